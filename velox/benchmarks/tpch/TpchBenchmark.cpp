@@ -15,11 +15,16 @@
  */
 
 #include <folly/Benchmark.h>
+#include <folly/String.h>
 #include <folly/init/Init.h>
+#include <folly/json.h>
 #include <gflags/gflags.h>
+#include <fstream>
+#include <numeric>
 
 #include "velox/common/base/SuccinctPrinter.h"
 #include "velox/common/file/FileSystems.h"
+#include "velox/common/memory/MemoryUsageTracker.h"
 #include "velox/connectors/hive/HiveConnector.h"
 #include "velox/dwio/common/Options.h"
 #include "velox/dwio/parquet/RegisterParquetReader.h"
@@ -53,6 +58,47 @@ static bool validateDataFormat(const char* flagname, const std::string& value) {
   return false;
 }
 
+// Parses a comma-separated list of integers. Returns 'defaultValues' if
+// 'list' is empty.
+std::vector<int32_t> parseIntList(
+    const std::string& list,
+    std::vector<int32_t> defaultValues) {
+  if (list.empty()) {
+    return defaultValues;
+  }
+  std::vector<folly::StringPiece> parts;
+  folly::split(',', list, parts, true);
+  std::vector<int32_t> values;
+  values.reserve(parts.size());
+  for (const auto& part : parts) {
+    values.push_back(folly::to<int32_t>(folly::trimWhitespace(part)));
+  }
+  return values;
+}
+
+// Returns the CPU time spent in all operators of the task.
+uint64_t totalCpuNanos(const TaskStats& stats) {
+  uint64_t cpuNanos = 0;
+  for (const auto& pipelineStats : stats.pipelineStats) {
+    for (const auto& operatorStats : pipelineStats.operatorStats) {
+      cpuNanos += operatorStats.addInputTiming.cpuNanos +
+          operatorStats.getOutputTiming.cpuNanos +
+          operatorStats.finishTiming.cpuNanos;
+    }
+  }
+  return cpuNanos;
+}
+
+uint64_t totalSpilledBytes(const TaskStats& stats) {
+  uint64_t spilledBytes = 0;
+  for (const auto& pipelineStats : stats.pipelineStats) {
+    for (const auto& operatorStats : pipelineStats.operatorStats) {
+      spilledBytes += operatorStats.spilledBytes;
+    }
+  }
+  return spilledBytes;
+}
+
 void ensureTaskCompletion(exec::Task* task) {
   // ASSERT_TRUE requires a function with return type void.
   ASSERT_TRUE(waitForTaskCompletion(task));
@@ -87,6 +133,24 @@ DEFINE_bool(include_results, false, "Include results in the output");
 DEFINE_int32(num_drivers, 4, "Number of drivers");
 DEFINE_string(data_format, "parquet", "Data format");
 DEFINE_int32(num_splits_per_file, 10, "Number of splits per file");
+DEFINE_string(
+    json_report,
+    "",
+    "If set, runs the queries in --queries with each of --driver_counts "
+    "and writes a JSON report of the runs to this path instead of running "
+    "the benchmarks. The scale factor is the one of the data in "
+    "--data_path.");
+DEFINE_string(
+    queries,
+    "",
+    "Comma-separated TPC-H query numbers for --json_report. All 22 queries "
+    "if empty");
+DEFINE_string(
+    driver_counts,
+    "",
+    "Comma-separated numbers of drivers for --json_report. --num_drivers if "
+    "empty");
+DEFINE_int32(num_repeats, 1, "Number of runs per query for --json_report");
 
 DEFINE_validator(data_path, &notEmpty);
 DEFINE_validator(data_format, &validateDataFormat);
@@ -106,11 +170,19 @@ class TpchBenchmark {
     connector::registerConnector(hiveConnector);
   }
 
+  /// Runs 'tpchPlan' with 'numDrivers' drivers per pipeline. If 'tracker' is
+  /// set, it tracks the memory of the query.
   std::pair<std::unique_ptr<TaskCursor>, std::vector<RowVectorPtr>> run(
-      const TpchPlan& tpchPlan) {
+      const TpchPlan& tpchPlan,
+      int32_t numDrivers = FLAGS_num_drivers,
+      const std::shared_ptr<memory::MemoryUsageTracker>& tracker = nullptr) {
     CursorParameters params;
-    params.maxDrivers = FLAGS_num_drivers;
+    params.maxDrivers = numDrivers;
     params.planNode = tpchPlan.plan;
+    if (tracker) {
+      params.queryCtx = core::QueryCtx::createForTest();
+      params.queryCtx->pool()->setMemoryUsageTracker(tracker);
+    }
     const int numSplitsPerFile = FLAGS_num_splits_per_file;
 
     bool noMoreSplits = false;
@@ -141,11 +213,21 @@ BENCHMARK(q1) {
   benchmark.run(planContext);
 }
 
+BENCHMARK(q2) {
+  const auto planContext = queryBuilder->getQueryPlan(2);
+  benchmark.run(planContext);
+}
+
 BENCHMARK(q3) {
   const auto planContext = queryBuilder->getQueryPlan(3);
   benchmark.run(planContext);
 }
 
+BENCHMARK(q4) {
+  const auto planContext = queryBuilder->getQueryPlan(4);
+  benchmark.run(planContext);
+}
+
 BENCHMARK(q5) {
   const auto planContext = queryBuilder->getQueryPlan(5);
   benchmark.run(planContext);
@@ -156,11 +238,31 @@ BENCHMARK(q6) {
   benchmark.run(planContext);
 }
 
+BENCHMARK(q7) {
+  const auto planContext = queryBuilder->getQueryPlan(7);
+  benchmark.run(planContext);
+}
+
+BENCHMARK(q8) {
+  const auto planContext = queryBuilder->getQueryPlan(8);
+  benchmark.run(planContext);
+}
+
+BENCHMARK(q9) {
+  const auto planContext = queryBuilder->getQueryPlan(9);
+  benchmark.run(planContext);
+}
+
 BENCHMARK(q10) {
   const auto planContext = queryBuilder->getQueryPlan(10);
   benchmark.run(planContext);
 }
 
+BENCHMARK(q11) {
+  const auto planContext = queryBuilder->getQueryPlan(11);
+  benchmark.run(planContext);
+}
+
 BENCHMARK(q12) {
   const auto planContext = queryBuilder->getQueryPlan(12);
   benchmark.run(planContext);
@@ -176,6 +278,21 @@ BENCHMARK(q14) {
   benchmark.run(planContext);
 }
 
+BENCHMARK(q15) {
+  const auto planContext = queryBuilder->getQueryPlan(15);
+  benchmark.run(planContext);
+}
+
+BENCHMARK(q16) {
+  const auto planContext = queryBuilder->getQueryPlan(16);
+  benchmark.run(planContext);
+}
+
+BENCHMARK(q17) {
+  const auto planContext = queryBuilder->getQueryPlan(17);
+  benchmark.run(planContext);
+}
+
 BENCHMARK(q18) {
   const auto planContext = queryBuilder->getQueryPlan(18);
   benchmark.run(planContext);
@@ -186,13 +303,79 @@ BENCHMARK(q19) {
   benchmark.run(planContext);
 }
 
+BENCHMARK(q20) {
+  const auto planContext = queryBuilder->getQueryPlan(20);
+  benchmark.run(planContext);
+}
+
+BENCHMARK(q21) {
+  const auto planContext = queryBuilder->getQueryPlan(21);
+  benchmark.run(planContext);
+}
+
+BENCHMARK(q22) {
+  const auto planContext = queryBuilder->getQueryPlan(22);
+  benchmark.run(planContext);
+}
+
+// Runs each query with each driver count and writes the wall and CPU time,
+// peak memory, spilled bytes and per plan node statistics of each run.
+void writeJsonReport() {
+  std::vector<int32_t> allQueries(22);
+  std::iota(allQueries.begin(), allQueries.end(), 1);
+  const auto queries = parseIntList(FLAGS_queries, allQueries);
+  const auto driverCounts =
+      parseIntList(FLAGS_driver_counts, {FLAGS_num_drivers});
+
+  folly::dynamic runs = folly::dynamic::array;
+  for (const auto queryId : queries) {
+    const auto queryPlan = queryBuilder->getQueryPlan(queryId);
+    for (const auto numDrivers : driverCounts) {
+      for (auto repeat = 0; repeat < FLAGS_num_repeats; ++repeat) {
+        auto tracker = memory::MemoryUsageTracker::create();
+        const auto [cursor, results] =
+            benchmark.run(queryPlan, numDrivers, tracker);
+        auto task = cursor->task();
+        ensureTaskCompletion(task.get());
+        const auto stats = task->taskStats();
+
+        folly::dynamic run = folly::dynamic::object;
+        run["query"] = queryId;
+        run["numDrivers"] = numDrivers;
+        run["repeat"] = repeat;
+        run["wallTimeMs"] =
+            stats.executionEndTimeMs - stats.executionStartTimeMs;
+        run["cpuTimeNanos"] = totalCpuNanos(stats);
+        run["peakMemoryBytes"] = tracker->getPeakTotalBytes();
+        run["spilledBytes"] = totalSpilledBytes(stats);
+        run["numTotalSplits"] = stats.numTotalSplits;
+        run["numFinishedSplits"] = stats.numFinishedSplits;
+        run["planNodeStats"] = toPlanStatsJson(stats);
+        runs.push_back(std::move(run));
+      }
+    }
+  }
+
+  folly::dynamic report = folly::dynamic::object;
+  report["dataPath"] = FLAGS_data_path;
+  report["dataFormat"] = FLAGS_data_format;
+  report["numSplitsPerFile"] = FLAGS_num_splits_per_file;
+  report["runs"] = std::move(runs);
+
+  std::ofstream out(FLAGS_json_report);
+  VELOX_CHECK(out.good(), "Cannot open {}", FLAGS_json_report);
+  out << folly::toPrettyJson(report) << std::endl;
+}
+
 int main(int argc, char** argv) {
   folly::init(&argc, &argv, false);
   benchmark.initialize();
   queryBuilder =
       std::make_shared<TpchQueryBuilder>(toFileFormat(FLAGS_data_format));
   queryBuilder->initialize(FLAGS_data_path);
-  if (FLAGS_run_query_verbose == -1) {
+  if (!FLAGS_json_report.empty()) {
+    writeJsonReport();
+  } else if (FLAGS_run_query_verbose == -1) {
     folly::runBenchmarks();
   } else {
     const auto queryPlan = queryBuilder->getQueryPlan(FLAGS_run_query_verbose);
@@ -16,11 +16,14 @@
 
 #pragma once
 
+#include <folly/Executor.h>
 #include <folly/Unit.h>
 #include <folly/executors/QueuedImmediateExecutor.h>
 #include <folly/futures/Future.h>
+#include <exception>
 #include <functional>
 #include <memory>
+#include <vector>
 
 #include "velox/common/future/VeloxPromise.h"
 
@@ -57,6 +60,10 @@ class AsyncSource {
         promise_->setValue();
         promise_ = nullptr;
       }
+      for (auto& promise : readyPromises_) {
+        promise.setValue();
+      }
+      readyPromises_.clear();
     }
   }
 
@@ -95,6 +102,19 @@ class AsyncSource {
     return std::move(item_);
   }
 
+  // Returns true if move() will not wait for prepare() running on another
+  // thread. Otherwise sets 'future' to be realized when the item is made, so
+  // that the caller can give up its thread instead of blocking in move().
+  bool readyOrFuture(ContinueFuture* future) {
+    std::lock_guard<std::mutex> l(mutex_);
+    if (!making_) {
+      return true;
+    }
+    readyPromises_.emplace_back("AsyncSource::readyOrFuture");
+    *future = readyPromises_.back().getSemiFuture();
+    return false;
+  }
+
   // If true, move() will not block. But there is no guarantee that somebody
   // else will not get the item first.
   bool hasValue() const {
@@ -106,7 +126,47 @@ class AsyncSource {
   // True if 'prepare() is making the item.
   bool making_{false};
   std::unique_ptr<ContinuePromise> promise_;
+  // Promises of readyOrFuture() callers.
+  std::vector<ContinuePromise> readyPromises_;
   std::unique_ptr<Item> item_;
   std::function<std::unique_ptr<Item>()> make_;
 };
+
+// Runs 'numTasks' invocations of 'task' on 'executor' and the calling thread
+// and returns after all are done. Rethrows the first error on the calling
+// thread.
+inline void runParallel(
+    folly::Executor* executor,
+    int32_t numTasks,
+    const std::function<void(int32_t)>& task) {
+  struct TaskResult {
+    std::exception_ptr error;
+  };
+  std::vector<std::shared_ptr<AsyncSource<TaskResult>>> sources;
+  sources.reserve(numTasks);
+  for (auto i = 0; i < numTasks; ++i) {
+    sources.push_back(std::make_shared<AsyncSource<TaskResult>>([i, &task]() {
+      auto result = std::make_unique<TaskResult>();
+      try {
+        task(i);
+      } catch (const std::exception& e) {
+        result->error = std::current_exception();
+      }
+      return result;
+    }));
+    executor->add([source = sources.back()]() { source->prepare(); });
+  }
+  // Waits for or runs all the tasks before rethrowing so that none is left
+  // running with references to the caller's state.
+  std::exception_ptr error;
+  for (auto& source : sources) {
+    auto result = source->move();
+    if (result && result->error && !error) {
+      error = result->error;
+    }
+  }
+  if (error) {
+    std::rethrow_exception(error);
+  }
+}
 } // namespace facebook::velox
@@ -17,11 +17,14 @@
 #pragma once
 
 #include <cstdint>
+#include <cstring>
 #include <vector>
 
 #include <folly/Hash.h>
 
 #include "velox/common/base/BitUtil.h"
+#include "velox/common/base/Exceptions.h"
+#include "velox/common/base/SimdUtil.h"
 
 namespace facebook::velox {
 
@@ -42,6 +45,71 @@ class BloomFilter {
     bits_.resize(std::max<int32_t>(4, bits::nextPowerOfTwo(capacity) / 4));
   }
 
+  // Returns the words of the filter, e.g. for serializing it.
+  const std::vector<uint64_t>& words() const {
+    return bits_;
+  }
+
+  // Replaces the content with 'words' returned by words() of a filter
+  // with the same 'hashInput'.
+  void setWords(std::vector<uint64_t> words) {
+    VELOX_CHECK(
+        !words.empty() && bits::isPowerOfTwo(words.size()),
+        "BloomFilter size must be a power of 2: {}",
+        words.size());
+    bits_ = std::move(words);
+  }
+
+  // True if reset() or setWords() has been called.
+  bool isSet() const {
+    return !bits_.empty();
+  }
+
+  // Size of the serialized form: a 1 byte version, a 4 byte count of words and
+  // the words.
+  int32_t serializedSize() const {
+    return 1 + sizeof(int32_t) + bits_.size() * sizeof(uint64_t);
+  }
+
+  // Writes serializedSize() bytes to 'output'.
+  void serialize(char* FOLLY_NONNULL output) const {
+    *output = kSerializationVersion;
+    int32_t numWords = bits_.size();
+    memcpy(output + 1, &numWords, sizeof(numWords));
+    memcpy(
+        output + 1 + sizeof(numWords),
+        bits_.data(),
+        numWords * sizeof(uint64_t));
+  }
+
+  // Replaces the content with a filter written by serialize().
+  void deserialize(const char* FOLLY_NONNULL data, int32_t size) {
+    auto numWords = checkSerialized(data, size);
+    std::vector<uint64_t> words(numWords);
+    memcpy(words.data(), data + kHeaderSize, numWords * sizeof(uint64_t));
+    setWords(std::move(words));
+  }
+
+  // Adds the content of a filter written by serialize() to 'this'. If
+  // 'this' is not set, it takes the size of the serialized filter. Otherwise
+  // the sizes must match.
+  void merge(const char* FOLLY_NONNULL data, int32_t size) {
+    if (bits_.empty()) {
+      deserialize(data, size);
+      return;
+    }
+    auto numWords = checkSerialized(data, size);
+    VELOX_CHECK_EQ(
+        numWords,
+        static_cast<int32_t>(bits_.size()),
+        "Cannot merge BloomFilters of different size");
+    for (auto i = 0; i < numWords; ++i) {
+      uint64_t word;
+      memcpy(&word, data + kHeaderSize + i * sizeof(uint64_t), sizeof(word));
+      bits_[i] |= word;
+    }
+  }
+
   // Adds 'value'.
   void insert(uint64_t value) {
     set(bits_.data(),
@@ -56,7 +124,38 @@ class BloomFilter {
         hashInput ? folly::hasher<uint64_t>()(value) : value);
   }
 
+  // Tests a batch of hash numbers at a time. Returns the lanes of 'hashes'
+  // that may be in 'this'. Only for pre-hashed input.
+  xsimd::batch_bool<int64_t> mayContain(xsimd::batch<int64_t> hashes) const {
+    static_assert(!hashInput, "Batch mayContain() requires hashed input");
+    xsimd::batch<uint64_t> hashCodes(hashes);
+    xsimd::batch<int64_t> indices(
+        (hashCodes >> 24) & xsimd::broadcast<uint64_t>(bits_.size() - 1));
+    xsimd::batch<uint64_t> words(simd::gather(
+        reinterpret_cast<const int64_t*>(bits_.data()), indices));
+    auto masks = bloomMask(hashCodes);
+    return xsimd::batch<int64_t>(words & masks) ==
+        xsimd::batch<int64_t>(masks);
+  }
+
  private:
+  static constexpr int8_t kSerializationVersion = 1;
+  static constexpr int32_t kHeaderSize = 1 + sizeof(int32_t);
+
+  // Checks the header of a serialized filter and returns its number of words.
+  static int32_t checkSerialized(const char* FOLLY_NONNULL data, int32_t size) {
+    VELOX_CHECK_GE(size, kHeaderSize, "Truncated BloomFilter");
+    VELOX_CHECK_EQ(
+        data[0], kSerializationVersion, "Unsupported BloomFilter version");
+    int32_t numWords;
+    memcpy(&numWords, data + 1, sizeof(numWords));
+    VELOX_CHECK_EQ(
+        static_cast<int64_t>(size),
+        kHeaderSize + static_cast<int64_t>(numWords) * sizeof(uint64_t),
+        "Bad BloomFilter size");
+    return numWords;
+  }
+
   // We use 4 independent hash functions by taking 24 bits of
   // the hash code and breaking these up into 4 groups of 6 bits. Each group
   // represents a number between 0 and 63 (2^6-1) and maps to one bit in a
@@ -67,6 +166,15 @@ class BloomFilter {
         (1L << ((hashCode >> 12) & 63)) | (1L << ((hashCode >> 18) & 63));
   }
 
+  inline static xsimd::batch<uint64_t> bloomMask(
+      xsimd::batch<uint64_t> hashCodes) {
+    const auto one = xsimd::broadcast<uint64_t>(1);
+    const auto low6 = xsimd::broadcast<uint64_t>(63);
+    return (one << (hashCodes & low6)) | (one << ((hashCodes >> 6) & low6)) |
+        (one << ((hashCodes >> 12) & low6)) |
+        (one << ((hashCodes >> 18) & low6));
+  }
+
   // Skip 24 bits used for bloomMask and use the next N bits of the hash code
   // as index. N = log2(bloomSize). bloomSize must be a power of 2.
   inline static uint32_t bloomIndex(uint32_t bloomSize, uint64_t hashCode) {
@@ -18,8 +18,71 @@
 #include "velox/common/base/Exceptions.h"
 #include "velox/common/base/SuccinctPrinter.h"
 
+#include <cmath>
+
 namespace facebook::velox {
 
+void RuntimeHistogram::merge(const RuntimeHistogram& other) {
+  for (auto i = 0; i < kNumBuckets; ++i) {
+    counts_[i] += other.counts_[i];
+  }
+  count_ += other.count_;
+  sum_ += other.sum_;
+  min_ = std::min(min_, other.min_);
+  max_ = std::max(max_, other.max_);
+}
+
+uint64_t RuntimeHistogram::percentile(double pct) const {
+  if (count_ == 0) {
+    return 0;
+  }
+  const auto target = std::max<int64_t>(1, std::ceil(count_ * pct / 100));
+  int64_t seen = 0;
+  for (auto i = 0; i < kNumBuckets; ++i) {
+    seen += counts_[i];
+    if (seen >= target) {
+      return 1UL << i;
+    }
+  }
+  return 1UL << (kNumBuckets - 1);
+}
+
+std::string RuntimeHistogram::toString() const {
+  return fmt::format(
+      "count: {} avg: {} p50: {} p90: {} p99: {} max: {}",
+      count_,
+      count_ ? sum_ / count_ : 0,
+      percentile(50),
+      percentile(90),
+      percentile(99),
+      max_);
+}
+
+RuntimeMetric::RuntimeMetric(const RuntimeMetric& other)
+    : unit(other.unit),
+      sum(other.sum),
+      count(other.count),
+      min(other.min),
+      max(other.max),
+      histogram(
+          other.histogram
+              ? std::make_unique<RuntimeHistogram>(*other.histogram)
+              : nullptr) {}
+
+RuntimeMetric& RuntimeMetric::operator=(const RuntimeMetric& other) {
+  if (this != &other) {
+    unit = other.unit;
+    sum = other.sum;
+    count = other.count;
+    min = other.min;
+    max = other.max;
+    histogram = other.histogram
+        ? std::make_unique<RuntimeHistogram>(*other.histogram)
+        : nullptr;
+  }
+  return *this;
+}
+
 void RuntimeMetric::addValue(int64_t value) {
   sum += value;
   count++;
@@ -27,12 +90,32 @@ void RuntimeMetric::addValue(int64_t value) {
   max = std::max(max, value);
 }
 
+void RuntimeMetric::addHistogram(const RuntimeHistogram& values) {
+  if (values.count() == 0) {
+    return;
+  }
+  sum += values.sum();
+  count += values.count();
+  min = std::min<int64_t>(min, values.min());
+  max = std::max<int64_t>(max, values.max());
+  if (!histogram) {
+    histogram = std::make_unique<RuntimeHistogram>();
+  }
+  histogram->merge(values);
+}
+
 void RuntimeMetric::merge(const RuntimeMetric& other) {
   VELOX_CHECK_EQ(unit, other.unit);
   sum += other.sum;
   count += other.count;
   min = std::min(min, other.min);
   max = std::max(max, other.max);
+  if (other.histogram) {
+    if (!histogram) {
+      histogram = std::make_unique<RuntimeHistogram>();
+    }
+    histogram->merge(*other.histogram);
+  }
 }
 
 void RuntimeMetric::printMetric(std::stringstream& stream) const {
@@ -52,5 +135,23 @@ void RuntimeMetric::printMetric(std::stringstream& stream) const {
       stream << " sum: " << sum << ", count: " << count << ", min: " << min
              << ", max: " << max;
   }
+  if (!histogram) {
+    return;
+  }
+  for (auto pct : {50, 90, 99}) {
+    const int64_t value = histogram->percentile(pct);
+    stream << ", p" << pct << ": ";
+    switch (unit) {
+      case RuntimeCounter::Unit::kNanos:
+        stream << succinctNanos(value);
+        break;
+      case RuntimeCounter::Unit::kBytes:
+        stream << succinctBytes(value);
+        break;
+      case RuntimeCounter::Unit::kNone:
+      default:
+        stream << value;
+    }
+  }
 }
 } // namespace facebook::velox
@@ -17,7 +17,10 @@
 #pragma once
 
 #include <fmt/format.h>
+#include <algorithm>
+#include <array>
 #include <limits>
+#include <memory>
 #include <sstream>
 
 namespace facebook::velox {
@@ -31,6 +34,67 @@ struct RuntimeCounter {
       : value(_value), unit(_unit) {}
 };
 
+/// Counts of values in buckets of powers of 2. Bucket 0 counts values under
+/// 1 and bucket i > 0 counts values from 2^(i-1) to 2^i - 1. Adding a value
+/// is a few increments and merging is an addition of the counts, so each
+/// driver or thread keeps its own histogram without locking and the
+/// histograms are merged when the stats are collected.
+class RuntimeHistogram {
+ public:
+  static constexpr int32_t kNumBuckets = 64;
+
+  void add(uint64_t value) {
+    ++counts_[bucket(value)];
+    ++count_;
+    sum_ += value;
+    min_ = std::min(min_, value);
+    max_ = std::max(max_, value);
+  }
+
+  void merge(const RuntimeHistogram& other);
+
+  int64_t count() const {
+    return count_;
+  }
+
+  uint64_t sum() const {
+    return sum_;
+  }
+
+  /// The smallest and largest added value. 0 if there are no values.
+  uint64_t min() const {
+    return count_ ? min_ : 0;
+  }
+
+  uint64_t max() const {
+    return max_;
+  }
+
+  const std::array<int64_t, kNumBuckets>& counts() const {
+    return counts_;
+  }
+
+  /// Returns the upper bound of the bucket of the value at percentile 'pct',
+  /// e.g. 99 for p99. 0 if there are no values.
+  uint64_t percentile(double pct) const;
+
+  std::string toString() const;
+
+ private:
+  static int32_t bucket(uint64_t value) {
+    if (value == 0) {
+      return 0;
+    }
+    return std::min<int32_t>(kNumBuckets - 1, 64 - __builtin_clzll(value));
+  }
+
+  std::array<int64_t, kNumBuckets> counts_{};
+  int64_t count_{0};
+  uint64_t sum_{0};
+  uint64_t min_{std::numeric_limits<uint64_t>::max()};
+  uint64_t max_{0};
+};
+
 struct RuntimeMetric {
   // Sum, min, max have the same unit, count has kNone.
   RuntimeCounter::Unit unit;
@@ -39,19 +103,43 @@ struct RuntimeMetric {
   int64_t min{std::numeric_limits<int64_t>::max()};
   int64_t max{std::numeric_limits<int64_t>::min()};
 
+  // Distribution of the values. Set only for metrics that are given
+  // histograms with addHistogram().
+  std::unique_ptr<RuntimeHistogram> histogram;
+
   explicit RuntimeMetric(
       RuntimeCounter::Unit _unit = RuntimeCounter::Unit::kNone)
       : unit(_unit) {}
 
+  RuntimeMetric(const RuntimeMetric& other);
+
+  RuntimeMetric& operator=(const RuntimeMetric& other);
+
+  RuntimeMetric(RuntimeMetric&& other) = default;
+
+  RuntimeMetric& operator=(RuntimeMetric&& other) = default;
+
   void addValue(int64_t value);
 
+  // Adds the values counted in 'values' to the sum, count, min and max and
+  // to 'histogram'.
+  void addHistogram(const RuntimeHistogram& values);
+
   void printMetric(std::stringstream& stream) const;
 
   void merge(const RuntimeMetric& other);
 
   std::string toString() const {
-    return fmt::format(
-        "sum:{}, count:{}, min:{}, max:{}", sum, count, min, max);
+    auto result =
+        fmt::format("sum:{}, count:{}, min:{}, max:{}", sum, count, min, max);
+    if (histogram) {
+      result += fmt::format(
+          ", p50:{}, p90:{}, p99:{}",
+          histogram->percentile(50),
+          histogram->percentile(90),
+          histogram->percentile(99));
+    }
+    return result;
   }
 };
 } // namespace facebook::velox
@@ -47,6 +47,13 @@ class SelectivityInfo {
     return numOut_;
   }
 
+  // Halves the history so that newer samples weigh more than older ones.
+  void decay() {
+    numIn_ /= 2;
+    numOut_ /= 2;
+    timeClocks_ /= 2;
+  }
+
  private:
   uint64_t numIn_ = 0;
   uint64_t numOut_ = 0;
@@ -176,6 +176,9 @@ int32_t indicesOfSetBits(
   if (end <= begin) {
     return 0;
   }
+  if (process::hasAvx512()) {
+    return detail::indicesOfSetBitsAvx512(bits, begin, end, result);
+  }
   int32_t row = begin & ~63;
   auto originalResult = result;
   int32_t endWord = bits::roundUp(end, 64) / 64;
@@ -593,6 +596,33 @@ struct Gather<T, int32_t, A, 8> {
 #endif
 };
 
+template <typename T, typename A>
+struct Gather<T, int64_t, A, 4> {
+#if XSIMD_WITH_AVX2
+  template <int kScale>
+  static xsimd::batch<T, A>
+  apply(const T* base, const int64_t* indices, const xsimd::avx2&) {
+    // A gather with 64 bit indices fills 4 lanes of 32 bits.
+    auto low = _mm256_i64gather_epi32(
+        reinterpret_cast<const int32_t*>(base),
+        _mm256_loadu_si256(reinterpret_cast<const __m256i*>(indices)),
+        kScale);
+    auto high = _mm256_i64gather_epi32(
+        reinterpret_cast<const int32_t*>(base),
+        _mm256_loadu_si256(reinterpret_cast<const __m256i*>(indices + 4)),
+        kScale);
+    return reinterpret_cast<typename xsimd::batch<T, A>::register_type>(
+        _mm256_set_m128i(high, low));
+  }
+#endif
+
+  template <int kScale>
+  static xsimd::batch<T, A>
+  apply(const T* base, const int64_t* indices, const xsimd::generic&) {
+    return genericGather<T, A, kScale>(base, indices);
+  }
+};
+
 template <typename T, typename A>
 struct Gather<T, int64_t, A, 8> {
   using VIndexType = xsimd::batch<int64_t, A>;
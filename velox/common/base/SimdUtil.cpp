@@ -17,6 +17,10 @@
 #include "velox/common/base/SimdUtil.h"
 #include <folly/Preprocessor.h>
 
+#ifdef __x86_64__
+#include <immintrin.h>
+#endif
+
 namespace facebook::velox::simd {
 
 namespace detail {
@@ -24,6 +28,65 @@ namespace detail {
 alignas(kPadding) int32_t byteSetBits[256][8];
 alignas(kPadding) int32_t permute4x64Indices[16][8];
 
+#ifdef __x86_64__
+__attribute__((target("avx512f"))) int32_t indicesOfSetBitsAvx512(
+    const uint64_t* bits,
+    int32_t begin,
+    int32_t end,
+    int32_t* result) {
+  if (end <= begin) {
+    return 0;
+  }
+  const auto kLanes = _mm512_setr_epi32(
+      0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15);
+  auto originalResult = result;
+  const int32_t firstWord = begin / 64;
+  const int32_t endWord = bits::nwords(end);
+  for (auto wordIndex = firstWord; wordIndex < endWord; ++wordIndex) {
+    uint64_t word = bits[wordIndex];
+    const int32_t row = wordIndex * 64;
+    if (wordIndex == firstWord) {
+      word &= ~bits::lowMask(begin - row);
+    }
+    if (wordIndex == endWord - 1 && end - row < 64) {
+      word &= bits::lowMask(end - row);
+    }
+    if (!word) {
+      continue;
+    }
+    // A sparse word is cheaper to scan one set bit at a time.
+    if (__builtin_popcountll(word) <= 8) {
+      do {
+        *result++ = __builtin_ctzll(word) + row;
+        word &= word - 1;
+      } while (word);
+      continue;
+    }
+    // Add the row to the lane numbers and store the lanes of the set bits
+    // of each 16 bit slice of 'word' contiguously.
+    for (auto slice = 0; slice < 4; ++slice) {
+      const __mmask16 mask = word >> (slice * 16);
+      if (mask) {
+        _mm512_mask_compressstoreu_epi32(
+            result,
+            mask,
+            _mm512_add_epi32(kLanes, _mm512_set1_epi32(row + slice * 16)));
+        result += __builtin_popcount(mask);
+      }
+    }
+  }
+  return result - originalResult;
+}
+#else
+int32_t indicesOfSetBitsAvx512(
+    const uint64_t* /*bits*/,
+    int32_t /*begin*/,
+    int32_t /*end*/,
+    int32_t* /*result*/) {
+  VELOX_UNREACHABLE();
+}
+#endif
+
 } // namespace detail
 
 namespace {
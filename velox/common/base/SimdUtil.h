@@ -19,6 +19,7 @@
 #include <cstdint>
 #include "velox/common/base/BitUtil.h"
 #include "velox/common/base/Exceptions.h"
+#include "velox/common/process/ProcessBase.h"
 
 #include <folly/Likely.h>
 #include <xsimd/xsimd.hpp>
@@ -46,7 +47,8 @@ bool initializeSimdUtil();
 // Returns positions of set bits in 'bits' in 'indices'. Bits from
 // 'begin' to 'end' are considered and the return value is the number
 // of found set bits. For bits 0xff and begin 2 and end 5 we have a return value
-// of 3 and indices is set to {2, 3, 4}.
+// of 3 and indices is set to {2, 3, 4}. Uses AVX-512 if
+// process::hasAvx512().
 template <typename A = xsimd::default_arch>
 int32_t indicesOfSetBits(
     const uint64_t* bits,
@@ -57,6 +59,15 @@ int32_t indicesOfSetBits(
 
 namespace detail {
 extern int32_t byteSetBits[256][8];
+
+// indicesOfSetBits() for machines with AVX-512. Makes the indices for 16 bits
+// at a time with VPCOMPRESSD. Compiled for AVX-512 regardless of the build
+// target, so this may only be called if process::hasAvx512().
+int32_t indicesOfSetBitsAvx512(
+    const uint64_t* bits,
+    int32_t begin,
+    int32_t end,
+    int32_t* result);
 }
 
 // Offsets of set bits in a byte. For example, for byte 42 it returns
@@ -178,7 +189,9 @@ gather(const T* base, Batch64<IndexType> vindex, const A& arch = {}) {
   return Impl::template apply<kScale>(base, vindex.data, arch);
 }
 
-// Same as 'gather' above except the indices are read from memory.
+// Same as 'gather' above except the indices are read from memory. 64 bit
+// indices can be used with 4 and 8 byte 'T', e.g. with a 'base' of 0 for
+// gathering from a set of pointers.
 template <
     typename T,
     typename IndexType,
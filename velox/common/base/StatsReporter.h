@@ -18,6 +18,7 @@
 
 #include <folly/Singleton.h>
 #include <memory>
+#include <vector>
 
 /// StatsReporter designed to assist in reporting various stats of the
 /// application that uses velox library. The library itself does not implement
@@ -44,6 +45,12 @@
 ///   REPORT_ADD_STAT_VALUE("my_stat1");
 ///   REPORT_ADD_STAT_VALUE("my_stat2", 10);
 ///   REPORT_ADD_STAT_VALUE("my_stat1", numOfFailures);
+///
+/// A histogram stat is registered with its buckets and the percentiles to
+/// export, and each value is then added to it:
+///
+///   REPORT_ADD_HISTOGRAM_EXPORT_PERCENTILE("my_stat3", 10, 0, 1000, 50, 99);
+///   REPORT_ADD_HISTOGRAM_VALUE("my_stat3", latencyMs);
 
 namespace facebook::velox {
 
@@ -70,6 +77,19 @@ class BaseStatsReporter {
   virtual void addStatValue(const char* key, size_t value = 1) const = 0;
 
   virtual void addStatValue(folly::StringPiece key, size_t value = 1) const = 0;
+
+  // Registers 'key' as a histogram with buckets of 'bucketWidth' from 'min'
+  // to 'max' that exports the percentiles 'pcts', e.g. {50, 99}.
+  virtual void addHistogramExportPercentiles(
+      folly::StringPiece key,
+      int64_t bucketWidth,
+      int64_t min,
+      int64_t max,
+      const std::vector<int32_t>& pcts) const = 0;
+
+  // Adds 'value' to the histogram 'key'.
+  virtual void addHistogramValue(folly::StringPiece key, int64_t value)
+      const = 0;
 };
 
 // This is a dummy reporter that does nothing
@@ -88,6 +108,16 @@ class DummyStatsReporter : public BaseStatsReporter {
 
   void addStatValue(folly::StringPiece /* key */, size_t /* value */)
       const override {}
+
+  void addHistogramExportPercentiles(
+      folly::StringPiece /* key */,
+      int64_t /* bucketWidth */,
+      int64_t /* min */,
+      int64_t /* max */,
+      const std::vector<int32_t>& /* pcts */) const override {}
+
+  void addHistogramValue(folly::StringPiece /* key */, int64_t /* value */)
+      const override {}
 };
 
 #define REPORT_ADD_STAT_VALUE(k, ...)                                         \
@@ -108,4 +138,23 @@ class DummyStatsReporter : public BaseStatsReporter {
     }                                                                         \
   }
 
+#define REPORT_ADD_HISTOGRAM_EXPORT_PERCENTILE(k, w, mi, ma, ...)             \
+  {                                                                           \
+    auto reporter =                                                           \
+        folly::Singleton<facebook::velox::BaseStatsReporter>::try_get_fast(); \
+    if (LIKELY(reporter != nullptr)) {                                        \
+      reporter->addHistogramExportPercentiles(                                \
+          (k), (w), (mi), (ma), {__VA_ARGS__});                               \
+    }                                                                         \
+  }
+
+#define REPORT_ADD_HISTOGRAM_VALUE(k, v)                                      \
+  {                                                                           \
+    auto reporter =                                                           \
+        folly::Singleton<facebook::velox::BaseStatsReporter>::try_get_fast(); \
+    if (LIKELY(reporter != nullptr)) {                                        \
+      reporter->addHistogramValue((k), (v));                                  \
+    }                                                                         \
+  }
+
 } // namespace facebook::velox
@@ -15,12 +15,15 @@
  */
 
 #include <folly/Benchmark.h>
+#include <folly/Random.h>
 #include <folly/init/Init.h>
 
 #include <optional>
 
 #include "velox/common/base/BitUtil.h"
+#include "velox/common/base/SimdUtil.h"
 DECLARE_bool(bmi2); // NOLINT
+DECLARE_bool(avx512); // NOLINT
 
 namespace facebook {
 namespace velox {
@@ -143,6 +146,46 @@ BENCHMARK_RELATIVE(BM_scatterBits, n) {
   runScatterBits(n, false);
 }
 
+void runIndicesOfSetBits(int32_t n, int32_t onesPer1000, bool avx512) {
+  constexpr int32_t kNumBits = 64'000;
+  std::vector<uint64_t> bits;
+  std::vector<int32_t> indices;
+  BENCHMARK_SUSPEND {
+    FLAGS_avx512 = avx512; // NOLINT
+    bits.resize(bits::nwords(kNumBits));
+    indices.resize(kNumBits);
+    folly::Random::DefaultGenerator rng(1);
+    for (auto i = 0; i < kNumBits; ++i) {
+      if (folly::Random::rand32(1000, rng) < onesPer1000) {
+        bits::setBit(bits.data(), i);
+      }
+    }
+  }
+  for (auto i = 0; i < n; ++i) {
+    folly::doNotOptimizeAway(
+        simd::indicesOfSetBits(bits.data(), 0, kNumBits, indices.data()));
+  }
+  FLAGS_avx512 = true; // NOLINT
+}
+
+BENCHMARK_DRAW_LINE();
+
+BENCHMARK(BM_indicesOfSetBits50Pct, n) {
+  runIndicesOfSetBits(n, 500, false);
+}
+
+BENCHMARK_RELATIVE(BM_indicesOfSetBits50PctAvx512, n) {
+  runIndicesOfSetBits(n, 500, true);
+}
+
+BENCHMARK(BM_indicesOfSetBits90Pct, n) {
+  runIndicesOfSetBits(n, 900, false);
+}
+
+BENCHMARK_RELATIVE(BM_indicesOfSetBits90PctAvx512, n) {
+  runIndicesOfSetBits(n, 900, true);
+}
+
 void BM_forEachBit(
     uint32_t iterations,
     size_t numBits,
@@ -18,6 +18,7 @@
 #include <fmt/format.h>
 #include <folly/Random.h>
 #include <folly/Synchronized.h>
+#include <folly/synchronization/Baton.h>
 #include <gtest/gtest.h>
 #include <thread>
 
@@ -40,6 +41,29 @@ TEST(AsyncSourceTest, basic) {
   EXPECT_EQ(11, value->id);
 }
 
+TEST(AsyncSourceTest, readyOrFuture) {
+  folly::Baton<> started;
+  folly::Baton<> release;
+  AsyncSource<Gizmo> gizmo([&]() {
+    started.post();
+    release.wait();
+    return std::make_unique<Gizmo>(11);
+  });
+  ContinueFuture future;
+  // Not started, so move() would make the item on the calling thread.
+  EXPECT_TRUE(gizmo.readyOrFuture(&future));
+
+  std::thread thread([&]() { gizmo.prepare(); });
+  started.wait();
+  EXPECT_FALSE(gizmo.readyOrFuture(&future));
+  EXPECT_FALSE(future.isReady());
+  release.post();
+  std::move(future).wait();
+  thread.join();
+  EXPECT_TRUE(gizmo.readyOrFuture(&future));
+  EXPECT_EQ(11, gizmo.move()->id);
+}
+
 TEST(AsyncSourceTest, threads) {
   constexpr int32_t kNumThreads = 10;
   constexpr int32_t kNumGizmos = 2000;
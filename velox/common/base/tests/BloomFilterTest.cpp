@@ -37,3 +37,39 @@ TEST(BloomFilterTest, basic) {
   }
   EXPECT_GT(2, 100 * numFalsePositives / kSize);
 }
+
+TEST(BloomFilterTest, serializeAndMerge) {
+  constexpr int32_t kSize = 1024;
+  BloomFilter<false> first;
+  BloomFilter<false> second;
+  first.reset(kSize);
+  second.reset(kSize);
+  for (auto i = 0; i < kSize; ++i) {
+    auto hash = folly::hasher<uint64_t>()(i);
+    (i % 2 ? first : second).insert(hash);
+  }
+
+  std::string serialized(first.serializedSize(), '\0');
+  first.serialize(serialized.data());
+  BloomFilter<false> copy;
+  EXPECT_FALSE(copy.isSet());
+  copy.deserialize(serialized.data(), serialized.size());
+  EXPECT_EQ(first.words(), copy.words());
+
+  second.serialize(serialized.data());
+  copy.merge(serialized.data(), serialized.size());
+  for (auto i = 0; i < kSize; ++i) {
+    EXPECT_TRUE(copy.mayContain(folly::hasher<uint64_t>()(i)));
+  }
+
+  BloomFilter<false> other;
+  other.reset(kSize * 4);
+  std::string otherSerialized(other.serializedSize(), '\0');
+  other.serialize(otherSerialized.data());
+  EXPECT_THROW(
+      copy.merge(otherSerialized.data(), otherSerialized.size()),
+      VeloxRuntimeError);
+  EXPECT_THROW(
+      copy.deserialize(serialized.data(), serialized.size() - 1),
+      VeloxRuntimeError);
+}
@@ -0,0 +1,92 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#include "velox/common/base/RuntimeMetrics.h"
+
+#include <gtest/gtest.h>
+
+using namespace facebook::velox;
+
+TEST(RuntimeHistogramTest, percentiles) {
+  RuntimeHistogram histogram;
+  EXPECT_EQ(histogram.percentile(50), 0);
+  EXPECT_EQ(histogram.min(), 0);
+  for (auto i = 0; i < 90; ++i) {
+    histogram.add(3);
+  }
+  for (auto i = 0; i < 9; ++i) {
+    histogram.add(100);
+  }
+  histogram.add(5'000);
+  EXPECT_EQ(histogram.count(), 100);
+  EXPECT_EQ(histogram.sum(), 90 * 3 + 9 * 100 + 5'000);
+  EXPECT_EQ(histogram.min(), 3);
+  EXPECT_EQ(histogram.max(), 5'000);
+  // The upper bounds of the buckets of 2-3, 64-127 and 4096-8191.
+  EXPECT_EQ(histogram.percentile(50), 4);
+  EXPECT_EQ(histogram.percentile(90), 4);
+  EXPECT_EQ(histogram.percentile(99), 128);
+  EXPECT_EQ(histogram.percentile(100), 8192);
+
+  RuntimeHistogram other;
+  other.add(0);
+  other.add(std::numeric_limits<uint64_t>::max());
+  histogram.merge(other);
+  EXPECT_EQ(histogram.count(), 102);
+  EXPECT_EQ(histogram.counts()[0], 1);
+  EXPECT_EQ(histogram.counts()[RuntimeHistogram::kNumBuckets - 1], 1);
+  EXPECT_EQ(histogram.min(), 0);
+  EXPECT_EQ(histogram.max(), std::numeric_limits<uint64_t>::max());
+}
+
+TEST(RuntimeMetricTest, histogram) {
+  RuntimeHistogram first;
+  first.add(10);
+  first.add(20);
+  RuntimeHistogram second;
+  second.add(1'000);
+
+  RuntimeMetric metric(RuntimeCounter::Unit::kNanos);
+  metric.addHistogram(first);
+  EXPECT_EQ(metric.count, 2);
+  EXPECT_EQ(metric.sum, 30);
+  EXPECT_EQ(metric.min, 10);
+  EXPECT_EQ(metric.max, 20);
+
+  // Copies do not share the histogram.
+  RuntimeMetric copy = metric;
+  RuntimeMetric other(RuntimeCounter::Unit::kNanos);
+  other.addHistogram(second);
+  metric.merge(other);
+  EXPECT_EQ(metric.count, 3);
+  EXPECT_EQ(metric.max, 1'000);
+  ASSERT_NE(metric.histogram, nullptr);
+  EXPECT_EQ(metric.histogram->count(), 3);
+  EXPECT_EQ(metric.histogram->percentile(100), 1024);
+  ASSERT_NE(copy.histogram, nullptr);
+  EXPECT_EQ(copy.histogram->count(), 2);
+
+  std::stringstream out;
+  metric.printMetric(out);
+  EXPECT_NE(out.str().find("p99:"), std::string::npos);
+
+  // Metrics without a histogram are unchanged.
+  RuntimeMetric plain;
+  plain.addValue(5);
+  EXPECT_EQ(plain.histogram, nullptr);
+  EXPECT_EQ(plain.toString(), "sum:5, count:1, min:5, max:5");
+}
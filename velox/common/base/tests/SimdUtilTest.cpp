@@ -16,9 +16,12 @@
 
 #include "velox/common/base/SimdUtil.h"
 #include <folly/Random.h>
+#include <gflags/gflags.h>
 
 #include <gtest/gtest.h>
 
+DECLARE_bool(avx512); // NOLINT
+
 using namespace facebook::velox;
 
 namespace {
@@ -102,12 +105,18 @@ class SimdUtilTest : public testing::Test {
 };
 
 TEST_F(SimdUtilTest, bitIndices) {
-  testIndices(1);
-  testIndices(10);
-  testIndices(100);
-  testIndices(250);
-  testIndices(500);
-  testIndices(999);
+  // Covers the AVX-512 kernel if the machine has AVX-512 and the portable
+  // one otherwise.
+  for (auto avx512 : {false, true}) {
+    SCOPED_TRACE(avx512 ? "avx512" : "portable");
+    FLAGS_avx512 = avx512;
+    testIndices(1);
+    testIndices(10);
+    testIndices(100);
+    testIndices(250);
+    testIndices(500);
+    testIndices(999);
+  }
 }
 
 TEST_F(SimdUtilTest, gather32) {
@@ -161,6 +170,26 @@ TEST_F(SimdUtilTest, gather64) {
   EXPECT_EQ((1 << (kBatchSize - 1)) - 1, bits);
 }
 
+TEST_F(SimdUtilTest, gatherWith64BitIndices) {
+  int32_t data32[8] = {0, 11, 22, 33, 44, 55, 66, 77};
+  int64_t indices[8] = {7, 6, 5, 4, 3, 2, 1, 0};
+  auto result32 = simd::gather(data32, indices);
+  for (auto i = 0; i < xsimd::batch<int32_t>::size; ++i) {
+    EXPECT_EQ(result32.get(i), data32[indices[i]]);
+  }
+
+  // Gather through pointers with a base of 0 and a scale of 1.
+  int64_t data64[4] = {44, 55, 66, 77};
+  int64_t pointers[8];
+  for (auto i = 0; i < 8; ++i) {
+    pointers[i] = reinterpret_cast<int64_t>(&data64[3 - i % 4]);
+  }
+  auto result64 = simd::gather<int64_t, int64_t, 1>(nullptr, pointers);
+  for (auto i = 0; i < xsimd::batch<int64_t>::size; ++i) {
+    EXPECT_EQ(result64.get(i), data64[3 - i % 4]);
+  }
+}
+
 TEST_F(SimdUtilTest, gather16) {
   int16_t data[32];
   int32_t indices[32];
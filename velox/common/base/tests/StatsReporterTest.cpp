@@ -32,6 +32,9 @@ class TestReporter : public BaseStatsReporter {
  public:
   mutable std::unordered_map<std::string, size_t> counterMap;
   mutable std::unordered_map<std::string, StatType> counterTypeMap;
+  mutable std::unordered_map<std::string, std::vector<int32_t>>
+      histogramPercentilesMap;
+  mutable std::unordered_map<std::string, std::vector<int64_t>> histogramMap;
 
   void addStatExportType(const char* key, StatType statType) const override {
     counterTypeMap[key] = statType;
@@ -53,6 +56,20 @@ class TestReporter : public BaseStatsReporter {
   void addStatValue(folly::StringPiece key, size_t value) const override {
     counterMap[key.str()] += value;
   }
+
+  void addHistogramExportPercentiles(
+      folly::StringPiece key,
+      int64_t /* bucketWidth */,
+      int64_t /* min */,
+      int64_t /* max */,
+      const std::vector<int32_t>& pcts) const override {
+    histogramPercentilesMap[key.str()] = pcts;
+  }
+
+  void addHistogramValue(folly::StringPiece key, int64_t value)
+      const override {
+    histogramMap[key.str()].push_back(value);
+  }
 };
 
 TEST_F(StatsReporterTest, trivialReporter) {
@@ -80,6 +97,15 @@ TEST_F(StatsReporterTest, trivialReporter) {
   EXPECT_EQ(36, reporter->counterMap["key1"]);
   EXPECT_EQ(2201, reporter->counterMap["key2"]);
   EXPECT_EQ(1101, reporter->counterMap["key3"]);
+
+  REPORT_ADD_HISTOGRAM_EXPORT_PERCENTILE("key4", 10, 0, 100, 50, 99);
+  REPORT_ADD_HISTOGRAM_VALUE("key4", 5);
+  REPORT_ADD_HISTOGRAM_VALUE("key4", 60);
+
+  EXPECT_EQ(
+      std::vector<int32_t>({50, 99}),
+      reporter->histogramPercentilesMap["key4"]);
+  EXPECT_EQ(std::vector<int64_t>({5, 60}), reporter->histogramMap["key4"]);
 };
 
 // Registering to folly Singleton with intended reporter type
@@ -50,7 +50,7 @@ void AsyncDataCacheEntry::setExclusiveToShared() {
     hook(*this);
   }
 
-  if (!ssdFile_ && shard_->cache()->ssdCache()) {
+  if (!ssdFile_ && !isUncached_ && shard_->cache()->ssdCache()) {
     auto ssdCache = shard_->cache()->ssdCache();
     assert(ssdCache); // for lint only.
     if (ssdCache->groupStats().shouldSaveToSsd(groupId_, trackingId_)) {
@@ -74,6 +74,8 @@ void AsyncDataCacheEntry::release() {
     if (promise) {
       promise->setValue(true);
     }
+  } else if (isUncached_) {
+    shard_->releaseUncached(this);
   } else {
     auto oldPins = numPins_.fetch_add(-1);
     VELOX_CHECK_LE(1, oldPins, "pin count goes negative");
@@ -147,13 +149,23 @@ std::unique_ptr<AsyncDataCacheEntry> CacheShard::getFreeEntryWithSize(
 CachePin CacheShard::findOrCreate(
     RawFileCacheKey key,
     uint64_t size,
-    folly::SemiFuture<bool>* wait) {
+    folly::SemiFuture<bool>* wait,
+    int32_t quotaGroup) {
   AsyncDataCacheEntry* entryToInit = nullptr;
+  auto& group = cache_->quotaGroup(quotaGroup);
   {
-    std::lock_guard<std::mutex> l(mutex_);
+    std::unique_lock<std::mutex> l(mutex_, std::try_to_lock);
+    if (!l.owns_lock()) {
+      l.lock();
+      ++numLockWaits_;
+    }
     ++eventCounter_;
+    if (frequencies_) {
+      frequencies_->record(std::hash<RawFileCacheKey>()(key));
+    }
     auto it = entryMap_.find(key);
-    if (it != entryMap_.end()) {
+    bool isSuperseded = it != entryMap_.end();
+    if (isSuperseded) {
       auto found = it->second;
       if (found->isExclusive()) {
         ++numWaitExclusive_;
@@ -165,15 +177,26 @@ CachePin CacheShard::findOrCreate(
       }
       if (found->size() >= size) {
         found->touch();
+        found->isLowPriority_ = false;
         // The entry is in a readable state. Add a pin.
         if (found->isPrefetch_) {
           found->isFirstUse_ = true;
           found->setPrefetch(false);
         } else {
           ++numHit_;
+          ++group.numHit;
         }
-        ++found->numPins_;
         CachePin pin;
+        if (found->isCompressed()) {
+          // Decompressed outside of 'mutex_'. Other readers wait for
+          // this as for a load.
+          VELOX_CHECK_EQ(0, found->numPins_);
+          found->numPins_ = AsyncDataCacheEntry::kExclusive;
+          pin.setEntry(found);
+          l.unlock();
+          return decompress(std::move(pin), key, size, wait, quotaGroup);
+        }
+        ++found->numPins_;
         pin.setEntry(found);
         return pin;
       }
@@ -184,14 +207,28 @@ CachePin CacheShard::findOrCreate(
                              << found->size() << " requested size " << size;
       // The old entry is superseded. Possible readers of the old
       // entry still retain a valid read pin.
-      found->key_.fileNum.clear();
+      clearKeyLocked(found);
     }
     auto newEntry = getFreeEntryWithSize(size);
     // Initialize the members that must be set inside 'mutex_'.
     newEntry->numPins_ = AsyncDataCacheEntry::kExclusive;
     newEntry->promise_ = nullptr;
+    newEntry->quotaGroup_ = quotaGroup;
+    auto isLowFrequency = !shouldAdmit(key, size);
+    if (isLowFrequency) {
+      ++numLowFrequency_;
+    }
+    auto isOverHardQuota = group.isOverHardQuota();
+    newEntry->isLowPriority_ = isLowFrequency || isOverHardQuota;
+    // The map refers to a superseded entry, so its replacement must be
+    // mapped.
+    newEntry->isUncached_ = !isSuperseded &&
+        (isOverHardQuota ||
+         (isLowFrequency && admission_ == CacheAdmission::kScanResistant));
     entryToInit = newEntry.get();
-    entryMap_[key] = newEntry.get();
+    if (!newEntry->isUncached_) {
+      entryMap_[key] = newEntry.get();
+    }
     if (emptySlots_.empty()) {
       entries_.push_back(std::move(newEntry));
     } else {
@@ -200,14 +237,71 @@ CachePin CacheShard::findOrCreate(
       entries_[index] = std::move(newEntry);
     }
     ++numNew_;
+    ++group.numNew;
     // Inside the shard mutex.
     VELOX_CHECK_EQ(0, entryToInit->size_);
     entryToInit->size_ = size;
+    group.bytes += size;
     entryToInit->isFirstUse_ = true;
   }
   return initEntry(key, entryToInit);
 }
 
+CachePin CacheShard::decompress(
+    CachePin pin,
+    RawFileCacheKey key,
+    uint64_t size,
+    folly::SemiFuture<bool>* wait,
+    int32_t quotaGroup) {
+  auto entry = pin.checkedEntry();
+  auto numPages = bits::roundUp(entry->size_, MappedMemory::kPageSize) /
+      MappedMemory::kPageSize;
+  {
+    ClockTimer t(allocClocks_);
+    if (!cache_->allocate(numPages, kCacheOwner, entry->data_)) {
+      // Releasing the exclusive pin drops the entry. The retry makes a
+      // new entry or throws for lack of space.
+      pin.clear();
+      return findOrCreate(key, size, wait, quotaGroup);
+    }
+  }
+  cache_->incrementCachedPages(entry->data_.numPages());
+  auto compressed = folly::IOBuf::wrapBuffer(
+      entry->compressed_.data(), entry->compressed_.size());
+  auto uncompressed = folly::io::getCodec(cache_->compressionCodec())
+                          ->uncompress(compressed.get(), entry->size_);
+  // Copies the uncompressed data into the runs of 'data_'.
+  auto& data = entry->data_;
+  int32_t runIndex = 0;
+  uint64_t runOffset = 0;
+  int64_t numCopied = 0;
+  for (auto range : *uncompressed) {
+    while (!range.empty()) {
+      auto run = data.runAt(runIndex);
+      auto bytes =
+          std::min<uint64_t>(range.size(), run.numBytes() - runOffset);
+      memcpy(run.data<uint8_t>() + runOffset, range.data(), bytes);
+      range.advance(bytes);
+      numCopied += bytes;
+      runOffset += bytes;
+      if (runOffset == run.numBytes()) {
+        ++runIndex;
+        runOffset = 0;
+      }
+    }
+  }
+  VELOX_CHECK_EQ(entry->size_, numCopied);
+  std::string toFree;
+  {
+    std::lock_guard<std::mutex> l(mutex_);
+    ++numDecompress_;
+    cache_->releaseCompressed(entry->compressed_.size());
+    toFree.swap(entry->compressed_);
+  }
+  entry->setExclusiveToShared();
+  return pin;
+}
+
 bool CacheShard::exists(RawFileCacheKey key) const {
   std::lock_guard<std::mutex> l(mutex_);
   auto it = entryMap_.find(key);
@@ -218,6 +312,56 @@ bool CacheShard::exists(RawFileCacheKey key) const {
   return false;
 }
 
+bool CacheShard::shouldAdmit(RawFileCacheKey key, uint64_t size) {
+  // Number of entries from the clock hand on that are considered for
+  // the eviction candidate.
+  constexpr int32_t kNumCandidates = 8;
+  if (!frequencies_ || entries_.empty()) {
+    return true;
+  }
+  auto sizePages =
+      bits::roundUp(size, MappedMemory::kPageSize) / MappedMemory::kPageSize;
+  auto maxPages = cache_->maxBytes() / MappedMemory::kPageSize;
+  // Leaves 1/16 of the capacity for loading entries that are not
+  // admitted, so that these do not need to evict anything.
+  if (cache_->numAllocated() + sizePages < maxPages - maxPages / 16) {
+    return true;
+  }
+  // The candidate is the unpinned entry with the highest score.
+  auto now = accessTime();
+  AsyncDataCacheEntry* candidate = nullptr;
+  int32_t candidateScore = 0;
+  auto numEntries = entries_.size();
+  for (auto i = 0; i < std::min<int32_t>(kNumCandidates, numEntries); ++i) {
+    auto entry = entries_[(clockHand_ + i) % numEntries].get();
+    if (!entry || entry->numPins_ != 0 || !entry->key_.fileNum.hasValue()) {
+      continue;
+    }
+    auto score = entry->score(now);
+    if (!candidate || score > candidateScore) {
+      candidate = entry;
+      candidateScore = score;
+    }
+  }
+  if (!candidate) {
+    return true;
+  }
+  // TinyLFU: admit only if strictly more frequent than what is displaced.
+  return frequencies_->estimate(std::hash<RawFileCacheKey>()(key)) >
+      frequencies_->estimate(std::hash<RawFileCacheKey>()(RawFileCacheKey{
+          candidate->key_.fileNum.id(), candidate->key_.offset}));
+}
+
+void CacheShard::setAdmission(CacheAdmission admission, int32_t sketchWidth) {
+  std::lock_guard<std::mutex> l(mutex_);
+  admission_ = admission;
+  if (admission == CacheAdmission::kAll) {
+    frequencies_.reset();
+  } else if (!frequencies_) {
+    frequencies_ = std::make_unique<FrequencySketch>(sketchWidth);
+  }
+}
+
 CachePin CacheShard::initEntry(
     RawFileCacheKey key,
     AsyncDataCacheEntry* entry) {
@@ -294,13 +438,36 @@ void CacheShard::removeEntry(AsyncDataCacheEntry* entry) {
   removeEntryLocked(entry);
 }
 
+void CacheShard::releaseUncached(AsyncDataCacheEntry* entry) {
+  MappedMemory::Allocation toFree(cache_);
+  {
+    std::lock_guard<std::mutex> l(mutex_);
+    auto oldPins = entry->numPins_.fetch_add(-1);
+    VELOX_CHECK_LE(1, oldPins, "pin count goes negative");
+    if (oldPins > 1) {
+      return;
+    }
+    // Nobody else can pin the entry since it is not in 'entryMap_'. The
+    // keyless entry is recycled by the next evict().
+    toFree = std::move(entry->data());
+    entry->tinyData_.clear();
+    removeEntryLocked(entry);
+  }
+  ClockTimer t(allocClocks_);
+  auto numPages = toFree.numPages();
+  cache_->free(toFree);
+  cache_->incrementCachedPages(-static_cast<int64_t>(numPages));
+}
+
 void CacheShard::removeEntryLocked(AsyncDataCacheEntry* entry) {
   if (entry->key_.fileNum.hasValue()) {
-    auto removeIter = entryMap_.find(
-        RawFileCacheKey{entry->key_.fileNum.id(), entry->key_.offset});
-    VELOX_CHECK(removeIter != entryMap_.end());
-    entryMap_.erase(removeIter);
-    entry->key_.fileNum.clear();
+    if (!entry->isUncached_) {
+      auto removeIter = entryMap_.find(
+          RawFileCacheKey{entry->key_.fileNum.id(), entry->key_.offset});
+      VELOX_CHECK(removeIter != entryMap_.end());
+      entryMap_.erase(removeIter);
+    }
+    clearKeyLocked(entry);
     entry->setSsdFile(nullptr, 0);
     if (entry->isPrefetch()) {
       entry->setPrefetch(false);
@@ -317,7 +484,117 @@ void CacheShard::removeEntryLocked(AsyncDataCacheEntry* entry) {
   }
 }
 
+void CacheShard::clearKeyLocked(AsyncDataCacheEntry* entry) {
+  entry->key_.fileNum.clear();
+  cache_->quotaGroup(entry->quotaGroup_).bytes -= entry->size_;
+  if (entry->isCompressed()) {
+    cache_->releaseCompressed(entry->compressed_.size());
+    std::string().swap(entry->compressed_);
+  }
+}
+
+bool CacheShard::shouldCompressLocked(const AsyncDataCacheEntry& entry) const {
+  return cache_->hasCompression() && entry.key_.fileNum.hasValue() &&
+      !entry.isCompressed() && entry.data_.numPages() > 0 &&
+      !entry.isLowPriority_ && !entry.isPrefetch_ && !entry.ssdSaveable_ &&
+      !entry.isUncached_;
+}
+
+void CacheShard::compressEntries(
+    const std::vector<AsyncDataCacheEntry*>& entries,
+    const std::vector<int32_t>& indices,
+    std::vector<MappedMemory::Allocation>& toFree) {
+  auto codec = folly::io::getCodec(cache_->compressionCodec());
+  std::vector<std::string> compressed(entries.size());
+  for (auto i = 0; i < entries.size(); ++i) {
+    auto entry = entries[i];
+    auto& data = entry->data_;
+    std::unique_ptr<folly::IOBuf> input;
+    int64_t bytesLeft = entry->size_;
+    for (auto runIndex = 0; runIndex < data.numRuns() && bytesLeft > 0;
+         ++runIndex) {
+      auto run = data.runAt(runIndex);
+      auto bytes = std::min<int64_t>(bytesLeft, run.numBytes());
+      auto buffer = folly::IOBuf::wrapBuffer(run.data<char>(), bytes);
+      if (input) {
+        input->prependChain(std::move(buffer));
+      } else {
+        input = std::move(buffer);
+      }
+      bytesLeft -= bytes;
+    }
+    try {
+      auto output = codec->compress(input.get());
+      auto size = output->computeChainDataLength();
+      // Data that does not compress well is not worth the CPU of
+      // decompressing on every hit.
+      if (size <= entry->size_ / 4 * 3 && cache_->reserveCompressed(size)) {
+        output->coalesce();
+        compressed[i].assign(
+            reinterpret_cast<const char*>(output->data()), size);
+      }
+    } catch (const std::exception& e) {
+      LOG(WARNING) << "Error compressing cache entry: " << e.what();
+    }
+  }
+  std::vector<std::unique_ptr<folly::SharedPromise<bool>>> promises;
+  {
+    std::lock_guard<std::mutex> l(mutex_);
+    for (auto i = 0; i < entries.size(); ++i) {
+      auto entry = entries[i];
+      entry->numPins_ = 0;
+      if (entry->promise_) {
+        promises.push_back(std::move(entry->promise_));
+      }
+      if (compressed[i].empty()) {
+        // The caller has counted the memory of the entry as freed.
+        int64_t tinyFreed = 0;
+        int64_t largeFreed = 0;
+        evictLocked(indices[i], toFree, tinyFreed, largeFreed);
+        continue;
+      }
+      ++numCompress_;
+      entry->compressed_ = std::move(compressed[i]);
+      toFree.push_back(std::move(entry->data()));
+      // Starts the life of the entry in the compressed tier, so that
+      // it is not evicted on the next pass of the clock hand.
+      entry->accessStats_.lastUse = accessTime();
+    }
+  }
+  for (auto& promise : promises) {
+    promise->setValue(true);
+  }
+}
+
+void CacheShard::evictLocked(
+    int32_t entryIndex,
+    std::vector<MappedMemory::Allocation>& toFree,
+    int64_t& tinyFreed,
+    int64_t& largeFreed) {
+  auto& slot = entries_[entryIndex];
+  auto candidate = slot.get();
+  if (candidate->key_.fileNum.hasValue()) {
+    ++cache_->quotaGroup(candidate->quotaGroup_).numEvict;
+    if (candidate->isPrefetch_) {
+      ++numWastedPrefetch_;
+      wastedPrefetchBytes_ += candidate->size_;
+    }
+  }
+  largeFreed += candidate->data_.byteSize();
+  toFree.push_back(std::move(candidate->data()));
+  removeEntryLocked(candidate);
+  freeEntries_.push_back(std::move(slot));
+  emptySlots_.push_back(entryIndex);
+  tinyFreed += candidate->tinyData_.size();
+  candidate->tinyData_.clear();
+  candidate->size_ = 0;
+  ++numEvict_;
+}
+
 void CacheShard::evict(uint64_t bytesToFree, bool evictAllUnpinned) {
+  ClockTimer evictTimer(evictClocks_);
+  // Bounds the compression work done by one thread that needs memory.
+  constexpr int32_t kMaxCompressPerEvict = 8;
   int64_t tinyFreed = 0;
   int64_t largeFreed = 0;
   int32_t evictSaveableSkipped = 0;
@@ -325,17 +602,40 @@ void CacheShard::evict(uint64_t bytesToFree, bool evictAllUnpinned) {
   bool skipSsdSaveable = ssdCache && ssdCache->writeInProgress();
   auto now = accessTime();
   std::vector<MappedMemory::Allocation> toFree;
+  std::vector<AsyncDataCacheEntry*> toCompress;
+  std::vector<int32_t> toCompressIndices;
   {
     std::lock_guard<std::mutex> l(mutex_);
     int size = entries_.size();
     if (!size) {
       return;
     }
+    if (!evictAllUnpinned && cache_->anyOverSoftQuota()) {
+      // Entries of groups over their soft quota go first, whatever
+      // their score.
+      for (auto i = 0; i < size; ++i) {
+        auto candidate = entries_[i].get();
+        if (!candidate || candidate->numPins_ != 0 ||
+            !candidate->key_.fileNum.hasValue() ||
+            !cache_->quotaGroup(candidate->quotaGroup_).isOverSoftQuota()) {
+          continue;
+        }
+        ++numEvictChecks_;
+        if (skipSsdSaveable && candidate->ssdSaveable_) {
+          ++evictSaveableSkipped;
+          continue;
+        }
+        evictLocked(i, toFree, tinyFreed, largeFreed);
+        if (largeFreed + tinyFreed > bytesToFree) {
+          break;
+        }
+      }
+    }
     int32_t counter = 0;
     int32_t numChecked = 0;
     auto entryIndex = (clockHand_ % size);
     auto iter = entries_.begin() + entryIndex;
-    while (++counter <= size) {
+    while (largeFreed + tinyFreed <= bytesToFree && ++counter <= size) {
       if (++iter == entries_.end()) {
         iter = entries_.begin();
         entryIndex = 0;
@@ -360,22 +660,25 @@ void CacheShard::evict(uint64_t bytesToFree, bool evictAllUnpinned) {
       int32_t score = 0;
       if (candidate->numPins_ == 0 &&
           (!candidate->key_.fileNum.hasValue() || evictAllUnpinned ||
+           candidate->isLowPriority_ ||
            (score = candidate->score(now)) >= evictionThreshold_)) {
         if (skipSsdSaveable && candidate->ssdSaveable_ && !evictAllUnpinned) {
           ++evictSaveableSkipped;
           continue;
         }
-        largeFreed += candidate->data_.byteSize();
-        toFree.push_back(std::move(candidate->data()));
-        removeEntryLocked(candidate);
-        freeEntries_.push_back(std::move(*iter));
-        emptySlots_.push_back(entryIndex);
-        tinyFreed += candidate->tinyData_.size();
-        candidate->tinyData_.clear();
-        candidate->size_ = 0;
-        ++numEvict_;
-        if (score) {
-          sumEvictScore_ += score;
+        if (!evictAllUnpinned && toCompress.size() < kMaxCompressPerEvict &&
+            shouldCompressLocked(*candidate)) {
+          // Compressed after leaving 'mutex_'. Exclusive meanwhile, so
+          // that it is neither read nor evicted.
+          candidate->numPins_ = AsyncDataCacheEntry::kExclusive;
+          toCompress.push_back(candidate);
+          toCompressIndices.push_back(entryIndex);
+          largeFreed += candidate->data_.byteSize();
+        } else {
+          evictLocked(entryIndex, toFree, tinyFreed, largeFreed);
+          if (score) {
+            sumEvictScore_ += score;
+          }
         }
         if (largeFreed + tinyFreed > bytesToFree) {
           break;
@@ -383,6 +686,9 @@ void CacheShard::evict(uint64_t bytesToFree, bool evictAllUnpinned) {
       }
     }
   }
+  if (!toCompress.empty()) {
+    compressEntries(toCompress, toCompressIndices, toFree);
+  }
   ClockTimer t(allocClocks_);
   toFree.clear();
   cache_->incrementCachedPages(
@@ -421,6 +727,20 @@ void CacheShard::calibrateThreshold() {
       80);
 }
 
+void CacheShard::addResidency(
+    const folly::F14FastSet<uint64_t>* fileNums,
+    FileResidencyMap& residency) const {
+  std::lock_guard<std::mutex> l(mutex_);
+  for (auto& [key, entry] : entryMap_) {
+    if (fileNums && !fileNums->count(key.fileNum)) {
+      continue;
+    }
+    auto& file = residency[key.fileNum];
+    ++file.numEntries;
+    file.bytes += entry->size();
+  }
+}
+
 void CacheShard::updateStats(CacheStats& stats) {
   std::lock_guard<std::mutex> l(mutex_);
   for (auto& entry : entries_) {
@@ -437,6 +757,12 @@ void CacheShard::updateStats(CacheStats& stats) {
       stats.prefetchBytes += entry->size();
     }
     ++stats.numEntries;
+    if (entry->isCompressed()) {
+      ++stats.numCompressed;
+      stats.compressedDataSize += entry->size_;
+      stats.compressedSize += entry->compressed_.size();
+      continue;
+    }
     stats.tinySize += entry->tinyData_.size();
     stats.tinyPadding += entry->tinyData_.capacity() - entry->tinyData_.size();
     stats.largeSize += entry->size_;
@@ -448,7 +774,14 @@ void CacheShard::updateStats(CacheStats& stats) {
   stats.numEvictChecks += numEvictChecks_;
   stats.numWaitExclusive += numWaitExclusive_;
   stats.sumEvictScore += sumEvictScore_;
+  stats.numLowFrequency += numLowFrequency_;
+  stats.numWastedPrefetch += numWastedPrefetch_;
+  stats.wastedPrefetchBytes += wastedPrefetchBytes_;
+  stats.numCompress += numCompress_;
+  stats.numDecompress += numDecompress_;
   stats.allocClocks += allocClocks_;
+  stats.evictClocks += evictClocks_;
+  stats.numLockWaits += numLockWaits_;
 }
 
 void CacheShard::appendSsdSaveable(std::vector<CachePin>& pins) {
@@ -460,7 +793,7 @@ void CacheShard::appendSsdSaveable(std::vector<CachePin>& pins) {
   VELOX_CHECK(cache_->ssdCache()->writeInProgress());
   for (auto& entry : entries_) {
     if (entry && !entry->ssdFile_ && !entry->isExclusive() &&
-        entry->ssdSaveable_) {
+        entry->ssdSaveable_ && !entry->isCompressed()) {
       CachePin pin;
       ++entry->numPins_;
       pin.setEntry(entry.get());
@@ -477,12 +810,19 @@ void CacheShard::appendSsdSaveable(std::vector<CachePin>& pins) {
 AsyncDataCache::AsyncDataCache(
     const std::shared_ptr<MappedMemory>& mappedMemory,
     uint64_t maxBytes,
-    std::unique_ptr<SsdCache> ssdCache)
+    std::unique_ptr<SsdCache> ssdCache,
+    int32_t numShards)
     : mappedMemory_(mappedMemory),
       ssdCache_(std::move(ssdCache)),
+      numShards_(numShards),
+      shardMask_(numShards - 1),
       cachedPages_(0),
       maxBytes_(maxBytes) {
-  for (auto i = 0; i < kNumShards; ++i) {
+  VELOX_CHECK(
+      numShards_ > 0 && bits::isPowerOfTwo(numShards_),
+      "Number of cache shards must be a power of 2: {}",
+      numShards_);
+  for (auto i = 0; i < numShards_; ++i) {
     shards_.push_back(std::make_unique<CacheShard>(this));
   }
 }
@@ -490,13 +830,14 @@ AsyncDataCache::AsyncDataCache(
 CachePin AsyncDataCache::findOrCreate(
     RawFileCacheKey key,
     uint64_t size,
-    folly::SemiFuture<bool>* wait) {
-  int shard = std::hash<RawFileCacheKey>()(key) & (kShardMask);
-  return shards_[shard]->findOrCreate(key, size, wait);
+    folly::SemiFuture<bool>* wait,
+    int32_t quotaGroup) {
+  int shard = std::hash<RawFileCacheKey>()(key) & shardMask_;
+  return shards_[shard]->findOrCreate(key, size, wait, quotaGroup);
 }
 
 bool AsyncDataCache::exists(RawFileCacheKey key) const {
-  int shard = std::hash<RawFileCacheKey>()(key) & (kShardMask);
+  int shard = std::hash<RawFileCacheKey>()(key) & shardMask_;
   return shards_[shard]->exists(key);
 }
 
@@ -515,7 +856,7 @@ bool AsyncDataCache::makeSpace(
   // serialize with a mutex because memory arbitration must not be
   // called from inside a global mutex.
 
-  constexpr int32_t kMaxAttempts = kNumShards * 4;
+  const int32_t maxAttempts = numShards_ * 4;
   // If requesting less than kSmallSizePages try up to 4x more if
   // first try failed.
   constexpr int32_t kSmallSizePages = 2048; // 8MB
@@ -533,7 +874,7 @@ bool AsyncDataCache::makeSpace(
     rank = ++numThreadsInAllocate_;
     isCounted = true;
   }
-  for (auto nthAttempt = 0; nthAttempt < kMaxAttempts; ++nthAttempt) {
+  for (auto nthAttempt = 0; nthAttempt < maxAttempts; ++nthAttempt) {
     if (mappedMemory_->numAllocated() + numPages <
         maxBytes_ / MappedMemory::kPageSize) {
       try {
@@ -555,7 +896,7 @@ bool AsyncDataCache::makeSpace(
                 << "cach write to unpin memory";
       std::this_thread::sleep_for(std::chrono::milliseconds(500)); // NOLINT
     }
-    if (nthAttempt > kMaxAttempts / 2) {
+    if (nthAttempt > maxAttempts / 2) {
       if (!isCounted) {
         rank = ++numThreadsInAllocate_;
         isCounted = true;
@@ -568,9 +909,9 @@ bool AsyncDataCache::makeSpace(
     // Evict from next shard. If we have gone through all shards once
     // and still have not made the allocation, we go to desperate mode
     // with 'evictAllUnpinned' set to true.
-    shards_[shardCounter_ & (kShardMask)]->evict(
+    shards_[shardCounter_ & shardMask_]->evict(
         numPages * sizeMultiplier * MappedMemory::kPageSize,
-        nthAttempt >= kNumShards);
+        nthAttempt >= numShards_);
     if (numPages < kSmallSizePages && sizeMultiplier < 4) {
       sizeMultiplier *= 2;
     }
@@ -666,6 +1007,187 @@ void AsyncDataCache::clear() {
   }
 }
 
+void AsyncDataCache::setAdmission(CacheAdmission admission) {
+  // One counter per page of capacity, divided among the shards.
+  auto sketchWidth = std::clamp<int64_t>(
+      maxBytes_ / (numShards_ * MappedMemory::kPageSize), 1 << 10, 1 << 16);
+  admission_ = admission;
+  for (auto& shard : shards_) {
+    shard->setAdmission(admission, sketchWidth);
+  }
+}
+
+int32_t AsyncDataCache::quotaGroupId(const std::string& name) {
+  if (name.empty()) {
+    return kDefaultQuotaGroup;
+  }
+  std::lock_guard<std::mutex> l(quotaMutex_);
+  auto it = quotaGroupIds_.find(name);
+  if (it != quotaGroupIds_.end()) {
+    return it->second;
+  }
+  int32_t id = numQuotaGroups_;
+  VELOX_USER_CHECK_LT(
+      id, kMaxQuotaGroups, "Too many cache quota groups, adding {}", name);
+  quotaGroups_[id].name = name;
+  quotaGroupIds_[name] = id;
+  // Publishes the group to readers that do not take 'quotaMutex_'.
+  numQuotaGroups_ = id + 1;
+  return id;
+}
+
+void AsyncDataCache::setQuota(
+    const std::string& name,
+    int64_t softBytes,
+    int64_t hardBytes) {
+  VELOX_USER_CHECK(!name.empty(), "The default quota group has no quota");
+  VELOX_USER_CHECK_GE(softBytes, 0);
+  VELOX_USER_CHECK_GE(hardBytes, 0);
+  VELOX_USER_CHECK(
+      !hardBytes || softBytes <= hardBytes,
+      "Soft cache quota {} is above hard quota {}",
+      softBytes,
+      hardBytes);
+  auto& group = quotaGroup(quotaGroupId(name));
+  group.softBytes = softBytes;
+  group.hardBytes = hardBytes;
+}
+
+bool AsyncDataCache::anyOverSoftQuota() const {
+  int32_t numGroups = numQuotaGroups_;
+  for (auto i = 1; i < numGroups; ++i) {
+    if (quotaGroups_[i].isOverSoftQuota()) {
+      return true;
+    }
+  }
+  return false;
+}
+
+void AsyncDataCache::setCompression(
+    int64_t maxCompressedBytes,
+    folly::io::CodecType codecType) {
+  VELOX_CHECK(
+      folly::io::hasCodec(codecType),
+      "Codec {} is not available for the compressed cache tier",
+      static_cast<int>(codecType));
+  maxCompressedBytes_ = maxCompressedBytes;
+  compressionCodec_ = codecType;
+}
+
+bool AsyncDataCache::reserveCompressed(int64_t bytes) {
+  if (!maxCompressedBytes_) {
+    return false;
+  }
+  if (compressedBytes_.fetch_add(bytes) + bytes > maxCompressedBytes_) {
+    compressedBytes_ -= bytes;
+    return false;
+  }
+  return true;
+}
+
+std::vector<FileResidency> AsyncDataCache::residency(
+    const std::vector<std::string>& paths) const {
+  std::vector<FileResidency> result(paths.size());
+  folly::F14FastSet<uint64_t> fileNums;
+  for (auto i = 0; i < paths.size(); ++i) {
+    result[i].path = paths[i];
+    // Does not register the paths that are not known.
+    result[i].fileNum = fileIds().id(paths[i]);
+    if (result[i].fileNum != StringIdMap::kNoId) {
+      fileNums.insert(result[i].fileNum);
+    }
+  }
+  if (fileNums.empty()) {
+    return result;
+  }
+  FileResidencyMap residency;
+  for (auto& shard : shards_) {
+    shard->addResidency(&fileNums, residency);
+  }
+  if (ssdCache_) {
+    ssdCache_->addResidency(&fileNums, residency);
+  }
+  for (auto& file : result) {
+    auto it = residency.find(file.fileNum);
+    if (it != residency.end()) {
+      file.numEntries = it->second.numEntries;
+      file.bytes = it->second.bytes;
+      file.numSsdEntries = it->second.numSsdEntries;
+      file.ssdBytes = it->second.ssdBytes;
+    }
+  }
+  return result;
+}
+
+std::vector<FileResidency> AsyncDataCache::topResidency(
+    int32_t maxFiles) const {
+  FileResidencyMap residency;
+  for (auto& shard : shards_) {
+    shard->addResidency(nullptr, residency);
+  }
+  if (ssdCache_) {
+    ssdCache_->addResidency(nullptr, residency);
+  }
+  std::vector<FileResidency> result;
+  result.reserve(residency.size());
+  for (auto& [fileNum, file] : residency) {
+    result.push_back(std::move(file));
+    result.back().fileNum = fileNum;
+  }
+  auto numFiles = std::min<int32_t>(maxFiles, result.size());
+  std::partial_sort(
+      result.begin(),
+      result.begin() + numFiles,
+      result.end(),
+      [](const FileResidency& left, const FileResidency& right) {
+        return left.totalBytes() > right.totalBytes();
+      });
+  result.resize(numFiles);
+  for (auto& file : result) {
+    file.path = fileIds().string(file.fileNum);
+  }
+  return result;
+}
+
+std::vector<CacheQuotaStats> AsyncDataCache::quotaStats() const {
+  std::lock_guard<std::mutex> l(quotaMutex_);
+  std::vector<CacheQuotaStats> result;
+  for (auto i = 0; i < numQuotaGroups_; ++i) {
+    auto& group = quotaGroups_[i];
+    CacheQuotaStats stats;
+    stats.name = group.name;
+    stats.softBytes = group.softBytes;
+    stats.hardBytes = group.hardBytes;
+    stats.bytes = group.bytes;
+    stats.numHit = group.numHit;
+    stats.numNew = group.numNew;
+    stats.numEvict = group.numEvict;
+    result.push_back(std::move(stats));
+  }
+  return result;
+}
+
+std::string FileResidency::toString() const {
+  return fmt::format(
+      "{}: {} entries {} bytes, SSD {} entries {} bytes",
+      path,
+      numEntries,
+      bytes,
+      numSsdEntries,
+      ssdBytes);
+}
+
+std::string CacheQuotaStats::toString() const {
+  return fmt::format(
+      "{}: {} bytes, quota {} / {} hit rate {:.2f} evict {}",
+      name.empty() ? "<default>" : name,
+      bytes,
+      softBytes,
+      hardBytes,
+      hitRate(),
+      numEvict);
+}
+
 std::string AsyncDataCache::toString() const {
   auto stats = refreshStats();
   std::stringstream out;
@@ -674,12 +1196,29 @@ std::string AsyncDataCache::toString() const {
           stats.largePadding
       << " / " << maxBytes_ << " bytes\n"
       << "Miss: " << stats.numNew << " Hit " << stats.numHit << " evict "
-      << stats.numEvict << "\n"
+      << stats.numEvict << " low frequency " << stats.numLowFrequency
+      << "\n"
       << " read pins " << stats.numShared << " write pins "
       << stats.numExclusive << " unused prefetch " << stats.numPrefetch
+      << " wasted prefetch " << stats.numWastedPrefetch << " / "
+      << stats.wastedPrefetchBytes << " bytes"
       << " Alloc Megaclocks " << (stats.allocClocks >> 20)
+      << " evict Megaclocks " << (stats.evictClocks >> 20)
+      << " shard lock waits " << stats.numLockWaits
       << " allocated pages " << numAllocated() << " cached pages "
       << cachedPages_;
+  if (hasCompression()) {
+    out << "\nCompressed: " << stats.numCompressed << " entries "
+        << stats.compressedDataSize << " bytes in " << stats.compressedSize
+        << " / " << maxCompressedBytes_ << " bytes, compress "
+        << stats.numCompress << " decompress " << stats.numDecompress;
+  }
+  auto quotas = quotaStats();
+  if (quotas.size() > 1) {
+    for (auto& quota : quotas) {
+      out << "\nQuota group " << quota.toString();
+    }
+  }
   out << "\nBacking: " << mappedMemory_->toString();
   if (ssdCache_) {
     out << "\nSSD: " << ssdCache_->toString();
@@ -16,15 +16,19 @@
 
 #pragma once
 
+#include <array>
 #include <deque>
 
 #include <fmt/format.h>
 #include <folly/chrono/Hardware.h>
+#include <folly/compression/Compression.h>
+#include <folly/container/F14Set.h>
 #include <folly/futures/SharedPromise.h>
 #include "velox/common/base/BitUtil.h"
 #include "velox/common/base/CoalesceIo.h"
 #include "velox/common/base/SelectivityInfo.h"
 #include "velox/common/caching/FileGroupStats.h"
+#include "velox/common/caching/FrequencySketch.h"
 #include "velox/common/caching/ScanTracker.h"
 #include "velox/common/caching/StringIdMap.h"
 #include "velox/common/file/File.h"
@@ -174,6 +178,11 @@ class AsyncDataCacheEntry {
     accessStats_.touch();
   }
 
+  // True if 'this' was not admitted to the cache. See CacheAdmission.
+  bool isUncached() const {
+    return isUncached_;
+  }
+
   int32_t score(AccessTime now) const {
     return accessStats_.score(now, size_);
   }
@@ -231,6 +240,19 @@ class AsyncDataCacheEntry {
     groupId_ = groupId;
   }
 
+  // Id of the quota group that 'this' is charged to. See
+  // AsyncDataCache::quotaGroupId().
+  int32_t quotaGroup() const {
+    return quotaGroup_;
+  }
+
+  // True if the data of 'this' is in the compressed tier. Such an
+  // entry is never pinned. A hit decompresses it before returning the
+  // pin. See AsyncDataCache::setCompression().
+  bool isCompressed() const {
+    return !compressed_.empty();
+  }
+
   std::string toString() const;
 
  private:
@@ -258,6 +280,11 @@ class AsyncDataCacheEntry {
   // (kTinyDataSize).
   std::string tinyData_;
 
+  // The compressed data if 'this' is in the compressed tier. 'data_'
+  // is then empty. Set and cleared inside the shard's mutex while
+  // 'this' is exclusive.
+  std::string compressed_;
+
   std::unique_ptr<folly::SharedPromise<bool>> promise_;
   int32_t size_{0};
 
@@ -282,6 +309,10 @@ class AsyncDataCacheEntry {
   // Tracking id. Used for deciding if this should be written to SSD.
   TrackingId trackingId_;
 
+  // Quota group that 'size_' is charged to. Set inside the shard's
+  // mutex when 'this' is created.
+  int32_t quotaGroup_{0};
+
   // SSD file from which this was loaded or nullptr if not backed by
   // SsdFile. Used to avoid re-adding items that already come from
   // SSD. The exact file and offset are needed to include uses in RAM
@@ -295,6 +326,17 @@ class AsyncDataCacheEntry {
   // True if this should be saved to SSD.
   bool ssdSaveable_{false};
 
+  // True if the key of 'this' was less frequently accessed than the
+  // eviction candidate when 'this' was created. 'this' is evicted at
+  // first sight when unpinned. Cleared by a hit.
+  bool isLowPriority_{false};
+
+  // True if 'this' is not in the shard's map, so that only the pins
+  // made at creation see it. Such an entry is always low priority, is
+  // not saved to SSD and is freed with its last pin. Also set for the
+  // misses of a quota group over its hard quota.
+  bool isUncached_{false};
+
   friend class CacheShard;
   friend class CachePin;
 };
@@ -476,9 +518,122 @@ struct CacheStats {
   // Cumulative clocks spent in allocating or freeing memory  for backing cache
   // entries.
   uint64_t allocClocks{};
+  // Cumulative clocks spent in evicting entries to make space, including
+  // freeing their memory.
+  uint64_t evictClocks{};
+  // Number of findOrCreate() calls that found the shard mutex held by
+  // another thread.
+  int64_t numLockWaits{};
   // Sum of scores of evicted entries. This serves to infer an average
   // lifetime for entries in cache.
   int64_t sumEvictScore{};
+  // Number of new entries whose key was less frequently accessed than
+  // the eviction candidate. These are cached at low priority or not at
+  // all, depending on CacheAdmission.
+  int64_t numLowFrequency{};
+  // Number and total size of prefetched entries that were evicted
+  // before their first hit.
+  int64_t numWastedPrefetch{};
+  int64_t wastedPrefetchBytes{};
+  // Number of entries in the compressed tier, their uncompressed size
+  // and the size of their compressed data.
+  int32_t numCompressed{};
+  int64_t compressedDataSize{};
+  int64_t compressedSize{};
+  // Number of entries moved to the compressed tier and number of hits
+  // that decompressed an entry.
+  int64_t numCompress{};
+  int64_t numDecompress{};
+};
+
+// A named group of cache entries with optional byte quotas, e.g. the
+// entries read by the queries of one tenant. An entry is charged to
+// the group of the findOrCreate() that created it. A quota of 0 means
+// no limit. The counters are updated by all shards without locking.
+struct CacheQuotaGroup {
+  std::string name;
+  // Above this, unpinned entries of the group are evicted before any
+  // other entries.
+  std::atomic<int64_t> softBytes{0};
+  // Above this, misses of the group are not cached, as with
+  // CacheAdmission::kScanResistant.
+  std::atomic<int64_t> hardBytes{0};
+  // Total size of the entries charged to the group.
+  std::atomic<int64_t> bytes{0};
+  // Hits and misses by findOrCreate() calls for the group. A hit
+  // counts whichever group the hit entry is charged to.
+  std::atomic<int64_t> numHit{0};
+  std::atomic<int64_t> numNew{0};
+  // Number of entries of the group removed to make space.
+  std::atomic<int64_t> numEvict{0};
+
+  bool isOverSoftQuota() const {
+    auto limit = softBytes.load();
+    return limit && bytes > limit;
+  }
+
+  bool isOverHardQuota() const {
+    auto limit = hardBytes.load();
+    return limit && bytes > limit;
+  }
+};
+
+// Snapshot of a CacheQuotaGroup.
+struct CacheQuotaStats {
+  std::string name;
+  int64_t softBytes{};
+  int64_t hardBytes{};
+  int64_t bytes{};
+  int64_t numHit{};
+  int64_t numNew{};
+  int64_t numEvict{};
+
+  // Fraction of the lookups of the group that were hits.
+  double hitRate() const {
+    return numHit + numNew ? numHit / static_cast<double>(numHit + numNew)
+                           : 0;
+  }
+
+  std::string toString() const;
+};
+
+// Amount of the data of one file that is cached. Lets whoever assigns
+// splits send the splits of a file to a worker that has its data.
+struct FileResidency {
+  // Id of the file in fileIds(). StringIdMap::kNoId if the file has
+  // not been read by this process.
+  uint64_t fileNum{StringIdMap::kNoId};
+  std::string path;
+  // Number and total size of the entries of the file in memory.
+  int32_t numEntries{};
+  int64_t bytes{};
+  // Number and total size of the entries of the file on SSD.
+  int32_t numSsdEntries{};
+  int64_t ssdBytes{};
+
+  int64_t totalBytes() const {
+    return bytes + ssdBytes;
+  }
+
+  std::string toString() const;
+};
+
+// Map from file number to the cached amount of the file.
+using FileResidencyMap = folly::F14FastMap<uint64_t, FileResidency>;
+
+// Policy for creating entries for misses when the cache is full.
+enum class CacheAdmission {
+  // Every miss is cached.
+  kAll,
+  // A miss whose key is accessed less often than the key of the next
+  // eviction candidate is cached at low priority, i.e. it is evicted
+  // first after it is unpinned unless it is hit before that.
+  kFrequency,
+  // Like kFrequency but such a miss is not cached at all. The caller
+  // gets an exclusive pin to load the data into as for any miss but
+  // other callers do not find the entry. This keeps one-time scans from
+  // evicting frequently read data.
+  kScanResistant
 };
 // Collection of cache entries whose key hashes to the same shard of
 // the hash number space.  The cache population is divided into shards
@@ -494,7 +649,8 @@ class CacheShard {
   CachePin findOrCreate(
       RawFileCacheKey key,
       uint64_t size,
-      folly::SemiFuture<bool>* FOLLY_NULLABLE readyFuture);
+      folly::SemiFuture<bool>* FOLLY_NULLABLE readyFuture,
+      int32_t quotaGroup);
 
   // Returns true if there is an entry for 'key'. Updates access time.
   bool exists(RawFileCacheKey key) const;
@@ -508,14 +664,20 @@ class CacheShard {
 
   // removes 'bytesToFree' worth of entries or as many entries as are
   // not pinned. This favors first removing older and less frequently
-  // used entries. If 'evictAllUnpinned' is true, anything that is
-  // not pinned is evicted at first sight. This is for out of memory
-  // emergencies.
+  // used entries. If some quota group is over its soft quota, the
+  // unpinned entries of such groups are removed first. If
+  // 'evictAllUnpinned' is true, anything that is not pinned is
+  // evicted at first sight. This is for out of memory emergencies.
   void evict(uint64_t bytesToFree, bool evictAllUnpinned);
 
   // Removes 'entry' from 'this'.
   void removeEntry(AsyncDataCacheEntry* FOLLY_NONNULL entry);
 
+  // Drops a pin on an uncached 'entry'. The last pin frees the memory
+  // of 'entry', so that one-time reads do not need to evict cached
+  // data.
+  void releaseUncached(AsyncDataCacheEntry* FOLLY_NONNULL entry);
+
   // Adds the stats of 'this' to 'stats'.
   void updateStats(CacheStats& stats);
 
@@ -526,14 +688,61 @@ class CacheShard {
   // calling this a second time.
   void appendSsdSaveable(std::vector<CachePin>& pins);
 
+  // Adds the size of each entry of 'this' to the element of
+  // 'residency' for its file. If 'fileNums' is given, only counts the
+  // entries of these files.
+  void addResidency(
+      const folly::F14FastSet<uint64_t>* FOLLY_NULLABLE fileNums,
+      FileResidencyMap& residency) const;
+
   auto& allocClocks() {
     return allocClocks_;
   }
 
+  // Sets the admission policy for new entries. Makes or drops the
+  // frequency sketch.
+  void setAdmission(CacheAdmission admission, int32_t sketchWidth);
+
  private:
   static constexpr int32_t kNoThreshold = std::numeric_limits<int32_t>::max();
   void calibrateThreshold();
   void removeEntryLocked(AsyncDataCacheEntry* FOLLY_NONNULL entry);
+
+  // Removes the key of 'entry' and uncharges its size from its quota
+  // group. Does not remove 'entry' from 'entryMap_'.
+  void clearKeyLocked(AsyncDataCacheEntry* FOLLY_NONNULL entry);
+
+  // True if the unpinned 'entry' should go to the compressed tier
+  // instead of being evicted.
+  bool shouldCompressLocked(const AsyncDataCacheEntry& entry) const;
+
+  // Moves the data of 'entries' to the compressed tier. The entries
+  // are exclusive and their indices in 'entries_' are in 'indices'.
+  // Entries that do not compress well are evicted. The memory to
+  // free is appended to 'toFree'.
+  void compressEntries(
+      const std::vector<AsyncDataCacheEntry*>& entries,
+      const std::vector<int32_t>& indices,
+      std::vector<memory::MappedMemory::Allocation>& toFree);
+
+  // Decompresses the entry of the exclusive 'pin' and returns a shared
+  // pin on it. If there is no memory for the data, drops the entry
+  // and returns findOrCreate() of the other arguments.
+  CachePin decompress(
+      CachePin pin,
+      RawFileCacheKey key,
+      uint64_t size,
+      folly::SemiFuture<bool>* FOLLY_NULLABLE readyFuture,
+      int32_t quotaGroup);
+
+  // Makes the unpinned entry at 'entryIndex' in 'entries_' reusable.
+  // Moves its memory to 'toFree' and adds the freed sizes to
+  // 'tinyFreed' and 'largeFreed'.
+  void evictLocked(
+      int32_t entryIndex,
+      std::vector<memory::MappedMemory::Allocation>& toFree,
+      int64_t& tinyFreed,
+      int64_t& largeFreed);
   // Returns an unused entry if found. 'size' is a hint for selecting an entry
   // that already has the right amount of memory associated with it.
   std::unique_ptr<AsyncDataCacheEntry> getFreeEntryWithSize(uint64_t sizeHint);
@@ -541,6 +750,12 @@ class CacheShard {
       RawFileCacheKey key,
       AsyncDataCacheEntry* FOLLY_NONNULL entry);
 
+  // Returns true if a new entry of 'size' bytes for 'key' should be
+  // cached at normal priority, i.e. if the cache has space or 'key' is
+  // more frequent than the eviction candidate. Must be called inside
+  // 'mutex_'.
+  bool shouldAdmit(RawFileCacheKey key, uint64_t size);
+
   mutable std::mutex mutex_;
   folly::F14FastMap<RawFileCacheKey, AsyncDataCacheEntry * FOLLY_NONNULL>
       entryMap_;
@@ -558,6 +773,9 @@ class CacheShard {
   uint32_t eventCounter_{};
   // Maximum retainable entry score(). Anything above this is evictable.
   int32_t evictionThreshold_{kNoThreshold};
+  CacheAdmission admission_{CacheAdmission::kAll};
+  // Recent access counts by key. Set if 'admission_' is not kAll.
+  std::unique_ptr<FrequencySketch> frequencies_;
   // Cumulative count of cache hits.
   uint64_t numHit_{};
   // Cumulative count of hits on entries held in exclusive mode.
@@ -572,17 +790,38 @@ class CacheShard {
   // Sum of evict scores. This divided by 'numEvict_' correlates to
   // time data stays in cache.
   uint64_t sumEvictScore_{};
+  // Count of new entries below the frequency of the eviction candidate.
+  uint64_t numLowFrequency_{};
+  // Count and bytes of prefetched entries evicted without being hit.
+  uint64_t numWastedPrefetch_{};
+  uint64_t wastedPrefetchBytes_{};
+  // Count of entries moved to the compressed tier and of hits that
+  // decompressed an entry.
+  uint64_t numCompress_{};
+  uint64_t numDecompress_{};
+  // Count of findOrCreate() calls that waited for 'mutex_'.
+  uint64_t numLockWaits_{};
   // Tracker of time spent in allocating/freeing MappedMemory space
   // for backing cached data.
   std::atomic<uint64_t> allocClocks_;
+  // Tracker of time spent in evict().
+  std::atomic<uint64_t> evictClocks_{0};
 };
 
 class AsyncDataCache : public memory::MappedMemory {
  public:
+  // Quota group of entries made without a group. Has no quota.
+  static constexpr int32_t kDefaultQuotaGroup = 0;
+  static constexpr int32_t kMaxQuotaGroups = 64;
+  static constexpr int32_t kDefaultNumShards = 4;
+
+  // 'numShards' is the number of CacheShards, each with its own mutex. It
+  // must be a power of 2.
   AsyncDataCache(
       const std::shared_ptr<memory::MappedMemory>& mappedMemory,
       uint64_t maxBytes,
-      std::unique_ptr<SsdCache> ssdCache = nullptr);
+      std::unique_ptr<SsdCache> ssdCache = nullptr,
+      int32_t numShards = kDefaultNumShards);
 
   // Finds or creates a cache entry corresponding to 'key'. The entry
   // is returned in 'pin'. If the entry is new, it is pinned in
@@ -594,11 +833,15 @@ class AsyncDataCache : public memory::MappedMemory {
   // future that is realized when the pin is no longer exclusive. When
   // the future is realized, the caller may retry findOrCreate().
   // runtime error with code kNoCacheSpace if there is no space to create the
-  // new entry after evicting any unpinned content.
+  // new entry after evicting any unpinned content. With
+  // CacheAdmission::kScanResistant, a new entry may be uncached, see
+  // AsyncDataCacheEntry::isUncached(). A new entry is charged to
+  // 'quotaGroup', see quotaGroupId().
   CachePin findOrCreate(
       RawFileCacheKey key,
       uint64_t size,
-      folly::SemiFuture<bool>* FOLLY_NULLABLE waitFuture = nullptr);
+      folly::SemiFuture<bool>* FOLLY_NULLABLE waitFuture = nullptr,
+      int32_t quotaGroup = kDefaultQuotaGroup);
 
   // Returns true if there is an entry for 'key'. Updates access time.
   bool exists(RawFileCacheKey key) const;
@@ -692,9 +935,10 @@ class AsyncDataCache : public memory::MappedMemory {
   void makePins(
       const std::vector<RawFileCacheKey>& keys,
       SizeFunc sizeFunc,
-      ProcessPin processPin) {
+      ProcessPin processPin,
+      int32_t quotaGroup = kDefaultQuotaGroup) {
     for (auto i = 0; i < keys.size(); ++i) {
-      auto pin = findOrCreate(keys[i], sizeFunc(i), nullptr);
+      auto pin = findOrCreate(keys[i], sizeFunc(i), nullptr, quotaGroup);
       if (pin.empty() || pin.checkedEntry()->isShared()) {
         continue;
       }
@@ -705,6 +949,75 @@ class AsyncDataCache : public memory::MappedMemory {
   // Drops all unpinned entries. Pins stay valid.
   void clear();
 
+  // Sets the policy for caching misses when the cache is full. The
+  // default is CacheAdmission::kAll.
+  void setAdmission(CacheAdmission admission);
+
+  CacheAdmission admission() const {
+    return admission_;
+  }
+
+  // Turns on the compressed tier. Instead of being evicted, entries
+  // whose score is above the eviction threshold are compressed with
+  // 'codecType' as long as the compressed data of all entries is under
+  // 'maxCompressedBytes'. This memory is not part of maxBytes(). A hit
+  // on a compressed entry decompresses it. Entries that are less than
+  // 3/4 their size compressed, tiny entries, unhit prefetches and
+  // entries pending SSD save are evicted as before. Must be called
+  // before the cache is used. 0 turns the tier off.
+  void setCompression(
+      int64_t maxCompressedBytes,
+      folly::io::CodecType codecType = folly::io::CodecType::LZ4);
+
+  bool hasCompression() const {
+    return maxCompressedBytes_ > 0;
+  }
+
+  folly::io::CodecType compressionCodec() const {
+    return compressionCodec_;
+  }
+
+  // Reserves 'bytes' of the compressed tier. Returns false if the tier
+  // is off or full.
+  bool reserveCompressed(int64_t bytes);
+
+  // Returns 'bytes' reserved with reserveCompressed().
+  void releaseCompressed(int64_t bytes) {
+    compressedBytes_ -= bytes;
+  }
+
+  // Returns the id of the quota group 'name', registering the group
+  // if new. The empty name is kDefaultQuotaGroup. Throws if there
+  // are kMaxQuotaGroups groups.
+  int32_t quotaGroupId(const std::string& name);
+
+  // Sets the soft and hard byte quotas of the group 'name', see
+  // CacheQuotaGroup. 0 means no limit.
+  void setQuota(const std::string& name, int64_t softBytes, int64_t hardBytes);
+
+  CacheQuotaGroup& quotaGroup(int32_t id) {
+    VELOX_DCHECK_LT(id, numQuotaGroups_);
+    return quotaGroups_[id];
+  }
+
+  // True if some quota group is over its soft quota.
+  bool anyOverSoftQuota() const;
+
+  // Returns the stats of the registered quota groups, starting with
+  // kDefaultQuotaGroup.
+  std::vector<CacheQuotaStats> quotaStats() const;
+
+  // Returns how much of each of 'paths' is in memory and on SSD, in
+  // the order of 'paths'. Cheap enough to be called for every batch of
+  // splits to assign but not for every split.
+  std::vector<FileResidency> residency(
+      const std::vector<std::string>& paths) const;
+
+  // Returns the 'maxFiles' files with the most cached bytes, largest
+  // first. This is a compact summary of the cache contents for a
+  // coordinator to place splits by.
+  std::vector<FileResidency> topResidency(int32_t maxFiles) const;
+
   // Saves all entries with 'ssdSaveable_' to 'ssdCache_'.
   void saveToSsd();
 
@@ -717,9 +1030,6 @@ class AsyncDataCache : public memory::MappedMemory {
   }
 
  private:
-  static constexpr int32_t kNumShards = 4; // Must be power of 2.
-  static constexpr int32_t kShardMask = kNumShards - 1;
-
   // Waits a pseudorandom delay times 'counter'.
   void backoff(int32_t counter);
 
@@ -737,6 +1047,8 @@ class AsyncDataCache : public memory::MappedMemory {
 
   std::shared_ptr<memory::MappedMemory> mappedMemory_;
   std::unique_ptr<SsdCache> ssdCache_;
+  const int32_t numShards_;
+  const int32_t shardMask_;
   std::vector<std::unique_ptr<CacheShard>> shards_;
   int32_t shardCounter_{};
   std::atomic<memory::MachinePageCount> cachedPages_{0};
@@ -770,6 +1082,21 @@ class AsyncDataCache : public memory::MappedMemory {
   // Counter of threads competing for allocation in makeSpace(). Used
   // for setting staggered backoff. Mutexes are not allowed for this.
   std::atomic<int32_t> numThreadsInAllocate_{0};
+
+  CacheAdmission admission_{CacheAdmission::kAll};
+
+  // Serializes registering quota groups.
+  mutable std::mutex quotaMutex_;
+  folly::F14FastMap<std::string, int32_t> quotaGroupIds_;
+  // Indexed by quota group id. The first 'numQuotaGroups_' are in use.
+  std::array<CacheQuotaGroup, kMaxQuotaGroups> quotaGroups_;
+  std::atomic<int32_t> numQuotaGroups_{1};
+
+  // Capacity of the compressed tier. 0 if the tier is off.
+  int64_t maxCompressedBytes_{0};
+  folly::io::CodecType compressionCodec_{folly::io::CodecType::LZ4};
+  // Total size of the compressed data of the compressed tier.
+  std::atomic<int64_t> compressedBytes_{0};
 };
 
 // Samples a set of values T from 'numSamples' calls of
@@ -0,0 +1,76 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#include "velox/common/caching/FrequencySketch.h"
+#include "velox/common/base/BitUtil.h"
+#include "velox/common/base/Exceptions.h"
+
+#include <folly/hash/Hash.h>
+
+namespace facebook::velox::cache {
+
+FrequencySketch::FrequencySketch(int32_t width)
+    : widthMask_(bits::nextPowerOfTwo(std::max<int32_t>(width, 1)) - 1),
+      sampleSize_(kSamplesPerCounter * (widthMask_ + 1)),
+      counters_(kDepth * (widthMask_ + 1)) {
+  VELOX_CHECK_GT(width, 0);
+}
+
+int32_t FrequencySketch::index(uint64_t mixedHash, int32_t row) const {
+  // Double hashing. The odd step makes the rows independent for
+  // keys that collide in one row.
+  uint32_t step = (mixedHash >> 32) | 1;
+  return row * (widthMask_ + 1) +
+      ((static_cast<uint32_t>(mixedHash) + row * step) & widthMask_);
+}
+
+void FrequencySketch::record(uint64_t hash) {
+  // The cache shards on the low bits of the key hash, so remix.
+  auto mixed = folly::hash::twang_mix64(hash);
+  // Conservative update: only the smallest counters are incremented.
+  auto count = estimate(hash);
+  if (count < kMaxCount) {
+    for (auto row = 0; row < kDepth; ++row) {
+      auto& counter = counters_[index(mixed, row)];
+      if (counter == count) {
+        ++counter;
+      }
+    }
+  }
+  if (++numRecorded_ >= sampleSize_) {
+    reset();
+  }
+}
+
+int32_t FrequencySketch::estimate(uint64_t hash) const {
+  auto mixed = folly::hash::twang_mix64(hash);
+  int32_t count = kMaxCount;
+  for (auto row = 0; row < kDepth; ++row) {
+    count = std::min<int32_t>(count, counters_[index(mixed, row)]);
+  }
+  return count;
+}
+
+void FrequencySketch::reset() {
+  for (auto& counter : counters_) {
+    counter >>= 1;
+  }
+  numRecorded_ = 0;
+  ++numResets_;
+}
+
+} // namespace facebook::velox::cache
@@ -0,0 +1,79 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+namespace facebook::velox::cache {
+
+// Approximate count of recent accesses per key. Used for admitting a
+// new cache entry only if its key is accessed more often than the key
+// of the entry it would displace (TinyLFU). This is a count-min
+// sketch with kDepth rows of counters that saturate at kMaxCount. All
+// counters are halved after every 'kSamplesPerCounter' times width
+// recorded accesses, so that the counts follow recent popularity. Not
+// thread safe.
+class FrequencySketch {
+ public:
+  static constexpr int32_t kDepth = 4;
+  static constexpr int32_t kMaxCount = 15;
+  static constexpr int32_t kSamplesPerCounter = 10;
+
+  // Makes a sketch with 'width' counters per row, rounded up to a
+  // power of 2.
+  explicit FrequencySketch(int32_t width);
+
+  // Counts an access to the key whose hash is 'hash'.
+  void record(uint64_t hash);
+
+  // Returns the estimated number of recent accesses to the key whose
+  // hash is 'hash'.
+  int32_t estimate(uint64_t hash) const;
+
+  int32_t width() const {
+    return widthMask_ + 1;
+  }
+
+  // Returns the number of times the counters have been halved.
+  int64_t numResets() const {
+    return numResets_;
+  }
+
+ private:
+  // Returns the index in 'counters_' of the counter for 'mixedHash'
+  // in 'row'.
+  int32_t index(uint64_t mixedHash, int32_t row) const;
+
+  // Halves all counters.
+  void reset();
+
+  const int32_t widthMask_;
+
+  // Number of records after which counters are halved.
+  const int32_t sampleSize_;
+
+  // kDepth rows of width() counters each.
+  std::vector<uint8_t> counters_;
+
+  // Number of records since the last reset().
+  int32_t numRecorded_{0};
+
+  int64_t numResets_{0};
+};
+
+} // namespace facebook::velox::cache
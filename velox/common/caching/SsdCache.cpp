@@ -16,6 +16,7 @@
 #include <folly/Executor.h>
 #include <folly/portability/SysUio.h>
 #include <numeric>
+#include "velox/common/base/StatsReporter.h"
 #include "velox/common/caching/FileIds.h"
 
 #include "velox/common/caching/SsdCache.h"
@@ -33,6 +34,11 @@ SsdCache::SsdCache(
       numShards_(numShards),
       groupStats_(std::make_unique<FileGroupStats>()),
       executor_(executor) {
+  // 1ms buckets up to 100ms.
+  REPORT_ADD_HISTOGRAM_EXPORT_PERCENTILE(
+      SsdFile::kReadLatencyStat, 1'000, 0, 100'000, 50, 90, 99);
+  REPORT_ADD_HISTOGRAM_EXPORT_PERCENTILE(
+      SsdFile::kWriteLatencyStat, 1'000, 0, 100'000, 50, 90, 99);
   files_.reserve(numShards_);
   // Cache size must be a multiple of this so that each shard has the same max
   // size.
@@ -43,7 +49,8 @@ SsdCache::SsdCache(
         fmt::format("{}{}", filePrefix_, i),
         i,
         fileMaxRegions,
-        checkpointIntervalBytes / numShards));
+        checkpointIntervalBytes / numShards,
+        executor_));
   }
 }
 
@@ -120,6 +127,14 @@ SsdCacheStats SsdCache::stats() const {
   return stats;
 }
 
+void SsdCache::addResidency(
+    const folly::F14FastSet<uint64_t>* fileNums,
+    FileResidencyMap& residency) const {
+  for (auto& file : files_) {
+    file->addResidency(fileNums, residency);
+  }
+}
+
 void SsdCache::clear() {
   for (auto& file : files_) {
     file->clear();
@@ -134,6 +149,8 @@ std::string SsdCache::toString() const {
       << (data.bytesRead >> 20) << "MB Size " << (capacity >> 30)
       << "GB Occupied " << (data.bytesCached >> 30) << "GB";
   out << (data.entriesCached >> 10) << "K entries.";
+  out << "\nRead latency: " << data.readLatencyUs.toString()
+      << "us\nWrite latency: " << data.writeLatencyUs.toString() << "us";
   out << "\nGroupStats: " << groupStats_->toString(capacity);
   return out.str();
 }
@@ -31,7 +31,9 @@ class SsdCache {
   //  256M with 2 shards each of 128M (2 regions). If
   //  'checkpointIntervalBytes' is non-0, the cache makes a durable
   //  checkpointed state that survives restart after each
-  //  'checkpointIntervalBytes' written.
+  //  'checkpointIntervalBytes' written. The shards read their
+  //  checkpoints in parallel on 'executor' and find entries before
+  //  their checkpoint is fully read.
   SsdCache(
       std::string_view filePrefix,
       uint64_t maxBytes,
@@ -67,6 +69,12 @@ class SsdCache {
   // Returns  stats aggregated from all shards.
   SsdCacheStats stats() const;
 
+  // Adds the entries of all shards to 'residency'. See
+  // CacheShard::addResidency().
+  void addResidency(
+      const folly::F14FastSet<uint64_t>* FOLLY_NULLABLE fileNums,
+      FileResidencyMap& residency) const;
+
   FileGroupStats& groupStats() const {
     return *groupStats_;
   }
@@ -18,7 +18,9 @@
 #include <folly/Executor.h>
 #include <folly/portability/SysUio.h>
 #include "velox/common/base/AsyncSource.h"
+#include "velox/common/base/StatsReporter.h"
 #include "velox/common/caching/FileIds.h"
+#include "velox/common/time/Timer.h"
 
 #include <fcntl.h>
 #include <sys/stat.h>
@@ -29,6 +31,10 @@
 
 DEFINE_bool(ssd_odirect, true, "Use O_DIRECT for SSD cache IO");
 DEFINE_bool(ssd_verify_write, false, "Read back data after writing to SSD");
+DEFINE_bool(
+    ssd_io_uring,
+    false,
+    "Use io_uring for SSD cache IO if Velox is built with it");
 
 namespace facebook::velox::cache {
 
@@ -88,7 +94,7 @@ SsdFile::SsdFile(
     LOG(ERROR) << "Cannot open or create " << filename << " error " << errno;
     exit(1);
   }
-  readFile_ = std::make_unique<LocalReadFile>(fd_);
+  io_ = SsdIo::create(fd_, FLAGS_ssd_io_uring);
   uint64_t size = lseek(fd_, 0, SEEK_END);
   numRegions_ = size / kRegionSize;
   if (numRegions_ > maxRegions_) {
@@ -109,6 +115,17 @@ SsdFile::SsdFile(
   }
 }
 
+SsdFile::~SsdFile() {
+  // The checkpoint reader refers to 'this'.
+  waitForRecovery();
+}
+
+void SsdFile::waitForRecovery() {
+  if (recovering_) {
+    recoveryDone_.getSemiFuture().wait();
+  }
+}
+
 void SsdFile::pinRegion(uint64_t offset) {
   std::lock_guard<std::mutex> l(mutex_);
   pinRegionLocked(offset);
@@ -124,6 +141,31 @@ void SsdFile::unpinRegion(uint64_t offset) {
 }
 
 namespace {
+// Makes a request for reading 'buffers' at 'offset'. A Range with no
+// data is a gap that is read and discarded.
+SsdIoRequest makeReadRequest(
+    uint64_t offset,
+    const std::vector<folly::Range<char*>>& buffers) {
+  // Dropped bytes sized so that a typical dropped range of 50K is not
+  // too many iovecs.
+  static char droppedBytes[16 * 1024];
+  SsdIoRequest request{offset};
+  request.iovecs.reserve(buffers.size());
+  for (auto& range : buffers) {
+    if (!range.data()) {
+      auto skipSize = range.size();
+      while (skipSize) {
+        auto bytes = std::min<size_t>(sizeof(droppedBytes), skipSize);
+        request.iovecs.push_back({droppedBytes, bytes});
+        skipSize -= bytes;
+      }
+    } else {
+      request.iovecs.push_back({range.data(), range.size()});
+    }
+  }
+  return request;
+}
+
 void addEntryToIovecs(AsyncDataCacheEntry& entry, std::vector<iovec>& iovecs) {
   if (entry.tinyData()) {
     iovecs.push_back({entry.tinyData(), static_cast<size_t>(entry.size())});
@@ -198,6 +240,7 @@ CoalesceIoStats SsdFile::load(
     ++stats_.entriesRead;
     stats_.bytesRead += entry->size();
   }
+  std::vector<SsdIoRequest> requests;
   // Do coalesced IO for the pins. For short payloads, the break-even
   // between discrete pread calls and a single preadv that discards
   // gaps is ~25K per gap. For longer payloads this is ~50-100K.
@@ -214,8 +257,19 @@ CoalesceIoStats SsdFile::load(
           int32_t /*end*/,
           uint64_t offset,
           const std::vector<folly::Range<char*>>& buffers) {
-        read(offset, buffers);
+        // The reads are issued together after all are planned.
+        requests.push_back(makeReadRequest(offset, buffers));
       });
+  uint64_t readUs = 0;
+  {
+    MicrosecondTimer timer(&readUs);
+    read(requests);
+  }
+  REPORT_ADD_HISTOGRAM_VALUE(kReadLatencyStat, readUs);
+  {
+    std::lock_guard<std::mutex> l(mutex_);
+    stats_.readLatencyUs.add(readUs);
+  }
 
   for (auto i = 0; i < ssdPins.size(); ++i) {
     pins[i].checkedEntry()->setSsdFile(this, ssdPins[i].run().offset());
@@ -223,10 +277,16 @@ CoalesceIoStats SsdFile::load(
   return stats;
 }
 
-void SsdFile::read(
-    uint64_t offset,
-    const std::vector<folly::Range<char*>>& buffers) {
-  readFile_->preadv(offset, buffers);
+void SsdFile::read(std::vector<SsdIoRequest>& requests) {
+  io_->read(requests);
+  for (auto& request : requests) {
+    VELOX_CHECK_EQ(
+        request.result,
+        static_cast<int64_t>(request.size()),
+        "IOERR: Failed to read SSD cache file {} at {}",
+        filename_,
+        request.offset);
+  }
 }
 
 std::optional<std::pair<uint64_t, int32_t>> SsdFile::getSpace(
@@ -317,6 +377,11 @@ void SsdFile::clearRegionEntriesLocked(
 }
 
 void SsdFile::write(std::vector<CachePin>& pins) {
+  if (recovering_) {
+    // The free space is known after the checkpoint is read. The pins
+    // are retried in a later write.
+    return;
+  }
   // Sorts the pins by their file/offset. In this way what is ajacent
   // in storage is likely adjacent on SSD.
   std::sort(pins.begin(), pins.end());
@@ -326,39 +391,60 @@ void SsdFile::write(std::vector<CachePin>& pins) {
     VELOX_CHECK_NULL(entry->ssdFile());
     total += entry->size();
   }
+  // Space is reserved for all pins first and the writes for the
+  // different regions are then issued together. 'firstPins[i]' is the
+  // index in 'pins' of the first pin written by 'requests[i]'.
+  std::vector<SsdIoRequest> requests;
+  std::vector<int32_t> firstPins;
   int32_t storeIndex = 0;
   while (storeIndex < pins.size()) {
     auto space = getSpace(pins, storeIndex);
 
     if (!space.has_value()) {
-      // No space can be reclaimed. The pins are freed when the caller is freed.
-      return;
+      // No space can be reclaimed. The pins that do not get written are
+      // freed when the caller is freed.
+      break;
     }
     auto [offset, available] = space.value();
-    int32_t numWritten = 0;
     int32_t bytes = 0;
-    std::vector<iovec> iovecs;
-    for (auto i = storeIndex; i < pins.size(); ++i) {
-      auto entry = pins[i].checkedEntry();
+    SsdIoRequest request{offset};
+    firstPins.push_back(storeIndex);
+    for (; storeIndex < pins.size(); ++storeIndex) {
+      auto entry = pins[storeIndex].checkedEntry();
       auto entrySize = entry->size();
       if (bytes + entrySize > available) {
         break;
       }
-      addEntryToIovecs(*entry, iovecs);
+      addEntryToIovecs(*entry, request.iovecs);
       bytes += entrySize;
-      ++numWritten;
     }
     VELOX_CHECK_GE(fileSize_, offset + bytes);
-    auto rc = folly::pwritev(fd_, iovecs.data(), iovecs.size(), offset);
-    if (rc != bytes) {
-      LOG(ERROR) << "Failed to write to SSD " << errno;
-      // If the write fails we return without adding the pins to the cache. The
+    requests.push_back(std::move(request));
+  }
+  uint64_t writeUs = 0;
+  {
+    MicrosecondTimer timer(&writeUs);
+    io_->write(requests);
+  }
+  REPORT_ADD_HISTOGRAM_VALUE(kWriteLatencyStat, writeUs);
+  {
+    std::lock_guard<std::mutex> l(mutex_);
+    stats_.writeLatencyUs.add(writeUs);
+  }
+  for (auto nthRequest = 0; nthRequest < requests.size(); ++nthRequest) {
+    auto& request = requests[nthRequest];
+    if (request.result != static_cast<int64_t>(request.size())) {
+      LOG(ERROR) << "Failed to write to SSD " << -request.result;
+      // If the write fails the pins are not added to the cache. The
       // entries are unchanged.
-      return;
+      continue;
     }
+    auto offset = request.offset;
+    auto endIndex = nthRequest + 1 < requests.size() ? firstPins[nthRequest + 1]
+                                                     : storeIndex;
     {
       std::lock_guard<std::mutex> l(mutex_);
-      for (auto i = storeIndex; i < storeIndex + numWritten; ++i) {
+      for (auto i = firstPins[nthRequest]; i < endIndex; ++i) {
         auto entry = pins[i].checkedEntry();
         entry->setSsdFile(this, offset);
         auto size = entry->size();
@@ -374,7 +460,6 @@ void SsdFile::write(std::vector<CachePin>& pins) {
         bytesAfterCheckpoint_ += size;
       }
     }
-    storeIndex += numWritten;
   }
 
   if (bytesAfterCheckpoint_ > checkpointIntervalBytes_) {
@@ -427,6 +512,8 @@ void SsdFile::updateStats(SsdCacheStats& stats) const {
   stats.bytesWritten += stats_.bytesWritten;
   stats.entriesRead += stats_.entriesRead;
   stats.bytesRead += stats_.bytesRead;
+  stats.readLatencyUs.merge(stats_.readLatencyUs);
+  stats.writeLatencyUs.merge(stats_.writeLatencyUs);
   stats.entriesCached += entries_.size();
   for (auto& regionSize : regionSize_) {
     stats.bytesCached += regionSize;
@@ -436,7 +523,23 @@ void SsdFile::updateStats(SsdCacheStats& stats) const {
   }
 }
 
+void SsdFile::addResidency(
+    const folly::F14FastSet<uint64_t>* fileNums,
+    FileResidencyMap& residency) {
+  std::lock_guard<std::mutex> l(mutex_);
+  for (auto& [key, run] : entries_) {
+    auto fileNum = key.fileNum.id();
+    if (fileNums && !fileNums->count(fileNum)) {
+      continue;
+    }
+    auto& file = residency[fileNum];
+    ++file.numSsdEntries;
+    file.ssdBytes += run.size();
+  }
+}
+
 void SsdFile::clear() {
+  waitForRecovery();
   std::lock_guard<std::mutex> l(mutex_);
   entries_.clear();
   std::fill(regionSize_.begin(), regionSize_.end(), 0);
@@ -445,6 +548,7 @@ void SsdFile::clear() {
 }
 
 void SsdFile::deleteFile() {
+  waitForRecovery();
   if (fd_) {
     close(fd_);
     fd_ = 0;
@@ -513,6 +617,12 @@ inline const char* asChar(const T* ptr) {
 } // namespace
 
 void SsdFile::checkpoint(bool force) {
+  if (recovering_) {
+    if (!force) {
+      return;
+    }
+    waitForRecovery();
+  }
   std::lock_guard<std::mutex> l(mutex_);
   if (!force && bytesAfterCheckpoint_ < checkpointIntervalBytes_) {
     return;
@@ -621,16 +731,42 @@ void SsdFile::initializeCheckpoint() {
     exit(1);
   }
 
+  if (!hasCheckpoint) {
+    return;
+  }
+  state.close();
+  if (!executor_) {
+    recoverFromCheckpoint();
+    return;
+  }
+  // The shards of an SsdCache read their checkpoints in parallel.
+  recovering_ = true;
+  executor_->add([this]() {
+    recoverFromCheckpoint();
+    recovering_ = false;
+    recoveryDone_.setValue();
+  });
+}
+
+void SsdFile::recoverFromCheckpoint() {
   try {
-    if (hasCheckpoint) {
-      state.exceptions(std::ifstream::failbit);
-      readCheckpoint(state);
-    }
+    std::ifstream state(fileName_ + kCheckpointExtension);
+    state.exceptions(std::ifstream::failbit);
+    readCheckpoint(state);
   } catch (const std::exception& e) {
     try {
       LOG(ERROR) << "Error recovering from checkpoint " << e.what()
                  << ": Starting without checkpoint";
+      std::lock_guard<std::mutex> l(mutex_);
       entries_.clear();
+      // Entries found before the error may still be pinned. Their
+      // regions are not written before they are evicted.
+      writableRegions_.clear();
+      for (auto region = 0; region < numRegions_; ++region) {
+        if (!regionPins_[region]) {
+          writableRegions_.push_back(region);
+        }
+      }
       deleteCheckpoint(true);
     } catch (const std::exception& e) {
     }
@@ -647,17 +783,19 @@ T readNumber(std::ifstream& stream) {
 } // namespace
 
 void SsdFile::readCheckpoint(std::ifstream& state) {
+  // Number of entries added to 'entries_' at a time.
+  constexpr int32_t kBatchSize = 10000;
   char magic[4];
   state.read(magic, sizeof(magic));
   VELOX_CHECK(strncmp(magic, kCheckpointMagic, 4) == 0);
   auto maxRegions = readNumber<int32_t>(state);
-  VELOX_CHECK_EQ(
-      maxRegions,
-      maxRegions_,
-      "Trying to start from checkpoint with a different capacity");
-  numRegions_ = readNumber<int32_t>(state);
+  VELOX_CHECK_LT(0, maxRegions);
+  // The checkpoint may come from a cache of another capacity. The
+  // regions that are not in the file of 'this' are dropped.
+  auto numRegions = std::min(readNumber<int32_t>(state), numRegions_);
   std::vector<int64_t> scores(maxRegions);
-  state.read(asChar(scores.data()), maxRegions_ * sizeof(uint64_t));
+  state.read(asChar(scores.data()), maxRegions * sizeof(uint64_t));
+  scores.resize(maxRegions_);
   std::unordered_map<uint64_t, StringIdLease> idMap;
   for (;;) {
     auto id = readNumber<uint64_t>(state);
@@ -678,6 +816,17 @@ void SsdFile::readCheckpoint(std::ifstream& state) {
   for (auto region : evicted) {
     evictedMap.insert(region);
   }
+  // Entries are added in batches so that they can be found before the
+  // whole checkpoint is read.
+  std::vector<std::pair<FileCacheKey, SsdRun>> batch;
+  auto addBatch = [&]() {
+    std::lock_guard<std::mutex> l(mutex_);
+    for (auto& [key, run] : batch) {
+      entries_[std::move(key)] = run;
+    }
+    batch.clear();
+  };
+  int64_t numDropped = 0;
   for (;;) {
     uint64_t fileNum = readNumber<uint64_t>(state);
     if (fileNum == kCheckpointEndMarker) {
@@ -685,28 +834,43 @@ void SsdFile::readCheckpoint(std::ifstream& state) {
     }
     uint64_t offset = readNumber<uint64_t>(state);
     auto run = SsdRun(readNumber<uint64_t>(state));
-    // Check that the recovered entry does not fall in an evicted region.
-    if (evictedMap.find(regionIndex(run.offset())) == evictedMap.end()) {
-      // The file may have a different id on restore.
-      auto it = idMap.find(fileNum);
-      VELOX_CHECK(it != idMap.end());
-      FileCacheKey key{it->second, offset};
-      entries_[std::move(key)] = run;
+    // Check that the recovered entry is inside one region of 'this'
+    // and that the region is not evicted.
+    auto region = regionIndex(run.offset());
+    if (region >= numRegions ||
+        region != regionIndex(run.offset() + run.size() - 1) ||
+        evictedMap.find(region) != evictedMap.end()) {
+      ++numDropped;
+      continue;
+    }
+    // The file may have a different id on restore.
+    auto it = idMap.find(fileNum);
+    VELOX_CHECK(it != idMap.end());
+    batch.emplace_back(FileCacheKey{it->second, offset}, run);
+    if (batch.size() >= kBatchSize) {
+      addBatch();
     }
   }
+  addBatch();
   // The state is successfully read. Install the access frequency scores and
   // evicted regions.
+  std::lock_guard<std::mutex> l(mutex_);
   VELOX_CHECK_EQ(scores.size(), tracker_.regionScores().size());
+  numRegions_ = numRegions;
   // Set the writable regions by deduplicated evicted regions.
   writableRegions_.clear();
   for (auto region : evictedMap) {
-    writableRegions_.push_back(region);
+    if (region < numRegions_) {
+      writableRegions_.push_back(region);
+    }
   }
   tracker_.regionScores() = scores;
   LOG(INFO) << fmt::format(
-      "Starting shard {} from checkpoint with {} entries, {} regions with {} free.",
+      "Starting shard {} from checkpoint with {} entries, {} dropped, {} "
+      "regions with {} free.",
       shardId_,
       entries_.size(),
+      numDropped,
       numRegions_,
       writableRegions_.size());
 }
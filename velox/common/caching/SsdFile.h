@@ -16,14 +16,18 @@
 
 #pragma once
 
+#include "velox/common/base/RuntimeMetrics.h"
 #include "velox/common/caching/AsyncDataCache.h"
 #include "velox/common/caching/SsdFileTracker.h"
+#include "velox/common/caching/SsdIo.h"
 #include "velox/common/file/File.h"
 
+#include <folly/futures/SharedPromise.h>
 #include <gflags/gflags.h>
 
 DECLARE_bool(ssd_odirect);
 DECLARE_bool(ssd_verify_write);
+DECLARE_bool(ssd_io_uring);
 
 namespace facebook::velox::cache {
 
@@ -127,6 +131,10 @@ struct SsdCacheStats {
   uint64_t entriesCached{0};
   uint64_t bytesCached{0};
   int32_t numPins{0};
+  // Microseconds taken by each batch of reads in load() and each batch of
+  // writes in write().
+  RuntimeHistogram readLatencyUs;
+  RuntimeHistogram writeLatencyUs;
 };
 
 // A shard of SsdCache. Corresponds to one file on SSD.  The data
@@ -141,8 +149,19 @@ class SsdFile {
  public:
   static constexpr uint64_t kRegionSize = 1 << 26; // 64MB
 
+  // Names of the StatsReporter histograms of the microseconds taken by
+  // batches of reads and writes.
+  static constexpr const char* kReadLatencyStat =
+      "velox.ssd_cache_read_latency_us";
+  static constexpr const char* kWriteLatencyStat =
+      "velox.ssd_cache_write_latency_us";
+
   // Constructs a cache backed by filename. Discards any previous
-  // contents of filename.
+  // contents of filename unless 'checkpointIntervalBytes' is non-0 and
+  // there is a checkpoint. The checkpoint may come from a cache of a
+  // different capacity. If 'executor' is given, the checkpoint is read
+  // on 'executor' and entries can be found as soon as they are read.
+  // New entries are not written before the checkpoint is fully read.
   SsdFile(
       const std::string& filename,
       int32_t shardId,
@@ -150,6 +169,8 @@ class SsdFile {
       int64_t checkpointInternalBytes = 0,
       folly::Executor* FOLLY_NULLABLE executor = nullptr);
 
+  ~SsdFile();
+
   // Adds entries of  'pins'  to this file. 'pins' must be in read mode and
   // those pins that are successfully added to SSD are marked as being on SSD.
   // The file of the entries must be a file that is backed by 'this'.
@@ -201,6 +222,12 @@ class SsdFile {
   // Adds 'stats_' to 'stats'.
   void updateStats(SsdCacheStats& stats) const;
 
+  // Adds the size of each entry of 'this' to the element of
+  // 'residency' for its file. See CacheShard::addResidency().
+  void addResidency(
+      const folly::F14FastSet<uint64_t>* FOLLY_NULLABLE fileNums,
+      FileResidencyMap& residency);
+
   // Resets this' to a post-construction empty state. See SsdCache::clear().
   void clear();
 
@@ -213,6 +240,15 @@ class SsdFile {
   // written since last checkpoint and silently returns if not.
   void checkpoint(bool force = false);
 
+  // True while the checkpoint is being read in the background.
+  bool isRecovering() const {
+    return recovering_;
+  }
+
+  // Returns after the checkpoint is read if it is being read in the
+  // background.
+  void waitForRecovery();
+
  private:
   // 4 first bytes of a checkpoint file. Allows distinguishing between format
   // versions.
@@ -246,8 +282,9 @@ class SsdFile {
   // added to 'writableRegions_'. Returns true if regions could be cleared.
   bool growOrEvictLocked();
 
-  // Reads the backing file with ReadFile::preadv().
-  void read(uint64_t offset, const std::vector<folly::Range<char*>>& buffers);
+  // Reads 'requests' from the backing file. Throws if any is not read
+  // in full.
+  void read(std::vector<SsdIoRequest>& requests);
 
   // Verifies that 'entry' has the data at 'run'.
   void verifyWrite(AsyncDataCacheEntry& entry, SsdRun run);
@@ -257,10 +294,16 @@ class SsdFile {
   void deleteCheckpoint(bool keepLog = false);
 
   // Reads a checkpoint state file and sets 'this' accordingly if read
-  // is successful. Return true for successful read. A failed read
-  // deletes the checkpoint and leaves the log truncated open.
+  // is successful. Entries are added in batches, so that they can be
+  // found while the rest is read. Entries that fall outside of the
+  // regions of 'this' are dropped. Throws if the file is corrupt.
   void readCheckpoint(std::ifstream& state);
 
+  // Reads the checkpoint with readCheckpoint(). A failed read drops
+  // the entries, deletes the checkpoint and leaves the log truncated
+  // open.
+  void recoverFromCheckpoint();
+
   // Logs an error message, deletes the checkpoint and stop making new
   // checkpoints.
   void checkpointError(int32_t rc, const std::string& error);
@@ -324,8 +367,9 @@ class SsdFile {
   // Size of the backing file in bytes. Must be multiple of kRegionSize.
   uint64_t fileSize_{0};
 
-  // ReadFile made from 'fd_'.
-  std::unique_ptr<ReadFile> readFile_;
+  // Reads and writes 'fd_'. Batches of IOs are in flight together if
+  // this uses io_uring.
+  std::unique_ptr<SsdIo> io_;
 
   // Counters.
   SsdCacheStats stats_;
@@ -335,7 +379,8 @@ class SsdFile {
   // checkpointing fails.
   int64_t checkpointIntervalBytes_{0};
 
-  // Executor for async fsync in checkpoint.
+  // Executor for async fsync in checkpoint and for reading the
+  // checkpoint at startup.
   folly::Executor* FOLLY_NULLABLE executor_;
 
   // Count of bytes written after last checkpoint.
@@ -346,6 +391,13 @@ class SsdFile {
 
   // True if there was an error with checkpoint and the checkpoint was deleted.
   bool checkpointDeleted_{false};
+
+  // True while the checkpoint is read on 'executor_'. 'this' is not
+  // written and not checkpointed meanwhile.
+  std::atomic<bool> recovering_{false};
+
+  // Realized when the checkpoint read on 'executor_' is done.
+  folly::SharedPromise<folly::Unit> recoveryDone_;
 };
 
 } // namespace facebook::velox::cache
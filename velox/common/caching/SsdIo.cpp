@@ -0,0 +1,240 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#include "velox/common/caching/SsdIo.h"
+#include "velox/common/base/Exceptions.h"
+
+#include <glog/logging.h>
+
+#include <mutex>
+
+#ifdef VELOX_ENABLE_IO_URING
+#include <liburing.h>
+#endif
+
+namespace facebook::velox::cache {
+
+uint64_t SsdIoRequest::size() const {
+  uint64_t total = 0;
+  for (auto& iov : iovecs) {
+    total += iov.iov_len;
+  }
+  return total;
+}
+
+namespace {
+
+void syncRead(int32_t fd, SsdIoRequest& request) {
+  auto rc = folly::preadv(
+      fd, request.iovecs.data(), request.iovecs.size(), request.offset);
+  request.result = rc < 0 ? -errno : rc;
+}
+
+void syncWrite(int32_t fd, SsdIoRequest& request) {
+  auto rc = folly::pwritev(
+      fd, request.iovecs.data(), request.iovecs.size(), request.offset);
+  request.result = rc < 0 ? -errno : rc;
+}
+
+class SyncSsdIo : public SsdIo {
+ public:
+  explicit SyncSsdIo(int32_t fd) : fd_(fd) {}
+
+  void read(std::vector<SsdIoRequest>& requests) override {
+    for (auto& request : requests) {
+      syncRead(fd_, request);
+    }
+  }
+
+  void write(std::vector<SsdIoRequest>& requests) override {
+    for (auto& request : requests) {
+      syncWrite(fd_, request);
+    }
+  }
+
+  bool isAsync() const override {
+    return false;
+  }
+
+ private:
+  const int32_t fd_;
+};
+
+#ifdef VELOX_ENABLE_IO_URING
+// A ring is used by one thread at a time. Concurrent batches take
+// different rings, so that their requests are in flight together.
+class IoUringSsdIo : public SsdIo {
+ public:
+  explicit IoUringSsdIo(int32_t fd) : fd_(fd) {}
+
+  ~IoUringSsdIo() override {
+    for (auto& ring : rings_) {
+      io_uring_queue_exit(ring.get());
+    }
+  }
+
+  // Returns true if the kernel supports io_uring.
+  bool initialize() {
+    auto ring = makeRing();
+    if (!ring) {
+      return false;
+    }
+    rings_.push_back(std::move(ring));
+    return true;
+  }
+
+  void read(std::vector<SsdIoRequest>& requests) override {
+    run(requests, false);
+  }
+
+  void write(std::vector<SsdIoRequest>& requests) override {
+    run(requests, true);
+  }
+
+  bool isAsync() const override {
+    return true;
+  }
+
+ private:
+  static std::unique_ptr<io_uring> makeRing() {
+    auto ring = std::make_unique<io_uring>();
+    auto rc = io_uring_queue_init(kQueueDepth, ring.get(), 0);
+    if (rc < 0) {
+      LOG(WARNING) << "SSDCA: io_uring_queue_init failed: " << -rc;
+      return nullptr;
+    }
+    return ring;
+  }
+
+  std::unique_ptr<io_uring> takeRing() {
+    {
+      std::lock_guard<std::mutex> l(mutex_);
+      if (!rings_.empty()) {
+        auto ring = std::move(rings_.back());
+        rings_.pop_back();
+        return ring;
+      }
+    }
+    auto ring = makeRing();
+    VELOX_CHECK_NOT_NULL(ring, "Failed to make an io_uring for SSD cache IO");
+    return ring;
+  }
+
+  void returnRing(std::unique_ptr<io_uring> ring) {
+    std::lock_guard<std::mutex> l(mutex_);
+    rings_.push_back(std::move(ring));
+  }
+
+  void run(std::vector<SsdIoRequest>& requests, bool isWrite) {
+    for (auto& request : requests) {
+      request.result = 0;
+    }
+    auto ring = takeRing();
+    size_t numSubmitted = 0;
+    size_t numDone = 0;
+    while (numDone < requests.size()) {
+      while (numSubmitted < requests.size() &&
+             numSubmitted - numDone < kQueueDepth) {
+        auto sqe = io_uring_get_sqe(ring.get());
+        if (!sqe) {
+          break;
+        }
+        auto& request = requests[numSubmitted++];
+        if (isWrite) {
+          io_uring_prep_writev(
+              sqe,
+              fd_,
+              request.iovecs.data(),
+              request.iovecs.size(),
+              request.offset);
+        } else {
+          io_uring_prep_readv(
+              sqe,
+              fd_,
+              request.iovecs.data(),
+              request.iovecs.size(),
+              request.offset);
+        }
+        io_uring_sqe_set_data(sqe, &request);
+      }
+      auto rc = io_uring_submit_and_wait(ring.get(), 1);
+      if (rc < 0 && rc != -EINTR) {
+        // The ring may be unusable. Complete the rest synchronously.
+        LOG(ERROR) << "SSDCA: io_uring_submit_and_wait failed: " << -rc;
+        io_uring_queue_exit(ring.get());
+        finishSync(requests, isWrite);
+        return;
+      }
+      io_uring_cqe* cqe;
+      unsigned head;
+      unsigned numCompleted = 0;
+      io_uring_for_each_cqe(ring.get(), head, cqe) {
+        auto request =
+            reinterpret_cast<SsdIoRequest*>(io_uring_cqe_get_data(cqe));
+        request->result = cqe->res;
+        if (cqe->res >= 0 &&
+            static_cast<uint64_t>(cqe->res) < request->size()) {
+          // A short transfer is rare. Redo the request synchronously.
+          isWrite ? syncWrite(fd_, *request) : syncRead(fd_, *request);
+        }
+        ++numCompleted;
+      }
+      io_uring_cq_advance(ring.get(), numCompleted);
+      numDone += numCompleted;
+    }
+    returnRing(std::move(ring));
+  }
+
+  // Redoes the requests that have not completed in full after a ring
+  // failure. Completions arrive in any order, so all requests are
+  // checked.
+  void finishSync(std::vector<SsdIoRequest>& requests, bool isWrite) {
+    for (auto& request : requests) {
+      if (request.result != static_cast<int64_t>(request.size())) {
+        isWrite ? syncWrite(fd_, request) : syncRead(fd_, request);
+      }
+    }
+  }
+
+  const int32_t fd_;
+  std::mutex mutex_;
+  // Rings not in use by any thread.
+  std::vector<std::unique_ptr<io_uring>> rings_;
+};
+#endif
+
+} // namespace
+
+// static
+std::unique_ptr<SsdIo> SsdIo::create(int32_t fd, bool useIoUring) {
+#ifdef VELOX_ENABLE_IO_URING
+  if (useIoUring) {
+    auto io = std::make_unique<IoUringSsdIo>(fd);
+    if (io->initialize()) {
+      return io;
+    }
+    LOG(WARNING) << "SSDCA: io_uring is not available, using sync IO";
+  }
+#else
+  if (useIoUring) {
+    LOG(WARNING) << "SSDCA: Built without io_uring, using sync IO";
+  }
+#endif
+  return std::make_unique<SyncSsdIo>(fd);
+}
+
+} // namespace facebook::velox::cache
@@ -0,0 +1,65 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <folly/portability/SysUio.h>
+
+#include <memory>
+#include <vector>
+
+namespace facebook::velox::cache {
+
+// A read or write of consecutive bytes of an SSD cache file from or
+// into 'iovecs'.
+struct SsdIoRequest {
+  uint64_t offset;
+  std::vector<iovec> iovecs;
+  // Number of bytes transferred or -errno. Set by SsdIo.
+  int64_t result{0};
+
+  // Returns the total size of 'iovecs'.
+  uint64_t size() const;
+};
+
+// Executes batches of reads or writes on an SSD cache file. The
+// synchronous implementation issues one preadv or pwritev at a time. With
+// io_uring, a batch is submitted with one system call and is in flight
+// at up to kQueueDepth requests at a time. Thread safe.
+class SsdIo {
+ public:
+  static constexpr int32_t kQueueDepth = 64;
+
+  virtual ~SsdIo() = default;
+
+  // Makes an SsdIo for 'fd'. Uses io_uring if 'useIoUring' is true,
+  // Velox is built with VELOX_ENABLE_IO_URING and the kernel supports
+  // io_uring. Otherwise uses synchronous system calls.
+  static std::unique_ptr<SsdIo> create(int32_t fd, bool useIoUring);
+
+  // Reads all of 'requests' and sets their 'result'. Returns after all
+  // are done.
+  virtual void read(std::vector<SsdIoRequest>& requests) = 0;
+
+  // Writes all of 'requests' and sets their 'result'. Returns after all
+  // are done.
+  virtual void write(std::vector<SsdIoRequest>& requests) = 0;
+
+  // True if 'this' uses io_uring.
+  virtual bool isAsync() const = 0;
+};
+
+} // namespace facebook::velox::cache
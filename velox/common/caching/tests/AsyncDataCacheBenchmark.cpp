@@ -0,0 +1,325 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "velox/common/caching/AsyncDataCache.h"
+#include "velox/common/caching/FileIds.h"
+#include "velox/common/caching/SsdCache.h"
+#include "velox/common/memory/MmapAllocator.h"
+
+#include <folly/Random.h>
+#include <folly/executors/IOThreadPoolExecutor.h>
+#include <folly/executors/QueuedImmediateExecutor.h>
+#include <folly/init/Init.h>
+#include <gflags/gflags.h>
+
+#include <chrono>
+#include <cmath>
+#include <thread>
+
+DEFINE_int32(num_threads, 16, "Threads issuing loads");
+DEFINE_int32(num_loads, 20'000, "Coalesced loads per thread");
+DEFINE_int32(num_files, 1'000, "Files in the simulated dataset");
+DEFINE_int32(num_stripes, 20, "Stripes per file");
+DEFINE_int32(num_columns, 20, "Column chunks per stripe");
+DEFINE_int32(columns_per_load, 5, "Column chunks read by one coalesced load");
+DEFINE_int32(max_entry_kb, 1'024, "Largest column chunk size in KB");
+DEFINE_double(
+    skew,
+    3,
+    "Exponent of the file, stripe and column distributions. 1 is uniform, "
+    "larger values concentrate the accesses on the first files");
+DEFINE_int64(memory_mb, 4'096, "Capacity of the AsyncDataCache");
+DEFINE_int32(num_shards, 4, "CacheShards of the AsyncDataCache");
+DEFINE_string(
+    admission,
+    "all",
+    "Cache admission policy: all, frequency or scan_resistant");
+DEFINE_int64(compressed_mb, 0, "Size of the compressed tier. 0 is off");
+DEFINE_string(ssd_path, "", "File prefix of the SsdCache. Empty is no SSD");
+DEFINE_int64(ssd_gb, 16, "Capacity of the SsdCache");
+DEFINE_int32(
+    storage_latency_us,
+    0,
+    "Simulated latency of each coalesced load from storage");
+
+using namespace facebook::velox;
+using namespace facebook::velox::cache;
+
+using memory::MappedMemory;
+
+// Simulates the access pattern of CachedBufferedInput on AsyncDataCache from
+// 'num_threads' threads. Each load picks a file, a stripe and a run of column
+// chunks with a power law skew, looks up all the chunks in the cache and
+// loads the misses in one coalesced read, from SSD if the SsdCache has them
+// and from simulated storage otherwise. A load waits for chunks that another
+// thread is loading. At the end this prints the hit rates, the p50/p99/max
+// latency of a load, the fraction of lookups that waited for the shard
+// mutex and the cost of evictions, so that admission policies, shard counts
+// and the compressed tier can be compared.
+namespace {
+
+struct ThreadStats {
+  std::vector<int64_t> latencyNanos;
+  int64_t numLookups{0};
+  int64_t numStorageEntries{0};
+  int64_t numSsdEntries{0};
+};
+
+CacheAdmission admission(const std::string& name) {
+  if (name == "all") {
+    return CacheAdmission::kAll;
+  }
+  if (name == "frequency") {
+    return CacheAdmission::kFrequency;
+  }
+  VELOX_USER_CHECK_EQ(name, "scan_resistant", "Unknown admission policy");
+  return CacheAdmission::kScanResistant;
+}
+
+// Fills 'entry' with words derived from its key, as a read from storage
+// would fill it.
+void fillFromStorage(AsyncDataCacheEntry& entry) {
+  const int64_t sequence = entry.key().fileNum.id() + entry.offset();
+  auto& allocation = entry.data();
+  for (auto i = 0; i < allocation.numRuns(); ++i) {
+    auto run = allocation.runAt(i);
+    auto* words = reinterpret_cast<int64_t*>(run.data());
+    const auto numWords = run.numBytes() / sizeof(int64_t);
+    for (auto word = 0; word < numWords; ++word) {
+      words[word] = sequence + word;
+    }
+  }
+}
+
+class CacheBenchmark {
+ public:
+  CacheBenchmark() {
+    std::unique_ptr<SsdCache> ssdCache;
+    if (!FLAGS_ssd_path.empty()) {
+      ssdExecutor_ = std::make_unique<folly::IOThreadPoolExecutor>(8);
+      ssdCache = std::make_unique<SsdCache>(
+          FLAGS_ssd_path,
+          FLAGS_ssd_gb << 30,
+          8,
+          ssdExecutor_.get());
+    }
+    const uint64_t capacity = FLAGS_memory_mb << 20;
+    memory::MmapAllocatorOptions options = {capacity};
+    cache_ = std::make_shared<AsyncDataCache>(
+        std::make_shared<memory::MmapAllocator>(options),
+        capacity,
+        std::move(ssdCache),
+        FLAGS_num_shards);
+    cache_->setAdmission(admission(FLAGS_admission));
+    if (FLAGS_compressed_mb) {
+      cache_->setCompression(FLAGS_compressed_mb << 20);
+    }
+    for (auto i = 0; i < FLAGS_num_files; ++i) {
+      files_.emplace_back(fileIds(), fmt::format("benchmark_file_{}", i));
+    }
+  }
+
+  ~CacheBenchmark() {
+    if (auto* ssdCache = cache_->ssdCache()) {
+      ssdCache->deleteFiles();
+    }
+    cache_.reset();
+    if (ssdExecutor_) {
+      ssdExecutor_->join();
+    }
+  }
+
+  void run() {
+    std::vector<ThreadStats> stats(FLAGS_num_threads);
+    std::vector<std::thread> threads;
+    const auto start = std::chrono::steady_clock::now();
+    for (auto i = 0; i < FLAGS_num_threads; ++i) {
+      threads.emplace_back([&, i]() { runThread(i, stats[i]); });
+    }
+    for (auto& thread : threads) {
+      thread.join();
+    }
+    const auto seconds = std::chrono::duration<double>(
+                             std::chrono::steady_clock::now() - start)
+                             .count();
+    report(stats, seconds);
+  }
+
+ private:
+  // Returns a number in [0, 'range') with the configured skew.
+  int32_t skewed(folly::Random::DefaultGenerator& rng, int32_t range) {
+    const double fraction =
+        std::pow(folly::Random::randDouble01(rng), FLAGS_skew);
+    return std::min<int32_t>(range - 1, fraction * range);
+  }
+
+  // Column chunk sizes vary per file and column from 8KB to max_entry_kb.
+  uint64_t chunkSize(int32_t file, int32_t column) const {
+    const uint64_t maxBytes = std::max(16, FLAGS_max_entry_kb) << 10;
+    return (8 << 10) + bits::hashMix(file, column) % (maxBytes - (8 << 10));
+  }
+
+  void runThread(int32_t threadIndex, ThreadStats& stats) {
+    folly::Random::DefaultGenerator rng(threadIndex);
+    stats.latencyNanos.reserve(FLAGS_num_loads);
+    const uint64_t stripeSize =
+        static_cast<uint64_t>(FLAGS_num_columns) * (FLAGS_max_entry_kb << 10);
+    for (auto load = 0; load < FLAGS_num_loads; ++load) {
+      const auto file = skewed(rng, FLAGS_num_files);
+      const auto stripe = skewed(rng, FLAGS_num_stripes);
+      const auto firstColumn = skewed(rng, FLAGS_num_columns);
+      const auto start = std::chrono::steady_clock::now();
+      std::vector<CachePin> toLoad;
+      for (auto i = 0; i < FLAGS_columns_per_load; ++i) {
+        const auto column = (firstColumn + i) % FLAGS_num_columns;
+        RawFileCacheKey key{
+            files_[file].id(),
+            stripe * stripeSize + column * (FLAGS_max_entry_kb << 10)};
+        for (;;) {
+          folly::SemiFuture<bool> wait(false);
+          ++stats.numLookups;
+          auto pin = cache_->findOrCreate(key, chunkSize(file, column), &wait);
+          if (pin.empty()) {
+            auto& executor = folly::QueuedImmediateExecutor::instance();
+            std::move(wait).via(&executor).wait();
+            continue;
+          }
+          if (pin.checkedEntry()->isExclusive()) {
+            toLoad.push_back(std::move(pin));
+          }
+          break;
+        }
+      }
+      if (!toLoad.empty()) {
+        loadPins(toLoad, stats);
+      }
+      stats.latencyNanos.push_back(
+          std::chrono::duration_cast<std::chrono::nanoseconds>(
+              std::chrono::steady_clock::now() - start)
+              .count());
+    }
+  }
+
+  // Loads the exclusive 'pins' of one file from SSD or storage.
+  void loadPins(std::vector<CachePin>& pins, ThreadStats& stats) {
+    std::vector<CachePin> fromStorage;
+    if (auto* ssdCache = cache_->ssdCache()) {
+      auto& ssdFile =
+          ssdCache->file(pins[0].checkedEntry()->key().fileNum.id());
+      std::vector<CachePin> fromSsd;
+      std::vector<SsdPin> ssdPins;
+      for (auto& pin : pins) {
+        auto ssdPin = ssdFile.find(RawFileCacheKey{
+            pin.checkedEntry()->key().fileNum.id(),
+            pin.checkedEntry()->offset()});
+        if (ssdPin.empty()) {
+          fromStorage.push_back(std::move(pin));
+        } else {
+          fromSsd.push_back(std::move(pin));
+          ssdPins.push_back(std::move(ssdPin));
+        }
+      }
+      if (!fromSsd.empty()) {
+        ssdFile.load(ssdPins, fromSsd);
+        for (auto& pin : fromSsd) {
+          pin.checkedEntry()->setExclusiveToShared();
+        }
+        stats.numSsdEntries += fromSsd.size();
+      }
+    } else {
+      fromStorage = std::move(pins);
+    }
+    if (fromStorage.empty()) {
+      return;
+    }
+    if (FLAGS_storage_latency_us) {
+      std::this_thread::sleep_for(
+          std::chrono::microseconds(FLAGS_storage_latency_us)); // NOLINT
+    }
+    for (auto& pin : fromStorage) {
+      fillFromStorage(*pin.checkedEntry());
+      pin.checkedEntry()->setExclusiveToShared();
+    }
+    stats.numStorageEntries += fromStorage.size();
+  }
+
+  void report(std::vector<ThreadStats>& stats, double seconds) {
+    std::vector<int64_t> latencies;
+    int64_t numLookups = 0;
+    int64_t numStorageEntries = 0;
+    int64_t numSsdEntries = 0;
+    for (auto& thread : stats) {
+      latencies.insert(
+          latencies.end(),
+          thread.latencyNanos.begin(),
+          thread.latencyNanos.end());
+      numLookups += thread.numLookups;
+      numStorageEntries += thread.numStorageEntries;
+      numSsdEntries += thread.numSsdEntries;
+    }
+    std::sort(latencies.begin(), latencies.end());
+    auto percentile = [&](double pct) {
+      return latencies[std::min<size_t>(
+                 latencies.size() - 1, latencies.size() * pct / 100)] /
+          1000.0;
+    };
+    const auto cacheStats = cache_->refreshStats();
+    std::cout << fmt::format(
+                     "{} loads in {:.2f}s, {:.0f} loads/s\n",
+                     latencies.size(),
+                     seconds,
+                     latencies.size() / seconds)
+              << fmt::format(
+                     "Load latency us: p50 {:.1f} p99 {:.1f} max {:.1f}\n",
+                     percentile(50),
+                     percentile(99),
+                     latencies.back() / 1000.0)
+              << fmt::format(
+                     "Memory hit rate {:.3f}, entries from SSD {}, "
+                     "from storage {}\n",
+                     cacheStats.numHit /
+                         std::max<double>(
+                             1, cacheStats.numHit + cacheStats.numNew),
+                     numSsdEntries,
+                     numStorageEntries)
+              << fmt::format(
+                     "Shard lock waits {} of {} lookups ({:.4f})\n",
+                     cacheStats.numLockWaits,
+                     numLookups,
+                     cacheStats.numLockWaits /
+                         std::max<double>(1, numLookups))
+              << fmt::format(
+                     "Evictions {}, {:.1f} checks and {:.0f} clocks each\n",
+                     cacheStats.numEvict,
+                     cacheStats.numEvictChecks /
+                         std::max<double>(1, cacheStats.numEvict),
+                     cacheStats.evictClocks /
+                         std::max<double>(1, cacheStats.numEvict))
+              << cache_->toString() << std::endl;
+  }
+
+  std::unique_ptr<folly::IOThreadPoolExecutor> ssdExecutor_;
+  std::shared_ptr<AsyncDataCache> cache_;
+  std::vector<StringIdLease> files_;
+};
+} // namespace
+
+int main(int argc, char** argv) {
+  folly::init(&argc, &argv);
+  CacheBenchmark benchmark;
+  benchmark.run();
+  return 0;
+}
@@ -14,6 +14,7 @@
  * limitations under the License.
  */
 
+#include "velox/common/base/tests/GTestUtils.h"
 #include "velox/common/caching/FileIds.h"
 #include "velox/common/caching/SsdCache.h"
 #include "velox/common/memory/MmapAllocator.h"
@@ -584,6 +585,77 @@ TEST_F(AsyncDataCacheTest, outOfCapacity) {
   EXPECT_EQ(4092, cache_->numAllocated());
 }
 
+TEST_F(AsyncDataCacheTest, numShards) {
+  constexpr int64_t kMaxBytes = 16 << 20;
+  memory::MmapAllocatorOptions options = {kMaxBytes};
+  auto allocator = std::make_shared<memory::MmapAllocator>(options);
+  VELOX_ASSERT_THROW(
+      std::make_shared<AsyncDataCache>(allocator, kMaxBytes, nullptr, 3),
+      "Number of cache shards must be a power of 2: 3");
+
+  cache_ = std::make_shared<AsyncDataCache>(allocator, kMaxBytes, nullptr, 16);
+  StringIdLease file(fileIds(), std::string_view("testingfile"));
+  for (uint64_t offset = 0; offset < 100; ++offset) {
+    auto pin = cache_->findOrCreate({file.id(), offset * 100}, 10'000);
+    ASSERT_TRUE(pin.checkedEntry()->isExclusive());
+    pin.checkedEntry()->setExclusiveToShared();
+  }
+  for (uint64_t offset = 0; offset < 100; ++offset) {
+    auto pin = cache_->findOrCreate({file.id(), offset * 100}, 10'000);
+    EXPECT_TRUE(pin.checkedEntry()->isShared());
+  }
+  auto stats = cache_->refreshStats();
+  EXPECT_EQ(100, stats.numNew);
+  EXPECT_EQ(100, stats.numHit);
+  EXPECT_EQ(0, stats.numLockWaits);
+}
+
+TEST_F(AsyncDataCacheTest, scanResistantAdmission) {
+  constexpr int64_t kMaxBytes = 16 << 20;
+  constexpr int32_t kSize = 16 << 10;
+  constexpr int32_t kNumHot = 512;
+  constexpr int32_t kNumScan = 2000;
+  initializeCache(kMaxBytes);
+  cache_->setAdmission(CacheAdmission::kScanResistant);
+  auto load = [&](uint64_t offset) {
+    RawFileCacheKey key{filenames_[0].id(), offset};
+    auto pin = cache_->findOrCreate(key, kSize, nullptr);
+    EXPECT_FALSE(pin.empty());
+    if (pin.entry()->isExclusive()) {
+      pin.entry()->setExclusiveToShared();
+    }
+    return pin.entry()->isUncached();
+  };
+  // Half the capacity is read 3 times.
+  for (auto i = 0; i < 3; ++i) {
+    for (auto hot = 0; hot < kNumHot; ++hot) {
+      EXPECT_FALSE(load(hot * kSize));
+    }
+  }
+  // A scan of twice the capacity is read once.
+  int32_t numUncached = 0;
+  uint64_t uncachedOffset = 0;
+  for (auto i = 0; i < kNumScan; ++i) {
+    uint64_t offset = (kNumHot + i) * kSize;
+    if (load(offset)) {
+      ++numUncached;
+      uncachedOffset = offset;
+    }
+  }
+  auto stats = cache_->refreshStats();
+  EXPECT_EQ(0, stats.numEvict);
+  EXPECT_EQ(numUncached, stats.numLowFrequency);
+  EXPECT_LT(kNumScan / 2, numUncached);
+  // The uncached entries are not found and their memory is free.
+  EXPECT_FALSE(
+      cache_->exists(RawFileCacheKey{filenames_[0].id(), uncachedOffset}));
+  EXPECT_GT(kMaxBytes / MappedMemory::kPageSize, cache_->numAllocated());
+  for (auto hot = 0; hot < kNumHot; ++hot) {
+    EXPECT_TRUE(
+        cache_->exists(RawFileCacheKey{filenames_[0].id(), hot * kSize}));
+  }
+}
+
 namespace {
 // Cuts off the last 1/10th of file at 'path'.
 void corruptFile(const std::string& path) {
@@ -594,6 +666,150 @@ void corruptFile(const std::string& path) {
 }
 } // namespace
 
+TEST_F(AsyncDataCacheTest, quota) {
+  constexpr int64_t kMaxBytes = 16 << 20;
+  constexpr int32_t kSize = 16 << 10;
+  constexpr int32_t kNumHot = 256;
+  initializeCache(kMaxBytes);
+  cache_->setAdmission(CacheAdmission::kAll);
+  auto dashboard = cache_->quotaGroupId("dashboard");
+  cache_->setQuota("adhoc", 2 << 20, 0);
+  cache_->setQuota("capped", 1 << 20, 2 << 20);
+  auto adhoc = cache_->quotaGroupId("adhoc");
+  auto capped = cache_->quotaGroupId("capped");
+  EXPECT_EQ(adhoc, cache_->quotaGroupId("adhoc"));
+  VELOX_ASSERT_THROW(
+      cache_->setQuota("capped", 2 << 20, 1 << 20),
+      "Soft cache quota 2097152 is above hard quota 1048576");
+
+  auto load = [&](uint64_t offset, int32_t group) {
+    RawFileCacheKey key{filenames_[0].id(), offset};
+    auto pin = cache_->findOrCreate(key, kSize, nullptr, group);
+    EXPECT_FALSE(pin.empty());
+    EXPECT_EQ(group, pin.entry()->quotaGroup());
+    if (pin.entry()->isExclusive()) {
+      pin.entry()->setExclusiveToShared();
+    }
+    return pin.entry()->isUncached();
+  };
+  for (auto i = 0; i < 2; ++i) {
+    for (auto hot = 0; hot < kNumHot; ++hot) {
+      load(hot * kSize, dashboard);
+    }
+  }
+  // 'adhoc' reads twice the capacity. Only its own entries are evicted.
+  uint64_t offset = kNumHot * kSize;
+  for (auto i = 0; i < 2 * kMaxBytes / kSize; ++i) {
+    EXPECT_FALSE(load(offset, adhoc));
+    offset += kSize;
+  }
+  // 'capped' gets no more than its hard quota.
+  int32_t numUncached = 0;
+  for (auto i = 0; i < 500; ++i) {
+    numUncached += load(offset, capped);
+    offset += kSize;
+  }
+  EXPECT_LT(0, numUncached);
+  for (auto hot = 0; hot < kNumHot; ++hot) {
+    EXPECT_TRUE(
+        cache_->exists(RawFileCacheKey{filenames_[0].id(), hot * kSize}));
+  }
+
+  auto stats = cache_->quotaStats();
+  ASSERT_EQ(4, stats.size());
+  EXPECT_EQ(0, stats[dashboard].numEvict);
+  EXPECT_EQ(kNumHot * kSize, stats[dashboard].bytes);
+  EXPECT_EQ(0.5, stats[dashboard].hitRate());
+  EXPECT_LT(0, stats[adhoc].numEvict);
+  EXPECT_EQ(0, stats[adhoc].hitRate());
+  EXPECT_GE((2 << 20) + kSize, stats[capped].bytes);
+  EXPECT_EQ(500, stats[capped].numNew);
+  EXPECT_EQ(
+      cache_->refreshStats().largeSize,
+      stats[dashboard].bytes + stats[adhoc].bytes + stats[capped].bytes);
+}
+
+TEST_F(AsyncDataCacheTest, residency) {
+  constexpr int32_t kSize = 16 << 10;
+  initializeCache(16 << 20);
+  auto load = [&](int32_t file, int32_t numEntries) {
+    for (auto i = 0; i < numEntries; ++i) {
+      RawFileCacheKey key{
+          filenames_[file].id(), static_cast<uint64_t>(i) * kSize};
+      auto pin = cache_->findOrCreate(key, kSize);
+      ASSERT_FALSE(pin.empty());
+      if (pin.entry()->isExclusive()) {
+        pin.entry()->setExclusiveToShared();
+      }
+    }
+  };
+  load(0, 10);
+  load(1, 3);
+  load(2, 7);
+
+  auto residency = cache_->residency(
+      {"testing_file_1", "testing_file_3", "no_such_file", "testing_file_0"});
+  ASSERT_EQ(4, residency.size());
+  EXPECT_EQ("testing_file_1", residency[0].path);
+  EXPECT_EQ(filenames_[1].id(), residency[0].fileNum);
+  EXPECT_EQ(3, residency[0].numEntries);
+  EXPECT_EQ(3 * kSize, residency[0].bytes);
+  EXPECT_EQ(0, residency[1].totalBytes());
+  EXPECT_EQ(StringIdMap::kNoId, residency[2].fileNum);
+  EXPECT_EQ(0, residency[2].totalBytes());
+  EXPECT_EQ(10 * kSize, residency[3].totalBytes());
+
+  auto top = cache_->topResidency(2);
+  ASSERT_EQ(2, top.size());
+  EXPECT_EQ("testing_file_0", top[0].path);
+  EXPECT_EQ(10 * kSize, top[0].bytes);
+  EXPECT_EQ("testing_file_2", top[1].path);
+  EXPECT_EQ(7, top[1].numEntries);
+  EXPECT_EQ(3, cache_->topResidency(100).size());
+}
+
+TEST_F(AsyncDataCacheTest, compressedTier) {
+  constexpr int64_t kMaxBytes = 16 << 20;
+  constexpr int32_t kSize = 64 << 10;
+  constexpr int32_t kNumEntries = 2 * kMaxBytes / kSize;
+  initializeCache(kMaxBytes);
+  cache_->setCompression(64 << 20);
+  // Checks the data of new and decompressed entries.
+  cache_->setVerifyHook(checkContents);
+  auto fileNum = filenames_[0].id();
+  auto load = [&](uint64_t offset) {
+    auto pin = cache_->findOrCreate(RawFileCacheKey{fileNum, offset}, kSize);
+    EXPECT_FALSE(pin.empty());
+    if (pin.entry()->isShared()) {
+      return true;
+    }
+    initializeContents(fileNum + offset, pin.entry()->data());
+    pin.entry()->setExclusiveToShared();
+    return false;
+  };
+  for (auto i = 0; i < kNumEntries; ++i) {
+    EXPECT_FALSE(load(i * static_cast<uint64_t>(kSize)));
+  }
+  auto stats = cache_->refreshStats();
+  EXPECT_LT(0, stats.numCompress);
+  EXPECT_LT(0, stats.numCompressed);
+  EXPECT_LT(stats.compressedSize, stats.compressedDataSize);
+  EXPECT_GE(kMaxBytes, stats.largeSize);
+
+  // More entries are found than fit in memory uncompressed.
+  int32_t numHit = 0;
+  for (auto i = 0; i < kNumEntries; ++i) {
+    numHit += load(i * static_cast<uint64_t>(kSize));
+  }
+  EXPECT_LT(kMaxBytes / kSize, numHit);
+  stats = cache_->refreshStats();
+  EXPECT_LT(0, stats.numDecompress);
+  EXPECT_NE(std::string::npos, cache_->toString().find("Compressed:"));
+
+  cache_->clear();
+  EXPECT_EQ(0, cache_->refreshStats().compressedSize);
+}
+
 TEST_F(AsyncDataCacheTest, ssd) {
   constexpr uint64_t kRamBytes = 32 << 20;
   constexpr uint64_t kSsdBytes = 512UL << 20;
@@ -642,6 +858,8 @@ TEST_F(AsyncDataCacheTest, ssd) {
   auto stats2 = cache_->ssdCache()->stats();
   EXPECT_GT(stats2.bytesWritten, stats.bytesWritten);
   EXPECT_GT(stats2.bytesRead, stats.bytesRead);
+  EXPECT_GT(stats2.readLatencyUs.count(), stats.readLatencyUs.count());
+  EXPECT_GT(stats2.writeLatencyUs.count(), 0);
 
   // Check that no pins are leaked.
   EXPECT_EQ(0, stats2.numPins);
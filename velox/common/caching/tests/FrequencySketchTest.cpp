@@ -0,0 +1,61 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#include "velox/common/caching/FrequencySketch.h"
+
+#include <gtest/gtest.h>
+
+using namespace facebook::velox::cache;
+
+TEST(FrequencySketchTest, estimate) {
+  FrequencySketch sketch(4000);
+  EXPECT_EQ(4096, sketch.width());
+  // A few hot keys among many keys seen once.
+  for (uint64_t i = 0; i < 500; ++i) {
+    sketch.record(i);
+    if (i % 50 == 0) {
+      for (uint64_t hot = 0; hot < 4; ++hot) {
+        sketch.record(1'000'000 + hot);
+      }
+    }
+  }
+  for (uint64_t hot = 0; hot < 4; ++hot) {
+    EXPECT_LE(10, sketch.estimate(1'000'000 + hot));
+  }
+  int32_t numOverEstimated = 0;
+  for (uint64_t i = 0; i < 500; ++i) {
+    auto count = sketch.estimate(i);
+    EXPECT_LE(1, count);
+    numOverEstimated += count > 1;
+  }
+  EXPECT_GT(5, numOverEstimated);
+  EXPECT_EQ(0, sketch.estimate(2'000'000));
+}
+
+TEST(FrequencySketchTest, aging) {
+  FrequencySketch sketch(16);
+  for (auto i = 0; i < 100; ++i) {
+    sketch.record(1);
+  }
+  EXPECT_EQ(FrequencySketch::kMaxCount, sketch.estimate(1));
+  // 10 records per counter halve all counts.
+  for (uint64_t i = 0; i < 160 - 100; ++i) {
+    sketch.record(100 + i);
+  }
+  EXPECT_EQ(1, sketch.numResets());
+  EXPECT_EQ(FrequencySketch::kMaxCount / 2, sketch.estimate(1));
+}
@@ -18,6 +18,7 @@
 #include "velox/common/caching/SsdCache.h"
 #include "velox/exec/tests/utils/TempDirectoryPath.h"
 
+#include <folly/executors/CPUThreadPoolExecutor.h>
 #include <folly/executors/QueuedImmediateExecutor.h>
 #include <glog/logging.h>
 #include <gtest/gtest.h>
@@ -47,7 +48,10 @@ class SsdFileTest : public testing::Test {
     }
   }
 
-  void initializeCache(int64_t maxBytes, int64_t ssdBytes = 0) {
+  void initializeCache(
+      int64_t maxBytes,
+      int64_t ssdBytes = 0,
+      int64_t checkpointIntervalBytes = 0) {
     // tmpfs does not support O_DIRECT, so turn this off for testing.
     FLAGS_ssd_odirect = false;
     cache_ = std::make_shared<AsyncDataCache>(
@@ -59,7 +63,8 @@ class SsdFileTest : public testing::Test {
     ssdFile_ = std::make_unique<SsdFile>(
         fmt::format("{}/ssdtest", tempDirectory_->path),
         0,
-        bits::roundUp(ssdBytes, SsdFile::kRegionSize) / SsdFile::kRegionSize);
+        bits::roundUp(ssdBytes, SsdFile::kRegionSize) / SsdFile::kRegionSize,
+        checkpointIntervalBytes);
   }
 
   static void initializeContents(
@@ -295,3 +300,48 @@ TEST_F(SsdFileTest, writeAndRead) {
     }
   }
 }
+
+TEST_F(SsdFileTest, recoverWithSmallerCapacity) {
+  constexpr int32_t kNumRegions = 4;
+  constexpr int64_t kCheckpointIntervalBytes = 1L << 40;
+  initializeCache(
+      128 * kMB, kNumRegions * SsdFile::kRegionSize, kCheckpointIntervalBytes);
+  std::vector<TestEntry> allEntries;
+  for (auto region = 0; region < kNumRegions; ++region) {
+    auto pins = makePins(
+        fileName_.id(),
+        region * SsdFile::kRegionSize,
+        4096,
+        2048 * 1025,
+        62 * kMB);
+    ssdFile_->write(pins);
+    for (auto& pin : pins) {
+      EXPECT_EQ(ssdFile_.get(), pin.entry()->ssdFile());
+      allEntries.emplace_back(
+          pin.entry()->key(), pin.entry()->ssdOffset(), pin.entry()->size());
+    }
+  }
+  ssdFile_->checkpoint(true);
+
+  // A cache with half the capacity takes over the file. The checkpoint
+  // is read in the background.
+  folly::CPUThreadPoolExecutor executor(1);
+  ssdFile_ = std::make_unique<SsdFile>(
+      fmt::format("{}/ssdtest", tempDirectory_->path),
+      0,
+      kNumRegions / 2,
+      kCheckpointIntervalBytes,
+      &executor);
+  ssdFile_->waitForRecovery();
+  EXPECT_FALSE(ssdFile_->isRecovering());
+  int32_t numFound = 0;
+  for (auto& entry : allEntries) {
+    auto found =
+        !ssdFile_->find(RawFileCacheKey{fileName_.id(), entry.key.offset})
+             .empty();
+    EXPECT_EQ(entry.ssdOffset < kNumRegions / 2 * SsdFile::kRegionSize, found);
+    numFound += found;
+  }
+  EXPECT_LT(0, numFound);
+  EXPECT_GT(allEntries.size(), numFound);
+}
@@ -0,0 +1,97 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#include "velox/common/caching/SsdIo.h"
+#include "velox/common/base/tests/GTestUtils.h"
+#include "velox/exec/tests/utils/TempDirectoryPath.h"
+
+#include <fcntl.h>
+#include <gtest/gtest.h>
+#include <unistd.h>
+
+using namespace facebook::velox;
+using namespace facebook::velox::cache;
+
+class SsdIoTest : public testing::TestWithParam<bool> {
+ protected:
+  void SetUp() override {
+    tempDirectory_ = exec::test::TempDirectoryPath::create();
+    fd_ = open(
+        fmt::format("{}/ssdio", tempDirectory_->path).c_str(),
+        O_CREAT | O_RDWR,
+        S_IRUSR | S_IWUSR);
+    ASSERT_LE(0, fd_);
+    io_ = SsdIo::create(fd_, GetParam());
+  }
+
+  void TearDown() override {
+    io_.reset();
+    close(fd_);
+  }
+
+  std::shared_ptr<exec::test::TempDirectoryPath> tempDirectory_;
+  int32_t fd_;
+  std::unique_ptr<SsdIo> io_;
+};
+
+TEST_P(SsdIoTest, batch) {
+  // More requests than fit in the queue, each with 2 iovecs.
+  constexpr int32_t kNumRequests = SsdIo::kQueueDepth * 3 + 1;
+  constexpr int32_t kSize = 1000;
+  std::vector<std::string> data(kNumRequests * 2);
+  std::vector<SsdIoRequest> requests;
+  for (auto i = 0; i < kNumRequests; ++i) {
+    SsdIoRequest request{static_cast<uint64_t>(i) * 2 * kSize};
+    for (auto j = 0; j < 2; ++j) {
+      auto& buffer = data[i * 2 + j];
+      buffer.resize(kSize, 'a' + (i + j) % 26);
+      request.iovecs.push_back({buffer.data(), buffer.size()});
+    }
+    requests.push_back(std::move(request));
+  }
+  io_->write(requests);
+  for (auto& request : requests) {
+    EXPECT_EQ(2 * kSize, request.result);
+  }
+
+  // Reads back in reverse order, each request into one buffer.
+  std::vector<std::string> readData(kNumRequests);
+  std::vector<SsdIoRequest> reads;
+  for (auto i = kNumRequests - 1; i >= 0; --i) {
+    readData[i].resize(2 * kSize);
+    SsdIoRequest request{static_cast<uint64_t>(i) * 2 * kSize};
+    request.iovecs.push_back({readData[i].data(), readData[i].size()});
+    reads.push_back(std::move(request));
+  }
+  io_->read(reads);
+  for (auto i = 0; i < kNumRequests; ++i) {
+    EXPECT_EQ(2 * kSize, reads[i].result);
+    EXPECT_EQ(data[i * 2] + data[i * 2 + 1], readData[i]);
+  }
+
+  // A read past the end of the file is short.
+  std::string pastEnd(kSize, 0);
+  std::vector<SsdIoRequest> shortRead{
+      SsdIoRequest{2 * kSize * kNumRequests - 10, {{pastEnd.data(), kSize}}}};
+  io_->read(shortRead);
+  EXPECT_EQ(10, shortRead[0].result);
+}
+
+VELOX_INSTANTIATE_TEST_SUITE_P(
+    SsdIoTest,
+    SsdIoTest,
+    testing::Values(false, true));
@@ -15,6 +15,7 @@
  */
 
 #include "velox/common/file/File.h"
+#include "velox/common/file/IoRing.h"
 
 #include <fmt/format.h>
 #include <glog/logging.h>
@@ -23,6 +24,8 @@
 
 #include <fcntl.h>
 #include <folly/portability/SysUio.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
 
 namespace facebook::velox {
 
@@ -99,9 +102,11 @@ std::string LocalReadFile::pread(uint64_t offset, uint64_t length) const {
   return result;
 }
 
-uint64_t LocalReadFile::preadv(
-    uint64_t offset,
-    const std::vector<folly::Range<char*>>& buffers) const {
+namespace {
+// Returns the iovecs for reading into 'buffers'. The ranges with nullptr
+// data are read into a scratch buffer and dropped.
+std::vector<struct iovec> toIovecs(
+    const std::vector<folly::Range<char*>>& buffers) {
   // Dropped bytes sized so that a typical dropped range of 50K is not
   // too many iovecs.
   static char droppedBytes[16 * 1024];
@@ -119,9 +124,31 @@ uint64_t LocalReadFile::preadv(
       iovecs.push_back({range.data(), range.size()});
     }
   }
+  return iovecs;
+}
+} // namespace
+
+uint64_t LocalReadFile::preadv(
+    uint64_t offset,
+    const std::vector<folly::Range<char*>>& buffers) const {
+  auto iovecs = toIovecs(buffers);
   return folly::preadv(fd_, iovecs.data(), iovecs.size(), offset);
 }
 
+folly::SemiFuture<uint64_t> LocalReadFile::preadvAsync(
+    uint64_t offset,
+    const std::vector<folly::Range<char*>>& buffers) const {
+  auto ring = IoRing::instance();
+  if (!ring) {
+    return ReadFile::preadvAsync(offset, buffers);
+  }
+  return ring->preadv(fd_, offset, toIovecs(buffers));
+}
+
+bool LocalReadFile::hasPreadvAsync() const {
+  return IoRing::instance() != nullptr;
+}
+
 uint64_t LocalReadFile::size() const {
   if (size_ != -1) {
     return size_;
@@ -140,6 +167,94 @@ uint64_t LocalReadFile::memoryUsage() const {
   return sizeof(FILE);
 }
 
+MmapReadFile::MmapReadFile(std::string_view path) {
+  const std::string pathString(path);
+  fd_ = open(pathString.c_str(), O_RDONLY);
+  VELOX_CHECK_GE(fd_, 0, "open failure in MmapReadFile constructor, {}.", path);
+  struct stat fileStat;
+  VELOX_CHECK_EQ(
+      fstat(fd_, &fileStat), 0, "fstat failure in MmapReadFile, {}.", path);
+  size_ = fileStat.st_size;
+  if (size_ == 0) {
+    return;
+  }
+  auto data = mmap(nullptr, size_, PROT_READ, MAP_SHARED, fd_, 0);
+  if (data == MAP_FAILED) {
+    ::close(fd_);
+    VELOX_FAIL("mmap failure in MmapReadFile, {}.", path);
+  }
+  data_ = static_cast<char*>(data);
+}
+
+MmapReadFile::~MmapReadFile() {
+  if (data_) {
+    munmap(data_, size_);
+  }
+  ::close(fd_);
+}
+
+const char* MmapReadFile::checkedRange(uint64_t offset, uint64_t length)
+    const {
+  VELOX_CHECK_LE(
+      offset + length,
+      size_,
+      "Read past the end of MmapReadFile, {} + {} > {}.",
+      offset,
+      length,
+      size_);
+  bytesRead_ += length;
+  return data_ ? data_ + offset : nullptr;
+}
+
+std::string_view
+MmapReadFile::pread(uint64_t offset, uint64_t length, void* buf) const {
+  auto data = checkedRange(offset, length);
+  if (length > 0) {
+    memcpy(buf, data, length);
+  }
+  return {static_cast<char*>(buf), length};
+}
+
+std::string MmapReadFile::pread(uint64_t offset, uint64_t length) const {
+  auto data = checkedRange(offset, length);
+  return length > 0 ? std::string(data, length) : std::string();
+}
+
+uint64_t MmapReadFile::preadv(
+    uint64_t offset,
+    const std::vector<folly::Range<char*>>& buffers) const {
+  uint64_t length = 0;
+  for (auto& range : buffers) {
+    length += range.size();
+  }
+  auto data = checkedRange(offset, length);
+  for (auto& range : buffers) {
+    if (range.data()) {
+      memcpy(range.data(), data, range.size());
+    }
+    data += range.size();
+  }
+  return length;
+}
+
+std::optional<std::string_view> MmapReadFile::readInPlace(
+    uint64_t offset,
+    uint64_t length) const {
+  auto data = checkedRange(offset, length);
+  return std::string_view(data, data ? length : 0);
+}
+
+void MmapReadFile::willNeed(uint64_t offset, uint64_t length) const {
+  if (!data_ || length == 0 || offset >= size_) {
+    return;
+  }
+  // madvise needs a page aligned start.
+  static const uint64_t kPageSize = sysconf(_SC_PAGESIZE);
+  auto begin = offset / kPageSize * kPageSize;
+  auto end = std::min(offset + length, size_);
+  madvise(data_ + begin, end - begin, MADV_WILLNEED);
+}
+
 LocalWriteFile::LocalWriteFile(std::string_view path) {
   std::unique_ptr<char[]> buf(new char[path.size() + 1]);
   buf[path.size()] = 0;
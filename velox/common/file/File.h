@@ -30,6 +30,7 @@
 #include <cstdint>
 #include <cstdio>
 #include <functional>
+#include <optional>
 #include <string>
 #include <string_view>
 
@@ -81,6 +82,20 @@ class ReadFile {
     return false;
   }
 
+  // Returns a view of [offset, offset + length) that stays valid as long as
+  // 'this' if the file is in memory or mapped, so that the caller can use
+  // the bytes without copying them. Returns std::nullopt if the bytes must
+  // be read with pread().
+  virtual std::optional<std::string_view> readInPlace(
+      uint64_t /*offset*/,
+      uint64_t /*length*/) const {
+    return std::nullopt;
+  }
+
+  // Hints that [offset, offset + length) will be read soon, so that the
+  // implementation may start reading it ahead. Does nothing by default.
+  virtual void willNeed(uint64_t /*offset*/, uint64_t /*length*/) const {}
+
   // Whether preads should be coalesced where possible. E.g. remote disk would
   // set to true, in-memory to false.
   virtual bool shouldCoalesce() const = 0;
@@ -206,6 +221,14 @@ class LocalReadFile final : public ReadFile {
       uint64_t offset,
       const std::vector<folly::Range<char*>>& buffers) const final;
 
+  // Reads with the process-wide IoRing if there is one. 'this' and
+  // 'buffers' must stay live until the result is set.
+  folly::SemiFuture<uint64_t> preadvAsync(
+      uint64_t offset,
+      const std::vector<folly::Range<char*>>& buffers) const final;
+
+  bool hasPreadvAsync() const final;
+
   uint64_t memoryUsage() const final;
 
   bool shouldCoalesce() const final {
@@ -220,6 +243,54 @@ class LocalReadFile final : public ReadFile {
   mutable long size_ = -1;
 };
 
+// A local file that is mapped into memory. pread() and preadv() copy from
+// the mapping and readInPlace() returns views into it, so that readers of
+// uncompressed data need not copy at all. willNeed() advises the kernel to
+// read ahead the ranges a reader plans to read.
+class MmapReadFile final : public ReadFile {
+ public:
+  explicit MmapReadFile(std::string_view path);
+
+  ~MmapReadFile() override;
+
+  std::string_view
+  pread(uint64_t offset, uint64_t length, void* FOLLY_NONNULL buf) const final;
+
+  std::string pread(uint64_t offset, uint64_t length) const final;
+
+  uint64_t preadv(
+      uint64_t offset,
+      const std::vector<folly::Range<char*>>& buffers) const final;
+
+  std::optional<std::string_view> readInPlace(uint64_t offset, uint64_t length)
+      const final;
+
+  void willNeed(uint64_t offset, uint64_t length) const final;
+
+  uint64_t size() const final {
+    return size_;
+  }
+
+  uint64_t memoryUsage() const final {
+    return sizeof(*this);
+  }
+
+  bool shouldCoalesce() const final {
+    return false;
+  }
+
+ private:
+  // Checks that [offset, offset + length) is in the file and counts it in
+  // 'bytesRead_'. Returns the start of the range in the mapping.
+  const char* FOLLY_NULLABLE checkedRange(uint64_t offset, uint64_t length)
+      const;
+
+  int32_t fd_;
+  uint64_t size_{0};
+  // Start of the mapping. nullptr if the file is empty.
+  char* FOLLY_NULLABLE data_{nullptr};
+};
+
 class LocalWriteFile final : public WriteFile {
  public:
   // An error is thrown is a file already exists at |path|.
@@ -28,6 +28,10 @@ namespace {
 
 constexpr std::string_view kFileScheme("file:");
 
+// If true, local files are opened as MmapReadFile, so that the readers of
+// uncompressed data read them in place.
+const std::string kMmapReads = "local.mmap-reads";
+
 using RegisteredFileSystems = std::vector<std::pair<
     std::function<bool(std::string_view)>,
     std::function<std::shared_ptr<FileSystem>(std::shared_ptr<const Config>)>>>;
@@ -77,7 +81,10 @@ class LocalFileSystem : public FileSystem {
 
   std::unique_ptr<ReadFile> openFileForRead(std::string_view path) override {
     if (path.find(kFileScheme) == 0) {
-      return std::make_unique<LocalReadFile>(path.substr(kFileScheme.length()));
+      path = path.substr(kFileScheme.length());
+    }
+    if (config_ && config_->get<bool>(kMmapReads, false)) {
+      return std::make_unique<MmapReadFile>(path);
     }
     return std::make_unique<LocalReadFile>(path);
   }
@@ -16,6 +16,7 @@
 
 #include "velox/common/file/File.h"
 #include "velox/common/file/FileSystems.h"
+#include "velox/common/file/IoRing.h"
 #include "velox/exec/tests/utils/TempFilePath.h"
 
 #include "gtest/gtest.h"
@@ -92,6 +93,40 @@ TEST(LocalFile, writeAndRead) {
   readData(&readFile);
 }
 
+TEST(LocalFile, preadvAsync) {
+  auto tempFile = ::exec::test::TempFilePath::create();
+  const auto& filename = tempFile->path.c_str();
+  remove(filename);
+  {
+    LocalWriteFile writeFile(filename);
+    writeData(&writeFile);
+  }
+  LocalReadFile readFile(filename);
+  // Asynchronous with io_uring, synchronous otherwise.
+  EXPECT_EQ(readFile.hasPreadvAsync(), IoRing::instance() != nullptr);
+
+  // Many reads in flight at once, each with a gap.
+  constexpr int32_t kNumReads = 200;
+  std::vector<std::array<char, 10>> heads(kNumReads);
+  std::vector<std::array<char, 5>> tails(kNumReads);
+  std::vector<folly::SemiFuture<uint64_t>> futures;
+  for (auto i = 0; i < kNumReads; ++i) {
+    std::vector<folly::Range<char*>> buffers = {
+        folly::Range<char*>(heads[i].data(), heads[i].size()),
+        folly::Range<char*>(nullptr, kOneMB - i),
+        folly::Range<char*>(tails[i].data(), tails[i].size())};
+    futures.push_back(readFile.preadvAsync(i, buffers));
+  }
+  const auto start = "aaaaabbbbb" + std::string(kNumReads, 'c');
+  for (auto i = 0; i < kNumReads; ++i) {
+    ASSERT_EQ(std::move(futures[i]).get(), 15 + kOneMB - i);
+    ASSERT_EQ(
+        std::string_view(heads[i].data(), heads[i].size()),
+        start.substr(i, 10));
+    ASSERT_EQ(std::string_view(tails[i].data(), tails[i].size()), "ddddd");
+  }
+}
+
 TEST(LocalFile, viaRegistry) {
   filesystems::registerLocalFileSystem();
   auto tempFile = ::exec::test::TempFilePath::create();
@@ -108,3 +143,27 @@ TEST(LocalFile, viaRegistry) {
   ASSERT_EQ(readFile->pread(0, 5, &buffer1), "snarf");
   lfs->remove(filename);
 }
+
+TEST(MmapFile, writeAndRead) {
+  auto tempFile = ::exec::test::TempFilePath::create();
+  const auto& filename = tempFile->path.c_str();
+  remove(filename);
+  {
+    LocalWriteFile writeFile(filename);
+    writeData(&writeFile);
+  }
+  MmapReadFile readFile(filename);
+  readData(&readFile);
+
+  // Reading in place returns the bytes of the mapping without a copy.
+  auto first = readFile.readInPlace(kOneMB, 15);
+  ASSERT_TRUE(first.has_value());
+  ASSERT_EQ(first.value(), "ccccccccccddddd");
+  auto second = readFile.readInPlace(kOneMB + 10, 5);
+  ASSERT_EQ(second.value().data(), first.value().data() + 10);
+  readFile.willNeed(0, readFile.size());
+  EXPECT_THROW(readFile.readInPlace(kOneMB, 16), VeloxException);
+
+  LocalReadFile localFile(filename);
+  ASSERT_FALSE(localFile.readInPlace(0, 5).has_value());
+}
@@ -0,0 +1,219 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#include "velox/common/file/IoRing.h"
+#include "velox/common/base/Exceptions.h"
+
+#include <glog/logging.h>
+
+#ifdef VELOX_ENABLE_IO_URING
+#include <fmt/format.h>
+#include <folly/String.h>
+#include <liburing.h>
+
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <thread>
+#endif
+
+namespace facebook::velox {
+
+#ifdef VELOX_ENABLE_IO_URING
+namespace {
+
+class IoUringRing : public IoRing {
+ public:
+  ~IoUringRing() override {
+    {
+      std::lock_guard<std::mutex> l(mutex_);
+      stop_ = true;
+    }
+    cv_.notify_one();
+    if (thread_.joinable()) {
+      thread_.join();
+    }
+    io_uring_queue_exit(&ring_);
+  }
+
+  // Returns true if the kernel supports io_uring.
+  bool initialize() {
+    auto rc = io_uring_queue_init(kQueueDepth, &ring_, 0);
+    if (rc < 0) {
+      LOG(WARNING) << "io_uring_queue_init failed: " << -rc;
+      return false;
+    }
+    thread_ = std::thread([this]() { run(); });
+    return true;
+  }
+
+  folly::SemiFuture<uint64_t>
+  preadv(int32_t fd, uint64_t offset, std::vector<iovec> iovecs) override {
+    auto request = std::make_unique<Request>();
+    request->fd = fd;
+    request->offset = offset;
+    request->iovecs = std::move(iovecs);
+    auto future = request->promise.getSemiFuture();
+    {
+      std::lock_guard<std::mutex> l(mutex_);
+      pending_.push_back(std::move(request));
+    }
+    cv_.notify_one();
+    return future;
+  }
+
+ private:
+  struct Request {
+    int32_t fd;
+    uint64_t offset;
+    std::vector<iovec> iovecs;
+    folly::Promise<uint64_t> promise;
+
+    uint64_t size() const {
+      uint64_t total = 0;
+      for (auto& iov : iovecs) {
+        total += iov.iov_len;
+      }
+      return total;
+    }
+  };
+
+  // Submits the pending requests that fit in the ring, then reaps the
+  // completions. Waits for new requests when there is nothing in flight.
+  // Returns after the requests in flight complete once 'stop_' is set.
+  void run() {
+    for (;;) {
+      std::vector<std::unique_ptr<Request>> batch;
+      {
+        std::unique_lock<std::mutex> l(mutex_);
+        if (numInFlight_ == 0) {
+          cv_.wait(l, [&]() { return stop_ || !pending_.empty(); });
+        }
+        if (stop_ && numInFlight_ == 0) {
+          break;
+        }
+        while (!stop_ && !pending_.empty() && numInFlight_ < kQueueDepth) {
+          batch.push_back(std::move(pending_.front()));
+          pending_.pop_front();
+          ++numInFlight_;
+        }
+      }
+      for (auto& request : batch) {
+        auto sqe = io_uring_get_sqe(&ring_);
+        VELOX_CHECK_NOT_NULL(sqe, "io_uring submission queue is full");
+        io_uring_prep_readv(
+            sqe,
+            request->fd,
+            request->iovecs.data(),
+            request->iovecs.size(),
+            request->offset);
+        io_uring_sqe_set_data(sqe, request.release());
+      }
+      if (!batch.empty()) {
+        auto rc = io_uring_submit(&ring_);
+        if (rc < 0) {
+          LOG(ERROR) << "io_uring_submit failed: " << -rc;
+        }
+      }
+      reap();
+    }
+    failPending();
+  }
+
+  // Completes the finished requests. Waits a short time for one to finish
+  // so that new requests are submitted without much delay.
+  void reap() {
+    io_uring_cqe* cqe;
+    __kernel_timespec timeout{0, 100'000};
+    if (io_uring_wait_cqe_timeout(&ring_, &cqe, &timeout) < 0) {
+      return;
+    }
+    unsigned head;
+    unsigned numCompleted = 0;
+    io_uring_for_each_cqe(&ring_, head, cqe) {
+      std::unique_ptr<Request> request(
+          reinterpret_cast<Request*>(io_uring_cqe_get_data(cqe)));
+      complete(*request, cqe->res);
+      ++numCompleted;
+    }
+    io_uring_cq_advance(&ring_, numCompleted);
+    std::lock_guard<std::mutex> l(mutex_);
+    numInFlight_ -= numCompleted;
+  }
+
+  // Sets the result of 'request' from 'result', the bytes read or -errno.
+  // A short read is rare and is redone synchronously.
+  static void complete(Request& request, int32_t result) {
+    if (result >= 0 && static_cast<uint64_t>(result) < request.size()) {
+      result = folly::preadv(
+          request.fd,
+          request.iovecs.data(),
+          request.iovecs.size(),
+          request.offset);
+      if (result < 0) {
+        result = -errno;
+      }
+    }
+    if (result < 0) {
+      request.promise.setException(std::runtime_error(
+          fmt::format("io_uring preadv failed: {}", folly::errnoStr(-result))));
+      return;
+    }
+    request.promise.setValue(result);
+  }
+
+  // Fails the requests that are not yet submitted when 'this' is
+  // destroyed.
+  void failPending() {
+    std::lock_guard<std::mutex> l(mutex_);
+    for (auto& request : pending_) {
+      request->promise.setException(
+          std::runtime_error("IoRing destroyed before the read was issued"));
+    }
+    pending_.clear();
+  }
+
+  io_uring ring_;
+  std::thread thread_;
+  std::mutex mutex_;
+  std::condition_variable cv_;
+  std::deque<std::unique_ptr<Request>> pending_;
+  int32_t numInFlight_{0};
+  bool stop_{false};
+};
+
+} // namespace
+#endif
+
+// static
+IoRing* IoRing::instance() {
+#ifdef VELOX_ENABLE_IO_URING
+  static std::unique_ptr<IoRing> ring = []() -> std::unique_ptr<IoRing> {
+    auto ring = std::make_unique<IoUringRing>();
+    if (ring->initialize()) {
+      return ring;
+    }
+    LOG(WARNING) << "io_uring is not available, local reads are synchronous";
+    return nullptr;
+  }();
+  return ring.get();
+#else
+  return nullptr;
+#endif
+}
+
+} // namespace facebook::velox
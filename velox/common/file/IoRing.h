@@ -0,0 +1,51 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#pragma once
+
+#include <folly/futures/Future.h>
+#include <folly/portability/SysUio.h>
+
+#include <vector>
+
+namespace facebook::velox {
+
+// Runs preadv on local files asynchronously. There is one IoRing per
+// process. It is backed by an io_uring served by an I/O thread that
+// submits the queued reads in batches with one system call and polls for
+// their completions, so that many reads are in flight with few threads.
+// Thread safe.
+class IoRing {
+ public:
+  // Maximum number of reads in flight in the ring.
+  static constexpr int32_t kQueueDepth = 128;
+
+  virtual ~IoRing() = default;
+
+  // Returns the process-wide IoRing or nullptr if Velox is built without
+  // VELOX_ENABLE_IO_URING or the kernel does not support io_uring.
+  static IoRing* FOLLY_NULLABLE instance();
+
+  // Reads from 'fd' at 'offset' into 'iovecs'. The result is the number of
+  // bytes read, which is the total size of 'iovecs' unless the file ends
+  // before. 'fd' and the memory of 'iovecs' must stay valid until the
+  // result is set.
+  virtual folly::SemiFuture<uint64_t>
+  preadv(int32_t fd, uint64_t offset, std::vector<iovec> iovecs) = 0;
+};
+
+} // namespace facebook::velox
@@ -42,6 +42,7 @@ char* AllocationPool::allocateFixed(uint64_t bytes) {
     if (!mappedMemory_->allocateContiguous(numPages, nullptr, *largeAlloc)) {
       throw std::bad_alloc();
     }
+    ++numMappedMemoryAllocations_;
     largeAllocations_.emplace_back(std::move(largeAlloc));
     auto res = largeAllocations_.back()->data<char>();
     VELOX_CHECK_NOT_NULL(
@@ -59,6 +60,29 @@ char* AllocationPool::allocateFixed(uint64_t bytes) {
   return reinterpret_cast<char*>(run.data() + currentOffset_ - bytes);
 }
 
+void AllocationPool::truncate(
+    int32_t allocationIndex,
+    int32_t runIndex,
+    int64_t offset) {
+  VELOX_CHECK_LT(allocationIndex, numSmallAllocations());
+  if (allocationIndex < allocations_.size()) {
+    {
+      // Free the current allocation.
+      auto copy = std::move(allocation_);
+    }
+    allocation_ = std::move(*allocations_[allocationIndex]);
+    allocations_.resize(allocationIndex);
+  }
+  if (!allocation_.numRuns()) {
+    VELOX_CHECK_EQ(offset, 0);
+    return;
+  }
+  VELOX_CHECK_LT(runIndex, allocation_.numRuns());
+  currentRun_ = runIndex;
+  VELOX_CHECK_LE(offset, currentRun().numBytes());
+  currentOffset_ = offset;
+}
+
 void AllocationPool::newRunImpl(memory::MachinePageCount numPages) {
   ++currentRun_;
   if (currentRun_ >= allocation_.numRuns()) {
@@ -66,14 +90,23 @@ void AllocationPool::newRunImpl(memory::MachinePageCount numPages) {
       allocations_.push_back(std::make_unique<memory::MappedMemory::Allocation>(
           std::move(allocation_)));
     }
+    // Adds up to 1/8 of the small allocations so far.
+    int64_t numSmallPages = 0;
+    for (auto& allocation : allocations_) {
+      numSmallPages += allocation->numPages();
+    }
+    const int64_t growthPages =
+        std::min<int64_t>(kMaxGrowthPages, numSmallPages / 8);
     if (!mappedMemory_->allocate(
-            std::max<int32_t>(kMinPages, numPages),
+            std::max<int64_t>(
+                {kMinPages, static_cast<int64_t>(numPages), growthPages}),
             owner_,
             allocation_,
             nullptr,
             numPages)) {
       throw std::bad_alloc();
     }
+    ++numMappedMemoryAllocations_;
     currentRun_ = 0;
   }
   currentOffset_ = 0;
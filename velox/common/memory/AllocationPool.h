@@ -30,6 +30,11 @@ class AllocationPool {
   static constexpr int32_t kHashTableOwner = -3;
   static constexpr int32_t kMinPages = 16;
 
+  // Upper limit for the pages added by newRun() beyond the requested
+  // size. New runs grow with the pool, so that a large pool calls
+  // MappedMemory, which serializes allocations, less often.
+  static constexpr int32_t kMaxGrowthPages = 256;
+
   explicit AllocationPool(
       memory::MappedMemory* mappedMemory,
       int32_t owner = kHashTableOwner)
@@ -41,6 +46,12 @@ class AllocationPool {
 
   char* allocateFixed(uint64_t bytes);
 
+  // Frees the small allocations after the 'allocationIndex'th and makes
+  // 'offset' in its 'runIndex'th run the first free position. Used after
+  // moving the contents of 'this' towards its start. Large allocations are
+  // not affected.
+  void truncate(int32_t allocationIndex, int32_t runIndex, int64_t offset);
+
   // Starts a new run for variable length allocation. The actual size
   // is at least one machine page. Throws std::bad_alloc if no space.
   void newRun(int32_t preferredSize);
@@ -75,6 +86,12 @@ class AllocationPool {
     return currentOffset_;
   }
 
+  // Returns the number of allocations made from MappedMemory, including
+  // freed ones.
+  int64_t numMappedMemoryAllocations() const {
+    return numMappedMemoryAllocations_;
+  }
+
   int64_t allocatedBytes() const {
     int32_t totalPages = allocation_.numPages();
     for (auto& allocation : allocations_) {
@@ -128,6 +145,7 @@ class AllocationPool {
   memory::MappedMemory::Allocation allocation_;
   int32_t currentRun_ = 0;
   int32_t currentOffset_ = 0;
+  int64_t numMappedMemoryAllocations_{0};
   const int32_t owner_;
 };
 
@@ -16,6 +16,8 @@
 
 #include "velox/common/memory/ByteStream.h"
 
+#include <folly/io/IOBufQueue.h>
+
 namespace facebook::velox {
 
 std::streampos ByteStream::tellp() const {
@@ -59,7 +61,8 @@ void ByteStream::flush(OutputStream* out) {
     if (isBits_ && isReverseBitOrder_ && !isReversed_) {
       bits::reverseBits(ranges_[i].buffer, bytes);
     }
-    out->write(reinterpret_cast<char*>(ranges_[i].buffer), bytes);
+    out->writeFromArena(
+        reinterpret_cast<char*>(ranges_[i].buffer), bytes, arena_);
   }
   if (isBits_ && isReverseBitOrder_) {
     isReversed_ = true;
@@ -96,6 +99,31 @@ void freeFunc(void* /*data*/, void* userData) {
 }
 } // namespace
 
+void IOBufOutputStream::writeFromArena(
+    const char* s,
+    std::streamsize count,
+    StreamArena* arena) {
+  if (!sharedArena_ || arena != sharedArena_.get() || count < kMinSharedBytes) {
+    write(s, count);
+    return;
+  }
+  // Bytes are added only at the end. Seeks back are for overwriting
+  // headers.
+  const int64_t offset = out_->tellp();
+  VELOX_CHECK_EQ(offset, out_->size());
+  auto userData = new std::shared_ptr<StreamArena>(sharedArena_);
+  auto data = folly::IOBuf::takeOwnership(
+      const_cast<char*>(s), count, freeFunc, userData);
+  if (!shared_.empty() && shared_.back().offset == offset) {
+    shared_.back().data->prev()->appendChain(std::move(data));
+  } else {
+    shared_.push_back({offset, std::move(data)});
+  }
+  if (listener_) {
+    listener_->onWrite(s, count);
+  }
+}
+
 std::unique_ptr<folly::IOBuf> IOBufOutputStream::getIOBuf() {
   // Make an IOBuf for each range. The IOBufs keep shared ownership of
   // 'arena_'.
@@ -113,15 +141,54 @@ std::unique_ptr<folly::IOBuf> IOBufOutputStream::getIOBuf() {
       iobuf = std::move(newBuf);
     }
   }
-  return iobuf;
+  if (shared_.empty()) {
+    return iobuf;
+  }
+
+  // Splice the shared bytes between the bytes of 'out_' they follow.
+  folly::IOBufQueue own;
+  own.append(std::move(iobuf));
+  folly::IOBufQueue result;
+  int64_t offset = 0;
+  for (auto& shared : shared_) {
+    if (shared.offset > offset) {
+      result.append(own.split(shared.offset - offset));
+      offset = shared.offset;
+    }
+    result.append(shared.data->clone());
+  }
+  if (!own.empty()) {
+    result.append(own.move());
+  }
+  return result.move();
 }
 
 std::streampos IOBufOutputStream::tellp() const {
-  return out_->tellp();
+  int64_t position = out_->tellp();
+  int64_t sharedBytes = 0;
+  for (auto& shared : shared_) {
+    if (shared.offset > position) {
+      break;
+    }
+    sharedBytes += shared.data->computeChainDataLength();
+  }
+  return position + sharedBytes;
 }
 
 void IOBufOutputStream::seekp(std::streampos pos) {
-  out_->seekp(pos);
+  int64_t position = pos;
+  int64_t sharedBytes = 0;
+  for (auto& shared : shared_) {
+    const int64_t start = shared.offset + sharedBytes;
+    if (position < start) {
+      break;
+    }
+    const int64_t size = shared.data->computeChainDataLength();
+    VELOX_CHECK_GE(
+        position, start + size, "Cannot seek into bytes of a shared arena");
+    sharedBytes += size;
+  }
+  out_->seekp(position - sharedBytes);
 }
 
 } // namespace facebook::velox
@@ -48,6 +48,16 @@ class OutputStream {
 
   virtual void write(const char* s, std::streamsize count) = 0;
 
+  /// Writes 'count' bytes at 's', which are memory of 'arena'. A stream that
+  /// shares ownership of 'arena' may reference the bytes instead of copying
+  /// them. The bytes must then not change after the write.
+  virtual void writeFromArena(
+      const char* s,
+      std::streamsize count,
+      StreamArena* /*arena*/) {
+    write(s, count);
+  }
+
   virtual std::streampos tellp() const = 0;
 
   virtual void seekp(std::streampos pos) = 0;
@@ -358,7 +368,7 @@ class ByteStream {
     }
   }
 
-  StreamArena* arena_;
+  StreamArena* arena_{nullptr};
   // Indicates that position in ranges_ is in bits, not bytes.
   const bool isBits_;
   const bool isReverseBitOrder_;
@@ -409,6 +419,10 @@ class IOBufOutputStream : public OutputStream {
     out_->startWrite(initialSize);
   }
 
+  /// Ranges of at least this many bytes written from the shared arena are
+  /// referenced instead of copied.
+  static constexpr int32_t kMinSharedBytes = memory::MappedMemory::kPageSize;
+
   void write(const char* s, std::streamsize count) override {
     out_->appendStringPiece(folly::StringPiece(s, count));
     if (listener_) {
@@ -416,6 +430,18 @@ class IOBufOutputStream : public OutputStream {
     }
   }
 
+  void writeFromArena(
+      const char* s,
+      std::streamsize count,
+      StreamArena* arena) override;
+
+  /// Lets writes of memory of 'arena' add the memory to the IOBuf chain
+  /// without a copy. The chain keeps shared ownership of 'arena', so that
+  /// a serialized page goes to the network with no copy of its columns.
+  void shareArena(std::shared_ptr<StreamArena> arena) {
+    sharedArena_ = std::move(arena);
+  }
+
   std::streampos tellp() const override;
 
   void seekp(std::streampos pos) override;
@@ -423,8 +449,16 @@ class IOBufOutputStream : public OutputStream {
   std::unique_ptr<folly::IOBuf> getIOBuf();
 
  private:
+  // Bytes of 'sharedArena_' that follow the first 'offset' bytes of 'out_'.
+  struct SharedBytes {
+    int64_t offset;
+    std::unique_ptr<folly::IOBuf> data;
+  };
+
   std::shared_ptr<StreamArena> arena_;
   std::unique_ptr<ByteStream> out_;
+  std::shared_ptr<StreamArena> sharedArena_;
+  std::vector<SharedBytes> shared_;
 };
 
 } // namespace facebook::velox
@@ -161,7 +161,7 @@ void HashStringAllocator::newSlab(int32_t size) {
   // Add the new memory to the free list: Placement construct a header
   // that covers the space from start to the end marker and add this
   // to free list.
-  free(new (run) Header(available - sizeof(Header)));
+  freeToFreeList(new (run) Header(available - sizeof(Header)));
 }
 
 void HashStringAllocator::newRange(int32_t bytes, ByteRange* range) {
@@ -213,12 +213,16 @@ void HashStringAllocator::freeRestOfBlock(Header* header, int32_t keepBytes) {
 
   header->setSize(keepBytes);
   auto newHeader = new (header->end()) Header(freeSize);
-  free(newHeader);
+  freeToFreeList(newHeader);
 }
 
 HashStringAllocator::Header* FOLLY_NULLABLE
 HashStringAllocator::allocate(int32_t size, bool exactSize) {
   auto header = allocateFromFreeList(size, exactSize, exactSize);
+  if (!header && cachedBytes_ > 0) {
+    releaseCache();
+    header = allocateFromFreeList(size, exactSize, exactSize);
+  }
   if (!header) {
     newSlab(size);
     header = allocateFromFreeList(size, exactSize, exactSize);
@@ -229,6 +233,59 @@ HashStringAllocator::allocate(int32_t size, bool exactSize) {
   return header;
 }
 
+HashStringAllocator::Header* HashStringAllocator::allocateSmall(int32_t size) {
+  const int32_t cacheIndex = bits::roundUp(size, 8) / 8;
+  auto& blocks = cache_[cacheIndex];
+  if (blocks.empty()) {
+    refillCache(cacheIndex);
+  } else {
+    ++stats_.numCacheHits;
+  }
+  auto header = blocks.back();
+  blocks.pop_back();
+  cachedBytes_ -= header->size() + sizeof(Header);
+  cumulativeBytes_ += header->size();
+  return header;
+}
+
+void HashStringAllocator::refillCache(int32_t cacheIndex) {
+  ++stats_.numCacheRefills;
+  constexpr int32_t kHeaderSize = sizeof(Header);
+  const int32_t blockSize = cacheIndex * 8;
+  // The blocks are not allocated until taken from the cache.
+  const auto cumulativeBytes = cumulativeBytes_;
+  auto header = allocate(
+      kCacheRefillCount * (blockSize + kHeaderSize) - kHeaderSize, true);
+  auto& blocks = cache_[cacheIndex];
+  for (;;) {
+    const int32_t rest = header->size() - blockSize - kHeaderSize;
+    if (rest < blockSize) {
+      break;
+    }
+    header->setSize(blockSize);
+    auto next = new (header->end()) Header(rest);
+    blocks.push_back(header);
+    cachedBytes_ += header->size() + sizeof(Header);
+    header = next;
+  }
+  blocks.push_back(header);
+  cachedBytes_ += header->size() + sizeof(Header);
+  cumulativeBytes_ = cumulativeBytes;
+}
+
+void HashStringAllocator::releaseCache() {
+  ++stats_.numCacheReleases;
+  for (auto& blocks : cache_) {
+    for (auto header : blocks) {
+      // Cached blocks are already subtracted from 'cumulativeBytes_'.
+      cumulativeBytes_ += header->size();
+      freeToFreeList(header);
+    }
+    blocks.clear();
+  }
+  cachedBytes_ = 0;
+}
+
 HashStringAllocator::Header* FOLLY_NULLABLE
 HashStringAllocator::allocateFromFreeList(
     int32_t preferredSize,
@@ -243,7 +300,9 @@ HashStringAllocator::allocateFromFreeList(
   int32_t counter = 0;
   Header* largest = nullptr;
   Header* found = nullptr;
+  ++stats_.numFreeListSearches;
   for (auto* item = free_.next(); item != &free_; item = item->next()) {
+    ++stats_.numFreeListBlocksVisited;
     auto header = headerOf(item);
     VELOX_CHECK(header->isFree());
     auto size = header->size();
@@ -280,7 +339,26 @@ HashStringAllocator::allocateFromFreeList(
   return found;
 }
 
-void HashStringAllocator::free(Header* _header) {
+void HashStringAllocator::free(Header* header) {
+  // The smallest block size that can be cached. A cached block must be
+  // able to go to the free list.
+  constexpr int32_t kMinCachedSize = (kMinAlloc + 7) / 8 * 8;
+  const auto size = header->size();
+  if (header->isContinued() || size < kMinCachedSize ||
+      size > kMaxCachedSize) {
+    freeToFreeList(header);
+    return;
+  }
+  VELOX_CHECK(!header->isFree());
+  cumulativeBytes_ -= size;
+  cache_[size / 8].push_back(header);
+  cachedBytes_ += size + sizeof(Header);
+  if (cachedBytes_ > kMaxCachedBytes) {
+    releaseCache();
+  }
+}
+
+void HashStringAllocator::freeToFreeList(Header* _header) {
   Header* header = _header;
   do {
     Header* continued = nullptr;
@@ -444,6 +522,17 @@ void HashStringAllocator::checkConsistency() const {
   }
   VELOX_CHECK(numInFreeList == numFree_);
   VELOX_CHECK(bytesInFreeList == freeBytes_);
+
+  int64_t cachedBytes = 0;
+  for (auto i = 0; i < cache_.size(); ++i) {
+    for (auto header : cache_[i]) {
+      VELOX_CHECK(!header->isFree());
+      VELOX_CHECK(!header->isContinued());
+      VELOX_CHECK_GE(header->size(), i * 8);
+      cachedBytes += header->size() + sizeof(Header);
+    }
+  }
+  VELOX_CHECK_EQ(cachedBytes, cachedBytes_);
 }
 
 } // namespace facebook::velox
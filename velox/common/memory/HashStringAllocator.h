@@ -15,6 +15,9 @@
  */
 #pragma once
 
+#include <array>
+#include <vector>
+
 #include "velox/common/memory/AllocationPool.h"
 #include "velox/common/memory/ByteStream.h"
 #include "velox/common/memory/CompactDoubleList.h"
@@ -35,6 +38,13 @@ namespace facebook::velox {
 // below is free. In this case the uint32_t below the header has the size of the
 // previous free block. The last word of a MappedMemory::PageRun backing a
 // HashStringAllocator is set to kArenaEnd.
+//
+// Small blocks freed with free() are kept in a cache of LIFO lists by size
+// instead of being coalesced, so that allocate() of a small size is usually
+// a pop from a list instead of a free list search. An empty list is refilled
+// with kCacheRefillCount blocks cut from one free block. The cache is
+// released to the free list as a whole when it exceeds kMaxCachedBytes or
+// before growing 'this'.
 class HashStringAllocator : public StreamArena {
  public:
   // The minimum allocation must have space after the header for the
@@ -42,6 +52,50 @@ class HashStringAllocator : public StreamArena {
   static constexpr int32_t kMinAlloc =
       sizeof(CompactDoubleList) + sizeof(uint32_t);
 
+  // Largest block size kept in the cache of small blocks. Cached sizes are
+  // multiples of 8 bytes.
+  static constexpr int32_t kMaxCachedSize = 128;
+  static constexpr int32_t kNumCachedSizes = kMaxCachedSize / 8 + 1;
+
+  // Number of blocks added to an empty list of the cache at a time.
+  static constexpr int32_t kCacheRefillCount = 16;
+
+  // Cached bytes, including headers, above which the cache is released.
+  static constexpr int64_t kMaxCachedBytes = 64 << 10;
+
+  // Allocation statistics for tuning.
+  struct Stats {
+    // Number of size classes in 'bytesBySize'.
+    static constexpr int32_t kNumSizes = 20;
+
+    // Bytes allocated by allocate() by power of 2 size class. Element i
+    // is for sizes up to 16 << i bytes. The last also has all larger sizes.
+    std::array<int64_t, kNumSizes> bytesBySize{};
+
+    // Number of allocate() calls.
+    int64_t numAllocations{0};
+
+    // Number of allocate() calls served from the cache of small blocks.
+    int64_t numCacheHits{0};
+
+    // Number of refills and releases of the cache of small blocks.
+    int64_t numCacheRefills{0};
+    int64_t numCacheReleases{0};
+
+    // Number of free list searches and free blocks looked at by them.
+    int64_t numFreeListSearches{0};
+    int64_t numFreeListBlocksVisited{0};
+
+    // Returns the index in 'bytesBySize' for an allocation of 'size' bytes.
+    static int32_t sizeIndex(int32_t size) {
+      int32_t index = 0;
+      while (index < kNumSizes - 1 && (16 << index) < size) {
+        ++index;
+      }
+      return index;
+    }
+  };
+
   class Header {
    public:
     static constexpr uint32_t kFree = 1U << 31;
@@ -182,7 +236,13 @@ class HashStringAllocator : public StreamArena {
   Header* FOLLY_NONNULL allocate(int32_t size) {
     VELOX_CHECK(
         !currentHeader_, "Do not call allocate() when a write is in progress");
-    return allocate(std::max(size, kMinAlloc), true);
+    size = std::max(size, kMinAlloc);
+    ++stats_.numAllocations;
+    stats_.bytesBySize[Stats::sizeIndex(size)] += size;
+    if (size <= kMaxCachedSize) {
+      return allocateSmall(size);
+    }
+    return allocate(size, true);
   }
 
   // Returns the header immediately below 'data'.
@@ -254,21 +314,41 @@ class HashStringAllocator : public StreamArena {
   // 'this'. This is the sum of free block sizes minus size of pointer
   // for each. We subtract the pointer because in the worst case we
   // would have one allocation that chains many small free blocks
-  // together via kContinued.
+  // together via kContinued. Cached small blocks are not counted, see
+  // cachedBytes().
   uint64_t freeSpace() const {
     int64_t minFree = freeBytes_ - numFree_ * (sizeof(Header) + sizeof(void*));
     VELOX_CHECK_GE(minFree, 0, "Guaranteed free space cannot be negative");
     return minFree;
   }
 
+  // Returns the bytes in the cache of small blocks, including headers. These
+  // are neither in use nor in freeSpace(), since a cached block serves only
+  // allocations of up to its size until the cache is released to the free
+  // list.
+  uint64_t cachedBytes() const {
+    return cachedBytes_;
+  }
+
   // Frees all memory associated with 'this' and leaves 'this' ready for reuse.
   void clear() {
     numFree_ = 0;
     freeBytes_ = 0;
     new (&free_) CompactDoubleList();
+    for (auto& blocks : cache_) {
+      blocks.clear();
+    }
+    cachedBytes_ = 0;
     pool_.clear();
   }
 
+  // Adds the blocks in the cache of small blocks to the free list.
+  void releaseCache();
+
+  const Stats& stats() const {
+    return stats_;
+  }
+
   memory::MappedMemory* FOLLY_NONNULL mappedMemory() const {
     return pool_.mappedMemory();
   }
@@ -293,6 +373,18 @@ class HashStringAllocator : public StreamArena {
   // starting to process a batch of input.
   void newSlab(int32_t size);
 
+  // Returns a block of at least 'size' bytes from the cache of small
+  // blocks. Refills the cache if it has no block of the size.
+  Header* FOLLY_NONNULL allocateSmall(int32_t size);
+
+  // Cuts kCacheRefillCount blocks of 'cacheIndex' * 8 bytes from one
+  // free block and adds them to the cache.
+  void refillCache(int32_t cacheIndex);
+
+  // Adds 'header' and its continuations to the free list, coalescing
+  // them with adjacent free blocks.
+  void freeToFreeList(Header* FOLLY_NONNULL header);
+
   void removeFromFreeList(Header* FOLLY_NONNULL header) {
     VELOX_CHECK(header->isFree());
     header->clearFree();
@@ -335,6 +427,15 @@ class HashStringAllocator : public StreamArena {
   // the row by row space usage in a RowContainer.
   uint64_t cumulativeBytes_{0};
 
+  // Cache of small blocks. Element i has allocated blocks of at least i * 8
+  // bytes that are free for allocate().
+  std::array<std::vector<Header*>, kNumCachedSizes> cache_;
+
+  // Sum of the size of blocks in 'cache_', including headers.
+  int64_t cachedBytes_{0};
+
+  Stats stats_;
+
   // Pointer to Header for the range being written. nullptr if a write is not in
   // progress.
   Header* FOLLY_NULLABLE currentHeader_ = nullptr;
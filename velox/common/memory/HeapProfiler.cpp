@@ -0,0 +1,115 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "velox/common/memory/HeapProfiler.h"
+
+#include <algorithm>
+#include <sstream>
+
+#include <folly/hash/Hash.h>
+
+#include "velox/common/base/Exceptions.h"
+#include "velox/common/base/SuccinctPrinter.h"
+
+namespace facebook::velox::memory {
+
+HeapProfiler::HeapProfiler(int64_t sampleBytes) : sampleBytes_(sampleBytes) {
+  VELOX_CHECK_GT(sampleBytes_, 0);
+}
+
+void HeapProfiler::recordAllocation(
+    const void* p,
+    int64_t size,
+    const std::string& owner) {
+  if (!p || size <= 0) {
+    return;
+  }
+  auto before = allocatedBytes_.fetch_add(size, std::memory_order_relaxed);
+  auto numCrossed = (before + size) / sampleBytes_ - before / sampleBytes_;
+  if (numCrossed == 0) {
+    return;
+  }
+  // Skips the frames of this function and the MemoryPool allocate method.
+  process::StackTrace stack(2);
+  auto& pointers = stack.getStack();
+  auto stackId = folly::hash::hash_range(pointers.begin(), pointers.end());
+  std::lock_guard<std::mutex> l(mutex_);
+  stacks_.try_emplace(stackId, std::move(stack));
+  auto ownerIt = owners_.try_emplace(owner, 0).first;
+  auto [it, inserted] = samples_.insert_or_assign(
+      p, Sample{numCrossed * sampleBytes_, &ownerIt->first, stackId});
+  if (inserted) {
+    ++numSamples_;
+  }
+}
+
+void HeapProfiler::recordFree(const void* p) {
+  if (numSamples_.load(std::memory_order_relaxed) == 0) {
+    return;
+  }
+  std::lock_guard<std::mutex> l(mutex_);
+  if (samples_.erase(p)) {
+    --numSamples_;
+  }
+}
+
+std::vector<HeapProfiler::Entry> HeapProfiler::entries() const {
+  folly::F14FastMap<std::pair<const std::string*, uint64_t>, Entry> byKey;
+  {
+    std::lock_guard<std::mutex> l(mutex_);
+    for (auto& [p, sample] : samples_) {
+      auto [it, inserted] = byKey.try_emplace(
+          std::make_pair(sample.owner, sample.stackId),
+          Entry{*sample.owner, sample.stackId, 0, 0});
+      it->second.bytes += sample.bytes;
+      ++it->second.numSamples;
+    }
+  }
+  std::vector<Entry> result;
+  result.reserve(byKey.size());
+  for (auto& [key, entry] : byKey) {
+    result.push_back(std::move(entry));
+  }
+  std::sort(result.begin(), result.end(), [](auto& left, auto& right) {
+    return left.bytes > right.bytes;
+  });
+  return result;
+}
+
+std::string HeapProfiler::toString(int32_t maxEntries) const {
+  auto allEntries = entries();
+  int64_t totalBytes = 0;
+  for (auto& entry : allEntries) {
+    totalBytes += entry.bytes;
+  }
+  std::stringstream out;
+  out << "Heap profile: " << succinctBytes(totalBytes)
+      << " live in sampled allocations, 1 sample per "
+      << succinctBytes(sampleBytes_) << std::endl;
+  for (auto i = 0; i < allEntries.size() && i < maxEntries; ++i) {
+    auto& entry = allEntries[i];
+    out << succinctBytes(entry.bytes) << " in " << entry.numSamples
+        << " samples by " << entry.owner << std::endl;
+    std::lock_guard<std::mutex> l(mutex_);
+    auto it = stacks_.find(entry.stackId);
+    if (it != stacks_.end()) {
+      out << it->second.toString();
+    }
+  }
+  return out.str();
+}
+
+} // namespace facebook::velox::memory
@@ -0,0 +1,86 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <atomic>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include <folly/container/F14Map.h>
+
+#include "velox/common/process/StackTrace.h"
+
+namespace facebook::velox::memory {
+
+// Sampling profiler of the live allocations of the MemoryPools it is set
+// on. Samples about one allocation per 'sampleBytes' bytes allocated and
+// keeps each live sample with its owner, i.e. the name of the allocating
+// pool, and its allocation stack. A sample stands for 'sampleBytes' bytes
+// for each multiple of 'sampleBytes' its allocation crosses, so that the
+// profile estimates the live bytes by owner and stack. Thread-safe.
+class HeapProfiler {
+ public:
+  // Estimated live bytes allocated by 'owner' from the stack 'stackId'.
+  struct Entry {
+    std::string owner;
+    uint64_t stackId;
+    int64_t bytes;
+    int32_t numSamples;
+  };
+
+  explicit HeapProfiler(int64_t sampleBytes);
+
+  // Records that 'owner' allocated 'size' bytes at 'p'.
+  void recordAllocation(const void* p, int64_t size, const std::string& owner);
+
+  // Records that 'p' is freed. Must be called before the memory is reused.
+  void recordFree(const void* p);
+
+  // Returns the live samples aggregated by owner and stack, largest first.
+  std::vector<Entry> entries() const;
+
+  // Returns the 'maxEntries' largest entries with their symbolized stacks.
+  std::string toString(int32_t maxEntries = 10) const;
+
+  int64_t sampleBytes() const {
+    return sampleBytes_;
+  }
+
+ private:
+  struct Sample {
+    int64_t bytes;
+    const std::string* owner;
+    uint64_t stackId;
+  };
+
+  const int64_t sampleBytes_;
+
+  // Total bytes recorded by recordAllocation().
+  std::atomic<int64_t> allocatedBytes_{0};
+
+  // Number of live samples. Lets recordFree() skip the lock when 0.
+  std::atomic<int64_t> numSamples_{0};
+
+  mutable std::mutex mutex_;
+  folly::F14FastMap<const void*, Sample> samples_;
+  folly::F14NodeMap<uint64_t, process::StackTrace> stacks_;
+  // Owner names, interned so that samples refer to them by pointer.
+  folly::F14NodeMap<std::string, int32_t> owners_;
+};
+
+} // namespace facebook::velox::memory
@@ -127,6 +127,9 @@ MemoryPool& MemoryPoolBase::addChild(const std::string& name, int64_t cap) {
   if (auto usageTracker = getMemoryUsageTracker()) {
     child->setMemoryUsageTracker(usageTracker->addChild());
   }
+  if (auto& profiler = getHeapProfiler()) {
+    child->setHeapProfiler(profiler);
+  }
   children_.emplace_back(std::move(child));
   return *children_.back();
 }
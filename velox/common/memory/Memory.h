@@ -33,6 +33,7 @@
 #include "folly/SharedMutex.h"
 #include "folly/experimental/FunctionScheduler.h"
 #include "velox/common/base/GTestMacros.h"
+#include "velox/common/memory/HeapProfiler.h"
 #include "velox/common/memory/MemoryUsage.h"
 #include "velox/common/memory/MemoryUsageTracker.h"
 
@@ -91,6 +92,11 @@ class MemoryPool : public AbstractMemoryPool {
       const std::shared_ptr<MemoryUsageTracker>& tracker) = 0;
   virtual const std::shared_ptr<MemoryUsageTracker>& getMemoryUsageTracker()
       const = 0;
+  // Sets the profiler that samples the allocations of this pool. Children
+  // added afterwards get the same profiler.
+  virtual void setHeapProfiler(
+      const std::shared_ptr<HeapProfiler>& profiler) = 0;
+  virtual const std::shared_ptr<HeapProfiler>& getHeapProfiler() const = 0;
   // Used for external aggregation.
   virtual void setSubtreeMemoryUsage(int64_t size) = 0;
   virtual int64_t updateSubtreeMemoryUsage(int64_t size) = 0;
@@ -182,6 +188,12 @@ class ScopedMemoryPool final : public MemoryPool {
       const override {
     return pool_.getMemoryUsageTracker();
   }
+  void setHeapProfiler(const std::shared_ptr<HeapProfiler>& profiler) override {
+    pool_.setHeapProfiler(profiler);
+  }
+  const std::shared_ptr<HeapProfiler>& getHeapProfiler() const override {
+    return pool_.getHeapProfiler();
+  }
 
   void* FOLLY_NULLABLE allocate(int64_t size) override {
     return pool_.allocate(size);
@@ -426,6 +438,8 @@ class MemoryPoolImpl : public MemoryPoolBase {
       const std::shared_ptr<MemoryUsageTracker>& tracker) override;
   const std::shared_ptr<MemoryUsageTracker>& getMemoryUsageTracker()
       const override;
+  void setHeapProfiler(const std::shared_ptr<HeapProfiler>& profiler) override;
+  const std::shared_ptr<HeapProfiler>& getHeapProfiler() const override;
   void setSubtreeMemoryUsage(int64_t size) override;
   int64_t updateSubtreeMemoryUsage(int64_t size) override;
   // Get the cap for the memory node and its subtree.
@@ -510,6 +524,7 @@ class MemoryPoolImpl : public MemoryPoolBase {
   // Memory allocated attributed to the memory node.
   MemoryUsage localMemoryUsage_;
   std::shared_ptr<MemoryUsageTracker> memoryUsageTracker_;
+  std::shared_ptr<HeapProfiler> heapProfiler_;
   mutable folly::SharedMutex subtreeUsageMutex_;
   MemoryUsage subtreeMemoryUsage_;
   int64_t cap_;
@@ -632,7 +647,11 @@ MemoryPoolImpl<Allocator, ALIGNMENT>::allocate(int64_t size) {
   }
   auto alignedSize = sizeAlign<ALIGNMENT>(ALIGNER<ALIGNMENT>{}, size);
   reserve(alignedSize);
-  return allocAligned<ALIGNMENT>(ALIGNER<ALIGNMENT>{}, alignedSize);
+  auto* p = allocAligned<ALIGNMENT>(ALIGNER<ALIGNMENT>{}, alignedSize);
+  if (UNLIKELY(heapProfiler_ != nullptr)) {
+    heapProfiler_->recordAllocation(p, alignedSize, name_);
+  }
+  return p;
 }
 
 template <typename Allocator, uint16_t ALIGNMENT>
@@ -645,7 +664,11 @@ void* FOLLY_NULLABLE MemoryPoolImpl<Allocator, ALIGNMENT>::allocateZeroFilled(
     VELOX_MEM_MANUAL_CAP();
   }
   reserve(alignedSize * sizeEach);
-  return allocator_.allocZeroFilled(alignedSize, sizeEach);
+  auto* p = allocator_.allocZeroFilled(alignedSize, sizeEach);
+  if (UNLIKELY(heapProfiler_ != nullptr)) {
+    heapProfiler_->recordAllocation(p, alignedSize * sizeEach, name_);
+  }
+  return p;
 }
 
 template <typename Allocator, uint16_t ALIGNMENT>
@@ -663,12 +686,18 @@ void* FOLLY_NULLABLE MemoryPoolImpl<Allocator, ALIGNMENT>::reallocate(
   }
 
   reserve(difference);
+  if (UNLIKELY(heapProfiler_ != nullptr)) {
+    heapProfiler_->recordFree(p);
+  }
   void* newP = reallocAligned<ALIGNMENT>(
       ALIGNER<ALIGNMENT>{}, p, alignedSize, alignedNewSize);
   if (UNLIKELY(!newP)) {
     free(p, alignedSize);
     VELOX_MEM_CAP_EXCEEDED(cap_);
   }
+  if (UNLIKELY(heapProfiler_ != nullptr)) {
+    heapProfiler_->recordAllocation(newP, alignedNewSize, name_);
+  }
 
   return newP;
 }
@@ -678,6 +707,9 @@ void MemoryPoolImpl<Allocator, ALIGNMENT>::free(
     void* FOLLY_NULLABLE p,
     int64_t size) {
   auto alignedSize = sizeAlign<ALIGNMENT>(ALIGNER<ALIGNMENT>{}, size);
+  if (UNLIKELY(heapProfiler_ != nullptr)) {
+    heapProfiler_->recordFree(p);
+  }
   allocator_.free(p, alignedSize);
   release(alignedSize);
 }
@@ -704,6 +736,18 @@ MemoryPoolImpl<Allocator, ALIGNMENT>::getMemoryUsageTracker() const {
   return memoryUsageTracker_;
 }
 
+template <typename Allocator, uint16_t ALIGNMENT>
+void MemoryPoolImpl<Allocator, ALIGNMENT>::setHeapProfiler(
+    const std::shared_ptr<HeapProfiler>& profiler) {
+  heapProfiler_ = profiler;
+}
+
+template <typename Allocator, uint16_t ALIGNMENT>
+const std::shared_ptr<HeapProfiler>&
+MemoryPoolImpl<Allocator, ALIGNMENT>::getHeapProfiler() const {
+  return heapProfiler_;
+}
+
 template <typename Allocator, uint16_t ALIGNMENT>
 void MemoryPoolImpl<Allocator, ALIGNMENT>::setSubtreeMemoryUsage(int64_t size) {
   updateSubtreeMemoryUsage([size](MemoryUsage& subtreeUsage) {
@@ -16,6 +16,8 @@
 
 #include "velox/common/memory/MemoryUsageTracker.h"
 
+#include <algorithm>
+
 namespace facebook::velox::memory {
 std::shared_ptr<MemoryUsageTracker> MemoryUsageTracker::create(
     const std::shared_ptr<MemoryUsageTracker>& parent,
@@ -29,7 +31,63 @@ std::shared_ptr<MemoryUsageTracker> MemoryUsageTracker::create(
         : MemoryUsageTracker(parent, type, config) {}
   };
 
-  return std::make_shared<SharedMemoryUsageTracker>(parent, type, config);
+  auto tracker =
+      std::make_shared<SharedMemoryUsageTracker>(parent, type, config);
+  if (parent) {
+    parent->registerChild(tracker);
+  }
+  return tracker;
+}
+
+MemoryUsageTracker::~MemoryUsageTracker() {
+  // The children hold a reference to 'this', so all are destroyed and
+  // their counts are in 'numAllocs_'.
+  if (parent_) {
+    parent_->numAllocs_ += numAllocs_;
+  }
+}
+
+void MemoryUsageTracker::registerChild(
+    const std::shared_ptr<MemoryUsageTracker>& child) {
+  std::lock_guard<std::mutex> l(childrenMutex_);
+  children_.erase(
+      std::remove_if(
+          children_.begin(),
+          children_.end(),
+          [](const auto& weakChild) { return weakChild.expired(); }),
+      children_.end());
+  children_.push_back(child);
+}
+
+int64_t MemoryUsageTracker::getNumAllocs() const {
+  int64_t count = numAllocs_;
+  std::lock_guard<std::mutex> l(childrenMutex_);
+  for (auto& weakChild : children_) {
+    if (auto child = weakChild.lock()) {
+      count += child->getNumAllocs();
+    }
+  }
+  return count;
+}
+
+void MemoryUsageTracker::reserveFromParents(int64_t size, int64_t increment) {
+  std::exception_ptr exception;
+  try {
+    checkAndPropagateReservationIncrement(increment, false);
+    return;
+  } catch (const std::exception& e) {
+    exception = std::current_exception();
+  }
+  int64_t exactIncrement;
+  {
+    std::lock_guard<std::mutex> l(mutex_);
+    exactIncrement = size - (reservation_ - usedReservation_);
+    if (exactIncrement <= 0 || exactIncrement >= increment) {
+      std::rethrow_exception(exception);
+    }
+    reservation_ += exactIncrement;
+  }
+  checkAndPropagateReservationIncrement(exactIncrement, false);
 }
 
 void MemoryUsageTracker::checkAndPropagateReservationIncrement(
@@ -65,8 +123,6 @@ void MemoryUsageTracker::incrementUsage(UsageType type, int64_t size) {
                       .fetch_add(size, std::memory_order_relaxed) +
       size;
 
-  ++usage(numAllocs_, type);
-  ++usage(numAllocs_, UsageType::kTotalMem);
   usage(cumulativeBytes_, type) += size;
 
   // We track the peak usage of total memory independent of user and
@@ -108,7 +164,10 @@ bool MemoryUsageTracker::maybeReserve(int64_t increment) {
       candidate = candidate->parent_.get();
       continue;
     }
-    if (limit - candidate->getCurrentTotalBytes() > addedReservation) {
+    // A tracker with a GrowCallback may raise its limit, so try the
+    // reservation and let the callback decide.
+    if (limit - candidate->getCurrentTotalBytes() > addedReservation ||
+        candidate->growCallback_) {
       try {
         reserve(addedReservation);
       } catch (const std::exception& e) {
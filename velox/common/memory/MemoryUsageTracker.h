@@ -20,6 +20,7 @@
 #include <atomic>
 #include <memory>
 #include <optional>
+#include <vector>
 
 #include "velox/common/base/BitUtil.h"
 #include "velox/common/base/Exceptions.h"
@@ -88,10 +89,18 @@ struct MemoryUsageConfigBuilder {
 // enough memory is freed.  Explicitly made reservations must be freed
 // with release(). Parents are updated only at reservation time to
 // avoid cache coherence traffic that arises when every thread
-// constantly updates the same top level allocation counter.
+// constantly updates the same top level allocation counter. For the
+// same reason the count of allocations is kept in the tracker that
+// makes them and is summed over the children when read. If a
+// reservation rounded up to the quantum exceeds a limit, the exact
+// size is tried before failing, so that the last bytes below a limit
+// can be allocated.
 class MemoryUsageTracker
     : public std::enable_shared_from_this<MemoryUsageTracker> {
  public:
+  // Adds the allocation count of 'this' to the parent.
+  ~MemoryUsageTracker();
+
   enum class UsageType : int { kUserMem = 0, kSystemMem = 1, kTotalMem = 2 };
 
   // Function to increase a MemoryUsageTracker's limits. This is called when an
@@ -158,10 +167,10 @@ class MemoryUsageTracker
     int64_t remaining;
     {
       std::lock_guard<std::mutex> l(mutex_);
-      remaining = reservation_ - usedReservation_;
-      reservation_ = 0;
+      const int64_t newReservation = quantizedSize(usedReservation_);
+      remaining = reservation_ - newReservation;
+      reservation_ = newReservation;
       minReservation_ = 0;
-      usedReservation_ = 0;
     }
     if (remaining) {
       decrementUsage(type_, remaining);
@@ -174,6 +183,7 @@ class MemoryUsageTracker
   // change upward.
   void update(int64_t size) {
     if (size > 0) {
+      ++numAllocs_;
       int64_t increment = 0;
       {
         std::lock_guard<std::mutex> l(mutex_);
@@ -181,7 +191,9 @@ class MemoryUsageTracker
           increment = reserveLocked(size);
         }
       }
-      checkAndPropagateReservationIncrement(increment, false);
+      if (increment) {
+        reserveFromParents(size, increment);
+      }
       usedReservation_.fetch_add(size);
       return;
     }
@@ -227,9 +239,9 @@ class MemoryUsageTracker
     return std::max<int64_t>(0, reservation_ - usedReservation_);
   }
 
-  int64_t getNumAllocs() const {
-    return total(numAllocs_);
-  }
+  // Returns the number of allocations made with update() in 'this' and its
+  // children.
+  int64_t getNumAllocs() const;
 
   int64_t getCumulativeBytes() const {
     return total(cumulativeBytes_);
@@ -276,7 +288,8 @@ class MemoryUsageTracker
   /// Checks if it is likely that the reservation on 'this' can be
   /// incremented by 'increment'. Returns false if this seems
   /// unlikely. Otherwise attempts the reservation increment and returns
-  /// true if succeeded.
+  /// true if succeeded. The increment is always attempted if a tracker with
+  /// a GrowCallback is reached before a tracker without enough headroom.
   bool maybeReserve(int64_t increment);
 
  private:
@@ -357,6 +370,15 @@ class MemoryUsageTracker
         : std::max<int64_t>(0, total);
   }
 
+  // Increments usage of 'this' and parents by 'increment', which
+  // reserves at least 'size' bytes. If this exceeds a limit, tries
+  // again with the exact increment needed for 'size'. Throws if that
+  // fails too. Must be called without holding 'mutex_'.
+  void reserveFromParents(int64_t size, int64_t increment);
+
+  // Adds 'child' to 'children_'.
+  void registerChild(const std::shared_ptr<MemoryUsageTracker>& child);
+
   // Increments usage of 'this' and parents. Must be called without
   // holding 'mutex_'. Reverts the increment of reservation on before
   // rethrowing the error. If 'updateMinReservation' is true, also
@@ -376,9 +398,15 @@ class MemoryUsageTracker
   std::array<std::atomic<int64_t>, 3> currentUsageInBytes_{};
   std::array<std::atomic<int64_t>, 3> peakUsageInBytes_{};
   std::array<int64_t, 3> maxMemory_;
-  std::array<std::atomic<int64_t>, 3> numAllocs_{};
   std::array<std::atomic<int64_t>, 3> cumulativeBytes_{};
 
+  // Number of allocations in 'this' and in destroyed children.
+  std::atomic<int64_t> numAllocs_{0};
+
+  // Serializes 'children_'.
+  mutable std::mutex childrenMutex_;
+  std::vector<std::weak_ptr<MemoryUsageTracker>> children_;
+
   int64_t reservation_{0};
 
   // Minimum amount of reserved memory to hold until explicit release().
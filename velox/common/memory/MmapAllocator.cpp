@@ -28,11 +28,31 @@ MmapAllocator::MmapAllocator(const MmapAllocatorOptions& options)
 
       capacity_(bits::roundUp(
           options.capacity / kPageSize,
-          64 * sizeClassSizes_.back())) {
-  for (int size : sizeClassSizes_) {
-    sizeClasses_.push_back(std::make_unique<SizeClass>(capacity_ / size, size));
+          64 * sizeClassSizes_.back())),
+      useHugePages_(options.useHugePages),
+      numaNodes_(options.numaNodes) {
+  VELOX_CHECK_GT(numaNodes_, 0);
+  for (auto node = 0; node < numaNodes_; ++node) {
+    for (int size : sizeClassSizes_) {
+      sizeClasses_.push_back(std::make_unique<SizeClass>(
+          capacity_ / size,
+          size,
+          useHugePages_ && size >= options.hugePageMinUnitSize));
+    }
+  }
+}
+
+namespace {
+// Advises the kernel to back the range at 'data' with transparent huge
+// pages. This is a hint. Failures are logged and otherwise ignored.
+void adviseHugePages(void* data, size_t size) {
+#ifdef MADV_HUGEPAGE
+  if (madvise(data, size, MADV_HUGEPAGE) < 0) {
+    LOG(WARNING) << "madvise MADV_HUGEPAGE got errno " << errno;
   }
+#endif
 }
+} // namespace
 
 bool MmapAllocator::allocate(
     MachinePageCount numPages,
@@ -69,8 +89,8 @@ bool MmapAllocator::allocate(
         sizeClassSizes_[mix.sizeIndices[i]] * kPageSize,
         mix.sizeCounts[i],
         [&]() {
-          success = sizeClasses_[mix.sizeIndices[i]]->allocate(
-              mix.sizeCounts[i], owner, newMapsNeeded, out);
+          success = localSizeClass(mix.sizeIndices[i])
+                        .allocate(mix.sizeCounts[i], owner, newMapsNeeded, out);
         });
     if (!success) {
       // This does not normally happen since any size class can accommodate
@@ -141,7 +161,7 @@ MachinePageCount MmapAllocator::freeInternal(Allocation& allocation) {
       // Increment the free time only if the allocation contained
       // pages in the class. Note that size class indices in the
       // allocator are not necessarily the same as in the stats.
-      auto sizeIndex = Stats::sizeIndex(sizeClassSizes_[i] * kPageSize);
+      auto sizeIndex = Stats::sizeIndex(sizeClass->unitSize() * kPageSize);
       stats_.sizes[sizeIndex].freeClocks += clocks;
     }
     numFreed += pages;
@@ -264,6 +284,10 @@ bool MmapAllocator::allocateContiguousImpl(
     return false;
   }
 
+  if (isHugePageContiguous(numPages)) {
+    adviseHugePages(data, numPages * kPageSize);
+    numHugePageExternalMapped_ += numPages;
+  }
   allocation.reset(this, data, numPages * kPageSize);
   return true;
 }
@@ -276,6 +300,9 @@ void MmapAllocator::freeContiguousImpl(ContiguousAllocation& allocation) {
     }
     numMapped_ -= allocation.numPages();
     numExternalMapped_ -= allocation.numPages();
+    if (isHugePageContiguous(allocation.numPages())) {
+      numHugePageExternalMapped_ -= allocation.numPages();
+    }
     numAllocated_ -= allocation.numPages();
     allocation.reset(nullptr, nullptr, 0);
   }
@@ -298,17 +325,25 @@ MachinePageCount MmapAllocator::adviseAway(MachinePageCount target) {
   return numAway;
 }
 
-MmapAllocator::SizeClass::SizeClass(size_t capacity, MachinePageCount unitSize)
+MmapAllocator::SizeClass::SizeClass(
+    size_t capacity,
+    MachinePageCount unitSize,
+    bool hugePages)
     : capacity_(capacity),
       unitSize_(unitSize),
+      hugePages_(hugePages),
       byteSize_(capacity_ * unitSize_ * kPageSize),
       pageAllocated_(capacity_ / 64),
       pageMapped_(capacity_ / 64) {
   VELOX_CHECK(
       capacity_ % 64 == 0, "Sizeclass must have a multiple of 64 capacity.");
+  // A huge page backed range is aligned at a huge page boundary, so that
+  // all of it can be backed by huge pages. The slack at either end is
+  // unmapped.
+  const size_t alignment = hugePages_ ? kHugePageSize : 0;
   void* ptr = mmap(
       nullptr,
-      capacity_ * unitSize_ * kPageSize,
+      byteSize_ + alignment,
       PROT_READ | PROT_WRITE,
       MAP_PRIVATE | MAP_ANONYMOUS,
       -1,
@@ -321,6 +356,19 @@ MmapAllocator::SizeClass::SizeClass(size_t capacity, MachinePageCount unitSize)
         errno);
   }
   address_ = reinterpret_cast<uint8_t*>(ptr);
+  if (hugePages_) {
+    auto aligned = reinterpret_cast<uint8_t*>(
+        bits::roundUp(reinterpret_cast<uint64_t>(ptr), kHugePageSize));
+    if (aligned > address_) {
+      munmap(address_, aligned - address_);
+    }
+    const auto tail = address_ + alignment - aligned;
+    if (tail > 0) {
+      munmap(aligned + byteSize_, tail);
+    }
+    address_ = aligned;
+    adviseHugePages(address_, byteSize_);
+  }
 }
 
 MmapAllocator::SizeClass::~SizeClass() {
@@ -348,6 +396,23 @@ ClassPageCount MmapAllocator::SizeClass::checkConsistency(
   return count;
 }
 
+MachinePageCount MmapAllocator::SizeClass::numMappedPages() {
+  std::lock_guard<std::mutex> l(mutex_);
+  MachinePageCount count = 0;
+  for (auto word : pageMapped_) {
+    count += __builtin_popcountll(word);
+  }
+  return count * unitSize_;
+}
+
+MachinePageCount MmapAllocator::SizeClass::numAllocatedPages() const {
+  MachinePageCount count = 0;
+  for (auto word : pageAllocated_) {
+    count += __builtin_popcountll(word);
+  }
+  return count * unitSize_;
+}
+
 std::string MmapAllocator::SizeClass::toString() const {
   std::stringstream out;
   int count = 0;
@@ -362,6 +427,9 @@ std::string MmapAllocator::SizeClass::toString() const {
   auto mb = (count * MappedMemory::kPageSize * unitSize_) >> 20;
   out << "[size " << unitSize_ << ": " << count << "(" << mb << "MB) allocated "
       << mappedCount << " mapped";
+  if (hugePages_) {
+    out << " huge pages";
+  }
   if (mappedFreeCount != numMappedFreePages_) {
     out << "Mismatched count of mapped free pages "
         << ". Actual= " << mappedFreeCount
@@ -618,16 +686,43 @@ bool MmapAllocator::checkConsistency() const {
   return ok;
 }
 
+MachinePageCount MmapAllocator::numHugePageMapped() const {
+  MachinePageCount count = numHugePageExternalMapped_;
+  for (auto& sizeClass : sizeClasses_) {
+    if (sizeClass->hugePages()) {
+      count += sizeClass->numMappedPages();
+    }
+  }
+  return count;
+}
+
 std::string MmapAllocator::toString() const {
   std::stringstream out;
   out << "[Memory capacity " << capacity_ << " free "
       << static_cast<int64_t>(capacity_ - numAllocated_) << " mapped "
-      << numMapped_ << std::endl;
-  for (auto& sizeClass : sizeClasses_) {
-    out << sizeClass->toString() << std::endl;
+      << numMapped_;
+  if (useHugePages_) {
+    out << " huge page mapped " << numHugePageMapped();
+  }
+  out << std::endl;
+  for (auto i = 0; i < sizeClasses_.size(); ++i) {
+    if (numaNodes_ > 1 && i % sizeClassSizes_.size() == 0) {
+      out << "NUMA node " << i / sizeClassSizes_.size() << ":" << std::endl;
+    }
+    out << sizeClasses_[i]->toString() << std::endl;
   }
   out << "]" << std::endl;
   return out.str();
 }
 
+MachinePageCount MmapAllocator::numAllocatedOnNode(int32_t node) const {
+  VELOX_CHECK_LT(node, numaNodes_);
+  MachinePageCount count = 0;
+  for (auto i = 0; i < sizeClassSizes_.size(); ++i) {
+    count +=
+        sizeClasses_[node * sizeClassSizes_.size() + i]->numAllocatedPages();
+  }
+  return count;
+}
+
 } // namespace facebook::velox::memory
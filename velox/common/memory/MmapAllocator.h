@@ -25,6 +25,7 @@
 
 #include "velox/common/base/BitUtil.h"
 #include "velox/common/memory/MappedMemory.h"
+#include "velox/common/memory/Numa.h"
 
 namespace facebook::velox::memory {
 
@@ -35,6 +36,24 @@ using ClassPageCount = int32_t;
 struct MmapAllocatorOptions {
   //  Capacity in bytes, default 512MB
   uint64_t capacity = 1L << 29;
+
+  // If true, the address ranges of size classes of at least
+  // 'hugePageMinUnitSize' machine pages and contiguous allocations of at
+  // least a huge page are advised to be backed by transparent huge
+  // pages. This reduces TLB misses for large hash tables and row
+  // containers. Allocation and advising away stay at machine page
+  // granularity.
+  bool useHugePages = false;
+
+  // Smallest size class that is backed by huge pages if 'useHugePages'.
+  MachinePageCount hugePageMinUnitSize = 64;
+
+  // Number of NUMA nodes with their own size classes. Pages are first
+  // backed by memory when the allocating thread touches them, which places
+  // them on the node of that thread. Allocating from the size classes of
+  // the node of the calling thread (see currentNumaNode()) keeps reused
+  // pages on that node. numaNodeCount() gives the count for the host.
+  int32_t numaNodes = 1;
 };
 // Implementation of MappedMemory with mmap and madvise. Each size
 // class is mmapped for the whole capacity. Each size class has a
@@ -48,10 +67,16 @@ struct MmapAllocatorOptions {
 // we advise away enough pages from other size classes to cover for
 // it and then make a new mmap of the requested size
 // (ContiguousAllocation).
+//
+// On a host with many NUMA nodes, each node may have its own set of size
+// classes. Capacity and mapped pages are shared by all nodes.
 class MmapAllocator : public MappedMemory {
  public:
   enum class Failure { kNone, kMadvise, kMmap };
 
+  // Size of a transparent huge page on x86_64 and aarch64 with 4K pages.
+  static constexpr uint64_t kHugePageSize = 2 << 20;
+
   explicit MmapAllocator(const MmapAllocatorOptions& options);
 
   bool allocate(
@@ -102,6 +127,21 @@ class MmapAllocator : public MappedMemory {
     return numMapped_;
   }
 
+  int32_t numaNodes() const {
+    return numaNodes_;
+  }
+
+  // Returns the number of machine pages allocated from the size classes of
+  // NUMA node 'node'. May be off if there are concurrent allocations and
+  // frees.
+  MachinePageCount numAllocatedOnNode(int32_t node) const;
+
+  // Returns the number of mapped machine pages in address ranges advised to
+  // be backed by huge pages. The kernel may back some of these with machine
+  // pages, e.g. if it has no free huge page or after part of a huge page is
+  // advised away.
+  MachinePageCount numHugePageMapped() const;
+
   // Causes 'failure' to occur in next call. This is a test-only
   // function for validating otherwise unreachable error paths.
   void injectFailure(Failure failure) {
@@ -123,7 +163,7 @@ class MmapAllocator : public MappedMemory {
   // 'unitSize_' machine pages.
   class SizeClass {
    public:
-    SizeClass(size_t capacity, MachinePageCount unitSize);
+    SizeClass(size_t capacity, MachinePageCount unitSize, bool hugePages);
 
     ~SizeClass();
 
@@ -131,6 +171,14 @@ class MmapAllocator : public MappedMemory {
       return unitSize_;
     }
 
+    // True if the address range is advised to be backed by huge pages.
+    bool hugePages() const {
+      return hugePages_;
+    }
+
+    // Returns the number of machine pages backed by memory.
+    MachinePageCount numMappedPages();
+
     // Allocates 'numPages' from 'this' and appends these to
     // *out. '*numUnmapped' is incremented by the number of pages that
     // are not backed by memory.
@@ -147,6 +195,9 @@ class MmapAllocator : public MappedMemory {
     // Checks that allocation and map counts match the corresponding bitmaps.
     ClassPageCount checkConsistency(ClassPageCount& numMapped) const;
 
+    // Returns the number of allocated machine pages.
+    MachinePageCount numAllocatedPages() const;
+
     // Advises away backing for 'numPages' worth of unallocated mapped class
     // pages. This needs to make an Allocation, for which it needs the
     // containing MmapAllocator.
@@ -213,6 +264,8 @@ class MmapAllocator : public MappedMemory {
     // Size of one size class page in machine pages.
     const MachinePageCount unitSize_;
 
+    const bool hugePages_;
+
     // Start of address range.
     uint8_t* FOLLY_NONNULL address_;
 
@@ -251,6 +304,12 @@ class MmapAllocator : public MappedMemory {
 
   void freeContiguousImpl(ContiguousAllocation& allocation);
 
+  // True if a contiguous allocation of 'numPages' is advised to be backed by
+  // huge pages.
+  bool isHugePageContiguous(MachinePageCount numPages) const {
+    return useHugePages_ && numPages * kPageSize >= kHugePageSize;
+  }
+
   // Ensures that there are at least 'newMappedNeeded' pages that are
   // not backing any existing allocation. If capacity_ - numMapped_ <
   // newMappedNeeded, advises away enough pages backing freed slots in
@@ -266,6 +325,13 @@ class MmapAllocator : public MappedMemory {
 
   void markAllMapped(const Allocation& allocation);
 
+  // Returns the size class for size 'sizeIndex' of the NUMA node of the
+  // calling thread.
+  SizeClass& localSizeClass(int32_t sizeIndex) {
+    const auto node = numaNodes_ == 1 ? 0 : currentNumaNode() % numaNodes_;
+    return *sizeClasses_[node * sizeClassSizes_.size() + sizeIndex];
+  }
+
   // Finds at least  'target' unallocated pages in different size classes and
   // advises them away. Returns the number of pages advised away.
   MachinePageCount adviseAway(MachinePageCount target);
@@ -289,8 +355,16 @@ class MmapAllocator : public MappedMemory {
   // 'numAllocated_' and 'numMapped_'. This counter is informational
   // only.
   std::atomic<MachinePageCount> numExternalMapped_{0};
+
+  // Number of pages of contiguous allocations advised to be backed by huge
+  // pages. Informational only.
+  std::atomic<MachinePageCount> numHugePageExternalMapped_{0};
   MachinePageCount capacity_ = 0;
+  const bool useHugePages_;
+
+  const int32_t numaNodes_;
 
+  // The size classes of each NUMA node, for node 0 first.
   std::vector<std::unique_ptr<SizeClass>> sizeClasses_;
 
   // Statistics. Not atomic.
@@ -0,0 +1,120 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "velox/common/memory/Numa.h"
+
+#ifdef __linux__
+#include <sched.h>
+#endif
+
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <vector>
+
+#include <folly/Conv.h>
+#include <folly/String.h>
+
+namespace facebook::velox::memory {
+
+namespace {
+// Node of each CPU, read from sysfs on first use.
+struct NumaTopology {
+  NumaTopology() {
+#ifdef __linux__
+    const std::filesystem::path root("/sys/devices/system/node");
+    std::error_code error;
+    for (int32_t node = 0;; ++node) {
+      auto nodePath = root / ("node" + std::to_string(node));
+      if (!std::filesystem::exists(nodePath, error)) {
+        break;
+      }
+      numNodes = node + 1;
+      std::ifstream in(nodePath / "cpulist");
+      std::string cpuList;
+      std::getline(in, cpuList);
+      addCpus(cpuList, node);
+    }
+#endif
+    if (numNodes == 0) {
+      numNodes = 1;
+    }
+  }
+
+  // Adds the CPUs in 'cpuList', e.g. "0-7,16-23", to 'node'.
+  void addCpus(const std::string& cpuList, int32_t node) {
+    std::vector<folly::StringPiece> ranges;
+    folly::split(',', cpuList, ranges, true);
+    for (auto range : ranges) {
+      std::vector<folly::StringPiece> bounds;
+      folly::split('-', folly::trimWhitespace(range), bounds);
+      auto first = folly::tryTo<int32_t>(bounds[0]);
+      auto last = folly::tryTo<int32_t>(bounds.back());
+      if (!first.hasValue() || !last.hasValue()) {
+        continue;
+      }
+      if (cpuNodes.size() <= static_cast<size_t>(last.value())) {
+        cpuNodes.resize(last.value() + 1, 0);
+      }
+      for (auto cpu = first.value(); cpu <= last.value(); ++cpu) {
+        cpuNodes[cpu] = node;
+      }
+    }
+  }
+
+  int32_t numNodes{0};
+  std::vector<int32_t> cpuNodes;
+};
+
+const NumaTopology& topology() {
+  static const NumaTopology instance;
+  return instance;
+}
+
+thread_local int32_t threadNumaNode = kNoNumaNode;
+} // namespace
+
+int32_t numaNodeCount() {
+  return topology().numNodes;
+}
+
+int32_t numaNodeOfCpu(int32_t cpu) {
+  auto& cpuNodes = topology().cpuNodes;
+  if (cpu < 0 || static_cast<size_t>(cpu) >= cpuNodes.size()) {
+    return 0;
+  }
+  return cpuNodes[cpu];
+}
+
+int32_t currentNumaNode() {
+  if (threadNumaNode != kNoNumaNode) {
+    return threadNumaNode;
+  }
+  if (numaNodeCount() == 1) {
+    return 0;
+  }
+#ifdef __linux__
+  return numaNodeOfCpu(sched_getcpu());
+#else
+  return 0;
+#endif
+}
+
+void setThreadNumaNode(int32_t node) {
+  threadNumaNode = node;
+}
+
+} // namespace facebook::velox::memory
@@ -0,0 +1,41 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#pragma once
+
+#include <cstdint>
+
+namespace facebook::velox::memory {
+
+constexpr int32_t kNoNumaNode = -1;
+
+// Returns the number of NUMA nodes of the host. 1 if the host has no NUMA
+// information, e.g. outside of Linux.
+int32_t numaNodeCount();
+
+// Returns the NUMA node of 'cpu'. 0 if not known.
+int32_t numaNodeOfCpu(int32_t cpu);
+
+// Returns the NUMA node memory for the calling thread should come from. This
+// is the node set by setThreadNumaNode() if any, else the node of the CPU the
+// thread runs on.
+int32_t currentNumaNode();
+
+// Sets the NUMA node returned by currentNumaNode() for the calling
+// thread. Threads pinned to a CPU, e.g. workers of a DriverExecutor, set
+// their node once. kNoNumaNode clears the setting.
+void setThreadNumaNode(int32_t node);
+
+} // namespace facebook::velox::memory
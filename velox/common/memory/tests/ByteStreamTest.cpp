@@ -14,6 +14,7 @@
  * limitations under the License.
  */
 #include "velox/common/memory/ByteStream.h"
+#include "velox/common/base/tests/GTestUtils.h"
 #include "velox/common/memory/MappedMemory.h"
 #include "velox/common/memory/MmapAllocator.h"
 
@@ -87,3 +88,55 @@ TEST_F(ByteStreamTest, outputStream) {
   // We expect dropping the stream and the iobuf frees the backing memory.
   EXPECT_EQ(0, mmapAllocator_->numAllocated());
 }
+
+TEST_F(ByteStreamTest, sharedArena) {
+  auto arena = std::make_shared<StreamArena>(mmapAllocator_.get());
+  ByteStream source(arena.get());
+  source.startWrite(MappedMemory::kPageSize);
+  std::string data(3 * MappedMemory::kPageSize, 'x');
+  for (auto i = 0; i < data.size(); ++i) {
+    data[i] = i % 251;
+  }
+  source.appendStringPiece(data);
+
+  std::stringstream referenceSStream;
+  OStreamOutputStream reference(&referenceSStream);
+  auto out = std::make_unique<IOBufOutputStream>(*mmapAllocator_, nullptr, 100);
+  out->shareArena(arena);
+  for (OutputStream* stream :
+       std::vector<OutputStream*>{out.get(), &reference}) {
+    std::string header(20, 'h');
+    stream->write(header.data(), header.size());
+    source.flush(stream);
+    stream->write("tail", 4);
+    // Overwrites the header after the shared bytes are added.
+    auto end = stream->tellp();
+    stream->seekp(4);
+    stream->write("abcd", 4);
+    stream->seekp(end);
+  }
+  EXPECT_EQ(reference.tellp(), out->tellp());
+  VELOX_ASSERT_THROW(out->seekp(100), "Cannot seek into bytes of a shared");
+
+  auto iobuf = out->getIOBuf();
+  // The first range of 'source' is full and is referenced, not copied.
+  auto firstRange = source.ranges()[0].buffer;
+  bool referenced = false;
+  for (auto range : *iobuf) {
+    referenced |= range.data() == firstRange;
+  }
+  EXPECT_TRUE(referenced);
+  auto str = referenceSStream.str();
+  auto coalesced = iobuf->clone()->coalesce();
+  EXPECT_EQ(
+      str,
+      std::string(
+          reinterpret_cast<const char*>(coalesced.data()), coalesced.size()));
+
+  // 'iobuf' keeps the memory of 'arena' alive.
+  arena = nullptr;
+  out = nullptr;
+  EXPECT_LT(0, mmapAllocator_->numAllocated());
+  iobuf = nullptr;
+  EXPECT_EQ(0, mmapAllocator_->numAllocated());
+}
@@ -105,7 +105,67 @@ TEST_F(HashStringAllocatorTest, allocate) {
     }
   }
   // We allow for some free overhead for free lists after all is freed.
-  EXPECT_LE(instance_->retainedSize() - instance_->freeSpace(), 200);
+  EXPECT_LE(
+      instance_->retainedSize() - instance_->freeSpace() -
+          instance_->cachedBytes(),
+      200);
+}
+
+TEST_F(HashStringAllocatorTest, smallBlockCache) {
+  // The first allocation refills the cache with blocks of 40 bytes.
+  auto first = allocate(33);
+  EXPECT_EQ(40, first->size());
+  EXPECT_EQ(1, instance_->stats().numCacheRefills);
+  std::vector<HashStringAllocator::Header*> headers;
+  for (auto i = 1; i < HashStringAllocator::kCacheRefillCount; ++i) {
+    headers.push_back(allocate(40));
+  }
+  EXPECT_EQ(
+      HashStringAllocator::kCacheRefillCount - 1,
+      instance_->stats().numCacheHits);
+  EXPECT_EQ(1, instance_->stats().numCacheRefills);
+  instance_->checkConsistency();
+
+  // A freed block is reused by the next allocation of its size without a
+  // free list search.
+  const auto numSearches = instance_->stats().numFreeListSearches;
+  instance_->free(first);
+  EXPECT_EQ(first, allocate(35));
+  EXPECT_EQ(numSearches, instance_->stats().numFreeListSearches);
+  headers.push_back(first);
+  for (auto header : headers) {
+    instance_->free(header);
+  }
+  instance_->checkConsistency();
+  headers.clear();
+
+  // Cached blocks are not counted as free space until the cache is released.
+  EXPECT_LE(
+      HashStringAllocator::kCacheRefillCount *
+          (40 + sizeof(HashStringAllocator::Header)),
+      instance_->cachedBytes());
+  auto freeSpace = instance_->freeSpace();
+  instance_->releaseCache();
+  EXPECT_EQ(0, instance_->cachedBytes());
+  EXPECT_LT(freeSpace, instance_->freeSpace());
+
+  // Freeing enough small blocks releases the cache to the free list.
+  for (auto i = 0; i < 10'000; ++i) {
+    headers.push_back(allocate(8 + i % 120));
+  }
+  for (auto header : headers) {
+    instance_->free(header);
+  }
+  instance_->checkConsistency();
+  EXPECT_LT(0, instance_->stats().numCacheReleases);
+  instance_->releaseCache();
+  instance_->checkConsistency();
+
+  const auto& stats = instance_->stats();
+  EXPECT_EQ(
+      10'000 + HashStringAllocator::kCacheRefillCount + 1,
+      stats.numAllocations);
+  EXPECT_LT(0, stats.bytesBySize[HashStringAllocator::Stats::sizeIndex(40)]);
 }
 
 TEST_F(HashStringAllocatorTest, multipart) {
@@ -240,7 +300,10 @@ TEST_F(HashStringAllocatorTest, stlAllocator) {
   instance_->checkConsistency();
 
   // We allow for some overhead for free lists after all is freed.
-  EXPECT_LE(instance_->retainedSize() - instance_->freeSpace(), 100);
+  EXPECT_LE(
+      instance_->retainedSize() - instance_->freeSpace() -
+          instance_->cachedBytes(),
+      100);
 }
 
 TEST_F(HashStringAllocatorTest, stlAllocatorWithSet) {
@@ -275,7 +338,10 @@ TEST_F(HashStringAllocatorTest, stlAllocatorWithSet) {
   instance_->checkConsistency();
 
   // We allow for some overhead for free lists after all is freed.
-  EXPECT_LE(instance_->retainedSize() - instance_->freeSpace(), 100);
+  EXPECT_LE(
+      instance_->retainedSize() - instance_->freeSpace() -
+          instance_->cachedBytes(),
+      100);
 }
 
 TEST_F(HashStringAllocatorTest, alignedStlAllocatorWithF14Map) {
@@ -313,5 +379,8 @@ TEST_F(HashStringAllocatorTest, alignedStlAllocatorWithF14Map) {
 
   // We allow for some overhead for free lists after all is freed. Map tends to
   // generate more free blocks at the end, so we loosen the upper bound a bit.
-  EXPECT_LE(instance_->retainedSize() - instance_->freeSpace(), 130);
+  EXPECT_LE(
+      instance_->retainedSize() - instance_->freeSpace() -
+          instance_->cachedBytes(),
+      130);
 }
@@ -0,0 +1,95 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <gtest/gtest.h>
+
+#include "velox/common/memory/HeapProfiler.h"
+#include "velox/common/memory/Memory.h"
+
+using namespace ::testing;
+using namespace ::facebook::velox::memory;
+
+TEST(HeapProfilerTest, sampling) {
+  HeapProfiler profiler(1024);
+  std::vector<char> data(10);
+  // 3 x 400 bytes cross 1024 once.
+  for (auto i = 0; i < 3; ++i) {
+    profiler.recordAllocation(&data[i], 400, "a");
+  }
+  // 2000 more bytes cross 2048 and 3072.
+  profiler.recordAllocation(&data[3], 2000, "b");
+
+  auto entries = profiler.entries();
+  ASSERT_EQ(2, entries.size());
+  EXPECT_EQ("b", entries[0].owner);
+  EXPECT_EQ(2048, entries[0].bytes);
+  EXPECT_EQ(1, entries[0].numSamples);
+  EXPECT_EQ("a", entries[1].owner);
+  EXPECT_EQ(1024, entries[1].bytes);
+
+  // Frees of unsampled allocations are ignored.
+  profiler.recordFree(&data[0]);
+  profiler.recordFree(&data[1]);
+  EXPECT_EQ(2, profiler.entries().size());
+  profiler.recordFree(&data[3]);
+  ASSERT_EQ(1, profiler.entries().size());
+  EXPECT_EQ("a", profiler.entries()[0].owner);
+  profiler.recordFree(&data[2]);
+  EXPECT_TRUE(profiler.entries().empty());
+}
+
+TEST(HeapProfilerTest, memoryPool) {
+  MemoryManager<MemoryAllocator, 64> manager{};
+  auto& root = manager.getRoot();
+  auto profiler = std::make_shared<HeapProfiler>(1024);
+  root.setHeapProfiler(profiler);
+  auto& first = root.addChild("first");
+  auto& second = root.addChild("second");
+  EXPECT_EQ(profiler, first.getHeapProfiler());
+  EXPECT_EQ(profiler, second.getHeapProfiler());
+
+  std::vector<void*> buffers;
+  for (auto i = 0; i < 10; ++i) {
+    buffers.push_back(first.allocate(1024));
+  }
+  auto* other = second.allocateZeroFilled(4096, 1);
+
+  auto entries = profiler->entries();
+  ASSERT_EQ(2, entries.size());
+  EXPECT_EQ("first", entries[0].owner);
+  EXPECT_EQ(10 * 1024, entries[0].bytes);
+  EXPECT_EQ(10, entries[0].numSamples);
+  EXPECT_EQ("second", entries[1].owner);
+  EXPECT_EQ(4096, entries[1].bytes);
+  EXPECT_NE(std::string::npos, profiler->toString().find("by second"));
+
+  for (auto i = 0; i < 5; ++i) {
+    first.free(buffers[i], 1024);
+  }
+  other = second.reallocate(other, 4096, 8192);
+  entries = profiler->entries();
+  ASSERT_EQ(2, entries.size());
+  EXPECT_EQ("second", entries[0].owner);
+  EXPECT_EQ(8192, entries[0].bytes);
+  EXPECT_EQ("first", entries[1].owner);
+  EXPECT_EQ(5 * 1024, entries[1].bytes);
+
+  for (auto i = 5; i < 10; ++i) {
+    first.free(buffers[i], 1024);
+  }
+  second.free(other, 8192);
+  EXPECT_TRUE(profiler->entries().empty());
+}
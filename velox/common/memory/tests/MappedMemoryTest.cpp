@@ -689,6 +689,79 @@ TEST_P(MappedMemoryTest, stlMappedMemoryAllocator) {
   EXPECT_TRUE(instance_->checkConsistency());
 }
 
+TEST(MmapAllocatorTest, hugePages) {
+  MmapAllocatorOptions options = {kMaxMappedMemory};
+  options.useHugePages = true;
+  options.hugePageMinUnitSize = 64;
+  MmapAllocator allocator(options);
+  EXPECT_EQ(0, allocator.numHugePageMapped());
+
+  // Size class allocations below 'hugePageMinUnitSize' are not counted.
+  MappedMemory::Allocation small(&allocator);
+  ASSERT_TRUE(allocator.allocate(16, 0, small));
+  EXPECT_EQ(0, allocator.numHugePageMapped());
+
+  MappedMemory::Allocation large(&allocator);
+  ASSERT_TRUE(allocator.allocate(256, 0, large));
+  EXPECT_EQ(256, allocator.numHugePageMapped());
+  // Free pages stay mapped until advised away.
+  allocator.free(large);
+  EXPECT_EQ(256, allocator.numHugePageMapped());
+
+  constexpr MachinePageCount kHugePages =
+      MmapAllocator::kHugePageSize / MappedMemory::kPageSize;
+  MappedMemory::ContiguousAllocation contiguous;
+  ASSERT_TRUE(
+      allocator.allocateContiguous(2 * kHugePages, nullptr, contiguous));
+  EXPECT_EQ(256 + 2 * kHugePages, allocator.numHugePageMapped());
+  memset(contiguous.data(), 1, contiguous.size());
+  EXPECT_NE(
+      std::string::npos, allocator.toString().find("huge page mapped"));
+  allocator.freeContiguous(contiguous);
+  EXPECT_EQ(256, allocator.numHugePageMapped());
+
+  // A contiguous allocation smaller than a huge page is not counted.
+  ASSERT_TRUE(allocator.allocateContiguous(16, nullptr, contiguous));
+  EXPECT_EQ(256, allocator.numHugePageMapped());
+  allocator.freeContiguous(contiguous);
+  allocator.free(small);
+  EXPECT_TRUE(allocator.checkConsistency());
+}
+
+TEST(MmapAllocatorTest, numaNodes) {
+  EXPECT_LE(1, numaNodeCount());
+  MmapAllocatorOptions options = {kMaxMappedMemory};
+  options.numaNodes = 2;
+  MmapAllocator allocator(options);
+
+  // Allocations come from the node set for the thread.
+  setThreadNumaNode(1);
+  MappedMemory::Allocation first(&allocator);
+  ASSERT_TRUE(allocator.allocate(100, 0, first));
+  EXPECT_EQ(0, allocator.numAllocatedOnNode(0));
+  EXPECT_LE(100, allocator.numAllocatedOnNode(1));
+
+  setThreadNumaNode(0);
+  MappedMemory::Allocation second(&allocator);
+  ASSERT_TRUE(allocator.allocate(100, 0, second));
+  EXPECT_LE(100, allocator.numAllocatedOnNode(0));
+  EXPECT_TRUE(allocator.checkConsistency());
+
+  // Any node can free pages of another node. The capacity is shared.
+  allocator.free(first);
+  EXPECT_EQ(0, allocator.numAllocatedOnNode(1));
+  MappedMemory::Allocation large(&allocator);
+  ASSERT_TRUE(
+      allocator.allocate(kCapacity - second.numPages(), 0, large));
+  MappedMemory::Allocation extra(&allocator);
+  EXPECT_FALSE(allocator.allocate(1, 0, extra));
+  allocator.free(large);
+  allocator.free(second);
+  EXPECT_EQ(0, allocator.numAllocated());
+  EXPECT_TRUE(allocator.checkConsistency());
+  setThreadNumaNode(kNoNumaNode);
+}
+
 VELOX_INSTANTIATE_TEST_SUITE_P(
     MappedMemoryTests,
     MappedMemoryTest,
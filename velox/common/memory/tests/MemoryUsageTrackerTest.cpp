@@ -108,6 +108,20 @@ TEST(MemoryUsageTrackerTest, reserve) {
   EXPECT_EQ(0, parent->getCurrentTotalBytes());
 }
 
+TEST(MemoryUsageTrackerTest, releaseKeepsUsedReservation) {
+  constexpr int64_t kMB = 1 << 20;
+  auto parent = MemoryUsageTracker::create();
+  auto child = parent->addChild();
+  child->reserve(100 * kMB);
+  child->update(10 * kMB);
+  // Only the unused part of the reservation is returned.
+  child->release();
+  EXPECT_EQ(10 * kMB, parent->getCurrentTotalBytes());
+  EXPECT_EQ(10 * kMB, child->getCurrentTotalBytes());
+  child->update(-10 * kMB);
+  EXPECT_EQ(0, parent->getCurrentTotalBytes());
+}
+
 namespace {
 // Model implementation of a GrowCallback.
 bool grow(
@@ -203,3 +217,71 @@ TEST(MemoryUsageTrackerTest, maybeReserve) {
   EXPECT_EQ(8 * kMB, child->getAvailableReservation());
   EXPECT_EQ(8 * kMB, parent->getCurrentUserBytes());
 }
+
+TEST(MemoryUsageTrackerTest, maybeReserveWithGrowCallback) {
+  constexpr int64_t kMB = 1 << 20;
+  auto config =
+      memory::MemoryUsageConfigBuilder().maxTotalMemory(10 * kMB).build();
+  auto parent = memory::MemoryUsageTracker::create(config);
+  int64_t parentLimit = 100 * kMB;
+  parent->setGrowCallback([&](MemoryUsageTracker::UsageType type,
+                              int64_t size,
+                              MemoryUsageTracker& tracker) {
+    return grow(type, size, parentLimit, tracker);
+  });
+  auto child = parent->addChild();
+  // The parent has no headroom for 16MB but its GrowCallback raises the
+  // limit.
+  EXPECT_TRUE(child->maybeReserve(16 * kMB));
+  EXPECT_EQ(16 * kMB, child->getAvailableReservation());
+  EXPECT_EQ(16 * kMB, parent->maxTotalBytes());
+  // The GrowCallback refuses to go past 'parentLimit'.
+  EXPECT_FALSE(child->maybeReserve(100 * kMB));
+  EXPECT_EQ(16 * kMB, child->getAvailableReservation());
+}
+
+TEST(MemoryUsageTrackerTest, numAllocs) {
+  constexpr int64_t kMB = 1 << 20;
+  auto parent = MemoryUsageTracker::create();
+  auto child = parent->addChild();
+  auto grandChild = child->addChild();
+  // Allocations within the reservation do not go to the parents but are
+  // counted for them.
+  for (auto i = 0; i < 10; ++i) {
+    grandChild->update(1000);
+  }
+  child->update(kMB);
+  EXPECT_EQ(10, grandChild->getNumAllocs());
+  EXPECT_EQ(11, child->getNumAllocs());
+  EXPECT_EQ(11, parent->getNumAllocs());
+  grandChild->update(-10 * 1000);
+  child->update(-kMB);
+
+  // The counts of a destroyed tracker stay with its parent.
+  grandChild.reset();
+  EXPECT_EQ(11, child->getNumAllocs());
+  child.reset();
+  EXPECT_EQ(11, parent->getNumAllocs());
+}
+
+TEST(MemoryUsageTrackerTest, exactReservationAtLimit) {
+  constexpr int64_t kMB = 1 << 20;
+  auto config =
+      MemoryUsageConfigBuilder().maxTotalMemory(3 * kMB + kMB / 2).build();
+  auto parent = MemoryUsageTracker::create(config);
+  auto child = parent->addChild();
+  child->update(3 * kMB);
+  EXPECT_EQ(3 * kMB, parent->getCurrentTotalBytes());
+  // The reservation rounded up to 4MB exceeds the limit but the exact size
+  // fits.
+  child->update(kMB / 4);
+  EXPECT_EQ(3 * kMB + kMB / 4, parent->getCurrentTotalBytes());
+  EXPECT_EQ(0, child->getAvailableReservation());
+  EXPECT_THROW(child->update(kMB / 2), VeloxRuntimeError);
+  EXPECT_EQ(3 * kMB + kMB / 4, parent->getCurrentTotalBytes());
+  // Freeing goes back to the quantized reservation.
+  child->update(-kMB / 4);
+  EXPECT_EQ(3 * kMB, parent->getCurrentTotalBytes());
+  child->update(-3 * kMB);
+  EXPECT_EQ(0, parent->getCurrentTotalBytes());
+}
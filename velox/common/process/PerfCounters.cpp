@@ -0,0 +1,129 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "velox/common/process/PerfCounters.h"
+
+#include <fmt/format.h>
+#include <memory>
+
+#ifdef __linux__
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+namespace facebook::velox::process {
+
+std::string PerfCounterValues::toString() const {
+  return fmt::format(
+      "cycles: {}, instructions: {}, llcMisses: {}, branchMisses: {}",
+      cycles,
+      instructions,
+      llcMisses,
+      branchMisses);
+}
+
+ThreadPerfCounters::~ThreadPerfCounters() {
+#ifdef __linux__
+  for (auto fd : fds_) {
+    if (fd >= 0) {
+      ::close(fd);
+    }
+  }
+#endif
+}
+
+// static
+ThreadPerfCounters* ThreadPerfCounters::get() {
+  struct Holder {
+    bool opened{false};
+    std::unique_ptr<ThreadPerfCounters> counters;
+  };
+  thread_local Holder holder;
+  if (!holder.opened) {
+    holder.opened = true;
+    std::unique_ptr<ThreadPerfCounters> counters(new ThreadPerfCounters());
+    if (counters->open()) {
+      holder.counters = std::move(counters);
+    }
+  }
+  return holder.counters.get();
+}
+
+bool ThreadPerfCounters::open() {
+#ifdef __linux__
+  static constexpr uint64_t kConfigs[kNumCounters] = {
+      PERF_COUNT_HW_CPU_CYCLES,
+      PERF_COUNT_HW_INSTRUCTIONS,
+      PERF_COUNT_HW_CACHE_MISSES,
+      PERF_COUNT_HW_BRANCH_MISSES};
+  for (auto i = 0; i < kNumCounters; ++i) {
+    struct perf_event_attr attr {};
+    attr.size = sizeof(attr);
+    attr.type = PERF_TYPE_HARDWARE;
+    attr.config = kConfigs[i];
+    attr.read_format = PERF_FORMAT_GROUP;
+    attr.exclude_kernel = 1;
+    attr.exclude_hv = 1;
+    // The group starts counting when the leader is enabled below.
+    attr.disabled = i == 0;
+    fds_[i] = syscall(
+        __NR_perf_event_open, &attr, 0, -1, i == 0 ? -1 : fds_[0], 0);
+    if (fds_[i] < 0) {
+      return false;
+    }
+  }
+  return ioctl(fds_[0], PERF_EVENT_IOC_ENABLE, PERF_IOC_FLAG_GROUP) == 0;
+#else
+  return false;
+#endif
+}
+
+PerfCounterValues ThreadPerfCounters::read() const {
+  PerfCounterValues values;
+#ifdef __linux__
+  // With PERF_FORMAT_GROUP the leader returns the number of counters
+  // followed by their values in the order they were opened.
+  uint64_t buffer[1 + kNumCounters];
+  if (::read(fds_[0], buffer, sizeof(buffer)) == sizeof(buffer) &&
+      buffer[0] == kNumCounters) {
+    values.cycles = buffer[1];
+    values.instructions = buffer[2];
+    values.llcMisses = buffer[3];
+    values.branchMisses = buffer[4];
+  }
+#endif
+  return values;
+}
+
+PerfCounterScope::PerfCounterScope(PerfCounterValues* values)
+    : values_(values),
+      counters_(values ? ThreadPerfCounters::get() : nullptr),
+      start_(counters_ ? counters_->read() : PerfCounterValues()) {}
+
+PerfCounterScope::~PerfCounterScope() {
+  if (!counters_) {
+    return;
+  }
+  auto end = counters_->read();
+  values_->cycles += end.cycles - start_.cycles;
+  values_->instructions += end.instructions - start_.instructions;
+  values_->llcMisses += end.llcMisses - start_.llcMisses;
+  values_->branchMisses += end.branchMisses - start_.branchMisses;
+}
+
+} // namespace facebook::velox::process
@@ -0,0 +1,94 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <string>
+
+#include <folly/CPortability.h>
+
+namespace facebook::velox::process {
+
+// Hardware event counts of a thread over some interval.
+struct PerfCounterValues {
+  uint64_t cycles{0};
+  uint64_t instructions{0};
+  // Misses in the last level cache.
+  uint64_t llcMisses{0};
+  uint64_t branchMisses{0};
+
+  void add(const PerfCounterValues& other) {
+    cycles += other.cycles;
+    instructions += other.instructions;
+    llcMisses += other.llcMisses;
+    branchMisses += other.branchMisses;
+  }
+
+  void clear() {
+    *this = PerfCounterValues();
+  }
+
+  bool empty() const {
+    return cycles == 0 && instructions == 0;
+  }
+
+  std::string toString() const;
+};
+
+// Counters of cycles, instructions, last level cache misses and branch
+// misses of the calling thread, opened with perf_event_open() as one group
+// on first use and kept until the thread exits. Counts user space only so
+// that the default perf_event_paranoid setting allows it.
+class ThreadPerfCounters {
+ public:
+  ~ThreadPerfCounters();
+
+  // Returns the counters of the calling thread or nullptr if hardware
+  // counters are not available, e.g. outside of Linux, in a VM without a
+  // virtual PMU or when not permitted.
+  static ThreadPerfCounters* FOLLY_NULLABLE get();
+
+  // Returns the counts since the counters were opened.
+  PerfCounterValues read() const;
+
+ private:
+  static constexpr int32_t kNumCounters = 4;
+
+  ThreadPerfCounters() = default;
+
+  bool open();
+
+  // The group leader is fds_[0].
+  int fds_[kNumCounters] = {-1, -1, -1, -1};
+};
+
+// Adds the counts of the calling thread from construction to destruction
+// to '*values'. Does nothing if 'values' is nullptr or the thread has no
+// counters, so that call sites cost a branch when counting is off.
+class PerfCounterScope {
+ public:
+  explicit PerfCounterScope(PerfCounterValues* FOLLY_NULLABLE values);
+
+  ~PerfCounterScope();
+
+ private:
+  PerfCounterValues* const values_;
+  ThreadPerfCounters* const counters_;
+  PerfCounterValues start_;
+};
+
+} // namespace facebook::velox::process
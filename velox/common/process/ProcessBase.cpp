@@ -32,6 +32,8 @@ DECLARE_bool(avx2); // Enables use of AVX2 when available NOLINT
 
 DECLARE_bool(bmi2); // Enables use of BMI2 when available NOLINT
 
+DECLARE_bool(avx512); // Enables use of AVX-512 when available NOLINT
+
 namespace facebook {
 namespace velox {
 namespace process {
@@ -108,6 +110,7 @@ uint64_t threadCpuNanos() {
 namespace {
 bool bmi2CpuFlag = folly::CpuId().bmi2();
 bool avx2CpuFlag = folly::CpuId().avx2();
+bool avx512CpuFlag = folly::CpuId().avx512f();
 } // namespace
 
 bool hasAvx2() {
@@ -126,6 +129,14 @@ bool hasBmi2() {
 #endif
 }
 
+bool hasAvx512() {
+#ifdef __x86_64__
+  return avx512CpuFlag && FLAGS_avx512;
+#else
+  return false;
+#endif
+}
+
 } // namespace process
 } // namespace velox
 } // namespace facebook
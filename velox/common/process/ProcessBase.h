@@ -63,6 +63,12 @@ bool hasAvx2();
 // flag.
 bool hasBmi2();
 
+// True if the machine has Intel AVX-512F instructions and these are not
+// disabled by flag. Unlike hasAvx2(), this does not depend on the build
+// target: AVX-512 kernels are compiled for AVX-512 individually and are
+// selected at runtime.
+bool hasAvx512();
+
 } // namespace process
 } // namespace velox
 } // namespace facebook
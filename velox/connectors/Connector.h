@@ -15,12 +15,14 @@
  */
 #pragma once
 
+#include "velox/common/base/AsyncSource.h"
 #include "velox/common/base/RuntimeMetrics.h"
 #include "velox/common/caching/ScanTracker.h"
 #include "velox/common/future/VeloxPromise.h"
 #include "velox/core/Context.h"
 #include "velox/vector/ComplexVector.h"
 
+#include <folly/Executor.h>
 #include <folly/Synchronized.h>
 
 namespace facebook::velox::common {
@@ -34,6 +36,8 @@ class ExprSet;
 }
 namespace facebook::velox::connector {
 
+class DataSource;
+
 // A split represents a chunk of data that a connector should load and return
 // as a RowVectorPtr, potentially after processing pushdowns.
 struct ConnectorSplit {
@@ -43,6 +47,11 @@ struct ConnectorSplit {
   // async prefetch for the split.
   bool cancelled{false};
 
+  // DataSource with 'this' added, made in the background before the
+  // split's turn comes. Set if the split is preloaded, see
+  // Connector::supportsSplitPreload().
+  std::shared_ptr<AsyncSource<std::shared_ptr<DataSource>>> dataSource;
+
   explicit ConnectorSplit(const std::string& _connectorId)
       : connectorId(_connectorId) {}
 
@@ -56,6 +65,10 @@ struct ConnectorSplit {
 class ColumnHandle {
  public:
   virtual ~ColumnHandle() = default;
+
+  virtual std::string toString() const {
+    VELOX_UNSUPPORTED("toString");
+  }
 };
 
 class ConnectorTableHandle {
@@ -136,6 +149,13 @@ class DataSource {
 
   virtual std::unordered_map<std::string, RuntimeCounter> runtimeStats() = 0;
 
+  // Returns runtime stats that carry a histogram of their values, e.g. the
+  // latencies of IO waits. Merged into the operator's runtime stats together
+  // with runtimeStats().
+  virtual std::unordered_map<std::string, RuntimeMetric> runtimeHistograms() {
+    return {};
+  }
+
   // Returns a connector dependent row size if available. This can be
   // called after addSplit().  This estimates uncompressed data
   // sizes. This is better than getCompletedBytes()/getCompletedRows()
@@ -145,6 +165,20 @@ class DataSource {
   virtual int64_t estimatedRowSize() {
     return kUnknownRowSize;
   }
+
+  // Takes over the split of 'source', a DataSource of the same table
+  // and columns that has been given the split with addSplit(). Used
+  // for continuing with a split preloaded by another DataSource. The
+  // dynamic filters of 'this' apply to the split.
+  virtual void setFromDataSource(std::shared_ptr<DataSource> /*source*/) {
+    VELOX_UNSUPPORTED("setFromDataSource");
+  }
+
+  // Hints that the consumer needs at most 'limit' rows from the splits of
+  // 'this', e.g. because the scan feeds a Limit. The DataSource may then
+  // read smaller batches and skip read-ahead. Called before the first
+  // addSplit(). Does nothing by default.
+  virtual void setRowLimit(int64_t /*limit*/) {}
 };
 
 // Exposes expression evaluation functionality of the engine to the connector.
@@ -174,12 +208,14 @@ class ConnectorQueryCtx {
       Config* config,
       ExpressionEvaluator* expressionEvaluator,
       memory::MappedMemory* mappedMemory,
-      const std::string& scanId)
+      const std::string& scanId,
+      const std::string& cacheQuotaGroup = "")
       : pool_(pool),
         config_(config),
         expressionEvaluator_(expressionEvaluator),
         mappedMemory_(mappedMemory),
-        scanId_(scanId) {}
+        scanId_(scanId),
+        cacheQuotaGroup_(cacheQuotaGroup) {}
 
   memory::MemoryPool* memoryPool() const {
     return pool_;
@@ -208,12 +244,19 @@ class ConnectorQueryCtx {
     return scanId_;
   }
 
+  // Name of the quota group of cache::AsyncDataCache that the data
+  // cached for the query is charged to. Empty for no quota.
+  const std::string& cacheQuotaGroup() const {
+    return cacheQuotaGroup_;
+  }
+
  private:
   memory::MemoryPool* pool_;
   Config* config_;
   ExpressionEvaluator* expressionEvaluator_;
   memory::MappedMemory* mappedMemory_;
   std::string scanId_;
+  std::string cacheQuotaGroup_;
 };
 
 class Connector {
@@ -239,6 +282,18 @@ class Connector {
     return false;
   }
 
+  // Returns true if the splits of a scan may be added to a DataSource
+  // ahead of time on executor() and then be passed to the DataSource
+  // of the scan with DataSource::setFromDataSource().
+  virtual bool supportsSplitPreload() {
+    return false;
+  }
+
+  // Executor for background work of the connector, e.g. prefetch.
+  virtual folly::Executor* FOLLY_NULLABLE executor() const {
+    return nullptr;
+  }
+
   virtual std::shared_ptr<DataSource> createDataSource(
       const RowTypePtr& outputType,
       const std::shared_ptr<connector::ConnectorTableHandle>& tableHandle,
@@ -15,6 +15,7 @@
  */
 #include "velox/connectors/hive/HiveConnector.h"
 
+#include <filesystem>
 #include <memory>
 
 #include "velox/dwio/common/InputStream.h"
@@ -43,15 +44,27 @@ HiveTableHandle::HiveTableHandle(
     const std::string& tableName,
     bool filterPushdownEnabled,
     SubfieldFilters subfieldFilters,
-    const core::TypedExprPtr& remainingFilter)
+    const core::TypedExprPtr& remainingFilter,
+    std::vector<PushdownAggregate> aggregates)
     : ConnectorTableHandle(std::move(connectorId)),
       tableName_(tableName),
       filterPushdownEnabled_(filterPushdownEnabled),
       subfieldFilters_(std::move(subfieldFilters)),
-      remainingFilter_(remainingFilter) {}
+      remainingFilter_(remainingFilter),
+      aggregates_(std::move(aggregates)) {}
 
 HiveTableHandle::~HiveTableHandle() {}
 
+std::string HiveColumnHandle::toString() const {
+  static const char* kColumnTypeNames[] = {
+      "partition key", "regular", "synthesized"};
+  return fmt::format(
+      "{} {} {}",
+      name_,
+      kColumnTypeNames[static_cast<int>(columnType_)],
+      dataType_->toString());
+}
+
 std::string HiveTableHandle::toString() const {
   std::stringstream out;
   out << "table: " << tableName_;
@@ -75,33 +88,309 @@ std::string HiveTableHandle::toString() const {
   if (remainingFilter_) {
     out << ", remaining filter: (" << remainingFilter_->toString() << ")";
   }
+  if (!aggregates_.empty()) {
+    static const char* kNames[] = {"count", "min", "max"};
+    out << ", aggregates: [";
+    for (auto i = 0; i < aggregates_.size(); ++i) {
+      out << (i > 0 ? ", " : "") << kNames[static_cast<int>(aggregates_[i])];
+    }
+    out << "]";
+  }
   return out.str();
 }
 
+namespace {
+// Directory name of a null partition value.
+const char* kDefaultPartitionValue = "__HIVE_DEFAULT_PARTITION__";
+
+// Escapes the characters that Hive escapes in partition directory names.
+std::string escapePathName(const std::string& name) {
+  std::string escaped;
+  escaped.reserve(name.size());
+  for (char c : name) {
+    if (c < ' ' || c == '"' || c == '#' || c == '%' || c == '\'' ||
+        c == '*' || c == '/' || c == ':' || c == '=' || c == '?' ||
+        c == '\\' || c == '{' || c == '[' || c == ']' || c == '^') {
+      escaped += fmt::format("%{:02X}", static_cast<uint8_t>(c));
+    } else {
+      escaped += c;
+    }
+  }
+  return escaped;
+}
+
+bool isSupportedPartitionType(TypeKind kind) {
+  switch (kind) {
+    case TypeKind::BOOLEAN:
+    case TypeKind::TINYINT:
+    case TypeKind::SMALLINT:
+    case TypeKind::INTEGER:
+    case TypeKind::BIGINT:
+    case TypeKind::VARCHAR:
+    case TypeKind::DATE:
+      return true;
+    default:
+      return false;
+  }
+}
+
+std::string partitionValue(
+    const DecodedVector& decoded,
+    TypeKind kind,
+    vector_size_t row) {
+  if (decoded.isNullAt(row)) {
+    return kDefaultPartitionValue;
+  }
+  switch (kind) {
+    case TypeKind::BOOLEAN:
+      return decoded.valueAt<bool>(row) ? "true" : "false";
+    case TypeKind::TINYINT:
+      return folly::to<std::string>(decoded.valueAt<int8_t>(row));
+    case TypeKind::SMALLINT:
+      return folly::to<std::string>(decoded.valueAt<int16_t>(row));
+    case TypeKind::INTEGER:
+      return folly::to<std::string>(decoded.valueAt<int32_t>(row));
+    case TypeKind::BIGINT:
+      return folly::to<std::string>(decoded.valueAt<int64_t>(row));
+    case TypeKind::VARCHAR:
+      return escapePathName(std::string(decoded.valueAt<StringView>(row)));
+    case TypeKind::DATE:
+      return decoded.valueAt<Date>(row).toString();
+    default:
+      VELOX_UNREACHABLE();
+  }
+}
+
+// Makes the directory of a local file. Object stores have no directories.
+void makeParentDirectory(const std::string& path) {
+  std::string localPath;
+  if (path.find("://") == std::string::npos) {
+    localPath = path.compare(0, 5, "file:") == 0 ? path.substr(5) : path;
+  }
+  if (localPath.empty()) {
+    return;
+  }
+  std::filesystem::create_directories(
+      std::filesystem::path(localPath).parent_path());
+}
+} // namespace
+
 HiveDataSink::HiveDataSink(
     std::shared_ptr<const RowType> inputType,
-    const std::string& filePath,
-    velox::memory::MemoryPool* memoryPool)
-    : inputType_(inputType) {
+    std::shared_ptr<const HiveInsertTableHandle> insertTableHandle,
+    const ConnectorQueryCtx* connectorQueryCtx)
+    : inputType_(std::move(inputType)),
+      insertTableHandle_(std::move(insertTableHandle)),
+      pool_(connectorQueryCtx->memoryPool()),
+      maxOpenWriters_(connectorQueryCtx->config()->get<int32_t>(
+          kMaxOpenWriters,
+          kDefaultMaxOpenWriters)),
+      writerMemoryLimit_(connectorQueryCtx->config()->get<int64_t>(
+          kWriterMemoryLimit,
+          kDefaultWriterMemoryLimit)) {
+  if (!insertTableHandle_->isPartitionedOrBucketed()) {
+    dataType_ = inputType_;
+    writers_.push_back(makeWriter(insertTableHandle_->filePath()));
+    writerPaths_.push_back(insertTableHandle_->filePath());
+    return;
+  }
+  VELOX_USER_CHECK_GT(maxOpenWriters_, 0);
+  const auto& partitionedBy = insertTableHandle_->partitionedBy();
+  for (const auto& name : partitionedBy) {
+    auto channel = inputType_->getChildIdx(name);
+    VELOX_USER_CHECK(
+        isSupportedPartitionType(inputType_->childAt(channel)->kind()),
+        "Unsupported partition column type: {} {}",
+        name,
+        inputType_->childAt(channel)->toString());
+    partitionChannels_.push_back(channel);
+  }
+  decodedPartitionKeys_.resize(partitionChannels_.size());
+
+  std::vector<std::string> names;
+  std::vector<TypePtr> types;
+  for (auto i = 0; i < inputType_->size(); ++i) {
+    const auto& name = inputType_->nameOf(i);
+    if (std::find(partitionedBy.begin(), partitionedBy.end(), name) ==
+        partitionedBy.end()) {
+      dataChannels_.push_back(i);
+      names.push_back(name);
+      types.push_back(inputType_->childAt(i));
+    }
+  }
+  dataType_ = ROW(std::move(names), std::move(types));
+
+  if (insertTableHandle_->bucketCount() > 0) {
+    std::vector<column_index_t> bucketChannels;
+    for (const auto& name : insertTableHandle_->bucketedBy()) {
+      bucketChannels.push_back(inputType_->getChildIdx(name));
+    }
+    std::vector<int> bucketToPartition(insertTableHandle_->bucketCount());
+    std::iota(bucketToPartition.begin(), bucketToPartition.end(), 0);
+    bucketFunction_ = std::make_unique<HivePartitionFunction>(
+        insertTableHandle_->bucketCount(),
+        std::move(bucketToPartition),
+        std::move(bucketChannels));
+  }
+}
+
+std::unique_ptr<dwrf::Writer> HiveDataSink::makeWriter(
+    const std::string& path) {
   auto config = std::make_shared<WriterConfig>();
   // TODO: Wire up serde properties to writer configs.
 
   facebook::velox::dwrf::WriterOptions options;
   options.config = config;
-  options.schema = inputType;
+  options.schema = dataType_;
   // Without explicitly setting flush policy, the default memory based flush
   // policy is used.
 
-  auto sink = facebook::velox::dwio::common::DataSink::create(filePath);
-  writer_ = std::make_unique<Writer>(options, std::move(sink), *memoryPool);
+  auto sink = facebook::velox::dwio::common::DataSink::create(path);
+  return std::make_unique<Writer>(options, std::move(sink), *pool_);
 }
 
 void HiveDataSink::appendData(VectorPtr input) {
-  writer_->write(input);
+  if (!insertTableHandle_->isPartitionedOrBucketed()) {
+    writers_[0]->write(input);
+    return;
+  }
+  auto rowVector = std::dynamic_pointer_cast<RowVector>(input);
+  VELOX_CHECK_NOT_NULL(rowVector, "HiveDataSink expects a RowVector");
+  appendPartitioned(rowVector);
+  flushLargestWriters();
+}
+
+std::string HiveDataSink::partitionDirectory(vector_size_t row) const {
+  std::string directory;
+  for (auto i = 0; i < partitionChannels_.size(); ++i) {
+    auto channel = partitionChannels_[i];
+    directory += escapePathName(inputType_->nameOf(channel));
+    directory += '=';
+    directory += partitionValue(
+        decodedPartitionKeys_[i], inputType_->childAt(channel)->kind(), row);
+    directory += '/';
+  }
+  return directory;
+}
+
+int32_t HiveDataSink::writerIndex(
+    const std::string& partitionDir,
+    int32_t bucket) {
+  auto key = bucketFunction_ ? fmt::format("{}{}", partitionDir, bucket)
+                             : partitionDir;
+  auto it = writerIndices_.find(key);
+  if (it != writerIndices_.end()) {
+    return it->second;
+  }
+  VELOX_USER_CHECK_LT(
+      writers_.size(),
+      maxOpenWriters_,
+      "Exceeded the limit of {} open writers for partitions and buckets",
+      maxOpenWriters_);
+  auto fileName = bucketFunction_ ? fmt::format("bucket-{:05d}", bucket)
+                                  : std::string("data");
+  auto path = fmt::format(
+      "{}/{}{}", insertTableHandle_->filePath(), partitionDir, fileName);
+  makeParentDirectory(path);
+  writers_.push_back(makeWriter(path));
+  writerPaths_.push_back(path);
+  writerIndices_[key] = writers_.size() - 1;
+  return writers_.size() - 1;
+}
+
+void HiveDataSink::appendPartitioned(const RowVectorPtr& input) {
+  const auto numRows = input->size();
+  if (bucketFunction_) {
+    bucketFunction_->partition(*input, buckets_);
+  }
+  SelectivityVector rows(numRows);
+  for (auto i = 0; i < partitionChannels_.size(); ++i) {
+    decodedPartitionKeys_[i].decode(
+        *input->childAt(partitionChannels_[i]), rows);
+  }
+
+  rowWriters_.resize(numRows);
+  std::string directory;
+  for (auto row = 0; row < numRows; ++row) {
+    directory = partitionDirectory(row);
+    rowWriters_[row] =
+        writerIndex(directory, bucketFunction_ ? buckets_[row] : 0);
+  }
+
+  // Gathers the rows of each writer and writes them as dictionaries over
+  // the input columns.
+  writerRowCounts_.assign(writers_.size(), 0);
+  for (auto row = 0; row < numRows; ++row) {
+    ++writerRowCounts_[rowWriters_[row]];
+  }
+  std::vector<BufferPtr> writerRows(writers_.size());
+  std::vector<vector_size_t*> rawWriterRows(writers_.size());
+  for (auto i = 0; i < writers_.size(); ++i) {
+    if (writerRowCounts_[i] == 0) {
+      continue;
+    }
+    writerRows[i] = allocateIndices(writerRowCounts_[i], pool_);
+    rawWriterRows[i] = writerRows[i]->asMutable<vector_size_t>();
+  }
+  for (auto row = 0; row < numRows; ++row) {
+    *rawWriterRows[rowWriters_[row]]++ = row;
+  }
+  for (auto i = 0; i < writers_.size(); ++i) {
+    if (writerRowCounts_[i] == 0) {
+      continue;
+    }
+    std::vector<VectorPtr> children;
+    children.reserve(dataChannels_.size());
+    for (auto channel : dataChannels_) {
+      children.push_back(
+          writerRowCounts_[i] == numRows
+              ? input->childAt(channel)
+              : BaseVector::wrapInDictionary(
+                    nullptr,
+                    writerRows[i],
+                    writerRowCounts_[i],
+                    input->childAt(channel)));
+    }
+    writers_[i]->write(std::make_shared<RowVector>(
+        pool_,
+        dataType_,
+        nullptr,
+        writerRowCounts_[i],
+        std::move(children)));
+  }
+}
+
+void HiveDataSink::flushLargestWriters() {
+  std::vector<std::pair<int64_t, int32_t>> usage;
+  int64_t totalUsage = 0;
+  for (auto i = 0; i < writers_.size(); ++i) {
+    const auto& context =
+        static_cast<const dwrf::Writer&>(*writers_[i]).getContext();
+    if (context.stripeRowCount == 0) {
+      continue;
+    }
+    auto bytes = context.getTotalMemoryUsage();
+    totalUsage += bytes;
+    usage.emplace_back(bytes, i);
+  }
+  if (totalUsage <= writerMemoryLimit_) {
+    return;
+  }
+  std::sort(usage.begin(), usage.end(), std::greater<>());
+  for (const auto& [bytes, index] : usage) {
+    writers_[index]->flush();
+    ++numMemoryFlushes_;
+    totalUsage -= bytes;
+    if (totalUsage <= writerMemoryLimit_) {
+      break;
+    }
+  }
 }
 
 void HiveDataSink::close() {
-  writer_->close();
+  for (auto& writer : writers_) {
+    writer->close();
+  }
 }
 
 namespace {
@@ -195,7 +484,8 @@ HiveDataSource::HiveDataSource(
     ExpressionEvaluator* expressionEvaluator,
     memory::MappedMemory* mappedMemory,
     const std::string& scanId,
-    folly::Executor* executor)
+    folly::Executor* executor,
+    const std::string& cacheQuotaGroup)
     : outputType_(outputType),
       fileHandleFactory_(fileHandleFactory),
       pool_(pool),
@@ -204,6 +494,9 @@ HiveDataSource::HiveDataSource(
       mappedMemory_(mappedMemory),
       scanId_(scanId),
       executor_(executor) {
+  if (auto asyncCache = dynamic_cast<cache::AsyncDataCache*>(mappedMemory)) {
+    cacheQuotaGroup_ = asyncCache->quotaGroupId(cacheQuotaGroup);
+  }
   // Column handled keyed on the column alias, the name used in the query.
   for (const auto& [canonicalizedName, columnHandle] : columnHandles) {
     auto handle = std::dynamic_pointer_cast<HiveColumnHandle>(columnHandle);
@@ -217,19 +510,6 @@ HiveDataSource::HiveDataSource(
     }
   }
 
-  std::vector<std::string> columnNames;
-  columnNames.reserve(outputType->size());
-  for (auto& outputName : outputType->names()) {
-    auto it = columnHandles.find(outputName);
-    VELOX_CHECK(
-        it != columnHandles.end(),
-        "ColumnHandle is missing for output column: {}",
-        outputName);
-
-    const auto& handle = static_cast<HiveColumnHandle&>(*it->second);
-    columnNames.emplace_back(handle.name());
-  }
-
   auto hiveTableHandle =
       std::dynamic_pointer_cast<HiveTableHandle>(tableHandle);
   VELOX_CHECK(
@@ -238,9 +518,64 @@ HiveDataSource::HiveDataSource(
   VELOX_CHECK(
       hiveTableHandle->isFilterPushdownEnabled(),
       "Filter pushdown must be enabled");
+  aggregates_ = hiveTableHandle->aggregates();
 
-  auto outputTypes = outputType_->children();
-  readerOutputType_ = ROW(std::move(columnNames), std::move(outputTypes));
+  std::vector<std::string> columnNames;
+  std::vector<TypePtr> columnTypes;
+  if (aggregates_.empty()) {
+    columnNames.reserve(outputType->size());
+    for (auto& outputName : outputType->names()) {
+      auto it = columnHandles.find(outputName);
+      VELOX_CHECK(
+          it != columnHandles.end(),
+          "ColumnHandle is missing for output column: {}",
+          outputName);
+
+      const auto& handle = static_cast<HiveColumnHandle&>(*it->second);
+      columnNames.emplace_back(handle.name());
+    }
+    columnTypes = outputType_->children();
+  } else {
+    // The reader reads the aggregated columns, each once.
+    VELOX_CHECK_EQ(
+        aggregates_.size(),
+        outputType->size(),
+        "One output column per pushed down aggregate is expected");
+    for (auto i = 0; i < aggregates_.size(); ++i) {
+      const auto& outputName = outputType->nameOf(i);
+      auto it = columnHandles.find(outputName);
+      if (it == columnHandles.end()) {
+        VELOX_CHECK(
+            aggregates_[i] == PushdownAggregate::kCount,
+            "ColumnHandle is missing for aggregate output column: {}",
+            outputName);
+        aggregateInputs_.push_back(std::nullopt);
+        continue;
+      }
+      const auto& handle = static_cast<HiveColumnHandle&>(*it->second);
+      VELOX_CHECK(
+          handle.columnType() == HiveColumnHandle::ColumnType::kRegular,
+          "Aggregates can only be pushed down over regular columns: {}",
+          handle.name());
+      if (aggregates_[i] == PushdownAggregate::kCount) {
+        VELOX_CHECK_EQ(outputType->childAt(i)->kind(), TypeKind::BIGINT);
+      } else {
+        VELOX_CHECK(
+            outputType->childAt(i)->kindEquals(handle.dataType()),
+            "Type of min or max must be the type of its column: {}",
+            outputName);
+      }
+      auto column = std::find(
+          columnNames.begin(), columnNames.end(), handle.name());
+      aggregateInputs_.push_back(column - columnNames.begin());
+      if (column == columnNames.end()) {
+        columnNames.push_back(handle.name());
+        columnTypes.push_back(handle.dataType());
+      }
+    }
+  }
+
+  readerOutputType_ = ROW(std::move(columnNames), std::move(columnTypes));
   scanSpec_ =
       makeScanSpec(hiveTableHandle->subfieldFilters(), readerOutputType_);
 
@@ -253,7 +588,7 @@ HiveDataSource::HiveDataSource(
     // Make sure to add these columns to scanSpec_.
 
     auto filterInputs = remainingFilterExprSet_->expr(0)->distinctFields();
-    column_index_t channel = outputType_->size();
+    column_index_t channel = readerOutputType_->size();
     auto names = readerOutputType_->names();
     auto types = readerOutputType_->children();
     for (auto& input : filterInputs) {
@@ -272,6 +607,13 @@ HiveDataSource::HiveDataSource(
   }
 
   rowReaderOpts_.setScanSpec(scanSpec_);
+  if (executor_) {
+    // The executor outlives the data source and is not owned by it.
+    rowReaderOpts_.setDecodingExecutor(
+        std::shared_ptr<folly::Executor>(executor_, [](folly::Executor*) {}));
+    rowReaderOpts_.setRowGroupsAhead(kParquetRowGroupsAhead);
+    rowReaderOpts_.setParallelColumnDecoding(true);
+  }
 
   ioStats_ = std::make_shared<dwio::common::IoStatistics>();
 }
@@ -357,11 +699,156 @@ velox::variant convertFromString(const std::optional<std::string>& value) {
   return velox::variant(ToKind);
 }
 
+// True if 'stats' of a column of a file of 'numRows' rows show that all its
+// values pass 'filter'. Range filters pass all values if they pass the
+// minimum and the maximum.
+bool allRowsPass(
+    const common::Filter& filter,
+    const dwio::common::ColumnStatistics& stats,
+    uint64_t numRows) {
+  auto numValues = stats.getNumberOfValues();
+  if (numValues == 0) {
+    return filter.testNull();
+  }
+  bool mayHaveNull = stats.hasNull().value_or(true);
+  if (numValues == numRows) {
+    mayHaveNull = false;
+  }
+  if (mayHaveNull && !filter.testNull()) {
+    return false;
+  }
+  auto* intStats =
+      dynamic_cast<const dwio::common::IntegerColumnStatistics*>(&stats);
+  auto* doubleStats =
+      dynamic_cast<const dwio::common::DoubleColumnStatistics*>(&stats);
+  auto* stringStats =
+      dynamic_cast<const dwio::common::StringColumnStatistics*>(&stats);
+  switch (filter.kind()) {
+    case common::FilterKind::kAlwaysTrue:
+      return true;
+    case common::FilterKind::kIsNotNull:
+      return !mayHaveNull;
+    case common::FilterKind::kBigintRange:
+      return intStats && intStats->getMinimum() && intStats->getMaximum() &&
+          filter.testInt64(intStats->getMinimum().value()) &&
+          filter.testInt64(intStats->getMaximum().value());
+    case common::FilterKind::kDoubleRange:
+      return doubleStats && doubleStats->getMinimum() &&
+          doubleStats->getMaximum() &&
+          filter.testDouble(doubleStats->getMinimum().value()) &&
+          filter.testDouble(doubleStats->getMaximum().value());
+    case common::FilterKind::kFloatRange:
+      return doubleStats && doubleStats->getMinimum() &&
+          doubleStats->getMaximum() &&
+          filter.testFloat(doubleStats->getMinimum().value()) &&
+          filter.testFloat(doubleStats->getMaximum().value());
+    case common::FilterKind::kBytesRange:
+      return stringStats && stringStats->getMinimum() &&
+          stringStats->getMaximum() &&
+          filter.testBytes(
+              stringStats->getMinimum()->data(),
+              stringStats->getMinimum()->size()) &&
+          filter.testBytes(
+              stringStats->getMaximum()->data(),
+              stringStats->getMaximum()->size());
+    default:
+      return false;
+  }
+}
+
+// Returns the minimum or maximum of a column of 'type' from 'stats' or
+// std::nullopt if the statistics do not have it.
+std::optional<variant> minMaxFromStats(
+    const dwio::common::ColumnStatistics& stats,
+    const TypePtr& type,
+    bool isMin) {
+  auto* intStats =
+      dynamic_cast<const dwio::common::IntegerColumnStatistics*>(&stats);
+  auto* doubleStats =
+      dynamic_cast<const dwio::common::DoubleColumnStatistics*>(&stats);
+  auto* stringStats =
+      dynamic_cast<const dwio::common::StringColumnStatistics*>(&stats);
+  std::optional<int64_t> intValue;
+  if (intStats) {
+    intValue = isMin ? intStats->getMinimum() : intStats->getMaximum();
+  }
+  std::optional<double> doubleValue;
+  if (doubleStats) {
+    doubleValue = isMin ? doubleStats->getMinimum() : doubleStats->getMaximum();
+  }
+  switch (type->kind()) {
+    case TypeKind::TINYINT:
+      return intValue ? std::optional(variant(static_cast<int8_t>(*intValue)))
+                      : std::nullopt;
+    case TypeKind::SMALLINT:
+      return intValue ? std::optional(variant(static_cast<int16_t>(*intValue)))
+                      : std::nullopt;
+    case TypeKind::INTEGER:
+      return intValue ? std::optional(variant(static_cast<int32_t>(*intValue)))
+                      : std::nullopt;
+    case TypeKind::BIGINT:
+      return intValue ? std::optional(variant(*intValue)) : std::nullopt;
+    case TypeKind::REAL:
+      return doubleValue
+          ? std::optional(variant(static_cast<float>(*doubleValue)))
+          : std::nullopt;
+    case TypeKind::DOUBLE:
+      return doubleValue ? std::optional(variant(*doubleValue)) : std::nullopt;
+    case TypeKind::VARCHAR: {
+      if (!stringStats) {
+        return std::nullopt;
+      }
+      const auto& value =
+          isMin ? stringStats->getMinimum() : stringStats->getMaximum();
+      return value ? std::optional(variant(*value)) : std::nullopt;
+    }
+    default:
+      return std::nullopt;
+  }
+}
+
+// Updates 'result' with the minimum or maximum of the non-null 'rows' of
+// 'decoded'.
+template <TypeKind Kind>
+void updateMinMax(
+    const DecodedVector& decoded,
+    const SelectivityVector& rows,
+    bool isMin,
+    std::optional<variant>& result) {
+  using T = typename TypeTraits<Kind>::NativeType;
+  std::optional<T> best;
+  rows.applyToSelected([&](auto row) {
+    if (decoded.isNullAt(row)) {
+      return;
+    }
+    auto value = decoded.valueAt<T>(row);
+    if (!best.has_value() || (isMin ? value < *best : *best < value)) {
+      best = value;
+    }
+  });
+  if (!best.has_value()) {
+    return;
+  }
+  variant candidate;
+  if constexpr (std::is_same_v<T, StringView>) {
+    candidate = variant::create<Kind>(std::string(best->data(), best->size()));
+  } else {
+    candidate = variant::create<Kind>(*best);
+  }
+  if (!result.has_value() ||
+      (isMin ? candidate < *result : *result < candidate)) {
+    result = std::move(candidate);
+  }
+}
+
 } // namespace
 
 void HiveDataSource::addDynamicFilter(
     column_index_t outputChannel,
     const std::shared_ptr<common::Filter>& filter) {
+  VELOX_CHECK(
+      aggregates_.empty(),
+      "Dynamic filters do not apply to pushed down aggregates");
   auto& fieldSpec = scanSpec_->getChildByChannel(outputChannel);
   if (fieldSpec.filter()) {
     fieldSpec.setFilter(fieldSpec.filter()->mergeWith(filter.get()));
@@ -369,6 +856,7 @@ void HiveDataSource::addDynamicFilter(
     fieldSpec.setFilter(filter->clone());
   }
   scanSpec_->resetCachedValues();
+  dynamicFilters_.emplace_back(outputChannel, filter);
 }
 
 void HiveDataSource::addSplit(std::shared_ptr<ConnectorSplit> split) {
@@ -377,16 +865,18 @@ void HiveDataSource::addSplit(std::shared_ptr<ConnectorSplit> split) {
       "Previous split has not been processed yet. Call next to process the split.");
   split_ = std::dynamic_pointer_cast<HiveConnectorSplit>(split);
   VELOX_CHECK(split_, "Wrong type of split");
+  resetAggregates();
 
   VLOG(1) << "Adding split " << split_->toString();
 
   fileHandle_ = fileHandleFactory_->generate(split_->filePath);
+  // The file number also keys the process wide cache of parsed footers.
+  readerOpts_.setFileNum(fileHandle_->uuid.id());
   // For DataCache and no cache, the stream keeps track of IO.
   auto asyncCache = dynamic_cast<cache::AsyncDataCache*>(mappedMemory_);
   // Decide between AsyncDataCache, legacy DataCache and no cache. All
   // three are supported to enable comparison.
   if (asyncCache) {
-    readerOpts_.setFileNum(fileHandle_->uuid.id());
     bufferedInputFactory_ =
         std::make_unique<dwio::common::CachedBufferedInputFactory>(
             (asyncCache),
@@ -397,7 +887,8 @@ void HiveDataSource::addSplit(std::shared_ptr<ConnectorSplit> split) {
             },
             ioStats_,
             executor_,
-            readerOpts_);
+            readerOpts_,
+            cacheQuotaGroup_);
     readerOpts_.setBufferedInputFactory(bufferedInputFactory_);
   }
 
@@ -496,12 +987,47 @@ void HiveDataSource::addSplit(std::shared_ptr<ConnectorSplit> split) {
 
   rowReader_ = reader_->createRowReader(
       rowReaderOpts_.select(cs).range(split_->start, split_->length));
+  // Starts the IO for the first stripe. If this runs ahead of the scan
+  // for split preload, the IO overlaps with reading the previous split.
+  rowReader_->prefetchNextStripe();
+}
+
+void HiveDataSource::setFromDataSource(std::shared_ptr<DataSource> source) {
+  auto other = std::dynamic_pointer_cast<HiveDataSource>(source);
+  VELOX_CHECK(other, "Bad DataSource type");
+  VELOX_CHECK(
+      split_ == nullptr,
+      "Previous split has not been processed yet. Call next to process the split.");
+  for (auto& [channel, filter] : dynamicFilters_) {
+    other->addDynamicFilter(channel, filter);
+  }
+  if (other->rowReader_) {
+    other->rowReader_->resetFilterCaches();
+  }
+  VLOG(1) << "Adding preloaded split " << other->split_->toString();
+  split_ = std::move(other->split_);
+  fileHandle_ = std::move(other->fileHandle_);
+  emptySplit_ = other->emptySplit_;
+  // The row reader refers to the ScanSpec and reports IO to the stats of
+  // 'other'. These replace the ones of 'this'.
+  scanSpec_ = std::move(other->scanSpec_);
+  rowReaderOpts_.setScanSpec(scanSpec_);
+  other->ioStats_->merge(*ioStats_);
+  ioStats_ = std::move(other->ioStats_);
+  reader_ = std::move(other->reader_);
+  rowReader_ = std::move(other->rowReader_);
+  runtimeStats_.skippedSplits += other->runtimeStats_.skippedSplits;
+  runtimeStats_.skippedSplitBytes += other->runtimeStats_.skippedSplitBytes;
+  resetAggregates();
 }
 
 std::optional<RowVectorPtr> HiveDataSource::next(
     uint64_t size,
     velox::ContinueFuture& /*future*/) {
   VELOX_CHECK(split_ != nullptr, "No split to process. Call addSplit first.");
+  if (!aggregates_.empty()) {
+    return nextAggregates(size);
+  }
   if (emptySplit_) {
     resetSplit();
     return nullptr;
@@ -515,6 +1041,10 @@ std::optional<RowVectorPtr> HiveDataSource::next(
   // column, e.g. rand() < 0.1. Evaluate that conjunct first, then scan only
   // rows that passed.
 
+  if (readsToRowLimit()) {
+    size = std::min<uint64_t>(
+        size, std::max<int64_t>(1, *rowLimit_ - rowsReturned_));
+  }
   auto rowsScanned = rowReader_->next(size, output_);
   completedRows_ += rowsScanned;
 
@@ -548,6 +1078,7 @@ std::optional<RowVectorPtr> HiveDataSource::next(
       }
     }
 
+    rowsReturned_ += rowsRemaining;
     if (outputType_->size() == 0) {
       return exec::wrap(rowsRemaining, remainingIndices, rowVector);
     }
@@ -569,6 +1100,21 @@ std::optional<RowVectorPtr> HiveDataSource::next(
   return nullptr;
 }
 
+void HiveDataSource::setRowLimit(int64_t limit) {
+  VELOX_CHECK_NULL(split_, "setRowLimit must be called before addSplit");
+  rowLimit_ = limit;
+  if (readsToRowLimit()) {
+    // The first stripe has the rows to return. Reading the next one ahead
+    // would be wasted.
+    rowReaderOpts_.setStripeReadAheadBytes(0);
+  }
+}
+
+bool HiveDataSource::readsToRowLimit() const {
+  return rowLimit_.has_value() && aggregates_.empty() &&
+      !remainingFilterExprSet_ && !scanSpec_->hasFilter();
+}
+
 void HiveDataSource::resetSplit() {
   split_.reset();
   // Make sure to destroy Reader and RowReader in the opposite order of
@@ -577,6 +1123,185 @@ void HiveDataSource::resetSplit() {
   reader_.reset();
 }
 
+std::optional<RowVectorPtr> HiveDataSource::nextAggregates(uint64_t size) {
+  if (aggregateState_ == AggregateState::kStart) {
+    if (emptySplit_) {
+      aggregateState_ = AggregateState::kDone;
+    } else if (aggregateFromStats()) {
+      ++numSplitsAggregatedFromStats_;
+      aggregateState_ = AggregateState::kDone;
+    } else {
+      aggregateState_ = AggregateState::kReading;
+    }
+  }
+
+  if (aggregateState_ == AggregateState::kReading) {
+    if (!output_) {
+      output_ = BaseVector::create(readerOutputType_, 0, pool_);
+    }
+    auto rowsScanned = rowReader_->next(size, output_);
+    completedRows_ += rowsScanned;
+    if (rowsScanned) {
+      addToAggregates();
+      return RowVector::createEmpty(outputType_, pool_);
+    }
+    rowReader_->updateRuntimeStats(runtimeStats_);
+    aggregateState_ = AggregateState::kDone;
+  }
+
+  if (aggregateState_ == AggregateState::kDone) {
+    aggregateState_ = AggregateState::kReturned;
+    std::vector<VectorPtr> columns;
+    columns.reserve(aggregates_.size());
+    for (auto i = 0; i < aggregates_.size(); ++i) {
+      const auto& value = aggregateValues_[i];
+      columns.push_back(
+          value.has_value()
+              ? BaseVector::createConstant(*value, 1, pool_)
+              : BaseVector::createNullConstant(
+                    outputType_->childAt(i), 1, pool_));
+    }
+    return std::make_shared<RowVector>(
+        pool_, outputType_, BufferPtr(nullptr), 1, std::move(columns));
+  }
+
+  resetSplit();
+  return nullptr;
+}
+
+bool HiveDataSource::aggregateFromStats() {
+  // File statistics describe the whole file. The remaining filter can
+  // remove any row.
+  if (remainingFilterExprSet_ || split_->start > 0 ||
+      split_->length < fileHandle_->file->size()) {
+    return false;
+  }
+  auto numRows = reader_->numberOfRows();
+  if (!numRows.has_value()) {
+    return false;
+  }
+  const auto& fileType = reader_->rowType();
+  const auto& fileTypeWithId = reader_->typeWithId();
+  auto columnStats = [&](const std::string& name) {
+    return reader_->columnStatistics(fileTypeWithId->childByName(name)->id);
+  };
+
+  // Filters on partition keys and missing columns are constant. The reader
+  // does not apply them either.
+  for (const auto& child : scanSpec_->children()) {
+    if (!child->filter() || child->isConstant()) {
+      continue;
+    }
+    if (!fileType->containsChild(child->fieldName()) ||
+        !allRowsPass(
+            *child->filter(), *columnStats(child->fieldName()), *numRows)) {
+      return false;
+    }
+  }
+
+  std::vector<std::optional<variant>> values(aggregates_.size());
+  for (auto i = 0; i < aggregates_.size(); ++i) {
+    const bool isCount = aggregates_[i] == PushdownAggregate::kCount;
+    if (!aggregateInputs_[i].has_value()) {
+      values[i] = variant(static_cast<int64_t>(*numRows));
+      continue;
+    }
+    const auto& name = readerOutputType_->nameOf(*aggregateInputs_[i]);
+    if (!fileType->containsChild(name)) {
+      // Column is missing. All its values are null.
+      if (isCount) {
+        values[i] = variant(static_cast<int64_t>(0));
+      }
+      continue;
+    }
+    auto stats = columnStats(name);
+    auto numValues = stats->getNumberOfValues();
+    if (isCount) {
+      if (!numValues.has_value()) {
+        return false;
+      }
+      values[i] = variant(static_cast<int64_t>(*numValues));
+      continue;
+    }
+    if (numValues == 0) {
+      continue;
+    }
+    values[i] = minMaxFromStats(
+        *stats,
+        readerOutputType_->childAt(*aggregateInputs_[i]),
+        aggregates_[i] == PushdownAggregate::kMin);
+    if (!values[i].has_value()) {
+      return false;
+    }
+  }
+  aggregateValues_ = std::move(values);
+  return true;
+}
+
+void HiveDataSource::addToAggregates() {
+  auto rowVector = std::dynamic_pointer_cast<RowVector>(output_);
+  const auto numRows = rowVector->size();
+  if (numRows == 0) {
+    return;
+  }
+  SelectivityVector rows(numRows);
+  if (remainingFilterExprSet_) {
+    auto numPassed = evaluateRemainingFilter(rowVector);
+    if (numPassed == 0) {
+      return;
+    }
+    if (numPassed < numRows) {
+      rows.clearAll();
+      auto* indices = filterEvalCtx_.selectedIndices->as<vector_size_t>();
+      for (auto i = 0; i < numPassed; ++i) {
+        rows.setValid(indices[i], true);
+      }
+      rows.updateBounds();
+    }
+  }
+
+  DecodedVector decoded;
+  for (auto i = 0; i < aggregates_.size(); ++i) {
+    auto& value = aggregateValues_[i];
+    if (!aggregateInputs_[i].has_value()) {
+      value = variant(value->value<int64_t>() + rows.countSelected());
+      continue;
+    }
+    auto input = BaseVector::loadedVectorShared(
+        rowVector->childAt(*aggregateInputs_[i]));
+    decoded.decode(*input, rows);
+    switch (aggregates_[i]) {
+      case PushdownAggregate::kCount: {
+        int64_t count = 0;
+        rows.applyToSelected(
+            [&](auto row) { count += decoded.isNullAt(row) ? 0 : 1; });
+        value = variant(value->value<int64_t>() + count);
+        break;
+      }
+      case PushdownAggregate::kMin:
+      case PushdownAggregate::kMax:
+        VELOX_DYNAMIC_SCALAR_TYPE_DISPATCH(
+            updateMinMax,
+            input->typeKind(),
+            decoded,
+            rows,
+            aggregates_[i] == PushdownAggregate::kMin,
+            value);
+        break;
+    }
+  }
+}
+
+void HiveDataSource::resetAggregates() {
+  aggregateState_ = AggregateState::kStart;
+  aggregateValues_.assign(aggregates_.size(), std::nullopt);
+  for (auto i = 0; i < aggregates_.size(); ++i) {
+    if (aggregates_[i] == PushdownAggregate::kCount) {
+      aggregateValues_[i] = variant(static_cast<int64_t>(0));
+    }
+  }
+}
+
 vector_size_t HiveDataSource::evaluateRemainingFilter(RowVectorPtr& rowVector) {
   filterRows_.resize(output_->size());
 
@@ -629,7 +1354,36 @@ std::unordered_map<std::string, RuntimeCounter> HiveDataSource::runtimeStats() {
        {"numRamRead", RuntimeCounter(ioStats_->ramHit().count())},
        {"ramReadBytes",
         RuntimeCounter(
-            ioStats_->ramHit().bytes(), RuntimeCounter::Unit::kBytes)}});
+            ioStats_->ramHit().bytes(), RuntimeCounter::Unit::kBytes)},
+       {"backgroundDecompressionNanos",
+        RuntimeCounter(
+            ioStats_->backgroundDecompression().bytes() * 1'000,
+            RuntimeCounter::Unit::kNanos)},
+       {"queryThreadDecompressionWaitNanos",
+        RuntimeCounter(
+            ioStats_->queryThreadDecompressionLatency().bytes() * 1'000,
+            RuntimeCounter::Unit::kNanos)},
+       {"decryptionNanos",
+        RuntimeCounter(
+            ioStats_->decryption().bytes() * 1'000,
+            RuntimeCounter::Unit::kNanos)}});
+  if (!aggregates_.empty()) {
+    res.insert(
+        {"splitsAggregatedFromStats",
+         RuntimeCounter(numSplitsAggregatedFromStats_)});
+  }
+  return res;
+}
+
+std::unordered_map<std::string, RuntimeMetric>
+HiveDataSource::runtimeHistograms() {
+  std::unordered_map<std::string, RuntimeMetric> res;
+  auto ioLatency = ioStats_->queryThreadIoLatencyHistogram();
+  if (ioLatency.count() > 0) {
+    RuntimeMetric metric(RuntimeCounter::Unit::kNanos);
+    metric.addHistogram(ioLatency);
+    res.insert({"queryThreadIoWaitNanos", std::move(metric)});
+  }
   return res;
 }
 
@@ -15,8 +15,11 @@
  */
 #pragma once
 
+#include <folly/container/F14Map.h>
+
 #include "velox/connectors/hive/FileHandle.h"
 #include "velox/connectors/hive/HiveConnectorSplit.h"
+#include "velox/connectors/hive/HivePartitionFunction.h"
 #include "velox/dwio/common/CachedBufferedInput.h"
 #include "velox/dwio/common/IoStatistics.h"
 #include "velox/dwio/common/ScanSpec.h"
@@ -51,6 +54,8 @@ class HiveColumnHandle : public ColumnHandle {
     return dataType_;
   }
 
+  std::string toString() const override;
+
  private:
   const std::string name_;
   const ColumnType columnType_;
@@ -60,6 +65,14 @@ class HiveColumnHandle : public ColumnHandle {
 using SubfieldFilters =
     std::unordered_map<common::Subfield, std::unique_ptr<common::Filter>>;
 
+// An aggregate that a scan computes over the rows of each split that pass
+// the filters, instead of returning the rows. Output column i of the scan
+// is aggregate i over the column that its assignment names. A count
+// without an assignment is count(*). The scan returns one row of partial
+// results per split, which a final aggregation combines: counts are summed
+// and minimums and maximums are aggregated again.
+enum class PushdownAggregate { kCount, kMin, kMax };
+
 class HiveTableHandle : public ConnectorTableHandle {
  public:
   HiveTableHandle(
@@ -67,7 +80,8 @@ class HiveTableHandle : public ConnectorTableHandle {
       const std::string& tableName,
       bool filterPushdownEnabled,
       SubfieldFilters subfieldFilters,
-      const core::TypedExprPtr& remainingFilter);
+      const core::TypedExprPtr& remainingFilter,
+      std::vector<PushdownAggregate> aggregates = {});
 
   ~HiveTableHandle() override;
 
@@ -83,6 +97,10 @@ class HiveTableHandle : public ConnectorTableHandle {
     return remainingFilter_;
   }
 
+  const std::vector<PushdownAggregate>& aggregates() const {
+    return aggregates_;
+  }
+
   std::string toString() const override;
 
  private:
@@ -90,46 +108,149 @@ class HiveTableHandle : public ConnectorTableHandle {
   const bool filterPushdownEnabled_;
   const SubfieldFilters subfieldFilters_;
   const core::TypedExprPtr remainingFilter_;
+  const std::vector<PushdownAggregate> aggregates_;
 };
 
 /**
- * Represents a request for Hive write
+ * Represents a request for Hive write. An unpartitioned and unbucketed
+ * table is written to the file 'filePath'. Otherwise 'filePath' is a
+ * directory unique to the writer and each partition and bucket is written
+ * to its own file under it, e.g. <filePath>/ds=2022-10-01/bucket-00003.
+ * The partition columns are not stored in the files.
  */
 class HiveInsertTableHandle : public ConnectorInsertTableHandle {
  public:
-  explicit HiveInsertTableHandle(const std::string& filePath)
-      : filePath_(filePath) {}
+  explicit HiveInsertTableHandle(
+      const std::string& filePath,
+      std::vector<std::string> partitionedBy = {},
+      std::vector<std::string> bucketedBy = {},
+      int32_t bucketCount = 0)
+      : filePath_(filePath),
+        partitionedBy_(std::move(partitionedBy)),
+        bucketedBy_(std::move(bucketedBy)),
+        bucketCount_(bucketCount) {
+    VELOX_CHECK_EQ(
+        bucketedBy_.empty(),
+        bucketCount_ == 0,
+        "A bucketed table needs both bucket columns and a bucket count");
+  }
 
   const std::string& filePath() const {
     return filePath_;
   }
 
+  const std::vector<std::string>& partitionedBy() const {
+    return partitionedBy_;
+  }
+
+  const std::vector<std::string>& bucketedBy() const {
+    return bucketedBy_;
+  }
+
+  int32_t bucketCount() const {
+    return bucketCount_;
+  }
+
+  bool isPartitionedOrBucketed() const {
+    return !partitionedBy_.empty() || bucketCount_ > 0;
+  }
+
   virtual ~HiveInsertTableHandle() {}
 
  private:
   const std::string filePath_;
+  const std::vector<std::string> partitionedBy_;
+  const std::vector<std::string> bucketedBy_;
+  const int32_t bucketCount_;
 };
 
+// Writes the rows of a HiveInsertTableHandle. Rows of a partitioned or
+// bucketed table are routed to a DWRF writer per partition and bucket, so
+// that no repartitioning is needed before the write.
 class HiveDataSink : public DataSink {
  public:
-  explicit HiveDataSink(
+  // Connector session property for the maximum number of files that a sink
+  // of a partitioned or bucketed table may write. Exceeding it is an error.
+  static constexpr const char* kMaxOpenWriters = "max_open_writers";
+  static constexpr int32_t kDefaultMaxOpenWriters = 100;
+
+  // Connector session property for the memory in bytes of the open writers
+  // of a sink above which the writers using the most memory flush their
+  // stripes.
+  static constexpr const char* kWriterMemoryLimit = "writer_memory_limit";
+  static constexpr int64_t kDefaultWriterMemoryLimit = 512L << 20;
+
+  HiveDataSink(
       std::shared_ptr<const RowType> inputType,
-      const std::string& filePath,
-      velox::memory::MemoryPool* FOLLY_NONNULL memoryPool);
+      std::shared_ptr<const HiveInsertTableHandle> insertTableHandle,
+      const ConnectorQueryCtx* FOLLY_NONNULL connectorQueryCtx);
 
   void appendData(VectorPtr input) override;
 
   void close() override;
 
+  // Returns the paths of the files made so far.
+  const std::vector<std::string>& writtenFiles() const {
+    return writerPaths_;
+  }
+
+  // Returns the number of stripes flushed to stay within the writer memory
+  // limit.
+  int64_t numMemoryFlushes() const {
+    return numMemoryFlushes_;
+  }
+
  private:
+  std::unique_ptr<dwrf::Writer> makeWriter(const std::string& path);
+
+  // Returns the index in 'writers_' of the writer for the partition
+  // directory 'partitionDir' and 'bucket', making the writer if needed.
+  int32_t writerIndex(const std::string& partitionDir, int32_t bucket);
+
+  // Returns the partition directory of 'row', e.g. "ds=2022-10-01/hr=3/".
+  std::string partitionDirectory(vector_size_t row) const;
+
+  void appendPartitioned(const RowVectorPtr& input);
+
+  // Flushes the stripes of the writers that use the most memory until the
+  // writers are within 'writerMemoryLimit_'.
+  void flushLargestWriters();
+
   const std::shared_ptr<const RowType> inputType_;
-  std::unique_ptr<facebook::velox::dwrf::Writer> writer_;
+  const std::shared_ptr<const HiveInsertTableHandle> insertTableHandle_;
+  memory::MemoryPool* const pool_;
+  const int32_t maxOpenWriters_;
+  const int64_t writerMemoryLimit_;
+
+  // Channels of the partition columns in the input.
+  std::vector<column_index_t> partitionChannels_;
+  // Channels of the input columns stored in the files and their type.
+  std::vector<column_index_t> dataChannels_;
+  RowTypePtr dataType_;
+  std::unique_ptr<HivePartitionFunction> bucketFunction_;
+
+  std::vector<std::unique_ptr<dwrf::Writer>> writers_;
+  std::vector<std::string> writerPaths_;
+  // Maps the partition directory and bucket of a writer to its index.
+  folly::F14FastMap<std::string, int32_t> writerIndices_;
+  int64_t numMemoryFlushes_{0};
+
+  // Reusable memory for routing a batch.
+  std::vector<DecodedVector> decodedPartitionKeys_;
+  std::vector<uint32_t> buckets_;
+  // The index of the writer of each row.
+  std::vector<int32_t> rowWriters_;
+  std::vector<vector_size_t> writerRowCounts_;
 };
 
 class HiveConnector;
 
 class HiveDataSource : public DataSource {
  public:
+  // Number of Parquet row groups that are read and decoded ahead of the
+  // scan on the connector executor, if there is one.
+  static constexpr uint32_t kParquetRowGroupsAhead = 2;
+
   HiveDataSource(
       const std::shared_ptr<const RowType>& outputType,
       const std::shared_ptr<connector::ConnectorTableHandle>& tableHandle,
@@ -141,7 +262,8 @@ class HiveDataSource : public DataSource {
       ExpressionEvaluator* FOLLY_NONNULL expressionEvaluator,
       memory::MappedMemory* FOLLY_NONNULL mappedMemory,
       const std::string& scanId,
-      folly::Executor* FOLLY_NULLABLE executor);
+      folly::Executor* FOLLY_NULLABLE executor,
+      const std::string& cacheQuotaGroup = "");
 
   void addSplit(std::shared_ptr<ConnectorSplit> split) override;
 
@@ -162,9 +284,19 @@ class HiveDataSource : public DataSource {
 
   std::unordered_map<std::string, RuntimeCounter> runtimeStats() override;
 
+  std::unordered_map<std::string, RuntimeMetric> runtimeHistograms() override;
+
   int64_t estimatedRowSize() override;
 
+  void setFromDataSource(std::shared_ptr<DataSource> source) override;
+
+  void setRowLimit(int64_t limit) override;
+
  private:
+  // True if 'rowLimit_' bounds the rows to read, i.e. every row read is
+  // returned because there are no filters and no aggregates.
+  bool readsToRowLimit() const;
+
   // Evaluates remainingFilter_ on the specified vector. Returns number of rows
   // passed. Populates filterEvalCtx_.selectedIndices and selectedBits if only
   // some rows passed the filter. If none or all rows passed
@@ -187,6 +319,22 @@ class HiveDataSource : public DataSource {
   /// Clear split_, reader_ and rowReader_ after split has been fully processed.
   void resetSplit();
 
+  // next() when the scan computes 'aggregates_'. Reads the rows of the split
+  // unless the file statistics answer the aggregates and returns one row
+  // of results at the end of the split.
+  std::optional<RowVectorPtr> nextAggregates(uint64_t size);
+
+  // Sets 'aggregateValues_' from the file statistics if the split covers
+  // the file and the statistics show that all its rows pass the filters.
+  // Returns false if the rows must be read.
+  bool aggregateFromStats();
+
+  // Adds the rows of 'output_' that pass the remaining filter to
+  // 'aggregateValues_'.
+  void addToAggregates();
+
+  void resetAggregates();
+
   const std::shared_ptr<const RowType> outputType_;
   // Column handles for the partition key columns keyed on partition key column
   // name.
@@ -221,6 +369,32 @@ class HiveDataSource : public DataSource {
   memory::MappedMemory* const FOLLY_NONNULL mappedMemory_;
   const std::string& scanId_;
   folly::Executor* FOLLY_NULLABLE executor_;
+  // Quota group of 'mappedMemory_' if this is an AsyncDataCache.
+  int32_t cacheQuotaGroup_{0};
+  // Filters given to addDynamicFilter(), in arrival order. Applied to
+  // the DataSource given to setFromDataSource().
+  std::vector<std::pair<column_index_t, std::shared_ptr<common::Filter>>>
+      dynamicFilters_;
+
+  // Aggregates computed instead of returning rows. See PushdownAggregate.
+  std::vector<PushdownAggregate> aggregates_;
+
+  // The column of 'readerOutputType_' each of 'aggregates_' is over.
+  // std::nullopt for count(*).
+  std::vector<std::optional<column_index_t>> aggregateInputs_;
+
+  // Partial results of 'aggregates_' for the current split. std::nullopt
+  // is null.
+  std::vector<std::optional<variant>> aggregateValues_;
+
+  enum class AggregateState { kStart, kReading, kDone, kReturned };
+  AggregateState aggregateState_{AggregateState::kStart};
+
+  uint64_t numSplitsAggregatedFromStats_{0};
+
+  // See setRowLimit(). The rows returned so far count against it.
+  std::optional<int64_t> rowLimit_;
+  int64_t rowsReturned_{0};
 };
 
 class HiveConnector final : public Connector {
@@ -250,7 +424,8 @@ class HiveConnector final : public Connector {
         connectorQueryCtx->expressionEvaluator(),
         connectorQueryCtx->mappedMemory(),
         connectorQueryCtx->scanId(),
-        executor_);
+        executor_,
+        connectorQueryCtx->cacheQuotaGroup());
   }
 
   std::shared_ptr<DataSink> createDataSink(
@@ -263,12 +438,14 @@ class HiveConnector final : public Connector {
         hiveInsertHandle != nullptr,
         "Hive connector expecting hive write handle!");
     return std::make_shared<HiveDataSink>(
-        inputType,
-        hiveInsertHandle->filePath(),
-        connectorQueryCtx->memoryPool());
+        inputType, hiveInsertHandle, connectorQueryCtx);
+  }
+
+  bool supportsSplitPreload() override {
+    return true;
   }
 
-  folly::Executor* FOLLY_NULLABLE executor() {
+  folly::Executor* FOLLY_NULLABLE executor() const override {
     return executor_;
   }
 
@@ -29,6 +29,38 @@ void hashTyped(
       TypeTraits<kind>::name);
 }
 
+void hashPrecomputed(
+    uint32_t precomputedHash,
+    vector_size_t numRows,
+    bool mix,
+    std::vector<uint32_t>& hashes) {
+  for (auto i = 0; i < numRows; ++i) {
+    hashes[i] = mix ? hashes[i] * 31 + precomputedHash : precomputedHash;
+  }
+}
+
+// Sets 'hashes' to the hashes of 'size' values or, if 'mix' is true,
+// combines the hashes with the hashes of the previous columns. 'hashOne'
+// gives the hash of the value at an index. The loops have no branches, so
+// that the compiler can vectorize the multiply-accumulate.
+template <typename HashOne>
+void hashLoop(
+    vector_size_t size,
+    bool mix,
+    HashOne&& hashOne,
+    std::vector<uint32_t>& hashes) {
+  auto* rawHashes = hashes.data();
+  if (mix) {
+    for (auto i = 0; i < size; ++i) {
+      rawHashes[i] = rawHashes[i] * 31 + hashOne(i);
+    }
+  } else {
+    for (auto i = 0; i < size; ++i) {
+      rawHashes[i] = hashOne(i);
+    }
+  }
+}
+
 template <typename T, typename Func>
 void abstractHashTyped(
     const DecodedVector& values,
@@ -36,11 +68,56 @@ void abstractHashTyped(
     bool mix,
     Func&& hashOne,
     std::vector<uint32_t>& hashes) {
-  for (auto i = 0; i < size; ++i) {
+  if (values.isConstantMapping()) {
     const uint32_t hash =
-        (values.isNullAt(i)) ? 0 : hashOne(values.valueAt<T>(i));
-    hashes[i] = mix ? hashes[i] * 31 + hash : hash;
+        values.isNullAt(0) ? 0 : hashOne(values.valueAt<T>(0));
+    hashPrecomputed(hash, size, mix, hashes);
+    return;
+  }
+  // Booleans are bits, so there is no array of values to read.
+  if constexpr (!std::is_same_v<T, bool>) {
+    const auto* rawValues = values.data<T>();
+    if (values.isIdentityMapping() && !values.mayHaveNulls()) {
+      hashLoop(
+          size,
+          mix,
+          [&](vector_size_t i) -> uint32_t { return hashOne(rawValues[i]); },
+          hashes);
+      return;
+    }
+    const auto* base = values.base();
+    if (!values.isIdentityMapping() && base->size() < size) {
+      // A dictionary with fewer distinct values than rows. Hashes each
+      // distinct value once.
+      std::vector<uint32_t> baseHashes(base->size());
+      for (auto i = 0; i < base->size(); ++i) {
+        baseHashes[i] = base->isNullAt(i) ? 0 : hashOne(rawValues[i]);
+      }
+      if (!values.mayHaveNulls()) {
+        hashLoop(
+            size,
+            mix,
+            [&](vector_size_t i) { return baseHashes[values.index(i)]; },
+            hashes);
+        return;
+      }
+      hashLoop(
+          size,
+          mix,
+          [&](vector_size_t i) {
+            return values.isNullAt(i) ? 0 : baseHashes[values.index(i)];
+          },
+          hashes);
+      return;
+    }
   }
+  hashLoop(
+      size,
+      mix,
+      [&](vector_size_t i) -> uint32_t {
+        return values.isNullAt(i) ? 0 : hashOne(values.valueAt<T>(i));
+      },
+      hashes);
 }
 
 template <>
@@ -199,16 +276,6 @@ void hash(
 
   VELOX_DYNAMIC_TYPE_DISPATCH(hashTyped, typeKind, values, size, mix, hashes);
 }
-
-void hashPrecomputed(
-    uint32_t precomputedHash,
-    vector_size_t numRows,
-    bool mix,
-    std::vector<uint32_t>& hashes) {
-  for (auto i = 0; i < numRows; ++i) {
-    hashes[i] = mix ? hashes[i] * 31 + precomputedHash : precomputedHash;
-  }
-}
 } // namespace
 
 HivePartitionFunction::HivePartitionFunction(
@@ -235,10 +302,11 @@ void HivePartitionFunction::partition(
   const auto numRows = input.size();
 
   if (numRows > hashes_.size()) {
-    rows_.resize(numRows);
-    rows_.setAll();
     hashes_.resize(numRows);
   }
+  if (rows_.size() != numRows) {
+    rows_.resizeFill(numRows);
+  }
 
   partitions.resize(numRows);
   for (auto i = 0; i < keyChannels_.size(); ++i) {
@@ -14,10 +14,12 @@
  * limitations under the License.
  */
 #include "HdfsFileSystem.h"
+#include <folly/executors/IOThreadPoolExecutor.h>
 #include <hdfs/hdfs.h>
 #include "HdfsReadFile.h"
 #include "velox/common/file/FileSystems.h"
 #include "velox/core/Context.h"
+#include "velox/dwio/common/IoStatistics.h"
 
 namespace facebook::velox::filesystems {
 folly::once_flag hdfsInitiationFlag;
@@ -35,9 +37,25 @@ class HdfsFileSystem::Impl {
         hdfsClient_,
         "Unable to connect to HDFS, got error: {}.",
         hdfsGetLastError())
+
+    auto readThreads = config->get<int32_t>("hive.hdfs.read-threads", 16);
+    if (readThreads > 0) {
+      readExecutor_ = std::make_unique<folly::IOThreadPoolExecutor>(
+          readThreads, std::make_shared<folly::NamedThreadFactory>("HdfsRead"));
+      auto hedgePercentile =
+          config->get<double>("hive.hdfs.hedge-read-percentile", 95);
+      if (hedgePercentile > 0) {
+        hedging_ = std::make_unique<HdfsReadHedging>(
+            hedgePercentile,
+            config->get<uint64_t>("hive.hdfs.hedge-read-min-delay-ms", 10) *
+                1000);
+      }
+    }
   }
 
   ~Impl() {
+    // Reads in flight use the client.
+    readExecutor_.reset();
     LOG(INFO) << "Disconnecting HDFS file system";
     int disconnectResult = hdfsDisconnect(hdfsClient_);
     if (disconnectResult != 0) {
@@ -63,8 +81,32 @@ class HdfsFileSystem::Impl {
     return hdfsClient_;
   }
 
+  std::unique_ptr<HdfsReadFile> openFileForRead(std::string_view path) {
+    return std::make_unique<HdfsReadFile>(
+        hdfsClient_, path, readExecutor_.get(), hedging_.get(), &ioStats_);
+  }
+
+  HdfsReadHedging* hedging() const {
+    return hedging_.get();
+  }
+
+  dwio::common::IoStatistics& ioStats() {
+    return ioStats_;
+  }
+
  private:
   hdfsFS hdfsClient_;
+
+  // Runs preadvAsync() of the files. Not set if 'hive.hdfs.read-threads'
+  // is 0.
+  std::unique_ptr<folly::IOThreadPoolExecutor> readExecutor_;
+
+  // Not set if there is no 'readExecutor_' or if
+  // 'hive.hdfs.hedge-read-percentile' is 0.
+  std::unique_ptr<HdfsReadHedging> hedging_;
+
+  // Latencies of reads per datanode.
+  dwio::common::IoStatistics ioStats_;
 };
 
 HdfsFileSystem::HdfsFileSystem(const std::shared_ptr<const Config>& config)
@@ -85,7 +127,15 @@ std::unique_ptr<ReadFile> HdfsFileSystem::openFileForRead(
     path.remove_prefix(index);
   }
 
-  return std::make_unique<HdfsReadFile>(impl_->hdfsClient(), path);
+  return impl_->openFileForRead(path);
+}
+
+HdfsReadHedging* HdfsFileSystem::readHedging() const {
+  return impl_->hedging();
+}
+
+const dwio::common::IoStatistics& HdfsFileSystem::ioStats() const {
+  return impl_->ioStats();
 }
 
 std::unique_ptr<WriteFile> HdfsFileSystem::openFileForWrite(
@@ -15,6 +15,13 @@
  */
 #include "velox/common/file/FileSystems.h"
 
+namespace facebook::velox {
+class HdfsReadHedging;
+namespace dwio::common {
+class IoStatistics;
+}
+} // namespace facebook::velox
+
 namespace facebook::velox::filesystems {
 struct HdfsServiceEndpoint {
   std::string host;
@@ -27,6 +34,13 @@ struct HdfsServiceEndpoint {
  * or "hdfs-client.xml" in working directory.
  *
  * Internally you can use hdfsBuilderConfSetStr to configure the client
+ *
+ * preadvAsync() of the files runs on 'hive.hdfs.read-threads' threads
+ * (default 16, 0 for synchronous reads). A read that has not completed
+ * after 'hive.hdfs.hedge-read-percentile' (default 95, 0 disables) of the
+ * latencies of recent reads, and at least
+ * 'hive.hdfs.hedge-read-min-delay-ms' (default 10), is sent again and the
+ * first of the two to complete is used.
  */
 class HdfsFileSystem : public FileSystem {
  private:
@@ -45,6 +59,13 @@ class HdfsFileSystem : public FileSystem {
 
   static bool isHdfsFile(std::string_view filename);
 
+  // Returns the hedging policy of preadvAsync(), nullptr if reads are not
+  // hedged.
+  HdfsReadHedging* readHedging() const;
+
+  // Returns the latencies of the reads of the files per datanode.
+  const dwio::common::IoStatistics& ioStats() const;
+
  protected:
   class Impl;
   std::shared_ptr<Impl> impl_;
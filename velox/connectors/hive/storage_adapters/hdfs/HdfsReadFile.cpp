@@ -15,13 +15,157 @@
  */
 
 #include "HdfsReadFile.h"
+#include <folly/futures/Future.h>
 #include <folly/synchronization/CallOnce.h>
 #include <hdfs/hdfs.h>
+#include "velox/common/time/Timer.h"
+#include "velox/dwio/common/IoStatistics.h"
 
 namespace facebook::velox {
 
-HdfsReadFile::HdfsReadFile(hdfsFS hdfs, const std::string_view path)
-    : hdfsClient_(hdfs), filePath_(path) {
+namespace {
+// Reads 'length' bytes at 'offset' of 'path' into 'pos' through a stream
+// of its own. Uses no state of the HdfsReadFile, so that a hedged read
+// that loses may complete after the file is destroyed.
+void readRange(
+    hdfsFS hdfsClient,
+    const std::string& path,
+    uint64_t offset,
+    uint64_t length,
+    char* pos) {
+  auto file = hdfsOpenFile(hdfsClient, path.data(), O_RDONLY, 0, 0, 0);
+  VELOX_CHECK_NOT_NULL(
+      file, "Unable to open file {}. got error: {}", path, hdfsGetLastError());
+  auto seekStatus = hdfsSeek(hdfsClient, file, offset);
+  if (seekStatus != 0) {
+    hdfsCloseFile(hdfsClient, file);
+  }
+  VELOX_CHECK_EQ(
+      seekStatus,
+      0,
+      "Cannot seek through HDFS file: {}, error: {}",
+      path,
+      std::string(hdfsGetLastError()));
+  uint64_t totalBytesRead = 0;
+  while (totalBytesRead < length) {
+    auto bytesRead = hdfsRead(hdfsClient, file, pos, length - totalBytesRead);
+    if (bytesRead < 0) {
+      hdfsCloseFile(hdfsClient, file);
+    }
+    VELOX_CHECK(bytesRead >= 0, "Read failure in HDFSReadFile::preadInternal.")
+    totalBytesRead += bytesRead;
+    pos += bytesRead;
+  }
+
+  if (hdfsCloseFile(hdfsClient, file) == -1) {
+    LOG(ERROR) << "Unable to close file, errno: " << errno;
+  }
+}
+
+// Copies 'data', which starts at 'offset', into the data ranges of
+// 'buffers'.
+void scatter(
+    const std::string& data,
+    uint64_t offset,
+    const std::vector<folly::Range<char*>>& buffers) {
+  for (auto& range : buffers) {
+    if (range.data()) {
+      memcpy(range.data(), data.data() + offset, range.size());
+    }
+    offset += range.size();
+  }
+}
+
+// State shared by a read and its hedged read.
+struct HedgedRead {
+  HedgedRead(std::vector<folly::Range<char*>> buffers, uint64_t length)
+      : buffers(std::move(buffers)), length(length) {}
+
+  const std::vector<folly::Range<char*>> buffers;
+  const uint64_t length;
+
+  std::mutex mutex;
+  // True after 'promise' is fulfilled. 'buffers' may not be accessed after
+  // this.
+  bool done{false};
+  // Number of reads that have not completed.
+  int32_t numRunning{1};
+  folly::Promise<uint64_t> promise;
+};
+
+// Completes one of the reads of 'state'. The first read to succeed fills
+// the buffers. An error is returned only if all reads fail.
+void finishRead(
+    HedgedRead& state,
+    folly::Try<std::string>&& result,
+    bool isHedge,
+    HdfsReadHedging* hedging) {
+  std::unique_lock<std::mutex> l(state.mutex);
+  --state.numRunning;
+  if (state.done) {
+    return;
+  }
+  if (result.hasValue()) {
+    scatter(result.value(), 0, state.buffers);
+    state.done = true;
+    l.unlock();
+    if (isHedge && hedging) {
+      hedging->incrementHedgeWins();
+    }
+    state.promise.setValue(state.length);
+    return;
+  }
+  if (state.numRunning == 0) {
+    state.done = true;
+    l.unlock();
+    state.promise.setException(std::move(result.exception()));
+  }
+}
+} // namespace
+
+HdfsReadHedging::HdfsReadHedging(
+    double percentile,
+    uint64_t minDelayMicros,
+    int32_t windowSize)
+    : percentile_(percentile),
+      minDelayMicros_(minDelayMicros),
+      windowSize_(windowSize) {
+  VELOX_CHECK_GT(percentile_, 0);
+  VELOX_CHECK_LT(percentile_, 100);
+  VELOX_CHECK_GT(windowSize_, 0);
+  latencies_.reserve(windowSize_);
+}
+
+void HdfsReadHedging::recordLatency(uint64_t micros) {
+  std::lock_guard<std::mutex> l(mutex_);
+  if (latencies_.size() < static_cast<size_t>(windowSize_)) {
+    latencies_.push_back(micros);
+  } else {
+    latencies_[next_] = micros;
+    next_ = (next_ + 1) % windowSize_;
+  }
+  if (++numSinceUpdate_ < kUpdateInterval) {
+    return;
+  }
+  numSinceUpdate_ = 0;
+  auto sorted = latencies_;
+  auto nth =
+      sorted.begin() + static_cast<size_t>(sorted.size() * percentile_ / 100);
+  std::nth_element(sorted.begin(), nth, sorted.end());
+  hedgeDelayMicros_ = std::max(*nth, minDelayMicros_);
+}
+
+HdfsReadFile::HdfsReadFile(
+    hdfsFS hdfs,
+    const std::string_view path,
+    folly::Executor* executor,
+    HdfsReadHedging* hedging,
+    dwio::common::IoStatistics* ioStats)
+    : hdfsClient_(hdfs),
+      filePath_(path),
+      executor_(executor),
+      hedging_(hedging),
+      ioStats_(ioStats) {
   fileInfo_ = hdfsGetPathInfo(hdfsClient_, filePath_.data());
   VELOX_CHECK_NOT_NULL(
       fileInfo_,
@@ -33,34 +177,44 @@ HdfsReadFile::HdfsReadFile(hdfsFS hdfs, const std::string_view path)
 void HdfsReadFile::preadInternal(uint64_t offset, uint64_t length, char* pos)
     const {
   checkFileReadParameters(offset, length);
-  auto file = hdfsOpenFile(hdfsClient_, filePath_.data(), O_RDONLY, 0, 0, 0);
-  VELOX_CHECK_NOT_NULL(
-      file,
-      "Unable to open file {}. got error: {}",
-      filePath_,
-      hdfsGetLastError());
-  seekToPosition(file, offset);
-  uint64_t totalBytesRead = 0;
-  while (totalBytesRead < length) {
-    auto bytesRead = hdfsRead(hdfsClient_, file, pos, length - totalBytesRead);
-    VELOX_CHECK(bytesRead >= 0, "Read failure in HDFSReadFile::preadInternal.")
-    totalBytesRead += bytesRead;
-    pos += bytesRead;
+  if (!hedging_ && !ioStats_) {
+    readRange(hdfsClient_, filePath_, offset, length, pos);
+    return;
   }
-
-  if (hdfsCloseFile(hdfsClient_, file) == -1) {
-    LOG(ERROR) << "Unable to close file, errno: " << errno;
+  uint64_t micros = 0;
+  {
+    MicrosecondTimer timer(&micros);
+    readRange(hdfsClient_, filePath_, offset, length, pos);
+  }
+  if (hedging_) {
+    hedging_->recordLatency(micros);
+  }
+  if (ioStats_) {
+    ioStats_->incHostLatency(datanode(offset), micros);
   }
 }
 
-void HdfsReadFile::seekToPosition(hdfsFile file, uint64_t offset) const {
-  auto seekStatus = hdfsSeek(hdfsClient_, file, offset);
-  VELOX_CHECK_EQ(
-      seekStatus,
-      0,
-      "Cannot seek through HDFS file: {}, error: {}",
-      filePath_,
-      std::string(hdfsGetLastError()));
+const std::string& HdfsReadFile::datanode(uint64_t offset) const {
+  static const std::string kUnknown;
+  folly::call_once(blockHostsFlag_, [&]() {
+    auto hosts =
+        hdfsGetHosts(hdfsClient_, filePath_.data(), 0, fileInfo_->mSize);
+    if (!hosts) {
+      return;
+    }
+    for (auto block = hosts; *block; ++block) {
+      blockHosts_.emplace_back();
+      for (auto host = *block; *host; ++host) {
+        blockHosts_.back().push_back(*host);
+      }
+    }
+    hdfsFreeHosts(hosts);
+  });
+  auto block = fileInfo_->mBlockSize ? offset / fileInfo_->mBlockSize : 0;
+  if (block >= blockHosts_.size() || blockHosts_[block].empty()) {
+    return kUnknown;
+  }
+  return blockHosts_[block][0];
 }
 
 std::string_view
@@ -76,6 +230,90 @@ std::string HdfsReadFile::pread(uint64_t offset, uint64_t length) const {
   return result;
 }
 
+uint64_t HdfsReadFile::preadv(
+    uint64_t offset,
+    const std::vector<folly::Range<char*>>& buffers) const {
+  uint64_t length = 0;
+  for (auto& range : buffers) {
+    length += range.size();
+  }
+  if (buffers.size() == 1 && buffers[0].data()) {
+    preadInternal(offset, length, buffers[0].data());
+    return length;
+  }
+  std::string data(length, 0);
+  preadInternal(offset, length, data.data());
+  scatter(data, 0, buffers);
+  return length;
+}
+
+folly::SemiFuture<uint64_t> HdfsReadFile::preadvAsync(
+    uint64_t offset,
+    const std::vector<folly::Range<char*>>& buffers) const {
+  if (!executor_) {
+    return ReadFile::preadvAsync(offset, buffers);
+  }
+  uint64_t length = 0;
+  for (auto& range : buffers) {
+    length += range.size();
+  }
+  try {
+    checkFileReadParameters(offset, length);
+  } catch (const std::exception& e) {
+    return folly::makeSemiFuture<uint64_t>(e);
+  }
+  auto state = std::make_shared<HedgedRead>(buffers, length);
+  auto future = state->promise.getSemiFuture();
+  // The reads capture copies of what they use, since a losing read may
+  // outlive 'this'.
+  auto read = [hdfsClient = hdfsClient_,
+               path = filePath_,
+               hedging = hedging_,
+               ioStats = ioStats_,
+               host = ioStats_ ? datanode(offset) : std::string(),
+               state,
+               offset,
+               length](bool isHedge) {
+    auto result = folly::makeTryWith([&]() {
+      std::string data(length, 0);
+      uint64_t micros = 0;
+      {
+        MicrosecondTimer timer(&micros);
+        readRange(hdfsClient, path, offset, length, data.data());
+      }
+      if (hedging) {
+        hedging->recordLatency(micros);
+      }
+      if (ioStats && !isHedge) {
+        ioStats->incHostLatency(host, micros);
+      }
+      return data;
+    });
+    finishRead(*state, std::move(result), isHedge, hedging);
+  };
+  executor_->add([read]() { read(false); });
+
+  auto delayMicros = hedging_ ? hedging_->hedgeDelayMicros() : 0;
+  if (delayMicros > 0) {
+    // A second read through a new stream may be served by another
+    // replica. It is not started if the first read is done by then.
+    folly::futures::sleep(std::chrono::microseconds(delayMicros))
+        .via(executor_)
+        .thenValue([read, state, hedging = hedging_](auto&&) {
+          {
+            std::lock_guard<std::mutex> l(state->mutex);
+            if (state->done) {
+              return;
+            }
+            ++state->numRunning;
+          }
+          hedging->incrementHedged();
+          read(true);
+        });
+  }
+  return future;
+}
+
 uint64_t HdfsReadFile::size() const {
   return fileInfo_->mSize;
 }
@@ -14,20 +14,105 @@
  * limitations under the License.
  */
 
+#include <folly/Executor.h>
+#include <folly/synchronization/CallOnce.h>
 #include <hdfs/hdfs.h>
+#include <mutex>
 #include "velox/common/file/File.h"
 
 namespace facebook::velox {
 
+namespace dwio::common {
+class IoStatistics;
+}
+
+// Decides when a read of an HdfsReadFile is hedged, i.e. sent a second
+// time in case the datanode serving it is slow. A read is hedged when it
+// has not completed after 'percentile' of the latencies of recent reads,
+// but not before 'minDelayMicros'. Shared by the files of a file system.
+class HdfsReadHedging {
+ public:
+  HdfsReadHedging(
+      double percentile,
+      uint64_t minDelayMicros,
+      int32_t windowSize = 1024);
+
+  // Records the latency of a completed read.
+  void recordLatency(uint64_t micros);
+
+  // Returns the delay after which an outstanding read is hedged, 0 if
+  // there are not yet enough latencies to decide.
+  uint64_t hedgeDelayMicros() const {
+    return hedgeDelayMicros_;
+  }
+
+  uint64_t numHedged() const {
+    return numHedged_;
+  }
+
+  // Number of hedged reads that completed before the read they hedged.
+  uint64_t numHedgeWins() const {
+    return numHedgeWins_;
+  }
+
+  void incrementHedged() {
+    ++numHedged_;
+  }
+
+  void incrementHedgeWins() {
+    ++numHedgeWins_;
+  }
+
+ private:
+  // Number of latencies recorded between updates of 'hedgeDelayMicros_'.
+  static constexpr int32_t kUpdateInterval = 64;
+
+  const double percentile_;
+  const uint64_t minDelayMicros_;
+  const int32_t windowSize_;
+
+  std::mutex mutex_;
+  // Ring of the latest 'windowSize_' latencies.
+  std::vector<uint64_t> latencies_;
+  int32_t next_{0};
+  int32_t numSinceUpdate_{0};
+
+  std::atomic<uint64_t> hedgeDelayMicros_{0};
+  std::atomic<uint64_t> numHedged_{0};
+  std::atomic<uint64_t> numHedgeWins_{0};
+};
+
 class HdfsReadFile final : public ReadFile {
  public:
-  explicit HdfsReadFile(hdfsFS hdfs, std::string_view path);
+  // preadvAsync() runs on 'executor' if it is set and is then hedged
+  // according to 'hedging' if that is set. The latencies of reads are
+  // added to 'ioStats' per datanode if 'ioStats' is set.
+  explicit HdfsReadFile(
+      hdfsFS hdfs,
+      std::string_view path,
+      folly::Executor* executor = nullptr,
+      HdfsReadHedging* hedging = nullptr,
+      dwio::common::IoStatistics* ioStats = nullptr);
 
   std::string_view pread(uint64_t offset, uint64_t length, void* buf)
       const final;
 
   std::string pread(uint64_t offset, uint64_t length) const final;
 
+  uint64_t preadv(
+      uint64_t offset,
+      const std::vector<folly::Range<char*>>& buffers) const final;
+
+  // Reads the range covered by 'buffers' on the executor. If the read is
+  // hedged, the first of the two reads to complete fills 'buffers'.
+  folly::SemiFuture<uint64_t> preadvAsync(
+      uint64_t offset,
+      const std::vector<folly::Range<char*>>& buffers) const override;
+
+  bool hasPreadvAsync() const override {
+    return executor_ != nullptr;
+  }
+
   uint64_t size() const final;
 
   uint64_t memoryUsage() const final;
@@ -36,10 +121,21 @@ class HdfsReadFile final : public ReadFile {
 
  private:
   void preadInternal(uint64_t offset, uint64_t length, char* pos) const;
-  void seekToPosition(hdfsFile file, uint64_t offset) const;
+
+  // Returns the first datanode of the block containing 'offset', or an
+  // empty string if unknown.
+  const std::string& datanode(uint64_t offset) const;
+
   void checkFileReadParameters(uint64_t offset, uint64_t length) const;
   hdfsFS hdfsClient_;
   hdfsFileInfo* fileInfo_;
   std::string filePath_;
+  folly::Executor* const executor_;
+  HdfsReadHedging* const hedging_;
+  dwio::common::IoStatistics* const ioStats_;
+
+  // Hosts of each block, looked up on first use by datanode().
+  mutable folly::once_flag blockHostsFlag_;
+  mutable std::vector<std::vector<std::string>> blockHosts_;
 };
 } // namespace facebook::velox
@@ -16,6 +16,7 @@
 #include "velox/connectors/hive/storage_adapters/hdfs/HdfsFileSystem.h"
 #include <boost/format.hpp>
 #include <connectors/hive/storage_adapters/hdfs/HdfsReadFile.h>
+#include <folly/executors/IOThreadPoolExecutor.h>
 #include <gmock/gmock-matchers.h>
 #include <hdfs/hdfs.h>
 #include <atomic>
@@ -24,6 +25,7 @@
 #include "gtest/gtest.h"
 #include "velox/common/file/File.h"
 #include "velox/common/file/FileSystems.h"
+#include "velox/dwio/common/IoStatistics.h"
 #include "velox/exec/tests/utils/TempFilePath.h"
 
 using namespace facebook::velox;
@@ -350,6 +352,49 @@ TEST_F(HdfsFileSystemTest, multipleThreadsWithFileSystem) {
   }
 }
 
+TEST_F(HdfsFileSystemTest, preadvAsync) {
+  struct hdfsBuilder* builder = hdfsNewBuilder();
+  hdfsBuilderSetNameNode(builder, localhost.c_str());
+  hdfsBuilderSetNameNodePort(builder, stoi(hdfsPort));
+  auto hdfs = hdfsBuilderConnect(builder);
+  folly::IOThreadPoolExecutor executor(4);
+  // Hedges about half of the reads.
+  HdfsReadHedging hedging(50, 1, 64);
+  dwio::common::IoStatistics ioStats;
+  HdfsReadFile readFile(hdfs, destinationPath, &executor, &hedging, &ioStats);
+  ASSERT_TRUE(readFile.hasPreadvAsync());
+  EXPECT_EQ(hedging.hedgeDelayMicros(), 0);
+  for (auto i = 0; i < 64; ++i) {
+    readData(&readFile);
+  }
+  EXPECT_GT(hedging.hedgeDelayMicros(), 0);
+
+  std::string head(8, 0);
+  std::string middle(kOneMB - 8, 0);
+  std::string tail(10, 0);
+  for (auto i = 0; i < 20; ++i) {
+    std::vector<folly::Range<char*>> buffers = {
+        folly::Range<char*>(head.data(), head.size()),
+        folly::Range<char*>(nullptr, 2),
+        folly::Range<char*>(middle.data(), middle.size()),
+        folly::Range<char*>(tail.data(), tail.size())};
+    ASSERT_EQ(readFile.preadvAsync(0, buffers).get(), kOneMB + 12);
+    EXPECT_EQ(head, "aaaaabbb");
+    EXPECT_EQ(middle, std::string(kOneMB - 8, 'c'));
+    EXPECT_EQ(tail, "ccccccccdd");
+  }
+  EXPECT_LE(hedging.numHedgeWins(), hedging.numHedged());
+
+  auto hostStats = ioStats.hostLatencyStats();
+  ASSERT_EQ(hostStats.size(), 1);
+  EXPECT_GE(hostStats.begin()->second.count, 64 * 6 + 20);
+
+  std::vector<folly::Range<char*>> beyondEnd = {
+      folly::Range<char*>(tail.data(), tail.size())};
+  EXPECT_THROW(
+      readFile.preadvAsync(kOneMB + 10, beyondEnd).get(), VeloxException);
+}
+
 TEST_F(HdfsFileSystemTest, readFailures) {
   struct hdfsBuilder* builder = hdfsNewBuilder();
   hdfsBuilderSetNameNode(builder, localhost.c_str());
@@ -20,7 +20,11 @@
 #include "velox/core/Context.h"
 
 #include <fmt/format.h>
+#include <folly/executors/IOThreadPoolExecutor.h>
+#include <folly/executors/thread_factory/NamedThreadFactory.h>
+#include <folly/futures/Future.h>
 #include <glog/logging.h>
+#include <deque>
 #include <memory>
 #include <stdexcept>
 
@@ -31,8 +35,15 @@
 #include <aws/core/utils/stream/PreallocatedStreamBuf.h>
 #include <aws/identity-management/auth/STSAssumeRoleCredentialsProvider.h>
 #include <aws/s3/S3Client.h>
+#include <aws/s3/model/AbortMultipartUploadRequest.h>
+#include <aws/s3/model/CompleteMultipartUploadRequest.h>
+#include <aws/s3/model/CompletedMultipartUpload.h>
+#include <aws/s3/model/CompletedPart.h>
+#include <aws/s3/model/CreateMultipartUploadRequest.h>
 #include <aws/s3/model/GetObjectRequest.h>
 #include <aws/s3/model/HeadObjectRequest.h>
+#include <aws/s3/model/PutObjectRequest.h>
+#include <aws/s3/model/UploadPartRequest.h>
 
 namespace facebook::velox {
 namespace {
@@ -61,8 +72,20 @@ Aws::IOStreamFactory AwsWriteableStreamFactory(void* data, int64_t nbytes) {
 
 class S3ReadFile final : public ReadFile {
  public:
-  S3ReadFile(const std::string& path, Aws::S3::S3Client* client)
-      : client_(client) {
+  // If 'executor' is given, preadvAsync() reads with concurrent GETs
+  // of at most 'partSize' bytes on 'executor'. Data ranges separated
+  // by at most 'maxGap' bytes are then read by the same GET.
+  S3ReadFile(
+      const std::string& path,
+      Aws::S3::S3Client* client,
+      folly::Executor* executor = nullptr,
+      uint64_t partSize = 0,
+      uint64_t maxGap = 0)
+      : client_(client),
+        executor_(executor),
+        partSize_(partSize),
+        maxGap_(maxGap) {
+    VELOX_CHECK(!executor_ || partSize_ > 0);
     bucketAndKeyFromS3Path(path, bucket_, key_);
   }
 
@@ -124,6 +147,44 @@ class S3ReadFile final : public ReadFile {
     return length;
   }
 
+  // Unlike preadv(), which reads all of 'buffers' with a single GET,
+  // issues concurrent GETs for the data ranges and returns when all
+  // are done. S3 latency is per request, so parallel GETs of the parts
+  // of one large range are faster than a single GET.
+  folly::SemiFuture<uint64_t> preadvAsync(
+      uint64_t offset,
+      const std::vector<folly::Range<char*>>& buffers) const override {
+    if (!executor_) {
+      return ReadFile::preadvAsync(offset, buffers);
+    }
+    uint64_t length = 0;
+    auto parts = makeParts(offset, buffers, length);
+    auto sharedBuffers =
+        std::make_shared<const std::vector<folly::Range<char*>>>(buffers);
+    std::vector<folly::SemiFuture<folly::Unit>> futures;
+    futures.reserve(parts.size());
+    for (auto& part : parts) {
+      auto future =
+          folly::via(executor_, [this, offset, sharedBuffers, part]() {
+            readPart(offset, *sharedBuffers, part.first, part.second);
+          });
+      futures.push_back(std::move(future).semi());
+    }
+    return folly::collectAll(std::move(futures))
+        .deferValue([length](std::vector<folly::Try<folly::Unit>> results) {
+          // Errors are raised after all parts are done, so that no part
+          // writes into 'buffers' after the caller sees the error.
+          for (auto& result : results) {
+            result.throwIfFailed();
+          }
+          return length;
+        });
+  }
+
+  bool hasPreadvAsync() const override {
+    return executor_ != nullptr;
+  }
+
   uint64_t size() const override {
     return length_;
   }
@@ -157,11 +218,298 @@ class S3ReadFile final : public ReadFile {
     VELOX_CHECK_AWS_OUTCOME(outcome, "Failed to get S3 object", bucket_, key_);
   }
 
+  // Returns the [offset, length] of the GETs that read the data ranges
+  // of 'buffers' starting at 'offset'. Sets 'length' to the total size
+  // of 'buffers'.
+  std::vector<std::pair<uint64_t, uint64_t>> makeParts(
+      uint64_t offset,
+      const std::vector<folly::Range<char*>>& buffers,
+      uint64_t& length) const {
+    std::vector<std::pair<uint64_t, uint64_t>> reads;
+    auto position = offset;
+    for (auto& range : buffers) {
+      if (range.data()) {
+        if (!reads.empty() &&
+            position - (reads.back().first + reads.back().second) <=
+                maxGap_) {
+          reads.back().second = position + range.size() - reads.back().first;
+        } else {
+          reads.push_back({position, range.size()});
+        }
+      }
+      position += range.size();
+    }
+    length = position - offset;
+    std::vector<std::pair<uint64_t, uint64_t>> parts;
+    for (auto [readOffset, readLength] : reads) {
+      // Parts of one read are of about the same size.
+      auto numParts = (readLength + partSize_ - 1) / partSize_;
+      for (auto i = 0; i < numParts; ++i) {
+        auto begin = readOffset + readLength * i / numParts;
+        auto end = readOffset + readLength * (i + 1) / numParts;
+        parts.push_back({begin, end - begin});
+      }
+    }
+    return parts;
+  }
+
+  // Reads [partOffset, partOffset + partLength) into the data ranges of
+  // 'buffers', which start at 'offset'.
+  void readPart(
+      uint64_t offset,
+      const std::vector<folly::Range<char*>>& buffers,
+      uint64_t partOffset,
+      uint64_t partLength) const {
+    auto partEnd = partOffset + partLength;
+    auto position = offset;
+    for (auto& range : buffers) {
+      auto end = position + range.size();
+      if (range.data() && position <= partOffset && end >= partEnd) {
+        // One buffer covers the part.
+        preadInternal(
+            partOffset, partLength, range.data() + (partOffset - position));
+        return;
+      }
+      if (end >= partEnd) {
+        break;
+      }
+      position = end;
+    }
+    std::string scratch(partLength, 0);
+    preadInternal(partOffset, partLength, scratch.data());
+    position = offset;
+    for (auto& range : buffers) {
+      auto end = position + range.size();
+      if (range.data() && end > partOffset && position < partEnd) {
+        auto begin = std::max(position, partOffset);
+        memcpy(
+            range.data() + (begin - position),
+            scratch.data() + (begin - partOffset),
+            std::min(end, partEnd) - begin);
+      }
+      if (end >= partEnd) {
+        break;
+      }
+      position = end;
+    }
+  }
+
   Aws::S3::S3Client* client_;
+  folly::Executor* const executor_;
+  const uint64_t partSize_;
+  const uint64_t maxGap_;
   std::string bucket_;
   std::string key_;
   int64_t length_ = -1;
 };
+
+// Writes an S3 object with a multipart upload. Appends are buffered into
+// parts of 'partSize' bytes. Full parts are uploaded on 'executor' while
+// the writer continues, with at most 'maxPartsInFlight' parts pending, so
+// that a file holds at most 'maxPartsInFlight' + 1 parts in memory. An
+// object smaller than a part is written with a single PUT. The object
+// becomes visible on close(). Destroying an unclosed file aborts the
+// upload.
+class S3WriteFile final : public WriteFile {
+ public:
+  // S3 rejects smaller parts except for the last.
+  static constexpr uint64_t kMinPartSize = 5 << 20;
+
+  // Uploads synchronously if 'executor' is nullptr.
+  S3WriteFile(
+      const std::string& path,
+      Aws::S3::S3Client* client,
+      folly::Executor* executor,
+      uint64_t partSize,
+      int32_t maxPartsInFlight)
+      : client_(client),
+        executor_(executor),
+        partSize_(partSize),
+        maxPartsInFlight_(maxPartsInFlight) {
+    VELOX_USER_CHECK_GE(
+        partSize_, kMinPartSize, "S3 upload part size must be at least 5MB");
+    VELOX_USER_CHECK_GT(maxPartsInFlight_, 0);
+    bucketAndKeyFromS3Path(path, bucket_, key_);
+    current_.reserve(partSize_);
+  }
+
+  ~S3WriteFile() override {
+    if (!closed_) {
+      try {
+        abort();
+      } catch (const std::exception& e) {
+        LOG(WARNING) << "Failed to abort upload of " << s3URI(bucket_, key_)
+                     << ": " << e.what();
+      }
+    }
+  }
+
+  void append(std::string_view data) override {
+    VELOX_CHECK(!closed_, "Append to closed S3 file {}", s3URI(bucket_, key_));
+    size_ += data.size();
+    while (!data.empty()) {
+      auto bytes =
+          std::min<uint64_t>(data.size(), partSize_ - current_.size());
+      current_.append(data.data(), bytes);
+      data.remove_prefix(bytes);
+      if (current_.size() == partSize_) {
+        uploadPart();
+      }
+    }
+  }
+
+  // Waits for the parts being uploaded. A part that is not full stays
+  // buffered, since all parts but the last must be at least
+  // kMinPartSize.
+  void flush() override {
+    while (!inFlight_.empty()) {
+      waitForPart();
+    }
+  }
+
+  void close() override {
+    if (closed_) {
+      return;
+    }
+    if (uploadId_.empty()) {
+      putObject();
+    } else {
+      if (!current_.empty()) {
+        uploadPart();
+      }
+      flush();
+      completeUpload();
+    }
+    current_ = std::string();
+    closed_ = true;
+  }
+
+  uint64_t size() const override {
+    return size_;
+  }
+
+ private:
+  void createUpload() {
+    Aws::S3::Model::CreateMultipartUploadRequest request;
+    request.SetBucket(awsString(bucket_));
+    request.SetKey(awsString(key_));
+    auto outcome = client_->CreateMultipartUpload(request);
+    VELOX_CHECK_AWS_OUTCOME(
+        outcome, "Failed to start S3 multipart upload", bucket_, key_);
+    uploadId_ = outcome.GetResult().GetUploadId();
+  }
+
+  // Starts the upload of 'current_' as the next part. First waits for
+  // the oldest part if 'maxPartsInFlight_' parts are pending.
+  void uploadPart() {
+    if (uploadId_.empty()) {
+      createUpload();
+    }
+    if (inFlight_.size() >= maxPartsInFlight_) {
+      waitForPart();
+    }
+    auto data = std::make_shared<std::string>(std::move(current_));
+    current_ = std::string();
+    current_.reserve(partSize_);
+    // Does not reference 'this', which may be destroyed while the part
+    // is uploading if an error stops the writer.
+    auto upload = [client = client_,
+                   bucket = bucket_,
+                   key = key_,
+                   uploadId = uploadId_,
+                   partNumber = numParts_ + 1,
+                   data]() {
+      Aws::S3::Model::UploadPartRequest request;
+      request.SetBucket(awsString(bucket));
+      request.SetKey(awsString(key));
+      request.SetUploadId(uploadId);
+      request.SetPartNumber(partNumber);
+      request.SetContentLength(data->size());
+      request.SetBody(
+          std::make_shared<StringViewStream>(data->data(), data->size()));
+      auto outcome = client->UploadPart(request);
+      VELOX_CHECK_AWS_OUTCOME(
+          outcome, "Failed to upload S3 part", bucket, key);
+      return outcome.GetResult().GetETag();
+    };
+    ++numParts_;
+    if (executor_) {
+      inFlight_.push_back(folly::via(executor_, std::move(upload)).semi());
+    } else {
+      inFlight_.push_back(folly::makeSemiFutureWith(std::move(upload)));
+    }
+  }
+
+  // Waits for the oldest part in flight. Throws if it failed.
+  void waitForPart() {
+    auto future = std::move(inFlight_.front());
+    inFlight_.pop_front();
+    auto etag = std::move(future).get();
+    Aws::S3::Model::CompletedPart part;
+    part.SetPartNumber(completedParts_.size() + 1);
+    part.SetETag(etag);
+    completedParts_.push_back(std::move(part));
+  }
+
+  void completeUpload() {
+    Aws::S3::Model::CompletedMultipartUpload upload;
+    upload.SetParts(completedParts_);
+    Aws::S3::Model::CompleteMultipartUploadRequest request;
+    request.SetBucket(awsString(bucket_));
+    request.SetKey(awsString(key_));
+    request.SetUploadId(uploadId_);
+    request.SetMultipartUpload(std::move(upload));
+    auto outcome = client_->CompleteMultipartUpload(request);
+    VELOX_CHECK_AWS_OUTCOME(
+        outcome, "Failed to complete S3 multipart upload", bucket_, key_);
+  }
+
+  void putObject() {
+    Aws::S3::Model::PutObjectRequest request;
+    request.SetBucket(awsString(bucket_));
+    request.SetKey(awsString(key_));
+    request.SetContentLength(current_.size());
+    request.SetBody(
+        std::make_shared<StringViewStream>(current_.data(), current_.size()));
+    auto outcome = client_->PutObject(request);
+    VELOX_CHECK_AWS_OUTCOME(outcome, "Failed to put S3 object", bucket_, key_);
+  }
+
+  // Waits for the parts in flight, ignoring errors, and aborts the
+  // upload so that S3 drops the uploaded parts.
+  void abort() {
+    for (auto& future : inFlight_) {
+      future.wait();
+    }
+    inFlight_.clear();
+    if (uploadId_.empty()) {
+      return;
+    }
+    Aws::S3::Model::AbortMultipartUploadRequest request;
+    request.SetBucket(awsString(bucket_));
+    request.SetKey(awsString(key_));
+    request.SetUploadId(uploadId_);
+    auto outcome = client_->AbortMultipartUpload(request);
+    VELOX_CHECK_AWS_OUTCOME(
+        outcome, "Failed to abort S3 multipart upload", bucket_, key_);
+  }
+
+  Aws::S3::S3Client* const client_;
+  folly::Executor* const executor_;
+  const uint64_t partSize_;
+  const int32_t maxPartsInFlight_;
+  std::string bucket_;
+  std::string key_;
+  // Data appended after the last uploaded part.
+  std::string current_;
+  Aws::String uploadId_;
+  int32_t numParts_{0};
+  // ETags of the parts being uploaded, oldest first.
+  std::deque<folly::SemiFuture<Aws::String>> inFlight_;
+  std::vector<Aws::S3::Model::CompletedPart> completedParts_;
+  uint64_t size_{0};
+  bool closed_{false};
+};
 } // namespace
 
 namespace filesystems {
@@ -214,6 +562,51 @@ class S3Config {
         "hive.s3.iam-role-session-name", std::string("velox-session"));
   }
 
+  // Maximum number of open HTTP connections of the S3 client. Should be
+  // at least readThreads() plus the number of threads that call
+  // pread() or preadv().
+  int32_t maxConnections() const {
+    return config_->get<int32_t>("hive.s3.max-connections", 64);
+  }
+
+  // Size of the parts of the multipart upload of a written file. At
+  // least 5MB.
+  uint64_t writePartSize() const {
+    return config_->get<uint64_t>("hive.s3.write-part-size", 16 << 20);
+  }
+
+  // Maximum number of parts of a written file being uploaded while the
+  // writer continues. Bounds the memory of a file to this plus one
+  // parts.
+  int32_t writeMaxPartsInFlight() const {
+    return config_->get<int32_t>("hive.s3.write-max-parts-in-flight", 4);
+  }
+
+  // Number of threads uploading parts for all written files. 0 makes
+  // the uploads synchronous.
+  int32_t writeThreads() const {
+    return config_->get<int32_t>("hive.s3.write-threads", 16);
+  }
+
+  // Number of threads for the concurrent GETs of preadvAsync(). 0
+  // makes preadvAsync() synchronous.
+  int32_t readThreads() const {
+    return config_->get<int32_t>("hive.s3.read-threads", 32);
+  }
+
+  // Maximum size of one GET of preadvAsync(). Larger ranges are split
+  // into parts that are read in parallel.
+  uint64_t readPartSize() const {
+    return config_->get<uint64_t>("hive.s3.read-part-size", 8 << 20);
+  }
+
+  // Maximum distance between two ranges read with one GET by
+  // preadvAsync(). S3 charges per request and a GET costs 50-100ms of
+  // latency, during which about this much could be transferred.
+  uint64_t readMaxGap() const {
+    return config_->get<uint64_t>("hive.s3.read-max-gap", 1 << 20);
+  }
+
  private:
   const Config* FOLLY_NONNULL config_;
 };
@@ -230,6 +623,10 @@ class S3FileSystem::Impl {
   }
 
   ~Impl() {
+    // Pending reads use the client, so they must finish before the
+    // SDK shuts down.
+    readExecutor_.reset();
+    writeExecutor_.reset();
     const size_t newCount = --initCounter_;
     if (newCount == 0) {
       Aws::SDKOptions awsOptions;
@@ -306,6 +703,7 @@ class S3FileSystem::Impl {
     Aws::Client::ClientConfiguration clientConfig;
 
     clientConfig.endpointOverride = s3Config_.endpoint();
+    clientConfig.maxConnections = s3Config_.maxConnections();
 
     if (s3Config_.useSSL()) {
       clientConfig.scheme = Aws::Http::Scheme::HTTPS;
@@ -320,6 +718,40 @@ class S3FileSystem::Impl {
         clientConfig,
         Aws::Client::AWSAuthV4Signer::PayloadSigningPolicy::Never,
         s3Config_.useVirtualAddressing());
+
+    if (s3Config_.readThreads() > 0) {
+      readExecutor_ = std::make_unique<folly::IOThreadPoolExecutor>(
+          s3Config_.readThreads(),
+          std::make_shared<folly::NamedThreadFactory>("S3Read"));
+    }
+    if (s3Config_.writeThreads() > 0) {
+      writeExecutor_ = std::make_unique<folly::IOThreadPoolExecutor>(
+          s3Config_.writeThreads(),
+          std::make_shared<folly::NamedThreadFactory>("S3Write"));
+    }
+  }
+
+  // Makes a file that reads with concurrent GETs if there are read
+  // threads.
+  std::unique_ptr<S3ReadFile> openFileForRead(const std::string& path) const {
+    if (!readExecutor_) {
+      return std::make_unique<S3ReadFile>(path, client_.get());
+    }
+    return std::make_unique<S3ReadFile>(
+        path,
+        client_.get(),
+        readExecutor_.get(),
+        s3Config_.readPartSize(),
+        s3Config_.readMaxGap());
+  }
+
+  std::unique_ptr<WriteFile> openFileForWrite(const std::string& path) const {
+    return std::make_unique<S3WriteFile>(
+        path,
+        client_.get(),
+        writeExecutor_.get(),
+        s3Config_.writePartSize(),
+        s3Config_.writeMaxPartsInFlight());
   }
 
   // Make it clear that the S3FileSystem instance owns the S3Client.
@@ -332,6 +764,12 @@ class S3FileSystem::Impl {
  private:
   const S3Config s3Config_;
   std::shared_ptr<Aws::S3::S3Client> client_;
+  // Runs the GETs of preadvAsync(). nullptr if there are no read
+  // threads.
+  std::unique_ptr<folly::IOThreadPoolExecutor> readExecutor_;
+  // Uploads the parts of written files. nullptr if there are no write
+  // threads.
+  std::unique_ptr<folly::IOThreadPoolExecutor> writeExecutor_;
   static std::atomic<size_t> initCounter_;
 };
 
@@ -349,14 +787,14 @@ void S3FileSystem::initializeClient() {
 
 std::unique_ptr<ReadFile> S3FileSystem::openFileForRead(std::string_view path) {
   const std::string file = s3Path(path);
-  auto s3file = std::make_unique<S3ReadFile>(file, impl_->s3Client());
+  auto s3file = impl_->openFileForRead(file);
   s3file->initialize();
   return s3file;
 }
 
 std::unique_ptr<WriteFile> S3FileSystem::openFileForWrite(
     std::string_view path) {
-  VELOX_NYI();
+  return impl_->openFileForWrite(s3Path(path));
 }
 
 std::string S3FileSystem::name() const {
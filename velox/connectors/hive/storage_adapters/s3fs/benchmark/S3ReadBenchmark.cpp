@@ -20,6 +20,11 @@
 #include <fstream>
 
 DEFINE_string(s3_config, "", "Path of S3 config file");
+DEFINE_int32(
+    max_concurrency,
+    64,
+    "Maximum number of preadvAsync calls in flight when measuring "
+    "throughput vs. concurrency");
 
 namespace facebook::velox {
 
@@ -18,6 +18,7 @@
 #include "velox/connectors/hive/storage_adapters/s3fs/S3FileSystem.h"
 
 DECLARE_string(s3_config);
+DECLARE_int32(max_concurrency);
 
 namespace facebook::velox {
 
@@ -52,6 +53,84 @@ class S3ReadBenchmark : public ReadBenchmark {
       rng_.seed(FLAGS_seed);
     }
   }
+
+  // Measures the throughput of preadvAsync() with 'concurrency' reads
+  // in flight. Each read is 'count' ranges of 'size' bytes separated by
+  // 'gap' bytes.
+  void
+  asyncReads(int32_t size, int32_t gap, int32_t count, int32_t concurrency) {
+    int32_t rangeSize = size * count + gap * (count - 1);
+    int32_t repeats = std::max<int32_t>(
+        concurrency, FLAGS_measurement_size / (size * count));
+    std::vector<std::string> buffers(concurrency);
+    for (auto& buffer : buffers) {
+      buffer.resize(rangeSize);
+    }
+    std::vector<folly::SemiFuture<uint64_t>> futures;
+    uint64_t usec = 0;
+    {
+      MicrosecondTimer timer(&usec);
+      for (auto repeat = 0; repeat < repeats; ++repeat) {
+        auto slot = repeat % concurrency;
+        if (futures.size() == concurrency) {
+          // Waits for the read that last used 'slot'.
+          std::move(futures[slot]).get();
+        }
+        std::vector<folly::Range<char*>> ranges;
+        for (auto start = 0; start < rangeSize; start += size + gap) {
+          ranges.push_back(
+              folly::Range<char*>(buffers[slot].data() + start, size));
+          if (gap && start + size < rangeSize) {
+            ranges.push_back(folly::Range<char*>(nullptr, gap));
+          }
+        }
+        int64_t offset =
+            folly::Random::rand64(rng_) % (fileSize_ - rangeSize);
+        auto future = readFile_->preadvAsync(offset, ranges);
+        if (futures.size() < concurrency) {
+          futures.push_back(std::move(future));
+        } else {
+          futures[slot] = std::move(future);
+        }
+      }
+      for (auto& future : futures) {
+        if (future.valid()) {
+          std::move(future).get();
+        }
+      }
+    }
+    std::cout << fmt::format(
+                     "{} MB/s preadvAsync concurrency {}",
+                     (static_cast<float>(count) * size * repeats) / usec,
+                     concurrency)
+              << std::endl;
+  }
+
+  // Measures the throughput of preadvAsync() with 1 to
+  // --max_concurrency reads in flight.
+  void concurrency(int32_t size, int32_t gap, int32_t count) {
+    std::cout << fmt::format(
+                     "Async run: {} Gap: {} Count: {}", size, gap, count)
+              << std::endl;
+    for (auto concurrency = 1; concurrency <= FLAGS_max_concurrency;
+         concurrency *= 2) {
+      asyncReads(size, gap, count, concurrency);
+    }
+  }
+
+  void runConcurrency() {
+    if (!readFile_->hasPreadvAsync()) {
+      LOG(INFO) << "preadvAsync is not asynchronous, set hive.s3.read-threads";
+      return;
+    }
+    if (FLAGS_bytes) {
+      concurrency(FLAGS_bytes, FLAGS_gap, FLAGS_num_in_run);
+      return;
+    }
+    concurrency(1000000, 0, 8);
+    concurrency(1000000, 100000, 8);
+    concurrency(16 << 20, 0, 1);
+  }
 };
 
 } // namespace facebook::velox
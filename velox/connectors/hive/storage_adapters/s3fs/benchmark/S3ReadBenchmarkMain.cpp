@@ -28,4 +28,5 @@ int main(int argc, char** argv) {
   S3ReadBenchmark bm;
   bm.initialize();
   bm.run();
+  bm.runConcurrency();
 }
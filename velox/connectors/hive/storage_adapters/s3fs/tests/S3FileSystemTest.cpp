@@ -152,6 +152,97 @@ TEST_F(S3FileSystemTest, fileHandle) {
   readData(fileHandle->file.get());
 }
 
+TEST_F(S3FileSystemTest, preadvAsync) {
+  const char* bucketName = "data4";
+  const char* file = "test.txt";
+  const std::string filename = localPath(bucketName) + "/" + file;
+  const std::string s3File = s3URI(bucketName, file);
+  addBucket(bucketName);
+  std::string data(3 * kOneMB, 0);
+  for (auto i = 0; i < data.size(); ++i) {
+    data[i] = 'a' + i % 26;
+  }
+  {
+    LocalWriteFile writeFile(filename);
+    writeFile.append(data);
+  }
+  // Small parts, so that each range is read by several GETs.
+  auto hiveConfig = minioServer_->hiveConfig(
+      {{"hive.s3.read-part-size", "100000"},
+       {"hive.s3.read-max-gap", "1000"}});
+  filesystems::S3FileSystem s3fs(hiveConfig);
+  s3fs.initializeClient();
+  auto readFile = s3fs.openFileForRead(s3File);
+  ASSERT_TRUE(readFile->hasPreadvAsync());
+  std::string head(kOneMB, 0);
+  std::string middle(10, 0);
+  std::string tail(500, 0);
+  std::string last(kOneMB, 0);
+  std::vector<folly::Range<char*>> buffers = {
+      folly::Range<char*>(head.data(), head.size()),
+      // Read through by the GET of 'head'.
+      folly::Range<char*>(nullptr, (char*)(uint64_t)500),
+      folly::Range<char*>(middle.data(), middle.size()),
+      // Skipped.
+      folly::Range<char*>(nullptr, (char*)(uint64_t)200000),
+      folly::Range<char*>(tail.data(), tail.size()),
+      folly::Range<char*>(last.data(), last.size())};
+  const uint64_t offset = 1000;
+  auto length = readFile->preadvAsync(offset, buffers).get();
+  ASSERT_EQ(2 * kOneMB + 500 + 10 + 200000 + 500, length);
+  uint64_t position = offset;
+  for (auto& range : buffers) {
+    if (range.data()) {
+      ASSERT_EQ(
+          data.substr(position, range.size()),
+          std::string(range.data(), range.size()));
+    }
+    position += range.size();
+  }
+}
+
+TEST_F(S3FileSystemTest, write) {
+  const char* bucketName = "data5";
+  addBucket(bucketName);
+  // Minimum part size and 2 parts in flight.
+  auto hiveConfig = minioServer_->hiveConfig(
+      {{"hive.s3.write-part-size", std::to_string(5 * kOneMB)},
+       {"hive.s3.write-max-parts-in-flight", "2"}});
+  filesystems::S3FileSystem s3fs(hiveConfig);
+  s3fs.initializeClient();
+
+  // Large enough for a multipart upload with a short last part.
+  const std::string s3File = s3URI(bucketName, "large.txt");
+  std::string data(17 * kOneMB, 0);
+  for (auto i = 0; i < data.size(); ++i) {
+    data[i] = 'a' + i % 26;
+  }
+  auto writeFile = s3fs.openFileForWrite(s3File);
+  for (auto offset = 0; offset < data.size(); offset += 100000) {
+    writeFile->append(std::string_view(data).substr(offset, 100000));
+  }
+  ASSERT_EQ(data.size(), writeFile->size());
+  writeFile->close();
+  auto readFile = s3fs.openFileForRead(s3File);
+  ASSERT_EQ(data.size(), readFile->size());
+  ASSERT_EQ(data, readFile->pread(0, data.size()));
+
+  // Smaller than a part, written with one PUT.
+  const std::string smallFile = s3URI(bucketName, "small.txt");
+  writeFile = s3fs.openFileForWrite(smallFile);
+  writeData(writeFile.get());
+  writeFile->close();
+  readFile = s3fs.openFileForRead(smallFile);
+  readData(readFile.get());
+
+  // An unclosed file is not visible.
+  const std::string abortedFile = s3URI(bucketName, "aborted.txt");
+  writeFile = s3fs.openFileForWrite(abortedFile);
+  writeFile->append(std::string_view(data).substr(0, 11 * kOneMB));
+  writeFile.reset();
+  ASSERT_THROW(s3fs.openFileForRead(abortedFile), VeloxException);
+}
+
 TEST_F(S3FileSystemTest, invalidCredentialsConfig) {
   {
     const std::unordered_map<std::string, std::string> config(
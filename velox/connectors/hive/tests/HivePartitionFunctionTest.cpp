@@ -264,3 +264,46 @@ TEST_F(HivePartitionFunctionTest, date) {
   assertPartitionsWithConstChannel(values, 500);
   assertPartitionsWithConstChannel(values, 997);
 }
+
+TEST_F(HivePartitionFunctionTest, encodings) {
+  // 1000 rows over 10 distinct values, half of them null at the dictionary
+  // level.
+  auto base = vm_.flatVectorNullable<std::string>(
+      {"a", "bb", std::nullopt, "dddd", "eeeee", "f", "g", "h", "i", "j"});
+  auto ints = vm_.flatVector<int64_t>(10, [](auto row) { return row * 1001; });
+  constexpr vector_size_t kSize = 1'000;
+  auto indices = AlignedBuffer::allocate<vector_size_t>(kSize, pool_.get());
+  auto nulls = AlignedBuffer::allocate<bool>(kSize, pool_.get());
+  auto* rawIndices = indices->asMutable<vector_size_t>();
+  auto* rawNulls = nulls->asMutable<uint64_t>();
+  for (auto i = 0; i < kSize; ++i) {
+    rawIndices[i] = (i * 7) % 10;
+    bits::setNull(rawNulls, i, i % 2 == 0);
+  }
+  auto strings = BaseVector::wrapInDictionary(nulls, indices, kSize, base);
+  auto bigints = BaseVector::wrapInDictionary(nullptr, indices, kSize, ints);
+  auto constant = BaseVector::wrapInConstant(kSize, 3, base);
+
+  // The encoded and flat inputs land in the same partitions.
+  auto partitions = [&](const std::vector<VectorPtr>& columns) {
+    auto input = vm_.rowVector(columns);
+    std::vector<int> bucketToPartition(100);
+    std::iota(bucketToPartition.begin(), bucketToPartition.end(), 0);
+    connector::hive::HivePartitionFunction function(
+        100, bucketToPartition, {0, 1, 2});
+    std::vector<uint32_t> result;
+    function.partition(*input, result);
+    return result;
+  };
+  auto flatten = [&](const VectorPtr& vector) {
+    auto flat = BaseVector::create(vector->type(), kSize, pool_.get());
+    flat->copy(vector.get(), 0, 0, kSize);
+    return flat;
+  };
+  EXPECT_EQ(
+      partitions({flatten(strings), flatten(bigints), flatten(constant)}),
+      partitions({strings, bigints, constant}));
+  EXPECT_EQ(
+      partitions({flatten(bigints), flatten(strings), flatten(bigints)}),
+      partitions({bigints, strings, bigints}));
+}
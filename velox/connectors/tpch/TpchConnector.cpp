@@ -71,7 +71,7 @@ TpchDataSource::TpchDataSource(
       tpchTableHandle, "TableHandle must be an instance of TpchTableHandle");
   tpchTable_ = tpchTableHandle->getTable();
   scaleFactor_ = tpchTableHandle->getScaleFactor();
-  tpchTableRowCount_ = getRowCount(tpchTable_, scaleFactor_);
+  generatorRowCount_ = getGeneratorRowCount(tpchTable_, scaleFactor_);
 
   auto tpchTableSchema = getTableSchema(tpchTableHandle->getTable());
   VELOX_CHECK_NOT_NULL(tpchTableSchema, "TpchSchema can't be null.");
@@ -129,11 +129,12 @@ void TpchDataSource::addSplit(std::shared_ptr<ConnectorSplit> split) {
   currentSplit_ = std::dynamic_pointer_cast<TpchConnectorSplit>(split);
   VELOX_CHECK(currentSplit_, "Wrong type of split for TpchDataSource.");
 
-  size_t partSize =
-      std::ceil((double)tpchTableRowCount_ / (double)currentSplit_->totalParts);
+  const size_t totalParts = currentSplit_->totalParts;
+  const size_t partSize = (generatorRowCount_ + totalParts - 1) / totalParts;
 
-  splitOffset_ = partSize * currentSplit_->partNumber;
-  splitEnd_ = splitOffset_ + partSize;
+  splitOffset_ =
+      std::min(generatorRowCount_, partSize * currentSplit_->partNumber);
+  splitEnd_ = std::min(generatorRowCount_, splitOffset_ + partSize);
 }
 
 std::optional<RowVectorPtr> TpchDataSource::next(
@@ -142,6 +143,10 @@ std::optional<RowVectorPtr> TpchDataSource::next(
   VELOX_CHECK_NOT_NULL(
       currentSplit_, "No split to process. Call addSplit() first.");
 
+  // Lineitem is generated by order, with 4 lines per order on average.
+  if (tpchTable_ == Table::TBL_LINEITEM) {
+    size = std::max<uint64_t>(1, size / 4);
+  }
   size_t maxRows = std::min(size, (splitEnd_ - splitOffset_));
   auto outputVector =
       getTpchData(tpchTable_, maxRows, splitOffset_, scaleFactor_, pool_);
@@ -33,6 +33,10 @@ class TpchColumnHandle : public ColumnHandle {
     return name_;
   }
 
+  std::string toString() const override {
+    return name_;
+  }
+
  private:
   const std::string name_;
 };
@@ -104,7 +108,8 @@ class TpchDataSource : public DataSource {
 
   velox::tpch::Table tpchTable_;
   size_t scaleFactor_{1};
-  size_t tpchTableRowCount_{0};
+  // The rows the splits divide into parts. These are orders for lineitem.
+  size_t generatorRowCount_{0};
   RowTypePtr outputType_;
 
   // Mapping between output columns and their indices (column_index_t) in the
@@ -114,7 +119,7 @@ class TpchDataSource : public DataSource {
   std::shared_ptr<TpchConnectorSplit> currentSplit_;
 
   // First (splitOffset_) and last (splitEnd_) row number that should be
-  // generated by this split.
+  // generated by this split. For lineitem these are order numbers.
   uint64_t splitOffset_{0};
   uint64_t splitEnd_{0};
 
@@ -211,6 +211,25 @@ TEST_F(TpchConnectorTest, multipleSplits) {
   }
 }
 
+// Lineitem is generated by order, so its splits divide the orders. Every
+// part reads a distinct range of orders.
+TEST_F(TpchConnectorTest, lineItemSplits) {
+  auto plan = PlanBuilder()
+                  .tableScan(Table::TBL_LINEITEM, {"l_orderkey"})
+                  .limit(0, 1, false)
+                  .planNode();
+
+  constexpr size_t kTotalParts = 4;
+  int64_t previousOrderKey = 0;
+  for (size_t i = 0; i < kTotalParts; ++i) {
+    auto output = getResults(plan, {makeTpchSplit(kTotalParts, i)});
+    ASSERT_EQ(1, output->size());
+    auto orderKey = output->childAt(0)->asFlatVector<int64_t>()->valueAt(0);
+    EXPECT_LT(previousOrderKey, orderKey);
+    previousOrderKey = orderKey;
+  }
+}
+
 // Join nation and region.
 TEST_F(TpchConnectorTest, join) {
   auto planNodeIdGenerator =
@@ -330,10 +330,14 @@ class ConcatTypedExpr : public ITypedExpr {
   }
 
   bool operator==(const ITypedExpr& other) const override {
-    const auto* casted = dynamic_cast<const FieldAccessTypedExpr*>(&other);
+    const auto* casted = dynamic_cast<const ConcatTypedExpr*>(&other);
     if (!casted) {
       return false;
     }
+    // The field names are part of the type.
+    if (*casted->type() != *this->type()) {
+      return false;
+    }
     return std::equal(
         this->inputs().begin(),
         this->inputs().end(),
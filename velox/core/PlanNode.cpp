@@ -62,6 +62,7 @@ AggregationNode::AggregationNode(
     const std::vector<std::string>& aggregateNames,
     const std::vector<CallTypedExprPtr>& aggregates,
     const std::vector<FieldAccessTypedExprPtr>& aggregateMasks,
+    const std::vector<bool>& aggregateDistincts,
     bool ignoreNullKeys,
     PlanNodePtr source)
     : PlanNode(id),
@@ -71,6 +72,7 @@ AggregationNode::AggregationNode(
       aggregateNames_(aggregateNames),
       aggregates_(aggregates),
       aggregateMasks_(aggregateMasks),
+      aggregateDistincts_(aggregateDistincts),
       ignoreNullKeys_(ignoreNullKeys),
       sources_{source},
       outputType_(getAggregationOutputType(
@@ -98,6 +100,19 @@ AggregationNode::AggregationNode(
         "Pre-grouped key must be one of the grouping keys: {}.",
         key->name());
   }
+
+  if (!aggregateDistincts_.empty()) {
+    VELOX_CHECK_EQ(
+        aggregateDistincts_.size(),
+        aggregates_.size(),
+        "Distinct flags must be given for all aggregates or none");
+  }
+  // Distinct values seen by one partial aggregation may repeat in another, so
+  // the intermediate results of distinct aggregates cannot be merged.
+  VELOX_USER_CHECK(
+      step_ == Step::kSingle || !hasDistinctAggregates(),
+      "Distinct aggregates are only supported in a single aggregation: {}",
+      stepName(step_));
 }
 
 namespace {
@@ -146,6 +161,9 @@ void AggregationNode::addDetails(std::stringstream& stream) const {
       stream << ", ";
     }
     stream << aggregateNames_[i] << " := " << aggregates_[i]->toString();
+    if (!aggregateDistincts_.empty() && aggregateDistincts_[i]) {
+      stream << " DISTINCT";
+    }
   }
 }
 
@@ -230,6 +248,14 @@ void ValuesNode::addDetails(std::stringstream& stream) const {
   stream << totalCount << " rows in " << values_.size() << " vectors";
 }
 
+const std::vector<PlanNodePtr>& ArrowStreamNode::sources() const {
+  return kEmptySources;
+}
+
+void ArrowStreamNode::addDetails(std::stringstream& /* stream */) const {
+  // Nothing to add.
+}
+
 void ProjectNode::addDetails(std::stringstream& stream) const {
   stream << "expressions: ";
   for (auto i = 0; i < projections_.size(); i++) {
@@ -387,17 +413,28 @@ void AbstractJoinNode::addDetails(std::stringstream& stream) const {
   }
 }
 
+void HashJoinNode::addDetails(std::stringstream& stream) const {
+  AbstractJoinNode::addDetails(stream);
+  if (buildCacheId_.has_value()) {
+    stream << ", build cache id: " << buildCacheId_.value();
+  }
+}
+
 CrossJoinNode::CrossJoinNode(
     const PlanNodeId& id,
     PlanNodePtr left,
     PlanNodePtr right,
-    RowTypePtr outputType)
+    RowTypePtr outputType,
+    TypedExprPtr filter)
     : PlanNode(id),
       sources_({std::move(left), std::move(right)}),
-      outputType_(std::move(outputType)) {}
+      outputType_(std::move(outputType)),
+      filter_(std::move(filter)) {}
 
-void CrossJoinNode::addDetails(std::stringstream& /* stream */) const {
-  // Nothing to add.
+void CrossJoinNode::addDetails(std::stringstream& stream) const {
+  if (filter_) {
+    stream << "filter: " << filter_->toString();
+  }
 }
 
 AssignUniqueIdNode::AssignUniqueIdNode(
@@ -469,10 +506,6 @@ WindowNode::WindowNode(
       "Number of sorting keys must be equal to the number of sorting orders");
 }
 
-void WindowNode::addDetails(std::stringstream& stream) const {
-  VELOX_NYI();
-}
-
 namespace {
 void addSortingKeys(
     std::stringstream& stream,
@@ -487,6 +520,68 @@ void addSortingKeys(
 }
 } // namespace
 
+namespace {
+const char* windowTypeName(WindowNode::WindowType type) {
+  switch (type) {
+    case WindowNode::WindowType::kRows:
+      return "ROWS";
+    case WindowNode::WindowType::kRange:
+      return "RANGE";
+  }
+  VELOX_UNREACHABLE();
+}
+
+void addFrameBound(
+    std::stringstream& stream,
+    WindowNode::BoundType type,
+    const TypedExprPtr& value) {
+  switch (type) {
+    case WindowNode::BoundType::kUnboundedPreceding:
+      stream << "UNBOUNDED PRECEDING";
+      break;
+    case WindowNode::BoundType::kPreceding:
+      stream << value->toString() << " PRECEDING";
+      break;
+    case WindowNode::BoundType::kCurrentRow:
+      stream << "CURRENT ROW";
+      break;
+    case WindowNode::BoundType::kFollowing:
+      stream << value->toString() << " FOLLOWING";
+      break;
+    case WindowNode::BoundType::kUnboundedFollowing:
+      stream << "UNBOUNDED FOLLOWING";
+      break;
+  }
+}
+} // namespace
+
+void WindowNode::addDetails(std::stringstream& stream) const {
+  stream << "partition by [";
+  for (auto i = 0; i < partitionKeys_.size(); ++i) {
+    if (i > 0) {
+      stream << ", ";
+    }
+    stream << partitionKeys_[i]->name();
+  }
+  stream << "] order by [";
+  addSortingKeys(stream, sortingKeys_, sortingOrders_);
+  stream << "] ";
+
+  const auto numInputs = sources_[0]->outputType()->size();
+  for (auto i = 0; i < windowFunctions_.size(); ++i) {
+    if (i > 0) {
+      stream << ", ";
+    }
+    const auto& function = windowFunctions_[i];
+    stream << outputType_->nameOf(numInputs + i) << " := "
+           << function.functionCall->toString() << " "
+           << windowTypeName(function.frame.type) << " between ";
+    addFrameBound(stream, function.frame.startType, function.frame.startValue);
+    stream << " and ";
+    addFrameBound(stream, function.frame.endType, function.frame.endValue);
+  }
+}
+
 void LocalMergeNode::addDetails(std::stringstream& stream) const {
   addSortingKeys(stream, sortingKeys_, sortingOrders_);
 }
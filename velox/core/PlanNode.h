@@ -18,6 +18,9 @@
 #include "velox/connectors/Connector.h"
 #include "velox/core/Expressions.h"
 
+/// Defined in <arrow/c/abi.h> or "velox/vector/arrow/Abi.h".
+struct ArrowArrayStream;
+
 namespace facebook::velox::core {
 
 typedef std::string PlanNodeId;
@@ -212,6 +215,43 @@ class ValuesNode : public PlanNode {
   const bool parallelizable_;
 };
 
+/// Source node that reads the batches of an ArrowArrayStream, as defined by
+/// Arrow's C stream interface. Batches are pulled from the stream only as the
+/// plan consumes them. The stream is consumed and released by the first
+/// execution of the plan and the node runs single-threaded.
+class ArrowStreamNode : public PlanNode {
+ public:
+  ArrowStreamNode(
+      const PlanNodeId& id,
+      RowTypePtr outputType,
+      std::shared_ptr<ArrowArrayStream> arrowStream)
+      : PlanNode(id),
+        outputType_(std::move(outputType)),
+        arrowStream_(std::move(arrowStream)) {
+    VELOX_CHECK_NOT_NULL(arrowStream_);
+  }
+
+  const RowTypePtr& outputType() const override {
+    return outputType_;
+  }
+
+  const std::vector<PlanNodePtr>& sources() const override;
+
+  const std::shared_ptr<ArrowArrayStream>& arrowStream() const {
+    return arrowStream_;
+  }
+
+  std::string_view name() const override {
+    return "ArrowStream";
+  }
+
+ private:
+  void addDetails(std::stringstream& stream) const override;
+
+  const RowTypePtr outputType_;
+  const std::shared_ptr<ArrowArrayStream> arrowStream_;
+};
+
 class FilterNode : public PlanNode {
  public:
   FilterNode(const PlanNodeId& id, TypedExprPtr filter, PlanNodePtr source)
@@ -451,6 +491,9 @@ class AggregationNode : public PlanNode {
    * clustered, i.e. identical sets of values for these keys always appear next
    * to each other. Can be empty. If contains all the 'groupingKeys', the
    * aggregation will run in streaming mode.
+   * @param aggregateDistincts Empty or one flag per aggregate. True if the
+   * aggregate only accumulates distinct values of its arguments in each
+   * group, as in count(DISTINCT c). Only supported for single aggregations.
    * @param ignoreNullKeys True if rows with at least one null key should be
    * ignored. Used when group by is a source of a join build side and grouping
    * keys are join keys.
@@ -463,6 +506,7 @@ class AggregationNode : public PlanNode {
       const std::vector<std::string>& aggregateNames,
       const std::vector<CallTypedExprPtr>& aggregates,
       const std::vector<FieldAccessTypedExprPtr>& aggregateMasks,
+      const std::vector<bool>& aggregateDistincts,
       bool ignoreNullKeys,
       PlanNodePtr source);
 
@@ -498,6 +542,17 @@ class AggregationNode : public PlanNode {
     return aggregateMasks_;
   }
 
+  const std::vector<bool>& aggregateDistincts() const {
+    return aggregateDistincts_;
+  }
+
+  /// Returns true if at least one aggregate has the DISTINCT flag.
+  bool hasDistinctAggregates() const {
+    return std::find(
+               aggregateDistincts_.begin(), aggregateDistincts_.end(), true) !=
+        aggregateDistincts_.end();
+  }
+
   bool ignoreNullKeys() const {
     return ignoreNullKeys_;
   }
@@ -517,6 +572,9 @@ class AggregationNode : public PlanNode {
   // Keeps mask/'no mask' for every aggregation. Mask, if given, is a reference
   // to a boolean projection column, used to mask out rows for the aggregation.
   const std::vector<FieldAccessTypedExprPtr> aggregateMasks_;
+  // Empty or one flag per aggregation. True if the aggregation only sees the
+  // distinct values of its arguments in each group.
+  const std::vector<bool> aggregateDistincts_;
   const bool ignoreNullKeys_;
   const std::vector<PlanNodePtr> sources_;
   const RowTypePtr outputType_;
@@ -1037,9 +1095,10 @@ class AbstractJoinNode : public PlanNode {
     return filter_;
   }
 
- private:
+ protected:
   void addDetails(std::stringstream& stream) const override;
 
+ private:
   const JoinType joinType_;
   const std::vector<FieldAccessTypedExprPtr> leftKeys_;
   const std::vector<FieldAccessTypedExprPtr> rightKeys_;
@@ -1055,6 +1114,12 @@ class AbstractJoinNode : public PlanNode {
 /// Represents inner/outer/semi/anti hash joins. Translates to an
 /// exec::HashBuild and exec::HashProbe. A separate pipeline is produced for the
 /// build side when generating exec::Operators.
+///
+/// 'buildCacheId' identifies the data read by the build side, e.g. the table,
+/// snapshot and splits of a broadcast dimension table. If set, Tasks running
+/// the same build side over the same data share one hash table through
+/// exec::HashJoinTableCache instead of each building their own. The caller
+/// must ensure that equal ids mean equal build side input.
 class HashJoinNode : public AbstractJoinNode {
  public:
   HashJoinNode(
@@ -1065,7 +1130,8 @@ class HashJoinNode : public AbstractJoinNode {
       TypedExprPtr filter,
       PlanNodePtr left,
       PlanNodePtr right,
-      const RowTypePtr outputType)
+      const RowTypePtr outputType,
+      std::optional<std::string> buildCacheId = std::nullopt)
       : AbstractJoinNode(
             id,
             joinType,
@@ -1074,11 +1140,21 @@ class HashJoinNode : public AbstractJoinNode {
             filter,
             left,
             right,
-            outputType) {}
+            outputType),
+        buildCacheId_(std::move(buildCacheId)) {}
 
   std::string_view name() const override {
     return "HashJoin";
   }
+
+  const std::optional<std::string>& buildCacheId() const {
+    return buildCacheId_;
+  }
+
+ private:
+  void addDetails(std::stringstream& stream) const override;
+
+  const std::optional<std::string> buildCacheId_;
 };
 
 /// Represents inner/outer/semi/anti merge joins. Translates to an
@@ -1115,11 +1191,15 @@ class MergeJoinNode : public AbstractJoinNode {
 // Cross join.
 class CrossJoinNode : public PlanNode {
  public:
+  // 'filter' is an optional condition on the columns of both inputs. Only
+  // the pairs of rows that pass it are produced, which makes the node an
+  // inner nested loop join.
   CrossJoinNode(
       const PlanNodeId& id,
       PlanNodePtr left,
       PlanNodePtr right,
-      RowTypePtr outputType);
+      RowTypePtr outputType,
+      TypedExprPtr filter = nullptr);
 
   const std::vector<PlanNodePtr>& sources() const override {
     return sources_;
@@ -1129,6 +1209,10 @@ class CrossJoinNode : public PlanNode {
     return outputType_;
   }
 
+  const TypedExprPtr& filter() const {
+    return filter_;
+  }
+
   std::string_view name() const override {
     return "CrossJoin";
   }
@@ -1138,6 +1222,7 @@ class CrossJoinNode : public PlanNode {
 
   const std::vector<PlanNodePtr> sources_;
   const RowTypePtr outputType_;
+  const TypedExprPtr filter_;
 };
 
 // Represents the 'SortBy' node in the plan.
@@ -58,6 +58,13 @@ class QueryConfig {
   static constexpr const char* kExprTrackCpuUsage =
       "expression.track_cpu_usage";
 
+  // If a THEN or ELSE clause of a CASE expression is evaluated on fewer than
+  // this percentage of the rows of the CASE, the fields it uses are copied to
+  // just those rows and the clause is evaluated on the dense copy. 0, the
+  // default, disables this.
+  static constexpr const char* kExprSwitchCompactionPct =
+      "expression.switch_compaction_pct";
+
   // Flags used to configure the CAST operator:
 
   // This flag makes the Row conversion to by applied
@@ -77,14 +84,67 @@ class QueryConfig {
   static constexpr const char* kMaxPartialAggregationMemory =
       "max_partial_aggregation_memory";
 
+  /// Minimum number of input rows a partial aggregation must see before it
+  /// may give up aggregating because of poor reduction.
+  static constexpr const char* kAbandonPartialAggregationMinRows =
+      "abandon_partial_aggregation_min_rows";
+
+  /// Partial aggregation switches to passing input through as intermediate
+  /// results when the number of groups is at least this percentage of the
+  /// number of input rows.
+  static constexpr const char* kAbandonPartialAggregationMinPct =
+      "abandon_partial_aggregation_min_pct";
+
+  /// If true, the Drivers of a final or single aggregation merge their input
+  /// into one set of groups, partitioned by the hash of the grouping keys
+  /// with a lock per partition. Each Driver then produces one partition, so
+  /// the input does not need a local repartition by the grouping keys.
+  /// Applies to aggregations with grouping keys that do not spill, have no
+  /// distinct aggregates or pre-grouped keys and do not ignore null keys.
+  static constexpr const char* kSharedFinalAggregation =
+      "shared_final_aggregation";
+
   static constexpr const char* kMaxPartitionedOutputBufferSize =
       "driver.max-page-partitioning-buffer-size";
 
+  /// Maximum time in milliseconds a Driver runs on a thread before yielding
+  /// it to other runnable Drivers. 0 means no limit.
+  static constexpr const char* kDriverTimeSliceMs = "driver_time_slice_ms";
+
+  /// If true, each Driver records a timeline of its operator calls, blocking
+  /// and spilling. See Task::driverTraceJson().
+  static constexpr const char* kDriverTraceEnabled = "driver_trace_enabled";
+
+  /// If true, Drivers count the cycles, instructions, last level cache
+  /// misses and branch misses of each operator call with hardware counters
+  /// and add them to OperatorStats::perfCounters. Has no effect where
+  /// perf_event_open() is not available or not permitted.
+  static constexpr const char* kOperatorPerfCountersEnabled =
+      "operator_perf_counters_enabled";
+
+  /// If positive, the memory pools of a Task sample about one allocation per
+  /// this many bytes with their allocating operator and stack. See
+  /// Task::heapProfile(). The profile is logged when the Task fails on
+  /// exceeding its memory cap. 0 disables the sampling.
+  static constexpr const char* kHeapProfileSampleBytes =
+      "heap_profile_sample_bytes";
+
   /// Preffered number of rows to be returned by operators from
   /// Operator::getOutput.
   static constexpr const char* kPreferredOutputBatchSize =
       "preferred_output_batch_size";
 
+  /// Preferred size in bytes of the batches returned by operators that can
+  /// estimate the width of their output rows, e.g. HashAggregation, Merge,
+  /// HashProbe for a key with many matches and TableScan. These size their
+  /// batches to about this many bytes, with at most kMaxOutputBatchRows
+  /// rows, instead of using kPreferredOutputBatchSize.
+  static constexpr const char* kPreferredOutputBatchBytes =
+      "preferred_output_batch_bytes";
+
+  /// Maximum number of rows in a batch sized by kPreferredOutputBatchBytes.
+  static constexpr const char* kMaxOutputBatchRows = "max_output_batch_rows";
+
   static constexpr const char* kHashAdaptivityEnabled =
       "driver.hash_adaptivity_enabled";
 
@@ -95,13 +155,106 @@ class QueryConfig {
 
   static constexpr const char* kSpillPath = "spiller-spill-path";
 
+  /// Directories, e.g. on remote storage, for the spill files that do not
+  /// fit in the local spill quota. Comma-separated like kSpillPath.
+  static constexpr const char* kSpillOverflowPath = "spiller-overflow-path";
+
+  /// Bytes of local spill files of the process above which new spill files
+  /// go to kSpillOverflowPath. 0 means no quota.
+  static constexpr const char* kSpillLocalQuotaBytes =
+      "spiller-local-quota-bytes";
+
   static constexpr const char* kTestingSpillPct = "testing.spill-pct";
 
+  static constexpr const char* kSpillCompressionKind =
+      "spiller-compression-kind";
+
+  /// Number of spilled partitions of a HashAggregation that are merged at
+  /// the same time when producing output. Each partition is merged on the
+  /// spill executor with at most one batch of results pending. 1 merges the
+  /// partitions one after the other on the Driver thread.
+  static constexpr const char* kAggregationSpillMergeThreads =
+      "aggregation_spill_merge_threads";
+
+  /// If true and spilling is disabled, a final OrderBy runs on as many
+  /// Drivers as its pipeline. Each Driver sorts its share of the input and
+  /// the last Driver to finish merges the sorted rows of all Drivers.
+  static constexpr const char* kOrderByMultiDriverEnabled =
+      "order_by_multi_driver_enabled";
+
+  /// Number of threads that sort the rows of an OrderBy, including the
+  /// Driver thread. The other threads come from the Driver executor.
+  static constexpr const char* kOrderBySortThreads = "order_by_sort_threads";
+
+  /// Codec for compressing the pages sent between tasks. Must be the same
+  /// for the producing and the consuming tasks.
+  static constexpr const char* kExchangeCompressionKind =
+      "exchange-compression-kind";
+
+  /// Name of the serde of the pages sent between tasks, as registered with
+  /// registerNamedVectorSerde(). Must be the same for the producing and the
+  /// consuming tasks.
+  static constexpr const char* kExchangeSerde = "exchange-serde";
+
+  /// If true, tasks with a "local://" id hand the vectors of their output to
+  /// in-process consumers without serializing them.
+  static constexpr const char* kExchangeLocalVectors = "exchange-local-vectors";
+
+  /// If true, an Exchange deserializes the pages it receives on the
+  /// executor of the query as they arrive, instead of on the Driver thread
+  /// that consumes them.
+  static constexpr const char* kExchangeParallelDeserialize =
+      "exchange-parallel-deserialize";
+
+  /// If true with kExchangeParallelDeserialize, the batches of a page are
+  /// combined into vectors of up to kPreferredOutputBatchSize rows while
+  /// deserializing.
+  static constexpr const char* kExchangeMergeBatches = "exchange-merge-batches";
+
+  /// Number of splits after the current one that a TableScan prepares in the
+  /// background, so that the file opening and the IO for the first stripe of
+  /// the next splits overlap with reading the current one. Requires a
+  /// connector that supports split preload. 0 disables preload.
+  static constexpr const char* kMaxSplitPreloadPerDriver =
+      "max-split-preload-per-driver";
+
+  /// Maximum number of Drivers a Task adds to a pipeline while running,
+  /// beyond the ones it starts with. Applies to pipelines that read splits
+  /// with a TableScan and whose Drivers share no state, e.g. a scan with a
+  /// partial aggregation feeding a PartitionedOutput. Added Drivers retire
+  /// when no split is queued. 0 disables adding Drivers.
+  static constexpr const char* kMaxElasticDriversPerPipeline =
+      "max_elastic_drivers_per_pipeline";
+
+  /// A Driver is added to a pipeline only if its TableScan spends less than
+  /// this percentage of its wall time on CPU, e.g. because it waits for IO.
+  static constexpr const char* kElasticDriverMaxCpuPct =
+      "elastic_driver_max_cpu_pct";
+
+  /// Name of the AsyncDataCache quota group that the cache entries read by
+  /// the query are charged to, e.g. a tenant. See
+  /// AsyncDataCache::setQuota().
+  static constexpr const char* kCacheQuotaGroup = "cache-quota-group";
+
   uint64_t maxPartialAggregationMemoryUsage() const {
     static constexpr uint64_t kDefault = 1L << 24;
     return get<uint64_t>(kMaxPartialAggregationMemory, kDefault);
   }
 
+  int32_t abandonPartialAggregationMinRows() const {
+    static constexpr int32_t kDefault = 100'000;
+    return get<int32_t>(kAbandonPartialAggregationMinRows, kDefault);
+  }
+
+  int32_t abandonPartialAggregationMinPct() const {
+    static constexpr int32_t kDefault = 80;
+    return get<int32_t>(kAbandonPartialAggregationMinPct, kDefault);
+  }
+
+  bool sharedFinalAggregation() const {
+    return get<bool>(kSharedFinalAggregation, false);
+  }
+
   // Returns the target size for a Task's buffered output. The
   // producer Drivers are blocked when the buffered size exceeds
   // this. The Drivers are resumed when the buffered size goes below
@@ -111,6 +264,22 @@ class QueryConfig {
     return get<uint64_t>(kMaxPartitionedOutputBufferSize, kDefault);
   }
 
+  uint64_t driverTimeSliceMs() const {
+    return get<uint64_t>(kDriverTimeSliceMs, 0);
+  }
+
+  bool driverTraceEnabled() const {
+    return get<bool>(kDriverTraceEnabled, false);
+  }
+
+  bool operatorPerfCountersEnabled() const {
+    return get<bool>(kOperatorPerfCountersEnabled, false);
+  }
+
+  int64_t heapProfileSampleBytes() const {
+    return get<int64_t>(kHeapProfileSampleBytes, 0);
+  }
+
   uint64_t maxLocalExchangeBufferSize() const {
     static constexpr uint64_t kDefault = 32UL << 20;
     return get<uint64_t>(kMaxLocalExchangeBufferSize, kDefault);
@@ -120,6 +289,15 @@ class QueryConfig {
     return get<uint32_t>(kPreferredOutputBatchSize, 1024);
   }
 
+  uint64_t preferredOutputBatchBytes() const {
+    static constexpr uint64_t kDefault = 10UL << 20;
+    return get<uint64_t>(kPreferredOutputBatchBytes, kDefault);
+  }
+
+  uint32_t maxOutputBatchRows() const {
+    return get<uint32_t>(kMaxOutputBatchRows, 10'000);
+  }
+
   bool hashAdaptivityEnabled() const {
     return get<bool>(kHashAdaptivityEnabled, true);
   }
@@ -174,6 +352,10 @@ class QueryConfig {
     return get<bool>(kExprEvalSimplified, false);
   }
 
+  int32_t exprSwitchCompactionPct() const {
+    return get<int32_t>(kExprSwitchCompactionPct, 0);
+  }
+
   /// Returns a path for writing spill files. If empty, spilling is
   /// disabled. The path should be interpretable by
   /// filesystems::getFileSystem and may refer to any writable
@@ -181,9 +363,21 @@ class QueryConfig {
   /// filename composed of Task id and serial numbers. The files are
   /// automatically deleted when no longer needed. Files may be left
   /// behind after crashes but are identifiable based on the Task id in
-  /// the name.
+  /// the name. The value may also be a comma-separated list of
+  /// directories, e.g. one per local disk. The spill files are then
+  /// striped over the directories round-robin. If kSpillOverflowPath is
+  /// set, it follows the local directories after a '|'.
   std::optional<std::string> spillPath() const {
-    return get<std::string>(kSpillPath);
+    auto path = get<std::string>(kSpillPath);
+    auto overflowPath = get<std::string>(kSpillOverflowPath);
+    if (path.has_value() && overflowPath.has_value()) {
+      return path.value() + "|" + overflowPath.value();
+    }
+    return path;
+  }
+
+  uint64_t spillLocalQuotaBytes() const {
+    return get<uint64_t>(kSpillLocalQuotaBytes, 0);
   }
 
   // Returns a percentage of aggregation or join input batches that
@@ -192,6 +386,72 @@ class QueryConfig {
     return get<int32_t>(kTestingSpillPct, 0);
   }
 
+  /// Returns the codec for compressing spill files: "none", "lz4", "zstd",
+  /// "zlib" or "snappy". Defaults to "none".
+  std::string spillCompressionKind() const {
+    return get<std::string>(kSpillCompressionKind, "none");
+  }
+
+  int32_t aggregationSpillMergeThreads() const {
+    return get<int32_t>(kAggregationSpillMergeThreads, 1);
+  }
+
+  bool orderByMultiDriverEnabled() const {
+    return get<bool>(kOrderByMultiDriverEnabled, false);
+  }
+
+  int32_t orderBySortThreads() const {
+    return get<int32_t>(kOrderBySortThreads, 1);
+  }
+
+  /// Returns the codec for compressing exchanged pages: "none", "lz4",
+  /// "zstd", "zlib" or "snappy". Defaults to "none".
+  std::string exchangeCompressionKind() const {
+    return get<std::string>(kExchangeCompressionKind, "none");
+  }
+
+  /// Returns the name of the serde of exchanged pages, e.g. "compact_row".
+  /// Defaults to "", the serde registered with registerVectorSerde().
+  std::string exchangeSerde() const {
+    return get<std::string>(kExchangeSerde, "");
+  }
+
+  /// Returns true if pages sent between tasks of this process hold vectors
+  /// instead of serialized data. Defaults to false.
+  bool exchangeLocalVectors() const {
+    return get<bool>(kExchangeLocalVectors, false);
+  }
+
+  /// Returns true if exchanged pages are deserialized on the executor of
+  /// the query. Defaults to false.
+  bool exchangeParallelDeserialize() const {
+    return get<bool>(kExchangeParallelDeserialize, false);
+  }
+
+  /// Returns true if the batches of a page deserialized in parallel are
+  /// combined up to the preferred output batch size. Defaults to false.
+  bool exchangeMergeBatches() const {
+    return get<bool>(kExchangeMergeBatches, false);
+  }
+
+  int32_t maxSplitPreloadPerDriver() const {
+    return get<int32_t>(kMaxSplitPreloadPerDriver, 0);
+  }
+
+  int32_t maxElasticDriversPerPipeline() const {
+    return get<int32_t>(kMaxElasticDriversPerPipeline, 0);
+  }
+
+  int32_t elasticDriverMaxCpuPct() const {
+    return get<int32_t>(kElasticDriverMaxCpuPct, 50);
+  }
+
+  /// Returns the cache quota group of the query. Defaults to "", the group
+  /// without quota.
+  std::string cacheQuotaGroup() const {
+    return get<std::string>(kCacheQuotaGroup, "");
+  }
+
   bool exprTrackCpuUsage() const {
     return get<bool>(kExprTrackCpuUsage, false);
   }
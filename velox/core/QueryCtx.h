@@ -22,6 +22,7 @@
 #include "velox/core/Context.h"
 #include "velox/core/QueryConfig.h"
 #include "velox/vector/DecodedVector.h"
+#include "velox/vector/VectorPool.h"
 
 namespace facebook::velox::core {
 
@@ -165,7 +166,10 @@ class ExecCtx : public Context {
   ExecCtx(
       memory::MemoryPool* FOLLY_NONNULL pool,
       QueryCtx* FOLLY_NULLABLE queryCtx)
-      : Context{ContextScope::QUERY}, pool_(pool), queryCtx_(queryCtx) {}
+      : Context{ContextScope::QUERY},
+        pool_(pool),
+        queryCtx_(queryCtx),
+        vectorPool_(pool) {}
 
   velox::memory::MemoryPool* FOLLY_NONNULL pool() const {
     return pool_;
@@ -220,6 +224,42 @@ class ExecCtx : public Context {
     decodedVectorPool_.push_back(std::move(vector));
   }
 
+  /// Returns a flat vector of 'type' and 'size' from the pool of recycled
+  /// vectors, or a new one. The values are undefined.
+  VectorPtr getVector(const TypePtr& type, vector_size_t size) {
+    return vectorPool_.get(type, size);
+  }
+
+  /// Gives 'vector' back for reuse if nothing else references it. Returns
+  /// true and resets 'vector' if it was taken.
+  bool releaseVector(VectorPtr& vector) {
+    return vectorPool_.release(vector);
+  }
+
+  /// Calls releaseVector() on each of 'vectors' and clears 'vectors'.
+  size_t releaseVectors(std::vector<VectorPtr>& vectors) {
+    return vectorPool_.release(vectors);
+  }
+
+  /// Returns a buffer of at least 'size' bytes with undefined content for
+  /// temporaries that live until the end of a batch. Reuses a released
+  /// buffer if one is large enough. Prefer exec::EvalCtx::scratch(), which
+  /// gives the buffers back when the EvalCtx is destroyed.
+  BufferPtr getScratchBuffer(size_t size) {
+    for (auto i = 0; i < scratchBufferPool_.size(); ++i) {
+      if (scratchBufferPool_[i]->capacity() >= size) {
+        auto buffer = std::move(scratchBufferPool_[i]);
+        scratchBufferPool_.erase(scratchBufferPool_.begin() + i);
+        return buffer;
+      }
+    }
+    return AlignedBuffer::allocate<char>(size, pool_);
+  }
+
+  void releaseScratchBuffer(BufferPtr&& buffer) {
+    scratchBufferPool_.push_back(std::move(buffer));
+  }
+
  private:
   // Pool for all Buffers for this thread
   memory::MemoryPool* FOLLY_NONNULL pool_;
@@ -229,6 +269,12 @@ class ExecCtx : public Context {
   // A pool of preallocated SelectivityVectors for use by expressions
   // and operators.
   std::vector<std::unique_ptr<SelectivityVector>> selectivityVectorPool_;
+  // A pool of flat vectors recycled between batches, e.g. intermediate
+  // results of expressions.
+  VectorPool vectorPool_;
+  // Buffers recycled between batches for scratch memory. There are about as
+  // many as nested EvalCtxs, so a vector is enough.
+  std::vector<BufferPtr> scratchBufferPool_;
 };
 
 } // namespace facebook::velox::core
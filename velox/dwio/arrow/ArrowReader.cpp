@@ -0,0 +1,367 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "velox/dwio/arrow/ArrowReader.h"
+
+#include <numeric>
+
+#include <arrow/buffer.h> // @manual
+#include <arrow/c/bridge.h> // @manual
+#include <arrow/io/file.h> // @manual
+#include <arrow/io/memory.h> // @manual
+#include <arrow/ipc/reader.h> // @manual
+#include <arrow/record_batch.h> // @manual
+
+#include "velox/dwio/common/IoLatencyModel.h"
+#include "velox/vector/DecodedVector.h"
+#include "velox/vector/arrow/Bridge.h"
+
+namespace facebook::velox::arrow_ipc {
+
+namespace {
+
+void checkStatus(const ::arrow::Status& status, const std::string& path) {
+  VELOX_CHECK(
+      status.ok(), "Error reading Arrow file {}: {}", path, status.ToString());
+}
+
+template <typename T>
+T valueOrThrow(::arrow::Result<T>&& result, const std::string& path) {
+  checkStatus(result.status(), path);
+  return std::move(result).ValueUnsafe();
+}
+
+// Opens the bytes of 'stream'. A local file is memory mapped. Otherwise
+// the file is read into one buffer, so that record batches can refer to
+// it without a copy either way.
+std::shared_ptr<::arrow::io::RandomAccessFile> openFile(
+    dwio::common::InputStream& stream) {
+  const auto& path = stream.getName();
+  if (dwio::common::IoLatencyModel::storageName(path) == "file") {
+    std::string localPath =
+        path.rfind("file:", 0) == 0 ? path.substr(5) : path;
+    auto mapped = ::arrow::io::MemoryMappedFile::Open(
+        localPath, ::arrow::io::FileMode::READ);
+    if (mapped.ok()) {
+      return std::move(mapped).ValueUnsafe();
+    }
+  }
+  auto length = stream.getLength();
+  std::shared_ptr<::arrow::Buffer> buffer =
+      valueOrThrow(::arrow::AllocateBuffer(length), path);
+  stream.read(
+      const_cast<uint8_t*>(buffer->data()),
+      length,
+      0,
+      dwio::common::LogType::FILE);
+  return std::make_shared<::arrow::io::BufferReader>(std::move(buffer));
+}
+
+template <TypeKind Kind>
+vector_size_t filterTyped(
+    const common::Filter& filter,
+    const DecodedVector& decoded,
+    vector_size_t* rows,
+    vector_size_t numRows) {
+  using T = typename TypeTraits<Kind>::NativeType;
+  vector_size_t numPassed = 0;
+  for (auto i = 0; i < numRows; ++i) {
+    auto row = rows[i];
+    bool passed = decoded.isNullAt(row)
+        ? filter.testNull()
+        : common::applyFilter(filter, decoded.valueAt<T>(row));
+    if (passed) {
+      rows[numPassed++] = row;
+    }
+  }
+  return numPassed;
+}
+
+// Narrows 'rows' to the rows where 'vector' passes 'filter'. Returns the
+// number of rows left.
+vector_size_t applyFilter(
+    const common::Filter& filter,
+    const BaseVector& vector,
+    vector_size_t* rows,
+    vector_size_t numRows) {
+  SelectivityVector allRows(vector.size());
+  DecodedVector decoded(vector, allRows);
+  switch (filter.kind()) {
+    case common::FilterKind::kIsNull:
+    case common::FilterKind::kIsNotNull: {
+      vector_size_t numPassed = 0;
+      for (auto i = 0; i < numRows; ++i) {
+        if (decoded.isNullAt(rows[i]) == filter.testNull()) {
+          rows[numPassed++] = rows[i];
+        }
+      }
+      return numPassed;
+    }
+    default:
+      break;
+  }
+  switch (vector.typeKind()) {
+    case TypeKind::BOOLEAN:
+      return filterTyped<TypeKind::BOOLEAN>(filter, decoded, rows, numRows);
+    case TypeKind::TINYINT:
+      return filterTyped<TypeKind::TINYINT>(filter, decoded, rows, numRows);
+    case TypeKind::SMALLINT:
+      return filterTyped<TypeKind::SMALLINT>(filter, decoded, rows, numRows);
+    case TypeKind::INTEGER:
+      return filterTyped<TypeKind::INTEGER>(filter, decoded, rows, numRows);
+    case TypeKind::BIGINT:
+      return filterTyped<TypeKind::BIGINT>(filter, decoded, rows, numRows);
+    case TypeKind::REAL:
+      return filterTyped<TypeKind::REAL>(filter, decoded, rows, numRows);
+    case TypeKind::DOUBLE:
+      return filterTyped<TypeKind::DOUBLE>(filter, decoded, rows, numRows);
+    case TypeKind::VARCHAR:
+      return filterTyped<TypeKind::VARCHAR>(filter, decoded, rows, numRows);
+    case TypeKind::VARBINARY:
+      return filterTyped<TypeKind::VARBINARY>(filter, decoded, rows, numRows);
+    default:
+      VELOX_UNSUPPORTED(
+          "Unsupported filter on column of type {} in Arrow reader: {}",
+          vector.type()->toString(),
+          filter.toString());
+  }
+}
+
+} // namespace
+
+ArrowRowReader::ArrowRowReader(
+    std::shared_ptr<::arrow::ipc::RecordBatchFileReader> reader,
+    RowTypePtr fileType,
+    uint64_t fileLength,
+    const dwio::common::RowReaderOptions& options,
+    memory::MemoryPool& pool)
+    : reader_(std::move(reader)),
+      fileType_(std::move(fileType)),
+      pool_(pool),
+      scanSpec_(options.getScanSpec()) {
+  std::vector<bool> read(fileType_->size());
+  if (scanSpec_) {
+    // The result has a column per channel of the ScanSpec.
+    std::vector<std::string> names;
+    std::vector<TypePtr> types;
+    for (auto& spec : scanSpec_->children()) {
+      VELOX_CHECK(
+          !spec->extractValues(), "Subfield access is NYI in Arrow reader");
+      if (spec->isConstant() || spec->projectOut()) {
+        auto channel = spec->channel();
+        if (channel >= names.size()) {
+          names.resize(channel + 1);
+          types.resize(channel + 1);
+        }
+        names[channel] = spec->fieldName();
+        types[channel] = spec->isConstant()
+            ? spec->constantValue()->type()
+            : fileType_->findChild(spec->fieldName());
+      }
+      if (spec->isConstant() || (!spec->projectOut() && !spec->filter())) {
+        continue;
+      }
+      read[fileType_->getChildIdx(spec->fieldName())] = true;
+    }
+    rowType_ = ROW(std::move(names), std::move(types));
+  } else {
+    rowType_ = options.getSelector()
+        ? options.getSelector()->buildSelectedReordered()
+        : fileType_;
+    for (auto& name : rowType_->names()) {
+      read[fileType_->getChildIdx(name)] = true;
+    }
+  }
+  for (column_index_t i = 0; i < read.size(); ++i) {
+    if (read[i]) {
+      readColumns_.push_back(i);
+    }
+  }
+
+  // The IPC footer does not expose the file offsets of the batches, so
+  // the batches are spread evenly over the file and a batch belongs to
+  // the split that covers its nominal position.
+  auto numBatches = reader_->num_record_batches();
+  for (int32_t i = 0; i < numBatches; ++i) {
+    auto position = fileLength * i / numBatches;
+    if (position >= options.getOffset() &&
+        position - options.getOffset() < options.getLength()) {
+      batches_.push_back(i);
+    }
+  }
+}
+
+bool ArrowRowReader::loadBatch() {
+  batch_ = nullptr;
+  columns_.clear();
+  while (nextBatch_ < batches_.size()) {
+    auto batch = reader_->ReadRecordBatch(batches_[nextBatch_++]);
+    VELOX_CHECK(
+        batch.ok(),
+        "Error reading Arrow record batch: {}",
+        batch.status().ToString());
+    batch_ = std::move(batch).ValueUnsafe();
+    if (batch_->num_rows() > 0) {
+      break;
+    }
+    batch_ = nullptr;
+  }
+  if (!batch_) {
+    return false;
+  }
+  VELOX_CHECK_LE(
+      batch_->num_rows(), std::numeric_limits<vector_size_t>::max());
+  columns_.resize(fileType_->size());
+  for (auto column : readColumns_) {
+    ArrowArray arrowArray;
+    ArrowSchema arrowSchema;
+    auto status = ::arrow::ExportArray(
+        *batch_->column(column), &arrowArray, &arrowSchema);
+    VELOX_CHECK(
+        status.ok(), "Error exporting Arrow array: {}", status.ToString());
+    // The imported vector holds on to the Arrow buffers, which point into
+    // the mapped file.
+    columns_[column] = importFromArrowAsOwner(arrowSchema, arrowArray, &pool_);
+  }
+  batchOffset_ = 0;
+  return true;
+}
+
+uint64_t ArrowRowReader::next(uint64_t size, velox::VectorPtr& result) {
+  if ((!batch_ || batchOffset_ >= batch_->num_rows()) && !loadBatch()) {
+    return 0;
+  }
+  const vector_size_t batchRows = batch_->num_rows();
+  const vector_size_t numRows =
+      std::min<uint64_t>(size, batchRows - batchOffset_);
+  auto indices = allocateIndices(numRows, &pool_);
+  auto rows = indices->asMutable<vector_size_t>();
+  std::iota(rows, rows + numRows, batchOffset_);
+  vector_size_t numPassed = numRows;
+  if (scanSpec_) {
+    for (auto& spec : scanSpec_->children()) {
+      if (spec->isConstant() || !spec->filter() || numPassed == 0) {
+        continue;
+      }
+      auto& column = columns_[fileType_->getChildIdx(spec->fieldName())];
+      numPassed = applyFilter(*spec->filter(), *column, rows, numPassed);
+    }
+  }
+  batchOffset_ += numRows;
+
+  // Whole batches that pass all filters are returned as imported.
+  const bool wholeBatch = numPassed == batchRows;
+  auto wrap = [&](const VectorPtr& column) -> VectorPtr {
+    if (wholeBatch) {
+      return column;
+    }
+    return BaseVector::wrapInDictionary(nullptr, indices, numPassed, column);
+  };
+  std::vector<VectorPtr> children(rowType_->size());
+  if (scanSpec_) {
+    for (auto& spec : scanSpec_->children()) {
+      if (spec->isConstant()) {
+        children[spec->channel()] =
+            BaseVector::wrapInConstant(numPassed, 0, spec->constantValue());
+      } else if (spec->projectOut()) {
+        children[spec->channel()] =
+            wrap(columns_[fileType_->getChildIdx(spec->fieldName())]);
+      }
+    }
+  } else {
+    for (column_index_t i = 0; i < rowType_->size(); ++i) {
+      children[i] = wrap(columns_[fileType_->getChildIdx(rowType_->nameOf(i))]);
+    }
+  }
+  result = std::make_shared<RowVector>(
+      &pool_,
+      rowType_,
+      BufferPtr(nullptr),
+      numPassed,
+      std::move(children),
+      std::nullopt);
+  return numRows;
+}
+
+void ArrowRowReader::updateRuntimeStats(
+    dwio::common::RuntimeStatistics& /*stats*/) const {}
+
+void ArrowRowReader::resetFilterCaches() {
+  // No filter caches to reset.
+}
+
+std::optional<size_t> ArrowRowReader::estimatedRowSize() const {
+  return std::nullopt;
+}
+
+ArrowReader::ArrowReader(
+    std::unique_ptr<dwio::common::InputStream> stream,
+    const dwio::common::ReaderOptions& options)
+    : pool_(options.getMemoryPool()),
+      fileLength_(stream->getLength()),
+      file_(openFile(*stream)) {
+  const auto& path = stream->getName();
+  reader_ = valueOrThrow(
+      ::arrow::ipc::RecordBatchFileReader::Open(file_), path);
+  ArrowSchema arrowSchema;
+  checkStatus(::arrow::ExportSchema(*reader_->schema(), &arrowSchema), path);
+  auto type = importFromArrow(arrowSchema);
+  arrowSchema.release(&arrowSchema);
+  VELOX_CHECK(type->isRow(), "Arrow file {} does not have a row schema", path);
+  type_ = std::static_pointer_cast<const RowType>(type);
+}
+
+std::optional<uint64_t> ArrowReader::numberOfRows() const {
+  auto numRows = reader_->CountRows();
+  if (!numRows.ok()) {
+    return std::nullopt;
+  }
+  return *numRows;
+}
+
+std::unique_ptr<dwio::common::ColumnStatistics> ArrowReader::columnStatistics(
+    uint32_t /*index*/) const {
+  // The IPC format has no column statistics.
+  return std::make_unique<dwio::common::ColumnStatistics>();
+}
+
+const velox::RowTypePtr& ArrowReader::rowType() const {
+  return type_;
+}
+
+const std::shared_ptr<const dwio::common::TypeWithId>&
+ArrowReader::typeWithId() const {
+  if (!typeWithId_) {
+    typeWithId_ = dwio::common::TypeWithId::create(type_);
+  }
+  return typeWithId_;
+}
+
+std::unique_ptr<dwio::common::RowReader> ArrowReader::createRowReader(
+    const dwio::common::RowReaderOptions& options) const {
+  return std::make_unique<ArrowRowReader>(
+      reader_, type_, fileLength_, options, pool_);
+}
+
+void registerArrowReaderFactory() {
+  dwio::common::registerReaderFactory(std::make_shared<ArrowReaderFactory>());
+}
+
+void unregisterArrowReaderFactory() {
+  dwio::common::unregisterReaderFactory(dwio::common::FileFormat::ARROW);
+}
+
+} // namespace facebook::velox::arrow_ipc
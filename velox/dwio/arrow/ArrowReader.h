@@ -0,0 +1,138 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include "velox/dwio/common/Reader.h"
+#include "velox/dwio/common/ReaderFactory.h"
+
+namespace arrow {
+class RecordBatch;
+namespace io {
+class RandomAccessFile;
+}
+namespace ipc {
+class RecordBatchFileReader;
+}
+} // namespace arrow
+
+namespace facebook::velox::arrow_ipc {
+
+// Reads the record batches of a split of an Arrow IPC file. Each call to
+// next() returns up to 'size' rows of one record batch. The columns are
+// imported through the Arrow bridge as views on the buffers of the file,
+// so that no values are copied. Filters in the ScanSpec are evaluated on
+// the imported columns. A result that is not a whole batch is a
+// dictionary over the rows of the batch it returns.
+class ArrowRowReader : public dwio::common::RowReader {
+ public:
+  ArrowRowReader(
+      std::shared_ptr<::arrow::ipc::RecordBatchFileReader> reader,
+      RowTypePtr fileType,
+      uint64_t fileLength,
+      const dwio::common::RowReaderOptions& options,
+      memory::MemoryPool& pool);
+
+  uint64_t next(uint64_t size, velox::VectorPtr& result) override;
+
+  void updateRuntimeStats(
+      dwio::common::RuntimeStatistics& stats) const override;
+
+  void resetFilterCaches() override;
+
+  std::optional<size_t> estimatedRowSize() const override;
+
+ private:
+  // Reads the next batch of the split and imports the columns the scan
+  // needs into 'columns_'. Returns false if there are no more batches.
+  bool loadBatch();
+
+  const std::shared_ptr<::arrow::ipc::RecordBatchFileReader> reader_;
+  const RowTypePtr fileType_;
+  memory::MemoryPool& pool_;
+  const std::shared_ptr<common::ScanSpec> scanSpec_;
+
+  // The type of the result. This has the channels of the ScanSpec if
+  // there is one. Otherwise this is the selected columns of the file, or
+  // the whole file if there is no selector.
+  RowTypePtr rowType_;
+
+  // The record batches in the split.
+  std::vector<int32_t> batches_;
+
+  // The columns of the file the scan reads, i.e. the projected and the
+  // filtered ones.
+  std::vector<column_index_t> readColumns_;
+
+  // Index in 'batches_' of the next batch to load.
+  size_t nextBatch_{0};
+
+  // The current batch, its columns imported to Velox indexed as in the
+  // file and the first row of it not yet returned. The columns not in
+  // 'readColumns_' are null.
+  std::shared_ptr<::arrow::RecordBatch> batch_;
+  std::vector<VectorPtr> columns_;
+  vector_size_t batchOffset_{0};
+};
+
+// Reader for Arrow IPC files, also known as Feather V2. A local file is
+// memory mapped. Other files are read into memory in one piece. In both
+// cases the vectors returned by the row readers refer to the file bytes
+// without copying them.
+class ArrowReader : public dwio::common::Reader {
+ public:
+  ArrowReader(
+      std::unique_ptr<dwio::common::InputStream> stream,
+      const dwio::common::ReaderOptions& options);
+
+  std::optional<uint64_t> numberOfRows() const override;
+
+  std::unique_ptr<dwio::common::ColumnStatistics> columnStatistics(
+      uint32_t index) const override;
+
+  const velox::RowTypePtr& rowType() const override;
+
+  const std::shared_ptr<const dwio::common::TypeWithId>& typeWithId()
+      const override;
+
+  std::unique_ptr<dwio::common::RowReader> createRowReader(
+      const dwio::common::RowReaderOptions& options = {}) const override;
+
+ private:
+  memory::MemoryPool& pool_;
+  uint64_t fileLength_;
+  std::shared_ptr<::arrow::io::RandomAccessFile> file_;
+  std::shared_ptr<::arrow::ipc::RecordBatchFileReader> reader_;
+  RowTypePtr type_;
+  mutable std::shared_ptr<const dwio::common::TypeWithId> typeWithId_;
+};
+
+class ArrowReaderFactory : public dwio::common::ReaderFactory {
+ public:
+  ArrowReaderFactory() : ReaderFactory(dwio::common::FileFormat::ARROW) {}
+
+  std::unique_ptr<dwio::common::Reader> createReader(
+      std::unique_ptr<dwio::common::InputStream> stream,
+      const dwio::common::ReaderOptions& options) override {
+    return std::make_unique<ArrowReader>(std::move(stream), options);
+  }
+};
+
+void registerArrowReaderFactory();
+
+void unregisterArrowReaderFactory();
+
+} // namespace facebook::velox::arrow_ipc
@@ -0,0 +1,212 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "velox/dwio/arrow/ArrowReader.h"
+
+#include <arrow/c/bridge.h> // @manual
+#include <arrow/io/file.h> // @manual
+#include <arrow/ipc/writer.h> // @manual
+#include <arrow/record_batch.h> // @manual
+#include <gtest/gtest.h>
+#include <filesystem>
+
+#include "velox/exec/tests/utils/TempFilePath.h"
+#include "velox/vector/arrow/Bridge.h"
+#include "velox/vector/tests/VectorTestBase.h"
+
+using namespace facebook::velox;
+using namespace facebook::velox::arrow_ipc;
+using namespace facebook::velox::test;
+
+class ArrowReaderTest : public testing::Test, public VectorTestBase {
+ protected:
+  static constexpr vector_size_t kBatchSize = 100;
+  static constexpr int32_t kNumBatches = 3;
+
+  void SetUp() override {
+    file_ = exec::test::TempFilePath::create();
+    for (auto i = 0; i < kNumBatches; ++i) {
+      auto first = i * kBatchSize;
+      batches_.push_back(makeRowVector(
+          {"a", "b", "c"},
+          {makeFlatVector<int64_t>(
+               kBatchSize, [&](auto row) { return first + row; }),
+           makeFlatVector<double>(
+               kBatchSize, [&](auto row) { return (first + row) * 0.5; }),
+           makeFlatVector<StringView>(
+               kBatchSize,
+               [&](auto row) {
+                 return StringView(
+                     fmt::format("string value {}", first + row));
+               },
+               nullEvery(7))}));
+    }
+    writeFile();
+  }
+
+  // Writes 'batches_' to 'file_' as one record batch each.
+  void writeFile() {
+    auto out = ::arrow::io::FileOutputStream::Open(file_->path).ValueOrDie();
+    std::shared_ptr<::arrow::ipc::RecordBatchWriter> writer;
+    for (auto& batch : batches_) {
+      ArrowArray arrowArray;
+      ArrowSchema arrowSchema;
+      exportToArrow(batch, arrowArray, pool());
+      exportToArrow(batch->type(), arrowSchema);
+      auto recordBatch =
+          ::arrow::ImportRecordBatch(&arrowArray, &arrowSchema).ValueOrDie();
+      if (!writer) {
+        writer = ::arrow::ipc::MakeFileWriter(out, recordBatch->schema())
+                     .ValueOrDie();
+      }
+      ASSERT_TRUE(writer->WriteRecordBatch(*recordBatch).ok());
+    }
+    ASSERT_TRUE(writer->Close().ok());
+    ASSERT_TRUE(out->Close().ok());
+  }
+
+  std::unique_ptr<dwio::common::Reader> makeReader() {
+    auto factory =
+        dwio::common::getReaderFactory(dwio::common::FileFormat::ARROW);
+    dwio::common::ReaderOptions options(pool());
+    return factory->createReader(
+        std::make_unique<dwio::common::FileInputStream>(file_->path),
+        options);
+  }
+
+  // Reads all rows with 'rowReader', 'size' at a time. Returns the number
+  // of rows scanned and appends the results to 'results'.
+  uint64_t readAll(
+      dwio::common::RowReader& rowReader,
+      uint64_t size,
+      std::vector<RowVectorPtr>& results) {
+    uint64_t numScanned = 0;
+    VectorPtr result;
+    while (auto numRows = rowReader.next(size, result)) {
+      EXPECT_LE(numRows, size);
+      numScanned += numRows;
+      results.push_back(std::dynamic_pointer_cast<RowVector>(result));
+    }
+    return numScanned;
+  }
+
+  // Checks that the rows of 'results' are the rows of 'batches_' for
+  // which 'keep' is true, projected to 'columns'.
+  void assertRows(
+      const std::vector<RowVectorPtr>& results,
+      const std::vector<column_index_t>& columns,
+      std::function<bool(vector_size_t)> keep) {
+    vector_size_t row = 0;
+    for (auto& result : results) {
+      ASSERT_EQ(result->childrenSize(), columns.size());
+      for (auto i = 0; i < result->size(); ++i) {
+        while (!keep(row)) {
+          ++row;
+        }
+        auto& batch = batches_[row / kBatchSize];
+        for (auto j = 0; j < columns.size(); ++j) {
+          ASSERT_TRUE(result->childAt(j)->equalValueAt(
+              batch->childAt(columns[j]).get(), i, row % kBatchSize))
+              << "at row " << row << " column " << columns[j];
+        }
+        ++row;
+      }
+    }
+    while (row < kBatchSize * kNumBatches) {
+      ASSERT_FALSE(keep(row)) << "missing row " << row;
+      ++row;
+    }
+  }
+
+  static void SetUpTestCase() {
+    registerArrowReaderFactory();
+  }
+
+  static void TearDownTestCase() {
+    unregisterArrowReaderFactory();
+  }
+
+  std::shared_ptr<exec::test::TempFilePath> file_;
+  std::vector<RowVectorPtr> batches_;
+};
+
+TEST_F(ArrowReaderTest, readAll) {
+  auto reader = makeReader();
+  EXPECT_EQ(reader->numberOfRows(), kBatchSize * kNumBatches);
+  EXPECT_EQ(*reader->rowType(), *batches_[0]->type());
+
+  auto rowReader = reader->createRowReader();
+  std::vector<RowVectorPtr> results;
+  EXPECT_EQ(readAll(*rowReader, 1000, results), kBatchSize * kNumBatches);
+  ASSERT_EQ(results.size(), kNumBatches);
+  for (auto i = 0; i < kNumBatches; ++i) {
+    assertEqualVectors(batches_[i], results[i]);
+  }
+}
+
+TEST_F(ArrowReaderTest, smallReads) {
+  auto reader = makeReader();
+  auto rowReader = reader->createRowReader();
+  std::vector<RowVectorPtr> results;
+  EXPECT_EQ(readAll(*rowReader, 30, results), kBatchSize * kNumBatches);
+  // Each batch of 100 rows is read as 30, 30, 30 and 10 rows.
+  EXPECT_EQ(results.size(), 4 * kNumBatches);
+  assertRows(results, {0, 1, 2}, [](auto) { return true; });
+}
+
+TEST_F(ArrowReaderTest, projectionAndFilters) {
+  auto reader = makeReader();
+  auto scanSpec = std::make_shared<common::ScanSpec>("");
+  // Returns c and b, filters on a which is not projected out.
+  auto c = scanSpec->getOrCreateChild(common::Subfield("c"));
+  c->setProjectOut(true);
+  c->setChannel(0);
+  c->setFilter(std::make_unique<common::IsNotNull>());
+  auto b = scanSpec->getOrCreateChild(common::Subfield("b"));
+  b->setProjectOut(true);
+  b->setChannel(1);
+  scanSpec->getOrCreateChild(common::Subfield("a"))
+      ->setFilter(std::make_unique<common::BigintRange>(50, 249, false));
+
+  dwio::common::RowReaderOptions options;
+  options.setScanSpec(scanSpec);
+  auto rowReader = reader->createRowReader(options);
+  std::vector<RowVectorPtr> results;
+  EXPECT_EQ(readAll(*rowReader, 1000, results), kBatchSize * kNumBatches);
+  for (auto& result : results) {
+    EXPECT_EQ(*result->type(), *ROW({"c", "b"}, {VARCHAR(), DOUBLE()}));
+  }
+  assertRows(results, {2, 1}, [](auto row) {
+    return row >= 50 && row <= 249 && row % kBatchSize % 7 != 0;
+  });
+}
+
+TEST_F(ArrowReaderTest, splits) {
+  auto reader = makeReader();
+  auto fileSize = std::filesystem::file_size(file_->path);
+  std::vector<RowVectorPtr> results;
+  uint64_t numScanned = 0;
+  // The batches are divided among splits of a third of the file each.
+  for (auto i = 0; i < 3; ++i) {
+    dwio::common::RowReaderOptions options;
+    auto begin = i * fileSize / 3;
+    options.range(begin, (i + 1) * fileSize / 3 - begin);
+    auto rowReader = reader->createRowReader(options);
+    numScanned += readAll(*rowReader, 1000, results);
+  }
+  EXPECT_EQ(numScanned, kBatchSize * kNumBatches);
+  assertRows(results, {0, 1, 2}, [](auto) { return true; });
+}
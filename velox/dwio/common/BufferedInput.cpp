@@ -16,6 +16,7 @@
 
 #include <fmt/format.h>
 
+#include "velox/common/time/Timer.h"
 #include "velox/dwio/common/BufferedInput.h"
 
 DEFINE_bool(wsVRLoad, false, "Use WS VRead API to load");
@@ -23,6 +24,12 @@ DEFINE_bool(wsVRLoad, false, "Use WS VRead API to load");
 namespace facebook::velox::dwio::common {
 
 void BufferedInput::load(const LogType logType) {
+  // The mapped regions are read on first access. Start reading them ahead.
+  for (const auto& region : mappedRegions_) {
+    input_.willNeed(region.offset, region.length);
+  }
+  mappedRegions_.clear();
+
   // no regions to load
   if (regions_.size() == 0) {
     return;
@@ -36,6 +43,9 @@ void BufferedInput::load(const LogType logType) {
   // sorting the regions from low to high
   std::sort(regions_.begin(), regions_.end());
 
+  auto& latencyModel = IoLatencyModel::forPath(input_.getName());
+  maxMergeDistance_ = latencyModel.maxCoalesceDistance(kMaxMergeDistance);
+
   if (UNLIKELY(FLAGS_wsVRLoad)) {
     std::vector<void*> buffers;
     std::vector<Region> regions;
@@ -54,8 +64,17 @@ void BufferedInput::load(const LogType logType) {
   } else {
     loadWithAction(
         logType,
-        [this](void* buf, uint64_t length, uint64_t offset, LogType type) {
-          input_.read(buf, length, offset, type);
+        [this, &latencyModel](
+            void* buf, uint64_t length, uint64_t offset, LogType type) {
+          uint64_t usec = 0;
+          {
+            MicrosecondTimer timer(&usec);
+            input_.read(buf, length, offset, type);
+          }
+          latencyModel.recordRead(length, usec);
+          if (auto* stats = input_.getStats()) {
+            stats->storageReadLatency().increment(usec);
+          }
         });
   }
 
@@ -77,6 +96,14 @@ std::unique_ptr<SeekableInputStream> BufferedInput::enqueue(
     return ret;
   }
 
+  // A mapped file is read in place.
+  if (auto data =
+          input_.readInPlace(region.offset, region.length, LogType::STREAM)) {
+    mappedRegions_.push_back(region);
+    return std::make_unique<SeekableArrayInputStream>(
+        data->data(), data->size());
+  }
+
   // push to region pool and give the caller the callback
   regions_.push_back(region);
   return std::make_unique<SeekableArrayInputStream>(
@@ -109,7 +136,7 @@ bool BufferedInput::tryMerge(Region& first, const Region& second) {
   int64_t gap = second.offset - first.offset - first.length;
 
   // compare with 0 since it's comparison in different types
-  if (gap < 0 || gap <= kMaxMergeDistance) {
+  if (gap < 0 || gap <= maxMergeDistance_) {
     // ensure try merge will handle duplicate regions (extension==0)
     int64_t extension = gap + second.length;
 
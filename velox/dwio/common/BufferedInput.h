@@ -17,6 +17,7 @@
 #pragma once
 
 #include "velox/dwio/common/DataBuffer.h"
+#include "velox/dwio/common/IoLatencyModel.h"
 #include "velox/dwio/common/SeekableInputStream.h"
 #include "velox/dwio/common/StreamIdentifier.h"
 
@@ -24,6 +25,8 @@ namespace facebook::velox::dwio::common {
 
 class BufferedInput {
  public:
+  // Merge distance used until the IoLatencyModel of the storage has
+  // enough samples.
   constexpr static uint64_t kMaxMergeDistance = 1024 * 1024 * 1.25;
   BufferedInput(InputStream& input, memory::MemoryPool& pool)
       : input_{input}, pool_{pool} {}
@@ -59,6 +62,10 @@ class BufferedInput {
   read(uint64_t offset, uint64_t length, LogType logType) const {
     std::unique_ptr<SeekableInputStream> ret = readBuffer(offset, length);
     if (!ret) {
+      if (auto data = input_.readInPlace(offset, length, logType)) {
+        return std::make_unique<SeekableArrayInputStream>(
+            data->data(), data->size());
+      }
       VLOG(1) << "Unplanned read. Offset: " << offset << ", Length: " << length;
       // We cannot do enqueue/load here because load() clears previously laoded
       // data. TODO: figure out how we can use the data cache for
@@ -94,6 +101,12 @@ class BufferedInput {
   std::vector<uint64_t> offsets_;
   std::vector<DataBuffer<char>> buffers_;
   std::vector<Region> regions_;
+  // Regions enqueued from a mapped file. These are not loaded but hinted to
+  // the file in load().
+  std::vector<Region> mappedRegions_;
+  // Largest gap between regions that are read together. Set from the
+  // IoLatencyModel of the storage at each load().
+  uint64_t maxMergeDistance_{kMaxMergeDistance};
 
   std::unique_ptr<SeekableInputStream> readBuffer(
       uint64_t offset,
@@ -141,7 +141,8 @@ void CacheInputStream::loadSync(Region region) {
     folly::SemiFuture<bool> wait(false);
     cache::RawFileCacheKey key{fileNum_, region.offset};
     pin_.clear();
-    pin_ = cache_->findOrCreate(key, region.length, &wait);
+    pin_ = cache_->findOrCreate(
+        key, region.length, &wait, bufferedInput_->quotaGroup());
     if (pin_.empty()) {
       VELOX_CHECK(wait.valid());
       auto& exec = folly::QueuedImmediateExecutor::instance();
@@ -150,7 +151,7 @@ void CacheInputStream::loadSync(Region region) {
         MicrosecondTimer timer(&usec);
         std::move(wait).via(&exec).wait();
       }
-      ioStats_->queryThreadIoLatency().increment(usec);
+      ioStats_->incQueryThreadIoLatency(usec);
       continue;
     }
     auto entry = pin_.checkedEntry();
@@ -167,7 +168,7 @@ void CacheInputStream::loadSync(Region region) {
         input_.read(ranges, region.offset, LogType::FILE);
       }
       ioStats_->read().increment(region.length);
-      ioStats_->queryThreadIoLatency().increment(usec);
+      ioStats_->incQueryThreadIoLatency(usec);
       entry->setExclusiveToShared();
     } else {
       if (!entry->getAndClearFirstUseFlag()) {
@@ -229,7 +230,7 @@ bool CacheInputStream::loadFromSsd(
   }
   pin_ = std::move(pins[0]);
   ioStats_->ssdRead().increment(entry.size());
-  ioStats_->queryThreadIoLatency().increment(usec);
+  ioStats_->incQueryThreadIoLatency(usec);
   entry.setExclusiveToShared();
   return true;
 }
@@ -254,7 +255,7 @@ void CacheInputStream::loadPosition() {
           LOG(ERROR) << "IOERR: error in coalesced load " << e.what();
         }
       }
-      ioStats_->queryThreadIoLatency().increment(usec);
+      ioStats_->incQueryThreadIoLatency(usec);
     }
     auto loadRegion = region_;
     // Quantize position to previous multiple of 'loadQuantum_'.
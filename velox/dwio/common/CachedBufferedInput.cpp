@@ -16,6 +16,7 @@
 
 #include "velox/dwio/common/CachedBufferedInput.h"
 #include "velox/common/process/TraceContext.h"
+#include "velox/common/time/Timer.h"
 #include "velox/dwio/common/CacheInputStream.h"
 
 DEFINE_int32(
@@ -207,7 +208,9 @@ void CachedBufferedInput::makeLoads(
     return;
   }
   bool isSsd = !requests[0]->ssdPin.empty();
-  int32_t maxDistance = isSsd ? 20000 : maxCoalesceDistance_;
+  int32_t maxDistance = isSsd
+      ? 20000
+      : latencyModel_.maxCoalesceDistance(maxCoalesceDistance_);
   std::sort(
       requests.begin(),
       requests.end(),
@@ -267,11 +270,13 @@ class DwioCoalescedLoadBase : public cache::CoalescedLoad {
       cache::AsyncDataCache& cache,
       std::shared_ptr<IoStatistics> ioStats,
       uint64_t groupId,
+      int32_t quotaGroup,
       std::vector<CacheRequest*> requests)
       : CoalescedLoad(makeKeys(requests), makeSizes(requests)),
         cache_(cache),
         ioStats_(std::move(ioStats)),
-        groupId_(groupId) {
+        groupId_(groupId),
+        quotaGroup_(quotaGroup) {
     for (auto& request : requests) {
       requests_.push_back(std::move(*request));
     }
@@ -334,6 +339,7 @@ class DwioCoalescedLoadBase : public cache::CoalescedLoad {
   std::vector<CacheRequest> requests_;
   std::shared_ptr<IoStatistics> ioStats_;
   const uint64_t groupId_;
+  const int32_t quotaGroup_;
 };
 
 // Represents a CoalescedLoad from ReadFile, e.g. disagg disk.
@@ -344,10 +350,18 @@ class DwioCoalescedLoad : public DwioCoalescedLoadBase {
       std::unique_ptr<AbstractInputStreamHolder> input,
       std::shared_ptr<IoStatistics> ioStats,
       uint64_t groupId,
+      int32_t quotaGroup,
       std::vector<CacheRequest*> requests,
+      IoLatencyModel& latencyModel,
       int32_t maxCoalesceDistance)
-      : DwioCoalescedLoadBase(cache, ioStats, groupId, std::move(requests)),
+      : DwioCoalescedLoadBase(
+            cache,
+            ioStats,
+            groupId,
+            quotaGroup,
+            std::move(requests)),
         input_(std::move(input)),
+        latencyModel_(latencyModel),
         maxCoalesceDistance_(maxCoalesceDistance) {}
 
   std::vector<CachePin> loadData(bool isPrefetch) override {
@@ -359,13 +373,14 @@ class DwioCoalescedLoad : public DwioCoalescedLoadBase {
         [&](int32_t index) { return sizes_[index]; },
         [&](int32_t /*index*/, CachePin pin) {
           pins.push_back(std::move(pin));
-        });
+        },
+        quotaGroup_);
     if (pins.empty()) {
       return pins;
     }
     auto stats = cache::readPins(
         pins,
-        maxCoalesceDistance_,
+        latencyModel_.maxCoalesceDistance(maxCoalesceDistance_),
         1000,
         [&](int32_t i) { return pins[i].entry()->offset(); },
         [&](const std::vector<CachePin>& /*pins*/,
@@ -373,13 +388,26 @@ class DwioCoalescedLoad : public DwioCoalescedLoadBase {
             int32_t /*end*/,
             uint64_t offset,
             const std::vector<folly::Range<char*>>& buffers) {
-          stream.read(buffers, offset, LogType::FILE);
+          uint64_t usec = 0;
+          {
+            MicrosecondTimer timer(&usec);
+            stream.read(buffers, offset, LogType::FILE);
+          }
+          uint64_t bytes = 0;
+          for (auto& buffer : buffers) {
+            bytes += buffer.size();
+          }
+          latencyModel_.recordRead(bytes, usec);
+          if (ioStats_) {
+            ioStats_->storageReadLatency().increment(usec);
+          }
         });
     updateStats(stats, isPrefetch, false);
     return pins;
   }
 
   std::unique_ptr<AbstractInputStreamHolder> input_;
+  IoLatencyModel& latencyModel_;
   const int32_t maxCoalesceDistance_;
 };
 
@@ -390,8 +418,14 @@ class SsdLoad : public DwioCoalescedLoadBase {
       cache::AsyncDataCache& cache,
       std::shared_ptr<IoStatistics> ioStats,
       uint64_t groupId,
+      int32_t quotaGroup,
       std::vector<CacheRequest*> requests)
-      : DwioCoalescedLoadBase(cache, ioStats, groupId, std::move(requests)) {}
+      : DwioCoalescedLoadBase(
+            cache,
+            ioStats,
+            groupId,
+            quotaGroup,
+            std::move(requests)) {}
 
   std::vector<CachePin> loadData(bool isPrefetch) override {
     std::vector<SsdPin> ssdPins;
@@ -402,7 +436,8 @@ class SsdLoad : public DwioCoalescedLoadBase {
         [&](int32_t index, CachePin pin) {
           pins.push_back(std::move(pin));
           ssdPins.push_back(std::move(requests_[index].ssdPin));
-        });
+        },
+        quotaGroup_);
     if (pins.empty()) {
       return pins;
     }
@@ -423,14 +458,17 @@ void CachedBufferedInput::readRegion(
   }
   std::shared_ptr<cache::CoalescedLoad> load;
   if (!requests[0]->ssdPin.empty()) {
-    load = std::make_shared<SsdLoad>(*cache_, ioStats_, groupId_, requests);
+    load = std::make_shared<SsdLoad>(
+        *cache_, ioStats_, groupId_, quotaGroup_, requests);
   } else {
     load = std::make_shared<DwioCoalescedLoad>(
         *cache_,
         streamSource_(),
         ioStats_,
         groupId_,
+        quotaGroup_,
         requests,
+        latencyModel_,
         maxCoalesceDistance_);
   }
   allCoalescedLoads_.push_back(load);
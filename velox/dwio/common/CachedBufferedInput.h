@@ -24,6 +24,7 @@
 #include "velox/dwio/common/BufferedInput.h"
 #include "velox/dwio/common/CacheInputStream.h"
 #include "velox/dwio/common/InputStream.h"
+#include "velox/dwio/common/IoLatencyModel.h"
 #include "velox/dwio/common/IoStatistics.h"
 #include "velox/dwio/common/Options.h"
 
@@ -84,7 +85,8 @@ class CachedBufferedInput : public BufferedInput {
       std::shared_ptr<IoStatistics> ioStats,
       folly::Executor* FOLLY_NULLABLE executor,
       int32_t loadQuantum,
-      int32_t maxCoalesceDistance)
+      int32_t maxCoalesceDistance,
+      int32_t quotaGroup = cache::AsyncDataCache::kDefaultQuotaGroup)
       : BufferedInput(input, pool),
         cache_(cache),
         fileNum_(fileNum),
@@ -95,7 +97,9 @@ class CachedBufferedInput : public BufferedInput {
         executor_(executor),
         fileSize_(input.getLength()),
         loadQuantum_(loadQuantum),
-        maxCoalesceDistance_(maxCoalesceDistance) {}
+        maxCoalesceDistance_(maxCoalesceDistance),
+        latencyModel_(IoLatencyModel::forPath(input.getName())),
+        quotaGroup_(quotaGroup) {}
 
   ~CachedBufferedInput() override {
     for (auto& load : allCoalescedLoads_) {
@@ -135,6 +139,11 @@ class CachedBufferedInput : public BufferedInput {
     return cache_;
   }
 
+  // Quota group that the cache entries made by 'this' are charged to.
+  int32_t quotaGroup() const {
+    return quotaGroup_;
+  }
+
   // Returns the CoalescedLoad that contains the correlated loads for
   // 'stream' or nullptr if none. Returns nullptr on all but first
   // call for 'stream' since the load is to be triggered by the first
@@ -176,7 +185,14 @@ class CachedBufferedInput : public BufferedInput {
 
   const uint64_t fileSize_;
   const int32_t loadQuantum_;
+  // Used until 'latencyModel_' has enough samples to pick the coalesce
+  // distance.
   const int32_t maxCoalesceDistance_;
+
+  // Latency and bandwidth of the storage of 'input_'. Shared by all
+  // files on the same storage.
+  IoLatencyModel& latencyModel_;
+  const int32_t quotaGroup_;
 };
 
 class CachedBufferedInputFactory : public BufferedInputFactory {
@@ -188,7 +204,8 @@ class CachedBufferedInputFactory : public BufferedInputFactory {
       StreamSource streamSource,
       std::shared_ptr<IoStatistics> ioStats,
       folly::Executor* FOLLY_NULLABLE executor,
-      const ReaderOptions& readerOpts)
+      const ReaderOptions& readerOpts,
+      int32_t quotaGroup = cache::AsyncDataCache::kDefaultQuotaGroup)
       : cache_(cache),
         tracker_(std::move(tracker)),
         groupId_(groupId),
@@ -196,7 +213,8 @@ class CachedBufferedInputFactory : public BufferedInputFactory {
         ioStats_(ioStats),
         executor_(executor),
         loadQuantum_(readerOpts.loadQuantum()),
-        maxCoalesceDistance_(readerOpts.maxCoalesceDistance()) {}
+        maxCoalesceDistance_(readerOpts.maxCoalesceDistance()),
+        quotaGroup_(quotaGroup) {}
 
   std::unique_ptr<BufferedInput> create(
       InputStream& input,
@@ -213,7 +231,8 @@ class CachedBufferedInputFactory : public BufferedInputFactory {
         ioStats_,
         executor_,
         loadQuantum_,
-        maxCoalesceDistance_);
+        maxCoalesceDistance_,
+        quotaGroup_);
   }
 
   std::string toString() const {
@@ -236,5 +255,6 @@ class CachedBufferedInputFactory : public BufferedInputFactory {
   folly::Executor* FOLLY_NULLABLE executor_;
   int32_t loadQuantum_;
   int32_t maxCoalesceDistance_;
+  int32_t quotaGroup_;
 };
 } // namespace facebook::velox::dwio::common
@@ -211,6 +211,20 @@ bool ReadFileInputStream::hasReadAsync() const {
   return readFile_->hasPreadvAsync();
 }
 
+std::optional<std::string_view> ReadFileInputStream::readInPlace(
+    uint64_t offset,
+    uint64_t length,
+    LogType logType) {
+  auto data = readFile_->readInPlace(offset, length);
+  if (data.has_value()) {
+    logRead(offset, length, logType);
+    if (stats_) {
+      stats_->incRawBytesRead(length);
+    }
+  }
+  return data;
+}
+
 bool Region::operator<(const Region& other) const {
   return offset < other.offset ||
       (offset == other.offset && length < other.length);
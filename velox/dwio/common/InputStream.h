@@ -25,7 +25,9 @@
 #include <functional>
 #include <memory>
 #include <mutex>
+#include <optional>
 #include <string>
+#include <string_view>
 #include <thread>
 #include <utility>
 #include <vector>
@@ -125,6 +127,17 @@ class InputStream {
     return false;
   }
 
+  /// Returns a view of 'length' bytes at 'offset' that stays valid as long
+  /// as 'this' if the file is mapped, so that the bytes need not be copied.
+  /// Returns std::nullopt if the bytes must be read with read().
+  virtual std::optional<std::string_view>
+  readInPlace(uint64_t /*offset*/, uint64_t /*length*/, LogType /*logType*/) {
+    return std::nullopt;
+  }
+
+  /// Hints that 'length' bytes at 'offset' will be read soon.
+  virtual void willNeed(uint64_t /*offset*/, uint64_t /*length*/) {}
+
   /**
    * Take advantage of vectorized read API provided by some file system.
    * Allow file system to do optimzied reading plan to disk to minimize
@@ -216,6 +229,13 @@ class ReadFileInputStream final : public InputStream {
 
   bool hasReadAsync() const override;
 
+  std::optional<std::string_view>
+  readInPlace(uint64_t offset, uint64_t length, LogType logType) override;
+
+  void willNeed(uint64_t offset, uint64_t length) override {
+    readFile_->willNeed(offset, length);
+  }
+
  private:
   velox::ReadFile* FOLLY_NONNULL readFile_;
 };
@@ -0,0 +1,107 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "velox/dwio/common/IoLatencyModel.h"
+
+#include <algorithm>
+#include <memory>
+#include <unordered_map>
+
+namespace facebook::velox::dwio::common {
+
+// static
+std::string_view IoLatencyModel::storageName(std::string_view path) {
+  auto colon = path.find(':');
+  if (colon == std::string_view::npos || colon == 0 ||
+      path.substr(0, colon).find('/') != std::string_view::npos) {
+    return "file";
+  }
+  return path.substr(0, colon);
+}
+
+// static
+IoLatencyModel& IoLatencyModel::forPath(std::string_view path) {
+  static std::mutex mutex;
+  static std::unordered_map<std::string, std::unique_ptr<IoLatencyModel>>
+      models;
+  std::string name(storageName(path));
+  std::lock_guard<std::mutex> l(mutex);
+  auto& model = models[name];
+  if (!model) {
+    model = std::make_unique<IoLatencyModel>();
+  }
+  return *model;
+}
+
+void IoLatencyModel::recordRead(uint64_t bytes, uint64_t latencyUs) {
+  double x = bytes;
+  double y = latencyUs;
+  std::lock_guard<std::mutex> l(mutex_);
+  count_ = count_ * kDecay + 1;
+  sumX_ = sumX_ * kDecay + x;
+  sumY_ = sumY_ * kDecay + y;
+  sumXX_ = sumXX_ * kDecay + x * x;
+  sumXY_ = sumXY_ * kDecay + x * y;
+  ++numSamples_;
+}
+
+bool IoLatencyModel::fitLocked(double& latencyUs, double& bytesPerUs) const {
+  if (numSamples_ < kMinSamples) {
+    return false;
+  }
+  double denominator = count_ * sumXX_ - sumX_ * sumX_;
+  // Sizes must vary for the fit to separate latency from transfer time.
+  if (denominator <= 1e-6 * count_ * sumXX_) {
+    return false;
+  }
+  double usPerByte = (count_ * sumXY_ - sumX_ * sumY_) / denominator;
+  double intercept = (sumY_ - usPerByte * sumX_) / count_;
+  if (usPerByte <= 0 || intercept <= 0) {
+    return false;
+  }
+  latencyUs = intercept;
+  bytesPerUs = 1 / usPerByte;
+  return true;
+}
+
+int32_t IoLatencyModel::maxCoalesceDistance(int32_t defaultDistance) const {
+  double latency;
+  double rate;
+  {
+    std::lock_guard<std::mutex> l(mutex_);
+    if (!fitLocked(latency, rate)) {
+      return defaultDistance;
+    }
+  }
+  return std::clamp<double>(
+      latency * rate, kMinCoalesceDistance, kMaxCoalesceDistance);
+}
+
+double IoLatencyModel::latencyUs() const {
+  double latency;
+  double rate;
+  std::lock_guard<std::mutex> l(mutex_);
+  return fitLocked(latency, rate) ? latency : 0;
+}
+
+double IoLatencyModel::bytesPerUs() const {
+  double latency;
+  double rate;
+  std::lock_guard<std::mutex> l(mutex_);
+  return fitLocked(latency, rate) ? rate : 0;
+}
+
+} // namespace facebook::velox::dwio::common
@@ -0,0 +1,88 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <string_view>
+
+namespace facebook::velox::dwio::common {
+
+// Estimates the per-request latency and the transfer rate of a storage
+// system from the timing of reads against it. Two reads separated by a
+// gap are worth merging if transferring the gap takes less time than
+// the latency of a separate request, so the largest gap worth reading
+// through is latency * bandwidth. The estimate follows the storage:
+// object stores with tens of ms of first byte latency coalesce across
+// megabytes while a local file coalesces only across small gaps.
+//
+// The model is a least squares fit of 'time = latency + bytes /
+// bandwidth' over exponentially decayed samples, so that it tracks
+// changes in load on the storage.
+class IoLatencyModel {
+ public:
+  // Number of samples needed before the fit is used.
+  static constexpr int32_t kMinSamples = 16;
+
+  // Weight of the previous samples when adding a new one.
+  static constexpr double kDecay = 0.99;
+
+  // Bounds for the coalesce distance produced by the model.
+  static constexpr int32_t kMinCoalesceDistance = 4 << 10;
+  static constexpr int32_t kMaxCoalesceDistance = 16 << 20;
+
+  // Returns the process-wide model for the storage of 'path'. Models
+  // are keyed on the scheme of 'path', e.g. "s3" or "hdfs", paths
+  // without a scheme are "file".
+  static IoLatencyModel& forPath(std::string_view path);
+
+  // Returns the scheme that identifies the storage of 'path'.
+  static std::string_view storageName(std::string_view path);
+
+  // Records a read of 'bytes' that took 'latencyUs'.
+  void recordRead(uint64_t bytes, uint64_t latencyUs);
+
+  // Returns the largest gap in bytes that is cheaper to read through
+  // than to skip with a separate request. Returns 'defaultDistance'
+  // until the samples are enough to estimate both latency and
+  // bandwidth.
+  int32_t maxCoalesceDistance(int32_t defaultDistance) const;
+
+  // Estimated per-request latency in microseconds or 0 if not known.
+  double latencyUs() const;
+
+  // Estimated transfer rate in bytes per microsecond or 0 if not known.
+  double bytesPerUs() const;
+
+ private:
+  // Fits the model. Returns false if the samples do not determine it,
+  // e.g. all reads had the same size.
+  bool fitLocked(double& latencyUs, double& bytesPerUs) const;
+
+  mutable std::mutex mutex_;
+
+  // Decayed number of samples and sums over sizes (x) and times (y).
+  double count_{0};
+  double sumX_{0};
+  double sumY_{0};
+  double sumXX_{0};
+  double sumXY_{0};
+  int64_t numSamples_{0};
+};
+
+} // namespace facebook::velox::dwio::common
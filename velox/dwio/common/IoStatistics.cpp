@@ -15,6 +15,7 @@
  */
 
 #include <glog/logging.h>
+#include <algorithm>
 #include <atomic>
 #include <utility>
 
@@ -86,6 +87,33 @@ IoStatistics::operationStats() const {
   return operationStats_;
 }
 
+void IoStatistics::incHostLatency(
+    const std::string& host,
+    uint64_t latencyUs) {
+  std::lock_guard<std::mutex> lock{hostLatencyStatsMutex_};
+  auto& counters = hostLatencyStats_[host];
+  ++counters.count;
+  counters.totalLatencyUs += latencyUs;
+  counters.maxLatencyUs = std::max(counters.maxLatencyUs, latencyUs);
+}
+
+std::unordered_map<std::string, HostLatencyCounters>
+IoStatistics::hostLatencyStats() const {
+  std::lock_guard<std::mutex> lock{hostLatencyStatsMutex_};
+  return hostLatencyStats_;
+}
+
+void IoStatistics::incQueryThreadIoLatency(uint64_t latencyUs) {
+  queryThreadIoLatency_.increment(latencyUs);
+  std::lock_guard<std::mutex> lock{queryThreadIoLatencyMutex_};
+  queryThreadIoLatencyHistogram_.add(latencyUs * 1'000);
+}
+
+RuntimeHistogram IoStatistics::queryThreadIoLatencyHistogram() const {
+  std::lock_guard<std::mutex> lock{queryThreadIoLatencyMutex_};
+  return queryThreadIoLatencyHistogram_;
+}
+
 void IoStatistics::merge(const IoStatistics& other) {
   rawBytesRead_ += other.rawBytesRead_;
   rawBytesWritten_ += other.rawBytesWritten_;
@@ -96,10 +124,29 @@ void IoStatistics::merge(const IoStatistics& other) {
   ramHit_.merge(other.ramHit_);
   ssdRead_.merge(other.ssdRead_);
   queryThreadIoLatency_.merge(other.queryThreadIoLatency_);
+  backgroundDecompression_.merge(other.backgroundDecompression_);
+  queryThreadDecompressionLatency_.merge(
+      other.queryThreadDecompressionLatency_);
+  decryption_.merge(other.decryption_);
+  storageReadLatency_.merge(other.storageReadLatency_);
   std::lock_guard<std::mutex> l(operationStatsMutex_);
   for (auto& item : other.operationStats_) {
     operationStats_[item.first].merge(item.second);
   }
+  auto otherHostLatencyStats = other.hostLatencyStats();
+  std::lock_guard<std::mutex> hostLock(hostLatencyStatsMutex_);
+  for (auto& item : otherHostLatencyStats) {
+    hostLatencyStats_[item.first].merge(item.second);
+  }
+  auto otherIoLatency = other.queryThreadIoLatencyHistogram();
+  std::lock_guard<std::mutex> ioLatencyLock(queryThreadIoLatencyMutex_);
+  queryThreadIoLatencyHistogram_.merge(otherIoLatency);
+}
+
+void HostLatencyCounters::merge(const HostLatencyCounters& other) {
+  count += other.count;
+  totalLatencyUs += other.totalLatencyUs;
+  maxLatencyUs = std::max(maxLatencyUs, other.maxLatencyUs);
 }
 
 void OperationCounters::merge(const OperationCounters& other) {
@@ -24,6 +24,8 @@
 
 #include <folly/dynamic.h>
 
+#include "velox/common/base/RuntimeMetrics.h"
+
 namespace facebook::velox::dwio::common {
 
 struct OperationCounters {
@@ -38,6 +40,15 @@ struct OperationCounters {
   void merge(const OperationCounters& other);
 };
 
+// Latency of the reads served by one storage host, e.g. an HDFS datanode.
+struct HostLatencyCounters {
+  uint64_t count{0};
+  uint64_t totalLatencyUs{0};
+  uint64_t maxLatencyUs{0};
+
+  void merge(const HostLatencyCounters& other);
+};
+
 class IoCounter {
  public:
   uint64_t count() const {
@@ -97,6 +108,30 @@ class IoStatistics {
     return queryThreadIoLatency_;
   }
 
+  // Records a wait of 'latencyUs' by a query thread for IO. Adds to
+  // queryThreadIoLatency() and to the histogram of the waits.
+  void incQueryThreadIoLatency(uint64_t latencyUs);
+
+  // Returns the distribution of the IO waits of query threads in
+  // nanoseconds.
+  RuntimeHistogram queryThreadIoLatencyHistogram() const;
+
+  IoCounter& backgroundDecompression() {
+    return backgroundDecompression_;
+  }
+
+  IoCounter& queryThreadDecompressionLatency() {
+    return queryThreadDecompressionLatency_;
+  }
+
+  IoCounter& decryption() {
+    return decryption_;
+  }
+
+  IoCounter& storageReadLatency() {
+    return storageReadLatency_;
+  }
+
   void incOperationCounters(
       const std::string& operation,
       const uint64_t resourceThrottleCount,
@@ -108,6 +143,12 @@ class IoStatistics {
 
   std::unordered_map<std::string, OperationCounters> operationStats() const;
 
+  // Records a read served by 'host' that took 'latencyUs'.
+  void incHostLatency(const std::string& host, uint64_t latencyUs);
+
+  std::unordered_map<std::string, HostLatencyCounters> hostLatencyStats()
+      const;
+
   void merge(const IoStatistics& other);
 
   folly::dynamic getOperationStatsSnapshot() const;
@@ -136,8 +177,31 @@ class IoStatistics {
   // issued IO or for an in-progress read-ahead to finish.
   IoCounter queryThreadIoLatency_;
 
+  // Nanoseconds of each wait counted in 'queryThreadIoLatency_'.
+  RuntimeHistogram queryThreadIoLatencyHistogram_;
+  mutable std::mutex queryThreadIoLatencyMutex_;
+
+  // Time in microseconds spent decompressing blocks on an executor, ahead
+  // of and overlapped with the query thread.
+  IoCounter backgroundDecompression_;
+
+  // Time in microseconds a query processing thread waited for the
+  // background decompression of a block it needed.
+  IoCounter queryThreadDecompressionLatency_;
+
+  // Time in microseconds spent decrypting blocks read ahead.
+  IoCounter decryption_;
+
+  // Time in microseconds of coalesced reads from storage. One count per
+  // read. Together with read() and rawOverreadBytes() shows the effect
+  // of the coalesce distance chosen by IoLatencyModel.
+  IoCounter storageReadLatency_;
+
   std::unordered_map<std::string, OperationCounters> operationStats_;
   mutable std::mutex operationStatsMutex_;
+
+  std::unordered_map<std::string, HostLatencyCounters> hostLatencyStats_;
+  mutable std::mutex hostLatencyStatsMutex_;
 };
 
 } // namespace facebook::velox::dwio::common
@@ -40,6 +40,8 @@ FileFormat toFileFormat(std::string s) {
     return FileFormat::ALPHA;
   } else if (s == "orc") {
     return FileFormat::ORC;
+  } else if (s == "arrow") {
+    return FileFormat::ARROW;
   }
   return FileFormat::UNKNOWN;
 }
@@ -64,6 +66,8 @@ std::string toString(FileFormat fmt) {
       return "alpha";
     case FileFormat::ORC:
       return "orc";
+    case FileFormat::ARROW:
+      return "arrow";
     default:
       return "unknown";
   }
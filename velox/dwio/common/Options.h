@@ -47,6 +47,7 @@ enum class FileFormat {
   PARQUET = 7,
   ALPHA = 8,
   ORC = 9,
+  ARROW = 10, // Arrow IPC file (Feather V2)
 };
 
 FileFormat toFileFormat(std::string s);
@@ -91,8 +92,23 @@ class RowReaderOptions {
   uint64_t dataStart;
   uint64_t dataLength;
   bool preloadStripe;
+  // Maximum size of a stripe that is read ahead while the previous stripe
+  // is decoded. 0 disables read-ahead.
+  uint64_t stripeReadAheadBytes_ = 0;
+  // Number of compression blocks of a stream decompressed ahead of the
+  // reader on the IO executor. 0 decompresses on the reader thread.
+  uint32_t decompressionBlocksAhead_ = 0;
+  // Number of Parquet row groups decoded ahead of the reader on the
+  // decoding executor. 0 decodes on the reader thread.
+  uint32_t rowGroupsAhead_ = 0;
+  // Decode the non-filter columns of a batch in parallel on the decoding
+  // executor.
+  bool parallelColumnDecoding_ = false;
   bool projectSelectedType;
   bool returnFlatVector_ = false;
+  // Return integer dictionary encoded columns as DictionaryVectors over the
+  // stripe dictionary where the values of a batch are all in it.
+  bool integerDictionaryOutput_ = false;
   ErrorTolerance errorTolerance_;
   std::shared_ptr<ColumnSelector> selector_;
   std::shared_ptr<velox::common::ScanSpec> scanSpec_ = nullptr;
@@ -115,7 +131,14 @@ class RowReaderOptions {
     selector_ = other.selector_;
     scanSpec_ = other.scanSpec_;
     returnFlatVector_ = other.returnFlatVector_;
+    integerDictionaryOutput_ = other.integerDictionaryOutput_;
     flatmapNodeIdAsStruct_ = other.flatmapNodeIdAsStruct_;
+    decodingExecutor_ = other.decodingExecutor_;
+    ioExecutor_ = other.ioExecutor_;
+    stripeReadAheadBytes_ = other.stripeReadAheadBytes_;
+    decompressionBlocksAhead_ = other.decompressionBlocksAhead_;
+    rowGroupsAhead_ = other.rowGroupsAhead_;
+    parallelColumnDecoding_ = other.parallelColumnDecoding_;
   }
 
   RowReaderOptions() noexcept
@@ -196,6 +219,59 @@ class RowReaderOptions {
     return preloadStripe;
   }
 
+  /**
+   * Read the next stripe ahead on the IO executor while the current stripe
+   * is decoded if the next stripe is at most 'bytes' long. Read-ahead needs
+   * an IO executor and is off by default.
+   */
+  void setStripeReadAheadBytes(uint64_t bytes) {
+    stripeReadAheadBytes_ = bytes;
+  }
+
+  uint64_t getStripeReadAheadBytes() const {
+    return stripeReadAheadBytes_;
+  }
+
+  /**
+   * Decompress up to 'blocks' compression blocks of each stream ahead of
+   * the reader, in parallel on the IO executor. Pays off for streams of
+   * many blocks, e.g. wide strings or maps. Needs an IO executor and is off
+   * by default.
+   */
+  void setDecompressionBlocksAhead(uint32_t blocks) {
+    decompressionBlocksAhead_ = blocks;
+  }
+
+  uint32_t getDecompressionBlocksAhead() const {
+    return decompressionBlocksAhead_;
+  }
+
+  /**
+   * Read and decode up to 'groups' Parquet row groups ahead of the reader,
+   * in parallel on the decoding executor. Needs a decoding executor and is
+   * off by default.
+   */
+  void setRowGroupsAhead(uint32_t groups) {
+    rowGroupsAhead_ = groups;
+  }
+
+  uint32_t getRowGroupsAhead() const {
+    return rowGroupsAhead_;
+  }
+
+  /**
+   * Decode the top level columns of a DWRF batch that have no filter in
+   * parallel on the decoding executor, after the filter columns. Needs a
+   * decoding executor and is off by default.
+   */
+  void setParallelColumnDecoding(bool parallel) {
+    parallelColumnDecoding_ = parallel;
+  }
+
+  bool getParallelColumnDecoding() const {
+    return parallelColumnDecoding_;
+  }
+
   // For flat map, return flat vector representation
   bool getReturnFlatVector() const {
     return returnFlatVector_;
@@ -206,6 +282,19 @@ class RowReaderOptions {
     returnFlatVector_ = value;
   }
 
+  bool getIntegerDictionaryOutput() const {
+    return integerDictionaryOutput_;
+  }
+
+  // Request that integer dictionary encoded columns without filters are
+  // returned as DictionaryVectors over the stripe dictionary instead of
+  // copying the dictionary entries. Applies to batches where all non-null
+  // values are in the stripe dictionary. String dictionary columns are
+  // always returned this way unless the ScanSpec asks for flat vectors.
+  void setIntegerDictionaryOutput(bool value) {
+    integerDictionaryOutput_ = value;
+  }
+
   /**
    * Request that the selected type be projected.
    */
@@ -339,7 +428,8 @@ class ReaderOptions {
         fileFormat(FileFormat::UNKNOWN),
         fileSchema(nullptr),
         autoPreloadLength(DEFAULT_AUTO_PRELOAD_SIZE),
-        prefetchMode(PrefetchMode::PREFETCH) {
+        prefetchMode(PrefetchMode::PREFETCH),
+        fileNum(std::numeric_limits<uint64_t>::max()) {
     // PASS
   }
 
@@ -69,6 +69,13 @@ class RowReader {
    * @return Estimate of the row size or std::nullopt if cannot estimate.
    */
   virtual std::optional<size_t> estimatedRowSize() const = 0;
+
+  /**
+   * Start loading the data of the next stripe to be read, if the format
+   * has stripes, so that next() finds it loaded or loading. Does nothing
+   * by default.
+   */
+  virtual void prefetchNextStripe() {}
 };
 
 /**
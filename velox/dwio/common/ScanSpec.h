@@ -40,6 +40,18 @@ class ScanSpec {
  public:
   static constexpr column_index_t kNoChannel = ~0;
 
+  // The parts of a list or map that are read.
+  enum class ElementAccess {
+    // Reads the lengths, keys and values.
+    kAll,
+    // Reads only the lengths, e.g. for cardinality(). The elements of the
+    // result are null.
+    kLengthsOnly,
+    // Reads the lengths and the keys of a map, e.g. for map_keys() or for
+    // checking that a key exists. The values of the result are null.
+    kKeysOnly
+  };
+
   explicit ScanSpec(const Subfield::PathElement& element) {
     if (element.kind() == kNestedField) {
       auto field = reinterpret_cast<const Subfield::NestedField*>(&element);
@@ -229,6 +241,22 @@ class ScanSpec {
     makeFlat_ = makeFlat;
   }
 
+  ElementAccess elementAccess() const {
+    return elementAccess_;
+  }
+
+  void setElementAccess(ElementAccess elementAccess) {
+    elementAccess_ = elementAccess;
+  }
+
+  bool makeRunLengthEncoded() const {
+    return makeRunLengthEncoded_;
+  }
+
+  void setMakeRunLengthEncoded(bool makeRunLengthEncoded) {
+    makeRunLengthEncoded_ = makeRunLengthEncoded;
+  }
+
   // True if this or a descendant has a filter. This may change as a
   // result of runtime adaptation.
   bool hasFilter() const;
@@ -280,6 +308,13 @@ class ScanSpec {
   // True if a string dictionary or flat map in this field should be
   // returned as flat.
   bool makeFlat_ = false;
+  // True if an integer field whose values are mostly long runs of the same
+  // value should be returned as a SequenceVector.
+  bool makeRunLengthEncoded_ = false;
+  // Parts of a list or map that are read. A filter on the keys or elements
+  // of a list or map passes the rows where at least one element passes and
+  // requires the list or map to be filter-only.
+  ElementAccess elementAccess_ = ElementAccess::kAll;
   std::unique_ptr<common::Filter> filter_;
   SelectivityInfo selectivity_;
   // Sort children by filtering efficiency.
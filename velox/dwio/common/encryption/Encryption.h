@@ -16,6 +16,8 @@
 
 #pragma once
 
+#include <vector>
+
 #include "folly/Range.h"
 #include "folly/io/IOBuf.h"
 #include "velox/dwio/common/exception/Exception.h"
@@ -89,6 +91,20 @@ class Decrypter {
   virtual std::unique_ptr<folly::IOBuf> decrypt(
       folly::StringPiece input) const = 0;
 
+  // Decrypts each of 'inputs'. Used for decrypting the blocks of a stream
+  // that are loaded together in one call, so that implementations can
+  // pipeline the blocks, e.g. by interleaving several AES-NI or VAES
+  // streams. The default decrypts the inputs one at a time.
+  virtual std::vector<std::unique_ptr<folly::IOBuf>> decryptBatch(
+      const std::vector<folly::StringPiece>& inputs) const {
+    std::vector<std::unique_ptr<folly::IOBuf>> result;
+    result.reserve(inputs.size());
+    for (auto& input : inputs) {
+      result.push_back(decrypt(input));
+    }
+    return result;
+  }
+
   virtual std::unique_ptr<Decrypter> clone() const = 0;
 };
 
@@ -0,0 +1,83 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <gtest/gtest.h>
+#include "velox/dwio/common/IoLatencyModel.h"
+
+using namespace facebook::velox::dwio::common;
+
+namespace {
+// Records reads of varying size from a storage with 'latencyUs' per
+// request and 'bytesPerUs' transfer rate.
+void recordReads(
+    IoLatencyModel& model,
+    int32_t numReads,
+    double latencyUs,
+    double bytesPerUs) {
+  for (auto i = 0; i < numReads; ++i) {
+    uint64_t bytes = (1 + i % 10) * 100'000;
+    model.recordRead(bytes, latencyUs + bytes / bytesPerUs);
+  }
+}
+} // namespace
+
+TEST(IoLatencyModelTest, storageName) {
+  EXPECT_EQ("s3", IoLatencyModel::storageName("s3://bucket/key"));
+  EXPECT_EQ("hdfs", IoLatencyModel::storageName("hdfs://host:9000/a/b"));
+  EXPECT_EQ("file", IoLatencyModel::storageName("file:/tmp/x"));
+  EXPECT_EQ("file", IoLatencyModel::storageName("/tmp/a:b"));
+  EXPECT_EQ("file", IoLatencyModel::storageName("data.orc"));
+  EXPECT_EQ(
+      &IoLatencyModel::forPath("s3://a/b"),
+      &IoLatencyModel::forPath("s3://c/d"));
+  EXPECT_NE(
+      &IoLatencyModel::forPath("s3://a/b"), &IoLatencyModel::forPath("/a/b"));
+}
+
+TEST(IoLatencyModelTest, fit) {
+  IoLatencyModel model;
+  recordReads(model, IoLatencyModel::kMinSamples - 1, 10'000, 100);
+  EXPECT_EQ(12345, model.maxCoalesceDistance(12345));
+  EXPECT_EQ(0, model.latencyUs());
+
+  recordReads(model, 100, 10'000, 100);
+  EXPECT_NEAR(10'000, model.latencyUs(), 1);
+  EXPECT_NEAR(100, model.bytesPerUs(), 0.01);
+  EXPECT_NEAR(1'000'000, model.maxCoalesceDistance(12345), 200);
+
+  // The model follows a change in the storage.
+  recordReads(model, 2'000, 1'000, 100);
+  EXPECT_NEAR(100'000, model.maxCoalesceDistance(12345), 200);
+}
+
+TEST(IoLatencyModelTest, bounds) {
+  IoLatencyModel slow;
+  recordReads(slow, 100, 1'000'000, 1'000);
+  EXPECT_EQ(
+      IoLatencyModel::kMaxCoalesceDistance, slow.maxCoalesceDistance(12345));
+
+  IoLatencyModel fast;
+  recordReads(fast, 100, 1, 1'000);
+  EXPECT_EQ(
+      IoLatencyModel::kMinCoalesceDistance, fast.maxCoalesceDistance(12345));
+
+  // Reads of a single size do not separate latency from transfer time.
+  IoLatencyModel sameSize;
+  for (auto i = 0; i < 100; ++i) {
+    sameSize.recordRead(100'000, 2'000);
+  }
+  EXPECT_EQ(12345, sameSize.maxCoalesceDistance(12345));
+}
@@ -73,6 +73,14 @@ enum StreamKind {
  */
 std::string streamKindToString(StreamKind kind);
 
+/**
+ * Returns true for the kinds of streams that are placed in the index area
+ * of a stripe, before the data streams.
+ */
+inline bool isIndexStream(StreamKind kind) {
+  return kind == StreamKind_ROW_INDEX || kind == StreamKind_BLOOM_FILTER_UTF8;
+}
+
 class StreamInformation {
  public:
   virtual ~StreamInformation() = default;
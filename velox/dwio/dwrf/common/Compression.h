@@ -16,7 +16,10 @@
 
 #pragma once
 
+#include <folly/Executor.h>
+
 #include "velox/dwio/common/Common.h"
+#include "velox/dwio/common/IoStatistics.h"
 #include "velox/dwio/common/SeekableInputStream.h"
 #include "velox/dwio/dwrf/common/Common.h"
 #include "velox/dwio/dwrf/common/CompressionBufferPool.h"
@@ -65,12 +68,30 @@ class Decompressor {
   const std::string streamDebugInfo_;
 };
 
+// Decompression of the blocks of a stream on an executor, ahead of the
+// reader.
+struct ParallelDecompressionOptions {
+  // Runs the decompression of blocks read ahead. Off if nullptr.
+  folly::Executor* executor{nullptr};
+
+  // Max number of blocks read and decompressed ahead of the one being
+  // consumed. Off if 0.
+  uint32_t maxBlocksAhead{0};
+
+  // If set, gets the time spent decompressing on 'executor', waiting for
+  // it and decrypting the blocks read ahead.
+  dwio::common::IoStatistics* ioStats{nullptr};
+};
+
 /**
  * Create a decompressor for the given compression kind.
  * @param kind the compression type to implement
  * @param input the input stream that is the underlying source
  * @param bufferSize the maximum size of the buffer
  * @param pool the memory pool
+ * @param parallel if set, blocks are decompressed ahead of the reader in
+ * the background. The blocks of encrypted streams are then also decrypted in
+ * batches. Does not apply to unencrypted zlib streams
  */
 std::unique_ptr<dwio::common::SeekableInputStream> createDecompressor(
     dwio::common::CompressionKind kind,
@@ -78,7 +99,8 @@ std::unique_ptr<dwio::common::SeekableInputStream> createDecompressor(
     uint64_t bufferSize,
     memory::MemoryPool& pool,
     const std::string& streamDebugInfo,
-    const dwio::common::encryption::Decrypter* decryptr = nullptr);
+    const dwio::common::encryption::Decrypter* decryptr = nullptr,
+    const ParallelDecompressionOptions& parallel = {});
 
 /**
  * Create a compressor for the given compression kind.
@@ -87,12 +109,14 @@ std::unique_ptr<dwio::common::SeekableInputStream> createDecompressor(
  * @param bufferHolder buffer holder that handles buffer allocation and
  * collection
  * @param level compression level
+ * @param executor if set, pages are compressed in the background on it
  */
 std::unique_ptr<BufferedOutputStream> createCompressor(
     dwio::common::CompressionKind kind,
     CompressionBufferPool& bufferPool,
     DataBufferHolder& bufferHolder,
     const Config& config,
-    const dwio::common::encryption::Encrypter* encrypter = nullptr);
+    const dwio::common::encryption::Encrypter* encrypter = nullptr,
+    folly::Executor* executor = nullptr);
 
 } // namespace facebook::velox::dwrf
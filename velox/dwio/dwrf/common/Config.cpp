@@ -20,6 +20,27 @@
 
 namespace facebook::velox::dwrf {
 
+namespace {
+std::string columnsToString(const std::vector<uint32_t>& val) {
+  return folly::join(",", val);
+}
+
+std::vector<uint32_t> columnsFromString(const std::string& val) {
+  std::vector<uint32_t> result;
+  if (!val.empty()) {
+    std::vector<folly::StringPiece> pieces;
+    folly::split(',', val, pieces, true);
+    for (auto& p : pieces) {
+      const auto& trimmedCol = folly::trimWhitespace(p);
+      if (!trimmedCol.empty()) {
+        result.push_back(folly::to<uint32_t>(trimmedCol));
+      }
+    }
+  }
+  return result;
+}
+} // namespace
+
 Config::Entry<WriterVersion> Config::WRITER_VERSION(
     "orc.writer.version",
     WriterVersion_CURRENT);
@@ -52,6 +73,10 @@ Config::Entry<uint32_t> Config::COMPRESSION_THRESHOLD(
     "orc.compression.threshold",
     256);
 
+Config::Entry<uint32_t> Config::COMPRESSION_MAX_PENDING_PAGES(
+    "orc.compression.max.pending.pages",
+    4);
+
 Config::Entry<bool> Config::CREATE_INDEX{"hive.exec.orc.create.index", true};
 
 Config::Entry<uint32_t> Config::ROW_INDEX_STRIDE{
@@ -88,6 +113,10 @@ Config::Entry<bool> Config::DICTIONARY_SORT_KEYS{
     "hive.exec.orc.dictionary.key.sorted",
     false};
 
+Config::Entry<uint32_t> Config::DICTIONARY_EARLY_CHECK_ROWS{
+    "hive.exec.orc.dictionary.early.check.rows",
+    0};
+
 Config::Entry<float> Config::ENTROPY_KEY_STRING_SIZE_THRESHOLD{
     "hive.exec.orc.entropy.key.string.size.threshold",
     0.9f};
@@ -125,21 +154,8 @@ Config::Entry<bool> Config::MAP_FLAT_DICT_SHARE(
 Config::Entry<const std::vector<uint32_t>> Config::MAP_FLAT_COLS(
     "orc.map.flat.cols",
     {},
-    [](const std::vector<uint32_t>& val) { return folly::join(",", val); },
-    [](const std::string& val) {
-      std::vector<uint32_t> result;
-      if (!val.empty()) {
-        std::vector<folly::StringPiece> pieces;
-        folly::split(',', val, pieces, true);
-        for (auto& p : pieces) {
-          const auto& trimmedCol = folly::trimWhitespace(p);
-          if (!trimmedCol.empty()) {
-            result.push_back(folly::to<uint32_t>(trimmedCol));
-          }
-        }
-      }
-      return result;
-    });
+    columnsToString,
+    columnsFromString);
 
 Config::Entry<uint32_t> Config::MAP_FLAT_MAX_KEYS(
     "orc.map.flat.max.keys",
@@ -170,4 +186,10 @@ Config::Entry<uint64_t> Config::RAW_DATA_SIZE_PER_BATCH(
     50UL * 1024 * 1024);
 
 Config::Entry<bool> Config::MAP_STATISTICS("orc.map.statistics", false);
+
+Config::Entry<const std::vector<uint32_t>> Config::BLOOM_FILTER_COLS(
+    "orc.bloom.filter.cols",
+    {},
+    columnsToString,
+    columnsFromString);
 } // namespace facebook::velox::dwrf
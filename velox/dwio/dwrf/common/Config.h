@@ -86,6 +86,9 @@ class Config {
   static Entry<uint64_t> COMPRESSION_BLOCK_SIZE_MIN;
   static Entry<float> COMPRESSION_BLOCK_SIZE_EXTEND_RATIO;
   static Entry<uint32_t> COMPRESSION_THRESHOLD;
+  // Max number of pages per stream that wait for background compression
+  // before the writer blocks. Only used with a compression executor.
+  static Entry<uint32_t> COMPRESSION_MAX_PENDING_PAGES;
   static Entry<bool> CREATE_INDEX;
   static Entry<uint32_t> ROW_INDEX_STRIDE;
   static Entry<proto::ChecksumAlgorithm> CHECKSUM_ALGORITHM;
@@ -96,6 +99,10 @@ class Config {
   static Entry<float> DICTIONARY_NUMERIC_KEY_SIZE_THRESHOLD;
   static Entry<float> DICTIONARY_STRING_KEY_SIZE_THRESHOLD;
   static Entry<bool> DICTIONARY_SORT_KEYS;
+  // If not 0, the dictionary of a column is checked once the first stripe
+  // has this many values, and abandoned right away if it does not pay off,
+  // instead of at the end of the stripe.
+  static Entry<uint32_t> DICTIONARY_EARLY_CHECK_ROWS;
   static Entry<float> ENTROPY_KEY_STRING_SIZE_THRESHOLD;
   static Entry<uint32_t> ENTROPY_STRING_MIN_SAMPLES;
   static Entry<float> ENTROPY_STRING_DICT_SAMPLE_FRACTION;
@@ -121,6 +128,10 @@ class Config {
   // to write oversized stripes.
   static Entry<uint64_t> RAW_DATA_SIZE_PER_BATCH;
   static Entry<bool> MAP_STATISTICS;
+  // Columns, by their index in the top level struct, for which each row
+  // group stores a bloom filter of its values. Only integer and string
+  // columns have bloom filters.
+  static Entry<const std::vector<uint32_t>> BLOOM_FILTER_COLS;
 
  private:
   std::unordered_map<std::string, std::string> configs_;
@@ -15,11 +15,17 @@
  */
 
 #include "velox/dwio/dwrf/common/PagedInputStream.h"
+#include "velox/common/time/Timer.h"
 #include "velox/dwio/common/SeekableInputStream.h"
 #include "velox/dwio/common/exception/Exception.h"
 
 namespace facebook::velox::dwrf {
 
+PagedInputStream::~PagedInputStream() {
+  // Decompressions in flight refer to this stream.
+  clearBlocksAhead();
+}
+
 void PagedInputStream::prepareOutputBuffer(uint64_t uncompressedLength) {
   if (!outputBuffer_ || uncompressedLength > outputBuffer_->capacity()) {
     outputBuffer_ = std::make_unique<dwio::common::DataBuffer<char>>(
@@ -119,6 +125,10 @@ bool PagedInputStream::Next(const void** data, int32_t* size) {
   // release previous decryption buffer
   decryptionBuffer_ = nullptr;
 
+  if (executor_) {
+    return nextBlockAhead(data, size);
+  }
+
   if (state_ == State::HEADER || remainingLength_ == 0) {
     readHeader();
   }
@@ -186,6 +196,171 @@ bool PagedInputStream::Next(const void** data, int32_t* size) {
   return true;
 }
 
+bool PagedInputStream::nextBlockAhead(const void** data, int32_t* size) {
+  if (blocksAhead_.empty()) {
+    readBlocksAhead();
+    if (blocksAhead_.empty()) {
+      return false;
+    }
+  }
+  currentBlock_ = std::move(blocksAhead_.front());
+  blocksAhead_.pop_front();
+  // Starts the next block while this one is consumed.
+  if (!decrypter_ || blocksAhead_.size() <= maxBlocksAhead_ / 2) {
+    readBlocksAhead();
+  }
+
+  // The header offsets for seekToPosition() are those of the block being
+  // returned, not of the last block read ahead.
+  lastHeaderOffset_ = currentBlock_->headerOffset;
+  bytesReturnedAtLastHeaderOffset_ = bytesReturned_;
+
+  const char* output;
+  uint64_t length;
+  if (currentBlock_->original) {
+    output = currentBlock_->data();
+    length = currentBlock_->length();
+  } else {
+    uint64_t usec = 0;
+    {
+      MicrosecondTimer timer(&usec);
+      std::move(currentBlock_->done).get();
+    }
+    if (ioStats_) {
+      ioStats_->queryThreadDecompressionLatency().increment(usec);
+    }
+    output = currentBlock_->output->data();
+    length = currentBlock_->outputLength;
+  }
+  *data = output;
+  *size = static_cast<int32_t>(length);
+  outputBufferPtr_ = output + length;
+  outputBufferLength_ = 0;
+  bytesReturned_ += length;
+  return true;
+}
+
+void PagedInputStream::readBlocksAhead() {
+  const auto firstNewBlock = blocksAhead_.size();
+  while (state_ != State::END && blocksAhead_.size() < maxBlocksAhead_) {
+    readHeader();
+    if (state_ == State::END) {
+      break;
+    }
+    auto block = std::make_unique<BlockAhead>();
+    block->headerOffset = lastHeaderOffset_;
+    block->original = state_ == State::ORIGINAL;
+    block->inputLength = remainingLength_;
+    block->input = std::make_unique<dwio::common::DataBuffer<char>>(
+        pool_, remainingLength_);
+    for (size_t pos = 0; pos < remainingLength_;) {
+      if (inputBufferPtr_ == inputBufferPtrEnd_) {
+        readBuffer(true);
+      }
+      auto length = std::min(
+          static_cast<size_t>(inputBufferPtrEnd_ - inputBufferPtr_),
+          remainingLength_ - pos);
+      std::copy(
+          inputBufferPtr_,
+          inputBufferPtr_ + length,
+          block->input->data() + pos);
+      pos += length;
+      inputBufferPtr_ += length;
+    }
+    remainingLength_ = 0;
+    state_ = State::HEADER;
+    blocksAhead_.push_back(std::move(block));
+  }
+
+  if (decrypter_ && firstNewBlock < blocksAhead_.size()) {
+    // The decrypter is shared by the streams of an encryption group and is
+    // not thread-safe, so the batch is decrypted on this thread.
+    std::vector<folly::StringPiece> inputs;
+    inputs.reserve(blocksAhead_.size() - firstNewBlock);
+    for (auto i = firstNewBlock; i < blocksAhead_.size(); ++i) {
+      inputs.emplace_back(
+          blocksAhead_[i]->input->data(), blocksAhead_[i]->inputLength);
+    }
+    uint64_t usec = 0;
+    std::vector<std::unique_ptr<folly::IOBuf>> decrypted;
+    {
+      MicrosecondTimer timer(&usec);
+      decrypted = decrypter_->decryptBatch(inputs);
+    }
+    DWIO_ENSURE_EQ(decrypted.size(), inputs.size());
+    if (ioStats_) {
+      ioStats_->decryption().increment(usec);
+    }
+    for (auto i = firstNewBlock; i < blocksAhead_.size(); ++i) {
+      auto& block = blocksAhead_[i];
+      block->decrypted = std::move(decrypted[i - firstNewBlock]);
+      // The ciphertext is no longer needed.
+      block->input.reset();
+    }
+  }
+
+  for (auto i = firstNewBlock; i < blocksAhead_.size(); ++i) {
+    auto* block = blocksAhead_[i].get();
+    if (!block->original) {
+      DWIO_ENSURE_NOT_NULL(decompressor_.get(), "invalid stream state");
+      // The output is allocated here since the pool is not shared with the
+      // executor.
+      block->output = std::make_unique<dwio::common::DataBuffer<char>>(
+          pool_,
+          decompressor_->getUncompressedLength(
+              block->data(), block->length()));
+      auto [promise, future] = folly::makePromiseContract<folly::Unit>();
+      executor_->add([this, block, promise = std::move(promise)]() mutable {
+        promise.setTry(folly::makeTryWith([&]() {
+          uint64_t usec = 0;
+          {
+            MicrosecondTimer timer(&usec);
+            block->outputLength = decompressor_->decompress(
+                block->data(),
+                block->length(),
+                block->output->data(),
+                block->output->capacity());
+          }
+          if (ioStats_) {
+            ioStats_->backgroundDecompression().increment(usec);
+          }
+        }));
+      });
+      block->done = std::move(future);
+    }
+  }
+}
+
+bool PagedInputStream::skipToBlockAhead(uint64_t headerOffset) {
+  auto it = std::find_if(
+      blocksAhead_.begin(), blocksAhead_.end(), [&](const auto& block) {
+        return block->headerOffset == headerOffset;
+      });
+  if (it == blocksAhead_.end()) {
+    return false;
+  }
+  for (auto skipped = blocksAhead_.begin(); skipped != it; ++skipped) {
+    if ((*skipped)->done.valid()) {
+      (*skipped)->done.wait();
+    }
+  }
+  blocksAhead_.erase(blocksAhead_.begin(), it);
+  currentBlock_.reset();
+  outputBufferLength_ = 0;
+  outputBufferPtr_ = nullptr;
+  return true;
+}
+
+void PagedInputStream::clearBlocksAhead() {
+  for (auto& block : blocksAhead_) {
+    if (block->done.valid()) {
+      block->done.wait();
+    }
+  }
+  blocksAhead_.clear();
+  currentBlock_.reset();
+}
+
 void PagedInputStream::BackUp(int32_t count) {
   DWIO_ENSURE(
       outputBufferPtr_ != nullptr,
@@ -226,6 +401,7 @@ bool PagedInputStream::Skip(int32_t count) {
 }
 
 void PagedInputStream::clearDecompressionState() {
+  clearBlocksAhead();
   state_ = State::HEADER;
   outputBufferLength_ = 0;
   remainingLength_ = 0;
@@ -254,7 +430,12 @@ void PagedInputStream::seekToPosition(
         alreadyRead - uncompressedOffset;
   };
 
-  if (compressedOffset != lastHeaderOffset_ || outsideOriginalWindow()) {
+  if (executor_ && compressedOffset != lastHeaderOffset_ &&
+      skipToBlockAhead(compressedOffset)) {
+    // The block is already read ahead.
+    Skip(uncompressedOffset);
+  } else if (
+      compressedOffset != lastHeaderOffset_ || outsideOriginalWindow()) {
     std::vector<uint64_t> positions = {compressedOffset};
     auto provider = dwio::common::PositionProvider(positions);
     input_->seekToPosition(provider);
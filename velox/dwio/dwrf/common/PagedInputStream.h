@@ -16,6 +16,10 @@
 
 #pragma once
 
+#include <deque>
+
+#include <folly/futures/Future.h>
+
 #include "velox/dwio/common/SeekableInputStream.h"
 #include "velox/dwio/dwrf/common/Compression.h"
 
@@ -28,7 +32,8 @@ class PagedInputStream : public dwio::common::SeekableInputStream {
       memory::MemoryPool& memPool,
       std::unique_ptr<Decompressor> decompressor,
       const dwio::common::encryption::Decrypter* decrypter,
-      const std::string& streamDebugInfo)
+      const std::string& streamDebugInfo,
+      const ParallelDecompressionOptions& parallel = {})
       : input_(std::move(inStream)),
         pool_(memPool),
         inputBuffer_(pool_),
@@ -38,8 +43,17 @@ class PagedInputStream : public dwio::common::SeekableInputStream {
     DWIO_ENSURE(
         decompressor_ || decrypter_,
         "one of decompressor or decryptor is required");
+    // Encrypted blocks are read ahead even without a decompressor so that
+    // they can be decrypted in batches.
+    if (parallel.executor && parallel.maxBlocksAhead > 0) {
+      executor_ = parallel.executor;
+      maxBlocksAhead_ = parallel.maxBlocksAhead;
+      ioStats_ = parallel.ioStats;
+    }
   }
 
+  ~PagedInputStream() override;
+
   bool Next(const void** data, int32_t* size) override;
   void BackUp(int32_t count) override;
   bool Skip(int32_t count) override;
@@ -146,8 +160,62 @@ class PagedInputStream : public dwio::common::SeekableInputStream {
   const dwio::common::encryption::Decrypter* decrypter_;
 
  private:
+  // A block copied out of 'input_' ahead of the reader, decrypted if the
+  // stream is encrypted and, if compressed, decompressed on 'executor_'.
+  struct BlockAhead {
+    // Offset of the block header in 'input_'.
+    uint64_t headerOffset;
+    bool original;
+    std::unique_ptr<dwio::common::DataBuffer<char>> input;
+    uint64_t inputLength;
+    // The decrypted 'input' if the stream is encrypted.
+    std::unique_ptr<folly::IOBuf> decrypted;
+    std::unique_ptr<dwio::common::DataBuffer<char>> output;
+    uint64_t outputLength{0};
+    folly::SemiFuture<folly::Unit> done{
+        folly::SemiFuture<folly::Unit>::makeEmpty()};
+
+    // The plaintext of the block, before decompression.
+    const char* data() const {
+      return decrypted ? reinterpret_cast<const char*>(decrypted->data())
+                       : input->data();
+    }
+
+    uint64_t length() const {
+      return decrypted ? decrypted->length() : inputLength;
+    }
+  };
+
+  // Next() when blocks are decompressed ahead.
+  bool nextBlockAhead(const void** data, int32_t* size);
+
+  // Reads blocks from 'input_' and starts decompressing them until
+  // 'maxBlocksAhead_' blocks are queued or 'input_' is at end. The blocks
+  // of an encrypted stream are read once half of the queue is consumed and
+  // are decrypted together with one Decrypter::decryptBatch() call.
+  void readBlocksAhead();
+
+  // If a block in 'blocksAhead_' starts at 'headerOffset', drops the
+  // blocks before it so that the next Next() returns it. Returns false if
+  // there is no such block.
+  bool skipToBlockAhead(uint64_t headerOffset);
+
+  // Waits for the decompressions in flight and drops the queued blocks.
+  void clearBlocksAhead();
+
   // Stream Debug Info
   const std::string streamDebugInfo_;
+
+  // Decompresses blocks ahead of the reader if set.
+  folly::Executor* executor_{nullptr};
+  uint32_t maxBlocksAhead_{0};
+  dwio::common::IoStatistics* ioStats_{nullptr};
+
+  // Blocks read ahead, oldest first.
+  std::deque<std::unique_ptr<BlockAhead>> blocksAhead_;
+
+  // The block the last Next() returned data of.
+  std::unique_ptr<BlockAhead> currentBlock_;
 };
 
 } // namespace facebook::velox::dwrf
@@ -19,35 +19,39 @@
 
 namespace facebook::velox::dwrf {
 
-std::vector<folly::StringPiece> PagedOutputStream::createPage() {
-  auto origSize = buffer_.size();
-  DWIO_ENSURE_GT(origSize, PAGE_HEADER_SIZE);
-  origSize -= PAGE_HEADER_SIZE;
+PagedOutputStream::~PagedOutputStream() {
+  // Pending compressions refer to this stream.
+  for (auto& page : pendingPages_) {
+    page->done.wait();
+  }
+}
 
-  auto compressedSize = origSize;
+folly::StringPiece PagedOutputStream::compress(
+    char* page,
+    uint64_t size,
+    std::unique_ptr<dwio::common::DataBuffer<char>>& output) {
+  auto compressedSize = size;
   // apply compressoin if there is compressor and original data size exceeds
   // threshold
-  if (compressor_ && origSize >= threshold_) {
-    compressionBuffer_ = pool_.getBuffer(buffer_.size());
+  if (compressor_ && size >= threshold_) {
+    output = pool_.getBuffer(size + PAGE_HEADER_SIZE);
     compressedSize = compressor_->compress(
-        buffer_.data() + PAGE_HEADER_SIZE,
-        compressionBuffer_->data() + PAGE_HEADER_SIZE,
-        origSize);
+        page + PAGE_HEADER_SIZE, output->data() + PAGE_HEADER_SIZE, size);
   }
 
-  folly::StringPiece compressed;
-  if (compressedSize >= origSize) {
+  if (compressedSize >= size) {
     // write orig
-    writeHeader(buffer_.data(), origSize, true);
-    compressed =
-        folly::StringPiece(buffer_.data(), origSize + PAGE_HEADER_SIZE);
-  } else {
-    // write compressed
-    writeHeader(compressionBuffer_->data(), compressedSize, false);
-    compressed = folly::StringPiece(
-        compressionBuffer_->data(), compressedSize + PAGE_HEADER_SIZE);
+    writeHeader(page, size, true);
+    return folly::StringPiece(page, size + PAGE_HEADER_SIZE);
   }
+  // write compressed
+  writeHeader(output->data(), compressedSize, false);
+  return folly::StringPiece(
+      output->data(), compressedSize + PAGE_HEADER_SIZE);
+}
 
+std::vector<folly::StringPiece> PagedOutputStream::encrypt(
+    folly::StringPiece compressed) {
   if (!encrypter_) {
     return {compressed};
   }
@@ -63,6 +67,53 @@ std::vector<folly::StringPiece> PagedOutputStream::createPage() {
           encryptionBuffer_->length())};
 }
 
+std::vector<folly::StringPiece> PagedOutputStream::createPage() {
+  auto origSize = buffer_.size();
+  DWIO_ENSURE_GT(origSize, PAGE_HEADER_SIZE);
+  return encrypt(compress(
+      buffer_.data(), origSize - PAGE_HEADER_SIZE, compressionBuffer_));
+}
+
+void PagedOutputStream::enqueuePage() {
+  DWIO_ENSURE_GT(buffer_.size(), PAGE_HEADER_SIZE);
+  auto page = std::make_unique<PendingPage>();
+  page->size = buffer_.size() - PAGE_HEADER_SIZE;
+  page->input = pool_.getBuffer(buffer_.size());
+  std::memcpy(page->input->data(), buffer_.data(), buffer_.size());
+  auto [promise, future] = folly::makePromiseContract<folly::Unit>();
+  compressionExecutor_->add(
+      [this, page = page.get(), promise = std::move(promise)]() mutable {
+        promise.setTry(folly::makeTryWith([&]() {
+          page->compressed =
+              compress(page->input->data(), page->size, page->output);
+        }));
+      });
+  page->done = std::move(future);
+  pendingSize_ += page->size;
+  pendingPages_.push_back(std::move(page));
+  drainPages(maxPendingPages_);
+}
+
+void PagedOutputStream::drainPages(uint32_t maxPending) {
+  while (!pendingPages_.empty()) {
+    if (pendingPages_.size() <= maxPending &&
+        !pendingPages_.front()->done.isReady()) {
+      break;
+    }
+    auto page = std::move(pendingPages_.front());
+    pendingPages_.pop_front();
+    pendingSize_ -= page->size;
+    std::move(page->done).get();
+    // Encryption runs on the writer thread, after compression.
+    bufferHolder_.take(encrypt(page->compressed));
+    encryptionBuffer_ = nullptr;
+    pool_.returnBuffer(std::move(page->input));
+    if (page->output) {
+      pool_.returnBuffer(std::move(page->output));
+    }
+  }
+}
+
 void PagedOutputStream::writeHeader(
     char* buffer,
     size_t compressedSize,
@@ -91,6 +142,7 @@ void PagedOutputStream::resetBuffers() {
 uint64_t PagedOutputStream::flush() {
   auto size = buffer_.size();
   auto originalSize = bufferHolder_.size();
+  drainPages(0);
   if (size > PAGE_HEADER_SIZE) {
     bufferHolder_.take(createPage());
     resetBuffers();
@@ -109,8 +161,14 @@ void PagedOutputStream::BackUp(int32_t count) {
 
 bool PagedOutputStream::Next(void** data, int32_t* size, uint64_t increment) {
   if (!tryResize(data, size, PAGE_HEADER_SIZE, increment)) {
-    flushAndReset(data, size, PAGE_HEADER_SIZE, createPage());
-    resetBuffers();
+    if (compressionExecutor_) {
+      // The page is copied, so that 'buffer_' can be reused right away.
+      enqueuePage();
+      flushAndReset(data, size, PAGE_HEADER_SIZE, {});
+    } else {
+      flushAndReset(data, size, PAGE_HEADER_SIZE, createPage());
+      resetBuffers();
+    }
   }
   return true;
 }
@@ -120,6 +178,9 @@ void PagedOutputStream::recordPosition(
     int32_t bufferLength,
     int32_t bufferOffset,
     int32_t strideOffset) const {
+  // Positions are offsets in the compressed stream, so pending pages are
+  // written out first.
+  const_cast<PagedOutputStream*>(this)->drainPages(0);
   // add compressed size, then uncompressed
   recorder.add(bufferHolder_.size(), strideOffset);
   auto size = buffer_.size();
@@ -16,6 +16,11 @@
 
 #pragma once
 
+#include <deque>
+
+#include <folly/executors/SerialExecutor.h>
+#include <folly/futures/Future.h>
+
 #include "velox/dwio/dwrf/common/Compression.h"
 
 namespace facebook::velox::dwrf {
@@ -27,22 +32,33 @@ class PagedOutputStream : public BufferedOutputStream {
       DataBufferHolder& bufferHolder,
       const Config& config,
       std::unique_ptr<Compressor> compressor,
-      const dwio::common::encryption::Encrypter* encrypter)
+      const dwio::common::encryption::Encrypter* encrypter,
+      folly::Executor* executor = nullptr)
       : BufferedOutputStream(bufferHolder),
         pool_{pool},
         compressor_{std::move(compressor)},
         encrypter_{encrypter},
-        threshold_{config.get(Config::COMPRESSION_THRESHOLD)} {
+        threshold_{config.get(Config::COMPRESSION_THRESHOLD)},
+        maxPendingPages_{config.get(Config::COMPRESSION_MAX_PENDING_PAGES)} {
     DWIO_ENSURE(compressor_ || encrypter_, "invalid paged output stream");
+    // Pages of a stream share the compressor, so they are compressed one at
+    // a time and in order, but in the background.
+    if (executor && compressor_ && maxPendingPages_ > 0) {
+      compressionExecutor_ =
+          folly::SerialExecutor::create(folly::getKeepAliveToken(executor));
+    }
   }
 
+  ~PagedOutputStream() override;
+
   bool Next(void** data, int32_t* size, uint64_t increment) override;
 
   uint64_t flush() override;
 
   uint64_t size() const override {
-    // only care about compressed size
-    return bufferHolder_.size();
+    // only care about compressed size. Pages still being compressed count
+    // with their uncompressed size.
+    return bufferHolder_.size() + pendingSize_;
   }
 
   void BackUp(int32_t count) override;
@@ -58,9 +74,43 @@ class PagedOutputStream : public BufferedOutputStream {
       int32_t strideOffset = -1) const override;
 
  private:
+  // A full page handed off for compression.
+  struct PendingPage {
+    // Copy of the page, including space for the header.
+    std::unique_ptr<dwio::common::DataBuffer<char>> input;
+    uint64_t size;
+    std::unique_ptr<dwio::common::DataBuffer<char>> output;
+    // Header and compressed data, in 'input' or 'output'.
+    folly::StringPiece compressed;
+    folly::SemiFuture<folly::Unit> done{
+        folly::SemiFuture<folly::Unit>::makeEmpty()};
+  };
+
   // create page using compressor and encrypter
   std::vector<folly::StringPiece> createPage();
 
+  // Compresses the 'size' bytes after the header in 'page' and writes the
+  // header. Returns the header and data, in 'page' or in 'output' if
+  // compression paid off.
+  folly::StringPiece compress(
+      char* page,
+      uint64_t size,
+      std::unique_ptr<dwio::common::DataBuffer<char>>& output);
+
+  // Encrypts 'compressed' if there is an encrypter. Returns the header and
+  // the data to write.
+  std::vector<folly::StringPiece> encrypt(folly::StringPiece compressed);
+
+  // Copies the full page in 'buffer_' and compresses the copy on
+  // 'compressionExecutor_'. Blocks while more than 'maxPendingPages_' pages
+  // are in flight.
+  void enqueuePage();
+
+  // Writes out compressed pages in order until at most 'maxPending' pages are
+  // in flight, blocking on the oldest page if needed. Completed pages at the
+  // front are always written.
+  void drainPages(uint32_t maxPending);
+
   void writeHeader(char* buffer, size_t compressedSize, bool original);
 
   void updateSize(char* buffer, size_t compressedSize);
@@ -82,6 +132,18 @@ class PagedOutputStream : public BufferedOutputStream {
 
   // threshold below which, we skip compression
   uint32_t threshold_;
+
+  // Max number of uncompressed pages in flight before Next() blocks.
+  const uint32_t maxPendingPages_;
+
+  // Compresses pages in the background if set.
+  folly::Executor::KeepAlive<folly::SerialExecutor> compressionExecutor_;
+
+  // Pages being compressed, oldest first.
+  std::deque<std::unique_ptr<PendingPage>> pendingPages_;
+
+  // Uncompressed size of 'pendingPages_'.
+  uint64_t pendingSize_{0};
 };
 
 } // namespace facebook::velox::dwrf
@@ -15,6 +15,7 @@
  */
 
 #include "velox/dwio/dwrf/common/RLEv2.h"
+#include <folly/Bits.h>
 #include "velox/dwio/common/SeekableInputStream.h"
 #include "velox/dwio/dwrf/common/Common.h"
 
@@ -107,6 +108,130 @@ inline uint32_t getClosestFixedBits(uint32_t n) {
   }
 }
 
+namespace {
+
+// Returns the 'bitWidth' bit big endian value that starts 'bitOffset' bits
+// after 'input'. Loads 8 bytes, or 9 if 'bitWidth' is over 56.
+FOLLY_ALWAYS_INLINE uint64_t
+unpackOne(const char* input, uint64_t bitOffset, uint32_t bitWidth) {
+  auto* word = input + (bitOffset >> 3);
+  auto shift = bitOffset & 7;
+  auto value = folly::Endian::big(folly::loadUnaligned<uint64_t>(word));
+  if (bitWidth <= 56) {
+    return (value << shift) >> (64 - bitWidth);
+  }
+  if (shift) {
+    value = (value << shift) |
+        (static_cast<uint8_t>(word[sizeof(uint64_t)]) >> (8 - shift));
+  }
+  return value >> (64 - bitWidth);
+}
+
+// Unpacks 'numValues' 'bitWidth' bit big endian values that start
+// 'bitOffset' bits after 'input' into 'result'. Byte aligned widths are
+// copied a value at a time. 'input' must have 8 readable bytes past the
+// last value.
+void unpackBigEndian(
+    const char* input,
+    uint64_t bitOffset,
+    uint32_t bitWidth,
+    uint64_t numValues,
+    int64_t* result) {
+  if (bitOffset == 0) {
+    switch (bitWidth) {
+      case 8:
+        for (uint64_t i = 0; i < numValues; ++i) {
+          result[i] = static_cast<uint8_t>(input[i]);
+        }
+        return;
+      case 16:
+        for (uint64_t i = 0; i < numValues; ++i) {
+          result[i] = folly::Endian::big(
+              folly::loadUnaligned<uint16_t>(input + i * sizeof(uint16_t)));
+        }
+        return;
+      case 32:
+        for (uint64_t i = 0; i < numValues; ++i) {
+          result[i] = folly::Endian::big(
+              folly::loadUnaligned<uint32_t>(input + i * sizeof(uint32_t)));
+        }
+        return;
+      case 64:
+        for (uint64_t i = 0; i < numValues; ++i) {
+          result[i] = folly::Endian::big(
+              folly::loadUnaligned<uint64_t>(input + i * sizeof(uint64_t)));
+        }
+        return;
+      default:
+        break;
+    }
+  }
+  for (uint64_t i = 0; i < numValues; ++i) {
+    result[i] = unpackOne(input, bitOffset + i * bitWidth, bitWidth);
+  }
+}
+
+} // namespace
+
+template <bool isSigned>
+uint64_t RleDecoderV2<isSigned>::readLongs(
+    int64_t* data,
+    uint64_t offset,
+    uint64_t len,
+    uint64_t fb,
+    const uint64_t* nulls) {
+  auto numValues = nulls
+      ? static_cast<uint64_t>(bits::countNonNulls(nulls, offset, offset + len))
+      : len;
+  // The unread bits of 'curByte' are the low bits of the last byte read
+  // from the buffer.
+  const char* input = dwio::common::IntDecoder<isSigned>::bufferStart -
+      (bitsLeft > 0 ? 1 : 0);
+  const uint64_t bitOffset = bitsLeft > 0 ? 8 - bitsLeft : 0;
+  const uint64_t endBit = bitOffset + numValues * fb;
+  if (fb == 0 ||
+      dwio::common::IntDecoder<isSigned>::bufferEnd - input <
+          static_cast<int64_t>(endBit / 8 + sizeof(uint64_t) + 1)) {
+    return readLongsSlow(data, offset, len, fb, nulls);
+  }
+
+  if (nulls) {
+    uint64_t bit = bitOffset;
+    for (uint64_t i = offset; i < offset + len; ++i) {
+      if (!bits::isBitNull(nulls, i)) {
+        data[i] = unpackOne(input, bit, fb);
+        bit += fb;
+      }
+    }
+  } else {
+    unpackBigEndian(input, bitOffset, fb, len, data + offset);
+  }
+
+  // Leave the decoder as readLongsSlow() would.
+  auto* end = input + endBit / 8;
+  if (endBit % 8 == 0) {
+    bitsLeft = 0;
+  } else {
+    curByte = static_cast<uint8_t>(*end++);
+    bitsLeft = 8 - endBit % 8;
+  }
+  dwio::common::IntDecoder<isSigned>::bufferStart = end;
+  return numValues;
+}
+
+template uint64_t RleDecoderV2<true>::readLongs(
+    int64_t* data,
+    uint64_t offset,
+    uint64_t len,
+    uint64_t fb,
+    const uint64_t* nulls);
+template uint64_t RleDecoderV2<false>::readLongs(
+    int64_t* data,
+    uint64_t offset,
+    uint64_t len,
+    uint64_t fb,
+    const uint64_t* nulls);
+
 template <bool isSigned>
 int64_t RleDecoderV2<isSigned>::readLongBE(uint64_t bsz) {
   int64_t ret = 0, val;
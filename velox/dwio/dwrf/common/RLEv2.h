@@ -107,15 +107,26 @@ class RleDecoderV2 : public dwio::common::IntDecoder<isSigned> {
   }
 
   int64_t readLongBE(uint64_t bsz);
+  // Reads 'len' values of 'fb' bits into 'data' starting at 'offset',
+  // skipping positions that are null in 'nulls'. Returns the number of
+  // values read.
   uint64_t readLongs(
       int64_t* data,
       uint64_t offset,
       uint64_t len,
       uint64_t fb,
-      const uint64_t* nulls = nullptr) {
+      const uint64_t* nulls = nullptr);
+
+  // Reads values a bit at a time through readByte(). Used when the values
+  // are not all in the current buffer.
+  uint64_t readLongsSlow(
+      int64_t* data,
+      uint64_t offset,
+      uint64_t len,
+      uint64_t fb,
+      const uint64_t* nulls) {
     uint64_t ret = 0;
 
-    // TODO: unroll to improve performance
     for (uint64_t i = offset; i < (offset + len); i++) {
       // skip null positions
       if (nulls && bits::isBitNull(nulls, i)) {
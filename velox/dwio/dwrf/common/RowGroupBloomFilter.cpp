@@ -0,0 +1,50 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "velox/dwio/dwrf/common/RowGroupBloomFilter.h"
+
+namespace facebook::velox::dwrf {
+
+void toBloomFilterProto(
+    std::vector<uint64_t> hashes,
+    proto::BloomFilter& bloomFilter) {
+  std::sort(hashes.begin(), hashes.end());
+  hashes.erase(std::unique(hashes.begin(), hashes.end()), hashes.end());
+  BloomFilter<false> filter;
+  filter.reset(hashes.size());
+  for (auto hash : hashes) {
+    filter.insert(hash);
+  }
+  bloomFilter.set_numhashfunctions(kBloomFilterNumHashFunctions);
+  for (auto word : filter.words()) {
+    bloomFilter.add_bitset(word);
+  }
+}
+
+std::optional<BloomFilter<false>> fromBloomFilterProto(
+    const proto::BloomFilter& bloomFilter) {
+  if (bloomFilter.numhashfunctions() != kBloomFilterNumHashFunctions ||
+      bloomFilter.bitset_size() == 0 ||
+      !bits::isPowerOfTwo(bloomFilter.bitset_size())) {
+    return std::nullopt;
+  }
+  BloomFilter<false> filter;
+  filter.setWords(std::vector<uint64_t>(
+      bloomFilter.bitset().begin(), bloomFilter.bitset().end()));
+  return filter;
+}
+
+} // namespace facebook::velox::dwrf
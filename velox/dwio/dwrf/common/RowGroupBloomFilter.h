@@ -0,0 +1,54 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <folly/Hash.h>
+#include <folly/Range.h>
+
+#include "velox/common/base/BloomFilter.h"
+#include "velox/dwio/dwrf/common/wrap/dwrf-proto-wrapper.h"
+
+namespace facebook::velox::dwrf {
+
+// Row group bloom filters. The writer adds the hashes of the integer and
+// string values of each row group of a column to a BloomFilter<false>
+// and stores its words in 'bitset' of a proto::BloomFilter per row group,
+// in the BLOOM_FILTER_UTF8 stream of the column. 'numHashFunctions' is
+// kBloomFilterNumHashFunctions. Filters of other writers, which use
+// other hash functions and keep their bits in 'utf8bitset', are ignored.
+constexpr uint32_t kBloomFilterNumHashFunctions = 4;
+
+inline uint64_t bloomFilterHash(int64_t value) {
+  return folly::hasher<int64_t>()(value);
+}
+
+inline uint64_t bloomFilterHash(folly::StringPiece value) {
+  return folly::hasher<folly::StringPiece>()(value);
+}
+
+// Fills 'bloomFilter' with a filter of 'hashes', sized by the number of
+// distinct hashes.
+void toBloomFilterProto(
+    std::vector<uint64_t> hashes,
+    proto::BloomFilter& bloomFilter);
+
+// Returns the filter stored in 'bloomFilter' by toBloomFilterProto(), or
+// std::nullopt if 'bloomFilter' was written by another writer.
+std::optional<BloomFilter<false>> fromBloomFilterProto(
+    const proto::BloomFilter& bloomFilter);
+
+} // namespace facebook::velox::dwrf
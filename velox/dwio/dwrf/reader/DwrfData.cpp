@@ -15,13 +15,63 @@
  */
 
 #include "velox/dwio/dwrf/reader/DwrfData.h"
+#include "velox/dwio/dwrf/common/RowGroupBloomFilter.h"
 
 namespace facebook::velox::dwrf {
 
+namespace {
+// Returns false if no value in 'bloomFilter' passes 'filter'. Tests only
+// filters that pass a set of values and do not pass nulls if the row
+// group may have nulls.
+bool testBloomFilter(
+    const common::Filter& filter,
+    const BloomFilter<false>& bloomFilter,
+    bool mayHaveNull) {
+  if (mayHaveNull && filter.testNull()) {
+    return true;
+  }
+  auto mayContain = [&](const auto& values) {
+    for (const auto& value : values) {
+      if (bloomFilter.mayContain(bloomFilterHash(value))) {
+        return true;
+      }
+    }
+    return false;
+  };
+  switch (filter.kind()) {
+    case common::FilterKind::kBigintRange: {
+      auto& range = static_cast<const common::BigintRange&>(filter);
+      return !range.isSingleValue() ||
+          bloomFilter.mayContain(bloomFilterHash(range.lower()));
+    }
+    case common::FilterKind::kBigintValuesUsingHashTable:
+      return mayContain(
+          static_cast<const common::BigintValuesUsingHashTable&>(filter)
+              .values());
+    case common::FilterKind::kBigintValuesUsingBitmask:
+      return mayContain(
+          static_cast<const common::BigintValuesUsingBitmask&>(filter)
+              .values());
+    case common::FilterKind::kBytesRange: {
+      auto& range = static_cast<const common::BytesRange&>(filter);
+      return !range.isSingleValue() ||
+          bloomFilter.mayContain(
+              bloomFilterHash(folly::StringPiece(range.lower())));
+    }
+    case common::FilterKind::kBytesValues:
+      return mayContain(
+          static_cast<const common::BytesValues&>(filter).values());
+    default:
+      return true;
+  }
+}
+} // namespace
+
 DwrfData::DwrfData(
     std::shared_ptr<const dwio::common::TypeWithId> nodeType,
     StripeStreams& stripe,
-    FlatMapContext flatMapContext)
+    FlatMapContext flatMapContext,
+    bool readBloomFilters)
     : memoryPool_(stripe.getMemoryPool()),
       nodeType_(std::move(nodeType)),
       flatMapContext_(std::move(flatMapContext)),
@@ -40,6 +90,10 @@ DwrfData::DwrfData(
   // time pushdown.
   indexStream_ = stripe.getStream(
       encodingKey.forKind(proto::Stream_Kind_ROW_INDEX), false);
+  if (readBloomFilters) {
+    bloomFilterStream_ = stripe.getStream(
+        encodingKey.forKind(proto::Stream_Kind_BLOOM_FILTER_UTF8), false);
+  }
 }
 
 uint64_t DwrfData::skipNulls(uint64_t numValues) {
@@ -118,6 +172,11 @@ std::vector<uint32_t> DwrfData::filterRowGroups(
   ensureRowGroupIndex();
   auto filter = scanSpec.filter();
 
+  if (bloomFilterStream_) {
+    bloomFilterIndex_ = ProtoUtils::readProto<proto::BloomFilterIndex>(
+        std::move(bloomFilterStream_));
+  }
+
   std::vector<uint32_t> stridesToSkip;
   auto dwrfContext = reinterpret_cast<const StatsContext*>(&context);
   for (auto i = 0; i < index_->entry_size(); i++) {
@@ -127,6 +186,22 @@ std::vector<uint32_t> DwrfData::filterRowGroups(
     if (!testFilter(filter, columnStats.get(), rowGroupSize, nodeType_->type)) {
       VLOG(1) << "Drop stride " << i << " on " << scanSpec.toString();
       stridesToSkip.push_back(i); // Skipping stride based on column stats.
+      continue;
+    }
+    if (!bloomFilterIndex_ || i >= bloomFilterIndex_->bloomfilter_size()) {
+      continue;
+    }
+    auto bloomFilter = fromBloomFilterProto(bloomFilterIndex_->bloomfilter(i));
+    if (!bloomFilter) {
+      continue;
+    }
+    auto numValues = columnStats->getNumberOfValues();
+    auto mayHaveNull = columnStats->hasNull().value_or(true) &&
+        !(numValues.has_value() && numValues.value() == rowGroupSize);
+    if (!testBloomFilter(*filter, *bloomFilter, mayHaveNull)) {
+      VLOG(1) << "Drop stride " << i << " on bloom filter of "
+              << scanSpec.toString();
+      stridesToSkip.push_back(i);
     }
   }
   return stridesToSkip;
@@ -32,10 +32,13 @@ namespace facebook::velox::dwrf {
 // DWRF specific functions shared between all readers.
 class DwrfData : public dwio::common::FormatData {
  public:
+  // Reads the row group bloom filters if 'readBloomFilters' and the
+  // column has them.
   DwrfData(
       std::shared_ptr<const dwio::common::TypeWithId> nodeType,
       StripeStreams& stripe,
-      FlatMapContext flatMapContext);
+      FlatMapContext flatMapContext,
+      bool readBloomFilters = false);
 
   void readNulls(
       vector_size_t numValues,
@@ -94,6 +97,8 @@ class DwrfData : public dwio::common::FormatData {
   std::unique_ptr<ByteRleDecoder> notNullDecoder_;
   std::unique_ptr<dwio::common::SeekableInputStream> indexStream_;
   std::unique_ptr<proto::RowIndex> index_;
+  std::unique_ptr<dwio::common::SeekableInputStream> bloomFilterStream_;
+  std::unique_ptr<proto::BloomFilterIndex> bloomFilterIndex_;
   // Number of rows in a row group. Last row group may have fewer rows.
   uint32_t rowsPerRowGroup_;
 
@@ -112,10 +117,13 @@ class DwrfParams : public dwio::common::FormatParams {
         stripeStreams_(stripeStreams),
         flatMapContext_(context) {}
 
+  // Bloom filters are read only for columns that have a filter when the
+  // reader is made, since they are larger than the row group index.
   std::unique_ptr<dwio::common::FormatData> toFormatData(
       const std::shared_ptr<const dwio::common::TypeWithId>& type,
-      const common::ScanSpec& /*scanSpec*/) override {
-    return std::make_unique<DwrfData>(type, stripeStreams_, flatMapContext_);
+      const common::ScanSpec& scanSpec) override {
+    return std::make_unique<DwrfData>(
+        type, stripeStreams_, flatMapContext_, scanSpec.filter() != nullptr);
   }
 
   StripeStreams& stripeStreams() {
@@ -80,6 +80,12 @@ class DwrfRowReader : public DwrfRowReaderShared {
 
   void resetFilterCaches() override;
 
+  void prefetchNextStripe() override {
+    if (currentRowInStripe == 0) {
+      startNextStripe();
+    }
+  }
+
   // Returns the skipped strides for 'stripe'. Used for testing.
   std::optional<std::vector<uint32_t>> stridesToSkip(uint32_t stripe) const {
     auto it = stripeStridesToSkip_.find(stripe);
@@ -411,6 +411,13 @@ void DwrfRowReaderShared::startNextStripe() {
 
   stripeDictionaryCache_ = stripeStreams.getStripeDictionaryCache();
   newStripeLoaded = true;
+
+  // Overlap the IO for the next stripe with decoding this one.
+  auto& ioExecutor = options_.getIOExecutor();
+  auto readAheadBytes = options_.getStripeReadAheadBytes();
+  if (ioExecutor && readAheadBytes > 0 && currentStripe + 1 < lastStripe) {
+    readAheadStripe(currentStripe + 1, ioExecutor.get(), readAheadBytes);
+  }
 }
 
 size_t DwrfRowReaderShared::estimatedReaderMemory() const {
@@ -0,0 +1,85 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#include "velox/dwio/dwrf/reader/FileTailCache.h"
+
+#include <gflags/gflags.h>
+
+DEFINE_int32(
+    dwrf_file_tail_cache_mb,
+    64,
+    "Memory for parsed DWRF file footers shared between readers of the same "
+    "file. 0 disables the cache.");
+
+namespace facebook::velox::dwrf {
+
+int64_t FileTail::memoryUsage() const {
+  int64_t size = sizeof(*this) + sizeof(PostScript);
+  if (arena) {
+    size += arena->SpaceAllocated();
+  }
+  if (postScript) {
+    size += postScript->cacheSize();
+  }
+  return size;
+}
+
+FileTailCache::FileTailCache(int64_t maxBytes)
+    : pool_(memory::getDefaultScopedMemoryPool()), cache_(maxBytes) {}
+
+std::shared_ptr<const FileTail> FileTailCache::find(
+    uint64_t fileNum,
+    uint64_t fileLength) {
+  Key key{fileNum, fileLength};
+  std::lock_guard<std::mutex> l(mutex_);
+  auto* tail = cache_.get(key);
+  if (!tail) {
+    return nullptr;
+  }
+  auto result = *tail;
+  cache_.release(key);
+  return result;
+}
+
+void FileTailCache::insert(
+    uint64_t fileNum,
+    uint64_t fileLength,
+    std::shared_ptr<FileTail> tail) {
+  auto size = tail->memoryUsage();
+  auto value = std::make_unique<std::shared_ptr<const FileTail>>(
+      std::move(tail));
+  std::lock_guard<std::mutex> l(mutex_);
+  if (cache_.add(Key{fileNum, fileLength}, value.get(), size)) {
+    value.release();
+  }
+}
+
+int64_t FileTailCache::currentBytes() {
+  std::lock_guard<std::mutex> l(mutex_);
+  return cache_.currentSize();
+}
+
+// static
+FileTailCache* FileTailCache::instance() {
+  static auto cache = FLAGS_dwrf_file_tail_cache_mb > 0
+      ? std::make_unique<FileTailCache>(
+            static_cast<int64_t>(FLAGS_dwrf_file_tail_cache_mb) << 20)
+      : nullptr;
+  return cache.get();
+}
+
+} // namespace facebook::velox::dwrf
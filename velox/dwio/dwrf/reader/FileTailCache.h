@@ -0,0 +1,87 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#pragma once
+
+#include <mutex>
+
+#include <folly/hash/Hash.h>
+#include "velox/common/caching/SimpleLRUCache.h"
+#include "velox/common/memory/Memory.h"
+#include "velox/dwio/dwrf/reader/StripeMetadataCache.h"
+#include "velox/type/Type.h"
+
+namespace facebook::velox::dwrf {
+
+// The PostScript, footer and stripe metadata cache of a file, parsed
+// once. These are immutable and may be shared by all readers of the file.
+struct FileTail {
+  // Owns 'footer' unless the footer is given by the creator of the reader.
+  std::unique_ptr<google::protobuf::Arena> arena;
+  std::unique_ptr<PostScript> postScript;
+  proto::Footer* footer = nullptr;
+  std::unique_ptr<StripeMetadataCache> cache;
+  RowTypePtr schema;
+  uint64_t psLength = 0;
+
+  // Approximate memory held by 'this'.
+  int64_t memoryUsage() const;
+};
+
+// Process wide LRU cache of FileTails, so that readers for many splits of
+// the same file do not read and parse its footer again. Tails are keyed on
+// the file number and the file length. The file number is the id the data
+// cache knows the file by, i.e. the uuid of its FileHandle, which is not
+// reused for another file. Thread-safe.
+class FileTailCache {
+ public:
+  explicit FileTailCache(int64_t maxBytes);
+
+  // Returns the tail of the file, nullptr if it is not cached.
+  std::shared_ptr<const FileTail> find(uint64_t fileNum, uint64_t fileLength);
+
+  // Adds the tail of a file. The tail must be made with pool() so that it
+  // may outlive the reader that made it.
+  void
+  insert(uint64_t fileNum, uint64_t fileLength, std::shared_ptr<FileTail> tail);
+
+  // Pool for the buffers of cached tails.
+  memory::MemoryPool& pool() {
+    return *pool_;
+  }
+
+  int64_t currentBytes();
+
+  // Returns the process wide instance or nullptr if
+  // FLAGS_dwrf_file_tail_cache_mb is 0.
+  static FileTailCache* FOLLY_NULLABLE instance();
+
+ private:
+  using Key = std::pair<uint64_t, uint64_t>;
+
+  std::unique_ptr<memory::ScopedMemoryPool> pool_;
+  std::mutex mutex_;
+  // The tails outlive their eviction for as long as readers refer to them.
+  SimpleLRUCache<
+      Key,
+      std::shared_ptr<const FileTail>,
+      std::equal_to<Key>,
+      folly::hasher<Key>>
+      cache_;
+};
+
+} // namespace facebook::velox::dwrf
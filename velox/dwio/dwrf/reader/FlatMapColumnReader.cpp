@@ -220,6 +220,8 @@ ParsedKeyFilter<T> parseKeyFilter(
       .keys = std::move(keys)};
 }
 
+} // namespace
+
 template <typename T>
 KeyPredicate<T> prepareKeyPredicate(
     const std::shared_ptr<const TypeWithId>& requestedType,
@@ -231,6 +233,8 @@ KeyPredicate<T> prepareKeyPredicate(
           parsedKeyFilter.keys.begin(), parsedKeyFilter.keys.end()));
 }
 
+namespace {
+
 template <typename T>
 std::vector<std::unique_ptr<KeyNode<T>>> rearrangeKeyNodesAsProjectedOrder(
     std::vector<std::unique_ptr<KeyNode<T>>>& availableKeyNodes,
@@ -756,6 +760,22 @@ std::unique_ptr<ColumnReader> createFlatMapColumnReader(
   }
 }
 
+template KeyPredicate<int8_t> prepareKeyPredicate<int8_t>(
+    const std::shared_ptr<const TypeWithId>& requestedType,
+    StripeStreams& stripe);
+template KeyPredicate<int16_t> prepareKeyPredicate<int16_t>(
+    const std::shared_ptr<const TypeWithId>& requestedType,
+    StripeStreams& stripe);
+template KeyPredicate<int32_t> prepareKeyPredicate<int32_t>(
+    const std::shared_ptr<const TypeWithId>& requestedType,
+    StripeStreams& stripe);
+template KeyPredicate<int64_t> prepareKeyPredicate<int64_t>(
+    const std::shared_ptr<const TypeWithId>& requestedType,
+    StripeStreams& stripe);
+template KeyPredicate<StringView> prepareKeyPredicate<StringView>(
+    const std::shared_ptr<const TypeWithId>& requestedType,
+    StripeStreams& stripe);
+
 // declare all possible flat map column reader
 template class FlatMapColumnReader<int8_t>;
 template class FlatMapColumnReader<int16_t>;
@@ -198,6 +198,14 @@ class KeyPredicate {
   std::function<bool(const KeyValue<T>&, const Lookup&)> predicate_;
 };
 
+// Returns the predicate for the keys of the flat map 'requestedType' given
+// by the key filter of the column selector of 'stripe'. Passes all keys if
+// there is no key filter.
+template <typename T>
+KeyPredicate<T> prepareKeyPredicate(
+    const std::shared_ptr<const dwio::common::TypeWithId>& requestedType,
+    StripeStreams& stripe);
+
 template <typename T>
 class FlatMapColumnReader : public ColumnReader {
  public:
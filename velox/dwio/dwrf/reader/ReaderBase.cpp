@@ -110,13 +110,69 @@ ReaderBase::ReaderBase(
   fileLength_ = stream_->getLength();
   DWIO_ENSURE(fileLength_ > 0, "ORC file is empty");
 
+  auto* tailCache =
+      fileNum_ != kDefaultFileNum ? FileTailCache::instance() : nullptr;
+  if (tailCache) {
+    tail_ = tailCache->find(fileNum_, fileLength_);
+  }
+
   auto preloadFile = fileLength_ <= FILE_PRELOAD_THRESHOLD;
   uint64_t readSize =
       preloadFile ? fileLength_ : std::min(fileLength_, DIRECTORY_SIZE_GUESS);
   DWIO_ENSURE_GE(readSize, 4, "File size too small");
 
-  input_->enqueue({fileLength_ - readSize, readSize});
-  input_->load(preloadFile ? LogType::FILE : LogType::FOOTER);
+  if (!tail_ || preloadFile) {
+    input_->enqueue({fileLength_ - readSize, readSize});
+    input_->load(preloadFile ? LogType::FILE : LogType::FOOTER);
+  }
+
+  if (tail_) {
+    footer_ = tail_->footer;
+    schema_ = tail_->schema;
+    psLength_ = tail_->psLength;
+  } else {
+    auto tail =
+        readTail(tailCache ? tailCache->pool() : pool, readSize, fileFormat);
+    if (tailCache) {
+      tailCache->insert(fileNum_, fileLength_, std::move(tail));
+    }
+  }
+
+  if (input_->shouldPrefetchStripes()) {
+    auto numStripes = getFooter().stripes_size();
+    for (auto i = 0; i < numStripes; i++) {
+      const auto& stripe = getFooter().stripes(i);
+      input_->enqueue(
+          {stripe.offset() + stripe.indexlength() + stripe.datalength(),
+           stripe.footerlength()});
+    }
+    if (numStripes) {
+      input_->load(LogType::FOOTER);
+    }
+  }
+  // initialize file decrypter
+  handler_ = DecryptionHandler::create(*footer_, decryptorFactory_.get());
+}
+
+std::shared_ptr<const FileTail> ReaderBase::makeTail(
+    std::unique_ptr<PostScript> postScript,
+    proto::Footer* footer,
+    std::unique_ptr<StripeMetadataCache> cache) {
+  auto tail = std::make_shared<FileTail>();
+  tail->postScript = std::move(postScript);
+  tail->footer = footer;
+  tail->cache = std::move(cache);
+  return tail;
+}
+
+std::shared_ptr<FileTail> ReaderBase::readTail(
+    MemoryPool& tailPool,
+    uint64_t readSize,
+    FileFormat fileFormat) {
+  auto tail = std::make_shared<FileTail>();
+  tail->arena = std::make_unique<google::protobuf::Arena>();
+  // The accessors used while parsing see the partially filled 'tail'.
+  tail_ = tail;
 
   // TODO: read footer from spectrum
   {
@@ -126,6 +182,7 @@ ReaderBase::ReaderBase(
     DWIO_ENSURE(lastByteStream->Next(&buf, &ignored), "failed to read");
     // Make sure 'lastByteStream' is live while dereferencing 'buf'.
     psLength_ = *static_cast<const char*>(buf) & 0xff;
+    tail->psLength = psLength_;
   }
   DWIO_ENSURE_LE(
       psLength_ + 4, // 1 byte for post script len, 3 byte "ORC" header.
@@ -135,15 +192,15 @@ ReaderBase::ReaderBase(
   if (fileFormat == FileFormat::DWRF) {
     auto postScript = ProtoUtils::readProto<proto::PostScript>(
         input_->read(fileLength_ - psLength_ - 1, psLength_, LogType::FOOTER));
-    postScript_ = std::make_unique<PostScript>(*postScript);
+    tail->postScript = std::make_unique<PostScript>(*postScript);
   } else {
     auto postScript = ProtoUtils::readProto<proto::orc::PostScript>(
         input_->read(fileLength_ - psLength_ - 1, psLength_, LogType::FOOTER));
-    postScript_ = std::make_unique<PostScript>(*postScript);
+    tail->postScript = std::make_unique<PostScript>(*postScript);
   }
 
-  uint64_t footerSize = postScript_->footerLength();
-  uint64_t cacheSize = postScript_->cacheSize();
+  uint64_t footerSize = tail->postScript->footerLength();
+  uint64_t cacheSize = tail->postScript->cacheSize();
   uint64_t tailSize = 1 + psLength_ + footerSize + cacheSize;
 
   // There are cases in warehouse, where RC/text files are stored
@@ -155,16 +212,16 @@ ReaderBase::ReaderBase(
       cacheSize, fileLength_, "Corrupted file, cache size is invalid");
   DWIO_ENSURE_LE(tailSize, fileLength_, "Corrupted file, tail size is invalid");
 
-  if (getFileFormat() == FileFormat::DWRF) {
+  if (tail->postScript->fileFormat() == FileFormat::DWRF) {
     DWIO_ENSURE(
-        proto::CompressionKind_IsValid(postScript_->compression()),
+        proto::CompressionKind_IsValid(tail->postScript->compression()),
         "Corrupted File, invalid compression kind ",
-        postScript_->compression());
+        tail->postScript->compression());
   } else {
     DWIO_ENSURE(
-        proto::orc::CompressionKind_IsValid(postScript_->compression()),
+        proto::orc::CompressionKind_IsValid(tail->postScript->compression()),
         "Corrupted File, invalid compression kind ",
-        postScript_->compression());
+        tail->postScript->compression());
   }
 
   if (tailSize > readSize) {
@@ -174,39 +231,29 @@ ReaderBase::ReaderBase(
 
   auto footerStream = input_->read(
       fileLength_ - psLength_ - footerSize - 1, footerSize, LogType::FOOTER);
-  footer_ = google::protobuf::Arena::CreateMessage<proto::Footer>(arena_.get());
+  footer_ =
+      google::protobuf::Arena::CreateMessage<proto::Footer>(tail->arena.get());
   ProtoUtils::readProtoInto<proto::Footer>(
       createDecompressedStream(std::move(footerStream), "File Footer"),
       footer_);
+  tail->footer = footer_;
 
   schema_ = std::dynamic_pointer_cast<const RowType>(convertType(*footer_));
   DWIO_ENSURE_NOT_NULL(schema_, "invalid schema");
+  tail->schema = schema_;
 
   // load stripe index/footer cache
   if (cacheSize > 0) {
     DWIO_ENSURE_EQ(getFileFormat(), FileFormat::DWRF);
     auto cacheBuffer =
-        std::make_shared<dwio::common::DataBuffer<char>>(pool, cacheSize);
+        std::make_shared<dwio::common::DataBuffer<char>>(tailPool, cacheSize);
     input_->read(fileLength_ - tailSize, cacheSize, LogType::FOOTER)
         ->readFully(cacheBuffer->data(), cacheSize);
-    cache_ = std::make_unique<StripeMetadataCache>(
-        postScript_->cacheMode(), *footer_, std::move(cacheBuffer));
+    tail->cache = std::make_unique<StripeMetadataCache>(
+        tail->postScript->cacheMode(), *footer_, std::move(cacheBuffer));
   }
 
-  if (input_->shouldPrefetchStripes()) {
-    auto numStripes = getFooter().stripes_size();
-    for (auto i = 0; i < numStripes; i++) {
-      const auto& stripe = getFooter().stripes(i);
-      input_->enqueue(
-          {stripe.offset() + stripe.indexlength() + stripe.datalength(),
-           stripe.footerlength()});
-    }
-    if (numStripes) {
-      input_->load(LogType::FOOTER);
-    }
-  }
-  // initialize file decrypter
-  handler_ = DecryptionHandler::create(*footer_, decryptorFactory_.get());
+  return tail;
 }
 
 std::vector<uint64_t> ReaderBase::getRowsPerStripe() const {
@@ -22,6 +22,7 @@
 #include "velox/dwio/common/TypeWithId.h"
 #include "velox/dwio/dwrf/common/Compression.h"
 #include "velox/dwio/dwrf/common/Statistics.h"
+#include "velox/dwio/dwrf/reader/FileTailCache.h"
 #include "velox/dwio/dwrf/reader/StripeMetadataCache.h"
 #include "velox/dwio/dwrf/utils/ProtoUtils.h"
 
@@ -89,9 +90,8 @@ class ReaderBase {
       std::unique_ptr<encryption::DecryptionHandler> handler = nullptr)
       : pool_{pool},
         stream_{std::move(stream)},
-        postScript_{std::move(ps)},
+        tail_{makeTail(std::move(ps), footer, std::move(cache))},
         footer_{footer},
-        cache_{std::move(cache)},
         handler_{std::move(handler)},
         input_{
             stream_
@@ -126,7 +126,7 @@ class ReaderBase {
   }
 
   const PostScript& getPostScript() const {
-    return *postScript_;
+    return *tail_->postScript;
   }
 
   const proto::Footer& getFooter() const {
@@ -156,7 +156,7 @@ class ReaderBase {
   }
 
   const std::unique_ptr<StripeMetadataCache>& getMetadataCache() const {
-    return cache_;
+    return tail_->cache;
   }
 
   const encryption::DecryptionHandler& getDecryptionHandler() const {
@@ -174,15 +174,15 @@ class ReaderBase {
   }
 
   uint64_t getCompressionBlockSize() const {
-    return postScript_->compressionBlockSize();
+    return tail_->postScript->compressionBlockSize();
   }
 
   dwio::common::CompressionKind getCompressionKind() const {
-    return postScript_->compression();
+    return tail_->postScript->compression();
   }
 
   WriterVersion getWriterVersion() const {
-    auto version = postScript_->writerVersion();
+    auto version = tail_->postScript->writerVersion();
     return version <= WriterVersion_CURRENT
         ? static_cast<WriterVersion>(version)
         : WriterVersion::FUTURE;
@@ -207,14 +207,16 @@ class ReaderBase {
   std::unique_ptr<dwio::common::SeekableInputStream> createDecompressedStream(
       std::unique_ptr<dwio::common::SeekableInputStream> compressed,
       const std::string& streamDebugInfo,
-      const dwio::common::encryption::Decrypter* decrypter = nullptr) const {
+      const dwio::common::encryption::Decrypter* decrypter = nullptr,
+      const ParallelDecompressionOptions& parallel = {}) const {
     return createDecompressor(
         getCompressionKind(),
         std::move(compressed),
         getCompressionBlockSize(),
         pool_,
         streamDebugInfo,
-        decrypter);
+        decrypter,
+        parallel);
   }
 
   template <typename T>
@@ -232,7 +234,7 @@ class ReaderBase {
   }
 
   dwio::common::FileFormat getFileFormat() const {
-    return postScript_->fileFormat();
+    return tail_->postScript->fileFormat();
   }
 
  private:
@@ -240,14 +242,28 @@ class ReaderBase {
       const proto::Footer& footer,
       uint32_t index = 0);
 
+  static std::shared_ptr<const FileTail> makeTail(
+      std::unique_ptr<PostScript> postScript,
+      proto::Footer* footer,
+      std::unique_ptr<StripeMetadataCache> cache);
+
+  // Reads and parses the PostScript, footer and stripe metadata cache into
+  // 'tail_'. The metadata cache is allocated from 'tailPool'. 'readSize'
+  // bytes at the end of the file are already loaded into 'input_'.
+  std::shared_ptr<FileTail> readTail(
+      memory::MemoryPool& tailPool,
+      uint64_t readSize,
+      dwio::common::FileFormat fileFormat);
+
   memory::MemoryPool& pool_;
   std::unique_ptr<dwio::common::InputStream> stream_;
+  // For the stripe footers.
   std::unique_ptr<google::protobuf::Arena> arena_;
-  std::unique_ptr<PostScript> postScript_;
+  // May be shared with other readers of the file.
+  std::shared_ptr<const FileTail> tail_;
 
   proto::Footer* footer_ = nullptr;
   uint64_t fileNum_;
-  std::unique_ptr<StripeMetadataCache> cache_;
   // Keeps factory alive for possibly async prefetch.
   std::shared_ptr<dwio::common::encryption::DecrypterFactory> decryptorFactory_;
   std::unique_ptr<encryption::DecryptionHandler> handler_;
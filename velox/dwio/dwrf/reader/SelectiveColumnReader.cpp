@@ -187,6 +187,84 @@ void SelectiveColumnReader::getIntValues(
   }
 }
 
+namespace {
+// Minimum number of values on average per run for a column to be returned
+// run-length encoded.
+constexpr vector_size_t kMinAverageRunLength = 8;
+
+template <typename T>
+VectorPtr encodeRuns(const FlatVector<T>& flat, memory::MemoryPool* pool) {
+  const auto size = flat.size();
+  const auto* rawValues = flat.rawValues();
+  const auto* rawNulls = flat.rawNulls();
+  auto sameAsPrevious = [&](vector_size_t row) {
+    if (rawNulls) {
+      bool isNull = bits::isBitNull(rawNulls, row);
+      if (isNull != bits::isBitNull(rawNulls, row - 1)) {
+        return false;
+      }
+      if (isNull) {
+        return true;
+      }
+    }
+    return rawValues[row] == rawValues[row - 1];
+  };
+
+  // Counts the runs. Stops as soon as the runs are too short on average.
+  const auto maxRuns = size / kMinAverageRunLength;
+  vector_size_t numRuns = 1;
+  for (auto row = 1; row < size; ++row) {
+    if (!sameAsPrevious(row) && ++numRuns > maxRuns) {
+      return nullptr;
+    }
+  }
+
+  auto values = BaseVector::create<FlatVector<T>>(flat.type(), numRuns, pool);
+  auto lengths = AlignedBuffer::allocate<vector_size_t>(numRuns, pool);
+  auto* rawLengths = lengths->asMutable<vector_size_t>();
+  vector_size_t run = 0;
+  vector_size_t runStart = 0;
+  for (auto row = 1; row <= size; ++row) {
+    if (row < size && sameAsPrevious(row)) {
+      continue;
+    }
+    if (rawNulls && bits::isBitNull(rawNulls, runStart)) {
+      values->setNull(run, true);
+    } else {
+      values->set(run, rawValues[runStart]);
+    }
+    rawLengths[run++] = row - runStart;
+    runStart = row;
+  }
+  return BaseVector::wrapInSequence(std::move(lengths), size, values);
+}
+} // namespace
+
+void SelectiveColumnReader::makeRunLengthEncoded(VectorPtr* result) {
+  auto& vector = *result;
+  if (!vector->isFlatEncoding() ||
+      vector->size() < 2 * kMinAverageRunLength) {
+    return;
+  }
+  VectorPtr encoded;
+  switch (vector->typeKind()) {
+    case TypeKind::SMALLINT:
+      encoded = encodeRuns(*vector->asFlatVector<int16_t>(), &memoryPool_);
+      break;
+    case TypeKind::INTEGER:
+      encoded = encodeRuns(*vector->asFlatVector<int32_t>(), &memoryPool_);
+      break;
+    case TypeKind::BIGINT:
+      encoded = encodeRuns(*vector->asFlatVector<int64_t>(), &memoryPool_);
+      break;
+    default:
+      return;
+  }
+  if (encoded) {
+    vector = std::move(encoded);
+  }
+}
+
 template <>
 void SelectiveColumnReader::getFlatValues<int8_t, bool>(
     RowSet rows,
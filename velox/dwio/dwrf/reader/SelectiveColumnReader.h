@@ -353,6 +353,11 @@ class SelectiveColumnReader {
   // 'requestedType' in '*result'.
   void getIntValues(RowSet rows, const Type* requestedType, VectorPtr* result);
 
+  // Replaces the flat integer vector in '*result' with a SequenceVector if
+  // the values form runs of at least kMinAverageRunLength values on average.
+  // Leaves '*result' unchanged otherwise.
+  void makeRunLengthEncoded(VectorPtr* result);
+
   // Returns read values for 'rows' in 'vector'. This can be called
   // multiple times for consecutive subsets of 'rows'. If 'isFinal' is
   // true, this is free not to maintain the information mapping values
@@ -0,0 +1,466 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#include "velox/dwio/dwrf/reader/SelectiveFlatMapColumnReader.h"
+#include "velox/dwio/dwrf/reader/SelectiveDwrfReader.h"
+
+namespace facebook::velox::dwrf {
+
+using namespace dwio::common;
+
+namespace {
+
+template <typename T>
+T parseKey(const std::string& name) {
+  return folly::to<T>(name);
+}
+
+template <>
+StringView parseKey<StringView>(const std::string& /*name*/) {
+  // Set after all names are known. See SelectiveFlatMapColumnReader().
+  return StringView();
+}
+
+template <typename T>
+T extractKey(const proto::KeyInfo& info) {
+  return static_cast<T>(info.intkey());
+}
+
+template <>
+StringView extractKey<StringView>(const proto::KeyInfo& info) {
+  return StringView(info.byteskey());
+}
+
+template <typename T>
+std::string keyName(const proto::KeyInfo& info) {
+  return folly::to<std::string>(info.intkey());
+}
+
+template <>
+std::string keyName<StringView>(const proto::KeyInfo& info) {
+  return info.byteskey();
+}
+
+bool isMapChildName(const std::string& name) {
+  return name == "keys" || name == "elements";
+}
+
+// Returns the nulls of 'rows' in 'readerNulls', nullptr if no nulls.
+BufferPtr nullsForRows(
+    const BufferPtr& readerNulls,
+    RowSet rows,
+    memory::MemoryPool& pool) {
+  if (!readerNulls) {
+    return nullptr;
+  }
+  auto nulls = AlignedBuffer::allocate<bool>(rows.size(), &pool);
+  auto* rawNulls = nulls->asMutable<uint64_t>();
+  auto* rawReaderNulls = readerNulls->as<uint64_t>();
+  for (size_t i = 0; i < rows.size(); ++i) {
+    bits::setBit(rawNulls, i, bits::isBitSet(rawReaderNulls, rows[i]));
+  }
+  return nulls;
+}
+
+} // namespace
+
+template <typename T>
+SelectiveFlatMapColumnReader<T>::SelectiveFlatMapColumnReader(
+    const std::shared_ptr<const TypeWithId>& requestedType,
+    const std::shared_ptr<const TypeWithId>& dataType,
+    DwrfParams& params,
+    common::ScanSpec& scanSpec)
+    : SelectiveColumnReader(dataType, params, scanSpec, dataType->type),
+      requestedType_{requestedType},
+      rowsPerRowGroup_(formatData_->as<DwrfData>().rowsPerRowGroup()) {
+  auto& stripe = params.stripeStreams();
+  std::vector<std::string> names;
+  const auto& structKeys =
+      stripe.getRowReaderOptions().getMapColumnIdAsStruct();
+  auto it = structKeys.find(requestedType_->id);
+  if (it != structKeys.end()) {
+    structOutput_ = true;
+    names = it->second;
+  } else {
+    for (auto& child : scanSpec.children()) {
+      if (!isMapChildName(child->fieldName())) {
+        names.push_back(child->fieldName());
+      }
+    }
+  }
+
+  // Without named keys, the values of all keys share the spec of the map
+  // elements. Filters on these would drop map entries, not rows.
+  const bool readAllKeys = names.empty();
+  common::ScanSpec* elementsSpec = nullptr;
+  std::unordered_map<std::string, size_t> keyIndices;
+  if (readAllKeys) {
+    VELOX_CHECK(
+        !scanSpec.hasFilter(),
+        "Filters on the keys or elements of a flat map are not supported");
+    elementsSpec = scanSpec.getOrCreateChild(common::Subfield("elements"));
+    elementsSpec->setProjectOut(true);
+    elementsSpec->setExtractValues(true);
+  } else {
+    for (auto& name : names) {
+      auto* spec = scanSpec.childByName(name);
+      if (!spec) {
+        std::vector<std::unique_ptr<common::Subfield::PathElement>> path;
+        path.push_back(std::make_unique<common::Subfield::NestedField>(name));
+        spec = scanSpec.getOrCreateChild(common::Subfield(std::move(path)));
+        spec->setProjectOut(true);
+        spec->setExtractValues(true);
+      }
+      keyIndices[name] = keys_.size();
+      keys_.emplace_back(parseKey<T>(name), name, spec);
+    }
+  }
+
+  const auto keyPredicate = prepareKeyPredicate<T>(requestedType, stripe);
+  const auto& requestedValueType = requestedType->childAt(1);
+  const auto& dataValueType = dataType->childAt(1);
+  std::unordered_set<uint32_t> processed;
+  stripe.visitStreamsOfNode(
+      dataValueType->id, [&](const StreamInformation& stream) {
+        auto sequence = stream.getSequence();
+        // Sequence 0 has the shared dictionary of the keys, if any.
+        if (sequence == 0 || !processed.insert(sequence).second) {
+          return;
+        }
+        EncodingKey seqEk(dataValueType->id, sequence);
+        const auto& keyInfo = stripe.getEncoding(seqEk).key();
+        if (!keyPredicate(KeyValue<T>(extractKey<T>(keyInfo)))) {
+          return;
+        }
+        auto name = keyName<T>(keyInfo);
+        size_t index;
+        if (readAllKeys) {
+          index = keys_.size();
+          keys_.emplace_back(extractKey<T>(keyInfo), name, elementsSpec);
+        } else {
+          auto keyIt = keyIndices.find(name);
+          if (keyIt == keyIndices.end()) {
+            return;
+          }
+          index = keyIt->second;
+        }
+        auto inMap =
+            stripe.getStream(seqEk.forKind(proto::Stream_Kind_IN_MAP), true);
+        DWIO_ENSURE_NOT_NULL(inMap, "In map stream is required");
+        auto& key = keys_[index];
+        key.sequence = sequence;
+        key.inMap = createBooleanRleDecoder(std::move(inMap), seqEk);
+        auto childParams =
+            DwrfParams(stripe, FlatMapContext{sequence, key.inMap.get()});
+        key.reader = SelectiveDwrfReader::build(
+            requestedValueType, dataValueType, childParams, *key.spec);
+      });
+
+  if (readAllKeys) {
+    // Sort by sequence so that the order of keys is fixed.
+    std::sort(keys_.begin(), keys_.end(), [](auto& a, auto& b) {
+      return a.sequence < b.sequence;
+    });
+  }
+
+  if constexpr (std::is_same_v<T, StringView>) {
+    size_t size = 0;
+    for (auto& key : keys_) {
+      size += key.name.size();
+    }
+    keyStrings_ = AlignedBuffer::allocate<char>(size, &memoryPool_);
+    auto* data = keyStrings_->asMutable<char>();
+    for (auto& key : keys_) {
+      std::memcpy(data, key.name.data(), key.name.size());
+      key.key = StringView(data, key.name.size());
+      data += key.name.size();
+    }
+  }
+  VLOG(1) << "[Flat-Map] Initialized a selective flat-map column reader for "
+          << "node " << dataType->id << ", keys=" << keys_.size();
+}
+
+template <typename T>
+void SelectiveFlatMapColumnReader<T>::seekToRowGroup(uint32_t index) {
+  formatData_->seekToRowGroup(index);
+  // The value readers also seek the in map streams of their keys.
+  for (auto& key : keys_) {
+    if (key.reader) {
+      key.reader->seekToRowGroup(index);
+    }
+  }
+  setReadOffsetRecursive(index * rowsPerRowGroup_);
+}
+
+template <typename T>
+uint64_t SelectiveFlatMapColumnReader<T>::readInMap(
+    KeyReader& key,
+    vector_size_t numRows,
+    const uint64_t* mapNulls) {
+  auto numBytes = bits::nbytes(numRows);
+  if (!key.inMapRows ||
+      key.inMapRows->capacity() < numBytes + simd::kPadding) {
+    key.inMapRows = AlignedBuffer::allocate<char>(
+        numBytes + simd::kPadding, &memoryPool_);
+  }
+  auto* inMapRows = key.inMapRows->asMutable<uint64_t>();
+  key.inMap->next(reinterpret_cast<char*>(inMapRows), numRows, mapNulls);
+  return bits::countBits(inMapRows, 0, numRows);
+}
+
+template <typename T>
+uint64_t SelectiveFlatMapColumnReader<T>::skip(uint64_t numValues) {
+  auto numNonNulls = formatData_->skipNulls(numValues);
+  // As in SelectiveStructColumnReader, the read offsets of the value
+  // readers are in terms of rows of the map, although the values of a key
+  // exist only for the maps that have the key.
+  for (auto& key : keys_) {
+    if (!key.reader) {
+      continue;
+    }
+    key.reader->skip(readInMap(key, numNonNulls, nullptr));
+    key.reader->setReadOffsetRecursive(key.reader->readOffset() + numValues);
+  }
+  return numValues;
+}
+
+template <typename T>
+std::vector<uint32_t> SelectiveFlatMapColumnReader<T>::filterRowGroups(
+    uint64_t rowGroupSize,
+    const dwio::common::StatsContext& context) const {
+  auto stridesToSkip =
+      SelectiveColumnReader::filterRowGroups(rowGroupSize, context);
+  for (const auto& key : keys_) {
+    // The statistics of a key do not count the rows without the key,
+    // which are null for the filter. So these can drop row groups only
+    // if the filter does not pass nulls.
+    auto* filter = key.spec->filter();
+    if (!key.reader || !filter || filter->testNull()) {
+      continue;
+    }
+    auto keyStridesToSkip = key.reader->filterRowGroups(rowGroupSize, context);
+    if (stridesToSkip.empty()) {
+      stridesToSkip = std::move(keyStridesToSkip);
+    } else {
+      std::vector<uint32_t> merged;
+      merged.reserve(keyStridesToSkip.size() + stridesToSkip.size());
+      std::merge(
+          keyStridesToSkip.begin(),
+          keyStridesToSkip.end(),
+          stridesToSkip.begin(),
+          stridesToSkip.end(),
+          std::back_inserter(merged));
+      stridesToSkip = std::move(merged);
+    }
+  }
+  return stridesToSkip;
+}
+
+template <typename T>
+void SelectiveFlatMapColumnReader<T>::read(
+    vector_size_t offset,
+    RowSet rows,
+    const uint64_t* incomingNulls) {
+  scanSpec_->newRead();
+  prepareRead<char>(offset, rows, incomingNulls);
+  const vector_size_t numRows = rows.back() + 1;
+  const uint64_t* mapNulls =
+      nullsInReadRange_ ? nullsInReadRange_->as<uint64_t>() : nullptr;
+  RowSet activeRows = rows;
+  auto readKey = [&](KeyReader& key) {
+    if (!key.reader) {
+      // All rows are null for a key that is not in the stripe.
+      auto* filter = key.spec->filter();
+      if (filter && !filter->testNull()) {
+        activeRows = RowSet();
+      }
+      return;
+    }
+    readInMap(key, numRows, mapNulls);
+    auto* inMapRows = key.inMapRows->as<uint64_t>();
+    vector_size_t numRead = 0;
+    if (!activeRows.empty()) {
+      numRead = activeRows.back() + 1;
+      key.reader->read(offset, activeRows, inMapRows);
+      if (key.spec->hasFilter()) {
+        activeRows = key.reader->outputRows();
+      }
+    }
+    // Skip the values of the rows after the last row read, so that all
+    // keys end at the same row.
+    auto numToSkip = bits::countBits(inMapRows, numRead, numRows);
+    if (numToSkip > 0) {
+      key.reader->skip(numToSkip);
+    }
+    key.reader->setReadOffsetRecursive(offset + numRows);
+  };
+  // Keys with filters are read first, so that the other keys are read
+  // only for the rows that pass.
+  for (auto& key : keys_) {
+    if (key.spec->hasFilter()) {
+      readKey(key);
+    }
+  }
+  for (auto& key : keys_) {
+    if (!key.spec->hasFilter()) {
+      readKey(key);
+    }
+  }
+  if (scanSpec_->hasFilter()) {
+    setOutputRows(activeRows);
+  }
+  readOffset_ = offset + numRows;
+}
+
+template <typename T>
+void SelectiveFlatMapColumnReader<T>::getValues(
+    RowSet rows,
+    VectorPtr* result) {
+  if (structOutput_) {
+    makeStructValues(rows, result);
+  } else {
+    makeMapValues(rows, result);
+  }
+}
+
+template <typename T>
+void SelectiveFlatMapColumnReader<T>::makeMapValues(
+    RowSet rows,
+    VectorPtr* result) {
+  const auto& mapType = requestedType_->type->asMap();
+  const vector_size_t numRows = rows.size();
+  auto offsets = allocateOffsets(numRows, &memoryPool_);
+  auto sizes = allocateSizes(numRows, &memoryPool_);
+  auto* rawOffsets = offsets->asMutable<vector_size_t>();
+  auto* rawSizes = sizes->asMutable<vector_size_t>();
+  auto isOutput = [&](const KeyReader& key) {
+    return key.reader && key.spec->projectOut() && numRows > 0;
+  };
+  for (auto& key : keys_) {
+    if (!isOutput(key)) {
+      continue;
+    }
+    auto* inMapRows = key.inMapRows->as<uint64_t>();
+    for (vector_size_t i = 0; i < numRows; ++i) {
+      rawSizes[i] += bits::isBitSet(inMapRows, rows[i]);
+    }
+  }
+  vector_size_t numEntries = 0;
+  for (vector_size_t i = 0; i < numRows; ++i) {
+    rawOffsets[i] = numEntries;
+    numEntries += rawSizes[i];
+  }
+
+  auto keys = BaseVector::create(mapType.keyType(), numEntries, &memoryPool_);
+  auto* flatKeys = keys->asFlatVector<T>();
+  VELOX_CHECK_NOT_NULL(flatKeys, "Unexpected key type of flat map");
+  if constexpr (std::is_same_v<T, StringView>) {
+    flatKeys->setStringBuffers({keyStrings_});
+  }
+  auto values =
+      BaseVector::create(mapType.valueType(), numEntries, &memoryPool_);
+  // The maps have the entries of each key in the order of 'keys_'.
+  std::vector<vector_size_t> nextEntry(rawOffsets, rawOffsets + numRows);
+  for (auto& key : keys_) {
+    if (!isOutput(key)) {
+      continue;
+    }
+    auto keyValues = BaseVector::create(mapType.valueType(), 0, &memoryPool_);
+    key.reader->getValues(rows, &keyValues);
+    auto* inMapRows = key.inMapRows->as<uint64_t>();
+    for (vector_size_t i = 0; i < numRows; ++i) {
+      if (bits::isBitSet(inMapRows, rows[i])) {
+        auto entry = nextEntry[i]++;
+        flatKeys->set(entry, key.key);
+        values->copy(keyValues.get(), entry, i, 1);
+      }
+    }
+  }
+  *result = std::make_shared<MapVector>(
+      &memoryPool_,
+      requestedType_->type,
+      nullsForRows(nullsInReadRange_, rows, memoryPool_),
+      numRows,
+      std::move(offsets),
+      std::move(sizes),
+      std::move(keys),
+      std::move(values));
+}
+
+template <typename T>
+void SelectiveFlatMapColumnReader<T>::makeStructValues(
+    RowSet rows,
+    VectorPtr* result) {
+  const auto& valueType = requestedType_->type->asMap().valueType();
+  std::vector<std::string> names;
+  std::vector<TypePtr> types;
+  std::vector<VectorPtr> children;
+  for (auto& key : keys_) {
+    names.push_back(key.name);
+    types.push_back(valueType);
+    if (!key.reader || rows.empty()) {
+      children.push_back(
+          BaseVector::createNullConstant(valueType, rows.size(), &memoryPool_));
+      continue;
+    }
+    auto keyValues = BaseVector::create(valueType, 0, &memoryPool_);
+    key.reader->getValues(rows, &keyValues);
+    children.push_back(std::move(keyValues));
+  }
+  *result = std::make_shared<RowVector>(
+      &memoryPool_,
+      ROW(std::move(names), std::move(types)),
+      nullsForRows(nullsInReadRange_, rows, memoryPool_),
+      rows.size(),
+      std::move(children));
+}
+
+std::unique_ptr<SelectiveColumnReader> createSelectiveFlatMapColumnReader(
+    const std::shared_ptr<const TypeWithId>& requestedType,
+    const std::shared_ptr<const TypeWithId>& dataType,
+    DwrfParams& params,
+    common::ScanSpec& scanSpec) {
+  const auto kind = dataType->childAt(0)->type->kind();
+  switch (kind) {
+    case TypeKind::TINYINT:
+      return std::make_unique<SelectiveFlatMapColumnReader<int8_t>>(
+          requestedType, dataType, params, scanSpec);
+    case TypeKind::SMALLINT:
+      return std::make_unique<SelectiveFlatMapColumnReader<int16_t>>(
+          requestedType, dataType, params, scanSpec);
+    case TypeKind::INTEGER:
+      return std::make_unique<SelectiveFlatMapColumnReader<int32_t>>(
+          requestedType, dataType, params, scanSpec);
+    case TypeKind::BIGINT:
+      return std::make_unique<SelectiveFlatMapColumnReader<int64_t>>(
+          requestedType, dataType, params, scanSpec);
+    case TypeKind::VARBINARY:
+    case TypeKind::VARCHAR:
+      return std::make_unique<SelectiveFlatMapColumnReader<StringView>>(
+          requestedType, dataType, params, scanSpec);
+    default:
+      DWIO_RAISE("Not supported key type: ", kind);
+  }
+}
+
+template class SelectiveFlatMapColumnReader<int8_t>;
+template class SelectiveFlatMapColumnReader<int16_t>;
+template class SelectiveFlatMapColumnReader<int32_t>;
+template class SelectiveFlatMapColumnReader<int64_t>;
+template class SelectiveFlatMapColumnReader<StringView>;
+
+} // namespace facebook::velox::dwrf
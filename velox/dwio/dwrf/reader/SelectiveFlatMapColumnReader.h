@@ -0,0 +1,123 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#pragma once
+
+#include "velox/dwio/dwrf/reader/DwrfData.h"
+#include "velox/dwio/dwrf/reader/FlatMapColumnReader.h"
+#include "velox/dwio/dwrf/reader/SelectiveColumnReaderInternal.h"
+
+namespace facebook::velox::dwrf {
+
+// Selective reader for a flat map column. Each key of the flat map has its
+// own value streams and in map stream, so each key is read like a member of
+// a struct whose rows without the key are null.
+//
+// If the ScanSpec of the map has children other than 'keys' and 'elements',
+// these name the keys to read. A filter in such a child applies to the
+// value of its key, so that the filters of several keys combine like the
+// filters of struct members. Otherwise all keys selected by the column
+// selector are read. The result is a MapVector, or a RowVector with a
+// child per key if the column is listed in
+// RowReaderOptions::getMapColumnIdAsStruct().
+template <typename T>
+class SelectiveFlatMapColumnReader : public SelectiveColumnReader {
+ public:
+  SelectiveFlatMapColumnReader(
+      const std::shared_ptr<const dwio::common::TypeWithId>& requestedType,
+      const std::shared_ptr<const dwio::common::TypeWithId>& dataType,
+      DwrfParams& params,
+      common::ScanSpec& scanSpec);
+
+  void resetFilterCaches() override {
+    for (auto& key : keys_) {
+      if (key.reader) {
+        key.reader->resetFilterCaches();
+      }
+    }
+  }
+
+  void seekToRowGroup(uint32_t index) override;
+
+  uint64_t skip(uint64_t numValues) override;
+
+  std::vector<uint32_t> filterRowGroups(
+      uint64_t rowGroupSize,
+      const dwio::common::StatsContext& context) const override;
+
+  void read(vector_size_t offset, RowSet rows, const uint64_t* incomingNulls)
+      override;
+
+  void getValues(RowSet rows, VectorPtr* result) override;
+
+  void setReadOffsetRecursive(int32_t readOffset) override {
+    readOffset_ = readOffset;
+    for (auto& key : keys_) {
+      if (key.reader) {
+        key.reader->setReadOffsetRecursive(readOffset);
+      }
+    }
+  }
+
+ private:
+  struct KeyReader {
+    KeyReader(T key, std::string name, common::ScanSpec* spec)
+        : key{key}, name{std::move(name)}, spec{spec} {}
+
+    T key;
+    // The key as a field name in the ScanSpec and in struct output.
+    std::string name;
+    common::ScanSpec* spec;
+    // Sequence of the streams of the key. 0 if not in the stripe.
+    uint32_t sequence{0};
+    // Null if the key does not occur in the stripe.
+    std::unique_ptr<ByteRleDecoder> inMap;
+    std::unique_ptr<SelectiveColumnReader> reader;
+    // Bit per row of the last read. Set if the map is not null and
+    // has the key. Passed to 'reader' as incoming nulls.
+    BufferPtr inMapRows;
+  };
+
+  // Reads the in map bits of the next 'numNonNullMaps' non-null maps of
+  // 'key' into 'key.inMapRows', spreading them over 'numRows' rows
+  // with 'mapNulls'. Returns the number of rows that have the key.
+  uint64_t readInMap(
+      KeyReader& key,
+      vector_size_t numRows,
+      const uint64_t* mapNulls);
+
+  void makeMapValues(RowSet rows, VectorPtr* result);
+
+  void makeStructValues(RowSet rows, VectorPtr* result);
+
+  const std::shared_ptr<const dwio::common::TypeWithId> requestedType_;
+  const int32_t rowsPerRowGroup_;
+  // True if the result is a RowVector with a child per key.
+  bool structOutput_{false};
+  std::vector<KeyReader> keys_;
+  // Backing storage for string keys.
+  BufferPtr keyStrings_;
+};
+
+// Makes a SelectiveFlatMapColumnReader for the key type of 'dataType'.
+std::unique_ptr<SelectiveColumnReader> createSelectiveFlatMapColumnReader(
+    const std::shared_ptr<const dwio::common::TypeWithId>& requestedType,
+    const std::shared_ptr<const dwio::common::TypeWithId>& dataType,
+    DwrfParams& params,
+    common::ScanSpec& scanSpec);
+
+} // namespace facebook::velox::dwrf
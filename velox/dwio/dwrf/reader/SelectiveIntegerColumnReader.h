@@ -37,6 +37,9 @@ class SelectiveIntegerColumnReader : public SelectiveColumnReader {
 
   void getValues(RowSet rows, VectorPtr* result) override {
     getIntValues(rows, nodeType_->type.get(), result);
+    if (scanSpec_->makeRunLengthEncoded()) {
+      makeRunLengthEncoded(result);
+    }
   }
 
  protected:
@@ -144,6 +147,10 @@ void SelectiveIntegerColumnReader::processFilter(
       readHelper<Reader, common::BigintValuesUsingBitmask, isDense>(
           filter, rows, extractValues);
       break;
+    case common::FilterKind::kBigintValuesUsingBloomFilter:
+      readHelper<Reader, common::BigintValuesUsingBloomFilter, isDense>(
+          filter, rows, extractValues);
+      break;
     case common::FilterKind::kNegatedBigintValuesUsingHashTable:
       readHelper<Reader, common::NegatedBigintValuesUsingHashTable, isDense>(
           filter, rows, extractValues);
@@ -31,7 +31,10 @@ SelectiveIntegerDictionaryColumnReader::SelectiveIntegerDictionaryColumnReader(
           std::move(requestedType),
           params,
           scanSpec,
-          dataType->type) {
+          dataType->type),
+      dictionaryOutput_(params.stripeStreams()
+                            .getRowReaderOptions()
+                            .getIntegerDictionaryOutput()) {
   EncodingKey encodingKey{nodeType_->id, params.flatMapContext().sequence};
   auto& stripe = params.stripeStreams();
   auto encoding = stripe.getEncoding(encodingKey);
@@ -80,9 +83,10 @@ void SelectiveIntegerDictionaryColumnReader::read(
 
   // read the stream of booleans indicating whether a given data entry
   // is an offset or a literal value.
+  int32_t numFlags = 0;
   if (inDictionaryReader_) {
     bool isBulk = useBulkPath();
-    int32_t numFlags = (isBulk && nullsInReadRange_)
+    numFlags = (isBulk && nullsInReadRange_)
         ? bits::countNonNulls(nullsInReadRange_->as<uint64_t>(), 0, end)
         : end;
     dwio::common::ensureCapacity<uint64_t>(
@@ -99,9 +103,86 @@ void SelectiveIntegerDictionaryColumnReader::read(
 
   // lazy load dictionary only when it's needed
   ensureInitialized();
+  readsIndices_ = canReturnIndices(numFlags);
+  if (readsIndices_) {
+    valueSize_ = sizeof(int32_t);
+    ensureValuesCapacity<int32_t>(rows.size());
+    if (rows.back() == rows.size() - 1) {
+      readIndices<true>(rows);
+    } else {
+      readIndices<false>(rows);
+    }
+    return;
+  }
   readCommon<SelectiveIntegerDictionaryColumnReader>(rows);
 }
 
+bool SelectiveIntegerDictionaryColumnReader::canReturnIndices(
+    int32_t numFlags) const {
+  if (!dictionaryOutput_ || scanSpec_->filter() || !scanSpec_->keepValues() ||
+      scanSpec_->valueHook() || scanSpec_->makeFlat() ||
+      scanSpec_->makeRunLengthEncoded() || rleVersion_ != RleVersion_1 ||
+      scanState_.dictionary.numValues == 0) {
+    return false;
+  }
+  // The dictionary is returned as is, so the file type must be the requested
+  // type.
+  if (!nodeType_->type->kindEquals(type_)) {
+    return false;
+  }
+  // Values that are not in the dictionary are literals in the data stream.
+  // Null rows have no flag set when the flags are read row by row, so a
+  // batch with nulls takes this path only on the bulk path.
+  return !inDictionaryReader_ ||
+      bits::isAllSet(
+             scanState_.inDictionary->as<uint64_t>(), 0, numFlags, true);
+}
+
+template <typename T>
+void SelectiveIntegerDictionaryColumnReader::makeDictionaryValues() {
+  dictionaryValues_ = std::make_shared<FlatVector<T>>(
+      &memoryPool_,
+      nodeType_->type,
+      BufferPtr(nullptr),
+      scanState_.dictionary.numValues,
+      scanState_.dictionary.values,
+      std::vector<BufferPtr>{});
+}
+
+void SelectiveIntegerDictionaryColumnReader::getValues(
+    RowSet rows,
+    VectorPtr* result) {
+  if (!readsIndices_) {
+    SelectiveIntegerColumnReader::getValues(rows, result);
+    return;
+  }
+  if (!dictionaryValues_) {
+    switch (nodeType_->type->kind()) {
+      case TypeKind::SMALLINT:
+        makeDictionaryValues<int16_t>();
+        break;
+      case TypeKind::INTEGER:
+        makeDictionaryValues<int32_t>();
+        break;
+      case TypeKind::BIGINT:
+        makeDictionaryValues<int64_t>();
+        break;
+      default:
+        VELOX_FAIL(
+            "Not a valid type for integer reader: {}",
+            nodeType_->type->toString());
+    }
+  }
+  compactScalarValues<int32_t, int32_t>(rows, false);
+  *result = BaseVector::wrapInDictionary(
+      !anyNulls_               ? nullptr
+          : returnReaderNulls_ ? nullsInReadRange_
+                               : resultNulls_,
+      values_,
+      numValues_,
+      dictionaryValues_);
+}
+
 void SelectiveIntegerDictionaryColumnReader::ensureInitialized() {
   if (LIKELY(initialized_)) {
     return;
@@ -49,12 +49,37 @@ class SelectiveIntegerDictionaryColumnReader
   void read(vector_size_t offset, RowSet rows, const uint64_t* incomingNulls)
       override;
 
+  void getValues(RowSet rows, VectorPtr* result) override;
+
   template <typename ColumnVisitor>
   void readWithVisitor(RowSet rows, ColumnVisitor visitor);
 
  private:
   void ensureInitialized();
 
+  // True if the rows of the current read can be returned as indices into
+  // the stripe dictionary. 'numFlags' is the number of in dictionary flags
+  // read for the batch.
+  bool canReturnIndices(int32_t numFlags) const;
+
+  // Reads the dictionary indices of 'rows' into 'values_' without
+  // translating them.
+  template <bool isDense>
+  void readIndices(RowSet rows);
+
+  template <typename T>
+  void makeDictionaryValues();
+
+  // Set from RowReaderOptions::getIntegerDictionaryOutput().
+  const bool dictionaryOutput_;
+
+  // True if the last read() left dictionary indices in 'values_'.
+  bool readsIndices_{false};
+
+  // The stripe dictionary as a vector of the requested type. Made on first
+  // use.
+  VectorPtr dictionaryValues_;
+
   std::unique_ptr<ByteRleDecoder> inDictionaryReader_;
   std::unique_ptr<dwio::common::IntDecoder</* isSigned = */ false>> dataReader_;
   std::unique_ptr<dwio::common::IntDecoder</* isSigned = */ true>> dictReader_;
@@ -79,4 +104,21 @@ void SelectiveIntegerDictionaryColumnReader::readWithVisitor(
   }
   readOffset_ += numRows;
 }
+
+template <bool isDense>
+void SelectiveIntegerDictionaryColumnReader::readIndices(RowSet rows) {
+  vector_size_t numRows = rows.back() + 1;
+  // The indices are extracted as is, without the dictionary translation
+  // of readWithVisitor().
+  ColumnVisitor<int32_t, common::AlwaysTrue, ExtractToReader, isDense> visitor(
+      alwaysTrue(), this, rows, ExtractToReader(this));
+  auto reader = reinterpret_cast<RleDecoderV1<false>*>(dataReader_.get());
+  if (nullsInReadRange_) {
+    reader->readWithVisitor<true>(nullsInReadRange_->as<uint64_t>(), visitor);
+  } else {
+    reader->readWithVisitor<false>(nullptr, visitor);
+  }
+  readOffset_ += numRows;
+}
+
 } // namespace facebook::velox::dwrf
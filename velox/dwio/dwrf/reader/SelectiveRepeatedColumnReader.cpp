@@ -32,14 +32,18 @@ SelectiveListColumnReader::SelectiveListColumnReader(
   // count the number of selected sub-columns
   const auto& cs = stripe.getColumnSelector();
   auto& childType = requestedType_->childAt(0);
-  VELOX_CHECK(
-      cs.shouldReadNode(childType->id),
-      "SelectiveListColumnReader must select the values stream");
   if (scanSpec_->children().empty()) {
     scanSpec.getOrCreateChild(common::Subfield("elements"));
   }
-  scanSpec_->children()[0]->setProjectOut(true);
-  scanSpec_->children()[0]->setExtractValues(true);
+  prepareElementSpecs();
+  if (scanSpec_->elementAccess() != common::ScanSpec::ElementAccess::kAll) {
+    VELOX_CHECK(
+        !hasElementFilter_, "A lengths-only list cannot filter elements");
+    return;
+  }
+  VELOX_CHECK(
+      cs.shouldReadNode(childType->id),
+      "SelectiveListColumnReader must select the values stream");
 
   auto childParams =
       DwrfParams(stripe, FlatMapContext{encodingKey.sequence, nullptr});
@@ -76,11 +80,16 @@ void SelectiveListColumnReader::read(
     RowSet rows,
     const uint64_t* incomingNulls) {
   // Catch up if the child is behind the length stream.
-  child_->seekTo(childTargetReadOffset_, false);
+  if (child_) {
+    child_->seekTo(childTargetReadOffset_, false);
+  }
   prepareRead<char>(offset, rows, incomingNulls);
   makeNestedRowSet(rows);
-  if (child_ && !nestedRows_.empty()) {
-    child_->read(child_->readOffset(), nestedRows_, nullptr);
+  if (child_) {
+    auto passingNestedRows = readElements({child_.get()});
+    if (hasElementFilter_) {
+      filterByElements(rows, passingNestedRows);
+    }
   }
   numValues_ = rows.size();
   readOffset_ = offset + rows.back() + 1;
@@ -89,7 +98,11 @@ void SelectiveListColumnReader::read(
 void SelectiveListColumnReader::getValues(RowSet rows, VectorPtr* result) {
   compactOffsets(rows);
   VectorPtr elements;
-  if (child_ && !nestedRows_.empty()) {
+  if (!child_) {
+    // Lengths only.
+    elements = BaseVector::createNullConstant(
+        requestedType_->type->childAt(0), nestedRows_.size(), &memoryPool_);
+  } else if (!nestedRows_.empty()) {
     prepareStructResult(type_->childAt(0), &elements);
     child_->getValues(nestedRows_, &elements);
   }
@@ -117,10 +130,13 @@ SelectiveMapColumnReader::SelectiveMapColumnReader(
     scanSpec_->getOrCreateChild(common::Subfield("keys"));
     scanSpec_->getOrCreateChild(common::Subfield("elements"));
   }
-  scanSpec_->children()[0]->setProjectOut(true);
-  scanSpec_->children()[0]->setExtractValues(true);
-  scanSpec_->children()[1]->setProjectOut(true);
-  scanSpec_->children()[1]->setExtractValues(true);
+  prepareElementSpecs();
+  auto access = scanSpec_->elementAccess();
+  if (access == common::ScanSpec::ElementAccess::kLengthsOnly) {
+    VELOX_CHECK(
+        !hasElementFilter_, "A lengths-only map cannot filter elements");
+    return;
+  }
 
   const auto& cs = stripe.getColumnSelector();
   auto& keyType = requestedType_->childAt(0);
@@ -134,6 +150,12 @@ SelectiveMapColumnReader::SelectiveMapColumnReader(
       nodeType_->childAt(0),
       keyParams,
       *scanSpec_->children()[0].get());
+  if (access == common::ScanSpec::ElementAccess::kKeysOnly) {
+    VELOX_CHECK(
+        !scanSpec_->children()[1]->hasFilter(),
+        "A keys-only map cannot filter values");
+    return;
+  }
 
   auto& valueType = requestedType_->childAt(1);
   VELOX_CHECK(
@@ -196,9 +218,15 @@ void SelectiveMapColumnReader::read(
 
   prepareRead<char>(offset, rows, incomingNulls);
   makeNestedRowSet(rows);
-  if (keyReader_ && elementReader_ && !nestedRows_.empty()) {
-    keyReader_->read(keyReader_->readOffset(), nestedRows_, nullptr);
-    elementReader_->read(elementReader_->readOffset(), nestedRows_, nullptr);
+  if (keyReader_) {
+    std::vector<SelectiveColumnReader*> readers{keyReader_.get()};
+    if (elementReader_) {
+      readers.push_back(elementReader_.get());
+    }
+    auto passingNestedRows = readElements(readers);
+    if (hasElementFilter_) {
+      filterByElements(rows, passingNestedRows);
+    }
   }
   numValues_ = rows.size();
   readOffset_ = offset + rows.back() + 1;
@@ -208,12 +236,17 @@ void SelectiveMapColumnReader::getValues(RowSet rows, VectorPtr* result) {
   compactOffsets(rows);
   VectorPtr keys;
   VectorPtr values;
-  VELOX_CHECK(
-      keyReader_ && elementReader_,
-      "keyReader_ and elementReaer_ must exist in "
-      "SelectiveMapColumnReader::getValues");
-  if (!nestedRows_.empty()) {
+  auto& mapType = requestedType_->type;
+  if (!keyReader_) {
+    keys = BaseVector::createNullConstant(
+        mapType->childAt(0), nestedRows_.size(), &memoryPool_);
+  } else if (!nestedRows_.empty()) {
     keyReader_->getValues(nestedRows_, &keys);
+  }
+  if (!elementReader_) {
+    values = BaseVector::createNullConstant(
+        mapType->childAt(1), nestedRows_.size(), &memoryPool_);
+  } else if (!nestedRows_.empty()) {
     prepareStructResult(type_->childAt(1), &values);
     elementReader_->getValues(nestedRows_, &values);
   }
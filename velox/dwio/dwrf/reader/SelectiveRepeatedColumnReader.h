@@ -113,11 +113,66 @@ class SelectiveRepeatedColumnReader : public SelectiveColumnReader {
     childTargetReadOffset_ += nestedOffset;
   }
 
+  // Marks the specs of the keys and elements for value extraction, except
+  // those with filters, which only select the rows of 'this'.
+  void prepareElementSpecs() {
+    for (auto& childSpec : scanSpec_->children()) {
+      auto filtered = childSpec->hasFilter();
+      childSpec->setProjectOut(!filtered);
+      childSpec->setExtractValues(!filtered);
+      hasElementFilter_ |= filtered;
+    }
+    VELOX_CHECK(
+        !hasElementFilter_ || !scanSpec_->keepValues(),
+        "A list or map with element filters must be filter-only");
+  }
+
+  // Adds to the output rows the 'rows' for which at least one nested row
+  // is in 'passingNestedRows'. Called after makeNestedRowSet(rows) and
+  // reading the filtered keys or elements.
+  void filterByElements(RowSet rows, RowSet passingNestedRows) {
+    auto rawOffsets = offsets_->as<vector_size_t>();
+    auto rawSizes = sizes_->as<vector_size_t>();
+    vector_size_t passing = 0;
+    for (auto i = 0; i < rows.size(); ++i) {
+      if (rawSizes[i] == 0) {
+        continue;
+      }
+      auto last = nestedRows_[rawOffsets[i] + rawSizes[i] - 1];
+      while (passing < passingNestedRows.size() &&
+             passingNestedRows[passing] < nestedRows_[rawOffsets[i]]) {
+        ++passing;
+      }
+      if (passing < passingNestedRows.size() &&
+          passingNestedRows[passing] <= last) {
+        addOutputRow(rows[i]);
+      }
+    }
+  }
+
+  // Reads 'readers' for 'nestedRows_'. A reader whose spec has a filter
+  // narrows down the nested rows for the next ones. Returns the nested
+  // rows that pass the filters.
+  RowSet readElements(const std::vector<SelectiveColumnReader*>& readers) {
+    RowSet activeRows = nestedRows_;
+    for (auto* reader : readers) {
+      if (activeRows.empty()) {
+        break;
+      }
+      reader->read(reader->readOffset(), activeRows, nullptr);
+      if (reader->scanSpec()->hasFilter()) {
+        activeRows = reader->outputRows();
+      }
+    }
+    return activeRows;
+  }
+
   void compactOffsets(RowSet rows) {
     auto rawOffsets = offsets_->asMutable<vector_size_t>();
     auto rawSizes = sizes_->asMutable<vector_size_t>();
     VELOX_CHECK(
-        outputRows_.empty(), "Repeated reader does not support filters");
+        outputRows_.empty(),
+        "Values of a list or map with element filters are not extracted");
     RowSet rowsToCompact;
     if (valueRows_.empty()) {
       valueRows_.resize(rows.size());
@@ -158,6 +213,8 @@ class SelectiveRepeatedColumnReader : public SelectiveColumnReader {
     }
   }
 
+  // True if a key or element spec has a filter.
+  bool hasElementFilter_{false};
   std::vector<int64_t> allLengths_;
   raw_vector<vector_size_t> nestedRows_;
   BufferPtr offsets_;
@@ -180,7 +237,9 @@ class SelectiveListColumnReader : public SelectiveRepeatedColumnReader {
       common::ScanSpec& scanSpec);
 
   void resetFilterCaches() override {
-    child_->resetFilterCaches();
+    if (child_) {
+      child_->resetFilterCaches();
+    }
   }
 
   void seekToRowGroup(uint32_t index) override {
@@ -189,8 +248,10 @@ class SelectiveListColumnReader : public SelectiveRepeatedColumnReader {
 
     VELOX_CHECK(!positionsProvider.hasNext());
 
-    child_->seekToRowGroup(index);
-    child_->setReadOffsetRecursive(0);
+    if (child_) {
+      child_->seekToRowGroup(index);
+      child_->setReadOffsetRecursive(0);
+    }
     childTargetReadOffset_ = 0;
   }
 
@@ -215,8 +276,12 @@ class SelectiveMapColumnReader : public SelectiveRepeatedColumnReader {
       common::ScanSpec& scanSpec);
 
   void resetFilterCaches() override {
-    keyReader_->resetFilterCaches();
-    elementReader_->resetFilterCaches();
+    if (keyReader_) {
+      keyReader_->resetFilterCaches();
+    }
+    if (elementReader_) {
+      elementReader_->resetFilterCaches();
+    }
   }
 
   void seekToRowGroup(uint32_t index) override {
@@ -226,10 +291,14 @@ class SelectiveMapColumnReader : public SelectiveRepeatedColumnReader {
 
     VELOX_CHECK(!positionsProvider.hasNext());
 
-    keyReader_->seekToRowGroup(index);
-    keyReader_->setReadOffsetRecursive(0);
-    elementReader_->seekToRowGroup(index);
-    elementReader_->setReadOffsetRecursive(0);
+    if (keyReader_) {
+      keyReader_->seekToRowGroup(index);
+      keyReader_->setReadOffsetRecursive(0);
+    }
+    if (elementReader_) {
+      elementReader_->seekToRowGroup(index);
+      elementReader_->setReadOffsetRecursive(0);
+    }
     childTargetReadOffset_ = 0;
   }
 
@@ -17,6 +17,7 @@
 #include "velox/dwio/dwrf/reader/SelectiveStringDictionaryColumnReader.h"
 #include "velox/dwio/common/BufferUtil.h"
 #include "velox/dwio/dwrf/common/DecoderUtil.h"
+#include "velox/functions/lib/string/StringCore.h"
 
 namespace facebook::velox::dwrf {
 
@@ -190,6 +191,18 @@ void SelectiveStringDictionaryColumnReader::makeDictionaryBaseVector() {
         scanState_.dictionary.values,
         std::vector<BufferPtr>{scanState_.dictionary.strings});
   }
+
+  // The strings of each dictionary are contiguous, so this is one pass over
+  // the dictionary bytes per stripe or stride instead of one per row and
+  // function.
+  dictionaryIsAscii_ = true;
+  for (const auto& strings : dictionaryValues_->stringBuffers()) {
+    dictionaryIsAscii_ &=
+        functions::stringCore::isAscii(strings->as<char>(), strings->size());
+  }
+  if (dictionaryIsAscii_) {
+    dictionaryValues_->setAllIsAscii(true);
+  }
 }
 
 void SelectiveStringDictionaryColumnReader::read(
@@ -269,6 +282,9 @@ void SelectiveStringDictionaryColumnReader::getValues(
       numValues_,
       dictionaryValues_,
       values_);
+  if (dictionaryIsAscii_) {
+    (*result)->asUnchecked<SimpleVector<StringView>>()->setAllIsAscii(true);
+  }
 
   if (scanSpec_->makeFlat()) {
     BaseVector::ensureWritable(
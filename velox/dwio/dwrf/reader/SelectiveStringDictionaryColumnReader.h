@@ -86,6 +86,10 @@ class SelectiveStringDictionaryColumnReader : public SelectiveColumnReader {
 
   FlatVectorPtr<StringView> dictionaryValues_;
 
+  // True if all values of 'dictionaryValues_' are ASCII. Marks the results
+  // so that string functions take their ASCII path without scanning.
+  bool dictionaryIsAscii_{false};
+
   int64_t lastStrideIndex_;
   size_t positionOffset_;
   size_t strideDictSizeOffset_;
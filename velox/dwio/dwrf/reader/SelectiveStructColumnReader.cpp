@@ -15,6 +15,9 @@
  */
 
 #include "velox/dwio/dwrf/reader/SelectiveStructColumnReader.h"
+
+#include <folly/futures/Future.h>
+
 #include "velox/dwio/dwrf/reader/ColumnLoader.h"
 #include "velox/dwio/dwrf/reader/SelectiveDwrfReader.h"
 
@@ -39,6 +42,10 @@ SelectiveStructColumnReader::SelectiveStructColumnReader(
       encoding,
       proto::ColumnEncoding_Kind_DIRECT,
       "Unknown encoding for StructColumnReader");
+  auto& options = stripe.getRowReaderOptions();
+  if (options.getParallelColumnDecoding()) {
+    decodingExecutor_ = options.getDecodingExecutor().get();
+  }
 
   const auto& cs = stripe.getColumnSelector();
   auto& childSpecs = scanSpec.children();
@@ -110,6 +117,7 @@ void SelectiveStructColumnReader::next(
     VectorPtr& result,
     const uint64_t* incomingNulls) {
   VELOX_CHECK(!incomingNulls, "next may only be called for the root reader.");
+  isRoot_ = true;
   if (children_.empty()) {
     // no readers
     // This can be either count(*) query or a query that select only
@@ -147,6 +155,8 @@ void SelectiveStructColumnReader::read(
   const uint64_t* structNulls =
       nullsInReadRange_ ? nullsInReadRange_->as<uint64_t>() : nullptr;
   bool hasFilter = false;
+  // Non-filter children read together after the filters before them.
+  std::vector<SelectiveColumnReader*> pendingReaders;
   assert(!children_.empty());
   for (size_t i = 0; i < childSpecs.size(); ++i) {
     auto& childSpec = childSpecs[i];
@@ -156,12 +166,14 @@ void SelectiveStructColumnReader::read(
     auto fieldIndex = childSpec->subscript();
     auto reader = children_.at(fieldIndex).get();
     if (reader->isTopLevel() && childSpec->projectOut() &&
-        !childSpec->filter() && !childSpec->extractValues()) {
+        !childSpec->hasFilter() && !childSpec->extractValues()) {
       // Will make a LazyVector.
       continue;
     }
     advanceFieldReader(reader, offset);
-    if (childSpec->filter()) {
+    if (childSpec->hasFilter()) {
+      readChildren(pendingReaders, offset, activeRows, structNulls);
+      pendingReaders.clear();
       hasFilter = true;
       {
         SelectivityTimer timer(childSpec->selectivity(), activeRows.size());
@@ -179,9 +191,10 @@ void SelectiveStructColumnReader::read(
         break;
       }
     } else {
-      reader->read(offset, activeRows, structNulls);
+      pendingReaders.push_back(reader);
     }
   }
+  readChildren(pendingReaders, offset, activeRows, structNulls);
   if (hasFilter) {
     setOutputRows(activeRows);
   }
@@ -189,6 +202,59 @@ void SelectiveStructColumnReader::read(
   readOffset_ = offset + rows.back() + 1;
 }
 
+void SelectiveStructColumnReader::readChildren(
+    const std::vector<SelectiveColumnReader*>& readers,
+    vector_size_t offset,
+    RowSet rows,
+    const uint64_t* incomingNulls) {
+  if (readers.empty()) {
+    return;
+  }
+  if (!decodingExecutor_ || !isRoot_ || readers.size() == 1) {
+    for (auto* reader : readers) {
+      reader->read(offset, rows, incomingNulls);
+    }
+    return;
+  }
+  // The children have separate streams and decoders, so they can be read
+  // concurrently. The first one is read on this thread.
+  std::vector<folly::SemiFuture<folly::Unit>> futures;
+  futures.reserve(readers.size() - 1);
+  for (size_t i = 1; i < readers.size(); ++i) {
+    auto [promise, future] = folly::makePromiseContract<folly::Unit>();
+    decodingExecutor_->add([this,
+                            child = readers[i],
+                            offset,
+                            rows,
+                            incomingNulls,
+                            promise = std::move(promise)]() mutable {
+      ExceptionContextSetter exceptionContext(
+          {[](auto* reader) {
+             return static_cast<SelectiveStructColumnReader*>(reader)
+                 ->debugString();
+           },
+           this});
+      promise.setTry(folly::makeTryWith(
+          [&]() { child->read(offset, rows, incomingNulls); }));
+    });
+    futures.push_back(std::move(future));
+  }
+  std::exception_ptr error;
+  try {
+    readers[0]->read(offset, rows, incomingNulls);
+  } catch (...) {
+    error = std::current_exception();
+  }
+  // Waits for all the reads before throwing since they refer to 'this'.
+  auto results = folly::collectAll(std::move(futures)).get();
+  if (error) {
+    std::rethrow_exception(error);
+  }
+  for (auto& result : results) {
+    result.throwIfFailed();
+  }
+}
+
 namespace {
 //   Recursively makes empty RowVectors for positions in 'children'
 //   where the corresponding child type in 'rowType' is a row. The
@@ -260,7 +326,7 @@ void SelectiveStructColumnReader::getValues(RowSet rows, VectorPtr* result) {
       resultRow->childAt(channel) = BaseVector::wrapInConstant(
           rows.size(), 0, childSpec->constantValue());
     } else {
-      if (!childSpec->extractValues() && !childSpec->filter() &&
+      if (!childSpec->extractValues() && !childSpec->hasFilter() &&
           children_[index]->isTopLevel()) {
         // LazyVector result.
         if (!lazyPrepared) {
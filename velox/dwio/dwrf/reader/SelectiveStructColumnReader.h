@@ -16,6 +16,8 @@
 
 #pragma once
 
+#include <folly/Executor.h>
+
 #include "velox/dwio/dwrf/reader/DwrfData.h"
 #include "velox/dwio/dwrf/reader/SelectiveColumnReaderInternal.h"
 
@@ -125,8 +127,23 @@ class SelectiveStructColumnReader : public SelectiveColumnReader {
   }
 
  private:
+  // Reads 'readers' for 'rows'. The readers after the first are read on
+  // 'decodingExecutor_' if set.
+  void readChildren(
+      const std::vector<SelectiveColumnReader*>& readers,
+      vector_size_t offset,
+      RowSet rows,
+      const uint64_t* incomingNulls);
+
   const std::shared_ptr<const dwio::common::TypeWithId> requestedType_;
   std::vector<std::unique_ptr<SelectiveColumnReader>> children_;
+  // Decodes the non-filter children of the root struct in parallel if
+  // set.
+  folly::Executor* decodingExecutor_{nullptr};
+  // True if next() is called on 'this'. The children of nested structs are
+  // read sequentially so that tasks on 'decodingExecutor_' do not wait for
+  // each other.
+  bool isRoot_{false};
   // Sequence number of output batch. Checked against ColumnLoaders
   // created by 'this' to verify they are still valid at load.
   uint64_t numReads_ = 0;
@@ -20,6 +20,12 @@ namespace facebook::velox::dwrf {
 
 using dwio::common::LogType;
 
+StripeReaderBase::~StripeReaderBase() {
+  if (readAhead_) {
+    readAhead_->loaded.wait();
+  }
+}
+
 const proto::StripeInformation& StripeReaderBase::loadStripe(
     uint32_t index,
     bool& preload) {
@@ -35,6 +41,9 @@ const proto::StripeInformation& StripeReaderBase::loadStripe(
   if (reader_->getBufferedInput().isBuffered(offset, length)) {
     // if file is preloaded, return stripe is preloaded
     preload = true;
+  } else if (auto input = takeReadAhead(index)) {
+    stripeInput_ = std::move(input);
+    preload = true;
   } else {
     stripeInput_ = reader_->bufferedInputFactory().create(
         reader_->getStream(), reader_->getMemoryPool(), reader_->getFileNum());
@@ -88,6 +97,54 @@ const proto::StripeInformation& StripeReaderBase::loadStripe(
   return stripe;
 }
 
+void StripeReaderBase::readAheadStripe(
+    uint32_t index,
+    folly::Executor* executor,
+    uint64_t maxBytes) {
+  if (readAhead_ && readAhead_->index == index) {
+    return;
+  }
+  takeReadAhead(index);
+  auto& footer = reader_->getFooter();
+  if (index >= footer.stripes_size()) {
+    return;
+  }
+  auto& stripe = footer.stripes(index);
+  uint64_t offset = stripe.offset();
+  uint64_t length =
+      stripe.indexlength() + stripe.datalength() + stripe.footerlength();
+  if (length > maxBytes ||
+      reader_->getBufferedInput().isBuffered(offset, length)) {
+    return;
+  }
+  // The base BufferedInput keeps the whole range in memory, so that all
+  // streams and the footer of the stripe are served without further IO.
+  auto input = std::make_unique<dwio::common::BufferedInput>(
+      reader_->getStream(), reader_->getMemoryPool());
+  input->enqueue({offset, length});
+  auto [promise, future] = folly::makePromiseContract<folly::Unit>();
+  executor->add([input = input.get(), promise = std::move(promise)]() mutable {
+    promise.setTry(folly::makeTryWith([&]() { input->load(LogType::STRIPE); }));
+  });
+  readAhead_ = ReadAhead{index, std::move(input), std::move(future)};
+}
+
+std::unique_ptr<dwio::common::BufferedInput> StripeReaderBase::takeReadAhead(
+    uint32_t index) {
+  if (!readAhead_) {
+    return nullptr;
+  }
+  auto readAhead = std::move(*readAhead_);
+  readAhead_.reset();
+  if (readAhead.index != index) {
+    readAhead.loaded.wait();
+    return nullptr;
+  }
+  // Rethrows the error of a failed load.
+  std::move(readAhead.loaded).get();
+  return std::move(readAhead.input);
+}
+
 void StripeReaderBase::loadEncryptionKeys(uint32_t index) {
   if (!handler_->isEncrypted()) {
     return;
@@ -16,6 +16,8 @@
 
 #pragma once
 
+#include <folly/Executor.h>
+#include <folly/futures/Future.h>
 #include "velox/dwio/common/BufferedInput.h"
 #include "velox/dwio/common/Options.h"
 #include "velox/dwio/dwrf/reader/ReaderBase.h"
@@ -42,10 +44,22 @@ class StripeReaderBase {
     DWIO_ENSURE(footer->GetArena());
   }
 
-  virtual ~StripeReaderBase() = default;
+  virtual ~StripeReaderBase();
 
+  // Loads the footer of stripe 'index' and sets up the input for its
+  // streams. Sets 'preload' if the whole stripe is in memory, e.g. because
+  // it was read ahead.
   const proto::StripeInformation& loadStripe(uint32_t index, bool& preload);
 
+  // Starts reading stripe 'index' as a whole on 'executor' if it is at most
+  // 'maxBytes' long, so that the IO overlaps with decoding the current
+  // stripe. The next loadStripe() of 'index' uses the read data. Replaces
+  // any earlier read-ahead.
+  void readAheadStripe(
+      uint32_t index,
+      folly::Executor* FOLLY_NONNULL executor,
+      uint64_t maxBytes);
+
   const proto::StripeFooter& getStripeFooter() const {
     DWIO_ENSURE_NOT_NULL(footer_, "stripe not loaded");
     return *footer_;
@@ -74,8 +88,23 @@ class StripeReaderBase {
   std::unique_ptr<encryption::DecryptionHandler> handler_;
   std::optional<uint32_t> lastStripeIndex_;
 
+  // The stripe being read ahead, its input and the completion of its load.
+  // The load refers to 'input_' of 'reader_', so it is waited for before
+  // 'this' goes away.
+  struct ReadAhead {
+    uint32_t index;
+    std::unique_ptr<dwio::common::BufferedInput> input;
+    folly::SemiFuture<folly::Unit> loaded;
+  };
+  std::optional<ReadAhead> readAhead_;
+
   void loadEncryptionKeys(uint32_t index);
 
+  // Returns the input of the read-ahead of stripe 'index' after its load
+  // has completed, or nullptr if 'index' is not read ahead. Waits for and
+  // drops a read-ahead of another stripe.
+  std::unique_ptr<dwio::common::BufferedInput> takeReadAhead(uint32_t index);
+
   friend class StripeLoadKeysTest;
 };
 
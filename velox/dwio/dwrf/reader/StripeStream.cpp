@@ -283,10 +283,17 @@ std::unique_ptr<dwio::common::SeekableInputStream> StripeStreamsImpl::getStream(
 
   auto streamDebugInfo =
       fmt::format("Stripe {} Stream {}", stripeIndex_, si.toString());
+  ParallelDecompressionOptions parallel;
+  if (opts_.getIOExecutor() && si.kind() != StreamKind::StreamKind_ROW_INDEX) {
+    parallel.executor = opts_.getIOExecutor().get();
+    parallel.maxBlocksAhead = opts_.getDecompressionBlocksAhead();
+    parallel.ioStats = reader_.getReader().getStream().getStats();
+  }
   return reader_.getReader().createDecompressedStream(
       std::move(streamRead),
       streamDebugInfo,
-      getDecrypter(si.encodingKey().node));
+      getDecrypter(si.encodingKey().node),
+      parallel);
 }
 
 uint32_t StripeStreamsImpl::visitStreamsOfNode(
@@ -1222,6 +1222,38 @@ TEST(ColumnWriterTests, TestMapWriterDuplicateKeys) {
       exception::LoggedException);
 }
 
+TEST(ColumnWriterTests, TestMapWriterSparseKeysAcrossBatches) {
+  using keyType = int32_t;
+  using valueType = int32_t;
+  using b = MapBuilder<keyType, valueType>;
+
+  std::unique_ptr<ScopedMemoryPool> scopedPool = getDefaultScopedMemoryPool();
+  auto& pool = *scopedPool;
+  // Keys change order between maps, are missing from whole batches and first
+  // appear in later batches.
+  auto batch1 = b::create(
+      pool,
+      {b::row{b::pair{1, 1}, b::pair{2, 2}, b::pair{3, 3}},
+       b::row{b::pair{1, 4}, b::pair{3, 5}},
+       b::row{b::pair{3, 6}, b::pair{1, 7}, b::pair{2, 8}}});
+  auto batch2 = b::create(
+      pool,
+      {b::row{b::pair{4, 9}},
+       b::row{b::pair{4, 10}, b::pair{1, 11}},
+       b::row{b::pair{5, 12}, b::pair{4, 13}}});
+  auto batch3 = b::create(pool, {b::row{b::pair{2, 14}, b::pair{5, 15}}});
+  std::vector<VectorPtr> batches{batch1, batch2, batch3};
+
+  for (auto disableDictionaryEncoding : {true, false}) {
+    testMapWriter<keyType, valueType>(
+        pool,
+        batches,
+        /* useFlatMap */ true,
+        disableDictionaryEncoding,
+        /* testEncoded */ false);
+  }
+}
+
 TEST(ColumnWriterTests, TestMapWriterBigBatch) {
   using keyType = int32_t;
   using valueType = float;
@@ -3861,6 +3893,58 @@ TEST(ColumnWriterTests, IntDictWriterDirectValueOverflow) {
   }
 }
 
+TEST(ColumnWriterTests, dictionaryEarlyCheckAndHints) {
+  auto config = std::make_shared<Config>();
+  config->set<uint32_t>(Config::DICTIONARY_EARLY_CHECK_ROWS, 100);
+  auto hints = std::make_shared<DictionaryEncodingHints>();
+  auto scopedPool = getDefaultScopedMemoryPool();
+  auto& pool = scopedPool->getPool();
+  auto type = std::make_shared<const BigintType>();
+  auto typeWithId = TypeWithId::create(type, 1);
+
+  constexpr size_t size = 1000;
+  std::vector<std::optional<int64_t>> distinct;
+  std::vector<std::optional<int64_t>> repeated;
+  for (auto i = 0; i < size; ++i) {
+    distinct.push_back(i);
+    repeated.push_back(i % 10);
+  }
+
+  // Writes a stripe of 'data' as a file of its own and checks the hint
+  // before the stripe is flushed. Returns the encoding.
+  auto writeFile = [&](const std::vector<std::optional<int64_t>>& data,
+                       std::optional<bool> hintBeforeFlush) {
+    WriterContext context{config, getDefaultScopedMemoryPool()};
+    context.setDictionaryEncodingHints(hints);
+    auto writer = BaseColumnWriter::create(context, *typeWithId, 0);
+    for (auto i = 0; i < data.size(); i += 200) {
+      std::vector<std::optional<int64_t>> batch{
+          data.begin() + i, data.begin() + i + 200};
+      writer->write(populateBatch<int64_t>(batch, &pool), Ranges::of(0, 200));
+    }
+    EXPECT_EQ(hints->useDictionary({1, 0}), hintBeforeFlush);
+    writer->createIndexEntry();
+    proto::StripeFooter sf;
+    writer->flush([&sf](auto /* unused */) -> proto::ColumnEncoding& {
+      return *sf.add_encoding();
+    });
+    return sf.encoding(0).kind();
+  };
+
+  // Distinct values abandon the dictionary once 100 values are written.
+  ASSERT_EQ(writeFile(distinct, false), proto::ColumnEncoding_Kind_DIRECT);
+
+  // The next file starts without dictionary, although it would pay off.
+  ASSERT_EQ(writeFile(repeated, false), proto::ColumnEncoding_Kind_DIRECT);
+
+  // Without the hint, repeated values keep the dictionary.
+  hints = std::make_shared<DictionaryEncodingHints>();
+  ASSERT_EQ(
+      writeFile(repeated, std::nullopt),
+      proto::ColumnEncoding_Kind_DICTIONARY);
+  ASSERT_EQ(hints->useDictionary({1, 0}), true);
+}
+
 TEST(ColumnWriterTests, ShortDictWriterDictValueOverflow) {
   auto config = std::make_shared<Config>();
   auto scopedPool = getDefaultScopedMemoryPool();
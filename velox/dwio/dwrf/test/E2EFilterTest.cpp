@@ -14,6 +14,8 @@
  * limitations under the License.
  */
 
+#include <folly/executors/CPUThreadPoolExecutor.h>
+
 #include "velox/dwio/dwrf/test/E2EFilterTestBase.h"
 #include "velox/dwio/dwrf/writer/FlushPolicy.h"
 
@@ -34,6 +36,11 @@ class E2EFilterTest : public E2EFilterTestBase {
     auto config = std::make_shared<dwrf::Config>();
     config->set(dwrf::Config::COMPRESSION, CompressionKind_NONE);
     config->set(dwrf::Config::USE_VINTS, useVInts_);
+    config->set(dwrf::Config::BLOOM_FILTER_COLS, bloomFilterColumns_);
+    if (!flatMapColumns_.empty()) {
+      config->set(dwrf::Config::FLATTEN_MAP, true);
+      config->set(dwrf::Config::MAP_FLAT_COLS, flatMapColumns_);
+    }
     WriterOptions options;
     options.config = config;
     options.schema = type;
@@ -62,6 +69,8 @@ class E2EFilterTest : public E2EFilterTestBase {
   }
 
   std::unique_ptr<Writer> writer_;
+  std::vector<uint32_t> bloomFilterColumns_;
+  std::vector<uint32_t> flatMapColumns_;
 };
 
 TEST_F(E2EFilterTest, integerDirect) {
@@ -203,6 +212,20 @@ TEST_F(E2EFilterTest, listAndMap) {
       10);
 }
 
+TEST_F(E2EFilterTest, parallelColumnDecoding) {
+  decodingExecutor_ = std::make_shared<folly::CPUThreadPoolExecutor>(4);
+  testWithTypes(
+      "long_val:bigint,"
+      "int_val:int,"
+      "string_val:string,"
+      "array_val:array<int>,"
+      "map_val:map<bigint,struct<nested_long: bigint>>",
+      [&]() {},
+      false,
+      {"long_val", "int_val"},
+      10);
+}
+
 TEST_F(E2EFilterTest, nullCompactRanges) {
   // Makes a dataset with nulls at the beginning. Tries different
   // filter ombinations on progressively larger batches. tests for a
@@ -237,3 +260,389 @@ TEST_F(E2EFilterTest, lazyStruct) {
       true,
       false);
 }
+
+TEST_F(E2EFilterTest, runLengthEncodedIntegers) {
+  makeRowType("long_val:bigint,int_val:int", false);
+  filterGenerator = std::make_unique<FilterGenerator>(rowType_, 1);
+  batches_.clear();
+  for (auto i = 0; i < 4; ++i) {
+    auto batch = std::static_pointer_cast<RowVector>(
+        BaseVector::create(rowType_, 10'000, pool_.get()));
+    auto* longs = batch->childAt(0)->asFlatVector<int64_t>();
+    auto* ints = batch->childAt(1)->asFlatVector<int32_t>();
+    for (auto row = 0; row < batch->size(); ++row) {
+      // Runs of 100 equal values. Every 7th run of 'long_val' is null.
+      auto run = row / 100;
+      longs->set(row, i * 1'000 + run);
+      ints->set(row, run % 10);
+      if (run % 7 == 0) {
+        longs->setNull(row, true);
+      }
+    }
+    batches_.push_back(batch);
+  }
+  writeToMemory(rowType_, batches_, false);
+
+  auto spec = filterGenerator->makeScanSpec(SubfieldFilters{});
+  for (auto& childSpec : spec->children()) {
+    childSpec->setMakeRunLengthEncoded(true);
+  }
+  uint64_t time = 0;
+  readWithoutFilter(spec, batches_, time);
+
+  auto input = std::make_unique<MemoryInputStream>(
+      sinkPtr_->getData(), sinkPtr_->size());
+  RowReaderOptions rowReaderOpts;
+  rowReaderOpts.setScanSpec(spec);
+  auto reader = makeReader(ReaderOptions(), std::move(input));
+  auto rowReader = reader->createRowReader(rowReaderOpts);
+  auto batch = BaseVector::create(rowType_, 1, pool_.get());
+  ASSERT_TRUE(rowReader->next(1'000, batch));
+  for (auto& child : batch->as<RowVector>()->children()) {
+    EXPECT_EQ(
+        child->loadedVector()->encoding(), VectorEncoding::Simple::SEQUENCE);
+  }
+}
+
+TEST_F(E2EFilterTest, bloomFilter) {
+  makeRowType("long_val:bigint,string_val:string", false);
+  filterGenerator = std::make_unique<FilterGenerator>(rowType_, 1);
+  bloomFilterColumns_ = {0, 1};
+  batches_.clear();
+  // One row group per batch. The values of batch i are 4 * row + i, so
+  // that the ranges of the row groups overlap and their values do not.
+  constexpr int32_t kRows = 10'000;
+  for (auto i = 0; i < 4; ++i) {
+    auto batch = std::static_pointer_cast<RowVector>(
+        BaseVector::create(rowType_, kRows, pool_.get()));
+    auto* longs = batch->childAt(0)->asFlatVector<int64_t>();
+    auto* strings = batch->childAt(1)->asFlatVector<StringView>();
+    for (auto row = 0; row < kRows; ++row) {
+      longs->set(row, 4 * row + i);
+      strings->set(row, StringView(fmt::format("s{}", 4 * row + i)));
+    }
+    batches_.push_back(batch);
+  }
+  writeToMemory(rowType_, batches_, true);
+
+  auto test = [&](const std::string& field,
+                  std::unique_ptr<Filter> filter,
+                  const std::vector<uint32_t>& hitRows) {
+    SubfieldFilters filters;
+    filters[Subfield(field)] = std::move(filter);
+    auto spec = filterGenerator->makeScanSpec(std::move(filters));
+    uint64_t time = 0;
+    readWithFilter(spec, batches_, hitRows, time, false);
+    // The min/max of each row group pass the filters. All row groups
+    // without hits are skipped, but for bloom filter false positives.
+    EXPECT_LT(0, runtimeStats_.skippedStrides);
+  };
+
+  test(
+      "long_val",
+      std::make_unique<BigintRange>(4 * 5'000 + 2, 4 * 5'000 + 2, false),
+      {batchPosition(2, 5'000)});
+  test(
+      "long_val",
+      createBigintValues({4 * 100 + 3, 4 * 200 + 3}, false),
+      {batchPosition(3, 100), batchPosition(3, 200)});
+  test(
+      "long_val",
+      std::make_unique<BigintRange>(4 * 17, 4 * 17, false),
+      {batchPosition(0, 17)});
+  test(
+      "string_val",
+      std::make_unique<BytesValues>(
+          std::vector<std::string>{"s20001", "s4005"}, false),
+      {batchPosition(1, 1'001), batchPosition(1, 5'000)});
+}
+
+TEST_F(E2EFilterTest, flatMap) {
+  makeRowType("long_val:bigint,map_val:map<bigint,bigint>", false);
+  filterGenerator = std::make_unique<FilterGenerator>(rowType_, 1);
+  flatMapColumns_ = {1};
+  batches_.clear();
+  // Key k is in the maps of the rows that are a multiple of k. Every 11th
+  // map is null. The value of key k in row r is k * 1'000'000 + r.
+  constexpr int32_t kRows = 1'000;
+  for (auto i = 0; i < 4; ++i) {
+    auto longs = BaseVector::create<FlatVector<int64_t>>(
+        BIGINT(), kRows, pool_.get());
+    auto keys = BaseVector::create<FlatVector<int64_t>>(
+        BIGINT(), 3 * kRows, pool_.get());
+    auto values = BaseVector::create<FlatVector<int64_t>>(
+        BIGINT(), 3 * kRows, pool_.get());
+    auto nulls = AlignedBuffer::allocate<bool>(kRows, pool_.get(), true);
+    auto offsets = allocateOffsets(kRows, pool_.get());
+    auto sizes = allocateSizes(kRows, pool_.get());
+    auto* rawOffsets = offsets->asMutable<vector_size_t>();
+    auto* rawSizes = sizes->asMutable<vector_size_t>();
+    vector_size_t numEntries = 0;
+    for (auto row = 0; row < kRows; ++row) {
+      int64_t globalRow = i * kRows + row;
+      longs->set(row, globalRow);
+      rawOffsets[row] = numEntries;
+      if (globalRow % 11 == 0) {
+        bits::setNull(nulls->asMutable<uint64_t>(), row);
+        continue;
+      }
+      for (int64_t key = 1; key <= 3; ++key) {
+        if (globalRow % key == 0) {
+          keys->set(numEntries, key);
+          values->set(numEntries, key * 1'000'000 + globalRow);
+          ++numEntries;
+        }
+      }
+      rawSizes[row] = numEntries - rawOffsets[row];
+    }
+    keys->resize(numEntries);
+    values->resize(numEntries);
+    auto maps = std::make_shared<MapVector>(
+        pool_.get(),
+        rowType_->childAt(1),
+        nulls,
+        kRows,
+        offsets,
+        sizes,
+        keys,
+        values);
+    batches_.push_back(std::make_shared<RowVector>(
+        pool_.get(),
+        rowType_,
+        nullptr,
+        kRows,
+        std::vector<VectorPtr>{longs, maps}));
+  }
+  writeToMemory(rowType_, batches_, false);
+
+  // All keys.
+  uint64_t time = 0;
+  readWithoutFilter(
+      filterGenerator->makeScanSpec(SubfieldFilters{}), batches_, time);
+
+  auto keySpec = [](ScanSpec& mapSpec, const std::string& key) {
+    std::vector<std::unique_ptr<Subfield::PathElement>> path;
+    path.push_back(std::make_unique<Subfield::NestedField>(key));
+    return mapSpec.getOrCreateChild(Subfield(std::move(path)));
+  };
+  auto read = [&](const std::shared_ptr<ScanSpec>& spec,
+                  RowReaderOptions rowReaderOpts,
+                  std::function<void(int64_t row, const RowVector&, int32_t)>
+                      checkRow) {
+    auto input = std::make_unique<MemoryInputStream>(
+        sinkPtr_->getData(), sinkPtr_->size());
+    rowReaderOpts.setScanSpec(spec);
+    auto reader = makeReader(ReaderOptions(), std::move(input));
+    auto rowReader = reader->createRowReader(rowReaderOpts);
+    auto batch = BaseVector::create(rowType_, 1, pool_.get());
+    int32_t numRows = 0;
+    while (rowReader->next(300, batch)) {
+      auto* rows = batch->as<RowVector>();
+      auto* longs =
+          rows->childAt(0)->loadedVector()->as<SimpleVector<int64_t>>();
+      for (auto i = 0; i < rows->size(); ++i) {
+        checkRow(longs->valueAt(i), *rows, i);
+      }
+      numRows += rows->size();
+    }
+    return numRows;
+  };
+
+  // A filter on the value of key 2 reads only key 2.
+  auto spec = filterGenerator->makeScanSpec(SubfieldFilters{});
+  auto* valueSpec = keySpec(*spec->childByName("map_val"), "2");
+  valueSpec->setFilter(
+      std::make_unique<BigintRange>(2'001'000, 2'001'999, false));
+  valueSpec->setProjectOut(true);
+  valueSpec->setExtractValues(true);
+  int32_t expectedRows = 0;
+  for (auto row = 1'000; row < 2'000; ++row) {
+    expectedRows += row % 2 == 0 && row % 11 != 0;
+  }
+  auto numRows = read(
+      spec, RowReaderOptions(), [&](auto row, const auto& rows, auto i) {
+        EXPECT_TRUE(row >= 1'000 && row < 2'000 && row % 2 == 0);
+        auto* maps = rows.childAt(1)->template as<MapVector>();
+        auto* keys = maps->mapKeys()->template as<SimpleVector<int64_t>>();
+        auto* values =
+            maps->mapValues()->template as<SimpleVector<int64_t>>();
+        ASSERT_EQ(1, maps->sizeAt(i));
+        EXPECT_EQ(2, keys->valueAt(maps->offsetAt(i)));
+        EXPECT_EQ(2'000'000 + row, values->valueAt(maps->offsetAt(i)));
+      });
+  EXPECT_EQ(expectedRows, numRows);
+
+  // Struct output with a filter on key 3. Key 4 does not exist.
+  spec = filterGenerator->makeScanSpec(SubfieldFilters{});
+  valueSpec = keySpec(*spec->childByName("map_val"), "3");
+  valueSpec->setFilter(std::make_unique<IsNotNull>());
+  valueSpec->setProjectOut(true);
+  valueSpec->setExtractValues(true);
+  RowReaderOptions rowReaderOpts;
+  rowReaderOpts.setFlatmapNodeIdsAsStruct({{2, {"1", "3", "4"}}});
+  expectedRows = 0;
+  for (auto row = 0; row < 4 * kRows; ++row) {
+    expectedRows += row % 3 == 0 && row % 11 != 0;
+  }
+  numRows = read(spec, rowReaderOpts, [&](auto row, const auto& rows, auto i) {
+    EXPECT_TRUE(row % 3 == 0 && row % 11 != 0);
+    auto* keys = rows.childAt(1)->template as<RowVector>();
+    ASSERT_EQ(3, keys->childrenSize());
+    auto key1 = keys->childAt(0)->template as<SimpleVector<int64_t>>();
+    auto key3 = keys->childAt(1)->template as<SimpleVector<int64_t>>();
+    EXPECT_EQ(1'000'000 + row, key1->valueAt(i));
+    EXPECT_EQ(3'000'000 + row, key3->valueAt(i));
+    EXPECT_TRUE(keys->childAt(2)->isNullAt(i));
+  });
+  EXPECT_EQ(expectedRows, numRows);
+}
+
+TEST_F(E2EFilterTest, listAndMapElementAccess) {
+  makeRowType(
+      "long_val:bigint,array_val:array<bigint>,map_val:map<bigint,bigint>",
+      false);
+  filterGenerator = std::make_unique<FilterGenerator>(rowType_, 1);
+  batches_.clear();
+  // Row r has r % 5 elements. Element j of the array of row r is
+  // r * 10 + j and key j of the map is mapped to r * 10 + j. Every 13th
+  // array is null.
+  constexpr int32_t kRows = 1'000;
+  auto numElements = [](int64_t row) { return row % 5; };
+  for (auto i = 0; i < 4; ++i) {
+    auto longs = BaseVector::create<FlatVector<int64_t>>(
+        BIGINT(), kRows, pool_.get());
+    auto elements = BaseVector::create<FlatVector<int64_t>>(
+        BIGINT(), 4 * kRows, pool_.get());
+    auto keys = BaseVector::create<FlatVector<int64_t>>(
+        BIGINT(), 4 * kRows, pool_.get());
+    auto nulls = AlignedBuffer::allocate<bool>(kRows, pool_.get(), true);
+    auto offsets = allocateOffsets(kRows, pool_.get());
+    auto sizes = allocateSizes(kRows, pool_.get());
+    auto* rawOffsets = offsets->asMutable<vector_size_t>();
+    auto* rawSizes = sizes->asMutable<vector_size_t>();
+    vector_size_t numEntries = 0;
+    for (auto row = 0; row < kRows; ++row) {
+      int64_t globalRow = i * kRows + row;
+      longs->set(row, globalRow);
+      rawOffsets[row] = numEntries;
+      rawSizes[row] = numElements(globalRow);
+      for (auto j = 0; j < rawSizes[row]; ++j) {
+        elements->set(numEntries, globalRow * 10 + j);
+        keys->set(numEntries, j);
+        ++numEntries;
+      }
+    }
+    elements->resize(numEntries);
+    keys->resize(numEntries);
+    auto arrayNulls = AlignedBuffer::allocate<bool>(kRows, pool_.get(), true);
+    for (auto row = 0; row < kRows; ++row) {
+      if ((i * kRows + row) % 13 == 0) {
+        bits::setNull(arrayNulls->asMutable<uint64_t>(), row);
+      }
+    }
+    auto arrays = std::make_shared<ArrayVector>(
+        pool_.get(),
+        rowType_->childAt(1),
+        arrayNulls,
+        kRows,
+        offsets,
+        sizes,
+        elements);
+    auto maps = std::make_shared<MapVector>(
+        pool_.get(),
+        rowType_->childAt(2),
+        nulls,
+        kRows,
+        offsets,
+        sizes,
+        keys,
+        elements);
+    batches_.push_back(std::make_shared<RowVector>(
+        pool_.get(),
+        rowType_,
+        nullptr,
+        kRows,
+        std::vector<VectorPtr>{longs, arrays, maps}));
+  }
+  writeToMemory(rowType_, batches_, false);
+
+  auto read = [&](const std::shared_ptr<ScanSpec>& spec,
+                  std::function<void(int64_t row, const RowVector&, int32_t)>
+                      checkRow) {
+    auto input = std::make_unique<MemoryInputStream>(
+        sinkPtr_->getData(), sinkPtr_->size());
+    RowReaderOptions rowReaderOpts;
+    rowReaderOpts.setScanSpec(spec);
+    auto reader = makeReader(ReaderOptions(), std::move(input));
+    auto rowReader = reader->createRowReader(rowReaderOpts);
+    auto batch = BaseVector::create(rowType_, 1, pool_.get());
+    int32_t numRows = 0;
+    while (rowReader->next(300, batch)) {
+      auto* rows = batch->as<RowVector>();
+      auto* longs =
+          rows->childAt(0)->loadedVector()->as<SimpleVector<int64_t>>();
+      for (auto i = 0; i < rows->size(); ++i) {
+        checkRow(longs->valueAt(i), *rows, i);
+      }
+      numRows += rows->size();
+    }
+    return numRows;
+  };
+
+  // Lengths of the arrays and keys of the maps.
+  auto spec = filterGenerator->makeScanSpec(SubfieldFilters{});
+  spec->childByName("array_val")
+      ->setElementAccess(ScanSpec::ElementAccess::kLengthsOnly);
+  spec->childByName("map_val")->setElementAccess(
+      ScanSpec::ElementAccess::kKeysOnly);
+  auto numRows = read(spec, [&](auto row, const auto& rows, auto i) {
+    auto* arrays = rows.childAt(1)->loadedVector()->template as<ArrayVector>();
+    auto* maps = rows.childAt(2)->loadedVector()->template as<MapVector>();
+    ASSERT_EQ(row % 13 == 0, arrays->isNullAt(i));
+    if (row % 13 != 0) {
+      ASSERT_EQ(numElements(row), arrays->sizeAt(i));
+      for (auto j = 0; j < arrays->sizeAt(i); ++j) {
+        EXPECT_TRUE(arrays->elements()->isNullAt(arrays->offsetAt(i) + j));
+      }
+    }
+    ASSERT_EQ(numElements(row), maps->sizeAt(i));
+    auto* keys = maps->mapKeys()->template as<SimpleVector<int64_t>>();
+    for (auto j = 0; j < maps->sizeAt(i); ++j) {
+      EXPECT_EQ(j, keys->valueAt(maps->offsetAt(i) + j));
+      EXPECT_TRUE(maps->mapValues()->isNullAt(maps->offsetAt(i) + j));
+    }
+  });
+  EXPECT_EQ(4 * kRows, numRows);
+
+  // A filter on the elements passes the rows where an element passes.
+  spec = filterGenerator->makeScanSpec(SubfieldFilters{});
+  auto* arraySpec = spec->childByName("array_val");
+  arraySpec->setProjectOut(false);
+  arraySpec->setExtractValues(false);
+  arraySpec->childByName("elements")
+      ->setFilter(std::make_unique<BigintRange>(20'003, 30'003, false));
+  int32_t expectedRows = 0;
+  for (int64_t row = 0; row < 4 * kRows; ++row) {
+    if (row % 13 != 0 && numElements(row) > 0 &&
+        row * 10 + numElements(row) - 1 >= 20'003 && row * 10 <= 30'003) {
+      ++expectedRows;
+    }
+  }
+  numRows = read(spec, [&](auto row, const auto& /*rows*/, auto /*i*/) {
+    EXPECT_TRUE(row % 13 != 0 && row >= 2'000 && row <= 3'000) << row;
+  });
+  EXPECT_EQ(expectedRows, numRows);
+
+  // A filter on the keys of a keys-only map checks that a key exists.
+  spec = filterGenerator->makeScanSpec(SubfieldFilters{});
+  auto* mapSpec = spec->childByName("map_val");
+  mapSpec->setProjectOut(false);
+  mapSpec->setExtractValues(false);
+  mapSpec->setElementAccess(ScanSpec::ElementAccess::kKeysOnly);
+  mapSpec->childByName("keys")->setFilter(
+      std::make_unique<BigintRange>(3, 3, false));
+  numRows = read(spec, [&](auto row, const auto& /*rows*/, auto /*i*/) {
+    EXPECT_EQ(4, numElements(row)) << row;
+  });
+  EXPECT_EQ(4 * kRows / 5, numRows);
+}
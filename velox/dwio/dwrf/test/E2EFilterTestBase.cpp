@@ -182,6 +182,10 @@ void E2EFilterTestBase::readWithoutFilter(
 
   // The spec must stay live over the lifetime of the reader.
   rowReaderOpts.setScanSpec(spec);
+  if (decodingExecutor_) {
+    rowReaderOpts.setDecodingExecutor(decodingExecutor_);
+    rowReaderOpts.setParallelColumnDecoding(true);
+  }
   OwnershipChecker ownershipChecker;
   auto rowReader = reader->createRowReader(rowReaderOpts);
 
@@ -231,6 +235,10 @@ void E2EFilterTestBase::readWithFilter(
   auto reader = makeReader(readerOpts, std::move(input));
   // The  spec must stay live over the lifetime of the reader.
   rowReaderOpts.setScanSpec(spec);
+  if (decodingExecutor_) {
+    rowReaderOpts.setDecodingExecutor(decodingExecutor_);
+    rowReaderOpts.setParallelColumnDecoding(true);
+  }
   OwnershipChecker ownershipChecker;
   auto rowReader = reader->createRowReader(rowReaderOpts);
   runtimeStats_ = dwio::common::RuntimeStatistics();
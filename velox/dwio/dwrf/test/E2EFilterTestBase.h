@@ -16,6 +16,7 @@
 
 #pragma once
 
+#include <folly/Executor.h>
 #include <folly/Random.h>
 #include <gtest/gtest.h>
 #include <memory>
@@ -292,6 +293,8 @@ class E2EFilterTestBase : public testing::Test {
   int32_t flushEveryNBatches_{10};
   int32_t nextReadSizeIndex_{0};
   std::vector<int32_t> readSizes_;
+  // If set, the columns of a batch are decoded in parallel on this.
+  std::shared_ptr<folly::Executor> decodingExecutor_;
 };
 
 } // namespace facebook::velox::dwio::dwrf
@@ -15,6 +15,7 @@
  */
 
 #include <folly/Random.h>
+#include <folly/executors/CPUThreadPoolExecutor.h>
 #include <random>
 #include "velox/dwio/common/MemoryInputStream.h"
 #include "velox/dwio/common/Options.h"
@@ -635,6 +636,112 @@ TEST(E2EWriterTests, PartialStride) {
   ASSERT_EQ(true, reader->columnStatistics(1)->hasNull().value());
 }
 
+TEST(E2EWriterTests, stripeReadAhead) {
+  auto scopedPool = memory::getDefaultScopedMemoryPool();
+  auto& pool = *scopedPool;
+  HiveTypeParser parser;
+  auto type = parser.parse(
+      "struct<long_val:bigint,string_val:string,array_val:array<float>>");
+  auto batches = E2EWriterTestUtil::generateBatches(
+      type, 10, 1'000, /* seed */ 1, pool);
+
+  auto config = std::make_shared<Config>();
+  auto sink = std::make_unique<MemorySink>(pool, 20 * kSizeMB);
+  auto sinkPtr = sink.get();
+  auto writer = E2EWriterTestUtil::writeData(
+      std::move(sink),
+      type,
+      batches,
+      config,
+      E2EWriterTestUtil::simpleFlushPolicyFactory(true));
+
+  auto executor = std::make_shared<folly::CPUThreadPoolExecutor>(2);
+  // Reads all stripes ahead and then none. The seek drops the read-ahead of
+  // the stripe after the current one.
+  for (auto readAheadBytes : {kSizeMB, 1UL}) {
+    ReaderOptions readerOpts;
+    auto reader = std::make_unique<DwrfReader>(
+        readerOpts,
+        std::make_unique<MemoryInputStream>(
+            sinkPtr->getData(), sinkPtr->size()));
+    ASSERT_EQ(batches.size(), reader->getNumberOfStripes());
+    RowReaderOptions rowReaderOpts;
+    rowReaderOpts.setIOExecutor(executor);
+    rowReaderOpts.setStripeReadAheadBytes(readAheadBytes);
+    auto rowReader = reader->createRowReader(rowReaderOpts);
+    auto dwrfRowReader = dynamic_cast<DwrfRowReader*>(rowReader.get());
+
+    VectorPtr batch;
+    for (auto i = 0; i < batches.size(); ++i) {
+      if (i == 5) {
+        dwrfRowReader->seekToRow(7 * 1'000);
+        i = 7;
+      }
+      ASSERT_TRUE(rowReader->next(1'000, batch));
+      ASSERT_EQ(batches[i]->size(), batch->size());
+      for (auto row = 0; row < batch->size(); ++row) {
+        ASSERT_TRUE(batches[i]->equalValueAt(batch.get(), row, row))
+            << "Mismatch at batch " << i << " row " << row;
+      }
+    }
+    ASSERT_FALSE(rowReader->next(1'000, batch));
+  }
+}
+
+TEST(E2EWriterTests, parallelEncoding) {
+  auto scopedPool = memory::getDefaultScopedMemoryPool();
+  auto& pool = *scopedPool;
+  HiveTypeParser parser;
+  auto type = parser.parse(
+      "struct<"
+      "bool_val:boolean,"
+      "int_val:int,"
+      "long_val:bigint,"
+      "double_val:double,"
+      "string_val:string,"
+      "array_val:array<float>,"
+      "map_val:map<int,double>,"
+      "flat_map_val:map<bigint,string>"
+      ">");
+  auto config = std::make_shared<Config>();
+  // Small blocks, so that pages are compressed while the columns are written.
+  config->set(Config::COMPRESSION_BLOCK_SIZE, static_cast<uint64_t>(1024));
+  config->set(Config::FLATTEN_MAP, true);
+  config->set(Config::MAP_FLAT_COLS, {7});
+  auto batches =
+      E2EWriterTestUtil::generateBatches(type, 10, 500, /* seed */ 1, pool);
+
+  auto sink = std::make_unique<MemorySink>(pool, 20 * kSizeMB);
+  auto sinkPtr = sink.get();
+  WriterOptions options;
+  options.config = config;
+  options.schema = type;
+  options.encodingExecutor =
+      std::make_shared<folly::CPUThreadPoolExecutor>(4);
+  Writer writer{options, std::move(sink), pool};
+  for (auto& batch : batches) {
+    writer.write(batch);
+  }
+  writer.close();
+
+  ReaderOptions readerOpts;
+  auto input =
+      std::make_unique<MemoryInputStream>(sinkPtr->getData(), sinkPtr->size());
+  auto reader = std::make_unique<DwrfReader>(readerOpts, std::move(input));
+  auto rowReader = reader->createRowReader(RowReaderOptions());
+  VectorPtr result;
+  for (auto& batch : batches) {
+    ASSERT_TRUE(rowReader->next(batch->size(), result));
+    ASSERT_EQ(batch->size(), result->size());
+    for (auto row = 0; row < batch->size(); ++row) {
+      ASSERT_TRUE(batch->equalValueAt(result.get(), row, row))
+          << "Mismatch at row " << row << ": " << batch->toString(row)
+          << " vs " << result->toString(row);
+    }
+  }
+  ASSERT_FALSE(rowReader->next(1, result));
+}
+
 TEST(E2EWriterTests, OversizeRows) {
   auto scopedPool = facebook::velox::memory::getDefaultScopedMemoryPool();
   auto& pool = scopedPool->getPool();
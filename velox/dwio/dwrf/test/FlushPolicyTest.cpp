@@ -277,4 +277,47 @@ TEST(RowsPerStripeFlushPolicyTest, FlushTest) {
       exception::LoggedException)
       << "Out of Range Stripe";
 }
+
+TEST(MemoryAwareFlushPolicyTest, StripeSizeFollowsPressure) {
+  constexpr int64_t kCap = 1 << 20;
+  auto pool = getDefaultScopedMemoryPool(kCap);
+  auto coordinator = std::make_shared<WriterMemoryCoordinator>(*pool);
+  MemoryAwareFlushPolicy small{
+      coordinator,
+      /* targetStripeSize */ 200,
+      /* maxStripeSize */ 400,
+      /* dictionarySizeThreshold */ 0};
+  MemoryAwareFlushPolicy large{coordinator, 200, 400, 0};
+
+  // The pool is empty. Stripes grow past the target.
+  EXPECT_FALSE(small.shouldFlush(StripeProgress{
+      .totalMemoryUsage = 100, .stripeSizeEstimate = 300}));
+  EXPECT_TRUE(small.shouldFlush(StripeProgress{
+      .totalMemoryUsage = 100, .stripeSizeEstimate = 400}));
+
+  // Between the low and high usage ratios, stripes end at the target.
+  auto* buffer = pool->allocate(kCap * 6 / 10);
+  EXPECT_TRUE(small.shouldFlush(StripeProgress{
+      .totalMemoryUsage = 100, .stripeSizeEstimate = 300}));
+  EXPECT_FALSE(large.shouldFlush(StripeProgress{
+      .totalMemoryUsage = 500, .stripeSizeEstimate = 100}));
+
+  // Near the cap, the writer using the most memory flushes a small stripe.
+  auto* moreBuffer = pool->allocate(kCap * 3 / 10);
+  EXPECT_FALSE(small.shouldFlush(StripeProgress{
+      .totalMemoryUsage = 100, .stripeSizeEstimate = 100}));
+  EXPECT_TRUE(large.shouldFlush(StripeProgress{
+      .totalMemoryUsage = 500, .stripeSizeEstimate = 100}));
+
+  // After 'large' closes, 'small' is the largest writer.
+  large.onClose();
+  EXPECT_TRUE(small.shouldFlush(StripeProgress{
+      .totalMemoryUsage = 100, .stripeSizeEstimate = 100}));
+  // Nothing to flush in an empty stripe.
+  EXPECT_FALSE(small.shouldFlush(StripeProgress{
+      .totalMemoryUsage = 100, .stripeSizeEstimate = 0}));
+
+  pool->free(moreBuffer, kCap * 3 / 10);
+  pool->free(buffer, kCap * 6 / 10);
+}
 } // namespace facebook::velox::dwrf
@@ -209,3 +209,63 @@ TEST(ReaderBaseTest, InvalidPostScriptThrows) {
   EXPECT_THROW(
       { createCorruptedFileReader(0, 1'000'000); }, exception::LoggedException);
 }
+
+namespace {
+// Returns a file with no stripes whose footer starts after 'padding' bytes.
+std::string makeEmptyFile(int32_t padding) {
+  proto::Footer footer;
+  footer.set_numberofrows(0);
+  footer.add_types()->set_kind(proto::Type_Kind::Type_Kind_STRUCT);
+  auto footerBytes = footer.SerializeAsString();
+
+  proto::PostScript ps;
+  ps.set_footerlength(footerBytes.size());
+  ps.set_compression(proto::CompressionKind::NONE);
+  auto psBytes = ps.SerializeAsString();
+
+  return "ORC" + std::string(padding, 'x') + footerBytes + psBytes +
+      static_cast<char>(psBytes.size());
+}
+} // namespace
+
+TEST(ReaderBaseTest, sharedFileTail) {
+  auto* tailCache = FileTailCache::instance();
+  ASSERT_NE(tailCache, nullptr);
+  auto scopedPool = getDefaultScopedMemoryPool();
+  auto& pool = scopedPool->getPool();
+  auto file = makeEmptyFile(10);
+  auto longerFile = makeEmptyFile(20);
+  auto makeReader = [&](const std::string& data, uint64_t fileNum) {
+    return std::make_unique<ReaderBase>(
+        pool,
+        std::make_unique<MemoryInputStream>(data.data(), data.size()),
+        nullptr,
+        nullptr,
+        fileNum);
+  };
+
+  constexpr uint64_t kFileNum = 1'000'000'007;
+  auto first = makeReader(file, kFileNum);
+  auto second = makeReader(file, kFileNum);
+  EXPECT_EQ(&first->getFooter(), &second->getFooter());
+  EXPECT_EQ(&first->getPostScript(), &second->getPostScript());
+  EXPECT_EQ(first->getSchema(), second->getSchema());
+
+  // A reader without a file number and a file of another length do not
+  // share the tail.
+  auto unnumbered = makeReader(file, std::numeric_limits<uint64_t>::max());
+  EXPECT_NE(&first->getFooter(), &unnumbered->getFooter());
+  auto longer = makeReader(longerFile, kFileNum);
+  EXPECT_NE(&first->getFooter(), &longer->getFooter());
+  EXPECT_EQ(0, longer->getFooter().numberofrows());
+
+  // A reader keeps its tail after the other readers are gone.
+  first.reset();
+  EXPECT_EQ(0, second->getFooter().numberofrows());
+
+  // A tail larger than the cache is not kept.
+  FileTailCache smallCache(1);
+  smallCache.insert(1, 1, std::make_shared<FileTail>());
+  EXPECT_EQ(smallCache.find(1, 1), nullptr);
+  EXPECT_EQ(smallCache.currentBytes(), 0);
+}
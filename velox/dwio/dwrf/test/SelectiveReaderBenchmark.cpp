@@ -0,0 +1,317 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <folly/String.h>
+#include <folly/init/Init.h>
+#include <gflags/gflags.h>
+#include <chrono>
+
+#include "velox/common/file/File.h"
+#include "velox/dwio/common/InputStream.h"
+#include "velox/dwio/dwrf/reader/DwrfReader.h"
+#include "velox/dwio/dwrf/test/utils/FilterGenerator.h"
+#include "velox/dwio/dwrf/writer/Writer.h"
+#include "velox/vector/tests/VectorMaker.h"
+
+DEFINE_int32(num_rows, 1'000'000, "Rows in each file");
+DEFINE_int32(cardinality, 1'000, "Distinct values of the scanned column");
+DEFINE_string(null_ratios, "0,0.2", "Comma separated null ratios to write");
+DEFINE_string(
+    compressions,
+    "none,zstd",
+    "Comma separated compression kinds to write: none, zlib or zstd");
+DEFINE_int32(num_repeats, 3, "Scans per case. The fastest one is reported");
+
+using namespace facebook::velox;
+using namespace facebook::velox::dwio::common;
+using namespace facebook::velox::dwio::dwrf;
+using namespace facebook::velox::dwrf;
+
+// Measures scans of DWRF files with the selective column readers. Each file
+// has a BIGINT filter column c0 whose values cycle over 0..999 and a scanned
+// column c1 of one type, written with a given encoding, null ratio and
+// compression kind. The scans filter c0 to keep 100%, 50%, 10% and 1% of the
+// rows and read c0 and c1. The files are read from an InMemoryReadFile so
+// that the times are for decompression and decoding only.
+//
+// The encodings are direct or dictionary, forced with the dictionary key
+// size thresholds, each with varint or fixed width integers. The DWRF writer
+// only writes RLEv1, so the varint setting stands in for the choice of
+// integer encoding. MAP columns are written as regular or flat maps.
+//
+// For each case this prints the input rows/s, the file bytes/s and the
+// fraction of rows passing the filter.
+namespace {
+
+enum class ColumnKind { kBigint, kDouble, kVarchar, kMap };
+
+std::string kindName(ColumnKind kind) {
+  switch (kind) {
+    case ColumnKind::kBigint:
+      return "bigint";
+    case ColumnKind::kDouble:
+      return "double";
+    case ColumnKind::kVarchar:
+      return "varchar";
+    case ColumnKind::kMap:
+      return "map";
+  }
+  VELOX_UNREACHABLE();
+}
+
+TypePtr kindType(ColumnKind kind) {
+  switch (kind) {
+    case ColumnKind::kBigint:
+      return BIGINT();
+    case ColumnKind::kDouble:
+      return DOUBLE();
+    case ColumnKind::kVarchar:
+      return VARCHAR();
+    case ColumnKind::kMap:
+      return MAP(INTEGER(), BIGINT());
+  }
+  VELOX_UNREACHABLE();
+}
+
+struct FileParams {
+  ColumnKind kind;
+  bool dictionary;
+  bool useVInts;
+  bool flatMap;
+  double nullRatio;
+  std::string compression;
+
+  std::string toString() const {
+    return fmt::format(
+        "{}/{}/{}{}/nulls={}/{}",
+        kindName(kind),
+        dictionary ? "dict" : "direct",
+        useVInts ? "vint" : "fixed",
+        kind == ColumnKind::kMap ? (flatMap ? "/flat" : "/regular") : "",
+        nullRatio,
+        compression);
+  }
+};
+
+struct ScanStats {
+  int64_t nanos{std::numeric_limits<int64_t>::max()};
+  int64_t outputRows{0};
+};
+
+CompressionKind compressionKind(const std::string& name) {
+  static const std::unordered_map<std::string, CompressionKind> kKinds = {
+      {"none", CompressionKind_NONE},
+      {"zlib", CompressionKind_ZLIB},
+      {"zstd", CompressionKind_ZSTD}};
+  auto it = kKinds.find(name);
+  VELOX_USER_CHECK(it != kKinds.end(), "Unsupported compression: {}", name);
+  return it->second;
+}
+
+template <typename T>
+std::vector<T> parseList(const std::string& flag) {
+  std::vector<std::string> parts;
+  folly::split(',', flag, parts, true);
+  std::vector<T> values;
+  for (const auto& part : parts) {
+    values.push_back(folly::to<T>(part));
+  }
+  return values;
+}
+
+class SelectiveReaderBenchmark {
+ public:
+  SelectiveReaderBenchmark()
+      : pool_(memory::getDefaultScopedMemoryPool()),
+        vectorMaker_(pool_.get()) {
+    for (auto i = 0; i < FLAGS_cardinality; ++i) {
+      strings_.push_back(fmt::format("value-{:016}", i * 7919));
+    }
+  }
+
+  // Writes a file for 'params' and returns its bytes.
+  std::string write(const FileParams& params) {
+    auto rowType = ROW({"c0", "c1"}, {BIGINT(), kindType(params.kind)});
+    auto config = std::make_shared<Config>();
+    config->set(Config::COMPRESSION, compressionKind(params.compression));
+    config->set(Config::USE_VINTS, params.useVInts);
+    const float threshold = params.dictionary ? 1.0f : 0.0f;
+    config->set(Config::DICTIONARY_NUMERIC_KEY_SIZE_THRESHOLD, threshold);
+    config->set(Config::DICTIONARY_STRING_KEY_SIZE_THRESHOLD, threshold);
+    config->set(Config::ENTROPY_KEY_STRING_SIZE_THRESHOLD, 0.0f);
+    if (params.flatMap) {
+      config->set(Config::FLATTEN_MAP, true);
+      config->set(Config::MAP_FLAT_COLS, std::vector<uint32_t>{1});
+    }
+    WriterOptions options;
+    options.config = config;
+    options.schema = rowType;
+    auto sink = std::make_unique<MemorySink>(*pool_, 64 << 20);
+    auto* sinkPtr = sink.get();
+    Writer writer(options, std::move(sink), *pool_);
+    constexpr vector_size_t kBatchSize = 10'000;
+    for (auto firstRow = 0; firstRow < FLAGS_num_rows;
+         firstRow += kBatchSize) {
+      writer.write(makeBatch(
+          params, firstRow, std::min(kBatchSize, FLAGS_num_rows - firstRow)));
+    }
+    writer.close();
+    return std::string(sinkPtr->getData(), sinkPtr->size());
+  }
+
+  // Scans 'file' with a filter on c0 that passes 'percent' of the rows.
+  ScanStats scan(
+      const std::string& file,
+      const RowTypePtr& rowType,
+      int32_t percent) {
+    ScanStats stats;
+    InMemoryReadFile readFile(std::string_view(file.data(), file.size()));
+    for (auto repeat = 0; repeat < FLAGS_num_repeats; ++repeat) {
+      std::shared_ptr<const RowType> type = rowType;
+      FilterGenerator filterGenerator(type);
+      SubfieldFilters filters;
+      if (percent < 100) {
+        filters[Subfield("c0")] =
+            std::make_unique<common::BigintRange>(0, percent * 10 - 1, false);
+      }
+      auto spec = filterGenerator.makeScanSpec(std::move(filters));
+      RowReaderOptions rowReaderOptions;
+      rowReaderOptions.setScanSpec(spec);
+
+      const auto start = std::chrono::steady_clock::now();
+      DwrfReader reader(
+          ReaderOptions(), std::make_unique<ReadFileInputStream>(&readFile));
+      auto rowReader = reader.createRowReader(rowReaderOptions);
+      auto batch = BaseVector::create(rowType, 0, pool_.get());
+      int64_t outputRows = 0;
+      while (rowReader->next(10'000, batch)) {
+        auto* rowVector = batch->asUnchecked<RowVector>();
+        for (auto& child : rowVector->children()) {
+          child->loadedVector();
+        }
+        outputRows += batch->size();
+      }
+      const auto nanos = std::chrono::duration_cast<std::chrono::nanoseconds>(
+                             std::chrono::steady_clock::now() - start)
+                             .count();
+      stats.nanos = std::min<int64_t>(stats.nanos, nanos);
+      stats.outputRows = outputRows;
+    }
+    return stats;
+  }
+
+ private:
+  RowVectorPtr
+  makeBatch(const FileParams& params, int32_t firstRow, vector_size_t size) {
+    const auto nullEvery = params.nullRatio > 0
+        ? std::max<int32_t>(1, std::lround(1 / params.nullRatio))
+        : 0;
+    auto isNullAt = [&](vector_size_t row) {
+      return nullEvery && (firstRow + row) % nullEvery == 0;
+    };
+    // Spreads the values so that consecutive rows do not repeat.
+    auto valueIndex = [&](vector_size_t row) {
+      return ((firstRow + row) * 7919L) % FLAGS_cardinality;
+    };
+    auto c0 = vectorMaker_.flatVector<int64_t>(
+        size, [&](auto row) { return (firstRow + row) % 1'000; });
+    VectorPtr c1;
+    switch (params.kind) {
+      case ColumnKind::kBigint:
+        c1 = vectorMaker_.flatVector<int64_t>(
+            size,
+            [&](auto row) { return valueIndex(row) * 1'000'003; },
+            isNullAt);
+        break;
+      case ColumnKind::kDouble:
+        c1 = vectorMaker_.flatVector<double>(
+            size, [&](auto row) { return valueIndex(row) * 0.25; }, isNullAt);
+        break;
+      case ColumnKind::kVarchar:
+        c1 = vectorMaker_.flatVector<StringView>(
+            size,
+            [&](auto row) { return StringView(strings_[valueIndex(row)]); },
+            isNullAt);
+        break;
+      case ColumnKind::kMap:
+        c1 = vectorMaker_.mapVector<int32_t, int64_t>(
+            size,
+            [&](auto row) { return 1 + valueIndex(row) % 5; },
+            [&](auto index) { return index % 10; },
+            [&](auto index) { return (index * 7919L) % FLAGS_cardinality; },
+            isNullAt);
+        break;
+    }
+    return vectorMaker_.rowVector({"c0", "c1"}, {c0, c1});
+  }
+
+  std::unique_ptr<memory::MemoryPool> pool_;
+  test::VectorMaker vectorMaker_;
+  // Backing for the VARCHAR values.
+  std::vector<std::string> strings_;
+};
+} // namespace
+
+int main(int argc, char** argv) {
+  folly::init(&argc, &argv);
+  SelectiveReaderBenchmark benchmark;
+  std::cout << fmt::format(
+                   "{:<48} {:>4} {:>12} {:>10} {:>8}",
+                   "file",
+                   "pct",
+                   "rows/s",
+                   "MB/s",
+                   "pass")
+            << std::endl;
+  for (auto kind :
+       {ColumnKind::kBigint,
+        ColumnKind::kDouble,
+        ColumnKind::kVarchar,
+        ColumnKind::kMap}) {
+    for (auto dictionary : {false, true}) {
+      for (auto useVInts : {true, false}) {
+        for (auto flatMap : {false, true}) {
+          if (flatMap && kind != ColumnKind::kMap) {
+            continue;
+          }
+          for (auto nullRatio : parseList<double>(FLAGS_null_ratios)) {
+            for (const auto& compression :
+                 parseList<std::string>(FLAGS_compressions)) {
+              FileParams params{
+                  kind, dictionary, useVInts, flatMap, nullRatio, compression};
+              auto file = benchmark.write(params);
+              auto rowType = ROW({"c0", "c1"}, {BIGINT(), kindType(kind)});
+              for (auto percent : {100, 50, 10, 1}) {
+                auto stats = benchmark.scan(file, rowType, percent);
+                const double seconds = stats.nanos / 1e9;
+                std::cout << fmt::format(
+                                 "{:<48} {:>4} {:>12.0f} {:>10.1f} {:>8.3f}",
+                                 params.toString(),
+                                 percent,
+                                 FLAGS_num_rows / seconds,
+                                 file.size() / seconds / (1 << 20),
+                                 static_cast<double>(stats.outputRows) /
+                                     FLAGS_num_rows)
+                          << std::endl;
+              }
+            }
+          }
+        }
+      }
+    }
+  }
+  return 0;
+}
@@ -120,6 +120,7 @@ class ColumnReaderTestBase {
     ColumnSelector cs(rowType, nodes, true);
     auto options = RowReaderOptions();
     options.setReturnFlatVector(returnFlatVector());
+    options.setIntegerDictionaryOutput(integerDictionaryOutput_);
 
     EXPECT_CALL(streams_, getColumnSelectorProxy())
         .WillRepeatedly(testing::Return(&cs));
@@ -205,6 +206,10 @@ class ColumnReaderTestBase {
   std::unique_ptr<ColumnReader> columnReader_;
   std::unique_ptr<SelectiveColumnReader> selectiveColumnReader_;
 
+  // Passed to RowReaderOptions::setIntegerDictionaryOutput() in
+  // buildReader().
+  bool integerDictionaryOutput_{false};
+
  private:
   std::unique_ptr<common::ScanSpec> scanSpec_;
 };
@@ -805,6 +810,62 @@ TEST_P(TestColumnReader, testIntDictSkipNoNullsAllInDict) {
   }
 }
 
+TEST_P(TestColumnReader, testIntDictAsDictionaryVector) {
+  if (!useSelectiveReader()) {
+    return;
+  }
+  integerDictionaryOutput_ = true;
+  proto::ColumnEncoding directEncoding;
+  directEncoding.set_kind(proto::ColumnEncoding_Kind_DIRECT);
+  proto::ColumnEncoding dictEncoding;
+  dictEncoding.set_kind(proto::ColumnEncoding_Kind_DICTIONARY);
+  dictEncoding.set_dictionarysize(100);
+  EXPECT_CALL(streams_, getEncodingProxy(_))
+      .WillRepeatedly(Return(&directEncoding));
+  EXPECT_CALL(streams_, getEncodingProxy(1))
+      .WillRepeatedly(Return(&dictEncoding));
+
+  EXPECT_CALL(streams_, getStreamProxy(_, proto::Stream_Kind_ROW_INDEX, false))
+      .WillRepeatedly(Return(nullptr));
+  EXPECT_CALL(streams_, getStreamProxy(0, proto::Stream_Kind_ROW_INDEX, false))
+      .WillRepeatedly(Return(nullptr));
+  EXPECT_CALL(streams_, getStreamProxy(_, proto::Stream_Kind_PRESENT, false))
+      .WillRepeatedly(Return(nullptr));
+
+  // Row i refers to dictionary entry i.
+  char data[1024];
+  std::vector<uint64_t> v;
+  data[0] = 0x9C; // rle literal, -100
+  for (uint64_t i = 0; i < 100; ++i) {
+    v.push_back(i);
+  }
+  size_t size = writeVuLongs(data + 1, v);
+  EXPECT_CALL(streams_, getStreamProxy(1, proto::Stream_Kind_DATA, true))
+      .WillRepeatedly(Return(new SeekableArrayInputStream(data, size + 1)));
+  EXPECT_CALL(
+      streams_, getStreamProxy(1, proto::Stream_Kind_IN_DICTIONARY, false))
+      .WillRepeatedly(Return(nullptr));
+  EXPECT_CALL(streams_, genMockDictDataSetter(1, 0))
+      .WillRepeatedly(Return([&](BufferPtr& buffer, MemoryPool* pool) {
+        buffer = sequence<int32_t>(pool, 1000, 1100);
+      }));
+
+  auto rowType = HiveTypeParser().parse("struct<myInt:int>");
+  buildReader(rowType);
+  VectorPtr batch = newBatch(rowType);
+  int32_t offset = 0;
+  for (int32_t round = 0; round < 2; ++round) {
+    skipAndRead(batch, /* read */ 40, /* skip */ 10);
+    offset += 10;
+    auto child = getOnlyChild<SimpleVector<int32_t>>(batch);
+    ASSERT_EQ(VectorEncoding::Simple::DICTIONARY, child->encoding());
+    ASSERT_EQ(40, child->size());
+    for (auto i = 0; i < child->size(); ++i) {
+      EXPECT_EQ(1000 + offset++, child->valueAt(i));
+    }
+  }
+}
+
 TEST_P(TestColumnReader, testIntDictSkipWithNulls) {
   // set getEncoding
   proto::ColumnEncoding directEncoding;
@@ -1019,6 +1080,11 @@ TEST_P(StringReaderTests, testDictionaryWithNulls) {
   }
   ASSERT_EQ(200, stringBatch->size());
   ASSERT_EQ(100, getNullCount(stringBatch));
+  if (useSelectiveReader() && !returnFlatVector_) {
+    // The dictionary is checked for ASCII once when loaded.
+    SelectivityVector allRows(stringBatch->size());
+    EXPECT_EQ(true, stringBatch->isAscii(allRows));
+  }
   for (size_t i = 0; i < batch->size(); ++i) {
     if (i & 4) {
       EXPECT_TRUE(stringBatch->isNullAt(i));
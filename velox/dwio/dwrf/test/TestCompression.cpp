@@ -21,9 +21,11 @@
 #include "velox/dwio/dwrf/test/OrcTest.h"
 
 #include <folly/Random.h>
+#include <folly/executors/CPUThreadPoolExecutor.h>
 #include <gtest/gtest.h>
 
 #include <algorithm>
+#include <mutex>
 
 using namespace ::testing;
 using namespace facebook::velox::dwio;
@@ -38,20 +40,29 @@ const int32_t DEFAULT_MEM_STREAM_SIZE = 1024 * 1024 * 2; // 2M
 class TestBufferPool : public CompressionBufferPool {
  public:
   TestBufferPool(MemoryPool& pool, uint64_t blockSize)
-      : buffer_{std::make_unique<DataBuffer<char>>(
-            pool,
-            blockSize + PAGE_HEADER_SIZE)} {}
+      : pool_{pool}, blockSize_{blockSize} {}
 
   std::unique_ptr<DataBuffer<char>> getBuffer(uint64_t /* unused */) override {
-    return std::move(buffer_);
+    std::lock_guard<std::mutex> l(mutex_);
+    if (buffers_.empty()) {
+      return std::make_unique<DataBuffer<char>>(
+          pool_, blockSize_ + PAGE_HEADER_SIZE);
+    }
+    auto buffer = std::move(buffers_.back());
+    buffers_.pop_back();
+    return buffer;
   }
 
   void returnBuffer(std::unique_ptr<DataBuffer<char>> buffer) override {
-    buffer_ = std::move(buffer);
+    std::lock_guard<std::mutex> l(mutex_);
+    buffers_.push_back(std::move(buffer));
   }
 
  private:
-  std::unique_ptr<DataBuffer<char>> buffer_;
+  MemoryPool& pool_;
+  const uint64_t blockSize_;
+  std::mutex mutex_;
+  std::vector<std::unique_ptr<DataBuffer<char>>> buffers_;
 };
 
 void generateRandomData(char* data, size_t size, bool letter) {
@@ -107,14 +118,16 @@ void compressAndVerify(
     MemoryPool& pool,
     const char* data,
     size_t dataSize,
-    const Encrypter* encrypter) {
+    const Encrypter* encrypter,
+    folly::Executor* executor = nullptr) {
   TestBufferPool bufferPool(pool, block);
   DataBufferHolder holder{
       pool, block, 0, DEFAULT_PAGE_GROW_RATIO, std::addressof(sink)};
   Config config;
   config.set<uint32_t>(Config::COMPRESSION_THRESHOLD, 128);
-  std::unique_ptr<BufferedOutputStream> compressStream =
-      createCompressor(kind, bufferPool, holder, config, encrypter);
+  config.set<uint32_t>(Config::COMPRESSION_MAX_PENDING_PAGES, 2);
+  std::unique_ptr<BufferedOutputStream> compressStream = createCompressor(
+      kind, bufferPool, holder, config, encrypter, executor);
 
   size_t pos = 0;
   char* compressBuffer;
@@ -237,6 +250,33 @@ TEST_P(CompressionTest, compressRandomBytes) {
       memSink, kind_, block, testData, dataSize, pool, decrypter_);
 }
 
+TEST_P(CompressionTest, compressInBackground) {
+  auto scopedPool = getDefaultScopedMemoryPool();
+  auto& pool = scopedPool->getPool();
+  MemorySink memSink(pool, DEFAULT_MEM_STREAM_SIZE);
+  MemorySink expectedSink(pool, DEFAULT_MEM_STREAM_SIZE);
+  folly::CPUThreadPoolExecutor executor(2);
+
+  uint64_t block = 1024;
+  constexpr size_t dataSize = 1024 * 1024; // 1M
+
+  char testData[dataSize];
+  generateRandomData(testData, dataSize, true);
+  compressAndVerify(
+      kind_, memSink, block, pool, testData, dataSize, encrypter_, &executor);
+  decompressAndVerify(
+      memSink, kind_, block, testData, dataSize, pool, decrypter_);
+
+  // Pages come out in the same order and with the same content as when
+  // compressed on the calling thread.
+  compressAndVerify(
+      kind_, expectedSink, block, pool, testData, dataSize, encrypter_);
+  ASSERT_EQ(memSink.size(), expectedSink.size());
+  EXPECT_EQ(
+      std::memcmp(memSink.getData(), expectedSink.getData(), memSink.size()),
+      0);
+}
+
 void verifyProto(
     const MemorySink& memSink,
     CompressionKind kind,
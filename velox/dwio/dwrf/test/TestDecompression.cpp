@@ -18,8 +18,10 @@
 #include <folly/String.h>
 #include <folly/compression/Compression.h>
 #include <folly/compression/Zlib.h>
+#include <folly/executors/CPUThreadPoolExecutor.h>
 #include <gtest/gtest.h>
 #include "velox/dwio/common/InputStream.h"
+#include "velox/dwio/common/encryption/TestProvider.h"
 #include "velox/dwio/dwrf/common/Compression.h"
 #include "velox/dwio/dwrf/test/OrcTest.h"
 
@@ -917,3 +919,131 @@ TEST_F(TestSeek, uncompressed) {
   EXPECT_TRUE(stream->Next(&result, &size));
   EXPECT_EQ(result, data.getCompressed() + 50);
 }
+
+TEST(TestDecompression, blocksAhead) {
+  constexpr size_t kBlockSize = 1024;
+  constexpr int32_t kNumBlocks = 20;
+  auto codec = getCodec(CodecType::ZSTD);
+  std::vector<std::vector<char>> blocks(kNumBlocks);
+  std::vector<char> compressed((kBlockSize + 100) * kNumBlocks);
+  std::vector<size_t> offsets;
+  size_t offset = 0;
+  for (auto i = 0; i < kNumBlocks; ++i) {
+    blocks[i].resize(kBlockSize);
+    fillInput(blocks[i].data(), kBlockSize);
+    offsets.push_back(offset);
+    if (i % 5 == 4) {
+      // Every fifth block is stored uncompressed.
+      writeHeader(compressed.data() + offset, kBlockSize, true);
+      std::memcpy(
+          compressed.data() + offset + 3, blocks[i].data(), kBlockSize);
+      offset += kBlockSize + 3;
+    } else {
+      offset = compress(
+          blocks[i].data(), kBlockSize, compressed.data(), offset, *codec);
+    }
+  }
+
+  folly::CPUThreadPoolExecutor executor(4);
+  IoStatistics ioStats;
+  ParallelDecompressionOptions parallel{&executor, 3, &ioStats};
+  auto stream = createDecompressor(
+      CompressionKind_ZSTD,
+      std::make_unique<SeekableArrayInputStream>(
+          compressed.data(), offset, 100),
+      kBlockSize,
+      scopedPool->getPool(),
+      "Test Decompression",
+      nullptr,
+      parallel);
+
+  const void* data;
+  int32_t size;
+  for (auto i = 0; i < kNumBlocks; ++i) {
+    ASSERT_TRUE(stream->Next(&data, &size));
+    ASSERT_EQ(kBlockSize, size);
+    EXPECT_EQ(0, std::memcmp(data, blocks[i].data(), kBlockSize)) << i;
+  }
+  EXPECT_FALSE(stream->Next(&data, &size));
+  EXPECT_EQ(16, ioStats.backgroundDecompression().count());
+  EXPECT_EQ(16, ioStats.queryThreadDecompressionLatency().count());
+
+  // Seeks back, then forward to a block that is read ahead, then to one
+  // that is not.
+  for (auto i : {3, 5, 18, 1}) {
+    std::vector<uint64_t> position{offsets[i], 10};
+    PositionProvider provider(position);
+    stream->seekToPosition(provider);
+    ASSERT_TRUE(stream->Next(&data, &size));
+    ASSERT_EQ(kBlockSize - 10, size);
+    EXPECT_EQ(0, std::memcmp(data, blocks[i].data() + 10, size)) << i;
+  }
+
+  // BackUp() is limited to the current block.
+  stream->BackUp(size);
+  ASSERT_TRUE(stream->Next(&data, &size));
+  EXPECT_EQ(kBlockSize - 10, size);
+  EXPECT_EQ(0, std::memcmp(data, blocks[1].data() + 10, size));
+}
+
+namespace {
+class BatchCountingDecrypter : public encryption::test::TestDecrypter {
+ public:
+  std::vector<std::unique_ptr<folly::IOBuf>> decryptBatch(
+      const std::vector<folly::StringPiece>& inputs) const override {
+    ++numBatches;
+    numBlocks += inputs.size();
+    return Decrypter::decryptBatch(inputs);
+  }
+
+  mutable int32_t numBatches{0};
+  mutable int32_t numBlocks{0};
+};
+} // namespace
+
+TEST(TestDecompression, decryptBlocksAhead) {
+  constexpr size_t kBlockSize = 1024;
+  constexpr int32_t kNumBlocks = 12;
+  encryption::test::TestEncrypter encrypter;
+  encrypter.setKey("key");
+  BatchCountingDecrypter decrypter;
+  decrypter.setKey("key");
+  std::vector<std::vector<char>> blocks(kNumBlocks);
+  std::string encrypted;
+  for (auto i = 0; i < kNumBlocks; ++i) {
+    blocks[i].resize(kBlockSize);
+    fillInput(blocks[i].data(), kBlockSize);
+    auto block = encrypter.encrypt({blocks[i].data(), kBlockSize});
+    char header[3];
+    writeHeader(header, block->length(), true);
+    encrypted.append(header, sizeof(header));
+    encrypted.append(
+        reinterpret_cast<const char*>(block->data()), block->length());
+  }
+
+  folly::CPUThreadPoolExecutor executor(2);
+  IoStatistics ioStats;
+  ParallelDecompressionOptions parallel{&executor, 4, &ioStats};
+  auto stream = createDecompressor(
+      CompressionKind_NONE,
+      std::make_unique<SeekableArrayInputStream>(
+          encrypted.data(), encrypted.size(), 100),
+      kBlockSize,
+      scopedPool->getPool(),
+      "Test Decryption",
+      &decrypter,
+      parallel);
+
+  const void* data;
+  int32_t size;
+  for (auto i = 0; i < kNumBlocks; ++i) {
+    ASSERT_TRUE(stream->Next(&data, &size));
+    ASSERT_EQ(kBlockSize, size);
+    EXPECT_EQ(0, std::memcmp(data, blocks[i].data(), kBlockSize)) << i;
+  }
+  EXPECT_FALSE(stream->Next(&data, &size));
+  // The blocks are decrypted a half queue at a time after the first fill.
+  EXPECT_EQ(kNumBlocks, decrypter.numBlocks);
+  EXPECT_EQ(5, decrypter.numBatches);
+  EXPECT_EQ(5, ioStats.decryption().count());
+}
@@ -15,6 +15,7 @@
  */
 
 #include <gtest/gtest.h>
+#include <random>
 
 #include "velox/common/base/Nulls.h"
 #include "velox/dwio/common/IntDecoder.h"
@@ -600,6 +601,68 @@ TEST(RLEv2, basicDirectSeek) {
   EXPECT_EQ(2, data[0]);
 };
 
+TEST(RLEv2, directAllBitWidths) {
+  // Encoded width of each bit width that DIRECT runs may use.
+  const std::vector<std::pair<uint32_t, uint32_t>> widths = {
+      {1, 0},   {2, 1},   {3, 2},   {4, 3},   {5, 4},   {6, 5},   {7, 6},
+      {8, 7},   {9, 8},   {10, 9},  {11, 10}, {12, 11}, {13, 12}, {14, 13},
+      {15, 14}, {16, 15}, {17, 16}, {18, 17}, {19, 18}, {20, 19}, {21, 20},
+      {22, 21}, {23, 22}, {24, 23}, {26, 24}, {28, 25}, {30, 26}, {32, 27},
+      {40, 28}, {48, 29}, {56, 30}, {64, 31}};
+  std::mt19937 rng(1);
+  for (auto [width, encodedWidth] : widths) {
+    // Two runs of 300 and 7 values, so that the second run starts inside
+    // a buffer and the values do not end on a byte boundary.
+    std::vector<unsigned char> bytes;
+    std::vector<int64_t> values;
+    for (uint32_t runLength : {300, 7}) {
+      bytes.push_back(0x40 | (encodedWidth << 1) | ((runLength - 1) >> 8));
+      bytes.push_back((runLength - 1) & 0xff);
+      uint64_t bitOffset = 0;
+      auto runStart = bytes.size();
+      bytes.resize(runStart + (runLength * width + 7) / 8);
+      for (uint32_t i = 0; i < runLength; ++i) {
+        uint64_t value = (static_cast<uint64_t>(rng()) << 32) | rng();
+        if (width < 64) {
+          value &= (1UL << width) - 1;
+        }
+        values.push_back(zigZagDecode(value));
+        for (int32_t bit = width - 1; bit >= 0; --bit, ++bitOffset) {
+          if (value >> bit & 1) {
+            bytes[runStart + bitOffset / 8] |= 0x80 >> (bitOffset % 8);
+          }
+        }
+      }
+    }
+    for (auto n : {1, 7, 100, 307}) {
+      checkResults(
+          values,
+          decodeRLEv2(bytes.data(), bytes.size(), n, values.size()),
+          n);
+    }
+    // Every 3rd value is null.
+    std::vector<uint64_t> nulls(bits::nwords(values.size() * 2));
+    std::vector<int64_t> withNulls;
+    for (auto i = 0, j = 0; j < values.size(); ++i) {
+      if (i % 3 == 0) {
+        bits::setNull(nulls.data(), i);
+        withNulls.push_back(0);
+      } else {
+        bits::clearNull(nulls.data(), i);
+        withNulls.push_back(values[j++]);
+      }
+    }
+    for (auto n : {5, 64, 500}) {
+      checkResults(
+          withNulls,
+          decodeRLEv2(
+              bytes.data(), bytes.size(), n, withNulls.size(), nulls.data()),
+          n,
+          nulls.data());
+    }
+  }
+}
+
 TEST(RLEv2, bitsLeftByPreviousStream) {
   auto scopedPool = memory::getDefaultScopedMemoryPool();
   // test for #109
@@ -15,6 +15,7 @@
  */
 
 #include "velox/dwio/dwrf/writer/ColumnWriter.h"
+#include <folly/futures/Future.h>
 #include "velox/dwio/common/ChainedBuffer.h"
 #include "velox/dwio/dwrf/common/EncoderUtil.h"
 #include "velox/dwio/dwrf/writer/DictionaryEncodingUtils.h"
@@ -34,7 +35,8 @@ namespace facebook::velox::dwrf {
 WriterContext::LocalDecodedVector BaseColumnWriter::decode(
     const VectorPtr& slice,
     const Ranges& ranges) {
-  auto& selected = context_.getSharedSelectivityVector(slice->size());
+  auto localSelected = context_.getLocalSelectivityVector(slice->size());
+  auto& selected = localSelected.get();
   // initialize
   selected.clearAll();
   for (auto& range : ranges.getRanges()) {
@@ -209,6 +211,10 @@ class IntegerColumnWriter : public BaseColumnWriter {
             getConfig(Config::DICTIONARY_NUMERIC_KEY_SIZE_THRESHOLD)},
         sort_{getConfig(Config::DICTIONARY_SORT_KEYS)},
         useDictionaryEncoding_{useDictionaryEncoding()},
+        earlyCheckRows_{
+            dictionaryEncodingHint().has_value()
+                ? 0
+                : getConfig(Config::DICTIONARY_EARLY_CHECK_ROWS)},
         strideOffsets_{getMemoryPool(MemoryUsageCategory::GENERAL)} {
     DWIO_ENSURE_GE(dictionaryKeySizeThreshold_, 0.0);
     DWIO_ENSURE_LE(dictionaryKeySizeThreshold_, 1.0);
@@ -247,7 +253,11 @@ class IntegerColumnWriter : public BaseColumnWriter {
   void flush(
       std::function<proto::ColumnEncoding&(uint32_t)> encodingFactory,
       std::function<void(proto::ColumnEncoding&)> encodingOverride) override {
+    const bool decideEncoding = firstStripe_ && useDictionaryEncoding_;
     tryAbandonDictionaries(false);
+    if (decideEncoding) {
+      recordDictionaryEncodingHint(useDictionaryEncoding_);
+    }
     initStreamWriters(useDictionaryEncoding_);
 
     size_t dictEncoderSize = dictEncoder_.size();
@@ -398,6 +408,19 @@ class IntegerColumnWriter : public BaseColumnWriter {
     ensureValidStreamWriters(dictEncoding);
   }
 
+  // Abandons the dictionary if it does not pay off for the first
+  // 'earlyCheckRows_' values, rather than building it for the whole stripe.
+  void checkDictionaryEarly() {
+    if (earlyCheckRows_ == 0 || !firstStripe_ ||
+        rows_.size() < earlyCheckRows_) {
+      return;
+    }
+    earlyCheckRows_ = 0;
+    if (tryAbandonDictionaries(false)) {
+      recordDictionaryEncodingHint(false);
+    }
+  }
+
   // NOTE: This should be called *before* clearing the rows_ buffer.
   bool shouldKeepDictionary() const {
     // TODO(T91508412): Move the dictionary efficiency based decision into
@@ -463,6 +486,9 @@ class IntegerColumnWriter : public BaseColumnWriter {
   // determine with the first stripe that the data is not fit for dictionary
   // encoding.
   bool useDictionaryEncoding_;
+  // Number of values in the first stripe after which the dictionary is
+  // checked early. 0 once checked or if not checked early.
+  uint32_t earlyCheckRows_;
   bool firstStripe_{true};
   DataBuffer<size_t> strideOffsets_;
 };
@@ -475,7 +501,9 @@ uint64_t IntegerColumnWriter<T>::write(
     // Decode and then write
     auto localDecoded = decode(slice, ranges);
     auto& decodedVector = localDecoded.get();
-    return writeDict(decodedVector, ranges);
+    auto rawSize = writeDict(decodedVector, ranges);
+    checkDictionaryEarly();
+    return rawSize;
   } else {
     // If the input is not a flat vector we make a complete copy and convert
     // it to flat vector
@@ -802,6 +830,10 @@ class StringColumnWriter : public BaseColumnWriter {
             getConfig(Config::ENTROPY_STRING_THRESHOLD)},
         sort_{getConfig(Config::DICTIONARY_SORT_KEYS)},
         useDictionaryEncoding_{useDictionaryEncoding()},
+        earlyCheckRows_{
+            dictionaryEncodingHint().has_value()
+                ? 0
+                : getConfig(Config::DICTIONARY_EARLY_CHECK_ROWS)},
         strideOffsets_{getMemoryPool(MemoryUsageCategory::GENERAL)} {
     DWIO_ENSURE(firstStripe_);
     if (!useDictionaryEncoding_) {
@@ -832,7 +864,11 @@ class StringColumnWriter : public BaseColumnWriter {
   void flush(
       std::function<proto::ColumnEncoding&(uint32_t)> encodingFactory,
       std::function<void(proto::ColumnEncoding&)> encodingOverride) override {
+    const bool decideEncoding = firstStripe_ && useDictionaryEncoding_;
     tryAbandonDictionaries(false);
+    if (decideEncoding) {
+      recordDictionaryEncodingHint(useDictionaryEncoding_);
+    }
     initStreamWriters(useDictionaryEncoding_);
 
     size_t dictEncoderSize = dictEncoder_.size();
@@ -953,7 +989,7 @@ class StringColumnWriter : public BaseColumnWriter {
     return (sequence_ == 0 ||
             !context_.getConfig(
                 Config::MAP_FLAT_DISABLE_DICT_ENCODING_STRING)) &&
-        !context_.isLowMemoryMode();
+        !context_.isLowMemoryMode() && dictionaryEncodingHint().value_or(true);
   }
 
  private:
@@ -1010,6 +1046,19 @@ class StringColumnWriter : public BaseColumnWriter {
     ensureValidStreamWriters(dictEncoding);
   }
 
+  // Abandons the dictionary if it does not pay off for the first
+  // 'earlyCheckRows_' values, rather than building it for the whole stripe.
+  void checkDictionaryEarly() {
+    if (earlyCheckRows_ == 0 || !firstStripe_ ||
+        rows_.size() < earlyCheckRows_) {
+      return;
+    }
+    earlyCheckRows_ = 0;
+    if (tryAbandonDictionaries(false)) {
+      recordDictionaryEncodingHint(false);
+    }
+  }
+
   // NOTE: This should be called *before* clearing the rows_ buffer.
   bool shouldKeepDictionary() const {
     return rows_.size() != 0 &&
@@ -1075,6 +1124,9 @@ class StringColumnWriter : public BaseColumnWriter {
   // determine with the first stripe that the data is not fit for dictionary
   // encoding.
   bool useDictionaryEncoding_;
+  // Number of values in the first stripe after which the dictionary is
+  // checked early. 0 once checked or if not checked early.
+  uint32_t earlyCheckRows_;
   bool firstStripe_{true};
   DataBuffer<size_t> strideOffsets_;
 };
@@ -1086,7 +1138,9 @@ uint64_t StringColumnWriter::write(
   auto& decodedVector = localDecoded.get();
 
   if (useDictionaryEncoding_) {
-    return writeDict(decodedVector, ranges);
+    auto rawSize = writeDict(decodedVector, ranges);
+    checkDictionaryEarly();
+    return rawSize;
   } else {
     return writeDirect(decodedVector, ranges);
   }
@@ -1590,14 +1644,63 @@ class StructColumnWriter : public BaseColumnWriter {
       const RowVector* rowSlice,
       const Ranges& ranges,
       uint64_t nullCount);
+
+  // Writes the top level columns on the encoding executor of 'context_'.
+  // Each child encodes and compresses into its own streams. Returns the
+  // total raw size.
+  uint64_t writeChildrenInParallel(
+      folly::Executor& executor,
+      const RowVector* rowSlice,
+      const Ranges& ranges);
 };
 
+uint64_t StructColumnWriter::writeChildrenInParallel(
+    folly::Executor& executor,
+    const RowVector* rowSlice,
+    const Ranges& ranges) {
+  std::vector<folly::SemiFuture<uint64_t>> futures;
+  futures.reserve(children_.size());
+  for (size_t i = 0; i < children_.size(); ++i) {
+    auto [promise, future] = folly::makePromiseContract<uint64_t>();
+    executor.add([&, i, promise = std::move(promise)]() mutable {
+      promise.setTry(folly::makeTryWith([&]() {
+        return children_[i]->write(rowSlice->childAt(i), ranges);
+      }));
+    });
+    futures.push_back(std::move(future));
+  }
+  // All children must be done before returning since they refer to
+  // 'rowSlice' and 'ranges'.
+  uint64_t rawSize = 0;
+  std::exception_ptr error;
+  for (auto& future : futures) {
+    auto result = std::move(future).getTry();
+    if (result.hasException()) {
+      if (!error) {
+        error = result.exception().to_exception_ptr();
+      }
+    } else {
+      rawSize += result.value();
+    }
+  }
+  if (error) {
+    std::rethrow_exception(error);
+  }
+  return rawSize;
+}
+
 uint64_t StructColumnWriter::writeChildrenAndStats(
     const RowVector* rowSlice,
     const Ranges& ranges,
     uint64_t nullCount) {
   uint64_t rawSize = 0;
-  if (ranges.size() > 0) {
+  auto* executor = context_.encodingExecutor();
+  // Encrypted files are written serially since encrypters are not known to
+  // be thread-safe.
+  if (ranges.size() > 0 && executor && isRoot() && children_.size() > 1 &&
+      !context_.getEncryptionHandler().isEncrypted()) {
+    rawSize = writeChildrenInParallel(*executor, rowSlice, ranges);
+  } else if (ranges.size() > 0) {
     for (size_t i = 0; i < children_.size(); ++i) {
       rawSize += children_.at(i)->write(rowSlice->childAt(i), ranges);
     }
@@ -167,6 +167,32 @@ class BaseColumnWriter : public ColumnWriter {
     auto options = StatisticsBuilderOptions::fromConfig(context.getConfigs());
     indexStatsBuilder_ = StatisticsBuilder::create(*type.type, options);
     fileStatsBuilder_ = StatisticsBuilder::create(*type.type, options);
+    if (hasBloomFilter()) {
+      indexStatsBuilder_->enableBloomFilter();
+      indexBuilder_->setBloomFilterStream(
+          newStream(StreamKind::StreamKind_BLOOM_FILTER_UTF8));
+    }
+  }
+
+  // True if 'this' is a top level integer or string column listed in
+  // BLOOM_FILTER_COLS.
+  bool hasBloomFilter() const {
+    if (!type_.parent || type_.parent->parent) {
+      return false;
+    }
+    switch (type_.type->kind()) {
+      case TypeKind::TINYINT:
+      case TypeKind::SMALLINT:
+      case TypeKind::INTEGER:
+      case TypeKind::BIGINT:
+      case TypeKind::VARCHAR:
+        break;
+      default:
+        return false;
+    }
+    const auto& columns = getConfig(Config::BLOOM_FILTER_COLS);
+    return std::find(columns.begin(), columns.end(), type_.column) !=
+        columns.end();
   }
 
   uint64_t writeNulls(const VectorPtr& slice, const Ranges& ranges) {
@@ -243,7 +269,23 @@ class BaseColumnWriter : public ColumnWriter {
   virtual bool useDictionaryEncoding() const {
     return (sequence_ == 0 ||
             !context_.getConfig(Config::MAP_FLAT_DISABLE_DICT_ENCODING)) &&
-        !context_.isLowMemoryMode();
+        !context_.isLowMemoryMode() && dictionaryEncodingHint().value_or(true);
+  }
+
+  // Whether the writer of an earlier file kept the dictionary of this column,
+  // if known.
+  std::optional<bool> dictionaryEncodingHint() const {
+    auto* hints = context_.dictionaryEncodingHints();
+    if (!hints) {
+      return std::nullopt;
+    }
+    return hints->useDictionary({id_, sequence_});
+  }
+
+  void recordDictionaryEncodingHint(bool useDictionary) const {
+    if (auto* hints = context_.dictionaryEncodingHints()) {
+      hints->setUseDictionary({id_, sequence_}, useDictionary);
+    }
   }
 
   WriterContext::LocalDecodedVector decode(
@@ -0,0 +1,53 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#pragma once
+
+#include <mutex>
+#include <optional>
+#include <unordered_map>
+
+#include "velox/dwio/dwrf/common/Common.h"
+
+namespace facebook::velox::dwrf {
+
+// Whether dictionary encoding paid off for a column, as decided on the first
+// stripe of a file. Writers of further files of the same table that share the
+// hints start these columns with the same encoding, so that they do not build
+// dictionaries only to abandon them. Thread-safe.
+class DictionaryEncodingHints {
+ public:
+  std::optional<bool> useDictionary(const EncodingKey& key) const {
+    std::lock_guard<std::mutex> l(mutex_);
+    auto it = hints_.find(key);
+    if (it == hints_.end()) {
+      return std::nullopt;
+    }
+    return it->second;
+  }
+
+  void setUseDictionary(const EncodingKey& key, bool useDictionary) {
+    std::lock_guard<std::mutex> l(mutex_);
+    hints_[key] = useDictionary;
+  }
+
+ private:
+  mutable std::mutex mutex_;
+  std::unordered_map<EncodingKey, bool, EncodingKeyHash> hints_;
+};
+
+} // namespace facebook::velox::dwrf
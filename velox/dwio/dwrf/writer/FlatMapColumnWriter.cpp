@@ -116,6 +116,8 @@ void FlatMapColumnWriter<K>::reset() {
   BaseColumnWriter::reset();
   clearNodes();
   valueWriters_.clear();
+  batchWriters_.clear();
+  keysByPosition_.clear();
   rowsInStrides_.clear();
   rowsInCurrentStride_ = 0;
 }
@@ -133,12 +135,11 @@ KeyInfo getKeyInfo(StringView key) {
 }
 
 template <TypeKind K>
-ValueWriter& FlatMapColumnWriter<K>::getValueWriter(
-    KeyType key,
-    uint32_t inMapSize) {
+typename FlatMapColumnWriter<K>::ValueWriterEntry&
+FlatMapColumnWriter<K>::getValueWriter(KeyType key, uint32_t inMapSize) {
   auto it = valueWriters_.find(key);
   if (it != valueWriters_.end()) {
-    return it->second;
+    return *it;
   }
 
   if (valueWriters_.size() >= maxKeyCount_) {
@@ -172,7 +173,7 @@ ValueWriter& FlatMapColumnWriter<K>::getValueWriter(
   // Back fill current (partial) stride with not-in-map indication
   valueWriter.backfill(rowsInCurrentStride_);
 
-  return valueWriter;
+  return *it;
 }
 
 template <TypeKind K>
@@ -298,11 +299,23 @@ uint64_t FlatMapColumnWriter<K>::write(
   // particular value node.
   auto processMap = [&](uint64_t offsetIndex, const auto& keysVector) {
     auto begin = offsets[offsetIndex];
-    auto end = begin + lengths[offsetIndex];
+    auto length = lengths[offsetIndex];
+    if (length > keysByPosition_.size()) {
+      keysByPosition_.resize(length, nullptr);
+    }
 
-    for (auto i = begin; i < end; ++i) {
+    for (auto position = 0; position < length; ++position) {
+      auto i = begin + position;
       auto key = keysVector.valueAt(i);
-      ValueWriter& valueWriter = getValueWriter(key, ranges.size());
+      auto* entry = keysByPosition_[position];
+      if (!entry || !(entry->first == key)) {
+        entry = &getValueWriter(key, ranges.size());
+        keysByPosition_[position] = entry;
+      }
+      ValueWriter& valueWriter = entry->second;
+      if (valueWriter.startBatch(batch_, ranges.size())) {
+        batchWriters_.push_back(&valueWriter);
+      }
       valueWriter.addOffset(i, mapCount);
       auto keySize = updateKeyStatistics<K>(*keyFileStatsBuilder_, key);
       keyFileStatsBuilder_->increaseRawSize(keySize);
@@ -338,12 +351,10 @@ uint64_t FlatMapColumnWriter<K>::write(
     }
   };
 
-  // Reset all existing value writer buffers
-  // This includes existing value writers that are not used in this batch
-  // (their buffers will be set to empty buffers)
-  for (auto& pair : valueWriters_) {
-    pair.second.resizeBuffers(ranges.size());
-  }
+  // Value writers clear their buffers when they first get a key in this
+  // batch.
+  ++batch_;
+  batchWriters_.clear();
 
   // Fill value buffers per key
   uint64_t nullCount = 0;
@@ -368,10 +379,17 @@ uint64_t FlatMapColumnWriter<K>::write(
   }
 
   auto& values = mapSlice->mapValues();
-  // Write all accumulated buffers (this includes value writers that weren't
-  // used in this write. This is how we backfill unused value writers)
-  for (auto& pair : valueWriters_) {
-    rawSize += pair.second.writeBuffers(values, mapCount);
+  // Write the values of each key in this batch in one range set.
+  for (auto* valueWriter : batchWriters_) {
+    rawSize += valueWriter->writeBuffers(values, mapCount);
+  }
+  // The keys that are not in this batch are not in any of its maps.
+  if (batchWriters_.size() < valueWriters_.size()) {
+    for (auto& pair : valueWriters_) {
+      if (!pair.second.inBatch(batch_)) {
+        pair.second.backfill(mapCount);
+      }
+    }
   }
 
   if (nullCount > 0) {
@@ -89,7 +89,7 @@ class ValueStatisticsBuilder {
 // ValueWriter is used to write flat-map value columns.
 // It holds a column writer to write the values and an in-map encoder to
 // indicate if a value exists in the map (to distinguish null values from
-// not-in-map values)
+// not-in-map values). The in-map flags of a batch are kept as a bitmap.
 class ValueWriter {
  public:
   ValueWriter(
@@ -109,27 +109,28 @@ class ValueWriter {
             [this](auto& indexBuilder) {
               inMap_->recordPosition(indexBuilder);
             })},
-        inMapBuffer_{
-            context.getMemoryPool(MemoryUsageCategory::GENERAL),
-            inMapSize},
+        inMapBits_{context.getMemoryPool(MemoryUsageCategory::GENERAL)},
         ranges_{},
-        collectMapStats_{context.getConfig(Config::MAP_STATISTICS)} {}
+        collectMapStats_{context.getConfig(Config::MAP_STATISTICS)} {
+    resizeBuffers(inMapSize);
+  }
 
   void addOffset(uint64_t offset, uint64_t inMapIndex) {
-    if (UNLIKELY(inMapBuffer_[inMapIndex])) {
+    if (UNLIKELY(bits::isBitSet(inMapBits_.data(), inMapIndex))) {
       DWIO_RAISE("Duplicate key in map");
     }
 
     ranges_.add(offset, offset + 1);
-    inMapBuffer_[inMapIndex] = 1;
+    bits::setBit(inMapBits_.data(), inMapIndex);
   }
 
   uint64_t writeBuffers(const VectorPtr& values, uint32_t mapCount) {
     if (mapCount) {
-      inMap_->add(inMapBuffer_.data(), Ranges::of(0, mapCount), nullptr);
+      inMap_->addBits(
+          inMapBits_.data(), Ranges::of(0, mapCount), nullptr, false);
     }
 
-    if (values) {
+    if (values && ranges_.size() > 0) {
       return columnWriter_->write(values, ranges_);
     }
     return 0;
@@ -140,9 +141,23 @@ class ValueWriter {
       return;
     }
 
-    inMapBuffer_.reserve(count);
-    std::memset(inMapBuffer_.data(), 0, count);
-    inMap_->add(inMapBuffer_.data(), Ranges::of(0, count), nullptr);
+    resizeBuffers(count);
+    inMap_->addBits(inMapBits_.data(), Ranges::of(0, count), nullptr, false);
+  }
+
+  // Clears the buffers for a batch of 'inMapSize' maps the first time this is
+  // called for 'batch'. Returns true if this was the first call for 'batch'.
+  bool startBatch(uint64_t batch, size_t inMapSize) {
+    if (batch_ == batch) {
+      return false;
+    }
+    batch_ = batch;
+    resizeBuffers(inMapSize);
+    return true;
+  }
+
+  bool inBatch(uint64_t batch) const {
+    return batch_ == batch;
   }
 
   uint32_t getSequence() const {
@@ -171,8 +186,9 @@ class ValueWriter {
   }
 
   void resizeBuffers(size_t inMap) {
-    inMapBuffer_.reserve(inMap);
-    std::memset(inMapBuffer_.data(), 0, inMap);
+    const auto numWords = bits::nwords(inMap);
+    inMapBits_.reserve(numWords);
+    std::memset(inMapBits_.data(), 0, numWords * sizeof(uint64_t));
     ranges_.clear();
   }
 
@@ -181,9 +197,11 @@ class ValueWriter {
   const proto::KeyInfo keyInfo_;
   std::unique_ptr<ByteRleEncoder> inMap_;
   std::unique_ptr<BaseColumnWriter> columnWriter_;
-  dwio::common::DataBuffer<char> inMapBuffer_;
+  dwio::common::DataBuffer<uint64_t> inMapBits_;
   Ranges ranges_;
   const bool collectMapStats_;
+  // The last batch of FlatMapColumnWriter::write() that had this key.
+  uint64_t batch_{0};
 };
 
 namespace {
@@ -246,10 +264,11 @@ class FlatMapColumnWriter : public BaseColumnWriter {
 
  private:
   using KeyType = typename TypeTraits<K>::NativeType;
+  using ValueWriterEntry = std::pair<const KeyType, ValueWriter>;
 
   void setEncoding(proto::ColumnEncoding& encoding) const override;
 
-  ValueWriter& getValueWriter(KeyType key, uint32_t inMapSize);
+  ValueWriterEntry& getValueWriter(KeyType key, uint32_t inMapSize);
 
   void clearNodes();
 
@@ -264,6 +283,18 @@ class FlatMapColumnWriter : public BaseColumnWriter {
   // Captures current row count for current (incomplete) stride
   size_t rowsInCurrentStride_{0};
 
+  // Number of the current write() for telling which value writers have keys
+  // in the current batch.
+  uint64_t batch_{0};
+
+  // The value writers with keys in the current batch.
+  std::vector<ValueWriter*> batchWriters_;
+
+  // The value writer for the key at each position of the last map that had
+  // a key at the position. Maps tend to have the same keys in the same order,
+  // so comparing with these saves most hash lookups.
+  std::vector<ValueWriterEntry*> keysByPosition_;
+
   // Remember key and value types. Needed for constructing value writers
   const dwio::common::TypeWithId& keyType_;
   const dwio::common::TypeWithId& valueType_;
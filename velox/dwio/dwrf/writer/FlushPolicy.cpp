@@ -72,6 +72,104 @@ FlushDecision StaticBudgetFlushPolicy::shouldFlushDictionary(
           .getCurrentBytes());
 }
 
+WriterMemoryCoordinator::WriterMemoryCoordinator(
+    memory::MemoryPool& pool,
+    double highUsageRatio,
+    double lowUsageRatio)
+    : pool_{pool},
+      highUsageRatio_{highUsageRatio},
+      lowUsageRatio_{lowUsageRatio} {
+  DWIO_ENSURE_LE(lowUsageRatio_, highUsageRatio_);
+}
+
+int32_t WriterMemoryCoordinator::addWriter() {
+  std::lock_guard<std::mutex> l(mutex_);
+  auto id = nextId_++;
+  usage_[id] = 0;
+  return id;
+}
+
+void WriterMemoryCoordinator::removeWriter(int32_t id) {
+  std::lock_guard<std::mutex> l(mutex_);
+  usage_.erase(id);
+}
+
+void WriterMemoryCoordinator::updateUsage(int32_t id, int64_t bytes) {
+  std::lock_guard<std::mutex> l(mutex_);
+  usage_[id] = bytes;
+}
+
+bool WriterMemoryCoordinator::isLargestUnderPressure(int32_t id) const {
+  if (usageRatio() < highUsageRatio_) {
+    return false;
+  }
+  std::lock_guard<std::mutex> l(mutex_);
+  auto it = usage_.find(id);
+  if (it == usage_.end() || it->second == 0) {
+    return false;
+  }
+  for (const auto& [otherId, bytes] : usage_) {
+    // Ties go to the lower id so that only one writer flushes.
+    if (bytes > it->second || (bytes == it->second && otherId < id)) {
+      return false;
+    }
+  }
+  return true;
+}
+
+bool WriterMemoryCoordinator::hasSpareMemory() const {
+  return usageRatio() < lowUsageRatio_;
+}
+
+double WriterMemoryCoordinator::usageRatio() const {
+  return static_cast<double>(pool_.getCurrentBytes()) / pool_.getCap();
+}
+
+MemoryAwareFlushPolicy::MemoryAwareFlushPolicy(
+    std::shared_ptr<WriterMemoryCoordinator> coordinator,
+    uint64_t targetStripeSize,
+    uint64_t maxStripeSize,
+    uint64_t dictionarySizeThreshold)
+    : coordinator_{std::move(coordinator)},
+      targetStripeSize_{targetStripeSize},
+      maxStripeSize_{std::max(maxStripeSize, targetStripeSize)},
+      staticBudgetFlushPolicy_{targetStripeSize, dictionarySizeThreshold},
+      id_{coordinator_->addWriter()} {}
+
+MemoryAwareFlushPolicy::~MemoryAwareFlushPolicy() {
+  onClose();
+}
+
+bool MemoryAwareFlushPolicy::shouldFlush(
+    const dwio::common::StripeProgress& stripeProgress) {
+  DWIO_ENSURE(id_.has_value(), "Flush policy used after close");
+  coordinator_->updateUsage(id_.value(), stripeProgress.totalMemoryUsage);
+  if (stripeProgress.stripeSizeEstimate == 0) {
+    return false;
+  }
+  if (coordinator_->isLargestUnderPressure(id_.value())) {
+    return true;
+  }
+  const auto threshold =
+      coordinator_->hasSpareMemory() ? maxStripeSize_ : targetStripeSize_;
+  return stripeProgress.stripeSizeEstimate >= threshold;
+}
+
+FlushDecision MemoryAwareFlushPolicy::shouldFlushDictionary(
+    bool stripeProgressDecision,
+    bool overMemoryBudget,
+    const WriterContext& context) {
+  return staticBudgetFlushPolicy_.shouldFlushDictionary(
+      stripeProgressDecision, overMemoryBudget, context);
+}
+
+void MemoryAwareFlushPolicy::onClose() {
+  if (id_.has_value()) {
+    coordinator_->removeWriter(id_.value());
+    id_.reset();
+  }
+}
+
 RowsPerStripeFlushPolicy::RowsPerStripeFlushPolicy(
     std::vector<uint64_t> rowsPerStripe)
     : rowsPerStripe_{std::move(rowsPerStripe)} {
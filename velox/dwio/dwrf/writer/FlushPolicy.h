@@ -17,6 +17,9 @@
 #pragma once
 
 #include <cstdint>
+#include <mutex>
+#include <folly/container/F14Map.h>
+#include "velox/common/memory/Memory.h"
 #include "velox/dwio/common/FlushPolicy.h"
 #include "velox/dwio/dwrf/writer/WriterContext.h"
 
@@ -151,6 +154,78 @@ class RowThresholdFlushPolicy : public DWRFFlushPolicy {
   uint64_t rowCountThreshold_;
 };
 
+// Tracks the memory of the writers whose pools are children of 'pool' so that
+// their MemoryAwareFlushPolicy can flush the largest writers first when
+// 'pool' is near its cap. Shared by the flush policies of the writers.
+class WriterMemoryCoordinator {
+ public:
+  // 'highUsageRatio' is the fraction of the cap of 'pool' above which the
+  // largest writer flushes. Below 'lowUsageRatio' the writers may grow their
+  // stripes.
+  explicit WriterMemoryCoordinator(
+      memory::MemoryPool& pool,
+      double highUsageRatio = 0.8,
+      double lowUsageRatio = 0.5);
+
+  // Adds a writer and returns its id.
+  int32_t addWriter();
+
+  void removeWriter(int32_t id);
+
+  // Records 'bytes' as the memory usage of writer 'id'.
+  void updateUsage(int32_t id, int64_t bytes);
+
+  // True if 'pool' is over the high usage ratio and writer 'id' uses the most
+  // memory of the writers.
+  bool isLargestUnderPressure(int32_t id) const;
+
+  // True if 'pool' is under the low usage ratio.
+  bool hasSpareMemory() const;
+
+ private:
+  double usageRatio() const;
+
+  memory::MemoryPool& pool_;
+  const double highUsageRatio_;
+  const double lowUsageRatio_;
+  mutable std::mutex mutex_;
+  int32_t nextId_{0};
+  folly::F14FastMap<int32_t, int64_t> usage_;
+};
+
+// Sizes stripes by the memory pressure on the pool shared by many writers.
+// A stripe is flushed at 'targetStripeSize', the size that suits readers,
+// unless the shared pool has spare memory, in which case it may grow to
+// 'maxStripeSize'. When the pool is near its cap, the writer using the most
+// memory flushes first, regardless of its stripe size. Dictionaries are
+// handled as in StaticBudgetFlushPolicy.
+class MemoryAwareFlushPolicy : public DWRFFlushPolicy {
+ public:
+  MemoryAwareFlushPolicy(
+      std::shared_ptr<WriterMemoryCoordinator> coordinator,
+      uint64_t targetStripeSize,
+      uint64_t maxStripeSize,
+      uint64_t dictionarySizeThreshold);
+  ~MemoryAwareFlushPolicy() override;
+
+  bool shouldFlush(const dwio::common::StripeProgress& stripeProgress) override;
+
+  FlushDecision shouldFlushDictionary(
+      bool stripeProgressDecision,
+      bool overMemoryBudget,
+      const WriterContext& context) override;
+
+  void onClose() override;
+
+ private:
+  const std::shared_ptr<WriterMemoryCoordinator> coordinator_;
+  const uint64_t targetStripeSize_;
+  const uint64_t maxStripeSize_;
+  StaticBudgetFlushPolicy staticBudgetFlushPolicy_;
+  // Id of 'this' in 'coordinator_'. Unset after onClose().
+  std::optional<int32_t> id_;
+};
+
 class LambdaFlushPolicy : public DWRFFlushPolicy {
  public:
   explicit LambdaFlushPolicy(std::function<bool()> lambda) : lambda_{lambda} {}
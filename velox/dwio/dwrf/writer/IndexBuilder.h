@@ -46,6 +46,18 @@ class IndexBuilder : public PositionRecorder {
     writer.toProto(*stats);
     *index_.add_entry() = entry_;
     entry_.Clear();
+    if (bloomFilterOut_) {
+      auto hashes = writer.bloomFilterHashes();
+      DWIO_ENSURE_NOT_NULL(hashes, "Bloom filter hashes are not collected");
+      toBloomFilterProto(*hashes, *bloomFilterIndex_.add_bloomfilter());
+    }
+  }
+
+  // Makes flush() also write the bloom filter of each entry to 'out'. The
+  // filter has the hashes collected by the StatisticsBuilder given to
+  // addEntry(), which must have bloom filters enabled.
+  void setBloomFilterStream(std::unique_ptr<BufferedOutputStream> out) {
+    bloomFilterOut_ = std::move(out);
   }
 
   virtual size_t getEntrySize() const {
@@ -60,6 +72,11 @@ class IndexBuilder : public PositionRecorder {
     out_->flush();
     index_.Clear();
     entry_.Clear();
+    if (bloomFilterOut_) {
+      bloomFilterIndex_.SerializeToZeroCopyStream(bloomFilterOut_.get());
+      bloomFilterOut_->flush();
+      bloomFilterIndex_.Clear();
+    }
   }
 
   void capturePresentStreamOffset() {
@@ -88,6 +105,8 @@ class IndexBuilder : public PositionRecorder {
   proto::RowIndex index_;
   proto::RowIndexEntry entry_;
   std::optional<int32_t> presentStreamOffset_;
+  std::unique_ptr<BufferedOutputStream> bloomFilterOut_;
+  proto::BloomFilterIndex bloomFilterIndex_;
 
   proto::RowIndexEntry* getEntry(int32_t index) {
     if (index < 0) {
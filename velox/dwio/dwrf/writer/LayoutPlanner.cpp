@@ -50,10 +50,10 @@ void LayoutPlanner::iterateDataStreams(
 }
 
 void LayoutPlanner::plan() {
-  // place index before data
+  // place index and bloom filters before data
   auto iter =
       std::partition(streams_.begin(), streams_.end(), [](auto& stream) {
-        return stream.first->kind() == StreamKind::StreamKind_ROW_INDEX;
+        return isIndexStream(stream.first->kind());
       });
   indexCount_ = iter - streams_.begin();
 
@@ -18,6 +18,7 @@
 
 #include <velox/common/base/Exceptions.h>
 #include "velox/dwio/dwrf/common/Config.h"
+#include "velox/dwio/dwrf/common/RowGroupBloomFilter.h"
 #include "velox/dwio/dwrf/common/Statistics.h"
 #include "velox/dwio/dwrf/common/wrap/dwrf-proto-wrapper.h"
 #include "velox/type/Type.h"
@@ -120,6 +121,18 @@ class StatisticsBuilder : public virtual dwio::common::ColumnStatistics {
     rawSize_.reset();
   }
 
+  // Makes the integer and string builders collect the hashes of the added
+  // values for a row group bloom filter. The hashes are not merged.
+  void enableBloomFilter() {
+    bloomFilterHashes_.emplace();
+  }
+
+  // Returns the hashes of the values added since reset(), nullptr if
+  // enableBloomFilter() was not called.
+  const std::vector<uint64_t>* bloomFilterHashes() const {
+    return bloomFilterHashes_ ? &bloomFilterHashes_.value() : nullptr;
+  }
+
   /*
    * Merge stats of same type. This is used in writer to aggregate file level
    * stats.
@@ -131,6 +144,9 @@ class StatisticsBuilder : public virtual dwio::common::ColumnStatistics {
    */
   virtual void reset() {
     init();
+    if (bloomFilterHashes_) {
+      bloomFilterHashes_->clear();
+    }
   }
 
   /*
@@ -159,7 +175,15 @@ class StatisticsBuilder : public virtual dwio::common::ColumnStatistics {
   }
 
  protected:
+  template <typename T>
+  void addBloomFilterHash(T value) {
+    if (bloomFilterHashes_) {
+      bloomFilterHashes_->push_back(bloomFilterHash(value));
+    }
+  }
+
   StatisticsBuilderOptions options_;
+  std::optional<std::vector<uint64_t>> bloomFilterHashes_;
 };
 
 class BooleanStatisticsBuilder : public StatisticsBuilder,
@@ -206,6 +230,7 @@ class IntegerStatisticsBuilder : public StatisticsBuilder,
 
   void addValues(int64_t value, uint64_t count = 1) {
     increaseValueCount(count);
+    addBloomFilterHash(value);
     if (min_.has_value() && value < min_.value()) {
       min_ = value;
     }
@@ -311,6 +336,7 @@ class StringStatisticsBuilder : public StatisticsBuilder,
     // differently.
     auto isSelfEmpty = isEmpty(*this);
     increaseValueCount(count);
+    addBloomFilterHash(value);
     if (isSelfEmpty) {
       min_ = value;
       max_ = value;
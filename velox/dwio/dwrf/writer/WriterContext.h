@@ -16,10 +16,14 @@
 
 #pragma once
 
+#include <mutex>
+
+#include <folly/Executor.h>
 #include "velox/common/base/GTestMacros.h"
 #include "velox/common/time/CpuWallTimer.h"
 #include "velox/dwio/dwrf/common/Compression.h"
 #include "velox/dwio/dwrf/common/EncoderUtil.h"
+#include "velox/dwio/dwrf/writer/DictionaryEncodingHints.h"
 #include "velox/dwio/dwrf/writer/IndexBuilder.h"
 #include "velox/dwio/dwrf/writer/IntegerDictionaryEncoder.h"
 #include "velox/dwio/dwrf/writer/RatioTracker.h"
@@ -70,8 +74,9 @@ class WriterContext : public CompressionBufferPool {
     }
     validateConfigs();
     VLOG(1) << fmt::format("Compression config: {}", compression);
-    compressionBuffer_ = std::make_unique<dwio::common::DataBuffer<char>>(
-        generalPool_, compressionBlockSize + PAGE_HEADER_SIZE);
+    compressionBuffers_.push_back(
+        std::make_unique<dwio::common::DataBuffer<char>>(
+            generalPool_, compressionBlockSize + PAGE_HEADER_SIZE));
   }
 
   bool hasStream(const DwrfStreamIdentifier& stream) const {
@@ -98,6 +103,7 @@ class WriterContext : public CompressionBufferPool {
   // flush policy evaluation and would be more accurate after flush.
   std::unique_ptr<BufferedOutputStream> newStream(
       const DwrfStreamIdentifier& stream) {
+    std::lock_guard<std::mutex> l(streamsMutex_);
     DWIO_ENSURE(
         !hasStream(stream), "Stream already exists ", stream.toString());
     streams_.emplace(
@@ -130,7 +136,13 @@ class WriterContext : public CompressionBufferPool {
       dwio::common::CompressionKind kind,
       DataBufferHolder& holder,
       const dwio::common::encryption::Encrypter* encrypter = nullptr) {
-    return createCompressor(kind, *this, holder, *config_, encrypter);
+    return createCompressor(
+        kind,
+        *this,
+        holder,
+        *config_,
+        encrypter,
+        compressionExecutor_.get());
   }
 
   template <typename T>
@@ -138,6 +150,7 @@ class WriterContext : public CompressionBufferPool {
       const EncodingKey& ek,
       velox::memory::MemoryPool& dictionaryPool,
       velox::memory::MemoryPool& generalPool) {
+    std::lock_guard<std::mutex> l(dictEncodersMutex_);
     auto result = dictEncoders_.find(ek);
     if (result == dictEncoders_.end()) {
       auto emplaceResult = dictEncoders_.emplace(
@@ -169,9 +182,10 @@ class WriterContext : public CompressionBufferPool {
   }
 
   void suppressStream(const DwrfStreamIdentifier& stream) {
-    DWIO_ENSURE(hasStream(stream));
-    auto& collector = streams_.at(stream);
-    collector.suppress();
+    std::lock_guard<std::mutex> l(streamsMutex_);
+    auto it = streams_.find(stream);
+    DWIO_ENSURE(it != streams_.end());
+    it->second.suppress();
   }
 
   bool isStreamPaged(uint32_t nodeId) const {
@@ -296,16 +310,24 @@ class WriterContext : public CompressionBufferPool {
 
   std::unique_ptr<dwio::common::DataBuffer<char>> getBuffer(
       uint64_t size) override {
-    DWIO_ENSURE_NOT_NULL(compressionBuffer_);
-    DWIO_ENSURE_GE(compressionBuffer_->size(), size);
-    return std::move(compressionBuffer_);
+    std::lock_guard<std::mutex> l(poolMutex_);
+    if (compressionBuffers_.empty()) {
+      // Column writers that run in parallel each hold a buffer.
+      compressionBuffers_.push_back(
+          std::make_unique<dwio::common::DataBuffer<char>>(
+              generalPool_, compressionBlockSize + PAGE_HEADER_SIZE));
+    }
+    auto buffer = std::move(compressionBuffers_.back());
+    compressionBuffers_.pop_back();
+    DWIO_ENSURE_GE(buffer->size(), size);
+    return buffer;
   }
 
   void returnBuffer(
       std::unique_ptr<dwio::common::DataBuffer<char>> buffer) override {
     DWIO_ENSURE_NOT_NULL(buffer);
-    DWIO_ENSURE(!compressionBuffer_);
-    compressionBuffer_ = std::move(buffer);
+    std::lock_guard<std::mutex> l(poolMutex_);
+    compressionBuffers_.push_back(std::move(buffer));
   }
 
   void incrementNodeSize(uint32_t node, uint64_t size) {
@@ -414,19 +436,67 @@ class WriterContext : public CompressionBufferPool {
     return LocalDecodedVector{*this};
   }
 
-  SelectivityVector& getSharedSelectivityVector(velox::vector_size_t size) {
-    if (UNLIKELY(!selectivityVector_)) {
-      selectivityVector_ = std::make_unique<velox::SelectivityVector>(size);
-    } else {
-      selectivityVector_->resize(size);
+  class LocalSelectivityVector {
+   public:
+    LocalSelectivityVector(WriterContext& context, vector_size_t size)
+        : context_(context), vector_(context_.getSelectivityVector(size)) {}
+
+    LocalSelectivityVector(LocalSelectivityVector&& other) noexcept
+        : context_{other.context_}, vector_{std::move(other.vector_)} {}
+
+    LocalSelectivityVector& operator=(LocalSelectivityVector&& other) = delete;
+
+    ~LocalSelectivityVector() {
+      if (vector_) {
+        context_.releaseSelectivityVector(std::move(vector_));
+      }
     }
-    return *selectivityVector_;
+
+    SelectivityVector& get() {
+      return *vector_;
+    }
+
+   private:
+    WriterContext& context_;
+    std::unique_ptr<velox::SelectivityVector> vector_;
+  };
+
+  LocalSelectivityVector getLocalSelectivityVector(vector_size_t size) {
+    return LocalSelectivityVector{*this, size};
+  }
+
+  // Executor for writing the columns of a batch in parallel. nullptr if the
+  // columns are written on the calling thread.
+  folly::Executor* FOLLY_NULLABLE encodingExecutor() const {
+    return encodingExecutor_.get();
+  }
+
+  void setEncodingExecutor(std::shared_ptr<folly::Executor> executor) {
+    encodingExecutor_ = std::move(executor);
+  }
+
+  // Dictionary encoding decisions shared with the writers of other files.
+  // nullptr if not shared.
+  DictionaryEncodingHints* FOLLY_NULLABLE dictionaryEncodingHints() const {
+    return dictionaryEncodingHints_.get();
+  }
+
+  void setDictionaryEncodingHints(
+      std::shared_ptr<DictionaryEncodingHints> hints) {
+    dictionaryEncodingHints_ = std::move(hints);
+  }
+
+  // Executor for compressing the pages of streams in the background. Applies
+  // to streams created after it is set.
+  void setCompressionExecutor(std::shared_ptr<folly::Executor> executor) {
+    compressionExecutor_ = std::move(executor);
   }
 
  private:
   void validateConfigs() const;
 
   std::unique_ptr<velox::DecodedVector> getDecodedVector() {
+    std::lock_guard<std::mutex> l(poolMutex_);
     if (decodedVectorPool_.empty()) {
       return std::make_unique<velox::DecodedVector>();
     }
@@ -436,9 +506,33 @@ class WriterContext : public CompressionBufferPool {
   }
 
   void releaseDecodedVector(std::unique_ptr<velox::DecodedVector>&& vector) {
+    std::lock_guard<std::mutex> l(poolMutex_);
     decodedVectorPool_.push_back(std::move(vector));
   }
 
+  std::unique_ptr<velox::SelectivityVector> getSelectivityVector(
+      vector_size_t size) {
+    std::unique_ptr<velox::SelectivityVector> vector;
+    {
+      std::lock_guard<std::mutex> l(poolMutex_);
+      if (!selectivityVectorPool_.empty()) {
+        vector = std::move(selectivityVectorPool_.back());
+        selectivityVectorPool_.pop_back();
+      }
+    }
+    if (!vector) {
+      return std::make_unique<velox::SelectivityVector>(size);
+    }
+    vector->resize(size);
+    return vector;
+  }
+
+  void releaseSelectivityVector(
+      std::unique_ptr<velox::SelectivityVector>&& vector) {
+    std::lock_guard<std::mutex> l(poolMutex_);
+    selectivityVectorPool_.push_back(std::move(vector));
+  }
+
   std::shared_ptr<const Config> config_;
   std::unique_ptr<memory::ScopedMemoryPool> scopedPool_;
   memory::MemoryPool& pool_;
@@ -460,11 +554,23 @@ class WriterContext : public CompressionBufferPool {
   std::function<std::unique_ptr<IndexBuilder>(
       std::unique_ptr<BufferedOutputStream>)>
       indexBuilderFactory_;
-  std::unique_ptr<dwio::common::DataBuffer<char>> compressionBuffer_;
+  // Column writers may run in parallel on 'encodingExecutor_'. The pools
+  // below are then shared between threads and streams and dictionary
+  // encoders may be added concurrently, e.g. by flat map writers.
+  std::shared_ptr<folly::Executor> encodingExecutor_;
+  std::shared_ptr<folly::Executor> compressionExecutor_;
+  std::shared_ptr<DictionaryEncodingHints> dictionaryEncodingHints_;
+  std::mutex poolMutex_;
+  std::mutex streamsMutex_;
+  std::mutex dictEncodersMutex_;
+  // Free buffers for compressing pages.
+  std::vector<std::unique_ptr<dwio::common::DataBuffer<char>>>
+      compressionBuffers_;
   // A pool of reusable DecodedVectors.
   std::vector<std::unique_ptr<velox::DecodedVector>> decodedVectorPool_;
-  // Reusable SelectivityVector
-  std::unique_ptr<velox::SelectivityVector> selectivityVector_;
+  // A pool of reusable SelectivityVectors.
+  std::vector<std::unique_ptr<velox::SelectivityVector>>
+      selectivityVectorPool_;
 
   std::unique_ptr<encryption::EncryptionHandler> handler_;
   folly::F14FastMap<uint32_t, uint64_t> nodeSize;
@@ -119,6 +119,17 @@ struct WriterOptionsShared {
   std::shared_ptr<encryption::EncryptionSpecification> encryptionSpec;
   std::shared_ptr<dwio::common::encryption::EncrypterFactory> encrypterFactory;
   int64_t memoryBudget = std::numeric_limits<int64_t>::max();
+  // If set, the top level columns of each batch are encoded and compressed
+  // in parallel on this executor. Must not be the executor the writer runs
+  // on, since the writer blocks until the columns are written.
+  std::shared_ptr<folly::Executor> encodingExecutor;
+  // If set, pages are compressed in the background on this executor while
+  // the writer keeps encoding. See Config::COMPRESSION_MAX_PENDING_PAGES.
+  // Must not be 'encodingExecutor'.
+  std::shared_ptr<folly::Executor> compressionExecutor;
+  // Dictionary encoding decisions to share between the writers of the files
+  // of a table. See DictionaryEncodingHints.
+  std::shared_ptr<DictionaryEncodingHints> dictionaryEncodingHints;
 };
 
 class WriterShared : public WriterBase {
@@ -144,6 +155,9 @@ class WriterShared : public WriterBase {
                 folly::to<std::string>(folly::Random::rand64())),
             std::min(options.memoryBudget, parentPool.getCap())),
         std::move(handler));
+    getContext().setEncodingExecutor(options.encodingExecutor);
+    getContext().setCompressionExecutor(options.compressionExecutor);
+    getContext().setDictionaryEncodingHints(options.dictionaryEncodingHints);
     if (!options.flushPolicyFactory) {
       auto& context = getContext();
       flushPolicy_ = std::make_unique<DefaultFlushPolicy>(
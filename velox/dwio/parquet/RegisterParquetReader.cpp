@@ -24,6 +24,10 @@ void registerParquetReaderFactory(ParquetReaderType parquetReaderType) {
       dwio::common::registerReaderFactory(
           std::make_shared<duckdb_reader::ParquetReaderFactory>());
       break;
+    case ParquetReaderType::NATIVE:
+      dwio::common::registerReaderFactory(
+          std::make_shared<ParquetReaderFactory>());
+      break;
     default:
       VELOX_UNSUPPORTED(
           "Velox does not support ParquetReaderType ", parquetReaderType);
@@ -172,6 +172,23 @@ void toDuckDbFilter(
       buildConjunctOrFilter(colIdx, type, values, filters);
       break;
     }
+    case common::FilterKind::kBigintValuesUsingBloomFilter: {
+      // Only the range is pushed down. This passes more rows than the Bloom
+      // filter but the filter comes from a join that checks the keys anyway.
+      auto bloomFilter =
+          static_cast<common::BigintValuesUsingBloomFilter*>(filter);
+      filters.PushFilter(
+          colIdx,
+          constantFilter(
+              ::duckdb::ExpressionType::COMPARE_GREATERTHANOREQUALTO,
+              makeValue(type, bloomFilter->min())));
+      filters.PushFilter(
+          colIdx,
+          constantFilter(
+              ::duckdb::ExpressionType::COMPARE_LESSTHANOREQUALTO,
+              makeValue(type, bloomFilter->max())));
+      break;
+    }
     case common::FilterKind::kAlwaysFalse:
     case common::FilterKind::kAlwaysTrue:
     case common::FilterKind::kIsNull:
@@ -211,7 +228,9 @@ ParquetRowReader::ParquetRowReader(
     memory::MemoryPool& pool)
     : reader_(std::move(reader)),
       pool_(pool),
-      scanSpec_{options.getScanSpec()} {
+      scanSpec_{options.getScanSpec()},
+      executor_{options.getDecodingExecutor()},
+      rowGroupsAhead_{executor_ ? options.getRowGroupsAhead() : 0} {
   auto& selector = *options.getSelector();
   rowType_ = selector.buildSelectedReordered();
   duckdbRowType_.reserve(rowType_->size());
@@ -219,8 +238,7 @@ ParquetRowReader::ParquetRowReader(
   auto& projection = selector.getProjection();
   VELOX_CHECK_EQ(rowType_->size(), projection.size());
 
-  std::vector<::duckdb::column_t> columnIds;
-  columnIds.reserve(rowType_->size());
+  columnIds_.reserve(rowType_->size());
   for (uint64_t i = 0; i < projection.size(); i++) {
     uint64_t columnId = projection[i].column;
     VELOX_CHECK_LT(
@@ -228,7 +246,7 @@ ParquetRowReader::ParquetRowReader(
         reader_->names.size(),
         "Unexpected column name: {}",
         projection[i].name);
-    columnIds.push_back(columnId);
+    columnIds_.push_back(columnId);
 
     // DuckDB ParquetReader::return_types contains all columns present in the
     // file.
@@ -244,20 +262,43 @@ ParquetRowReader::ParquetRowReader(
     }
   }
 
-  std::vector<idx_t> groups;
   for (idx_t i = 0; i < reader_->NumRowGroups(); i++) {
     auto groupOffset = reader_->GetFileMetadata()->row_groups[i].file_offset;
     if (groupOffset >= options.getOffset() &&
         groupOffset < (options.getLength() + options.getOffset())) {
-      groups.push_back(i);
+      rowGroups_.push_back(i);
     }
   }
 
-  reader_->InitializeScan(
-      state_, std::move(columnIds), std::move(groups), &filters_);
+  if (rowGroupsAhead_ > 0) {
+    scheduleRowGroups();
+  } else {
+    reader_->InitializeScan(state_, columnIds_, rowGroups_, &filters_);
+  }
+}
+
+ParquetRowReader::~ParquetRowReader() {
+  // The pending reads refer to 'this'.
+  for (auto& rowGroup : pendingRowGroups_) {
+    rowGroup.wait();
+  }
 }
 
 uint64_t ParquetRowReader::next(uint64_t /*size*/, velox::VectorPtr& result) {
+  if (rowGroupsAhead_ > 0) {
+    while (nextBatch_ >= batches_.size()) {
+      if (pendingRowGroups_.empty()) {
+        return 0;
+      }
+      batches_ = std::move(pendingRowGroups_.front()).get();
+      pendingRowGroups_.pop_front();
+      nextBatch_ = 0;
+      scheduleRowGroups();
+    }
+    result = std::move(batches_[nextBatch_++]);
+    return result->size();
+  }
+
   ::duckdb::DataChunk output;
   // TODO: We are using the default duckdb allocator which uses Velox's default
   // memory manager, not the one specified in the ReaderOptions.
@@ -266,32 +307,63 @@ uint64_t ParquetRowReader::next(uint64_t /*size*/, velox::VectorPtr& result) {
   reader_->Scan(state_, output);
 
   if (output.size() > 0) {
-    std::vector<VectorPtr> columns;
-    columns.resize(output.data.size());
-    for (auto& spec : scanSpec_->children()) {
-      if (spec->isConstant()) {
-        columns[spec->channel()] =
-            BaseVector::wrapInConstant(output.size(), 0, spec->constantValue());
-      } else if (spec->projectOut()) {
-        auto index = rowType_->getChildIdx(spec->fieldName());
-        columns[spec->channel()] = duckdb::toVeloxVector(
-            output.size(),
-            output.data[index],
-            rowType_->childAt(index),
-            &pool_);
-      }
+    result = toRowVector(output);
+  }
+
+  return output.size();
+}
+
+RowVectorPtr ParquetRowReader::toRowVector(::duckdb::DataChunk& output) {
+  std::vector<VectorPtr> columns;
+  columns.resize(output.data.size());
+  for (auto& spec : scanSpec_->children()) {
+    if (spec->isConstant()) {
+      columns[spec->channel()] =
+          BaseVector::wrapInConstant(output.size(), 0, spec->constantValue());
+    } else if (spec->projectOut()) {
+      auto index = rowType_->getChildIdx(spec->fieldName());
+      columns[spec->channel()] = duckdb::toVeloxVector(
+          output.size(), output.data[index], rowType_->childAt(index), &pool_);
     }
+  }
 
-    result = std::make_shared<RowVector>(
-        &pool_,
-        rowType_,
-        BufferPtr(nullptr),
-        output.size(),
-        columns,
-        std::nullopt);
+  return std::make_shared<RowVector>(
+      &pool_,
+      rowType_,
+      BufferPtr(nullptr),
+      output.size(),
+      columns,
+      std::nullopt);
+}
+
+std::vector<RowVectorPtr> ParquetRowReader::readRowGroup(idx_t group) {
+  // Each row group has its own scan state and file handle. The reads of the
+  // InputStream are positional, so that row groups can be scanned
+  // concurrently.
+  ::duckdb::ParquetReaderScanState state;
+  reader_->InitializeScan(state, columnIds_, {group}, &filters_);
+
+  std::vector<RowVectorPtr> batches;
+  for (;;) {
+    // Each chunk has its own buffers, which the Velox vectors of the batch
+    // keep alive.
+    ::duckdb::DataChunk output;
+    output.Initialize(duckdb::getDefaultAllocator(), duckdbRowType_);
+    reader_->Scan(state, output);
+    if (output.size() == 0) {
+      return batches;
+    }
+    batches.push_back(toRowVector(output));
   }
+}
 
-  return output.size();
+void ParquetRowReader::scheduleRowGroups() {
+  while (pendingRowGroups_.size() < rowGroupsAhead_ &&
+         nextRowGroup_ < rowGroups_.size()) {
+    auto group = rowGroups_[nextRowGroup_++];
+    pendingRowGroups_.push_back(folly::via(
+        executor_.get(), [this, group]() { return readRowGroup(group); }));
+  }
 }
 
 void ParquetRowReader::updateRuntimeStats(
@@ -16,6 +16,10 @@
 
 #pragma once
 
+#include <deque>
+
+#include <folly/futures/Future.h>
+
 #include "velox/common/base/Macros.h"
 #include "velox/duckdb/memory/Allocator.h"
 #include "velox/dwio/common/Reader.h"
@@ -27,13 +31,19 @@ VELOX_UNSUPPRESS_DEPRECATION_WARNING
 
 namespace facebook::velox::parquet::duckdb_reader {
 
+// Reads the row groups of a split through a DuckDB ParquetReader. If the
+// options have a decoding executor and ask for row groups ahead, the row
+// groups are scanned and converted to Velox vectors on the executor, up to
+// that many ahead of the consumer. Otherwise the row groups are scanned on
+// the calling thread, one DuckDB chunk per call to next().
 class ParquetRowReader : public dwio::common::RowReader {
  public:
   ParquetRowReader(
       std::shared_ptr<::duckdb::ParquetReader> reader,
       const dwio::common::RowReaderOptions& options,
       memory::MemoryPool& pool);
-  ~ParquetRowReader() override = default;
+
+  ~ParquetRowReader() override;
 
   uint64_t next(uint64_t size, velox::VectorPtr& result) override;
 
@@ -45,6 +55,18 @@ class ParquetRowReader : public dwio::common::RowReader {
   std::optional<size_t> estimatedRowSize() const override;
 
  private:
+  // Converts the rows of 'output' to a RowVector laid out as 'scanSpec_'
+  // asks. Fixed-width columns wrap the DuckDB buffers without a copy.
+  RowVectorPtr toRowVector(::duckdb::DataChunk& output);
+
+  // Scans row group 'group' with a scan state of its own. Runs on
+  // 'executor_'.
+  std::vector<RowVectorPtr> readRowGroup(::duckdb::idx_t group);
+
+  // Starts reading row groups on 'executor_' until 'rowGroupsAhead_' are
+  // pending or all row groups are started.
+  void scheduleRowGroups();
+
   ::duckdb::TableFilterSet filters_;
   std::shared_ptr<::duckdb::ParquetReader> reader_;
   ::duckdb::ParquetReaderScanState state_;
@@ -52,6 +74,20 @@ class ParquetRowReader : public dwio::common::RowReader {
   RowTypePtr rowType_;
   std::vector<::duckdb::LogicalType> duckdbRowType_;
   std::shared_ptr<velox::common::ScanSpec> scanSpec_;
+
+  std::vector<::duckdb::column_t> columnIds_;
+  // The row groups in the split, in file order.
+  std::vector<::duckdb::idx_t> rowGroups_;
+  const std::shared_ptr<folly::Executor> executor_;
+  // Maximum number of row groups read ahead on 'executor_'. 0 if row
+  // groups are read on the calling thread through 'state_'.
+  const uint32_t rowGroupsAhead_;
+  // The index in 'rowGroups_' of the next row group to start reading.
+  size_t nextRowGroup_{0};
+  std::deque<folly::Future<std::vector<RowVectorPtr>>> pendingRowGroups_;
+  // The batches of the row group being returned and the next one to return.
+  std::vector<RowVectorPtr> batches_;
+  size_t nextBatch_{0};
 };
 
 class ParquetReader : public dwio::common::Reader {
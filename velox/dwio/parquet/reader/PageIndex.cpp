@@ -0,0 +1,110 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "velox/dwio/parquet/reader/PageIndex.h"
+
+#include "velox/dwio/common/ScanSpec.h"
+#include "velox/dwio/parquet/reader/ParquetStatistics.h"
+
+namespace facebook::velox::parquet {
+
+RowRange pageRows(
+    const thrift::OffsetIndex& offsetIndex,
+    int32_t index,
+    int64_t numRows) {
+  const auto& pages = offsetIndex.page_locations;
+  auto end = static_cast<size_t>(index) + 1 < pages.size()
+      ? pages[index + 1].first_row_index
+      : numRows;
+  return {pages[index].first_row_index, end};
+}
+
+RowRanges filterPages(
+    const ParquetColumn& column,
+    common::Filter& filter,
+    const thrift::ColumnIndex& columnIndex,
+    const thrift::OffsetIndex& offsetIndex,
+    int64_t numRows) {
+  const auto numPages = offsetIndex.page_locations.size();
+  VELOX_CHECK(
+      columnIndex.null_pages.size() == numPages &&
+          columnIndex.min_values.size() == numPages &&
+          columnIndex.max_values.size() == numPages,
+      "Column index and offset index of {} do not match",
+      column.name);
+  const bool hasNullCounts = columnIndex.__isset.null_counts &&
+      columnIndex.null_counts.size() == numPages;
+  // testFilter() does not know DATE. Its values are compared as int32.
+  TypePtr type =
+      column.type->kind() == TypeKind::DATE ? INTEGER() : column.type;
+
+  RowRanges result;
+  for (auto i = 0; i < numPages; ++i) {
+    auto rows = pageRows(offsetIndex, i, numRows);
+    auto numPageRows = rows.end - rows.begin;
+    thrift::Statistics stats;
+    if (columnIndex.null_pages[i]) {
+      stats.__set_null_count(numPageRows);
+    } else {
+      stats.__set_min_value(columnIndex.min_values[i]);
+      stats.__set_max_value(columnIndex.max_values[i]);
+      if (hasNullCounts) {
+        stats.__set_null_count(columnIndex.null_counts[i]);
+      }
+    }
+    auto pageStats = toColumnStatistics(column, stats, numPageRows);
+    if (!common::testFilter(&filter, pageStats.get(), numPageRows, type)) {
+      continue;
+    }
+    if (!result.empty() && result.back().end == rows.begin) {
+      result.back().end = rows.end;
+    } else {
+      result.push_back(rows);
+    }
+  }
+  return result;
+}
+
+RowRanges intersectRanges(const RowRanges& left, const RowRanges& right) {
+  RowRanges result;
+  size_t i = 0;
+  size_t j = 0;
+  while (i < left.size() && j < right.size()) {
+    auto begin = std::max(left[i].begin, right[j].begin);
+    auto end = std::min(left[i].end, right[j].end);
+    if (begin < end) {
+      result.push_back({begin, end});
+    }
+    if (left[i].end < right[j].end) {
+      ++i;
+    } else {
+      ++j;
+    }
+  }
+  return result;
+}
+
+bool overlapsRanges(const RowRanges& ranges, int64_t begin, int64_t end) {
+  // The first range that ends after 'begin'.
+  auto it = std::upper_bound(
+      ranges.begin(),
+      ranges.end(),
+      begin,
+      [](int64_t row, const RowRange& range) { return row < range.end; });
+  return it != ranges.end() && it->begin < end;
+}
+
+} // namespace facebook::velox::parquet
@@ -0,0 +1,54 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include "velox/dwio/parquet/reader/PageReader.h"
+#include "velox/type/Filter.h"
+
+namespace facebook::velox::parquet {
+
+// Rows [begin, end) of a row group.
+struct RowRange {
+  int64_t begin;
+  int64_t end;
+};
+
+// Ascending ranges that neither overlap nor touch.
+using RowRanges = std::vector<RowRange>;
+
+// Returns the rows of page 'index' of a column chunk of 'numRows' rows.
+RowRange pageRows(
+    const thrift::OffsetIndex& offsetIndex,
+    int32_t index,
+    int64_t numRows);
+
+// Returns the rows of the pages of a column chunk of 'numRows' rows whose
+// min, max and null counts in 'columnIndex' do not rule out 'filter'.
+RowRanges filterPages(
+    const ParquetColumn& column,
+    common::Filter& filter,
+    const thrift::ColumnIndex& columnIndex,
+    const thrift::OffsetIndex& offsetIndex,
+    int64_t numRows);
+
+// Returns the rows that are in both 'left' and 'right'.
+RowRanges intersectRanges(const RowRanges& left, const RowRanges& right);
+
+// True if a row in [begin, end) is in 'ranges'.
+bool overlapsRanges(const RowRanges& ranges, int64_t begin, int64_t end);
+
+} // namespace facebook::velox::parquet
@@ -0,0 +1,420 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "velox/dwio/parquet/reader/PageReader.h"
+#include "velox/dwio/parquet/reader/RleBpDecoder.h"
+
+namespace facebook::velox::parquet {
+
+namespace {
+
+// Size of the length that precedes the levels in a V1 data page.
+constexpr int32_t kLevelsSizeBytes = 4;
+
+std::unique_ptr<folly::io::Codec> makeCodec(
+    thrift::CompressionCodec::type codec,
+    const std::string& columnName) {
+  switch (codec) {
+    case thrift::CompressionCodec::UNCOMPRESSED:
+      return nullptr;
+    case thrift::CompressionCodec::SNAPPY:
+      return folly::io::getCodec(folly::io::CodecType::SNAPPY);
+    case thrift::CompressionCodec::GZIP:
+      return folly::io::getCodec(folly::io::CodecType::GZIP);
+    case thrift::CompressionCodec::ZSTD:
+      return folly::io::getCodec(folly::io::CodecType::ZSTD);
+    default:
+      VELOX_UNSUPPORTED(
+          "Unsupported Parquet compression codec {} in column {}",
+          static_cast<int32_t>(codec),
+          columnName);
+  }
+}
+
+// Returns the size of a plain encoded value of fixed width 'type'.
+int32_t valueSize(thrift::Type::type type) {
+  switch (type) {
+    case thrift::Type::INT32:
+    case thrift::Type::FLOAT:
+      return 4;
+    case thrift::Type::INT64:
+    case thrift::Type::DOUBLE:
+      return 8;
+    default:
+      VELOX_UNSUPPORTED(
+          "Unsupported Parquet physical type {}", static_cast<int32_t>(type));
+  }
+}
+
+} // namespace
+
+PageReader::PageReader(
+    std::unique_ptr<dwio::common::SeekableInputStream> stream,
+    memory::MemoryPool& pool,
+    const ParquetColumn& column,
+    thrift::CompressionCodec::type codec,
+    int64_t numRows)
+    : stream_(std::move(stream)),
+      pool_(pool),
+      column_(column),
+      codec_(makeCodec(codec, column.name)),
+      rowsLeftInChunk_(numRows) {}
+
+void PageReader::setIndexedPages(std::vector<IndexedPage> pages) {
+  VELOX_CHECK(!pendingHeader_ && numRowsInPage_ == 0);
+  indexedPages_ = std::move(pages);
+  nextIndexedPage_ = 0;
+}
+
+void PageReader::readDictionary() {
+  VELOX_CHECK(!pendingHeader_ && numRowsInPage_ == 0);
+  if (rowsLeftInChunk_ == 0 || !stream_) {
+    return;
+  }
+  auto header = readPageHeader();
+  if (header.type == thrift::PageType::DICTIONARY_PAGE) {
+    loadDictionary(header);
+  } else {
+    pendingHeader_ = std::move(header);
+  }
+}
+
+void PageReader::skip(int64_t numRows) {
+  while (numRows > 0) {
+    if (rowInPage_ == numRowsInPage_) {
+      numRows -= nextDataPage(numRows);
+      continue;
+    }
+    auto numInPage = std::min<int64_t>(numRows, numRowsInPage_ - rowInPage_);
+    advanceInPage(numInPage);
+    numRows -= numInPage;
+  }
+}
+
+thrift::PageHeader PageReader::readPageHeader() {
+  if (pendingHeader_) {
+    auto header = std::move(*pendingHeader_);
+    pendingHeader_.reset();
+    return header;
+  }
+  thrift::PageHeader header;
+  readThrift(stream_.get(), bufferStart_, bufferEnd_, header);
+  return header;
+}
+
+int32_t PageReader::nextDataPage(int64_t rowsToSkip) {
+  VELOX_CHECK_GT(
+      rowsLeftInChunk_,
+      0,
+      "Reading past the end of the column chunk of {}",
+      column_.name);
+  numRowsInPage_ = 0;
+  rowInPage_ = 0;
+  if (!indexedPages_.empty()) {
+    return nextIndexedPage(rowsToSkip);
+  }
+  auto header = readDataPageHeader();
+  const int32_t numRows = header.type == thrift::PageType::DATA_PAGE
+      ? header.data_page_header.num_values
+      : header.data_page_header_v2.num_rows;
+  VELOX_CHECK_LE(numRows, rowsLeftInChunk_);
+  rowsLeftInChunk_ -= numRows;
+  if (numRows <= rowsToSkip) {
+    skipBytes(header.compressed_page_size);
+    return numRows;
+  }
+  loadDataPage(header, numRows);
+  return 0;
+}
+
+int32_t PageReader::nextIndexedPage(int64_t rowsToSkip) {
+  VELOX_CHECK_LT(
+      nextIndexedPage_,
+      indexedPages_.size(),
+      "Reading past the last page of {}",
+      column_.name);
+  auto& page = indexedPages_[nextIndexedPage_++];
+  const int32_t numRows = page.numRows;
+  VELOX_CHECK_LE(numRows, rowsLeftInChunk_);
+  rowsLeftInChunk_ -= numRows;
+  if (numRows <= rowsToSkip) {
+    page.stream.reset();
+    return numRows;
+  }
+  VELOX_CHECK_NOT_NULL(
+      page.stream,
+      "Reading a page of {} that is not selected by the page index",
+      column_.name);
+  stream_ = std::move(page.stream);
+  bufferStart_ = nullptr;
+  bufferEnd_ = nullptr;
+  auto header = readDataPageHeader();
+  const int32_t headerRows = header.type == thrift::PageType::DATA_PAGE
+      ? header.data_page_header.num_values
+      : header.data_page_header_v2.num_rows;
+  VELOX_CHECK_EQ(
+      headerRows,
+      numRows,
+      "Page of {} does not match the offset index",
+      column_.name);
+  loadDataPage(header, numRows);
+  return 0;
+}
+
+thrift::PageHeader PageReader::readDataPageHeader() {
+  for (;;) {
+    auto header = readPageHeader();
+    if (header.type == thrift::PageType::DATA_PAGE ||
+        header.type == thrift::PageType::DATA_PAGE_V2) {
+      return header;
+    }
+    if (header.type == thrift::PageType::DICTIONARY_PAGE) {
+      loadDictionary(header);
+    } else {
+      skipBytes(header.compressed_page_size);
+    }
+  }
+}
+
+void PageReader::loadDataPage(
+    const thrift::PageHeader& header,
+    int32_t numRows) {
+  const bool isV1 = header.type == thrift::PageType::DATA_PAGE;
+  auto data = readBytes(header.compressed_page_size, pageCopy_);
+  if (isV1) {
+    auto& pageHeader = header.data_page_header;
+    auto pageSize = header.uncompressed_page_size;
+    auto page = decompress(data, header.compressed_page_size, pageSize);
+    const char* levels = nullptr;
+    int32_t levelsSize = 0;
+    if (column_.maxDefinitionLevel > 0) {
+      VELOX_CHECK_EQ(
+          pageHeader.definition_level_encoding,
+          thrift::Encoding::RLE,
+          "Unsupported definition level encoding in column {}",
+          column_.name);
+      VELOX_CHECK_GE(pageSize, kLevelsSizeBytes);
+      levelsSize = folly::loadUnaligned<int32_t>(page);
+      levels = page + kLevelsSizeBytes;
+      VELOX_CHECK_LE(kLevelsSizeBytes + levelsSize, pageSize);
+    }
+    auto values = levels ? levels + levelsSize : page;
+    prepareDataPage(
+        pageHeader.encoding,
+        numRows,
+        levels,
+        levelsSize,
+        values,
+        page + pageSize - values);
+  } else {
+    auto& pageHeader = header.data_page_header_v2;
+    VELOX_CHECK_EQ(
+        pageHeader.repetition_levels_byte_length,
+        0,
+        "Repeated columns are not supported: {}",
+        column_.name);
+    // Levels are never compressed in V2 pages.
+    auto levelsSize = pageHeader.definition_levels_byte_length;
+    auto values = data + levelsSize;
+    int32_t valuesSize = header.compressed_page_size - levelsSize;
+    if (pageHeader.is_compressed) {
+      auto uncompressedSize = header.uncompressed_page_size - levelsSize;
+      values = decompress(values, valuesSize, uncompressedSize);
+      valuesSize = uncompressedSize;
+    }
+    prepareDataPage(
+        pageHeader.encoding,
+        numRows,
+        levelsSize > 0 ? data : nullptr,
+        levelsSize,
+        values,
+        valuesSize);
+  }
+}
+
+void PageReader::prepareDataPage(
+    thrift::Encoding::type encoding,
+    int32_t numRows,
+    const char* levels,
+    int32_t levelsSize,
+    const char* values,
+    int32_t valuesSize) {
+  numRowsInPage_ = numRows;
+  rowInPage_ = 0;
+  valueIndex_ = 0;
+  pageNulls_ = nullptr;
+  int32_t numValues = numRows;
+  if (levels) {
+    dwio::common::ensureCapacity<bool>(nulls_, numRows, &pool_);
+    auto nulls = nulls_->asMutable<uint64_t>();
+    RleBpDecoder(levels, levels + levelsSize, 1).readBits(numRows, nulls, 0);
+    numValues = bits::countNonNulls(nulls, 0, numRows);
+    if (numValues < numRows) {
+      pageNulls_ = nulls;
+    }
+  }
+
+  dictionaryIndices_ = nullptr;
+  pageValues_ = values;
+  switch (encoding) {
+    case thrift::Encoding::PLAIN:
+      if (column_.physicalType == thrift::Type::BYTE_ARRAY) {
+        decodeStrings(values, valuesSize, numValues, pageStrings_);
+      } else if (column_.physicalType == thrift::Type::BOOLEAN) {
+        VELOX_CHECK_LE(
+            bits::nbytes(numValues), static_cast<uint64_t>(valuesSize));
+      } else {
+        VELOX_CHECK_LE(
+            numValues * valueSize(column_.physicalType), valuesSize);
+      }
+      break;
+    case thrift::Encoding::PLAIN_DICTIONARY:
+    case thrift::Encoding::RLE_DICTIONARY: {
+      VELOX_CHECK(
+          dictionary_,
+          "Dictionary encoded page without a dictionary in column {}",
+          column_.name);
+      VELOX_CHECK_GT(valuesSize, 0);
+      dwio::common::ensureCapacity<int32_t>(indices_, numValues, &pool_);
+      auto indices = indices_->asMutable<int32_t>();
+      RleBpDecoder(values + 1, values + valuesSize, *values)
+          .next(indices, numValues);
+      for (auto i = 0; i < numValues; ++i) {
+        VELOX_CHECK_LT(
+            static_cast<uint32_t>(indices[i]),
+            static_cast<uint32_t>(dictionarySize_),
+            "Dictionary index out of range in column {}",
+            column_.name);
+      }
+      dictionaryIndices_ = indices;
+      break;
+    }
+    default:
+      VELOX_UNSUPPORTED(
+          "Unsupported Parquet encoding {} in column {}",
+          static_cast<int32_t>(encoding),
+          column_.name);
+  }
+}
+
+void PageReader::loadDictionary(const thrift::PageHeader& header) {
+  auto& dictionaryHeader = header.dictionary_page_header;
+  VELOX_CHECK(
+      dictionaryHeader.encoding == thrift::Encoding::PLAIN ||
+          dictionaryHeader.encoding == thrift::Encoding::PLAIN_DICTIONARY,
+      "Unsupported dictionary encoding in column {}",
+      column_.name);
+  auto size = header.uncompressed_page_size;
+  auto data = decompress(
+      readBytes(header.compressed_page_size, pageCopy_),
+      header.compressed_page_size,
+      size);
+  dictionarySize_ = dictionaryHeader.num_values;
+  if (column_.physicalType == thrift::Type::BYTE_ARRAY) {
+    // The dictionary outlives the page, so the strings are copied.
+    dictionaryStrings_ = AlignedBuffer::allocate<char>(size, &pool_);
+    memcpy(dictionaryStrings_->asMutable<char>(), data, size);
+    dictionary_.reset();
+    decodeStrings(
+        dictionaryStrings_->as<char>(), size, dictionarySize_, dictionary_);
+    return;
+  }
+  auto bytes = dictionarySize_ * valueSize(column_.physicalType);
+  VELOX_CHECK_LE(bytes, size);
+  dictionary_ = AlignedBuffer::allocate<char>(bytes, &pool_);
+  memcpy(dictionary_->asMutable<char>(), data, bytes);
+}
+
+const char* PageReader::readBytes(int32_t size, BufferPtr& copy) {
+  auto nextBuffer = [&]() {
+    const void* buffer;
+    int32_t bufferSize;
+    VELOX_CHECK(
+        stream_->Next(&buffer, &bufferSize),
+        "Reading past the end of the column chunk of {}",
+        column_.name);
+    bufferStart_ = reinterpret_cast<const char*>(buffer);
+    bufferEnd_ = bufferStart_ + bufferSize;
+  };
+  if (bufferStart_ == bufferEnd_ && size > 0) {
+    nextBuffer();
+  }
+  if (bufferEnd_ - bufferStart_ >= size) {
+    auto result = bufferStart_;
+    bufferStart_ += size;
+    return result;
+  }
+  dwio::common::ensureCapacity<char>(copy, size, &pool_);
+  auto destination = copy->asMutable<char>();
+  int32_t copied = 0;
+  while (copied < size) {
+    if (bufferStart_ == bufferEnd_) {
+      nextBuffer();
+    }
+    auto toCopy = std::min<int64_t>(size - copied, bufferEnd_ - bufferStart_);
+    memcpy(destination + copied, bufferStart_, toCopy);
+    bufferStart_ += toCopy;
+    copied += toCopy;
+  }
+  return destination;
+}
+
+void PageReader::skipBytes(int64_t size) {
+  auto inBuffer = std::min<int64_t>(size, bufferEnd_ - bufferStart_);
+  bufferStart_ += inBuffer;
+  size -= inBuffer;
+  if (size > 0) {
+    VELOX_CHECK(
+        stream_->Skip(size),
+        "Skipping past the end of the column chunk of {}",
+        column_.name);
+  }
+}
+
+const char* PageReader::decompress(
+    const char* data,
+    int32_t size,
+    int32_t uncompressedSize) {
+  if (!codec_) {
+    return data;
+  }
+  auto input = folly::IOBuf::wrapBufferAsValue(data, size);
+  decompressed_ = codec_->uncompress(&input, uncompressedSize);
+  decompressed_->coalesce();
+  VELOX_CHECK_EQ(
+      decompressed_->length(), static_cast<uint64_t>(uncompressedSize));
+  return reinterpret_cast<const char*>(decompressed_->data());
+}
+
+void PageReader::decodeStrings(
+    const char* data,
+    int32_t size,
+    int32_t numValues,
+    BufferPtr& result) {
+  dwio::common::ensureCapacity<StringView>(result, numValues, &pool_);
+  auto views = result->asMutable<StringView>();
+  auto end = data + size;
+  for (auto i = 0; i < numValues; ++i) {
+    VELOX_CHECK_LE(data + sizeof(uint32_t), end);
+    auto length = folly::loadUnaligned<uint32_t>(data);
+    data += sizeof(uint32_t);
+    VELOX_CHECK_LE(length, static_cast<uint64_t>(end - data));
+    views[i] = StringView(data, length);
+    data += length;
+  }
+}
+
+} // namespace facebook::velox::parquet
@@ -0,0 +1,272 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <folly/compression/Compression.h>
+#include <folly/lang/Bits.h>
+
+#include "velox/common/base/Nulls.h"
+#include "velox/dwio/common/BufferUtil.h"
+#include "velox/dwio/parquet/reader/ThriftTransport.h"
+#include "velox/vector/LazyVector.h"
+
+namespace facebook::velox::parquet {
+
+// Describes a leaf column of a Parquet file as needed for decoding its
+// pages.
+struct ParquetColumn {
+  // Position of the column in the column chunks of a row group.
+  uint32_t index;
+
+  std::string name;
+
+  thrift::Type::type physicalType;
+
+  // The Velox type the values are read as.
+  TypePtr type;
+
+  // 1 if the column is optional, 0 if it is required. Repeated and nested
+  // columns are not supported.
+  int16_t maxDefinitionLevel;
+};
+
+// A data page located by the offset index of its column chunk.
+struct IndexedPage {
+  int64_t numRows;
+
+  // The bytes of the page. nullptr if the page is not read because none of
+  // its rows are selected.
+  std::unique_ptr<dwio::common::SeekableInputStream> stream;
+};
+
+// Reads the pages of one column chunk. Decompresses data pages, turns
+// definition levels into null flags and decodes dictionary indices a page
+// at a time into buffers from 'pool'. Pages that contain no requested row
+// are skipped without decompressing them.
+class PageReader {
+ public:
+  PageReader(
+      std::unique_ptr<dwio::common::SeekableInputStream> stream,
+      memory::MemoryPool& pool,
+      const ParquetColumn& column,
+      thrift::CompressionCodec::type codec,
+      int64_t numRows);
+
+  // Reads the data pages from 'pages' instead of from the stream given to
+  // the constructor, which then holds only the dictionary page, if any, or
+  // is nullptr. Must be called before readDictionary(). Skipped pages are
+  // not read. Reading a row of a page without a stream is an error.
+  void setIndexedPages(std::vector<IndexedPage> pages);
+
+  // Reads the dictionary page if the column chunk starts with one. Must be
+  // called before reading any rows.
+  void readDictionary();
+
+  bool hasDictionary() const {
+    return dictionary_ != nullptr;
+  }
+
+  // Returns the values of the dictionary. For BYTE_ARRAY columns these are
+  // StringViews pointing into dictionaryStrings().
+  template <typename T>
+  const T* dictionary() const {
+    return dictionary_->as<T>();
+  }
+
+  int32_t dictionarySize() const {
+    return dictionarySize_;
+  }
+
+  const BufferPtr& dictionaryStrings() const {
+    return dictionaryStrings_;
+  }
+
+  // Skips the next 'numRows' rows.
+  void skip(int64_t numRows);
+
+  // Reads the next 'numRows' rows and calls 'visitor' for the ones in
+  // 'rows', which are ascending and relative to the current row. Calls
+  // visitor.processNull(i) for a null in rows[i],
+  // visitor.processDictionaryValue(i, index, value) for a dictionary
+  // encoded value and visitor.processValue(i, value) for a plain encoded
+  // value. T is the C++ type of the values of the physical type, StringView
+  // for BYTE_ARRAY. StringViews from a data page are valid until the next
+  // call on 'this'.
+  template <typename T, typename Visitor>
+  void readWithVisitor(RowSet rows, int32_t numRows, Visitor& visitor);
+
+ private:
+  // Returns the header of the next page.
+  thrift::PageHeader readPageHeader();
+
+  // Reads the next data page. If the page has no more than 'rowsToSkip'
+  // rows, skips it without decompressing and returns its number of rows.
+  // Otherwise makes it the current page and returns 0.
+  int32_t nextDataPage(int64_t rowsToSkip);
+
+  // nextDataPage() for pages from setIndexedPages().
+  int32_t nextIndexedPage(int64_t rowsToSkip);
+
+  // Reads the next data page header, loading any dictionary page before it
+  // and skipping other pages.
+  thrift::PageHeader readDataPageHeader();
+
+  // Decompresses the data page of 'header' and sets up decoding it.
+  void loadDataPage(const thrift::PageHeader& header, int32_t numRows);
+
+  // Sets up decoding a data page of 'numRows' rows. 'levels' and 'values'
+  // are the uncompressed definition levels and values.
+  void prepareDataPage(
+      thrift::Encoding::type encoding,
+      int32_t numRows,
+      const char* levels,
+      int32_t levelsSize,
+      const char* values,
+      int32_t valuesSize);
+
+  void loadDictionary(const thrift::PageHeader& header);
+
+  // Returns 'size' contiguous bytes from 'stream_'. The bytes are valid
+  // until the next read from 'stream_'. If these straddle buffers of the
+  // stream, copies them to 'copy'.
+  const char* readBytes(int32_t size, BufferPtr& copy);
+
+  void skipBytes(int64_t size);
+
+  // Returns 'uncompressedSize' bytes decompressed from 'size' bytes at
+  // 'data'. Returns 'data' if the column chunk is not compressed.
+  const char*
+  decompress(const char* data, int32_t size, int32_t uncompressedSize);
+
+  // Moves 'numRows' rows ahead in the current page.
+  void advanceInPage(int32_t numRows) {
+    valueIndex_ += pageNulls_
+        ? bits::countNonNulls(pageNulls_, rowInPage_, rowInPage_ + numRows)
+        : numRows;
+    rowInPage_ += numRows;
+  }
+
+  template <typename T>
+  T plainValue(int32_t index) const {
+    if constexpr (std::is_same_v<T, bool>) {
+      return bits::isBitSet(
+          reinterpret_cast<const uint8_t*>(pageValues_), index);
+    } else if constexpr (std::is_same_v<T, StringView>) {
+      return pageStrings_->as<StringView>()[index];
+    } else {
+      return folly::loadUnaligned<T>(pageValues_ + index * sizeof(T));
+    }
+  }
+
+  // Makes StringViews for the 'numValues' plain encoded BYTE_ARRAY values
+  // in 'data'.
+  void decodeStrings(
+      const char* data,
+      int32_t size,
+      int32_t numValues,
+      BufferPtr& result);
+
+  std::unique_ptr<dwio::common::SeekableInputStream> stream_;
+  memory::MemoryPool& pool_;
+  const ParquetColumn& column_;
+  std::unique_ptr<folly::io::Codec> codec_;
+
+  // Rows of the column chunk not yet loaded in a page or skipped.
+  int64_t rowsLeftInChunk_;
+
+  // Header read by readDictionary() that is not a dictionary page header.
+  std::optional<thrift::PageHeader> pendingHeader_;
+
+  // The data pages if located by the offset index and the next of them.
+  std::vector<IndexedPage> indexedPages_;
+  size_t nextIndexedPage_{0};
+
+  // The unconsumed part of the last buffer returned by 'stream_'.
+  const char* bufferStart_{nullptr};
+  const char* bufferEnd_{nullptr};
+
+  // Copy of a page that straddles buffers of 'stream_'.
+  BufferPtr pageCopy_;
+  std::unique_ptr<folly::IOBuf> decompressed_;
+
+  BufferPtr dictionary_;
+  BufferPtr dictionaryStrings_;
+  int32_t dictionarySize_{0};
+
+  // State of the current data page.
+  int32_t numRowsInPage_{0};
+  int32_t rowInPage_{0};
+
+  // Index of the value of the row at 'rowInPage_' among the non-null
+  // values of the page.
+  int32_t valueIndex_{0};
+
+  // Null flags of the rows of the page. nullptr if the page has no nulls.
+  const uint64_t* pageNulls_{nullptr};
+  BufferPtr nulls_;
+
+  // Dictionary indices of the non-null values of the page. nullptr if the
+  // page is plain encoded.
+  const int32_t* dictionaryIndices_{nullptr};
+  BufferPtr indices_;
+
+  // Start of the plain encoded values of the page.
+  const char* pageValues_{nullptr};
+
+  // StringViews of the plain encoded values of a BYTE_ARRAY page.
+  BufferPtr pageStrings_;
+};
+
+template <typename T, typename Visitor>
+void PageReader::readWithVisitor(
+    RowSet rows,
+    int32_t numRows,
+    Visitor& visitor) {
+  int32_t currentRow = 0;
+  int32_t i = 0;
+  while (i < rows.size()) {
+    if (rows[i] > currentRow) {
+      skip(rows[i] - currentRow);
+      currentRow = rows[i];
+    }
+    if (rowInPage_ == numRowsInPage_) {
+      VELOX_CHECK_EQ(nextDataPage(0), 0);
+    }
+    // Processes the rows in the current page.
+    auto pageEndRow = currentRow + numRowsInPage_ - rowInPage_;
+    auto nulls = pageNulls_;
+    auto indices = dictionaryIndices_;
+    for (; i < rows.size() && rows[i] < pageEndRow; ++i) {
+      advanceInPage(rows[i] - currentRow);
+      if (nulls && bits::isBitNull(nulls, rowInPage_)) {
+        visitor.processNull(i);
+      } else if (indices) {
+        auto index = indices[valueIndex_];
+        visitor.processDictionaryValue(i, index, dictionary<T>()[index]);
+      } else {
+        visitor.processValue(i, plainValue<T>(valueIndex_));
+      }
+      advanceInPage(1);
+      currentRow = rows[i] + 1;
+    }
+  }
+  if (numRows > currentRow) {
+    skip(numRows - currentRow);
+  }
+}
+
+} // namespace facebook::velox::parquet
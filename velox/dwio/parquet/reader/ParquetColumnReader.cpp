@@ -0,0 +1,269 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "velox/dwio/parquet/reader/ParquetColumnReader.h"
+#include "velox/vector/FlatVector.h"
+
+namespace facebook::velox::parquet {
+
+namespace {
+
+// Reads a column of fixed width or string values. TPhysical is the C++
+// type of the Parquet physical type and TValue the C++ type of the Velox
+// type, e.g. int32_t and int16_t for a SMALLINT column.
+template <typename TPhysical, typename TValue>
+class ScalarColumnReader : public ParquetColumnReader {
+ public:
+  ScalarColumnReader(
+      const ParquetColumn& column,
+      common::ScanSpec& scanSpec,
+      memory::MemoryPool& pool)
+      : ParquetColumnReader(column, scanSpec, pool) {}
+
+  void startRowGroup(
+      std::unique_ptr<PageReader> pageReader,
+      bool dictionaryOnly) override {
+    pageReader_ = std::move(pageReader);
+    pageReader_->readDictionary();
+    dictionaryResults_.clear();
+    rowGroupRejected_ = false;
+    auto filter = scanSpec_.filter();
+    if (!filter || !filter->isDeterministic() ||
+        !pageReader_->hasDictionary()) {
+      return;
+    }
+    // Each dictionary value is tested once instead of once per row.
+    auto size = pageReader_->dictionarySize();
+    auto dictionary = pageReader_->dictionary<TPhysical>();
+    dictionaryResults_.resize(size);
+    bool anyPassed = false;
+    for (auto i = 0; i < size; ++i) {
+      dictionaryResults_[i] = common::applyFilter(*filter, dictionary[i]);
+      anyPassed |= dictionaryResults_[i];
+    }
+    rowGroupRejected_ = dictionaryOnly && !anyPassed && !filter->testNull();
+  }
+
+  void read(int32_t numRows, RowSet rows) override {
+    filter_ = scanSpec_.filter();
+    keepValues_ = scanSpec_.keepValues();
+    outputRows_.clear();
+    numValues_ = 0;
+    anyNulls_ = false;
+    stringBuffers_.clear();
+    rawStringBuffer_ = nullptr;
+    usesDictionaryStrings_ = false;
+    if (keepValues_) {
+      dwio::common::ensureCapacity<TValue>(values_, rows.size(), &pool_);
+      dwio::common::ensureCapacity<bool>(nulls_, rows.size(), &pool_);
+      rawValues_ = values_->asMutable<RawValueType>();
+      rawNulls_ = nulls_->asMutable<uint64_t>();
+    }
+    rows_ = rows;
+    pageReader_->readWithVisitor<TPhysical>(rows, numRows, *this);
+  }
+
+  VectorPtr getValues(RowSet rows) override {
+    VELOX_CHECK(keepValues_);
+    if (rows.size() != static_cast<size_t>(numValues_)) {
+      compactValues(rows);
+    }
+    return std::make_shared<FlatVector<TValue>>(
+        &pool_,
+        column_.type,
+        anyNulls_ ? nulls_ : BufferPtr(nullptr),
+        numValues_,
+        values_,
+        std::move(stringBuffers_));
+  }
+
+  // Visitor interface for PageReader::readWithVisitor().
+  void processNull(int32_t i) {
+    if (filter_ && !filter_->testNull()) {
+      return;
+    }
+    outputRows_.push_back(rows_[i]);
+    if (keepValues_) {
+      anyNulls_ = true;
+      bits::setNull(rawNulls_, numValues_);
+      if constexpr (!std::is_same_v<TValue, bool>) {
+        rawValues_[numValues_] = TValue();
+      }
+      ++numValues_;
+    }
+  }
+
+  void processValue(int32_t i, TPhysical value) {
+    if (filter_ && !common::applyFilter(*filter_, value)) {
+      return;
+    }
+    addValue(rows_[i], value, false);
+  }
+
+  void processDictionaryValue(int32_t i, int32_t index, TPhysical value) {
+    if (filter_) {
+      if (!dictionaryResults_.empty()) {
+        if (!dictionaryResults_[index]) {
+          return;
+        }
+      } else if (!common::applyFilter(*filter_, value)) {
+        return;
+      }
+    }
+    addValue(rows_[i], value, true);
+  }
+
+ private:
+  static constexpr int32_t kStringBufferSize = 16 * 1024;
+
+  void addValue(int32_t row, TPhysical value, bool inDictionary) {
+    outputRows_.push_back(row);
+    if (!keepValues_) {
+      return;
+    }
+    bits::clearNull(rawNulls_, numValues_);
+    if constexpr (std::is_same_v<TValue, bool>) {
+      bits::setBit(rawValues_, numValues_, value);
+    } else if constexpr (std::is_same_v<TValue, StringView>) {
+      if (value.isInline()) {
+        rawValues_[numValues_] = value;
+      } else if (inDictionary) {
+        // Points into the dictionary, which stays alive with the vector.
+        if (!usesDictionaryStrings_) {
+          stringBuffers_.push_back(pageReader_->dictionaryStrings());
+          usesDictionaryStrings_ = true;
+        }
+        rawValues_[numValues_] = value;
+      } else {
+        // Values of data pages are copied, the page is reused.
+        rawValues_[numValues_] = copyString(value);
+      }
+    } else {
+      rawValues_[numValues_] = TValue(value);
+    }
+    ++numValues_;
+  }
+
+  StringView copyString(StringView value) {
+    auto size = value.size();
+    if (!rawStringBuffer_ || rawStringUsed_ + size > rawStringSize_) {
+      auto bufferSize = std::max<int32_t>(kStringBufferSize, size);
+      stringBuffers_.push_back(
+          AlignedBuffer::allocate<char>(bufferSize, &pool_));
+      rawStringBuffer_ = stringBuffers_.back()->asMutable<char>();
+      rawStringSize_ = bufferSize;
+      rawStringUsed_ = 0;
+    }
+    auto copy = rawStringBuffer_ + rawStringUsed_;
+    memcpy(copy, value.data(), size);
+    rawStringUsed_ += size;
+    return StringView(copy, size);
+  }
+
+  // Moves the values of 'rows' to the front of 'values_' and 'nulls_'.
+  void compactValues(RowSet rows) {
+    const int32_t numRows = rows.size();
+    int32_t numCompacted = 0;
+    for (auto i = 0; i < numValues_ && numCompacted < numRows; ++i) {
+      if (outputRows_[i] != rows[numCompacted]) {
+        continue;
+      }
+      if (i != numCompacted) {
+        bits::setBit(rawNulls_, numCompacted, bits::isBitSet(rawNulls_, i));
+        if constexpr (std::is_same_v<TValue, bool>) {
+          bits::setBit(
+              rawValues_, numCompacted, bits::isBitSet(rawValues_, i));
+        } else {
+          rawValues_[numCompacted] = rawValues_[i];
+        }
+      }
+      ++numCompacted;
+    }
+    VELOX_CHECK_EQ(numCompacted, numRows);
+    numValues_ = numCompacted;
+  }
+
+  // FlatVector<bool> keeps its values as bits.
+  using RawValueType =
+      std::conditional_t<std::is_same_v<TValue, bool>, uint64_t, TValue>;
+
+  common::Filter* filter_{nullptr};
+  bool keepValues_{false};
+  RowSet rows_;
+
+  // Result of the filter for each value of the dictionary of the current
+  // column chunk. Empty if not known up front.
+  std::vector<bool> dictionaryResults_;
+
+  BufferPtr values_;
+  RawValueType* rawValues_{nullptr};
+  BufferPtr nulls_;
+  uint64_t* rawNulls_{nullptr};
+  int32_t numValues_{0};
+  bool anyNulls_{false};
+
+  // Buffers the StringViews in 'values_' point to.
+  std::vector<BufferPtr> stringBuffers_;
+  bool usesDictionaryStrings_{false};
+  char* rawStringBuffer_{nullptr};
+  int32_t rawStringSize_{0};
+  int32_t rawStringUsed_{0};
+};
+
+} // namespace
+
+std::unique_ptr<ParquetColumnReader> ParquetColumnReader::create(
+    const ParquetColumn& column,
+    common::ScanSpec& scanSpec,
+    memory::MemoryPool& pool) {
+  switch (column.type->kind()) {
+    case TypeKind::BOOLEAN:
+      return std::make_unique<ScalarColumnReader<bool, bool>>(
+          column, scanSpec, pool);
+    case TypeKind::TINYINT:
+      return std::make_unique<ScalarColumnReader<int32_t, int8_t>>(
+          column, scanSpec, pool);
+    case TypeKind::SMALLINT:
+      return std::make_unique<ScalarColumnReader<int32_t, int16_t>>(
+          column, scanSpec, pool);
+    case TypeKind::INTEGER:
+      return std::make_unique<ScalarColumnReader<int32_t, int32_t>>(
+          column, scanSpec, pool);
+    case TypeKind::DATE:
+      return std::make_unique<ScalarColumnReader<int32_t, Date>>(
+          column, scanSpec, pool);
+    case TypeKind::BIGINT:
+      return std::make_unique<ScalarColumnReader<int64_t, int64_t>>(
+          column, scanSpec, pool);
+    case TypeKind::REAL:
+      return std::make_unique<ScalarColumnReader<float, float>>(
+          column, scanSpec, pool);
+    case TypeKind::DOUBLE:
+      return std::make_unique<ScalarColumnReader<double, double>>(
+          column, scanSpec, pool);
+    case TypeKind::VARCHAR:
+    case TypeKind::VARBINARY:
+      return std::make_unique<ScalarColumnReader<StringView, StringView>>(
+          column, scanSpec, pool);
+    default:
+      VELOX_UNSUPPORTED(
+          "Unsupported type {} of Parquet column {}",
+          column.type->toString(),
+          column.name);
+  }
+}
+
+} // namespace facebook::velox::parquet
@@ -0,0 +1,98 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include "velox/common/base/RawVector.h"
+#include "velox/dwio/common/ScanSpec.h"
+#include "velox/dwio/parquet/reader/PageReader.h"
+
+namespace facebook::velox::parquet {
+
+// Reads one column of a Parquet file for a ParquetRowReader. A batch of
+// rows is read in two phases. First the readers of the filtered columns
+// read the rows that passed the filters so far, each narrowing them down.
+// Then the readers of the other projected columns decode only the rows
+// that passed all the filters.
+class ParquetColumnReader {
+ public:
+  ParquetColumnReader(
+      const ParquetColumn& column,
+      common::ScanSpec& scanSpec,
+      memory::MemoryPool& pool)
+      : column_(column), scanSpec_(scanSpec), pool_(pool) {}
+
+  virtual ~ParquetColumnReader() = default;
+
+  static std::unique_ptr<ParquetColumnReader> create(
+      const ParquetColumn& column,
+      common::ScanSpec& scanSpec,
+      memory::MemoryPool& pool);
+
+  const ParquetColumn& column() const {
+    return column_;
+  }
+
+  common::ScanSpec& scanSpec() const {
+    return scanSpec_;
+  }
+
+  // Starts reading the column chunk of a new row group from 'pageReader'.
+  // Reads the dictionary, if any, and evaluates the filter once for each
+  // of its values. 'dictionaryOnly' is true if all the data pages of the
+  // column chunk are dictionary encoded.
+  virtual void startRowGroup(
+      std::unique_ptr<PageReader> pageReader,
+      bool dictionaryOnly) = 0;
+
+  // True if no row of the current row group can pass the filter. This is
+  // known when all the data pages are dictionary encoded and no value of
+  // the dictionary nor null passes the filter.
+  bool rowGroupRejected() const {
+    return rowGroupRejected_;
+  }
+
+  // Reads the next 'numRows' rows. Decodes the rows in 'rows', which are
+  // relative to the current row, and skips the others. If the column has
+  // a filter, outputRows() are the rows that pass. If the column is
+  // projected out, keeps the values of the rows in outputRows().
+  virtual void read(int32_t numRows, RowSet rows) = 0;
+
+  // Skips the next 'numRows' rows.
+  void skip(int32_t numRows) {
+    pageReader_->skip(numRows);
+  }
+
+  RowSet outputRows() const {
+    return outputRows_;
+  }
+
+  // Returns the values of 'rows', which must be a subset of outputRows().
+  // May be called once after each read().
+  virtual VectorPtr getValues(RowSet rows) = 0;
+
+ protected:
+  const ParquetColumn& column_;
+  common::ScanSpec& scanSpec_;
+  memory::MemoryPool& pool_;
+  std::unique_ptr<PageReader> pageReader_;
+  bool rowGroupRejected_{false};
+
+  // The rows of the values read by the last read().
+  raw_vector<int32_t> outputRows_;
+};
+
+} // namespace facebook::velox::parquet
@@ -0,0 +1,655 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "velox/dwio/parquet/reader/ParquetReader.h"
+
+#include <cstring>
+#include <numeric>
+
+#include "velox/common/base/SelectivityInfo.h"
+#include "velox/dwio/parquet/reader/ParquetStatistics.h"
+
+namespace facebook::velox::parquet {
+
+using dwio::common::LogType;
+
+namespace {
+
+constexpr const char* kMagic = "PAR1";
+constexpr uint64_t kMagicSize = 4;
+
+// The footer ends with its length as int32 and the magic.
+constexpr uint64_t kTrailerSize = 8;
+
+// Bytes read from the end of the file in the first read. Covers the footer
+// of most files.
+constexpr uint64_t kFooterSizeGuess = 64 * 1024;
+
+TypePtr toVeloxType(const thrift::SchemaElement& element) {
+  VELOX_USER_CHECK(
+      element.__isset.type, "Parquet column {} has no type", element.name);
+  std::optional<thrift::ConvertedType::type> convertedType;
+  if (element.__isset.converted_type) {
+    convertedType = element.converted_type;
+  }
+  switch (element.type) {
+    case thrift::Type::BOOLEAN:
+      if (!convertedType.has_value()) {
+        return BOOLEAN();
+      }
+      break;
+    case thrift::Type::INT32:
+      if (!convertedType.has_value()) {
+        return INTEGER();
+      }
+      switch (convertedType.value()) {
+        case thrift::ConvertedType::INT_8:
+          return TINYINT();
+        case thrift::ConvertedType::INT_16:
+          return SMALLINT();
+        case thrift::ConvertedType::INT_32:
+          return INTEGER();
+        case thrift::ConvertedType::DATE:
+          return DATE();
+        default:
+          break;
+      }
+      break;
+    case thrift::Type::INT64:
+      if (!convertedType.has_value() ||
+          convertedType.value() == thrift::ConvertedType::INT_64) {
+        return BIGINT();
+      }
+      break;
+    case thrift::Type::FLOAT:
+      return REAL();
+    case thrift::Type::DOUBLE:
+      return DOUBLE();
+    case thrift::Type::BYTE_ARRAY:
+      if (!convertedType.has_value()) {
+        return VARBINARY();
+      }
+      switch (convertedType.value()) {
+        case thrift::ConvertedType::UTF8:
+        case thrift::ConvertedType::ENUM:
+        case thrift::ConvertedType::JSON:
+          return VARCHAR();
+        default:
+          break;
+      }
+      break;
+    default:
+      break;
+  }
+  VELOX_UNSUPPORTED(
+      "Unsupported Parquet column type for {}: type {}, converted type {}",
+      element.name,
+      static_cast<int32_t>(element.type),
+      convertedType.has_value() ? static_cast<int32_t>(convertedType.value())
+                                : -1);
+}
+
+// True if all the data pages of 'metaData' are dictionary encoded, so that
+// the dictionary holds every non-null value of the column chunk.
+bool isDictionaryOnly(const thrift::ColumnMetaData& metaData) {
+  auto isDictionary = [](thrift::Encoding::type encoding) {
+    return encoding == thrift::Encoding::PLAIN_DICTIONARY ||
+        encoding == thrift::Encoding::RLE_DICTIONARY;
+  };
+  if (metaData.__isset.encoding_stats) {
+    for (auto& stats : metaData.encoding_stats) {
+      if ((stats.page_type == thrift::PageType::DATA_PAGE ||
+           stats.page_type == thrift::PageType::DATA_PAGE_V2) &&
+          stats.count > 0 && !isDictionary(stats.encoding)) {
+        return false;
+      }
+    }
+    return true;
+  }
+  // Without page statistics, a writer that fell back from dictionary to
+  // plain encoding lists PLAIN among the encodings of the chunk.
+  for (auto encoding : metaData.encodings) {
+    if (encoding == thrift::Encoding::PLAIN) {
+      return false;
+    }
+  }
+  return true;
+}
+
+} // namespace
+
+ReaderBase::ReaderBase(
+    std::unique_ptr<dwio::common::InputStream> stream,
+    const dwio::common::ReaderOptions& options)
+    : pool_(options.getMemoryPool()),
+      fileNum_(options.getFileNum()),
+      stream_(std::move(stream)),
+      bufferedInputFactory_(
+          options.getBufferedInputFactory()
+              ? options.getBufferedInputFactory()
+              : dwio::common::BufferedInputFactory::baseFactoryShared()) {
+  loadFileMetaData();
+  initializeSchema();
+}
+
+void ReaderBase::loadFileMetaData() {
+  const uint64_t fileLength = stream_->getLength();
+  VELOX_CHECK_GE(
+      fileLength,
+      kMagicSize + kTrailerSize,
+      "Parquet file is too small: {}",
+      stream_->getName());
+
+  auto input = makeBufferedInput();
+  const uint64_t readSize = std::min(fileLength, kFooterSizeGuess);
+  input->enqueue({fileLength - readSize, readSize});
+  input->load(LogType::FOOTER);
+
+  char trailer[kTrailerSize];
+  input->read(fileLength - kTrailerSize, kTrailerSize, LogType::FOOTER)
+      ->readFully(trailer, kTrailerSize);
+  VELOX_CHECK_EQ(
+      std::memcmp(trailer + kTrailerSize - kMagicSize, kMagic, kMagicSize),
+      0,
+      "No Parquet magic at the end of {}",
+      stream_->getName());
+  const uint64_t footerLength = folly::loadUnaligned<uint32_t>(trailer);
+  VELOX_CHECK_LE(
+      footerLength + kMagicSize + kTrailerSize,
+      fileLength,
+      "Parquet footer is longer than the file {}",
+      stream_->getName());
+
+  // Served from the buffer loaded above unless the footer is larger than
+  // the guess.
+  auto footerStream = input->read(
+      fileLength - kTrailerSize - footerLength, footerLength, LogType::FOOTER);
+  const char* bufferStart = nullptr;
+  const char* bufferEnd = nullptr;
+  fileMetaData_ = std::make_unique<thrift::FileMetaData>();
+  readThrift(footerStream.get(), bufferStart, bufferEnd, *fileMetaData_);
+}
+
+void ReaderBase::initializeSchema() {
+  const auto& schema = fileMetaData_->schema;
+  VELOX_CHECK(!schema.empty(), "Parquet file has no schema");
+  const auto numColumns = schema[0].num_children;
+  VELOX_CHECK_EQ(
+      static_cast<size_t>(numColumns) + 1,
+      schema.size(),
+      "Nested Parquet columns are not supported");
+
+  std::vector<std::string> names;
+  std::vector<TypePtr> types;
+  names.reserve(numColumns);
+  types.reserve(numColumns);
+  columns_.reserve(numColumns);
+  for (auto i = 0; i < numColumns; ++i) {
+    const auto& element = schema[i + 1];
+    if (element.__isset.num_children && element.num_children > 0) {
+      VELOX_UNSUPPORTED(
+          "Nested Parquet columns are not supported: {}", element.name);
+    }
+    if (element.repetition_type == thrift::FieldRepetitionType::REPEATED) {
+      VELOX_UNSUPPORTED(
+          "Repeated Parquet columns are not supported: {}", element.name);
+    }
+    auto type = toVeloxType(element);
+    columns_.push_back(ParquetColumn{
+        static_cast<uint32_t>(i),
+        element.name,
+        element.type,
+        type,
+        static_cast<int16_t>(
+            element.repetition_type == thrift::FieldRepetitionType::OPTIONAL
+                ? 1
+                : 0)});
+    names.push_back(element.name);
+    types.push_back(std::move(type));
+  }
+  type_ = ROW(std::move(names), std::move(types));
+}
+
+const std::shared_ptr<const dwio::common::TypeWithId>&
+ReaderBase::typeWithId() const {
+  if (!typeWithId_) {
+    typeWithId_ = dwio::common::TypeWithId::create(type_);
+  }
+  return typeWithId_;
+}
+
+const ParquetColumn* ReaderBase::findColumn(const std::string& name) const {
+  for (auto& column : columns_) {
+    if (column.name == name) {
+      return &column;
+    }
+  }
+  return nullptr;
+}
+
+int64_t ReaderBase::rowGroupOffset(int32_t index) const {
+  const auto& rowGroup = fileMetaData_->row_groups[index];
+  if (rowGroup.__isset.file_offset) {
+    return rowGroup.file_offset;
+  }
+  VELOX_CHECK(!rowGroup.columns.empty());
+  const auto& metaData = rowGroup.columns[0].meta_data;
+  if (metaData.__isset.dictionary_page_offset &&
+      metaData.dictionary_page_offset > 0) {
+    return std::min(metaData.dictionary_page_offset, metaData.data_page_offset);
+  }
+  return metaData.data_page_offset;
+}
+
+ParquetRowReader::ParquetRowReader(
+    std::shared_ptr<const ReaderBase> readerBase,
+    const dwio::common::RowReaderOptions& options)
+    : readerBase_(std::move(readerBase)),
+      pool_(readerBase_->pool()),
+      rowType_(options.getSelector()->buildSelectedReordered()),
+      scanSpec_(options.getScanSpec()),
+      input_(readerBase_->makeBufferedInput()) {
+  VELOX_CHECK_NOT_NULL(scanSpec_, "Parquet reader requires a ScanSpec");
+  for (auto& childSpec : scanSpec_->children()) {
+    if (childSpec->isConstant()) {
+      continue;
+    }
+    auto column = readerBase_->findColumn(childSpec->fieldName());
+    if (!column) {
+      // A column missing from the file reads as null.
+      auto filter = childSpec->filter();
+      if (filter && !filter->testNull()) {
+        missingColumnRejected_ = true;
+      }
+      continue;
+    }
+    columnReaders_.push_back(
+        ParquetColumnReader::create(*column, *childSpec, pool_));
+    readerBySpec_[childSpec.get()] = columnReaders_.back().get();
+  }
+
+  if (missingColumnRejected_) {
+    return;
+  }
+  const auto& rowGroups = readerBase_->fileMetaData().row_groups;
+  for (auto i = 0; i < rowGroups.size(); ++i) {
+    auto offset = readerBase_->rowGroupOffset(i);
+    if (offset >= options.getOffset() &&
+        offset < options.getOffset() + options.getLength()) {
+      rowGroups_.push_back(i);
+    }
+  }
+}
+
+bool ParquetRowReader::rowGroupRejectedByStats(int32_t index) const {
+  const auto& rowGroup = readerBase_->fileMetaData().row_groups[index];
+  for (auto& reader : columnReaders_) {
+    auto filter = reader->scanSpec().filter();
+    if (!filter) {
+      continue;
+    }
+    const auto& column = reader->column();
+    const auto& metaData = rowGroup.columns.at(column.index).meta_data;
+    if (!metaData.__isset.statistics) {
+      continue;
+    }
+    auto stats =
+        toColumnStatistics(column, metaData.statistics, rowGroup.num_rows);
+    // testFilter() does not know DATE. Its values are compared as int32.
+    TypePtr type =
+        column.type->kind() == TypeKind::DATE ? INTEGER() : column.type;
+    if (!common::testFilter(filter, stats.get(), rowGroup.num_rows, type)) {
+      return true;
+    }
+  }
+  return false;
+}
+
+bool ParquetRowReader::advanceToNextRowGroup() {
+  const auto& rowGroups = readerBase_->fileMetaData().row_groups;
+  while (nextRowGroup_ < rowGroups_.size()) {
+    const auto index = rowGroups_[nextRowGroup_++];
+    const auto& rowGroup = rowGroups[index];
+    if (rowGroup.num_rows == 0) {
+      continue;
+    }
+    if (rowGroupRejectedByStats(index)) {
+      ++skippedRowGroups_;
+      continue;
+    }
+
+    std::vector<thrift::OffsetIndex> offsetIndexes;
+    if (!selectRowsByPageIndex(index, offsetIndexes)) {
+      ++skippedRowGroups_;
+      continue;
+    }
+    const bool prunePages = selectedRanges_.size() != 1 ||
+        selectedRanges_[0].begin != 0 ||
+        selectedRanges_[0].end != rowGroup.num_rows;
+
+    std::vector<std::unique_ptr<dwio::common::SeekableInputStream>> streams;
+    std::vector<std::vector<IndexedPage>> pages(columnReaders_.size());
+    streams.reserve(columnReaders_.size());
+    for (auto i = 0; i < columnReaders_.size(); ++i) {
+      auto& reader = columnReaders_[i];
+      const auto& chunk = rowGroup.columns.at(reader->column().index);
+      VELOX_CHECK(
+          !chunk.__isset.file_path,
+          "Parquet column chunks in other files are not supported");
+      const auto& metaData = chunk.meta_data;
+      auto start = metaData.data_page_offset;
+      if (metaData.__isset.dictionary_page_offset &&
+          metaData.dictionary_page_offset > 0) {
+        start = std::min(start, metaData.dictionary_page_offset);
+      }
+      dwio::common::StreamIdentifier id(reader->column().index);
+      if (!prunePages || offsetIndexes.empty() ||
+          offsetIndexes[i].page_locations.empty()) {
+        streams.push_back(input_->enqueue(
+            {static_cast<uint64_t>(start),
+             static_cast<uint64_t>(metaData.total_compressed_size)},
+            &id));
+        continue;
+      }
+      // Reads the dictionary page, which precedes the first data page, and
+      // the data pages that have selected rows.
+      const auto& locations = offsetIndexes[i].page_locations;
+      const auto dictionarySize = locations[0].offset - start;
+      streams.push_back(
+          dictionarySize > 0 ? input_->enqueue(
+                                   {static_cast<uint64_t>(start),
+                                    static_cast<uint64_t>(dictionarySize)},
+                                   &id)
+                             : nullptr);
+      for (auto page = 0; page < locations.size(); ++page) {
+        const auto rows = pageRows(offsetIndexes[i], page, rowGroup.num_rows);
+        IndexedPage indexedPage{rows.end - rows.begin, nullptr};
+        if (overlapsRanges(selectedRanges_, rows.begin, rows.end)) {
+          indexedPage.stream = input_->enqueue(
+              {static_cast<uint64_t>(locations[page].offset),
+               static_cast<uint64_t>(locations[page].compressed_page_size)},
+              &id);
+        }
+        pages[i].push_back(std::move(indexedPage));
+      }
+    }
+    input_->load(LogType::STREAM);
+
+    bool rejected = false;
+    for (auto i = 0; i < columnReaders_.size(); ++i) {
+      auto& reader = columnReaders_[i];
+      const auto& metaData =
+          rowGroup.columns[reader->column().index].meta_data;
+      auto pageReader = std::make_unique<PageReader>(
+          std::move(streams[i]),
+          pool_,
+          reader->column(),
+          metaData.codec,
+          rowGroup.num_rows);
+      if (!pages[i].empty()) {
+        pageReader->setIndexedPages(std::move(pages[i]));
+      }
+      reader->startRowGroup(std::move(pageReader), isDictionaryOnly(metaData));
+      rejected |= reader->rowGroupRejected();
+    }
+    if (rejected) {
+      ++skippedRowGroups_;
+      continue;
+    }
+    rowGroupNumRows_ = rowGroup.num_rows;
+    rowsLeftInRowGroup_ = rowGroup.num_rows;
+    nextRange_ = 0;
+    return true;
+  }
+  return false;
+}
+
+bool ParquetRowReader::selectRowsByPageIndex(
+    int32_t index,
+    std::vector<thrift::OffsetIndex>& offsetIndexes) {
+  const auto& rowGroup = readerBase_->fileMetaData().row_groups[index];
+  selectedRanges_ = {RowRange{0, rowGroup.num_rows}};
+  auto hasPageIndex = [&](const ParquetColumnReader& reader) {
+    const auto& chunk = rowGroup.columns[reader.column().index];
+    return chunk.__isset.offset_index_offset &&
+        chunk.__isset.column_index_offset &&
+        chunk.offset_index_length > 0 && chunk.column_index_length > 0;
+  };
+  bool anyIndexedFilter = false;
+  for (auto& reader : columnReaders_) {
+    if (reader->scanSpec().hasFilter() && hasPageIndex(*reader)) {
+      anyIndexedFilter = true;
+      break;
+    }
+  }
+  if (!anyIndexedFilter) {
+    return true;
+  }
+
+  // The page indexes of the row group are next to each other at the end of
+  // the file, so they are read in one load.
+  std::vector<std::unique_ptr<dwio::common::SeekableInputStream>>
+      offsetStreams(columnReaders_.size());
+  std::vector<std::unique_ptr<dwio::common::SeekableInputStream>>
+      columnStreams(columnReaders_.size());
+  for (auto i = 0; i < columnReaders_.size(); ++i) {
+    auto& reader = *columnReaders_[i];
+    const auto& chunk = rowGroup.columns[reader.column().index];
+    dwio::common::StreamIdentifier id(reader.column().index);
+    if (chunk.__isset.offset_index_offset && chunk.offset_index_length > 0) {
+      offsetStreams[i] = input_->enqueue(
+          {static_cast<uint64_t>(chunk.offset_index_offset),
+           static_cast<uint64_t>(chunk.offset_index_length)},
+          &id);
+    }
+    if (reader.scanSpec().hasFilter() && hasPageIndex(reader)) {
+      columnStreams[i] = input_->enqueue(
+          {static_cast<uint64_t>(chunk.column_index_offset),
+           static_cast<uint64_t>(chunk.column_index_length)},
+          &id);
+    }
+  }
+  input_->load(LogType::FOOTER);
+
+  offsetIndexes.resize(columnReaders_.size());
+  for (auto i = 0; i < columnReaders_.size(); ++i) {
+    const char* bufferStart = nullptr;
+    const char* bufferEnd = nullptr;
+    if (offsetStreams[i]) {
+      readThrift(
+          offsetStreams[i].get(), bufferStart, bufferEnd, offsetIndexes[i]);
+    }
+    if (!columnStreams[i]) {
+      continue;
+    }
+    thrift::ColumnIndex columnIndex;
+    bufferStart = nullptr;
+    bufferEnd = nullptr;
+    readThrift(columnStreams[i].get(), bufferStart, bufferEnd, columnIndex);
+    auto& reader = *columnReaders_[i];
+    selectedRanges_ = intersectRanges(
+        selectedRanges_,
+        filterPages(
+            reader.column(),
+            *reader.scanSpec().filter(),
+            columnIndex,
+            offsetIndexes[i],
+            rowGroup.num_rows));
+    if (selectedRanges_.empty()) {
+      return false;
+    }
+  }
+  return true;
+}
+
+RowSet ParquetRowReader::readRows(int32_t numRows) {
+  scanSpec_->newRead();
+  const auto oldSize = rows_.size();
+  rows_.resize(numRows);
+  if (numRows > oldSize) {
+    std::iota(&rows_[oldSize], &rows_[rows_.size()], oldSize);
+  }
+  RowSet activeRows(rows_.data(), numRows);
+
+  // The filtered columns are read first, in the order the ScanSpec keeps
+  // them in, each on the rows that passed the filters before it. The other
+  // columns then decode only the rows that passed all of them.
+  for (auto& childSpec : scanSpec_->children()) {
+    auto it = readerBySpec_.find(childSpec.get());
+    if (it == readerBySpec_.end() || !childSpec->hasFilter()) {
+      continue;
+    }
+    auto* reader = it->second;
+    if (activeRows.empty()) {
+      reader->skip(numRows);
+      continue;
+    }
+    SelectivityTimer timer(childSpec->selectivity(), activeRows.size());
+    reader->read(numRows, activeRows);
+    activeRows = reader->outputRows();
+    childSpec->selectivity().addOutput(activeRows.size());
+  }
+  for (auto& reader : columnReaders_) {
+    auto& childSpec = reader->scanSpec();
+    if (childSpec.hasFilter()) {
+      continue;
+    }
+    if (activeRows.empty() || !childSpec.keepValues()) {
+      reader->skip(numRows);
+    } else {
+      reader->read(numRows, activeRows);
+    }
+  }
+  return activeRows;
+}
+
+RowVectorPtr ParquetRowReader::makeResult(RowSet rows) {
+  std::vector<VectorPtr> children(rowType_->size());
+  for (auto& childSpec : scanSpec_->children()) {
+    if (childSpec->isConstant()) {
+      children[childSpec->channel()] = BaseVector::wrapInConstant(
+          rows.size(), 0, childSpec->constantValue());
+    } else if (childSpec->projectOut()) {
+      auto channel = childSpec->channel();
+      children[channel] = BaseVector::createNullConstant(
+          rowType_->childAt(channel), rows.size(), &pool_);
+    }
+  }
+  for (auto& reader : columnReaders_) {
+    auto& childSpec = reader->scanSpec();
+    if (childSpec.projectOut()) {
+      children[childSpec.channel()] = reader->getValues(rows);
+    }
+  }
+  return std::make_shared<RowVector>(
+      &pool_, rowType_, BufferPtr(nullptr), rows.size(), std::move(children));
+}
+
+uint64_t ParquetRowReader::next(uint64_t size, velox::VectorPtr& result) {
+  VELOX_CHECK_GT(size, 0);
+  for (;;) {
+    if (rowsLeftInRowGroup_ == 0 && !advanceToNextRowGroup()) {
+      return 0;
+    }
+    // Skips to the next range selected by the page index and ends the batch
+    // at its end.
+    const auto row = rowGroupNumRows_ - rowsLeftInRowGroup_;
+    while (nextRange_ < selectedRanges_.size() &&
+           selectedRanges_[nextRange_].end <= row) {
+      ++nextRange_;
+    }
+    if (nextRange_ == selectedRanges_.size()) {
+      rowsLeftInRowGroup_ = 0;
+      continue;
+    }
+    const auto& range = selectedRanges_[nextRange_];
+    if (range.begin > row) {
+      for (auto& reader : columnReaders_) {
+        reader->skip(range.begin - row);
+      }
+      rowsLeftInRowGroup_ -= range.begin - row;
+      continue;
+    }
+    const auto numRows = std::min<int64_t>(size, range.end - row);
+    rowsLeftInRowGroup_ -= numRows;
+    auto rows = readRows(numRows);
+    if (!rows.empty()) {
+      result = makeResult(rows);
+      return rows.size();
+    }
+  }
+}
+
+void ParquetRowReader::updateRuntimeStats(
+    dwio::common::RuntimeStatistics& stats) const {
+  stats.skippedStrides += skippedRowGroups_;
+}
+
+void ParquetRowReader::resetFilterCaches() {
+  // No filter caches to reset.
+}
+
+std::optional<size_t> ParquetRowReader::estimatedRowSize() const {
+  return std::nullopt;
+}
+
+ParquetReader::ParquetReader(
+    std::unique_ptr<dwio::common::InputStream> stream,
+    const dwio::common::ReaderOptions& options)
+    : readerBase_(std::make_shared<ReaderBase>(std::move(stream), options)) {}
+
+std::optional<uint64_t> ParquetReader::numberOfRows() const {
+  return readerBase_->fileMetaData().num_rows;
+}
+
+std::unique_ptr<dwio::common::ColumnStatistics> ParquetReader::columnStatistics(
+    uint32_t index) const {
+  // 'index' is a node id of typeWithId(). The root is 0 and the columns
+  // follow in order.
+  VELOX_CHECK_GT(index, 0, "Parquet statistics are per column");
+  const auto& column = readerBase_->columns().at(index - 1);
+  std::optional<uint64_t> valueCount = 0;
+  bool hasNull = false;
+  for (auto& rowGroup : readerBase_->fileMetaData().row_groups) {
+    const auto& metaData = rowGroup.columns.at(column.index).meta_data;
+    if (!metaData.__isset.statistics ||
+        !metaData.statistics.__isset.null_count) {
+      return std::make_unique<dwio::common::ColumnStatistics>(
+          std::nullopt, std::nullopt, std::nullopt, std::nullopt);
+    }
+    auto nullCount = metaData.statistics.null_count;
+    valueCount = valueCount.value() + rowGroup.num_rows - nullCount;
+    hasNull |= nullCount > 0;
+  }
+  return std::make_unique<dwio::common::ColumnStatistics>(
+      valueCount, hasNull, std::nullopt, std::nullopt);
+}
+
+const velox::RowTypePtr& ParquetReader::rowType() const {
+  return readerBase_->rowType();
+}
+
+const std::shared_ptr<const dwio::common::TypeWithId>&
+ParquetReader::typeWithId() const {
+  return readerBase_->typeWithId();
+}
+
+std::unique_ptr<dwio::common::RowReader> ParquetReader::createRowReader(
+    const dwio::common::RowReaderOptions& options) const {
+  return std::make_unique<ParquetRowReader>(readerBase_, options);
+}
+
+} // namespace facebook::velox::parquet
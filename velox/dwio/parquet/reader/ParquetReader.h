@@ -0,0 +1,201 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <folly/container/F14Map.h>
+
+#include "velox/dwio/common/BufferedInput.h"
+#include "velox/dwio/common/Reader.h"
+#include "velox/dwio/common/ReaderFactory.h"
+#include "velox/dwio/parquet/reader/PageIndex.h"
+#include "velox/dwio/parquet/reader/ParquetColumnReader.h"
+
+namespace facebook::velox::parquet {
+
+// The footer and schema of a Parquet file. Shared by a ParquetReader and
+// the row readers it makes.
+class ReaderBase {
+ public:
+  ReaderBase(
+      std::unique_ptr<dwio::common::InputStream> stream,
+      const dwio::common::ReaderOptions& options);
+
+  memory::MemoryPool& pool() const {
+    return pool_;
+  }
+
+  // Makes a BufferedInput over the file for a row reader.
+  std::unique_ptr<dwio::common::BufferedInput> makeBufferedInput() const {
+    return bufferedInputFactory_->create(*stream_, pool_, fileNum_);
+  }
+
+  const thrift::FileMetaData& fileMetaData() const {
+    return *fileMetaData_;
+  }
+
+  const RowTypePtr& rowType() const {
+    return type_;
+  }
+
+  const std::shared_ptr<const dwio::common::TypeWithId>& typeWithId() const;
+
+  const std::vector<ParquetColumn>& columns() const {
+    return columns_;
+  }
+
+  // Returns the leaf column called 'name' or nullptr if there is none.
+  const ParquetColumn* findColumn(const std::string& name) const;
+
+  // Returns the offset of the first page of row group 'index'. A split
+  // reads the row groups whose offset falls in its range.
+  int64_t rowGroupOffset(int32_t index) const;
+
+ private:
+  void loadFileMetaData();
+
+  void initializeSchema();
+
+  memory::MemoryPool& pool_;
+  const uint64_t fileNum_;
+  std::unique_ptr<dwio::common::InputStream> stream_;
+  std::shared_ptr<dwio::common::BufferedInputFactory> bufferedInputFactory_;
+  std::unique_ptr<thrift::FileMetaData> fileMetaData_;
+  std::vector<ParquetColumn> columns_;
+  RowTypePtr type_;
+  mutable std::shared_ptr<const dwio::common::TypeWithId> typeWithId_;
+};
+
+// Reads the row groups of a split. Row groups that cannot have rows
+// passing the filters are skipped using the column chunk statistics
+// before any I/O, and using the dictionaries of dictionary encoded
+// columns before decoding any data page. If the filtered columns have a
+// page index, only the pages whose min and max admit the filters are
+// read and decoded. The column chunks of the selected columns of a row
+// group are read in one load of the BufferedInput, which coalesces
+// nearby ranges.
+class ParquetRowReader : public dwio::common::RowReader {
+ public:
+  ParquetRowReader(
+      std::shared_ptr<const ReaderBase> readerBase,
+      const dwio::common::RowReaderOptions& options);
+
+  ~ParquetRowReader() override = default;
+
+  uint64_t next(uint64_t size, velox::VectorPtr& result) override;
+
+  void updateRuntimeStats(
+      dwio::common::RuntimeStatistics& stats) const override;
+
+  void resetFilterCaches() override;
+
+  std::optional<size_t> estimatedRowSize() const override;
+
+ private:
+  // Makes the next row group that may have passing rows current. Returns
+  // false if there are no more row groups.
+  bool advanceToNextRowGroup();
+
+  // True if the statistics of row group 'index' show that no row passes
+  // the filters.
+  bool rowGroupRejectedByStats(int32_t index) const;
+
+  // Sets 'selectedRanges_' to the rows of row group 'index' whose pages
+  // are not ruled out by the column indexes of the filtered columns and
+  // fills 'offsetIndexes' with the offset indexes of 'columnReaders_' if
+  // any filtered column has a page index. Returns false if no row is
+  // selected.
+  bool selectRowsByPageIndex(
+      int32_t index,
+      std::vector<thrift::OffsetIndex>& offsetIndexes);
+
+  // Reads 'numRows' rows of the current row group. Returns the rows that
+  // pass the filters and leaves the values of projected columns in the
+  // column readers.
+  RowSet readRows(int32_t numRows);
+
+  RowVectorPtr makeResult(RowSet rows);
+
+  const std::shared_ptr<const ReaderBase> readerBase_;
+  memory::MemoryPool& pool_;
+  RowTypePtr rowType_;
+  std::shared_ptr<common::ScanSpec> scanSpec_;
+  std::unique_ptr<dwio::common::BufferedInput> input_;
+
+  // The row groups in the split, in file order.
+  std::vector<int32_t> rowGroups_;
+  size_t nextRowGroup_{0};
+  int64_t rowGroupNumRows_{0};
+  int64_t rowsLeftInRowGroup_{0};
+
+  // The rows of the current row group that may pass the filters and the
+  // first of them that is not yet read past.
+  RowRanges selectedRanges_;
+  size_t nextRange_{0};
+
+  // Readers for the non-constant children of 'scanSpec_' that are in the
+  // file, in the order of the children.
+  std::vector<std::unique_ptr<ParquetColumnReader>> columnReaders_;
+  folly::F14FastMap<const common::ScanSpec*, ParquetColumnReader*>
+      readerBySpec_;
+
+  // True if a column that is not in the file has a filter that rejects
+  // null. No row can pass then.
+  bool missingColumnRejected_{false};
+
+  // The rows of the current batch, 0 .. n - 1.
+  raw_vector<int32_t> rows_;
+
+  int64_t skippedRowGroups_{0};
+};
+
+class ParquetReader : public dwio::common::Reader {
+ public:
+  ParquetReader(
+      std::unique_ptr<dwio::common::InputStream> stream,
+      const dwio::common::ReaderOptions& options);
+
+  ~ParquetReader() override = default;
+
+  std::optional<uint64_t> numberOfRows() const override;
+
+  std::unique_ptr<dwio::common::ColumnStatistics> columnStatistics(
+      uint32_t index) const override;
+
+  const velox::RowTypePtr& rowType() const override;
+
+  const std::shared_ptr<const dwio::common::TypeWithId>& typeWithId()
+      const override;
+
+  std::unique_ptr<dwio::common::RowReader> createRowReader(
+      const dwio::common::RowReaderOptions& options = {}) const override;
+
+ private:
+  std::shared_ptr<const ReaderBase> readerBase_;
+};
+
+class ParquetReaderFactory : public dwio::common::ReaderFactory {
+ public:
+  ParquetReaderFactory() : ReaderFactory(dwio::common::FileFormat::PARQUET) {}
+
+  std::unique_ptr<dwio::common::Reader> createReader(
+      std::unique_ptr<dwio::common::InputStream> stream,
+      const dwio::common::ReaderOptions& options) override {
+    return std::make_unique<ParquetReader>(std::move(stream), options);
+  }
+};
+
+} // namespace facebook::velox::parquet
@@ -0,0 +1,115 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "velox/dwio/parquet/reader/ParquetStatistics.h"
+
+#include <folly/lang/Bits.h>
+
+namespace facebook::velox::parquet {
+
+namespace {
+
+// Returns the value of a min or max statistic of a fixed width column.
+template <typename T>
+std::optional<T> decodeStat(const std::string& bytes) {
+  if (bytes.size() != sizeof(T)) {
+    return std::nullopt;
+  }
+  return folly::loadUnaligned<T>(bytes.data());
+}
+
+} // namespace
+
+std::unique_ptr<dwio::common::ColumnStatistics> toColumnStatistics(
+    const ParquetColumn& column,
+    const thrift::Statistics& stats,
+    int64_t numRows) {
+  std::optional<uint64_t> valueCount;
+  std::optional<bool> hasNull;
+  if (stats.__isset.null_count) {
+    valueCount = numRows - stats.null_count;
+    hasNull = stats.null_count > 0;
+  }
+  dwio::common::ColumnStatistics base(
+      valueCount, hasNull, std::nullopt, std::nullopt);
+
+  // min_value and max_value are in the sort order of the logical type. The
+  // deprecated min and max are in signed byte order and are only usable
+  // for fixed width types, where that order agrees.
+  const bool hasMinMax = stats.__isset.min_value && stats.__isset.max_value;
+  const auto& min = hasMinMax ? stats.min_value : stats.min;
+  const auto& max = hasMinMax ? stats.max_value : stats.max;
+  const bool hasDeprecatedMinMax = stats.__isset.min && stats.__isset.max;
+  switch (column.type->kind()) {
+    case TypeKind::BOOLEAN:
+      return std::make_unique<dwio::common::BooleanColumnStatistics>(
+          base, std::nullopt);
+    case TypeKind::TINYINT:
+    case TypeKind::SMALLINT:
+    case TypeKind::INTEGER:
+    case TypeKind::DATE:
+      if (hasMinMax || hasDeprecatedMinMax) {
+        return std::make_unique<dwio::common::IntegerColumnStatistics>(
+            base,
+            decodeStat<int32_t>(min),
+            decodeStat<int32_t>(max),
+            std::nullopt);
+      }
+      break;
+    case TypeKind::BIGINT:
+      if (hasMinMax || hasDeprecatedMinMax) {
+        return std::make_unique<dwio::common::IntegerColumnStatistics>(
+            base,
+            decodeStat<int64_t>(min),
+            decodeStat<int64_t>(max),
+            std::nullopt);
+      }
+      break;
+    case TypeKind::REAL:
+      if (hasMinMax || hasDeprecatedMinMax) {
+        auto minValue = decodeStat<float>(min);
+        auto maxValue = decodeStat<float>(max);
+        return std::make_unique<dwio::common::DoubleColumnStatistics>(
+            base,
+            minValue.has_value() ? std::optional<double>(minValue.value())
+                                 : std::nullopt,
+            maxValue.has_value() ? std::optional<double>(maxValue.value())
+                                 : std::nullopt,
+            std::nullopt);
+      }
+      break;
+    case TypeKind::DOUBLE:
+      if (hasMinMax || hasDeprecatedMinMax) {
+        return std::make_unique<dwio::common::DoubleColumnStatistics>(
+            base,
+            decodeStat<double>(min),
+            decodeStat<double>(max),
+            std::nullopt);
+      }
+      break;
+    case TypeKind::VARCHAR:
+      if (hasMinMax) {
+        return std::make_unique<dwio::common::StringColumnStatistics>(
+            base, min, max, std::nullopt);
+      }
+      break;
+    default:
+      break;
+  }
+  return std::make_unique<dwio::common::ColumnStatistics>(base);
+}
+
+} // namespace facebook::velox::parquet
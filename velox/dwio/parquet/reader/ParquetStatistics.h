@@ -0,0 +1,31 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include "velox/dwio/common/Statistics.h"
+#include "velox/dwio/parquet/reader/PageReader.h"
+
+namespace facebook::velox::parquet {
+
+// Converts the statistics of a column chunk or page of 'numRows' rows to
+// the statistics the filters are tested against.
+std::unique_ptr<dwio::common::ColumnStatistics> toColumnStatistics(
+    const ParquetColumn& column,
+    const thrift::Statistics& stats,
+    int64_t numRows);
+
+} // namespace facebook::velox::parquet
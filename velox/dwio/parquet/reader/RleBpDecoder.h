@@ -0,0 +1,189 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <folly/lang/Bits.h>
+
+#include "velox/common/base/BitUtil.h"
+#include "velox/common/base/Exceptions.h"
+
+namespace facebook::velox::parquet {
+
+// Decoder for the RLE/bit-packed hybrid encoding of Parquet. This is used
+// for definition levels and dictionary indices. The input is a sequence of
+// runs. A run is a varint header followed by either one repeated value of
+// ceil(bitWidth / 8) bytes or groups of 8 values of 'bitWidth' bits,
+// packed least significant bit first.
+class RleBpDecoder {
+ public:
+  RleBpDecoder(const char* start, const char* end, uint8_t bitWidth)
+      : bufferStart_(start),
+        bufferEnd_(end),
+        bitWidth_(bitWidth),
+        byteWidth_(bits::roundUp(bitWidth, 8) / 8) {
+    VELOX_CHECK_LE(bitWidth, 32, "Unsupported RLE/bit-packed width");
+  }
+
+  // Skips the next 'numValues' values.
+  void skip(int64_t numValues) {
+    while (numValues > 0) {
+      if (remainingValues_ == 0) {
+        readHeader();
+      }
+      auto count = std::min<int64_t>(numValues, remainingValues_);
+      if (!repeating_) {
+        bitOffset_ += count * bitWidth_;
+      }
+      remainingValues_ -= count;
+      numValues -= count;
+    }
+  }
+
+  // Reads the next 'numValues' values into 'values'.
+  template <typename T>
+  void next(T* values, int32_t numValues) {
+    int32_t numRead = 0;
+    while (numRead < numValues) {
+      if (remainingValues_ == 0) {
+        readHeader();
+      }
+      auto count = std::min<int64_t>(numValues - numRead, remainingValues_);
+      if (repeating_) {
+        std::fill(values + numRead, values + numRead + count, value_);
+      } else {
+        for (auto i = 0; i < count; ++i) {
+          values[numRead + i] = loadBits(bitOffset_, bitWidth_);
+          bitOffset_ += bitWidth_;
+        }
+      }
+      remainingValues_ -= count;
+      numRead += count;
+    }
+  }
+
+  // Reads the next 'numValues' values of bit width 1 as bits of 'bits'
+  // starting at bit 'offset'. This turns the definition levels of a flat
+  // column directly into Velox null flags.
+  void readBits(int32_t numValues, uint64_t* bits, int32_t offset) {
+    VELOX_DCHECK_EQ(bitWidth_, 1);
+    int32_t numRead = 0;
+    while (numRead < numValues) {
+      if (remainingValues_ == 0) {
+        readHeader();
+      }
+      auto count = std::min<int64_t>(numValues - numRead, remainingValues_);
+      if (repeating_) {
+        bits::fillBits(
+            bits, offset + numRead, offset + numRead + count, value_ != 0);
+      } else {
+        for (auto i = 0; i < count;) {
+          auto chunk = std::min<int32_t>(count - i, kMaxChunkBits);
+          storeBits(
+              bits,
+              offset + numRead + i,
+              loadBits(bitOffset_, chunk),
+              chunk);
+          bitOffset_ += chunk;
+          i += chunk;
+        }
+      }
+      remainingValues_ -= count;
+      numRead += count;
+    }
+  }
+
+ private:
+  // Loads at most this many bits at a time, so that a bit offset inside
+  // the first byte plus the loaded bits fit in 64 bits.
+  static constexpr int32_t kMaxChunkBits = 56;
+
+  void readHeader() {
+    // Bit-packed runs are padded to whole bytes.
+    bufferStart_ += bits::roundUp(bitOffset_, 8) / 8;
+    bitOffset_ = 0;
+    uint64_t header = 0;
+    for (int32_t shift = 0;; shift += 7) {
+      VELOX_CHECK_LT(
+          bufferStart_, bufferEnd_, "Reading past end of RLE/bit-packed data");
+      auto byte = static_cast<uint8_t>(*bufferStart_++);
+      header |= static_cast<uint64_t>(byte & 0x7f) << shift;
+      if (!(byte & 0x80)) {
+        break;
+      }
+    }
+    repeating_ = (header & 1) == 0;
+    if (repeating_) {
+      remainingValues_ = header >> 1;
+      VELOX_CHECK_LE(bufferStart_ + byteWidth_, bufferEnd_);
+      value_ = bits::loadPartialWord(
+          reinterpret_cast<const uint8_t*>(bufferStart_), byteWidth_);
+      bufferStart_ += byteWidth_;
+    } else {
+      remainingValues_ = (header >> 1) * 8;
+      if (bitWidth_ > 0) {
+        // The last group may be cut short at the end of the data.
+        remainingValues_ = std::min<int64_t>(
+            remainingValues_, (bufferEnd_ - bufferStart_) * 8 / bitWidth_);
+      }
+    }
+    VELOX_CHECK_GT(remainingValues_, 0, "Empty RLE/bit-packed run");
+  }
+
+  // Returns 'numBits' bits starting 'bitOffset' bits after 'bufferStart_'.
+  uint64_t loadBits(int64_t bitOffset, int32_t numBits) const {
+    auto byte = reinterpret_cast<const uint8_t*>(bufferStart_) + bitOffset / 8;
+    auto available = reinterpret_cast<const uint8_t*>(bufferEnd_) - byte;
+    uint64_t word = available >= 8
+        ? folly::loadUnaligned<uint64_t>(byte)
+        : bits::loadPartialWord(byte, available);
+    return (word >> (bitOffset & 7)) & bits::lowMask(numBits);
+  }
+
+  // Sets 'numBits' bits of 'bits' starting at 'offset' to the low bits of
+  // 'word'.
+  static void
+  storeBits(uint64_t* bits, int32_t offset, uint64_t word, int32_t numBits) {
+    auto index = offset / 64;
+    auto shift = offset & 63;
+    auto mask = bits::lowMask(numBits);
+    bits[index] = (bits[index] & ~(mask << shift)) | (word << shift);
+    if (shift + numBits > 64) {
+      auto high = shift + numBits - 64;
+      bits[index + 1] = (bits[index + 1] & ~bits::lowMask(high)) |
+          (word >> (64 - shift));
+    }
+  }
+
+  const char* bufferStart_;
+  const char* const bufferEnd_;
+  const uint8_t bitWidth_;
+  const uint8_t byteWidth_;
+
+  // Values left in the current run.
+  int64_t remainingValues_{0};
+
+  // True if the current run is a repeated value, false if bit-packed.
+  bool repeating_{false};
+
+  // The repeated value of the current run.
+  uint64_t value_{0};
+
+  // Offset of the next value of a bit-packed run from 'bufferStart_'.
+  int64_t bitOffset_{0};
+};
+
+} // namespace facebook::velox::parquet
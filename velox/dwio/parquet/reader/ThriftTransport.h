@@ -0,0 +1,91 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include "velox/common/base/Exceptions.h"
+#include "velox/common/base/Macros.h"
+#include "velox/dwio/common/SeekableInputStream.h"
+VELOX_SUPPRESS_DEPRECATION_WARNING
+#include "velox/external/duckdb/parquet-amalgamation.hpp"
+VELOX_UNSUPPRESS_DEPRECATION_WARNING
+
+namespace facebook::velox::parquet {
+
+// The Thrift definitions of the Parquet metadata. These come with the
+// vendored DuckDB Parquet extension.
+namespace thrift = ::duckdb_parquet::format;
+
+// Thrift transport that reads from a SeekableInputStream. The stream is
+// shared with the caller through 'bufferStart' and 'bufferEnd', the not yet
+// consumed part of the last buffer returned by the stream. Page headers are
+// read with this and the page data right after without seeking. Metadata
+// may straddle the buffers of the stream, e.g. when the stream comes from
+// the cache.
+class ThriftStreamTransport
+    : public ::duckdb_apache::thrift::transport::TVirtualTransport<
+          ThriftStreamTransport> {
+ public:
+  ThriftStreamTransport(
+      dwio::common::SeekableInputStream* input,
+      const char*& bufferStart,
+      const char*& bufferEnd)
+      : input_(input), bufferStart_(bufferStart), bufferEnd_(bufferEnd) {}
+
+  uint32_t read(uint8_t* outputBuf, uint32_t len) {
+    auto remaining = len;
+    while (remaining > 0) {
+      if (bufferStart_ == bufferEnd_) {
+        const void* buffer;
+        int32_t size;
+        VELOX_CHECK(
+            input_->Next(&buffer, &size),
+            "Reading past the end of Parquet metadata");
+        bufferStart_ = reinterpret_cast<const char*>(buffer);
+        bufferEnd_ = bufferStart_ + size;
+      }
+      auto toCopy =
+          std::min<uint32_t>(remaining, bufferEnd_ - bufferStart_);
+      memcpy(outputBuf, bufferStart_, toCopy);
+      bufferStart_ += toCopy;
+      outputBuf += toCopy;
+      remaining -= toCopy;
+    }
+    return len;
+  }
+
+ private:
+  dwio::common::SeekableInputStream* const input_;
+  const char*& bufferStart_;
+  const char*& bufferEnd_;
+};
+
+// Deserializes a Thrift struct of type T, e.g. thrift::PageHeader, from
+// 'input'. See ThriftStreamTransport for 'bufferStart' and 'bufferEnd'.
+template <typename T>
+void readThrift(
+    dwio::common::SeekableInputStream* input,
+    const char*& bufferStart,
+    const char*& bufferEnd,
+    T& result) {
+  auto transport =
+      std::make_shared<ThriftStreamTransport>(input, bufferStart, bufferEnd);
+  ::duckdb_apache::thrift::protocol::TCompactProtocolT<ThriftStreamTransport>
+      protocol(transport);
+  result.read(&protocol);
+}
+
+} // namespace facebook::velox::parquet
@@ -13,6 +13,7 @@
  * See the License for the specific language governing permissions and
  * limitations under the License.
  */
+#include <folly/executors/CPUThreadPoolExecutor.h>
 #include <gtest/gtest.h>
 #include <array>
 
@@ -90,6 +91,26 @@ TEST_F(ParquetReaderTest, readSampleFull) {
   assertReadExpected(*rowReader, expected);
 }
 
+TEST_F(ParquetReaderTest, readSampleRowGroupsAhead) {
+  // Both row groups of sample.parquet are read on the executor, the second
+  // while the first is returned.
+  const std::string sample(getExampleFilePath("sample.parquet"));
+
+  ReaderOptions readerOptions;
+  ParquetReader reader(
+      std::make_unique<FileInputStream>(sample), readerOptions);
+
+  auto rowReaderOpts = getReaderOpts(sampleSchema());
+  rowReaderOpts.setScanSpec(makeScanSpec(sampleSchema()));
+  rowReaderOpts.setDecodingExecutor(
+      std::make_shared<folly::CPUThreadPoolExecutor>(2));
+  rowReaderOpts.setRowGroupsAhead(1);
+  auto rowReader = reader.createRowReader(rowReaderOpts);
+  auto expected = vectorMaker_->rowVector(
+      {rangeVector<int64_t>(20, 1), rangeVector<double>(20, 1)});
+  assertReadExpected(*rowReader, expected);
+}
+
 TEST_F(ParquetReaderTest, readSampleRange1) {
   const std::string sample(getExampleFilePath("sample.parquet"));
 
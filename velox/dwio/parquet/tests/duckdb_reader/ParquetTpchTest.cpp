@@ -161,17 +161,34 @@ std::unordered_map<std::string, std::string> ParquetTpchTest::duckDbParquetWrite
         R"(COPY (SELECT * FROM {}) TO '{}' (FORMAT 'parquet', ROW_GROUP_SIZE {}))"),
     std::make_pair(
         "supplier",
-        R"(COPY (SELECT * FROM {}) TO '{}' (FORMAT 'parquet', ROW_GROUP_SIZE {}))")};
+        R"(COPY (SELECT s_suppkey, s_name, s_address, s_nationkey, s_phone,
+        s_acctbal::DOUBLE as s_acctbal, s_comment
+        FROM {}) TO '{}' (FORMAT 'parquet', ROW_GROUP_SIZE {}))"),
+    std::make_pair(
+        "partsupp",
+        R"(COPY (SELECT ps_partkey, ps_suppkey, ps_availqty,
+        ps_supplycost::DOUBLE as ps_supplycost, ps_comment
+        FROM {}) TO '{}' (FORMAT 'parquet', ROW_GROUP_SIZE {}))")};
 
 TEST_F(ParquetTpchTest, Q1) {
   assertQuery(1);
 }
 
+TEST_F(ParquetTpchTest, Q2) {
+  std::vector<uint32_t> sortingKeys{0, 2, 1, 3};
+  assertQuery(2, std::move(sortingKeys));
+}
+
 TEST_F(ParquetTpchTest, Q3) {
   std::vector<uint32_t> sortingKeys{1, 2};
   assertQuery(3, std::move(sortingKeys));
 }
 
+TEST_F(ParquetTpchTest, Q4) {
+  std::vector<uint32_t> sortingKeys{0};
+  assertQuery(4, std::move(sortingKeys));
+}
+
 TEST_F(ParquetTpchTest, Q5) {
   std::vector<uint32_t> sortingKeys{1};
   assertQuery(5, std::move(sortingKeys));
@@ -181,11 +198,31 @@ TEST_F(ParquetTpchTest, Q6) {
   assertQuery(6);
 }
 
+TEST_F(ParquetTpchTest, Q7) {
+  std::vector<uint32_t> sortingKeys{0, 1, 2};
+  assertQuery(7, std::move(sortingKeys));
+}
+
+TEST_F(ParquetTpchTest, Q8) {
+  std::vector<uint32_t> sortingKeys{0};
+  assertQuery(8, std::move(sortingKeys));
+}
+
+TEST_F(ParquetTpchTest, Q9) {
+  std::vector<uint32_t> sortingKeys{0, 1};
+  assertQuery(9, std::move(sortingKeys));
+}
+
 TEST_F(ParquetTpchTest, Q10) {
   std::vector<uint32_t> sortingKeys{2};
   assertQuery(10, std::move(sortingKeys));
 }
 
+TEST_F(ParquetTpchTest, Q11) {
+  std::vector<uint32_t> sortingKeys{1};
+  assertQuery(11, std::move(sortingKeys));
+}
+
 TEST_F(ParquetTpchTest, Q12) {
   std::vector<uint32_t> sortingKeys{0};
   assertQuery(12, std::move(sortingKeys));
@@ -200,6 +237,20 @@ TEST_F(ParquetTpchTest, Q14) {
   assertQuery(14);
 }
 
+TEST_F(ParquetTpchTest, Q15) {
+  std::vector<uint32_t> sortingKeys{0};
+  assertQuery(15, std::move(sortingKeys));
+}
+
+TEST_F(ParquetTpchTest, Q16) {
+  std::vector<uint32_t> sortingKeys{3, 0, 1, 2};
+  assertQuery(16, std::move(sortingKeys));
+}
+
+TEST_F(ParquetTpchTest, Q17) {
+  assertQuery(17);
+}
+
 TEST_F(ParquetTpchTest, Q18) {
   assertQuery(18);
 }
@@ -208,6 +259,21 @@ TEST_F(ParquetTpchTest, Q19) {
   assertQuery(19);
 }
 
+TEST_F(ParquetTpchTest, Q20) {
+  std::vector<uint32_t> sortingKeys{0};
+  assertQuery(20, std::move(sortingKeys));
+}
+
+TEST_F(ParquetTpchTest, Q21) {
+  std::vector<uint32_t> sortingKeys{1, 0};
+  assertQuery(21, std::move(sortingKeys));
+}
+
+TEST_F(ParquetTpchTest, Q22) {
+  std::vector<uint32_t> sortingKeys{0};
+  assertQuery(22, std::move(sortingKeys));
+}
+
 int main(int argc, char** argv) {
   testing::InitGoogleTest(&argc, argv);
   folly::init(&argc, &argv, false);
@@ -0,0 +1,132 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "velox/dwio/parquet/reader/PageIndex.h"
+
+#include <folly/lang/Bits.h>
+#include <gtest/gtest.h>
+
+using namespace facebook::velox;
+using namespace facebook::velox::parquet;
+
+namespace {
+
+std::string encodeInt64(int64_t value) {
+  std::string bytes(sizeof(value), '\0');
+  folly::storeUnaligned(bytes.data(), value);
+  return bytes;
+}
+
+// Makes the indexes of a column chunk with pages starting at 'firstRows'.
+// A page with no min and max is all nulls. The other pages have no nulls.
+void makeIndexes(
+    const std::vector<int64_t>& firstRows,
+    const std::vector<std::optional<std::pair<int64_t, int64_t>>>& minMax,
+    thrift::ColumnIndex& columnIndex,
+    thrift::OffsetIndex& offsetIndex) {
+  std::vector<thrift::PageLocation> locations;
+  std::vector<bool> nullPages;
+  std::vector<std::string> mins;
+  std::vector<std::string> maxes;
+  std::vector<int64_t> nullCounts;
+  for (auto i = 0; i < firstRows.size(); ++i) {
+    thrift::PageLocation location;
+    location.__set_offset(1000 * i);
+    location.__set_compressed_page_size(1000);
+    location.__set_first_row_index(firstRows[i]);
+    locations.push_back(location);
+    nullPages.push_back(!minMax[i].has_value());
+    mins.push_back(minMax[i] ? encodeInt64(minMax[i]->first) : "");
+    maxes.push_back(minMax[i] ? encodeInt64(minMax[i]->second) : "");
+    nullCounts.push_back(minMax[i] ? 0 : 1);
+  }
+  offsetIndex.__set_page_locations(locations);
+  columnIndex.__set_null_pages(nullPages);
+  columnIndex.__set_min_values(mins);
+  columnIndex.__set_max_values(maxes);
+  columnIndex.__set_null_counts(nullCounts);
+}
+
+void expectRanges(const RowRanges& expected, const RowRanges& actual) {
+  ASSERT_EQ(expected.size(), actual.size());
+  for (auto i = 0; i < expected.size(); ++i) {
+    EXPECT_EQ(expected[i].begin, actual[i].begin) << i;
+    EXPECT_EQ(expected[i].end, actual[i].end) << i;
+  }
+}
+
+} // namespace
+
+TEST(PageIndexTest, pageRows) {
+  thrift::ColumnIndex columnIndex;
+  thrift::OffsetIndex offsetIndex;
+  makeIndexes(
+      {0, 100, 250}, {{{1, 2}}, {{3, 4}}, {{5, 6}}}, columnIndex, offsetIndex);
+  auto rows = pageRows(offsetIndex, 1, 300);
+  EXPECT_EQ(100, rows.begin);
+  EXPECT_EQ(250, rows.end);
+  rows = pageRows(offsetIndex, 2, 300);
+  EXPECT_EQ(250, rows.begin);
+  EXPECT_EQ(300, rows.end);
+}
+
+TEST(PageIndexTest, filterPages) {
+  ParquetColumn column{0, "c", thrift::Type::INT64, BIGINT(), 1};
+  thrift::ColumnIndex columnIndex;
+  thrift::OffsetIndex offsetIndex;
+  makeIndexes(
+      {0, 100, 200, 300, 400},
+      {{{0, 99}}, {{100, 199}}, std::nullopt, {{150, 250}}, {{300, 399}}},
+      columnIndex,
+      offsetIndex);
+
+  common::BigintRange range(120, 160, false);
+  expectRanges(
+      {{100, 200}, {300, 400}},
+      filterPages(column, range, columnIndex, offsetIndex, 500));
+
+  // Adjacent passing pages are merged.
+  common::BigintRange wide(50, 350, false);
+  expectRanges(
+      {{0, 200}, {300, 500}},
+      filterPages(column, wide, columnIndex, offsetIndex, 500));
+
+  // Only the all null page can have nulls.
+  common::IsNull isNull;
+  expectRanges(
+      {{200, 300}}, filterPages(column, isNull, columnIndex, offsetIndex, 500));
+
+  common::BigintRange none(1000, 2000, false);
+  expectRanges({}, filterPages(column, none, columnIndex, offsetIndex, 500));
+}
+
+TEST(PageIndexTest, intersectRanges) {
+  expectRanges(
+      {{10, 20}, {40, 45}, {50, 60}},
+      intersectRanges({{0, 20}, {40, 60}}, {{10, 45}, {50, 100}}));
+  expectRanges({}, intersectRanges({{0, 10}}, {{10, 20}}));
+  expectRanges({}, intersectRanges({}, {{0, 20}}));
+}
+
+TEST(PageIndexTest, overlapsRanges) {
+  RowRanges ranges{{10, 20}, {40, 60}};
+  EXPECT_FALSE(overlapsRanges(ranges, 0, 10));
+  EXPECT_TRUE(overlapsRanges(ranges, 0, 11));
+  EXPECT_TRUE(overlapsRanges(ranges, 19, 40));
+  EXPECT_FALSE(overlapsRanges(ranges, 20, 40));
+  EXPECT_TRUE(overlapsRanges(ranges, 45, 50));
+  EXPECT_FALSE(overlapsRanges(ranges, 60, 100));
+}
@@ -0,0 +1,132 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#include "velox/dwio/parquet/reader/RleBpDecoder.h"
+
+#include <gtest/gtest.h>
+
+using namespace facebook::velox;
+using namespace facebook::velox::parquet;
+
+namespace {
+
+// Appends a run of 'count' copies of 'value' of 'byteWidth' bytes.
+void appendRleRun(
+    std::string& data,
+    uint32_t count,
+    uint32_t value,
+    int32_t byteWidth) {
+  auto header = count << 1;
+  do {
+    uint8_t byte = header & 0x7f;
+    header >>= 7;
+    data.push_back(header ? byte | 0x80 : byte);
+  } while (header);
+  for (auto i = 0; i < byteWidth; ++i) {
+    data.push_back((value >> (8 * i)) & 0xff);
+  }
+}
+
+// Appends 'values' bit-packed in groups of 8, padding the last group with
+// zeros.
+void appendBitPackedRun(
+    std::string& data,
+    const std::vector<uint32_t>& values,
+    int32_t bitWidth) {
+  auto numGroups = (values.size() + 7) / 8;
+  data.push_back((numGroups << 1) | 1);
+  std::string packed(numGroups * bitWidth, '\0');
+  for (auto i = 0; i < values.size(); ++i) {
+    for (auto bit = 0; bit < bitWidth; ++bit) {
+      if (values[i] & (1U << bit)) {
+        auto offset = i * bitWidth + bit;
+        packed[offset / 8] |= 1 << (offset % 8);
+      }
+    }
+  }
+  data += packed;
+}
+
+} // namespace
+
+TEST(RleBpDecoderTest, mixedRuns) {
+  std::vector<uint32_t> packed{1, 5, 0, 7, 3, 2, 6, 4, 1, 1, 7, 0, 5, 3, 2, 6};
+  std::string data;
+  appendRleRun(data, 300, 5, 1);
+  appendBitPackedRun(data, packed, 3);
+  appendRleRun(data, 10, 2, 1);
+
+  std::vector<int32_t> expected(300, 5);
+  expected.insert(expected.end(), packed.begin(), packed.end());
+  expected.insert(expected.end(), 10, 2);
+
+  RleBpDecoder decoder(data.data(), data.data() + data.size(), 3);
+  std::vector<int32_t> values(expected.size());
+  // Reads across run boundaries.
+  decoder.next(values.data(), 299);
+  decoder.next(values.data() + 299, 5);
+  decoder.next(values.data() + 304, expected.size() - 304);
+  for (auto i = 0; i < expected.size(); ++i) {
+    ASSERT_EQ(values[i], expected[i]) << i;
+  }
+}
+
+TEST(RleBpDecoderTest, skip) {
+  std::vector<uint32_t> packed{1, 5, 0, 7, 3, 2, 6, 4};
+  std::string data;
+  appendRleRun(data, 20, 1, 1);
+  appendBitPackedRun(data, packed, 3);
+  appendBitPackedRun(data, packed, 3);
+
+  RleBpDecoder decoder(data.data(), data.data() + data.size(), 3);
+  int32_t value;
+  decoder.skip(19);
+  decoder.next(&value, 1);
+  EXPECT_EQ(value, 1);
+  decoder.skip(3);
+  decoder.next(&value, 1);
+  EXPECT_EQ(value, 7);
+  // Skips into the middle of the next bit-packed run.
+  decoder.skip(6);
+  decoder.next(&value, 1);
+  EXPECT_EQ(value, 0);
+}
+
+TEST(RleBpDecoderTest, readBits) {
+  // Definition levels of 1 bit, as for the nulls of an optional column. A
+  // bit-packed run that is not the last has a multiple of 8 values.
+  std::vector<uint32_t> packed(104);
+  for (auto i = 0; i < packed.size(); ++i) {
+    packed[i] = i % 3 != 0;
+  }
+  std::string data;
+  appendRleRun(data, 70, 1, 1);
+  appendBitPackedRun(data, packed, 1);
+  appendRleRun(data, 30, 0, 1);
+
+  RleBpDecoder decoder(data.data(), data.data() + data.size(), 1);
+  std::vector<uint64_t> bits(4, ~0ULL);
+  // Starts at an unaligned offset.
+  decoder.readBits(200, bits.data(), 5);
+  for (auto i = 0; i < 200; ++i) {
+    bool expected = i < 70 ? true : i < 174 ? packed[i - 70] != 0 : false;
+    ASSERT_EQ(bits::isBitSet(bits.data(), i + 5), expected) << i;
+  }
+  for (auto i = 0; i < 5; ++i) {
+    EXPECT_TRUE(bits::isBitSet(bits.data(), i));
+  }
+}
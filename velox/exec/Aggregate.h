@@ -18,6 +18,8 @@
 #include "velox/common/memory/HashStringAllocator.h"
 #include "velox/core/PlanNode.h"
 #include "velox/vector/BaseVector.h"
+#include "velox/vector/DecodedVector.h"
+#include "velox/vector/LazyVector.h"
 
 namespace facebook::velox::exec {
 
@@ -53,6 +55,13 @@ class Aggregate {
     return false;
   }
 
+  // Returns true if the accumulator may keep data in the
+  // HashStringAllocator given to setAllocator(). Such data may not be
+  // moved by the RowContainer when it compacts.
+  virtual bool accumulatorUsesAllocator() const {
+    return true;
+  }
+
   // Returns true if the accumulator never takes more than
   // accumulatorFixedWidthSize() bytes. If this is false, the
   // accumulator needs to track its changing variable length footprint
@@ -235,6 +244,48 @@ class Aggregate {
     *ptr = std::min<uint64_t>(size, std::numeric_limits<uint32_t>::max());
   }
 
+  // Loads the LazyVector under 'arg' for 'rows' into a THook that updates
+  // the accumulators of 'groups' without materializing the values.
+  // 'hookArgs' are passed to the THook constructor after the accumulator
+  // layout.
+  template <typename THook, typename... HookArgs>
+  void pushdown(
+      char** groups,
+      const SelectivityVector& rows,
+      const VectorPtr& arg,
+      HookArgs&&... hookArgs) {
+    pushdownDecoded_.decode(*arg, rows, false);
+    auto& decoded = pushdownDecoded_;
+    const vector_size_t* indices = decoded.indices();
+    THook hook(
+        offset_,
+        nullByte_,
+        nullMask_,
+        groups,
+        &numNulls_,
+        std::forward<HookArgs>(hookArgs)...);
+    // The decoded vector does not really keep the info from the 'rows', except
+    // for the 'upper bound' of it. In case not all rows are selected we need to
+    // generate proper indices, which we 'indirect' through the ones we got from
+    // the decoded vector.
+    vector_size_t numIndices{arg->size()};
+    if (not rows.isAllSelected()) {
+      const auto numSelected = rows.countSelected();
+      if (numSelected != arg->size()) {
+        pushdownCustomIndices_.resize(numSelected);
+        vector_size_t tgtIndex{0};
+        rows.template applyToSelected([&](vector_size_t i) {
+          pushdownCustomIndices_[tgtIndex++] = indices[i];
+        });
+        indices = pushdownCustomIndices_.data();
+        numIndices = numSelected;
+      }
+    }
+
+    decoded.base()->as<const LazyVector>()->load(
+        RowSet(indices, numIndices), &hook);
+  }
+
   // Sets null flag for all specified groups to true.
   // For any given group, this method can be called at most once.
   void setAllNulls(char** groups, folly::Range<const vector_size_t*> indices) {
@@ -312,6 +363,9 @@ class Aggregate {
   // different indices vector as the one we get from the DecodedVector is simply
   // sequential.
   std::vector<vector_size_t> pushdownCustomIndices_;
+
+  // Decodes the argument of pushdown(). Kept to reuse memory between batches.
+  DecodedVector pushdownDecoded_;
 };
 
 using AggregateFunctionFactory = std::function<std::unique_ptr<Aggregate>(
@@ -0,0 +1,118 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "velox/exec/AggregationDistincts.h"
+#include "velox/exec/Aggregate.h"
+
+namespace facebook::velox::exec {
+
+AggregationDistincts::AggregationDistincts(
+    std::vector<bool> distincts,
+    memory::MappedMemory* FOLLY_NONNULL mappedMemory,
+    memory::MemoryPool* FOLLY_NONNULL pool)
+    : distincts_(std::move(distincts)),
+      numDistinct_(std::count(distincts_.begin(), distincts_.end(), true)),
+      mappedMemory_(mappedMemory),
+      pool_(pool),
+      sets_(distincts_.size()) {}
+
+AggregationDistincts::DistinctSet& AggregationDistincts::distinctSet(
+    int32_t aggregationIndex,
+    bool isGlobal,
+    const std::vector<VectorPtr>& args) {
+  auto& set = sets_[aggregationIndex];
+  if (set) {
+    return *set;
+  }
+
+  std::vector<std::unique_ptr<VectorHasher>> hashers;
+  if (!isGlobal) {
+    hashers.push_back(VectorHasher::create(BIGINT(), 0));
+  }
+  for (const auto& arg : args) {
+    hashers.push_back(VectorHasher::create(arg->type(), hashers.size()));
+  }
+
+  static const std::vector<std::unique_ptr<Aggregate>> kNoAggregates;
+  set = std::make_unique<DistinctSet>();
+  set->table = HashTable<false>::createForAggregation(
+      std::move(hashers), kNoAggregates, mappedMemory_);
+  set->table->forceGenericHashMode();
+  set->lookup = std::make_unique<HashLookup>(set->table->hashers());
+  return *set;
+}
+
+const SelectivityVector& AggregationDistincts::newRows(
+    int32_t aggregationIndex,
+    char* FOLLY_NULLABLE* FOLLY_NULLABLE groups,
+    const SelectivityVector& rows,
+    const std::vector<VectorPtr>& args) {
+  VELOX_DCHECK(isDistinct(aggregationIndex));
+  auto& set = distinctSet(aggregationIndex, groups == nullptr, args);
+  auto& lookup = *set.lookup;
+  const auto& hashers = set.table->hashers();
+  lookup.reset(rows.end());
+
+  int32_t hasherIndex = 0;
+  if (groups) {
+    if (!groupAddresses_ || !groupAddresses_.unique()) {
+      groupAddresses_ = BaseVector::create(BIGINT(), rows.end(), pool_);
+    } else {
+      groupAddresses_->resize(rows.end());
+    }
+    auto* rawAddresses =
+        groupAddresses_->asUnchecked<FlatVector<int64_t>>()->mutableRawValues();
+    rows.applyToSelected([&](vector_size_t row) {
+      rawAddresses[row] = reinterpret_cast<int64_t>(groups[row]);
+    });
+    hashers[hasherIndex++]->hash(
+        *groupAddresses_, rows, false, lookup.hashes);
+  }
+  for (const auto& arg : args) {
+    hashers[hasherIndex]->hash(
+        *arg->loadedVector(), rows, hasherIndex > 0, lookup.hashes);
+    ++hasherIndex;
+  }
+
+  lookup.rows.clear();
+  rows.applyToSelected([&](vector_size_t row) { lookup.rows.push_back(row); });
+  set.table->groupProbe(lookup);
+
+  newRows_.resizeFill(rows.end(), false);
+  for (auto row : lookup.newGroups) {
+    newRows_.setValid(row, true);
+  }
+  newRows_.updateBounds();
+  return newRows_;
+}
+
+void AggregationDistincts::clear() {
+  for (auto& set : sets_) {
+    if (set) {
+      set->table->clear();
+    }
+  }
+}
+
+uint64_t AggregationDistincts::allocatedBytes() const {
+  uint64_t bytes = 0;
+  for (const auto& set : sets_) {
+    if (set) {
+      bytes += set->table->allocatedBytes();
+    }
+  }
+  return bytes;
+}
+} // namespace facebook::velox::exec
@@ -0,0 +1,88 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#pragma once
+
+#include "velox/exec/HashTable.h"
+#include "velox/vector/ComplexVector.h"
+
+namespace facebook::velox::exec {
+
+/// Keeps the combinations of group and argument values seen by the
+/// aggregates with the DISTINCT flag, e.g. count(DISTINCT c), so that each
+/// combination is added to the aggregate only once. Each distinct aggregate
+/// has a hash table keyed on the address of the group row followed by the
+/// arguments. Global aggregations have a single group and key on the
+/// arguments only.
+class AggregationDistincts {
+ public:
+  /// @param distincts Empty or one flag per aggregation. True for distinct
+  /// aggregations.
+  AggregationDistincts(
+      std::vector<bool> distincts,
+      memory::MappedMemory* FOLLY_NONNULL mappedMemory,
+      memory::MemoryPool* FOLLY_NONNULL pool);
+
+  bool empty() const {
+    return numDistinct_ == 0;
+  }
+
+  bool isDistinct(int32_t aggregationIndex) const {
+    return aggregationIndex < distincts_.size() && distincts_[aggregationIndex];
+  }
+
+  /// Returns the subset of 'rows' whose combination of group in 'groups' and
+  /// values in 'args' is new for distinct aggregation 'aggregationIndex'.
+  /// Records the new combinations. 'groups' is nullptr for a global
+  /// aggregation. The result is valid until the next call.
+  const SelectivityVector& newRows(
+      int32_t aggregationIndex,
+      char* FOLLY_NULLABLE* FOLLY_NULLABLE groups,
+      const SelectivityVector& rows,
+      const std::vector<VectorPtr>& args);
+
+  /// Forgets all combinations. Must be called when the groups are freed,
+  /// since the addresses of new groups may repeat those of the old ones.
+  void clear();
+
+  uint64_t allocatedBytes() const;
+
+ private:
+  struct DistinctSet {
+    std::unique_ptr<BaseHashTable> table;
+    std::unique_ptr<HashLookup> lookup;
+  };
+
+  // Creates the set for an aggregation with 'args' on first use.
+  DistinctSet& distinctSet(
+      int32_t aggregationIndex,
+      bool isGlobal,
+      const std::vector<VectorPtr>& args);
+
+  const std::vector<bool> distincts_;
+  const int32_t numDistinct_;
+  memory::MappedMemory* FOLLY_NONNULL const mappedMemory_;
+  memory::MemoryPool* FOLLY_NONNULL const pool_;
+
+  // One set per aggregation. nullptr for aggregations without DISTINCT and
+  // until first use.
+  std::vector<std::unique_ptr<DistinctSet>> sets_;
+
+  // Addresses of the groups of the current input as BIGINT keys.
+  VectorPtr groupAddresses_;
+
+  SelectivityVector newRows_;
+};
+} // namespace facebook::velox::exec
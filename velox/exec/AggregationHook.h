@@ -39,6 +39,24 @@ class AggregationHook : public ValueHook {
   // templating a column decoding loop with a hook.
   static constexpr bool kSkipNulls = true;
 
+  // True if column readers pass values of 'kind' to hooks. Other types,
+  // e.g. timestamps and complex types, are always materialized.
+  static bool supportsKind(TypeKind kind) {
+    switch (kind) {
+      case TypeKind::BOOLEAN:
+      case TypeKind::TINYINT:
+      case TypeKind::SMALLINT:
+      case TypeKind::INTEGER:
+      case TypeKind::BIGINT:
+      case TypeKind::REAL:
+      case TypeKind::DOUBLE:
+      case TypeKind::VARCHAR:
+        return true;
+      default:
+        return false;
+    }
+  }
+
   AggregationHook(
       int32_t offset,
       int32_t nullByte,
@@ -162,6 +180,50 @@ class SimpleCallableHook final : public AggregationHook {
   UpdateSingleValue updateSingleValue_;
 };
 
+// Counts the non-null values of each group. The count is never null, so
+// there are no null flags to clear.
+class CountHook final : public AggregationHook {
+ public:
+  CountHook(
+      int32_t offset,
+      int32_t nullByte,
+      uint8_t nullMask,
+      char** groups,
+      uint64_t* numNulls)
+      : AggregationHook(offset, nullByte, nullMask, groups, numNulls) {}
+
+  void addValue(vector_size_t row, const void* /*value*/) override {
+    ++*reinterpret_cast<int64_t*>(findGroup(row) + offset_);
+  }
+
+  void addValues(
+      const vector_size_t* rows,
+      const void* /*values*/,
+      vector_size_t size,
+      uint8_t /*valueWidth*/) override {
+    for (auto i = 0; i < size; ++i) {
+      ++*reinterpret_cast<int64_t*>(findGroup(rows[i]) + offset_);
+    }
+  }
+};
+
+// Counts the true values of each group. The count is never null.
+class CountIfHook final : public AggregationHook {
+ public:
+  CountIfHook(
+      int32_t offset,
+      int32_t nullByte,
+      uint8_t nullMask,
+      char** groups,
+      uint64_t* numNulls)
+      : AggregationHook(offset, nullByte, nullMask, groups, numNulls) {}
+
+  void addValue(vector_size_t row, const void* value) override {
+    *reinterpret_cast<int64_t*>(findGroup(row) + offset_) +=
+        *reinterpret_cast<const bool*>(value);
+  }
+};
+
 template <typename T, bool isMin>
 class MinMaxHook final : public AggregationHook {
  public:
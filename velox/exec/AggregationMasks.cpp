@@ -14,16 +14,26 @@
  * limitations under the License.
  */
 #include "velox/exec/AggregationMasks.h"
+#include <algorithm>
+#include <numeric>
 #include "velox/vector/SelectivityVector.h"
 
 namespace facebook::velox::exec {
 
 AggregationMasks::AggregationMasks(
-    std::vector<std::optional<column_index_t>> maskChannels)
-    : maskChannels_{std::move(maskChannels)} {
-  for (const auto& maskChannel : maskChannels_) {
-    if (maskChannel.has_value()) {
-      maskedRows_.insert({maskChannel.value(), SelectivityVector::empty()});
+    std::vector<std::optional<column_index_t>> maskChannels) {
+  maskIndices_.reserve(maskChannels.size());
+  for (const auto& maskChannel : maskChannels) {
+    if (!maskChannel.has_value()) {
+      maskIndices_.push_back(kNoMask);
+      continue;
+    }
+    auto it = std::find(
+        maskChannels_.begin(), maskChannels_.end(), maskChannel.value());
+    maskIndices_.push_back(it - maskChannels_.begin());
+    if (it == maskChannels_.end()) {
+      maskChannels_.push_back(maskChannel.value());
+      maskedRows_.push_back(SelectivityVector::empty());
     }
   }
 }
@@ -31,12 +41,15 @@ AggregationMasks::AggregationMasks(
 void AggregationMasks::addInput(
     const RowVectorPtr& input,
     const SelectivityVector& rows) {
-  for (auto& entry : maskedRows_) {
-    SelectivityVector& maskedRows = entry.second;
+  for (auto i = 0; i < maskChannels_.size(); ++i) {
+    SelectivityVector& maskedRows = maskedRows_[i];
     maskedRows = rows;
+    if (!rows.hasSelections()) {
+      continue;
+    }
 
     // Get the projection column vector that would be our mask.
-    const auto& maskVector = input->childAt(entry.first);
+    const auto& maskVector = input->childAt(maskChannels_[i]);
 
     // Get decoded vector and update the masked selectivity vector.
     decodedMask_.decode(*maskVector, rows);
@@ -46,10 +59,19 @@ void AggregationMasks::addInput(
         maskedRows.setValidRange(rows.begin(), rows.end(), false);
         maskedRows.updateBounds();
       }
+    } else if (decodedMask_.isIdentityMapping()) {
+      // A flat mask is applied a word at a time. Both the values and the
+      // nulls have a set bit for rows that pass.
+      maskedRows.deselectNulls(
+          decodedMask_.data<uint64_t>(), rows.begin(), rows.end());
+      if (decodedMask_.nulls()) {
+        maskedRows.deselectNulls(
+            decodedMask_.nulls(), rows.begin(), rows.end());
+      }
     } else {
-      rows.applyToSelected([&](vector_size_t i) {
-        if (decodedMask_.isNullAt(i) || !decodedMask_.valueAt<bool>(i)) {
-          maskedRows.setValid(i, false);
+      rows.applyToSelected([&](vector_size_t row) {
+        if (decodedMask_.isNullAt(row) || !decodedMask_.valueAt<bool>(row)) {
+          maskedRows.setValid(row, false);
         }
       });
       maskedRows.updateBounds();
@@ -59,12 +81,35 @@ void AggregationMasks::addInput(
 
 const SelectivityVector* FOLLY_NULLABLE
 AggregationMasks::activeRows(int32_t aggregationIndex) const {
-  if (maskChannels_[aggregationIndex].has_value()) {
-    auto it = maskedRows_.find(maskChannels_[aggregationIndex].value());
-    VELOX_CHECK(it != maskedRows_.end());
-    return &it->second;
+  const auto maskIndex = maskIndices_[aggregationIndex];
+  if (maskIndex == kNoMask) {
+    return nullptr;
   }
+  return &maskedRows_[maskIndex];
+}
+
+std::vector<int32_t> AggregationMasks::evaluationOrder(
+    const std::vector<std::vector<column_index_t>>& inputChannels) const {
+  VELOX_CHECK_EQ(inputChannels.size(), maskIndices_.size());
+  std::vector<int32_t> order(maskIndices_.size());
+  std::iota(order.begin(), order.end(), 0);
+  // kNoMask sorts first. Ties keep the original order.
+  std::stable_sort(
+      order.begin(), order.end(), [&](int32_t left, int32_t right) {
+        if (maskIndices_[left] != maskIndices_[right]) {
+          return maskIndices_[left] < maskIndices_[right];
+        }
+        return inputChannels[left] < inputChannels[right];
+      });
+  return order;
+}
 
-  return nullptr;
+// static
+bool AggregationMasks::sameInputs(
+    const std::vector<column_index_t>& channels,
+    const std::vector<column_index_t>& otherChannels) {
+  return channels == otherChannels &&
+      std::find(channels.begin(), channels.end(), kConstantChannel) ==
+      channels.end();
 }
 } // namespace facebook::velox::exec
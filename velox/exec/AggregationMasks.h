@@ -23,12 +23,13 @@ namespace facebook::velox::exec {
 class AggregationMasks {
  public:
   /// @param maskChannel Index of the 'mask' column for each aggregation.
-  /// Aggregations without masks use std::nullopt.
+  /// Aggregations without masks use std::nullopt. Aggregations with the same
+  /// mask channel share one selectivity vector.
   explicit AggregationMasks(
       std::vector<std::optional<column_index_t>> maskChannels);
 
-  /// Process the input batch and prepare selectivity vectors for each mask by
-  /// removing masked rows.
+  /// Process the input batch and prepare a selectivity vector for each
+  /// distinct mask by removing masked rows.
   void addInput(const RowVectorPtr& input, const SelectivityVector& rows);
 
   // Return prepared selectivity vector for a given aggregation. Must be called
@@ -36,9 +37,29 @@ class AggregationMasks {
   const SelectivityVector* FOLLY_NULLABLE
   activeRows(int32_t aggregationIndex) const;
 
+  /// Returns the order in which to update the aggregations. Aggregations
+  /// without a mask come first, followed by the aggregations of each distinct
+  /// mask in order of first use. Within a mask, aggregations over the same
+  /// 'inputChannels' are adjacent, so that the rows of a mask and the
+  /// argument vectors are prepared once for a run of aggregations.
+  std::vector<int32_t> evaluationOrder(
+      const std::vector<std::vector<column_index_t>>& inputChannels) const;
+
+  /// Returns true if the argument vectors for 'channels' can be reused for
+  /// 'otherChannels'. Constant arguments are never shared.
+  static bool sameInputs(
+      const std::vector<column_index_t>& channels,
+      const std::vector<column_index_t>& otherChannels);
+
  private:
-  std::vector<std::optional<column_index_t>> maskChannels_;
-  std::unordered_map<column_index_t, SelectivityVector> maskedRows_;
+  // Index into 'maskChannels_' and 'maskedRows_' for each aggregation, or
+  // kNoMask.
+  static constexpr int32_t kNoMask = -1;
+  std::vector<int32_t> maskIndices_;
+
+  // The distinct mask channels and the rows that pass each, pairwise.
+  std::vector<column_index_t> maskChannels_;
+  std::vector<SelectivityVector> maskedRows_;
   DecodedVector decodedMask_;
 };
 } // namespace facebook::velox::exec
@@ -0,0 +1,71 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "velox/exec/ArrowStream.h"
+#include "velox/vector/arrow/Abi.h"
+
+namespace facebook::velox::exec {
+
+ArrowStream::ArrowStream(
+    int32_t operatorId,
+    DriverCtx* driverCtx,
+    std::shared_ptr<const core::ArrowStreamNode> arrowStreamNode)
+    : SourceOperator(
+          driverCtx,
+          arrowStreamNode->outputType(),
+          operatorId,
+          arrowStreamNode->id(),
+          "ArrowStream") {
+  // Takes over the stream. A second execution of the plan finds it released.
+  importer_ = std::make_unique<ArrowStreamImporter>(
+      *arrowStreamNode->arrowStream(), pool());
+  VELOX_CHECK(
+      importer_->type()->equivalent(*outputType_),
+      "ArrowArrayStream produces {}, expected {}",
+      importer_->type()->toString(),
+      outputType_->toString());
+}
+
+RowVectorPtr ArrowStream::getOutput() {
+  if (finished_) {
+    return nullptr;
+  }
+  auto vector = importer_->next();
+  if (vector == nullptr) {
+    // Releases the stream as soon as it ends.
+    finished_ = true;
+    importer_.reset();
+    return nullptr;
+  }
+  // Operator::getOutput is expected to return nullptr or a non-empty vector.
+  // Vectors must also carry the names of the output type.
+  if (vector->size() == 0) {
+    return nullptr;
+  }
+  return std::make_shared<RowVector>(
+      vector->pool(),
+      outputType_,
+      vector->nulls(),
+      vector->size(),
+      vector->children());
+}
+
+void ArrowStream::close() {
+  finished_ = true;
+  importer_.reset();
+  Operator::close();
+}
+
+} // namespace facebook::velox::exec
@@ -29,6 +29,52 @@ const ContainerRowSerde& ContainerRowSerde::instance() {
 
 namespace {
 
+// Returns true if values of 'kind' are serialized as their native fixed
+// width representation. Arrays of these are read and written as blocks
+// of values with one dispatch on the type per array instead of one per
+// element.
+bool isFixedWidth(TypeKind kind) {
+  switch (kind) {
+    case TypeKind::TINYINT:
+    case TypeKind::SMALLINT:
+    case TypeKind::INTEGER:
+    case TypeKind::BIGINT:
+    case TypeKind::REAL:
+    case TypeKind::DOUBLE:
+      return true;
+    default:
+      return false;
+  }
+}
+
+// Returns true if 'elements' is a flat vector of a fixed width type.
+bool isFlatFixedWidth(const BaseVector& elements) {
+  return elements.encoding() == VectorEncoding::Simple::FLAT &&
+      isFixedWidth(elements.typeKind());
+}
+
+// Calls 'func' with a default constructed value of the native type of
+// 'kind', which must be fixed width.
+template <typename Func>
+auto fixedWidthDispatch(TypeKind kind, Func func) {
+  switch (kind) {
+    case TypeKind::TINYINT:
+      return func(int8_t());
+    case TypeKind::SMALLINT:
+      return func(int16_t());
+    case TypeKind::INTEGER:
+      return func(int32_t());
+    case TypeKind::BIGINT:
+      return func(int64_t());
+    case TypeKind::REAL:
+      return func(float());
+    case TypeKind::DOUBLE:
+      return func(double());
+    default:
+      VELOX_UNREACHABLE();
+  }
+}
+
 // Copy from vector to stream.
 void serializeSwitch(
     const BaseVector& source,
@@ -133,6 +179,22 @@ void serializeArray(
     ByteStream& out) {
   out.appendOne<int32_t>(size);
   writeNulls(elements, offset, size, out);
+  if (isFlatFixedWidth(elements)) {
+    fixedWidthDispatch(elements.typeKind(), [&](auto dummy) {
+      using T = decltype(dummy);
+      auto values = elements.asUnchecked<FlatVector<T>>()->rawValues();
+      if (!elements.mayHaveNulls()) {
+        out.append<T>(folly::Range<const T*>(values + offset, size));
+        return;
+      }
+      for (auto i = offset; i < offset + size; ++i) {
+        if (!elements.isNullAt(i)) {
+          out.appendOne<T>(values[i]);
+        }
+      }
+    });
+    return;
+  }
   for (auto i = 0; i < size; ++i) {
     if (!elements.isNullAt(i + offset)) {
       serializeSwitch(elements, i + offset, out);
@@ -146,6 +208,18 @@ void serializeArray(
     ByteStream& out) {
   out.appendOne<int32_t>(indices.size());
   writeNulls(elements, indices, out);
+  if (isFlatFixedWidth(elements)) {
+    fixedWidthDispatch(elements.typeKind(), [&](auto dummy) {
+      using T = decltype(dummy);
+      auto values = elements.asUnchecked<FlatVector<T>>()->rawValues();
+      for (auto i : indices) {
+        if (!elements.isNullAt(i)) {
+          out.appendOne<T>(values[i]);
+        }
+      }
+    });
+    return;
+  }
   for (auto i : indices) {
     if (!elements.isNullAt(i)) {
       serializeSwitch(elements, i, out);
@@ -276,6 +350,20 @@ deserializeArray(ByteStream& in, BaseVector& elements, vector_size_t& offset) {
   auto nulls = readNulls(in, size);
   offset = elements.size();
   elements.resize(offset + size);
+  if (isFlatFixedWidth(elements)) {
+    fixedWidthDispatch(elements.typeKind(), [&](auto dummy) {
+      using T = decltype(dummy);
+      auto values = elements.asUnchecked<FlatVector<T>>();
+      for (auto i = 0; i < size; ++i) {
+        if (bits::isBitSet(nulls.data(), i)) {
+          values->setNull(i + offset, true);
+        } else {
+          values->set(i + offset, in.read<T>());
+        }
+      }
+    });
+    return size;
+  }
   for (auto i = 0; i < size; ++i) {
     if (bits::isBitSet(nulls.data(), i)) {
       elements.setNull(i + offset, true);
@@ -435,74 +523,106 @@ int compare<TypeKind::ROW>(
   return 0;
 }
 
-int32_t compareArrays(
+// Compares the elements of a serialized array of 'leftSize' elements
+// with 'rightSize' elements of 'elements'. The index in 'elements' of
+// the ith element on the right is 'elementIndex(i)'.
+template <typename IndexFunc>
+int32_t compareArrayElements(
     ByteStream& left,
-    BaseVector& elements,
-    vector_size_t offset,
-    vector_size_t rightSize,
+    int32_t leftSize,
+    const BaseVector& elements,
+    int32_t rightSize,
+    IndexFunc elementIndex,
     CompareFlags flags) {
   VELOX_DCHECK(!flags.stopAtNull, "not supported compare flag");
 
-  int leftSize = left.read<int32_t>();
   if (leftSize != rightSize && flags.equalsOnly) {
     return flags.ascending ? 1 : -1;
   }
   auto compareSize = std::min(leftSize, rightSize);
   auto leftNulls = readNulls(left, leftSize);
   auto wrappedElements = elements.wrappedVector();
-  for (auto i = 0; i < compareSize; ++i) {
-    auto elementIndex = elements.wrappedIndex(offset + i);
+  // Returns 0 if both are null or both are not null.
+  auto compareNulls = [&](auto i, auto index) {
     bool leftNull = bits::isBitSet(leftNulls.data(), i);
-    bool rightNull = wrappedElements->isNullAt(elementIndex);
-    if (leftNull) {
-      if (rightNull) {
-        continue;
-      }
-      return flags.nullsFirst ? -1 : 1;
-    } else if (rightNull) {
-      return flags.nullsFirst ? 1 : -1;
+    bool rightNull = wrappedElements->isNullAt(index);
+    if (leftNull == rightNull) {
+      return 0;
     }
-    int result = compareSwitch(left, *wrappedElements, elementIndex, flags);
+    return leftNull == flags.nullsFirst ? -1 : 1;
+  };
+  if (isFlatFixedWidth(*wrappedElements)) {
+    auto result =
+        fixedWidthDispatch(wrappedElements->typeKind(), [&](auto dummy) {
+          using T = decltype(dummy);
+          auto values =
+              wrappedElements->asUnchecked<FlatVector<T>>()->rawValues();
+          for (auto i = 0; i < compareSize; ++i) {
+            auto index = elements.wrappedIndex(elementIndex(i));
+            if (auto nullResult = compareNulls(i, index)) {
+              return nullResult;
+            }
+            if (bits::isBitSet(leftNulls.data(), i)) {
+              continue;
+            }
+            auto leftValue = left.read<T>();
+            if (leftValue != values[index]) {
+              auto valueResult = leftValue < values[index] ? -1 : 1;
+              return flags.ascending ? valueResult : -valueResult;
+            }
+          }
+          return 0;
+        });
     if (result) {
       return result;
     }
+  } else {
+    for (auto i = 0; i < compareSize; ++i) {
+      auto index = elements.wrappedIndex(elementIndex(i));
+      if (auto nullResult = compareNulls(i, index)) {
+        return nullResult;
+      }
+      if (bits::isBitSet(leftNulls.data(), i)) {
+        continue;
+      }
+      if (auto valueResult =
+              compareSwitch(left, *wrappedElements, index, flags)) {
+        return valueResult;
+      }
+    }
   }
   return flags.ascending ? (leftSize - rightSize) : (rightSize - leftSize);
 }
 
+int32_t compareArrays(
+    ByteStream& left,
+    BaseVector& elements,
+    vector_size_t offset,
+    vector_size_t rightSize,
+    CompareFlags flags) {
+  int32_t leftSize = left.read<int32_t>();
+  return compareArrayElements(
+      left,
+      leftSize,
+      elements,
+      rightSize,
+      [&](auto i) { return offset + i; },
+      flags);
+}
+
 int32_t compareArrayIndices(
     ByteStream& left,
     BaseVector& elements,
     folly::Range<const vector_size_t*> rightIndices,
     CompareFlags flags) {
-  VELOX_DCHECK(!flags.stopAtNull, "not supported compare flag");
-
   int32_t leftSize = left.read<int32_t>();
-  int32_t rightSize = rightIndices.size();
-  if (leftSize != rightSize && flags.equalsOnly) {
-    return flags.ascending ? 1 : -1;
-  }
-  auto compareSize = std::min(leftSize, rightSize);
-  auto leftNulls = readNulls(left, leftSize);
-  auto wrappedElements = elements.wrappedVector();
-  for (auto i = 0; i < compareSize; ++i) {
-    auto elementIndex = elements.wrappedIndex(rightIndices[i]);
-    bool leftNull = bits::isBitSet(leftNulls.data(), i);
-    bool rightNull = wrappedElements->isNullAt(elementIndex);
-    if (leftNull) {
-      if (rightNull) {
-        continue;
-      }
-      return flags.nullsFirst ? -1 : 1;
-    } else if (rightNull) {
-      return flags.nullsFirst ? 1 : -1;
-    }
-    int result = compareSwitch(left, *wrappedElements, elementIndex, flags);
-    if (result) {
-      return result;
-    }
-  }
-  return flags.ascending ? (leftSize - rightSize) : (rightSize - leftSize);
+  return compareArrayElements(
+      left,
+      leftSize,
+      elements,
+      rightIndices.size(),
+      [&](auto i) { return rightIndices[i]; },
+      flags);
 }
 
 template <>
@@ -641,22 +761,50 @@ int32_t compareArrays(
   auto compareSize = std::min(leftSize, rightSize);
   auto leftNulls = readNulls(left, leftSize);
   auto rightNulls = readNulls(right, rightSize);
-  for (auto i = 0; i < compareSize; ++i) {
+  // Returns -1 or 1 if one side is null, 0 if both or neither are.
+  auto compareNulls = [&](auto i) {
     bool leftNull = bits::isBitSet(leftNulls.data(), i);
     bool rightNull = bits::isBitSet(rightNulls.data(), i);
-    if (leftNull && rightNull) {
-      continue;
-    }
-    if (leftNull) {
-      return flags.nullsFirst ? -1 : 1;
+    if (leftNull == rightNull) {
+      return 0;
     }
-    if (rightNull) {
-      return flags.nullsFirst ? 1 : -1;
-    }
-    auto result = compareSwitch(left, right, elementType, flags);
+    return leftNull == flags.nullsFirst ? -1 : 1;
+  };
+  if (isFixedWidth(elementType->kind())) {
+    auto result = fixedWidthDispatch(elementType->kind(), [&](auto dummy) {
+      using T = decltype(dummy);
+      for (auto i = 0; i < compareSize; ++i) {
+        if (auto nullResult = compareNulls(i)) {
+          return nullResult;
+        }
+        if (bits::isBitSet(leftNulls.data(), i)) {
+          continue;
+        }
+        auto leftValue = left.read<T>();
+        auto rightValue = right.read<T>();
+        if (leftValue != rightValue) {
+          auto valueResult = leftValue < rightValue ? -1 : 1;
+          return flags.ascending ? valueResult : -valueResult;
+        }
+      }
+      return 0;
+    });
     if (result) {
       return result;
     }
+  } else {
+    for (auto i = 0; i < compareSize; ++i) {
+      if (auto nullResult = compareNulls(i)) {
+        return nullResult;
+      }
+      if (bits::isBitSet(leftNulls.data(), i)) {
+        continue;
+      }
+      auto result = compareSwitch(left, right, elementType, flags);
+      if (result) {
+        return result;
+      }
+    }
   }
   return flags.ascending ? (leftSize - rightSize) : (rightSize - leftSize);
 }
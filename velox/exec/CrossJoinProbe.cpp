@@ -15,6 +15,7 @@
  */
 #include "velox/exec/CrossJoinProbe.h"
 #include "velox/exec/Task.h"
+#include "velox/expression/FieldReference.h"
 
 namespace facebook::velox::exec {
 
@@ -54,6 +55,44 @@ CrossJoinProbe::CrossJoinProbe(
   if (isIdentityProjection && buildProjections_.empty()) {
     isIdentityProjection_ = true;
   }
+
+  if (joinNode->filter()) {
+    initializeFilter(joinNode->filter(), probeType, buildType);
+  }
+}
+
+void CrossJoinProbe::initializeFilter(
+    const core::TypedExprPtr& filter,
+    const RowTypePtr& probeType,
+    const RowTypePtr& buildType) {
+  std::vector<core::TypedExprPtr> filters = {filter};
+  filter_ =
+      std::make_unique<ExprSet>(std::move(filters), operatorCtx_->execCtx());
+
+  column_index_t filterChannel = 0;
+  std::vector<std::string> names;
+  std::vector<TypePtr> types;
+  for (auto& field : filter_->expr(0)->distinctFields()) {
+    const auto& name = field->field();
+    auto channel = probeType->getChildIdxIfExists(name);
+    if (channel.has_value()) {
+      filterProbeInputs_.emplace_back(channel.value(), filterChannel++);
+      names.emplace_back(name);
+      types.emplace_back(probeType->childAt(channel.value()));
+      continue;
+    }
+    channel = buildType->getChildIdxIfExists(name);
+    if (channel.has_value()) {
+      filterBuildInputs_.emplace_back(channel.value(), filterChannel++);
+      names.emplace_back(name);
+      types.emplace_back(buildType->childAt(channel.value()));
+      continue;
+    }
+    VELOX_FAIL(
+        "Join filter field {} not in probe or build input", field->toString());
+  }
+
+  filterInputType_ = ROW(std::move(names), std::move(types));
 }
 
 BlockingReason CrossJoinProbe::isBlocked(ContinueFuture* future) {
@@ -92,56 +131,70 @@ void CrossJoinProbe::addInput(RowVectorPtr input) {
 }
 
 RowVectorPtr CrossJoinProbe::getOutput() {
-  if (!input_) {
-    return nullptr;
-  }
+  // With a filter, a block of the cross product may have no matches. Such
+  // blocks are skipped until there is output or the input is consumed.
+  while (input_) {
+    const auto inputSize = input_->size();
 
-  const auto inputSize = input_->size();
+    auto buildSize = buildData_.value()[buildIndex_]->size();
+    vector_size_t probeCnt;
+    if (buildSize > outputBatchSize_) {
+      probeCnt = 1;
+    } else {
+      probeCnt = std::min(
+          (vector_size_t)outputBatchSize_ / buildSize, inputSize - probeRow_);
+    }
 
-  auto buildSize = buildData_.value()[buildIndex_]->size();
-  vector_size_t probeCnt;
-  if (buildSize > outputBatchSize_) {
-    probeCnt = 1;
-  } else {
-    probeCnt = std::min(
-        (vector_size_t)outputBatchSize_ / buildSize, inputSize - probeRow_);
-  }
+    auto size = probeCnt * buildSize;
+    BufferPtr indices = allocateIndices(size, pool());
+    auto* rawIndices = indices->asMutable<vector_size_t>();
+    for (auto i = 0; i < probeCnt; ++i) {
+      std::fill(
+          rawIndices + i * buildSize,
+          rawIndices + (i + 1) * buildSize,
+          probeRow_ + i);
+    }
 
-  auto size = probeCnt * buildSize;
-  BufferPtr indices = allocateIndices(size, pool());
-  auto* rawIndices = indices->asMutable<vector_size_t>();
-  for (auto i = 0; i < probeCnt; ++i) {
-    std::fill(
-        rawIndices + i * buildSize,
-        rawIndices + (i + 1) * buildSize,
-        probeRow_ + i);
-  }
-  auto output = fillOutput(size, indices);
+    BufferPtr buildIndices = nullptr;
+    if (probeCnt > 1 || filter_) {
+      buildIndices = allocateIndices(size, pool());
+      auto* rawBuildIndices = buildIndices->asMutable<vector_size_t>();
+      for (auto i = 0; i < probeCnt; ++i) {
+        std::iota(
+            rawBuildIndices + i * buildSize,
+            rawBuildIndices + (i + 1) * buildSize,
+            0);
+      }
+    }
 
-  BufferPtr buildIndices = nullptr;
-  if (probeCnt > 1) {
-    buildIndices = allocateIndices(size, pool());
-    auto* rawBuildIndices = buildIndices->asMutable<vector_size_t>();
-    for (auto i = 0; i < probeCnt; ++i) {
-      std::iota(
-          rawBuildIndices + i * buildSize,
-          rawBuildIndices + (i + 1) * buildSize,
-          0);
+    auto buildRowVector =
+        buildData_.value()[buildIndex_]->asUnchecked<RowVector>();
+    if (filter_) {
+      size = evalFilter(size, indices, buildIndices, *buildRowVector);
+      if (size == 0) {
+        advance(probeCnt, inputSize);
+        continue;
+      }
     }
-  }
 
-  auto buildRowVector =
-      buildData_.value()[buildIndex_]->asUnchecked<RowVector>();
-  for (const auto& projection : buildProjections_) {
-    VectorPtr buildVector = buildRowVector->childAt(projection.inputChannel);
+    auto output = fillOutput(size, indices);
+    for (const auto& projection : buildProjections_) {
+      VectorPtr buildVector = buildRowVector->childAt(projection.inputChannel);
 
-    if (buildIndices) {
-      buildVector = BaseVector::wrapInDictionary(
-          BufferPtr(nullptr), buildIndices, size, buildVector);
+      if (buildIndices) {
+        buildVector = BaseVector::wrapInDictionary(
+            BufferPtr(nullptr), buildIndices, size, buildVector);
+      }
+      output->childAt(projection.outputChannel) = buildVector;
     }
-    output->childAt(projection.outputChannel) = buildVector;
+
+    advance(probeCnt, inputSize);
+    return output;
   }
+  return nullptr;
+}
 
+void CrossJoinProbe::advance(vector_size_t probeCnt, vector_size_t inputSize) {
   probeRow_ += probeCnt;
   if (probeRow_ == inputSize) {
     probeRow_ = 0;
@@ -151,7 +204,53 @@ RowVectorPtr CrossJoinProbe::getOutput() {
       input_.reset();
     }
   }
-  return output;
+}
+
+vector_size_t CrossJoinProbe::evalFilter(
+    vector_size_t size,
+    const BufferPtr& probeIndices,
+    const BufferPtr& buildIndices,
+    const RowVector& build) {
+  if (!filterInput_) {
+    filterInput_ = std::static_pointer_cast<RowVector>(
+        BaseVector::create(filterInputType_, 1, pool()));
+  }
+  filterInput_->resize(size);
+  for (const auto& projection : filterProbeInputs_) {
+    filterInput_->childAt(projection.outputChannel) =
+        BaseVector::wrapInDictionary(
+            BufferPtr(nullptr),
+            probeIndices,
+            size,
+            input_->childAt(projection.inputChannel));
+  }
+  for (const auto& projection : filterBuildInputs_) {
+    filterInput_->childAt(projection.outputChannel) =
+        BaseVector::wrapInDictionary(
+            BufferPtr(nullptr),
+            buildIndices,
+            size,
+            build.childAt(projection.inputChannel));
+  }
+
+  filterRows_.resize(size);
+  filterRows_.setAll();
+  EvalCtx evalCtx(operatorCtx_->execCtx(), filter_.get(), filterInput_.get());
+  filter_->eval(0, 1, true, filterRows_, &evalCtx, &filterResult_);
+  decodedFilterResult_.decode(*filterResult_[0], filterRows_);
+
+  auto* rawProbeIndices = probeIndices->asMutable<vector_size_t>();
+  auto* rawBuildIndices = buildIndices->asMutable<vector_size_t>();
+  vector_size_t numPassed = 0;
+  for (auto i = 0; i < size; ++i) {
+    if (!decodedFilterResult_.isNullAt(i) &&
+        decodedFilterResult_.valueAt<bool>(i)) {
+      rawProbeIndices[numPassed] = rawProbeIndices[i];
+      rawBuildIndices[numPassed] = rawBuildIndices[i];
+      ++numPassed;
+    }
+  }
+  return numPassed;
 }
 
 bool CrossJoinProbe::isFinished() {
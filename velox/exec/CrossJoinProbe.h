@@ -41,6 +41,26 @@ class CrossJoinProbe : public Operator {
   void close() override;
 
  private:
+  // Sets up 'filter_' and related members.
+  void initializeFilter(
+      const core::TypedExprPtr& filter,
+      const RowTypePtr& probeType,
+      const RowTypePtr& buildType);
+
+  // Evaluates 'filter_' on the 'size' pairs of rows given by
+  // 'probeIndices' into 'input_' and 'buildIndices' into 'build'. Moves
+  // the indices of the passing pairs to the front and returns their
+  // number.
+  vector_size_t evalFilter(
+      vector_size_t size,
+      const BufferPtr& probeIndices,
+      const BufferPtr& buildIndices,
+      const RowVector& build);
+
+  // Moves past the 'probeCnt' probe rows joined with the current build
+  // vector.
+  void advance(vector_size_t probeCnt, vector_size_t inputSize);
+
   /// Maximum number of rows in the output batch.
   const uint32_t outputBatchSize_;
 
@@ -56,5 +76,25 @@ class CrossJoinProbe : public Operator {
   vector_size_t probeRow_{0};
 
   bool buildSideEmpty_{false};
+
+  // Join filter. Evaluated on blocks of the cross product of a range of
+  // probe rows and a build vector, so that only the matching pairs are
+  // materialized.
+  std::unique_ptr<ExprSet> filter_;
+
+  // Type of the RowVector for filter inputs.
+  RowTypePtr filterInputType_;
+
+  // Maps input channels to channels in 'filterInputType_'.
+  std::vector<IdentityProjection> filterProbeInputs_;
+
+  // Maps build side channels to channels in 'filterInputType_'.
+  std::vector<IdentityProjection> filterBuildInputs_;
+
+  // Input for 'filter_'. Reused between blocks.
+  RowVectorPtr filterInput_;
+  SelectivityVector filterRows_;
+  std::vector<VectorPtr> filterResult_;
+  DecodedVector decodedFilterResult_;
 };
 } // namespace facebook::velox::exec
@@ -19,7 +19,10 @@
 #include <folly/executors/task_queue/UnboundedBlockingQueue.h>
 #include <folly/executors/thread_factory/InitThreadFactory.h>
 #include <gflags/gflags.h>
+#include "velox/common/process/PerfCounters.h"
+#include "velox/common/process/ProcessBase.h"
 #include "velox/common/time/Timer.h"
+#include "velox/exec/DriverExecutor.h"
 #include "velox/exec/Operator.h"
 #include "velox/exec/Task.h"
 
@@ -42,8 +45,9 @@ const core::QueryConfig& DriverCtx::queryConfig() const {
   return task->queryCtx()->config();
 }
 
-velox::memory::MemoryPool* FOLLY_NONNULL DriverCtx::addOperatorPool() {
-  return task->addOperatorPool(pool);
+velox::memory::MemoryPool* FOLLY_NONNULL
+DriverCtx::addOperatorPool(const std::string& name) {
+  return task->addOperatorPool(pool, name);
 }
 
 std::atomic_uint64_t BlockingState::numBlockedDrivers_{0};
@@ -75,6 +79,15 @@ void BlockingState::setResume(std::shared_ptr<BlockingState> state) {
       .thenValue([state](auto&& /* unused */) {
         state->operator_->recordBlockingTime(state->sinceMicros_);
         auto driver = state->driver_;
+        driver->recordBlockedTime(state->reason_, state->sinceMicros_);
+        if (auto& trace = driver->trace()) {
+          trace->record(
+              DriverTrace::EventType::kBlocked,
+              state->operator_->stats().operatorId,
+              state->sinceMicros_,
+              getCurrentTimeMicro(),
+              static_cast<int32_t>(state->reason_));
+        }
         auto task = driver->task();
         if (!task) {
           //'driver' is already removed from its task. No Just drop remaining
@@ -143,8 +156,16 @@ class CancelGuard {
   std::function<void(StopReason reason)> onTerminate_;
   bool isThrow_ = true;
 };
+
+// The Driver running on the current thread, if any.
+thread_local Driver* FOLLY_NULLABLE currentDriver{nullptr};
 } // namespace
 
+// static
+Driver* FOLLY_NULLABLE Driver::current() {
+  return currentDriver;
+}
+
 // static
 void Driver::enqueue(std::shared_ptr<Driver> driver) {
   // This is expected to be called inside the Driver's Tasks's mutex.
@@ -152,17 +173,43 @@ void Driver::enqueue(std::shared_ptr<Driver> driver) {
   if (driver->closed_) {
     return;
   }
-  driver->task()->queryCtx()->executor()->add(
-      [driver]() { Driver::run(driver); });
+  auto* executor = driver->task()->queryCtx()->executor();
+  if (auto* driverExecutor = dynamic_cast<DriverExecutor*>(executor)) {
+    // Prefer the worker that last ran 'driver' so that its operator state is
+    // still in that core's cache. Drivers that have used more CPU go to lower
+    // priority levels.
+    const auto workerId = driver->lastWorkerId_;
+    const auto priority =
+        DriverExecutor::priorityForCpuNanos(driver->cpuTimeNanos_);
+    driverExecutor->addWithAffinity(
+        [driver]() { Driver::run(driver); }, workerId, priority);
+    return;
+  }
+  executor->add([driver]() { Driver::run(driver); });
 }
 
 Driver::Driver(
     std::unique_ptr<DriverCtx> ctx,
     std::vector<std::unique_ptr<Operator>> operators)
-    : ctx_(std::move(ctx)), operators_(std::move(operators)) {
+    : ctx_(std::move(ctx)),
+      timeSliceMicros_(ctx_->queryConfig().driverTimeSliceMs() * 1'000),
+      operators_(std::move(operators)) {
   curOpIndex_ = operators_.size() - 1;
   // Operators need access to their Driver for adaptation.
   ctx_->driver = this;
+  if (ctx_->queryConfig().driverTraceEnabled()) {
+    std::vector<std::string> operatorNames(operators_.size());
+    for (auto& op : operators_) {
+      const auto operatorId = op->stats().operatorId;
+      if (operatorId >= operatorNames.size()) {
+        operatorNames.resize(operatorId + 1);
+      }
+      operatorNames[operatorId] = op->stats().operatorType;
+    }
+    trace_ = std::make_shared<DriverTrace>(
+        ctx_->pipelineId, ctx_->driverId, std::move(operatorNames));
+  }
+  perfCountersEnabled_ = ctx_->queryConfig().operatorPerfCountersEnabled();
 }
 
 namespace {
@@ -180,6 +227,10 @@ std::optional<column_index_t> getIdentityProjection(
 }
 } // namespace
 
+process::PerfCounterValues* FOLLY_NULLABLE Driver::perfCounters(Operator* op) {
+  return perfCountersEnabled_ ? &op->stats().perfCounters : nullptr;
+}
+
 void Driver::pushdownFilters(int operatorIndex) {
   auto op = operators_[operatorIndex].get();
   const auto& filters = op->getDynamicFilters();
@@ -235,7 +286,7 @@ RowVectorPtr Driver::next(std::shared_ptr<BlockingState>& blockingState) {
 
   auto self = shared_from_this();
   RowVectorPtr result;
-  auto stop = runInternal(self, blockingState, result);
+  auto stop = runInternal(self, blockingState, result, 0);
 
   // We get kBlock if 'result' was produced; kAtEnd if pipeline has finished
   // processing and no more results will be produced; kAlreadyTerminated on
@@ -257,7 +308,8 @@ void Driver::enqueueInternal() {
 StopReason Driver::runInternal(
     std::shared_ptr<Driver>& self,
     std::shared_ptr<BlockingState>& blockingState,
-    RowVectorPtr& result) {
+    RowVectorPtr& result,
+    size_t timeSliceMicros) {
   auto queuedTime = (getCurrentTimeMicro() - queueTimeStartMicros_) * 1'000;
   // Update the next operator's queueTime.
   auto stop = closed_ ? StopReason::kTerminate : task()->enter(state_);
@@ -286,6 +338,7 @@ StopReason Driver::runInternal(
         "queuedWallNanos",
         RuntimeCounter(queuedTime, RuntimeCounter::Unit::kNanos));
   }
+  queuedWallNanos_ += queuedTime;
 
   CancelGuard guard(task().get(), &state_, [&](StopReason reason) {
     // This is run on error or cancel exit.
@@ -308,6 +361,24 @@ StopReason Driver::runInternal(
   const auto statWriterGuard =
       folly::makeGuard([]() { setRunTimeStatWriter(nullptr); });
 
+  currentDriver = this;
+  const auto currentDriverGuard =
+      folly::makeGuard([]() { currentDriver = nullptr; });
+
+  runStartCpuNanos_ = process::threadCpuNanos();
+  runStartMicros_ = getCurrentTimeMicro();
+  const auto cpuTimeGuard = folly::makeGuard([&]() {
+    cpuTimeNanos_ += process::threadCpuNanos() - runStartCpuNanos_;
+    runningWallNanos_ += (getCurrentTimeMicro() - runStartMicros_) * 1'000;
+    runStartMicros_ = 0;
+  });
+  const auto sliceEndMicros =
+      timeSliceMicros > 0 ? getCurrentTimeMicro() + timeSliceMicros : 0;
+  // Records the time on thread. Destroyed before 'guard' takes 'this' off
+  // thread.
+  DriverTrace::Scope runScope(
+      trace_.get(), DriverTrace::EventType::kRun, /*operatorId=*/-1);
+
   try {
     int32_t numOperators = operators_.size();
     ContinueFuture future;
@@ -320,6 +391,13 @@ StopReason Driver::runInternal(
           return stop;
         }
 
+        if (sliceEndMicros > 0 && getCurrentTimeMicro() > sliceEndMicros) {
+          // The time slice is used up. Go to the end of the queue so that
+          // other Drivers get the thread.
+          guard.notThrown();
+          return StopReason::kYield;
+        }
+
         auto op = operators_[i].get();
         // In case we are blocked, this index will point to the operator, whose
         // queuedTime we should update.
@@ -351,6 +429,11 @@ StopReason Driver::runInternal(
             RowVectorPtr result;
             {
               CpuWallTimer timer(op->stats().getOutputTiming);
+              process::PerfCounterScope perfScope(perfCounters(op));
+              DriverTrace::Scope traceScope(
+                  trace_.get(),
+                  DriverTrace::EventType::kGetOutput,
+                  op->stats().operatorId);
               result = op->getOutput();
               if (result) {
                 op->stats().outputVectors += 1;
@@ -362,6 +445,11 @@ StopReason Driver::runInternal(
             pushdownFilters(i);
             if (result) {
               CpuWallTimer timer(nextOp->stats().addInputTiming);
+              process::PerfCounterScope perfScope(perfCounters(nextOp));
+              DriverTrace::Scope traceScope(
+                  trace_.get(),
+                  DriverTrace::EventType::kAddInput,
+                  nextOp->stats().operatorId);
               nextOp->stats().inputVectors += 1;
               nextOp->stats().inputPositions += result->size();
               nextOp->stats().inputBytes += resultBytes;
@@ -391,6 +479,11 @@ StopReason Driver::runInternal(
               }
               if (op->isFinished()) {
                 CpuWallTimer timer(nextOp->stats().finishTiming);
+                process::PerfCounterScope perfScope(perfCounters(nextOp));
+                DriverTrace::Scope traceScope(
+                    trace_.get(),
+                    DriverTrace::EventType::kNoMoreInput,
+                    nextOp->stats().operatorId);
                 nextOp->noMoreInput();
                 break;
               }
@@ -403,6 +496,11 @@ StopReason Driver::runInternal(
           // will come back here after this is again on thread.
           {
             CpuWallTimer timer(op->stats().getOutputTiming);
+            process::PerfCounterScope perfScope(perfCounters(op));
+            DriverTrace::Scope traceScope(
+                trace_.get(),
+                DriverTrace::EventType::kGetOutput,
+                op->stats().operatorId);
             result = op->getOutput();
             if (result) {
               // This code path is used only in single-threaded execution.
@@ -434,9 +532,14 @@ StopReason Driver::runInternal(
 
 // static
 void Driver::run(std::shared_ptr<Driver> self) {
+  if (auto* driverExecutor = dynamic_cast<DriverExecutor*>(
+          self->task()->queryCtx()->executor())) {
+    self->lastWorkerId_ = driverExecutor->currentWorkerId();
+  }
   std::shared_ptr<BlockingState> blockingState;
   RowVectorPtr nullResult;
-  auto reason = self->runInternal(self, blockingState, nullResult);
+  auto reason = self->runInternal(
+      self, blockingState, nullResult, self->timeSliceMicros_);
 
   // When Driver runs on an executor, the last operator (sink) must not produce
   // any results.
@@ -481,11 +584,40 @@ void Driver::initializeOperatorStats(std::vector<OperatorStats>& stats) {
 
 void Driver::addStatsToTask() {
   for (auto& op : operators_) {
+    op->finalizeStats();
     auto& stats = op->stats();
     stats.memoryStats.update(op->pool()->getMemoryUsageTracker());
     stats.numDrivers = 1;
     task()->addOperatorStats(stats);
   }
+
+  DriverTimingStats timing;
+  timing.queuedWallNanos = queuedWallNanos_;
+  timing.runningWallNanos = runningWallNanos_;
+  timing.runningCpuNanos = cpuTimeNanos_;
+  if (runStartMicros_ != 0) {
+    // Closing on thread, e.g. at end. Adds the current time on thread.
+    timing.runningWallNanos +=
+        (getCurrentTimeMicro() - runStartMicros_) * 1'000;
+    timing.runningCpuNanos += process::threadCpuNanos() - runStartCpuNanos_;
+  }
+  for (auto i = 0; i < kNumBlockingReasons; ++i) {
+    const auto nanos = blockedWallNanos_[i].load();
+    if (nanos > 0) {
+      timing.blockedWallNanos[blockingReasonToString(
+          static_cast<BlockingReason>(i))] = nanos;
+    }
+  }
+  task()->addDriverTimingStats(timing);
+}
+
+void Driver::recordBlockedTime(BlockingReason reason, uint64_t sinceMicros) {
+  const uint64_t now =
+      std::chrono::duration_cast<std::chrono::microseconds>(
+          std::chrono::high_resolution_clock::now().time_since_epoch())
+          .count();
+  blockedWallNanos_[static_cast<int32_t>(reason)] +=
+      (now - sinceMicros) * 1'000;
 }
 
 void Driver::close() {
@@ -528,6 +660,25 @@ bool Driver::mayPushdownAggregation(Operator* aggregation) const {
       aggregation->toString());
 }
 
+std::optional<int64_t> Driver::pushdownRowLimit(
+    const Operator* FOLLY_NONNULL source) const {
+  bool found = false;
+  for (auto i = 0; i < operators_.size(); ++i) {
+    auto op = operators_[i].get();
+    if (!found) {
+      found = op == source;
+      continue;
+    }
+    if (auto limit = op->rowLimit()) {
+      return limit;
+    }
+    if (!op->preservesCardinality()) {
+      return std::nullopt;
+    }
+  }
+  return std::nullopt;
+}
+
 std::unordered_set<column_index_t> Driver::canPushdownFilters(
     const Operator* FOLLY_NONNULL filterSource,
     const std::vector<column_index_t>& channels) const {
@@ -587,6 +738,22 @@ Driver::findOperator(std::string_view planNodeId) const {
   return nullptr;
 }
 
+uint64_t Driver::reclaimableBytes() const {
+  uint64_t bytes = 0;
+  for (const auto& op : operators_) {
+    bytes += op->reclaimableBytes();
+  }
+  return bytes;
+}
+
+void Driver::reclaim() {
+  for (auto& op : operators_) {
+    if (op->reclaimableBytes() > 0) {
+      op->reclaim();
+    }
+  }
+}
+
 void Driver::setError(std::exception_ptr exception) {
   task()->setError(exception);
 }
@@ -638,6 +805,8 @@ std::string blockingReasonToString(BlockingReason reason) {
       return "kWaitForMemory";
     case BlockingReason::kWaitForConnector:
       return "kWaitForConnector";
+    case BlockingReason::kWaitForPeers:
+      return "kWaitForPeers";
   }
   VELOX_UNREACHABLE();
   return "";
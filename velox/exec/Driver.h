@@ -22,6 +22,11 @@
 #include "velox/connectors/Connector.h"
 #include "velox/core/PlanNode.h"
 #include "velox/core/QueryCtx.h"
+#include "velox/exec/DriverTrace.h"
+
+namespace facebook::velox::process {
+struct PerfCounterValues;
+} // namespace facebook::velox::process
 
 namespace facebook::velox::exec {
 
@@ -126,8 +131,14 @@ enum class BlockingReason {
   kWaitForJoinBuild,
   kWaitForMemory,
   kWaitForConnector,
+  // Waiting for the other Drivers of the pipeline to reach the same point.
+  kWaitForPeers,
 };
 
+// Number of BlockingReason values. Must be updated when a reason is added.
+constexpr int32_t kNumBlockingReasons =
+    static_cast<int32_t>(BlockingReason::kWaitForPeers) + 1;
+
 std::string blockingReasonToString(BlockingReason reason);
 
 class BlockingState {
@@ -187,6 +198,10 @@ struct DriverCtx {
   std::shared_ptr<Task> task;
   memory::MemoryPool* FOLLY_NONNULL pool;
   Driver* FOLLY_NONNULL driver;
+  /// True if the Task added this driver while running. Such a driver
+  /// finishes when there is no split to take. See
+  /// Task::maybeAddElasticDriver().
+  bool elastic{false};
 
   explicit DriverCtx(
       std::shared_ptr<Task> _task,
@@ -197,7 +212,8 @@ struct DriverCtx {
 
   const core::QueryConfig& queryConfig() const;
 
-  velox::memory::MemoryPool* FOLLY_NONNULL addOperatorPool();
+  velox::memory::MemoryPool* FOLLY_NONNULL
+  addOperatorPool(const std::string& name = "operator_ctx");
 };
 
 class Driver : public std::enable_shared_from_this<Driver> {
@@ -238,10 +254,21 @@ class Driver : public std::enable_shared_from_this<Driver> {
 
   void addStatsToTask();
 
+  // Adds the time from 'sinceMicros' to now to the time 'this' has been
+  // blocked for 'reason'. Called when a blocking future of 'this' is
+  // realized, which may be on any thread.
+  void recordBlockedTime(BlockingReason reason, uint64_t sinceMicros);
+
   // Returns true if all operators between the source and 'aggregation' are
   // order-preserving and do not increase cardinality.
   bool mayPushdownAggregation(Operator* FOLLY_NONNULL aggregation) const;
 
+  // Returns the number of rows 'source' needs to produce at most if the
+  // operators after it pass each row through until one has a row limit,
+  // e.g. a Limit over a projection. Returns std::nullopt otherwise.
+  std::optional<int64_t> pushdownRowLimit(
+      const Operator* FOLLY_NONNULL source) const;
+
   // Returns a subset of channels for which there are operators upstream from
   // filterSource that accept dynamically generated filters.
   std::unordered_set<column_index_t> canPushdownFilters(
@@ -253,8 +280,26 @@ class Driver : public std::enable_shared_from_this<Driver> {
   // build by id.
   Operator* FOLLY_NULLABLE findOperator(std::string_view planNodeId) const;
 
+  // Returns the total of Operator::reclaimableBytes() for the operators of
+  // 'this'. Must only be called while 'this' is off thread.
+  uint64_t reclaimableBytes() const;
+
+  // Makes the operators of 'this' that have reclaimable memory spill. Must
+  // only be called while 'this' is off thread.
+  void reclaim();
+
+  // Returns the Driver running on the calling thread or nullptr if the
+  // calling thread is not running a Driver.
+  static Driver* FOLLY_NULLABLE current();
+
   void setError(std::exception_ptr exception);
 
+  // Returns the timeline of 'this' or nullptr if tracing is disabled. See
+  // QueryConfig::kDriverTraceEnabled.
+  const std::shared_ptr<DriverTrace>& trace() const {
+    return trace_;
+  }
+
   std::string toString();
 
   DriverCtx* FOLLY_NONNULL driverCtx() const {
@@ -274,10 +319,13 @@ class Driver : public std::enable_shared_from_this<Driver> {
 
   static void run(std::shared_ptr<Driver> self);
 
+  // Runs the pipeline. If 'timeSliceMicros' is non-zero, returns kYield once
+  // it has run for that long.
   StopReason runInternal(
       std::shared_ptr<Driver>& self,
       std::shared_ptr<BlockingState>& blockingState,
-      RowVectorPtr& result);
+      RowVectorPtr& result,
+      size_t timeSliceMicros);
 
   void close();
 
@@ -285,7 +333,16 @@ class Driver : public std::enable_shared_from_this<Driver> {
   // position in the pipeline.
   void pushdownFilters(int operatorIndex);
 
+  // Returns the stats that get the hardware counts of a call of 'op' or
+  // nullptr if counting is off.
+  process::PerfCounterValues* FOLLY_NULLABLE perfCounters(Operator* op);
+
   std::unique_ptr<DriverCtx> ctx_;
+
+  // Time a Driver runs on an executor thread before yielding. 0 means no
+  // limit. See QueryConfig::kDriverTimeSliceMs.
+  const size_t timeSliceMicros_;
+
   std::atomic_bool closed_{false};
 
   // Set via Task and serialized by Task's mutex.
@@ -300,6 +357,32 @@ class Driver : public std::enable_shared_from_this<Driver> {
   std::vector<std::unique_ptr<Operator>> operators_;
 
   BlockingReason blockingReason_{BlockingReason::kNotBlocked};
+
+  // Worker of the DriverExecutor that last ran 'this'. Used to resume 'this'
+  // on the same core. DriverExecutor::kNoWorker if the Task does not run on
+  // a DriverExecutor.
+  int32_t lastWorkerId_{-1};
+
+  // Thread CPU time 'this' has used so far. Determines its priority level
+  // on a DriverExecutor.
+  uint64_t cpuTimeNanos_{0};
+
+  // Wall time 'this' has spent in the executor queue and on thread.
+  uint64_t queuedWallNanos_{0};
+  uint64_t runningWallNanos_{0};
+
+  // Wall and thread CPU time at the start of the current time on thread. 0
+  // when off thread.
+  uint64_t runStartMicros_{0};
+  uint64_t runStartCpuNanos_{0};
+
+  // Wall time 'this' has spent blocked. The subscript is the BlockingReason.
+  std::array<std::atomic<uint64_t>, kNumBlockingReasons> blockedWallNanos_{};
+
+  std::shared_ptr<DriverTrace> trace_;
+
+  // True if QueryConfig::kOperatorPerfCountersEnabled is set.
+  bool perfCountersEnabled_{false};
 };
 
 using OperatorSupplier = std::function<std::unique_ptr<Operator>(
@@ -378,6 +461,36 @@ struct DriverFactory {
     return std::nullopt;
   }
 
+  /// Returns true if Drivers can be added to this pipeline while it runs and
+  /// can finish before all splits are done. This holds for pipelines that
+  /// read splits with a TableScan, have only operators that share no state
+  /// between Drivers and end in a PartitionedOutput, which takes its number
+  /// of Drivers at runtime. Pipelines feeding a local exchange, a join
+  /// bridge or a Task consumer need a fixed number of Drivers.
+  bool supportsElasticDrivers() const {
+    VELOX_CHECK(!planNodes.empty());
+    if (!std::dynamic_pointer_cast<const core::TableScanNode>(
+            planNodes.front()) ||
+        !needsPartitionedOutput()) {
+      return false;
+    }
+    for (auto i = 1; i < planNodes.size() - 1; ++i) {
+      const auto& planNode = planNodes[i];
+      if (std::dynamic_pointer_cast<const core::FilterNode>(planNode) ||
+          std::dynamic_pointer_cast<const core::ProjectNode>(planNode)) {
+        continue;
+      }
+      auto aggregation =
+          std::dynamic_pointer_cast<const core::AggregationNode>(planNode);
+      if (aggregation &&
+          aggregation->step() == core::AggregationNode::Step::kPartial) {
+        continue;
+      }
+      return false;
+    }
+    return true;
+  }
+
   /// Returns plan node IDs of all HashJoinNode's in the pipeline.
   std::vector<core::PlanNodeId> needsHashJoinBridges() const {
     std::vector<core::PlanNodeId> planNodeIds;
@@ -0,0 +1,343 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "velox/exec/DriverExecutor.h"
+
+#ifdef __linux__
+#include <pthread.h>
+#include <sched.h>
+#endif
+
+#include <optional>
+
+#include <glog/logging.h>
+#include "velox/common/base/Exceptions.h"
+#include "velox/common/memory/Numa.h"
+#include "velox/common/time/Timer.h"
+
+namespace facebook::velox::exec {
+
+namespace {
+struct CurrentWorker {
+  const DriverExecutor* executor{nullptr};
+  int32_t workerId{DriverExecutor::kNoWorker};
+};
+
+thread_local CurrentWorker currentWorker;
+
+void pinToCpu(std::thread& thread, int32_t workerId) {
+#ifdef __linux__
+  const auto numCpus = std::thread::hardware_concurrency();
+  if (numCpus == 0) {
+    return;
+  }
+  cpu_set_t cpus;
+  CPU_ZERO(&cpus);
+  CPU_SET(workerId % numCpus, &cpus);
+  auto rc =
+      pthread_setaffinity_np(thread.native_handle(), sizeof(cpus), &cpus);
+  if (rc != 0) {
+    LOG(WARNING) << "Failed to pin DriverExecutor worker " << workerId
+                 << " to a CPU: " << rc;
+  }
+#endif
+}
+} // namespace
+
+DriverExecutor::DriverExecutor(int32_t numThreads, bool pinThreads) {
+  VELOX_CHECK_GT(numThreads, 0);
+  workers_.reserve(numThreads);
+  const auto numCpus = std::thread::hardware_concurrency();
+  for (auto i = 0; i < numThreads; ++i) {
+    workers_.push_back(std::make_unique<Worker>());
+    if (pinThreads && numCpus > 0) {
+      workers_.back()->numaNode = memory::numaNodeOfCpu(i % numCpus);
+    }
+  }
+  // Start the threads after all workers exist since a worker may steal from
+  // any other.
+  for (auto i = 0; i < numThreads; ++i) {
+    workers_[i]->thread = std::thread([this, i]() { run(i); });
+    if (pinThreads) {
+      pinToCpu(workers_[i]->thread, i);
+    }
+  }
+}
+
+DriverExecutor::~DriverExecutor() {
+  {
+    std::lock_guard<std::mutex> l(idleMutex_);
+    stopped_ = true;
+    for (auto& worker : workers_) {
+      worker->wakeup.notify_one();
+    }
+  }
+  for (auto& worker : workers_) {
+    worker->thread.join();
+  }
+}
+
+void DriverExecutor::add(folly::Func func) {
+  addWithAffinity(std::move(func), kNoWorker);
+}
+
+void DriverExecutor::addWithAffinity(
+    folly::Func func,
+    int32_t workerId,
+    int32_t priority) {
+  VELOX_DCHECK(priority >= 0 && priority < kNumPriorities);
+  if (workerId < 0 || workerId >= workers_.size()) {
+    workerId = currentWorkerId();
+    if (workerId == kNoWorker) {
+      workerId = nextWorker_++ % workers_.size();
+    }
+  }
+  push(workerId, priority, std::move(func));
+}
+
+// static
+int32_t DriverExecutor::priorityForCpuNanos(uint64_t cpuNanos) {
+  static constexpr std::array<uint64_t, kNumPriorities - 1> kThresholdsNanos =
+      {1'000'000'000UL,
+       10'000'000'000UL,
+       60'000'000'000UL,
+       300'000'000'000UL};
+  int32_t priority = 0;
+  while (priority < kThresholdsNanos.size() &&
+         cpuNanos >= kThresholdsNanos[priority]) {
+    ++priority;
+  }
+  return priority;
+}
+
+int32_t DriverExecutor::currentWorkerId() const {
+  return currentWorker.executor == this ? currentWorker.workerId : kNoWorker;
+}
+
+DriverExecutor::Stats DriverExecutor::stats() const {
+  Stats stats;
+  stats.queueDepths.reserve(workers_.size());
+  for (const auto& worker : workers_) {
+    stats.queueDepths.push_back(worker->size);
+    std::lock_guard<std::mutex> l(worker->mutex);
+    for (auto i = 0; i < kNumPriorities; ++i) {
+      stats.priorityRunNanos[i] += worker->runNanos[i];
+    }
+  }
+  stats.numRun = numRun_;
+  stats.numSteals = numSteals_;
+  return stats;
+}
+
+void DriverExecutor::push(
+    int32_t workerId,
+    int32_t priority,
+    folly::Func func) {
+  auto& worker = *workers_[workerId];
+  {
+    std::lock_guard<std::mutex> l(worker.mutex);
+    auto& queue = worker.queues[priority];
+    if (queue.empty()) {
+      std::optional<double> minNormalizedNanos;
+      for (auto i = 0; i < kNumPriorities; ++i) {
+        if (i != priority && !worker.queues[i].empty()) {
+          const auto normalizedNanos = normalizedRunNanos(worker, i);
+          if (!minNormalizedNanos.has_value() ||
+              normalizedNanos < minNormalizedNanos.value()) {
+            minNormalizedNanos = normalizedNanos;
+          }
+        }
+      }
+      if (minNormalizedNanos.has_value()) {
+        const int64_t chargedNanos = minNormalizedNanos.value() *
+            (1 << (kNumPriorities - 1 - priority));
+        worker.runNanos[priority] =
+            std::max(worker.runNanos[priority], chargedNanos);
+      }
+    }
+    queue.push_back(std::move(func));
+    ++worker.size;
+    ++numPending_;
+  }
+  // A worker about to sleep increments 'numSleeping_' before checking
+  // 'numPending_'. Both are sequentially consistent, so either the worker
+  // sees this item or we see the worker and wake it up.
+  if (numSleeping_ > 0) {
+    wakeup(workerId);
+  }
+}
+
+void DriverExecutor::wakeup(int32_t workerId) {
+  std::lock_guard<std::mutex> l(idleMutex_);
+  Worker* target = workers_[workerId].get();
+  if (!target->sleeping) {
+    target = nullptr;
+    for (auto& worker : workers_) {
+      if (worker->sleeping) {
+        target = worker.get();
+        break;
+      }
+    }
+  }
+  if (target) {
+    target->sleeping = false;
+    --numSleeping_;
+    target->wakeup.notify_one();
+  }
+}
+
+// static
+double DriverExecutor::normalizedRunNanos(
+    const Worker& worker,
+    int32_t priority) {
+  // Level i is entitled to 2^(kNumPriorities - 1 - i) units of time for each
+  // unit given to the lowest priority level.
+  return static_cast<double>(worker.runNanos[priority]) /
+      (1 << (kNumPriorities - 1 - priority));
+}
+
+// static
+int32_t DriverExecutor::pickPriority(const Worker& worker) {
+  int32_t best = -1;
+  double bestNormalizedNanos = 0;
+  for (auto i = 0; i < kNumPriorities; ++i) {
+    if (worker.queues[i].empty()) {
+      continue;
+    }
+    const auto normalizedNanos = normalizedRunNanos(worker, i);
+    if (best == -1 || normalizedNanos < bestNormalizedNanos) {
+      best = i;
+      bestNormalizedNanos = normalizedNanos;
+    }
+  }
+  VELOX_DCHECK_NE(best, -1);
+  return best;
+}
+
+bool DriverExecutor::tryPop(
+    int32_t workerId,
+    folly::Func& func,
+    int32_t& priority) {
+  auto& worker = *workers_[workerId];
+  if (worker.size == 0) {
+    return false;
+  }
+  std::lock_guard<std::mutex> l(worker.mutex);
+  if (worker.size == 0) {
+    return false;
+  }
+  priority = pickPriority(worker);
+  auto& queue = worker.queues[priority];
+  func = std::move(queue.front());
+  queue.pop_front();
+  --worker.size;
+  --numPending_;
+  return true;
+}
+
+bool DriverExecutor::trySteal(
+    int32_t workerId,
+    folly::Func& func,
+    int32_t& priority,
+    int32_t& victim) {
+  // Retry until all other queues are seen empty since the longest queue may
+  // have been drained by its owner between the size check and the pop.
+  for (;;) {
+    // Workers on the same NUMA node are preferred, so that the Driver stays
+    // close to its memory.
+    const auto node = workers_[workerId]->numaNode;
+    victim = kNoWorker;
+    int64_t victimSize = 0;
+    int32_t localVictim = kNoWorker;
+    int64_t localVictimSize = 0;
+    for (auto i = 0; i < workers_.size(); ++i) {
+      const int64_t size = workers_[i]->size;
+      if (i == workerId) {
+        continue;
+      }
+      if (size > victimSize) {
+        victim = i;
+        victimSize = size;
+      }
+      if (node != memory::kNoNumaNode && workers_[i]->numaNode == node &&
+          size > localVictimSize) {
+        localVictim = i;
+        localVictimSize = size;
+      }
+    }
+    if (localVictim != kNoWorker) {
+      victim = localVictim;
+    }
+    if (victim == kNoWorker) {
+      return false;
+    }
+    if (tryPop(victim, func, priority)) {
+      ++numSteals_;
+      return true;
+    }
+  }
+}
+
+void DriverExecutor::run(int32_t workerId) {
+  currentWorker.executor = this;
+  currentWorker.workerId = workerId;
+  auto& worker = *workers_[workerId];
+  // Memory allocated by the Drivers of a pinned worker comes from its node.
+  memory::setThreadNumaNode(worker.numaNode);
+  for (;;) {
+    folly::Func func;
+    int32_t priority;
+    // The worker whose queue 'func' came from. Its level is charged for the
+    // run time.
+    int32_t sourceId = workerId;
+    if (tryPop(workerId, func, priority) ||
+        trySteal(workerId, func, priority, sourceId)) {
+      ++numRun_;
+      const auto startMicros = getCurrentTimeMicro();
+      try {
+        func();
+      } catch (const std::exception& e) {
+        LOG(ERROR) << "DriverExecutor: func threw: " << e.what();
+      }
+      const int64_t runNanos = (getCurrentTimeMicro() - startMicros) * 1'000;
+      auto& source = *workers_[sourceId];
+      std::lock_guard<std::mutex> sourceLock(source.mutex);
+      source.runNanos[priority] += runNanos;
+      continue;
+    }
+
+    std::unique_lock<std::mutex> l(idleMutex_);
+    worker.sleeping = true;
+    ++numSleeping_;
+    if (numPending_ > 0 || stopped_) {
+      worker.sleeping = false;
+      --numSleeping_;
+      if (numPending_ > 0) {
+        continue;
+      }
+      // Stopped and all queues are drained.
+      return;
+    }
+    worker.wakeup.wait(l, [&]() { return !worker.sleeping || stopped_; });
+    if (worker.sleeping) {
+      // Woken up by the destructor.
+      worker.sleeping = false;
+      --numSleeping_;
+    }
+  }
+}
+
+} // namespace facebook::velox::exec
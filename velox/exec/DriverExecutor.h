@@ -0,0 +1,189 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include <folly/Executor.h>
+
+#include "velox/common/memory/Numa.h"
+
+namespace facebook::velox::exec {
+
+/// Executor for running Drivers. Each worker thread has its own run queue.
+/// Work added from a worker thread goes to that worker's queue and work added
+/// with addWithAffinity() goes to the queue of the requested worker, so that a
+/// Driver resumed after blocking runs on the core that has its HashTable and
+/// RowContainer state in cache. A worker whose queue is empty steals the
+/// oldest item from the longest other queue before going to sleep.
+///
+/// Queues are FIFO for both the owner and thieves so that a Driver that
+/// yields goes behind the other runnable Drivers of the same worker.
+///
+/// If workers are pinned to CPUs, a worker steals from workers on its own
+/// NUMA node first and memory allocated by its Drivers comes from its node
+/// (see MmapAllocatorOptions::numaNodes).
+///
+/// Each queue has kNumPriorities levels, 0 being the highest priority. Like
+/// in a multi-level feedback queue, a Driver is queued at a level based on
+/// the CPU time it has used so far (see priorityForCpuNanos()), so that
+/// long-running Drivers sink to lower levels. To avoid starving the lower
+/// levels, a worker picks the non-empty level that has used the least time
+/// relative to its share, where each level's share is twice the share of the
+/// next lower priority level. A level that becomes non-empty is charged up
+/// to the least normalized time of the other non-empty levels, so that time
+/// it did not use while empty is not banked for later.
+class DriverExecutor : public folly::Executor {
+ public:
+  static constexpr int32_t kNumPriorities = 5;
+
+  struct Stats {
+    /// Number of items waiting in each worker's queue.
+    std::vector<int64_t> queueDepths;
+
+    /// Total number of items run.
+    int64_t numRun{0};
+
+    /// Number of items run by a worker other than the one they were queued
+    /// on.
+    int64_t numSteals{0};
+
+    /// Wall time spent running items of each priority level.
+    std::array<int64_t, kNumPriorities> priorityRunNanos{};
+  };
+
+  /// Starts 'numThreads' workers. If 'pinThreads' is true, worker i is bound
+  /// to CPU i modulo the number of CPUs. Pinning is only supported on Linux
+  /// and is a no-op elsewhere.
+  explicit DriverExecutor(int32_t numThreads, bool pinThreads = false);
+
+  /// Runs all queued items and joins the workers.
+  ~DriverExecutor() override;
+
+  /// Queues 'func' on the current worker if called from one of the workers of
+  /// 'this', otherwise on the next worker in round-robin order.
+  void add(folly::Func func) override;
+
+  /// Queues 'func' on worker 'workerId' at 'priority'. Queues on the worker
+  /// picked by add() if 'workerId' is not a valid worker id, e.g. kNoWorker.
+  void addWithAffinity(
+      folly::Func func,
+      int32_t workerId,
+      int32_t priority = 0);
+
+  /// Returns the priority level for a Driver that has used 'cpuNanos' of CPU
+  /// time. Levels start at 0, 1s, 10s, 60s and 300s.
+  static int32_t priorityForCpuNanos(uint64_t cpuNanos);
+
+  /// Returns the id of the worker of 'this' running the calling thread or
+  /// kNoWorker if the caller is not one of the workers of 'this'.
+  int32_t currentWorkerId() const;
+
+  int32_t numThreads() const {
+    return workers_.size();
+  }
+
+  Stats stats() const;
+
+  static constexpr int32_t kNoWorker = -1;
+
+ private:
+  struct Worker {
+    // Serializes 'queues'.
+    std::mutex mutex;
+
+    // Run queue for each priority level.
+    std::array<std::deque<folly::Func>, kNumPriorities> queues;
+
+    // Wall time charged to each priority level of this worker.
+    std::array<int64_t, kNumPriorities> runNanos{};
+
+    // Total size of 'queues', readable without 'mutex' to pick a victim for
+    // stealing.
+    std::atomic<int64_t> size{0};
+
+    // NUMA node of the CPU the worker is pinned to. kNoNumaNode if not
+    // pinned.
+    int32_t numaNode{memory::kNoNumaNode};
+
+    // Signaled when work is queued for this worker while it sleeps.
+    std::condition_variable wakeup;
+
+    // True while the worker waits on 'wakeup'. Serialized by 'idleMutex_'.
+    bool sleeping{false};
+
+    std::thread thread;
+  };
+
+  void run(int32_t workerId);
+
+  void push(int32_t workerId, int32_t priority, folly::Func func);
+
+  // Pops the oldest item of the level picked by pickPriority() of worker
+  // 'workerId' into 'func' and sets 'priority' to its level. Returns false if
+  // the queue is empty.
+  bool tryPop(int32_t workerId, folly::Func& func, int32_t& priority);
+
+  // Pops an item from the longest queue other than the one of 'workerId' and
+  // sets 'victim' to the id of that queue. Returns false if all other queues
+  // are empty.
+  bool trySteal(
+      int32_t workerId,
+      folly::Func& func,
+      int32_t& priority,
+      int32_t& victim);
+
+  // Returns the non-empty level of 'worker' that is furthest below its share
+  // of run time. 'worker.mutex' must be held and 'worker' must not be empty.
+  static int32_t pickPriority(const Worker& worker);
+
+  // Returns the run time of 'worker' at 'priority' divided by the share of
+  // 'priority'.
+  static double normalizedRunNanos(const Worker& worker, int32_t priority);
+
+  // Wakes up 'workerId' if it sleeps, otherwise any sleeping worker.
+  void wakeup(int32_t workerId);
+
+  std::vector<std::unique_ptr<Worker>> workers_;
+
+  // Counter for spreading work added from outside of the workers.
+  std::atomic<uint32_t> nextWorker_{0};
+
+  // Number of items in all queues.
+  std::atomic<int64_t> numPending_{0};
+
+  // Number of sleeping workers. Checked by producers to skip taking
+  // 'idleMutex_' when all workers are busy.
+  std::atomic<int32_t> numSleeping_{0};
+
+  std::atomic<int64_t> numRun_{0};
+  std::atomic<int64_t> numSteals_{0};
+
+  // Serializes sleeping and waking up of workers.
+  std::mutex idleMutex_;
+
+  // Set by the destructor. Serialized by 'idleMutex_'.
+  bool stopped_{false};
+};
+
+} // namespace facebook::velox::exec
@@ -0,0 +1,148 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "velox/exec/DriverTrace.h"
+
+#include <fmt/format.h>
+#include "velox/common/base/BitUtil.h"
+#include "velox/common/time/Timer.h"
+#include "velox/exec/Driver.h"
+
+namespace facebook::velox::exec {
+
+DriverTrace::Scope::Scope(
+    DriverTrace* trace,
+    EventType type,
+    int32_t operatorId)
+    : trace_(trace),
+      type_(type),
+      operatorId_(operatorId),
+      startMicros_(trace ? getCurrentTimeMicro() : 0) {}
+
+DriverTrace::Scope::~Scope() {
+  if (trace_) {
+    trace_->record(type_, operatorId_, startMicros_, getCurrentTimeMicro());
+  }
+}
+
+DriverTrace::DriverTrace(
+    int32_t pipelineId,
+    int32_t driverId,
+    std::vector<std::string> operatorNames,
+    int32_t capacity)
+    : pipelineId_(pipelineId),
+      driverId_(driverId),
+      operatorNames_(std::move(operatorNames)),
+      mask_(capacity - 1),
+      events_(capacity) {
+  VELOX_CHECK_GT(capacity, 0);
+  VELOX_CHECK(bits::isPowerOfTwo(capacity));
+}
+
+void DriverTrace::record(
+    EventType type,
+    int32_t operatorId,
+    uint64_t startMicros,
+    uint64_t endMicros,
+    int32_t detail) {
+  const auto index = numEvents_.fetch_add(1, std::memory_order_relaxed);
+  events_[index & mask_] = Event{
+      startMicros,
+      endMicros > startMicros ? endMicros - startMicros : 0,
+      operatorId,
+      detail,
+      type};
+}
+
+std::vector<DriverTrace::Event> DriverTrace::events() const {
+  const auto numEvents = numEvents_.load(std::memory_order_acquire);
+  if (numEvents <= events_.size()) {
+    return std::vector<Event>(events_.begin(), events_.begin() + numEvents);
+  }
+  // The oldest event is in the slot the next event goes to.
+  const auto oldest = numEvents & mask_;
+  std::vector<Event> result(events_.begin() + oldest, events_.end());
+  result.insert(result.end(), events_.begin(), events_.begin() + oldest);
+  return result;
+}
+
+uint64_t DriverTrace::numDropped() const {
+  const auto numEvents = numEvents_.load(std::memory_order_acquire);
+  return numEvents > events_.size() ? numEvents - events_.size() : 0;
+}
+
+// static
+std::string DriverTrace::eventTypeName(EventType type) {
+  switch (type) {
+    case EventType::kRun:
+      return "run";
+    case EventType::kGetOutput:
+      return "getOutput";
+    case EventType::kAddInput:
+      return "addInput";
+    case EventType::kNoMoreInput:
+      return "noMoreInput";
+    case EventType::kBlocked:
+      return "blocked";
+    case EventType::kSpill:
+      return "spill";
+  }
+  VELOX_UNREACHABLE();
+}
+
+// static
+std::string DriverTrace::toChromeTrace(
+    const std::vector<std::shared_ptr<DriverTrace>>& traces) {
+  std::string out = "{\"traceEvents\":[";
+  bool first = true;
+  for (const auto& trace : traces) {
+    for (const auto& event : trace->events()) {
+      const auto typeName = eventTypeName(event.type);
+      std::string name;
+      std::string args;
+      if (event.operatorId >= 0 &&
+          event.operatorId < trace->operatorNames_.size()) {
+        name = fmt::format(
+            "{}.{}", trace->operatorNames_[event.operatorId], typeName);
+        args = fmt::format("\"operatorId\":{}", event.operatorId);
+      } else {
+        name = typeName;
+      }
+      if (event.type == EventType::kBlocked) {
+        args += fmt::format(
+            "{}\"reason\":\"{}\"",
+            args.empty() ? "" : ",",
+            blockingReasonToString(static_cast<BlockingReason>(event.detail)));
+      }
+      out += fmt::format(
+          "{}{{\"name\":\"{}\",\"cat\":\"{}\",\"ph\":\"X\",\"ts\":{},"
+          "\"dur\":{},\"pid\":{},\"tid\":{},\"args\":{{{}}}}}",
+          first ? "" : ",",
+          name,
+          typeName,
+          event.startMicros,
+          event.durationMicros,
+          trace->pipelineId_,
+          trace->driverId_,
+          args);
+      first = false;
+    }
+  }
+  out += "]}";
+  return out;
+}
+
+} // namespace facebook::velox::exec
@@ -0,0 +1,113 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#pragma once
+
+#include <atomic>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace facebook::velox::exec {
+
+/// Timeline of the events of one Driver: the time spent on thread, in each
+/// operator call, blocked and spilling. Enabled with
+/// QueryConfig::kDriverTraceEnabled. Keeps the latest 'capacity' events in a
+/// ring buffer. Recording claims a slot with an atomic increment and takes no
+/// locks. Events are normally recorded by the thread running the Driver, but
+/// the resume of a blocked Driver and spilling on behalf of memory
+/// arbitration record from other threads while the Driver is off thread. The
+/// events must only be read once the Driver is done, e.g. after its Task
+/// finished.
+class DriverTrace {
+ public:
+  enum class EventType : uint8_t {
+    /// The Driver is on thread.
+    kRun,
+    kGetOutput,
+    kAddInput,
+    kNoMoreInput,
+    /// The Driver is off thread waiting on a future. 'detail' is the
+    /// BlockingReason.
+    kBlocked,
+    kSpill,
+  };
+
+  struct Event {
+    uint64_t startMicros;
+    uint64_t durationMicros;
+    /// Id of the operator in the pipeline. -1 for events of the whole Driver.
+    int32_t operatorId;
+    int32_t detail;
+    EventType type;
+  };
+
+  /// Records an event from construction to destruction. Does nothing if
+  /// 'trace' is nullptr, so that call sites cost a branch when tracing is
+  /// disabled.
+  class Scope {
+   public:
+    Scope(DriverTrace* trace, EventType type, int32_t operatorId);
+
+    ~Scope();
+
+   private:
+    DriverTrace* const trace_;
+    const EventType type_;
+    const int32_t operatorId_;
+    const uint64_t startMicros_;
+  };
+
+  /// 'operatorNames' is indexed on operator id. 'capacity' must be a power
+  /// of 2.
+  DriverTrace(
+      int32_t pipelineId,
+      int32_t driverId,
+      std::vector<std::string> operatorNames,
+      int32_t capacity = kDefaultCapacity);
+
+  void record(
+      EventType type,
+      int32_t operatorId,
+      uint64_t startMicros,
+      uint64_t endMicros,
+      int32_t detail = 0);
+
+  /// Returns the retained events, oldest first.
+  std::vector<Event> events() const;
+
+  /// Number of events overwritten by newer ones.
+  uint64_t numDropped() const;
+
+  /// Returns the events of 'traces' as a JSON object in the Chrome trace
+  /// event format, viewable in chrome://tracing or Perfetto. Each pipeline
+  /// is a process and each Driver a thread.
+  static std::string toChromeTrace(
+      const std::vector<std::shared_ptr<DriverTrace>>& traces);
+
+  static std::string eventTypeName(EventType type);
+
+  static constexpr int32_t kDefaultCapacity = 4096;
+
+ private:
+  const int32_t pipelineId_;
+  const int32_t driverId_;
+  const std::vector<std::string> operatorNames_;
+  const uint64_t mask_;
+  std::vector<Event> events_;
+  std::atomic<uint64_t> numEvents_{0};
+};
+
+} // namespace facebook::velox::exec
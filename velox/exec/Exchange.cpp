@@ -17,6 +17,7 @@
 #include <velox/buffer/Buffer.h>
 #include <velox/common/base/Exceptions.h>
 #include <velox/common/memory/MappedMemory.h>
+#include "velox/common/time/Timer.h"
 #include "velox/exec/PartitionedOutputBufferManager.h"
 
 namespace facebook::velox::exec {
@@ -40,6 +41,14 @@ SerializedPage::SerializedPage(
   }
 }
 
+SerializedPage::SerializedPage(
+    std::vector<RowVectorPtr> vectors,
+    uint64_t size,
+    std::shared_ptr<const void> owner)
+    : iobufBytes_(size),
+      vectors_(std::move(vectors)),
+      owner_(std::move(owner)) {}
+
 SerializedPage::~SerializedPage() {
   if (pool_ != nullptr) {
     pool_->release(iobufBytes_);
@@ -47,9 +56,52 @@ SerializedPage::~SerializedPage() {
 }
 
 void SerializedPage::prepareStreamForDeserialize(ByteStream* input) {
+  VELOX_CHECK(!hasVectors(), "A page of vectors cannot be deserialized");
   input->resetInput(std::move(ranges_));
 }
 
+RowVectorPtr SerializedPage::copyVectors(
+    const RowTypePtr& type,
+    memory::MemoryPool* pool) const {
+  VELOX_CHECK(hasVectors());
+  vector_size_t numRows = 0;
+  for (auto& vector : vectors_) {
+    numRows += vector->size();
+  }
+  auto result = std::static_pointer_cast<RowVector>(
+      BaseVector::create(type, numRows, pool));
+  vector_size_t offset = 0;
+  for (auto& vector : vectors_) {
+    result->copy(vector.get(), offset, 0, vector->size());
+    offset += vector->size();
+  }
+  return result;
+}
+
+void ExchangeQueue::deserialize(SerializedPage& page) {
+  std::unique_ptr<SerializedPage> result;
+  std::string error;
+  try {
+    result = deserializer_(page);
+  } catch (const std::exception& e) {
+    error = e.what();
+  }
+  std::lock_guard<std::mutex> l(mutex_);
+  --numDeserializing_;
+  if (!error.empty()) {
+    setErrorLocked(error);
+    return;
+  }
+  if (result) {
+    pushLocked(std::move(result));
+  } else {
+    totalBytes_ -= page.size();
+  }
+  if (atEnd_ && numDeserializing_ == 0) {
+    clearAllPromises();
+  }
+}
+
 std::shared_ptr<ExchangeSource> ExchangeSource::create(
     const std::string& taskId,
     int destination,
@@ -67,6 +119,28 @@ void ExchangeSource::setMemoryPool(memory::MemoryPool* pool) {
   pool_ = pool;
 }
 
+void ExchangeSource::recordRequestStart() {
+  requestStartUs_ = getCurrentTimeMicro();
+}
+
+void ExchangeSource::recordResponseLocked(uint64_t bytes) {
+  const auto latencyUs = getCurrentTimeMicro() - requestStartUs_;
+  ++stats_.numRequests;
+  stats_.numBytes += bytes;
+  stats_.latency.add(latencyUs * 1'000);
+  if (bytes == 0) {
+    // An end marker or a response after a timeout says nothing about the
+    // throughput.
+    return;
+  }
+  const double throughput =
+      bytes * 1'000'000.0 / std::max<uint64_t>(1, latencyUs);
+  stats_.throughput = stats_.throughput == 0
+      ? throughput
+      : (1 - kThroughputDecay) * stats_.throughput +
+          kThroughputDecay * throughput;
+}
+
 // static
 std::vector<ExchangeSource::Factory>& ExchangeSource::factories() {
   static std::vector<Factory> factories;
@@ -97,15 +171,17 @@ class LocalExchangeSource : public ExchangeSource {
     VELOX_CHECK(requestPending_);
     auto requestedSequence = sequence_;
     auto self = shared_from_this();
-    buffers->getData(
+    recordRequestStart();
+    buffers->getPages(
         taskId_,
         destination_,
-        kMaxBytes,
+        requestBytes_,
         sequence_,
         // Since this lambda may outlive 'this', we need to capture a
         // shared_ptr to the current object (self).
         [self, requestedSequence, buffers, this](
-            std::vector<std::unique_ptr<folly::IOBuf>> data, int64_t sequence) {
+            std::vector<std::shared_ptr<SerializedPage>> data,
+            int64_t sequence) {
           if (requestedSequence > sequence) {
             VLOG(2) << "Receives earlier sequence than requested: task "
                     << taskId_ << ", destination " << destination_
@@ -117,6 +193,7 @@ class LocalExchangeSource : public ExchangeSource {
             sequence = requestedSequence;
           }
           std::vector<std::unique_ptr<SerializedPage>> pages;
+          uint64_t bytes = 0;
           bool atEnd = false;
           for (auto& inputPage : data) {
             if (!inputPage) {
@@ -124,15 +201,26 @@ class LocalExchangeSource : public ExchangeSource {
               // Keep looping, there could be extra end markers.
               continue;
             }
-            inputPage->unshare();
-            pages.push_back(
-                std::make_unique<SerializedPage>(std::move(inputPage)));
+            if (inputPage->hasVectors()) {
+              // The vectors are shared with the producer, not copied.
+              pages.push_back(std::make_unique<SerializedPage>(
+                  inputPage->vectors(),
+                  inputPage->size(),
+                  inputPage->owner()));
+            } else {
+              auto iobuf = inputPage->getIOBuf();
+              iobuf->unshare();
+              pages.push_back(
+                  std::make_unique<SerializedPage>(std::move(iobuf)));
+            }
+            bytes += pages.back()->size();
             inputPage = nullptr;
           }
           int64_t ackSequence;
           {
             std::lock_guard<std::mutex> l(queue_->mutex());
             requestPending_ = false;
+            recordResponseLocked(bytes);
             for (auto& page : pages) {
               queue_->enqueue(std::move(page));
             }
@@ -152,9 +240,6 @@ class LocalExchangeSource : public ExchangeSource {
   }
 
   void close() override {}
-
- private:
-  static constexpr uint64_t kMaxBytes = 32 * 1024 * 1024; // 32 MB
 };
 
 std::unique_ptr<ExchangeSource> createLocalExchangeSource(
@@ -193,6 +278,7 @@ void ExchangeClient::addRemoteTaskId(const std::string& taskId) {
     sources_.push_back(source);
     queue_->addSource();
     if (source->shouldRequestLocked()) {
+      source->requestBytes_ = requestBytesLocked(*source);
       toRequest = source;
     }
   }
@@ -224,6 +310,7 @@ std::unique_ptr<SerializedPage> ExchangeClient::next(
     // request.
     for (auto& source : sources_) {
       if (source->shouldRequestLocked()) {
+        source->requestBytes_ = requestBytesLocked(*source);
         toRequest.push_back(source);
       }
     }
@@ -236,6 +323,45 @@ std::unique_ptr<SerializedPage> ExchangeClient::next(
   return page;
 }
 
+uint64_t ExchangeClient::requestBytesLocked(
+    const ExchangeSource& source) const {
+  const auto queued = queue_->totalBytes();
+  const auto space =
+      queued < queue_->minBytes() ? queue_->minBytes() - queued : 0;
+  double knownThroughput = 0;
+  int32_t numKnown = 0;
+  int32_t numActive = 0;
+  for (auto& other : sources_) {
+    if (other->atEnd_) {
+      continue;
+    }
+    ++numActive;
+    if (other->stats_.throughput > 0) {
+      knownThroughput += other->stats_.throughput;
+      ++numKnown;
+    }
+  }
+  double share = 1.0 / std::max(1, numActive);
+  if (numKnown > 0) {
+    const auto average = knownThroughput / numKnown;
+    const auto throughput = source.stats_.throughput > 0
+        ? source.stats_.throughput
+        : average;
+    share = throughput / (knownThroughput + (numActive - numKnown) * average);
+  }
+  return std::clamp<uint64_t>(
+      space * share, kMinRequestBytes, kMaxRequestBytes);
+}
+
+RuntimeHistogram ExchangeClient::requestLatency() {
+  std::lock_guard<std::mutex> l(queue_->mutex());
+  RuntimeHistogram latency;
+  for (auto& source : sources_) {
+    latency.merge(source->stats_.latency);
+  }
+  return latency;
+}
+
 ExchangeClient::~ExchangeClient() {
   for (auto& source : sources_) {
     source->close();
@@ -245,7 +371,9 @@ ExchangeClient::~ExchangeClient() {
 std::string ExchangeClient::toString() {
   std::stringstream out;
   for (auto& source : sources_) {
-    out << source->toString() << std::endl;
+    out << source->toString() << " requests: "
+        << source->stats_.latency.toString() << " bytes: "
+        << source->stats_.numBytes << std::endl;
   }
   return out.str();
 }
@@ -284,6 +412,75 @@ bool Exchange::getSplits(ContinueFuture* future) {
   }
 }
 
+void Exchange::recordRequestLatency() {
+  if (operatorCtx_->driverCtx()->driverId != 0) {
+    return;
+  }
+  auto latency = exchangeClient_->requestLatency();
+  if (latency.count() == 0) {
+    return;
+  }
+  for (auto pct : {50, 90, 99}) {
+    stats_.addRuntimeStat(
+        fmt::format("exchangeRequestLatencyP{}", pct),
+        RuntimeCounter(latency.percentile(pct), RuntimeCounter::Unit::kNanos));
+  }
+  RuntimeMetric metric(RuntimeCounter::Unit::kNanos);
+  metric.addHistogram(latency);
+  stats_.addRuntimeStat("exchangeRequestLatency", metric);
+}
+
+namespace {
+// Reads the batches of 'page' into vectors of 'type'. Consecutive batches
+// are appended to one vector while it has at most 'batchRows' rows. Returns
+// a page of the vectors with the size of 'page' and no owner.
+std::unique_ptr<SerializedPage> deserializePage(
+    SerializedPage& page,
+    const RowTypePtr& type,
+    memory::MemoryPool* pool,
+    VectorSerde* serde,
+    const VectorSerde::Options* options,
+    vector_size_t batchRows) {
+  ByteStream input;
+  page.prepareStreamForDeserialize(&input);
+  std::vector<RowVectorPtr> vectors;
+  while (!input.atEnd()) {
+    RowVectorPtr batch;
+    VectorStreamGroup::read(&input, pool, type, &batch, options, serde);
+    if (!vectors.empty() &&
+        vectors.back()->size() + batch->size() <= batchRows) {
+      vectors.back()->append(batch.get());
+    } else {
+      vectors.push_back(std::move(batch));
+    }
+  }
+  return std::make_unique<SerializedPage>(
+      std::move(vectors), page.size(), nullptr);
+}
+} // namespace
+
+void Exchange::setDeserializer(DriverCtx* ctx) {
+  const auto& config = ctx->queryConfig();
+  const vector_size_t batchRows =
+      config.exchangeMergeBatches() ? config.preferredOutputBatchSize() : 0;
+  exchangeClient_->queue()->setDeserializer(
+      ctx->task->queryCtx()->executor(),
+      [task = std::weak_ptr<Task>(ctx->task),
+       type = outputType_,
+       pool = exchangeClient_->pool(),
+       serde = serde_,
+       options = serdeOptions_,
+       batchRows](SerializedPage& page) -> std::unique_ptr<SerializedPage> {
+        // The Task keeps 'pool' alive. Pages that arrive after the Task is
+        // gone are dropped.
+        auto pinnedTask = task.lock();
+        if (!pinnedTask) {
+          return nullptr;
+        }
+        return deserializePage(page, type, pool, serde, &options, batchRows);
+      });
+}
+
 BlockingReason Exchange::isBlocked(ContinueFuture* future) {
   if (currentPage_ || atEnd_) {
     return BlockingReason::kNotBlocked;
@@ -302,6 +499,9 @@ BlockingReason Exchange::isBlocked(ContinueFuture* future) {
     if (atEnd_ && noMoreSplits_) {
       operatorCtx_->task()->multipleSplitsFinished(stats_.numSplits);
     }
+    if (atEnd_) {
+      recordRequestLatency();
+    }
     return BlockingReason::kNotBlocked;
   }
 
@@ -331,6 +531,34 @@ RowVectorPtr Exchange::getOutput() {
     return nullptr;
   }
 
+  if (currentPage_->hasVectors() && !currentPage_->owner()) {
+    // A page deserialized by the ExchangeQueue. The vectors are in the pool
+    // of 'exchangeClient_' and are returned one at a time as they are.
+    const auto& vectors = currentPage_->vectors();
+    if (vectorIndex_ == 0) {
+      stats_.rawInputBytes += currentPage_->size();
+    }
+    result_ = vectorIndex_ < vectors.size() ? vectors[vectorIndex_++] : nullptr;
+    if (vectorIndex_ >= vectors.size()) {
+      currentPage_ = nullptr;
+      vectorIndex_ = 0;
+    }
+    if (result_) {
+      stats_.inputPositions += result_->size();
+      stats_.inputBytes += result_->retainedSize();
+    }
+    return result_;
+  }
+
+  if (currentPage_->hasVectors()) {
+    stats_.rawInputBytes += currentPage_->size();
+    result_ = currentPage_->copyVectors(outputType_, operatorCtx_->pool());
+    currentPage_ = nullptr;
+    stats_.inputPositions += result_->size();
+    stats_.inputBytes += result_->retainedSize();
+    return result_;
+  }
+
   if (!inputStream_) {
     inputStream_ = std::make_unique<ByteStream>();
     stats_.rawInputBytes += currentPage_->size();
@@ -338,7 +566,12 @@ RowVectorPtr Exchange::getOutput() {
   }
 
   VectorStreamGroup::read(
-      inputStream_.get(), operatorCtx_->pool(), outputType_, &result_);
+      inputStream_.get(),
+      operatorCtx_->pool(),
+      outputType_,
+      &result_,
+      &serdeOptions_,
+      serde_);
 
   stats_.inputPositions += result_->size();
   stats_.inputBytes += result_->retainedSize();
@@ -19,6 +19,7 @@
 #include <memory>
 #include "velox/common/memory/ByteStream.h"
 #include "velox/exec/Operator.h"
+#include "velox/exec/OperatorUtils.h"
 
 namespace facebook::velox::exec {
 
@@ -36,6 +37,16 @@ class SerializedPage {
       std::unique_ptr<folly::IOBuf> iobuf,
       memory::MemoryPool* pool = nullptr);
 
+  // Constructs a page that hands 'vectors' to a consumer in the same
+  // process instead of their serialized form. 'size' is the estimated
+  // serialized size, used for flow control as the size of a serialized page
+  // would be. 'owner' owns the memory of 'vectors', e.g. the producing Task,
+  // and is kept alive with the page.
+  SerializedPage(
+      std::vector<RowVectorPtr> vectors,
+      uint64_t size,
+      std::shared_ptr<const void> owner);
+
   ~SerializedPage();
 
   // Returns the size of the serialized data in bytes.
@@ -48,9 +59,30 @@ class SerializedPage {
   void prepareStreamForDeserialize(ByteStream* input);
 
   std::unique_ptr<folly::IOBuf> getIOBuf() const {
+    VELOX_CHECK_NOT_NULL(
+        iobuf_, "A page of vectors can only be read in the same process");
     return iobuf_->clone();
   }
 
+  // Returns true if 'this' holds vectors instead of serialized data.
+  bool hasVectors() const {
+    return !iobuf_;
+  }
+
+  const std::vector<RowVectorPtr>& vectors() const {
+    return vectors_;
+  }
+
+  const std::shared_ptr<const void>& owner() const {
+    return owner_;
+  }
+
+  // Returns the rows of the vectors of a page of vectors copied into one
+  // vector of 'type' allocated from 'pool'. The result does not depend on
+  // the memory of the producer.
+  RowVectorPtr copyVectors(const RowTypePtr& type, memory::MemoryPool* pool)
+      const;
+
  private:
   static int64_t chainBytes(folly::IOBuf& iobuf) {
     int64_t size = 0;
@@ -66,16 +98,25 @@ class SerializedPage {
   // IOBuf holding the data in 'ranges_.
   std::unique_ptr<folly::IOBuf> iobuf_;
 
-  // Number of payload bytes in 'iobuf_'.
+  // Number of payload bytes in 'iobuf_'. The estimated serialized size of
+  // 'vectors_' for a page of vectors.
   const int64_t iobufBytes_;
   memory::MemoryPool* pool_{nullptr};
+
+  // The vectors of a page without 'iobuf_'.
+  std::vector<RowVectorPtr> vectors_;
+  std::shared_ptr<const void> owner_;
 };
 
 // Queue of results retrieved from source. Owned by shared_ptr by
 // Exchange and client threads and registered callbacks waiting
 // for input.
-class ExchangeQueue {
+class ExchangeQueue : public std::enable_shared_from_this<ExchangeQueue> {
  public:
+  // Turns a serialized page into a page of vectors.
+  using Deserializer =
+      std::function<std::unique_ptr<SerializedPage>(SerializedPage& page)>;
+
   explicit ExchangeQueue(int64_t minBytes) : minBytes_(minBytes) {}
 
   ~ExchangeQueue() {
@@ -91,6 +132,20 @@ class ExchangeQueue {
     return queue_.empty();
   }
 
+  // Makes enqueue() deserialize serialized pages with 'deserializer' on
+  // 'executor' instead of queueing them as is. The pages become visible to
+  // dequeue() when deserialized, in the order they finish. The pages count
+  // towards totalBytes() with their serialized size from arrival until
+  // dequeued, so the deserialized data is bounded by the same flow control
+  // as the serialized data. Only the first call has an effect.
+  void setDeserializer(folly::Executor* executor, Deserializer deserializer) {
+    std::lock_guard<std::mutex> l(mutex_);
+    if (!deserializer_) {
+      executor_ = executor;
+      deserializer_ = std::move(deserializer);
+    }
+  }
+
   void enqueue(std::unique_ptr<SerializedPage>&& page) {
     if (!page) {
       ++numCompleted_;
@@ -98,12 +153,14 @@ class ExchangeQueue {
       return;
     }
     totalBytes_ += page->size();
-    queue_.push_back(std::move(page));
-    if (!promises_.empty()) {
-      // Resume one of the waiting drivers.
-      promises_.back().setValue();
-      promises_.pop_back();
+    if (deserializer_ && !page->hasVectors()) {
+      ++numDeserializing_;
+      executor_->add([self = shared_from_this(), page = std::move(page)]() {
+        self->deserialize(*page);
+      });
+      return;
     }
+    pushLocked(std::move(page));
   }
 
   // If data is permanently not available, e.g. the source cannot be
@@ -125,7 +182,7 @@ class ExchangeQueue {
       throw std::runtime_error(error_);
     }
     if (queue_.empty()) {
-      if (atEnd_) {
+      if (atEnd_ && numDeserializing_ == 0) {
         *atEnd = true;
       } else {
         promises_.emplace_back("ExchangeQueue::dequeue");
@@ -164,6 +221,19 @@ class ExchangeQueue {
   }
 
  private:
+  void pushLocked(std::unique_ptr<SerializedPage>&& page) {
+    queue_.push_back(std::move(page));
+    if (!promises_.empty()) {
+      // Resume one of the waiting drivers.
+      promises_.back().setValue();
+      promises_.pop_back();
+    }
+  }
+
+  // Replaces 'page' with its deserialized form in the queue. Runs on
+  // 'executor_'.
+  void deserialize(SerializedPage& page);
+
   void checkComplete() {
     if (noMoreSources_ && numCompleted_ == numSources_) {
       atEnd_ = true;
@@ -194,10 +264,35 @@ class ExchangeQueue {
   // If 'totalBytes_' < 'minBytes_', an exchange should request more data from
   // producers.
   uint64_t minBytes_;
+
+  // Set by setDeserializer().
+  folly::Executor* FOLLY_NULLABLE executor_{nullptr};
+  Deserializer deserializer_;
+
+  // Number of pages being deserialized. The queue is not at end while
+  // there are any.
+  int32_t numDeserializing_{0};
 };
 
 class ExchangeSource : public std::enable_shared_from_this<ExchangeSource> {
  public:
+  /// Counters of the requests of a source. Updated with the mutex of the
+  /// queue held.
+  struct Stats {
+    int64_t numRequests{0};
+    int64_t numBytes{0};
+
+    /// Nanoseconds from request() to the response.
+    RuntimeHistogram latency;
+
+    /// Bytes per second received in recent responses. 0 before the first
+    /// response.
+    double throughput{0};
+  };
+
+  /// Limit for the bytes of a response unless ExchangeClient sets another.
+  static constexpr uint64_t kDefaultRequestBytes = 32 << 20; // 32 MB.
+
   using Factory = std::function<std::shared_ptr<ExchangeSource>(
       const std::string& taskId,
       int destination,
@@ -225,9 +320,11 @@ class ExchangeSource : public std::enable_shared_from_this<ExchangeSource> {
   // threads from issuing the same request.
   virtual bool shouldRequestLocked() = 0;
 
-  // Requests the producer to generate more data. Call only if shouldRequest()
-  // was true. The object handles its own lifetime by acquiring a
-  // shared_from_this() pointer if needed.
+  // Requests the producer to generate more data, up to about
+  // 'requestBytes_'. Call only if shouldRequest() was true. The object
+  // handles its own lifetime by acquiring a shared_from_this() pointer if
+  // needed. Implementations call recordRequestStart() and
+  // recordResponseLocked().
   virtual void request() = 0;
 
   // Close the exchange source. May be called before all data
@@ -262,8 +359,27 @@ class ExchangeSource : public std::enable_shared_from_this<ExchangeSource> {
   bool requestPending_ = false;
   bool atEnd_ = false;
 
+  // Limit for the bytes of the response to the next request(). Set by
+  // ExchangeClient with the queue mutex held before calling request().
+  uint64_t requestBytes_{kDefaultRequestBytes};
+
+  Stats stats_;
+
  protected:
+  // Records the start of a request for the latency and throughput.
+  void recordRequestStart();
+
+  // Records a response of 'bytes' to the request. Called with the queue
+  // mutex held.
+  void recordResponseLocked(uint64_t bytes);
+
   memory::MemoryPool* pool_{nullptr};
+
+ private:
+  // Weight of the latest response in 'stats_.throughput'.
+  static constexpr double kThroughputDecay = 0.3;
+
+  uint64_t requestStartUs_{0};
 };
 
 struct RemoteConnectorSplit : public connector::ConnectorSplit {
@@ -306,9 +422,26 @@ class ExchangeClient {
 
   std::unique_ptr<SerializedPage> next(bool* atEnd, ContinueFuture* future);
 
+  // Returns the latencies in nanoseconds of the requests to all sources so
+  // far.
+  RuntimeHistogram requestLatency();
+
   std::string toString();
 
  private:
+  // Lower and upper limits of the bytes requested from one source.
+  static constexpr uint64_t kMinRequestBytes = 1 << 20; // 1 MB.
+  static constexpr uint64_t kMaxRequestBytes =
+      ExchangeSource::kDefaultRequestBytes;
+
+  // Returns the bytes to request from 'source'. The space left in the queue
+  // below its minBytes() is divided among the sources that are not at end
+  // in proportion to their throughput, so that fast sources are asked for
+  // more. Sources without a response yet count as having the average
+  // throughput.
+  uint64_t requestBytesLocked(const ExchangeSource& source) const;
+
+
   const int destination_;
   std::shared_ptr<ExchangeQueue> queue_;
   std::unordered_set<std::string> taskIds_;
@@ -332,6 +465,12 @@ class Exchange : public SourceOperator {
         planNodeId_(exchangeNode->id()),
         exchangeClient_(std::move(exchangeClient)) {
     exchangeClient_->maybeSetMemoryPool(operatorCtx_->pool());
+    serde_ = namedVectorSerde(ctx->queryConfig().exchangeSerde());
+    serdeOptions_.compressionKind = compressionCodec(
+        ctx->queryConfig().exchangeCompressionKind(), "exchange");
+    if (ctx->queryConfig().exchangeParallelDeserialize()) {
+      setDeserializer(ctx);
+    }
   }
 
   ~Exchange() override {
@@ -360,6 +499,15 @@ class Exchange : public SourceOperator {
   /// exchangeClient_.
   bool getSplits(ContinueFuture* future);
 
+  /// Makes the queue of 'exchangeClient_' deserialize pages on the executor
+  /// of the query. The pages are read into the memory pool of the client.
+  void setDeserializer(DriverCtx* ctx);
+
+  /// Adds percentiles and the histogram of the latency of the requests of
+  /// 'exchangeClient_' to the runtime stats. Called at end. Only the operator
+  /// of driver 0 does this, since the client is shared.
+  void recordRequestLatency();
+
   const core::PlanNodeId planNodeId_;
   bool noMoreSplits_ = false;
 
@@ -370,8 +518,18 @@ class Exchange : public SourceOperator {
   RowVectorPtr result_;
   std::shared_ptr<ExchangeClient> exchangeClient_;
   std::unique_ptr<SerializedPage> currentPage_;
+
+  // Index of the next vector of a 'currentPage_' deserialized by the
+  // ExchangeQueue.
+  size_t vectorIndex_{0};
   std::unique_ptr<ByteStream> inputStream_;
   bool atEnd_{false};
+
+  // Serde of the pages. nullptr for the default serde.
+  VectorSerde* FOLLY_NULLABLE serde_{nullptr};
+
+  // Gives the codec for reading compressed pages.
+  VectorSerde::Options serdeOptions_;
 };
 
 } // namespace facebook::velox::exec
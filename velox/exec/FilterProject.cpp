@@ -103,6 +103,31 @@ bool FilterProject::allInputProcessed() {
   return false;
 }
 
+void FilterProject::finalizeStats() {
+  if (!operatorCtx_->driverCtx()->queryConfig().exprTrackCpuUsage()) {
+    return;
+  }
+  for (const auto& [name, exprStats] : exprs_->stats()) {
+    stats_.addRuntimeStat(
+        fmt::format("expr.{}.cpuNanos", name),
+        RuntimeCounter(
+            exprStats.timing.cpuNanos, RuntimeCounter::Unit::kNanos));
+    stats_.addRuntimeStat(
+        fmt::format("expr.{}.wallNanos", name),
+        RuntimeCounter(
+            exprStats.timing.wallNanos, RuntimeCounter::Unit::kNanos));
+    stats_.addRuntimeStat(
+        fmt::format("expr.{}.numProcessedRows", name),
+        RuntimeCounter(exprStats.numProcessedRows));
+    stats_.addRuntimeStat(
+        fmt::format("expr.{}.numPeeledRows", name),
+        RuntimeCounter(exprStats.numPeeledRows));
+    stats_.addRuntimeStat(
+        fmt::format("expr.{}.numFlatRows", name),
+        RuntimeCounter(exprStats.numFlatRows));
+  }
+}
+
 bool FilterProject::isFinished() {
   return noMoreInput_ && allInputProcessed();
 }
@@ -150,6 +175,8 @@ RowVectorPtr FilterProject::getOutput() {
   if (!isIdentityProjection_) {
     if (!allRowsSelected) {
       rows->setFromBits(filterEvalCtx_.selectedBits->as<uint64_t>(), size);
+      // All projections iterate over the rows that passed the filter.
+      rows->prepareIteration();
     }
     project(*rows, &evalCtx);
   }
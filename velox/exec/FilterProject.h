@@ -37,6 +37,10 @@ class FilterProject : public Operator {
     return true;
   }
 
+  bool preservesCardinality() const override {
+    return !hasFilter_;
+  }
+
   bool needsInput() const override {
     return !input_;
   }
@@ -56,6 +60,11 @@ class FilterProject : public Operator {
     exprs_->clear();
   }
 
+  // Adds the stats of the expressions aggregated by function name as runtime
+  // stats named expr.<name>.<stat>, if QueryConfig::exprTrackCpuUsage() is
+  // true.
+  void finalizeStats() override;
+
  private:
   // Tests if 'numProcessedRows_' equals to the length of input_ and clears
   // outstanding references to input_ if done. Returns true if getOutput
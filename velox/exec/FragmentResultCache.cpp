@@ -0,0 +1,218 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#include "velox/exec/FragmentResultCache.h"
+
+#include <map>
+#include <sstream>
+
+#include "velox/exec/Task.h"
+#include "velox/vector/VectorStream.h"
+
+namespace facebook::velox::exec {
+
+namespace {
+void collectLeaves(
+    const core::PlanNodePtr& node,
+    std::vector<core::PlanNodePtr>& leaves) {
+  if (node->sources().empty()) {
+    leaves.push_back(node);
+    return;
+  }
+  for (const auto& source : node->sources()) {
+    collectLeaves(source, leaves);
+  }
+}
+
+// Appends the column assignments of the scans under 'node', which the plan
+// text does not show, in a deterministic order.
+void addAssignments(const core::PlanNode& node, std::stringstream& out) {
+  if (auto scan = dynamic_cast<const core::TableScanNode*>(&node)) {
+    std::map<std::string, std::string> ordered;
+    for (const auto& [name, handle] : scan->assignments()) {
+      ordered[name] = handle->toString();
+    }
+    for (const auto& [name, handle] : ordered) {
+      out << name << "=" << handle << ";";
+    }
+    out << std::endl;
+  }
+  for (const auto& source : node.sources()) {
+    addAssignments(*source, out);
+  }
+}
+
+std::string serialize(const RowVectorPtr& vector) {
+  VectorStreamGroup streamGroup(memory::MappedMemory::getInstance());
+  streamGroup.createStreamTree(asRowType(vector->type()), vector->size());
+  IndexRange range{0, vector->size()};
+  streamGroup.append(vector, folly::Range<IndexRange*>(&range, 1));
+  std::ostringstream out;
+  OStreamOutputStream outputStream(&out);
+  streamGroup.flush(&outputStream);
+  return out.str();
+}
+} // namespace
+
+// static
+std::string FragmentResultCache::makeKey(
+    const core::PlanNode& fragment,
+    const connector::ConnectorSplit& split) {
+  std::stringstream out;
+  out << fragment.toString(true, true);
+  addAssignments(fragment, out);
+  out << split.connectorId << " " << split.toString();
+  return out.str();
+}
+
+std::optional<std::vector<RowVectorPtr>> FragmentResultCache::get(
+    const std::string& key,
+    const RowTypePtr& type,
+    memory::MemoryPool* pool) {
+  std::string data;
+  {
+    std::lock_guard<std::mutex> l(mutex_);
+    auto it = entries_.find(key);
+    if (it == entries_.end()) {
+      ++numMisses_;
+      return std::nullopt;
+    }
+    ++numHits_;
+    lru_.splice(lru_.begin(), lru_, it->second.lruPosition);
+    // Copied so that deserializing does not hold the mutex.
+    data = it->second.data;
+  }
+  std::vector<RowVectorPtr> results;
+  if (data.empty()) {
+    return results;
+  }
+  ByteStream input;
+  input.resetInput({ByteRange{
+      reinterpret_cast<uint8_t*>(data.data()),
+      static_cast<int32_t>(data.size()),
+      0}});
+  while (!input.atEnd()) {
+    RowVectorPtr result;
+    VectorStreamGroup::read(&input, pool, type, &result);
+    results.push_back(std::move(result));
+  }
+  return results;
+}
+
+void FragmentResultCache::put(
+    const std::string& key,
+    const std::vector<RowVectorPtr>& results) {
+  std::string data;
+  for (const auto& result : results) {
+    data += serialize(result);
+  }
+  if (key.size() + data.size() > maxBytes_) {
+    return;
+  }
+  std::lock_guard<std::mutex> l(mutex_);
+  auto it = entries_.find(key);
+  if (it != entries_.end()) {
+    bytes_ -= key.size() + it->second.data.size();
+    lru_.erase(it->second.lruPosition);
+    entries_.erase(it);
+  }
+  bytes_ += key.size() + data.size();
+  lru_.push_front(key);
+  entries_[key] = Entry{std::move(data), lru_.begin()};
+  evictLocked();
+}
+
+void FragmentResultCache::evictLocked() {
+  while (bytes_ > maxBytes_) {
+    VELOX_CHECK(!lru_.empty());
+    auto it = entries_.find(lru_.back());
+    VELOX_CHECK(it != entries_.end());
+    bytes_ -= it->first.size() + it->second.data.size();
+    entries_.erase(it);
+    lru_.pop_back();
+    ++numEvictions_;
+  }
+}
+
+std::vector<RowVectorPtr> FragmentResultCache::run(
+    const core::PlanNodePtr& fragment,
+    const std::vector<Split>& splits,
+    const std::shared_ptr<core::QueryCtx>& queryCtx,
+    memory::MemoryPool* pool) {
+  std::vector<core::PlanNodePtr> leaves;
+  collectLeaves(fragment, leaves);
+  VELOX_USER_CHECK_EQ(
+      leaves.size(), 1, "A cached fragment must have exactly one leaf");
+  VELOX_USER_CHECK_NOT_NULL(
+      std::dynamic_pointer_cast<const core::TableScanNode>(leaves[0]),
+      "The leaf of a cached fragment must be a table scan");
+  const auto& scanId = leaves[0]->id();
+  const auto& type = fragment->outputType();
+
+  std::vector<RowVectorPtr> allResults;
+  for (const auto& split : splits) {
+    VELOX_USER_CHECK(split.hasConnectorSplit());
+    const auto key = makeKey(*fragment, *split.connectorSplit);
+    if (auto cached = get(key, type, pool)) {
+      for (auto& result : cached.value()) {
+        allResults.push_back(std::move(result));
+      }
+      continue;
+    }
+
+    auto task = std::make_shared<Task>(
+        fmt::format("fragment-result-cache-{}", ++numTasks_),
+        core::PlanFragment{fragment},
+        0,
+        queryCtx);
+    task->addSplit(scanId, Split(split));
+    task->noMoreSplits(scanId);
+    std::vector<RowVectorPtr> results;
+    while (auto result = task->next()) {
+      // Copied out of the Task's memory, which goes away with the Task.
+      auto copy = std::static_pointer_cast<RowVector>(
+          BaseVector::create(type, result->size(), pool));
+      copy->copy(result.get(), 0, 0, result->size());
+      results.push_back(std::move(copy));
+    }
+    put(key, results);
+    for (auto& result : results) {
+      allResults.push_back(std::move(result));
+    }
+  }
+  return allResults;
+}
+
+FragmentResultCache::Stats FragmentResultCache::stats() const {
+  std::lock_guard<std::mutex> l(mutex_);
+  Stats stats;
+  stats.numHits = numHits_;
+  stats.numMisses = numMisses_;
+  stats.numEntries = entries_.size();
+  stats.numEvictions = numEvictions_;
+  stats.bytes = bytes_;
+  return stats;
+}
+
+void FragmentResultCache::clear() {
+  std::lock_guard<std::mutex> l(mutex_);
+  entries_.clear();
+  lru_.clear();
+  bytes_ = 0;
+}
+
+} // namespace facebook::velox::exec
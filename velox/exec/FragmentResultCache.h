@@ -0,0 +1,108 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#pragma once
+
+#include <folly/container/F14Map.h>
+#include <atomic>
+#include <list>
+#include <mutex>
+#include <optional>
+
+#include "velox/core/PlanNode.h"
+#include "velox/core/QueryCtx.h"
+#include "velox/exec/Split.h"
+
+namespace facebook::velox::exec {
+
+/// Caches the results of running a plan fragment, e.g. a scan, filter and
+/// partial aggregation, on one split. A repeated fragment over the same
+/// immutable split is then answered without scanning or aggregating. The key
+/// is the detailed text of the fragment, which includes filters and output
+/// types but not plan node ids, the column assignments of its scans and the
+/// split. The split text identifies the data, e.g. file path and byte range,
+/// so callers whose files can change in place must put a version in the
+/// path. Results are kept serialized with the default VectorSerde, so they
+/// do not hold memory of the Task that made them. The least recently used
+/// entries are dropped to stay under 'maxBytes'. Thread safe.
+class FragmentResultCache {
+ public:
+  struct Stats {
+    int64_t numHits{0};
+    int64_t numMisses{0};
+    int64_t numEntries{0};
+    int64_t numEvictions{0};
+    uint64_t bytes{0};
+  };
+
+  explicit FragmentResultCache(uint64_t maxBytes) : maxBytes_(maxBytes) {}
+
+  /// Returns the key for the results of 'fragment' on 'split'.
+  static std::string makeKey(
+      const core::PlanNode& fragment,
+      const connector::ConnectorSplit& split);
+
+  /// Returns the results cached under 'key', deserialized into 'pool', or
+  /// std::nullopt if there are none.
+  std::optional<std::vector<RowVectorPtr>> get(
+      const std::string& key,
+      const RowTypePtr& type,
+      memory::MemoryPool* pool);
+
+  /// Caches 'results' under 'key'. Results larger than 'maxBytes_' are not
+  /// cached.
+  void put(const std::string& key, const std::vector<RowVectorPtr>& results);
+
+  /// Returns the results of 'fragment' on each of 'splits', in order. The
+  /// results of a split come from the cache or from running 'fragment' on
+  /// the split alone in a single-threaded Task, after which they are cached.
+  /// 'fragment' must have exactly one leaf and it must be a TableScanNode.
+  /// The results are in 'pool'.
+  std::vector<RowVectorPtr> run(
+      const core::PlanNodePtr& fragment,
+      const std::vector<Split>& splits,
+      const std::shared_ptr<core::QueryCtx>& queryCtx,
+      memory::MemoryPool* pool);
+
+  Stats stats() const;
+
+  void clear();
+
+ private:
+  struct Entry {
+    std::string data;
+    std::list<std::string>::iterator lruPosition;
+  };
+
+  // Drops the least recently used entries until 'bytes_' is at most
+  // 'maxBytes_'.
+  void evictLocked();
+
+  const uint64_t maxBytes_;
+
+  mutable std::mutex mutex_;
+  folly::F14FastMap<std::string, Entry> entries_;
+  // Keys of 'entries_', most recently used first.
+  std::list<std::string> lru_;
+  uint64_t bytes_{0};
+  int64_t numHits_{0};
+  int64_t numMisses_{0};
+  int64_t numEvictions_{0};
+  std::atomic<int64_t> numTasks_{0};
+};
+
+} // namespace facebook::velox::exec
@@ -79,8 +79,11 @@ RowVectorPtr GroupId::getOutput() {
     return nullptr;
   }
 
-  // Make a copy of input for the grouping set at 'groupingSetIndex_'.
+  // The output for the grouping set at 'groupingSetIndex_' references the
+  // input columns. The absent grouping keys and the groupId column are
+  // constants shared by all outputs of the same size.
   auto numInput = input_->size();
+  prepareConstants(numInput);
 
   std::vector<VectorPtr> outputColumns(outputType_->size());
 
@@ -90,9 +93,7 @@ RowVectorPtr GroupId::getOutput() {
   // Fill in grouping keys.
   for (auto i = 0; i < numGroupingKeys; ++i) {
     if (mapping[i] == kMissingGroupingKey) {
-      // Add null column.
-      outputColumns[i] = BaseVector::createNullConstant(
-          outputType_->childAt(i), numInput, pool());
+      outputColumns[i] = nullKeys_[i];
     } else {
       outputColumns[i] = input_->childAt(mapping[i]);
     }
@@ -104,8 +105,7 @@ RowVectorPtr GroupId::getOutput() {
   }
 
   // Add groupId column.
-  outputColumns[outputType_->size() - 1] =
-      BaseVector::createConstant((int64_t)groupingSetIndex_, numInput, pool());
+  outputColumns[outputType_->size() - 1] = groupIds_[groupingSetIndex_];
 
   ++groupingSetIndex_;
   if (groupingSetIndex_ == groupingKeyMappings_.size()) {
@@ -117,4 +117,20 @@ RowVectorPtr GroupId::getOutput() {
       pool(), outputType_, nullptr, numInput, std::move(outputColumns));
 }
 
+void GroupId::prepareConstants(vector_size_t size) {
+  if (!groupIds_.empty() && groupIds_[0]->size() == size) {
+    return;
+  }
+  const auto numGroupingKeys = groupingKeyMappings_[0].size();
+  nullKeys_.resize(numGroupingKeys);
+  for (auto i = 0; i < numGroupingKeys; ++i) {
+    nullKeys_[i] =
+        BaseVector::createNullConstant(outputType_->childAt(i), size, pool());
+  }
+  groupIds_.resize(groupingKeyMappings_.size());
+  for (auto i = 0; i < groupIds_.size(); ++i) {
+    groupIds_[i] = BaseVector::createConstant((int64_t)i, size, pool());
+  }
+}
+
 } // namespace facebook::velox::exec
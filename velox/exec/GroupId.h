@@ -44,6 +44,10 @@ class GroupId : public Operator {
   static constexpr column_index_t kMissingGroupingKey =
       std::numeric_limits<column_index_t>::max();
 
+  // Makes 'nullKeys_' and 'groupIds_' of 'size' rows unless they already
+  // have that size.
+  void prepareConstants(vector_size_t size);
+
   bool finished_{false};
 
   /// A grouping set contains a subset of all the grouping keys. This list
@@ -64,5 +68,12 @@ class GroupId : public Operator {
   /// and lookup the input-to-output column mappings in the
   /// groupingKeyMappings_.
   int32_t groupingSetIndex_{0};
+
+  /// Null constants for the grouping keys that are absent from a grouping
+  /// set, by output channel, and the groupId constants, by grouping set.
+  /// These are shared by all outputs until the input size changes, so that
+  /// no output column is copied or allocated per grouping set.
+  std::vector<VectorPtr> nullKeys_;
+  std::vector<VectorPtr> groupIds_;
 };
 } // namespace facebook::velox::exec
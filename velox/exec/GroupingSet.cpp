@@ -44,7 +44,8 @@ std::optional<std::string> makeSpillPath(
   }
   auto path = operatorCtx.task()->queryCtx()->config().spillPath();
   if (path.has_value()) {
-    return path.value() + "/" + operatorCtx.task()->taskId();
+    return appendToSpillPath(
+        path.value(), "/" + operatorCtx.task()->taskId());
   }
   return std::nullopt;
 }
@@ -55,13 +56,15 @@ GroupingSet::GroupingSet(
     std::vector<column_index_t>&& preGroupedKeys,
     std::vector<std::unique_ptr<Aggregate>>&& aggregates,
     std::vector<std::optional<column_index_t>>&& aggrMaskChannels,
+    std::vector<bool>&& aggregateDistincts,
     std::vector<std::vector<column_index_t>>&& channelLists,
     std::vector<std::vector<VectorPtr>>&& constantLists,
     std::vector<TypePtr>&& intermediateTypes,
     bool ignoreNullKeys,
     bool isPartial,
     bool isRawInput,
-    OperatorCtx* FOLLY_NONNULL operatorCtx)
+    OperatorCtx* FOLLY_NONNULL operatorCtx,
+    std::function<std::vector<std::unique_ptr<Aggregate>>()> makeAggregates)
     : preGroupedKeyChannels_(std::move(preGroupedKeys)),
       hashers_(std::move(hashers)),
       isGlobal_(hashers_.empty()),
@@ -69,8 +72,13 @@ GroupingSet::GroupingSet(
       isRawInput_(isRawInput),
       aggregates_(std::move(aggregates)),
       masks_{std::move(aggrMaskChannels)},
+      distincts_(
+          std::move(aggregateDistincts),
+          operatorCtx->mappedMemory(),
+          operatorCtx->pool()),
       channelLists_(std::move(channelLists)),
       constantLists_(std::move(constantLists)),
+      evaluationOrder_(masks_.evaluationOrder(channelLists_)),
       intermediateTypes_(std::move(intermediateTypes)),
       ignoreNullKeys_(ignoreNullKeys),
       mappedMemory_(operatorCtx->mappedMemory()),
@@ -79,9 +87,26 @@ GroupingSet::GroupingSet(
       isAdaptive_(
           operatorCtx->task()->queryCtx()->config().hashAdaptivityEnabled()),
       execCtx_(*operatorCtx->execCtx()),
-      spillPath_(makeSpillPath(isPartial, *operatorCtx)),
+      operatorCtx_(*operatorCtx),
+      // Spilled groups are merged from their intermediate results, which do
+      // not carry the values seen by distinct aggregates.
+      spillPath_(
+          distincts_.empty() ? makeSpillPath(isPartial, *operatorCtx)
+                             : std::nullopt),
+      spillMergeThreads_(std::max<int32_t>(
+          1,
+          operatorCtx->task()
+              ->queryCtx()
+              ->config()
+              .aggregationSpillMergeThreads())),
+      makeAggregates_(std::move(makeAggregates)),
       pool_(*operatorCtx->pool()),
       spillExecutor_(operatorCtx->task()->queryCtx()->spillExecutor()),
+      spillCompression_(spillCompressionCodec(
+          spillPath_,
+          operatorCtx->task()->queryCtx()->config().spillCompressionKind())),
+      spillLocalQuotaBytes_(
+          operatorCtx->task()->queryCtx()->config().spillLocalQuotaBytes()),
       testSpillPct_(
           operatorCtx->task()->queryCtx()->config().testingSpillPct()) {
   for (auto& hasher : hashers_) {
@@ -98,6 +123,16 @@ GroupingSet::GroupingSet(
   }
 }
 
+GroupingSet::~GroupingSet() {
+  // Waits for the batches being made on 'spillExecutor_', which refer to
+  // 'mergers_'. Errors are dropped.
+  for (auto& batch : mergeBatches_) {
+    if (batch) {
+      batch->move();
+    }
+  }
+}
+
 namespace {
 bool equalKeys(
     const std::vector<column_index_t>& keys,
@@ -139,14 +174,57 @@ void GroupingSet::addInput(const RowVectorPtr& input, bool mayPushdown) {
         break;
       }
     }
+    // The groups in the table are also complete if 'input' starts with
+    // different pre-grouped keys than the previous input ended with. Flush
+    // them before adding any of 'input'. Distinct aggregations produce their
+    // output from the new groups of each input and are left as is.
+    if (!remainingInput_ && !aggregates_.empty() && table_ &&
+        table_->numDistinct() > 0 && !equalsLastPreGroupedKeys(*input, 0)) {
+      numRows = 0;
+      remainingInput_ = input;
+      firstRemainingRow_ = 0;
+      remainingMayPushdown_ = mayPushdown;
+    }
+    if (input->size() > 0) {
+      saveLastPreGroupedKeys(*input, input->size() - 1);
+    }
   }
 
+  if (numRows == 0) {
+    return;
+  }
   activeRows_.resize(numRows);
   activeRows_.setAll();
 
   addInputForActiveRows(input, mayPushdown);
 }
 
+bool GroupingSet::equalsLastPreGroupedKeys(
+    const RowVector& input,
+    vector_size_t row) const {
+  for (auto i = 0; i < preGroupedKeyChannels_.size(); ++i) {
+    auto key = input.childAt(preGroupedKeyChannels_[i])->loadedVector();
+    if (!key->equalValueAt(lastPreGroupedKeys_[i].get(), row, 0)) {
+      return false;
+    }
+  }
+  return true;
+}
+
+void GroupingSet::saveLastPreGroupedKeys(
+    const RowVector& input,
+    vector_size_t row) {
+  lastPreGroupedKeys_.resize(preGroupedKeyChannels_.size());
+  for (auto i = 0; i < preGroupedKeyChannels_.size(); ++i) {
+    auto key = input.childAt(preGroupedKeyChannels_[i])->loadedVector();
+    auto& lastKey = lastPreGroupedKeys_[i];
+    if (!lastKey) {
+      lastKey = BaseVector::create(key->type(), 1, &pool_);
+    }
+    lastKey->copy(key, 0, row, 1);
+  }
+}
+
 void GroupingSet::noMoreInput() {
   noMoreInput_ = true;
 
@@ -177,7 +255,8 @@ void GroupingSet::addInputForActiveRows(
     for (int32_t i = 0; i < hashers.size(); ++i) {
       auto key = input->childAt(hashers[i]->channel())->loadedVector();
       if (mode != BaseHashTable::HashMode::kHash) {
-        if (!hashers[i]->computeValueIds(*key, activeRows_, lookup_->hashes)) {
+        if (!hashers[i]->computeValueIds(
+                *key, activeRows_, table_->valueIds(*lookup_, i))) {
           rehash = true;
         }
       } else {
@@ -188,7 +267,8 @@ void GroupingSet::addInputForActiveRows(
     for (int32_t i = 0; i < hashers.size(); ++i) {
       auto key = input->childAt(hashers[i]->channel())->loadedVector();
       if (mode != BaseHashTable::HashMode::kHash) {
-        if (!hashers[i]->computeValueIds(*key, activeRows_, lookup_->hashes)) {
+        if (!hashers[i]->computeValueIds(
+                *key, activeRows_, table_->valueIds(*lookup_, i))) {
           rehash = true;
         }
       } else {
@@ -216,15 +296,18 @@ void GroupingSet::addInputForActiveRows(
   }
   table_->groupProbe(*lookup_);
   masks_.addInput(input, activeRows_);
-  for (auto i = 0; i < aggregates_.size(); ++i) {
-    const auto& rows = getSelectivityVector(i);
-
+  for (auto i : evaluationOrder_) {
     // Check is mask is false for all rows.
-    if (!rows.hasSelections()) {
+    if (!getSelectivityVector(i).hasSelections()) {
       continue;
     }
 
     populateTempVectors(i, input);
+    const auto& rows =
+        distinctRows(i, lookup_->hits.data(), getSelectivityVector(i));
+    if (!rows.hasSelections()) {
+      continue;
+    }
     // TODO(spershin): We disable the pushdown at the moment if selectivity
     // vector has changed after groups generation, we might want to revisit
     // this.
@@ -238,7 +321,7 @@ void GroupingSet::addInputForActiveRows(
           lookup_->hits.data(), rows, tempVectors_, canPushdown);
     }
   }
-  tempVectors_.clear();
+  clearTempVectors();
 }
 
 void GroupingSet::addRemainingInput() {
@@ -314,17 +397,19 @@ void GroupingSet::addGlobalAggregationInput(
   activeRows_.setAll();
 
   masks_.addInput(input, activeRows_);
-  for (auto i = 0; i < aggregates_.size(); ++i) {
-    const auto& rows = getSelectivityVector(i);
-
+  for (auto i : evaluationOrder_) {
     // Check is mask is false for all rows.
-    if (!rows.hasSelections()) {
+    if (!getSelectivityVector(i).hasSelections()) {
       continue;
     }
 
     populateTempVectors(i, input);
-    const bool canPushdown =
-        mayPushdown && mayPushdown_[i] && areAllLazyNotLoaded(tempVectors_);
+    const auto& rows = distinctRows(i, nullptr, getSelectivityVector(i));
+    if (!rows.hasSelections()) {
+      continue;
+    }
+    const bool canPushdown = mayPushdown && mayPushdown_[i] &&
+        !distincts_.isDistinct(i) && areAllLazyNotLoaded(tempVectors_);
     if (isRawInput_) {
       aggregates_[i]->addSingleGroupRawInput(
           lookup_->hits[0], rows, tempVectors_, canPushdown);
@@ -333,7 +418,7 @@ void GroupingSet::addGlobalAggregationInput(
           lookup_->hits[0], rows, tempVectors_, canPushdown);
     }
   }
-  tempVectors_.clear();
+  clearTempVectors();
 }
 
 bool GroupingSet::getGlobalAggregationOutput(
@@ -365,6 +450,14 @@ void GroupingSet::populateTempVectors(
     int32_t aggregateIndex,
     const RowVectorPtr& input) {
   auto& channels = channelLists_[aggregateIndex];
+  // Aggregates over the same columns are adjacent in 'evaluationOrder_' and
+  // share the argument vectors.
+  if (tempVectorsIndex_.has_value() &&
+      AggregationMasks::sameInputs(
+          channelLists_[tempVectorsIndex_.value()], channels)) {
+    return;
+  }
+  tempVectorsIndex_ = aggregateIndex;
   tempVectors_.resize(channels.size());
   for (auto i = 0; i < channels.size(); ++i) {
     if (channels[i] == kConstantChannel) {
@@ -377,6 +470,11 @@ void GroupingSet::populateTempVectors(
   }
 }
 
+void GroupingSet::clearTempVectors() {
+  tempVectors_.clear();
+  tempVectorsIndex_.reset();
+}
+
 const SelectivityVector& GroupingSet::getSelectivityVector(
     size_t aggregateIndex) const {
   auto* rows = masks_.activeRows(aggregateIndex);
@@ -389,6 +487,16 @@ const SelectivityVector& GroupingSet::getSelectivityVector(
   return *rows;
 }
 
+const SelectivityVector& GroupingSet::distinctRows(
+    size_t aggregateIndex,
+    char* FOLLY_NULLABLE* FOLLY_NULLABLE groups,
+    const SelectivityVector& rows) {
+  if (!distincts_.isDistinct(aggregateIndex)) {
+    return rows;
+  }
+  return distincts_.newRows(aggregateIndex, groups, rows, tempVectors_);
+}
+
 bool GroupingSet::getOutput(
     int32_t batchSize,
     RowContainerIterator& iterator,
@@ -407,6 +515,7 @@ bool GroupingSet::getOutput(
   if (!numGroups) {
     if (table_) {
       table_->clear();
+      distincts_.clear();
     }
     if (remainingInput_) {
       addRemainingInput();
@@ -443,15 +552,78 @@ void GroupingSet::extractGroups(
 void GroupingSet::resetPartial() {
   if (table_) {
     table_->clear();
+    distincts_.clear();
   }
 }
 
+bool GroupingSet::mayAbandonPartialAggregation() const {
+  return isPartial_ && isRawInput_ && !isGlobal_ && !aggregates_.empty() &&
+      preGroupedKeyChannels_.empty() && !ignoreNullKeys_;
+}
+
+void GroupingSet::toIntermediate(
+    const RowVectorPtr& input,
+    RowVectorPtr& result) {
+  VELOX_CHECK(mayAbandonPartialAggregation());
+  if (!table_) {
+    createHashTable();
+  }
+  auto* rows = table_->rows();
+  VELOX_CHECK_EQ(rows->numRows(), 0);
+
+  const auto numRows = input->size();
+  activeRows_.resize(numRows);
+  activeRows_.setAll();
+  masks_.addInput(input, activeRows_);
+
+  result->resize(numRows);
+  for (auto i = 0; i < keyChannels_.size(); ++i) {
+    result->childAt(i) = input->childAt(keyChannels_[i]);
+  }
+
+  // The accumulators are laid out in rows of the table's RowContainer. The
+  // keys of these rows are left unset and the rows are not added to the
+  // hash table.
+  intermediateGroups_.resize(numRows);
+  intermediateRowNumbers_.resize(numRows);
+  for (auto i = 0; i < numRows; ++i) {
+    intermediateGroups_[i] = rows->newRow();
+  }
+  std::iota(intermediateRowNumbers_.begin(), intermediateRowNumbers_.end(), 0);
+  for (auto i : evaluationOrder_) {
+    auto& aggregate = aggregates_[i];
+    aggregate->initializeNewGroups(
+        intermediateGroups_.data(), intermediateRowNumbers_);
+    const auto& aggregateRows = getSelectivityVector(i);
+    if (aggregateRows.hasSelections()) {
+      populateTempVectors(i, input);
+      aggregate->addRawInput(
+          intermediateGroups_.data(), aggregateRows, tempVectors_, false);
+    }
+    aggregate->finalize(intermediateGroups_.data(), numRows);
+    aggregate->extractAccumulators(
+        intermediateGroups_.data(),
+        numRows,
+        &result->childAt(keyChannels_.size() + i));
+  }
+  clearTempVectors();
+  rows->clear();
+}
+
 uint64_t GroupingSet::allocatedBytes() const {
   if (table_) {
-    return table_->allocatedBytes();
+    return table_->allocatedBytes() + distincts_.allocatedBytes();
   }
 
-  return stringAllocator_.retainedSize() + rows_.allocatedBytes();
+  return stringAllocator_.retainedSize() + rows_.allocatedBytes() +
+      distincts_.allocatedBytes();
+}
+
+std::optional<int64_t> GroupingSet::estimateOutputRowSize() const {
+  if (!table_) {
+    return std::nullopt;
+  }
+  return table_->rows()->estimateRowSize();
 }
 
 const HashLookup& GroupingSet::hashLookup() const {
@@ -526,7 +698,19 @@ void GroupingSet::ensureInputFits(const RowVectorPtr& input) {
       outOfLineBytes - (rowsToSpill * outOfLineBytesPerRow));
 }
 
+uint64_t GroupingSet::reclaimableBytes() const {
+  if (isPartial_ || !spillPath_.has_value() || noMoreInput_ || !table_ ||
+      table_->numDistinct() == 0) {
+    return 0;
+  }
+  return allocatedBytes();
+}
+
 void GroupingSet::spill(int64_t targetRows, int64_t targetBytes) {
+  DriverTrace::Scope traceScope(
+      operatorCtx_.driverTrace(),
+      DriverTrace::EventType::kSpill,
+      operatorCtx_.operatorId());
   if (!spiller_) {
     auto rows = table_->rows();
     auto types = rows->keyTypes();
@@ -542,36 +726,41 @@ void GroupingSet::spill(int64_t targetRows, int64_t targetBytes) {
         *rows,
         [&](folly::Range<char**> rows) { table_->erase(rows); },
         ROW(std::move(names), std::move(types)),
-        // Spill up to 4 partitions based on bits 29 and 30 of the hash number.
-        // Any two bits would do.
-        HashBitRange(29, 31),
+        // Spill up to 4 partitions based on bits 29 and 30 of the hash number,
+        // or 8 if more than 4 partitions are merged at a time. Any bits would
+        // do.
+        HashBitRange(29, spillMergeThreads_ > 4 ? 32 : 31),
         rows->keyTypes().size(),
         spillPath_.value(),
         fileSize,
         Spiller::spillPool(),
-        spillExecutor_);
+        spillExecutor_,
+        std::vector<CompareFlags>{},
+        spillCompression_,
+        spillLocalQuotaBytes_);
   }
   spiller_->spill(targetRows, targetBytes, spillIterator_);
+  maybeCompact();
+}
+
+void GroupingSet::maybeCompact() {
+  // Below this many free rows compacting is not worth a rehash.
+  constexpr int64_t kMinFreeRowsToCompact = 10'000;
+  auto rows = table_->rows();
+  const int64_t numFreeRows = rows->numFreeRows();
+  if (numFreeRows < kMinFreeRowsToCompact || numFreeRows < rows->numRows() ||
+      !rows->canCompact()) {
+    return;
+  }
+  if (!spiller_->releaseRows()) {
+    return;
+  }
+  table_->compact();
+  spillIterator_.reset();
 }
 
-bool GroupingSet::getOutputWithSpill(const RowVectorPtr& result) {
+bool GroupingSet::getOutputWithSpill(RowVectorPtr& result) {
   if (outputPartition_ == -1) {
-    mergeArgs_.resize(1);
-    std::vector<TypePtr> keyTypes;
-    for (auto& hasher : table_->hashers()) {
-      keyTypes.push_back(hasher->type());
-    }
-    mergeRows_ = std::make_unique<RowContainer>(
-        keyTypes,
-        !ignoreNullKeys_,
-        aggregates_,
-        std::vector<TypePtr>(),
-        false,
-        false,
-        false,
-        false,
-        mappedMemory_,
-        ContainerRowSerde::instance());
     // Take ownership of the rows and free the hash table. The table will not be
     // needed for producing spill output.
     rowsWhileReadingSpill_ = table_->moveRows();
@@ -587,7 +776,7 @@ bool GroupingSet::getOutputWithSpill(const RowVectorPtr& result) {
     auto limit = std::min<size_t>(
         1000, nonSpilledRows_.value().size() - nonSpilledIndex_);
     for (; numGroups < limit; ++numGroups) {
-      bytes += table_->rows()->rowSize(
+      bytes += rowsWhileReadingSpill_->rowSize(
           nonSpilledRows_.value()[nonSpilledIndex_ + numGroups]);
       if (bytes > maxBatchBytes_) {
         ++numGroups;
@@ -601,13 +790,22 @@ bool GroupingSet::getOutputWithSpill(const RowVectorPtr& result) {
     nonSpilledIndex_ += numGroups;
     return true;
   }
+  if (spillMergeThreads_ > 1 && makeAggregates_ && spillExecutor_) {
+    return getParallelMergeOutput(result);
+  }
   while (outputPartition_ < spiller_->state().maxPartitions()) {
-    if (!merge_) {
-      merge_ = spiller_->startMerge(outputPartition_);
+    if (!merger_) {
+      merger_ = std::make_unique<SpillMerger>(
+          spiller_->startMerge(outputPartition_),
+          rowsWhileReadingSpill_->keyTypes(),
+          !ignoreNullKeys_,
+          aggregates_,
+          isPartial_,
+          mappedMemory_);
     }
-    if (!mergeNext(result)) {
+    if (!merger_->next(result)) {
       ++outputPartition_;
-      merge_ = nullptr;
+      merger_ = nullptr;
       continue;
     }
     return true;
@@ -615,31 +813,123 @@ bool GroupingSet::getOutputWithSpill(const RowVectorPtr& result) {
   return false;
 }
 
-bool GroupingSet::mergeNext(const RowVectorPtr& result) {
+bool GroupingSet::getParallelMergeOutput(RowVectorPtr& result) {
+  if (mergers_.empty()) {
+    outputType_ = asRowType(result->type());
+    mergers_.resize(spillMergeThreads_);
+    mergeBatches_.resize(spillMergeThreads_);
+    for (auto i = 0; i < spillMergeThreads_; ++i) {
+      mergeAggregates_.push_back(makeAggregates_());
+    }
+  }
+  const int32_t numSlots = mergers_.size();
+  for (auto i = 0; i < numSlots; ++i) {
+    const auto slot = (nextMergeSlot_ + i) % numSlots;
+    if (!mergers_[slot]) {
+      if (outputPartition_ >= spiller_->state().maxPartitions()) {
+        continue;
+      }
+      // The merge is started on the Driver thread since it reads the state
+      // of 'spiller_'. The reading and merging of the runs is done on
+      // 'spillExecutor_'.
+      mergers_[slot] = std::make_unique<SpillMerger>(
+          spiller_->startMerge(outputPartition_++),
+          rowsWhileReadingSpill_->keyTypes(),
+          !ignoreNullKeys_,
+          mergeAggregates_[slot],
+          isPartial_,
+          mappedMemory_);
+      scheduleMerge(slot);
+    }
+    auto batch = mergeBatches_[slot]->move();
+    mergeBatches_[slot] = nullptr;
+    VELOX_CHECK_NOT_NULL(batch);
+    if (batch->error) {
+      std::rethrow_exception(batch->error);
+    }
+    if (!batch->rows) {
+      // The partition is merged. The slot takes the next partition.
+      mergers_[slot] = nullptr;
+      --i;
+      continue;
+    }
+    scheduleMerge(slot);
+    nextMergeSlot_ = slot + 1;
+    result = std::move(batch->rows);
+    return true;
+  }
+  return false;
+}
+
+void GroupingSet::scheduleMerge(int32_t slot) {
+  auto* merger = mergers_[slot].get();
+  auto type = outputType_;
+  auto* pool = &pool_;
+  mergeBatches_[slot] = std::make_shared<AsyncSource<MergeBatch>>(
+      [merger, type, pool]() {
+        auto batch = std::make_unique<MergeBatch>();
+        try {
+          auto rows = BaseVector::create<RowVector>(type, 0, pool);
+          if (merger->next(rows)) {
+            batch->rows = std::move(rows);
+          }
+        } catch (const std::exception& e) {
+          batch->error = std::current_exception();
+        }
+        return batch;
+      });
+  spillExecutor_->add(
+      [source = mergeBatches_[slot]]() { source->prepare(); });
+}
+
+SpillMerger::SpillMerger(
+    std::unique_ptr<TreeOfLosers<SpillStream>> merge,
+    const std::vector<TypePtr>& keyTypes,
+    bool nullableKeys,
+    const std::vector<std::unique_ptr<Aggregate>>& aggregates,
+    bool isPartial,
+    memory::MappedMemory* FOLLY_NONNULL mappedMemory)
+    : merge_(std::move(merge)),
+      aggregates_(aggregates),
+      isPartial_(isPartial),
+      rows_(
+          keyTypes,
+          nullableKeys,
+          aggregates,
+          std::vector<TypePtr>(),
+          false,
+          false,
+          false,
+          false,
+          mappedMemory,
+          ContainerRowSerde::instance()),
+      mergeArgs_(1) {}
+
+bool SpillMerger::next(const RowVectorPtr& result) {
   constexpr int32_t kBatchBytes = 1 << 20; // 1MB
   for (;;) {
     auto next = merge_->nextWithEquals();
     if (!next.first) {
-      extractSpillResult(result);
+      extractResult(result);
       return result->size() > 0;
     }
     if (!nextKeyIsEqual_) {
-      mergeState_ = mergeRows_->newRow();
+      mergeState_ = rows_.newRow();
       initializeRow(*next.first, mergeState_);
     }
     updateRow(*next.first, mergeState_);
     nextKeyIsEqual_ = next.second;
     next.first->pop();
-    if (!nextKeyIsEqual_ && mergeRows_->allocatedBytes() > kBatchBytes) {
-      extractSpillResult(result);
+    if (!nextKeyIsEqual_ && rows_.allocatedBytes() > kBatchBytes) {
+      extractResult(result);
       return true;
     }
   }
 }
 
-void GroupingSet::initializeRow(SpillStream& keys, char* FOLLY_NONNULL row) {
-  for (auto i = 0; i < keyChannels_.size(); ++i) {
-    mergeRows_->store(keys.decoded(i), keys.currentIndex(), mergeState_, i);
+void SpillMerger::initializeRow(SpillStream& keys, char* FOLLY_NONNULL row) {
+  for (auto i = 0; i < rows_.keyTypes().size(); ++i) {
+    rows_.store(keys.decoded(i), keys.currentIndex(), mergeState_, i);
   }
   vector_size_t zero = 0;
   for (auto& aggregate : aggregates_) {
@@ -648,24 +938,38 @@ void GroupingSet::initializeRow(SpillStream& keys, char* FOLLY_NONNULL row) {
   }
 }
 
-void GroupingSet::extractSpillResult(const RowVectorPtr& result) {
-  std::vector<char*> rows(mergeRows_->numRows());
+void SpillMerger::extractResult(const RowVectorPtr& result) {
+  std::vector<char*> rows(rows_.numRows());
   RowContainerIterator iter;
-  mergeRows_->listRows(
-      &iter, rows.size(), RowContainer::kUnlimited, rows.data());
-  extractGroups(folly::Range<char**>(rows.data(), rows.size()), result);
-  mergeRows_->clear();
+  rows_.listRows(&iter, rows.size(), RowContainer::kUnlimited, rows.data());
+  result->resize(rows.size());
+  const auto numKeys = rows_.keyTypes().size();
+  for (auto i = 0; i < numKeys; ++i) {
+    rows_.extractColumn(rows.data(), rows.size(), i, result->childAt(i));
+  }
+  for (auto i = 0; i < aggregates_.size(); ++i) {
+    aggregates_[i]->finalize(rows.data(), rows.size());
+    auto& aggregateVector = result->childAt(i + numKeys);
+    if (isPartial_) {
+      aggregates_[i]->extractAccumulators(
+          rows.data(), rows.size(), &aggregateVector);
+    } else {
+      aggregates_[i]->extractValues(rows.data(), rows.size(), &aggregateVector);
+    }
+  }
+  rows_.clear();
 }
 
-void GroupingSet::updateRow(SpillStream& input, char* FOLLY_NONNULL row) {
+void SpillMerger::updateRow(SpillStream& input, char* FOLLY_NONNULL row) {
   if (input.currentIndex() >= mergeSelection_.size()) {
     mergeSelection_.resize(bits::roundUp(input.currentIndex() + 1, 64));
     mergeSelection_.clearAll();
   }
   mergeSelection_.setValid(input.currentIndex(), true);
   mergeSelection_.updateBounds();
+  const auto numKeys = rows_.keyTypes().size();
   for (auto i = 0; i < aggregates_.size(); ++i) {
-    mergeArgs_[0] = input.current().childAt(i + keyChannels_.size());
+    mergeArgs_[0] = input.current().childAt(i + numKeys);
     aggregates_[i]->addSingleGroupIntermediateResults(
         row, mergeSelection_, mergeArgs_, false);
   }
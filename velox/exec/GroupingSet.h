@@ -15,6 +15,8 @@
  */
 #pragma once
 
+#include "velox/common/base/AsyncSource.h"
+#include "velox/exec/AggregationDistincts.h"
 #include "velox/exec/AggregationMasks.h"
 #include "velox/exec/HashTable.h"
 #include "velox/exec/Spiller.h"
@@ -25,6 +27,66 @@ namespace facebook::velox::exec {
 
 class Aggregate;
 
+// Merges the spill runs of one spilled partition of a GroupingSet into
+// batches of groups. The runs are sorted on the grouping keys, so a group is
+// complete when the next key differs.
+class SpillMerger {
+ public:
+  // 'aggregates' accumulate the groups in a RowContainer of 'this' and must
+  // not be used elsewhere while 'this' is merging, so that mergers with
+  // different Aggregates can run on different threads.
+  SpillMerger(
+      std::unique_ptr<TreeOfLosers<SpillStream>> merge,
+      const std::vector<TypePtr>& keyTypes,
+      bool nullableKeys,
+      const std::vector<std::unique_ptr<Aggregate>>& aggregates,
+      bool isPartial,
+      memory::MappedMemory* FOLLY_NONNULL mappedMemory);
+
+  // Reads rows until producing a batch of results in 'result'. Returns false
+  // and leaves 'result' empty when the partition is fully read.
+  bool next(const RowVectorPtr& result);
+
+ private:
+  // Initializes a new row in 'rows_' with the keys from the current element
+  // of 'keys'. Accumulators are left in the initial state with no data
+  // accumulated. This is called each time a new key is received from the
+  // merge. After this updateRow() is called on the same element and on every
+  // subsequent element read from the stream until a new key is seen, at
+  // which time we again call initializeRow(). When enough rows have been
+  // accumulated and we have a new key, we produce the output and clear
+  // 'rows_' with extractResult() and only then do initializeRow().
+  void initializeRow(SpillStream& keys, char* FOLLY_NONNULL row);
+
+  // Updates the accumulators in 'row' with the intermediate type data from
+  // 'keys'. This is called for each row received from the merge.
+  void updateRow(SpillStream& keys, char* FOLLY_NONNULL row);
+
+  // Copies the finalized state from 'rows_' to 'result' and clears 'rows_'.
+  void extractResult(const RowVectorPtr& result);
+
+  const std::unique_ptr<TreeOfLosers<SpillStream>> merge_;
+  const std::vector<std::unique_ptr<Aggregate>>& aggregates_;
+  const bool isPartial_;
+
+  // Container for materializing batches of output.
+  RowContainer rows_;
+
+  // The row with the current merge state, allocated from 'rows_'.
+  char* FOLLY_NULLABLE mergeState_ = nullptr;
+
+  // Intermediate vector for passing arguments to aggregate in merging spill.
+  std::vector<VectorPtr> mergeArgs_;
+
+  // Indicates the element in mergeArgs_[0] that corresponds to the
+  // accumulator to merge.
+  SelectivityVector mergeSelection_;
+
+  // True if 'merge_' indicates that the next key is the same as the current
+  // one.
+  bool nextKeyIsEqual_{false};
+};
+
 class GroupingSet {
  public:
   GroupingSet(
@@ -32,13 +94,18 @@ class GroupingSet {
       std::vector<column_index_t>&& preGroupedKeys,
       std::vector<std::unique_ptr<Aggregate>>&& aggregates,
       std::vector<std::optional<column_index_t>>&& aggrMaskChannels,
+      std::vector<bool>&& aggregateDistincts,
       std::vector<std::vector<column_index_t>>&& channelLists,
       std::vector<std::vector<VectorPtr>>&& constantLists,
       std::vector<TypePtr>&& intermediateTypes,
       bool ignoreNullKeys,
       bool isPartial,
       bool isRawInput,
-      OperatorCtx* FOLLY_NONNULL operatorCtx);
+      OperatorCtx* FOLLY_NONNULL operatorCtx,
+      std::function<std::vector<std::unique_ptr<Aggregate>>()>
+          makeAggregates = nullptr);
+
+  ~GroupingSet();
 
   void addInput(const RowVectorPtr& input, bool mayPushdown);
 
@@ -61,8 +128,25 @@ class GroupingSet {
 
   uint64_t allocatedBytes() const;
 
+  // Returns the average size of a group in the hash table or std::nullopt
+  // if not known. Used for sizing output batches.
+  std::optional<int64_t> estimateOutputRowSize() const;
+
   void resetPartial();
 
+  /// Returns true if a partial aggregation with poor reduction can switch to
+  /// converting its input directly to intermediate results with
+  /// toIntermediate(). False for global and distinct aggregations, pre-grouped
+  /// keys and if rows with null keys are ignored.
+  bool mayAbandonPartialAggregation() const;
+
+  /// Converts each row of 'input' into a group of its own with the
+  /// intermediate results for the row, without probing the hash
+  /// table. 'result' gets the grouping keys followed by the accumulators, as
+  /// in getOutput() of a partial aggregation. May only be called when no groups
+  /// are in the hash table, e.g. after resetPartial().
+  void toIntermediate(const RowVectorPtr& input, RowVectorPtr& result);
+
   const HashLookup& hashLookup() const;
 
   /// Spills content until under 'targetRows' and under 'targetBytes'
@@ -74,22 +158,53 @@ class GroupingSet {
   /// of this will be in a paused state and off thread.
   void spill(int64_t targetRows, int64_t targetBytes);
 
+  /// Returns the memory that spill(0, 0) could free or 0 if 'this' cannot
+  /// spill now, i.e. spilling is disabled, 'this' is a partial aggregation or
+  /// all input has been received.
+  uint64_t reclaimableBytes() const;
+
   /// Returns the total bytes and rows spilled so far.
   std::pair<int64_t, int64_t> spilledBytesAndRows() const {
     return spiller_ ? spiller_->spilledBytesAndRows()
                     : std::pair<int64_t, int64_t>(0, 0);
   }
 
+  /// Returns the size of the data spilled so far before compression.
+  int64_t spilledUncompressedBytes() const {
+    return spiller_ ? spiller_->spilledUncompressedBytes() : 0;
+  }
+
+  /// Returns the bytes written to and the write time of each spill directory.
+  std::vector<SpillPathStats> spillPathStats() const {
+    return spiller_ ? spiller_->spillPathStats()
+                    : std::vector<SpillPathStats>{};
+  }
+
   /// Return the number of rows kept in memory.
   int64_t numRows() const {
     return table_ ? table_->rows()->numRows() : 0;
   }
 
  private:
+  // A batch of results of parallel merging or the error from making it.
+  struct MergeBatch {
+    RowVectorPtr rows;
+    std::exception_ptr error;
+  };
+
   void addInputForActiveRows(const RowVectorPtr& input, bool mayPushdown);
 
   void addRemainingInput();
 
+  // True if the pre-grouped keys of 'row' of 'input' are equal to
+  // 'lastPreGroupedKeys_'.
+  bool equalsLastPreGroupedKeys(const RowVector& input, vector_size_t row)
+      const;
+
+  // Copies the pre-grouped keys of 'row' of 'input' to
+  // 'lastPreGroupedKeys_'.
+  void saveLastPreGroupedKeys(const RowVector& input, vector_size_t row);
+
   void initializeGlobalAggregation();
 
   void addGlobalAggregationInput(const RowVectorPtr& input, bool mayPushdown);
@@ -102,8 +217,20 @@ class GroupingSet {
 
   void createHashTable();
 
+  // Sets 'tempVectors_' to the arguments of 'aggregateIndex'. Keeps them if
+  // they were set for an aggregate over the same columns.
   void populateTempVectors(int32_t aggregateIndex, const RowVectorPtr& input);
 
+  void clearTempVectors();
+
+  // Narrows 'rows' of a distinct aggregate to the rows with argument values
+  // in 'tempVectors_' not yet seen in their group in 'groups'. Returns 'rows'
+  // as is for other aggregates.
+  const SelectivityVector& distinctRows(
+      size_t aggregateIndex,
+      char* FOLLY_NULLABLE* FOLLY_NULLABLE groups,
+      const SelectivityVector& rows);
+
   // If the given aggregation has mask, the method returns reference to the
   // selectivity vector from the maskedActiveRows_ (based on the mask channel
   // index for this aggregation), otherwise it returns reference to activeRows_.
@@ -114,6 +241,11 @@ class GroupingSet {
   // enough to make 'input' fit.
   void ensureInputFits(const RowVectorPtr& input);
 
+  // Compacts 'table_' after spilling if at least half of its rows are
+  // erased and no spilled rows are waiting to be written. This returns the
+  // memory of the erased rows and their out of line data.
+  void maybeCompact();
+
   // Copies the grouping keys and aggregates for 'groups' into 'result' If
   // partial output, extracts the intermediate type for aggregates, final result
   // otherwise.
@@ -123,33 +255,15 @@ class GroupingSet {
   /// from non-spilled partitions, then merges spill runs and
   /// unspilled data form spilled partitions. Returns nullptr when at
   /// end.
-  bool getOutputWithSpill(const RowVectorPtr& result);
-
-  /// Reads rows from the current spilled partition until producing a batch of
-  /// final results in 'result'. Returns false and leaves 'result' empty when
-  /// the partition is fully read.
-  bool mergeNext(const RowVectorPtr& result);
-
-  // Initializes a new row in 'mergeRows' with the keys from the
-  // current element from 'keys'. Accumulators are left in the initial
-  // state with no data accumulated. This is called each time a new
-  // key is received from a merge of spilled data. After this
-  // updateRow() is called on the same element and on every subsequent
-  // element read from the stream until a new key is seen, at which
-  // time we again call initializeRow(). When enough rows have been
-  // accumulated and we have a new key, we produce the output and
-  // clear 'mergeRows_' with extractSpillResult() and only then do
-  // initializeRow().
-  void initializeRow(SpillStream& keys, char* FOLLY_NONNULL row);
+  bool getOutputWithSpill(RowVectorPtr& result);
 
-  // Updates the accumulators in 'row' with the intermediate type data from
-  // 'keys'. This is called for each row received from a merge of spilled data.
-  void updateRow(SpillStream& keys, char* FOLLY_NONNULL row);
+  // Keeps up to 'spillMergeThreads_' spilled partitions merging on
+  // 'spillExecutor_' and returns the next batch of any of them in
+  // 'result'. Returns false when all partitions are merged.
+  bool getParallelMergeOutput(RowVectorPtr& result);
 
-  // Copies the finalized state from 'mergeRows' to 'result' and clears
-  // 'mergeRows'. Used for producing a batch of results when aggregating spilled
-  // groups.
-  void extractSpillResult(const RowVectorPtr& result);
+  // Starts making the next batch of 'mergers_[slot]' on 'spillExecutor_'.
+  void scheduleMerge(int32_t slot);
 
   std::vector<column_index_t> keyChannels_;
 
@@ -162,6 +276,8 @@ class GroupingSet {
   const bool isRawInput_;
   std::vector<std::unique_ptr<Aggregate>> aggregates_;
   AggregationMasks masks_;
+  // The values seen by the aggregates with the DISTINCT flag.
+  AggregationDistincts distincts_;
   // Argument list for the corresponding element of 'aggregates_'.
   const std::vector<std::vector<column_index_t>> channelLists_;
   // Constant arguments to aggregates. Corresponds pairwise to
@@ -169,6 +285,12 @@ class GroupingSet {
   // kConstantChannel.
   const std::vector<std::vector<VectorPtr>> constantLists_;
 
+  // Indices of 'aggregates_' grouped by mask and, within a mask, by argument
+  // list. Aggregates are updated in this order so that the aggregates with
+  // the same mask and arguments run back to back over the same rows and
+  // argument vectors.
+  const std::vector<int32_t> evaluationOrder_;
+
   // Types for extracting accumulators for spilling.
   const std::vector<TypePtr> intermediateTypes_;
 
@@ -183,6 +305,13 @@ class GroupingSet {
 
   // Place for the arguments of the aggregate being updated.
   std::vector<VectorPtr> tempVectors_;
+
+  // The aggregate whose arguments are in 'tempVectors_', if any.
+  std::optional<int32_t> tempVectorsIndex_;
+
+  // Rows with the accumulators for toIntermediate() and their indices.
+  std::vector<char*> intermediateGroups_;
+  std::vector<vector_size_t> intermediateRowNumbers_;
   std::unique_ptr<BaseHashTable> table_;
   std::unique_ptr<HashLookup> lookup_;
   SelectivityVector activeRows_;
@@ -195,6 +324,9 @@ class GroupingSet {
 
   core::ExecCtx& execCtx_;
 
+  // Used for recording spill events on the Driver's trace.
+  const OperatorCtx& operatorCtx_;
+
   bool noMoreInput_{false};
 
   /// In case of partial streaming aggregation, the input vector passed to
@@ -209,34 +341,47 @@ class GroupingSet {
   /// 'remainingInput_'.
   bool remainingMayPushdown_;
 
+  // The pre-grouped keys of the last row of the last input, one single row
+  // vector per key. A change from these at the start of the next input
+  // completes the groups in the table.
+  std::vector<VectorPtr> lastPreGroupedKeys_;
+
   uint64_t maxBatchBytes_;
 
   // Filesystem path for spill files, empty if spilling is disabled.
   const std::optional<std::string> spillPath_;
 
   std::unique_ptr<Spiller> spiller_;
-  std::unique_ptr<TreeOfLosers<SpillStream>> merge_;
   RowContainerIterator spillIterator_;
 
-  // Container for materializing batches of output from spilling.
-  std::unique_ptr<RowContainer> mergeRows_;
-
-  // The row with the current merge state, allocated from 'mergeRow_'.
-  char* FOLLY_NULLABLE mergeState_ = nullptr;
+  // Merges the current spilled partition if the partitions are merged one
+  // after the other.
+  std::unique_ptr<SpillMerger> merger_;
 
-  // The currently running spill partition in producing spilld output.
+  // The next spill partition to produce output from or to start merging.
   int32_t outputPartition_{-1};
 
-  // Intermediate vector for passing arguments to aggregate in merging spill.
-  std::vector<VectorPtr> mergeArgs_;
+  // Number of spilled partitions merged at the same time. See
+  // QueryConfig::kAggregationSpillMergeThreads.
+  const int32_t spillMergeThreads_;
 
-  // Indicates the element in mergeArgs_[0] that corresponds to the accumulator
-  // to merge.
-  SelectivityVector mergeSelection_;
+  // Makes a copy of 'aggregates_' for each of the partitions merged at the
+  // same time. Parallel merging is off if nullptr.
+  const std::function<std::vector<std::unique_ptr<Aggregate>>()>
+      makeAggregates_;
 
-  // True if 'merge_' indicates that the next key is the same as the current
-  // one.
-  bool nextKeyIsEqual_{false};
+  // The Aggregates, partitions being merged and next batch of each for
+  // parallel merging, one per slot. A slot whose partition is finished has
+  // a nullptr merger until it gets the next partition.
+  std::vector<std::vector<std::unique_ptr<Aggregate>>> mergeAggregates_;
+  std::vector<std::unique_ptr<SpillMerger>> mergers_;
+  std::vector<std::shared_ptr<AsyncSource<MergeBatch>>> mergeBatches_;
+
+  // The slot to take the next batch from.
+  int32_t nextMergeSlot_{0};
+
+  // Type of the results of parallel merging.
+  RowTypePtr outputType_;
 
   // The set of rows that are outside of the spillable hash number
   // ranges. Used when producing output.
@@ -254,6 +399,14 @@ class GroupingSet {
   // 'table_' when starting to read spill output.
   std::unique_ptr<RowContainer> rowsWhileReadingSpill_;
 
+  // Codec for compressing the spill files. NO_COMPRESSION if spilling is
+  // disabled.
+  const folly::io::CodecType spillCompression_;
+
+  // Local spill bytes of the process above which spill files go to the
+  // overflow tier of 'spillPath_'. 0 means no quota.
+  const uint64_t spillLocalQuotaBytes_;
+
   // Percentage of input batches to be spilled for testing. 0 means no spilling
   // for test.
   const int32_t testSpillPct_;
@@ -14,11 +14,32 @@
  * limitations under the License.
  */
 #include "velox/exec/HashAggregation.h"
+#include <algorithm>
 #include <optional>
 #include "velox/exec/Aggregate.h"
+#include "velox/exec/OperatorUtils.h"
 #include "velox/exec/Task.h"
 
 namespace facebook::velox::exec {
+namespace {
+// True if the Drivers of 'node' may merge their input into shared groups.
+// The shared GroupingSets do not spill and do not use the ExecCtx of the
+// Driver that made them, which is needed only for removing null keys.
+bool canShareGroups(
+    const core::AggregationNode& node,
+    const core::QueryConfig& config) {
+  if (!config.sharedFinalAggregation() || isPartialOutput(node.step()) ||
+      node.groupingKeys().empty() || node.aggregates().empty() ||
+      !node.preGroupedKeys().empty() || node.ignoreNullKeys() ||
+      config.spillPath().has_value()) {
+    return false;
+  }
+  const auto& distincts = node.aggregateDistincts();
+  return std::none_of(distincts.begin(), distincts.end(), [](bool distinct) {
+    return distinct;
+  });
+}
+} // namespace
 
 HashAggregation::HashAggregation(
     int32_t operatorId,
@@ -32,9 +53,12 @@ HashAggregation::HashAggregation(
           aggregationNode->step() == core::AggregationNode::Step::kPartial
               ? "PartialAggregation"
               : "Aggregation"),
-      outputBatchSize_{driverCtx->queryConfig().preferredOutputBatchSize()},
       maxPartialAggregationMemoryUsage_(
           driverCtx->queryConfig().maxPartialAggregationMemoryUsage()),
+      abandonPartialAggregationMinRows_(
+          driverCtx->queryConfig().abandonPartialAggregationMinRows()),
+      abandonPartialAggregationMinPct_(
+          driverCtx->queryConfig().abandonPartialAggregationMinPct()),
       isPartialOutput_(isPartialOutput(aggregationNode->step())),
       isDistinct_(aggregationNode->aggregates().empty()),
       isGlobal_(aggregationNode->groupingKeys().empty()) {
@@ -60,8 +84,27 @@ HashAggregation::HashAggregation(
   }
 
   auto numAggregates = aggregationNode->aggregates().size();
-  std::vector<std::unique_ptr<Aggregate>> aggregates;
-  aggregates.reserve(numAggregates);
+  // Also makes copies of the Aggregates for merging spilled partitions in
+  // parallel.
+  auto makeAggregates = [aggregationNode,
+                         outputType = outputType_,
+                         numHashers]() {
+    std::vector<std::unique_ptr<Aggregate>> aggregates;
+    for (auto i = 0; i < aggregationNode->aggregates().size(); ++i) {
+      const auto& aggregate = aggregationNode->aggregates()[i];
+      std::vector<TypePtr> argTypes;
+      for (auto& arg : aggregate->inputs()) {
+        argTypes.push_back(arg->type());
+      }
+      aggregates.push_back(Aggregate::create(
+          aggregate->name(),
+          aggregationNode->step(),
+          argTypes,
+          outputType->childAt(numHashers + i)));
+    }
+    return aggregates;
+  };
+  auto aggregates = makeAggregates();
   std::vector<std::optional<column_index_t>> aggrMaskChannels;
   aggrMaskChannels.reserve(numAggregates);
   auto numMasks = aggregationNode->aggregateMasks().size();
@@ -110,9 +153,6 @@ HashAggregation::HashAggregation(
       aggrMaskChannels.emplace_back(std::nullopt);
     }
 
-    const auto& resultType = outputType_->childAt(numHashers + i);
-    aggregates.push_back(Aggregate::create(
-        aggregate->name(), aggregationNode->step(), argTypes, resultType));
     args.push_back(channels);
     constantLists.push_back(constants);
   }
@@ -140,29 +180,47 @@ HashAggregation::HashAggregation(
       std::move(preGroupedChannels),
       std::move(aggregates),
       std::move(aggrMaskChannels),
+      std::vector<bool>(aggregationNode->aggregateDistincts()),
       std::move(args),
       std::move(constantLists),
       std::move(intermediateTypes),
       aggregationNode->ignoreNullKeys(),
       isPartialOutput_,
       isRawInput(aggregationNode->step()),
-      operatorCtx_.get());
+      operatorCtx_.get(),
+      std::move(makeAggregates));
+
+  shareGroups_ = canShareGroups(*aggregationNode, driverCtx->queryConfig());
+  if (shareGroups_) {
+    for (const auto& key : aggregationNode->groupingKeys()) {
+      partitionHashers_.push_back(VectorHasher::create(
+          key->type(), exprToChannel(key.get(), inputType)));
+    }
+  }
 }
 
 void HashAggregation::addInput(RowVectorPtr input) {
+  if (abandonedPartialAggregation_) {
+    // Converted to intermediate results in getOutput().
+    input_ = input;
+    return;
+  }
+  if (sharedPartitions_) {
+    addSharedInput(input);
+    return;
+  }
   if (!pushdownChecked_) {
     mayPushdown_ = operatorCtx_->driver()->mayPushdownAggregation(this);
     pushdownChecked_ = true;
   }
   groupingSet_->addInput(input, mayPushdown_);
-  auto spilled = groupingSet_->spilledBytesAndRows();
-  stats_.spilledBytes = spilled.first;
-  stats_.spilledRows = spilled.second;
+  updateSpillStats();
 
   if (isPartialOutput_ &&
       groupingSet_->allocatedBytes() > maxPartialAggregationMemoryUsage_) {
     partialFull_ = true;
   }
+  maybeAbandonPartialAggregation(input->size());
 
   if (isDistinct_) {
     newDistincts_ = !groupingSet_->hashLookup().newGroups.empty();
@@ -174,6 +232,137 @@ void HashAggregation::addInput(RowVectorPtr input) {
   }
 }
 
+void HashAggregation::addSharedInput(const RowVectorPtr& input) {
+  const auto numRows = input->size();
+  const int32_t numPartitions = sharedPartitions_->groupingSets.size();
+  SelectivityVector rows(numRows);
+  partitionHashes_.resize(numRows);
+  for (auto i = 0; i < partitionHashers_.size(); ++i) {
+    auto key = input->childAt(partitionHashers_[i]->channel())->loadedVector();
+    partitionHashers_[i]->hash(*key, rows, i > 0, partitionHashes_);
+  }
+
+  // The low bits of the hash pick the slot in the table of a partition, so
+  // the partition is picked by the high bits.
+  std::vector<vector_size_t> sizes(numPartitions, 0);
+  rowPartitions_.resize(numRows);
+  for (auto row = 0; row < numRows; ++row) {
+    const int32_t partition = (partitionHashes_[row] >> 32) % numPartitions;
+    rowPartitions_[row] = partition;
+    ++sizes[partition];
+  }
+
+  std::vector<VectorPtr> children;
+  children.reserve(input->childrenSize());
+  for (auto& child : input->children()) {
+    children.push_back(BaseVector::loadedVectorShared(child));
+  }
+  std::vector<BufferPtr> indices(numPartitions);
+  std::vector<vector_size_t*> rawIndices(numPartitions);
+  for (auto partition = 0; partition < numPartitions; ++partition) {
+    if (sizes[partition] > 0 && sizes[partition] < numRows) {
+      indices[partition] = allocateIndices(sizes[partition], pool());
+      rawIndices[partition] = indices[partition]->asMutable<vector_size_t>();
+    }
+    sizes[partition] = 0;
+  }
+  for (auto row = 0; row < numRows; ++row) {
+    const auto partition = rowPartitions_[row];
+    if (rawIndices[partition]) {
+      rawIndices[partition][sizes[partition]] = row;
+    }
+    ++sizes[partition];
+  }
+
+  // Each Driver starts with its own partition to spread the lock traffic.
+  for (auto i = 0; i < numPartitions; ++i) {
+    const auto partition = (sharedPartition_ + i) % numPartitions;
+    const auto size = sizes[partition];
+    if (size == 0) {
+      continue;
+    }
+    RowVectorPtr partitionInput;
+    if (size == numRows) {
+      partitionInput = std::make_shared<RowVector>(
+          pool(), input->type(), nullptr, numRows, children);
+    } else {
+      std::vector<VectorPtr> wrapped;
+      wrapped.reserve(children.size());
+      for (auto& child : children) {
+        wrapped.push_back(BaseVector::wrapInDictionary(
+            nullptr, indices[partition], size, child));
+      }
+      partitionInput = std::make_shared<RowVector>(
+          pool(), input->type(), nullptr, size, std::move(wrapped));
+    }
+    std::lock_guard<std::mutex> l(sharedPartitions_->mutexes[partition]);
+    sharedPartitions_->groupingSets[partition]->addInput(
+        partitionInput, false);
+  }
+}
+
+void HashAggregation::noMoreInput() {
+  groupingSet_->noMoreInput();
+  Operator::noMoreInput();
+  if (!sharedPartitions_) {
+    return;
+  }
+  // A Driver produces the groups of its partition after all Drivers have
+  // added their input.
+  std::vector<ContinuePromise> promises;
+  std::vector<std::shared_ptr<Driver>> peers;
+  if (!operatorCtx_->task()->allPeersFinished(
+          planNodeId(), operatorCtx_->driver(), &future_, promises, peers)) {
+    return;
+  }
+  for (auto& promise : promises) {
+    promise.setValue();
+  }
+}
+
+BlockingReason HashAggregation::isBlocked(ContinueFuture* future) {
+  if (shareGroups_ && !groupsShared_) {
+    shareGroupingSets();
+  }
+  if (!future_.valid()) {
+    return BlockingReason::kNotBlocked;
+  }
+  *future = std::move(future_);
+  return BlockingReason::kWaitForPeers;
+}
+
+void HashAggregation::shareGroupingSets() {
+  groupsShared_ = true;
+  // The last Driver to get here makes the partitions for all. The others
+  // wait and find 'sharedPartitions_' set when they continue. With one
+  // Driver there is nothing to share.
+  std::vector<ContinuePromise> promises;
+  std::vector<std::shared_ptr<Driver>> peers;
+  if (!operatorCtx_->task()->allPeersFinished(
+          planNodeId(), operatorCtx_->driver(), &future_, promises, peers)) {
+    return;
+  }
+  if (!peers.empty()) {
+    auto partitions =
+        std::make_shared<SharedAggregationPartitions>(peers.size() + 1);
+    partitions->groupingSets[0] = groupingSet_;
+    sharedPartitions_ = partitions;
+    for (auto i = 0; i < peers.size(); ++i) {
+      auto* peer =
+          dynamic_cast<HashAggregation*>(peers[i]->findOperator(planNodeId()));
+      VELOX_CHECK_NOT_NULL(peer);
+      partitions->groupingSets[i + 1] = peer->groupingSet_;
+      peer->sharedPartitions_ = partitions;
+      peer->sharedPartition_ = i + 1;
+    }
+    stats().addRuntimeStat(
+        "sharedPartitions", RuntimeCounter(partitions->groupingSets.size()));
+  }
+  for (auto& promise : promises) {
+    promise.setValue();
+  }
+}
+
 void HashAggregation::prepareOutput(vector_size_t size) {
   if (output_) {
     VectorPtr output = std::move(output_);
@@ -191,6 +380,24 @@ void HashAggregation::flushPartialOutputIfNeed() {
         "flushRowCount", RuntimeCounter(groupingSet_->numRows()));
     groupingSet_->resetPartial();
     partialFull_ = false;
+    numInputRowsSinceFlush_ = 0;
+  }
+}
+
+void HashAggregation::maybeAbandonPartialAggregation(vector_size_t numInput) {
+  if (!isPartialOutput_ || !groupingSet_->mayAbandonPartialAggregation()) {
+    return;
+  }
+  numInputRowsSinceFlush_ += numInput;
+  if (numInputRowsSinceFlush_ < abandonPartialAggregationMinRows_) {
+    return;
+  }
+  if (100 * groupingSet_->numRows() >=
+      abandonPartialAggregationMinPct_ * numInputRowsSinceFlush_) {
+    // The groups collected so far are flushed before passing input through.
+    partialFull_ = true;
+    abandonedPartialAggregation_ = true;
+    stats().addRuntimeStat("abandonedPartialAggregation", RuntimeCounter(1));
   }
 }
 
@@ -200,6 +407,19 @@ RowVectorPtr HashAggregation::getOutput() {
     return nullptr;
   }
 
+  if (abandonedPartialAggregation_ && !partialFull_) {
+    if (input_) {
+      prepareOutput(input_->size());
+      groupingSet_->toIntermediate(input_, output_);
+      input_ = nullptr;
+      return output_;
+    }
+    if (noMoreInput_) {
+      finished_ = true;
+    }
+    return nullptr;
+  }
+
   // Produce results if one of the following is true:
   // - received no-more-input message;
   // - partial aggregation reached memory limit;
@@ -235,7 +455,8 @@ RowVectorPtr HashAggregation::getOutput() {
     return output;
   }
 
-  auto batchSize = isGlobal_ ? 1 : outputBatchSize_;
+  auto batchSize =
+      isGlobal_ ? 1 : outputBatchRows(groupingSet_->estimateOutputRowSize());
 
   // Reuse output vectors if possible.
   prepareOutput(batchSize);
@@ -254,6 +475,21 @@ RowVectorPtr HashAggregation::getOutput() {
   return output_;
 }
 
+void HashAggregation::reclaim() {
+  groupingSet_->spill(0, 0);
+  updateSpillStats();
+  // Give back the reservation made for the spilled rows.
+  operatorCtx_->mappedMemory()->tracker()->release();
+}
+
+void HashAggregation::updateSpillStats() {
+  auto spilled = groupingSet_->spilledBytesAndRows();
+  stats_.spilledBytes = spilled.first;
+  stats_.spilledRows = spilled.second;
+  stats_.spilledUncompressedBytes = groupingSet_->spilledUncompressedBytes();
+  setSpillPathStats(groupingSet_->spillPathStats(), stats_);
+}
+
 bool HashAggregation::isFinished() {
   return finished_;
 }
@@ -15,11 +15,27 @@
  */
 #pragma once
 
+#include <mutex>
+
 #include "velox/exec/GroupingSet.h"
 #include "velox/exec/Operator.h"
 
 namespace facebook::velox::exec {
 
+// The groups of a final aggregation whose Drivers share their input. There
+// is one partition per Driver, holding the GroupingSet of that Driver. An
+// input row goes to the partition picked by the hash of its grouping keys,
+// so that the partitions have disjoint groups.
+struct SharedAggregationPartitions {
+  explicit SharedAggregationPartitions(int32_t numPartitions)
+      : groupingSets(numPartitions), mutexes(numPartitions) {}
+
+  std::vector<std::shared_ptr<GroupingSet>> groupingSets;
+
+  // Serializes the additions to the corresponding element of 'groupingSets'.
+  std::vector<std::mutex> mutexes;
+};
+
 class HashAggregation : public Operator {
  public:
   HashAggregation(
@@ -32,41 +48,95 @@ class HashAggregation : public Operator {
   RowVectorPtr getOutput() override;
 
   bool needsInput() const override {
-    return !noMoreInput_ && !partialFull_;
+    return !noMoreInput_ && !partialFull_ &&
+        !(abandonedPartialAggregation_ && input_);
   }
 
-  void noMoreInput() override {
-    groupingSet_->noMoreInput();
-    Operator::noMoreInput();
-  }
+  void noMoreInput() override;
 
-  BlockingReason isBlocked(ContinueFuture* /* unused */) override {
-    return BlockingReason::kNotBlocked;
-  }
+  BlockingReason isBlocked(ContinueFuture* future) override;
 
   bool isFinished() override;
 
+  uint64_t reclaimableBytes() const override {
+    return groupingSet_ && !sharedPartitions_
+        ? groupingSet_->reclaimableBytes()
+        : 0;
+  }
+
+  void reclaim() override;
+
   void close() override {
     Operator::close();
     groupingSet_.reset();
+    sharedPartitions_.reset();
   }
 
  private:
   void prepareOutput(vector_size_t size);
   void flushPartialOutputIfNeed();
 
-  /// Maximum number of rows in the output batch.
-  const uint32_t outputBatchSize_;
+  // Decides whether a partial aggregation reduces the input enough to be
+  // worth the hashing. If not, flushes the groups and switches to converting
+  // each input row to intermediate results.
+  void maybeAbandonPartialAggregation(vector_size_t numInput);
+
+  // Waits for all Drivers of the pipeline and gives them shared partitions
+  // made of their GroupingSets. Called once, from the first isBlocked().
+  void shareGroupingSets();
+
+  // Adds the rows of 'input' to the shared partitions of their keys.
+  void addSharedInput(const RowVectorPtr& input);
+
+  // Copies the spill statistics of 'groupingSet_' to 'stats_'.
+  void updateSpillStats();
 
   const int64_t maxPartialAggregationMemoryUsage_;
 
+  // See QueryConfig::kAbandonPartialAggregationMinRows and
+  // kAbandonPartialAggregationMinPct.
+  const int64_t abandonPartialAggregationMinRows_;
+  const int32_t abandonPartialAggregationMinPct_;
+
   const bool isPartialOutput_;
   const bool isDistinct_;
   const bool isGlobal_;
 
-  std::unique_ptr<GroupingSet> groupingSet_;
+  // Shared with the other Drivers of the pipeline if 'sharedPartitions_' is
+  // set.
+  std::shared_ptr<GroupingSet> groupingSet_;
+
+  // True if the Drivers share their groups. See
+  // QueryConfig::kSharedFinalAggregation.
+  bool shareGroups_ = false;
+
+  // True after shareGroupingSets() has run.
+  bool groupsShared_ = false;
+
+  // Set if the pipeline has more than one Driver and 'shareGroups_' is true.
+  std::shared_ptr<SharedAggregationPartitions> sharedPartitions_;
+
+  // The partition of 'groupingSet_' in 'sharedPartitions_'.
+  int32_t sharedPartition_{0};
+
+  // Hash the grouping keys to pick the shared partition of an input row.
+  std::vector<std::unique_ptr<VectorHasher>> partitionHashers_;
+  raw_vector<uint64_t> partitionHashes_;
+  raw_vector<int32_t> rowPartitions_;
+
+  // Set while waiting for the other Drivers to share the groups or to
+  // finish adding their input.
+  ContinueFuture future_{ContinueFuture::makeEmpty()};
 
   bool partialFull_ = false;
+
+  // Number of input rows added to the groups since the last flush of a
+  // partial aggregation.
+  int64_t numInputRowsSinceFlush_ = 0;
+
+  // True if the partial aggregation reduced too little and passes its input
+  // through as intermediate results.
+  bool abandonedPartialAggregation_ = false;
   bool newDistincts_ = false;
   bool finished_ = false;
   RowContainerIterator resultIterator_;
@@ -15,20 +15,26 @@
  */
 
 #include "velox/exec/HashBuild.h"
+#include <folly/ScopeGuard.h>
+#include "velox/exec/HashJoinTableCache.h"
 #include "velox/exec/OperatorUtils.h"
 #include "velox/exec/Task.h"
 
 namespace facebook::velox::exec {
 
-void HashJoinBridge::setHashTable(std::unique_ptr<BaseHashTable> table) {
+void HashJoinBridge::setHashTable(
+    std::shared_ptr<BaseHashTable> table,
+    std::shared_ptr<SpilledHashBuild> spill,
+    std::vector<std::shared_ptr<common::Filter>> keyBloomFilters) {
   VELOX_CHECK(table, "setHashTable called with null table");
 
   std::vector<ContinuePromise> promises;
   {
     std::lock_guard<std::mutex> l(mutex_);
     VELOX_CHECK(!table_, "setHashTable may be called only once");
-    // Ownership becomes shared.
-    table_.reset(table.release());
+    table_ = std::move(table);
+    spill_ = std::move(spill);
+    keyBloomFilters_ = std::move(keyBloomFilters);
     promises = std::move(promises_);
   }
   notify(std::move(promises));
@@ -48,26 +54,251 @@ void HashJoinBridge::setAntiJoinHasNullKeys() {
   notify(std::move(promises));
 }
 
+HashJoinBridge::CacheLookup HashJoinBridge::lookupCachedTable(
+    const std::string& key,
+    const std::string& taskId,
+    ContinueFuture* future) {
+  std::vector<ContinuePromise> promises;
+  {
+    std::lock_guard<std::mutex> l(mutex_);
+    if (cacheLookup_ != CacheLookup::kWait) {
+      return cacheLookup_;
+    }
+    auto entry = HashJoinTableCache::getInstance().get(key, taskId, future);
+    if (!entry) {
+      if (!future->valid()) {
+        cacheLookup_ = CacheLookup::kBuild;
+      }
+      return cacheLookup_;
+    }
+    VELOX_CHECK(!table_ && !antiJoinHasNullKeys_);
+    cacheLookup_ = CacheLookup::kHit;
+    cachedEntry_ = std::move(entry);
+    table_ = cachedEntry_->table;
+    antiJoinHasNullKeys_ = cachedEntry_->antiJoinHasNullKeys;
+    keyBloomFilters_ = cachedEntry_->keyBloomFilters;
+    promises = std::move(promises_);
+  }
+  notify(std::move(promises));
+  return CacheLookup::kHit;
+}
+
 std::optional<HashJoinBridge::HashBuildResult> HashJoinBridge::tableOrFuture(
     ContinueFuture* future) {
   std::lock_guard<std::mutex> l(mutex_);
   VELOX_CHECK(
       !cancelled_, "Getting hash table after the build side is aborted");
   if (table_ || antiJoinHasNullKeys_) {
-    return HashBuildResult{table_, antiJoinHasNullKeys_};
+    return HashBuildResult{
+        table_, antiJoinHasNullKeys_, spill_, keyBloomFilters_};
   }
   promises_.emplace_back("HashJoinBridge::tableOrFuture");
   *future = promises_.back().getSemiFuture();
   return std::nullopt;
 }
 
+void HashJoinBridge::addSpilledProbeFiles(
+    std::vector<std::vector<std::unique_ptr<SpillFile>>> files) {
+  std::lock_guard<std::mutex> l(mutex_);
+  if (spilledProbeFiles_.size() < files.size()) {
+    spilledProbeFiles_.resize(files.size());
+  }
+  for (auto i = 0; i < files.size(); ++i) {
+    for (auto& file : files[i]) {
+      spilledProbeFiles_[i].push_back(std::move(file));
+    }
+  }
+}
+
+void HashJoinBridge::startSpilledPartitions() {
+  std::lock_guard<std::mutex> l(mutex_);
+  VELOX_CHECK_NOT_NULL(spill_);
+  spilledProbeFiles_.resize(spill_->files.size());
+  for (auto i = 0; i < spill_->files.size(); ++i) {
+    if (!spill_->isSpilled(i) || spilledProbeFiles_[i].empty()) {
+      continue;
+    }
+    auto partition = std::make_unique<SpilledJoinPartition>();
+    partition->startBit = spill_->bits.end();
+    partition->buildFiles = std::move(spill_->files[i]);
+    partition->probeFiles = std::move(spilledProbeFiles_[i]);
+    spilledPartitions_.push_back(std::move(partition));
+  }
+  spilledProbeFiles_.clear();
+}
+
+std::unique_ptr<SpilledJoinPartition> HashJoinBridge::nextSpilledPartition(
+    ContinueFuture* future) {
+  std::lock_guard<std::mutex> l(mutex_);
+  VELOX_CHECK(!cancelled_, "Joining spilled partitions after cancellation");
+  if (spilledPartitions_.empty()) {
+    if (numSplittingPartitions_ > 0) {
+      promises_.emplace_back("HashJoinBridge::nextSpilledPartition");
+      *future = promises_.back().getSemiFuture();
+    }
+    return nullptr;
+  }
+  auto partition = std::move(spilledPartitions_.back());
+  spilledPartitions_.pop_back();
+  ++numSplittingPartitions_;
+  return partition;
+}
+
+void HashJoinBridge::finishSpilledPartition(
+    std::vector<std::unique_ptr<SpilledJoinPartition>> splits) {
+  std::vector<ContinuePromise> promises;
+  {
+    std::lock_guard<std::mutex> l(mutex_);
+    VELOX_CHECK_GT(numSplittingPartitions_, 0);
+    --numSplittingPartitions_;
+    for (auto& split : splits) {
+      spilledPartitions_.push_back(std::move(split));
+    }
+    promises = std::move(promises_);
+  }
+  notify(std::move(promises));
+}
+
+namespace {
+std::optional<std::string> makeSpillPath(
+    const core::HashJoinNode& joinNode,
+    const OperatorCtx& operatorCtx) {
+  // A table shared with other Tasks must have all the build side rows.
+  if (joinNode.isRightJoin() || joinNode.isFullJoin() ||
+      joinNode.buildCacheId().has_value()) {
+    return std::nullopt;
+  }
+  auto path = operatorCtx.task()->queryCtx()->config().spillPath();
+  if (path.has_value()) {
+    return appendToSpillPath(
+        path.value(),
+        fmt::format(
+            "/{}-join-{}", operatorCtx.task()->taskId(), joinNode.id()));
+  }
+  return std::nullopt;
+}
+
+// Upper limit on the expected number of entries a key Bloom filter is sized
+// for. At 16 bits per entry this is 8MB per key. Larger build sides get more
+// false positives.
+constexpr int64_t kMaxBloomFilterEntries = 4 << 20;
+
+template <typename T>
+std::shared_ptr<common::Filter> makeKeyBloomFilter(
+    const std::vector<RowContainer*>& containers,
+    int32_t keyIndex) {
+  int64_t numRows = 0;
+  for (auto* container : containers) {
+    numRows += container->numRows();
+  }
+  if (numRows == 0) {
+    return nullptr;
+  }
+  auto bloom = std::make_shared<common::BigintValuesUsingBloomFilter::Bloom>();
+  bloom->reset(std::min(numRows, kMaxBloomFilterEntries));
+  auto min = std::numeric_limits<int64_t>::max();
+  auto max = std::numeric_limits<int64_t>::min();
+  std::vector<char*> rows(1'000);
+  for (auto* container : containers) {
+    const auto column = container->columnAt(keyIndex);
+    RowContainerIterator iter;
+    while (auto numListed =
+               container->listRows(&iter, rows.size(), rows.data())) {
+      for (auto i = 0; i < numListed; ++i) {
+        // A null key does not match anything.
+        if (RowContainer::isNullAt(
+                rows[i], column.nullByte(), column.nullMask())) {
+          continue;
+        }
+        int64_t value = *reinterpret_cast<const T*>(rows[i] + column.offset());
+        min = std::min(min, value);
+        max = std::max(max, value);
+        bloom->insert(common::BigintValuesUsingBloomFilter::hashValue(value));
+      }
+    }
+  }
+  if (min > max) {
+    return nullptr;
+  }
+  return std::make_shared<common::BigintValuesUsingBloomFilter>(
+      min, max, std::move(bloom), false);
+}
+} // namespace
+
+void addJoinBuildRows(
+    BaseHashTable& table,
+    const RowVector& input,
+    const SelectivityVector& rows,
+    const std::vector<column_index_t>& dependentChannels,
+    std::vector<std::unique_ptr<DecodedVector>>& decoders,
+    bool& analyzeKeys,
+    raw_vector<uint64_t>& hashes) {
+  if (analyzeKeys && hashes.size() < rows.size()) {
+    hashes.resize(rows.size());
+  }
+
+  auto& hashers = table.hashers();
+
+  // As long as analyzeKeys is true, we keep running the keys through
+  // the Vectorhashers so that we get a possible mapping of the keys
+  // to small ints for array or normalized key. When mayUseValueIds is
+  // false for the first time we stop. We do not retain the value ids
+  // since the final ones will only be known after all data is
+  // received.
+  for (auto& hasher : hashers) {
+    // TODO: Load only for active rows, except if right/full outer join.
+    if (analyzeKeys) {
+      hasher->computeValueIds(
+          *input.childAt(hasher->channel())->loadedVector(), rows, hashes);
+      analyzeKeys = hasher->mayUseValueIds();
+    } else {
+      hasher->decode(*input.childAt(hasher->channel())->loadedVector(), rows);
+    }
+  }
+  for (auto i = 0; i < dependentChannels.size(); ++i) {
+    decoders[i]->decode(
+        *input.childAt(dependentChannels[i])->loadedVector(), rows);
+  }
+  auto container = table.rows();
+  auto nextOffset = container->nextOffset();
+  rows.applyToSelected([&](auto rowIndex) {
+    char* newRow = container->newRow();
+    if (nextOffset) {
+      *reinterpret_cast<char**>(newRow + nextOffset) = nullptr;
+    }
+    // Store the columns for each row in sequence. At probe time
+    // strings of the row will probably be in consecutive places, so
+    // reading one will prime the cache for the next.
+    for (auto i = 0; i < hashers.size(); ++i) {
+      container->store(hashers[i]->decodedVector(), rowIndex, newRow, i);
+    }
+    for (auto i = 0; i < dependentChannels.size(); ++i) {
+      container->store(*decoders[i], rowIndex, newRow, i + hashers.size());
+    }
+  });
+}
+
 HashBuild::HashBuild(
     int32_t operatorId,
     DriverCtx* driverCtx,
     std::shared_ptr<const core::HashJoinNode> joinNode)
     : Operator(driverCtx, nullptr, operatorId, joinNode->id(), "HashBuild"),
       joinType_{joinNode->joinType()},
-      mappedMemory_(operatorCtx_->mappedMemory()) {
+      cacheKey_(HashJoinTableCache::makeKey(
+          *joinNode,
+          operatorCtx_->driverCtx()->splitGroupId)),
+      mappedMemory_(
+          cacheKey_.has_value()
+              ? HashJoinTableCache::getInstance().mappedMemory()
+              : operatorCtx_->mappedMemory()),
+      spillPath_(makeSpillPath(*joinNode, *operatorCtx_)),
+      spillCompression_(spillCompressionCodec(
+          spillPath_,
+          operatorCtx_->task()->queryCtx()->config().spillCompressionKind())),
+      spillLocalQuotaBytes_(
+          operatorCtx_->task()->queryCtx()->config().spillLocalQuotaBytes()),
+      testSpillPct_(
+          operatorCtx_->task()->queryCtx()->config().testingSpillPct()) {
   auto type = joinNode->sources()[1]->outputType();
 
   auto numKeys = joinNode->rightKeys().size();
@@ -82,15 +313,23 @@ HashBuild::HashBuild(
     keyChannels_.emplace_back(channel);
     keyHashers.emplace_back(
         std::make_unique<VectorHasher>(type->childAt(channel), channel));
+    if (spillPath_.has_value()) {
+      spillHashers_.emplace_back(
+          std::make_unique<VectorHasher>(type->childAt(channel), channel));
+    }
   }
 
   // Identify the non-key build side columns and make a decoder for each.
-  auto numDependents = type->size() - numKeys;
+  // Semi and anti joins with no extra filter output only probe side columns,
+  // so the table stores only the keys.
+  const bool keysOnly = !joinNode->filter() &&
+      (joinNode->isLeftSemiJoin() || joinNode->isAntiJoin());
+  auto numDependents = keysOnly ? 0 : type->size() - numKeys;
   dependentChannels_.reserve(numDependents);
   decoders_.reserve(numDependents);
   std::vector<TypePtr> dependentTypes;
   dependentTypes.reserve(numDependents);
-  for (auto i = 0; i < type->size(); ++i) {
+  for (auto i = 0; !keysOnly && i < type->size(); ++i) {
     if (keyChannelSet.find(i) == keyChannelSet.end()) {
       dependentTypes.emplace_back(type->childAt(i));
       dependentChannels_.emplace_back(i);
@@ -98,7 +337,23 @@ HashBuild::HashBuild(
     }
   }
 
+  if (spillPath_.has_value()) {
+    std::vector<std::string> names;
+    std::vector<TypePtr> types;
+    for (auto channel : keyChannels_) {
+      names.push_back(type->nameOf(channel));
+      types.push_back(type->childAt(channel));
+    }
+    for (auto channel : dependentChannels_) {
+      names.push_back(type->nameOf(channel));
+      types.push_back(type->childAt(channel));
+    }
+    spillType_ = ROW(std::move(names), std::move(types));
+    spilledPartitions_.resize(spillBits_.numPartitions(), false);
+  }
+
   if (joinNode->isRightJoin() || joinNode->isFullJoin()) {
+    allowDuplicates_ = true;
     // Do not ignore null keys.
     table_ = HashTable<false>::createForJoin(
         std::move(keyHashers),
@@ -109,8 +364,8 @@ HashBuild::HashBuild(
   } else {
     // Semi and anti join with no extra filter only needs to know whether there
     // is a match. Hence, no need to store entries with duplicate keys.
-    const bool dropDuplicates = !joinNode->filter() &&
-        (joinNode->isLeftSemiJoin() || joinNode->isAntiJoin());
+    const bool dropDuplicates = keysOnly;
+    allowDuplicates_ = !dropDuplicates;
 
     table_ = HashTable<true>::createForJoin(
         std::move(keyHashers),
@@ -140,52 +395,274 @@ void HashBuild::addInput(RowVectorPtr input) {
     }
   }
 
-  if (analyzeKeys_ && hashes_.size() < activeRows_.size()) {
-    hashes_.resize(activeRows_.size());
+  ensureInputFits(input);
+  if (spillState_) {
+    spillInput(input, activeRows_);
+    if (!activeRows_.hasSelections()) {
+      return;
+    }
   }
 
-  auto& hashers = table_->hashers();
+  addJoinBuildRows(
+      *table_,
+      *input,
+      activeRows_,
+      dependentChannels_,
+      decoders_,
+      analyzeKeys_,
+      hashes_);
+}
 
-  // As long as analyzeKeys is true, we keep running the keys through
-  // the Vectorhashers so that we get a possible mapping of the keys
-  // to small ints for array or normalized key. When mayUseValueIds is
-  // false for the first time we stop. We do not retain the value ids
-  // since the final ones will only be known after all data is
-  // received.
-  for (auto& hasher : hashers) {
-    // TODO: Load only for active rows, except if right/full outer join.
-    if (analyzeKeys_) {
-      hasher->computeValueIds(
-          *input->childAt(hasher->channel())->loadedVector(),
-          activeRows_,
-          hashes_);
-      analyzeKeys_ = hasher->mayUseValueIds();
-    } else {
-      hasher->decode(
-          *input->childAt(hasher->channel())->loadedVector(), activeRows_);
+void HashBuild::ensureInputFits(const RowVectorPtr& input) {
+  if (!spillPath_.has_value()) {
+    return;
+  }
+  auto rows = table_->rows();
+  auto numRows = rows->numRows();
+  if (!numRows) {
+    // Table is empty. Nothing to spill.
+    return;
+  }
+
+  auto [freeRows, outOfLineFreeBytes] = rows->freeSpace();
+  auto outOfLineBytes =
+      rows->stringAllocator().retainedSize() - outOfLineFreeBytes;
+  int64_t flatBytes = input->estimateFlatSize();
+
+  // Test-only spill path.
+  if (testSpillPct_ &&
+      (folly::hasher<uint64_t>()(++spillTestCounter_)) % 100 <= testSpillPct_) {
+    spill(rows->allocatedBytes() / 4);
+    return;
+  }
+
+  if (freeRows > input->size() &&
+      (outOfLineBytes == 0 || outOfLineFreeBytes >= flatBytes)) {
+    // Enough free rows for input rows and enough variable length free
+    // space for the flat size of the whole vector. If outOfLineBytes
+    // is 0 there is no need for variable length space.
+    return;
+  }
+  // If there is variable length data we take the flat size of the
+  // input as a cap on the new variable length data needed.
+  auto increment =
+      rows->sizeIncrement(input->size(), outOfLineBytes ? flatBytes : 0);
+  auto tracker = mappedMemory_->tracker();
+  assert(tracker);
+  // There must be at least 2x the increment in reservation.
+  if (tracker->getAvailableReservation() > 2 * increment) {
+    return;
+  }
+
+  // Check if can increase reservation. The increment is the larger of
+  // twice the maximum increment from this input and 1/4 of the current
+  // reservation.
+  auto targetIncrement =
+      std::max<int64_t>(increment * 2, tracker->getCurrentUserBytes() / 4);
+  if (tracker->maybeReserve(targetIncrement)) {
+    return;
+  }
+  spill(targetIncrement);
+}
+
+void HashBuild::ensureSpillState() {
+  if (spillState_) {
+    return;
+  }
+  assert(mappedMemory_->tracker()); // lint
+  auto fileSize = std::max<uint64_t>(
+      mappedMemory_->tracker()->getCurrentUserBytes() / 4, 1 << 20);
+  spillState_ = std::make_unique<SpillState>(
+      appendToSpillPath(
+          spillPath_.value(), fmt::format("-build-{}", operatorId())),
+      spillBits_.numPartitions(),
+      0,
+      fileSize,
+      Spiller::spillPool(),
+      Spiller::spillMappedMemory(),
+      std::vector<CompareFlags>{},
+      spillCompression_,
+      operatorCtx_->task()->queryCtx()->spillExecutor(),
+      spillLocalQuotaBytes_);
+}
+
+void HashBuild::hashRows(folly::Range<char**> rows) {
+  spillHashes_.resize(rows.size());
+  for (auto i = 0; i < keyChannels_.size(); ++i) {
+    table_->rows()->hash(i, rows, i > 0, spillHashes_.data());
+  }
+}
+
+void HashBuild::spill(int64_t targetBytes) {
+  auto container = table_->rows();
+  auto numRows = container->numRows();
+  if (!numRows) {
+    return;
+  }
+  DriverTrace::Scope traceScope(
+      operatorCtx_->driverTrace(),
+      DriverTrace::EventType::kSpill,
+      operatorCtx_->operatorId());
+  std::vector<char*> rows(numRows);
+  RowContainerIterator iter;
+  container->listRows(&iter, numRows, rows.data());
+  hashRows(folly::Range<char**>(rows.data(), rows.size()));
+
+  std::vector<int64_t> partitionRows(spillBits_.numPartitions());
+  for (auto i = 0; i < rows.size(); ++i) {
+    ++partitionRows[spillBits_.partition(
+        spillHashes_[i], spillBits_.numPartitions())];
+  }
+
+  // Spill the largest partitions first.
+  const int64_t bytesPerRow = container->allocatedBytes() / numRows;
+  std::vector<bool> partitions(spillBits_.numPartitions(), false);
+  int64_t spilledBytes = 0;
+  while (spilledBytes < targetBytes) {
+    int32_t largest = -1;
+    for (auto i = 0; i < partitionRows.size(); ++i) {
+      if (!spilledPartitions_[i] && !partitions[i] && partitionRows[i] &&
+          (largest == -1 || partitionRows[i] > partitionRows[largest])) {
+        largest = i;
+      }
     }
+    if (largest == -1) {
+      break;
+    }
+    partitions[largest] = true;
+    spilledBytes += partitionRows[largest] * bytesPerRow;
   }
-  for (auto i = 0; i < dependentChannels_.size(); ++i) {
-    decoders_[i]->decode(
-        *input->childAt(dependentChannels_[i])->loadedVector(), activeRows_);
+  spillPartitions(partitions);
+}
+
+void HashBuild::spillPartitions(const std::vector<bool>& partitions) {
+  std::vector<bool> newPartitions(spillBits_.numPartitions(), false);
+  bool anyNew = false;
+  for (auto i = 0; i < partitions.size(); ++i) {
+    if (partitions[i] && !spilledPartitions_[i]) {
+      newPartitions[i] = true;
+      spilledPartitions_[i] = true;
+      anyNew = true;
+    }
   }
-  auto rows = table_->rows();
-  auto nextOffset = rows->nextOffset();
-  activeRows_.applyToSelected([&](auto rowIndex) {
-    char* newRow = rows->newRow();
-    if (nextOffset) {
-      *reinterpret_cast<char**>(newRow + nextOffset) = nullptr;
+  if (!anyNew) {
+    return;
+  }
+  ensureSpillState();
+
+  auto container = table_->rows();
+  auto numRows = container->numRows();
+  if (!numRows) {
+    return;
+  }
+  std::vector<char*> rows(numRows);
+  RowContainerIterator iter;
+  container->listRows(&iter, numRows, rows.data());
+  hashRows(folly::Range<char**>(rows.data(), rows.size()));
+
+  std::vector<std::vector<char*>> partitionRows(spillBits_.numPartitions());
+  for (auto i = 0; i < rows.size(); ++i) {
+    auto partition =
+        spillBits_.partition(spillHashes_[i], spillBits_.numPartitions());
+    if (newPartitions[partition]) {
+      partitionRows[partition].push_back(rows[i]);
     }
-    // Store the columns for each row in sequence. At probe time
-    // strings of the row will probably be in consecutive places, so
-    // reading one will prime the cache for the next.
-    for (auto i = 0; i < hashers.size(); ++i) {
-      rows->store(hashers[i]->decodedVector(), rowIndex, newRow, i);
+  }
+  for (auto i = 0; i < partitionRows.size(); ++i) {
+    if (!partitionRows[i].empty()) {
+      spillRows(i, partitionRows[i]);
+    }
+  }
+}
+
+void HashBuild::spillRows(int32_t partition, std::vector<char*>& rows) {
+  // Write at most 1000 rows at a time.
+  constexpr int32_t kBatchSize = 1000;
+  auto container = table_->rows();
+  for (auto offset = 0; offset < rows.size(); offset += kBatchSize) {
+    auto numRows = std::min<int32_t>(kBatchSize, rows.size() - offset);
+    auto batch = std::static_pointer_cast<RowVector>(
+        BaseVector::create(spillType_, numRows, pool()));
+    for (auto i = 0; i < spillType_->size(); ++i) {
+      container->extractColumn(
+          rows.data() + offset, numRows, i, batch->childAt(i));
+    }
+    spillState_->appendToPartition(partition, batch);
+  }
+  container->eraseRows(folly::Range<char**>(rows.data(), rows.size()));
+}
+
+void HashBuild::spillInput(
+    const RowVectorPtr& input,
+    SelectivityVector& rows) {
+  auto numInput = input->size();
+  spillHashes_.resize(numInput);
+  for (auto i = 0; i < spillHashers_.size(); ++i) {
+    spillHashers_[i]->hash(
+        *input->childAt(spillHashers_[i]->channel())->loadedVector(),
+        rows,
+        i > 0,
+        spillHashes_);
+  }
+
+  std::vector<BufferPtr> indices(spillBits_.numPartitions());
+  std::vector<vector_size_t> numSpilled(spillBits_.numPartitions(), 0);
+  rows.applyToSelected([&](auto row) {
+    auto partition =
+        spillBits_.partition(spillHashes_[row], spillBits_.numPartitions());
+    if (!spilledPartitions_[partition]) {
+      return;
     }
-    for (auto i = 0; i < dependentChannels_.size(); ++i) {
-      rows->store(*decoders_[i], rowIndex, newRow, i + hashers.size());
+    if (!indices[partition]) {
+      indices[partition] = allocateIndices(numInput, pool());
     }
+    indices[partition]->asMutable<vector_size_t>()[numSpilled[partition]++] =
+        row;
+    rows.setValid(row, false);
   });
+  rows.updateBounds();
+
+  for (auto partition = 0; partition < indices.size(); ++partition) {
+    if (!numSpilled[partition]) {
+      continue;
+    }
+    std::vector<VectorPtr> children;
+    children.reserve(spillType_->size());
+    for (auto channel : keyChannels_) {
+      children.push_back(wrapChild(
+          numSpilled[partition],
+          indices[partition],
+          BaseVector::loadedVectorShared(input->childAt(channel))));
+    }
+    for (auto channel : dependentChannels_) {
+      children.push_back(wrapChild(
+          numSpilled[partition],
+          indices[partition],
+          BaseVector::loadedVectorShared(input->childAt(channel))));
+    }
+    spillState_->appendToPartition(
+        partition,
+        std::make_shared<RowVector>(
+            pool(),
+            spillType_,
+            BufferPtr(nullptr),
+            numSpilled[partition],
+            std::move(children)));
+  }
+}
+
+void HashBuild::collectSpillFiles(SpilledHashBuild& spill) {
+  if (!spillState_) {
+    return;
+  }
+  for (auto partition = 0; partition < spill.files.size(); ++partition) {
+    if (!spillState_->hasFiles(partition)) {
+      continue;
+    }
+    for (auto& file : spillState_->files(partition)) {
+      spill.files[partition].push_back(std::move(file));
+    }
+  }
 }
 
 void HashBuild::noMoreInput() {
@@ -205,11 +682,18 @@ void HashBuild::noMoreInput() {
           planNodeId(), operatorCtx_->driver(), &future_, promises, peers)) {
     return;
   }
+  // Lets another Task build the shared table if this fails.
+  SCOPE_FAIL {
+    abandonCachedTable();
+  };
 
   std::vector<std::unique_ptr<BaseHashTable>> otherTables;
   otherTables.reserve(peers.size());
+  std::shared_ptr<SpilledHashBuild> spill;
 
   if (!antiJoinHasNullKeys_) {
+    std::vector<HashBuild*> builds;
+    builds.reserve(peers.size());
     for (auto& peer : peers) {
       auto op = peer->findOperator(planNodeId());
       HashBuild* build = dynamic_cast<HashBuild*>(op);
@@ -218,7 +702,39 @@ void HashBuild::noMoreInput() {
         antiJoinHasNullKeys_ = true;
         break;
       }
-      otherTables.push_back(std::move(build->table_));
+      builds.push_back(build);
+    }
+
+    if (!antiJoinHasNullKeys_ && spillPath_.has_value()) {
+      // A partition spilled by any build is spilled by all so that the hash
+      // table has either all or none of the rows of a partition.
+      auto partitions = spilledPartitions_;
+      for (auto* build : builds) {
+        for (auto i = 0; i < partitions.size(); ++i) {
+          partitions[i] = partitions[i] || build->spilledPartitions_[i];
+        }
+      }
+      if (std::find(partitions.begin(), partitions.end(), true) !=
+          partitions.end()) {
+        spill = std::make_shared<SpilledHashBuild>(
+            spillBits_, spillType_, keyChannels_.size(), allowDuplicates_);
+        spillPartitions(partitions);
+        collectSpillFiles(*spill);
+        for (auto* build : builds) {
+          build->spillPartitions(partitions);
+          build->collectSpillFiles(*spill);
+        }
+        stats_.addRuntimeStat(
+            "spilledPartitions",
+            RuntimeCounter(
+                std::count(partitions.begin(), partitions.end(), true)));
+      }
+    }
+
+    if (!antiJoinHasNullKeys_) {
+      for (auto* build : builds) {
+        otherTables.push_back(std::move(build->table_));
+      }
     }
   }
 
@@ -230,20 +746,118 @@ void HashBuild::noMoreInput() {
   }
 
   if (antiJoinHasNullKeys_) {
+    if (cacheBuilder_) {
+      HashJoinTableCache::getInstance().put(
+          cacheKey_.value(), operatorCtx_->taskId(), {nullptr, true, {}}, 0);
+    }
     operatorCtx_->task()
         ->getHashJoinBridge(
             operatorCtx_->driverCtx()->splitGroupId, planNodeId())
         ->setAntiJoinHasNullKeys();
   } else {
-    table_->prepareJoinTable(std::move(otherTables));
+    std::vector<RowContainer*> containers{table_->rows()};
+    for (auto& other : otherTables) {
+      containers.push_back(other->rows());
+    }
+    // The peer drivers are finished, so the table is built in parallel on
+    // the driver executor.
+    table_->prepareJoinTable(
+        std::move(otherTables), operatorCtx_->task()->queryCtx()->executor());
 
     addRuntimeStats();
 
+    // Dynamic filters are not pushed down if the build side spilled.
+    auto keyBloomFilters = spill
+        ? std::vector<std::shared_ptr<common::Filter>>{}
+        : makeKeyBloomFilters(containers);
+
+    std::shared_ptr<BaseHashTable> table = std::move(table_);
+    if (cacheBuilder_) {
+      // The peer tables were merged into 'table' and their rows are owned
+      // by it.
+      int64_t bytes = table->allocatedBytes();
+      for (auto i = 1; i < containers.size(); ++i) {
+        bytes += containers[i]->allocatedBytes();
+      }
+      // The probe side uses the table through the cache's handle, so that
+      // the cache is told when the table is released.
+      table = HashJoinTableCache::getInstance()
+                  .put(
+                      cacheKey_.value(),
+                      operatorCtx_->taskId(),
+                      {table, false, keyBloomFilters},
+                      bytes)
+                  ->table;
+    }
     operatorCtx_->task()
         ->getHashJoinBridge(
             operatorCtx_->driverCtx()->splitGroupId, planNodeId())
-        ->setHashTable(std::move(table_));
+        ->setHashTable(
+            std::move(table), std::move(spill), std::move(keyBloomFilters));
+  }
+}
+
+void HashBuild::lookupCachedTable() {
+  auto lookup =
+      operatorCtx_->task()
+          ->getHashJoinBridge(
+              operatorCtx_->driverCtx()->splitGroupId, planNodeId())
+          ->lookupCachedTable(
+              cacheKey_.value(), operatorCtx_->taskId(), &future_);
+  switch (lookup) {
+    case HashJoinBridge::CacheLookup::kWait:
+      return;
+    case HashJoinBridge::CacheLookup::kBuild:
+      cacheBuilder_ = true;
+      return;
+    case HashJoinBridge::CacheLookup::kHit:
+      // Another Task built the table and the bridge hands it over to the
+      // probe side. All Drivers finish without reading their input.
+      Operator::noMoreInput();
+      stats_.addRuntimeStat("sharedTableHits", RuntimeCounter(1));
+      return;
+  }
+}
+
+void HashBuild::abandonCachedTable() {
+  if (cacheBuilder_) {
+    HashJoinTableCache::getInstance().abandon(
+        cacheKey_.value(), operatorCtx_->taskId());
+  }
+}
+
+std::vector<std::shared_ptr<common::Filter>> HashBuild::makeKeyBloomFilters(
+    const std::vector<RowContainer*>& containers) const {
+  std::vector<std::shared_ptr<common::Filter>> filters;
+  if (!isInnerJoin(joinType_) && !isLeftSemiJoin(joinType_)) {
+    return filters;
   }
+  const auto& hashers = table_->hashers();
+  filters.resize(hashers.size());
+  for (auto i = 0; i < hashers.size(); ++i) {
+    if (table_->hashMode() != BaseHashTable::HashMode::kHash &&
+        !hashers[i]->distinctOverflow()) {
+      // HashProbe makes an exact filter from the distinct values.
+      continue;
+    }
+    switch (hashers[i]->typeKind()) {
+      case TypeKind::TINYINT:
+        filters[i] = makeKeyBloomFilter<int8_t>(containers, i);
+        break;
+      case TypeKind::SMALLINT:
+        filters[i] = makeKeyBloomFilter<int16_t>(containers, i);
+        break;
+      case TypeKind::INTEGER:
+        filters[i] = makeKeyBloomFilter<int32_t>(containers, i);
+        break;
+      case TypeKind::BIGINT:
+        filters[i] = makeKeyBloomFilter<int64_t>(containers, i);
+        break;
+      default:
+        break;
+    }
+  }
+  return filters;
 }
 
 void HashBuild::addRuntimeStats() {
@@ -265,6 +879,12 @@ void HashBuild::addRuntimeStats() {
 }
 
 BlockingReason HashBuild::isBlocked(ContinueFuture* future) {
+  // Looks up the shared table before reading any input and again after
+  // waiting for another Task to build it.
+  if (cacheKey_.has_value() && !cacheBuilder_ && !noMoreInput_ &&
+      !future_.valid()) {
+    lookupCachedTable();
+  }
   if (!future_.valid()) {
     return BlockingReason::kNotBlocked;
   }
@@ -276,4 +896,13 @@ bool HashBuild::isFinished() {
   return !future_.valid() && noMoreInput_;
 }
 
+void HashBuild::close() {
+  // A Driver that did not get to the end of its input gives up the shared
+  // table, e.g. after an error, so that another Task builds it. Once all
+  // Drivers got to the end, the last one puts the table in the cache.
+  if (!noMoreInput_) {
+    abandonCachedTable();
+  }
+}
+
 } // namespace facebook::velox::exec
@@ -15,21 +15,82 @@
  */
 #pragma once
 
+#include "velox/exec/HashJoinTableCache.h"
 #include "velox/exec/HashTable.h"
 #include "velox/exec/JoinBridge.h"
 #include "velox/exec/Operator.h"
+#include "velox/exec/Spill.h"
+#include "velox/exec/Spiller.h"
 #include "velox/exec/VectorHasher.h"
 #include "velox/expression/Expr.h"
 
 namespace facebook::velox::exec {
 
+// Build side rows of a hash join that did not fit in memory. The rows are
+// partitioned on 'bits' of the hash number of the join keys. The build side
+// rows of a spilled partition are not in the hash table. HashProbe spills the
+// probe side rows of these partitions and joins each spilled partition after
+// all probe input has been processed, see SpilledJoinPartition.
+struct SpilledHashBuild {
+  SpilledHashBuild(
+      HashBitRange _bits,
+      RowTypePtr _type,
+      int32_t _numKeys,
+      bool _allowDuplicates)
+      : bits(_bits),
+        type(std::move(_type)),
+        numKeys(_numKeys),
+        allowDuplicates(_allowDuplicates),
+        files(bits.numPartitions()) {}
+
+  bool isSpilled(int32_t partition) const {
+    return !files[partition].empty();
+  }
+
+  const HashBitRange bits;
+
+  // Type of the spilled rows. Keys first, then dependent columns, like the
+  // rows of the hash table.
+  const RowTypePtr type;
+
+  // Number of leading key columns in 'type'.
+  const int32_t numKeys;
+
+  // Same as the allowDuplicates flag of the hash table.
+  const bool allowDuplicates;
+
+  // Spill files for each partition of 'bits'. Empty for partitions that are
+  // not spilled.
+  std::vector<std::vector<std::unique_ptr<SpillFile>>> files;
+};
+
+// The spilled build and probe side rows of a hash join whose join keys hash
+// to the same partition. Joined by one HashProbe. A partition whose build
+// side does not fit in memory is split on the hash bits from 'startBit' up.
+struct SpilledJoinPartition {
+  // The lowest hash bit that is not the same for all the rows of 'this'. 64
+  // if 'this' may not be split further.
+  uint8_t startBit;
+
+  std::vector<std::unique_ptr<SpillFile>> buildFiles;
+
+  std::vector<std::unique_ptr<SpillFile>> probeFiles;
+};
+
 // Hands over a hash table from a multi-threaded build pipeline to a
 // multi-threaded probe pipeline. This is owned by shared_ptr by all the build
 // and probe Operator instances concerned. Corresponds to the Presto concept of
 // the same name.
 class HashJoinBridge : public JoinBridge {
  public:
-  void setHashTable(std::unique_ptr<BaseHashTable> table);
+  // Sets the hash table, which may be shared with other Tasks through
+  // HashJoinTableCache. 'spill' is non-null if some partitions of the build
+  // side were spilled and are not in 'table'. 'keyBloomFilters' has an
+  // approximate filter for each join key, nullptr for keys without one.
+  void setHashTable(
+      std::shared_ptr<BaseHashTable> table,
+      std::shared_ptr<SpilledHashBuild> spill = nullptr,
+      std::vector<std::shared_ptr<common::Filter>> keyBloomFilters = {});
 
   void setAntiJoinHasNullKeys();
 
@@ -40,15 +101,95 @@ class HashJoinBridge : public JoinBridge {
   struct HashBuildResult {
     std::shared_ptr<BaseHashTable> table;
     bool antiJoinHasNullKeys;
+    std::shared_ptr<SpilledHashBuild> spill;
+    // Bloom filters over the values of the join keys that have too many
+    // distinct values for an exact filter. Used as dynamic filters for the
+    // probe side. Empty or nullptr for a key if there is no filter.
+    std::vector<std::shared_ptr<common::Filter>> keyBloomFilters;
   };
 
   std::optional<HashBuildResult> tableOrFuture(ContinueFuture* future);
 
+  // The outcome of looking up the build side in HashJoinTableCache. Decided
+  // once per Task and split group so that all HashBuild Drivers follow it.
+  enum class CacheLookup {
+    // Another Task builds the table. Look up again when the future is
+    // realized.
+    kWait,
+    // This Task builds the table.
+    kBuild,
+    // The table is in the cache and is set as the result of 'this'.
+    kHit,
+  };
+
+  // Looks up 'key' in HashJoinTableCache on behalf of 'taskId' unless
+  // already decided by another Driver. On a hit, sets the cached table as
+  // the result of 'this' and keeps the cache entry until 'this' is
+  // destroyed. Sets 'future' if returning kWait.
+  CacheLookup lookupCachedTable(
+      const std::string& key,
+      const std::string& taskId,
+      ContinueFuture* future);
+
+  // Adds the spill files of probe side rows from one HashProbe. 'files' has
+  // an entry for each partition of the spilled build side.
+  void addSpilledProbeFiles(
+      std::vector<std::vector<std::unique_ptr<SpillFile>>> files);
+
+  // Makes a SpilledJoinPartition for each spilled build side partition with
+  // probe side rows. Called by the last HashProbe to add its files.
+  void startSpilledPartitions();
+
+  // Returns the next spilled partition to join. Returns nullptr and sets
+  // 'future' if there is none but the partitions taken by other HashProbes
+  // may still be split. Returns nullptr without setting 'future' if all
+  // partitions are taken. The caller must call finishSpilledPartition()
+  // for the returned partition.
+  std::unique_ptr<SpilledJoinPartition> nextSpilledPartition(
+      ContinueFuture* future);
+
+  // Adds 'splits', the partitions that a partition returned by
+  // nextSpilledPartition() was split into. Called with empty 'splits' if the
+  // partition is joined as is. Continues the HashProbes waiting for more
+  // partitions.
+  void finishSpilledPartition(
+      std::vector<std::unique_ptr<SpilledJoinPartition>> splits);
+
  private:
   std::shared_ptr<BaseHashTable> table_;
   bool antiJoinHasNullKeys_{false};
+  std::shared_ptr<SpilledHashBuild> spill_;
+  std::vector<std::shared_ptr<common::Filter>> keyBloomFilters_;
+  std::vector<std::vector<std::unique_ptr<SpillFile>>> spilledProbeFiles_;
+
+  // Spilled partitions not yet taken by a HashProbe.
+  std::vector<std::unique_ptr<SpilledJoinPartition>> spilledPartitions_;
+
+  // Number of partitions taken by HashProbes and not yet finished with
+  // finishSpilledPartition().
+  int32_t numSplittingPartitions_{0};
+
+  // Set once the cache lookup is decided. kWait until then.
+  CacheLookup cacheLookup_{CacheLookup::kWait};
+  std::shared_ptr<const HashJoinTableCache::Entry> cachedEntry_;
 };
 
+// Adds 'rows' of 'input' to 'table'. The keys are read from the channels of
+// the table's hashers and the dependent columns from 'dependentChannels'
+// using 'decoders'. While 'analyzeKeys' is true, the keys are run through the
+// hashers to find out if array or normalized key hash modes are possible.
+// 'analyzeKeys' is set to false when this is no longer the case. 'hashes' is
+// scratch space. Used by HashBuild and by HashProbe when rebuilding a spilled
+// partition.
+void addJoinBuildRows(
+    BaseHashTable& table,
+    const RowVector& input,
+    const SelectivityVector& rows,
+    const std::vector<column_index_t>& dependentChannels,
+    std::vector<std::unique_ptr<DecodedVector>>& decoders,
+    bool& analyzeKeys,
+    raw_vector<uint64_t>& hashes);
+
 // Builds a hash table for use in HashProbe. This is the final
 // Operator in a build side Driver. The build side pipeline has
 // multiple Drivers, each with its own HashBuild. The build finishes
@@ -58,6 +199,18 @@ class HashJoinBridge : public JoinBridge {
 // table. This table is then passed to the probe side pipeline via
 // JoinBridge. After this, all build side Drivers finish and free
 // their state.
+//
+// If a spill path is set in the query config, the build side spills when the
+// rows do not fit in memory. The rows are partitioned on the hash number of
+// the keys and whole partitions are written to disk. Input rows for a spilled
+// partition are written to disk as they arrive. The last Driver spills the
+// same partitions from the peers' tables so that the hash table only
+// contains unspilled partitions. Right and full joins do not spill.
+//
+// If the join node has a build cache id, the table is shared with other Tasks
+// through HashJoinTableCache. The first Task builds it and the others
+// finish without reading their input once it is built. Shared tables do not
+// spill.
 class HashBuild final : public Operator {
  public:
   HashBuild(
@@ -81,13 +234,64 @@ class HashBuild final : public Operator {
 
   bool isFinished() override;
 
-  void close() override {}
+  void close() override;
 
  private:
   void addRuntimeStats();
 
+  // Looks up the shared table in HashJoinTableCache through the
+  // HashJoinBridge, which decides for all Drivers of the Task. Finishes if
+  // the table is built, in which case the bridge hands it over to the probe
+  // side. Sets 'future_' if another Task is building it. Otherwise, this
+  // Task builds it.
+  void lookupCachedTable();
+
+  // Gives up building the shared table if this Task is its builder.
+  void abandonCachedTable();
+
+  // Makes Bloom filters for the integer join keys of an inner or semi join for
+  // which the hashers of 'table_' cannot make an exact filter. 'containers'
+  // are the RowContainers of 'table_' and the tables merged into it.
+  std::vector<std::shared_ptr<common::Filter>> makeKeyBloomFilters(
+      const std::vector<RowContainer*>& containers) const;
+
+  // Checks that there is memory for adding 'input' to 'table_'. Spills
+  // partitions of 'table_' if the reservation cannot be increased.
+  void ensureInputFits(const RowVectorPtr& input);
+
+  // Spills the largest unspilled partitions of 'table_' until at least
+  // 'targetBytes' of rows have been written to disk or all partitions are
+  // spilled.
+  void spill(int64_t targetBytes);
+
+  // Marks 'partitions' as spilled and writes the rows of these partitions in
+  // 'table_' to disk.
+  void spillPartitions(const std::vector<bool>& partitions);
+
+  // Writes the rows of 'rows' that fall in spilled partitions to disk and
+  // removes them from 'rows'.
+  void spillInput(const RowVectorPtr& input, SelectivityVector& rows);
+
+  // Writes 'rows' of 'table_' to 'partition' and erases them from 'table_'.
+  void spillRows(int32_t partition, std::vector<char*>& rows);
+
+  // Sets 'spillHashes_' for 'rows' of 'table_'.
+  void hashRows(folly::Range<char**> rows);
+
+  void ensureSpillState();
+
+  // Moves the spill files of 'this' to 'spill'.
+  void collectSpillFiles(SpilledHashBuild& spill);
+
   const core::JoinType joinType_;
 
+  // Key of the table in HashJoinTableCache. Not set if the table is not
+  // shared with other Tasks.
+  const std::optional<std::string> cacheKey_;
+
+  // True if this Task builds the shared table for 'cacheKey_'.
+  bool cacheBuilder_{false};
+
   // Container for the rows being accumulated.
   std::unique_ptr<BaseHashTable> table_;
 
@@ -120,6 +324,40 @@ class HashBuild final : public Operator {
   // True if this is a build side of an anti join and has at least one entry
   // with null join keys.
   bool antiJoinHasNullKeys_{false};
+
+  // True if duplicate keys are stored in 'table_'.
+  bool allowDuplicates_;
+
+  // Path prefix for spill files. Not set if spilling is disabled.
+  const std::optional<std::string> spillPath_;
+
+  // Codec for compressing the spill files. NO_COMPRESSION if spilling is
+  // disabled.
+  const folly::io::CodecType spillCompression_;
+
+  // Local spill bytes of the process above which spill files go to the
+  // overflow tier of 'spillPath_'. 0 means no quota.
+  const uint64_t spillLocalQuotaBytes_;
+
+  const int32_t testSpillPct_;
+
+  uint64_t spillTestCounter_{0};
+
+  // Spills up to 4 partitions based on bits 29 and 30 of the hash number.
+  const HashBitRange spillBits_{29, 31};
+
+  // Type of spilled rows. Keys first, then dependent columns.
+  RowTypePtr spillType_;
+
+  std::unique_ptr<SpillState> spillState_;
+
+  // True for partitions that are spilled.
+  std::vector<bool> spilledPartitions_;
+
+  // Hashers for computing the spill partition of input rows.
+  std::vector<std::unique_ptr<VectorHasher>> spillHashers_;
+
+  raw_vector<uint64_t> spillHashes_;
 };
 
 } // namespace facebook::velox::exec
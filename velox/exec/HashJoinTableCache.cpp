@@ -0,0 +1,192 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#include "velox/exec/HashJoinTableCache.h"
+
+namespace facebook::velox::exec {
+
+HashJoinTableCache::HashJoinTableCache(uint64_t maxBytes)
+    : maxBytes_(maxBytes),
+      tracker_(memory::MemoryUsageTracker::create()),
+      mappedMemory_(memory::MappedMemory::getInstance()->addChild(tracker_)) {}
+
+// static
+HashJoinTableCache& HashJoinTableCache::getInstance() {
+  static HashJoinTableCache instance;
+  return instance;
+}
+
+// static
+std::optional<std::string> HashJoinTableCache::makeKey(
+    const core::HashJoinNode& joinNode,
+    uint32_t splitGroupId) {
+  if (!joinNode.buildCacheId().has_value() || joinNode.isRightJoin() ||
+      joinNode.isFullJoin()) {
+    return std::nullopt;
+  }
+  std::stringstream out;
+  out << joinNode.buildCacheId().value() << "\n"
+      << core::joinTypeName(joinNode.joinType());
+  for (const auto& key : joinNode.rightKeys()) {
+    out << " " << key->name();
+  }
+  // Semi and anti join tables without a filter have only the keys.
+  if (joinNode.filter()) {
+    out << " filter: " << joinNode.filter()->toString();
+  }
+  out << "\n" << splitGroupId << "\n"
+      << joinNode.sources()[1]->toString(true, true);
+  return out.str();
+}
+
+std::shared_ptr<const HashJoinTableCache::Entry> HashJoinTableCache::get(
+    const std::string& key,
+    const std::string& taskId,
+    ContinueFuture* future) {
+  std::lock_guard<std::mutex> l(mutex_);
+  auto it = entries_.find(key);
+  if (it == entries_.end()) {
+    ++numMisses_;
+    entries_[key].builderTaskId = taskId;
+    return nullptr;
+  }
+  auto& cacheEntry = it->second;
+  if (cacheEntry.entry) {
+    ++numHits_;
+    lru_.splice(lru_.begin(), lru_, cacheEntry.lruPosition);
+    return makeHandle(cacheEntry.entry);
+  }
+  if (cacheEntry.builderTaskId != taskId) {
+    cacheEntry.promises.emplace_back("HashJoinTableCache::get");
+    *future = cacheEntry.promises.back().getSemiFuture();
+  }
+  return nullptr;
+}
+
+std::shared_ptr<const HashJoinTableCache::Entry> HashJoinTableCache::put(
+    const std::string& key,
+    const std::string& taskId,
+    Entry entry,
+    uint64_t bytes) {
+  std::vector<ContinuePromise> promises;
+  std::shared_ptr<const Entry> handle;
+  {
+    std::lock_guard<std::mutex> l(mutex_);
+    auto it = entries_.find(key);
+    VELOX_CHECK(
+        it != entries_.end() && !it->second.entry &&
+            it->second.builderTaskId == taskId,
+        "Hash join table is not being built by Task {}",
+        taskId);
+    auto& cacheEntry = it->second;
+    cacheEntry.entry = std::make_shared<const Entry>(std::move(entry));
+    cacheEntry.builderTaskId.clear();
+    cacheEntry.bytes = bytes;
+    lru_.push_front(key);
+    cacheEntry.lruPosition = lru_.begin();
+    bytes_ += bytes;
+    promises = std::move(cacheEntry.promises);
+    handle = makeHandle(cacheEntry.entry);
+    evictLocked();
+  }
+  for (auto& promise : promises) {
+    promise.setValue();
+  }
+  return handle;
+}
+
+std::shared_ptr<const HashJoinTableCache::Entry> HashJoinTableCache::makeHandle(
+    const std::shared_ptr<const Entry>& entry) {
+  auto handle = std::make_shared<Entry>(*entry);
+  if (entry->table) {
+    // The deleter runs when the Task releases its last reference to the
+    // table. The entry is unreferenced first so that it may be evicted.
+    std::shared_ptr<void> release(
+        nullptr, [this, entry](void* /*unused*/) mutable {
+          entry.reset();
+          evict();
+        });
+    handle->table =
+        std::shared_ptr<BaseHashTable>(release, entry->table.get());
+  }
+  return handle;
+}
+
+void HashJoinTableCache::abandon(
+    const std::string& key,
+    const std::string& taskId) {
+  std::vector<ContinuePromise> promises;
+  {
+    std::lock_guard<std::mutex> l(mutex_);
+    auto it = entries_.find(key);
+    if (it == entries_.end() || it->second.entry ||
+        it->second.builderTaskId != taskId) {
+      return;
+    }
+    promises = std::move(it->second.promises);
+    entries_.erase(it);
+  }
+  for (auto& promise : promises) {
+    promise.setValue();
+  }
+}
+
+void HashJoinTableCache::evict() {
+  std::lock_guard<std::mutex> l(mutex_);
+  evictLocked();
+}
+
+void HashJoinTableCache::evictLocked() {
+  auto it = lru_.end();
+  while (bytes_ > maxBytes_ && it != lru_.begin()) {
+    --it;
+    auto entryIt = entries_.find(*it);
+    VELOX_CHECK(entryIt != entries_.end());
+    const auto& entry = entryIt->second.entry;
+    if (entry.use_count() > 1 ||
+        (entry->table && entry->table.use_count() > 1)) {
+      // A Task is using the table.
+      continue;
+    }
+    bytes_ -= entryIt->second.bytes;
+    entries_.erase(entryIt);
+    it = lru_.erase(it);
+    ++numEvictions_;
+  }
+}
+
+HashJoinTableCache::Stats HashJoinTableCache::stats() const {
+  std::lock_guard<std::mutex> l(mutex_);
+  Stats stats;
+  stats.numHits = numHits_;
+  stats.numMisses = numMisses_;
+  stats.numEntries = lru_.size();
+  stats.numEvictions = numEvictions_;
+  stats.bytes = bytes_;
+  return stats;
+}
+
+void HashJoinTableCache::clear() {
+  std::lock_guard<std::mutex> l(mutex_);
+  for (const auto& key : lru_) {
+    entries_.erase(key);
+  }
+  lru_.clear();
+  bytes_ = 0;
+}
+
+} // namespace facebook::velox::exec
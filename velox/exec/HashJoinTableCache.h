@@ -0,0 +1,160 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#pragma once
+
+#include <folly/container/F14Map.h>
+#include <list>
+#include <mutex>
+#include <optional>
+
+#include "velox/common/future/VeloxPromise.h"
+#include "velox/common/memory/MappedMemory.h"
+#include "velox/core/PlanNode.h"
+#include "velox/exec/HashTable.h"
+#include "velox/type/Filter.h"
+
+namespace facebook::velox::exec {
+
+/// Shares the hash tables of hash join build sides between Tasks of the same
+/// or different queries. The build side of a HashJoinNode with a build cache
+/// id is cached under a key made of the id, the join type and keys and the
+/// detailed text of the build side plan fragment. The first Task to look up a
+/// key builds the table and puts it in the cache. Tasks that look up the key
+/// while it is being built wait and then attach to the same table instead of
+/// reading and building their own build side. If the building Task fails, a
+/// waiting Task builds the table instead.
+///
+/// The tables are allocated from 'mappedMemory()', so that their memory is
+/// accounted in the MemoryUsageTracker of the cache instead of that of the
+/// Task that built them, which they outlive. Tables are reference counted.
+/// The least recently used entries that no Task uses are dropped to stay
+/// under 'maxBytes'. This is checked when a table is added and when the last
+/// Task releases a table. Thread safe.
+class HashJoinTableCache {
+ public:
+  /// A built table and what a HashProbe needs besides the table.
+  struct Entry {
+    /// nullptr if 'antiJoinHasNullKeys' is true.
+    std::shared_ptr<BaseHashTable> table;
+    bool antiJoinHasNullKeys{false};
+    std::vector<std::shared_ptr<common::Filter>> keyBloomFilters;
+  };
+
+  struct Stats {
+    int64_t numHits{0};
+    int64_t numMisses{0};
+    int64_t numEntries{0};
+    int64_t numEvictions{0};
+    uint64_t bytes{0};
+  };
+
+  static constexpr uint64_t kDefaultMaxBytes = 1UL << 30;
+
+  explicit HashJoinTableCache(uint64_t maxBytes = kDefaultMaxBytes);
+
+  /// Returns the process-wide cache used by HashBuild.
+  static HashJoinTableCache& getInstance();
+
+  /// Returns the key for the build side of 'joinNode' in split group
+  /// 'splitGroupId' or std::nullopt if the table is not to be shared. Right
+  /// and full join tables are not shared since their probes mark the rows
+  /// they hit.
+  static std::optional<std::string> makeKey(
+      const core::HashJoinNode& joinNode,
+      uint32_t splitGroupId);
+
+  /// Returns the entry for 'key' if the table is built. Otherwise returns
+  /// nullptr and if no Task builds the table, makes 'taskId' its builder. If
+  /// another Task builds the table, sets 'future' to be realized when that
+  /// Task puts or abandons it. 'future' is not set for the builder. The
+  /// returned entry and the copies of its 'table' keep the table in the
+  /// cache. Releasing the last of them checks if entries are to be dropped.
+  std::shared_ptr<const Entry> get(
+      const std::string& key,
+      const std::string& taskId,
+      ContinueFuture* future);
+
+  /// Caches 'entry' under 'key'. 'taskId' must be the builder of 'key'.
+  /// 'bytes' is the memory of the table. Wakes up the Tasks waiting for the
+  /// table. Returns the entry for the builder to use, as from get().
+  std::shared_ptr<const Entry> put(
+      const std::string& key,
+      const std::string& taskId,
+      Entry entry,
+      uint64_t bytes);
+
+  /// Gives up building 'key' by 'taskId', e.g. after an error. The waiting
+  /// Tasks look up 'key' again. No-op if the table is built or if 'taskId'
+  /// is not its builder.
+  void abandon(const std::string& key, const std::string& taskId);
+
+  /// Returns the memory for allocating the tables to cache.
+  memory::MappedMemory* mappedMemory() const {
+    return mappedMemory_.get();
+  }
+
+  /// Tracks the memory of the cached tables and of the tables being built.
+  const std::shared_ptr<memory::MemoryUsageTracker>& tracker() const {
+    return tracker_;
+  }
+
+  Stats stats() const;
+
+  /// Drops the built tables. Tasks that use them keep them until they
+  /// finish.
+  void clear();
+
+ private:
+  struct CacheEntry {
+    // Set when the table is built.
+    std::shared_ptr<const Entry> entry;
+    // The Task that builds the table. Empty once the table is built.
+    std::string builderTaskId;
+    // Wake up the Tasks waiting for the table.
+    std::vector<ContinuePromise> promises;
+    uint64_t bytes{0};
+    std::list<std::string>::iterator lruPosition;
+  };
+
+  // Returns a copy of 'entry' for a Task. The 'table' of the copy keeps
+  // 'entry' referenced and calls evict() when the Task's last reference to
+  // the table is released.
+  std::shared_ptr<const Entry> makeHandle(
+      const std::shared_ptr<const Entry>& entry);
+
+  // Drops the least recently used tables that are not used by any Task
+  // until 'bytes_' is at most 'maxBytes_'.
+  void evict();
+
+  void evictLocked();
+
+  const uint64_t maxBytes_;
+  const std::shared_ptr<memory::MemoryUsageTracker> tracker_;
+  const std::shared_ptr<memory::MappedMemory> mappedMemory_;
+
+  mutable std::mutex mutex_;
+  folly::F14FastMap<std::string, CacheEntry> entries_;
+  // Keys of the built tables, most recently used first.
+  std::list<std::string> lru_;
+  uint64_t bytes_{0};
+  int64_t numHits_{0};
+  int64_t numMisses_{0};
+  int64_t numEvictions_{0};
+};
+
+} // namespace facebook::velox::exec
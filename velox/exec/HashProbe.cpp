@@ -61,9 +61,11 @@ HashProbe::HashProbe(
           joinNode->id(),
           "HashProbe"),
       outputBatchSize_{driverCtx->queryConfig().preferredOutputBatchSize()},
+      outputBatchBytes_{driverCtx->queryConfig().preferredOutputBatchBytes()},
       joinType_{joinNode->joinType()},
       filterResult_(1),
-      outputRows_(outputBatchSize_) {
+      outputRows_(outputBatchSize_),
+      testSpillPct_(driverCtx->queryConfig().testingSpillPct()) {
   auto probeType = joinNode->sources()[0]->outputType();
   auto numKeys = joinNode->leftKeys().size();
   keyChannels_.reserve(numKeys);
@@ -93,7 +95,12 @@ HashProbe::HashProbe(
     }
   }
 
-  for (column_index_t i = 0; i < outputType_->size(); ++i) {
+  // Semi and anti joins output only probe side columns. Without a filter,
+  // the table of these has no dependent columns.
+  for (column_index_t i = 0;
+       !isLeftSemiJoin(joinType_) && !isAntiJoin(joinType_) &&
+       i < outputType_->size();
+       ++i) {
     auto tableChannel = tableType->getChildIdxIfExists(outputType_->nameOf(i));
     if (tableChannel.has_value()) {
       tableResultProjections_.emplace_back(tableChannel.value(), i);
@@ -146,6 +153,10 @@ void HashProbe::initializeFilter(
 }
 
 BlockingReason HashProbe::isBlocked(ContinueFuture* future) {
+  if (future_.valid()) {
+    *future = std::move(future_);
+    return BlockingReason::kWaitForPeers;
+  }
   if (table_) {
     return BlockingReason::kNotBlocked;
   }
@@ -165,7 +176,8 @@ BlockingReason HashProbe::isBlocked(ContinueFuture* future) {
     finished_ = true;
   } else {
     table_ = hashBuildResult->table;
-    if (table_->numDistinct() == 0) {
+    spilledBuild_ = hashBuildResult->spill;
+    if (!hasBuildSide()) {
       // Build side is empty. Inner, right and semi joins return nothing in this
       // case, hence, we can terminate the pipeline early.
       if (isInnerJoin(joinType_) || isLeftSemiJoin(joinType_) ||
@@ -173,17 +185,31 @@ BlockingReason HashProbe::isBlocked(ContinueFuture* future) {
         finished_ = true;
       }
     } else if (
+        !spilledBuild_ &&
         (isInnerJoin(joinType_) || isLeftSemiJoin(joinType_)) &&
-        table_->hashMode() != BaseHashTable::HashMode::kHash) {
+        (table_->hashMode() != BaseHashTable::HashMode::kHash ||
+         !hashBuildResult->keyBloomFilters.empty())) {
+      // Filters are not pushed down if the build side spilled since the
+      // hash table does not have all the keys.
       // Find out whether there are any upstream operators that can accept
       // dynamic filters on all or a subset of the join keys. Create dynamic
-      // filters to push down.
+      // filters to push down. Keys with too many distinct values for an exact
+      // filter get the Bloom filter made by HashBuild.
       const auto& buildHashers = table_->hashers();
+      const auto& bloomFilters = hashBuildResult->keyBloomFilters;
       auto channels = operatorCtx_->driverCtx()->driver->canPushdownFilters(
           this, keyChannels_);
       for (auto i = 0; i < keyChannels_.size(); i++) {
         if (channels.find(keyChannels_[i]) != channels.end()) {
-          if (auto filter = buildHashers[i]->getFilter(false)) {
+          std::shared_ptr<common::Filter> filter;
+          if (table_->hashMode() != BaseHashTable::HashMode::kHash) {
+            filter = buildHashers[i]->getFilter(false);
+          }
+          if (!filter && i < bloomFilters.size() && bloomFilters[i]) {
+            filter = bloomFilters[i];
+            hasBloomDynamicFilter_ = true;
+          }
+          if (filter) {
             dynamicFilters_.emplace(keyChannels_[i], std::move(filter));
           }
         }
@@ -198,8 +224,10 @@ void HashProbe::clearDynamicFilters() {
   // The join can be completely replaced with a pushed down
   // filter when the following conditions are met:
   //  * hash table has a single key with unique values,
-  //  * build side has no dependent columns.
-  if (keyChannels_.size() == 1 && !table_->hasDuplicateKeys() &&
+  //  * build side has no dependent columns,
+  //  * the filter is exact, i.e. not a Bloom filter.
+  if (keyChannels_.size() == 1 && !hasBloomDynamicFilter_ &&
+      !table_->hasDuplicateKeys() &&
       tableResultProjections_.empty() && !filter_ && !dynamicFilters_.empty()) {
     canReplaceWithDynamicFilter_ = true;
   }
@@ -215,7 +243,14 @@ void HashProbe::addInput(RowVectorPtr input) {
     return;
   }
 
-  if (table_->numDistinct() == 0) {
+  if (spilledBuild_ && !restoreSpill_) {
+    spillInput();
+    if (!input_) {
+      return;
+    }
+  }
+
+  if (!hasBuildSide()) {
     // Build side is empty. This state is valid only for anti, left and full
     // joins.
     VELOX_CHECK(
@@ -224,6 +259,14 @@ void HashProbe::addInput(RowVectorPtr input) {
     return;
   }
 
+  const bool emptyTable = table_->numDistinct() == 0;
+  if (emptyTable && (isInnerJoin(joinType_) || isLeftSemiJoin(joinType_))) {
+    // All build side rows are spilled. The remaining probe rows are in
+    // partitions that have no build side rows.
+    input_ = nullptr;
+    return;
+  }
+
   nonNullRows_.resize(input_->size());
   nonNullRows_.setAll();
   deselectRowsWithNulls(
@@ -233,11 +276,14 @@ void HashProbe::addInput(RowVectorPtr input) {
   lookup_->hashes.resize(input_->size());
   auto mode = table_->hashMode();
   auto& buildHashers = table_->hashers();
-  for (auto i = 0; i < keyChannels_.size(); ++i) {
+  for (auto i = 0; !emptyTable && i < keyChannels_.size(); ++i) {
     auto key = input_->childAt(keyChannels_[i])->loadedVector();
     if (mode != BaseHashTable::HashMode::kHash) {
       buildHashers[i]->lookupValueIds(
-          *key, activeRows_, scratchMemory_, lookup_->hashes);
+          *key,
+          activeRows_,
+          scratchMemory_,
+          table_->valueIds(*lookup_, i));
     } else {
       hashers_[i]->hash(*key, activeRows_, i > 0, lookup_->hashes);
     }
@@ -264,7 +310,7 @@ void HashProbe::addInput(RowVectorPtr input) {
     auto& hits = lookup_->hits;
     hits.resize(numInput);
     std::fill(hits.data(), hits.data() + numInput, nullptr);
-    if (!lookup_->rows.empty()) {
+    if (!lookup_->rows.empty() && !emptyTable) {
       table_->joinProbe(*lookup_);
     }
 
@@ -287,19 +333,20 @@ void HashProbe::addInput(RowVectorPtr input) {
 
 namespace {
 // Copy values from 'rows' of 'table' according to 'projections' in
-// 'result'. Reuses 'result' children where possible.
+// 'result'. Reuses 'result' children where possible. Otherwise takes recycled
+// vectors from the pool of 'execCtx'.
 void extractColumns(
     BaseHashTable* table,
     folly::Range<char**> rows,
     folly::Range<const IdentityProjection*> projections,
-    memory::MemoryPool* pool,
+    core::ExecCtx* execCtx,
     const RowVectorPtr& result) {
   for (auto projection : projections) {
     auto& child = result->childAt(projection.outputChannel);
     // TODO: Consider reuse of complex types.
     if (!child || !BaseVector::isReusableFlatVector(child)) {
-      child = BaseVector::create(
-          result->type()->childAt(projection.outputChannel), rows.size(), pool);
+      child = execCtx->getVector(
+          result->type()->childAt(projection.outputChannel), rows.size());
     }
     child->resize(rows.size());
     table->rows()->extractColumn(
@@ -334,6 +381,19 @@ void HashProbe::prepareOutput(vector_size_t size) {
   }
 }
 
+vector_size_t HashProbe::maxOutputRows() const {
+  // The probe side columns of the output are dictionaries over 'input_'.
+  // They keep all of 'input_' alive and are this wide once flattened.
+  uint64_t probeBytes = 0;
+  for (const auto& projection : identityProjections_) {
+    probeBytes += input_->childAt(projection.inputChannel)->estimateFlatSize();
+  }
+  const uint64_t bytesPerRow =
+      std::max<uint64_t>(1, probeBytes / std::max(1, input_->size()));
+  return std::clamp<uint64_t>(
+      outputBatchBytes_ / 2 / bytesPerRow, 1, outputBatchSize_);
+}
+
 void HashProbe::fillOutput(vector_size_t size) {
   prepareOutput(size);
 
@@ -351,7 +411,7 @@ void HashProbe::fillOutput(vector_size_t size) {
       table_.get(),
       folly::Range<char**>(outputRows_.data(), size),
       tableResultProjections_,
-      pool(),
+      operatorCtx_->execCtx(),
       output_);
 }
 
@@ -382,7 +442,7 @@ RowVectorPtr HashProbe::getNonMatchingOutputForRightJoin() {
       table_.get(),
       folly::Range<char**>(outputRows_.data(), numOut),
       tableResultProjections_,
-      pool(),
+      operatorCtx_->execCtx(),
       output_);
   return output_;
 }
@@ -398,6 +458,14 @@ void HashProbe::clearIdentityProjectedOutput() {
 
 RowVectorPtr HashProbe::getOutput() {
   clearIdentityProjectedOutput();
+  if (!input_ && restoreSpill_ && !future_.valid()) {
+    nextSpilledInput();
+  }
+  if (future_.valid()) {
+    // Waits for the other HashProbes to finish their input or to split their
+    // spilled partitions.
+    return nullptr;
+  }
   if (!input_) {
     if (noMoreInput_ && (isRightJoin(joinType_) || isFullJoin(joinType_))) {
       auto output = getNonMatchingOutputForRightJoin();
@@ -425,7 +493,7 @@ RowVectorPtr HashProbe::getOutput() {
   const bool isLeftSemiOrAntiJoinNoFilter = !filter_ &&
       (core::isLeftSemiJoin(joinType_) || core::isAntiJoin(joinType_));
 
-  const bool emptyBuildSide = (table_->numDistinct() == 0);
+  const bool emptyBuildSide = !hasBuildSide();
 
   // Left semi and anti joins are always cardinality reducing, e.g. for a given
   // row of input they produce zero or 1 row of output. Therefore, if there is
@@ -455,13 +523,26 @@ RowVectorPtr HashProbe::getOutput() {
           ++numOut;
         }
       }
+    } else if (isLeftSemiJoin(joinType_) && !filter_) {
+      // Left semi join without a filter returns probe rows with a match. The
+      // table has no duplicate keys and no dependent columns, so there is
+      // nothing to list from it.
+      for (auto row : lookup_->rows) {
+        if (lookup_->hits[row]) {
+          mapping[numOut] = row;
+          ++numOut;
+        }
+      }
     } else {
+      // A key with many matches produces several batches. The listing
+      // resumes where the previous batch stopped.
       numOut = table_->listJoinResults(
           results_,
           isLeftJoin(joinType_) || isFullJoin(joinType_) ||
               isAntiJoin(joinType_),
-          mapping,
-          folly::Range(outputRows_.data(), outputRows_.size()));
+          folly::Range(mapping.data(), maxOutputRows()),
+          folly::Range(outputRows_.data(), outputRows_.size()),
+          outputBatchBytes_ / 2);
     }
 
     if (!numOut) {
@@ -510,7 +591,7 @@ void HashProbe::fillFilterInput(vector_size_t size) {
       table_.get(),
       folly::Range<char**>(outputRows_.data(), size),
       filterBuildInputs_,
-      pool(),
+      operatorCtx_->execCtx(),
       filterInput_);
 }
 
@@ -617,6 +698,35 @@ void HashProbe::ensureLoadedIfNotAtEnd(column_index_t channel) {
 
 void HashProbe::noMoreInput() {
   Operator::noMoreInput();
+  if (spilledBuild_) {
+    std::vector<std::vector<std::unique_ptr<SpillFile>>> files(
+        spilledBuild_->bits.numPartitions());
+    if (spillState_) {
+      for (auto partition = 0; partition < files.size(); ++partition) {
+        if (spillState_->hasFiles(partition)) {
+          files[partition] = spillState_->files(partition);
+        }
+      }
+    }
+    auto bridge = operatorCtx_->task()->getHashJoinBridge(
+        operatorCtx_->driverCtx()->splitGroupId, planNodeId());
+    bridge->addSpilledProbeFiles(std::move(files));
+
+    // All HashProbes join the spilled partitions once the last one to finish
+    // has added its spilled probe rows.
+    restoreSpill_ = true;
+    std::vector<ContinuePromise> promises;
+    std::vector<std::shared_ptr<Driver>> peers;
+    if (!operatorCtx_->task()->allPeersFinished(
+            planNodeId(), operatorCtx_->driver(), &future_, promises, peers)) {
+      return;
+    }
+    bridge->startSpilledPartitions();
+    for (auto& promise : promises) {
+      promise.setValue();
+    }
+    return;
+  }
   if (isRightJoin(joinType_) || isFullJoin(joinType_)) {
     std::vector<ContinuePromise> promises;
     std::vector<std::shared_ptr<Driver>> peers;
@@ -635,4 +745,295 @@ void HashProbe::noMoreInput() {
 bool HashProbe::isFinished() {
   return finished_;
 }
+
+void HashProbe::ensureSpillState() {
+  if (spillState_) {
+    return;
+  }
+  spillState_ = makeSpillState("probe", spilledBuild_->bits.numPartitions());
+}
+
+std::unique_ptr<SpillState> HashProbe::makeSpillState(
+    const std::string& name,
+    int32_t numPartitions) {
+  const auto& config = operatorCtx_->task()->queryCtx()->config();
+  auto path = config.spillPath();
+  VELOX_CHECK(path.has_value(), "Spilled hash join requires a spill path");
+  auto mappedMemory = operatorCtx_->mappedMemory();
+  assert(mappedMemory->tracker()); // lint
+  auto fileSize = std::max<uint64_t>(
+      mappedMemory->tracker()->getCurrentUserBytes() / 4, 1 << 20);
+  return std::make_unique<SpillState>(
+      appendToSpillPath(
+          path.value(),
+          fmt::format(
+              "/{}-join-{}-{}",
+              operatorCtx_->task()->taskId(),
+              planNodeId(),
+              name)),
+      numPartitions,
+      0,
+      fileSize,
+      Spiller::spillPool(),
+      Spiller::spillMappedMemory(),
+      std::vector<CompareFlags>{},
+      spillCompressionCodec(config.spillCompressionKind()),
+      operatorCtx_->task()->queryCtx()->spillExecutor(),
+      config.spillLocalQuotaBytes());
+}
+
+void HashProbe::spillInput() {
+  const auto numInput = input_->size();
+  nonNullRows_.resize(numInput);
+  nonNullRows_.setAll();
+  deselectRowsWithNulls(
+      *input_, keyChannels_, nonNullRows_, *operatorCtx_->execCtx());
+
+  spillHashes_.resize(numInput);
+  for (auto i = 0; i < keyChannels_.size(); ++i) {
+    hashers_[i]->hash(
+        *input_->childAt(keyChannels_[i])->loadedVector(),
+        nonNullRows_,
+        i > 0,
+        spillHashes_);
+  }
+
+  // Rows with null keys never match and stay in memory.
+  const auto& bits = spilledBuild_->bits;
+  const auto numPartitions = bits.numPartitions();
+  std::vector<BufferPtr> indices(numPartitions);
+  std::vector<vector_size_t> numSpilled(numPartitions, 0);
+  auto remaining = allocateIndices(numInput, pool());
+  auto rawRemaining = remaining->asMutable<vector_size_t>();
+  vector_size_t numRemaining = 0;
+  for (auto row = 0; row < numInput; ++row) {
+    auto partition = nonNullRows_.isValid(row)
+        ? bits.partition(spillHashes_[row], numPartitions)
+        : -1;
+    if (partition < 0 || !spilledBuild_->isSpilled(partition)) {
+      rawRemaining[numRemaining++] = row;
+      continue;
+    }
+    if (!indices[partition]) {
+      indices[partition] = allocateIndices(numInput, pool());
+    }
+    indices[partition]->asMutable<vector_size_t>()[numSpilled[partition]++] =
+        row;
+  }
+  if (numRemaining == numInput) {
+    return;
+  }
+
+  ensureSpillState();
+  std::vector<VectorPtr> loaded;
+  loaded.reserve(input_->childrenSize());
+  for (auto& child : input_->children()) {
+    loaded.push_back(BaseVector::loadedVectorShared(child));
+  }
+  auto input = std::make_shared<RowVector>(
+      pool(), input_->type(), BufferPtr(nullptr), numInput, std::move(loaded));
+  for (auto partition = 0; partition < numPartitions; ++partition) {
+    if (numSpilled[partition]) {
+      spillState_->appendToPartition(
+          partition, wrap(numSpilled[partition], indices[partition], input));
+    }
+  }
+
+  if (numRemaining == 0) {
+    input_ = nullptr;
+  } else {
+    input_ = wrap(numRemaining, std::move(remaining), input);
+  }
+}
+
+bool HashProbe::nextSpilledInput() {
+  auto bridge = operatorCtx_->task()->getHashJoinBridge(
+      operatorCtx_->driverCtx()->splitGroupId, planNodeId());
+  for (;;) {
+    if (restoringPartition_) {
+      auto& files = restoringPartition_->probeFiles;
+      while (restoringFile_ < files.size()) {
+        auto batch = files[restoringFile_]->popBatch();
+        if (!batch) {
+          files[restoringFile_] = nullptr;
+          if (++restoringFile_ < files.size()) {
+            files[restoringFile_]->startRead();
+          }
+          continue;
+        }
+        addInput(std::move(batch));
+        if (input_) {
+          return true;
+        }
+      }
+      restoringPartition_ = nullptr;
+    }
+
+    restoringPartition_ = bridge->nextSpilledPartition(&future_);
+    if (!restoringPartition_) {
+      return false;
+    }
+    if (maybeSplitSpilledPartition(*bridge)) {
+      continue;
+    }
+    bridge->finishSpilledPartition({});
+    restoreTable();
+    restoringFile_ = 0;
+    restoringPartition_->probeFiles[0]->startRead();
+  }
+}
+
+bool HashProbe::maybeSplitSpilledPartition(HashJoinBridge& bridge) {
+  auto& partition = *restoringPartition_;
+  if (partition.startBit + kSpillSplitBits > 64) {
+    return false;
+  }
+  // Test-only path. Splits partitions of the build side once.
+  bool split = testSpillPct_ &&
+      partition.startBit == spilledBuild_->bits.end() &&
+      folly::hasher<uint64_t>()(++spillTestCounter_) % 100 <= testSpillPct_;
+  if (!split) {
+    uint64_t buildBytes = 0;
+    for (const auto& file : partition.buildFiles) {
+      buildBytes += file->size();
+    }
+    auto tracker = operatorCtx_->mappedMemory()->tracker();
+    assert(tracker); // lint
+    // The hash table takes at least twice the size of the spilled rows.
+    split = buildBytes > 0 && !tracker->maybeReserve(2 * buildBytes);
+  }
+  if (!split) {
+    return false;
+  }
+
+  const auto& spill = *spilledBuild_;
+  std::vector<std::unique_ptr<VectorHasher>> buildHashers;
+  buildHashers.reserve(spill.numKeys);
+  for (auto i = 0; i < spill.numKeys; ++i) {
+    buildHashers.push_back(
+        std::make_unique<VectorHasher>(spill.type->childAt(i), i));
+  }
+  const HashBitRange bits(
+      partition.startBit, partition.startBit + kSpillSplitBits);
+  const auto numPartitions = bits.numPartitions();
+  auto buildState = makeSpillState("split-build", numPartitions);
+  auto probeState = makeSpillState("split-probe", numPartitions);
+  splitSpillFiles(partition.buildFiles, buildHashers, bits, *buildState);
+  splitSpillFiles(partition.probeFiles, hashers_, bits, *probeState);
+
+  // If all build side rows land in one partition, the keys are likely to
+  // be all the same and further bits do not split them either.
+  int32_t numBuildPartitions = 0;
+  for (auto i = 0; i < numPartitions; ++i) {
+    numBuildPartitions += buildState->hasFiles(i);
+  }
+  std::vector<std::unique_ptr<SpilledJoinPartition>> splits;
+  for (auto i = 0; i < numPartitions; ++i) {
+    if (!probeState->hasFiles(i)) {
+      continue;
+    }
+    auto split = std::make_unique<SpilledJoinPartition>();
+    split->startBit = numBuildPartitions > 1 ? bits.end() : 64;
+    if (buildState->hasFiles(i)) {
+      split->buildFiles = buildState->files(i);
+    }
+    split->probeFiles = probeState->files(i);
+    splits.push_back(std::move(split));
+  }
+  stats_.addRuntimeStat("spilledPartitionSplits", RuntimeCounter(1));
+  restoringPartition_ = nullptr;
+  bridge.finishSpilledPartition(std::move(splits));
+  return true;
+}
+
+void HashProbe::splitSpillFiles(
+    std::vector<std::unique_ptr<SpillFile>>& files,
+    const std::vector<std::unique_ptr<VectorHasher>>& hashers,
+    const HashBitRange& bits,
+    SpillState& state) {
+  const auto numPartitions = bits.numPartitions();
+  SelectivityVector rows;
+  for (auto& file : files) {
+    file->startRead();
+    while (auto batch = file->popBatch()) {
+      const auto numRows = batch->size();
+      rows.resize(numRows);
+      rows.setAll();
+      spillHashes_.resize(numRows);
+      for (auto i = 0; i < hashers.size(); ++i) {
+        hashers[i]->hash(
+            *batch->childAt(hashers[i]->channel()),
+            rows,
+            i > 0,
+            spillHashes_);
+      }
+      std::vector<BufferPtr> indices(numPartitions);
+      std::vector<vector_size_t> numSplit(numPartitions, 0);
+      for (auto row = 0; row < numRows; ++row) {
+        auto partition = bits.partition(spillHashes_[row], numPartitions);
+        if (!indices[partition]) {
+          indices[partition] = allocateIndices(numRows, pool());
+        }
+        indices[partition]->asMutable<vector_size_t>()[numSplit[partition]++] =
+            row;
+      }
+      for (auto partition = 0; partition < numPartitions; ++partition) {
+        if (numSplit[partition]) {
+          state.appendToPartition(
+              partition, wrap(numSplit[partition], indices[partition], batch));
+        }
+      }
+    }
+    file = nullptr;
+  }
+  files.clear();
+}
+
+void HashProbe::restoreTable() {
+  auto& spill = *spilledBuild_;
+  std::vector<std::unique_ptr<VectorHasher>> hashers;
+  hashers.reserve(spill.numKeys);
+  for (auto i = 0; i < spill.numKeys; ++i) {
+    hashers.push_back(
+        std::make_unique<VectorHasher>(spill.type->childAt(i), i));
+  }
+  std::vector<TypePtr> dependentTypes;
+  std::vector<column_index_t> dependentChannels;
+  std::vector<std::unique_ptr<DecodedVector>> decoders;
+  for (auto i = spill.numKeys; i < spill.type->size(); ++i) {
+    dependentTypes.push_back(spill.type->childAt(i));
+    dependentChannels.push_back(i);
+    decoders.push_back(std::make_unique<DecodedVector>());
+  }
+
+  // Right and full joins do not spill, so null keys are always ignored.
+  auto table = HashTable<true>::createForJoin(
+      std::move(hashers),
+      dependentTypes,
+      spill.allowDuplicates,
+      false, // hasProbedFlag
+      operatorCtx_->mappedMemory());
+  bool analyzeKeys = table->hashMode() != BaseHashTable::HashMode::kHash;
+  raw_vector<uint64_t> hashes;
+  SelectivityVector rows;
+  auto& files = restoringPartition_->buildFiles;
+  for (auto& file : files) {
+    file->startRead();
+    while (auto batch = file->popBatch()) {
+      rows.resize(batch->size());
+      rows.setAll();
+      addJoinBuildRows(
+          *table,
+          *batch,
+          rows,
+          dependentChannels,
+          decoders,
+          analyzeKeys,
+          hashes);
+    }
+  }
+  files.clear();
+  table->prepareJoinTable({});
+  table_ = std::move(table);
+}
 } // namespace facebook::velox::exec
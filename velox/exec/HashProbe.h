@@ -22,7 +22,12 @@
 
 namespace facebook::velox::exec {
 
-// Probes a hash table made by HashBuild.
+// Probes a hash table made by HashBuild. If the build side spilled, the probe
+// rows of the spilled partitions are spilled as well. When all HashProbes have
+// processed their input, they take turns at the spilled partitions. Each
+// rebuilds the hash table from the build side rows of a partition and probes
+// it with the spilled probe rows of the same partition. A partition whose
+// build side does not fit in memory is first split on more hash bits.
 class HashProbe : public Operator {
  public:
   HashProbe(
@@ -88,9 +93,59 @@ class HashProbe : public Operator {
 
   void ensureLoadedIfNotAtEnd(column_index_t channel);
 
-  // TODO: Define batch size as bytes based on RowContainer row sizes.
+  // Writes the rows of 'input_' in spilled partitions to disk and replaces
+  // 'input_' with the remaining rows. Sets 'input_' to nullptr if no rows
+  // remain.
+  void spillInput();
+
+  void ensureSpillState();
+
+  // Returns a SpillState with 'numPartitions' partitions for files named
+  // after 'name'.
+  std::unique_ptr<SpillState> makeSpillState(
+      const std::string& name,
+      int32_t numPartitions);
+
+  // Sets 'input_' to the next batch of spilled probe rows, rebuilding
+  // 'table_' from the spilled build side rows when starting a new
+  // partition. Returns false when there is no partition to join. Sets
+  // 'future_' if other HashProbes may still add partitions.
+  bool nextSpilledInput();
+
+  // Splits 'restoringPartition_' on the next kSpillSplitBits hash bits if
+  // its build side does not fit in memory and hands the splits over to the
+  // HashJoinBridge. Returns true if split.
+  bool maybeSplitSpilledPartition(HashJoinBridge& bridge);
+
+  // Appends the rows of 'files' to the partitions of 'state' given by
+  // 'bits' of the hash of the columns of 'hashers'. Deletes 'files'.
+  void splitSpillFiles(
+      std::vector<std::unique_ptr<SpillFile>>& files,
+      const std::vector<std::unique_ptr<VectorHasher>>& hashers,
+      const HashBitRange& bits,
+      SpillState& state);
+
+  // Replaces 'table_' with a hash table made from the spilled build side rows
+  // of 'restoringPartition_'.
+  void restoreTable();
+
+  // True if the build side has rows in memory or on disk.
+  bool hasBuildSide() const {
+    return table_->numDistinct() > 0 || spilledBuild_ != nullptr;
+  }
+
+  // Returns the most rows of output whose probe side columns fit in half of
+  // 'outputBatchBytes_'. The build side rows listed from 'table_' take up
+  // the other half.
+  vector_size_t maxOutputRows() const;
+
+  // Most rows in a batch of output.
   const uint32_t outputBatchSize_;
 
+  // Preferred size in bytes of a batch of output. Batches of wide rows have
+  // fewer than 'outputBatchSize_' rows.
+  const uint64_t outputBatchBytes_;
+
   const core::JoinType joinType_;
 
   std::unique_ptr<HashLookup> lookup_;
@@ -104,6 +159,10 @@ class HashProbe : public Operator {
   // True if the join became a no-op after pushing down the filter.
   bool replacedWithDynamicFilter_{false};
 
+  // True if a dynamic filter is a Bloom filter. Rows passing it may not have
+  // a match, so the join cannot be replaced with the filter.
+  bool hasBloomDynamicFilter_{false};
+
   std::vector<std::unique_ptr<VectorHasher>> hashers_;
 
   // Table shared between other HashProbes in other Drivers of the
@@ -252,6 +311,37 @@ class HashProbe : public Operator {
   // cases where there is more than one batch of output or join filter
   // input.
   SelectivityVector passingInputRows_;
+
+  // Spilled build side partitions. nullptr if the build side did not spill.
+  std::shared_ptr<SpilledHashBuild> spilledBuild_;
+
+  // Spilled probe rows for the partitions spilled on the build side.
+  std::unique_ptr<SpillState> spillState_;
+
+  raw_vector<uint64_t> spillHashes_;
+
+  // Number of hash bits a spilled partition is split on at a time.
+  static constexpr int32_t kSpillSplitBits = 2;
+
+  // True after this has spilled all its probe input. The spilled partitions
+  // are joined once all HashProbes are done with their input.
+  bool restoreSpill_{false};
+
+  // Realized when all HashProbes are done with their input or when another
+  // HashProbe has split or taken a spilled partition.
+  ContinueFuture future_{ContinueFuture::makeEmpty()};
+
+  // The spilled partition being joined. nullptr if none.
+  std::unique_ptr<SpilledJoinPartition> restoringPartition_;
+
+  // Index of the probe side file being read in 'restoringPartition_'.
+  int32_t restoringFile_{0};
+
+  // Percentage of the spilled partitions of the build side that are split
+  // once for testing, see QueryConfig::testingSpillPct().
+  const int32_t testSpillPct_;
+
+  int32_t spillTestCounter_{0};
 };
 
 } // namespace facebook::velox::exec
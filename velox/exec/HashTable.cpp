@@ -15,6 +15,10 @@
  */
 
 #include "velox/exec/HashTable.h"
+
+#include <folly/ScopeGuard.h>
+
+#include "velox/common/base/AsyncSource.h"
 #include "velox/common/base/Portability.h"
 #include "velox/common/base/SimdUtil.h"
 #include "velox/common/process/ProcessBase.h"
@@ -32,6 +36,24 @@ static int32_t typeKindSize(TypeKind kind) {
   return VELOX_DYNAMIC_TYPE_DISPATCH(kindSize, kind);
 }
 
+// Upper bound on the bits of the value ids of a key of 'kind', including
+// the id for null.
+static int32_t maxValueIdBits(TypeKind kind) {
+  switch (kind) {
+    case TypeKind::BOOLEAN:
+      return 2;
+    case TypeKind::TINYINT:
+      return 9;
+    case TypeKind::SMALLINT:
+      return 17;
+    case TypeKind::INTEGER:
+    case TypeKind::DATE:
+      return 33;
+    default:
+      return 64;
+  }
+}
+
 template <bool ignoreNullKeys>
 HashTable<ignoreNullKeys>::HashTable(
     std::vector<std::unique_ptr<VectorHasher>>&& hashers,
@@ -45,12 +67,20 @@ HashTable<ignoreNullKeys>::HashTable(
       aggregates_(aggregates),
       isJoinBuild_(isJoinBuild) {
   std::vector<TypePtr> keys;
+  int32_t valueIdBits = 0;
   for (auto& hasher : hashers_) {
     keys.push_back(hasher->type());
+    valueIdBits += maxValueIdBits(hasher->typeKind());
     if (!VectorHasher::typeKindSupportsValueIds(hasher->typeKind())) {
       hashMode_ = HashMode::kHash;
     }
   }
+  // A join build decides the hash mode once all rows are accumulated, so
+  // the second word of a kNormalizedKey128 key is reserved up front if
+  // the value ids of the keys may not fit in 64 bits. A group by stores
+  // rows before deciding and never uses the second word.
+  const bool mayUseNormalizedKey128 = isJoinBuild &&
+      hashMode_ != HashMode::kHash && hashers_.size() > 1 && valueIdBits > 64;
   rows_ = std::make_unique<RowContainer>(
       keys,
       !ignoreNullKeys,
@@ -61,7 +91,8 @@ HashTable<ignoreNullKeys>::HashTable(
       hasProbedFlag,
       hashMode_ != HashMode::kHash,
       mappedMemory,
-      ContainerRowSerde::instance());
+      ContainerRowSerde::instance(),
+      mayUseNormalizedKey128 ? 2 : 1);
   nextOffset_ = rows_->nextOffset();
 }
 
@@ -252,11 +283,14 @@ char* HashTable<ignoreNullKeys>::insertEntry(
   lookup.hits[row] = group; // NOLINT
   storeKeys(lookup, row);
   storeRowPointer(index, lookup.hashes[row], group);
-  if (hashMode_ == HashMode::kNormalizedKey) {
+  if (hasNormalizedKeys()) {
     // We store the unique digest of key values (normalized key) in
     // the word below the row. Space was reserved in the allocation
     // unless we have given up on normalized keys.
     RowContainer::normalizedKey(group) = lookup.normalizedKeys[row]; // NOLINT
+    if (hashMode_ == HashMode::kNormalizedKey128) {
+      RowContainer::normalizedKeyHigh(group) = lookup.highKeys[row]; // NOLINT
+    }
   }
   ++numDistinct_;
   lookup.newGroups.push_back(row);
@@ -321,6 +355,23 @@ FOLLY_ALWAYS_INLINE void HashTable<ignoreNullKeys>::fullProbe(
         !isJoin && extraCheck);
     return;
   }
+  if (hashMode_ == HashMode::kNormalizedKey128) {
+    // NOLINT
+    lookup.hits[state.row()] = state.fullProbe<op>(
+        tags_,
+        table_,
+        sizeMask_,
+        normalizedKeyOffset(),
+        [&](char* group, int32_t row) INLINE_LAMBDA {
+          return equalsNormalizedKey128(
+              group, lookup.normalizedKeys[row], lookup.highKeys[row]);
+        },
+        [&](int32_t index, int32_t row) {
+          return isJoin ? nullptr : insertEntry(lookup, row, index);
+        },
+        !isJoin && extraCheck);
+    return;
+  }
   // NOLINT
   lookup.hits[state.row()] = state.fullProbe<op>(
       tags_,
@@ -346,6 +397,13 @@ inline uint64_t mixNormalizedKey(uint64_t k, uint8_t bits) {
   return h + (h >> bits) * prime2 + (h >> (2 * bits)) * prime3;
 }
 
+// Combines the words of a two word normalized key and mixes the result
+// like mixNormalizedKey.
+inline uint64_t
+mixNormalizedKey128(uint64_t low, uint64_t high, uint8_t sizeBits) {
+  return mixNormalizedKey(bits::hashMix(high, low), sizeBits);
+}
+
 void populateNormalizedKeys(HashLookup& lookup, int8_t sizeBits) {
   lookup.normalizedKeys.resize(lookup.rows.back() + 1);
   auto hashes = lookup.hashes.data();
@@ -355,6 +413,19 @@ void populateNormalizedKeys(HashLookup& lookup, int8_t sizeBits) {
     hashes[row] = mixNormalizedKey(hash, sizeBits);
   }
 }
+
+// Same as populateNormalizedKeys for two word keys. The high words are
+// already in 'lookup.highKeys'.
+void populateNormalizedKeys128(HashLookup& lookup, int8_t sizeBits) {
+  lookup.normalizedKeys.resize(lookup.rows.back() + 1);
+  auto hashes = lookup.hashes.data();
+  auto highKeys = lookup.highKeys.data();
+  for (auto row : lookup.rows) {
+    auto hash = hashes[row];
+    lookup.normalizedKeys[row] = hash; // NOLINT
+    hashes[row] = mixNormalizedKey128(hash, highKeys[row], sizeBits);
+  }
+}
 } // namespace
 
 template <bool ignoreNullKeys>
@@ -368,6 +439,8 @@ void HashTable<ignoreNullKeys>::groupProbe(HashLookup& lookup) {
   checkSize(lookup.rows.size());
   if (hashMode_ == HashMode::kNormalizedKey) {
     populateNormalizedKeys(lookup, sizeBits_);
+  } else if (hashMode_ == HashMode::kNormalizedKey128) {
+    populateNormalizedKeys128(lookup, sizeBits_);
   }
   ProbeState state1;
   ProbeState state2;
@@ -457,8 +530,10 @@ void HashTable<ignoreNullKeys>::arrayGroupProbe(HashLookup& lookup) {
 
 template <bool ignoreNullKeys>
 void HashTable<ignoreNullKeys>::joinProbe(HashLookup& lookup) {
+  const bool partitioned = probePartitionBits_.has_value() &&
+      lookup.rows.size() >= kMinRowsForPartitionedProbe;
   if (hashMode_ == HashMode::kArray) {
-    for (auto row : lookup.rows) {
+    for (auto row : partitioned ? partitionProbeRows(lookup) : lookup.rows) {
       auto index = lookup.hashes[row];
       DCHECK(index < size_);
       lookup.hits[row] = table_[index]; // NOLINT
@@ -467,10 +542,14 @@ void HashTable<ignoreNullKeys>::joinProbe(HashLookup& lookup) {
   }
   if (hashMode_ == HashMode::kNormalizedKey) {
     populateNormalizedKeys(lookup, sizeBits_);
+  } else if (hashMode_ == HashMode::kNormalizedKey128) {
+    populateNormalizedKeys128(lookup, sizeBits_);
   }
+  const auto& probeRows =
+      partitioned ? partitionProbeRows(lookup) : lookup.rows;
   int32_t probeIndex = 0;
-  int32_t numProbes = lookup.rows.size();
-  const vector_size_t* rows = lookup.rows.data();
+  int32_t numProbes = probeRows.size();
+  const vector_size_t* rows = probeRows.data();
   ProbeState state1;
   ProbeState state2;
   ProbeState state3;
@@ -501,6 +580,49 @@ void HashTable<ignoreNullKeys>::joinProbe(HashLookup& lookup) {
   }
 }
 
+template <bool ignoreNullKeys>
+const raw_vector<vector_size_t>& HashTable<ignoreNullKeys>::partitionProbeRows(
+    HashLookup& lookup) {
+  const auto& bits = probePartitionBits_.value();
+  const auto numPartitions = bits.numPartitions();
+  // The slot of an array table is the hash itself.
+  const uint64_t slotMask =
+      hashMode_ == HashMode::kArray ? ~0ULL : static_cast<uint64_t>(sizeMask_);
+  auto& starts = lookup.partitionStarts;
+  starts.assign(numPartitions + 1, 0);
+  for (auto row : lookup.rows) {
+    ++starts[bits.partition(lookup.hashes[row] & slotMask, numPartitions) + 1];
+  }
+  for (auto i = 1; i < numPartitions; ++i) {
+    starts[i] += starts[i - 1];
+  }
+  auto& partitionedRows = lookup.partitionedRows;
+  partitionedRows.resize(lookup.rows.size());
+  for (auto row : lookup.rows) {
+    const auto partition =
+        bits.partition(lookup.hashes[row] & slotMask, numPartitions);
+    partitionedRows[starts[partition]++] = row;
+  }
+  return partitionedRows;
+}
+
+template <bool ignoreNullKeys>
+void HashTable<ignoreNullKeys>::setPartitionedJoinProbe(bool enable) {
+  probePartitionBits_.reset();
+  if (!enable || size_ <= 1) {
+    return;
+  }
+  // Number of bits in a slot number. An array table may have a size that
+  // is not a power of two.
+  const int32_t slotBits = 64 - __builtin_clzll(size_ - 1);
+  const int32_t partitionBits =
+      std::min(kMaxProbePartitionBits, slotBits - kProbePartitionSlotBits);
+  if (partitionBits <= 0) {
+    return;
+  }
+  probePartitionBits_.emplace(slotBits - partitionBits, slotBits);
+}
+
 template <bool ignoreNullKeys>
 void HashTable<ignoreNullKeys>::initializeNewGroups(HashLookup& lookup) {
   if (lookup.newGroups.empty()) {
@@ -544,6 +666,7 @@ void HashTable<ignoreNullKeys>::clear() {
     memset(table_, 0, sizeof(char*) * size_);
   }
   numDistinct_ = 0;
+  probePartitionBits_.reset();
 }
 
 template <bool ignoreNullKeys>
@@ -570,7 +693,30 @@ template <bool ignoreNullKeys>
 bool HashTable<ignoreNullKeys>::insertBatch(
     char** groups,
     int32_t numGroups,
-    raw_vector<uint64_t>& hashes) {
+    raw_vector<uint64_t>& hashes,
+    raw_vector<uint64_t>& highKeys) {
+  if (!hashRows(groups, numGroups, hashes, highKeys)) {
+    // Must reconsider 'hashMode_' and start over.
+    return false;
+  }
+  storeNormalizedKeys(groups, numGroups, hashes.data(), highKeys.data());
+  if (isJoinBuild_) {
+    insertForJoin(groups, hashes.data(), numGroups);
+  } else {
+    insertForGroupBy(groups, hashes.data(), numGroups);
+  }
+  return true;
+}
+
+template <bool ignoreNullKeys>
+bool HashTable<ignoreNullKeys>::hashRows(
+    char** groups,
+    int32_t numGroups,
+    raw_vector<uint64_t>& hashes,
+    raw_vector<uint64_t>& highKeys) {
+  if (hashMode_ == HashMode::kNormalizedKey128) {
+    highKeys.resize(hashes.size());
+  }
   for (int32_t i = 0; i < hashers_.size(); ++i) {
     auto& hasher = hashers_[i];
     if (hashMode_ == HashMode::kHash) {
@@ -585,20 +731,36 @@ bool HashTable<ignoreNullKeys>::insertBatch(
               column.offset(),
               column.nullByte(),
               ignoreNullKeys ? 0 : column.nullMask(),
-              hashes)) {
-        // Must reconsider 'hashMode_' and start over.
+              i < numLowKeys_ ? hashes : highKeys)) {
         return false;
       }
     }
   }
-  if (isJoinBuild_) {
-    insertForJoin(groups, hashes.data(), numGroups);
-  } else {
-    insertForGroupBy(groups, hashes.data(), numGroups);
-  }
   return true;
 }
 
+template <bool ignoreNullKeys>
+void HashTable<ignoreNullKeys>::storeNormalizedKeys(
+    char** groups,
+    int32_t numGroups,
+    uint64_t* hashes,
+    const uint64_t* highKeys) {
+  if (hashMode_ == HashMode::kNormalizedKey) {
+    for (auto i = 0; i < numGroups; ++i) {
+      // Write the normalized key below the row.
+      RowContainer::normalizedKey(groups[i]) = hashes[i];
+      // Shuffle the bits im the normalized key.
+      hashes[i] = mixNormalizedKey(hashes[i], sizeBits_);
+    }
+  } else if (hashMode_ == HashMode::kNormalizedKey128) {
+    for (auto i = 0; i < numGroups; ++i) {
+      RowContainer::normalizedKey(groups[i]) = hashes[i];
+      RowContainer::normalizedKeyHigh(groups[i]) = highKeys[i];
+      hashes[i] = mixNormalizedKey128(hashes[i], highKeys[i], sizeBits_);
+    }
+  }
+}
+
 template <bool ignoreNullKeys>
 void HashTable<ignoreNullKeys>::insertForGroupBy(
     char** groups,
@@ -612,15 +774,6 @@ void HashTable<ignoreNullKeys>::insertForGroupBy(
       table_[index] = groups[i];
     }
   } else {
-    if (hashMode_ == HashMode::kNormalizedKey) {
-      for (int i = 0; i < numGroups; ++i) {
-        auto hash = hashes[i];
-        // Write the normalized key below the row.
-        RowContainer::normalizedKey(groups[i]) = hash;
-        // Shuffle the bits im the normalized key.
-        hashes[i] = mixNormalizedKey(hash, sizeBits_);
-      }
-    }
     for (int32_t i = 0; i < numGroups; ++i) {
       auto hash = hashes[i];
       auto tagIndex = ProbeState::tagsByteOffset(hash, sizeMask_);
@@ -648,7 +801,7 @@ bool HashTable<ignoreNullKeys>::arrayPushRow(char* row, int32_t index) {
   if (nextOffset_) {
     nextRow(row) = existing;
     if (existing) {
-      hasDuplicates_ = true;
+      hasDuplicates_.store(true, std::memory_order_relaxed);
     }
   } else if (existing) {
     // Semijoin or a known unique build side ignores a repeat of a key.
@@ -661,7 +814,7 @@ bool HashTable<ignoreNullKeys>::arrayPushRow(char* row, int32_t index) {
 template <bool ignoreNullKeys>
 void HashTable<ignoreNullKeys>::pushNext(char* row, char* next) {
   if (nextOffset_) {
-    hasDuplicates_ = true;
+    hasDuplicates_.store(true, std::memory_order_relaxed);
     auto previousNext = nextRow(row);
     nextRow(row) = next;
     nextRow(next) = previousNext;
@@ -674,15 +827,14 @@ FOLLY_ALWAYS_INLINE void HashTable<ignoreNullKeys>::buildFullProbe(
     uint64_t hash,
     char* inserted,
     bool extraCheck) {
-  if (hashMode_ == HashMode::kNormalizedKey) {
+  if (hasNormalizedKeys()) {
     state.fullProbe<ProbeState::Operation::kInsert>(
         tags_,
         table_,
         sizeMask_,
-        -static_cast<int32_t>(sizeof(normalized_key_t)),
+        normalizedKeyOffset(),
         [&](char* group, int32_t /*row*/) {
-          if (RowContainer::normalizedKey(group) ==
-              RowContainer::normalizedKey(inserted)) {
+          if (equalNormalizedKeys(group, inserted)) {
             if (nextOffset_) {
               pushNext(group, inserted);
             }
@@ -723,15 +875,6 @@ void HashTable<ignoreNullKeys>::insertForJoin(
     char** groups,
     uint64_t* hashes,
     int32_t numGroups) {
-  if (hashMode_ == HashMode::kNormalizedKey) {
-    // Write the normalized key below each row. The key is only known
-    // at the time of insert, so cannot be filled in at the time of
-    // accumulating the build rows.
-    for (auto i = 0; i < numGroups; ++i) {
-      RowContainer::normalizedKey(groups[i]) = hashes[i];
-      hashes[i] = mixNormalizedKey(hashes[i], sizeBits_);
-    }
-  }
   // The insertable rows are in the table, all get put in the hash
   // table or array.
   if (hashMode_ == HashMode::kArray) {
@@ -742,7 +885,14 @@ void HashTable<ignoreNullKeys>::insertForJoin(
     }
     return;
   }
+  insertHashedForJoin(groups, hashes, numGroups);
+}
 
+template <bool ignoreNullKeys>
+void HashTable<ignoreNullKeys>::insertHashedForJoin(
+    char** groups,
+    uint64_t* hashes,
+    int32_t numGroups) {
   ProbeState state1;
   for (auto i = 0; i < numGroups; ++i) {
     state1.preProbe(tags_, sizeMask_, hashes[i], i);
@@ -751,12 +901,174 @@ void HashTable<ignoreNullKeys>::insertForJoin(
   }
 }
 
+template <bool ignoreNullKeys>
+bool HashTable<ignoreNullKeys>::insertForJoinInPartition(
+    char* row,
+    uint64_t hash,
+    int64_t partitionEnd) {
+  const auto wantedTags = TagVector::broadcast(hashTag(hash));
+  const auto emptyTags = TagVector::broadcast(0);
+  for (auto tagIndex = ProbeState::tagsByteOffset(hash, sizeMask_);
+       tagIndex < partitionEnd;
+       tagIndex += sizeof(TagVector)) {
+    const auto tagsInTable = loadTags(tags_, tagIndex);
+    MaskType hits =
+        simd::toBitMask(tagsInTable == wantedTags) & ProbeState::kFullMask;
+    while (hits) {
+      auto hit = bits::getAndClearLastSetBit(hits);
+      auto* group = loadRow(table_, tagIndex + hit);
+      const bool sameKey = hasNormalizedKeys()
+          ? equalNormalizedKeys(group, row)
+          : compareKeys(group, row);
+      if (sameKey) {
+        pushNext(group, row);
+        return true;
+      }
+    }
+    MaskType empty =
+        simd::toBitMask(tagsInTable == emptyTags) & ProbeState::kFullMask;
+    if (empty) {
+      storeRowPointer(tagIndex + bits::getAndClearLastSetBit(empty), hash, row);
+      return true;
+    }
+  }
+  return false;
+}
+
+template <bool ignoreNullKeys>
+bool HashTable<ignoreNullKeys>::canApplyParallelJoinBuild() const {
+  return isJoinBuild_ && buildExecutor_ != nullptr &&
+      hashMode_ != HashMode::kArray && !otherTables_.empty() &&
+      numDistinct_ >= kMinRowsForParallelJoinBuild;
+}
+
+template <bool ignoreNullKeys>
+bool HashTable<ignoreNullKeys>::parallelJoinBuild() {
+  const int32_t numTables = otherTables_.size() + 1;
+  const int32_t numPartitions = std::min<int64_t>(
+      numTables, size_ / static_cast<int64_t>(sizeof(TagVector)));
+  const int64_t partitionSize = bits::roundUp(
+      (size_ + numPartitions - 1) / numPartitions, sizeof(TagVector));
+  auto partitionOf = [&](uint64_t hash) -> int32_t {
+    return ProbeState::tagsByteOffset(hash, sizeMask_) / partitionSize;
+  };
+
+  // The rows of a table ordered by partition, the hash of each and the start
+  // of each partition in these. 'highKeys' is scratch for the high words
+  // of normalized keys.
+  struct PartitionedRows {
+    std::vector<char*> rows;
+    raw_vector<uint64_t> hashes;
+    raw_vector<uint64_t> highKeys;
+    std::vector<int64_t> partitionStarts;
+  };
+  std::vector<PartitionedRows> tableRows(numTables);
+
+  // Lists the rows of table 'i' and computes their hashes. Returns false if
+  // the keys do not map to normalized keys.
+  auto hashTable = [&](int32_t i) {
+    auto* rows = (i == 0 ? this : otherTables_[i - 1].get())->rows();
+    auto& partitioned = tableRows[i];
+    partitioned.rows.resize(rows->numRows());
+    partitioned.hashes.resize(rows->numRows());
+    RowContainerIterator iterator;
+    rows->listRows(
+        &iterator, partitioned.rows.size(), partitioned.rows.data());
+    return hashRows(
+        partitioned.rows.data(),
+        partitioned.rows.size(),
+        partitioned.hashes,
+        partitioned.highKeys);
+  };
+
+  // Stores the normalized keys and orders the rows of table 'i' by
+  // partition.
+  auto partitionTable = [&](int32_t i) {
+    auto& partitioned = tableRows[i];
+    const int32_t numRows = partitioned.rows.size();
+    auto& hashes = partitioned.hashes;
+    storeNormalizedKeys(
+        partitioned.rows.data(),
+        numRows,
+        hashes.data(),
+        partitioned.highKeys.data());
+    auto& starts = partitioned.partitionStarts;
+    starts.assign(numPartitions + 1, 0);
+    for (auto row = 0; row < numRows; ++row) {
+      ++starts[partitionOf(hashes[row]) + 1];
+    }
+    for (auto partition = 0; partition < numPartitions; ++partition) {
+      starts[partition + 1] += starts[partition];
+    }
+    std::vector<int64_t> fill(starts.begin(), starts.end() - 1);
+    std::vector<char*> rows(numRows);
+    raw_vector<uint64_t> rowHashes;
+    rowHashes.resize(numRows);
+    for (auto row = 0; row < numRows; ++row) {
+      auto index = fill[partitionOf(hashes[row])]++;
+      rows[index] = partitioned.rows[row];
+      rowHashes[index] = hashes[row];
+    }
+    partitioned.rows = std::move(rows);
+    partitioned.hashes = std::move(rowHashes);
+  };
+
+  if (hashMode_ == HashMode::kHash) {
+    // Hashing reads only the rows, so each table is hashed in parallel.
+    runParallel(buildExecutor_, numTables, [&](int32_t i) {
+      hashTable(i);
+      partitionTable(i);
+    });
+  } else {
+    // Normalized keys are looked up in the VectorHashers, which are not
+    // thread safe.
+    for (auto i = 0; i < numTables; ++i) {
+      if (!hashTable(i)) {
+        return false;
+      }
+    }
+    runParallel(buildExecutor_, numTables, partitionTable);
+  }
+
+  // Each partition is filled by one thread. The rows whose probe reaches the
+  // end of their partition are inserted serially at the end.
+  std::vector<PartitionedRows> overflows(numPartitions);
+  runParallel(buildExecutor_, numPartitions, [&](int32_t partition) {
+    const int64_t partitionEnd =
+        std::min<int64_t>(size_, (partition + 1) * partitionSize);
+    auto& overflow = overflows[partition];
+    for (auto& partitioned : tableRows) {
+      const auto end = partitioned.partitionStarts[partition + 1];
+      for (auto i = partitioned.partitionStarts[partition]; i < end; ++i) {
+        if (!insertForJoinInPartition(
+                partitioned.rows[i], partitioned.hashes[i], partitionEnd)) {
+          overflow.rows.push_back(partitioned.rows[i]);
+          overflow.hashes.push_back(partitioned.hashes[i]);
+        }
+      }
+    }
+  });
+  for (auto& overflow : overflows) {
+    insertHashedForJoin(
+        overflow.rows.data(), overflow.hashes.data(), overflow.rows.size());
+  }
+  return true;
+}
+
 template <bool ignoreNullKeys>
 void HashTable<ignoreNullKeys>::rehash() {
+  if (canApplyParallelJoinBuild()) {
+    if (!parallelJoinBuild()) {
+      VELOX_CHECK(hashMode_ != HashMode::kHash);
+      setHashMode(HashMode::kHash, 0);
+    }
+    return;
+  }
   constexpr int32_t kHashBatchSize = 1024;
   // @lint-ignore CLANGTIDY
   raw_vector<uint64_t> hashes;
   hashes.resize(kHashBatchSize);
+  raw_vector<uint64_t> highKeys;
   char* groups[kHashBatchSize];
   // A join build can have multiple payload tables. Loop over 'this'
   // and the possible other tables and put all the data in the table
@@ -768,7 +1080,7 @@ void HashTable<ignoreNullKeys>::rehash() {
       numGroups = (i == 0 ? this : otherTables_[i - 1].get())
                       ->rows()
                       ->listRows(&iterator, kHashBatchSize, groups);
-      if (!insertBatch(groups, numGroups, hashes)) {
+      if (!insertBatch(groups, numGroups, hashes, highKeys)) {
         VELOX_CHECK(hashMode_ != HashMode::kHash);
         setHashMode(HashMode::kHash, 0);
         return;
@@ -801,8 +1113,12 @@ void HashTable<ignoreNullKeys>::setHashMode(HashMode mode, int32_t numNew) {
     size_ = 0;
     // Makes tables of the right size and rehashes.
     checkSize(numNew);
-  } else if (mode == HashMode::kNormalizedKey) {
-    hashMode_ = HashMode::kNormalizedKey;
+  } else if (
+      mode == HashMode::kNormalizedKey ||
+      mode == HashMode::kNormalizedKey128) {
+    VELOX_CHECK(
+        mode == HashMode::kNormalizedKey || rows_->normalizedKeyWords() == 2);
+    hashMode_ = mode;
     size_ = 0;
     // Makes tables of the right size and rehashes.
     checkSize(numNew);
@@ -917,6 +1233,10 @@ uint64_t HashTable<ignoreNullKeys>::setHasherMode(
   // A group by leaves 50% space for values not yet seen.
   for (int i = 0; i < hashers.size(); ++i) {
     auto kind = hashers[i]->typeKind();
+    if (i == numLowKeys_) {
+      // The keys of the high word of a kNormalizedKey128 key start over.
+      multiplier = 1;
+    }
     multiplier = useRange.size() > i && useRange[i]
         ? hashers[i]->enableValueRange(multiplier, reservePct())
         : hashers[i]->enableValueIds(multiplier, reservePct());
@@ -940,6 +1260,7 @@ void HashTable<ignoreNullKeys>::decideHashMode(int32_t numNew) {
   uint64_t bestWithReserve = 1;
   uint64_t distinctsWithReserve = 1;
   uint64_t rangesWithReserve = 1;
+  numLowKeys_ = hashers_.size();
   if (numDistinct_ && !isJoinBuild_) {
     if (!analyze()) {
       setHashMode(HashMode::kHash, numNew);
@@ -998,6 +1319,12 @@ void HashTable<ignoreNullKeys>::decideHashMode(int32_t numNew) {
   }
   if (distinctsWithReserve == VectorHasher::kRangeTooLarge &&
       rangesWithReserve == VectorHasher::kRangeTooLarge) {
+    // The keys may still fit in two words.
+    if (rows_->normalizedKeyWords() == 2 &&
+        trySplitNormalizedKey(useRange, rangeSizes, distinctSizes)) {
+      setHashMode(HashMode::kNormalizedKey128, numNew);
+      return;
+    }
     setHashMode(HashMode::kHash, numNew);
     return;
   }
@@ -1011,6 +1338,45 @@ void HashTable<ignoreNullKeys>::decideHashMode(int32_t numNew) {
   setHashMode(HashMode::kNormalizedKey, numNew);
 }
 
+template <bool ignoreNullKeys>
+bool HashTable<ignoreNullKeys>::trySplitNormalizedKey(
+    const std::vector<bool>& useRange,
+    const std::vector<uint64_t>& rangeSizes,
+    const std::vector<uint64_t>& distinctSizes) {
+  const int32_t numKeys = hashers_.size();
+  std::vector<uint64_t> sizes(numKeys);
+  for (auto i = 0; i < numKeys; ++i) {
+    sizes[i] = useRange[i] ? rangeSizes[i] : distinctSizes[i];
+    if (sizes[i] == VectorHasher::kRangeTooLarge) {
+      return false;
+    }
+  }
+  // The low word takes as many leading keys as fit. The high word must
+  // fit the rest.
+  int32_t numLowKeys = 0;
+  uint64_t lowSize = 1;
+  for (; numLowKeys < numKeys; ++numLowKeys) {
+    auto size = safeMul(lowSize, sizes[numLowKeys]);
+    if (size == VectorHasher::kRangeTooLarge) {
+      break;
+    }
+    lowSize = size;
+  }
+  if (numLowKeys == 0 || numLowKeys == numKeys) {
+    return false;
+  }
+  uint64_t highSize = 1;
+  for (auto i = numLowKeys; i < numKeys; ++i) {
+    highSize = safeMul(highSize, sizes[i]);
+  }
+  if (highSize == VectorHasher::kRangeTooLarge) {
+    return false;
+  }
+  numLowKeys_ = numLowKeys;
+  setHasherMode(hashers_, useRange, rangeSizes, distinctSizes);
+  return true;
+}
+
 template <bool ignoreNullKeys>
 std::string HashTable<ignoreNullKeys>::toString() {
   std::stringstream out;
@@ -1049,7 +1415,10 @@ bool mayUseValueIds(const BaseHashTable& table) {
 
 template <bool ignoreNullKeys>
 void HashTable<ignoreNullKeys>::prepareJoinTable(
-    std::vector<std::unique_ptr<BaseHashTable>> tables) {
+    std::vector<std::unique_ptr<BaseHashTable>> tables,
+    folly::Executor* executor) {
+  buildExecutor_ = executor;
+  auto resetExecutor = folly::makeGuard([&]() { buildExecutor_ = nullptr; });
   otherTables_.reserve(tables.size());
   for (auto& table : tables) {
     otherTables_.emplace_back(std::unique_ptr<HashTable<ignoreNullKeys>>(
@@ -1091,6 +1460,10 @@ void HashTable<ignoreNullKeys>::prepareJoinTable(
   } else {
     decideHashMode(0);
   }
+  // An array table has no tags.
+  const int64_t tableBytes =
+      size_ * (sizeof(char*) + (hashMode_ == HashMode::kArray ? 0 : 1));
+  setPartitionedJoinProbe(tableBytes >= kMinBytesForPartitionedProbe);
 }
 
 template <bool ignoreNullKeys>
@@ -1098,10 +1471,12 @@ int32_t HashTable<ignoreNullKeys>::listJoinResults(
     JoinResultIterator& iter,
     bool includeMisses,
     folly::Range<vector_size_t*> inputRows,
-    folly::Range<char**> hits) {
+    folly::Range<char**> hits,
+    uint64_t maxBytes) {
   VELOX_CHECK_LE(inputRows.size(), hits.size());
   int numOut = 0;
   auto maxOut = inputRows.size();
+  uint64_t totalBytes = 0;
   while (iter.lastRowIndex < iter.rows->size()) {
     if (!iter.nextHit) {
       auto row = (*iter.rows)[iter.lastRowIndex];
@@ -1131,11 +1506,12 @@ int32_t HashTable<ignoreNullKeys>::listJoinResults(
       inputRows[numOut] = (*iter.rows)[iter.lastRowIndex]; // NOLINT
       hits[numOut] = iter.nextHit;
       ++numOut;
+      totalBytes += rows_->rowSize(iter.nextHit);
       iter.nextHit = next;
       if (!iter.nextHit) {
         ++iter.lastRowIndex;
       }
-      if (numOut >= maxOut) {
+      if (numOut >= maxOut || totalBytes >= maxBytes) {
         return numOut;
       }
     }
@@ -1177,6 +1553,10 @@ void HashTable<ignoreNullKeys>::erase(folly::Range<char**> rows) {
   auto numRows = rows.size();
   raw_vector<uint64_t> hashes;
   hashes.resize(numRows);
+  raw_vector<uint64_t> highKeys;
+  if (hashMode_ == HashMode::kNormalizedKey128) {
+    highKeys.resize(numRows);
+  }
 
   for (int32_t i = 0; i < hashers_.size(); ++i) {
     auto& hasher = hashers_[i];
@@ -1190,18 +1570,19 @@ void HashTable<ignoreNullKeys>::erase(folly::Range<char**> rows) {
               column.offset(),
               column.nullByte(),
               ignoreNullKeys ? 0 : column.nullMask(),
-              hashes)) {
+              i < numLowKeys_ ? hashes : highKeys)) {
         VELOX_FAIL("Value ids in erase must exist for all keys");
       }
     }
   }
-  eraseWithHashes(rows, hashes.data());
+  eraseWithHashes(rows, hashes.data(), highKeys.data());
 }
 
 template <bool ignoreNullKeys>
 void HashTable<ignoreNullKeys>::eraseWithHashes(
     folly::Range<char**> rows,
-    uint64_t* hashes) {
+    uint64_t* hashes,
+    const uint64_t* highKeys) {
   auto numRows = rows.size();
   if (hashMode_ == HashMode::kArray) {
     for (auto i = 0; i < numRows; ++i) {
@@ -1213,6 +1594,10 @@ void HashTable<ignoreNullKeys>::eraseWithHashes(
       for (auto i = 0; i < numRows; ++i) {
         hashes[i] = mixNormalizedKey(hashes[i], sizeBits_);
       }
+    } else if (hashMode_ == HashMode::kNormalizedKey128) {
+      for (auto i = 0; i < numRows; ++i) {
+        hashes[i] = mixNormalizedKey128(hashes[i], highKeys[i], sizeBits_);
+      }
     }
 
     ProbeState state;
@@ -1234,6 +1619,23 @@ void HashTable<ignoreNullKeys>::eraseWithHashes(
   rows_->eraseRows(rows);
 }
 
+template <bool ignoreNullKeys>
+void HashTable<ignoreNullKeys>::compact() {
+  VELOX_CHECK(!isJoinBuild_, "Cannot compact a hash join build side");
+  if (rows_->numFreeRows() == 0) {
+    return;
+  }
+  rows_->compact();
+  // The rows moved, so the table is rebuilt from the rows.
+  if (hashMode_ != HashMode::kArray && tags_) {
+    memset(tags_, 0, size_);
+  }
+  if (table_) {
+    memset(table_, 0, sizeof(char*) * size_);
+  }
+  rehash();
+}
+
 template class HashTable<true>;
 template class HashTable<false>;
 
@@ -19,6 +19,7 @@
 #include "velox/exec/Aggregate.h"
 #include "velox/exec/Operator.h"
 #include "velox/exec/RowContainer.h"
+#include "velox/exec/Spiller.h"
 #include "velox/exec/VectorHasher.h"
 
 namespace facebook::velox::exec {
@@ -42,10 +43,18 @@ struct HashLookup {
   raw_vector<uint64_t> hashes;
   // If using valueIds, list of concatenated valueIds. 1:1 with 'hashes'.
   raw_vector<uint64_t> normalizedKeys;
+  // High words of the normalized keys in kNormalizedKey128 mode. Filled
+  // with the value ids of the keys that do not fit in the low word. 1:1
+  // with 'hashes'.
+  raw_vector<uint64_t> highKeys;
   // Hit for each row of input. nullptr if no hit. Points to the
   // corresponding group row.
   raw_vector<char*> hits;
   std::vector<vector_size_t> newGroups;
+  // 'rows' grouped by probe partition of a partitioned join probe.
+  raw_vector<vector_size_t> partitionedRows;
+  // Scratch for counting the rows of each probe partition.
+  std::vector<vector_size_t> partitionStarts;
 };
 
 class BaseHashTable {
@@ -54,15 +63,21 @@ class BaseHashTable {
 
 #if XSIMD_WITH_SSE2
   using TagVector = xsimd::batch<uint8_t, xsimd::sse2>;
+  using NormalizedKey128 = xsimd::batch<uint64_t, xsimd::sse2>;
 #elif XSIMD_WITH_NEON
   using TagVector = xsimd::batch<uint8_t, xsimd::neon>;
+  using NormalizedKey128 = xsimd::batch<uint64_t, xsimd::neon>;
 #endif
 
   using MaskType = uint16_t;
 
   // 2M entries, i.e. 16MB is the largest array based hash table.
   static constexpr uint64_t kArrayHashMaxSize = 2L << 20;
-  enum class HashMode { kHash, kArray, kNormalizedKey };
+  // kNormalizedKey packs the value ids of all keys into one 64 bit
+  // word. kNormalizedKey128 packs the value ids of a prefix of the keys
+  // into a low word and the rest into a high word when they do not fit
+  // in 64 bits. Only join builds use kNormalizedKey128.
+  enum class HashMode { kHash, kArray, kNormalizedKey, kNormalizedKey128 };
 
   // Keeps track of results returned from a join table. One batch of
   // keys can produce multiple batches of results. This is initialized
@@ -97,7 +112,7 @@ class BaseHashTable {
   /// population while adding payload for either aggregation or join
   /// build.
   explicit BaseHashTable(std::vector<std::unique_ptr<VectorHasher>>&& hashers)
-      : hashers_(std::move(hashers)) {}
+      : hashers_(std::move(hashers)), numLowKeys_(hashers_.size()) {}
 
   virtual ~BaseHashTable() = default;
 
@@ -114,8 +129,9 @@ class BaseHashTable {
 
   /// Fills 'hits' with consecutive hash join results. The corresponding element
   /// of 'inputRows' is set to the corresponding row number in probe keys.
-  /// Returns the number of hits produced. If this s less than hits.size() then
-  /// all the hits have been produced.
+  /// Returns the number of hits produced. Stops after the hits whose build
+  /// side rows add up to 'maxBytes', so that a key with many matches produces
+  /// several batches. All the hits have been produced when 'iter' is at end.
   /// Adds input rows without a match to 'inputRows' with corresponding hit
   /// set to nullptr if 'includeMisses' is true. Otherwise, skips input rows
   /// without a match. 'includeMisses' is set to true when listing results for
@@ -124,7 +140,8 @@ class BaseHashTable {
       JoinResultIterator& iter,
       bool includeMisses,
       folly::Range<vector_size_t*> inputRows,
-      folly::Range<char**> hits) = 0;
+      folly::Range<char**> hits,
+      uint64_t maxBytes) = 0;
 
   /// Returns rows with 'probed' flag unset. Used by the right join.
   virtual int32_t listNotProbedRows(
@@ -133,8 +150,20 @@ class BaseHashTable {
       uint64_t maxBytes,
       char** rows) = 0;
 
+  /// Combines 'tables' into 'this' for use as a join build side. If
+  /// 'executor' is given, the build of the table may be split by hash range
+  /// and run in parallel on 'executor' and the calling thread.
   virtual void prepareJoinTable(
-      std::vector<std::unique_ptr<BaseHashTable>> tables) = 0;
+      std::vector<std::unique_ptr<BaseHashTable>> tables,
+      folly::Executor* executor = nullptr) = 0;
+
+  /// Enables or disables grouping the rows of a joinProbe() by region of
+  /// the table. prepareJoinTable() enables this if the table is too large
+  /// to stay in cache. Used by benchmarks and tests to compare the two.
+  virtual void setPartitionedJoinProbe(bool enable) = 0;
+
+  /// Returns true if joinProbe() groups its rows by region of the table.
+  virtual bool partitionedJoinProbe() const = 0;
 
   /// Returns the memory footprint in bytes for any data structures
   /// owned by 'this'.
@@ -181,6 +210,12 @@ class BaseHashTable {
   // and be unique.
   virtual void erase(folly::Range<char**> rows) = 0;
 
+  // Moves the rows of the RowContainer into dense storage after erasures
+  // and releases the memory they no longer need. See
+  // RowContainer::compact(). Pointers to the rows are invalid after this.
+  // Not supported for join build sides.
+  virtual void compact() = 0;
+
   /// Returns a brief description for use in debugging.
   virtual std::string toString() = 0;
 
@@ -192,6 +227,18 @@ class BaseHashTable {
     return hashers_;
   }
 
+  /// Returns the vector of 'lookup' that receives the value ids of the
+  /// key at 'index' when the hash mode is not kHash. This is
+  /// 'lookup.hashes' except for the keys of the high word of a
+  /// kNormalizedKey128 table, which go to 'lookup.highKeys'.
+  raw_vector<uint64_t>& valueIds(HashLookup& lookup, int32_t index) const {
+    if (index < numLowKeys_) {
+      return lookup.hashes;
+    }
+    lookup.highKeys.resize(lookup.hashes.size());
+    return lookup.highKeys;
+  }
+
   RowContainer* rows() const {
     return rows_.get();
   }
@@ -220,9 +267,24 @@ class BaseHashTable {
     return table[index];
   }
 
+  /// Returns true if the two word normalized key below 'group' is 'low'
+  /// and 'high'. Compares both words with one SIMD instruction.
+  static bool equalsNormalizedKey128(
+      const char* group,
+      uint64_t low,
+      uint64_t high) {
+    // The high word is below the low word.
+    auto stored = NormalizedKey128::load_unaligned(
+        reinterpret_cast<const uint64_t*>(group) - 2);
+    return xsimd::all(stored == NormalizedKey128(high, low));
+  }
+
  protected:
   virtual void setHashMode(HashMode mode, int32_t numNew) = 0;
   std::vector<std::unique_ptr<VectorHasher>> hashers_;
+  // Number of leading 'hashers_' whose value ids make up the low word of
+  // a kNormalizedKey128 key. The size of 'hashers_' in other modes.
+  int32_t numLowKeys_;
   std::unique_ptr<RowContainer> rows_;
 };
 
@@ -288,7 +350,8 @@ class HashTable : public BaseHashTable {
       JoinResultIterator& iter,
       bool includeMisses,
       folly::Range<vector_size_t*> inputRows,
-      folly::Range<char**> hits) override;
+      folly::Range<char**> hits,
+      uint64_t maxBytes) override;
 
   int32_t listNotProbedRows(
       NotProbedRowsIterator* iter,
@@ -324,6 +387,8 @@ class HashTable : public BaseHashTable {
 
   void erase(folly::Range<char**> rows) override;
 
+  void compact() override;
+
   // Moves the contents of 'tables' into 'this' and prepares 'this'
   // for use in hash join probe. A hash join build side is prepared as
   // follows: 1. Each build side thread gets a random selection of the
@@ -334,8 +399,40 @@ class HashTable : public BaseHashTable {
   // tables are filled, they are combined into one top level table
   // with prepareJoinTable. This then takes ownership of all the data
   // and VectorHashers and decides the hash mode and representation.
+  // 2. If 'executor' is set and the build side is large, the insertion
+  // into the table is partitioned by ranges of the hash table, one per
+  // build side table, and the partitions are filled in parallel.
   void prepareJoinTable(
-      std::vector<std::unique_ptr<BaseHashTable>> tables) override;
+      std::vector<std::unique_ptr<BaseHashTable>> tables,
+      folly::Executor* executor = nullptr) override;
+
+  // Minimum number of build side rows for a parallel join table build.
+  static constexpr int64_t kMinRowsForParallelJoinBuild = 10'000;
+
+  // Minimum size in bytes of the tags and row pointers of a join table
+  // for partitioning the probe. Smaller tables mostly stay in the last
+  // level cache.
+  static constexpr int64_t kMinBytesForPartitionedProbe = 32 << 20;
+
+  // A probe partition has 2^kProbePartitionSlotBits table slots, i.e.
+  // 256KB of row pointers, which fits in a second level cache. Tables
+  // with more than kMaxProbePartitionBits partitions of this size get
+  // larger partitions.
+  static constexpr int32_t kProbePartitionSlotBits = 15;
+
+  // Maximum number of bits in a probe partition number. More partitions
+  // would leave too few rows of a probe batch in each.
+  static constexpr int32_t kMaxProbePartitionBits = 6;
+
+  // Minimum number of rows in a joinProbe() for grouping the rows by
+  // partition.
+  static constexpr int32_t kMinRowsForPartitionedProbe = 256;
+
+  void setPartitionedJoinProbe(bool enable) override;
+
+  bool partitionedJoinProbe() const override {
+    return probePartitionBits_.has_value();
+  }
 
   uint64_t hashTableSizeIncrease(int32_t numNewDistinct) const override {
     if (numDistinct_ + numNewDistinct > rehashSize()) {
@@ -355,6 +452,11 @@ class HashTable : public BaseHashTable {
     return size_ - (size_ / 8);
   }
 
+  // Sets 'lookup.partitionedRows' to 'lookup.rows' grouped by the probe
+  // partition of their table slot and returns it. The rows of a partition
+  // keep their order.
+  const raw_vector<vector_size_t>& partitionProbeRows(HashLookup& lookup);
+
   char*& nextRow(char* row) {
     return *reinterpret_cast<char**>(row + nextOffset_);
   }
@@ -382,6 +484,24 @@ class HashTable : public BaseHashTable {
   void clearUseRange(std::vector<bool>& useRange);
 
   void rehash();
+
+  // True if the rehash of a join build side can be run in parallel on
+  // 'buildExecutor_'.
+  bool canApplyParallelJoinBuild() const;
+
+  // Rebuilds the join table from the rows of 'this' and 'otherTables_'. Each
+  // of the partitions of the table between 'partitionSize' boundaries is
+  // filled by a separate thread from the rows whose hash falls in the
+  // partition. The rows whose probe would cross the end of their partition
+  // are inserted serially at the end. Returns false if the keys cannot be
+  // mapped to normalized keys, in which case the table must switch to kHash.
+  bool parallelJoinBuild();
+
+  // Inserts 'row' with 'hash' into a join table if there is a free slot or
+  // a row with the same key before 'partitionEnd' on the probe path of
+  // 'hash'. Returns false if the probe would cross 'partitionEnd'.
+  bool insertForJoinInPartition(char* row, uint64_t hash, int64_t partitionEnd);
+
   void initializeNewGroups(HashLookup& lookup);
   void storeKeys(HashLookup& lookup, vector_size_t row);
 
@@ -394,21 +514,87 @@ class HashTable : public BaseHashTable {
   void checkSize(int32_t numNew);
 
   // Computes hash numbers of the appropriate hash mode for 'groups',
-  // stores these in 'hashes' and inserts the groups using
-  // insertForJoin or insertForGroupBy.
-  bool
-  insertBatch(char** groups, int32_t numGroups, raw_vector<uint64_t>& hashes);
+  // stores these in 'hashes', stores the normalized keys, if any, and
+  // inserts the groups using insertForJoin or insertForGroupBy.
+  // 'highKeys' is scratch for the high words of normalized keys.
+  bool insertBatch(
+      char** groups,
+      int32_t numGroups,
+      raw_vector<uint64_t>& hashes,
+      raw_vector<uint64_t>& highKeys);
+
+  // Computes the hash numbers of the appropriate hash mode for 'groups' into
+  // 'hashes'. In kNormalizedKey128 mode, 'hashes' gets the low and
+  // 'highKeys' the high words of the normalized keys. Returns false if the
+  // keys do not map to value ids in kArray or normalized key modes. Does
+  // not change 'this' in kHash mode.
+  bool hashRows(
+      char** groups,
+      int32_t numGroups,
+      raw_vector<uint64_t>& hashes,
+      raw_vector<uint64_t>& highKeys);
+
+  // Writes the normalized keys of 'groups' below the rows and replaces
+  // 'hashes' with the hash numbers for the table. 'hashes' and, in
+  // kNormalizedKey128 mode, 'highKeys' are the normalized keys from
+  // hashRows(). Does nothing in kHash and kArray modes.
+  void storeNormalizedKeys(
+      char** groups,
+      int32_t numGroups,
+      uint64_t* hashes,
+      const uint64_t* highKeys);
+
+  // True in kNormalizedKey and kNormalizedKey128 modes.
+  bool hasNormalizedKeys() const {
+    return hashMode_ == HashMode::kNormalizedKey ||
+        hashMode_ == HashMode::kNormalizedKey128;
+  }
+
+  // Offset of the normalized key from the start of a row.
+  int32_t normalizedKeyOffset() const {
+    return -static_cast<int32_t>(sizeof(normalized_key_t)) *
+        (hashMode_ == HashMode::kNormalizedKey128 ? 2 : 1);
+  }
+
+  // Returns true if the normalized keys of 'group' and 'row' are equal.
+  bool equalNormalizedKeys(char* group, char* row) const {
+    if (hashMode_ == HashMode::kNormalizedKey128) {
+      return equalsNormalizedKey128(
+          group,
+          RowContainer::normalizedKey(row),
+          RowContainer::normalizedKeyHigh(row));
+    }
+    return RowContainer::normalizedKey(group) ==
+        RowContainer::normalizedKey(row);
+  }
+
+  // Tries to split the keys into a low and a high word of at most 64 bits
+  // each, using ranges where 'useRange' is set and distinct values
+  // elsewhere. If the keys fit, sets the VectorHashers to the split and
+  // returns true.
+  bool trySplitNormalizedKey(
+      const std::vector<bool>& useRange,
+      const std::vector<uint64_t>& rangeSizes,
+      const std::vector<uint64_t>& distinctSizes);
 
   // Inserts 'numGroups' entries into 'this'. 'groups' point to
   // contents in a RowContainer owned by 'this'. 'hashes' are te hash
-  // numbers or array indices (if kArray mode) for each
-  // group. Duplicate key rows are chained via their next link.
+  // numbers or array indices (if kArray mode) for each group. The
+  // normalized keys, if any, are already stored in the rows. Duplicate
+  // key rows are chained via their next link.
   void insertForJoin(char** groups, uint64_t* hashes, int32_t numGroups);
 
+  // Inserts 'numGroups' entries into a join table not in kArray mode. The
+  // normalized keys, if any, are already stored in the rows and 'hashes'
+  // are the hash numbers for the table.
+  void
+  insertHashedForJoin(char** groups, uint64_t* hashes, int32_t numGroups);
+
   // Inserts 'numGroups' entries into 'this'. 'groups' point to
   // contents in a RowContainer owned by 'this'. 'hashes' are te hash
-  // numbers or array indices (if kArray mode) for each
-  // group. 'groups' is expectedd to have no duplicate keys.
+  // numbers or array indices (if kArray mode) for each group. The
+  // normalized keys, if any, are already stored in the rows. 'groups' is
+  // expectedd to have no duplicate keys.
 
   void insertForGroupBy(char** groups, uint64_t* hashes, int32_t numGroups);
 
@@ -439,8 +625,11 @@ class HashTable : public BaseHashTable {
   // for array or normalized key.
   bool analyze();
   // Erases the entries of rows from the hash table and its RowContainer.
-  // 'hashes' must be computed according to 'hashMode_'.
-  void eraseWithHashes(folly::Range<char**> rows, uint64_t* hashes);
+  // 'hashes' and 'highKeys' must be computed according to 'hashMode_'.
+  void eraseWithHashes(
+      folly::Range<char**> rows,
+      uint64_t* hashes,
+      const uint64_t* highKeys);
 
   // Returns the percentage of values to reserve for new keys in range
   // or distinct mode VectorHashers in a group by hash table. 0 for
@@ -454,8 +643,9 @@ class HashTable : public BaseHashTable {
   bool isJoinBuild_ = false;
 
   // Set at join build time if the table has duplicates, meaning
-  // that the join can be cardinality increasing.
-  bool hasDuplicates_ = false;
+  // that the join can be cardinality increasing. Atomic since a
+  // parallel join build sets this from multiple threads.
+  std::atomic<bool> hasDuplicates_{false};
 
   // Offset of next row link for join build side, 0 if none. Copied
   // from 'rows_'.
@@ -470,6 +660,17 @@ class HashTable : public BaseHashTable {
   // Owns the memory of multiple build side hash join tables that are
   // combined into a single probe hash table.
   std::vector<std::unique_ptr<HashTable<ignoreNullKeys>>> otherTables_;
+
+  // Executor for a parallel join build. Set only for the duration of
+  // prepareJoinTable().
+  folly::Executor* buildExecutor_{nullptr};
+
+  // The high bits of a table slot number for a partitioned join probe.
+  // Each value is a contiguous range of 'tags_' and 'table_' that fits in
+  // cache. joinProbe() probes the rows of a batch one partition at a time
+  // so that the tags and row pointers of a partition stay in cache
+  // while it is probed. Not set for tables that fit in cache.
+  std::optional<HashBitRange> probePartitionBits_;
 };
 
 } // namespace facebook::velox::exec
@@ -38,6 +38,10 @@ class Limit : public Operator {
     return finished_ || (noMoreInput_ && input_ == nullptr);
   }
 
+  std::optional<int64_t> rowLimit() const override {
+    return remainingOffset_ + remainingLimit_;
+  }
+
  private:
   int32_t remainingOffset_;
   int32_t remainingLimit_;
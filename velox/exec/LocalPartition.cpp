@@ -29,101 +29,116 @@ void notify(std::vector<ContinuePromise>& promises) {
 bool LocalExchangeMemoryManager::increaseMemoryUsage(
     ContinueFuture* future,
     int64_t added) {
+  if ((bufferedBytes_ += added) < maxBufferSize_) {
+    return false;
+  }
   std::lock_guard<std::mutex> l(mutex_);
-  bufferedBytes_ += added;
-
-  if (bufferedBytes_ >= maxBufferSize_) {
-    promises_.emplace_back("LocalExchangeMemoryManager::updateMemoryUsage");
-    *future = promises_.back().getSemiFuture();
-    return true;
+  // A consumer that brought the size below the limit after the update above
+  // takes 'mutex_' after this and completes the promise.
+  if (bufferedBytes_ < maxBufferSize_) {
+    return false;
   }
-
-  return false;
+  promises_.emplace_back("LocalExchangeMemoryManager::updateMemoryUsage");
+  *future = promises_.back().getSemiFuture();
+  return true;
 }
 
 void LocalExchangeMemoryManager::decreaseMemoryUsage(int64_t removed) {
+  const auto bufferedBytes = bufferedBytes_ -= removed;
+  if (bufferedBytes >= maxBufferSize_ ||
+      bufferedBytes + removed < maxBufferSize_) {
+    return;
+  }
   std::vector<ContinuePromise> promises;
   {
     std::lock_guard<std::mutex> l(mutex_);
-    bufferedBytes_ -= removed;
-
-    if (bufferedBytes_ < maxBufferSize_ &&
-        bufferedBytes_ + removed >= maxBufferSize_) {
-      promises = std::move(promises_);
-    }
+    promises = std::move(promises_);
   }
-
   notify(promises);
 }
 
 void LocalExchangeQueue::addProducer() {
-  queue_.withWLock([&](auto& /*queue*/) {
-    VELOX_CHECK(!noMoreProducers_, "addProducer called after noMoreProducers");
-    ++pendingProducers_;
-  });
+  std::lock_guard<std::mutex> l(mutex_);
+  VELOX_CHECK(!noMoreProducers_, "addProducer called after noMoreProducers");
+  ++pendingProducers_;
+}
+
+std::vector<ContinuePromise> LocalExchangeQueue::takeConsumerPromisesLocked() {
+  consumersWaiting_ = false;
+  return std::move(consumerPromises_);
 }
 
 void LocalExchangeQueue::noMoreProducers() {
   std::vector<ContinuePromise> consumerPromises;
   std::vector<ContinuePromise> producerPromises;
-  queue_.withWLock([&](auto& queue) {
+  {
+    std::lock_guard<std::mutex> l(mutex_);
     VELOX_CHECK(!noMoreProducers_, "noMoreProducers can be called only once");
     noMoreProducers_ = true;
     if (pendingProducers_ == 0) {
       // No more data will be produced.
-      consumerPromises = std::move(consumerPromises_);
+      producersFinished_ = true;
+      std::atomic_thread_fence(std::memory_order_seq_cst);
+      consumerPromises = takeConsumerPromisesLocked();
 
-      if (queue.empty()) {
+      if (queue_.empty()) {
         // All data has been consumed.
         producerPromises = std::move(producerPromises_);
       }
     }
-  });
+  }
   notify(consumerPromises);
   notify(producerPromises);
 }
 
 BlockingReason LocalExchangeQueue::enqueue(
     RowVectorPtr input,
+    int64_t inputBytes,
     ContinueFuture* future) {
-  auto inputBytes = input->retainedSize();
-
-  std::vector<ContinuePromise> consumerPromises;
-  bool isClosed = queue_.withWLock([&](auto& queue) {
-    if (closed_) {
-      return true;
-    }
-    queue.push(std::move(input));
-    consumerPromises = std::move(consumerPromises_);
-    return false;
-  });
-
-  if (isClosed) {
+  if (closed_) {
     return BlockingReason::kNotBlocked;
   }
-
-  notify(consumerPromises);
-
-  if (memoryManager_->increaseMemoryUsage(future, inputBytes)) {
-    return BlockingReason::kWaitForConsumer;
+  // The memory is accounted before the data is visible to consumers, which
+  // subtract it.
+  const bool blocked = memoryManager_->increaseMemoryUsage(future, inputBytes);
+  queue_.enqueue(QueuedVector{std::move(input), inputBytes});
+
+  // Either this sees a consumer that is about to wait or the consumer sees
+  // the data. The same holds for close().
+  std::atomic_thread_fence(std::memory_order_seq_cst);
+  if (closed_) {
+    dropData();
+    return BlockingReason::kNotBlocked;
+  }
+  if (consumersWaiting_) {
+    std::vector<ContinuePromise> consumerPromises;
+    {
+      std::lock_guard<std::mutex> l(mutex_);
+      consumerPromises = takeConsumerPromisesLocked();
+    }
+    notify(consumerPromises);
   }
 
-  return BlockingReason::kNotBlocked;
+  return blocked ? BlockingReason::kWaitForConsumer
+                 : BlockingReason::kNotBlocked;
 }
 
 void LocalExchangeQueue::noMoreData() {
   std::vector<ContinuePromise> consumerPromises;
   std::vector<ContinuePromise> producerPromises;
-  queue_.withWLock([&](auto queue) {
+  {
+    std::lock_guard<std::mutex> l(mutex_);
     VELOX_CHECK_GT(pendingProducers_, 0);
     --pendingProducers_;
     if (noMoreProducers_ && pendingProducers_ == 0) {
-      consumerPromises = std::move(consumerPromises_);
-      if (queue.empty()) {
+      producersFinished_ = true;
+      std::atomic_thread_fence(std::memory_order_seq_cst);
+      consumerPromises = takeConsumerPromisesLocked();
+      if (queue_.empty()) {
         producerPromises = std::move(producerPromises_);
       }
     }
-  });
+  }
   notify(consumerPromises);
   notify(producerPromises);
 }
@@ -132,42 +147,49 @@ BlockingReason LocalExchangeQueue::next(
     ContinueFuture* future,
     memory::MemoryPool* pool,
     RowVectorPtr* data) {
-  std::vector<ContinuePromise> producerPromises;
-  auto blockingReason = queue_.withWLock([&](auto& queue) {
-    *data = nullptr;
-    if (queue.empty()) {
-      if (isFinishedLocked(queue)) {
+  *data = nullptr;
+  QueuedVector queued;
+  if (!queue_.try_dequeue(queued)) {
+    std::lock_guard<std::mutex> l(mutex_);
+    // Set before checking the queue again so that a producer adding data
+    // after the check sees the waiting consumer.
+    consumersWaiting_ = true;
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    if (!queue_.try_dequeue(queued)) {
+      if (isFinishedLocked()) {
+        consumersWaiting_ = !consumerPromises_.empty();
         return BlockingReason::kNotBlocked;
       }
-
       consumerPromises_.emplace_back("LocalExchangeQueue::next");
       *future = consumerPromises_.back().getSemiFuture();
-
       return BlockingReason::kWaitForExchange;
     }
+    consumersWaiting_ = !consumerPromises_.empty();
+  }
 
-    *data = queue.front();
-    queue.pop();
-
-    memoryManager_->decreaseMemoryUsage((*data)->retainedSize());
+  *data = std::move(queued.vector);
+  memoryManager_->decreaseMemoryUsage(queued.bytes);
 
-    if (noMoreProducers_ && pendingProducers_ == 0 && queue.empty()) {
+  // Pairs with the fence in noMoreData() and noMoreProducers(): either the
+  // last producer sees the empty queue or this sees the producers finished.
+  std::atomic_thread_fence(std::memory_order_seq_cst);
+  if (producersFinished_ && queue_.empty()) {
+    std::vector<ContinuePromise> producerPromises;
+    {
+      std::lock_guard<std::mutex> l(mutex_);
       producerPromises = std::move(producerPromises_);
     }
-
-    return BlockingReason::kNotBlocked;
-  });
-  notify(producerPromises);
-  return blockingReason;
+    notify(producerPromises);
+  }
+  return BlockingReason::kNotBlocked;
 }
 
-bool LocalExchangeQueue::isFinishedLocked(
-    const std::queue<RowVectorPtr>& queue) const {
+bool LocalExchangeQueue::isFinishedLocked() const {
   if (closed_) {
     return true;
   }
 
-  if (noMoreProducers_ && pendingProducers_ == 0 && queue.empty()) {
+  if (producersFinished_ && queue_.empty()) {
     return true;
   }
 
@@ -175,40 +197,43 @@ bool LocalExchangeQueue::isFinishedLocked(
 }
 
 BlockingReason LocalExchangeQueue::isFinished(ContinueFuture* future) {
-  return queue_.withWLock([&](auto& queue) {
-    if (isFinishedLocked(queue)) {
-      return BlockingReason::kNotBlocked;
-    }
+  std::lock_guard<std::mutex> l(mutex_);
+  if (isFinishedLocked()) {
+    return BlockingReason::kNotBlocked;
+  }
 
-    producerPromises_.emplace_back("LocalExchangeQueue::isFinished");
-    *future = producerPromises_.back().getSemiFuture();
+  producerPromises_.emplace_back("LocalExchangeQueue::isFinished");
+  *future = producerPromises_.back().getSemiFuture();
 
-    return BlockingReason::kWaitForConsumer;
-  });
+  return BlockingReason::kWaitForConsumer;
 }
 
 bool LocalExchangeQueue::isFinished() {
-  return queue_.withWLock([&](auto& queue) { return isFinishedLocked(queue); });
+  std::lock_guard<std::mutex> l(mutex_);
+  return isFinishedLocked();
+}
+
+void LocalExchangeQueue::dropData() {
+  uint64_t freedBytes = 0;
+  QueuedVector queued;
+  while (queue_.try_dequeue(queued)) {
+    freedBytes += queued.bytes;
+  }
+  if (freedBytes) {
+    memoryManager_->decreaseMemoryUsage(freedBytes);
+  }
 }
 
 void LocalExchangeQueue::close() {
   std::vector<ContinuePromise> producerPromises;
   std::vector<ContinuePromise> consumerPromises;
-  queue_.withWLock([&](auto& queue) {
-    uint64_t freedBytes = 0;
-    while (!queue.empty()) {
-      freedBytes += queue.front()->retainedSize();
-      queue.pop();
-    }
-
-    if (freedBytes) {
-      memoryManager_->decreaseMemoryUsage(freedBytes);
-    }
-
-    producerPromises = std::move(producerPromises_);
-    consumerPromises = std::move(consumerPromises_);
+  {
+    std::lock_guard<std::mutex> l(mutex_);
     closed_ = true;
-  });
+    producerPromises = std::move(producerPromises_);
+    consumerPromises = takeConsumerPromisesLocked();
+  }
+  dropData();
   notify(producerPromises);
   notify(consumerPromises);
 }
@@ -333,6 +358,7 @@ wrapChildren(const RowVectorPtr& input, vector_size_t size, BufferPtr indices) {
 BlockingReason LocalPartition::enqueue(
     int32_t partition,
     RowVectorPtr data,
+    int64_t dataBytes,
     ContinueFuture* future) {
   RowVectorPtr projectedData;
   if (sourceOutputChannels_.empty() && outputType_->size() > 0) {
@@ -348,7 +374,7 @@ BlockingReason LocalPartition::enqueue(
         data->pool(), outputType_, nullptr, data->size(), outputColumns);
   }
 
-  return queues_[partition]->enqueue(projectedData, future);
+  return queues_[partition]->enqueue(projectedData, dataBytes, future);
 }
 
 void LocalPartition::addInput(RowVectorPtr input) {
@@ -361,9 +387,13 @@ void LocalPartition::addInput(RowVectorPtr input) {
   }
 
   input_ = std::move(input);
+  // Measured once per input. The partitions are dictionaries over the same
+  // children, so measuring each of them would count the input once per
+  // partition.
+  const int64_t inputBytes = input_->deduplicatedRetainedSize();
 
   if (numPartitions_ == 1) {
-    blockingReasons_[0] = enqueue(0, input_, &futures_[0]);
+    blockingReasons_[0] = enqueue(0, input_, inputBytes, &futures_[0]);
     if (blockingReasons_[0] != BlockingReason::kNotBlocked) {
       numBlockedPartitions_ = 1;
     }
@@ -388,11 +418,14 @@ void LocalPartition::addInput(RowVectorPtr input) {
         continue;
       }
       indexBuffers[i]->setSize(partitionSize * sizeof(vector_size_t));
+      // Each partition is charged its indices and its share of the input.
+      const int64_t partitionBytes = indexBuffers[i]->capacity() +
+          inputBytes * partitionSize / numInput;
       auto partitionData =
           wrapChildren(input_, partitionSize, std::move(indexBuffers[i]));
 
       ContinueFuture future;
-      auto reason = enqueue(i, partitionData, &future);
+      auto reason = enqueue(i, partitionData, partitionBytes, &future);
       if (reason != BlockingReason::kNotBlocked) {
         blockingReasons_[numBlockedPartitions_] = reason;
         futures_[numBlockedPartitions_] = std::move(future);
@@ -15,13 +15,17 @@
  */
 #pragma once
 
+#include <folly/concurrency/UnboundedQueue.h>
+
 #include "velox/exec/Operator.h"
 #include "velox/exec/VectorHasher.h"
 
 namespace facebook::velox::exec {
 
 /// Keeps track of the total size in bytes of the data buffered in all
-/// LocalExchangeQueues.
+/// LocalExchangeQueues. The size is updated without locking. The mutex is
+/// taken only by producers that reach the limit and by consumers bringing the
+/// size back below the limit.
 class LocalExchangeMemoryManager {
  public:
   explicit LocalExchangeMemoryManager(int64_t maxBufferSize)
@@ -35,8 +39,9 @@ class LocalExchangeMemoryManager {
 
  private:
   const int64_t maxBufferSize_;
+  std::atomic<int64_t> bufferedBytes_{0};
+  // Guards 'promises_'.
   std::mutex mutex_;
-  int64_t bufferedBytes_{0};
   std::vector<ContinuePromise> promises_;
 };
 
@@ -46,6 +51,12 @@ class LocalExchangeMemoryManager {
 /// must be called after all producers have been registered. A producer calls
 /// 'enqueue' multiple time to put the data and calls 'noMoreData' when done.
 /// Consumers call 'next' repeatedly to fetch the data.
+///
+/// The data is kept in a lock-free queue so that producers and consumers do
+/// not contend on a mutex while data is flowing. The mutex is taken only to
+/// register or complete the futures of blocked consumers and producers and to
+/// change the set of producers. The size of the queue is bounded by the
+/// memory limit of 'memoryManager'.
 class LocalExchangeQueue {
  public:
   LocalExchangeQueue(
@@ -63,8 +74,11 @@ class LocalExchangeQueue {
 
   /// Used by a producer to add data. Returning kNotBlocked if can accept more
   /// data. Otherwise returns kWaitForConsumer and sets future that will be
-  /// completed when ready to accept more data.
-  BlockingReason enqueue(RowVectorPtr input, ContinueFuture* future);
+  /// completed when ready to accept more data. 'inputBytes' is the memory
+  /// charged to 'memoryManager_' for 'input'. The same amount is released
+  /// when 'input' leaves the queue.
+  BlockingReason
+  enqueue(RowVectorPtr input, int64_t inputBytes, ContinueFuture* future);
 
   /// Called by a producer to indicate that no more data will be added.
   void noMoreData();
@@ -94,11 +108,31 @@ class LocalExchangeQueue {
   void close();
 
  private:
-  bool isFinishedLocked(const std::queue<RowVectorPtr>& queue) const;
+  // Must be called with 'mutex_' held.
+  bool isFinishedLocked() const;
+
+  // Takes the promises of the consumers waiting for data. Must be called with
+  // 'mutex_' held.
+  std::vector<ContinuePromise> takeConsumerPromisesLocked();
+
+  // Drops the data of a closed queue and returns the memory to
+  // 'memoryManager_'.
+  void dropData();
 
   std::shared_ptr<LocalExchangeMemoryManager> memoryManager_;
   const int partition_;
-  folly::Synchronized<std::queue<RowVectorPtr>> queue_;
+  // A vector and the bytes charged for it, so that the bytes released when
+  // the vector is dequeued match those added, without measuring the vector
+  // again.
+  struct QueuedVector {
+    RowVectorPtr vector;
+    int64_t bytes;
+  };
+
+  folly::UMPMCQueue<QueuedVector, false> queue_;
+
+  // Guards the promises and the producer counts below.
+  std::mutex mutex_;
   // Satisfied when data becomes available or all producers report that they
   // finished producing, e.g. queue_ is not empty or noMoreProducers_ is true
   // and pendingProducers_ is zero.
@@ -109,7 +143,13 @@ class LocalExchangeQueue {
   std::vector<ContinuePromise> producerPromises_;
   int pendingProducers_{0};
   bool noMoreProducers_{false};
-  bool closed_{false};
+
+  // True if 'consumerPromises_' may be non-empty. Lets producers skip
+  // 'mutex_' when no consumer waits.
+  std::atomic<bool> consumersWaiting_{false};
+  // True if noMoreProducers_ is true and pendingProducers_ is zero.
+  std::atomic<bool> producersFinished_{false};
+  std::atomic<bool> closed_{false};
 };
 
 /// Fetches data for a single partition produced by local exchange from
@@ -188,8 +228,11 @@ class LocalPartition : public Operator {
   }
 
  private:
-  BlockingReason
-  enqueue(int32_t partition, RowVectorPtr data, ContinueFuture* future);
+  BlockingReason enqueue(
+      int32_t partition,
+      RowVectorPtr data,
+      int64_t dataBytes,
+      ContinueFuture* future);
 
   const std::vector<std::shared_ptr<LocalExchangeQueue>> queues_;
   const size_t numPartitions_;
@@ -15,6 +15,7 @@
  */
 #include "velox/exec/LocalPlanner.h"
 #include "velox/core/PlanFragment.h"
+#include "velox/exec/ArrowStream.h"
 #include "velox/exec/AssignUniqueId.h"
 #include "velox/exec/CallbackSink.h"
 #include "velox/exec/CrossJoinBuild.h"
@@ -37,6 +38,7 @@
 #include "velox/exec/TopN.h"
 #include "velox/exec/Unnest.h"
 #include "velox/exec/Values.h"
+#include "velox/exec/Window.h"
 
 namespace facebook::velox::exec {
 
@@ -164,7 +166,9 @@ uint32_t maxDriversForConsumer(
   return std::numeric_limits<uint32_t>::max();
 }
 
-uint32_t maxDrivers(const DriverFactory& driverFactory) {
+uint32_t maxDrivers(
+    const DriverFactory& driverFactory,
+    const core::QueryConfig& queryConfig) {
   uint32_t count = maxDriversForConsumer(driverFactory.consumerNode);
   if (count == 1) {
     return count;
@@ -181,6 +185,9 @@ uint32_t maxDrivers(const DriverFactory& driverFactory) {
       if (!values->isParallelizable()) {
         return 1;
       }
+    } else if (std::dynamic_pointer_cast<const core::ArrowStreamNode>(node)) {
+      // an arrow stream can be consumed only once
+      return 1;
     } else if (
         auto limit = std::dynamic_pointer_cast<const core::LimitNode>(node)) {
       // final limit must run single-threaded
@@ -190,8 +197,11 @@ uint32_t maxDrivers(const DriverFactory& driverFactory) {
     } else if (
         auto orderBy =
             std::dynamic_pointer_cast<const core::OrderByNode>(node)) {
-      // final orderby must run single-threaded
-      if (!orderBy->isPartial()) {
+      // final orderby must run single-threaded unless its Drivers merge
+      // their sorted rows. Spilled runs are not merged across Drivers.
+      if (!orderBy->isPartial() &&
+          !(queryConfig.orderByMultiDriverEnabled() &&
+            !queryConfig.spillPath().has_value())) {
         return 1;
       }
     } else if (
@@ -210,6 +220,12 @@ uint32_t maxDrivers(const DriverFactory& driverFactory) {
     } else if (std::dynamic_pointer_cast<const core::MergeJoinNode>(node)) {
       // Merge join must run single-threaded.
       return 1;
+    } else if (
+        auto window = std::dynamic_pointer_cast<const core::WindowNode>(node)) {
+      // Window without partition keys must run single-threaded.
+      if (window->partitionKeys().empty()) {
+        return 1;
+      }
     } else if (
         auto tableWrite =
             std::dynamic_pointer_cast<const core::TableWriteNode>(node)) {
@@ -242,6 +258,7 @@ void LocalPlanner::plan(
     const core::PlanFragment& planFragment,
     ConsumerSupplier consumerSupplier,
     std::vector<std::unique_ptr<DriverFactory>>* driverFactories,
+    const core::QueryConfig& queryConfig,
     uint32_t maxDrivers) {
   detail::plan(
       planFragment.planNode,
@@ -253,7 +270,7 @@ void LocalPlanner::plan(
   (*driverFactories)[0]->outputDriver = true;
 
   for (auto& factory : *driverFactories) {
-    factory->maxDrivers = detail::maxDrivers(*factory);
+    factory->maxDrivers = detail::maxDrivers(*factory, queryConfig);
     factory->numDrivers = std::min(factory->maxDrivers, maxDrivers);
     // For grouped/bucketed execution we would have separate groups of drivers
     // dealing with separate split groups (one driver can access splits from
@@ -303,6 +320,11 @@ std::shared_ptr<Driver> DriverFactory::createDriver(
         auto valuesNode =
             std::dynamic_pointer_cast<const core::ValuesNode>(planNode)) {
       operators.push_back(std::make_unique<Values>(id, ctx.get(), valuesNode));
+    } else if (
+        auto arrowStreamNode =
+            std::dynamic_pointer_cast<const core::ArrowStreamNode>(planNode)) {
+      operators.push_back(
+          std::make_unique<ArrowStream>(id, ctx.get(), arrowStreamNode));
     } else if (
         auto tableScanNode =
             std::dynamic_pointer_cast<const core::TableScanNode>(planNode)) {
@@ -342,9 +364,12 @@ std::shared_ptr<Driver> DriverFactory::createDriver(
     } else if (
         auto aggregationNode =
             std::dynamic_pointer_cast<const core::AggregationNode>(planNode)) {
+      // StreamingAggregation does not support distinct aggregates.
+      // HashAggregation handles the pre-grouped keys instead.
       if (!aggregationNode->preGroupedKeys().empty() &&
           aggregationNode->preGroupedKeys().size() ==
-              aggregationNode->groupingKeys().size()) {
+              aggregationNode->groupingKeys().size() &&
+          !aggregationNode->hasDistinctAggregates()) {
         operators.push_back(std::make_unique<StreamingAggregation>(
             id, ctx.get(), aggregationNode));
       } else {
@@ -411,6 +436,10 @@ std::shared_ptr<Driver> DriverFactory::createDriver(
           assignUniqueIdNode,
           assignUniqueIdNode->taskUniqueId(),
           assignUniqueIdNode->uniqueIdCounter()));
+    } else if (
+        auto windowNode =
+            std::dynamic_pointer_cast<const core::WindowNode>(planNode)) {
+      operators.push_back(std::make_unique<Window>(id, ctx.get(), windowNode));
     } else {
       auto extended = Operator::fromPlanNode(ctx.get(), id, planNode);
       VELOX_CHECK(extended, "Unsupported plan node: {}", planNode->toString());
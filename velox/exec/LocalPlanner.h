@@ -19,6 +19,7 @@
 
 namespace facebook::velox::core {
 struct PlanFragment;
+class QueryConfig;
 } // namespace facebook::velox::core
 
 namespace facebook::velox::exec {
@@ -29,6 +30,7 @@ class LocalPlanner {
       const core::PlanFragment& planFragment,
       ConsumerSupplier consumerSupplier,
       std::vector<std::unique_ptr<DriverFactory>>* driverFactories,
+      const core::QueryConfig& queryConfig,
       uint32_t maxDrivers);
 };
 } // namespace facebook::velox::exec
@@ -0,0 +1,246 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "velox/exec/MemoryArbitrator.h"
+
+#include <algorithm>
+
+#include <folly/executors/QueuedImmediateExecutor.h>
+#include "velox/exec/Driver.h"
+#include "velox/exec/Task.h"
+
+namespace facebook::velox::exec {
+
+MemoryArbitrator::MemoryArbitrator(int64_t capacity)
+    : capacity_(capacity), freeCapacity_(capacity) {
+  VELOX_CHECK_GT(capacity, 0);
+}
+
+MemoryArbitrator::~MemoryArbitrator() {
+  std::lock_guard<std::mutex> l(mutex_);
+  for (auto& [_, query] : queries_) {
+    if (auto tracker = query.tracker.lock()) {
+      tracker->setGrowCallback(nullptr);
+    }
+  }
+}
+
+void MemoryArbitrator::addTask(const std::shared_ptr<Task>& task) {
+  const auto& tracker =
+      task->queryCtx()->pool()->getMemoryUsageTracker();
+  VELOX_CHECK_NOT_NULL(
+      tracker, "Query must have a MemoryUsageTracker for memory arbitration");
+  std::lock_guard<std::mutex> l(mutex_);
+  removeFinishedLocked();
+  auto it = queries_.find(tracker.get());
+  if (it == queries_.end()) {
+    it = queries_.emplace(tracker.get(), Query{}).first;
+    auto& query = it->second;
+    query.tracker = tracker;
+    setCapacityLocked(query, *tracker, tracker->totalReservedBytes());
+    tracker->setGrowCallback(
+        [this](
+            memory::MemoryUsageTracker::UsageType /*type*/,
+            int64_t /*size*/,
+            memory::MemoryUsageTracker& tracker) { return grow(tracker); });
+  }
+  it->second.tasks.push_back(task);
+}
+
+MemoryArbitrator::Stats MemoryArbitrator::stats() const {
+  std::lock_guard<std::mutex> l(mutex_);
+  Stats stats;
+  stats.numRequests = numRequests_;
+  stats.numFailures = numFailures_;
+  stats.numReclaims = numReclaims_;
+  stats.reclaimedBytes = reclaimedBytes_;
+  stats.freeCapacity = freeCapacity_;
+  return stats;
+}
+
+bool MemoryArbitrator::grow(memory::MemoryUsageTracker& tracker) {
+  // A GrowCallback must not throw.
+  try {
+    // Wait for the arbitration in a suspended section so that arbitrations
+    // running on behalf of other queries can pause the Task of this thread.
+    auto* driver = Driver::current();
+    if (driver &&
+        driver->task()->enterSuspended(driver->state()) != StopReason::kNone) {
+      return false;
+    }
+    bool success;
+    {
+      std::lock_guard<std::mutex> l(mutex_);
+      success = growLocked(tracker);
+    }
+    if (driver &&
+        driver->task()->leaveSuspended(driver->state()) != StopReason::kNone) {
+      // The Task is being terminated.
+      return false;
+    }
+    return success;
+  } catch (const std::exception& e) {
+    LOG(ERROR) << "Memory arbitration failed: " << e.what();
+    return false;
+  }
+}
+
+bool MemoryArbitrator::growLocked(memory::MemoryUsageTracker& tracker) {
+  ++numRequests_;
+  removeFinishedLocked();
+  auto it = queries_.find(&tracker);
+  if (it == queries_.end()) {
+    ++numFailures_;
+    return false;
+  }
+  auto& query = it->second;
+  // The usage includes the allocation that exceeded the cap.
+  const int64_t needed = tracker.totalReservedBytes() - query.capacity;
+  if (needed <= 0) {
+    // Another thread grew the cap while this was waiting.
+    return true;
+  }
+  const int64_t target = std::max(needed, kMinGrowthBytes);
+
+  if (freeCapacity_ < target) {
+    // Take back the capacity other queries are not using.
+    for (auto& [_, other] : queries_) {
+      if (&other != &query) {
+        shrinkLocked(other);
+      }
+    }
+  }
+
+  if (freeCapacity_ < needed) {
+    // Spill the other queries, largest first, until enough is free.
+    std::vector<Query*> candidates;
+    for (auto& [_, other] : queries_) {
+      if (&other != &query) {
+        candidates.push_back(&other);
+      }
+    }
+    std::sort(candidates.begin(), candidates.end(), [](auto* l, auto* r) {
+      return l->capacity > r->capacity;
+    });
+    for (auto* candidate : candidates) {
+      if (freeCapacity_ >= needed) {
+        break;
+      }
+      reclaimLocked(*candidate);
+      shrinkLocked(*candidate);
+    }
+  }
+
+  if (freeCapacity_ < needed) {
+    ++numFailures_;
+    return false;
+  }
+  setCapacityLocked(
+      query, tracker, query.capacity + std::min(target, freeCapacity_));
+  return true;
+}
+
+void MemoryArbitrator::setCapacityLocked(
+    Query& query,
+    memory::MemoryUsageTracker& tracker,
+    int64_t capacity) {
+  freeCapacity_ -= capacity - query.capacity;
+  query.capacity = capacity;
+  tracker.updateConfig(memory::MemoryUsageConfigBuilder()
+                           .maxUserMemory(capacity)
+                           .maxTotalMemory(capacity)
+                           .build());
+}
+
+void MemoryArbitrator::shrinkLocked(Query& query) {
+  auto tracker = query.tracker.lock();
+  if (!tracker) {
+    return;
+  }
+  const auto usage = tracker->totalReservedBytes();
+  if (usage < query.capacity) {
+    setCapacityLocked(query, *tracker, usage);
+  }
+}
+
+void MemoryArbitrator::reclaimLocked(Query& query) {
+  auto tracker = query.tracker.lock();
+  if (!tracker) {
+    return;
+  }
+  std::vector<std::shared_ptr<Task>> tasks;
+  for (auto& weakTask : query.tasks) {
+    auto task = weakTask.lock();
+    if (task && task->isRunning()) {
+      tasks.push_back(std::move(task));
+    }
+  }
+  if (tasks.empty()) {
+    return;
+  }
+
+  const auto usageBefore = tracker->totalReservedBytes();
+  auto& executor = folly::QueuedImmediateExecutor::instance();
+  for (auto& task : tasks) {
+    task->requestPause(true).via(&executor).wait();
+  }
+  for (auto& task : tasks) {
+    try {
+      if (task->reclaimableBytes() > 0) {
+        task->reclaim();
+      }
+    } catch (const std::exception& e) {
+      task->setError(std::current_exception());
+    }
+  }
+  for (auto& task : tasks) {
+    if (!task->error()) {
+      Task::resume(task);
+    }
+  }
+  ++numReclaims_;
+  reclaimedBytes_ +=
+      std::max<int64_t>(0, usageBefore - tracker->totalReservedBytes());
+}
+
+void MemoryArbitrator::removeFinishedLocked() {
+  for (auto it = queries_.begin(); it != queries_.end();) {
+    auto& query = it->second;
+    if (query.tracker.expired()) {
+      freeCapacity_ += query.capacity;
+      it = queries_.erase(it);
+      continue;
+    }
+    auto& tasks = query.tasks;
+    tasks.erase(
+        std::remove_if(
+            tasks.begin(),
+            tasks.end(),
+            [](const auto& weakTask) {
+              auto task = weakTask.lock();
+              return !task || !task->isRunning();
+            }),
+        tasks.end());
+    if (tasks.empty()) {
+      // Keep the entry, and with it the GrowCallback, since the tracker may
+      // get more Tasks.
+      shrinkLocked(query);
+    }
+    ++it;
+  }
+}
+
+} // namespace facebook::velox::exec
@@ -0,0 +1,134 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#pragma once
+
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+#include "velox/common/memory/MemoryUsageTracker.h"
+
+namespace facebook::velox::exec {
+
+class Task;
+
+/// Divides a fixed memory capacity between the queries of a process. Each
+/// query's root MemoryUsageTracker gets a cap, and the caps add up to at most
+/// 'capacity'. When an allocation would exceed a query's cap, the tracker's
+/// GrowCallback asks the arbitrator for more. The arbitrator grows the cap
+/// from free capacity if it can. Otherwise it first takes back the unused
+/// part of other queries' caps. If that is still not enough, it pauses the
+/// Tasks of other queries, largest first. It makes their operators spill
+/// (see Operator::reclaim()), shrinks those queries' caps to their new
+/// usage, and resumes them. The allocation fails with the usual cap exceeded
+/// error only if all this does not free enough memory.
+///
+/// The arbitrator must outlive the allocations of the queries it arbitrates.
+///
+/// A Driver asking for memory waits for the arbitration in a suspended
+/// section. While it waits, other arbitrations may pause its Task without
+/// waiting for it. Operators of suspended Drivers are never made to spill,
+/// since they may be in the middle of their own allocation.
+class MemoryArbitrator {
+ public:
+  struct Stats {
+    /// Number of calls to grow a query's cap.
+    int64_t numRequests{0};
+
+    /// Number of requests that could not be satisfied.
+    int64_t numFailures{0};
+
+    /// Number of times the Tasks of a query were paused to spill.
+    int64_t numReclaims{0};
+
+    /// Bytes freed by spilling.
+    int64_t reclaimedBytes{0};
+
+    /// Capacity not given to any query.
+    int64_t freeCapacity{0};
+  };
+
+  explicit MemoryArbitrator(int64_t capacity);
+
+  /// Clears the GrowCallback of the trackers that are still alive.
+  ~MemoryArbitrator();
+
+  /// Makes 'this' arbitrate the memory of the query of 'task'. On the first
+  /// Task of a query, sets the total memory cap of the query's root tracker
+  /// to the tracker's current usage and installs a GrowCallback that
+  /// arbitrates increases. The query must not use another GrowCallback. Once
+  /// none of a query's Tasks is running, its cap shrinks to its usage. Queries
+  /// are forgotten, and their caps returned to the free capacity, once their
+  /// tracker is destroyed.
+  void addTask(const std::shared_ptr<Task>& task);
+
+  int64_t capacity() const {
+    return capacity_;
+  }
+
+  Stats stats() const;
+
+  /// Minimum increment of a query's cap. Avoids arbitrating for every
+  /// reservation quantum.
+  static constexpr int64_t kMinGrowthBytes = 8 << 20;
+
+ private:
+  struct Query {
+    std::weak_ptr<memory::MemoryUsageTracker> tracker;
+    std::vector<std::weak_ptr<Task>> tasks;
+
+    // Cap given to the query. Mirrors the tracker's total memory cap.
+    int64_t capacity{0};
+  };
+
+  // GrowCallback of the query trackers.
+  bool grow(memory::MemoryUsageTracker& tracker);
+
+  bool growLocked(memory::MemoryUsageTracker& tracker);
+
+  // Sets the cap of 'query' to 'capacity' and adjusts 'freeCapacity_'.
+  void setCapacityLocked(
+      Query& query,
+      memory::MemoryUsageTracker& tracker,
+      int64_t capacity);
+
+  // Shrinks the cap of 'query' to its current usage.
+  void shrinkLocked(Query& query);
+
+  // Pauses the running Tasks of 'query', makes them spill and resumes them.
+  void reclaimLocked(Query& query);
+
+  // Forgets queries whose tracker is gone and shrinks the caps of queries
+  // with no running Tasks.
+  void removeFinishedLocked();
+
+  const int64_t capacity_;
+
+  mutable std::mutex mutex_;
+
+  // Capacity not given to any query.
+  int64_t freeCapacity_;
+
+  // Keyed on the root tracker of the query.
+  std::unordered_map<const memory::MemoryUsageTracker*, Query> queries_;
+
+  int64_t numRequests_{0};
+  int64_t numFailures_{0};
+  int64_t numReclaims_{0};
+  int64_t reclaimedBytes_{0};
+};
+
+} // namespace facebook::velox::exec
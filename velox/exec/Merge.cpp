@@ -36,7 +36,11 @@ Merge::Merge(
           operatorId,
           planNodeId,
           operatorType),
-      outputBatchSize_{driverCtx->queryConfig().preferredOutputBatchSize()} {
+      outputBatchSize_{static_cast<vector_size_t>(
+          driverCtx->queryConfig().preferredOutputBatchSize())},
+      maxOutputBatchSize_{static_cast<vector_size_t>(std::max(
+          driverCtx->queryConfig().preferredOutputBatchSize(),
+          driverCtx->queryConfig().maxOutputBatchRows()))} {
   auto numKeys = sortingKeys.size();
   sortingKeys_.reserve(numKeys);
   for (int i = 0; i < numKeys; ++i) {
@@ -52,6 +56,13 @@ Merge::Merge(
             sortingOrders[i].isAscending(),
             false});
   }
+  std::vector<TypePtr> keyTypes;
+  std::vector<CompareFlags> compareFlags;
+  for (const auto& [channel, flags] : sortingKeys_) {
+    keyTypes.push_back(outputType_->childAt(channel));
+    compareFlags.push_back(flags);
+  }
+  keyEncoder_ = std::make_unique<SortKeyEncoder>(keyTypes, compareFlags);
 }
 
 void Merge::initializeTreeOfLosers() {
@@ -59,7 +70,7 @@ void Merge::initializeTreeOfLosers() {
   sourceCursors.reserve(sources_.size());
   for (auto& source : sources_) {
     sourceCursors.push_back(std::make_unique<SourceStream>(
-        source.get(), sortingKeys_, outputBatchSize_));
+        source.get(), sortingKeys_, *keyEncoder_, maxOutputBatchSize_));
   }
 
   // Save the pointers to cursors before moving these into the TreeOfLosers.
@@ -156,6 +167,8 @@ RowVectorPtr Merge::getOutput() {
       }
 
       outputSize_ = 0;
+      outputBatchSize_ = outputBatchRows(
+          output_->estimateFlatSize() / output_->size());
       return std::move(output_);
     }
 
@@ -167,6 +180,13 @@ RowVectorPtr Merge::getOutput() {
 
 bool SourceStream::operator<(const MergeStream& other) const {
   const auto& otherCursor = static_cast<const SourceStream&>(other);
+  if (auto result =
+          keyEncoder_.compare(key_.data(), otherCursor.key_.data())) {
+    return result < 0;
+  }
+  if (keyEncoder_.isComplete()) {
+    return false;
+  }
   for (auto i = 0; i < sortingKeys_.size(); ++i) {
     const auto& [_, compareFlags] = sortingKeys_[i];
     VELOX_DCHECK(
@@ -193,6 +213,7 @@ bool SourceStream::pop(std::vector<ContinueFuture>& futures) {
     return fetchMoreData(futures);
   }
 
+  encodeKey();
   return false;
 }
 
@@ -204,12 +225,23 @@ void SourceStream::copyToOutput(RowVectorPtr& output) {
   }
 
   vector_size_t sourceRow = firstSourceRow_;
-  outputRows_.applyToSelected(
-      [&](auto row) { sourceRows_[row] = sourceRow++; });
+  const auto numRows = outputRows_.countSelected();
+  if (numRows == outputRows_.end() - outputRows_.begin()) {
+    // This stream won 'numRows' consecutive pops, which is common for mostly
+    // sorted inputs. Copy the rows as one range.
+    for (auto i = 0; i < output->type()->size(); ++i) {
+      output->childAt(i)->copy(
+          data_->childAt(i).get(), outputRows_.begin(), sourceRow, numRows);
+    }
+    sourceRow += numRows;
+  } else {
+    outputRows_.applyToSelected(
+        [&](auto row) { sourceRows_[row] = sourceRow++; });
 
-  for (auto i = 0; i < output->type()->size(); ++i) {
-    output->childAt(i)->copy(
-        data_->childAt(i).get(), outputRows_, sourceRows_.data());
+    for (auto i = 0; i < output->type()->size(); ++i) {
+      output->childAt(i)->copy(
+          data_->childAt(i).get(), outputRows_, sourceRows_.data());
+    }
   }
 
   outputRows_.clearAll();
@@ -242,6 +274,13 @@ bool SourceStream::fetchMoreData(std::vector<ContinueFuture>& futures) {
     for (const auto& key : sortingKeys_) {
       keyColumns_.push_back(data_->childAt(key.first).get());
     }
+    if (keyEncoder_.keySize() > 0) {
+      SelectivityVector allRows(data_->size());
+      for (auto i = 0; i < keyColumns_.size(); ++i) {
+        decodedKeys_[i].decode(*keyColumns_[i], allRows);
+      }
+      encodeKey();
+    }
   }
   return false;
 }
@@ -283,7 +322,11 @@ MergeExchange::MergeExchange(
           mergeExchangeNode->sortingKeys(),
           mergeExchangeNode->sortingOrders(),
           mergeExchangeNode->id(),
-          "MergeExchange") {}
+          "MergeExchange") {
+  serde_ = namedVectorSerde(driverCtx->queryConfig().exchangeSerde());
+  serdeOptions_.compressionKind = compressionCodec(
+      driverCtx->queryConfig().exchangeCompressionKind(), "exchange");
+}
 
 BlockingReason MergeExchange::addMergeSources(ContinueFuture* future) {
   if (operatorCtx_->driverCtx()->driverId != 0) {
@@ -17,6 +17,7 @@
 
 #include "velox/exec/Exchange.h"
 #include "velox/exec/MergeSource.h"
+#include "velox/exec/SortKeyEncoder.h"
 #include "velox/exec/TreeOfLosers.h"
 
 namespace facebook::velox::exec {
@@ -60,11 +61,20 @@ class Merge : public SourceOperator {
  private:
   void initializeTreeOfLosers();
 
-  /// Maximum number of rows in the output batch.
-  const uint32_t outputBatchSize_;
+  /// Maximum number of rows in the output batch. Starts at
+  /// QueryConfig::preferredOutputBatchSize() and is then adapted to the
+  /// width of the rows of the previous batch. See Operator::outputBatchRows().
+  vector_size_t outputBatchSize_;
+
+  /// Upper bound of 'outputBatchSize_'. The SourceStreams are sized for it.
+  const vector_size_t maxOutputBatchSize_;
 
   std::vector<std::pair<column_index_t, CompareFlags>> sortingKeys_;
 
+  /// Encodes the sorting keys of the current row of each stream so that
+  /// most comparisons are a memcmp.
+  std::unique_ptr<SortKeyEncoder> keyEncoder_;
+
   /// A list of cursors over batches of ordered source data. One per source.
   /// Aligned with 'sources'.
   std::vector<SourceStream*> streams_;
@@ -89,9 +99,13 @@ class SourceStream final : public MergeStream {
   SourceStream(
       MergeSource* source,
       const std::vector<std::pair<column_index_t, CompareFlags>>& sortingKeys,
+      const SortKeyEncoder& keyEncoder,
       uint32_t outputBatchSize)
       : source_{source},
         sortingKeys_{sortingKeys},
+        keyEncoder_{keyEncoder},
+        decodedKeys_(sortingKeys.size()),
+        key_(keyEncoder.keySize()),
         outputRows_(outputBatchSize, false),
         sourceRows_(outputBatchSize) {
     keyColumns_.reserve(sortingKeys.size());
@@ -138,10 +152,23 @@ class SourceStream final : public MergeStream {
  private:
   bool fetchMoreData(std::vector<ContinueFuture>& futures);
 
+  /// Sets 'key_' to the normalized key of the current row.
+  void encodeKey() {
+    keyEncoder_.encode(decodedKeys_, currentSourceRow_, key_.data());
+  }
+
   MergeSource* source_;
 
   const std::vector<std::pair<column_index_t, CompareFlags>>& sortingKeys_;
 
+  const SortKeyEncoder& keyEncoder_;
+
+  /// Sorting key columns of 'data_' in the same order as 'sortingKeys_'.
+  std::vector<DecodedVector> decodedKeys_;
+
+  /// Normalized key of the current row.
+  std::vector<char> key_;
+
   /// Ordered source rows.
   RowVectorPtr data_;
 
@@ -193,10 +220,22 @@ class MergeExchange : public Merge {
       DriverCtx* driverCtx,
       const std::shared_ptr<const core::MergeExchangeNode>& orderByNode);
 
+  // Gives the codec for reading compressed pages.
+  const VectorSerde::Options& serdeOptions() const {
+    return serdeOptions_;
+  }
+
+  // Serde of the pages. nullptr for the default serde.
+  VectorSerde* FOLLY_NULLABLE serde() const {
+    return serde_;
+  }
+
  protected:
   BlockingReason addMergeSources(ContinueFuture* future) override;
 
  private:
+  VectorSerde* FOLLY_NULLABLE serde_{nullptr};
+  VectorSerde::Options serdeOptions_;
   bool noMoreSplits_ = false;
   size_t numSplits_{0}; // Number of splits we took to process so far.
 };
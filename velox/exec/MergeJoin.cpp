@@ -34,8 +34,9 @@ MergeJoin::MergeJoin(
       joinType_{joinNode->joinType()},
       numKeys_{joinNode->leftKeys().size()} {
   VELOX_USER_CHECK(
-      joinNode->isInnerJoin() || joinNode->isLeftJoin(),
-      "Merge join supports only inner and left joins. Other join types are not supported yet.");
+      joinNode->isInnerJoin() || joinNode->isLeftJoin() ||
+          joinNode->isRightJoin() || joinNode->isFullJoin(),
+      "Merge join supports only inner, left, right and full joins. Other join types are not supported yet.");
 
   leftKeys_.reserve(numKeys_);
   rightKeys_.reserve(numKeys_);
@@ -67,6 +68,9 @@ MergeJoin::MergeJoin(
   }
 
   if (joinNode->filter()) {
+    VELOX_USER_CHECK(
+        joinNode->isInnerJoin() || joinNode->isLeftJoin(),
+        "Merge join supports filters only for inner and left joins");
     initializeFilter(joinNode->filter(), leftType, rightType);
 
     if (joinNode->isLeftJoin()) {
@@ -193,28 +197,11 @@ bool MergeJoin::findEndOfMatch(
   return true;
 }
 
-namespace {
-void copyRow(
-    const RowVectorPtr& source,
-    vector_size_t sourceIndex,
-    const RowVectorPtr& target,
-    vector_size_t targetIndex,
-    const std::vector<IdentityProjection>& projections) {
-  for (const auto& projection : projections) {
-    const auto& sourceChild = source->childAt(projection.inputChannel);
-    const auto& targetChild = target->childAt(projection.outputChannel);
-    targetChild->copy(sourceChild.get(), targetIndex, sourceIndex, 1);
-  }
-}
-} // namespace
-
 void MergeJoin::addOutputRowForLeftJoin() {
-  copyRow(input_, index_, output_, outputSize_, leftProjections_);
-
-  for (const auto& projection : rightProjections_) {
-    const auto& target = output_->childAt(projection.outputChannel);
-    target->setNull(outputSize_, true);
-  }
+  rawLeftIndices_[outputSize_] = index_;
+  rawRightIndices_[outputSize_] = 0;
+  bits::setNull(rawRightNulls_, outputSize_);
+  hasRightNulls_ = true;
 
   if (leftJoinTracker_) {
     // Record left-side row with no match on the right side.
@@ -224,82 +211,129 @@ void MergeJoin::addOutputRowForLeftJoin() {
   ++outputSize_;
 }
 
+void MergeJoin::addOutputRowForRightJoin() {
+  rawLeftIndices_[outputSize_] = 0;
+  rawRightIndices_[outputSize_] = rightIndex_;
+  bits::setNull(rawLeftNulls_, outputSize_);
+  hasLeftNulls_ = true;
+  ++outputSize_;
+}
+
 void MergeJoin::addOutputRow(
     const RowVectorPtr& left,
     vector_size_t leftIndex,
-    const RowVectorPtr& right,
     vector_size_t rightIndex) {
-  copyRow(left, leftIndex, output_, outputSize_, leftProjections_);
-  copyRow(right, rightIndex, output_, outputSize_, rightProjections_);
-
-  if (filter_) {
-    // TODO Re-use output_ columns when possible.
-
-    copyRow(left, leftIndex, filterInput_, outputSize_, filterLeftInputs_);
-    copyRow(right, rightIndex, filterInput_, outputSize_, filterRightInputs_);
+  rawLeftIndices_[outputSize_] = leftIndex;
+  rawRightIndices_[outputSize_] = rightIndex;
 
-    if (leftJoinTracker_) {
-      // Record left-side row with a match on the right-side.
-      leftJoinTracker_->addMatch(left, leftIndex, outputSize_);
-    }
+  if (leftJoinTracker_) {
+    // Record left-side row with a match on the right-side.
+    leftJoinTracker_->addMatch(left, leftIndex, outputSize_);
   }
 
   ++outputSize_;
 }
 
-void MergeJoin::prepareOutput() {
-  if (output_ == nullptr) {
-    std::vector<VectorPtr> localColumns(outputType_->size());
-    for (auto i = 0; i < outputType_->size(); ++i) {
-      localColumns[i] = BaseVector::create(
-          outputType_->childAt(i), outputBatchSize_, operatorCtx_->pool());
-    }
+bool MergeJoin::prepareOutput(
+    const RowVectorPtr& left,
+    const RowVectorPtr& right) {
+  if (outputSize_ == outputBatchSize_) {
+    return false;
+  }
 
-    output_ = std::make_shared<RowVector>(
-        operatorCtx_->pool(),
-        outputType_,
-        nullptr,
-        outputBatchSize_,
-        std::move(localColumns));
-    outputSize_ = 0;
-
-    if (filterInput_ != nullptr) {
-      // When filterInput_ contains array or map columns, their child vectors
-      // (elements, keys and values) keep growing after each call to
-      // 'copyRow'. Call BaseVector::resize(0) on these child vectors to avoid
-      // that.
-      // TODO Refactor this logic into a method on BaseVector.
-      for (auto& child : filterInput_->children()) {
-        if (child->typeKind() == TypeKind::ARRAY) {
-          child->as<ArrayVector>()->elements()->resize(0);
-        } else if (child->typeKind() == TypeKind::MAP) {
-          auto* mapChild = child->as<MapVector>();
-          mapChild->mapKeys()->resize(0);
-          mapChild->mapValues()->resize(0);
-        }
-      }
-    }
+  // All rows of an output batch refer to one batch on each side so that the
+  // output can be made by wrapping these in dictionaries.
+  if ((left && currentLeft_ && left != currentLeft_) ||
+      (right && currentRight_ && right != currentRight_)) {
+    return false;
   }
 
-  if (filter_ != nullptr && filterInput_ == nullptr) {
-    std::vector<VectorPtr> inputs(filterInputType_->size());
-    for (auto i = 0; i < filterInputType_->size(); ++i) {
-      inputs[i] = BaseVector::create(
-          filterInputType_->childAt(i), outputBatchSize_, operatorCtx_->pool());
-    }
+  if (!leftIndices_) {
+    leftIndices_ = allocateIndices(outputBatchSize_, pool());
+    rawLeftIndices_ = leftIndices_->asMutable<vector_size_t>();
+    rightIndices_ = allocateIndices(outputBatchSize_, pool());
+    rawRightIndices_ = rightIndices_->asMutable<vector_size_t>();
+    leftNulls_ =
+        AlignedBuffer::allocate<bool>(outputBatchSize_, pool(), bits::kNotNull);
+    rawLeftNulls_ = leftNulls_->asMutable<uint64_t>();
+    rightNulls_ =
+        AlignedBuffer::allocate<bool>(outputBatchSize_, pool(), bits::kNotNull);
+    rawRightNulls_ = rightNulls_->asMutable<uint64_t>();
+  }
 
-    filterInput_ = std::make_shared<RowVector>(
-        operatorCtx_->pool(),
-        filterInputType_,
-        nullptr,
-        outputBatchSize_,
-        std::move(inputs));
+  // The output may be produced after advancing past 'left' or 'right'.
+  // LazyVectors must be loaded before that.
+  if (left && !currentLeft_) {
+    loadColumns(left, *operatorCtx_->execCtx());
+    currentLeft_ = left;
   }
+  if (right && !currentRight_) {
+    loadColumns(right, *operatorCtx_->execCtx());
+    currentRight_ = right;
+  }
+  return true;
 }
 
-bool MergeJoin::addToOutput() {
-  prepareOutput();
+VectorPtr MergeJoin::wrapOutputColumn(
+    const RowVectorPtr& input,
+    column_index_t channel,
+    const TypePtr& type,
+    const BufferPtr& indices,
+    const BufferPtr& nulls,
+    bool hasNulls) {
+  if (!input) {
+    // All rows have nulls for this side.
+    return BaseVector::createNullConstant(type, outputSize_, pool());
+  }
+  return wrapChild(
+      outputSize_,
+      indices,
+      input->childAt(channel),
+      hasNulls ? nulls : nullptr);
+}
 
+RowVectorPtr MergeJoin::makeOutput() {
+  RowVectorPtr output;
+  if (outputSize_ > 0) {
+    std::vector<VectorPtr> columns(outputType_->size());
+    for (const auto& projection : leftProjections_) {
+      columns[projection.outputChannel] = wrapOutputColumn(
+          currentLeft_,
+          projection.inputChannel,
+          outputType_->childAt(projection.outputChannel),
+          leftIndices_,
+          leftNulls_,
+          hasLeftNulls_);
+    }
+    for (const auto& projection : rightProjections_) {
+      columns[projection.outputChannel] = wrapOutputColumn(
+          currentRight_,
+          projection.inputChannel,
+          outputType_->childAt(projection.outputChannel),
+          rightIndices_,
+          rightNulls_,
+          hasRightNulls_);
+    }
+    output = std::make_shared<RowVector>(
+        pool(), outputType_, nullptr, outputSize_, std::move(columns));
+
+    // The buffers are now referenced by 'output'. Allocate new ones for the
+    // next batch.
+    leftIndices_ = nullptr;
+    rightIndices_ = nullptr;
+    leftNulls_ = nullptr;
+    rightNulls_ = nullptr;
+  }
+
+  currentLeft_ = nullptr;
+  currentRight_ = nullptr;
+  hasLeftNulls_ = false;
+  hasRightNulls_ = false;
+  outputSize_ = 0;
+  return output;
+}
+
+bool MergeJoin::addToOutput() {
   size_t firstLeftBatch;
   vector_size_t leftStartIndex;
   if (leftMatch_->cursor) {
@@ -335,12 +369,12 @@ bool MergeJoin::addToOutput() {
             r == numRights - 1 ? rightMatch_->endIndex : right->size();
 
         for (auto j = rightStart; j < rightEnd; ++j) {
-          if (outputSize_ == outputBatchSize_) {
+          if (!prepareOutput(left, right)) {
             leftMatch_->setCursor(l, i);
             rightMatch_->setCursor(r, j);
             return true;
           }
-          addOutputRow(left, i, right, j);
+          addOutputRow(left, i, j);
         }
       }
     }
@@ -362,19 +396,16 @@ RowVectorPtr MergeJoin::getOutput() {
   // TODO Finish early if ran out of data on either side of the join.
 
   for (;;) {
-    auto output = doGetOutput();
-    if (output != nullptr) {
+    if (doGetOutput()) {
       if (filter_) {
-        output = applyFilter(output);
-        if (output != nullptr) {
-          return output;
-        }
-
-        // No rows survived the filter. Get more rows.
-        continue;
-      } else {
+        applyFilter();
+      }
+      if (auto output = makeOutput()) {
         return output;
       }
+
+      // No rows survived the filter. Get more rows.
+      continue;
     }
 
     // Check if we need to get more data from the right side.
@@ -400,7 +431,7 @@ RowVectorPtr MergeJoin::getOutput() {
   }
 }
 
-RowVectorPtr MergeJoin::doGetOutput() {
+bool MergeJoin::doGetOutput() {
   // Check if we ran out of space in the output vector in the middle of the
   // match.
   if (leftMatch_ && leftMatch_->cursor) {
@@ -409,7 +440,7 @@ RowVectorPtr MergeJoin::doGetOutput() {
     // Not all rows from the last match fit in the output. Continue producing
     // results from the current match.
     if (addToOutput()) {
-      return std::move(output_);
+      return true;
     }
   }
 
@@ -423,7 +454,7 @@ RowVectorPtr MergeJoin::doGetOutput() {
       if (!findEndOfMatch(leftMatch_.value(), input_, leftKeys_)) {
         // Continue looking for the end of the match.
         input_ = nullptr;
-        return nullptr;
+        return false;
       }
 
       if (leftMatch_->inputs.back() == input_) {
@@ -433,14 +464,14 @@ RowVectorPtr MergeJoin::doGetOutput() {
       leftMatch_->complete = true;
     } else {
       // Need more input.
-      return nullptr;
+      return false;
     }
 
     if (rightInput_) {
       if (!findEndOfMatch(rightMatch_.value(), rightInput_, rightKeys_)) {
         // Continue looking for the end of the match.
         rightInput_ = nullptr;
-        return nullptr;
+        return false;
       }
       if (rightMatch_->inputs.back() == rightInput_) {
         rightIndex_ = rightMatch_->endIndex;
@@ -449,7 +480,7 @@ RowVectorPtr MergeJoin::doGetOutput() {
       rightMatch_->complete = true;
     } else {
       // Need more input.
-      return nullptr;
+      return false;
     }
   }
 
@@ -460,17 +491,17 @@ RowVectorPtr MergeJoin::doGetOutput() {
     VELOX_CHECK(rightMatch_ && rightMatch_->complete);
 
     if (addToOutput()) {
-      return std::move(output_);
+      return true;
     }
   }
 
   if (!input_ || !rightInput_) {
-    if (isLeftJoin(joinType_)) {
-      if (input_ && noMoreRightInput_) {
-        prepareOutput();
-        while (true) {
-          if (outputSize_ == outputBatchSize_) {
-            return std::move(output_);
+    if (input_ && noMoreRightInput_) {
+      // The remaining rows on the left side have no match.
+      if (isLeftJoin(joinType_) || isFullJoin(joinType_)) {
+        for (;;) {
+          if (!prepareOutput(input_, nullptr)) {
+            return true;
           }
 
           addOutputRowForLeftJoin();
@@ -478,27 +509,44 @@ RowVectorPtr MergeJoin::doGetOutput() {
           ++index_;
           if (index_ == input_->size()) {
             // Ran out of rows on the left side.
-            input_ = nullptr;
-            return nullptr;
+            break;
           }
         }
       }
+      input_ = nullptr;
+    }
 
-      if (noMoreInput_ && output_) {
-        output_->resize(outputSize_);
-        return std::move(output_);
-      }
-    } else {
-      if (noMoreInput_ || noMoreRightInput_) {
-        if (output_) {
-          output_->resize(outputSize_);
-          return std::move(output_);
+    if (rightInput_ && noMoreInput_ &&
+        (isRightJoin(joinType_) || isFullJoin(joinType_))) {
+      // The remaining rows on the right side have no match.
+      for (;;) {
+        if (!prepareOutput(nullptr, rightInput_)) {
+          return true;
+        }
+
+        addOutputRowForRightJoin();
+
+        ++rightIndex_;
+        if (rightIndex_ == rightInput_->size()) {
+          // Ran out of rows on the right side.
+          rightInput_ = nullptr;
+          return false;
         }
-        input_ = nullptr;
       }
     }
 
-    return nullptr;
+    // Produce the last batch of output once no more rows can be added to it.
+    bool atEnd;
+    if (isLeftJoin(joinType_)) {
+      atEnd = noMoreInput_;
+    } else if (isRightJoin(joinType_)) {
+      atEnd = noMoreRightInput_;
+    } else if (isFullJoin(joinType_)) {
+      atEnd = noMoreInput_ && noMoreRightInput_;
+    } else {
+      atEnd = noMoreInput_ || noMoreRightInput_;
+    }
+    return atEnd && outputSize_ > 0;
   }
 
   // Look for a new match starting with index_ row on the left and rightIndex_
@@ -508,11 +556,9 @@ RowVectorPtr MergeJoin::doGetOutput() {
   for (;;) {
     // Catch up input_ with rightInput_.
     while (compareResult < 0) {
-      if (isLeftJoin(joinType_)) {
-        prepareOutput();
-
-        if (outputSize_ == outputBatchSize_) {
-          return std::move(output_);
+      if (isLeftJoin(joinType_) || isFullJoin(joinType_)) {
+        if (!prepareOutput(input_, nullptr)) {
+          return true;
         }
 
         addOutputRowForLeftJoin();
@@ -522,18 +568,26 @@ RowVectorPtr MergeJoin::doGetOutput() {
       if (index_ == input_->size()) {
         // Ran out of rows on the left side.
         input_ = nullptr;
-        return nullptr;
+        return false;
       }
       compareResult = compare();
     }
 
     // Catch up rightInput_ with input_.
     while (compareResult > 0) {
+      if (isRightJoin(joinType_) || isFullJoin(joinType_)) {
+        if (!prepareOutput(nullptr, rightInput_)) {
+          return true;
+        }
+
+        addOutputRowForRightJoin();
+      }
+
       ++rightIndex_;
       if (rightIndex_ == rightInput_->size()) {
         // Ran out of rows on the right side.
         rightInput_ = nullptr;
-        return nullptr;
+        return false;
       }
       compareResult = compare();
     }
@@ -576,14 +630,14 @@ RowVectorPtr MergeJoin::doGetOutput() {
           // Need to continue looking for the end of match.
           rightInput_ = nullptr;
         }
-        return nullptr;
+        return false;
       }
 
       index_ = endIndex;
       rightIndex_ = endRightIndex;
 
       if (addToOutput()) {
-        return std::move(output_);
+        return true;
       }
 
       compareResult = compare();
@@ -593,8 +647,30 @@ RowVectorPtr MergeJoin::doGetOutput() {
   VELOX_UNREACHABLE();
 }
 
-RowVectorPtr MergeJoin::applyFilter(const RowVectorPtr& output) {
-  const auto numRows = output->size();
+void MergeJoin::applyFilter() {
+  const auto numRows = outputSize_;
+
+  std::vector<VectorPtr> inputs(filterInputType_->size());
+  for (const auto& projection : filterLeftInputs_) {
+    inputs[projection.outputChannel] = wrapOutputColumn(
+        currentLeft_,
+        projection.inputChannel,
+        filterInputType_->childAt(projection.outputChannel),
+        leftIndices_,
+        leftNulls_,
+        hasLeftNulls_);
+  }
+  for (const auto& projection : filterRightInputs_) {
+    inputs[projection.outputChannel] = wrapOutputColumn(
+        currentRight_,
+        projection.inputChannel,
+        filterInputType_->childAt(projection.outputChannel),
+        rightIndices_,
+        rightNulls_,
+        hasRightNulls_);
+  }
+  filterInput_ = std::make_shared<RowVector>(
+      pool(), filterInputType_, nullptr, numRows, std::move(inputs));
 
   BufferPtr indices = allocateIndices(numRows, pool());
   auto rawIndices = indices->asMutable<vector_size_t>();
@@ -605,7 +681,7 @@ RowVectorPtr MergeJoin::applyFilter(const RowVectorPtr& output) {
 
     if (!filterRows.hasSelections()) {
       // No matches in the output, no need to evaluate the filter.
-      return output;
+      return;
     }
 
     evaluateFilter(filterRows);
@@ -614,11 +690,8 @@ RowVectorPtr MergeJoin::applyFilter(const RowVectorPtr& output) {
     // the output with nulls for the right-side columns.
     auto onMiss = [&](auto row) {
       rawIndices[numPassed++] = row;
-
-      for (auto& projection : rightProjections_) {
-        auto target = output->childAt(projection.outputChannel);
-        target->setNull(row, true);
-      }
+      bits::setNull(rawRightNulls_, row);
+      hasRightNulls_ = true;
     };
 
     for (auto i = 0; i < numRows; ++i) {
@@ -655,18 +728,21 @@ RowVectorPtr MergeJoin::applyFilter(const RowVectorPtr& output) {
     }
   }
 
-  if (numPassed == 0) {
-    // No rows passed.
-    return nullptr;
-  }
-
   if (numPassed == numRows) {
     // All rows passed.
-    return output;
+    return;
   }
 
-  // Some, but not all rows passed.
-  return wrap(numPassed, indices, output);
+  // Keep the output rows that passed. 'rawIndices' is increasing, so this can
+  // be done in place.
+  for (auto i = 0; i < numPassed; ++i) {
+    const auto row = rawIndices[i];
+    rawLeftIndices_[i] = rawLeftIndices_[row];
+    rawRightIndices_[i] = rawRightIndices_[row];
+    bits::setNull(rawLeftNulls_, i, bits::isBitNull(rawLeftNulls_, row));
+    bits::setNull(rawRightNulls_, i, bits::isBitNull(rawRightNulls_, row));
+  }
+  outputSize_ = numPassed;
 }
 
 void MergeJoin::evaluateFilter(const SelectivityVector& rows) {
@@ -677,6 +753,11 @@ void MergeJoin::evaluateFilter(const SelectivityVector& rows) {
 }
 
 bool MergeJoin::isFinished() {
+  if (isRightJoin(joinType_) || isFullJoin(joinType_)) {
+    // All rows on the right side must be added to the output.
+    return noMoreInput_ && input_ == nullptr && noMoreRightInput_ &&
+        rightInput_ == nullptr && outputSize_ == 0;
+  }
   return noMoreInput_ && input_ == nullptr;
 }
 
@@ -49,7 +49,9 @@ class MergeJoin : public Operator {
       const RowTypePtr& leftType,
       const RowTypePtr& rightType);
 
-  RowVectorPtr doGetOutput();
+  // Adds rows to the output in progress. Returns true if the output is ready
+  // to be produced with makeOutput().
+  bool doGetOutput();
 
   static int32_t compare(
       const std::vector<column_index_t>& keys,
@@ -147,41 +149,56 @@ class MergeJoin : public Operator {
       const RowVectorPtr& input,
       const std::vector<column_index_t>& keys);
 
-  /// Initialize 'output_' vector using 'ouputType_' and 'outputBatchSize_' if
-  /// it is null.
-  void prepareOutput();
+  /// Checks that the output in progress can take a row from 'left' and
+  /// 'right', either of which is null for a row with no match. Output rows
+  /// are not copied but recorded as indices into one batch of each side,
+  /// which makeOutput() wraps in dictionaries. Returns false if the output is
+  /// full or refers to other batches, in which case it must be produced
+  /// before adding more rows.
+  bool prepareOutput(const RowVectorPtr& left, const RowVectorPtr& right);
+
+  /// Returns the output in progress and starts a new one. Returns nullptr if
+  /// the output has no rows.
+  RowVectorPtr makeOutput();
+
+  /// Returns the 'channel' column of 'input' wrapped in a dictionary over the
+  /// output rows, or a null constant of 'type' if 'input' is null.
+  VectorPtr wrapOutputColumn(
+      const RowVectorPtr& input,
+      column_index_t channel,
+      const TypePtr& type,
+      const BufferPtr& indices,
+      const BufferPtr& nulls,
+      bool hasNulls);
 
   // Appends a cartesian product of the current set of matching rows, leftMatch_
-  // x rightMatch_, to output_. Returns true if output_ is full. Sets
-  // leftMatchCursor_ and rightMatchCursor_ if output_ filled up before all the
-  // rows were added. Fills up output starting from leftMatchCursor_ and
-  // rightMatchCursor_ positions if these are set. Clears leftMatch_ and
-  // rightMatch_ if all rows were added. Updates leftMatchCursor_ and
-  // rightMatchCursor_ if output_ filled up before all rows were added.
+  // x rightMatch_, to the output. Returns true if the output must be produced
+  // before all the rows were added and sets the cursors of leftMatch_ and
+  // rightMatch_ to continue from. Fills up output starting from these cursors
+  // if set. Clears leftMatch_ and rightMatch_ if all rows were added.
   bool addToOutput();
 
-  // Adds one row of output by copying values from left and right batches at the
-  // specified rows. Advances outputSize_. Assumes that output_ has room.
-  //
-  // TODO: Copying is inefficient especially for complex type values. Consider
-  // an optimization of using dictionary wrapping when full batch of output can
-  // be produced using single batch of input from the left side and single batch
-  // of input from the right side.
+  // Adds one row of output for the 'leftIndex' row of 'left' and the
+  // 'rightIndex' row of the right side batch of the output. Advances
+  // outputSize_. Assumes that prepareOutput() returned true.
   void addOutputRow(
       const RowVectorPtr& left,
       vector_size_t leftIndex,
-      const RowVectorPtr& right,
       vector_size_t rightIndex);
 
   /// Adds one row of output for a left-side row with no right-side match.
-  /// Copies values from the 'index_' row on the left side and fills in nulls
-  /// for columns that correspond to the right side.
+  /// Uses the 'index_' row on the left side and nulls for columns that
+  /// correspond to the right side.
   void addOutputRowForLeftJoin();
 
-  /// Evaluates join filter on 'filterInput_' and returns 'output' that contains
-  /// a subset of rows on which the filter passed. Returns nullptr if no rows
-  /// passed the filter.
-  RowVectorPtr applyFilter(const RowVectorPtr& output);
+  /// Adds one row of output for a right-side row with no left-side match.
+  /// Uses the 'rightIndex_' row on the right side and nulls for columns that
+  /// correspond to the left side.
+  void addOutputRowForRightJoin();
+
+  /// Evaluates join filter on the output in progress and removes the rows on
+  /// which the filter did not pass.
+  void applyFilter();
 
   /// Evaluates 'filter_' on the specified rows of 'filterInput_' and decodes
   /// the result using 'decodedFilterResult_'.
@@ -359,7 +376,8 @@ class MergeJoin : public Operator {
   /// Maps right-side input channels to channels in 'filterInputType_'.
   std::vector<IdentityProjection> filterRightInputs_;
 
-  /// Reusable memory for filter evaluation.
+  /// Filter input columns wrapped over the output in progress and reusable
+  /// memory for filter evaluation.
   RowVectorPtr filterInput_;
   SelectivityVector filterRows_;
   std::vector<VectorPtr> filterResult_;
@@ -383,10 +401,28 @@ class MergeJoin : public Operator {
   /// A set of rows with matching keys on the right side.
   std::optional<Match> rightMatch_;
 
-  RowVectorPtr output_;
-
-  /// Number of rows accumulated in the output_.
-  vector_size_t outputSize_;
+  /// Left and right side batches the output in progress refers to. Null if
+  /// no output row refers to that side yet.
+  RowVectorPtr currentLeft_;
+  RowVectorPtr currentRight_;
+
+  /// Row numbers in 'currentLeft_' and 'currentRight_' for each output row.
+  BufferPtr leftIndices_;
+  vector_size_t* rawLeftIndices_{nullptr};
+  BufferPtr rightIndices_;
+  vector_size_t* rawRightIndices_{nullptr};
+
+  /// Output rows that have nulls for the left or right side columns because
+  /// the row on the other side has no match.
+  BufferPtr leftNulls_;
+  uint64_t* rawLeftNulls_{nullptr};
+  bool hasLeftNulls_{false};
+  BufferPtr rightNulls_;
+  uint64_t* rawRightNulls_{nullptr};
+  bool hasRightNulls_{false};
+
+  /// Number of rows accumulated in the output in progress.
+  vector_size_t outputSize_{0};
 
   /// A future that will be completed when right side input becomes available.
   ContinueFuture future_{ContinueFuture::makeEmpty()};
@@ -137,6 +137,15 @@ class MergeExchangeSource : public MergeSource {
         return BlockingReason::kWaitForExchange;
       }
     }
+    if (currentPage_->hasVectors()) {
+      mergeExchange_->stats().rawInputBytes += currentPage_->size();
+      data = currentPage_->copyVectors(
+          mergeExchange_->outputType(), mergeExchange_->pool());
+      currentPage_ = nullptr;
+      mergeExchange_->stats().inputPositions += data->size();
+      mergeExchange_->stats().inputBytes += data->retainedSize();
+      return BlockingReason::kNotBlocked;
+    }
     if (!inputStream_) {
       inputStream_ = std::make_unique<ByteStream>();
       mergeExchange_->stats().rawInputBytes += currentPage_->size();
@@ -148,7 +157,9 @@ class MergeExchangeSource : public MergeSource {
           inputStream_.get(),
           mergeExchange_->pool(),
           mergeExchange_->outputType(),
-          &data);
+          &data,
+          &mergeExchange_->serdeOptions(),
+          mergeExchange_->serde());
 
       mergeExchange_->stats().inputPositions += data->size();
       mergeExchange_->stats().inputBytes += data->retainedSize();
@@ -54,8 +54,13 @@ class SimpleExpressionEvaluator : public connector::ExpressionEvaluator {
 };
 } // namespace
 
-OperatorCtx::OperatorCtx(DriverCtx* driverCtx)
-    : driverCtx_(driverCtx), pool_(driverCtx_->addOperatorPool()) {}
+OperatorCtx::OperatorCtx(
+    DriverCtx* driverCtx,
+    int32_t operatorId,
+    const std::string& poolName)
+    : driverCtx_(driverCtx),
+      operatorId_(operatorId),
+      pool_(driverCtx_->addOperatorPool(poolName)) {}
 
 core::ExecCtx* OperatorCtx::execCtx() const {
   if (!execCtx_) {
@@ -78,7 +83,8 @@ OperatorCtx::createConnectorQueryCtx(
       driverCtx_->task->queryCtx()->getConnectorConfig(connectorId),
       expressionEvaluator_.get(),
       driverCtx_->task->queryCtx()->mappedMemory(),
-      fmt::format("{}.{}", driverCtx_->task->taskId(), planNodeId));
+      fmt::format("{}.{}", driverCtx_->task->taskId(), planNodeId),
+      driverCtx_->queryConfig().cacheQuotaGroup());
 }
 
 std::vector<std::unique_ptr<Operator::PlanNodeTranslator>>&
@@ -199,6 +205,18 @@ RowVectorPtr Operator::fillOutput(vector_size_t size, BufferPtr mapping) {
       std::move(columns));
 }
 
+vector_size_t Operator::outputBatchRows(
+    std::optional<int64_t> averageRowSize) const {
+  const auto& config = operatorCtx_->driverCtx()->queryConfig();
+  if (!averageRowSize.has_value() || averageRowSize.value() <= 0) {
+    return config.preferredOutputBatchSize();
+  }
+  return std::clamp<int64_t>(
+      config.preferredOutputBatchBytes() / averageRowSize.value(),
+      1,
+      config.maxOutputBatchRows());
+}
+
 void Operator::recordBlockingTime(uint64_t start) {
   uint64_t now =
       std::chrono::duration_cast<std::chrono::microseconds>(
@@ -293,6 +311,8 @@ void OperatorStats::add(const OperatorStats& other) {
 
   finishTiming.add(other.finishTiming);
 
+  perfCounters.add(other.perfCounters);
+
   memoryStats.add(other.memoryStats);
 
   for (const auto& [name, stats] : other.runtimeStats) {
@@ -305,6 +325,7 @@ void OperatorStats::add(const OperatorStats& other) {
 
   numDrivers += other.numDrivers;
   spilledBytes += other.spilledBytes;
+  spilledUncompressedBytes += other.spilledUncompressedBytes;
   spilledRows += other.spilledRows;
 }
 
@@ -327,8 +348,14 @@ void OperatorStats::clear() {
 
   finishTiming.clear();
 
+  perfCounters.clear();
+
   memoryStats.clear();
 
+  spilledBytes = 0;
+  spilledUncompressedBytes = 0;
+  spilledRows = 0;
+
   runtimeStats.clear();
 }
 
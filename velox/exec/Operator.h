@@ -15,6 +15,7 @@
  */
 #pragma once
 #include "velox/common/base/RuntimeMetrics.h"
+#include "velox/common/process/PerfCounters.h"
 #include "velox/common/time/CpuWallTimer.h"
 #include "velox/core/PlanNode.h"
 #include "velox/exec/Driver.h"
@@ -124,11 +125,19 @@ struct OperatorStats {
 
   CpuWallTiming finishTiming;
 
+  /// Hardware counts of the addInput, getOutput and finish calls. Set if
+  /// QueryConfig::kOperatorPerfCountersEnabled is true.
+  process::PerfCounterValues perfCounters;
+
   MemoryStats memoryStats;
 
   // Total bytes written for spilling.
   uint64_t spilledBytes{0};
 
+  // Total bytes of spilled data before compression. Equal to 'spilledBytes'
+  // if spill compression is off.
+  uint64_t spilledUncompressedBytes{0};
+
   // Total rows written for spilling.
   uint64_t spilledRows{0};
 
@@ -155,13 +164,28 @@ struct OperatorStats {
     runtimeStats.at(name).addValue(value.value);
   }
 
+  // Merges 'metric' into the runtime stat 'name'. Used for metrics that
+  // carry a histogram.
+  void addRuntimeStat(const std::string& name, const RuntimeMetric& metric) {
+    auto it = runtimeStats.find(name);
+    if (it == runtimeStats.end()) {
+      runtimeStats.insert(std::pair(name, metric));
+    } else {
+      it->second.merge(metric);
+    }
+  }
+
   void add(const OperatorStats& other);
   void clear();
 };
 
 class OperatorCtx {
  public:
-  explicit OperatorCtx(DriverCtx* driverCtx);
+  // 'poolName' names the memory pool of the operator, e.g. in heap profiles.
+  OperatorCtx(
+      DriverCtx* driverCtx,
+      int32_t operatorId,
+      const std::string& poolName = "operator_ctx");
 
   const std::shared_ptr<Task>& task() const {
     return driverCtx_->task;
@@ -177,6 +201,15 @@ class OperatorCtx {
     return driverCtx_;
   }
 
+  int32_t operatorId() const {
+    return operatorId_;
+  }
+
+  // Returns the timeline of the Driver or nullptr if tracing is disabled.
+  DriverTrace* FOLLY_NULLABLE driverTrace() const {
+    return driverCtx_->driver ? driverCtx_->driver->trace().get() : nullptr;
+  }
+
   velox::memory::MemoryPool* pool() const {
     return pool_;
   }
@@ -194,6 +227,7 @@ class OperatorCtx {
 
  private:
   DriverCtx* driverCtx_;
+  const int32_t operatorId_;
   velox::memory::MemoryPool* pool_;
 
   // These members are created on demand.
@@ -249,7 +283,10 @@ class Operator {
       int32_t operatorId,
       std::string planNodeId,
       std::string operatorType)
-      : operatorCtx_(std::make_unique<OperatorCtx>(driverCtx)),
+      : operatorCtx_(std::make_unique<OperatorCtx>(
+            driverCtx,
+            operatorId,
+            fmt::format("op.{}.{}", planNodeId, operatorType))),
         stats_(
             operatorId,
             driverCtx->pipelineId,
@@ -328,6 +365,19 @@ class Operator {
         toString());
   }
 
+  // Returns an estimate of the memory 'this' could free by spilling its state,
+  // 0 if 'this' cannot spill at this point. Called by memory arbitration
+  // while the Driver of 'this' is off thread.
+  virtual uint64_t reclaimableBytes() const {
+    return 0;
+  }
+
+  // Spills the state of 'this' to free memory. Called only if
+  // reclaimableBytes() returned non-zero and under the same conditions.
+  virtual void reclaim() {
+    VELOX_UNSUPPORTED("This operator doesn't support reclaim: {}", toString());
+  }
+
   // Returns a list of identify projections, e.g. columns that are projected
   // as-is possibly after applying a filter.
   const std::vector<IdentityProjection>& identityProjections() const {
@@ -341,6 +391,11 @@ class Operator {
     results_.clear();
   }
 
+  // Adds to 'stats_' the stats that are not kept up to date while running.
+  // Called once when the Driver is done, before the stats are added to the
+  // Task.
+  virtual void finalizeStats() {}
+
   // Returns true if 'this' never has more output rows than input rows.
   virtual bool isFilter() const {
     return false;
@@ -350,6 +405,18 @@ class Operator {
     return false;
   }
 
+  // Returns true if 'this' has exactly one output row per input row.
+  virtual bool preservesCardinality() const {
+    return false;
+  }
+
+  // Returns the number of input rows after which 'this' needs no more input,
+  // e.g. the offset plus the count of a Limit, or std::nullopt if 'this'
+  // consumes all its input.
+  virtual std::optional<int64_t> rowLimit() const {
+    return std::nullopt;
+  }
+
   OperatorStats& stats() {
     return stats_;
   }
@@ -399,6 +466,12 @@ class Operator {
   // 'identityProjections_' and 'resultProjections_'.
   RowVectorPtr fillOutput(vector_size_t size, BufferPtr mapping);
 
+  // Returns the number of rows of 'averageRowSize' bytes that make an
+  // output batch of about QueryConfig::preferredOutputBatchBytes(), at
+  // least 1 and at most QueryConfig::maxOutputBatchRows(). Returns
+  // QueryConfig::preferredOutputBatchSize() if the row size is not known.
+  vector_size_t outputBatchRows(std::optional<int64_t> averageRowSize) const;
+
   std::unique_ptr<OperatorCtx> operatorCtx_;
   OperatorStats stats_;
   const std::shared_ptr<const RowType> outputType_;
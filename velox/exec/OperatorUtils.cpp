@@ -21,6 +21,59 @@
 
 namespace facebook::velox::exec {
 
+void setSpillPathStats(
+    const std::vector<SpillPathStats>& pathStats,
+    OperatorStats& stats) {
+  std::optional<int64_t> overflowBytes;
+  for (auto i = 0; i < pathStats.size(); ++i) {
+    if (pathStats[i].overflow) {
+      overflowBytes = overflowBytes.value_or(0) + pathStats[i].bytes;
+    }
+    RuntimeMetric bytes(RuntimeCounter::Unit::kBytes);
+    bytes.addValue(pathStats[i].bytes);
+    stats.runtimeStats[fmt::format("spillPath{}Bytes", i)] = std::move(bytes);
+    RuntimeMetric time(RuntimeCounter::Unit::kNanos);
+    time.addValue(pathStats[i].writeMicros * 1'000);
+    stats.runtimeStats[fmt::format("spillPath{}WriteTime", i)] =
+        std::move(time);
+  }
+  if (overflowBytes.has_value()) {
+    RuntimeMetric bytes(RuntimeCounter::Unit::kBytes);
+    bytes.addValue(overflowBytes.value());
+    stats.runtimeStats["spillOverflowBytes"] = std::move(bytes);
+  }
+}
+
+folly::io::CodecType compressionCodec(
+    const std::string& kind,
+    std::string_view setting) {
+  static const std::unordered_map<std::string, folly::io::CodecType> kCodecs =
+      {{"none", folly::io::CodecType::NO_COMPRESSION},
+       {"lz4", folly::io::CodecType::LZ4},
+       {"zstd", folly::io::CodecType::ZSTD},
+       {"zlib", folly::io::CodecType::ZLIB},
+       {"snappy", folly::io::CodecType::SNAPPY}};
+  auto it = kCodecs.find(kind);
+  VELOX_USER_CHECK(
+      it != kCodecs.end(),
+      "Unsupported {} compression kind: {}",
+      setting,
+      kind);
+  VELOX_USER_CHECK(
+      folly::io::hasCodec(it->second),
+      "{} compression kind {} is not available in this build",
+      setting,
+      kind);
+  return it->second;
+}
+
+VectorSerde* FOLLY_NULLABLE namedVectorSerde(const std::string& name) {
+  if (name.empty()) {
+    return nullptr;
+  }
+  return getNamedVectorSerde(name);
+}
+
 void deselectRowsWithNulls(
     const RowVector& input,
     const std::vector<column_index_t>& channels,
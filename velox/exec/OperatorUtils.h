@@ -15,10 +15,34 @@
  */
 #pragma once
 
+#include <folly/compression/Compression.h>
+
 #include "velox/exec/Operator.h"
+#include "velox/exec/Spill.h"
+#include "velox/vector/VectorStream.h"
 
 namespace facebook::velox::exec {
 
+// Returns the codec type for a compression kind name. Supported names are
+// "none", "lz4", "zstd", "zlib" and "snappy". 'setting' names what is
+// compressed, e.g. "spill", in error messages.
+folly::io::CodecType compressionCodec(
+    const std::string& kind,
+    std::string_view setting);
+
+// Returns the serde named by 'name', nullptr for the default serde if 'name'
+// is empty. Throws if no serde is registered under 'name'.
+VectorSerde* FOLLY_NULLABLE namedVectorSerde(const std::string& name);
+
+// Sets the runtime stats 'spillPath<i>Bytes' and 'spillPath<i>WriteTime' of
+// 'stats' to the bytes written to and the time spent writing to the ith spill
+// directory. 'spillOverflowBytes' is set to the bytes written to the overflow
+// tier if the spill path has one. 'pathStats' are cumulative, so these replace
+// earlier values.
+void setSpillPathStats(
+    const std::vector<SpillPathStats>& pathStats,
+    OperatorStats& stats);
+
 // Deselects rows from 'rows' where any of the 'input' children
 // in 'channels' has a null.
 void deselectRowsWithNulls(
@@ -14,10 +14,83 @@
  * limitations under the License.
  */
 #include "velox/exec/OrderBy.h"
+#include "velox/exec/OperatorUtils.h"
+#include "velox/exec/SortKeyEncoder.h"
+#include "velox/exec/Task.h"
+#include "velox/expression/EvalCtx.h"
 #include "velox/vector/FlatVector.h"
 
 namespace facebook::velox::exec {
 
+namespace {
+std::optional<std::string> makeSpillPath(const OperatorCtx& operatorCtx) {
+  auto path = operatorCtx.task()->queryCtx()->config().spillPath();
+  if (path.has_value()) {
+    return appendToSpillPath(
+        path.value(), "/" + operatorCtx.task()->taskId());
+  }
+  return std::nullopt;
+}
+
+// A stream over sorted rows of a RowContainer for merging the rows sorted by
+// the Drivers of an OrderBy. The RowContainers of all Drivers have the same
+// layout.
+class SortedRowsStream : public MergeStream {
+ public:
+  SortedRowsStream(
+      RowContainer& container,
+      std::vector<char*> rows,
+      const SortKeyEncoder& encoder,
+      const std::vector<CompareFlags>& compareFlags)
+      : container_(container),
+        rows_(std::move(rows)),
+        encoder_(encoder),
+        compareFlags_(compareFlags),
+        key_(encoder.keySize()) {
+    encodeKey();
+  }
+
+  bool hasData() const override {
+    return index_ < rows_.size();
+  }
+
+  bool operator<(const MergeStream& other) const override {
+    const auto& otherStream = static_cast<const SortedRowsStream&>(other);
+    if (auto result = encoder_.compare(key_.data(), otherStream.key_.data())) {
+      return result < 0;
+    }
+    if (encoder_.isComplete()) {
+      return false;
+    }
+    return container_.compareRows(
+               current(), otherStream.current(), compareFlags_) < 0;
+  }
+
+  char* current() const {
+    return rows_[index_];
+  }
+
+  void pop() {
+    ++index_;
+    encodeKey();
+  }
+
+ private:
+  void encodeKey() {
+    if (hasData()) {
+      encoder_.encode(container_, current(), key_.data());
+    }
+  }
+
+  RowContainer& container_;
+  const std::vector<char*> rows_;
+  const SortKeyEncoder& encoder_;
+  const std::vector<CompareFlags>& compareFlags_;
+  size_t index_{0};
+  std::vector<char> key_;
+};
+} // namespace
+
 OrderBy::OrderBy(
     int32_t operatorId,
     DriverCtx* driverCtx,
@@ -28,70 +101,323 @@ OrderBy::OrderBy(
           operatorId,
           orderByNode->id(),
           "OrderBy"),
-      data_(std::make_unique<RowContainer>(
-          outputType_->as<TypeKind::ROW>().children(),
-          operatorCtx_->mappedMemory())) {
+      spillPath_(makeSpillPath(*operatorCtx_)),
+      spillExecutor_(operatorCtx_->task()->queryCtx()->spillExecutor()),
+      spillCompression_(spillCompressionCodec(
+          spillPath_,
+          operatorCtx_->task()->queryCtx()->config().spillCompressionKind())),
+      spillLocalQuotaBytes_(
+          operatorCtx_->task()->queryCtx()->config().spillLocalQuotaBytes()),
+      testSpillPct_(
+          operatorCtx_->task()->queryCtx()->config().testingSpillPct()),
+      sortThreads_(
+          operatorCtx_->task()->queryCtx()->config().orderBySortThreads()) {
   auto type = orderByNode->outputType();
   auto numKeys = orderByNode->sortingKeys().size();
+  columnMap_.resize(type->size(), kConstantChannel);
+  std::vector<TypePtr> keyTypes;
   for (int i = 0; i < numKeys; ++i) {
     auto channel = exprToChannel(orderByNode->sortingKeys()[i].get(), type);
     VELOX_CHECK(
         channel != kConstantChannel,
         "OrderBy doesn't allow constant grouping keys");
-    keyInfo_.emplace_back(channel, orderByNode->sortingOrders()[i]);
+    keyTypes.push_back(type->childAt(channel));
+    inputChannels_.push_back(channel);
+    auto sortOrder = orderByNode->sortingOrders()[i];
+    compareFlags_.push_back(
+        {sortOrder.isNullsFirst(), sortOrder.isAscending(), false});
+    if (columnMap_[channel] == kConstantChannel) {
+      columnMap_[channel] = i;
+    }
+  }
+  std::vector<TypePtr> dependentTypes;
+  for (auto i = 0; i < type->size(); ++i) {
+    if (columnMap_[i] == kConstantChannel) {
+      columnMap_[i] = numKeys + dependentTypes.size();
+      dependentTypes.push_back(type->childAt(i));
+      inputChannels_.push_back(i);
+    }
   }
+  keyEncoder_ = std::make_unique<SortKeyEncoder>(keyTypes, compareFlags_);
+  data_ = std::make_unique<RowContainer>(
+      keyTypes, dependentTypes, operatorCtx_->mappedMemory());
 }
 
 void OrderBy::addInput(RowVectorPtr input) {
+  ensureInputFits(input);
+
   SelectivityVector allRows(input->size());
   std::vector<char*> rows(input->size());
   for (int row = 0; row < input->size(); ++row) {
     rows[row] = data_->newRow();
   }
-  for (size_t col = 0; col < input->childrenSize(); ++col) {
-    DecodedVector decoded(*input->childAt(col), allRows);
+  LocalDecodedVector decoded(operatorCtx_->execCtx());
+  for (auto col = 0; col < inputChannels_.size(); ++col) {
+    decoded.get()->decode(*input->childAt(inputChannels_[col]), allRows);
     for (int i = 0; i < input->size(); ++i) {
-      data_->store(decoded, i, rows[i], col);
+      data_->store(*decoded.get(), i, rows[i], col);
     }
   }
 
   numRows_ += allRows.size();
 }
 
+void OrderBy::ensureInputFits(const RowVectorPtr& input) {
+  // Spilling is considered if spillPath is set.
+  if (!spillPath_.has_value()) {
+    return;
+  }
+  auto numRows = data_->numRows();
+  if (!numRows) {
+    // Nothing to spill.
+    return;
+  }
+
+  // Test-only spill path.
+  if (testSpillPct_ &&
+      (folly::hasher<uint64_t>()(++spillTestCounter_)) % 100 <= testSpillPct_) {
+    spill();
+    return;
+  }
+
+  auto [freeRows, outOfLineFreeBytes] = data_->freeSpace();
+  auto outOfLineBytes =
+      data_->stringAllocator().retainedSize() - outOfLineFreeBytes;
+  int64_t flatBytes = input->estimateFlatSize();
+  if (freeRows > input->size() &&
+      (outOfLineBytes == 0 || outOfLineFreeBytes >= flatBytes)) {
+    // Enough free rows for input rows and enough variable length free
+    // space for the flat size of the whole vector. If outOfLineBytes
+    // is 0 there is no need for variable length space.
+    return;
+  }
+  // If there is variable length data we take the flat size of the
+  // input as a cap on the new variable length data needed.
+  auto increment =
+      data_->sizeIncrement(input->size(), outOfLineBytes ? flatBytes : 0);
+  auto tracker = operatorCtx_->mappedMemory()->tracker();
+  assert(tracker);
+  // There must be at least 2x the increment in reservation.
+  if (tracker->getAvailableReservation() > 2 * increment) {
+    return;
+  }
+
+  // Check if can increase reservation. The increment is the larger of
+  // twice the maximum increment from this input and 1/4 of the current
+  // reservation.
+  auto targetIncrement =
+      std::max<int64_t>(increment * 2, tracker->getCurrentUserBytes() / 4);
+  if (tracker->maybeReserve(targetIncrement)) {
+    return;
+  }
+  spill();
+}
+
+uint64_t OrderBy::reclaimableBytes() const {
+  // Once all input is received the rows are being returned and can no longer
+  // be spilled.
+  if (!spillPath_.has_value() || noMoreInput_ || data_->numRows() == 0) {
+    return 0;
+  }
+  return data_->allocatedBytes();
+}
+
+void OrderBy::reclaim() {
+  spill();
+  // Give back the reservation made for the spilled rows.
+  operatorCtx_->mappedMemory()->tracker()->release();
+}
+
+void OrderBy::spill() {
+  DriverTrace::Scope traceScope(
+      operatorCtx_->driverTrace(),
+      DriverTrace::EventType::kSpill,
+      operatorCtx_->operatorId());
+  if (!spiller_) {
+    auto& types = data_->columnTypes();
+    std::vector<std::string> names;
+    for (auto i = 0; i < types.size(); ++i) {
+      names.push_back(fmt::format("s{}", i));
+    }
+    auto tracker = operatorCtx_->mappedMemory()->tracker();
+    assert(tracker); // lint
+    auto fileSize = tracker->getCurrentUserBytes() / 4;
+    spiller_ = std::make_unique<Spiller>(
+        *data_,
+        [&](folly::Range<char**> rows) { data_->eraseRows(rows); },
+        ROW(std::move(names), std::vector<TypePtr>(types)),
+        // All rows go to one partition. The runs are sorted on the keys.
+        HashBitRange(0, 0),
+        data_->keyTypes().size(),
+        spillPath_.value(),
+        fileSize,
+        Spiller::spillPool(),
+        spillExecutor_,
+        compareFlags_,
+        spillCompression_,
+        spillLocalQuotaBytes_);
+  }
+  // A target of 0 rows writes all rows of 'data_' as one sorted run.
+  spiller_->spill(0, 0, spillIterator_);
+  auto spilled = spiller_->spilledBytesAndRows();
+  stats_.spilledBytes = spilled.first;
+  stats_.spilledRows = spilled.second;
+  stats_.spilledUncompressedBytes = spiller_->spilledUncompressedBytes();
+  setSpillPathStats(spiller_->spillPathStats(), stats_);
+}
+
 void OrderBy::noMoreInput() {
   Operator::noMoreInput();
 
+  if (spiller_) {
+    // The rows left in 'data_' are sorted and merged with the spilled runs.
+    // All rows are in the one spilling partition. An OrderBy that may spill
+    // runs on a single Driver.
+    spiller_->finishSpill();
+    merge_ = spiller_->startMerge(0);
+    return;
+  }
+
+  // Sort the pointers to the rows in RowContainer (data_) instead of sorting
+  // the rows. The pointers are sorted on normalized keys, which are compared
+  // with memcmp.
+  if (numRows_ > 0) {
+    returningRows_.resize(numRows_);
+    RowContainerIterator iter;
+    data_->listRows(&iter, numRows_, returningRows_.data());
+    keyEncoder_->sortRows(
+        *data_,
+        folly::Range<char**>(returningRows_.data(), returningRows_.size()),
+        *pool(),
+        operatorCtx_->task()->queryCtx()->executor(),
+        sortThreads_);
+  }
+
+  // The last Driver to finish merges the sorted rows of all Drivers. The
+  // others finish once their rows are taken. With one Driver there are no
+  // peers to wait for.
+  std::vector<ContinuePromise> promises;
+  std::vector<std::shared_ptr<Driver>> peers;
+  if (!operatorCtx_->task()->allPeersFinished(
+          planNodeId(), operatorCtx_->driver(), &future_, promises, peers)) {
+    finished_ = true;
+    return;
+  }
+  if (!peers.empty()) {
+    mergePeers(peers);
+  }
+  for (auto& promise : promises) {
+    promise.setValue();
+  }
+
   // No data.
   if (numRows_ == 0) {
     finished_ = true;
+  }
+}
+
+void OrderBy::mergePeers(const std::vector<std::shared_ptr<Driver>>& peers) {
+  std::vector<std::unique_ptr<SortedRowsStream>> streams;
+  if (numRows_ > 0) {
+    streams.push_back(std::make_unique<SortedRowsStream>(
+        *data_, std::move(returningRows_), *keyEncoder_, compareFlags_));
+  }
+  for (auto& peer : peers) {
+    auto* peerOrderBy =
+        dynamic_cast<OrderBy*>(peer->findOperator(planNodeId()));
+    VELOX_CHECK_NOT_NULL(peerOrderBy);
+    if (peerOrderBy->numRows_ == 0) {
+      continue;
+    }
+    streams.push_back(std::make_unique<SortedRowsStream>(
+        *peerOrderBy->data_,
+        std::move(peerOrderBy->returningRows_),
+        *keyEncoder_,
+        compareFlags_));
+    numRows_ += peerOrderBy->numRows_;
+    peerData_.push_back(std::move(peerOrderBy->data_));
+  }
+  returningRows_.clear();
+  if (streams.empty()) {
     return;
   }
+  returningRows_.reserve(numRows_);
+  TreeOfLosers<SortedRowsStream> merge(std::move(streams));
+  while (auto* stream = merge.next()) {
+    returningRows_.push_back(stream->current());
+    stream->pop();
+  }
+}
 
-  // Sort the pointers to the rows in RowContainer (data_) instead of sorting
-  // the rows.
-  returningRows_.resize(numRows_);
-  RowContainerIterator iter;
-  data_->listRows(&iter, numRows_, returningRows_.data());
-
-  std::sort(
-      returningRows_.begin(),
-      returningRows_.end(),
-      [this](const char* leftRow, const char* rightRow) {
-        for (auto& [channelIndex, sortOrder] : keyInfo_) {
-          if (auto result = data_->compare(
-                  leftRow,
-                  rightRow,
-                  channelIndex,
-                  {sortOrder.isNullsFirst(), sortOrder.isAscending(), false})) {
-            return result < 0;
-          }
-        }
-        return false; // lhs == rhs.
-      });
+BlockingReason OrderBy::isBlocked(ContinueFuture* future) {
+  if (!future_.valid()) {
+    return BlockingReason::kNotBlocked;
+  }
+  *future = std::move(future_);
+  return BlockingReason::kWaitForPeers;
+}
+
+RowVectorPtr OrderBy::getOutputWithSpill() {
+  auto maxRows = data_->estimatedNumRowsPerBatch(kBatchSizeInBytes);
+  auto result = std::dynamic_pointer_cast<RowVector>(
+      BaseVector::create(outputType_, maxRows, operatorCtx_->pool()));
+
+  // Consecutive rows that come from the same batch of the same stream are
+  // copied as one range. 'runStream' is the stream of the current range,
+  // which starts at output row 'runStart' and source row 'runSourceStart'.
+  SpillStream* runStream = nullptr;
+  vector_size_t runStart = 0;
+  vector_size_t runSourceStart = 0;
+  auto copyRun = [&](vector_size_t runEnd) {
+    if (!runStream) {
+      return;
+    }
+    auto& input = runStream->current();
+    for (auto i = 0; i < outputType_->size(); ++i) {
+      result->childAt(i)->copy(
+          input.childAt(columnMap_[i]).get(),
+          runStart,
+          runSourceStart,
+          runEnd - runStart);
+    }
+    runStream = nullptr;
+  };
+
+  vector_size_t numRows = 0;
+  for (; numRows < maxRows; ++numRows) {
+    auto stream = merge_->next();
+    if (!stream) {
+      finished_ = true;
+      break;
+    }
+    if (stream != runStream) {
+      copyRun(numRows);
+      runStream = stream;
+      runStart = numRows;
+      runSourceStart = stream->currentIndex();
+    }
+    if (stream->currentIndex() + 1 == stream->current().size()) {
+      // pop() replaces the batch of 'stream'.
+      copyRun(numRows + 1);
+    }
+    stream->pop();
+  }
+  copyRun(numRows);
+  if (!numRows) {
+    return nullptr;
+  }
+  result->resize(numRows);
+  return result;
 }
 
 RowVectorPtr OrderBy::getOutput() {
-  if (finished_ || !noMoreInput_ || returningRows_.size() == numRowsReturned_) {
+  if (finished_ || !noMoreInput_) {
+    return nullptr;
+  }
+  if (merge_) {
+    return getOutputWithSpill();
+  }
+  if (returningRows_.size() == numRowsReturned_) {
     return nullptr;
   }
 
@@ -108,7 +434,7 @@ RowVectorPtr OrderBy::getOutput() {
     data_->extractColumn(
         returningRows_.data() + numRowsReturned_,
         numRowsToReturn,
-        i,
+        columnMap_[i],
         result->childAt(i));
   }
 
@@ -18,6 +18,8 @@
 #include "velox/exec/ContainerRowSerde.h"
 #include "velox/exec/Operator.h"
 #include "velox/exec/RowContainer.h"
+#include "velox/exec/SortKeyEncoder.h"
+#include "velox/exec/Spiller.h"
 
 namespace facebook::velox::exec {
 
@@ -27,11 +29,19 @@ namespace facebook::velox::exec {
 // to the rows using the RowContainer's compare() function. And finally it
 // constructs and returns the sorted output RowVector using the data in the
 // RowContainer.
+//
+// If a spill path is set in the query config and the memory reservation
+// cannot be increased for new input, the rows in the RowContainer are sorted
+// and written to disk as a sorted run. The output is then produced by
+// merging the sorted runs and the rows remaining in memory.
+//
+// If spilling is disabled, a final OrderBy may run on several Drivers (see
+// QueryConfig::kOrderByMultiDriverEnabled). Each Driver sorts the rows it
+// received. The last Driver to finish merges the sorted rows of all Drivers
+// and produces the output. The other Drivers finish without output.
 // Limitations:
 // * It memcopies twice: 1) input to RowContainer and 2) RowContainer to
 // output.
-// * It does not support spilling. For now, if memory limit exceeds, it will
-// throw an exception: VeloxMemoryCapExceeded.
 class OrderBy : public Operator {
  public:
   OrderBy(
@@ -49,24 +59,87 @@ class OrderBy : public Operator {
 
   RowVectorPtr getOutput() override;
 
-  BlockingReason isBlocked(ContinueFuture* /*future*/) override {
-    return BlockingReason::kNotBlocked;
-  }
+  BlockingReason isBlocked(ContinueFuture* future) override;
 
   bool isFinished() override {
-    return finished_;
+    return finished_ && !future_.valid();
   }
 
+  uint64_t reclaimableBytes() const override;
+
+  void reclaim() override;
+
  private:
   static const int32_t kBatchSizeInBytes{2 * 1024 * 1024};
 
+  // Checks that there is memory for adding 'input' to 'data_'. If the
+  // reservation cannot be increased, spills all rows of 'data_'.
+  void ensureInputFits(const RowVectorPtr& input);
+
+  // Writes all rows of 'data_' to disk as a sorted run.
+  void spill();
+
+  // Produces the next batch of output by merging the spilled runs.
+  RowVectorPtr getOutputWithSpill();
+
+  // Merges the sorted rows of the OrderBy operators of 'peers' into
+  // 'returningRows_' and takes ownership of their RowContainers.
+  void mergePeers(const std::vector<std::shared_ptr<Driver>>& peers);
+
   std::unique_ptr<RowContainer> data_;
-  std::vector<std::pair<column_index_t, core::SortOrder>> keyInfo_;
+
+  // Sort order of the keys. The keys are the leading columns of 'data_'.
+  std::vector<CompareFlags> compareFlags_;
+
+  std::unique_ptr<SortKeyEncoder> keyEncoder_;
+
+  // Number of threads for sorting 'data_'. See
+  // QueryConfig::kOrderBySortThreads.
+  const int32_t sortThreads_;
+
+  // RowContainers of the other Drivers whose rows are in 'returningRows_'.
+  std::vector<std::unique_ptr<RowContainer>> peerData_;
+
+  // Set while waiting for the other Drivers to sort their rows.
+  ContinueFuture future_{ContinueFuture::makeEmpty()};
+
+  // Column in 'data_' for each output channel. The sorting keys come first in
+  // 'data_', followed by the other columns.
+  std::vector<column_index_t> columnMap_;
+
+  // Input channel for each column of 'data_'. A channel appears more than
+  // once if it is repeated in the sorting keys.
+  std::vector<column_index_t> inputChannels_;
 
   size_t numRows_ = 0;
   size_t numRowsReturned_ = 0;
   std::vector<char*> returningRows_;
 
+  // Path prefix for spill files. Not set if spilling is disabled.
+  const std::optional<std::string> spillPath_;
+
+  folly::Executor* const spillExecutor_;
+
+  // Codec for compressing the spill files. NO_COMPRESSION if spilling is
+  // disabled.
+  const folly::io::CodecType spillCompression_;
+
+  // Local spill bytes of the process above which spill files go to the
+  // overflow tier of 'spillPath_'. 0 means no quota.
+  const uint64_t spillLocalQuotaBytes_;
+
+  const int32_t testSpillPct_;
+
+  uint64_t spillTestCounter_{0};
+
+  std::unique_ptr<Spiller> spiller_;
+
+  RowContainerIterator spillIterator_;
+
+  // Merge of the spilled runs and the unspilled rows. Set in noMoreInput()
+  // if spilled.
+  std::unique_ptr<TreeOfLosers<SpillStream>> merge_;
+
   bool finished_ = false;
 };
 } // namespace facebook::velox::exec
@@ -30,9 +30,7 @@ BlockingReason Destination::advance(
     *atEnd = true;
     return BlockingReason::kNotBlocked;
   }
-  uint32_t adjustedMaxBytes = std::max(
-      PartitionedOutput::kMinDestinationSize,
-      (maxBytes * targetSizePct_) / 100);
+  uint32_t adjustedMaxBytes = targetBytes(maxBytes);
   if (bytesInCurrent_ >= adjustedMaxBytes) {
     return flush(bufferManager, future);
   }
@@ -58,45 +56,128 @@ BlockingReason Destination::advance(
   return BlockingReason::kNotBlocked;
 }
 
-void Destination::serialize(
+VectorStreamGroup* Destination::prepareAppendBatch(
+    uint64_t maxBytes,
+    const std::vector<vector_size_t>& sizes,
+    const RowVectorPtr& output) {
+  if (row_ > 0 || rows_.empty() || rows_.size() > targetNumRows_) {
+    return nullptr;
+  }
+  const auto adjustedMaxBytes = targetBytes(maxBytes);
+  auto bytes = bytesInCurrent_;
+  for (auto& range : rows_) {
+    for (vector_size_t i = 0; i < range.size; ++i) {
+      bytes += sizes[range.begin + i];
+    }
+    if (bytes >= adjustedMaxBytes) {
+      return nullptr;
+    }
+  }
+  ensureCurrent(output, 0, rows_.size());
+  bytesInCurrent_ = bytes;
+  row_ = rows_.size();
+  return current_.get();
+}
+
+uint64_t Destination::targetBytes(uint64_t maxBytes) const {
+  return std::max(
+      PartitionedOutput::kMinDestinationSize,
+      (maxBytes * targetSizePct_) / 100);
+}
+
+void Destination::ensureCurrent(
     const RowVectorPtr& output,
     vector_size_t begin,
     vector_size_t end) {
-  if (!current_) {
-    current_ = std::make_unique<VectorStreamGroup>(memory_);
-    auto rowType = std::dynamic_pointer_cast<const RowType>(output->type());
-    vector_size_t numRows = 0;
+  if (current_) {
+    return;
+  }
+  current_ = std::make_shared<VectorStreamGroup>(memory_, serde_);
+  auto rowType = std::dynamic_pointer_cast<const RowType>(output->type());
+  vector_size_t numRows = 0;
+  for (vector_size_t i = begin; i < end; i++) {
+    numRows += rows_[i].size;
+  }
+  current_->createStreamTree(rowType, numRows, serdeOptions_);
+}
+
+void Destination::appendVectors(
+    const RowVectorPtr& output,
+    vector_size_t begin,
+    vector_size_t end) {
+  vector_size_t numRows = 0;
+  for (vector_size_t i = begin; i < end; i++) {
+    numRows += rows_[i].size;
+  }
+  // A destination gets each row at most once and in order, so that all rows
+  // means the whole vector.
+  BufferPtr indices;
+  if (numRows < output->size()) {
+    indices = allocateIndices(numRows, output->pool());
+    auto rawIndices = indices->asMutable<vector_size_t>();
     for (vector_size_t i = begin; i < end; i++) {
-      numRows += rows_[i].size;
+      std::iota(rawIndices, rawIndices + rows_[i].size, rows_[i].begin);
+      rawIndices += rows_[i].size;
     }
-    current_->createStreamTree(rowType, numRows);
   }
+  std::vector<VectorPtr> children;
+  children.reserve(output->childrenSize());
+  for (auto& child : output->children()) {
+    auto loaded = BaseVector::loadedVectorShared(child);
+    children.push_back(
+        indices
+            ? BaseVector::wrapInDictionary(nullptr, indices, numRows, loaded)
+            : loaded);
+  }
+  vectors_.push_back(std::make_shared<RowVector>(
+      output->pool(), output->type(), nullptr, numRows, std::move(children)));
+}
+
+void Destination::serialize(
+    const RowVectorPtr& output,
+    vector_size_t begin,
+    vector_size_t end) {
+  if (vectorPageOwner_) {
+    appendVectors(output, begin, end);
+    return;
+  }
+  ensureCurrent(output, begin, end);
   current_->append(output, folly::Range(&rows_[begin], end - begin));
 }
 
 BlockingReason Destination::flush(
     PartitionedOutputBufferManager& bufferManager,
     ContinueFuture* future) {
-  if (!current_) {
-    return BlockingReason::kNotBlocked;
+  std::unique_ptr<SerializedPage> page;
+  if (vectorPageOwner_) {
+    if (vectors_.empty()) {
+      return BlockingReason::kNotBlocked;
+    }
+    page = std::make_unique<SerializedPage>(
+        std::move(vectors_), bytesInCurrent_, vectorPageOwner_);
+    vectors_.clear();
+  } else {
+    if (!current_) {
+      return BlockingReason::kNotBlocked;
+    }
+    // Upper limit of message size with no columns.
+    constexpr int32_t kMinMessageSize = 128;
+    auto listener = bufferManager.newListener();
+    IOBufOutputStream stream(
+        *current_->mappedMemory(),
+        listener.get(),
+        kMinMessageSize);
+    // The page references the larger ranges of 'current_' instead of
+    // copying them.
+    stream.shareArena(current_);
+    current_->flush(&stream);
+    current_.reset();
+    page = std::make_unique<SerializedPage>(stream.getIOBuf());
   }
-  // Upper limit of message size with no columns.
-  constexpr int32_t kMinMessageSize = 128;
-  auto listener = bufferManager.newListener();
-  IOBufOutputStream stream(
-      *current_->mappedMemory(),
-      listener.get(),
-      std::max<int64_t>(kMinMessageSize, current_->size()));
-  current_->flush(&stream);
-  current_.reset();
   bytesInCurrent_ = 0;
   setTargetSizePct();
 
-  return bufferManager.enqueue(
-      taskId_,
-      destination_,
-      std::make_unique<SerializedPage>(stream.getIOBuf()),
-      future);
+  return bufferManager.enqueue(taskId_, destination_, std::move(page), future);
 }
 
 void PartitionedOutput::initializeInput(RowVectorPtr input) {
@@ -124,8 +205,8 @@ void PartitionedOutput::initializeDestinations() {
   if (destinations_.empty()) {
     auto taskId = operatorCtx_->taskId();
     for (int i = 0; i < numDestinations_; ++i) {
-      destinations_.push_back(
-          std::make_unique<Destination>(taskId, i, mappedMemory_));
+      destinations_.push_back(std::make_unique<Destination>(
+          taskId, i, mappedMemory_, serde_, &serdeOptions_, vectorPageOwner_));
     }
   }
 }
@@ -154,7 +235,8 @@ void PartitionedOutput::estimateRowSizes() {
     VectorStreamGroup::estimateSerializedSize(
         output_->childAt(i),
         folly::Range(topLevelRanges_.data(), numInput),
-        sizePointers_.data());
+        sizePointers_.data(),
+        serde_);
   }
 }
 
@@ -209,6 +291,65 @@ void PartitionedOutput::addInput(RowVectorPtr input) {
   }
 }
 
+void PartitionedOutput::appendPartitioned() {
+  if (destinations_.size() == 1 || vectorPageOwner_) {
+    return;
+  }
+  const auto maxBytes = maxBufferedBytes_ / destinations_.size();
+  std::vector<folly::Range<const IndexRange*>> ranges;
+  std::vector<VectorStreamGroup*> groups;
+  for (auto& destination : destinations_) {
+    auto* group = destination->prepareAppendBatch(maxBytes, rowSize_, output_);
+    if (group) {
+      ranges.push_back(destination->rows());
+      groups.push_back(group);
+    }
+  }
+  VectorStreamGroup::appendPartitioned(output_, ranges, groups);
+}
+
+int64_t PartitionedOutput::reportUnflushedBytes(
+    PartitionedOutputBufferManager& bufferManager) {
+  int64_t bytes = 0;
+  for (auto& destination : destinations_) {
+    bytes += destination->serializedBytes();
+  }
+  auto total = bufferManager.updateUnflushedBytes(
+      operatorCtx_->taskId(), bytes - unflushedBytes_);
+  unflushedBytes_ = bytes;
+  return total;
+}
+
+void PartitionedOutput::flushLargestDestinations(
+    PartitionedOutputBufferManager& bufferManager) {
+  auto total = reportUnflushedBytes(bufferManager);
+  if (total <= maxBufferedBytes_) {
+    return;
+  }
+  std::vector<Destination*> largest;
+  for (auto& destination : destinations_) {
+    if (destination->serializedBytes() > 0) {
+      largest.push_back(destination.get());
+    }
+  }
+  std::sort(largest.begin(), largest.end(), [](auto* left, auto* right) {
+    return left->serializedBytes() > right->serializedBytes();
+  });
+  // Flushes down to half the limit so that this does not repeat for every
+  // batch.
+  for (auto* destination : largest) {
+    if (total <= maxBufferedBytes_ / 2) {
+      break;
+    }
+    total -= destination->serializedBytes();
+    blockingReason_ = destination->flush(bufferManager, &future_);
+    if (blockingReason_ != BlockingReason::kNotBlocked) {
+      break;
+    }
+  }
+  reportUnflushedBytes(bufferManager);
+}
+
 void PartitionedOutput::collectNullRows() {
   auto size = input_->size();
   rows_.resize(size);
@@ -228,6 +369,35 @@ void PartitionedOutput::collectNullRows() {
   nullRows_.updateBounds();
 }
 
+void PartitionedOutput::recordCompressionStats() {
+  if (serdeOptions_.compressionKind == folly::io::CodecType::NO_COMPRESSION) {
+    return;
+  }
+  stats_.addRuntimeStat(
+      "compressionInputBytes",
+      RuntimeCounter(
+          compressionStats_.compressionInputBytes,
+          RuntimeCounter::Unit::kBytes));
+  stats_.addRuntimeStat(
+      "compressedBytes",
+      RuntimeCounter(
+          compressionStats_.compressedBytes, RuntimeCounter::Unit::kBytes));
+  stats_.addRuntimeStat(
+      "compressionTimeNanos",
+      RuntimeCounter(
+          compressionStats_.compressionTimeUs * 1'000,
+          RuntimeCounter::Unit::kNanos));
+  stats_.addRuntimeStat(
+      "numCompressedPages",
+      RuntimeCounter(compressionStats_.numCompressedPages));
+  stats_.addRuntimeStat(
+      "numIncompressiblePages",
+      RuntimeCounter(compressionStats_.numIncompressiblePages));
+  stats_.addRuntimeStat(
+      "numCompressionSkippedPages",
+      RuntimeCounter(compressionStats_.numSkippedPages));
+}
+
 RowVectorPtr PartitionedOutput::getOutput() {
   if (finished_) {
     return nullptr;
@@ -239,6 +409,11 @@ RowVectorPtr PartitionedOutput::getOutput() {
   VELOX_CHECK_NOT_NULL(
       bufferManager, "PartitionedOutputBufferManager was already destructed");
 
+  if (output_ && !appendedPartitioned_) {
+    appendPartitioned();
+    appendedPartitioned_ = true;
+  }
+
   bool workLeft;
   do {
     workLeft = false;
@@ -275,6 +450,7 @@ RowVectorPtr PartitionedOutput::getOutput() {
       }
       destination->flush(*bufferManager, nullptr);
     }
+    reportUnflushedBytes(*bufferManager);
     return nullptr;
   }
   // All of 'output_' is written into the destinations. We are finishing, hence
@@ -288,13 +464,19 @@ RowVectorPtr PartitionedOutput::getOutput() {
       destination->flush(*bufferManager, nullptr);
       destination->setFinished();
     }
+    reportUnflushedBytes(*bufferManager);
 
     bufferManager->noMoreData(operatorCtx_->task()->taskId());
     finished_ = true;
+    recordCompressionStats();
+  }
+  if (output_ && !finished_) {
+    flushLargestDestinations(*bufferManager);
   }
   // The input is fully processed, drop the reference to allow reuse.
   input_ = nullptr;
   output_ = nullptr;
+  appendedPartitioned_ = false;
   return nullptr;
 }
 
@@ -17,6 +17,7 @@
 
 #include <folly/Random.h>
 #include "velox/exec/Operator.h"
+#include "velox/exec/OperatorUtils.h"
 #include "velox/exec/PartitionedOutputBufferManager.h"
 
 namespace facebook::velox::exec {
@@ -25,11 +26,23 @@ class PartitionedOutput;
 
 class Destination {
  public:
+  // Pages are serialized with 'serde', or the default serde if nullptr.
+  // 'serdeOptions' is given to the serializer of each page and must outlive
+  // 'this'. If 'vectorPageOwner' is set, pages hold the vectors of their
+  // rows instead and keep 'vectorPageOwner' alive.
   Destination(
       const std::string& taskId,
       int destination,
-      memory::MappedMemory* FOLLY_NONNULL memory)
-      : taskId_(taskId), destination_(destination), memory_(memory) {
+      memory::MappedMemory* FOLLY_NONNULL memory,
+      VectorSerde* FOLLY_NULLABLE serde,
+      const VectorSerde::Options* FOLLY_NONNULL serdeOptions,
+      std::shared_ptr<const void> vectorPageOwner = nullptr)
+      : taskId_(taskId),
+        destination_(destination),
+        memory_(memory),
+        serde_(serde),
+        serdeOptions_(serdeOptions),
+        vectorPageOwner_(std::move(vectorPageOwner)) {
     setTargetSizePct();
   }
 
@@ -39,7 +52,12 @@ class Destination {
     row_ = 0;
   }
 
+  // Adds 'row' to the batch. Consecutive rows are coalesced into one range.
   void addRow(vector_size_t row) {
+    if (!rows_.empty() && rows_.back().begin + rows_.back().size == row) {
+      ++rows_.back().size;
+      return;
+    }
     rows_.push_back(IndexRange{row, 1});
   }
 
@@ -55,6 +73,21 @@ class Destination {
       bool* FOLLY_NONNULL atEnd,
       ContinueFuture* FOLLY_NONNULL future);
 
+  // Prepares appending all rows of the batch to the current page at once,
+  // which advance() would do without flushing. This is the case if the rows
+  // do not bring the page to the flush target. Returns the page with its
+  // stream tree created and the rows marked appended, so that advance()
+  // finds the destination at end. The caller appends 'rows()' of 'output'
+  // to the page. Returns nullptr if advance() must be used.
+  VectorStreamGroup* FOLLY_NULLABLE prepareAppendBatch(
+      uint64_t maxBytes,
+      const std::vector<vector_size_t>& sizes,
+      const RowVectorPtr& output);
+
+  folly::Range<const IndexRange*> rows() const {
+    return folly::Range(rows_.data(), rows_.size());
+  }
+
   BlockingReason flush(
       PartitionedOutputBufferManager& bufferManager,
       ContinueFuture* FOLLY_NULLABLE future);
@@ -75,6 +108,23 @@ class Destination {
   void
   serialize(const RowVectorPtr& input, vector_size_t begin, vector_size_t end);
 
+  // Adds the rows of the ranges from 'begin' to 'end' to 'vectors_'.
+  void appendVectors(
+      const RowVectorPtr& output,
+      vector_size_t begin,
+      vector_size_t end);
+
+  // Creates 'current_' for the ranges from 'begin' to 'end' if not yet
+  // created.
+  void ensureCurrent(
+      const RowVectorPtr& output,
+      vector_size_t begin,
+      vector_size_t end);
+
+  // Returns the flush target in bytes given the per destination share of
+  // the buffered bytes.
+  uint64_t targetBytes(uint64_t maxBytes) const;
+
   // Sets the next target size for flushing. This is called at the
   // start of each batch of output for the destination. The effect is
   // to make different destinations ready at slightly different times
@@ -91,12 +141,18 @@ class Destination {
   const std::string taskId_;
   const int destination_;
   memory::MappedMemory* FOLLY_NONNULL const memory_;
+  VectorSerde* FOLLY_NULLABLE const serde_;
+  const VectorSerde::Options* FOLLY_NONNULL const serdeOptions_;
+  const std::shared_ptr<const void> vectorPageOwner_;
   uint64_t bytesInCurrent_{0};
   std::vector<IndexRange> rows_;
 
   // First row of 'rows_' that is not appended to 'current_'
   vector_size_t row_{0};
-  std::unique_ptr<VectorStreamGroup> current_;
+  std::shared_ptr<VectorStreamGroup> current_;
+
+  // The rows of the current page if pages hold vectors.
+  std::vector<RowVectorPtr> vectors_;
   bool finished_{false};
 
   // Flush accumulated data to buffer manager after reaching this
@@ -156,6 +212,15 @@ class PartitionedOutput : public Operator {
       VELOX_CHECK(keyChannels_.empty());
       VELOX_CHECK_NULL(partitionFunction_);
     }
+    serde_ = namedVectorSerde(ctx->task->queryCtx()->config().exchangeSerde());
+    // Only LocalExchangeSource, in this process, reads from local:// tasks.
+    if (ctx->task->queryCtx()->config().exchangeLocalVectors() &&
+        operatorCtx_->taskId().rfind("local://", 0) == 0) {
+      vectorPageOwner_ = ctx->task;
+    }
+    serdeOptions_.compressionKind = compressionCodec(
+        ctx->task->queryCtx()->config().exchangeCompressionKind(), "exchange");
+    serdeOptions_.compressionStats = &compressionStats_;
   }
 
   void addInput(RowVectorPtr input) override;
@@ -198,6 +263,26 @@ class PartitionedOutput : public Operator {
   /// Collect all rows with null keys into nullRows_.
   void collectNullRows();
 
+  // Appends the rows of the batch to the pages of the destinations where
+  // they fit under the flush target, a column at a time for all these
+  // destinations. The remaining destinations are left to advance().
+  void appendPartitioned();
+
+  // Reports the change in the bytes held by the unflushed pages of the
+  // destinations to the buffer manager. Returns the total for the task.
+  int64_t reportUnflushedBytes(PartitionedOutputBufferManager& bufferManager);
+
+  // Flushes the destinations with the largest pages if the unflushed pages
+  // of all producers of the task hold more than 'maxBufferedBytes_'. This
+  // makes pages smaller when there are many destinations or producers, and
+  // lets them grow to the flush target otherwise. Sets 'blockingReason_' if
+  // the output buffers are full.
+  void flushLargestDestinations(PartitionedOutputBufferManager& bufferManager);
+
+  // Adds the compression counters of the serialized pages to the runtime
+  // stats.
+  void recordCompressionStats();
+
   const std::vector<column_index_t> keyChannels_;
   const int numDestinations_;
   const bool replicateNullsAndAny_;
@@ -220,6 +305,26 @@ class PartitionedOutput : public Operator {
   memory::MappedMemory* FOLLY_NONNULL mappedMemory_;
   RowVectorPtr output_;
 
+  // True after appendPartitioned() for 'output_'.
+  bool appendedPartitioned_{false};
+
+  // Bytes in the unflushed pages of the destinations as last reported to the
+  // buffer manager.
+  int64_t unflushedBytes_{0};
+
+  // Compression of the pages. The destinations share the counters, so that
+  // compression is skipped for all of them after pages that do not compress
+  // well.
+  VectorSerde::CompressionStats compressionStats_;
+  VectorSerde::Options serdeOptions_;
+
+  // Serde of the pages. nullptr for the default serde.
+  VectorSerde* FOLLY_NULLABLE serde_{nullptr};
+
+  // The Task, if pages hold vectors instead of serialized data. The pages
+  // keep it alive, since it owns the memory of the vectors.
+  std::shared_ptr<const void> vectorPageOwner_;
+
   // Reusable memory.
   SelectivityVector rows_;
   SelectivityVector nullRows_;
@@ -18,10 +18,10 @@
 
 namespace facebook::velox::exec {
 
-std::vector<std::unique_ptr<folly::IOBuf>> DestinationBuffer::getData(
+std::vector<std::shared_ptr<SerializedPage>> DestinationBuffer::getPages(
     uint64_t maxBytes,
     int64_t sequence,
-    DataAvailableCallback notify) {
+    PagesAvailableCallback notify) {
   VELOX_CHECK_GE(
       sequence, sequence_, "Get received for an already acknowledged item");
 
@@ -41,7 +41,7 @@ std::vector<std::unique_ptr<folly::IOBuf>> DestinationBuffer::getData(
     return {};
   }
 
-  std::vector<std::unique_ptr<folly::IOBuf>> result;
+  std::vector<std::shared_ptr<SerializedPage>> result;
   uint64_t resultBytes = 0;
   for (auto i = sequence - sequence_; i < data_.size(); i++) {
     // nullptr is used as end marker
@@ -50,7 +50,7 @@ std::vector<std::unique_ptr<folly::IOBuf>> DestinationBuffer::getData(
       result.push_back(nullptr);
       break;
     }
-    result.push_back(data_[i]->getIOBuf());
+    result.push_back(data_[i]);
     resultBytes += data_[i]->size();
     if (resultBytes >= maxBytes) {
       break;
@@ -66,7 +66,7 @@ DataAvailable DestinationBuffer::getAndClearNotify() {
   DataAvailable result;
   result.callback = notify_;
   result.sequence = notifySequence_;
-  result.data = getData(notifyMaxBytes_, notifySequence_, nullptr);
+  result.data = getPages(notifyMaxBytes_, notifySequence_, nullptr);
   notify_ = nullptr;
   notifySequence_ = 0;
   notifyMaxBytes_ = 0;
@@ -394,7 +394,29 @@ void PartitionedOutputBuffer::getData(
     uint64_t maxBytes,
     int64_t sequence,
     DataAvailableCallback notify) {
-  std::vector<std::unique_ptr<folly::IOBuf>> data;
+  getPages(
+      destination,
+      maxBytes,
+      sequence,
+      [notify](
+          std::vector<std::shared_ptr<SerializedPage>> pages,
+          int64_t pagesSequence) {
+        std::vector<std::unique_ptr<folly::IOBuf>> data;
+        data.reserve(pages.size());
+        for (auto& page : pages) {
+          // nullptr is the end marker.
+          data.push_back(page ? page->getIOBuf() : nullptr);
+        }
+        notify(std::move(data), pagesSequence);
+      });
+}
+
+void PartitionedOutputBuffer::getPages(
+    int destination,
+    uint64_t maxBytes,
+    int64_t sequence,
+    PagesAvailableCallback notify) {
+  std::vector<std::shared_ptr<SerializedPage>> data;
   std::vector<std::shared_ptr<SerializedPage>> freed;
   std::vector<ContinuePromise> promises;
   {
@@ -413,7 +435,7 @@ void PartitionedOutputBuffer::getData(
         sequence);
     freed = destinationBuffer->acknowledge(sequence, true);
     updateAfterAcknowledgeLocked(freed, promises);
-    data = destinationBuffer->getData(maxBytes, sequence, notify);
+    data = destinationBuffer->getPages(maxBytes, sequence, notify);
   }
   releaseAfterAcknowledge(freed, promises);
   if (!data.empty()) {
@@ -437,6 +459,7 @@ std::string PartitionedOutputBuffer::toString() {
   std::lock_guard<std::mutex> l(mutex_);
   std::stringstream out;
   out << "[PartitionedOutputBuffer totalSize_=" << totalSize_
+      << "b, unflushed=" << unflushedBytes_
       << "b, num producers blocked=" << promises_.size()
       << ", completed=" << numFinished_ << "/" << numDrivers_ << ", "
       << (atEnd_ ? "at end, " : "") << "destinations: " << std::endl;
@@ -477,6 +500,12 @@ BlockingReason PartitionedOutputBufferManager::enqueue(
   return getBuffer(taskId)->enqueue(destination, std::move(data), future);
 }
 
+int64_t PartitionedOutputBufferManager::updateUnflushedBytes(
+    const std::string& taskId,
+    int64_t delta) {
+  return getBuffer(taskId)->updateUnflushedBytes(delta);
+}
+
 void PartitionedOutputBufferManager::noMoreData(const std::string& taskId) {
   getBuffer(taskId)->noMoreData();
 }
@@ -529,6 +558,15 @@ void PartitionedOutputBufferManager::getData(
   getBuffer(taskId)->getData(destination, maxBytes, sequence, notify);
 }
 
+void PartitionedOutputBufferManager::getPages(
+    const std::string& taskId,
+    int destination,
+    uint64_t maxBytes,
+    int64_t sequence,
+    PagesAvailableCallback notify) {
+  getBuffer(taskId)->getPages(destination, maxBytes, sequence, notify);
+}
+
 void PartitionedOutputBufferManager::initializeTask(
     std::shared_ptr<Task> task,
     bool broadcast,
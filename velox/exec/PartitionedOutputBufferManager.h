@@ -28,10 +28,17 @@ namespace facebook::velox::exec {
 using DataAvailableCallback = std::function<
     void(std::vector<std::unique_ptr<folly::IOBuf>> pages, int64_t sequence)>;
 
+// Same as DataAvailableCallback for consumers in the same process. The pages
+// are shared with the producer instead of being copied. nullptr indicates
+// that there is no more data.
+using PagesAvailableCallback = std::function<void(
+    std::vector<std::shared_ptr<SerializedPage>> pages,
+    int64_t sequence)>;
+
 struct DataAvailable {
-  DataAvailableCallback callback;
+  PagesAvailableCallback callback;
   int64_t sequence;
-  std::vector<std::unique_ptr<folly::IOBuf>> data;
+  std::vector<std::shared_ptr<SerializedPage>> data;
 
   void notify() {
     if (callback) {
@@ -51,11 +58,11 @@ class DestinationBuffer {
     data_.push_back(std::move(data));
   }
 
-  // Returns a shallow copy (folly::IOBuf::clone) of the data starting at
-  // 'sequence', stopping after exceeding 'maxBytes'. If there is no data,
-  // 'notify' is installed so that this gets called when data is added.
-  std::vector<std::unique_ptr<folly::IOBuf>>
-  getData(uint64_t maxBytes, int64_t sequence, DataAvailableCallback notify);
+  // Returns the pages starting at 'sequence', stopping after exceeding
+  // 'maxBytes'. If there is no data, 'notify' is installed so that this gets
+  // called when data is added.
+  std::vector<std::shared_ptr<SerializedPage>>
+  getPages(uint64_t maxBytes, int64_t sequence, PagesAvailableCallback notify);
 
   // Removes data from the queue and returns removed data. If 'fromGetData' we
   // do not give a warning for the case where no data is removed, otherwise we
@@ -78,7 +85,7 @@ class DestinationBuffer {
   std::vector<std::shared_ptr<SerializedPage>> data_;
   // The sequence number of the first in 'data_'.
   int64_t sequence_ = 0;
-  DataAvailableCallback notify_ = nullptr;
+  PagesAvailableCallback notify_ = nullptr;
   // The sequence number of the first item to pass to 'notify'.
   int64_t notifySequence_;
   uint64_t notifyMaxBytes_;
@@ -106,6 +113,14 @@ class PartitionedOutputBuffer {
       std::unique_ptr<SerializedPage> data,
       ContinueFuture* future);
 
+  /// Adds 'delta' to the bytes the producers have serialized but not yet
+  /// enqueued and returns the new total. The producers report these so that
+  /// the memory held in their unflushed pages is bounded for the task as a
+  /// whole and not per producer.
+  int64_t updateUnflushedBytes(int64_t delta) {
+    return unflushedBytes_ += delta;
+  }
+
   void noMoreData();
 
   void noMoreDrivers();
@@ -128,6 +143,14 @@ class PartitionedOutputBuffer {
       int64_t sequence,
       DataAvailableCallback notify);
 
+  // Same as getData() but gives the pages themselves instead of copies of
+  // their data.
+  void getPages(
+      int destination,
+      uint64_t maxSize,
+      int64_t sequence,
+      PagesAvailableCallback notify);
+
   // Continues any possibly waiting producers. Called when the
   // producer task has an error or cancellation.
   void terminate();
@@ -168,6 +191,9 @@ class PartitionedOutputBuffer {
 
   bool noMoreBroadcastBuffers_ = false;
 
+  // Bytes serialized by the producers into pages not yet enqueued.
+  std::atomic<int64_t> unflushedBytes_{0};
+
   // While noMoreBroadcastBuffers_ is false, stores the enqueued data to
   // broadcast to destinations that have not yet been initialized. Cleared
   // after receiving no-more-broadcast-buffers signal.
@@ -211,6 +237,10 @@ class PartitionedOutputBufferManager {
       std::unique_ptr<SerializedPage> data,
       ContinueFuture* future);
 
+  // Adds 'delta' to the bytes serialized by the producers of 'taskId' into
+  // pages that are not yet enqueued. Returns the new total for the task.
+  int64_t updateUnflushedBytes(const std::string& taskId, int64_t delta);
+
   void noMoreData(const std::string& taskId);
 
   // Returns true if noMoreData has been called and all the accumulated data
@@ -242,6 +272,16 @@ class PartitionedOutputBufferManager {
       int64_t sequence,
       DataAvailableCallback notify);
 
+  // Same as getData() for consumers in the same process. The pages are
+  // handed over without copying their data, and pages that hold vectors
+  // instead of serialized data can only be read this way.
+  void getPages(
+      const std::string& taskId,
+      int destination,
+      uint64_t maxBytes,
+      int64_t sequence,
+      PagesAvailableCallback notify);
+
   void removeTask(const std::string& taskId);
 
   static std::weak_ptr<PartitionedOutputBufferManager> getInstance();
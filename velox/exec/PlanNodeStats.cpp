@@ -47,6 +47,8 @@ void PlanNodeStats::addTotals(const OperatorStats& stats) {
   cpuWallTiming.add(stats.getOutputTiming);
   cpuWallTiming.add(stats.finishTiming);
 
+  perfCounters.add(stats.perfCounters);
+
   blockedWallNanos += stats.blockedWallNanos;
 
   peakMemoryBytes += stats.memoryStats.peakTotalMemoryReservation;
@@ -96,6 +98,13 @@ std::string PlanNodeStats::toString(bool includeInputStats) const {
   if (numSplits > 0) {
     out << ", Splits: " << numSplits;
   }
+
+  if (!perfCounters.empty()) {
+    out << ", Cycles: " << perfCounters.cycles
+        << ", Instructions: " << perfCounters.instructions
+        << ", LLC misses: " << perfCounters.llcMisses
+        << ", Branch misses: " << perfCounters.branchMisses;
+  }
   return out.str();
 }
 
@@ -137,6 +146,7 @@ folly::dynamic toPlanStatsJson(const facebook::velox::exec::TaskStats& stats) {
       stat["outputVectors"] = operatorStat.second->outputVectors;
       stat["outputBytes"] = operatorStat.second->outputBytes;
       stat["cpuWallTiming"] = operatorStat.second->cpuWallTiming.toString();
+      stat["perfCounters"] = operatorStat.second->perfCounters.toString();
       stat["blockedWallNanos"] = operatorStat.second->blockedWallNanos;
       stat["peakMemoryBytes"] = operatorStat.second->peakMemoryBytes;
       stat["numMemoryAllocations"] = operatorStat.second->numMemoryAllocations;
@@ -78,6 +78,10 @@ struct PlanNodeStats {
   /// up.
   CpuWallTiming cpuWallTiming;
 
+  /// Sum of the hardware counts for all corresponding operators. Empty
+  /// unless QueryConfig::kOperatorPerfCountersEnabled is set.
+  process::PerfCounterValues perfCounters;
+
   /// Sum of blocked wall time for all corresponding operators.
   uint64_t blockedWallNanos{0};
 
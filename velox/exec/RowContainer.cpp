@@ -44,12 +44,15 @@ RowContainer::RowContainer(
     bool hasProbedFlag,
     bool hasNormalizedKeys,
     memory::MappedMemory* mappedMemory,
-    const RowSerde& serde)
+    const RowSerde& serde,
+    int32_t normalizedKeyWords)
     : keyTypes_(keyTypes),
       nullableKeys_(nullableKeys),
       aggregates_(aggregates),
       isJoinBuild_(isJoinBuild),
-      hasNormalizedKeys_(hasNormalizedKeys),
+      normalizedKeyBytes_(
+          hasNormalizedKeys ? normalizedKeyWords * sizeof(normalized_key_t)
+                            : 0),
       rows_(mappedMemory),
       stringAllocator_(mappedMemory),
       serde_(serde) {
@@ -73,11 +76,12 @@ RowContainer::RowContainer(
   //
   // In most cases, rows are prefixed with a normalized_key_t at index
   // -1, 8 bytes below the pointer. This space is reserved for a 64
-  // bit unique digest of the keys for speeding up comparison. This
-  // space is reserved for the rows that are inserted before the
-  // cardinality grows too large for packing all in 64
-  // bits. 'numRowsWithNormalizedKey_' gives the number of rows with
-  // the extra field.
+  // bit unique digest of the keys for speeding up comparison. If
+  // 'normalizedKeyWords' is 2, a second normalized_key_t at index -2
+  // makes the digest 128 bits. This space is reserved for the rows
+  // that are inserted before the cardinality grows too large for
+  // packing all in the normalized key. 'numRowsWithNormalizedKey_'
+  // gives the number of rows with the extra field.
   int32_t offset = 0;
   int32_t nullOffset = 0;
   bool isVariableWidth = false;
@@ -104,6 +108,7 @@ RowContainer::RowContainer(
     ++nullOffset;
     isVariableWidth |= !aggregate->isFixedSize();
     usesExternalMemory_ |= aggregate->accumulatorUsesExternalMemory();
+    accumulatorsUseAllocator_ |= aggregate->accumulatorUsesAllocator();
   }
   for (auto& type : dependentTypes) {
     types_.push_back(type);
@@ -168,7 +173,8 @@ RowContainer::RowContainer(
       bits::setBit(initialNulls_.data(), i + aggregateNullOffset);
     }
   }
-  normalizedKeySize_ = hasNormalizedKeys_ ? sizeof(normalized_key_t) : 0;
+  VELOX_CHECK(normalizedKeyWords == 1 || normalizedKeyWords == 2);
+  normalizedKeySize_ = normalizedKeyBytes_;
   for (auto i = 0; i < offsets_.size(); ++i) {
     rowColumns_.emplace_back(
         offsets_[i],
@@ -330,6 +336,15 @@ void RowContainer::prepareRead(
       HashStringAllocator::headerOf(view->data()), stream);
 }
 
+// static
+uint64_t RowContainer::prepareReadComplex(
+    const char* row,
+    int32_t offset,
+    ByteStream& stream) {
+  prepareRead(row, offset, stream);
+  return stream.read<uint64_t>();
+}
+
 void RowContainer::extractString(
     StringView value,
     FlatVector<StringView>* values,
@@ -367,6 +382,10 @@ void RowContainer::storeComplexType(
   RowSizeTracker tracker(row[rowSizeOffset_], stringAllocator_);
   ByteStream stream(&stringAllocator_, false, false);
   auto position = stringAllocator_.newWrite(stream);
+  // The hash of the value precedes the serialization. See
+  // prepareReadComplex().
+  stream.appendOne<uint64_t>(
+      decoded.base()->hashValueAt(decoded.index(index)));
   serde_.serialize(*decoded.base(), decoded.index(index), stream);
   stringAllocator_.finishWrite(stream, 0);
   valueAt<StringView>(row, offset) =
@@ -388,7 +407,7 @@ void RowContainer::extractComplexType(
     if (!row || row[nullByte] & nullMask) {
       result->setNull(i, true);
     } else {
-      prepareRead(row, offset, stream);
+      prepareReadComplex(row, offset, stream);
       ContainerRowSerde::instance().deserialize(stream, i, result.get());
     }
   }
@@ -414,7 +433,7 @@ int RowContainer::compareComplexType(
   VELOX_DCHECK(!flags.stopAtNull, "not supported compare flag");
 
   ByteStream stream;
-  prepareRead(row, offset, stream);
+  prepareReadComplex(row, offset, stream);
   return serde_.compare(stream, decoded, index, flags);
 }
 
@@ -435,8 +454,11 @@ int32_t RowContainer::compareComplexType(
 
   ByteStream leftStream;
   ByteStream rightStream;
-  prepareRead(left, offset, leftStream);
-  prepareRead(right, offset, rightStream);
+  auto leftHash = prepareReadComplex(left, offset, leftStream);
+  auto rightHash = prepareReadComplex(right, offset, rightStream);
+  if (flags.equalsOnly && leftHash != rightHash) {
+    return 1;
+  }
   return serde_.compare(leftStream, rightStream, type, flags);
 }
 
@@ -469,8 +491,7 @@ void RowContainer::hashTyped(
           Kind == TypeKind::ROW || Kind == TypeKind::ARRAY ||
           Kind == TypeKind::MAP) {
         ByteStream in;
-        prepareRead(row, offset, in);
-        hash = serde_.hash(in, type);
+        hash = prepareReadComplex(row, offset, in);
       } else {
         hash = folly::hasher<T>()(valueAt<T>(row, offset));
       }
@@ -496,6 +517,15 @@ void RowContainer::hash(
       result);
 }
 
+std::optional<int64_t> RowContainer::estimateRowSize() const {
+  if (numRows_ == 0) {
+    return std::nullopt;
+  }
+  const int64_t variableBytes = stringAllocator_.retainedSize() -
+      stringAllocator_.freeSpace() - stringAllocator_.cachedBytes();
+  return fixedRowSize_ + std::max<int64_t>(0, variableBytes) / numRows_;
+}
+
 void RowContainer::clear() {
   if (usesExternalMemory_) {
     constexpr int32_t kBatch = 1000;
@@ -515,11 +545,152 @@ void RowContainer::clear() {
   stringAllocator_.clear();
   numRows_ = 0;
   numRowsWithNormalizedKey_ = 0;
-  if (hasNormalizedKeys_) {
-    normalizedKeySize_ = sizeof(normalized_key_t);
+  normalizedKeySize_ = normalizedKeyBytes_;
+  numFreeRows_ = 0;
+  firstFreeRow_ = nullptr;
+}
+
+void RowContainer::compact() {
+  VELOX_CHECK(!isJoinBuild_, "Cannot compact a hash join build side");
+  VELOX_CHECK_EQ(rows_.numLargeAllocations(), 0);
+  if (numFreeRows_ == 0) {
+    return;
   }
+  if (numRows_ == 0) {
+    rows_.clear();
+    numRowsWithNormalizedKey_ = 0;
+    numFreeRows_ = 0;
+    firstFreeRow_ = nullptr;
+    return;
+  }
+
+  // Rows are placed the way 'rows_' would allocate them, so a row never
+  // moves past its current position and rows can be moved in place.
+  // The rows with a normalized key come first and stay first.
+  const auto numAllocations = rows_.numSmallAllocations();
+  int32_t toAllocation = 0;
+  int32_t toRun = 0;
+  int64_t toOffset = 0;
+  int64_t normalizedKeysLeft = numRowsWithNormalizedKey_;
+  int64_t numRowsWithNormalizedKey = 0;
+  for (auto i = 0; i < numAllocations; ++i) {
+    auto allocation = rows_.allocationAt(i);
+    auto numRuns = allocation->numRuns();
+    if (i == numAllocations - 1) {
+      numRuns = std::min<int32_t>(numRuns, rows_.currentRunIndex() + 1);
+    }
+    for (auto runIndex = 0; runIndex < numRuns; ++runIndex) {
+      auto run = allocation->runAt(runIndex);
+      auto data = run.data<char>();
+      const int64_t limit =
+          (i == numAllocations - 1 && runIndex == rows_.currentRunIndex())
+          ? rows_.currentOffset()
+          : run.numBytes();
+      int64_t offset = 0;
+      for (;;) {
+        const bool hasNormalizedKey = normalizedKeysLeft > 0;
+        const int32_t rowSize =
+            fixedRowSize_ + (hasNormalizedKey ? normalizedKeyBytes_ : 0);
+        if (offset + rowSize > limit) {
+          break;
+        }
+        char* start = data + offset;
+        offset += rowSize;
+        if (hasNormalizedKey) {
+          --normalizedKeysLeft;
+        }
+        const int32_t rowOffset = hasNormalizedKey ? normalizedKeyBytes_ : 0;
+        if (bits::isBitSet(start + rowOffset, freeFlagOffset_)) {
+          continue;
+        }
+        for (;;) {
+          auto toRunBytes =
+              rows_.allocationAt(toAllocation)->runAt(toRun).numBytes();
+          if (toOffset + rowSize <= toRunBytes) {
+            break;
+          }
+          if (++toRun == rows_.allocationAt(toAllocation)->numRuns()) {
+            ++toAllocation;
+            toRun = 0;
+          }
+          toOffset = 0;
+        }
+        char* to =
+            rows_.allocationAt(toAllocation)->runAt(toRun).data<char>() +
+            toOffset;
+        if (to != start) {
+          memmove(to, start, rowSize);
+        }
+        toOffset += rowSize;
+        if (hasNormalizedKey) {
+          ++numRowsWithNormalizedKey;
+        }
+      }
+    }
+  }
+  rows_.truncate(toAllocation, toRun, toOffset);
+  numRowsWithNormalizedKey_ = numRowsWithNormalizedKey;
   numFreeRows_ = 0;
   firstFreeRow_ = nullptr;
+  relocateVariableWidthData();
+}
+
+void RowContainer::relocateVariableWidthData() {
+  std::vector<RowColumn> columns;
+  for (auto i = 0; i < types_.size(); ++i) {
+    if (!types_[i]->isFixedWidth()) {
+      columns.push_back(rowColumns_[i]);
+    }
+  }
+  if (columns.empty() || accumulatorsUseAllocator_) {
+    return;
+  }
+  // The values are copied out to a staging allocator, 'stringAllocator_'
+  // is emptied and the values are copied back densely.
+  HashStringAllocator staging(mappedMemory());
+  constexpr int32_t kBatch = 1000;
+  std::vector<char*> rows(kBatch);
+  auto copyValues = [&](HashStringAllocator& to) {
+    RowContainerIterator iter;
+    while (auto numRows = listRows(&iter, kBatch, rows.data())) {
+      for (auto i = 0; i < numRows; ++i) {
+        for (auto& column : columns) {
+          if (!isNullAt(rows[i], column.nullByte(), column.nullMask())) {
+            copyVariableWidthValue(rows[i], column.offset(), to);
+          }
+        }
+      }
+    }
+  };
+  copyValues(staging);
+  stringAllocator_.clear();
+  copyValues(stringAllocator_);
+}
+
+void RowContainer::copyVariableWidthValue(
+    char* row,
+    int32_t offset,
+    HashStringAllocator& to) {
+  auto& view = valueAt<StringView>(row, offset);
+  if (view.isInline()) {
+    return;
+  }
+  ByteStream in;
+  HashStringAllocator::prepareRead(
+      HashStringAllocator::headerOf(view.data()), in);
+  ByteStream out(&to, false, false);
+  auto position = to.newWrite(out, view.size());
+  // The value may be in several pieces. Copies it a buffer at a time.
+  char buffer[1024];
+  int64_t remaining = view.size();
+  while (remaining > 0) {
+    const auto numBytes = std::min<int64_t>(remaining, sizeof(buffer));
+    in.readBytes(buffer, numBytes);
+    out.appendStringPiece(folly::StringPiece(buffer, numBytes));
+    remaining -= numBytes;
+  }
+  to.finishWrite(out, 0);
+  view = StringView(position.position, view.size());
 }
 
 void RowContainer::setProbedFlag(char** rows, int32_t numRows) {
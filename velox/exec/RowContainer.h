@@ -15,11 +15,13 @@
  */
 #pragma once
 
+#include "velox/common/base/SimdUtil.h"
 #include "velox/common/memory/HashStringAllocator.h"
 #include "velox/common/memory/MappedMemory.h"
 #include "velox/exec/Aggregate.h"
 #include "velox/exec/ContainerRowSerde.h"
 #include "velox/exec/Spill.h"
+#include "velox/type/StringViewSimd.h"
 #include "velox/vector/FlatVector.h"
 #include "velox/vector/VectorTypeUtils.h"
 namespace facebook::velox::exec {
@@ -28,8 +30,8 @@ struct RowContainerIterator {
   int32_t allocationIndex = 0;
   int32_t runIndex = 0;
   int32_t rowOffset = 0;
-  // Number of unvisited entries that are prefixed by a uint64_t for
-  // normalized key. Set in listRows() on first call.
+  // Number of unvisited entries that are prefixed by a normalized key.
+  // Set in listRows() on first call.
   int64_t normalizedKeysLeft = 0;
 
   void reset() {
@@ -101,6 +103,25 @@ class RowContainer {
             mappedMemory,
             ContainerRowSerde::instance()) {}
 
+  // 'keyTypes' gives the types of the sorting keys and 'dependentTypes' the
+  // types of the other columns of an order by. Uses 'mappedMemory' for bulk
+  // allocation.
+  RowContainer(
+      const std::vector<TypePtr>& keyTypes,
+      const std::vector<TypePtr>& dependentTypes,
+      memory::MappedMemory* mappedMemory)
+      : RowContainer(
+            keyTypes,
+            true, // nullableKeys
+            emptyAggregates(),
+            dependentTypes,
+            false, // hasNext
+            false, // isJoinBuild
+            false, // hasProbedFlag
+            false, // hasNormalizedKey
+            mappedMemory,
+            ContainerRowSerde::instance()) {}
+
   // 'keyTypes' gives the type of the key of each row. For a group by,
   // order by or right outer join build side these may be
   // nullable. 'nullableKeys' specifies if these have a null flag.
@@ -112,11 +133,11 @@ class RowContainer {
   // implies that hashing of keys ignores null keys even if these were
   // allowed. 'hasProbedFlag' indicates that an extra bit is reserved
   // for a probed state of a full or right outer
-  // join. 'hasNormalizedKey' specifies that an extra word is left
-  // below each row for a normalized key that collapses all parts
-  // into one word for faster comparison. The bulk allocation is done
-  // from 'mappedMemory'.  'serde_' is used for serializing complex
-  // type values into the container.
+  // join. 'hasNormalizedKey' specifies that 'normalizedKeyWords' extra
+  // words are left below each row for a normalized key that collapses
+  // all parts into one or two words for faster comparison. The bulk
+  // allocation is done from 'mappedMemory'.  'serde_' is used for
+  // serializing complex type values into the container.
   RowContainer(
       const std::vector<TypePtr>& keyTypes,
       bool nullableKeys,
@@ -127,7 +148,8 @@ class RowContainer {
       bool hasProbedFlag,
       bool hasNormalizedKey,
       memory::MappedMemory* mappedMemory,
-      const RowSerde& serde);
+      const RowSerde& serde,
+      int32_t normalizedKeyWords = 1);
 
   // Allocates a new row and initializes possible aggregates to null.
   char* newRow();
@@ -272,6 +294,20 @@ class RowContainer {
     return reinterpret_cast<normalized_key_t*>(group)[-1];
   }
 
+  // Allows get/set of the high word of a two word normalized key. This
+  // is the word below the one of normalizedKey(). Valid only if 'this'
+  // was created with two normalized key words.
+  static inline normalized_key_t& normalizedKeyHigh(char* group) {
+    return reinterpret_cast<normalized_key_t*>(group)[-2];
+  }
+
+  // Returns the number of words reserved below a row for a normalized key
+  // while normalized keys are enabled. 0 if 'this' was created without
+  // normalized keys.
+  int32_t normalizedKeyWords() const {
+    return normalizedKeyBytes_ / sizeof(normalized_key_t);
+  }
+
   void disableNormalizedKeys() {
     normalizedKeySize_ = 0;
   }
@@ -311,6 +347,10 @@ class RowContainer {
     return rows_.allocatedBytes() + stringAllocator_.retainedSize();
   }
 
+  // Returns the average size of a row, counting its out of line variable
+  // length data, or std::nullopt if there are no rows.
+  std::optional<int64_t> estimateRowSize() const;
+
   // Returns the number of fixed size rows that can be allocated
   // without growing the container and the number of unused bytes of
   // reserved storage for variable length data.
@@ -328,9 +368,34 @@ class RowContainer {
   // Resets the state to be as after construction. Frees memory for payload.
   void clear();
 
-  int32_t compareRows(const char* left, const char* right) {
+  // Moves the rows that are not erased towards the start of the fixed size
+  // row storage, keeping their order, empties the free row list and returns
+  // the pages that are no longer needed to the MappedMemory. Out of line
+  // variable width keys and dependents are then copied densely into a
+  // fresh 'stringAllocator_' unless an accumulator may keep data there, see
+  // Aggregate::accumulatorUsesAllocator(). Accumulators stay where they
+  // are, so they must not refer to their own row. Pointers to rows of
+  // 'this' are invalid after this. Not supported for hash join build sides
+  // since their rows point to each other.
+  void compact();
+
+  // True if compact() can be called, i.e. this is not a join build and
+  // no rows are in large allocations.
+  bool canCompact() const {
+    return !isJoinBuild_ && rows_.numLargeAllocations() == 0;
+  }
+
+  // Compares the keys of 'left' and 'right'. 'flags' gives the sort order of
+  // each key. If 'flags' is empty, all keys are compared ascending, nulls
+  // first.
+  int32_t compareRows(
+      const char* left,
+      const char* right,
+      const std::vector<CompareFlags>& flags = {}) {
+    VELOX_DCHECK(flags.empty() || flags.size() == keyTypes_.size());
     for (auto i = 0; i < keyTypes_.size(); ++i) {
-      auto result = compare(left, right, i);
+      auto result =
+          compare(left, right, i, flags.empty() ? CompareFlags() : flags[i]);
       if (result) {
         return result;
       }
@@ -472,6 +537,68 @@ class RowContainer {
     }
   }
 
+  // Sets the bits of 'nulls' for 'rows' to not null unless the row is
+  // nullptr or has the null flag given by 'nullByte' and 'nullMask' set.
+  // Makes a word of bits at a time.
+  static void extractNulls(
+      const char* const* rows,
+      int32_t numRows,
+      int32_t nullByte,
+      uint8_t nullMask,
+      uint64_t* nulls) {
+    for (int32_t i = 0; i < numRows; i += 64) {
+      const auto numBits = std::min<int32_t>(64, numRows - i);
+      uint64_t word = 0;
+      for (auto bit = 0; bit < numBits; ++bit) {
+        auto row = rows[i + bit];
+        word |= static_cast<uint64_t>(
+                    row != nullptr && !isNullAt(row, nullByte, nullMask))
+            << bit;
+      }
+      if (numBits == 64) {
+        nulls[i / 64] = word;
+      } else {
+        nulls[i / 64] = (nulls[i / 64] & ~bits::lowMask(numBits)) | word;
+      }
+    }
+  }
+
+  // Copies the values at 'offset' of 'rows' to 'values'. Rows that are
+  // nullptr get a default value. Uses SIMD gathers for 4 and 8 byte
+  // values, with the row pointers as indices.
+  template <typename T>
+  static void gatherValues(
+      const char* const* rows,
+      int32_t numRows,
+      int32_t offset,
+      T* values) {
+    int32_t i = 0;
+    if constexpr (
+        std::is_arithmetic_v<T> && (sizeof(T) == 4 || sizeof(T) == 8)) {
+      constexpr int32_t kBatchSize = xsimd::batch<T>::size;
+      // The address of a value is 'base' plus the row pointer.
+      auto base = reinterpret_cast<const T*>(static_cast<intptr_t>(offset));
+      for (; i + kBatchSize <= numRows; i += kBatchSize) {
+        bool hasNullRow = false;
+        for (auto j = 0; j < kBatchSize; ++j) {
+          hasNullRow |= rows[i + j] == nullptr;
+        }
+        if (hasNullRow) {
+          for (auto j = i; j < i + kBatchSize; ++j) {
+            values[j] = rows[j] ? valueAt<T>(rows[j], offset) : T();
+          }
+          continue;
+        }
+        simd::gather<T, int64_t, 1>(
+            base, reinterpret_cast<const int64_t*>(rows + i))
+            .store_unaligned(values + i);
+      }
+    }
+    for (; i < numRows; ++i) {
+      values[i] = rows[i] ? valueAt<T>(rows[i], offset) : T();
+    }
+  }
+
   template <typename T>
   static void extractValuesWithNulls(
       const char* const* rows,
@@ -483,15 +610,17 @@ class RowContainer {
     result->resize(numRows);
     BufferPtr nullBuffer = result->mutableNulls(numRows);
     auto nulls = nullBuffer->asMutable<uint64_t>();
+    extractNulls(rows, numRows, nullByte, nullMask, nulls);
     BufferPtr valuesBuffer = result->mutableValues(numRows);
-    auto values = valuesBuffer->asMutableRange<T>();
-    for (int32_t i = 0; i < numRows; ++i) {
-      if (rows[i] == nullptr) {
-        bits::setNull(nulls, i, true);
-      } else {
-        bits::setNull(nulls, i, isNullAt(rows[i], nullByte, nullMask));
-        values[i] = valueAt<T>(rows[i], offset);
+    if constexpr (std::is_same_v<T, bool>) {
+      auto values = valuesBuffer->asMutableRange<T>();
+      for (int32_t i = 0; i < numRows; ++i) {
+        if (rows[i]) {
+          values[i] = valueAt<T>(rows[i], offset);
+        }
       }
+    } else {
+      gatherValues(rows, numRows, offset, valuesBuffer->asMutable<T>());
     }
   }
 
@@ -503,20 +632,43 @@ class RowContainer {
       FlatVector<T>* result) {
     result->resize(numRows);
     BufferPtr valuesBuffer = result->mutableValues(numRows);
-    auto values = valuesBuffer->asMutableRange<T>();
-    for (int32_t i = 0; i < numRows; ++i) {
-      if (rows[i] == nullptr) {
-        result->setNull(i, true);
-      } else {
-        result->setNull(i, false);
-        // Here a StringView will reference the hash table, not copy.
-        values[i] = valueAt<T>(rows[i], offset);
+    if constexpr (std::is_same_v<T, bool>) {
+      auto values = valuesBuffer->asMutableRange<T>();
+      for (int32_t i = 0; i < numRows; ++i) {
+        if (rows[i]) {
+          values[i] = valueAt<T>(rows[i], offset);
+        }
       }
+    } else {
+      gatherValues(rows, numRows, offset, valuesBuffer->asMutable<T>());
+    }
+    // Only nullptr rows are null.
+    bool hasNullRow = false;
+    for (int32_t i = 0; i < numRows; ++i) {
+      hasNullRow |= rows[i] == nullptr;
+    }
+    if (hasNullRow) {
+      extractNulls(
+          rows,
+          numRows,
+          0,
+          0,
+          result->mutableNulls(numRows)->template asMutable<uint64_t>());
+    } else {
+      result->clearNulls(0, numRows);
     }
   }
 
   static void prepareRead(const char* row, int32_t offset, ByteStream& stream);
 
+  // Prepares 'stream' for reading the complex type value at 'offset' in
+  // 'row'. A complex type value is stored as its hash followed by its
+  // serialization, so that hashing stored keys does not deserialize them
+  // and keys with different hashes compare unequal without reading
+  // them. Returns the hash and leaves 'stream' at the serialization.
+  static uint64_t
+  prepareReadComplex(const char* row, int32_t offset, ByteStream& stream);
+
   template <TypeKind Kind>
   void hashTyped(
       const Type* type,
@@ -545,8 +697,7 @@ class RowContainer {
       return compareComplexType(row, offset, decoded, index) == 0;
     }
     if (Kind == TypeKind::VARCHAR || Kind == TypeKind::VARBINARY) {
-      return compareStringAsc(
-                 valueAt<StringView>(row, offset), decoded, index) == 0;
+      return equalsString(valueAt<StringView>(row, offset), decoded, index);
     }
     return decoded.valueAt<T>(index) == valueAt<T>(row, offset);
   }
@@ -564,8 +715,7 @@ class RowContainer {
       return compareComplexType(row, offset, decoded, index) == 0;
     }
     if (Kind == TypeKind::VARCHAR || Kind == TypeKind::VARBINARY) {
-      return compareStringAsc(
-                 valueAt<StringView>(row, offset), decoded, index) == 0;
+      return equalsString(valueAt<StringView>(row, offset), decoded, index);
     }
 
     return decoded.valueAt<T>(index) == valueAt<T>(row, offset);
@@ -675,10 +825,14 @@ class RowContainer {
       iter->normalizedKeysLeft = numRowsWithNormalizedKey_;
     }
     int32_t rowSize = fixedRowSize_ +
-        (iter->normalizedKeysLeft > 0 ? sizeof(normalized_key_t) : 0);
+        (iter->normalizedKeysLeft > 0 ? normalizedKeyBytes_ : 0);
     for (auto i = iter->allocationIndex; i < numAllocations; ++i) {
       auto allocation = rows_.allocationAt(i);
       auto numRuns = allocation->numRuns();
+      if (i == numAllocations - 1) {
+        // Runs after the current one are not used.
+        numRuns = std::min<int32_t>(numRuns, rows_.currentRunIndex() + 1);
+      }
       for (auto runIndex = iter->runIndex; runIndex < numRuns; ++runIndex) {
         memory::MappedMemory::PageRun run = allocation->runAt(runIndex);
         auto data = run.data<char>();
@@ -691,10 +845,10 @@ class RowContainer {
         auto row = iter->rowOffset;
         while (row + rowSize <= limit) {
           rows[count++] = data + row +
-              (iter->normalizedKeysLeft > 0 ? sizeof(normalized_key_t) : 0);
+              (iter->normalizedKeysLeft > 0 ? normalizedKeyBytes_ : 0);
           row += rowSize;
           if (--iter->normalizedKeysLeft == 0) {
-            rowSize -= sizeof(normalized_key_t);
+            rowSize -= normalizedKeyBytes_;
           }
           if (bits::isBitSet(rows[count - 1], freeFlagOffset_)) {
             --count;
@@ -743,6 +897,24 @@ class RowContainer {
 
   static int32_t compareStringAsc(StringView left, StringView right);
 
+  // Returns true if the string 'stored' in a row equals the value at 'index'
+  // of 'decoded'. Compares the sizes, prefixes and inline parts first, so
+  // that possibly non-contiguous out of line data is read only if these
+  // match.
+  static bool equalsString(
+      StringView stored,
+      const DecodedVector& decoded,
+      vector_size_t index) {
+    auto value = decoded.valueAt<StringView>(index);
+    if (!simd::stringViewHeadsEqual(stored, value)) {
+      return false;
+    }
+    if (stored.isInline()) {
+      return stored == value;
+    }
+    return compareStringAsc(stored, decoded, index) == 0;
+  }
+
   int32_t compareComplexType(
       const char* row,
       int32_t offset,
@@ -763,6 +935,16 @@ class RowContainer {
   // Free any aggregates associated with the 'rows'.
   void freeAggregates(folly::Range<char**> rows);
 
+  // Copies the out of line variable width keys and dependents of all rows
+  // into a new 'stringAllocator_' so that the memory of erased rows'
+  // values and of fragmentation is released. Called from compact().
+  void relocateVariableWidthData();
+
+  // Copies the non-inline StringView at 'offset' in 'row' to 'to' and
+  // points the StringView to the copy.
+  void
+  copyVariableWidthValue(char* row, int32_t offset, HashStringAllocator& to);
+
   const std::vector<TypePtr> keyTypes_;
   const bool nullableKeys_;
 
@@ -771,6 +953,8 @@ class RowContainer {
   // aggregates. Store the metadata here.
   const std::vector<std::unique_ptr<Aggregate>>& aggregates_;
   bool usesExternalMemory_ = false;
+  // True if an accumulator may keep data in 'stringAllocator_'.
+  bool accumulatorsUseAllocator_ = false;
   // Types of non-aggregate columns. Keys first. Corresponds pairwise
   // to 'typeKinds_' and 'rowColumns_'.
   std::vector<TypePtr> types_;
@@ -794,10 +978,11 @@ class RowContainer {
   int32_t rowSizeOffset_ = 0;
 
   int32_t fixedRowSize_;
-  // True if normalized keys are enabled in initial state.
-  const bool hasNormalizedKeys_;
-  // The count of entries that have an extra normalized_key_t before the
-  // start.
+  // Size of the normalized key before each row that has one. One or two
+  // normalized_key_t's if normalized keys are enabled in initial state.
+  const int8_t normalizedKeyBytes_;
+  // The count of entries that have an extra 'normalizedKeyBytes_' before
+  // the start.
   int64_t numRowsWithNormalizedKey_ = 0;
   // Extra bytes to reserve before  each added row for a normalized key. Set to
   // 0 after deciding not to use normalized keys.
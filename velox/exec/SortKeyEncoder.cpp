@@ -0,0 +1,407 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#include "velox/exec/SortKeyEncoder.h"
+
+#include <folly/lang/Bits.h>
+
+#include "velox/buffer/Buffer.h"
+#include "velox/common/base/AsyncSource.h"
+#include "velox/exec/RowContainer.h"
+
+namespace facebook::velox::exec {
+
+namespace {
+// Reads the keys of a row of a RowContainer.
+class ContainerKeys {
+ public:
+  ContainerKeys(const RowContainer& container, const char* row)
+      : container_(container), row_(row) {}
+
+  bool isNullAt(column_index_t channel) const {
+    auto column = container_.columnAt(channel);
+    return RowContainer::isNullAt(row_, column.nullByte(), column.nullMask());
+  }
+
+  template <typename T>
+  T valueAt(column_index_t channel) const {
+    T value;
+    memcpy(&value, row_ + container_.columnAt(channel).offset(), sizeof(T));
+    return value;
+  }
+
+  StringView stringAt(column_index_t channel, std::string& storage) const {
+    return HashStringAllocator::contiguousString(
+        valueAt<StringView>(channel), storage);
+  }
+
+ private:
+  const RowContainer& container_;
+  const char* row_;
+};
+
+// Reads the keys of a row of a set of DecodedVectors.
+class DecodedKeys {
+ public:
+  DecodedKeys(const std::vector<DecodedVector>& decoded, vector_size_t index)
+      : decoded_(decoded), index_(index) {}
+
+  bool isNullAt(column_index_t channel) const {
+    return decoded_[channel].isNullAt(index_);
+  }
+
+  template <typename T>
+  T valueAt(column_index_t channel) const {
+    return decoded_[channel].valueAt<T>(index_);
+  }
+
+  StringView stringAt(column_index_t channel, std::string& /*storage*/)
+      const {
+    return valueAt<StringView>(channel);
+  }
+
+ private:
+  const std::vector<DecodedVector>& decoded_;
+  const vector_size_t index_;
+};
+
+// Returns the number of value bytes of an encoded key of 'kind' or 0 if
+// keys of 'kind' are not encoded.
+int32_t encodedWidth(TypeKind kind) {
+  switch (kind) {
+    case TypeKind::BOOLEAN:
+    case TypeKind::TINYINT:
+      return 1;
+    case TypeKind::SMALLINT:
+      return 2;
+    case TypeKind::INTEGER:
+    case TypeKind::REAL:
+    case TypeKind::DATE:
+      return 4;
+    case TypeKind::BIGINT:
+    case TypeKind::DOUBLE:
+      return 8;
+    case TypeKind::TIMESTAMP:
+      return 16;
+    case TypeKind::VARCHAR:
+    case TypeKind::VARBINARY:
+      return SortKeyEncoder::kStringPrefixBytes;
+    default:
+      return 0;
+  }
+}
+
+bool isString(TypeKind kind) {
+  return kind == TypeKind::VARCHAR || kind == TypeKind::VARBINARY;
+}
+
+template <typename U>
+void storeBigEndian(U bits, bool descending, char* out) {
+  if (descending) {
+    bits = static_cast<U>(~bits);
+  }
+  bits = folly::Endian::big(bits);
+  memcpy(out, &bits, sizeof(U));
+}
+
+// Flips the sign bit so that negative values come first.
+template <typename T>
+void encodeInteger(T value, bool descending, char* out) {
+  using U = std::make_unsigned_t<T>;
+  constexpr U kSignBit = U(1) << (sizeof(U) * 8 - 1);
+  storeBigEndian<U>(
+      static_cast<U>(static_cast<U>(value) ^ kSignBit), descending, out);
+}
+
+// Inverts negative values and sets the sign bit of positive ones. -0.0 is
+// encoded as 0.0 and all NaNs as the same NaN, which sorts after infinity.
+template <typename T, typename U>
+void encodeFloatingPoint(T value, bool descending, char* out) {
+  static_assert(sizeof(T) == sizeof(U));
+  if (std::isnan(value)) {
+    value = std::numeric_limits<T>::quiet_NaN();
+  } else if (value == 0) {
+    value = 0;
+  }
+  U bits;
+  memcpy(&bits, &value, sizeof(U));
+  constexpr U kSignBit = U(1) << (sizeof(U) * 8 - 1);
+  bits = (bits & kSignBit) ? static_cast<U>(~bits) : bits | kSignBit;
+  storeBigEndian<U>(bits, descending, out);
+}
+
+void encodeStringPrefix(StringView value, bool descending, char* out) {
+  constexpr int32_t kSize = SortKeyEncoder::kStringPrefixBytes;
+  const auto size = std::min<int32_t>(value.size(), kSize);
+  memcpy(out, value.data(), size);
+  memset(out + size, 0, kSize - size);
+  if (descending) {
+    for (auto i = 0; i < kSize; ++i) {
+      out[i] = ~out[i];
+    }
+  }
+}
+
+char* rowAt(const char* entry) {
+  char* row;
+  memcpy(&row, entry, sizeof(char*));
+  return row;
+}
+} // namespace
+
+SortKeyEncoder::SortKeyEncoder(
+    const std::vector<TypePtr>& keyTypes,
+    const std::vector<CompareFlags>& compareFlags,
+    std::vector<column_index_t> channels,
+    int32_t maxKeyBytes)
+    : compareFlags_(compareFlags) {
+  VELOX_CHECK_EQ(keyTypes.size(), compareFlags.size());
+  VELOX_CHECK(channels.empty() || channels.size() == keyTypes.size());
+  for (auto i = 0; i < keyTypes.size(); ++i) {
+    const auto kind = keyTypes[i]->kind();
+    const auto width = encodedWidth(kind);
+    if (width == 0 || keySize_ + 1 + width > maxKeyBytes) {
+      break;
+    }
+    keys_.push_back(
+        {channels.empty() ? static_cast<column_index_t>(i) : channels[i],
+         kind,
+         compareFlags[i],
+         keySize_,
+         width});
+    keySize_ += 1 + width;
+    if (isString(kind)) {
+      // Strings that share the prefix are not ordered by the prefix, so
+      // the keys after them would not be either.
+      break;
+    }
+  }
+  complete_ = keys_.size() == keyTypes.size() &&
+      (keys_.empty() || !isString(keys_.back().kind));
+}
+
+template <typename Keys>
+void SortKeyEncoder::encodeKeys(const Keys& keys, char* key) const {
+  for (const auto& info : keys_) {
+    char* out = key + info.offset;
+    // The null byte does not depend on the sort direction.
+    if (keys.isNullAt(info.channel)) {
+      out[0] = info.flags.nullsFirst ? 0 : 2;
+      memset(out + 1, 0, info.width);
+      continue;
+    }
+    out[0] = 1;
+    ++out;
+    const auto channel = info.channel;
+    const bool descending = !info.flags.ascending;
+    switch (info.kind) {
+      case TypeKind::BOOLEAN:
+        storeBigEndian<uint8_t>(
+            keys.template valueAt<bool>(channel) ? 1 : 0, descending, out);
+        break;
+      case TypeKind::TINYINT:
+        encodeInteger(keys.template valueAt<int8_t>(channel), descending, out);
+        break;
+      case TypeKind::SMALLINT:
+        encodeInteger(
+            keys.template valueAt<int16_t>(channel), descending, out);
+        break;
+      case TypeKind::INTEGER:
+        encodeInteger(
+            keys.template valueAt<int32_t>(channel), descending, out);
+        break;
+      case TypeKind::BIGINT:
+        encodeInteger(
+            keys.template valueAt<int64_t>(channel), descending, out);
+        break;
+      case TypeKind::DATE:
+        encodeInteger(
+            keys.template valueAt<Date>(channel).days(), descending, out);
+        break;
+      case TypeKind::REAL:
+        encodeFloatingPoint<float, uint32_t>(
+            keys.template valueAt<float>(channel), descending, out);
+        break;
+      case TypeKind::DOUBLE:
+        encodeFloatingPoint<double, uint64_t>(
+            keys.template valueAt<double>(channel), descending, out);
+        break;
+      case TypeKind::TIMESTAMP: {
+        auto value = keys.template valueAt<Timestamp>(channel);
+        encodeInteger(value.getSeconds(), descending, out);
+        storeBigEndian<uint64_t>(value.getNanos(), descending, out + 8);
+        break;
+      }
+      case TypeKind::VARCHAR:
+      case TypeKind::VARBINARY: {
+        std::string storage;
+        encodeStringPrefix(keys.stringAt(channel, storage), descending, out);
+        break;
+      }
+      default:
+        VELOX_UNREACHABLE();
+    }
+  }
+}
+
+void SortKeyEncoder::encode(
+    const RowContainer& container,
+    const char* row,
+    char* key) const {
+  encodeKeys(ContainerKeys(container, row), key);
+}
+
+void SortKeyEncoder::encode(
+    const std::vector<DecodedVector>& decoded,
+    vector_size_t index,
+    char* key) const {
+  encodeKeys(DecodedKeys(decoded, index), key);
+}
+
+bool SortKeyEncoder::entryLess(
+    RowContainer& container,
+    const char* left,
+    const char* right) const {
+  if (auto result = compare(left + sizeof(char*), right + sizeof(char*))) {
+    return result < 0;
+  }
+  if (complete_) {
+    return false;
+  }
+  return container.compareRows(rowAt(left), rowAt(right), compareFlags_) < 0;
+}
+
+void SortKeyEncoder::sortRows(
+    RowContainer& container,
+    folly::Range<char**> rows,
+    memory::MemoryPool& pool,
+    folly::Executor* executor,
+    int32_t numThreads) const {
+  numThreads =
+      std::min<int64_t>(numThreads, rows.size() / kMinRowsPerSortThread);
+  if (executor && numThreads > 1) {
+    sortRowsParallel(container, rows, pool, executor, numThreads);
+    return;
+  }
+  if (keySize_ == 0) {
+    std::sort(
+        rows.begin(), rows.end(), [&](const char* left, const char* right) {
+          return container.compareRows(left, right, compareFlags_) < 0;
+        });
+    return;
+  }
+
+  // Each entry is a row pointer followed by the encoded key of the row. The
+  // entries are sorted so that the keys are compared without following the
+  // row pointers.
+  const auto entrySize = sizeof(char*) + keySize_;
+  auto entries = AlignedBuffer::allocate<char>(rows.size() * entrySize, &pool);
+  auto rawEntries = entries->asMutable<char>();
+  std::vector<char*> sorted(rows.size());
+  for (auto i = 0; i < rows.size(); ++i) {
+    char* entry = rawEntries + i * entrySize;
+    memcpy(entry, &rows[i], sizeof(char*));
+    encode(container, rows[i], entry + sizeof(char*));
+    sorted[i] = entry;
+  }
+  std::sort(
+      sorted.begin(), sorted.end(), [&](const char* left, const char* right) {
+        return entryLess(container, left, right);
+      });
+  for (auto i = 0; i < rows.size(); ++i) {
+    rows[i] = rowAt(sorted[i]);
+  }
+}
+
+void SortKeyEncoder::sortRowsParallel(
+    RowContainer& container,
+    folly::Range<char**> rows,
+    memory::MemoryPool& pool,
+    folly::Executor* executor,
+    int32_t numThreads) const {
+  // Number of sampled rows per key range. More samples make the ranges more
+  // even.
+  constexpr int32_t kSamplesPerRange = 64;
+  const auto numRows = rows.size();
+  const auto entrySize = sizeof(char*) + keySize_;
+  auto less = [&](const char* left, const char* right) {
+    return entryLess(container, left, right);
+  };
+  auto chunkBegin = [&](int32_t chunk) {
+    return numRows * chunk / numThreads;
+  };
+
+  auto entries = AlignedBuffer::allocate<char>(numRows * entrySize, &pool);
+  auto rawEntries = entries->asMutable<char>();
+  std::vector<char*> unsorted(numRows);
+  runParallel(executor, numThreads, [&](int32_t chunk) {
+    for (auto i = chunkBegin(chunk); i < chunkBegin(chunk + 1); ++i) {
+      char* entry = rawEntries + i * entrySize;
+      memcpy(entry, &rows[i], sizeof(char*));
+      encode(container, rows[i], entry + sizeof(char*));
+      unsorted[i] = entry;
+    }
+  });
+
+  // Takes evenly spaced rows as a sample. Every kSamplesPerRange'th sampled
+  // row in key order is the first key of a range.
+  const auto sampleSize = numThreads * kSamplesPerRange;
+  std::vector<char*> sample(sampleSize);
+  for (auto i = 0; i < sampleSize; ++i) {
+    sample[i] = unsorted[numRows * i / sampleSize];
+  }
+  std::sort(sample.begin(), sample.end(), less);
+  std::vector<char*> splitters(numThreads - 1);
+  for (auto i = 1; i < numThreads; ++i) {
+    splitters[i - 1] = sample[i * kSamplesPerRange];
+  }
+
+  std::vector<int32_t> ranges(numRows);
+  runParallel(executor, numThreads, [&](int32_t chunk) {
+    for (auto i = chunkBegin(chunk); i < chunkBegin(chunk + 1); ++i) {
+      ranges[i] = std::upper_bound(
+                      splitters.begin(), splitters.end(), unsorted[i], less) -
+          splitters.begin();
+    }
+  });
+
+  // Moves the entries of each range together.
+  std::vector<size_t> rangeBegin(numThreads + 1, 0);
+  for (auto range : ranges) {
+    ++rangeBegin[range + 1];
+  }
+  for (auto i = 1; i <= numThreads; ++i) {
+    rangeBegin[i] += rangeBegin[i - 1];
+  }
+  std::vector<char*> sorted(numRows);
+  auto fill = rangeBegin;
+  for (auto i = 0; i < numRows; ++i) {
+    sorted[fill[ranges[i]]++] = unsorted[i];
+  }
+
+  runParallel(executor, numThreads, [&](int32_t range) {
+    std::sort(
+        sorted.begin() + rangeBegin[range],
+        sorted.begin() + rangeBegin[range + 1],
+        less);
+    for (auto i = rangeBegin[range]; i < rangeBegin[range + 1]; ++i) {
+      rows[i] = rowAt(sorted[i]);
+    }
+  });
+}
+
+} // namespace facebook::velox::exec
@@ -0,0 +1,135 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#pragma once
+
+#include <folly/Executor.h>
+#include <folly/Range.h>
+#include <cstring>
+
+#include "velox/common/base/CompareFlags.h"
+#include "velox/common/memory/Memory.h"
+#include "velox/type/Type.h"
+#include "velox/vector/DecodedVector.h"
+
+namespace facebook::velox::exec {
+
+class RowContainer;
+
+// Encodes the leading sorting keys of a row into a fixed size byte string
+// whose memcmp order is the order of the keys under their CompareFlags.
+// Each key is a null byte followed by the value: integers and dates with
+// the sign bit flipped, floating point values with their bits arranged so
+// that -0.0 equals 0.0 and NaN sorts last, timestamps as seconds and nanos,
+// all big endian and inverted if descending. Strings contribute their first
+// kStringPrefixBytes bytes padded with zeros. Encoding stops after a string
+// key, before a key of another type and before a key that does not fit in
+// 'maxKeyBytes'. If the encoded prefix is not the whole key, rows with
+// equal prefixes must be compared with the full comparison.
+class SortKeyEncoder {
+ public:
+  static constexpr int32_t kDefaultMaxKeyBytes = 32;
+  static constexpr int32_t kStringPrefixBytes = 12;
+
+  // Makes an encoder for keys of 'keyTypes' ordered by 'compareFlags'. The
+  // i-th key is at 'channels[i]' of the RowContainer or DecodedVectors
+  // being encoded. 'channels' defaults to 0, 1, ...
+  SortKeyEncoder(
+      const std::vector<TypePtr>& keyTypes,
+      const std::vector<CompareFlags>& compareFlags,
+      std::vector<column_index_t> channels = {},
+      int32_t maxKeyBytes = kDefaultMaxKeyBytes);
+
+  // Size of an encoded key. 0 if the first key cannot be encoded.
+  int32_t keySize() const {
+    return keySize_;
+  }
+
+  // True if equal encoded keys imply equal rows.
+  bool isComplete() const {
+    return complete_;
+  }
+
+  // Compares two encoded keys. Returns < 0, 0 or > 0.
+  int32_t compare(const char* left, const char* right) const {
+    return keySize_ == 0 ? 0 : memcmp(left, right, keySize_);
+  }
+
+  // Writes the encoded key of 'row' of 'container' to 'key'.
+  void encode(const RowContainer& container, const char* row, char* key)
+      const;
+
+  // Writes the encoded key of row 'index' of 'decoded' to 'key'.
+  void encode(
+      const std::vector<DecodedVector>& decoded,
+      vector_size_t index,
+      char* key) const;
+
+  // Sorts 'rows' of 'container' on the keys. The keys must be the leading
+  // columns of 'container' in order. The rows are sorted on their encoded
+  // keys and only rows with equal incomplete keys are compared with
+  // RowContainer::compareRows(). If 'executor' is set and there are at least
+  // kMinRowsPerSortThread rows per thread, sorts with a sample sort on up to
+  // 'numThreads' threads of 'executor' and the calling thread: splitters
+  // picked from a sample divide the rows into key ranges that are sorted in
+  // parallel. The scratch memory for the encoded keys comes from 'pool'.
+  void sortRows(
+      RowContainer& container,
+      folly::Range<char**> rows,
+      memory::MemoryPool& pool,
+      folly::Executor* executor = nullptr,
+      int32_t numThreads = 1) const;
+
+  static constexpr int32_t kMinRowsPerSortThread = 10'000;
+
+ private:
+  struct KeyInfo {
+    column_index_t channel;
+    TypeKind kind;
+    CompareFlags flags;
+    // Offset of the null byte of the key in the encoded key.
+    int32_t offset;
+    // Number of value bytes after the null byte.
+    int32_t width;
+  };
+
+  template <typename Keys>
+  void encodeKeys(const Keys& keys, char* key) const;
+
+  // Returns true if the row of the sort entry 'left' sorts before the row of
+  // 'right'. A sort entry is a row pointer followed by the encoded key.
+  bool entryLess(RowContainer& container, const char* left, const char* right)
+      const;
+
+  void sortRowsParallel(
+      RowContainer& container,
+      folly::Range<char**> rows,
+      memory::MemoryPool& pool,
+      folly::Executor* executor,
+      int32_t numThreads) const;
+
+  const std::vector<CompareFlags> compareFlags_;
+
+  // The keys that are encoded.
+  std::vector<KeyInfo> keys_;
+
+  int32_t keySize_{0};
+
+  bool complete_{true};
+};
+
+} // namespace facebook::velox::exec
@@ -15,27 +15,193 @@
  */
 
 #include "velox/exec/Spill.h"
+#include <folly/String.h>
 #include "velox/common/file/FileSystems.h"
+#include "velox/common/time/Timer.h"
+#include "velox/exec/OperatorUtils.h"
 
 namespace facebook::velox::exec {
 
 std::atomic<int32_t> SpillStream::ordinalCounter_;
+std::atomic<uint64_t> SpillFileList::nextPrefixCounter_;
+std::atomic<int64_t> SpillFile::localSpillBytes_;
+
+namespace {
+// Batches for the overflow tier are buffered up to this size so that remote
+// files are written in large sequential pieces.
+constexpr uint64_t kOverflowWriteBytes = 8 << 20;
+} // namespace
+
+folly::io::CodecType spillCompressionCodec(const std::string& kind) {
+  return compressionCodec(kind, "spill");
+}
+
+folly::io::CodecType spillCompressionCodec(
+    const std::optional<std::string>& spillPath,
+    const std::string& kind) {
+  if (!spillPath.has_value()) {
+    return folly::io::CodecType::NO_COMPRESSION;
+  }
+  return spillCompressionCodec(kind);
+}
+
+std::vector<std::string> splitSpillPath(const std::string& path) {
+  std::vector<std::string> prefixes;
+  folly::split(',', path, prefixes);
+  for (const auto& prefix : prefixes) {
+    VELOX_USER_CHECK(!prefix.empty(), "Empty prefix in spill path: {}", path);
+  }
+  return prefixes;
+}
+
+std::pair<std::vector<std::string>, std::vector<std::string>> splitSpillTiers(
+    const std::string& path) {
+  std::vector<std::string> tiers;
+  folly::split('|', path, tiers);
+  VELOX_USER_CHECK_LE(
+      tiers.size(), 2, "Too many tiers in spill path: {}", path);
+  if (tiers.size() == 1) {
+    return {splitSpillPath(tiers[0]), {}};
+  }
+  return {splitSpillPath(tiers[0]), splitSpillPath(tiers[1])};
+}
+
+std::string appendToSpillPath(
+    const std::string& path,
+    std::string_view suffix) {
+  auto appendToTier = [&](const std::vector<std::string>& prefixes) {
+    std::string result;
+    for (const auto& prefix : prefixes) {
+      if (!result.empty()) {
+        result += ',';
+      }
+      result += prefix;
+      result += suffix;
+    }
+    return result;
+  };
+  auto [local, overflow] = splitSpillTiers(path);
+  if (overflow.empty()) {
+    return appendToTier(local);
+  }
+  return appendToTier(local) + "|" + appendToTier(overflow);
+}
+
+SpillInput::~SpillInput() {
+  if (readAhead_) {
+    // The read-ahead refers to 'this' and must be done before 'this' is freed.
+    try {
+      readAhead_->move();
+    } catch (const std::exception& e) {
+    }
+  }
+}
 
 void SpillInput::next(bool /*throwIfPastEnd*/) {
-  int32_t readBytes = std::min(input_->size() - offset_, buffer_->capacity());
-  VELOX_CHECK_LT(0, readBytes, "Reading past end of spill file");
-  setRange({buffer_->asMutable<uint8_t>(), readBytes, 0});
-  input_->pread(offset_, readBytes, buffer_->asMutable<char>());
-  offset_ += readBytes;
+  VELOX_CHECK_LT(offset_, size_, "Reading past end of spill file");
+  std::unique_ptr<Chunk> chunk;
+  if (readAhead_) {
+    chunk = readAhead_->move();
+    readAhead_ = nullptr;
+    if (chunk->error) {
+      std::rethrow_exception(chunk->error);
+    }
+  } else {
+    chunk = readChunk(offset_, std::move(spareBuffer_));
+  }
+  if (current_) {
+    // The buffer of the consumed chunk is reused for the next read.
+    spareBuffer_ = std::move(current_->buffer);
+  }
+  current_ = std::move(chunk);
+  offset_ = current_->endOffset;
+  setRange({current_->data, current_->size, 0});
+  startReadAhead();
+}
+
+void SpillInput::startReadAhead() {
+  if (!executor_ || offset_ >= size_) {
+    return;
+  }
+  if (!spareBuffer_) {
+    spareBuffer_ = AlignedBuffer::allocate<char>(
+        current_->buffer->capacity(), current_->buffer->pool());
+  }
+  readAhead_ = std::make_shared<AsyncSource<Chunk>>(
+      [this, offset = offset_, buffer = std::move(spareBuffer_)]() {
+        try {
+          return readChunk(offset, buffer);
+        } catch (const std::exception& e) {
+          // The error is rethrown on the consumer thread in next().
+          auto chunk = std::make_unique<Chunk>();
+          chunk->error = std::current_exception();
+          return chunk;
+        }
+      });
+  executor_->add([source = readAhead_]() { source->prepare(); });
+}
+
+std::unique_ptr<SpillInput::Chunk> SpillInput::readChunk(
+    uint64_t offset,
+    BufferPtr buffer) const {
+  VELOX_CHECK_NOT_NULL(buffer);
+  auto chunk = std::make_unique<Chunk>();
+  if (!codec_) {
+    const auto readBytes =
+        std::min<uint64_t>(size_ - offset, buffer->capacity());
+    VELOX_CHECK_LT(0, readBytes, "Reading past end of spill file");
+    input_->pread(offset, readBytes, buffer->asMutable<char>());
+    chunk->data = buffer->asMutable<uint8_t>();
+    chunk->size = readBytes;
+    chunk->endOffset = offset + readBytes;
+    chunk->buffer = std::move(buffer);
+    return chunk;
+  }
+  uint32_t header[2];
+  VELOX_CHECK_LE(
+      offset + sizeof(header), size_, "Reading past end of spill file");
+  input_->pread(offset, sizeof(header), header);
+  offset += sizeof(header);
+  const auto compressedSize = header[0];
+  const auto uncompressedSize = header[1];
+  VELOX_CHECK_LE(
+      offset + compressedSize, size_, "Truncated block in spill file");
+  if (buffer->capacity() < compressedSize) {
+    AlignedBuffer::reallocate<char>(&buffer, compressedSize);
+  }
+  input_->pread(offset, compressedSize, buffer->asMutable<char>());
+  auto compressed =
+      folly::IOBuf::wrapBufferAsValue(buffer->as<char>(), compressedSize);
+  chunk->uncompressed = codec_->uncompress(&compressed, uncompressedSize);
+  chunk->uncompressed->coalesce();
+  VELOX_CHECK_EQ(chunk->uncompressed->length(), uncompressedSize);
+  chunk->data = chunk->uncompressed->writableData();
+  chunk->size = uncompressedSize;
+  chunk->endOffset = offset + compressedSize;
+  chunk->buffer = std::move(buffer);
+  return chunk;
 }
 
 void SpillStream::pop() {
   if (++index_ >= size_) {
     setNextBatch();
+  } else {
+    encodeKey();
   }
 }
 
+RowVectorPtr SpillStream::popBatch() {
+  VELOX_CHECK_EQ(index_, 0, "popBatch() may not be combined with pop()");
+  if (!hasData()) {
+    return nullptr;
+  }
+  auto batch = std::move(rowVector_);
+  setNextBatch();
+  return batch;
+}
+
 SpillFile::~SpillFile() {
+  localSpillBytes_ -= localBytes_;
   try {
     auto fs = filesystems::getFileSystem(path_, nullptr);
     fs->remove(path_);
@@ -55,14 +221,22 @@ WriteFile& SpillFile::output() {
 void SpillFile::startRead() {
   constexpr uint64_t kMaxReadBufferSize =
       (1 << 20) - AlignedBuffer::kPaddedSize; // 1MB - padding.
+  // Overflow files are read in larger pieces since each read is a remote
+  // request.
+  constexpr uint64_t kMaxOverflowReadBufferSize =
+      (8 << 20) - AlignedBuffer::kPaddedSize; // 8MB - padding.
   VELOX_CHECK(!output_);
   VELOX_CHECK(!input_);
   auto fs = filesystems::getFileSystem(path_, nullptr);
   auto file = fs->openFileForRead(path_);
   auto buffer = AlignedBuffer::allocate<char>(
-      std::min<uint64_t>(fileSize_, kMaxReadBufferSize), &pool_);
-  input_ = std::make_unique<SpillInput>(std::move(file), std::move(buffer));
-  nextBatch();
+      std::min<uint64_t>(
+          fileSize_,
+          overflow_ ? kMaxOverflowReadBufferSize : kMaxReadBufferSize),
+      &pool_);
+  input_ = std::make_unique<SpillInput>(
+      std::move(file), std::move(buffer), compression_, executor_);
+  setNextBatch();
 }
 
 void SpillFile::nextBatch() {
@@ -75,21 +249,96 @@ void SpillFile::nextBatch() {
   size_ = rowVector_->size();
 }
 
+SpillFileList::SpillFileList(
+    RowTypePtr type,
+    int32_t numSortingKeys,
+    const std::string& path,
+    uint64_t targetFileSize,
+    memory::MemoryPool& pool,
+    memory::MappedMemory& mappedMemory,
+    std::vector<CompareFlags> sortCompareFlags,
+    folly::io::CodecType compression,
+    folly::Executor* FOLLY_NULLABLE executor,
+    uint64_t localQuotaBytes)
+    : type_(type),
+      numSortingKeys_(numSortingKeys),
+      sortCompareFlags_(std::move(sortCompareFlags)),
+      compression_(compression),
+      codec_(
+          compression == folly::io::CodecType::NO_COMPRESSION
+              ? nullptr
+              : folly::io::getCodec(compression)),
+      executor_(executor),
+      localQuotaBytes_(localQuotaBytes),
+      targetFileSize_(targetFileSize),
+      pool_(pool),
+      mappedMemory_(mappedMemory),
+      nextPrefix_(nextPrefixCounter_++) {
+  auto [local, overflow] = splitSpillTiers(path);
+  numLocalPrefixes_ = local.size();
+  prefixes_ = std::move(local);
+  prefixes_.insert(prefixes_.end(), overflow.begin(), overflow.end());
+  pathStats_.resize(prefixes_.size());
+  for (auto i = numLocalPrefixes_; i < prefixes_.size(); ++i) {
+    pathStats_[i].overflow = true;
+  }
+}
+
+bool SpillFileList::localQuotaExceeded() const {
+  return numLocalPrefixes_ < prefixes_.size() && localQuotaBytes_ > 0 &&
+      SpillFile::localSpillBytes() >= localQuotaBytes_;
+}
+
+bool SpillFileList::writesToOverflow() const {
+  if (!files_.empty() && files_.back()->isWritable()) {
+    return files_.back()->isOverflow();
+  }
+  return localQuotaExceeded();
+}
+
 WriteFile& SpillFileList::currentOutput() {
   if (files_.empty() || !files_.back()->isWritable() ||
       files_.back()->size() > targetFileSize_ * 1.5) {
     if (!files_.empty() && files_.back()->isWritable()) {
       files_.back()->finishWrite();
     }
+    const bool overflow = localQuotaExceeded();
+    const auto tierBegin = overflow ? numLocalPrefixes_ : 0;
+    const auto tierSize =
+        overflow ? prefixes_.size() - numLocalPrefixes_ : numLocalPrefixes_;
+    currentPrefix_ = tierBegin + nextPrefix_++ % tierSize;
     files_.push_back(std::make_unique<SpillFile>(
         type_,
         numSortingKeys_,
-        fmt::format("{}-{}", path_, files_.size()),
-        pool_));
+        fmt::format("{}-{}", prefixes_[currentPrefix_], files_.size()),
+        pool_,
+        sortCompareFlags_,
+        compression_,
+        executor_,
+        overflow));
   }
   return files_.back()->output();
 }
 
+SpillFileList::~SpillFileList() {
+  if (pendingWrite_) {
+    // The write refers to a file of 'this'.
+    try {
+      pendingWrite_->move();
+    } catch (const std::exception& e) {
+    }
+  }
+}
+
+namespace {
+void appendIOBuf(WriteFile& file, const folly::IOBuf& iobuf) {
+  for (auto& range : iobuf) {
+    file.append(std::string_view(
+        reinterpret_cast<const char*>(range.data()), range.size()));
+  }
+}
+} // namespace
+
 void SpillFileList::flush() {
   if (batch_) {
     IOBufOutputStream out(
@@ -97,10 +346,59 @@ void SpillFileList::flush() {
     batch_->flush(&out);
     batch_.reset();
     auto iobuf = out.getIOBuf();
+    const auto uncompressedSize = iobuf->computeChainDataLength();
+    uncompressedBytes_ += uncompressedSize;
+    if (codec_) {
+      // Each batch is a separately compressed block so that SpillInput can
+      // decompress one batch at a time.
+      VELOX_CHECK_LE(uncompressedSize, std::numeric_limits<uint32_t>::max());
+      auto compressed = codec_->compress(iobuf.get());
+      const uint32_t header[2] = {
+          static_cast<uint32_t>(compressed->computeChainDataLength()),
+          static_cast<uint32_t>(uncompressedSize)};
+      iobuf = folly::IOBuf::copyBuffer(header, sizeof(header));
+      iobuf->appendChain(std::move(compressed));
+    }
+    spilledBytes_ += iobuf->computeChainDataLength();
+
+    // The previous write must be done before choosing the file for this one.
+    waitForWrite();
     auto& file = currentOutput();
-    for (auto& range : *iobuf) {
-      file.append(std::string_view(
-          reinterpret_cast<const char*>(range.data()), range.size()));
+    const auto bytes = iobuf->computeChainDataLength();
+    pathStats_[currentPrefix_].bytes += bytes;
+    files_.back()->recordWrite(bytes);
+    if (!executor_) {
+      MicrosecondTimer timer(&pathStats_[currentPrefix_].writeMicros);
+      appendIOBuf(file, *iobuf);
+      return;
+    }
+    pendingPrefix_ = currentPrefix_;
+    pendingWrite_ = std::make_shared<AsyncSource<WriteResult>>(
+        [&file, data = std::shared_ptr<folly::IOBuf>(std::move(iobuf))]() {
+          auto result = std::make_unique<WriteResult>();
+          try {
+            MicrosecondTimer timer(&result->writeMicros);
+            appendIOBuf(file, *data);
+          } catch (const std::exception& e) {
+            // The error is rethrown on the caller thread in waitForWrite().
+            result->error = std::current_exception();
+          }
+          return result;
+        });
+    executor_->add([source = pendingWrite_]() { source->prepare(); });
+  }
+}
+
+void SpillFileList::waitForWrite() {
+  if (!pendingWrite_) {
+    return;
+  }
+  auto write = std::move(pendingWrite_);
+  auto result = write->move();
+  if (result) {
+    pathStats_[pendingPrefix_].writeMicros += result->writeMicros;
+    if (result->error) {
+      std::rethrow_exception(result->error);
     }
   }
 }
@@ -115,11 +413,16 @@ void SpillFileList::write(
   }
   batch_->append(rows, indices);
 
+  if (writesToOverflow() && batch_->size() < kOverflowWriteBytes) {
+    // Overflow files get fewer, larger writes. finishFile() flushes the rest.
+    return;
+  }
   flush();
 }
 
 void SpillFileList::finishFile() {
   flush();
+  waitForWrite();
   if (files_.empty()) {
     return;
   }
@@ -128,14 +431,6 @@ void SpillFileList::finishFile() {
   }
 }
 
-int64_t SpillFileList::spilledBytes() const {
-  int64_t bytes = 0;
-  for (auto& file : files_) {
-    bytes += file->size();
-  }
-  return bytes;
-}
-
 void SpillState::setNumPartitions(int32_t numPartitions) {
   VELOX_CHECK_LE(numPartitions, maxPartitions());
   VELOX_CHECK_GT(numPartitions, numPartitions_, "May only add partitions");
@@ -150,10 +445,14 @@ void SpillState::appendToPartition(
     files_[partition] = std::make_unique<SpillFileList>(
         std::static_pointer_cast<const RowType>(rows->type()),
         numSortingKeys_,
-        fmt::format("{}-spill-{}", path_, partition),
+        appendToSpillPath(path_, fmt::format("-spill-{}", partition)),
         targetFileSize_,
         pool_,
-        mappedMemory_);
+        mappedMemory_,
+        sortCompareFlags_,
+        compression_,
+        executor_,
+        localQuotaBytes_);
   }
 
   IndexRange range{0, rows->size()};
@@ -177,6 +476,12 @@ std::unique_ptr<TreeOfLosers<SpillStream>> SpillState::startMerge(
   return std::make_unique<TreeOfLosers<SpillStream>>(std::move(result));
 }
 
+std::vector<std::unique_ptr<SpillFile>> SpillState::files(int32_t partition) {
+  VELOX_CHECK(hasFiles(partition));
+  auto list = std::move(files_[partition]);
+  return list->files();
+}
+
 int64_t SpillState::spilledBytes() const {
   int64_t bytes = 0;
   for (auto& list : files_) {
@@ -187,4 +492,31 @@ int64_t SpillState::spilledBytes() const {
   return bytes;
 }
 
+std::vector<SpillPathStats> SpillState::pathStats() const {
+  std::vector<SpillPathStats> stats;
+  for (auto& list : files_) {
+    if (!list) {
+      continue;
+    }
+    const auto& listStats = list->pathStats();
+    stats.resize(std::max(stats.size(), listStats.size()));
+    for (auto i = 0; i < listStats.size(); ++i) {
+      stats[i].bytes += listStats[i].bytes;
+      stats[i].writeMicros += listStats[i].writeMicros;
+      stats[i].overflow = listStats[i].overflow;
+    }
+  }
+  return stats;
+}
+
+int64_t SpillState::spilledUncompressedBytes() const {
+  int64_t bytes = 0;
+  for (auto& list : files_) {
+    if (list) {
+      bytes += list->uncompressedBytes();
+    }
+  }
+  return bytes;
+}
+
 } // namespace facebook::velox::exec
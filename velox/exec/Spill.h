@@ -16,7 +16,12 @@
 
 #pragma once
 
+#include <folly/compression/Compression.h>
+
+#include "velox/common/base/AsyncSource.h"
+#include "velox/common/base/CompareFlags.h"
 #include "velox/common/file/File.h"
+#include "velox/exec/SortKeyEncoder.h"
 #include "velox/exec/TreeOfLosers.h"
 #include "velox/vector/ComplexVector.h"
 #include "velox/vector/DecodedVector.h"
@@ -24,17 +29,70 @@
 
 namespace facebook::velox::exec {
 
+// Returns the codec type for a spill compression kind name as given by
+// QueryConfig::kSpillCompressionKind. Supported names are "none", "lz4",
+// "zstd", "zlib" and "snappy".
+folly::io::CodecType spillCompressionCodec(const std::string& kind);
+
+// Same as above for an operator that spills to 'spillPath'. Returns
+// NO_COMPRESSION without resolving 'kind' if spilling is disabled, so that a
+// codec that is not available in this build only fails queries that spill.
+folly::io::CodecType spillCompressionCodec(
+    const std::optional<std::string>& spillPath,
+    const std::string& kind);
+
+// A spill path is a comma-separated list of file path prefixes, one per spill
+// directory, e.g. "/disk1/spill/task,/disk2/spill/task". The files of a
+// SpillFileList are striped over the prefixes. Returns the prefixes of
+// 'path'.
+std::vector<std::string> splitSpillPath(const std::string& path);
+
+// A spill path may have a second tier of prefixes after a '|', e.g.
+// "/disk1/spill/task|s3://bucket/spill/task". Files go to the second, overflow
+// tier when the local spill files of the process exceed a quota. Returns the
+// local and the overflow prefixes of 'path'.
+std::pair<std::vector<std::string>, std::vector<std::string>> splitSpillTiers(
+    const std::string& path);
+
+// Returns 'path' with 'suffix' appended to each of its prefixes.
+std::string appendToSpillPath(const std::string& path, std::string_view suffix);
+
+// Bytes written to one spill directory and the time spent writing them.
+struct SpillPathStats {
+  int64_t bytes{0};
+  uint64_t writeMicros{0};
+  // True if the directory is in the overflow tier.
+  bool overflow{false};
+};
+
 // Input stream backed by spill file.
 class SpillInput : public ByteStream {
  public:
-  // Reads from 'input' using 'buffer' for buffering reads.
-  SpillInput(std::unique_ptr<ReadFile>&& input, BufferPtr buffer)
+  // Reads from 'input' using 'buffer' for buffering reads. If 'compression' is
+  // not NO_COMPRESSION, the file consists of compressed blocks, each preceded
+  // by its compressed and uncompressed sizes as two uint32_t, and 'buffer' is
+  // grown as needed to hold the largest compressed block. If 'executor' is
+  // set, the read of the next buffer is started on 'executor' as soon as the
+  // current one is returned, so that reading overlaps with consuming the
+  // current buffer. This uses a second buffer of the same size.
+  SpillInput(
+      std::unique_ptr<ReadFile>&& input,
+      BufferPtr buffer,
+      folly::io::CodecType compression = folly::io::CodecType::NO_COMPRESSION,
+      folly::Executor* FOLLY_NULLABLE executor = nullptr)
       : input_(std::move(input)),
-        buffer_(std::move(buffer)),
-        size_(input_->size()) {
+        size_(input_->size()),
+        codec_(
+            compression == folly::io::CodecType::NO_COMPRESSION
+                ? nullptr
+                : folly::io::getCodec(compression)),
+        executor_(executor),
+        spareBuffer_(std::move(buffer)) {
     next(true);
   }
 
+  ~SpillInput() override;
+
   void next(bool throwIfPastEnd) override;
 
   // True if all of the file has been read into vectors.
@@ -43,21 +101,73 @@ class SpillInput : public ByteStream {
   }
 
  private:
+  // The content of one read from the file. This is a buffer of file bytes or,
+  // for a compressed file, the uncompressed content of one block.
+  struct Chunk {
+    BufferPtr buffer;
+    std::unique_ptr<folly::IOBuf> uncompressed;
+    uint8_t* data{nullptr};
+    int32_t size{0};
+    // Offset of the first byte in the file after 'this'.
+    uint64_t endOffset{0};
+    // Set if the read failed on the background executor.
+    std::exception_ptr error;
+  };
+
+  // Reads the chunk starting at 'offset' into 'buffer'. Does not modify
+  // 'this' and may run on a background thread.
+  std::unique_ptr<Chunk> readChunk(uint64_t offset, BufferPtr buffer) const;
+
+  // Starts reading the chunk after the current one on 'executor_'.
+  void startReadAhead();
+
   std::unique_ptr<ReadFile> input_;
-  BufferPtr buffer_;
   const uint64_t size_;
-  // Offset of first byte not in 'buffer_'
+  // Offset of first byte not in 'current_'.
   uint64_t offset_ = 0;
+  // Decompresses blocks of the file. nullptr if the file is not compressed.
+  const std::unique_ptr<folly::io::Codec> codec_;
+  folly::Executor* FOLLY_NULLABLE const executor_;
+  // The chunk being consumed.
+  std::unique_ptr<Chunk> current_;
+  // Buffer for the next read. nullptr while the read-ahead is in progress.
+  BufferPtr spareBuffer_;
+  // The read of the chunk after 'current_'. Set only if 'executor_' is set.
+  std::shared_ptr<AsyncSource<Chunk>> readAhead_;
 };
 
-// A source of spilled RowVectors coming either from a file or memory.
+// A source of spilled RowVectors coming either from a file or memory. The
+// leading 'numSortingKeys' columns are compared using 'sortCompareFlags'. If
+// 'sortCompareFlags' is empty, the keys are compared ascending, nulls first.
 class SpillStream : public MergeStream {
  public:
-  SpillStream(RowTypePtr type, int32_t numSortingKeys, memory::MemoryPool& pool)
+  SpillStream(
+      RowTypePtr type,
+      int32_t numSortingKeys,
+      memory::MemoryPool& pool,
+      std::vector<CompareFlags> sortCompareFlags = {})
       : type_(std::move(type)),
         numSortingKeys_(numSortingKeys),
+        sortCompareFlags_(std::move(sortCompareFlags)),
         pool_(pool),
-        ordinal_(++ordinalCounter_) {}
+        ordinal_(++ordinalCounter_) {
+    VELOX_CHECK(
+        sortCompareFlags_.empty() ||
+        sortCompareFlags_.size() == numSortingKeys_);
+    if (numSortingKeys_ > 0) {
+      const auto& types = type_->children();
+      keyEncoder_ = std::make_unique<SortKeyEncoder>(
+          std::vector<TypePtr>(types.begin(), types.begin() + numSortingKeys_),
+          sortCompareFlags_.empty()
+              ? std::vector<CompareFlags>(numSortingKeys_)
+              : sortCompareFlags_);
+      if (keyEncoder_->keySize() == 0) {
+        keyEncoder_.reset();
+      } else {
+        key_.resize(keyEncoder_->keySize());
+      }
+    }
+  }
 
   virtual ~SpillStream() = default;
 
@@ -71,12 +181,29 @@ class SpillStream : public MergeStream {
 
   int32_t compare(const MergeStream& other) const {
     auto& otherStream = static_cast<const SpillStream&>(other);
+    if (keyEncoder_) {
+      if (auto result =
+              keyEncoder_->compare(key_.data(), otherStream.key_.data())) {
+        return result;
+      }
+      if (keyEncoder_->isComplete()) {
+        return 0;
+      }
+    }
     auto& children = rowVector_->children();
     auto& otherChildren = otherStream.current().children();
     int32_t key = 0;
     do {
-      auto result = children[key]->compare(
-          otherChildren[key].get(), index_, otherStream.index_);
+      auto result = sortCompareFlags_.empty()
+          ? children[key]->compare(
+                otherChildren[key].get(), index_, otherStream.index_)
+          : children[key]
+                ->compare(
+                    otherChildren[key].get(),
+                    index_,
+                    otherStream.index_,
+                    sortCompareFlags_[key])
+                .value();
       if (result) {
         return result;
       }
@@ -90,6 +217,11 @@ class SpillStream : public MergeStream {
 
   void pop();
 
+  // Returns the current batch and advances to the next one. Returns nullptr
+  // when at end. Used for reading unsorted spilled data a batch at a time and
+  // may not be combined with pop().
+  RowVectorPtr popBatch();
+
   const RowVector& current() const {
     return *rowVector_;
   }
@@ -116,6 +248,9 @@ class SpillStream : public MergeStream {
         decoded_[i].decode(*rowVector_->childAt(i), rows_);
       }
     }
+    if (hasData()) {
+      encodeKey();
+    }
   }
 
   void ensureDecodedValid(int32_t index) {
@@ -126,7 +261,15 @@ class SpillStream : public MergeStream {
     ensureRows();
     decoded_.resize(index + 1);
     for (auto i = oldSize; i <= index; ++i) {
-      decoded_[index].decode(*rowVector_->childAt(index), rows_);
+      decoded_[i].decode(*rowVector_->childAt(i), rows_);
+    }
+  }
+
+  // Sets 'key_' to the normalized key of the current row.
+  void encodeKey() {
+    if (keyEncoder_) {
+      ensureDecodedValid(numSortingKeys_ - 1);
+      keyEncoder_->encode(decoded_, index_, key_.data());
     }
   }
 
@@ -147,6 +290,10 @@ class SpillStream : public MergeStream {
   // 0 if not sorted.
   const int32_t numSortingKeys_;
 
+  // Sort order of each of the 'numSortingKeys_' columns. Empty if all are
+  // ascending, nulls first.
+  const std::vector<CompareFlags> sortCompareFlags_;
+
   memory::MemoryPool& pool_;
 
   // Current batch of rows.
@@ -165,6 +312,11 @@ class SpillStream : public MergeStream {
   // Covers all rows inn 'rowVector_' Set if 'decoded_' is non-empty.
   SelectivityVector rows_;
 
+  // Encodes the sorting keys of the current row into 'key_' so that most
+  // comparisons in a merge are a memcmp. nullptr if not sorted.
+  std::unique_ptr<SortKeyEncoder> keyEncoder_;
+  std::vector<char> key_;
+
   // Ordinal number used for making a label for debugging.
   const int32_t ordinal_;
 
@@ -173,19 +325,50 @@ class SpillStream : public MergeStream {
 
 // Represents a spill file that is first in write mode and then
 // turns into a source of spilled RowVectors. Owns a file system file that
-// contains the spilled data and is live for the duration of 'this'.
+// contains the spilled data and is live for the duration of 'this'. If
+// 'overflow' is true, the file is in the overflow tier, e.g. on remote
+// storage, and is read with larger buffers.
 class SpillFile : public SpillStream {
  public:
   SpillFile(
       RowTypePtr type,
       int32_t numSortingKeys,
       const std::string& path,
-      memory::MemoryPool& pool)
-      : SpillStream(std::move(type), numSortingKeys, pool),
-        path_(fmt::format("{}-{}", path, ordinalCounter_++)) {}
+      memory::MemoryPool& pool,
+      std::vector<CompareFlags> sortCompareFlags = {},
+      folly::io::CodecType compression = folly::io::CodecType::NO_COMPRESSION,
+      folly::Executor* FOLLY_NULLABLE executor = nullptr,
+      bool overflow = false)
+      : SpillStream(
+            std::move(type),
+            numSortingKeys,
+            pool,
+            std::move(sortCompareFlags)),
+        path_(fmt::format("{}-{}", path, ordinalCounter_++)),
+        compression_(compression),
+        executor_(executor),
+        overflow_(overflow) {}
 
   ~SpillFile() override;
 
+  bool isOverflow() const {
+    return overflow_;
+  }
+
+  // Adds 'bytes' written to 'this' to the local spill bytes of the process
+  // unless 'this' is in the overflow tier.
+  void recordWrite(int64_t bytes) {
+    if (!overflow_) {
+      localBytes_ += bytes;
+      localSpillBytes_ += bytes;
+    }
+  }
+
+  // Returns the bytes in the live local spill files of the process.
+  static int64_t localSpillBytes() {
+    return localSpillBytes_;
+  }
+
   // Returns a file for writing spilled data. The caller constructs
   // this, then calls output() and writes serialized data to the file
   // and calls finishWrite when the file has reached its final
@@ -206,6 +389,7 @@ class SpillFile : public SpillStream {
 
   // Prepares 'this' for reading. Positions the read at the first row of
   // content. The caller must call output() and finishWrite() before this.
+  // If 'this' has an executor, the file is read ahead on the executor.
   void startRead();
 
   // Returns the file size in bytes. During the writing phase this is
@@ -225,10 +409,18 @@ class SpillFile : public SpillStream {
   void nextBatch() override;
 
   const std::string path_;
+  const folly::io::CodecType compression_;
+  // Executor for reading ahead. If nullptr, reads are on the caller thread.
+  folly::Executor* FOLLY_NULLABLE const executor_;
+  const bool overflow_;
   // Byte size of the backing file. Set when finishing writing.
   uint64_t fileSize_ = 0;
+  // Bytes of 'this' counted in 'localSpillBytes_'.
+  int64_t localBytes_{0};
   std::unique_ptr<WriteFile> output_;
   std::unique_ptr<SpillInput> input_;
+
+  static std::atomic<int64_t> localSpillBytes_;
 };
 
 // Sequence of files for one partition of the spilled data. If data is
@@ -238,10 +430,20 @@ class SpillFileList {
  public:
   // Constructs a set of spill files. 'type' is a RowType describing the
   // content. 'numSortingKeys' is the number of leading columns on which the
-  // data is sorted. 'path' is a file path prefix. ' 'targetFileSize' is the
+  // data is sorted. 'path' is a file path prefix or a comma-separated list of
+  // them, optionally followed by a tier of overflow prefixes, see
+  // splitSpillTiers(). Each new file goes to the next prefix of its tier in
+  // round-robin order. A new file goes to the overflow tier if the local spill
+  // files of the process hold 'localQuotaBytes' or more. 0 means no quota.
+  // 'targetFileSize' is the
   // target byte size of a single file in the file set. 'pool' and
   // 'mappedMemory' are used for buffering and constructing the result data read
-  // from 'this'.
+  // from 'this'. 'sortCompareFlags' gives the sort order of each sorting key,
+  // empty if all are ascending, nulls first. 'compression' is the codec for
+  // compressing the serialized batches before they are written. If 'executor'
+  // is set, the file writes are done on 'executor' while the caller serializes
+  // the next batch. At most one write is in flight at a time. The files of
+  // 'this' are also read ahead on 'executor'.
   //
   // When writing sorted spill runs, the caller is responsible for buffering and
   // sorting the data. write is called multiple times, followed by flush().
@@ -251,13 +453,14 @@ class SpillFileList {
       const std::string& path,
       uint64_t targetFileSize,
       memory::MemoryPool& pool,
-      memory::MappedMemory& mappedMemory)
-      : type_(type),
-        numSortingKeys_(numSortingKeys),
-        path_(path),
-        targetFileSize_(targetFileSize),
-        pool_(pool),
-        mappedMemory_(mappedMemory) {}
+      memory::MappedMemory& mappedMemory,
+      std::vector<CompareFlags> sortCompareFlags = {},
+      folly::io::CodecType compression = folly::io::CodecType::NO_COMPRESSION,
+      folly::Executor* FOLLY_NULLABLE executor = nullptr,
+      uint64_t localQuotaBytes = 0);
+
+  // Waits for the write in flight, if any.
+  ~SpillFileList();
 
   // Adds 'rows' for the positions in 'indices' into 'this'. The indices
   // must produce a view where the rows are sorted if sorting is desired.
@@ -277,21 +480,71 @@ class SpillFileList {
     return std::move(files_);
   }
 
-  int64_t spilledBytes() const;
+  int64_t spilledBytes() const {
+    return spilledBytes_;
+  }
+
+  // Returns the serialized size of the data written to 'this' before
+  // compression. Equal to spilledBytes() if compression is off.
+  int64_t uncompressedBytes() const {
+    return uncompressedBytes_;
+  }
+
+  // Returns the bytes written and the write time for each prefix of the path.
+  const std::vector<SpillPathStats>& pathStats() const {
+    return pathStats_;
+  }
 
  private:
+  // Result of a write on 'executor_'.
+  struct WriteResult {
+    std::exception_ptr error;
+    uint64_t writeMicros{0};
+  };
+
   // Returns the current file to write to and creates one if needed.
   WriteFile& currentOutput();
+  // True if new files go to the overflow tier.
+  bool localQuotaExceeded() const;
+  // True if the next flush goes to a file in the overflow tier.
+  bool writesToOverflow() const;
   // Writes data from 'batch_' to the current output file.
   void flush();
+  // Waits for 'pendingWrite_' and rethrows its error if any.
+  void waitForWrite();
   const RowTypePtr type_;
   const int32_t numSortingKeys_;
-  const std::string path_;
+  const std::vector<CompareFlags> sortCompareFlags_;
+  const folly::io::CodecType compression_;
+  // Compresses each flushed batch. nullptr if compression is off.
+  const std::unique_ptr<folly::io::Codec> codec_;
+  folly::Executor* FOLLY_NULLABLE const executor_;
+  // The local prefixes followed by the overflow prefixes.
+  std::vector<std::string> prefixes_;
+  size_t numLocalPrefixes_;
+  const uint64_t localQuotaBytes_;
   const uint64_t targetFileSize_;
   memory::MemoryPool& pool_;
   memory::MappedMemory& mappedMemory_;
+  std::vector<SpillPathStats> pathStats_;
+  // Counts the new files for choosing their prefix in round-robin order.
+  // Lists start at different prefixes so that lists with one file also spread
+  // over the directories.
+  size_t nextPrefix_;
+  // Index into 'prefixes_' of the last file of 'files_'.
+  size_t currentPrefix_{0};
+  // Index into 'prefixes_' of the file 'pendingWrite_' writes to.
+  size_t pendingPrefix_{0};
   std::unique_ptr<VectorStreamGroup> batch_;
   std::vector<std::unique_ptr<SpillFile>> files_;
+  // The write of the last flushed batch. Set only if 'executor_' is set.
+  std::shared_ptr<AsyncSource<WriteResult>> pendingWrite_;
+  // Bytes flushed to 'files_'. Counted at flush so that this does not depend on
+  // 'pendingWrite_' being done.
+  int64_t spilledBytes_{0};
+  int64_t uncompressedBytes_{0};
+
+  static std::atomic<uint64_t> nextPrefixCounter_;
 };
 
 // Represents all spilled data of an operator, e.g. order by or group
@@ -299,23 +552,37 @@ class SpillFileList {
 class SpillState {
  public:
   // Constructs a SpillState. 'type' is the content RowType. 'path' is
-  // the file system path prefix. 'bits' is the hash bit field for
+  // the file system path prefix, or a list of them to stripe the files
+  // over, see splitSpillPath(). 'bits' is the hash bit field for
   // partitioning data between files. This also gives the maximum
   // number of partitions. 'numSortingKeys' is the number of leading columns
   // on which the data is sorted, 0 if only hash partitioning is used.
   // 'targetFileSize' is the target size of a single
   // file.  'pool' and 'mappedMemory' own
-  // the memory for state and results.
+  // the memory for state and results. 'sortCompareFlags' gives the sort order
+  // of each sorting key, empty if all are ascending, nulls first.
+  // 'compression' is the codec for compressing the spill files. If 'executor'
+  // is set, the spill files are written and read ahead on 'executor'.
+  // 'localQuotaBytes' is the local spill bytes of the process above which new
+  // files go to the overflow tier of 'path'. 0 means no quota.
   SpillState(
       const std::string& path,
       int32_t maxPartitions,
       int32_t numSortingKeys,
       uint64_t targetFileSize,
       memory::MemoryPool& pool,
-      memory::MappedMemory& mappedMemory)
+      memory::MappedMemory& mappedMemory,
+      std::vector<CompareFlags> sortCompareFlags = {},
+      folly::io::CodecType compression = folly::io::CodecType::NO_COMPRESSION,
+      folly::Executor* FOLLY_NULLABLE executor = nullptr,
+      uint64_t localQuotaBytes = 0)
       : path_(path),
         maxPartitions_(maxPartitions),
         numSortingKeys_(numSortingKeys),
+        sortCompareFlags_(std::move(sortCompareFlags)),
+        compression_(compression),
+        executor_(executor),
+        localQuotaBytes_(localQuotaBytes),
         targetFileSize_(targetFileSize),
         files_(maxPartitions_),
         pool_(pool),
@@ -341,6 +608,10 @@ class SpillState {
     return pool_;
   }
 
+  const std::vector<CompareFlags>& sortCompareFlags() const {
+    return sortCompareFlags_;
+  }
+
   // Appends data to 'partition'. The rows given by 'indices' must be
   // sorted for a sorted spill and must hash to 'partition'. It is
   // safe to call this on multiple threads if all threads specify a
@@ -365,13 +636,28 @@ class SpillState {
     return partition < files_.size() && files_[partition];
   }
 
+  // Finishes writing 'partition' and returns its files. The files are removed
+  // from 'this' and are owned by the caller.
+  std::vector<std::unique_ptr<SpillFile>> files(int32_t partition);
+
   int64_t spilledBytes() const;
 
+  // Returns the size of the spilled data before compression.
+  int64_t spilledUncompressedBytes() const;
+
+  // Returns the bytes written and the write time for each prefix of the path,
+  // summed over the partitions.
+  std::vector<SpillPathStats> pathStats() const;
+
  private:
   const RowTypePtr type_;
   const std::string path_;
   const int32_t maxPartitions_;
   const int32_t numSortingKeys_;
+  const std::vector<CompareFlags> sortCompareFlags_;
+  const folly::io::CodecType compression_;
+  folly::Executor* FOLLY_NULLABLE const executor_;
+  const uint64_t localQuotaBytes_;
   // Number of currently spilling partitions.
   int32_t numPartitions_ = 0;
   const uint64_t targetFileSize_;
@@ -17,6 +17,7 @@
 #include "velox/exec/Spiller.h"
 
 #include "velox/common/base/AsyncSource.h"
+#include "velox/exec/SortKeyEncoder.h"
 
 #include <folly/ScopeGuard.h>
 
@@ -82,11 +83,15 @@ class RowContainerSpillStream : public SpillStream {
       memory::MemoryPool& pool,
       Spiller::SpillRows&& rows,
       Spiller& spiller)
-      : SpillStream(std::move(type), numSortingKeys, pool),
+      : SpillStream(
+            std::move(type),
+            numSortingKeys,
+            pool,
+            spiller.state().sortCompareFlags()),
         rows_(std::move(rows)),
         spiller_(spiller) {
     if (!rows_.empty()) {
-      nextBatch();
+      setNextBatch();
     }
   }
 
@@ -133,12 +138,15 @@ std::unique_ptr<SpillStream> Spiller::spillStreamOverRows(int32_t partition) {
 
 void Spiller::ensureSorted(SpillRun& run) {
   if (!run.sorted) {
-    std::sort(
-        run.rows.begin(),
-        run.rows.end(),
-        [&](const char* left, const char* right) {
-          return container_.compareRows(left, right) < 0;
-        });
+    const auto& flags = state_.sortCompareFlags();
+    SortKeyEncoder(
+        container_.keyTypes(),
+        flags.empty() ? std::vector<CompareFlags>(container_.keyTypes().size())
+                      : flags)
+        .sortRows(
+            container_,
+            folly::Range<char**>(run.rows.data(), run.rows.size()),
+            pool_);
     run.sorted = true;
   }
 }
@@ -159,7 +167,7 @@ std::unique_ptr<Spiller::SpillStatus> Spiller::writeSpill(
     size_t written = 0;
     while (written < run.rows.size()) {
       totalBytes += extractSpillVector(
-          run.rows, 64, kTargetBatchBytes, spillVector, written);
+          run.rows, maxBatchRows_, kTargetBatchBytes, spillVector, written);
       state_.appendToPartition(partition, spillVector);
       if (totalBytes > maxBytes) {
         break;
@@ -240,8 +248,9 @@ void Spiller::spill(
   }
   for (;;) {
     auto rowsLeft = container_.numRows();
-    auto spaceLeft = container_.stringAllocator().retainedSize() -
-        container_.stringAllocator().freeSpace();
+    const auto& stringAllocator = container_.stringAllocator();
+    auto spaceLeft = stringAllocator.retainedSize() -
+        stringAllocator.freeSpace() - stringAllocator.cachedBytes();
     if (!rowsLeft || (rowsLeft <= targetRows && spaceLeft < targetBytes)) {
       return;
     }
@@ -277,6 +286,14 @@ void Spiller::spill(
   }
 }
 
+bool Spiller::releaseRows() {
+  if (spillFinalized_ || !pendingSpillPartitions_.empty()) {
+    return false;
+  }
+  clearSpillRuns();
+  return true;
+}
+
 Spiller::SpillRows Spiller::finishSpill() {
   VELOX_CHECK(!spillFinalized_);
   spillFinalized_ = true;
@@ -35,6 +35,14 @@ class HashBitRange {
     return 1 << (end_ - begin_);
   }
 
+  uint8_t begin() const {
+    return begin_;
+  }
+
+  uint8_t end() const {
+    return end_;
+  }
+
  private:
   // Low bit number of hash number bit range.
   const uint8_t begin_;
@@ -48,6 +56,16 @@ class HashBitRange {
 class Spiller {
  public:
   using SpillRows = std::vector<char*, memory::StlMappedMemoryAllocator<char*>>;
+
+  static constexpr int32_t kDefaultMaxBatchRows = 64;
+
+  // 'sortCompareFlags' gives the sort order of the 'numSortingKeys' leading
+  // keys of a sorted spill. If empty, the keys are sorted ascending, nulls
+  // first. 'compression' is the codec for compressing the spill files.
+  // 'localQuotaBytes' is the local spill bytes of the process above which new
+  // files go to the overflow tier of 'path', see SpillState.
+  // 'maxBatchRows' is the most rows extracted from 'container' into one
+  // serialized batch of a spill file.
   Spiller(
       RowContainer& container,
       RowContainer::Eraser eraser,
@@ -57,7 +75,11 @@ class Spiller {
       const std::string& path,
       int64_t targetFileSize,
       memory::MemoryPool& pool,
-      folly::Executor* executor)
+      folly::Executor* executor,
+      std::vector<CompareFlags> sortCompareFlags = {},
+      folly::io::CodecType compression = folly::io::CodecType::NO_COMPRESSION,
+      uint64_t localQuotaBytes = 0,
+      int32_t maxBatchRows = kDefaultMaxBatchRows)
       : container_(container),
         eraser_(eraser),
         rowType_(std::move(rowType)),
@@ -68,9 +90,16 @@ class Spiller {
             numSortingKeys,
             targetFileSize,
             pool,
-            spillMappedMemory()),
+            spillMappedMemory(),
+            std::move(sortCompareFlags),
+            compression,
+            executor,
+            localQuotaBytes),
+        maxBatchRows_(maxBatchRows),
         pool_(pool),
-        executor_(executor) {}
+        executor_(executor) {
+    VELOX_CHECK_GT(maxBatchRows_, 0);
+  }
 
   // Spills rows from 'this' until there are under 'targetRows' rows
   // and 'targetBytes' of allocated variable length space in
@@ -92,6 +121,12 @@ class Spiller {
     return state_.hasFiles(partition);
   }
 
+  // Drops the pointers to rows of 'container_' that were collected for
+  // spilling so that the rows may move, e.g. by RowContainer::compact().
+  // Returns false and keeps the pointers if rows are still pending to be
+  // written or spilling is finalized.
+  bool releaseRows();
+
   // Finishes spilling and returns the rows that are in partitions that have not
   // started spilling.
   SpillRows finishSpill();
@@ -114,6 +149,16 @@ class Spiller {
         state_.spilledBytes(), spilledRows_);
   }
 
+  // Returns the size of the spilled data before compression.
+  int64_t spilledUncompressedBytes() const {
+    return state_.spilledUncompressedBytes();
+  }
+
+  // Returns the bytes written and the write time for each spill directory.
+  std::vector<SpillPathStats> spillPathStats() const {
+    return state_.pathStats();
+  }
+
   // Extracts the keys, dependents or accumulators for 'rows' into '*result'.
   // Creates '*results' in spillPool() if nullptr. Used from Spiller and
   // RowContainerSpillStream.
@@ -214,6 +259,8 @@ class Spiller {
   const HashBitRange bits_;
   SpillState state_;
 
+  const int32_t maxBatchRows_;
+
   // One spill run for each partition of spillable data.
   std::vector<SpillRun> spillRuns_;
 
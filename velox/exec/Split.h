@@ -22,29 +22,41 @@ namespace facebook::velox::exec {
 struct Split {
   std::shared_ptr<velox::connector::ConnectorSplit> connectorSplit;
   int32_t groupId{-1}; // Bucketed group id (-1 means 'none').
+  // True if the data of the split is expected to be in the local
+  // cache, e.g. as per AsyncDataCache::residency(). The Task runs such
+  // splits before the other queued splits of the same group.
+  bool cached{false};
 
   Split() {}
 
   explicit Split(
       std::shared_ptr<velox::connector::ConnectorSplit>&& connectorSplit,
-      int32_t groupId = -1)
-      : connectorSplit(std::move(connectorSplit)), groupId(groupId) {}
+      int32_t groupId = -1,
+      bool cached = false)
+      : connectorSplit(std::move(connectorSplit)),
+        groupId(groupId),
+        cached(cached) {}
 
   Split(Split&& other)
       : connectorSplit(std::move(other.connectorSplit)),
-        groupId(other.groupId) {}
+        groupId(other.groupId),
+        cached(other.cached) {}
 
   Split(const Split& other)
-      : connectorSplit(other.connectorSplit), groupId(other.groupId) {}
+      : connectorSplit(other.connectorSplit),
+        groupId(other.groupId),
+        cached(other.cached) {}
 
   void operator=(Split&& other) {
     connectorSplit = std::move(other.connectorSplit);
     groupId = other.groupId;
+    cached = other.cached;
   }
 
   void operator=(const Split& other) {
     connectorSplit = other.connectorSplit;
     groupId = other.groupId;
+    cached = other.cached;
   }
 
   inline bool hasConnectorSplit() const {
@@ -57,9 +69,10 @@ struct Split {
 
   std::string toString() const {
     return fmt::format(
-        "[split: [{}] {}]",
+        "[split: [{}] {}{}]",
         hasConnectorSplit() ? connectorSplit->toString() : "NULL",
-        groupId);
+        groupId,
+        cached ? " cached" : "");
   }
 };
 
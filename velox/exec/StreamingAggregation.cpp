@@ -89,6 +89,7 @@ StreamingAggregation::StreamingAggregation(
   }
 
   masks_ = std::make_unique<AggregationMasks>(std::move(maskChannels));
+  evaluationOrder_ = masks_->evaluationOrder(args_);
 
   rows_ = std::make_unique<RowContainer>(
       groupingKeyTypes,
@@ -220,20 +221,30 @@ const SelectivityVector& StreamingAggregation::getSelectivityVector(
 }
 
 void StreamingAggregation::evaluateAggregates() {
-  for (auto i = 0; i < aggregates_.size(); ++i) {
-    auto& aggregate = aggregates_[i];
+  std::vector<VectorPtr> args;
+  std::optional<int32_t> argsIndex;
+  for (auto i : evaluationOrder_) {
+    const auto& rows = getSelectivityVector(i);
+    if (!rows.hasSelections()) {
+      continue;
+    }
 
-    std::vector<VectorPtr> args;
-    for (auto j = 0; j < args_[i].size(); ++j) {
-      if (args_[i][j] == kConstantChannel) {
-        args.push_back(constantArgs_[i][j]);
-      } else {
-        args.push_back(input_->childAt(args_[i][j]));
+    // Aggregates over the same columns are adjacent in 'evaluationOrder_'
+    // and share 'args'.
+    if (!argsIndex.has_value() ||
+        !AggregationMasks::sameInputs(args_[argsIndex.value()], args_[i])) {
+      args.clear();
+      for (auto j = 0; j < args_[i].size(); ++j) {
+        if (args_[i][j] == kConstantChannel) {
+          args.push_back(constantArgs_[i][j]);
+        } else {
+          args.push_back(input_->childAt(args_[i][j]));
+        }
       }
+      argsIndex = i;
     }
 
-    const auto& rows = getSelectivityVector(i);
-
+    auto& aggregate = aggregates_[i];
     if (isRawInput(step_)) {
       aggregate->addRawInput(inputGroups_.data(), rows, args, false);
     } else {
@@ -76,6 +76,9 @@ class StreamingAggregation : public Operator {
   std::unique_ptr<AggregationMasks> masks_;
   std::vector<std::vector<column_index_t>> args_;
   std::vector<std::vector<VectorPtr>> constantArgs_;
+  // Indices of 'aggregates_' grouped by mask and arguments. See
+  // AggregationMasks::evaluationOrder().
+  std::vector<int32_t> evaluationOrder_;
   std::vector<DecodedVector> decodedKeys_;
 
   // Storage of grouping keys and accumulators.
@@ -34,6 +34,12 @@ TableScan::TableScan(
       columnHandles_(tableScanNode->assignments()),
       driverCtx_(driverCtx) {
   connector_ = connector::getConnector(tableHandle_->connectorId());
+  if (connector_->supportsSplitPreload() && connector_->executor()) {
+    maxPreloadedSplits_ = driverCtx_->queryConfig().maxSplitPreloadPerDriver();
+    if (maxPreloadedSplits_ > 0) {
+      splitPreloader_ = makeSplitPreloader();
+    }
+  }
 }
 
 RowVectorPtr TableScan::getOutput() {
@@ -41,11 +47,28 @@ RowVectorPtr TableScan::getOutput() {
     return nullptr;
   }
 
+  if (!rowLimitChecked_) {
+    rowLimitChecked_ = true;
+    rowLimit_ = operatorCtx_->driver()->pushdownRowLimit(this);
+    if (rowLimit_.has_value()) {
+      // Preloaded DataSources would be made without the limit and read
+      // splits that are not needed.
+      maxPreloadedSplits_ = 0;
+      stats().addRuntimeStat("pushdownRowLimit", RuntimeCounter(*rowLimit_));
+    }
+  }
+
   for (;;) {
     if (needNewSplit_) {
       exec::Split split;
       blockingReason_ = driverCtx_->task->getSplitOrFuture(
-          driverCtx_->splitGroupId, planNodeId(), split, blockingFuture_);
+          driverCtx_->splitGroupId,
+          planNodeId(),
+          split,
+          blockingFuture_,
+          maxPreloadedSplits_,
+          splitPreloader_,
+          driverCtx_->elastic);
       if (blockingReason_ != BlockingReason::kNotBlocked) {
         return nullptr;
       }
@@ -64,20 +87,31 @@ RowVectorPtr TableScan::getOutput() {
             }
             stats_.runtimeStats.at(name).addValue(counter.value);
           }
+          for (const auto& [name, metric] :
+               dataSource_->runtimeHistograms()) {
+            stats_.addRuntimeStat(name, metric);
+          }
         }
         return nullptr;
       }
 
       const auto& connectorSplit = split.connectorSplit;
       needNewSplit_ = false;
+      Task::maybeAddElasticDriver(
+          operatorCtx_->task(),
+          driverCtx_->pipelineId,
+          planNodeId(),
+          stats().getOutputTiming);
 
       VELOX_CHECK(
           connector_->connectorId() == connectorSplit->connectorId,
           "Got splits with different connector IDs");
 
       if (!dataSource_) {
-        connectorQueryCtx_ = operatorCtx_->createConnectorQueryCtx(
-            connectorSplit->connectorId, planNodeId());
+        if (!connectorQueryCtx_) {
+          connectorQueryCtx_ = operatorCtx_->createConnectorQueryCtx(
+              connectorSplit->connectorId, planNodeId());
+        }
         dataSource_ = connector_->createDataSource(
             outputType_,
             tableHandle_,
@@ -87,13 +121,48 @@ RowVectorPtr TableScan::getOutput() {
           dataSource_->addDynamicFilter(entry.first, entry.second);
         }
         pendingDynamicFilters_.clear();
+        if (rowLimit_.has_value()) {
+          dataSource_->setRowLimit(*rowLimit_);
+        }
       }
 
       debugString_ = fmt::format(
           "Split {} Task {}",
           connectorSplit->toString(),
           operatorCtx_->task()->taskId());
-      dataSource_->addSplit(connectorSplit);
+      pendingSplitOpenedAsync_ = false;
+      if (!connectorSplit->dataSource && splitPreloader_) {
+        // Opens the split on the connector's executor so that the Driver
+        // thread is not held while the file metadata is read.
+        splitPreloader_(connectorSplit);
+        pendingSplitOpenedAsync_ = true;
+      }
+      pendingSplit_ = connectorSplit;
+    }
+
+    if (pendingSplit_) {
+      auto& source = pendingSplit_->dataSource;
+      if (source && !source->readyOrFuture(&blockingFuture_)) {
+        // The DataSource is being made on the executor. Waits for it off
+        // thread instead of blocking in move().
+        stats().addRuntimeStat("splitOpenWaits", RuntimeCounter(1));
+        blockingReason_ = BlockingReason::kWaitForConnector;
+        return nullptr;
+      }
+      std::unique_ptr<std::shared_ptr<connector::DataSource>> preloaded;
+      if (source) {
+        preloaded = source->move();
+        source.reset();
+      }
+      if (preloaded) {
+        dataSource_->setFromDataSource(std::move(*preloaded));
+        stats().addRuntimeStat(
+            pendingSplitOpenedAsync_ ? "asyncOpenedSplits" : "preloadedSplits",
+            RuntimeCounter(1));
+      } else {
+        dataSource_->addSplit(pendingSplit_);
+      }
+      pendingSplit_.reset();
       ++stats_.numSplits;
       setBatchSize();
     }
@@ -133,22 +202,63 @@ RowVectorPtr TableScan::getOutput() {
   }
 }
 
+std::function<void(std::shared_ptr<connector::ConnectorSplit>)>
+TableScan::makeSplitPreloader() {
+  connectorQueryCtx_ = operatorCtx_->createConnectorQueryCtx(
+      tableHandle_->connectorId(), planNodeId());
+  // The DataSource may be made after 'this' is gone, so the lambdas hold
+  // what they need. The Task owns the memory pools. The Task is held weakly
+  // since the splits it queues hold the lambdas.
+  using DataSourcePtr = std::shared_ptr<connector::DataSource>;
+  return [type = outputType_,
+          table = tableHandle_,
+          columns = columnHandles_,
+          connector = connector_,
+          ctx = connectorQueryCtx_,
+          weakTask = std::weak_ptr<Task>(operatorCtx_->task())](
+             std::shared_ptr<connector::ConnectorSplit> split) {
+    split->dataSource = std::make_shared<AsyncSource<DataSourcePtr>>(
+        [type,
+         table,
+         columns,
+         connector,
+         ctx,
+         weakTask,
+         weakSplit = std::weak_ptr<connector::ConnectorSplit>(split)]()
+            -> std::unique_ptr<DataSourcePtr> {
+          auto split = weakSplit.lock();
+          auto task = weakTask.lock();
+          if (!split || split->cancelled || !task ||
+              task->state() != TaskState::kRunning) {
+            return nullptr;
+          }
+          try {
+            auto dataSource =
+                connector->createDataSource(type, table, columns, ctx.get());
+            dataSource->addSplit(split);
+            return std::make_unique<DataSourcePtr>(std::move(dataSource));
+          } catch (const std::exception& e) {
+            // The scan adds the split itself and gets the error then.
+            LOG(WARNING) << "Failed to preload split: " << e.what();
+            return nullptr;
+          }
+        });
+    connector->executor()->add(
+        [source = split->dataSource]() { source->prepare(); });
+  };
+}
+
 bool TableScan::isFinished() {
   return noMoreSplits_;
 }
 
 void TableScan::setBatchSize() {
-  constexpr int64_t kMB = 1 << 20;
   auto estimate = dataSource_->estimatedRowSize();
   if (estimate == connector::DataSource::kUnknownRowSize) {
     readBatchSize_ = kDefaultBatchSize;
     return;
   }
-  if (estimate < 1024) {
-    readBatchSize_ = 10000; // No more than 10MB of data per batch.
-    return;
-  }
-  readBatchSize_ = std::min<int64_t>(100, 10 * kMB / estimate);
+  readBatchSize_ = outputBatchRows(estimate);
 }
 
 void TableScan::addDynamicFilter(
@@ -157,7 +267,13 @@ void TableScan::addDynamicFilter(
   if (dataSource_) {
     dataSource_->addDynamicFilter(outputChannel, filter);
   } else {
-    pendingDynamicFilters_.emplace(outputChannel, filter);
+    auto it = pendingDynamicFilters_.find(outputChannel);
+    if (it == pendingDynamicFilters_.end()) {
+      pendingDynamicFilters_.emplace(outputChannel, filter);
+    } else {
+      // A later filter on the same column, e.g. a tighter TopN threshold.
+      it->second = it->second->mergeWith(filter.get());
+    }
   }
 }
 
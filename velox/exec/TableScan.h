@@ -50,9 +50,18 @@ class TableScan : public SourceOperator {
  private:
   static constexpr int32_t kDefaultBatchSize = 1024;
 
-  // Adjust batch size according to split information.
+  // Sets 'readBatchSize_' for batches of about
+  // QueryConfig::preferredOutputBatchBytes() given the row size estimate of
+  // the DataSource.
   void setBatchSize();
 
+  // Returns a function that sets 'split->dataSource' to a DataSource with
+  // 'split' added and schedules making it on the connector's executor. The
+  // function does not refer to 'this', so that the Task can call it for
+  // splits that arrive at any time.
+  std::function<void(std::shared_ptr<connector::ConnectorSplit>)>
+  makeSplitPreloader();
+
   const std::shared_ptr<connector::ConnectorTableHandle> tableHandle_;
   const std::
       unordered_map<std::string, std::shared_ptr<connector::ColumnHandle>>
@@ -70,6 +79,27 @@ class TableScan : public SourceOperator {
       pendingDynamicFilters_;
   int32_t readBatchSize_{kDefaultBatchSize};
 
+  // Number of splits to preload after the current one. 0 if the
+  // connector does not support split preload.
+  int32_t maxPreloadedSplits_{0};
+  // See makeSplitPreloader(). Passed to Task::getSplitOrFuture().
+  std::function<void(std::shared_ptr<connector::ConnectorSplit>)>
+      splitPreloader_;
+
+  // Split taken from the Task and not yet added to 'dataSource_'. Kept
+  // while waiting for its DataSource to be made on the connector's
+  // executor.
+  std::shared_ptr<connector::ConnectorSplit> pendingSplit_;
+  // True if 'pendingSplit_' is opened on the executor by 'this' rather than
+  // preloaded by the Task.
+  bool pendingSplitOpenedAsync_{false};
+
+  // The rows the operators after 'this' need at most, e.g. when 'this' feeds
+  // a Limit. Passed to the DataSource so that it reads no more than that.
+  // Found on the first getOutput() since the Driver is not set up before.
+  bool rowLimitChecked_{false};
+  std::optional<int64_t> rowLimit_;
+
   // String shown in ExceptionContext inside DataSource and LazyVector loading.
   std::string debugString_;
 };
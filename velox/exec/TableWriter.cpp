@@ -36,9 +36,8 @@ TableWriter::TableWriter(
       driverCtx_(driverCtx),
       insertTableHandle_(
           tableWriteNode->insertTableHandle()->connectorInsertTableHandle()) {
-  // For the time being the table writer supports one file
-  // To extend it we can create a new data sink for each
-  // partition
+  // The DataSink routes the rows of partitioned and bucketed tables to a
+  // writer per partition and bucket.
   const auto& connectorId = tableWriteNode->insertTableHandle()->connectorId();
   connector_ = connector::getConnector(connectorId);
   connectorQueryCtx_ =
@@ -26,6 +26,7 @@
 #include "velox/exec/Merge.h"
 #include "velox/exec/PartitionedOutputBufferManager.h"
 #include "velox/exec/Task.h"
+#include "velox/exec/TopN.h"
 #if CODEGEN_ENABLED == 1
 #include "velox/experimental/codegen/CodegenLogger.h"
 #endif
@@ -144,7 +145,13 @@ Task::Task(
       consumerSupplier_(std::move(consumerSupplier)),
       onError_(onError),
       pool_(queryCtx_->pool()->addScopedChild("task_root")),
-      bufferManager_(PartitionedOutputBufferManager::getInstance()) {}
+      bufferManager_(PartitionedOutputBufferManager::getInstance()) {
+  auto sampleBytes = queryCtx_->config().heapProfileSampleBytes();
+  if (sampleBytes > 0) {
+    pool_->setHeapProfiler(
+        std::make_shared<memory::HeapProfiler>(sampleBytes));
+  }
+}
 
 Task::~Task() {
   try {
@@ -170,8 +177,10 @@ velox::memory::MemoryPool* FOLLY_NONNULL Task::addDriverPool() {
 }
 
 velox::memory::MemoryPool* FOLLY_NONNULL
-Task::addOperatorPool(velox::memory::MemoryPool* FOLLY_NONNULL driverPool) {
-  childPools_.push_back(driverPool->addScopedChild("operator_ctx"));
+Task::addOperatorPool(
+    velox::memory::MemoryPool* FOLLY_NONNULL driverPool,
+    const std::string& name) {
+  childPools_.push_back(driverPool->addScopedChild(name));
   return childPools_.back().get();
 }
 
@@ -189,7 +198,8 @@ bool Task::supportsSingleThreadedExecution() const {
     return false;
   }
 
-  LocalPlanner::plan(planFragment_, nullptr, &driverFactories, 1);
+  LocalPlanner::plan(
+      planFragment_, nullptr, &driverFactories, queryCtx_->config(), 1);
 
   for (const auto& factory : driverFactories) {
     if (!factory->supportsSingleThreadedExecution()) {
@@ -222,7 +232,8 @@ RowVectorPtr Task::next() {
         consumerSupplier_,
         "Single-threaded execution doesn't support delivering results to a callback");
 
-    LocalPlanner::plan(planFragment_, nullptr, &driverFactories_, 1);
+    LocalPlanner::plan(
+        planFragment_, nullptr, &driverFactories_, queryCtx_->config(), 1);
 
     exchangeClients_.resize(driverFactories_.size());
 
@@ -332,6 +343,7 @@ void Task::start(
       self->planFragment_,
       self->consumerSupplier(),
       &self->driverFactories_,
+      self->queryCtx()->config(),
       maxDrivers);
 
   // Keep one exchange client per pipeline (NULL if not used).
@@ -351,7 +363,10 @@ void Task::start(
     self->numTotalDrivers_ += factory->numTotalDrivers;
     self->taskStats_.pipelineStats.emplace_back(
         factory->inputDriver, factory->outputDriver);
+    self->elasticPipelines_.push_back(
+        self->isUngroupedExecution() && factory->supportsElasticDrivers());
   }
+  self->numElasticDrivers_.resize(numPipelines);
 
   // Register self for possible memory recovery callback. Do this
   // after sizing 'drivers_' but before starting the
@@ -433,6 +448,27 @@ void Task::start(
   }
 }
 
+uint64_t Task::reclaimableBytes() const {
+  std::lock_guard<std::mutex> l(mutex_);
+  uint64_t bytes = 0;
+  for (const auto& driver : drivers_) {
+    if (driver && !driver->isOnThread() && !driver->isTerminated()) {
+      bytes += driver->reclaimableBytes();
+    }
+  }
+  return bytes;
+}
+
+void Task::reclaim() {
+  std::lock_guard<std::mutex> l(mutex_);
+  VELOX_CHECK(pauseRequested_, "Task must be paused for reclaim");
+  for (auto& driver : drivers_) {
+    if (driver && !driver->isOnThread() && !driver->isTerminated()) {
+      driver->reclaim();
+    }
+  }
+}
+
 // static
 void Task::resume(std::shared_ptr<Task> self) {
   VELOX_CHECK(!self->exception_, "Cannot resume failed task");
@@ -510,6 +546,9 @@ void Task::createDriversLocked(
                 ? self->driverFactories_[i]->numTotalDrivers
                 : 0;
           }));
+      if (const auto& trace = out.back()->trace()) {
+        self->driverTraces_.push_back(trace);
+      }
       ++splitGroupState.numRunningDrivers;
     }
   }
@@ -598,6 +637,70 @@ void Task::removeDriver(std::shared_ptr<Task> self, Driver* driver) {
   }
 }
 
+// static
+void Task::maybeAddElasticDriver(
+    std::shared_ptr<Task> self,
+    uint32_t pipelineId,
+    const core::PlanNodeId& planNodeId,
+    const CpuWallTiming& timing) {
+  const auto& config = self->queryCtx_->config();
+  const auto maxElasticDrivers = config.maxElasticDriversPerPipeline();
+  if (maxElasticDrivers <= 0 || timing.wallNanos == 0 ||
+      timing.cpuNanos * 100 >=
+          timing.wallNanos * config.elasticDriverMaxCpuPct()) {
+    return;
+  }
+  std::shared_ptr<Driver> driver;
+  {
+    std::lock_guard<std::mutex> l(self->mutex_);
+    if (!self->isRunningLocked() || self->pauseRequested_ ||
+        pipelineId >= self->elasticPipelines_.size() ||
+        !self->elasticPipelines_[pipelineId] ||
+        self->numElasticDrivers_[pipelineId] >= maxElasticDrivers) {
+      return;
+    }
+    auto& factory = self->driverFactories_[pipelineId];
+    const auto& splitsStore =
+        self->splitsStates_[planNodeId].groupSplitsStores[0];
+    if (splitsStore.splits.size() <= factory->numDrivers) {
+      return;
+    }
+
+    // The new Driver takes the next partition and driver id of the pipeline.
+    const auto partitionId = factory->numDrivers;
+    auto ctx = std::make_unique<DriverCtx>(
+        self, partitionId, pipelineId, 0, partitionId);
+    ctx->elastic = true;
+    driver = factory->createDriver(
+        std::move(ctx), self->exchangeClients_[pipelineId], [self](size_t i) {
+          return i < self->driverFactories_.size()
+              ? self->driverFactories_[i]->numTotalDrivers
+              : 0;
+        });
+    if (const auto& trace = driver->trace()) {
+      self->driverTraces_.push_back(trace);
+    }
+    ++factory->numDrivers;
+    ++factory->numTotalDrivers;
+    ++self->numElasticDrivers_[pipelineId];
+    ++self->numDriversPerSplitGroup_;
+    ++self->numTotalDrivers_;
+    ++self->splitGroupStates_[0].numRunningDrivers;
+    if (factory->needsPartitionedOutput()) {
+      // The buffer is not done while the calling Driver runs, so adding one
+      // more producer is safe.
+      ++self->numDriversInPartitionedOutput_;
+      if (auto bufferManager = self->bufferManager_.lock()) {
+        bufferManager->updateNumDrivers(
+            self->taskId_, self->numDriversInPartitionedOutput_);
+      }
+    }
+    self->drivers_.push_back(driver);
+    ++self->numRunningDrivers_;
+  }
+  Driver::enqueue(driver);
+}
+
 void Task::ensureSplitGroupsAreBeingProcessedLocked(
     std::shared_ptr<Task>& self) {
   // Only try creating more drivers if we are running.
@@ -727,7 +830,26 @@ std::unique_ptr<ContinuePromise> Task::addSplitLocked(
 std::unique_ptr<ContinuePromise> Task::addSplitToStoreLocked(
     SplitsStore& splitsStore,
     exec::Split&& split) {
-  splitsStore.splits.push_back(split);
+  int32_t position;
+  if (split.cached) {
+    // Goes after the cached splits that arrived before it.
+    position = splitsStore.numCachedSplits;
+    splitsStore.splits.insert(
+        splitsStore.splits.begin() + position, std::move(split));
+    ++splitsStore.numCachedSplits;
+  } else {
+    position = splitsStore.splits.size();
+    splitsStore.splits.push_back(std::move(split));
+  }
+  if (splitsStore.preload && splitsStore.splitPromises.empty() &&
+      position < splitsStore.maxPreloadSplits) {
+    // No scan is waiting, so the split would otherwise wait in the queue
+    // until the current split of a scan is done.
+    auto& connectorSplit = splitsStore.splits[position].connectorSplit;
+    if (connectorSplit && !connectorSplit->dataSource) {
+      splitsStore.preload(connectorSplit);
+    }
+  }
   if (not splitsStore.splitPromises.empty()) {
     auto promise = std::make_unique<ContinuePromise>(
         std::move(splitsStore.splitPromises.back()));
@@ -843,26 +965,48 @@ BlockingReason Task::getSplitOrFuture(
     uint32_t splitGroupId,
     const core::PlanNodeId& planNodeId,
     exec::Split& split,
-    ContinueFuture& future) {
+    ContinueFuture& future,
+    int32_t maxPreloadSplits,
+    const std::function<void(std::shared_ptr<connector::ConnectorSplit>)>&
+        preload,
+    bool retireIfNoSplits) {
   std::lock_guard<std::mutex> l(mutex_);
 
   auto& splitsState = splitsStates_[planNodeId];
 
   if (isUngroupedExecution()) {
     return getSplitOrFutureLocked(
-        splitsState.groupSplitsStores[0], split, future);
+        splitsState.groupSplitsStores[0],
+        split,
+        future,
+        maxPreloadSplits,
+        preload,
+        retireIfNoSplits);
   } else {
     return getSplitOrFutureLocked(
-        splitsState.groupSplitsStores[splitGroupId], split, future);
+        splitsState.groupSplitsStores[splitGroupId],
+        split,
+        future,
+        maxPreloadSplits,
+        preload,
+        retireIfNoSplits);
   }
 }
 
 BlockingReason Task::getSplitOrFutureLocked(
     SplitsStore& splitsStore,
     exec::Split& split,
-    ContinueFuture& future) {
+    ContinueFuture& future,
+    int32_t maxPreloadSplits,
+    const std::function<void(std::shared_ptr<connector::ConnectorSplit>)>&
+        preload,
+    bool retireIfNoSplits) {
+  if (preload && !splitsStore.preload) {
+    splitsStore.maxPreloadSplits = maxPreloadSplits;
+    splitsStore.preload = preload;
+  }
   if (splitsStore.splits.empty()) {
-    if (splitsStore.noMoreSplits) {
+    if (splitsStore.noMoreSplits || retireIfNoSplits) {
       return BlockingReason::kNotBlocked;
     }
     auto [splitPromise, splitFuture] = makeVeloxContinuePromiseContract(
@@ -874,6 +1018,22 @@ BlockingReason Task::getSplitOrFutureLocked(
 
   split = std::move(splitsStore.splits.front());
   splitsStore.splits.pop_front();
+  if (splitsStore.numCachedSplits > 0) {
+    --splitsStore.numCachedSplits;
+  }
+
+  if (preload) {
+    // 'preload' only schedules the work, so it is cheap to call inside
+    // 'mutex_'.
+    for (auto i = 0;
+         i < std::min<int32_t>(maxPreloadSplits, splitsStore.splits.size());
+         ++i) {
+      auto& connectorSplit = splitsStore.splits[i].connectorSplit;
+      if (connectorSplit && !connectorSplit->dataSource) {
+        preload(connectorSplit);
+      }
+    }
+  }
 
   --taskStats_.numQueuedSplits;
   ++taskStats_.numRunningSplits;
@@ -1069,6 +1229,19 @@ std::shared_ptr<JoinBridge> Task::getCustomJoinBridge(
   return getJoinBridgeInternal<JoinBridge>(splitGroupId, planNodeId);
 }
 
+std::shared_ptr<TopNThreshold> Task::getTopNThreshold(
+    uint32_t splitGroupId,
+    const core::PlanNodeId& planNodeId,
+    int32_t keySize) {
+  std::lock_guard<std::mutex> l(mutex_);
+  auto& threshold = splitGroupStates_[splitGroupId].topNThresholds[planNodeId];
+  if (!threshold) {
+    threshold = std::make_shared<TopNThreshold>(keySize);
+  }
+  VELOX_CHECK_EQ(threshold->keySize(), keySize);
+  return threshold;
+}
+
 void Task::addCrossJoinBridgesLocked(
     uint32_t splitGroupId,
     const std::vector<core::PlanNodeId>& planNodeIds) {
@@ -1262,6 +1435,11 @@ void Task::addOperatorStats(OperatorStats& stats) {
   stats.clear();
 }
 
+void Task::addDriverTimingStats(const DriverTimingStats& stats) {
+  std::lock_guard<std::mutex> l(mutex_);
+  taskStats_.driverTiming.add(stats);
+}
+
 uint64_t Task::timeSinceStartMs() const {
   std::lock_guard<std::mutex> l(mutex_);
   if (taskStats_.executionStartTimeMs == 0UL) {
@@ -1444,6 +1622,18 @@ void Task::setError(const std::exception_ptr& exception) {
       isFirstError = true;
     }
   }
+  if (isFirstError && pool_->getHeapProfiler()) {
+    try {
+      std::rethrow_exception(exception);
+    } catch (const VeloxRuntimeError& e) {
+      if (e.errorCode() == error_code::kMemCapExceeded.c_str()) {
+        LOG(ERROR) << "Task " << taskId_
+                   << " exceeded its memory cap. Heap profile:\n"
+                   << heapProfile();
+      }
+    } catch (...) {
+    }
+  }
   if (isFirstError) {
     terminate(TaskState::kFailed);
   }
@@ -1462,6 +1652,20 @@ void Task::setError(const std::string& message) {
   }
 }
 
+std::string Task::driverTraceJson() const {
+  std::vector<std::shared_ptr<DriverTrace>> traces;
+  {
+    std::lock_guard<std::mutex> l(mutex_);
+    traces = driverTraces_;
+  }
+  return DriverTrace::toChromeTrace(traces);
+}
+
+std::string Task::heapProfile() const {
+  auto& profiler = pool_->getHeapProfiler();
+  return profiler ? profiler->toString() : "";
+}
+
 std::string Task::errorMessage() const {
   std::lock_guard<std::mutex> l(mutex_);
   if (!exception_) {
@@ -162,7 +162,9 @@ class Task : public std::enable_shared_from_this<Task> {
       long sequenceId);
 
   // Adds split for a source operator corresponding to plan node with
-  // specified ID. Does not require sequential id.
+  // specified ID. Does not require sequential id. A split with 'cached'
+  // set is queued after the other cached splits but before the rest, so
+  // that splits with locally cached data run first.
   // Note that, the operation is silently ignored if Task is not running.
   void addSplit(const core::PlanNodeId& planNodeId, exec::Split&& split);
 
@@ -220,6 +222,17 @@ class Task : public std::enable_shared_from_this<Task> {
     return taskStats_;
   }
 
+  /// Returns the timelines of all Drivers 'this' has run as JSON in the
+  /// Chrome trace event format. Has no events unless
+  /// QueryConfig::kDriverTraceEnabled is set. Meant to be called after 'this'
+  /// finished, since running Drivers may be adding events.
+  std::string driverTraceJson() const;
+
+  /// Returns the live allocations of the memory pools of 'this' by operator
+  /// and stack, estimated from samples. Empty unless
+  /// QueryConfig::kHeapProfileSampleBytes is set.
+  std::string heapProfile() const;
+
   /// Returns time (ms) since the task execution started or zero, if not
   /// started.
   uint64_t timeSinceStartMs() const;
@@ -233,6 +246,15 @@ class Task : public std::enable_shared_from_this<Task> {
     return numDrivers(getOutputPipelineId());
   }
 
+  /// Returns the memory the Drivers of 'this' that are off thread could free
+  /// by spilling. Meant to be called while 'this' is paused. Drivers in a
+  /// suspended section are skipped since they may be inside an operator.
+  uint64_t reclaimableBytes() const;
+
+  /// Makes the Drivers of 'this' that are off thread spill their operators'
+  /// reclaimable memory. Must only be called while 'this' is paused.
+  void reclaim();
+
   /// Returns the number of running drivers.
   uint32_t numRunningDrivers() const {
     std::lock_guard<std::mutex> taskLock(mutex_);
@@ -260,8 +282,9 @@ class Task : public std::enable_shared_from_this<Task> {
   /// Creates new instance of MemoryPool, stores it in the task to ensure
   /// lifetime and returns a raw pointer. Not thread safe, e.g. must be called
   /// from the Operator's constructor.
-  memory::MemoryPool* FOLLY_NONNULL
-  addOperatorPool(memory::MemoryPool* FOLLY_NONNULL driverPool);
+  memory::MemoryPool* FOLLY_NONNULL addOperatorPool(
+      memory::MemoryPool* FOLLY_NONNULL driverPool,
+      const std::string& name = "operator_ctx");
 
   /// Creates new instance of MappedMemory, stores it in the task to ensure
   /// lifetime and returns a raw pointer. Not thread safe, e.g. must be called
@@ -277,16 +300,40 @@ class Task : public std::enable_shared_from_this<Task> {
       std::shared_ptr<Task> self,
       Driver* FOLLY_NONNULL instance);
 
+  /// Adds a Driver to 'pipelineId' of 'self' if the pipeline supports
+  /// elastic Drivers, QueryConfig::kMaxElasticDriversPerPipeline allows one
+  /// more, 'planNodeId' has more queued splits than the pipeline has Drivers
+  /// and 'timing' of the calling source shows less than
+  /// QueryConfig::kElasticDriverMaxCpuPct of its wall time on CPU. Called by
+  /// a TableScan after taking a split. Only for ungrouped execution.
+  static void maybeAddElasticDriver(
+      std::shared_ptr<Task> self,
+      uint32_t pipelineId,
+      const core::PlanNodeId& planNodeId,
+      const CpuWallTiming& timing);
+
   // Returns a split for the source operator corresponding to plan node with
   // specified ID. If there are no splits and no-more-splits signal has been
   // received, sets split to null and returns kNotBlocked. Otherwise, returns
   // kWaitForSplit and sets a future that will complete when split becomes
   // available or no-more-splits signal is received.
+  /// Gets the next split for 'planNodeId'. If 'maxPreloadSplits' is
+  /// not 0, calls 'preload' on up to that many of the queued splits after
+  /// the returned one that have no prepared DataSource yet. The Task keeps
+  /// 'preload' to also preload splits that arrive later, so 'preload' must
+  /// not refer to the calling operator. If 'retireIfNoSplits' is true and no
+  /// split is queued, sets split to null and returns kNotBlocked as if
+  /// no-more-splits was received, so that an elastic Driver finishes
+  /// instead of waiting.
   BlockingReason getSplitOrFuture(
       uint32_t splitGroupId,
       const core::PlanNodeId& planNodeId,
       exec::Split& split,
-      ContinueFuture& future);
+      ContinueFuture& future,
+      int32_t maxPreloadSplits = 0,
+      const std::function<void(std::shared_ptr<connector::ConnectorSplit>)>&
+          preload = nullptr,
+      bool retireIfNoSplits = false);
 
   void splitFinished();
 
@@ -386,6 +433,14 @@ class Task : public std::enable_shared_from_this<Task> {
       uint32_t splitGroupId,
       const core::PlanNodeId& planNodeId);
 
+  // Returns the threshold shared by the TopN operators of 'planNodeId' in
+  // all Drivers of 'splitGroupId'. Makes the threshold for encoded sort
+  // keys of 'keySize' bytes on first call.
+  std::shared_ptr<TopNThreshold> getTopNThreshold(
+      uint32_t splitGroupId,
+      const core::PlanNodeId& planNodeId,
+      int32_t keySize);
+
   // Transitions this to kFinished state if all Drivers are
   // finished. Otherwise sets a flag so that the last Driver to finish
   // will transition the state.
@@ -395,6 +450,10 @@ class Task : public std::enable_shared_from_this<Task> {
   // the Task stats. Clears 'stats'.
   void addOperatorStats(OperatorStats& stats);
 
+  // Adds the queued, running and blocked time of a finished Driver to the
+  // Task stats.
+  void addDriverTimingStats(const DriverTimingStats& stats);
+
   // Returns kNone if no pause or terminate is requested. The thread count is
   // incremented if kNone is returned. If something else is returned the
   // calling thread should unwind and return itself to its pool.
@@ -487,7 +546,11 @@ class Task : public std::enable_shared_from_this<Task> {
   BlockingReason getSplitOrFutureLocked(
       SplitsStore& splitsStore,
       exec::Split& split,
-      ContinueFuture& future);
+      ContinueFuture& future,
+      int32_t maxPreloadSplits,
+      const std::function<void(std::shared_ptr<connector::ConnectorSplit>)>&
+          preload,
+      bool retireIfNoSplits);
 
   /// Creates for the given split group and fills up the 'SplitGroupState'
   /// structure, which stores inter-operator state (local exchange, bridges).
@@ -660,6 +723,12 @@ class Task : public std::enable_shared_from_this<Task> {
   /// The number of splits groups we run concurrently.
   uint32_t concurrentSplitGroups_{1};
 
+  /// Per pipeline, true if Drivers can be added while running. See
+  /// maybeAddElasticDriver().
+  std::vector<bool> elasticPipelines_;
+  /// Per pipeline, number of Drivers added by maybeAddElasticDriver().
+  std::vector<uint32_t> numElasticDrivers_;
+
   /// Have we initialized operators' stats already?
   bool initializedOpStats_{false};
   /// How many splits groups we are processing at the moment. Used to control
@@ -684,6 +753,10 @@ class Task : public std::enable_shared_from_this<Task> {
   std::vector<ContinuePromise> stateChangePromises_;
 
   TaskStats taskStats_;
+
+  // Traces of the Drivers 'this' has created. Outlive the Drivers.
+  std::vector<std::shared_ptr<DriverTrace>> driverTraces_;
+
   std::unique_ptr<memory::MemoryPool> pool_;
 
   // Keep driver and operator memory pools alive for the duration of the task to
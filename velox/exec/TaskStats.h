@@ -15,6 +15,8 @@
  */
 #pragma once
 
+#include <string>
+#include <unordered_map>
 #include <unordered_set>
 
 namespace facebook::velox::exec {
@@ -38,6 +40,30 @@ struct PipelineStats {
       : inputPipeline{_inputPipeline}, outputPipeline{_outputPipeline} {}
 };
 
+/// Where the Drivers of a task spent their wall time. Shows whether a slow
+/// task was starved for threads, busy on CPU or waiting, and for what.
+struct DriverTimingStats {
+  // Time from being enqueued on the executor to getting a thread.
+  uint64_t queuedWallNanos{0};
+
+  // Time on thread and the thread CPU time used in it.
+  uint64_t runningWallNanos{0};
+  uint64_t runningCpuNanos{0};
+
+  // Time from blocking to being unblocked, keyed by the name of the
+  // BlockingReason, e.g. "kWaitForExchange".
+  std::unordered_map<std::string, uint64_t> blockedWallNanos;
+
+  void add(const DriverTimingStats& other) {
+    queuedWallNanos += other.queuedWallNanos;
+    runningWallNanos += other.runningWallNanos;
+    runningCpuNanos += other.runningCpuNanos;
+    for (const auto& [reason, nanos] : other.blockedWallNanos) {
+      blockedWallNanos[reason] += nanos;
+    }
+  }
+};
+
 /// Stores execution stats per task.
 struct TaskStats {
   int32_t numTotalSplits{0};
@@ -51,6 +77,9 @@ struct TaskStats {
   // processed Splits for Drivers of this pipeline.
   std::vector<PipelineStats> pipelineStats;
 
+  // Sum over the finished Drivers of the task.
+  DriverTimingStats driverTiming;
+
   // Epoch time (ms) when task starts to run
   uint64_t executionStartTimeMs{0};
 
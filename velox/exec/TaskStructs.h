@@ -14,6 +14,7 @@
  * limitations under the License.
  */
 #pragma once
+#include <functional>
 #include <limits>
 #include <unordered_set>
 #include <vector>
@@ -27,6 +28,7 @@ class LocalExchangeSource;
 class MergeSource;
 class MergeJoinSource;
 class Split;
+class TopNThreshold;
 
 /// Corresponds to Presto TaskState, needed for reporting query completion.
 enum TaskState { kRunning, kFinished, kCanceled, kAborted, kFailed };
@@ -41,10 +43,18 @@ struct BarrierState {
 struct SplitsStore {
   /// Arrived (added), but not distributed yet, splits.
   std::deque<exec::Split> splits;
+  /// Number of splits with 'cached' set at the front of 'splits'. These
+  /// are distributed first, in the order they arrived.
+  int32_t numCachedSplits{0};
   /// Signal, that no more splits will arrive.
   bool noMoreSplits{false};
   /// Blocking promises given out when out of splits to distribute.
   std::vector<ContinuePromise> splitPromises;
+  /// Set from the first getSplitOrFuture() that asks for split preload.
+  /// Splits that arrive while the scan is busy with a split are preloaded
+  /// on arrival if they are among the first 'maxPreloadSplits' queued ones.
+  int32_t maxPreloadSplits{0};
+  std::function<void(std::shared_ptr<connector::ConnectorSplit>)> preload;
 };
 
 /// Structure contains the current info on splits for a particular plan node.
@@ -90,6 +100,11 @@ struct SplitGroupState {
   /// Map of local exchanges keyed on LocalPartition plan node ID.
   std::unordered_map<core::PlanNodeId, LocalExchangeState> localExchanges;
 
+  /// Map of the thresholds shared by the TopN operators of different
+  /// Drivers, keyed on TopNNode plan node ID.
+  std::unordered_map<core::PlanNodeId, std::shared_ptr<TopNThreshold>>
+      topNThresholds;
+
   /// Drivers created and still running for this split group.
   /// The split group is finished when this numbers reaches zero.
   uint32_t numRunningDrivers{0};
@@ -108,6 +123,7 @@ struct SplitGroupState {
     localMergeSources.clear();
     mergeJoinSources.clear();
     localExchanges.clear();
+    topNThresholds.clear();
   }
 };
 
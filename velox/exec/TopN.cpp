@@ -18,6 +18,35 @@
 #include "velox/vector/FlatVector.h"
 
 namespace facebook::velox::exec {
+
+void TopNThreshold::update(
+    const char* key,
+    std::shared_ptr<const common::Filter> filter) {
+  std::lock_guard<std::mutex> l(mutex_);
+  if (version_ != 0 && memcmp(key, key_.data(), key_.size()) >= 0) {
+    return;
+  }
+  memcpy(key_.data(), key, key_.size());
+  if (filter) {
+    filter_ = std::move(filter);
+  }
+  ++version_;
+}
+
+bool TopNThreshold::get(
+    uint64_t& version,
+    std::vector<char>& key,
+    std::shared_ptr<const common::Filter>& filter) const {
+  if (version_ == version) {
+    return false;
+  }
+  std::lock_guard<std::mutex> l(mutex_);
+  key = key_;
+  filter = filter_;
+  version = version_;
+  return true;
+}
+
 TopN::TopN(
     int32_t operatorId,
     DriverCtx* driverCtx,
@@ -29,6 +58,9 @@ TopN::TopN(
           topNNode->id(),
           "TopN"),
       count_(topNNode->count()),
+      firstKeyChannel_(
+          exprToChannel(topNNode->sortingKeys()[0].get(), outputType_)),
+      firstKeyOrder_(topNNode->sortingOrders()[0]),
       data_(std::make_unique<RowContainer>(
           outputType_->children(),
           operatorCtx_->mappedMemory())),
@@ -38,6 +70,7 @@ TopN::TopN(
           topNNode->sortingOrders(),
           data_.get()),
       topRows_(comparator_),
+      inputKey_(comparator_.encoder().keySize()),
       decodedVectors_(outputType_->children().size()) {}
 
 TopN::Comparator::Comparator(
@@ -55,6 +88,27 @@ TopN::Comparator::Comparator(
         "TopN doesn't allow constant comparison keys");
     keyInfo_.push_back(std::make_pair(channel, sortingOrders[i]));
   }
+  std::vector<TypePtr> keyTypes;
+  std::vector<CompareFlags> compareFlags;
+  std::vector<column_index_t> channels;
+  for (const auto& [channel, order] : keyInfo_) {
+    keyTypes.push_back(type->childAt(channel));
+    compareFlags.push_back({order.isNullsFirst(), order.isAscending(), false});
+    channels.push_back(channel);
+  }
+  encoder_ = std::make_shared<SortKeyEncoder>(
+      keyTypes, compareFlags, std::move(channels));
+}
+
+char* TopN::newEntry() {
+  const auto entrySize = sizeof(char*) + comparator_.encoder().keySize();
+  const auto indexInBlock = numEntries_ % kEntriesPerBlock;
+  if (indexInBlock == 0) {
+    entryBlocks_.push_back(
+        std::make_unique<char[]>(kEntriesPerBlock * entrySize));
+  }
+  ++numEntries_;
+  return entryBlocks_.back().get() + indexInBlock * entrySize;
 }
 
 void TopN::addInput(RowVectorPtr input) {
@@ -65,27 +119,166 @@ void TopN::addInput(RowVectorPtr input) {
     decodedVectors_[col].decode(*input->childAt(col), allRows);
   }
 
+  const auto& encoder = comparator_.encoder();
+  if (!sharedThreshold_ && encoder.keySize() > 0) {
+    sharedThreshold_ = operatorCtx_->task()->getTopNThreshold(
+        operatorCtx_->driverCtx()->splitGroupId,
+        planNodeId(),
+        encoder.keySize());
+  }
+  if (sharedThreshold_) {
+    sharedThreshold_->get(sharedVersion_, sharedKey_, sharedFilter_);
+  }
+  // A row whose encoded key is greater than the shared threshold sorts
+  // after the rows kept by some Driver. Equal keys may be incomplete and
+  // are left to the comparator.
+  const char* sharedKey = sharedVersion_ != 0 ? sharedKey_.data() : nullptr;
+  int64_t numDropped = 0;
   for (int row = 0; row < input->size(); ++row) {
+    encoder.encode(decodedVectors_, row, inputKey_.data());
+    if (sharedKey && encoder.compare(inputKey_.data(), sharedKey) > 0) {
+      ++numDropped;
+      continue;
+    }
+    char* entry = nullptr;
     char* newRow = nullptr;
     if (topRows_.size() < count_) {
+      entry = newEntry();
       newRow = data_->newRow();
     } else {
-      char* topRow = topRows_.top();
+      entry = topRows_.top();
 
-      if (comparator_(topRow, decodedVectors_, row)) {
+      if (comparator_(entry, inputKey_.data(), decodedVectors_, row)) {
         continue;
       }
       topRows_.pop();
-      // Reuse the topRow's memory.
-      newRow = data_->initializeRow(topRow, true /* reuse */);
+      // Reuse the top entry and the memory of its row.
+      newRow = data_->initializeRow(entryRow(entry), true /* reuse */);
     }
 
     for (int col = 0; col < input->childrenSize(); ++col) {
       data_->store(decodedVectors_[col], row, newRow, col);
     }
 
-    topRows_.push(newRow);
+    memcpy(entry, &newRow, sizeof(char*));
+    memcpy(entry + sizeof(char*), inputKey_.data(), inputKey_.size());
+    topRows_.push(entry);
+  }
+  if (numDropped > 0) {
+    stats_.addRuntimeStat(
+        "sharedThresholdDroppedRows", RuntimeCounter(numDropped));
+  }
+  updateThresholds();
+}
+
+void TopN::updateThresholds() {
+  const bool isFull = topRows_.size() >= count_;
+  std::unique_ptr<common::Filter> filter;
+  if (isFull && mayPushdownThreshold()) {
+    filter = makeThresholdFilter();
+  }
+  if (!sharedThreshold_) {
+    if (filter) {
+      dynamicFilters_[firstKeyChannel_] = std::move(filter);
+    }
+    return;
+  }
+  if (isFull) {
+    sharedThreshold_->update(entryKey(topRows_.top()), std::move(filter));
+  }
+  // The shared threshold is at least as tight as the local one after the
+  // update, so the pushed down filter is always the shared one.
+  sharedThreshold_->get(sharedVersion_, sharedKey_, sharedFilter_);
+  if (sharedFilter_ && sharedFilter_ != pushedFilter_ &&
+      mayPushdownThreshold()) {
+    dynamicFilters_[firstKeyChannel_] = sharedFilter_->clone();
+    pushedFilter_ = sharedFilter_;
+  }
+}
+
+bool TopN::mayPushdownThreshold() {
+  if (!mayPushdownThreshold_.has_value()) {
+    auto typeKind = outputType_->childAt(firstKeyChannel_)->kind();
+    const bool isFloatingPoint =
+        typeKind == TypeKind::REAL || typeKind == TypeKind::DOUBLE;
+    // NaN sorts after all other values. A descending floating point key
+    // would need a filter that passes NaN.
+    mayPushdownThreshold_ =
+        (isFloatingPoint && firstKeyOrder_.isAscending()) ||
+        typeKind == TypeKind::TINYINT || typeKind == TypeKind::SMALLINT ||
+        typeKind == TypeKind::INTEGER || typeKind == TypeKind::BIGINT;
+    if (mayPushdownThreshold_.value()) {
+      mayPushdownThreshold_ =
+          !operatorCtx_->driverCtx()
+               ->driver->canPushdownFilters(this, {firstKeyChannel_})
+               .empty();
+    }
+  }
+  return mayPushdownThreshold_.value();
+}
+
+namespace {
+template <typename T>
+T valueAt(const char* row, const RowColumn& column) {
+  return *reinterpret_cast<const T*>(row + column.offset());
+}
+} // namespace
+
+std::unique_ptr<common::Filter> TopN::makeThresholdFilter() {
+  const char* worstRow = entryRow(topRows_.top());
+  const auto column = data_->columnAt(firstKeyChannel_);
+  if (RowContainer::isNullAt(worstRow, column.nullByte(), column.nullMask())) {
+    // With nulls last, all non-null values pass. With nulls first, only
+    // nulls do but this is left to the TopN.
+    return nullptr;
+  }
+  // Nulls sort before the threshold if nulls are first.
+  const bool nullAllowed = firstKeyOrder_.isNullsFirst();
+  const auto typeKind = outputType_->childAt(firstKeyChannel_)->kind();
+  if (typeKind == TypeKind::REAL || typeKind == TypeKind::DOUBLE) {
+    VELOX_DCHECK(firstKeyOrder_.isAscending());
+    const double threshold = typeKind == TypeKind::REAL
+        ? valueAt<float>(worstRow, column)
+        : valueAt<double>(worstRow, column);
+    if (std::isnan(threshold) || lastFloatingPointThreshold_ == threshold) {
+      return nullptr;
+    }
+    lastFloatingPointThreshold_ = threshold;
+    if (typeKind == TypeKind::REAL) {
+      return std::make_unique<common::FloatRange>(
+          0, true, false, threshold, false, false, nullAllowed);
+    }
+    return std::make_unique<common::DoubleRange>(
+        0, true, false, threshold, false, false, nullAllowed);
+  }
+
+  int64_t threshold;
+  switch (typeKind) {
+    case TypeKind::TINYINT:
+      threshold = valueAt<int8_t>(worstRow, column);
+      break;
+    case TypeKind::SMALLINT:
+      threshold = valueAt<int16_t>(worstRow, column);
+      break;
+    case TypeKind::INTEGER:
+      threshold = valueAt<int32_t>(worstRow, column);
+      break;
+    case TypeKind::BIGINT:
+      threshold = valueAt<int64_t>(worstRow, column);
+      break;
+    default:
+      VELOX_UNREACHABLE();
+  }
+  if (lastIntegerThreshold_ == threshold) {
+    return nullptr;
+  }
+  lastIntegerThreshold_ = threshold;
+  if (firstKeyOrder_.isAscending()) {
+    return std::make_unique<common::BigintRange>(
+        std::numeric_limits<int64_t>::min(), threshold, nullAllowed);
   }
+  return std::make_unique<common::BigintRange>(
+      threshold, std::numeric_limits<int64_t>::max(), nullAllowed);
 }
 
 RowVectorPtr TopN::getOutput() {
@@ -120,7 +313,7 @@ void TopN::noMoreInput() {
   }
   rows_.resize(topRows_.size());
   for (int i = rows_.size(); i > 0; --i) {
-    rows_[i - 1] = topRows_.top();
+    rows_[i - 1] = entryRow(topRows_.top());
     topRows_.pop();
   }
 }
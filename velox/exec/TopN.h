@@ -15,11 +15,53 @@
  */
 #pragma once
 
+#include <atomic>
+#include <mutex>
+
 #include "velox/exec/Operator.h"
 #include "velox/exec/RowContainer.h"
+#include "velox/exec/SortKeyEncoder.h"
 
 namespace facebook::velox::exec {
 
+// The best cutoff known to the TopN operators of one plan node in the
+// Drivers of a Task. A row that sorts after the N rows kept by any one of
+// the operators cannot be in the top N of their combined input. Each
+// operator publishes the encoded sort key of its worst kept row and drops
+// input that sorts after the best published key, so that all Drivers
+// prune against the tightest cutoff instead of their own.
+class TopNThreshold {
+ public:
+  explicit TopNThreshold(int32_t keySize) : key_(keySize) {}
+
+  int32_t keySize() const {
+    return key_.size();
+  }
+
+  // Sets the threshold to the encoded key 'key' if it sorts before the
+  // current one. 'filter' is the filter on the first sorting key that
+  // passes the values up to 'key'. If 'filter' is nullptr, the filter of
+  // the previous threshold is kept. This is correct since it passes a
+  // superset of the rows.
+  void update(const char* key, std::shared_ptr<const common::Filter> filter);
+
+  // Copies the threshold into 'key' and its filter into 'filter' if the
+  // threshold changed after 'version' and returns true. Sets 'version' to
+  // the version of the copied threshold. Version 0 means no threshold.
+  bool get(
+      uint64_t& version,
+      std::vector<char>& key,
+      std::shared_ptr<const common::Filter>& filter) const;
+
+ private:
+  // Incremented on each change. Read without 'mutex_' to skip unchanged
+  // thresholds.
+  std::atomic<uint64_t> version_{0};
+  mutable std::mutex mutex_;
+  std::vector<char> key_;
+  std::shared_ptr<const common::Filter> filter_;
+};
+
 class TopN : public Operator {
  public:
   TopN(
@@ -45,6 +87,37 @@ class TopN : public Operator {
 
  private:
   static constexpr size_t kMaxNumRowsToReturn = 1024;
+
+  // Publishes the key of the worst kept row to 'sharedThreshold_' and sets
+  // a dynamic filter on the first sorting key that passes only the values
+  // that sort before or equal to the best threshold of all Drivers. Called
+  // after each input batch.
+  void updateThresholds();
+
+  // Returns true if a threshold filter may be pushed down. The filter is
+  // made only for integer keys and ascending floating point keys and only
+  // if it can be pushed down to the source of the pipeline.
+  bool mayPushdownThreshold();
+
+  // Returns the filter for the first sorting key of the worst kept row or
+  // nullptr if its value did not change since the last call or there is
+  // no filter for it.
+  std::unique_ptr<common::Filter> makeThresholdFilter();
+  // Entries of 'topRows_' are a pointer to a row of 'data_' followed by the
+  // normalized key of the row.
+  static char* entryRow(const char* entry) {
+    char* row;
+    memcpy(&row, entry, sizeof(char*));
+    return row;
+  }
+
+  static const char* entryKey(const char* entry) {
+    return entry + sizeof(char*);
+  }
+
+  // Returns memory for a new entry of 'topRows_'.
+  char* newEntry();
+
   class Comparator {
    public:
     Comparator(
@@ -54,15 +127,27 @@ class TopN : public Operator {
         const std::vector<core::SortOrder>& sortingOrders,
         RowContainer* rowContainer);
 
-    // Returns true if lhs < rhs, false otherwise.
+    const SortKeyEncoder& encoder() const {
+      return *encoder_;
+    }
+
+    // Returns true if the entry 'lhs' < the entry 'rhs', false otherwise.
     bool operator()(const char* lhs, const char* rhs) {
       if (lhs == rhs) {
         return false;
       }
+      if (auto result = encoder_->compare(entryKey(lhs), entryKey(rhs))) {
+        return result < 0;
+      }
+      if (encoder_->isComplete()) {
+        return false;
+      }
+      const char* lhsRow = entryRow(lhs);
+      const char* rhsRow = entryRow(rhs);
       for (auto& key : keyInfo_) {
         if (auto result = rowContainer_->compare(
-                lhs,
-                rhs,
+                lhsRow,
+                rhsRow,
                 key.first,
                 {key.second.isNullsFirst(), key.second.isAscending(), false})) {
           return result < 0;
@@ -71,14 +156,23 @@ class TopN : public Operator {
       return false;
     }
 
-    // Returns true if lhs < decodeVectors[index], false otherwise.
+    // Returns true if the entry 'lhs' < decodeVectors[index], false
+    // otherwise. 'inputKey' is the normalized key of decodedVectors[index].
     bool operator()(
         const char* lhs,
+        const char* inputKey,
         const std::vector<DecodedVector>& decodedVectors,
         vector_size_t index) {
+      if (auto result = encoder_->compare(entryKey(lhs), inputKey)) {
+        return result < 0;
+      }
+      if (encoder_->isComplete()) {
+        return false;
+      }
+      const char* lhsRow = entryRow(lhs);
       for (auto& key : keyInfo_) {
         if (auto result = rowContainer_->compare(
-                lhs,
+                lhsRow,
                 rowContainer_->columnAt(key.first),
                 decodedVectors[key.first],
                 index,
@@ -92,17 +186,46 @@ class TopN : public Operator {
    private:
     std::vector<std::pair<column_index_t, core::SortOrder>> keyInfo_;
     RowContainer* rowContainer_;
+    // Shared by the copies of 'this' made by the priority queue.
+    std::shared_ptr<const SortKeyEncoder> encoder_;
   };
 
   const int32_t count_;
 
+  // Channel and order of the first sorting key. Any row with this key worse
+  // than in the worst of the top rows cannot be in the result.
+  const column_index_t firstKeyChannel_;
+  const core::SortOrder firstKeyOrder_;
+
+  // True if the threshold filter may be pushed down. Decided on the first
+  // call to mayPushdownThreshold().
+  std::optional<bool> mayPushdownThreshold_;
+
+  // Threshold shared with the TopN operators of the other Drivers. Set on
+  // the first input batch. nullptr if the sort keys cannot be encoded.
+  std::shared_ptr<TopNThreshold> sharedThreshold_;
+
+  // Copy of the shared threshold at 'sharedVersion_'. Input that sorts
+  // after 'sharedKey_' is dropped.
+  uint64_t sharedVersion_{0};
+  std::vector<char> sharedKey_;
+  std::shared_ptr<const common::Filter> sharedFilter_;
+
+  // The shared filter last pushed down.
+  std::shared_ptr<const common::Filter> pushedFilter_;
+
+  // The key value of the last threshold filter.
+  std::optional<int64_t> lastIntegerThreshold_;
+  std::optional<double> lastFloatingPointThreshold_;
+
   bool finished_ = false;
   uint32_t numRowsReturned_ = 0;
 
   // As the inputs are added to TopN operator, we use topRows_ (a priority
   // queue) to keep track of the pointers to rows stored in the
-  // RowContainer (data_). We only update the RowContainer if a row is a
-  // candidate for top rows. Otherwise, we will discard the row.
+  // RowContainer (data_) together with their normalized keys, so that most
+  // comparisons are a memcmp of the keys. We only update the RowContainer if
+  // a row is a candidate for top rows. Otherwise, we will discard the row.
   // Since we use a priority queue for TopN, we perform
   // O(total_rows * logN) comparisons and require O(N) space.
   // Once all inputs are available, we copy the final set of rows to the
@@ -113,6 +236,15 @@ class TopN : public Operator {
   std::priority_queue<char*, std::vector<char*>, Comparator> topRows_;
   std::vector<char*> rows_;
 
+  // Memory for the entries of 'topRows_' in blocks of kEntriesPerBlock.
+  // Entries are reused when a kept row is replaced.
+  static constexpr int32_t kEntriesPerBlock = 1024;
+  std::vector<std::unique_ptr<char[]>> entryBlocks_;
+  int32_t numEntries_{0};
+
+  // The normalized key of the input row being added.
+  std::vector<char> inputKey_;
+
   std::vector<DecodedVector> decodedVectors_;
 };
 } // namespace facebook::velox::exec
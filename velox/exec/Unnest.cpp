@@ -131,9 +131,8 @@ RowVectorPtr Unnest::getOutput() {
   auto* rawRepeatedIndices = repeatedIndices->asMutable<vector_size_t>();
   vector_size_t index = 0;
   for (auto row = 0; row < size; ++row) {
-    for (auto i = 0; i < rawMaxSizes[row]; i++) {
-      rawRepeatedIndices[index++] = row;
-    }
+    std::fill_n(rawRepeatedIndices + index, rawMaxSizes[row], row);
+    index += rawMaxSizes[row];
   }
 
   // Wrap "replicated" columns in a dictionary using 'repeatedIndices'.
@@ -151,66 +150,78 @@ RowVectorPtr Unnest::getOutput() {
     auto currentOffsets = rawOffsets[channel];
     auto currentIndices = rawIndices[channel];
 
-    BufferPtr elementIndices = allocateIndices(numElements, pool());
-    auto* rawElementIndices = elementIndices->asMutable<vector_size_t>();
-
-    auto nulls =
-        AlignedBuffer::allocate<bool>(numElements, pool(), bits::kNotNull);
-    auto rawNulls = nulls->asMutable<uint64_t>();
-
-    // Make dictionary index for elements column since they may be out of order.
-    index = 0;
+    // If the elements of consecutive rows follow each other in the base
+    // vector starting at 0 and no row needs padding, the elements, keys and
+    // values vectors are the output columns as is. Rows that contribute no
+    // output rows do not matter, whatever their offset.
     bool identityMapping = true;
+    bool needsNulls = false;
+    index = 0;
     for (auto row = 0; row < size; ++row) {
       auto maxSize = rawMaxSizes[row];
-
-      if (!currentDecoded.isNullAt(row)) {
-        auto offset = currentOffsets[currentIndices[row]];
-        auto unnestSize = currentSizes[currentIndices[row]];
-
-        if (index != offset || unnestSize < maxSize) {
-          identityMapping = false;
-        }
-
-        for (auto i = 0; i < unnestSize; i++) {
-          rawElementIndices[index++] = offset + i;
-        }
-
-        for (auto i = unnestSize; i < maxSize; ++i) {
-          bits::setNull(rawNulls, index++, true);
-        }
-      } else if (maxSize > 0) {
+      if (maxSize == 0) {
+        continue;
+      }
+      if (currentDecoded.isNullAt(row)) {
         identityMapping = false;
+        needsNulls = true;
+        continue;
+      }
+      auto offset = currentOffsets[currentIndices[row]];
+      auto unnestSize = currentSizes[currentIndices[row]];
+      if (unnestSize < maxSize) {
+        needsNulls = true;
+      }
+      if (index != offset || unnestSize < maxSize) {
+        identityMapping = false;
+      }
+      index += maxSize;
+    }
 
-        for (auto i = 0; i < maxSize; ++i) {
-          bits::setNull(rawNulls, index++, true);
+    BufferPtr elementIndices;
+    BufferPtr nulls;
+    if (!identityMapping) {
+      // Make dictionary index for elements column since they may be out of
+      // order. Pad rows shorter than the longest unnested column with nulls.
+      elementIndices = allocateIndices(numElements, pool());
+      auto* rawElementIndices = elementIndices->asMutable<vector_size_t>();
+      uint64_t* rawNulls = nullptr;
+      if (needsNulls) {
+        nulls =
+            AlignedBuffer::allocate<bool>(numElements, pool(), bits::kNotNull);
+        rawNulls = nulls->asMutable<uint64_t>();
+      }
+      index = 0;
+      for (auto row = 0; row < size; ++row) {
+        auto maxSize = rawMaxSizes[row];
+        vector_size_t unnestSize = 0;
+        if (!currentDecoded.isNullAt(row)) {
+          auto offset = currentOffsets[currentIndices[row]];
+          unnestSize = currentSizes[currentIndices[row]];
+          std::iota(
+              rawElementIndices + index,
+              rawElementIndices + index + unnestSize,
+              offset);
+        }
+        if (unnestSize < maxSize) {
+          bits::fillBits(rawNulls, index + unnestSize, index + maxSize, false);
         }
+        index += maxSize;
       }
     }
 
+    // Construct unnest columns using the Array elements or the Map keys and
+    // values. 'wrapChild' returns these as is if there is no dictionary index.
     if (currentDecoded.base()->typeKind() == TypeKind::ARRAY) {
-      // Construct unnest column using Array elements wrapped using above
-      // created dictionary.
       auto unnestBaseArray = currentDecoded.base()->as<ArrayVector>();
-      outputs[outputsIndex++] = identityMapping
-          ? unnestBaseArray->elements()
-          : wrapChild(
-                numElements,
-                elementIndices,
-                unnestBaseArray->elements(),
-                nulls);
+      outputs[outputsIndex++] = wrapChild(
+          numElements, elementIndices, unnestBaseArray->elements(), nulls);
     } else {
-      // Construct two unnest columns for Map keys and values vectors wrapped
-      // using above created dictionary.
       auto unnestBaseMap = currentDecoded.base()->as<MapVector>();
-      outputs[outputsIndex++] = identityMapping
-          ? unnestBaseMap->mapKeys()
-          : wrapChild(
-                numElements, elementIndices, unnestBaseMap->mapKeys(), nulls);
-      outputs[outputsIndex++] = identityMapping
-          ? unnestBaseMap->mapValues()
-          : wrapChild(
-                numElements, elementIndices, unnestBaseMap->mapValues(), nulls);
+      outputs[outputsIndex++] = wrapChild(
+          numElements, elementIndices, unnestBaseMap->mapKeys(), nulls);
+      outputs[outputsIndex++] = wrapChild(
+          numElements, elementIndices, unnestBaseMap->mapValues(), nulls);
     }
   }
 
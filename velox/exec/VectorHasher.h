@@ -59,6 +59,13 @@ class UniqueValue {
     data_ = value.milliseconds();
   }
 
+  explicit UniqueValue(Timestamp value) {
+    // Timestamps are keyed by their microsecond value. Only timestamps without
+    // sub-microsecond nanos get here, so this is exact.
+    size_ = sizeof(int64_t);
+    data_ = value.toMicros();
+  }
+
   uint32_t size() const {
     return size_;
   }
@@ -240,6 +247,11 @@ class VectorHasher {
     return hasRange_ || !distinctOverflow_;
   }
 
+  // Returns true if there are too many distinct values for getFilter().
+  bool distinctOverflow() const {
+    return distinctOverflow_;
+  }
+
   // Returns an instance of the filter corresponding to a set of unique values.
   // Returns null if distinctOverflow_ is true.
   std::unique_ptr<common::Filter> getFilter(bool nullAllowed) const;
@@ -303,6 +315,7 @@ class VectorHasher {
       case TypeKind::VARBINARY:
       case TypeKind::DATE:
       case TypeKind::INTERVAL_DAY_TIME:
+      case TypeKind::TIMESTAMP:
         return true;
       default:
         return false;
@@ -338,6 +351,21 @@ class VectorHasher {
     return value;
   }
 
+  // Returned by toInt64(Timestamp) for timestamps that have no exact int64
+  // microsecond value, i.e. sub-microsecond nanos or a value out of range.
+  // Such timestamps are unmappable and switch the hasher to hash mode.
+  static constexpr int64_t kNonMicrosTimestamp =
+      std::numeric_limits<int64_t>::min();
+
+  // True if 'normalized' is the result of toInt64 on a T that has no value ID.
+  template <typename T>
+  static bool isUnmappable(int64_t normalized) {
+    if constexpr (std::is_same_v<T, Timestamp>) {
+      return normalized == kNonMicrosTimestamp;
+    }
+    return false;
+  }
+
   // Sets the data statistics from 'other'. Does not set the mapping mode.
   void copyStatsFrom(const VectorHasher& other);
 
@@ -408,6 +436,11 @@ class VectorHasher {
   template <typename T>
   void analyzeValue(T value) {
     auto normalized = toInt64(value);
+    if (isUnmappable<T>(normalized)) {
+      rangeOverflow_ = true;
+      distinctOverflow_ = true;
+      return;
+    }
     if (!rangeOverflow_) {
       updateRange(normalized);
     }
@@ -448,7 +481,8 @@ class VectorHasher {
     bool inRange = true;
     rows.template testSelected([&](vector_size_t row) {
       auto int64Value = toInt64(values[row]);
-      if (int64Value > max_ || int64Value < min_) {
+      if (isUnmappable<T>(int64Value) || int64Value > max_ ||
+          int64Value < min_) {
         inRange = false;
         return false;
       }
@@ -463,6 +497,9 @@ class VectorHasher {
   template <typename T>
   uint64_t valueId(T value) {
     auto int64Value = toInt64(value);
+    if (isUnmappable<T>(int64Value)) {
+      return kUnmappable;
+    }
     if (isRange_) {
       if (int64Value > max_ || int64Value < min_) {
         return kUnmappable;
@@ -486,6 +523,9 @@ class VectorHasher {
   template <typename T>
   uint64_t lookupValueId(T value) const {
     auto int64Value = toInt64(value);
+    if (isUnmappable<T>(int64Value)) {
+      return kUnmappable;
+    }
     if (isRange_) {
       if (int64Value > max_ || int64Value < min_) {
         return kUnmappable;
@@ -579,6 +619,17 @@ inline int64_t VectorHasher::toInt64(IntervalDayTime value) const {
   return value.milliseconds();
 }
 
+template <>
+inline int64_t VectorHasher::toInt64(Timestamp value) const {
+  constexpr int64_t kMaxSeconds =
+      std::numeric_limits<int64_t>::max() / 1'000'000 - 1;
+  if (value.getNanos() % 1'000 != 0 || value.getSeconds() > kMaxSeconds ||
+      value.getSeconds() < -kMaxSeconds) {
+    return kNonMicrosTimestamp;
+  }
+  return value.toMicros();
+}
+
 template <>
 bool VectorHasher::makeValueIdsForRows<TypeKind::VARCHAR>(
     char** groups,
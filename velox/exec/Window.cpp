@@ -0,0 +1,717 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "velox/exec/Window.h"
+#include <numeric>
+#include "velox/exec/ContainerRowSerde.h"
+#include "velox/expression/EvalCtx.h"
+#include "velox/vector/FlatVector.h"
+
+namespace facebook::velox::exec {
+
+// Evaluates one window function over the rows of a partition. The rows of a
+// partition are presented in batches of consecutive rows. State may be kept
+// across batches of the same partition, which allows frames to be computed
+// incrementally.
+class WindowFunction {
+ public:
+  virtual ~WindowFunction() = default;
+
+  // Called at the start of each partition. 'rows' are the rows of the
+  // partition in sorted order. 'rows' stay valid until the next call.
+  virtual void resetPartition(folly::Range<char**> rows) = 0;
+
+  // Computes the results for 'numRows' rows starting at 'offset' in the
+  // current partition and writes these to rows [0, numRows) of 'result'.
+  // 'peerStarts' and 'peerEnds' give the start and end (exclusive) of the
+  // peer group of each of the rows, relative to the start of the partition.
+  virtual void apply(
+      vector_size_t offset,
+      vector_size_t numRows,
+      const vector_size_t* peerStarts,
+      const vector_size_t* peerEnds,
+      const VectorPtr& result) = 0;
+};
+
+namespace {
+
+class RowNumberFunction : public WindowFunction {
+ public:
+  void resetPartition(folly::Range<char**> /*rows*/) override {}
+
+  void apply(
+      vector_size_t offset,
+      vector_size_t numRows,
+      const vector_size_t* /*peerStarts*/,
+      const vector_size_t* /*peerEnds*/,
+      const VectorPtr& result) override {
+    auto* rawValues = result->asFlatVector<int64_t>()->mutableRawValues();
+    for (auto i = 0; i < numRows; ++i) {
+      rawValues[i] = offset + i + 1;
+    }
+  }
+};
+
+// Implements rank() and dense_rank().
+template <bool isDense>
+class RankFunction : public WindowFunction {
+ public:
+  void resetPartition(folly::Range<char**> /*rows*/) override {
+    rank_ = 0;
+    lastPeerStart_ = -1;
+  }
+
+  void apply(
+      vector_size_t /*offset*/,
+      vector_size_t numRows,
+      const vector_size_t* peerStarts,
+      const vector_size_t* /*peerEnds*/,
+      const VectorPtr& result) override {
+    auto* rawValues = result->asFlatVector<int64_t>()->mutableRawValues();
+    for (auto i = 0; i < numRows; ++i) {
+      if (peerStarts[i] != lastPeerStart_) {
+        lastPeerStart_ = peerStarts[i];
+        rank_ = isDense ? rank_ + 1 : peerStarts[i] + 1;
+      }
+      rawValues[i] = rank_;
+    }
+  }
+
+ private:
+  int64_t rank_ = 0;
+  vector_size_t lastPeerStart_ = -1;
+};
+
+// Returns the value of a k PRECEDING or k FOLLOWING frame bound. Only
+// constant bounds are supported.
+int64_t frameOffset(const core::TypedExprPtr& value) {
+  auto constant =
+      std::dynamic_pointer_cast<const core::ConstantTypedExpr>(value);
+  VELOX_USER_CHECK_NOT_NULL(
+      constant, "Window frame offset must be a constant");
+  VELOX_USER_CHECK(
+      !constant->value().isNull(), "Window frame offset must not be null");
+  int64_t offset;
+  switch (constant->type()->kind()) {
+    case TypeKind::TINYINT:
+      offset = constant->value().value<int8_t>();
+      break;
+    case TypeKind::SMALLINT:
+      offset = constant->value().value<int16_t>();
+      break;
+    case TypeKind::INTEGER:
+      offset = constant->value().value<int32_t>();
+      break;
+    case TypeKind::BIGINT:
+      offset = constant->value().value<int64_t>();
+      break;
+    default:
+      VELOX_USER_FAIL(
+          "Unsupported type of window frame offset: {}",
+          constant->type()->toString());
+  }
+  VELOX_USER_CHECK_GE(offset, 0, "Window frame offset must not be negative");
+  return offset;
+}
+
+// Evaluates an aggregate function over the frame of each row. The accumulator
+// covers the rows [accumulatedStart_, accumulatedEnd_) of the partition. When
+// the frame of the next row has the same start and an end that is not before
+// the current one, only the rows entering the frame are added. Otherwise the
+// accumulator is reset and the frame is added from a segment tree of
+// accumulators over blocks of kBlockSize rows, so that a sliding frame costs
+// O(kBlockSize + log(partition size)) per row instead of the frame size.
+class AggregateWindowFunction : public WindowFunction {
+ public:
+  AggregateWindowFunction(
+      const core::WindowNode::Function& function,
+      const RowTypePtr& inputType,
+      RowContainer* data,
+      memory::MemoryPool* pool,
+      memory::MappedMemory* mappedMemory)
+      : frame_(function.frame), data_(data), pool_(pool) {
+    std::vector<TypePtr> argTypes;
+    for (auto& arg : function.functionCall->inputs()) {
+      argTypes.push_back(arg->type());
+      auto channel = exprToChannel(arg.get(), inputType);
+      argChannels_.push_back(channel);
+      if (channel == kConstantChannel) {
+        auto constant = static_cast<const core::ConstantTypedExpr*>(arg.get());
+        constantArgs_.push_back(BaseVector::createConstant(
+            constant->value(), 1, pool_));
+      } else {
+        constantArgs_.push_back(nullptr);
+      }
+    }
+
+    const auto& resultType = function.functionCall->type();
+    aggregates_.push_back(Aggregate::create(
+        function.functionCall->name(),
+        core::AggregationNode::Step::kSingle,
+        argTypes,
+        resultType));
+    aggregate_ = aggregates_.back().get();
+
+    accumulators_ = std::make_unique<RowContainer>(
+        std::vector<TypePtr>{},
+        false, // nullableKeys
+        aggregates_,
+        std::vector<TypePtr>{},
+        false, // hasNext
+        false, // isJoinBuild
+        false, // hasProbedFlag
+        false, // hasNormalizedKey
+        mappedMemory,
+        ContainerRowSerde::instance());
+    accumulator_ = accumulators_->newRow();
+    initializeAccumulators(&accumulator_, 1);
+    singleResult_ = BaseVector::create(resultType, 1, pool_);
+    tree_ = std::make_unique<RowContainer>(
+        std::vector<TypePtr>{},
+        false, // nullableKeys
+        aggregates_,
+        std::vector<TypePtr>{},
+        false, // hasNext
+        false, // isJoinBuild
+        false, // hasProbedFlag
+        false, // hasNormalizedKey
+        mappedMemory,
+        ContainerRowSerde::instance());
+    intermediates_ = BaseVector::create(
+        Aggregate::intermediateType(function.functionCall->name(), argTypes),
+        0,
+        pool_);
+
+    if (frame_.startType == core::WindowNode::BoundType::kPreceding ||
+        frame_.startType == core::WindowNode::BoundType::kFollowing) {
+      startOffset_ = frameOffset(frame_.startValue);
+    }
+    if (frame_.endType == core::WindowNode::BoundType::kPreceding ||
+        frame_.endType == core::WindowNode::BoundType::kFollowing) {
+      endOffset_ = frameOffset(frame_.endValue);
+    }
+    VELOX_USER_CHECK(
+        frame_.startType != core::WindowNode::BoundType::kUnboundedFollowing,
+        "Window frame start cannot be UNBOUNDED FOLLOWING");
+    VELOX_USER_CHECK(
+        frame_.endType != core::WindowNode::BoundType::kUnboundedPreceding,
+        "Window frame end cannot be UNBOUNDED PRECEDING");
+    if (frame_.type == core::WindowNode::WindowType::kRange) {
+      VELOX_USER_CHECK(
+          startOffset_ == 0 && endOffset_ == 0 &&
+              frame_.startType != core::WindowNode::BoundType::kPreceding &&
+              frame_.startType != core::WindowNode::BoundType::kFollowing &&
+              frame_.endType != core::WindowNode::BoundType::kPreceding &&
+              frame_.endType != core::WindowNode::BoundType::kFollowing,
+          "RANGE frames with k PRECEDING or k FOLLOWING bounds are not supported");
+    }
+  }
+
+  ~AggregateWindowFunction() override {
+    aggregate_->destroy(folly::Range<char**>(&accumulator_, 1));
+    clearTree();
+  }
+
+  void resetPartition(folly::Range<char**> rows) override {
+    clearTree();
+    partitionSize_ = rows.size();
+    args_.resize(argChannels_.size());
+    for (auto i = 0; i < argChannels_.size(); ++i) {
+      if (argChannels_[i] == kConstantChannel) {
+        args_[i] = BaseVector::wrapInConstant(
+            partitionSize_, 0, constantArgs_[i]);
+      } else {
+        args_[i] = BaseVector::create(
+            data_->columnTypes()[argChannels_[i]], partitionSize_, pool_);
+        data_->extractColumn(
+            rows.data(), partitionSize_, argChannels_[i], args_[i]);
+      }
+    }
+    frameRows_.resize(partitionSize_, false);
+    resetAccumulator();
+  }
+
+  void apply(
+      vector_size_t offset,
+      vector_size_t numRows,
+      const vector_size_t* peerStarts,
+      const vector_size_t* peerEnds,
+      const VectorPtr& result) override {
+    vector_size_t lastStart = -1;
+    vector_size_t lastEnd = -1;
+    for (auto i = 0; i < numRows; ++i) {
+      auto row = offset + i;
+      auto start = std::max<int64_t>(0, frameStart(row, peerStarts[i]));
+      auto end =
+          std::min<int64_t>(partitionSize_, frameEnd(row, peerEnds[i]));
+      if (start >= end) {
+        // Empty frame. The result is the value of an empty accumulator.
+        start = 0;
+        end = 0;
+      }
+
+      if (i > 0 && start == lastStart && end == lastEnd) {
+        result->copy(result.get(), i, i - 1, 1);
+        continue;
+      }
+      lastStart = start;
+      lastEnd = end;
+
+      if (accumulatedStart_ == accumulatedEnd_ && start < end) {
+        addFrame(start, end);
+        accumulatedStart_ = start;
+      } else if (start == accumulatedStart_ && end >= accumulatedEnd_) {
+        addRange(accumulatedEnd_, end);
+      } else {
+        resetAccumulator();
+        if (start < end) {
+          addFrame(start, end);
+          accumulatedStart_ = start;
+        }
+      }
+      accumulatedEnd_ = std::max<vector_size_t>(accumulatedEnd_, end);
+
+      aggregate_->finalize(&accumulator_, 1);
+      aggregate_->extractValues(&accumulator_, 1, &singleResult_);
+      result->copy(singleResult_.get(), i, 0, 1);
+    }
+  }
+
+ private:
+  // Returns the first row of the frame of 'row'. The result may be outside of
+  // the partition.
+  int64_t frameStart(vector_size_t row, vector_size_t peerStart) const {
+    return frameBound(frame_.startType, startOffset_, row, peerStart);
+  }
+
+  // Returns the row after the last row of the frame of 'row'. The result may
+  // be outside of the partition.
+  int64_t frameEnd(vector_size_t row, vector_size_t peerEnd) const {
+    return frameBound(frame_.endType, endOffset_, row, peerEnd - 1) + 1;
+  }
+
+  // Returns the position of a frame bound of 'row'. 'peer' is the first peer
+  // of 'row' for a frame start and the last peer for a frame end. RANGE frames
+  // use it for CURRENT ROW bounds.
+  int64_t frameBound(
+      core::WindowNode::BoundType type,
+      int64_t offset,
+      vector_size_t row,
+      vector_size_t peer) const {
+    switch (type) {
+      case core::WindowNode::BoundType::kUnboundedPreceding:
+        return 0;
+      case core::WindowNode::BoundType::kPreceding:
+        return row - offset;
+      case core::WindowNode::BoundType::kCurrentRow:
+        return frame_.type == core::WindowNode::WindowType::kRange ? peer
+                                                                    : row;
+      case core::WindowNode::BoundType::kFollowing:
+        return row + offset;
+      case core::WindowNode::BoundType::kUnboundedFollowing:
+        return partitionSize_ - 1;
+    }
+    VELOX_UNREACHABLE();
+  }
+
+  // Adds rows [begin, end) of the partition to the accumulator.
+  void addRange(vector_size_t begin, vector_size_t end) {
+    if (begin >= end) {
+      return;
+    }
+    frameRows_.setValidRange(begin, end, true);
+    frameRows_.setActiveRange(begin, end);
+    aggregate_->addSingleGroupRawInput(accumulator_, frameRows_, args_, false);
+    frameRows_.setValidRange(begin, end, false);
+  }
+
+  // Adds rows [begin, end) of the partition to the accumulator. The rows at
+  // the edges are added as raw input and the whole blocks in between as the
+  // intermediate results of the covering nodes of the segment tree.
+  void addFrame(vector_size_t begin, vector_size_t end) {
+    if (end - begin <= 2 * kBlockSize) {
+      addRange(begin, end);
+      return;
+    }
+    ensureTree();
+    auto firstBlock = bits::roundUp(begin, kBlockSize) / kBlockSize;
+    auto endBlock = end / kBlockSize;
+    addRange(begin, firstBlock * kBlockSize);
+    addRange(endBlock * kBlockSize, end);
+
+    nodes_.clear();
+    for (auto left = firstBlock + numLeaves_, right = endBlock + numLeaves_;
+         left < right;
+         left /= 2, right /= 2) {
+      if (left & 1) {
+        nodes_.push_back(treeNodes_[left++]);
+      }
+      if (right & 1) {
+        nodes_.push_back(treeNodes_[--right]);
+      }
+    }
+    aggregate_->extractAccumulators(
+        nodes_.data(), nodes_.size(), &intermediates_);
+    SelectivityVector nodeRows(nodes_.size());
+    aggregate_->addSingleGroupIntermediateResults(
+        accumulator_, nodeRows, {intermediates_}, false);
+  }
+
+  // Builds the segment tree for the current partition if not yet built. The
+  // leaves accumulate consecutive blocks of kBlockSize rows. The rows after
+  // the last whole block are not covered. Node i accumulates the nodes 2 * i
+  // and 2 * i + 1.
+  void ensureTree() {
+    if (!treeNodes_.empty()) {
+      return;
+    }
+    const auto numBlocks = partitionSize_ / kBlockSize;
+    numLeaves_ = bits::nextPowerOfTwo(numBlocks);
+    treeNodes_.resize(2 * numLeaves_);
+    for (auto& node : treeNodes_) {
+      node = tree_->newRow();
+    }
+    initializeAccumulators(treeNodes_.data(), treeNodes_.size());
+
+    const auto numCovered = numBlocks * kBlockSize;
+    std::vector<char*> groups(numCovered);
+    for (auto i = 0; i < numCovered; ++i) {
+      groups[i] = treeNodes_[numLeaves_ + i / kBlockSize];
+    }
+    SelectivityVector coveredRows(partitionSize_, false);
+    coveredRows.setValidRange(0, numCovered, true);
+    coveredRows.updateBounds();
+    aggregate_->addRawInput(groups.data(), coveredRows, args_, false);
+
+    for (auto levelStart = numLeaves_; levelStart > 1; levelStart /= 2) {
+      aggregate_->extractAccumulators(
+          treeNodes_.data() + levelStart, levelStart, &intermediates_);
+      for (auto i = 0; i < levelStart; ++i) {
+        groups[i] = treeNodes_[(levelStart + i) / 2];
+      }
+      SelectivityVector levelRows(levelStart);
+      aggregate_->addIntermediateResults(
+          groups.data(), levelRows, {intermediates_}, false);
+    }
+  }
+
+  // Frees the accumulators of the segment tree.
+  void clearTree() {
+    if (treeNodes_.empty()) {
+      return;
+    }
+    aggregate_->destroy(
+        folly::Range<char**>(treeNodes_.data(), treeNodes_.size()));
+    tree_->clear();
+    treeNodes_.clear();
+    numLeaves_ = 0;
+  }
+
+  void initializeAccumulators(char** groups, int32_t numGroups) {
+    std::vector<vector_size_t> indices(numGroups);
+    std::iota(indices.begin(), indices.end(), 0);
+    aggregate_->initializeNewGroups(
+        groups, folly::Range<const vector_size_t*>(indices.data(), numGroups));
+  }
+
+  // Frees the state of the accumulator before initializing it again.
+  void resetAccumulator() {
+    aggregate_->destroy(folly::Range<char**>(&accumulator_, 1));
+    accumulators_->initializeRow(accumulator_, false);
+    initializeAccumulators(&accumulator_, 1);
+    accumulatedStart_ = 0;
+    accumulatedEnd_ = 0;
+  }
+
+  // Rows per leaf of the segment tree.
+  static constexpr vector_size_t kBlockSize = 16;
+
+  const core::WindowNode::Frame frame_;
+  RowContainer* const data_;
+  memory::MemoryPool* const pool_;
+
+  int64_t startOffset_ = 0;
+  int64_t endOffset_ = 0;
+
+  std::vector<column_index_t> argChannels_;
+  std::vector<VectorPtr> constantArgs_;
+
+  // Single aggregate. Kept in a vector since RowContainer references it.
+  std::vector<std::unique_ptr<Aggregate>> aggregates_;
+  Aggregate* aggregate_;
+  std::unique_ptr<RowContainer> accumulators_;
+  char* accumulator_;
+
+  vector_size_t partitionSize_ = 0;
+
+  // Argument values for all rows of the current partition.
+  std::vector<VectorPtr> args_;
+
+  // All rows unselected between calls to addRange().
+  SelectivityVector frameRows_;
+
+  vector_size_t accumulatedStart_ = 0;
+  vector_size_t accumulatedEnd_ = 0;
+
+  VectorPtr singleResult_;
+
+  // Accumulators of the segment tree nodes of the current partition.
+  std::unique_ptr<RowContainer> tree_;
+
+  // The nodes of the segment tree. Empty if not built for the current
+  // partition. Node 1 is the root and the leaves start at 'numLeaves_'.
+  std::vector<char*> treeNodes_;
+  vector_size_t numLeaves_ = 0;
+
+  // The nodes that cover the whole blocks of a frame. Kept to reuse memory.
+  std::vector<char*> nodes_;
+
+  // Intermediate results of tree nodes.
+  VectorPtr intermediates_;
+};
+
+std::unique_ptr<WindowFunction> createWindowFunction(
+    const core::WindowNode::Function& function,
+    const RowTypePtr& inputType,
+    RowContainer* data,
+    memory::MemoryPool* pool,
+    memory::MappedMemory* mappedMemory) {
+  VELOX_USER_CHECK(
+      !function.ignoreNulls, "IGNORE NULLS is not supported in window functions");
+  const auto& name = function.functionCall->name();
+  if (name == "row_number" || name == "rank" || name == "dense_rank") {
+    VELOX_USER_CHECK_EQ(
+        function.functionCall->type()->kind(),
+        TypeKind::BIGINT,
+        "{} must return BIGINT",
+        name);
+    if (name == "row_number") {
+      return std::make_unique<RowNumberFunction>();
+    }
+    if (name == "rank") {
+      return std::make_unique<RankFunction<false>>();
+    }
+    return std::make_unique<RankFunction<true>>();
+  }
+  return std::make_unique<AggregateWindowFunction>(
+      function, inputType, data, pool, mappedMemory);
+}
+} // namespace
+
+Window::Window(
+    int32_t operatorId,
+    DriverCtx* driverCtx,
+    const std::shared_ptr<const core::WindowNode>& windowNode)
+    : Operator(
+          driverCtx,
+          windowNode->outputType(),
+          operatorId,
+          windowNode->id(),
+          "Window"),
+      outputBatchSize_{static_cast<vector_size_t>(
+          driverCtx->queryConfig().preferredOutputBatchSize())},
+      numInputColumns_(windowNode->sources()[0]->outputType()->size()) {
+  auto inputType = windowNode->sources()[0]->outputType();
+  data_ = std::make_unique<RowContainer>(
+      inputType->children(), operatorCtx_->mappedMemory());
+
+  for (const auto& key : windowNode->partitionKeys()) {
+    auto channel = exprToChannel(key.get(), inputType);
+    VELOX_CHECK(
+        channel != kConstantChannel,
+        "Window doesn't allow constant partition keys");
+    partitionKeyInfo_.emplace_back(channel, core::kAscNullsLast);
+  }
+
+  auto numSortingKeys = windowNode->sortingKeys().size();
+  for (auto i = 0; i < numSortingKeys; ++i) {
+    auto channel =
+        exprToChannel(windowNode->sortingKeys()[i].get(), inputType);
+    VELOX_CHECK(
+        channel != kConstantChannel,
+        "Window doesn't allow constant sorting keys");
+    sortKeyInfo_.emplace_back(channel, windowNode->sortingOrders()[i]);
+  }
+
+  for (const auto& function : windowNode->windowFunctions()) {
+    windowFunctions_.push_back(createWindowFunction(
+        function,
+        inputType,
+        data_.get(),
+        pool(),
+        operatorCtx_->mappedMemory()));
+  }
+}
+
+Window::~Window() = default;
+
+void Window::addInput(RowVectorPtr input) {
+  SelectivityVector allRows(input->size());
+  std::vector<char*> rows(input->size());
+  for (int row = 0; row < input->size(); ++row) {
+    rows[row] = data_->newRow();
+  }
+  LocalDecodedVector decoded(operatorCtx_->execCtx());
+  for (auto col = 0; col < input->childrenSize(); ++col) {
+    decoded.get()->decode(*input->childAt(col), allRows);
+    for (auto i = 0; i < input->size(); ++i) {
+      data_->store(*decoded.get(), i, rows[i], col);
+    }
+  }
+
+  numRows_ += allRows.size();
+}
+
+bool Window::lessThan(const char* lhs, const char* rhs) {
+  for (const auto* keys : {&partitionKeyInfo_, &sortKeyInfo_}) {
+    for (auto& [channel, sortOrder] : *keys) {
+      if (auto result = data_->compare(
+              lhs,
+              rhs,
+              channel,
+              {sortOrder.isNullsFirst(), sortOrder.isAscending(), false})) {
+        return result < 0;
+      }
+    }
+  }
+  return false;
+}
+
+bool Window::equalKeys(
+    const std::vector<std::pair<column_index_t, core::SortOrder>>& keys,
+    const char* lhs,
+    const char* rhs) {
+  for (auto& key : keys) {
+    if (data_->compare(lhs, rhs, key.first)) {
+      return false;
+    }
+  }
+  return true;
+}
+
+void Window::noMoreInput() {
+  Operator::noMoreInput();
+
+  if (numRows_ == 0) {
+    finished_ = true;
+    return;
+  }
+
+  sortedRows_.resize(numRows_);
+  RowContainerIterator iter;
+  data_->listRows(&iter, numRows_, sortedRows_.data());
+
+  std::sort(
+      sortedRows_.begin(),
+      sortedRows_.end(),
+      [this](const char* leftRow, const char* rightRow) {
+        return lessThan(leftRow, rightRow);
+      });
+}
+
+void Window::startNextPartition() {
+  if (partitionSize_ > 0) {
+    // Frees the variable width data of the rows of the finished partition.
+    data_->eraseRows(folly::Range<char**>(
+        sortedRows_.data() + partitionStart_, partitionSize_));
+    partitionStart_ += partitionSize_;
+  }
+
+  if (partitionStart_ == sortedRows_.size()) {
+    partitionSize_ = 0;
+    finished_ = true;
+    return;
+  }
+
+  auto* firstRow = sortedRows_[partitionStart_];
+  vector_size_t end = partitionStart_ + 1;
+  while (end < sortedRows_.size() &&
+         equalKeys(partitionKeyInfo_, firstRow, sortedRows_[end])) {
+    ++end;
+  }
+
+  partitionSize_ = end - partitionStart_;
+  partitionOffset_ = 0;
+  peerStart_ = 0;
+  peerEnd_ = 0;
+
+  folly::Range<char**> partition(
+      sortedRows_.data() + partitionStart_, partitionSize_);
+  for (auto& function : windowFunctions_) {
+    function->resetPartition(partition);
+  }
+}
+
+void Window::computePeerBounds(vector_size_t numRows) {
+  peerStarts_.resize(numRows);
+  peerEnds_.resize(numRows);
+  auto* partition = sortedRows_.data() + partitionStart_;
+  for (auto i = 0; i < numRows; ++i) {
+    auto row = partitionOffset_ + i;
+    if (row >= peerEnd_) {
+      peerStart_ = row;
+      peerEnd_ = row + 1;
+      while (peerEnd_ < partitionSize_ &&
+             equalKeys(sortKeyInfo_, partition[peerStart_], partition[peerEnd_])) {
+        ++peerEnd_;
+      }
+    }
+    peerStarts_[i] = peerStart_;
+    peerEnds_[i] = peerEnd_;
+  }
+}
+
+RowVectorPtr Window::getOutput() {
+  if (finished_ || !noMoreInput_) {
+    return nullptr;
+  }
+
+  if (partitionOffset_ == partitionSize_) {
+    startNextPartition();
+    if (finished_) {
+      return nullptr;
+    }
+  }
+
+  auto numRows = std::min(outputBatchSize_, partitionSize_ - partitionOffset_);
+  auto result = std::dynamic_pointer_cast<RowVector>(
+      BaseVector::create(outputType_, numRows, pool()));
+
+  auto* rows = sortedRows_.data() + partitionStart_ + partitionOffset_;
+  for (auto i = 0; i < numInputColumns_; ++i) {
+    data_->extractColumn(rows, numRows, i, result->childAt(i));
+  }
+
+  computePeerBounds(numRows);
+  for (auto i = 0; i < windowFunctions_.size(); ++i) {
+    windowFunctions_[i]->apply(
+        partitionOffset_,
+        numRows,
+        peerStarts_.data(),
+        peerEnds_.data(),
+        result->childAt(numInputColumns_ + i));
+  }
+
+  partitionOffset_ += numRows;
+  return result;
+}
+
+void Window::close() {
+  windowFunctions_.clear();
+  data_->clear();
+  Operator::close();
+}
+
+} // namespace facebook::velox::exec
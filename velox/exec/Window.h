@@ -0,0 +1,131 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#pragma once
+
+#include "velox/exec/Aggregate.h"
+#include "velox/exec/Operator.h"
+#include "velox/exec/RowContainer.h"
+
+namespace facebook::velox::exec {
+
+class WindowFunction;
+
+/// Window operator implementation: Window stores all its inputs in a
+/// RowContainer as the inputs are added. Once all inputs are available, it
+/// sorts pointers to the rows on partition keys followed by the sorting keys
+/// using the RowContainer's compare() function, the same way OrderBy does.
+/// The output is then produced one partition at a time: each window function
+/// is evaluated incrementally over the rows of the current partition and the
+/// rows of the partition are erased from the RowContainer once the partition
+/// is fully returned.
+///
+/// Supported window functions are row_number, rank, dense_rank and any
+/// registered aggregate function. Aggregate frames where the start of the
+/// frame doesn't move (e.g. UNBOUNDED PRECEDING) are computed by only adding
+/// the rows entering the frame, so running totals are linear in the size of
+/// the partition. Sliding frames are recomputed only when the frame bounds
+/// change.
+class Window : public Operator {
+ public:
+  Window(
+      int32_t operatorId,
+      DriverCtx* driverCtx,
+      const std::shared_ptr<const core::WindowNode>& windowNode);
+
+  ~Window() override;
+
+  bool needsInput() const override {
+    return !noMoreInput_;
+  }
+
+  void addInput(RowVectorPtr input) override;
+
+  void noMoreInput() override;
+
+  RowVectorPtr getOutput() override;
+
+  BlockingReason isBlocked(ContinueFuture* /*future*/) override {
+    return BlockingReason::kNotBlocked;
+  }
+
+  bool isFinished() override {
+    return finished_;
+  }
+
+  void close() override;
+
+ private:
+  // Returns true if 'lhs' sorts before 'rhs' on partition keys followed by
+  // sorting keys.
+  bool lessThan(const char* lhs, const char* rhs);
+
+  // Returns true if 'lhs' and 'rhs' have equal values for all 'keys'.
+  bool equalKeys(
+      const std::vector<std::pair<column_index_t, core::SortOrder>>& keys,
+      const char* lhs,
+      const char* rhs);
+
+  // Finds the end of the partition starting at 'partitionStart_', erases the
+  // rows of the previous partition and resets the window functions.
+  void startNextPartition();
+
+  // Fills 'peerStarts_' and 'peerEnds_' for 'numRows' rows of the current
+  // partition starting at 'partitionOffset_'.
+  void computePeerBounds(vector_size_t numRows);
+
+  const vector_size_t outputBatchSize_;
+
+  const vector_size_t numInputColumns_;
+
+  std::unique_ptr<RowContainer> data_;
+
+  // Partition keys as channels in 'data_'. Partitions are sorted ascending,
+  // nulls last. The order between partitions is not observable.
+  std::vector<std::pair<column_index_t, core::SortOrder>> partitionKeyInfo_;
+
+  // Sorting keys as channels in 'data_'.
+  std::vector<std::pair<column_index_t, core::SortOrder>> sortKeyInfo_;
+
+  std::vector<std::unique_ptr<WindowFunction>> windowFunctions_;
+
+  size_t numRows_ = 0;
+
+  // All input rows in sorted order.
+  std::vector<char*> sortedRows_;
+
+  // Index into 'sortedRows_' of the first row of the current partition.
+  vector_size_t partitionStart_ = 0;
+
+  // Number of rows in the current partition.
+  vector_size_t partitionSize_ = 0;
+
+  // Number of rows of the current partition already returned.
+  vector_size_t partitionOffset_ = 0;
+
+  // Start and end (exclusive) of the peer group of the last row for which
+  // peer bounds were computed, relative to the start of the partition.
+  vector_size_t peerStart_ = 0;
+  vector_size_t peerEnd_ = 0;
+
+  // Peer group bounds, relative to the start of the partition, for the rows
+  // of the output batch being produced.
+  std::vector<vector_size_t> peerStarts_;
+  std::vector<vector_size_t> peerEnds_;
+
+  bool finished_ = false;
+};
+
+} // namespace facebook::velox::exec
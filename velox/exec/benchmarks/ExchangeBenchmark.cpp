@@ -0,0 +1,309 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <folly/Benchmark.h>
+#include <folly/String.h>
+#include <folly/init/Init.h>
+#include <gflags/gflags.h>
+#include <chrono>
+
+#include "velox/exec/Exchange.h"
+#include "velox/exec/Task.h"
+#include "velox/exec/tests/utils/PlanBuilder.h"
+#include "velox/exec/tests/utils/QueryAssertions.h"
+#include "velox/serializers/PrestoSerializer.h"
+#include "velox/vector/fuzzer/VectorFuzzer.h"
+
+DEFINE_int32(num_batches, 64, "Batches produced by each producer task");
+DEFINE_int32(batch_size, 10'000, "Rows per produced batch");
+DEFINE_int32(num_producers, 4, "Producer tasks feeding each consumer");
+DEFINE_string(
+    destination_counts,
+    "1,16,64",
+    "Comma separated numbers of PartitionedOutput destinations to run");
+
+using namespace facebook::velox;
+using namespace facebook::velox::exec;
+using namespace facebook::velox::exec::test;
+
+// Measures PartitionedOutput, the vector serde and Exchange end to end. Each
+// case runs 'num_producers' tasks that hash partition the same batches over a
+// number of destinations and one consumer task per destination that reads
+// its partition from all producers through the in-process ExchangeSource.
+// The column mixes are:
+//  - flat: fixed width scalars.
+//  - dictionary: the same scalars wrapped in dictionaries.
+//  - strings: VARCHARs of varying length.
+//  - nested: ARRAY, MAP and ROW columns.
+// Besides the folly timings, the last run of each case reports rows/s and
+// serialized bytes/s over the wall time, CPU ns per row over all operators
+// and the serialized bytes per row read by the Exchanges.
+namespace {
+
+enum class ColumnMix { kFlat, kDictionary, kStrings, kNested };
+
+std::string mixName(ColumnMix mix) {
+  switch (mix) {
+    case ColumnMix::kFlat:
+      return "flat";
+    case ColumnMix::kDictionary:
+      return "dictionary";
+    case ColumnMix::kStrings:
+      return "strings";
+    case ColumnMix::kNested:
+      return "nested";
+  }
+  VELOX_UNREACHABLE();
+}
+
+RowTypePtr mixType(ColumnMix mix) {
+  switch (mix) {
+    case ColumnMix::kFlat:
+    case ColumnMix::kDictionary:
+      return ROW(
+          {"c0", "c1", "c2", "c3", "c4"},
+          {BIGINT(), INTEGER(), SMALLINT(), DOUBLE(), BIGINT()});
+    case ColumnMix::kStrings:
+      return ROW({"c0", "c1", "c2"}, {BIGINT(), VARCHAR(), VARCHAR()});
+    case ColumnMix::kNested:
+      return ROW(
+          {"c0", "c1", "c2", "c3"},
+          {BIGINT(),
+           ARRAY(BIGINT()),
+           MAP(BIGINT(), VARCHAR()),
+           ROW({"f0", "f1"}, {INTEGER(), VARCHAR()})});
+  }
+  VELOX_UNREACHABLE();
+}
+
+struct RunStats {
+  int64_t rows{0};
+  int64_t serializedBytes{0};
+  int64_t cpuNanos{0};
+  int64_t wallNanos{0};
+};
+
+std::unique_ptr<memory::MemoryPool> pool;
+std::map<ColumnMix, std::vector<RowVectorPtr>> batchesByMix;
+std::map<std::string, RunStats> statsByName;
+std::atomic<int32_t> taskCounter{0};
+
+const std::vector<RowVectorPtr>& getBatches(ColumnMix mix) {
+  auto it = batchesByMix.find(mix);
+  if (it != batchesByMix.end()) {
+    return it->second;
+  }
+  VectorFuzzer::Options options;
+  options.vectorSize = FLAGS_batch_size;
+  options.nullRatio = 0.05;
+  options.stringLength = 40;
+  options.stringVariableLength = true;
+  options.containerLength = 5;
+  options.containerVariableLength = true;
+  VectorFuzzer fuzzer(options, pool.get(), 1);
+  auto rowType = mixType(mix);
+  std::vector<RowVectorPtr> batches;
+  for (auto i = 0; i < FLAGS_num_batches; ++i) {
+    std::vector<VectorPtr> children;
+    for (auto& type : rowType->children()) {
+      auto child = type->isPrimitiveType() ? fuzzer.fuzzFlat(type)
+                                           : fuzzer.fuzzComplex(type);
+      // The partitioning key stays flat.
+      if (mix == ColumnMix::kDictionary && !children.empty()) {
+        child = fuzzer.fuzzDictionary(child);
+      }
+      children.push_back(std::move(child));
+    }
+    batches.push_back(std::make_shared<RowVector>(
+        pool.get(),
+        rowType,
+        nullptr,
+        FLAGS_batch_size,
+        std::move(children)));
+  }
+  return batchesByMix.emplace(mix, std::move(batches)).first->second;
+}
+
+std::shared_ptr<Task> makeTask(
+    const std::string& taskId,
+    const core::PlanNodePtr& plan,
+    int destination,
+    Consumer consumer = nullptr) {
+  return std::make_shared<Task>(
+      taskId,
+      core::PlanFragment{plan},
+      destination,
+      core::QueryCtx::createForTest(),
+      std::move(consumer));
+}
+
+void addStats(const TaskStats& taskStats, RunStats& stats) {
+  for (const auto& pipeline : taskStats.pipelineStats) {
+    for (const auto& op : pipeline.operatorStats) {
+      stats.cpuNanos += op.addInputTiming.cpuNanos +
+          op.getOutputTiming.cpuNanos + op.finishTiming.cpuNanos;
+      if (op.operatorType == "Exchange") {
+        stats.serializedBytes += op.rawInputBytes;
+      }
+    }
+  }
+}
+
+RunStats run(ColumnMix mix, int32_t numDestinations) {
+  const auto& batches = getBatches(mix);
+  auto rowType = mixType(mix);
+  const auto runId = ++taskCounter;
+
+  std::vector<std::string> keys;
+  if (numDestinations > 1) {
+    keys.push_back("c0");
+  }
+  auto producerPlan = PlanBuilder()
+                          .values(batches)
+                          .partitionedOutput(keys, numDestinations)
+                          .planNode();
+  std::vector<std::shared_ptr<Task>> producers;
+  for (auto i = 0; i < FLAGS_num_producers; ++i) {
+    producers.push_back(makeTask(
+        fmt::format("local://producer-{}-{}", runId, i), producerPlan, 0));
+  }
+
+  core::PlanNodeId exchangeId;
+  auto consumerPlan = PlanBuilder()
+                          .exchange(rowType)
+                          .capturePlanNodeId(exchangeId)
+                          .planNode();
+  std::atomic<int64_t> numRows{0};
+  std::vector<std::shared_ptr<Task>> consumers;
+  for (auto i = 0; i < numDestinations; ++i) {
+    consumers.push_back(makeTask(
+        fmt::format("local://consumer-{}-{}", runId, i),
+        consumerPlan,
+        i,
+        [&numRows](RowVectorPtr vector, ContinueFuture* /*future*/) {
+          if (vector) {
+            numRows += vector->size();
+          }
+          return BlockingReason::kNotBlocked;
+        }));
+  }
+
+  const auto start = std::chrono::steady_clock::now();
+  for (auto& producer : producers) {
+    Task::start(producer, 1);
+  }
+  for (auto& consumer : consumers) {
+    Task::start(consumer, 1);
+    for (auto& producer : producers) {
+      consumer->addSplit(
+          exchangeId,
+          Split(std::make_shared<RemoteConnectorSplit>(producer->taskId())));
+    }
+    consumer->noMoreSplits(exchangeId);
+  }
+  for (auto& consumer : consumers) {
+    VELOX_CHECK(waitForTaskCompletion(consumer.get(), 600'000'000));
+  }
+  for (auto& producer : producers) {
+    VELOX_CHECK(waitForTaskCompletion(producer.get(), 600'000'000));
+  }
+  const auto end = std::chrono::steady_clock::now();
+
+  RunStats stats;
+  stats.rows = numRows;
+  stats.wallNanos =
+      std::chrono::duration_cast<std::chrono::nanoseconds>(end - start)
+          .count();
+  for (auto& task : producers) {
+    addStats(task->taskStats(), stats);
+  }
+  for (auto& task : consumers) {
+    addStats(task->taskStats(), stats);
+  }
+  VELOX_CHECK_EQ(
+      stats.rows,
+      static_cast<int64_t>(FLAGS_num_producers) * FLAGS_num_batches *
+          FLAGS_batch_size);
+  return stats;
+}
+
+void addBenchmark(ColumnMix mix, int32_t numDestinations) {
+  auto name = fmt::format("{}_{}dest", mixName(mix), numDestinations);
+  folly::addBenchmark(__FILE__, name, [mix, numDestinations, name]() {
+    {
+      folly::BenchmarkSuspender suspender;
+      getBatches(mix);
+    }
+    statsByName[name] = run(mix, numDestinations);
+    return 1;
+  });
+}
+
+std::vector<int32_t> parseDestinationCounts() {
+  std::vector<std::string> parts;
+  folly::split(',', FLAGS_destination_counts, parts, true);
+  std::vector<int32_t> counts;
+  for (const auto& part : parts) {
+    counts.push_back(folly::to<int32_t>(part));
+  }
+  return counts;
+}
+
+void printStats() {
+  std::cout << fmt::format(
+                   "{:<24} {:>14} {:>14} {:>12} {:>12}",
+                   "case",
+                   "rows/s",
+                   "MB/s",
+                   "cpu ns/row",
+                   "bytes/row")
+            << std::endl;
+  for (const auto& [name, stats] : statsByName) {
+    const double seconds = stats.wallNanos / 1e9;
+    std::cout << fmt::format(
+                     "{:<24} {:>14.0f} {:>14.1f} {:>12.1f} {:>12.1f}",
+                     name,
+                     stats.rows / seconds,
+                     stats.serializedBytes / seconds / (1 << 20),
+                     static_cast<double>(stats.cpuNanos) / stats.rows,
+                     static_cast<double>(stats.serializedBytes) / stats.rows)
+              << std::endl;
+  }
+}
+} // namespace
+
+int main(int argc, char** argv) {
+  folly::init(&argc, &argv);
+  ExchangeSource::registerFactory();
+  if (!isRegisteredVectorSerde()) {
+    serializer::presto::PrestoVectorSerde::registerVectorSerde();
+  }
+  pool = memory::getDefaultScopedMemoryPool();
+  for (auto mix :
+       {ColumnMix::kFlat,
+        ColumnMix::kDictionary,
+        ColumnMix::kStrings,
+        ColumnMix::kNested}) {
+    for (auto numDestinations : parseDestinationCounts()) {
+      addBenchmark(mix, numDestinations);
+    }
+  }
+  folly::runBenchmarks();
+  printStats();
+  batchesByMix.clear();
+  pool.reset();
+  return 0;
+}
@@ -0,0 +1,182 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include <folly/Benchmark.h>
+#include <folly/Random.h>
+#include <folly/init/Init.h>
+#include "velox/exec/RowContainer.h"
+#include "velox/vector/tests/VectorMaker.h"
+
+using namespace facebook::velox;
+using namespace facebook::velox::exec;
+using namespace facebook::velox::test;
+
+namespace {
+// Columns of the RowContainer. SMALLINT has no SIMD gather and serves as a
+// baseline.
+enum Column { kBigint = 0, kInteger, kDouble, kSmallint };
+
+// Extracts a column of 'numRows' rows of a RowContainer. The rows are in
+// random order, as they would be when listed from a hash table.
+void benchmarkExtractColumn(
+    uint32_t iterations,
+    Column column,
+    int32_t numRows,
+    bool withNulls) {
+  folly::BenchmarkSuspender suspender;
+  auto pool = memory::getDefaultScopedMemoryPool();
+  VectorMaker vectorMaker(pool.get());
+  auto nulls = withNulls ? VectorMaker::nullEvery(7) : nullptr;
+  std::vector<VectorPtr> columns = {
+      vectorMaker.flatVector<int64_t>(
+          numRows, [](auto row) { return row; }, nulls),
+      vectorMaker.flatVector<int32_t>(
+          numRows, [](auto row) { return row; }, nulls),
+      vectorMaker.flatVector<double>(
+          numRows, [](auto row) { return row * 0.1; }, nulls),
+      vectorMaker.flatVector<int16_t>(
+          numRows, [](auto row) { return row % 1'000; }, nulls),
+  };
+  std::vector<TypePtr> types;
+  for (auto& vector : columns) {
+    types.push_back(vector->type());
+  }
+  RowContainer data(types, memory::MappedMemory::getInstance());
+  SelectivityVector allRows(numRows);
+  std::vector<char*> rows(numRows);
+  for (auto i = 0; i < numRows; ++i) {
+    rows[i] = data.newRow();
+  }
+  for (auto i = 0; i < columns.size(); ++i) {
+    DecodedVector decoded(*columns[i], allRows);
+    for (auto row = 0; row < numRows; ++row) {
+      data.store(decoded, row, rows[row], i);
+    }
+  }
+  folly::Random::DefaultGenerator rng(1);
+  std::shuffle(rows.begin(), rows.end(), rng);
+  auto result = BaseVector::create(types[column], numRows, pool.get());
+  suspender.dismiss();
+
+  for (auto i = 0; i < iterations; ++i) {
+    data.extractColumn(rows.data(), numRows, column, result);
+    folly::doNotOptimizeAway(result);
+  }
+}
+} // namespace
+
+BENCHMARK_NAMED_PARAM(
+    benchmarkExtractColumn,
+    bigint_1K,
+    kBigint,
+    1'000,
+    false);
+BENCHMARK_RELATIVE_NAMED_PARAM(
+    benchmarkExtractColumn,
+    integer_1K,
+    kInteger,
+    1'000,
+    false);
+BENCHMARK_RELATIVE_NAMED_PARAM(
+    benchmarkExtractColumn,
+    double_1K,
+    kDouble,
+    1'000,
+    false);
+BENCHMARK_RELATIVE_NAMED_PARAM(
+    benchmarkExtractColumn,
+    smallint_1K,
+    kSmallint,
+    1'000,
+    false);
+BENCHMARK_RELATIVE_NAMED_PARAM(
+    benchmarkExtractColumn,
+    bigintNulls_1K,
+    kBigint,
+    1'000,
+    true);
+
+BENCHMARK_DRAW_LINE();
+
+BENCHMARK_NAMED_PARAM(
+    benchmarkExtractColumn,
+    bigint_10K,
+    kBigint,
+    10'000,
+    false);
+BENCHMARK_RELATIVE_NAMED_PARAM(
+    benchmarkExtractColumn,
+    integer_10K,
+    kInteger,
+    10'000,
+    false);
+BENCHMARK_RELATIVE_NAMED_PARAM(
+    benchmarkExtractColumn,
+    double_10K,
+    kDouble,
+    10'000,
+    false);
+BENCHMARK_RELATIVE_NAMED_PARAM(
+    benchmarkExtractColumn,
+    smallint_10K,
+    kSmallint,
+    10'000,
+    false);
+BENCHMARK_RELATIVE_NAMED_PARAM(
+    benchmarkExtractColumn,
+    bigintNulls_10K,
+    kBigint,
+    10'000,
+    true);
+
+BENCHMARK_DRAW_LINE();
+
+// 1M rows do not fit in the CPU caches.
+BENCHMARK_NAMED_PARAM(
+    benchmarkExtractColumn,
+    bigint_1M,
+    kBigint,
+    1'000'000,
+    false);
+BENCHMARK_RELATIVE_NAMED_PARAM(
+    benchmarkExtractColumn,
+    integer_1M,
+    kInteger,
+    1'000'000,
+    false);
+BENCHMARK_RELATIVE_NAMED_PARAM(
+    benchmarkExtractColumn,
+    double_1M,
+    kDouble,
+    1'000'000,
+    false);
+BENCHMARK_RELATIVE_NAMED_PARAM(
+    benchmarkExtractColumn,
+    smallint_1M,
+    kSmallint,
+    1'000'000,
+    false);
+BENCHMARK_RELATIVE_NAMED_PARAM(
+    benchmarkExtractColumn,
+    bigintNulls_1M,
+    kBigint,
+    1'000'000,
+    true);
+
+int main(int argc, char** argv) {
+  folly::init(&argc, &argv);
+  folly::runBenchmarks();
+  return 0;
+}
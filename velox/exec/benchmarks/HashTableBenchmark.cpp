@@ -0,0 +1,497 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <folly/Benchmark.h>
+#include <folly/Random.h>
+#include <folly/init/Init.h>
+#include <gflags/gflags.h>
+#include <numeric>
+
+#include "velox/exec/HashBuild.h"
+#include "velox/exec/HashTable.h"
+#include "velox/exec/VectorHasher.h"
+#include "velox/vector/tests/VectorMaker.h"
+
+DEFINE_int64(max_size, 10'000'000, "Largest table size in distinct keys");
+DEFINE_int32(num_duplicates, 4, "Build side rows per key of join tables");
+DEFINE_int32(
+    hit_pct,
+    100,
+    "Percentage of join probe rows that have a match in the table");
+DEFINE_int32(
+    hot_pct,
+    0,
+    "Percentage of probe rows that go to the 1% of keys first inserted");
+
+using namespace facebook::velox;
+using namespace facebook::velox::exec;
+using namespace facebook::velox::test;
+
+// Measures the throughput of HashTable probes per probed row and the memory
+// per entry of the table for each hash mode, with tables ranging from cache
+// resident to well past the last level cache. The hash modes are decided by
+// the table from the keys, so each mode has its own key layout:
+//  - kArray: a single dense BIGINT key. Only up to 1M keys fit an array.
+//  - kNormalizedKey: two sparse BIGINT keys whose ranges multiply to more
+//    than an array can hold.
+//  - kNormalizedKey128: three BIGINT keys whose ranges multiply to more
+//    than 64 bits. These have too many distinct values for distinct ids
+//    only from 1M keys on. Only join builds use this mode.
+//  - kHash: the same two BIGINT keys or a VARCHAR key that does not fit
+//    inline, with the generic hash mode forced.
+// The probe times include computing the hashes or value ids of the keys, as
+// HashProbe and GroupingSet do.
+namespace {
+
+constexpr int32_t kBatchSize = 1'024;
+constexpr int32_t kNumProbeRows = 1 << 20;
+
+enum class KeyKind {
+  kDenseBigint,
+  kSparseBigintPair,
+  kSparseBigintTriple,
+  kVarchar
+};
+
+// kJoinProbe probes the rows of a batch in their order. kPartitionedJoinProbe
+// groups them by region of the table first, also for tables below the size
+// at which prepareJoinTable() enables this.
+enum class ProbeKind {
+  kGroupProbe,
+  kJoinProbe,
+  kPartitionedJoinProbe,
+  kListJoinResults
+};
+
+struct TableParams {
+  BaseHashTable::HashMode mode;
+  KeyKind keyKind;
+  int64_t size;
+  bool isJoin;
+
+  bool operator==(const TableParams& other) const {
+    return mode == other.mode && keyKind == other.keyKind &&
+        size == other.size && isJoin == other.isJoin;
+  }
+};
+
+std::string modeName(BaseHashTable::HashMode mode) {
+  switch (mode) {
+    case BaseHashTable::HashMode::kArray:
+      return "array";
+    case BaseHashTable::HashMode::kNormalizedKey:
+      return "normalizedKey";
+    case BaseHashTable::HashMode::kNormalizedKey128:
+      return "normalizedKey128";
+    case BaseHashTable::HashMode::kHash:
+      return "hash";
+  }
+  VELOX_UNREACHABLE();
+}
+
+std::string keyName(KeyKind kind) {
+  switch (kind) {
+    case KeyKind::kDenseBigint:
+      return "bigint";
+    case KeyKind::kSparseBigintPair:
+      return "bigint_pair";
+    case KeyKind::kSparseBigintTriple:
+      return "bigint_triple";
+    case KeyKind::kVarchar:
+      return "varchar";
+  }
+  VELOX_UNREACHABLE();
+}
+
+std::string sizeName(int64_t size) {
+  if (size >= 1'000'000) {
+    return fmt::format("{}M", size / 1'000'000);
+  }
+  if (size >= 1'000) {
+    return fmt::format("{}K", size / 1'000);
+  }
+  return std::to_string(size);
+}
+
+// A hash table with its keys and a set of probe batches.
+class HashTableFixture {
+ public:
+  explicit HashTableFixture(const TableParams& params) : params_(params) {
+    makeProbeBatches();
+    if (params_.isJoin) {
+      makeJoinTable();
+    } else {
+      makeGroupTable();
+    }
+    VELOX_CHECK(
+        table_->hashMode() == params_.mode,
+        "Expected {} hash mode, got {}",
+        modeName(params_.mode),
+        modeName(table_->hashMode()));
+  }
+
+  const TableParams& params() const {
+    return params_;
+  }
+
+  double bytesPerEntry() const {
+    return table_->allocatedBytes() /
+        static_cast<double>(table_->rows()->numRows());
+  }
+
+  // Probes a group by table with keys that are all in the table. Returns
+  // the number of probed rows.
+  int64_t groupProbe() {
+    HashLookup lookup(table_->hashers());
+    for (const auto& batch : probeBatches_) {
+      const SelectivityVector rows(batch->size());
+      lookup.reset(batch->size());
+      std::iota(lookup.rows.begin(), lookup.rows.end(), 0);
+      hashGroupKeys(*batch, rows, lookup);
+      table_->groupProbe(lookup);
+      folly::doNotOptimizeAway(lookup.hits);
+    }
+    return kNumProbeRows;
+  }
+
+  void setPartitionedJoinProbe(bool enable) {
+    table_->setPartitionedJoinProbe(enable);
+  }
+
+  // Probes a join table. Lists all matches of the probe rows if
+  // 'listResults' is true. Returns the number of probed rows.
+  int64_t joinProbe(bool listResults) {
+    HashLookup lookup(table_->hashers());
+    VectorHasher::ScratchMemory scratchMemory;
+    BaseHashTable::JoinResultIterator results;
+    std::vector<vector_size_t> resultRows(kBatchSize);
+    std::vector<char*> resultHits(kBatchSize);
+    SelectivityVector rows(kBatchSize);
+    int64_t numResults = 0;
+    for (const auto& batch : probeBatches_) {
+      rows.resizeFill(batch->size(), true);
+      lookup.reset(batch->size());
+      const auto& hashers = table_->hashers();
+      for (auto i = 0; i < hashers.size(); ++i) {
+        const auto& key = *batch->childAt(i);
+        if (table_->hashMode() == BaseHashTable::HashMode::kHash) {
+          hashers[i]->hash(key, rows, i > 0, lookup.hashes);
+        } else {
+          hashers[i]->lookupValueIds(
+              key, rows, scratchMemory, table_->valueIds(lookup, i));
+        }
+      }
+      lookup.rows.clear();
+      rows.applyToSelected([&](auto row) { lookup.rows.push_back(row); });
+      if (lookup.rows.empty()) {
+        continue;
+      }
+      table_->joinProbe(lookup);
+      if (!listResults) {
+        folly::doNotOptimizeAway(lookup.hits);
+        continue;
+      }
+      results.reset(lookup);
+      while (!results.atEnd()) {
+        numResults += table_->listJoinResults(
+            results,
+            false,
+            folly::Range(resultRows.data(), resultRows.size()),
+            folly::Range(resultHits.data(), resultHits.size()),
+            RowContainer::kUnlimited);
+      }
+    }
+    folly::doNotOptimizeAway(numResults);
+    return kNumProbeRows;
+  }
+
+ private:
+  int32_t numKeyColumns() const {
+    switch (params_.keyKind) {
+      case KeyKind::kSparseBigintPair:
+        return 2;
+      case KeyKind::kSparseBigintTriple:
+        return 3;
+      default:
+        return 1;
+    }
+  }
+
+  // Makes a batch with the key columns of the keys numbered 'keys', followed
+  // by a BIGINT payload column.
+  RowVectorPtr makeBatch(const std::vector<int64_t>& keys) {
+    const auto size = keys.size();
+    std::vector<VectorPtr> columns;
+    switch (params_.keyKind) {
+      case KeyKind::kDenseBigint:
+        columns.push_back(vectorMaker_.flatVector<int64_t>(
+            size, [&](auto row) { return keys[row]; }));
+        break;
+      case KeyKind::kSparseBigintPair:
+        // Both columns have as many distinct values as there are keys, so
+        // the product of their ranges is too large for an array.
+        columns.push_back(vectorMaker_.flatVector<int64_t>(
+            size, [&](auto row) { return keys[row] * 3; }));
+        columns.push_back(vectorMaker_.flatVector<int64_t>(
+            size, [&](auto row) { return keys[row] * 7; }));
+        break;
+      case KeyKind::kSparseBigintTriple:
+        // The ranges of two columns multiply to less than 64 bits and the
+        // ranges of all three to more.
+        for (auto i = 0; i < 3; ++i) {
+          columns.push_back(vectorMaker_.flatVector<int64_t>(
+              size, [&](auto row) { return keys[row] * 16 + i; }));
+        }
+        break;
+      case KeyKind::kVarchar: {
+        std::vector<std::string> strings(size);
+        for (auto i = 0; i < size; ++i) {
+          strings[i] = fmt::format("key-{:016}", keys[i]);
+        }
+        columns.push_back(vectorMaker_.flatVector(strings));
+        break;
+      }
+    }
+    columns.push_back(vectorMaker_.flatVector<int64_t>(
+        size, [&](auto row) { return keys[row]; }));
+    return vectorMaker_.rowVector(columns);
+  }
+
+  std::vector<std::unique_ptr<VectorHasher>> makeHashers() {
+    std::vector<std::unique_ptr<VectorHasher>> hashers;
+    const auto keyType =
+        params_.keyKind == KeyKind::kVarchar ? VARCHAR() : BIGINT();
+    for (auto i = 0; i < numKeyColumns(); ++i) {
+      hashers.push_back(std::make_unique<VectorHasher>(keyType, i));
+    }
+    return hashers;
+  }
+
+  template <typename Func>
+  void forEachBuildBatch(Func func) {
+    const auto numCopies = params_.isJoin ? FLAGS_num_duplicates : 1;
+    std::vector<int64_t> keys;
+    for (auto copy = 0; copy < numCopies; ++copy) {
+      for (int64_t start = 0; start < params_.size; start += kBatchSize) {
+        keys.resize(std::min<int64_t>(kBatchSize, params_.size - start));
+        std::iota(keys.begin(), keys.end(), start);
+        func(*makeBatch(keys));
+      }
+    }
+  }
+
+  // Computes the hashes or value ids for a group by probe. Reconsiders the
+  // hash mode and retries if the keys do not fit the value ids.
+  void hashGroupKeys(
+      const RowVector& input,
+      const SelectivityVector& rows,
+      HashLookup& lookup) {
+    const auto& hashers = table_->hashers();
+    bool rehash = false;
+    for (auto i = 0; i < hashers.size(); ++i) {
+      const auto& key = *input.childAt(i);
+      if (table_->hashMode() == BaseHashTable::HashMode::kHash) {
+        hashers[i]->hash(key, rows, i > 0, lookup.hashes);
+      } else if (!hashers[i]->computeValueIds(
+                     key, rows, table_->valueIds(lookup, i))) {
+        rehash = true;
+      }
+    }
+    if (rehash) {
+      table_->decideHashMode(input.size());
+      hashGroupKeys(input, rows, lookup);
+    }
+  }
+
+  void makeGroupTable() {
+    table_ = HashTable<false>::createForAggregation(
+        makeHashers(), kNoAggregates_, memory::MappedMemory::getInstance());
+    if (params_.mode == BaseHashTable::HashMode::kHash) {
+      table_->forceGenericHashMode();
+    }
+    HashLookup lookup(table_->hashers());
+    forEachBuildBatch([&](const RowVector& batch) {
+      const SelectivityVector rows(batch.size());
+      lookup.reset(batch.size());
+      std::iota(lookup.rows.begin(), lookup.rows.end(), 0);
+      hashGroupKeys(batch, rows, lookup);
+      table_->groupProbe(lookup);
+    });
+  }
+
+  void makeJoinTable() {
+    table_ = HashTable<true>::createForJoin(
+        makeHashers(),
+        {BIGINT()},
+        true, // allowDuplicates
+        false, // hasProbedFlag
+        memory::MappedMemory::getInstance());
+    if (params_.mode == BaseHashTable::HashMode::kHash) {
+      table_->forceGenericHashMode();
+    }
+    bool analyzeKeys = params_.mode != BaseHashTable::HashMode::kHash;
+    const std::vector<column_index_t> dependentChannels = {
+        static_cast<column_index_t>(numKeyColumns())};
+    std::vector<std::unique_ptr<DecodedVector>> decoders;
+    decoders.push_back(std::make_unique<DecodedVector>());
+    raw_vector<uint64_t> hashes;
+    forEachBuildBatch([&](const RowVector& batch) {
+      addJoinBuildRows(
+          *table_,
+          batch,
+          SelectivityVector(batch.size()),
+          dependentChannels,
+          decoders,
+          analyzeKeys,
+          hashes);
+    });
+    table_->prepareJoinTable({});
+  }
+
+  // Makes probe batches in random key order. 'hot_pct' percent of the rows
+  // go to the first 1% of the keys. For a join, 100 - 'hit_pct' percent of
+  // the rows have keys that are not in the table.
+  void makeProbeBatches() {
+    folly::Random::DefaultGenerator rng;
+    rng.seed(1);
+    const auto numHotKeys = std::max<int64_t>(1, params_.size / 100);
+    std::vector<int64_t> keys(kBatchSize);
+    for (auto start = 0; start < kNumProbeRows; start += kBatchSize) {
+      for (auto& key : keys) {
+        if (folly::Random::rand32(100, rng) < FLAGS_hot_pct) {
+          key = folly::Random::rand64(numHotKeys, rng);
+        } else {
+          key = folly::Random::rand64(params_.size, rng);
+          if (params_.isJoin &&
+              folly::Random::rand32(100, rng) >= FLAGS_hit_pct) {
+            key += params_.size;
+          }
+        }
+      }
+      probeBatches_.push_back(makeBatch(keys));
+    }
+  }
+
+  static inline const std::vector<std::unique_ptr<Aggregate>> kNoAggregates_;
+
+  const TableParams params_;
+  std::unique_ptr<memory::MemoryPool> pool_{
+      memory::getDefaultScopedMemoryPool()};
+  VectorMaker vectorMaker_{pool_.get()};
+  std::unique_ptr<BaseHashTable> table_;
+  std::vector<RowVectorPtr> probeBatches_;
+};
+
+// The benchmarks of a table run back to back, so only the last table is
+// kept to bound the memory.
+std::unique_ptr<HashTableFixture> fixture;
+
+// Bytes per entry of each table, printed after the benchmarks.
+std::vector<std::pair<std::string, double>> bytesPerEntry;
+
+HashTableFixture& getFixture(const TableParams& params) {
+  if (!fixture || !(fixture->params() == params)) {
+    fixture.reset();
+    fixture = std::make_unique<HashTableFixture>(params);
+    bytesPerEntry.emplace_back(
+        fmt::format(
+            "{}_{}_{}_{}",
+            params.isJoin ? "join" : "group",
+            modeName(params.mode),
+            keyName(params.keyKind),
+            sizeName(params.size)),
+        fixture->bytesPerEntry());
+  }
+  return *fixture;
+}
+
+void addBenchmark(const TableParams& params, ProbeKind probeKind) {
+  static const char* kProbeNames[] = {
+      "groupProbe", "joinProbe", "partitionedJoinProbe", "listJoinResults"};
+  const auto name = fmt::format(
+      "{}_{}_{}_{}",
+      kProbeNames[static_cast<int32_t>(probeKind)],
+      modeName(params.mode),
+      keyName(params.keyKind),
+      sizeName(params.size));
+  folly::addBenchmark(__FILE__, name, [params, probeKind](unsigned iters) {
+    folly::BenchmarkSuspender suspender;
+    auto& table = getFixture(params);
+    if (params.isJoin) {
+      table.setPartitionedJoinProbe(
+          probeKind == ProbeKind::kPartitionedJoinProbe);
+    }
+    suspender.dismiss();
+    int64_t numRows = 0;
+    for (auto i = 0; i < iters; ++i) {
+      numRows += probeKind == ProbeKind::kGroupProbe
+          ? table.groupProbe()
+          : table.joinProbe(probeKind == ProbeKind::kListJoinResults);
+    }
+    return static_cast<unsigned>(numRows);
+  });
+}
+
+void addBenchmarks() {
+  struct Layout {
+    BaseHashTable::HashMode mode;
+    KeyKind keyKind;
+  };
+  const std::vector<Layout> layouts = {
+      {BaseHashTable::HashMode::kArray, KeyKind::kDenseBigint},
+      {BaseHashTable::HashMode::kNormalizedKey, KeyKind::kSparseBigintPair},
+      {BaseHashTable::HashMode::kNormalizedKey128,
+       KeyKind::kSparseBigintTriple},
+      {BaseHashTable::HashMode::kHash, KeyKind::kSparseBigintPair},
+      {BaseHashTable::HashMode::kHash, KeyKind::kVarchar}};
+  for (const int64_t size : {1'000, 64'000, 1'000'000, 10'000'000}) {
+    if (size > FLAGS_max_size) {
+      break;
+    }
+    for (const auto& layout : layouts) {
+      if (layout.mode == BaseHashTable::HashMode::kArray &&
+          size > BaseHashTable::kArrayHashMaxSize / 2) {
+        continue;
+      }
+      if (layout.mode == BaseHashTable::HashMode::kNormalizedKey128 &&
+          size < 1'000'000) {
+        continue;
+      }
+      const TableParams groupParams{layout.mode, layout.keyKind, size, false};
+      const TableParams joinParams{layout.mode, layout.keyKind, size, true};
+      // Only join builds use kNormalizedKey128.
+      if (layout.mode != BaseHashTable::HashMode::kNormalizedKey128) {
+        addBenchmark(groupParams, ProbeKind::kGroupProbe);
+      }
+      addBenchmark(joinParams, ProbeKind::kJoinProbe);
+      addBenchmark(joinParams, ProbeKind::kPartitionedJoinProbe);
+      addBenchmark(joinParams, ProbeKind::kListJoinResults);
+    }
+  }
+}
+} // namespace
+
+int main(int argc, char** argv) {
+  folly::init(&argc, &argv);
+  addBenchmarks();
+  folly::runBenchmarks();
+  fixture.reset();
+  std::cout << "Bytes per entry:" << std::endl;
+  for (const auto& [name, bytes] : bytesPerEntry) {
+    std::cout << fmt::format("{:<40} {:>8.1f}", name, bytes) << std::endl;
+  }
+  return 0;
+}
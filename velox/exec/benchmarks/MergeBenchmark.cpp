@@ -18,7 +18,11 @@
 #include <gflags/gflags.h>
 
 #include "velox/exec/TreeOfLosers.h"
+#include "velox/exec/tests/utils/AssertQueryBuilder.h"
 #include "velox/exec/tests/utils/MergeTestBase.h"
+#include "velox/exec/tests/utils/PlanBuilder.h"
+#include "velox/parse/TypeResolver.h"
+#include "velox/vector/tests/VectorMaker.h"
 
 using namespace facebook::velox;
 using namespace facebook::velox::exec::test;
@@ -27,6 +31,51 @@ TestData narrow;
 TestData medium;
 TestData wide;
 
+std::unique_ptr<memory::MemoryPool> pool;
+
+// LocalMerge inputs of 'kNumSources' sorted sources. In 'runs' each source
+// covers its own range of keys, so the same source wins long runs of pops. In
+// 'interleaved' the sources take turns.
+constexpr int32_t kNumSources = 8;
+core::PlanNodePtr runs;
+core::PlanNodePtr interleaved;
+
+core::PlanNodePtr makeLocalMerge(
+    std::function<int64_t(int32_t source, vector_size_t row)> key) {
+  constexpr int32_t kNumBatches = 100;
+  constexpr vector_size_t kBatchSize = 10'000;
+  test::VectorMaker vectorMaker(pool.get());
+  auto planNodeIdGenerator = std::make_shared<PlanNodeIdGenerator>();
+  std::vector<core::PlanNodePtr> sources;
+  for (auto source = 0; source < kNumSources; ++source) {
+    std::vector<RowVectorPtr> batches;
+    for (auto batch = 0; batch < kNumBatches; ++batch) {
+      batches.push_back(vectorMaker.rowVector({
+          vectorMaker.flatVector<int64_t>(
+              kBatchSize,
+              [&](auto row) {
+                return key(source, batch * kBatchSize + row);
+              }),
+          vectorMaker.flatVector<double>(
+              kBatchSize, [](auto row) { return row * 0.1; }),
+      }));
+    }
+    sources.push_back(
+        PlanBuilder(planNodeIdGenerator).values(batches).planNode());
+  }
+  return PlanBuilder(planNodeIdGenerator)
+      .localMerge({"c0"}, std::move(sources))
+      .planNode();
+}
+
+BENCHMARK(localMergeRuns) {
+  AssertQueryBuilder(runs).copyResults(pool.get());
+}
+
+BENCHMARK_RELATIVE(localMergeInterleaved) {
+  AssertQueryBuilder(interleaved).copyResults(pool.get());
+}
+
 BENCHMARK(narrowTree) {
   MergeTestBase::test<TreeOfLosers<TestingStream>>(narrow, false);
 }
@@ -58,6 +107,14 @@ int main(int argc, char* argv[]) {
   narrow = test.makeTestData(100'000'000, 7);
   medium = test.makeTestData(10'000'0000, 37);
   wide = test.makeTestData(10'000'0000, 1029);
+
+  parse::registerTypeResolver();
+  pool = memory::getDefaultScopedMemoryPool();
+  runs = makeLocalMerge([](auto source, auto row) {
+    return static_cast<int64_t>(source) << 32 | row;
+  });
+  interleaved = makeLocalMerge(
+      [](auto source, auto row) { return row * kNumSources + source; });
   folly::runBenchmarks();
   return 0;
 }
@@ -0,0 +1,302 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <folly/executors/IOThreadPoolExecutor.h>
+#include <folly/init/Init.h>
+#include <gflags/gflags.h>
+#include <sys/resource.h>
+#include <chrono>
+
+#include "velox/common/file/FileSystems.h"
+#include "velox/common/memory/MemoryUsageTracker.h"
+#include "velox/exec/OperatorUtils.h"
+#include "velox/exec/Spiller.h"
+#include "velox/serializers/CompactRowSerializer.h"
+#include "velox/serializers/PrestoSerializer.h"
+#include "velox/vector/DecodedVector.h"
+#include "velox/vector/fuzzer/VectorFuzzer.h"
+
+DEFINE_string(
+    spill_dir,
+    "/tmp",
+    "Directory for the spill files, e.g. on local NVMe or tmpfs");
+DEFINE_int32(num_rows, 1'000'000, "Rows in the RowContainer per case");
+DEFINE_string(
+    compression,
+    "none",
+    "Codec of the spill files: none, lz4, zstd, zlib or snappy");
+DEFINE_string(
+    spill_serde,
+    "presto",
+    "Serialization format of the spill files: presto or compact_row");
+DEFINE_int32(num_threads, 8, "Threads of the spill executor");
+
+using namespace facebook::velox;
+using namespace facebook::velox::exec;
+
+// Measures spilling a RowContainer through Spiller and merging the spilled
+// runs back through SpillStream and TreeOfLosers. Each case fills a
+// RowContainer with 'num_rows' fuzzed rows of a key and payload shape,
+// spills all of it sorted on the keys over a number of hash partitions with
+// a number of rows per serialized batch, and then merges each partition
+// back in key order. For each case this prints the write and read bandwidth
+// over the spilled file bytes, the process CPU per row of each phase, and
+// the peak bytes of the RowContainer and the spill state. Run it once per
+// --spill_dir, --compression and --spill_serde to compare devices and file
+// formats.
+namespace {
+
+// Named column types of the keys or the payload of a case.
+struct Shape {
+  std::string name;
+  std::vector<TypePtr> types;
+};
+
+struct CaseStats {
+  int64_t spilledBytes{0};
+  int64_t uncompressedBytes{0};
+  int64_t writeNanos{0};
+  int64_t writeCpuNanos{0};
+  int64_t readNanos{0};
+  int64_t readCpuNanos{0};
+  int64_t readRows{0};
+  int64_t peakBytes{0};
+};
+
+int64_t processCpuNanos() {
+  struct rusage usage;
+  getrusage(RUSAGE_SELF, &usage);
+  auto toNanos = [](const timeval& time) {
+    return time.tv_sec * 1'000'000'000L + time.tv_usec * 1'000L;
+  };
+  return toNanos(usage.ru_utime) + toNanos(usage.ru_stime);
+}
+
+int64_t nowNanos() {
+  return std::chrono::duration_cast<std::chrono::nanoseconds>(
+             std::chrono::steady_clock::now().time_since_epoch())
+      .count();
+}
+
+class SpillBenchmark {
+ public:
+  SpillBenchmark()
+      : executor_(
+            std::make_unique<folly::IOThreadPoolExecutor>(FLAGS_num_threads)),
+        compression_(compressionCodec(FLAGS_compression, "spill")) {}
+
+  CaseStats run(
+      const Shape& keys,
+      const Shape& payload,
+      int32_t numPartitionBits,
+      int32_t maxBatchRows) {
+    auto tracker = memory::MemoryUsageTracker::create();
+    auto mappedMemory = memory::MappedMemory::getInstance()->addChild(tracker);
+    auto pool = memory::getDefaultScopedMemoryPool();
+    pool->setMemoryUsageTracker(tracker);
+
+    auto data = std::make_unique<RowContainer>(
+        keys.types, payload.types, mappedMemory.get());
+    auto rowType = fill(*data, keys.types, payload.types, *pool);
+
+    CaseStats stats;
+    auto spiller = std::make_unique<Spiller>(
+        *data,
+        [&](folly::Range<char**> rows) { data->eraseRows(rows); },
+        rowType,
+        HashBitRange(29, 29 + numPartitionBits),
+        keys.types.size(),
+        fmt::format("{}/spill-benchmark-{}", FLAGS_spill_dir, ++caseCounter_),
+        1L << 30,
+        *pool,
+        executor_.get(),
+        std::vector<CompareFlags>{},
+        compression_,
+        0,
+        maxBatchRows);
+
+    auto startCpu = processCpuNanos();
+    auto start = nowNanos();
+    RowContainerIterator iterator;
+    spiller->spill(0, 0, iterator);
+    VELOX_CHECK(spiller->finishSpill().empty());
+    stats.writeNanos = nowNanos() - start;
+    stats.writeCpuNanos = processCpuNanos() - startCpu;
+    stats.spilledBytes = spiller->spilledBytesAndRows().first;
+    stats.uncompressedBytes = spiller->spilledUncompressedBytes();
+
+    startCpu = processCpuNanos();
+    start = nowNanos();
+    for (auto partition = 0; partition < (1 << numPartitionBits);
+         ++partition) {
+      if (!spiller->isSpilled(partition)) {
+        continue;
+      }
+      auto merge = spiller->startMerge(partition);
+      while (auto stream = merge->next()) {
+        ++stats.readRows;
+        stream->pop();
+      }
+    }
+    stats.readNanos = nowNanos() - start;
+    stats.readCpuNanos = processCpuNanos() - startCpu;
+    VELOX_CHECK_EQ(stats.readRows, FLAGS_num_rows);
+    stats.peakBytes = tracker->getPeakTotalBytes();
+    spiller.reset();
+    data.reset();
+    return stats;
+  }
+
+ private:
+  // Stores 'num_rows' fuzzed rows into 'data' and returns the row type of
+  // the spilled data.
+  RowTypePtr fill(
+      RowContainer& data,
+      const std::vector<TypePtr>& keyTypes,
+      const std::vector<TypePtr>& payloadTypes,
+      memory::MemoryPool& pool) {
+    constexpr vector_size_t kBatchSize = 10'000;
+    std::vector<std::string> names;
+    std::vector<TypePtr> types;
+    for (const auto& type : keyTypes) {
+      names.push_back(fmt::format("c{}", names.size()));
+      types.push_back(type);
+    }
+    for (const auto& type : payloadTypes) {
+      names.push_back(fmt::format("c{}", names.size()));
+      types.push_back(type);
+    }
+    auto rowType = ROW(std::move(names), std::move(types));
+
+    VectorFuzzer::Options options;
+    options.vectorSize = kBatchSize;
+    options.nullRatio = 0.05;
+    options.stringLength = 30;
+    options.stringVariableLength = true;
+    options.containerLength = 5;
+    options.containerVariableLength = true;
+    VectorFuzzer fuzzer(options, &pool, 1);
+    SelectivityVector allRows(kBatchSize);
+    DecodedVector decoded;
+    std::vector<char*> rows(kBatchSize);
+    for (auto numRows = 0; numRows < FLAGS_num_rows; numRows += kBatchSize) {
+      const auto batchSize = std::min(kBatchSize, FLAGS_num_rows - numRows);
+      for (auto i = 0; i < batchSize; ++i) {
+        rows[i] = data.newRow();
+      }
+      for (auto column = 0; column < rowType->size(); ++column) {
+        const auto& type = rowType->childAt(column);
+        auto vector = type->isPrimitiveType() ? fuzzer.fuzzFlat(type)
+                                              : fuzzer.fuzzComplex(type);
+        decoded.decode(*vector, allRows);
+        for (auto i = 0; i < batchSize; ++i) {
+          data.store(decoded, i, rows[i], column);
+        }
+      }
+    }
+    return rowType;
+  }
+
+  std::unique_ptr<folly::IOThreadPoolExecutor> executor_;
+  const folly::io::CodecType compression_;
+  int32_t caseCounter_{0};
+};
+
+void printStats(
+    const std::string& name,
+    const CaseStats& stats,
+    bool printHeader) {
+  if (printHeader) {
+    std::cout << fmt::format(
+                     "{:<36} {:>10} {:>10} {:>10} {:>10} {:>10} {:>10}",
+                     "case",
+                     "file MB",
+                     "ratio",
+                     "write MB/s",
+                     "read MB/s",
+                     "write ns/r",
+                     "read ns/r")
+              << " peak MB" << std::endl;
+  }
+  constexpr double kMB = 1 << 20;
+  const double megabytes = stats.spilledBytes / kMB;
+  std::cout << fmt::format(
+                   "{:<36} {:>10.1f} {:>10.2f} {:>10.1f} {:>10.1f} "
+                   "{:>10.1f} {:>10.1f} {:>8.1f}",
+                   name,
+                   megabytes,
+                   static_cast<double>(stats.uncompressedBytes) /
+                       stats.spilledBytes,
+                   megabytes / (stats.writeNanos / 1e9),
+                   megabytes / (stats.readNanos / 1e9),
+                   static_cast<double>(stats.writeCpuNanos) / stats.readRows,
+                   static_cast<double>(stats.readCpuNanos) / stats.readRows,
+                   stats.peakBytes / kMB)
+            << std::endl;
+}
+} // namespace
+
+int main(int argc, char** argv) {
+  folly::init(&argc, &argv);
+  filesystems::registerLocalFileSystem();
+  if (FLAGS_spill_serde == "compact_row") {
+    registerVectorSerde(std::make_unique<serializer::CompactRowVectorSerde>());
+  } else {
+    VELOX_USER_CHECK_EQ(FLAGS_spill_serde, "presto", "Unknown --spill_serde");
+    serializer::presto::PrestoVectorSerde::registerVectorSerde();
+  }
+
+  const std::vector<Shape> keyShapes = {
+      {"bigint", {BIGINT()}},
+      {"bigint2", {BIGINT(), BIGINT()}},
+      {"varchar", {VARCHAR()}}};
+  const std::vector<Shape> payloadShapes = {
+      {"narrow", {BIGINT(), DOUBLE()}},
+      {"wide",
+       {INTEGER(),
+        BIGINT(),
+        BIGINT(),
+        REAL(),
+        DOUBLE(),
+        DOUBLE(),
+        VARCHAR(),
+        VARCHAR()}},
+      {"nested", {ARRAY(BIGINT()), MAP(INTEGER(), VARCHAR())}}};
+
+  SpillBenchmark benchmark;
+  bool printHeader = true;
+  for (const auto& keys : keyShapes) {
+    for (const auto& payload : payloadShapes) {
+      for (auto numPartitionBits : {0, 2, 4}) {
+        for (auto maxBatchRows : {64, 1'024}) {
+          auto stats =
+              benchmark.run(keys, payload, numPartitionBits, maxBatchRows);
+          printStats(
+              fmt::format(
+                  "{}/{}/{}parts/{}rows",
+                  keys.name,
+                  payload.name,
+                  1 << numPartitionBits,
+                  maxBatchRows),
+              stats,
+              printHeader);
+          printHeader = false;
+        }
+      }
+    }
+  }
+  return 0;
+}
@@ -783,6 +783,88 @@ TEST_F(AggregationTest, partialAggregationMemoryLimit) {
       0);
 }
 
+TEST_F(AggregationTest, abandonPartialAggregation) {
+  std::vector<RowVectorPtr> vectors;
+  for (auto i = 0; i < 10; ++i) {
+    vectors.push_back(makeRowVector({
+        makeFlatVector<int32_t>(
+            1'000, [i](auto row) { return i * 1'000 + row; }, nullEvery(11)),
+        makeFlatVector<int64_t>(
+            1'000, [](auto row) { return row; }, nullEvery(7)),
+    }));
+  }
+  createDuckDbTable(vectors);
+
+  // Each key is nearly unique, so the partial aggregation gives up after the
+  // first 2000 rows and converts the rest of the input to intermediate
+  // results.
+  core::PlanNodeId aggNodeId;
+  auto task =
+      AssertQueryBuilder(duckDbQueryRunner_)
+          .config(core::QueryConfig::kAbandonPartialAggregationMinRows, "2000")
+          .config(core::QueryConfig::kAbandonPartialAggregationMinPct, "80")
+          .plan(PlanBuilder()
+                    .values(vectors)
+                    .partialAggregation(
+                        {"c0"}, {"count(1)", "sum(c1)", "avg(c1)", "max(c1)"})
+                    .capturePlanNodeId(aggNodeId)
+                    .finalAggregation()
+                    .planNode())
+          .assertResults(
+              "SELECT c0, count(1), sum(c1), avg(c1), max(c1) FROM tmp GROUP BY 1");
+  auto planStats = toPlanStats(task->taskStats()).at(aggNodeId);
+  EXPECT_EQ(1, planStats.customStats.at("abandonedPartialAggregation").sum);
+
+  // Enough reduction keeps the partial aggregation.
+  task =
+      AssertQueryBuilder(duckDbQueryRunner_)
+          .config(core::QueryConfig::kAbandonPartialAggregationMinRows, "2000")
+          .config(core::QueryConfig::kAbandonPartialAggregationMinPct, "80")
+          .plan(PlanBuilder()
+                    .values(vectors)
+                    .project({"c0 % 10 AS c0", "c1"})
+                    .partialAggregation({"c0"}, {"sum(c1)"})
+                    .capturePlanNodeId(aggNodeId)
+                    .finalAggregation()
+                    .planNode())
+          .assertResults("SELECT c0 % 10, sum(c1) FROM tmp GROUP BY 1");
+  planStats = toPlanStats(task->taskStats()).at(aggNodeId);
+  EXPECT_EQ(0, planStats.customStats.count("abandonedPartialAggregation"));
+}
+
+TEST_F(AggregationTest, sharedFinalAggregation) {
+  std::vector<RowVectorPtr> vectors;
+  for (auto i = 0; i < 10; ++i) {
+    vectors.push_back(makeRowVector({
+        makeFlatVector<int32_t>(
+            1'000, [i](auto row) { return i * 1'000 + row; }, nullEvery(11)),
+        makeFlatVector<int64_t>(
+            1'000, [](auto row) { return row; }, nullEvery(7)),
+    }));
+  }
+  createDuckDbTable(vectors);
+
+  // Each of 4 Drivers gets all of 'vectors'. The final aggregation follows
+  // the partial one without a local repartition, so the Drivers must merge
+  // their groups.
+  core::PlanNodeId aggNodeId;
+  auto task =
+      AssertQueryBuilder(duckDbQueryRunner_)
+          .config(core::QueryConfig::kSharedFinalAggregation, "true")
+          .maxDrivers(4)
+          .plan(PlanBuilder()
+                    .values(vectors, true)
+                    .project({"c0 % 1000 AS c0", "c1"})
+                    .partialAggregation({"c0"}, {"count(1)", "max(c1)"})
+                    .finalAggregation()
+                    .capturePlanNodeId(aggNodeId)
+                    .planNode())
+          .assertResults(
+              "SELECT c0 % 1000, count(1) * 4, max(c1) FROM tmp GROUP BY 1");
+  auto planStats = toPlanStats(task->taskStats()).at(aggNodeId);
+  EXPECT_EQ(4, planStats.customStats.at("sharedPartitions").sum);
+}
+
 // Validates partial aggregate output types for SUM/MIN/MAX.
 TEST_F(AggregationTest, validatePartialTypes) {
   auto vectors = makeVectors(rowType_, 10, 1);
@@ -906,6 +988,45 @@ TEST_F(AggregationTest, spill) {
   EXPECT_LT(20 << 20, stats[0].operatorStats[1].spilledBytes);
 }
 
+TEST_F(AggregationTest, spillParallelMerge) {
+  std::vector<RowVectorPtr> vectors;
+  for (auto i = 0; i < 10; ++i) {
+    vectors.push_back(makeRowVector({
+        makeFlatVector<int64_t>(
+            1'000, [i](auto row) { return (i * 1'000 + row) % 3'000; }),
+        makeFlatVector<int64_t>(
+            1'000, [](auto row) { return row; }, nullEvery(7)),
+    }));
+  }
+  createDuckDbTable(vectors);
+
+  // The spilled partitions are merged 4 at a time on the spill executor.
+  auto tempDirectory = exec::test::TempDirectoryPath::create();
+  auto queryCtx = std::make_shared<core::QueryCtx>(
+      std::make_shared<folly::CPUThreadPoolExecutor>(4),
+      std::make_shared<core::MemConfig>(),
+      std::unordered_map<std::string, std::shared_ptr<Config>>{},
+      memory::MappedMemory::getInstance(),
+      nullptr,
+      std::make_shared<folly::CPUThreadPoolExecutor>(4));
+  auto task =
+      AssertQueryBuilder(duckDbQueryRunner_)
+          .queryCtx(queryCtx)
+          .config(core::QueryConfig::kSpillPath, tempDirectory->path)
+          .config(core::QueryConfig::kTestingSpillPct, "100")
+          .config(core::QueryConfig::kAggregationSpillMergeThreads, "4")
+          .plan(PlanBuilder()
+                    .values(vectors)
+                    .singleAggregation(
+                        {"c0"}, {"count(1)", "sum(c1)", "max(c1)"})
+                    .planNode())
+          .assertResults(
+              "SELECT c0, count(1), sum(c1), max(c1) FROM tmp GROUP BY 1");
+
+  auto stats = task->taskStats().pipelineStats;
+  EXPECT_LT(0, stats[0].operatorStats[1].spilledBytes);
+}
+
 /// Verify number of memory allocations in the HashAggregation operator.
 TEST_F(AggregationTest, memoryAllocations) {
   vector_size_t size = 1'024;
@@ -957,6 +1078,179 @@ TEST_F(AggregationTest, memoryAllocations) {
   ASSERT_EQ(5, planStats.at(aggNodeId).numMemoryAllocations);
 }
 
+TEST_F(AggregationTest, distinctAggregates) {
+  vector_size_t size = 1'000;
+  std::vector<RowVectorPtr> vectors;
+  for (auto i = 0; i < 3; ++i) {
+    vectors.push_back(makeRowVector(
+        {"k", "a", "b"},
+        {
+            makeFlatVector<int64_t>(size, [](auto row) { return row % 11; }),
+            makeFlatVector<int64_t>(
+                size, [](auto row) { return row % 23; }, nullEvery(7)),
+            makeFlatVector<StringView>(
+                size,
+                [](auto row) {
+                  return StringView(std::string(row % 5, 'x'));
+                }),
+        }));
+  }
+  createDuckDbTable(vectors);
+
+  // Grouped, with distinct and regular aggregates over the same columns.
+  auto plan =
+      PlanBuilder()
+          .values(vectors)
+          .singleAggregation(
+              {"k"},
+              {"count(a)", "sum(a)", "count(a)", "count(b)", "count(a)"},
+              {},
+              {true, true, false, true, true})
+          .planNode();
+  assertQuery(
+      plan,
+      "SELECT k, count(DISTINCT a), sum(DISTINCT a), count(a), "
+      "count(DISTINCT b), count(DISTINCT a) FROM tmp GROUP BY 1");
+
+  // Global.
+  plan = PlanBuilder()
+             .values(vectors)
+             .singleAggregation(
+                 {}, {"count(a)", "count(b)", "sum(a)"}, {}, {true, true, false})
+             .planNode();
+  assertQuery(
+      plan, "SELECT count(DISTINCT a), count(DISTINCT b), sum(a) FROM tmp");
+
+  // Distinct aggregate with a mask.
+  plan = PlanBuilder()
+             .values(vectors)
+             .project({"k", "a", "k % 2 = 0 AS m"})
+             .singleAggregation({"k"}, {"count(a)"}, {"m"}, {true})
+             .planNode();
+  assertQuery(
+      plan,
+      "SELECT k, count(DISTINCT a) FILTER (WHERE k % 2 = 0) FROM tmp "
+      "GROUP BY 1");
+
+  // Input clustered on the grouping key. The groups are flushed when the key
+  // changes and the distinct values are forgotten with them.
+  std::vector<RowVectorPtr> sorted;
+  for (auto i = 0; i < 3; ++i) {
+    sorted.push_back(makeRowVector(
+        {"k", "a"},
+        {
+            makeFlatVector<int64_t>(
+                size, [i, size](auto row) { return (i * size + row) / 300; }),
+            makeFlatVector<int64_t>(size, [](auto row) { return row % 13; }),
+        }));
+  }
+  createDuckDbTable(sorted);
+  plan = PlanBuilder()
+             .values(sorted)
+             .aggregation(
+                 {"k"},
+                 {"k"},
+                 {"count(a)"},
+                 {},
+                 core::AggregationNode::Step::kSingle,
+                 false,
+                 {},
+                 {true})
+             .planNode();
+  assertQuery(plan, "SELECT k, count(DISTINCT a) FROM tmp GROUP BY 1");
+
+  // Intermediate results of distinct aggregates cannot be merged.
+  EXPECT_THROW(
+      PlanBuilder()
+          .values(vectors)
+          .aggregation(
+              {"k"},
+              {},
+              {"count(a)"},
+              {},
+              core::AggregationNode::Step::kPartial,
+              false,
+              {},
+              {true}),
+      VeloxUserError);
+}
+
+TEST_F(AggregationTest, sharedMasks) {
+  // Many aggregates over a few masks of different encodings: flat with nulls,
+  // dictionary and constant. Aggregates with the same mask and arguments are
+  // updated back to back.
+  vector_size_t size = 1'000;
+  std::vector<RowVectorPtr> vectors;
+  for (auto i = 0; i < 3; ++i) {
+    vectors.push_back(makeRowVector(
+        {"k", "a", "b", "m1", "m2", "m3"},
+        {
+            makeFlatVector<int64_t>(
+                size, [i, size](auto row) { return (i * size + row) / 100; }),
+            makeFlatVector<int64_t>(
+                size, [](auto row) { return row % 17; }, nullEvery(7)),
+            makeFlatVector<int64_t>(size, [](auto row) { return row; }),
+            makeFlatVector<bool>(
+                size, [](auto row) { return row % 3 == 0; }, nullEvery(5)),
+            wrapInDictionary(
+                makeIndicesInReverse(size),
+                size,
+                makeFlatVector<bool>(
+                    size, [](auto row) { return row % 2 == 0; })),
+            makeConstant(false, size),
+        }));
+  }
+  createDuckDbTable(vectors);
+
+  const std::vector<std::string> aggregates = {
+      "sum(a)",
+      "count(a)",
+      "sum(a)",
+      "max(b)",
+      "count(a)",
+      "min(b)",
+      "sum(b)",
+      "count(1)",
+      "sum(a)"};
+  const std::vector<std::string> masks = {
+      "m1", "", "m2", "m1", "m1", "m2", "m3", "m2", ""};
+  const std::string sql =
+      "SELECT k, sum(a) FILTER (WHERE m1), count(a), "
+      "sum(a) FILTER (WHERE m2), max(b) FILTER (WHERE m1), "
+      "count(a) FILTER (WHERE m1), min(b) FILTER (WHERE m2), "
+      "sum(b) FILTER (WHERE m3), count(1) FILTER (WHERE m2), sum(a) "
+      "FROM tmp GROUP BY 1";
+
+  auto plan = PlanBuilder()
+                  .values(vectors)
+                  .singleAggregation({"k"}, aggregates, masks)
+                  .planNode();
+  assertQuery(plan, sql);
+
+  // Streaming aggregation over input clustered on 'k'.
+  plan = PlanBuilder()
+             .values(vectors)
+             .streamingAggregation(
+                 {"k"},
+                 aggregates,
+                 masks,
+                 core::AggregationNode::Step::kSingle,
+                 false)
+             .planNode();
+  assertQuery(plan, sql);
+
+  // Global.
+  plan = PlanBuilder()
+             .values(vectors)
+             .singleAggregation(
+                 {}, {"sum(a)", "count(b)", "sum(a)"}, {"m1", "", "m2"})
+             .planNode();
+  assertQuery(
+      plan,
+      "SELECT sum(a) FILTER (WHERE m1), count(b), "
+      "sum(a) FILTER (WHERE m2) FROM tmp");
+}
+
 TEST_F(AggregationTest, groupingSets) {
   vector_size_t size = 1'000;
   auto data = makeRowVector(
@@ -1041,5 +1335,41 @@ TEST_F(AggregationTest, groupingSets) {
       "SELECT k1, k2, count(1), sum(a), max(b) FROM tmp GROUP BY ROLLUP (k1, k2)");
 }
 
+TEST_F(AggregationTest, outputBatchBytes) {
+  // 2'000 groups with a narrow result and a wide result of about 1KB per row.
+  auto data = makeRowVector({
+      makeFlatVector<int32_t>(10'000, [](auto row) { return row % 2'000; }),
+      makeFlatVector<StringView>(
+          10'000,
+          [](auto row) {
+            return StringView(std::string(1'000, 'a' + row % 26));
+          }),
+  });
+  createDuckDbTable({data});
+
+  core::PlanNodeId aggId;
+  auto makePlan = [&](const std::string& aggregate) {
+    return PlanBuilder()
+        .values({data})
+        .singleAggregation({"c0"}, {aggregate})
+        .capturePlanNodeId(aggId)
+        .planNode();
+  };
+
+  // Narrow rows fit one batch although there are more of them than
+  // preferred_output_batch_size.
+  auto task = AssertQueryBuilder(duckDbQueryRunner_)
+                  .plan(makePlan("count(1)"))
+                  .assertResults("SELECT c0, count(1) FROM tmp GROUP BY 1");
+  EXPECT_EQ(1, toPlanStats(task->taskStats()).at(aggId).outputVectors);
+
+  // Wide rows are returned in batches of about 100KB.
+  task = AssertQueryBuilder(duckDbQueryRunner_)
+             .plan(makePlan("max(c1)"))
+             .config(core::QueryConfig::kPreferredOutputBatchBytes, "100000")
+             .assertResults("SELECT c0, max(c1) FROM tmp GROUP BY 1");
+  EXPECT_LE(20, toPlanStats(task->taskStats()).at(aggId).outputVectors);
+}
+
 } // namespace
 } // namespace facebook::velox::exec::test
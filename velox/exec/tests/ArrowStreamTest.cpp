@@ -0,0 +1,92 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "velox/common/base/tests/GTestUtils.h"
+#include "velox/exec/tests/utils/Cursor.h"
+#include "velox/exec/tests/utils/OperatorTestBase.h"
+#include "velox/exec/tests/utils/PlanBuilder.h"
+#include "velox/vector/arrow/Abi.h"
+#include "velox/vector/arrow/Bridge.h"
+
+using namespace facebook::velox;
+using namespace facebook::velox::exec::test;
+
+class ArrowStreamTest : public OperatorTestBase {
+ protected:
+  std::vector<RowVectorPtr> makeVectors() {
+    std::vector<RowVectorPtr> vectors;
+    for (auto i = 0; i < 5; ++i) {
+      vectors.push_back(makeRowVector(
+          {makeFlatVector<int64_t>(1'000, [&](auto row) { return row * i; }),
+           makeFlatVector<double>(
+               1'000, [](auto row) { return row * 0.1; }, nullEvery(11))}));
+    }
+    return vectors;
+  }
+
+  // Returns a stream that produces the results of 'plan' as they are pulled.
+  std::shared_ptr<ArrowArrayStream> exportPlan(
+      const core::PlanNodePtr& plan) {
+    CursorParameters params;
+    params.planNode = plan;
+    auto cursor = std::make_shared<TaskCursor>(params);
+
+    auto arrowStream = std::shared_ptr<ArrowArrayStream>(
+        new ArrowArrayStream(), [](ArrowArrayStream* toDelete) {
+          if (toDelete->release != nullptr) {
+            toDelete->release(toDelete);
+          }
+          delete toDelete;
+        });
+    exportToArrowStream(
+        plan->outputType(),
+        [cursor]() -> RowVectorPtr {
+          return cursor->moveNext() ? cursor->current() : nullptr;
+        },
+        *arrowStream,
+        pool());
+    return arrowStream;
+  }
+};
+
+TEST_F(ArrowStreamTest, pipeline) {
+  auto vectors = makeVectors();
+  createDuckDbTable(vectors);
+
+  // Streams the output of one query into another.
+  auto arrowStream = exportPlan(
+      PlanBuilder().values(vectors).filter("c0 % 3 = 0").planNode());
+  auto plan = PlanBuilder()
+                  .arrowStream(asRowType(vectors[0]->type()), arrowStream)
+                  .project({"c0 + 1", "c1"})
+                  .planNode();
+  assertQuery(plan, "SELECT c0 + 1, c1 FROM tmp WHERE c0 % 3 = 0");
+
+  // The stream was consumed and released by the first execution.
+  EXPECT_EQ(nullptr, arrowStream->release);
+}
+
+TEST_F(ArrowStreamTest, typeMismatch) {
+  auto vectors = makeVectors();
+  auto arrowStream = exportPlan(PlanBuilder().values(vectors).planNode());
+  auto plan = PlanBuilder()
+                  .arrowStream(ROW({"c0"}, {BIGINT()}), arrowStream)
+                  .planNode();
+  CursorParameters params;
+  params.planNode = plan;
+  VELOX_ASSERT_THROW(
+      readCursor(params, [](auto /*task*/) {}),
+      "ArrowArrayStream produces");
+}
@@ -258,3 +258,59 @@ TEST_F(CrossJoinTest, parallelism) {
 
   OperatorTestBase::assertQuery(params, "VALUES (30), (30), (30), (30), (30)");
 }
+
+TEST_F(CrossJoinTest, filter) {
+  auto leftVectors = {
+      makeRowVector({sequence<int32_t>(10), sequence<int32_t>(10, 100)}),
+      makeRowVector({sequence<int32_t>(1'000, 10), sequence<int32_t>(1'000)}),
+  };
+
+  auto rightVectors = {
+      makeRowVector(
+          {"u_c0", "u_c1"}, {sequence<int32_t>(7), sequence<int32_t>(7)}),
+      makeRowVector(
+          {"u_c0", "u_c1"},
+          {sequence<int32_t>(2'000, 7),
+           makeFlatVector<int32_t>(
+               2'000, [](auto row) { return row; }, nullEvery(5))}),
+  };
+
+  createDuckDbTable("t", {leftVectors});
+  createDuckDbTable("u", {rightVectors});
+
+  auto testFilter = [&](const std::string& filter,
+                        const std::vector<std::string>& outputLayout,
+                        const std::string& sql) {
+    SCOPED_TRACE(filter);
+    auto planNodeIdGenerator = std::make_shared<PlanNodeIdGenerator>();
+    auto op = PlanBuilder(planNodeIdGenerator)
+                  .values({leftVectors})
+                  .crossJoin(
+                      PlanBuilder(planNodeIdGenerator)
+                          .values({rightVectors})
+                          .planNode(),
+                      outputLayout,
+                      filter)
+                  .planNode();
+    assertQuery(op, sql);
+  };
+
+  // Range join.
+  testFilter(
+      "c0 between u_c0 and u_c0 + 3",
+      {"c0", "c1", "u_c0"},
+      "SELECT c0, c1, u_c0 FROM t, u WHERE c0 BETWEEN u_c0 AND u_c0 + 3");
+
+  // Inequality on columns that are not in the output. Filter is null for
+  // the null u_c1.
+  testFilter(
+      "c1 < u_c1 and u_c1 < 20",
+      {"c0"},
+      "SELECT c0 FROM t, u WHERE c1 < u_c1 AND u_c1 < 20");
+
+  // No matches.
+  testFilter(
+      "c0 > u_c0 + 10000",
+      {"c0", "u_c1"},
+      "SELECT c0, u_c1 FROM t, u WHERE c0 > u_c0 + 10000");
+}
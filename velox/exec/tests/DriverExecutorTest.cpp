@@ -0,0 +1,202 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "velox/exec/DriverExecutor.h"
+#include <folly/synchronization/Baton.h>
+#include "velox/exec/tests/utils/AssertQueryBuilder.h"
+#include "velox/exec/tests/utils/OperatorTestBase.h"
+#include "velox/exec/tests/utils/PlanBuilder.h"
+
+using namespace facebook::velox;
+using namespace facebook::velox::exec;
+using namespace facebook::velox::exec::test;
+
+class DriverExecutorTest : public OperatorTestBase {};
+
+TEST_F(DriverExecutorTest, runAll) {
+  constexpr int32_t kNumItems = 10'000;
+  std::atomic<int32_t> numDone{0};
+  std::atomic<int32_t> numNestedDone{0};
+  {
+    DriverExecutor executor(4);
+    for (auto i = 0; i < kNumItems; ++i) {
+      executor.add([&]() {
+        // Runs on a worker and may queue more items from there.
+        auto workerId = executor.currentWorkerId();
+        EXPECT_NE(workerId, DriverExecutor::kNoWorker);
+        if (numDone++ % 2 == 0) {
+          executor.add([&]() { ++numNestedDone; });
+        }
+      });
+    }
+    EXPECT_EQ(DriverExecutor::kNoWorker, executor.currentWorkerId());
+    // The destructor runs all the queued items.
+  }
+  EXPECT_EQ(kNumItems, numDone);
+  EXPECT_EQ(kNumItems / 2, numNestedDone);
+}
+
+TEST_F(DriverExecutorTest, affinityAndSteal) {
+  DriverExecutor executor(2);
+
+  // Items queued for an idle worker run on that worker.
+  for (auto workerId = 0; workerId < 2; ++workerId) {
+    folly::Baton<> done;
+    int32_t ranOn = DriverExecutor::kNoWorker;
+    executor.addWithAffinity(
+        [&]() {
+          ranOn = executor.currentWorkerId();
+          done.post();
+        },
+        workerId);
+    done.wait();
+    EXPECT_EQ(workerId, ranOn);
+  }
+
+  // Items queued behind a blocked worker get stolen by the other worker.
+  folly::Baton<> blocked;
+  folly::Baton<> release;
+  executor.addWithAffinity(
+      [&]() {
+        blocked.post();
+        release.wait();
+      },
+      0);
+  blocked.wait();
+  const auto numStealsBefore = executor.stats().numSteals;
+  folly::Baton<> done;
+  int32_t ranOn = DriverExecutor::kNoWorker;
+  executor.addWithAffinity(
+      [&]() {
+        ranOn = executor.currentWorkerId();
+        done.post();
+      },
+      0);
+  done.wait();
+  EXPECT_EQ(1, ranOn);
+  release.post();
+
+  auto stats = executor.stats();
+  EXPECT_EQ(numStealsBefore + 1, stats.numSteals);
+  EXPECT_EQ(2, stats.queueDepths.size());
+}
+
+TEST_F(DriverExecutorTest, query) {
+  std::vector<RowVectorPtr> vectors;
+  for (auto i = 0; i < 20; ++i) {
+    vectors.push_back(makeRowVector({makeFlatVector<int64_t>(
+        1'000, [i](auto row) { return (i * 1'000 + row) % 97; })}));
+  }
+  createDuckDbTable(vectors);
+
+  auto executor = std::make_shared<DriverExecutor>(4);
+  auto queryCtx = std::make_shared<core::QueryCtx>(
+      executor.get(), std::make_shared<core::MemConfig>());
+  auto plan = PlanBuilder()
+                  .values(vectors, true)
+                  .partialAggregation({"c0"}, {"count(1)"})
+                  .localPartition({"c0"})
+                  .finalAggregation()
+                  .planNode();
+  AssertQueryBuilder(plan, duckDbQueryRunner_)
+      .queryCtx(queryCtx)
+      .maxDrivers(4)
+      .assertResults("SELECT c0, count(1) * 4 FROM tmp GROUP BY 1");
+  EXPECT_GT(executor->stats().numRun, 0);
+}
+
+TEST_F(DriverExecutorTest, priorities) {
+  EXPECT_EQ(0, DriverExecutor::priorityForCpuNanos(0));
+  EXPECT_EQ(0, DriverExecutor::priorityForCpuNanos(999'999'999));
+  EXPECT_EQ(1, DriverExecutor::priorityForCpuNanos(1'000'000'000));
+  EXPECT_EQ(2, DriverExecutor::priorityForCpuNanos(30'000'000'000));
+  EXPECT_EQ(4, DriverExecutor::priorityForCpuNanos(1'000'000'000'000));
+
+  DriverExecutor executor(1);
+  constexpr int32_t kLowest = DriverExecutor::kNumPriorities - 1;
+  folly::Baton<> blocked;
+  folly::Baton<> release;
+  executor.addWithAffinity(
+      [&]() {
+        blocked.post();
+        release.wait();
+      },
+      0,
+      kLowest);
+  blocked.wait();
+
+  std::mutex mutex;
+  std::vector<int32_t> order;
+  for (auto i = 0; i < 10; ++i) {
+    executor.addWithAffinity(
+        [&, i]() {
+          std::lock_guard<std::mutex> l(mutex);
+          order.push_back(i);
+        },
+        0,
+        kLowest);
+  }
+  folly::Baton<> done;
+  executor.addWithAffinity(
+      [&]() {
+        {
+          std::lock_guard<std::mutex> l(mutex);
+          order.push_back(100);
+        }
+        done.post();
+      },
+      0,
+      0);
+  release.post();
+  done.wait();
+
+  // The lowest level was charged for the time the first item blocked, so the
+  // top level item goes ahead of the items queued before it.
+  std::lock_guard<std::mutex> l(mutex);
+  ASSERT_FALSE(order.empty());
+  EXPECT_EQ(100, order[0]);
+}
+
+TEST_F(DriverExecutorTest, timeSlice) {
+  std::vector<RowVectorPtr> vectors;
+  for (auto i = 0; i < 1'000; ++i) {
+    vectors.push_back(makeRowVector({makeFlatVector<int64_t>(
+        1'000, [i](auto row) { return i * 1'000 + row; })}));
+  }
+  createDuckDbTable(vectors);
+
+  auto executor = std::make_shared<DriverExecutor>(2);
+  auto plan = PlanBuilder()
+                  .values(vectors)
+                  .project({"c0 % 13 AS c0", "c0 * 2 AS c1"})
+                  .singleAggregation({"c0"}, {"sum(c1)"})
+                  .planNode();
+  auto runQuery = [&](const std::string& timeSliceMs) {
+    auto queryCtx = std::make_shared<core::QueryCtx>(
+        executor.get(), std::make_shared<core::MemConfig>());
+    const auto numRunBefore = executor->stats().numRun;
+    AssertQueryBuilder(plan, duckDbQueryRunner_)
+        .queryCtx(queryCtx)
+        .config(core::QueryConfig::kDriverTimeSliceMs, timeSliceMs)
+        .assertResults("SELECT c0 % 13, sum(c0 * 2) FROM tmp GROUP BY 1");
+    return executor->stats().numRun - numRunBefore;
+  };
+
+  // Without a time slice the single Driver never yields since Values never
+  // blocks. Processing 1M rows takes well over 1ms, so with a 1ms slice the
+  // Driver yields and is run again.
+  const auto numRunWithoutSlice = runQuery("0");
+  EXPECT_GT(runQuery("1"), numRunWithoutSlice);
+}
@@ -18,6 +18,7 @@
 #include <velox/exec/Driver.h>
 #include "velox/common/base/tests/GTestUtils.h"
 #include "velox/dwio/dwrf/test/utils/BatchMaker.h"
+#include "velox/exec/PlanNodeStats.h"
 #include "velox/exec/tests/utils/AssertQueryBuilder.h"
 #include "velox/exec/tests/utils/Cursor.h"
 #include "velox/exec/tests/utils/OperatorTestBase.h"
@@ -417,6 +418,12 @@ TEST_F(DriverTest, slow) {
   // Check that the blocking of the CallbackSink at the end of the pipeline is
   // recorded.
   EXPECT_GT(stats[0].operatorStats.back().blockedWallNanos, 0);
+  // The same blocking is attributed to the Drivers in the task stats.
+  const auto timing = tasks_[0]->taskStats().driverTiming;
+  EXPECT_GT(timing.blockedWallNanos.at("kWaitForConsumer"), 0);
+  EXPECT_EQ(timing.blockedWallNanos.count("kWaitForSplit"), 0);
+  EXPECT_GT(timing.runningWallNanos, 0);
+  EXPECT_GT(timing.runningCpuNanos, 0);
   EXPECT_TRUE(stateFutures_.at(0).isReady());
   // The future was realized by timeout.
   EXPECT_TRUE(stateFutures_.at(0).hasException());
@@ -804,6 +811,95 @@ TEST_F(DriverTest, driverCreationThrow) {
       "Can only create 1 'throw driver'.");
 }
 
+TEST_F(DriverTest, trace) {
+  std::vector<RowVectorPtr> vectors;
+  for (auto i = 0; i < 10; ++i) {
+    vectors.push_back(makeRowVector({makeFlatVector<int64_t>(
+        1'000, [i](auto row) { return i * 1'000 + row; })}));
+  }
+  createDuckDbTable(vectors);
+  auto plan = PlanBuilder()
+                  .values(vectors)
+                  .project({"c0 % 7 AS c0"})
+                  .singleAggregation({"c0"}, {"count(1)"})
+                  .planNode();
+
+  auto task = AssertQueryBuilder(plan, duckDbQueryRunner_)
+                  .assertResults("SELECT c0 % 7, count(1) FROM tmp GROUP BY 1");
+  EXPECT_EQ("{\"traceEvents\":[]}", task->driverTraceJson());
+
+  task = AssertQueryBuilder(plan, duckDbQueryRunner_)
+             .config(core::QueryConfig::kDriverTraceEnabled, "true")
+             .assertResults("SELECT c0 % 7, count(1) FROM tmp GROUP BY 1");
+  const auto json = task->driverTraceJson();
+  EXPECT_NE(std::string::npos, json.find("\"name\":\"run\""));
+  EXPECT_NE(std::string::npos, json.find("\"FilterProject.getOutput\""));
+  EXPECT_NE(std::string::npos, json.find("\"Aggregation.addInput\""));
+  EXPECT_NE(std::string::npos, json.find("\"Aggregation.noMoreInput\""));
+}
+
+TEST_F(DriverTest, operatorPerfCounters) {
+  std::vector<RowVectorPtr> vectors;
+  for (auto i = 0; i < 10; ++i) {
+    vectors.push_back(makeRowVector({makeFlatVector<int64_t>(
+        1'000, [i](auto row) { return i * 1'000 + row; })}));
+  }
+  createDuckDbTable(vectors);
+  core::PlanNodeId aggregationId;
+  auto plan = PlanBuilder()
+                  .values(vectors)
+                  .singleAggregation({"c0"}, {"count(1)"})
+                  .capturePlanNodeId(aggregationId)
+                  .planNode();
+
+  auto task = AssertQueryBuilder(plan, duckDbQueryRunner_)
+                  .assertResults("SELECT c0, count(1) FROM tmp GROUP BY 1");
+  EXPECT_TRUE(
+      toPlanStats(task->taskStats()).at(aggregationId).perfCounters.empty());
+
+  task = AssertQueryBuilder(plan, duckDbQueryRunner_)
+             .config(core::QueryConfig::kOperatorPerfCountersEnabled, "true")
+             .assertResults("SELECT c0, count(1) FROM tmp GROUP BY 1");
+  if (!process::ThreadPerfCounters::get()) {
+    // No hardware counters on this machine.
+    return;
+  }
+  const auto& counters =
+      toPlanStats(task->taskStats()).at(aggregationId).perfCounters;
+  EXPECT_GT(counters.cycles, 0);
+  EXPECT_GT(counters.instructions, 0);
+}
+
+TEST_F(DriverTest, traceRingBuffer) {
+  auto trace = std::make_shared<DriverTrace>(
+      1, 2, std::vector<std::string>{"Values"}, 4);
+  for (auto i = 0; i < 6; ++i) {
+    trace->record(DriverTrace::EventType::kGetOutput, 0, i * 10, i * 10 + 5);
+  }
+  // The oldest 2 events are overwritten.
+  EXPECT_EQ(2, trace->numDropped());
+  auto events = trace->events();
+  ASSERT_EQ(4, events.size());
+  for (auto i = 0; i < events.size(); ++i) {
+    EXPECT_EQ((i + 2) * 10, events[i].startMicros);
+    EXPECT_EQ(5, events[i].durationMicros);
+  }
+
+  trace->record(
+      DriverTrace::EventType::kBlocked,
+      0,
+      100,
+      110,
+      static_cast<int32_t>(BlockingReason::kWaitForSplit));
+  const auto json = DriverTrace::toChromeTrace({trace});
+  EXPECT_NE(
+      std::string::npos,
+      json.find(
+          "{\"name\":\"Values.blocked\",\"cat\":\"blocked\",\"ph\":\"X\","
+          "\"ts\":100,\"dur\":10,\"pid\":1,\"tid\":2,"
+          "\"args\":{\"operatorId\":0,\"reason\":\"kWaitForSplit\"}}"));
+}
+
 int main(int argc, char** argv) {
   testing::InitGoogleTest(&argc, argv);
   folly::init(&argc, &argv, false);
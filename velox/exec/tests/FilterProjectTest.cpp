@@ -15,6 +15,7 @@
  */
 #include "velox/dwio/dwrf/test/utils/BatchMaker.h"
 #include "velox/exec/PlanNodeStats.h"
+#include "velox/exec/tests/utils/AssertQueryBuilder.h"
 #include "velox/exec/tests/utils/OperatorTestBase.h"
 #include "velox/exec/tests/utils/PlanBuilder.h"
 
@@ -308,3 +309,41 @@ TEST_F(FilterProjectTest, filterProjectFused) {
       plan,
       "SELECT c0, c1, c0 %100 + c1 % 50, c0 % 100 FROM tmp WHERE c0 % 10 < 5");
 }
+
+TEST_F(FilterProjectTest, exprStats) {
+  std::vector<RowVectorPtr> vectors;
+  for (int32_t i = 0; i < 10; ++i) {
+    vectors.push_back(makeRowVector({
+        makeFlatVector<int64_t>(100, [](auto row) { return row; }),
+        wrapInDictionary(
+            makeIndicesInReverse(100),
+            100,
+            makeFlatVector<int64_t>(100, [](auto row) { return row % 7; })),
+    }));
+  }
+  createDuckDbTable(vectors);
+
+  auto plan = PlanBuilder()
+                  .values(vectors)
+                  .project({"c0 + c0 AS e0", "c1 * 2 AS e1"})
+                  .planNode();
+  auto task = AssertQueryBuilder(plan, duckDbQueryRunner_)
+                  .config(core::QueryConfig::kExprTrackCpuUsage, "true")
+                  .assertResults("SELECT c0 + c0, c1 * 2 FROM tmp");
+
+  auto stats = toPlanStats(task->taskStats()).at(plan->id()).customStats;
+  ASSERT_EQ(1'000, stats.at("expr.plus.numProcessedRows").sum);
+  ASSERT_EQ(1'000, stats.at("expr.plus.numFlatRows").sum);
+  ASSERT_EQ(0, stats.at("expr.plus.numPeeledRows").sum);
+  ASSERT_LT(0, stats.at("expr.plus.cpuNanos").sum);
+
+  // The dictionary over 'c1' is peeled.
+  ASSERT_EQ(1'000, stats.at("expr.multiply.numProcessedRows").sum);
+  ASSERT_EQ(1'000, stats.at("expr.multiply.numPeeledRows").sum);
+
+  // No expression stats unless CPU tracking is enabled.
+  task = AssertQueryBuilder(plan, duckDbQueryRunner_)
+             .assertResults("SELECT c0 + c0, c1 * 2 FROM tmp");
+  stats = toPlanStats(task->taskStats()).at(plan->id()).customStats;
+  ASSERT_EQ(0, stats.count("expr.plus.numProcessedRows"));
+}
@@ -0,0 +1,161 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#include "velox/exec/FragmentResultCache.h"
+#include "velox/common/base/tests/GTestUtils.h"
+#include "velox/exec/tests/utils/HiveConnectorTestBase.h"
+#include "velox/exec/tests/utils/PlanBuilder.h"
+
+using namespace facebook::velox;
+using namespace facebook::velox::exec;
+using namespace facebook::velox::exec::test;
+
+class FragmentResultCacheTest : public HiveConnectorTestBase {
+ protected:
+  void SetUp() override {
+    HiveConnectorTestBase::SetUp();
+    filePaths_ = makeFilePaths(3);
+    std::vector<RowVectorPtr> vectors;
+    for (auto i = 0; i < filePaths_.size(); ++i) {
+      vectors.push_back(makeRowVector({
+          makeFlatVector<int64_t>(1'000, [i](auto row) { return row % 7 + i; }),
+          makeFlatVector<int32_t>(1'000, [](auto row) { return row; }),
+      }));
+      writeToFile(filePaths_[i]->path, vectors.back());
+    }
+    createDuckDbTable(vectors);
+  }
+
+  std::vector<Split> makeSplits() const {
+    std::vector<Split> splits;
+    for (auto& split : makeHiveConnectorSplits(filePaths_)) {
+      splits.push_back(Split(std::move(split)));
+    }
+    return splits;
+  }
+
+  // Scan, filter and partial aggregation of the files.
+  core::PlanNodePtr makeFragment(const std::string& filter) const {
+    return PlanBuilder()
+        .tableScan(rowType_)
+        .filter(filter)
+        .partialAggregation({"c0"}, {"sum(c1)"})
+        .planNode();
+  }
+
+  // Checks that 'results', the partial aggregates of all splits, add up to
+  // the aggregation of the files.
+  void checkResults(
+      const std::vector<RowVectorPtr>& results,
+      const std::string& filter) {
+    auto plan = PlanBuilder()
+                    .values(results)
+                    .singleAggregation({"c0"}, {"sum(a0)"})
+                    .planNode();
+    assertQuery(
+        plan,
+        fmt::format(
+            "SELECT c0, sum(c1) FROM tmp WHERE {} GROUP BY 1", filter));
+  }
+
+  const RowTypePtr rowType_{ROW({"c0", "c1"}, {BIGINT(), INTEGER()})};
+  std::vector<std::shared_ptr<TempFilePath>> filePaths_;
+};
+
+TEST_F(FragmentResultCacheTest, replay) {
+  FragmentResultCache cache(100 << 20);
+  auto queryCtx = core::QueryCtx::createForTest();
+  auto fragment = makeFragment("c1 % 3 = 0");
+
+  auto results = cache.run(fragment, makeSplits(), queryCtx, pool());
+  checkResults(results, "c1 % 3 = 0");
+  auto stats = cache.stats();
+  EXPECT_EQ(stats.numMisses, 3);
+  EXPECT_EQ(stats.numHits, 0);
+  EXPECT_EQ(stats.numEntries, 3);
+  EXPECT_GT(stats.bytes, 0);
+
+  // An identical fragment built again hits.
+  auto replayed =
+      cache.run(makeFragment("c1 % 3 = 0"), makeSplits(), queryCtx, pool());
+  assertEqualResults(results, replayed);
+  stats = cache.stats();
+  EXPECT_EQ(stats.numHits, 3);
+  EXPECT_EQ(stats.numEntries, 3);
+
+  // A different filter misses.
+  results =
+      cache.run(makeFragment("c1 % 5 = 0"), makeSplits(), queryCtx, pool());
+  checkResults(results, "c1 % 5 = 0");
+  stats = cache.stats();
+  EXPECT_EQ(stats.numMisses, 6);
+  EXPECT_EQ(stats.numEntries, 6);
+
+  cache.clear();
+  EXPECT_EQ(cache.stats().numEntries, 0);
+  EXPECT_EQ(cache.stats().bytes, 0);
+}
+
+TEST_F(FragmentResultCacheTest, evict) {
+  auto fragment = makeFragment("c1 % 3 = 0");
+  auto splits = makeSplits();
+  FragmentResultCache sizer(100 << 20);
+  sizer.run(fragment, {splits[0]}, core::QueryCtx::createForTest(), pool());
+  const auto entryBytes = sizer.stats().bytes;
+
+  // Room for about one split's results.
+  FragmentResultCache cache(entryBytes * 3 / 2);
+  auto queryCtx = core::QueryCtx::createForTest();
+  cache.run(fragment, splits, queryCtx, pool());
+  auto stats = cache.stats();
+  EXPECT_EQ(stats.numEntries, 1);
+  EXPECT_EQ(stats.numEvictions, 2);
+  EXPECT_LE(stats.bytes, entryBytes * 3 / 2);
+
+  // The last split is cached, the first is not.
+  cache.run(fragment, {splits[2], splits[0]}, queryCtx, pool());
+  stats = cache.stats();
+  EXPECT_EQ(stats.numHits, 1);
+  EXPECT_EQ(stats.numMisses, 4);
+}
+
+TEST_F(FragmentResultCacheTest, key) {
+  auto splits = makeSplits();
+  auto fragment = makeFragment("c1 % 3 = 0");
+  const auto key =
+      FragmentResultCache::makeKey(*fragment, *splits[0].connectorSplit);
+  EXPECT_EQ(
+      key,
+      FragmentResultCache::makeKey(
+          *makeFragment("c1 % 3 = 0"), *splits[0].connectorSplit));
+  EXPECT_NE(
+      key,
+      FragmentResultCache::makeKey(*fragment, *splits[1].connectorSplit));
+  EXPECT_NE(std::string::npos, key.find(filePaths_[0]->path));
+}
+
+TEST_F(FragmentResultCacheTest, fragmentWithoutScan) {
+  FragmentResultCache cache(1 << 20);
+  auto fragment =
+      PlanBuilder()
+          .values({makeRowVector({makeFlatVector<int64_t>({1, 2})})})
+          .planNode();
+  VELOX_ASSERT_THROW(
+      cache.run(
+          fragment, makeSplits(), core::QueryCtx::createForTest(), pool()),
+      "The leaf of a cached fragment must be a table scan");
+}
@@ -0,0 +1,84 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "velox/exec/tests/utils/OperatorTestBase.h"
+#include "velox/exec/tests/utils/PlanBuilder.h"
+
+using namespace facebook::velox;
+using namespace facebook::velox::exec::test;
+
+class GroupIdTest : public OperatorTestBase {};
+
+TEST_F(GroupIdTest, varyingBatchSizes) {
+  // The null keys and group ids are constants kept between batches of the
+  // same size. The batches grow and then shrink, so that the constants are
+  // remade larger and smaller.
+  const std::vector<vector_size_t> batchSizes = {10, 100, 1'000, 1'000, 7, 1};
+  std::vector<RowVectorPtr> batches;
+  int32_t start = 0;
+  for (auto size : batchSizes) {
+    batches.push_back(makeRowVector(
+        {"k1", "k2", "a"},
+        {
+            makeFlatVector<int64_t>(
+                size, [start](auto row) { return (start + row) % 11; }),
+            makeFlatVector<int32_t>(
+                size,
+                [start](auto row) { return (start + row) % 17; },
+                nullEvery(5)),
+            makeFlatVector<int64_t>(
+                size, [start](auto row) { return start + row; }),
+        }));
+    start += size;
+  }
+  createDuckDbTable(batches);
+
+  auto plan = PlanBuilder()
+                  .values(batches)
+                  .groupId({{"k1"}, {"k2"}, {}}, {"a"})
+                  .planNode();
+
+  assertQuery(
+      plan,
+      "SELECT k1, null, a, 0::BIGINT FROM tmp "
+      "UNION ALL SELECT null, k2, a, 1::BIGINT FROM tmp "
+      "UNION ALL SELECT null, null, a, 2::BIGINT FROM tmp");
+
+  // Each input batch produces one output batch per grouping set, in order.
+  CursorParameters params;
+  params.planNode = plan;
+  auto result = readCursor(params, [](auto /*task*/) {});
+  const auto& outputs = result.second;
+  ASSERT_EQ(batches.size() * 3, outputs.size());
+  for (auto i = 0; i < outputs.size(); ++i) {
+    const auto& input = batches[i / 3];
+    const auto& output = outputs[i];
+    const int64_t groupId = i % 3;
+    const auto size = input->size();
+    SCOPED_TRACE(fmt::format("batch: {}, group id: {}", i / 3, groupId));
+    ASSERT_EQ(size, output->size());
+
+    auto expectedK1 = groupId == 0
+        ? input->childAt(0)
+        : BaseVector::createNullConstant(BIGINT(), size, pool());
+    auto expectedK2 = groupId == 1
+        ? input->childAt(1)
+        : BaseVector::createNullConstant(INTEGER(), size, pool());
+    assertEqualVectors(expectedK1, output->childAt(0));
+    assertEqualVectors(expectedK2, output->childAt(1));
+    assertEqualVectors(input->childAt(2), output->childAt(2));
+    assertEqualVectors(makeConstant(groupId, size), output->childAt(3));
+  }
+}
@@ -14,12 +14,15 @@
  * limitations under the License.
  */
 
+#include <folly/Random.h>
 #include "velox/dwio/dwrf/test/utils/BatchMaker.h"
+#include "velox/exec/HashJoinTableCache.h"
 #include "velox/exec/PlanNodeStats.h"
 #include "velox/exec/tests/utils/AssertQueryBuilder.h"
 #include "velox/exec/tests/utils/Cursor.h"
 #include "velox/exec/tests/utils/HiveConnectorTestBase.h"
 #include "velox/exec/tests/utils/PlanBuilder.h"
+#include "velox/exec/tests/utils/TempDirectoryPath.h"
 #include "velox/expression/ExprToSubfieldFilter.h"
 
 using namespace facebook::velox;
@@ -531,6 +534,37 @@ TEST_F(HashJoinTest, leftSemiJoin) {
 
   assertQuery(
       op, "SELECT t.c1 FROM t WHERE t.c0 IN (SELECT c0 FROM u WHERE c0 < 0)");
+
+  // Build side with dependent columns. These are not stored in the table.
+  auto rightVectorsWithDependents = makeRowVector(
+      {"u0", "u1"},
+      {
+          makeFlatVector<int32_t>(
+              123, [](auto row) { return row % 5; }, nullEvery(7)),
+          makeFlatVector<StringView>(
+              123, [](auto /*row*/) { return StringView("not stored"); }),
+      });
+  for (auto joinType : {core::JoinType::kLeftSemi, core::JoinType::kAnti}) {
+    planNodeIdGenerator->reset();
+    op = PlanBuilder(planNodeIdGenerator)
+             .values({leftVectors})
+             .hashJoin(
+                 {"c0"},
+                 {"u0"},
+                 PlanBuilder(planNodeIdGenerator)
+                     .values({rightVectorsWithDependents})
+                     .filter("u0 IS NOT NULL")
+                     .planNode(),
+                 "",
+                 {"c1"},
+                 joinType)
+             .planNode();
+    assertQuery(
+        op,
+        fmt::format(
+            "SELECT t.c1 FROM t WHERE t.c0 {} (SELECT c0 FROM u WHERE c0 IS NOT NULL)",
+            joinType == core::JoinType::kAnti ? "NOT IN" : "IN"));
+  }
 }
 
 TEST_F(HashJoinTest, leftSemiJoinWithFilter) {
@@ -1005,6 +1039,57 @@ TEST_F(HashJoinTest, dynamicFilters) {
   }
 }
 
+TEST_F(HashJoinTest, bloomFilterDynamicFilters) {
+  const int32_t numSplits = 10;
+  const int32_t numRowsProbe = 1024;
+  // More distinct keys than VectorHasher::kMaxDistinct spread over a range
+  // too large for an array-based hash table, so the build side cannot make an
+  // exact IN-list and makes a Bloom filter instead.
+  const int32_t numRowsBuild = 150'000;
+
+  auto leftFiles = makeFilePaths(numSplits);
+  std::vector<RowVectorPtr> leftVectors;
+  for (int i = 0; i < numSplits; i++) {
+    auto rowVector = makeRowVector({
+        makeFlatVector<int64_t>(
+            numRowsProbe, [&](auto row) { return (row + i * 1000) * 7; }),
+        makeFlatVector<int64_t>(numRowsProbe, [](auto row) { return row; }),
+    });
+    leftVectors.push_back(rowVector);
+    writeToFile(leftFiles[i]->path, rowVector);
+  }
+
+  auto rightKey = makeFlatVector<int64_t>(
+      numRowsBuild, [](auto row) { return row * 37; });
+  auto rightVectors = {makeRowVector({rightKey})};
+
+  createDuckDbTable("t", {leftVectors});
+  createDuckDbTable("u", {rightVectors});
+
+  auto probeType = ROW({"c0", "c1"}, {BIGINT(), BIGINT()});
+  auto planNodeIdGenerator = std::make_shared<PlanNodeIdGenerator>();
+  auto buildSide = PlanBuilder(planNodeIdGenerator)
+                       .values(rightVectors)
+                       .project({"c0 AS u_c0"})
+                       .planNode();
+
+  core::PlanNodeId leftScanId;
+  auto op = PlanBuilder(planNodeIdGenerator)
+                .tableScan(probeType)
+                .capturePlanNodeId(leftScanId)
+                .hashJoin({"c0"}, {"u_c0"}, buildSide, "", {"c0", "c1"})
+                .planNode();
+
+  auto task = AssertQueryBuilder(op, duckDbQueryRunner_)
+                  .splits(leftScanId, makeHiveConnectorSplits(leftFiles))
+                  .assertResults("SELECT t.* FROM t, u WHERE t.c0 = u.c0");
+  EXPECT_EQ(1, getFiltersProduced(task, 1).sum);
+  EXPECT_EQ(1, getFiltersAccepted(task, 0).sum);
+  // A Bloom filter has false positives, so the join must still run.
+  EXPECT_EQ(0, getReplacedWithFilterRows(task, 1).sum);
+  EXPECT_LT(getInputPositions(task, 1), numRowsProbe * numSplits);
+}
+
 TEST_F(HashJoinTest, leftJoin) {
   // Left side keys are [0, 1, 2,..10].
   // Use 3-rd column as row number to allow for asserting the order of results.
@@ -1538,3 +1623,316 @@ TEST_F(HashJoinTest, smallOutputBatchSize) {
       .config(core::QueryConfig::kPreferredOutputBatchSize, std::to_string(10))
       .assertResults("SELECT c0, u_c1 FROM t, u WHERE c0 = u_c0 AND c1 < u_c1");
 }
+
+TEST_F(HashJoinTest, spill) {
+  std::vector<RowVectorPtr> probeVectors;
+  std::vector<RowVectorPtr> buildVectors;
+  for (auto i = 0; i < 10; ++i) {
+    probeVectors.push_back(makeRowVector({
+        makeFlatVector<int32_t>(
+            1'000, [i](auto row) { return (i * 1'000 + row) % 2'311; }),
+        makeFlatVector<int64_t>(1'000, [i](auto row) { return i + row; }),
+    }));
+    buildVectors.push_back(makeRowVector(
+        {"u_c0", "u_c1"},
+        {
+            makeFlatVector<int32_t>(
+                500,
+                [i](auto row) { return (i * 500 + row) % 1'777; },
+                nullEvery(37)),
+            makeFlatVector<StringView>(
+                500,
+                [i](auto row) {
+                  return StringView(
+                      fmt::format("string value {} {}", i, row).c_str());
+                }),
+        }));
+  }
+
+  createDuckDbTable("t", probeVectors);
+  createDuckDbTable("u", buildVectors);
+
+  auto tempDirectory = TempDirectoryPath::create();
+  auto makePlan = [&](core::JoinType joinType,
+                      const std::vector<std::string>& output) {
+    auto planNodeIdGenerator = std::make_shared<PlanNodeIdGenerator>();
+    return PlanBuilder(planNodeIdGenerator)
+        .values(probeVectors)
+        .hashJoin(
+            {"c0"},
+            {"u_c0"},
+            PlanBuilder(planNodeIdGenerator).values(buildVectors).planNode(),
+            "",
+            output,
+            joinType)
+        .planNode();
+  };
+
+  auto assertSpill = [&](const core::PlanNodePtr& plan,
+                         const std::string& sql) {
+    auto task = AssertQueryBuilder(plan, duckDbQueryRunner_)
+                    .config(core::QueryConfig::kSpillPath, tempDirectory->path)
+                    .config(core::QueryConfig::kTestingSpillPct, "100")
+                    .assertResults(sql);
+    auto planStats = toPlanStats(task->taskStats());
+    ASSERT_LT(0, planStats.at(plan->id()).customStats["spilledPartitions"].sum);
+  };
+
+  assertSpill(
+      makePlan(core::JoinType::kInner, {"c0", "c1", "u_c1"}),
+      "SELECT c0, c1, u_c1 FROM t, u WHERE c0 = u_c0");
+
+  assertSpill(
+      makePlan(core::JoinType::kLeft, {"c0", "c1", "u_c1"}),
+      "SELECT c0, c1, u_c1 FROM t LEFT JOIN u ON c0 = u_c0");
+
+  assertSpill(
+      makePlan(core::JoinType::kLeftSemi, {"c0", "c1"}),
+      "SELECT c0, c1 FROM t WHERE c0 IN (SELECT u_c0 FROM u)");
+
+  // The build side of an anti join may not have nulls.
+  auto planNodeIdGenerator = std::make_shared<PlanNodeIdGenerator>();
+  auto plan = PlanBuilder(planNodeIdGenerator)
+                  .values(probeVectors)
+                  .hashJoin(
+                      {"c0"},
+                      {"u_c0"},
+                      PlanBuilder(planNodeIdGenerator)
+                          .values(buildVectors)
+                          .filter("u_c0 IS NOT NULL")
+                          .planNode(),
+                      "",
+                      {"c0", "c1"},
+                      core::JoinType::kAnti)
+                  .planNode();
+  assertSpill(
+      plan,
+      "SELECT c0, c1 FROM t WHERE c0 NOT IN "
+      "(SELECT u_c0 FROM u WHERE u_c0 IS NOT NULL)");
+}
+
+TEST_F(HashJoinTest, spillSplitPartitions) {
+  // All Drivers join the spilled partitions. Each partition is split once
+  // on more hash bits before it is joined.
+  constexpr int32_t kNumDrivers = 4;
+  std::vector<RowVectorPtr> probeVectors;
+  std::vector<RowVectorPtr> buildVectors;
+  for (auto i = 0; i < 5; ++i) {
+    probeVectors.push_back(makeRowVector({
+        makeFlatVector<int32_t>(
+            1'000, [i](auto row) { return (i * 1'000 + row) % 2'311; }),
+        makeFlatVector<int64_t>(1'000, [i](auto row) { return i + row; }),
+    }));
+    buildVectors.push_back(makeRowVector(
+        {"u_c0", "u_c1"},
+        {
+            makeFlatVector<int32_t>(
+                500, [i](auto row) { return (i * 500 + row) % 1'777; }),
+            makeFlatVector<int64_t>(500, [i](auto row) { return i * row; }),
+        }));
+  }
+
+  // Each Driver of a parallelizable Values produces all of its rows.
+  std::vector<RowVectorPtr> probeRows;
+  std::vector<RowVectorPtr> buildRows;
+  for (auto i = 0; i < kNumDrivers; ++i) {
+    probeRows.insert(probeRows.end(), probeVectors.begin(), probeVectors.end());
+    buildRows.insert(buildRows.end(), buildVectors.begin(), buildVectors.end());
+  }
+  createDuckDbTable("t", probeRows);
+  createDuckDbTable("u", buildRows);
+
+  auto tempDirectory = TempDirectoryPath::create();
+  auto makePlan = [&](core::JoinType joinType) {
+    auto planNodeIdGenerator = std::make_shared<PlanNodeIdGenerator>();
+    return PlanBuilder(planNodeIdGenerator)
+        .values(probeVectors, true)
+        .hashJoin(
+            {"c0"},
+            {"u_c0"},
+            PlanBuilder(planNodeIdGenerator)
+                .values(buildVectors, true)
+                .planNode(),
+            "",
+            {"c0", "c1", "u_c1"},
+            joinType)
+        .planNode();
+  };
+
+  auto assertSplit = [&](const core::PlanNodePtr& plan,
+                         const std::string& sql) {
+    auto task = AssertQueryBuilder(plan, duckDbQueryRunner_)
+                    .maxDrivers(kNumDrivers)
+                    .config(core::QueryConfig::kSpillPath, tempDirectory->path)
+                    .config(core::QueryConfig::kTestingSpillPct, "100")
+                    .assertResults(sql);
+    auto planStats = toPlanStats(task->taskStats());
+    auto& customStats = planStats.at(plan->id()).customStats;
+    ASSERT_LT(0, customStats["spilledPartitions"].sum);
+    ASSERT_LT(0, customStats["spilledPartitionSplits"].sum);
+  };
+
+  assertSplit(
+      makePlan(core::JoinType::kInner),
+      "SELECT c0, c1, u_c1 FROM t, u WHERE c0 = u_c0");
+
+  assertSplit(
+      makePlan(core::JoinType::kLeft),
+      "SELECT c0, c1, u_c1 FROM t LEFT JOIN u ON c0 = u_c0");
+}
+
+TEST_F(HashJoinTest, sharedBuildTable) {
+  auto probeVectors = makeRowVector({
+      makeFlatVector<int32_t>(1'000, [](auto row) { return row % 23; }),
+      makeFlatVector<int64_t>(1'000, [](auto row) { return row; }),
+  });
+  auto buildVectors = makeRowVector(
+      {"u_c0", "u_c1"},
+      {
+          makeFlatVector<int32_t>(300, [](auto row) { return row % 31; }),
+          makeFlatVector<int64_t>(300, [](auto row) { return row; }),
+      });
+  createDuckDbTable("t", {probeVectors});
+  createDuckDbTable("u", {buildVectors});
+
+  // The cache is process-wide, so the id is unique to this run.
+  const auto cacheId =
+      fmt::format("sharedBuildTable-{}", folly::Random::rand64());
+  core::PlanNodeId joinNodeId;
+  auto makePlan = [&](core::JoinType joinType,
+                      const std::vector<std::string>& outputLayout) {
+    auto planNodeIdGenerator = std::make_shared<PlanNodeIdGenerator>();
+    return PlanBuilder(planNodeIdGenerator)
+        .values({probeVectors})
+        .hashJoin(
+            {"c0"},
+            {"u_c0"},
+            PlanBuilder(planNodeIdGenerator).values({buildVectors}).planNode(),
+            "",
+            outputLayout,
+            joinType,
+            cacheId)
+        .capturePlanNodeId(joinNodeId)
+        .planNode();
+  };
+  auto sharedTableHits = [&](const std::shared_ptr<Task>& task) {
+    auto planStats = toPlanStats(task->taskStats());
+    const auto& buildStats =
+        planStats.at(joinNodeId).operatorStats.at("HashBuild");
+    auto it = buildStats->customStats.find("sharedTableHits");
+    return it == buildStats->customStats.end() ? 0 : it->second.sum;
+  };
+
+  auto& cache = HashJoinTableCache::getInstance();
+  const auto numMisses = cache.stats().numMisses;
+  const auto plan = makePlan(core::JoinType::kInner, {"c0", "c1", "u_c1"});
+  const std::string sql = "SELECT c0, c1, u_c1 FROM t, u WHERE c0 = u_c0";
+
+  // The first Task builds the table and the second attaches to it.
+  auto task = AssertQueryBuilder(plan, duckDbQueryRunner_)
+                  .maxDrivers(4)
+                  .assertResults(sql);
+  EXPECT_EQ(0, sharedTableHits(task));
+  task = AssertQueryBuilder(plan, duckDbQueryRunner_)
+             .maxDrivers(4)
+             .assertResults(sql);
+  EXPECT_LT(0, sharedTableHits(task));
+  EXPECT_EQ(numMisses + 1, cache.stats().numMisses);
+
+  // A semi join table has only the keys and is not the same table.
+  task = AssertQueryBuilder(
+             makePlan(core::JoinType::kLeftSemi, {"c0", "c1"}),
+             duckDbQueryRunner_)
+             .assertResults(
+                 "SELECT c0, c1 FROM t WHERE c0 IN (SELECT u_c0 FROM u)");
+  EXPECT_EQ(0, sharedTableHits(task));
+  EXPECT_EQ(numMisses + 2, cache.stats().numMisses);
+}
+
+TEST_F(HashJoinTest, sharedBuildTableEvictedOnRelease) {
+  HashJoinTableCache cache(100);
+  auto makeTable = [&]() -> std::shared_ptr<BaseHashTable> {
+    std::vector<std::unique_ptr<VectorHasher>> hashers;
+    hashers.push_back(std::make_unique<VectorHasher>(BIGINT(), 0));
+    return HashTable<true>::createForJoin(
+        std::move(hashers), {}, true, false, cache.mappedMemory());
+  };
+
+  ContinueFuture future;
+  ASSERT_EQ(nullptr, cache.get("a", "task1", &future));
+  auto a = cache.put("a", "task1", {makeTable(), false, {}}, 80);
+  ASSERT_EQ(nullptr, cache.get("b", "task2", &future));
+  auto b = cache.put("b", "task2", {makeTable(), false, {}}, 80);
+
+  // Both tables are in use, so both stay over the limit.
+  EXPECT_EQ(2, cache.stats().numEntries);
+
+  // A Task keeps only a copy of the table. Releasing it evicts 'a'.
+  auto table = a->table;
+  a.reset();
+  EXPECT_EQ(2, cache.stats().numEntries);
+  table.reset();
+  EXPECT_EQ(1, cache.stats().numEntries);
+  EXPECT_EQ(1, cache.stats().numEvictions);
+
+  // A later Task hits 'b' and releasing it leaves 'b' under the limit.
+  b.reset();
+  auto hit = cache.get("b", "task3", &future);
+  ASSERT_NE(nullptr, hit);
+  EXPECT_NE(nullptr, hit->table);
+  hit.reset();
+  EXPECT_EQ(1, cache.stats().numEntries);
+  EXPECT_EQ(80, cache.stats().bytes);
+}
+
+TEST_F(HashJoinTest, highFanOutOutputBytes) {
+  // Every probe row with key 1 matches 2'000 build rows with 100 byte
+  // strings.
+  auto probeVectors = makeRowVector({
+      makeFlatVector<int32_t>(100, [](auto row) { return row % 5; }),
+      makeFlatVector<int64_t>(100, [](auto row) { return row; }),
+  });
+  auto buildVectors = makeRowVector(
+      {"u_c0", "u_c1"},
+      {
+          makeFlatVector<int32_t>(2'000, [](auto /*row*/) { return 1; }),
+          makeFlatVector<StringView>(
+              2'000,
+              [](auto row) {
+                return StringView(std::string(100, 'a' + row % 26));
+              }),
+      });
+  createDuckDbTable("t", {probeVectors});
+  createDuckDbTable("u", {buildVectors});
+
+  core::PlanNodeId joinNodeId;
+  auto planNodeIdGenerator = std::make_shared<PlanNodeIdGenerator>();
+  auto buildPlan =
+      PlanBuilder(planNodeIdGenerator).values({buildVectors}).planNode();
+  auto plan = PlanBuilder(planNodeIdGenerator)
+                  .values({probeVectors})
+                  .hashJoin(
+                      {"c0"},
+                      {"u_c0"},
+                      buildPlan,
+                      "",
+                      {"c1", "u_c1"},
+                      core::JoinType::kLeft)
+                  .capturePlanNodeId(joinNodeId)
+                  .planNode();
+
+  auto task =
+      AssertQueryBuilder(plan, duckDbQueryRunner_)
+          .config(
+              core::QueryConfig::kPreferredOutputBatchBytes,
+              std::to_string(100'000))
+          .assertResults("SELECT c1, u_c1 FROM t LEFT JOIN u ON c0 = u_c0");
+
+  // Batches of at most 50KB of build side rows of over 100 bytes each have
+  // less than half the rows of the preferred batch size.
+  auto planStats = toPlanStats(task->taskStats());
+  const auto& joinStats = planStats.at(joinNodeId);
+  const auto numRows = joinStats.outputRows;
+  EXPECT_EQ(20 * 2'000 + 80, numRows);
+  EXPECT_GT(joinStats.outputVectors, 2 * numRows / 1'024);
+}
@@ -19,6 +19,7 @@
 #include "velox/exec/VectorHasher.h"
 #include "velox/vector/tests/VectorMaker.h"
 
+#include <folly/executors/CPUThreadPoolExecutor.h>
 #include <gtest/gtest.h>
 #include <memory>
 
@@ -31,8 +32,8 @@ using namespace facebook::velox::test;
 // payload is shuffled so as not to correlate with the probe
 // order. Tests the presence/correctness of the hit for each key and
 // measures the time for computing hashes/value ids vs the time spent
-// probing the table. Covers kArray, kNormalizedKey and kHash hash
-// modes.
+// probing the table. Covers kArray, kNormalizedKey, kNormalizedKey128
+// and kHash hash modes.
 class HashTableTest : public testing::Test {
  protected:
   void testCycle(
@@ -81,8 +82,12 @@ class HashTableTest : public testing::Test {
       batches_.insert(batches_.end(), batches.begin(), batches.end());
       startOffset += size;
     }
-    topTable_->prepareJoinTable(std::move(otherTables));
+    topTable_->prepareJoinTable(std::move(otherTables), executor_.get());
     EXPECT_EQ(topTable_->hashMode(), mode);
+    if (partitionedProbe_) {
+      topTable_->setPartitionedJoinProbe(true);
+      EXPECT_TRUE(topTable_->partitionedJoinProbe());
+    }
     LOG(INFO) << "Made table " << describeTable();
     testProbe();
     testEraseEveryN(3);
@@ -168,7 +173,8 @@ class HashTableTest : public testing::Test {
     for (int32_t i = 0; i < hashers.size(); ++i) {
       auto key = input.childAt(hashers[i]->channel());
       if (mode != BaseHashTable::HashMode::kHash) {
-        if (!hashers[i]->computeValueIds(*key, rows, lookup.hashes)) {
+        if (!hashers[i]->computeValueIds(
+                *key, rows, table.valueIds(lookup, i))) {
           rehash = true;
         }
       } else {
@@ -360,7 +366,7 @@ class HashTableTest : public testing::Test {
           auto key = batch->childAt(i);
           if (mode != BaseHashTable::HashMode::kHash) {
             hashers[i]->lookupValueIds(
-                *key, rows, scratchMemory, lookup->hashes);
+                *key, rows, scratchMemory, topTable_->valueIds(*lookup, i));
           } else {
             hashers[i]->hash(*key, rows, i > 0, lookup->hashes);
           }
@@ -442,6 +448,11 @@ class HashTableTest : public testing::Test {
   // Spacing between consecutive generated keys. Affects whether
   // Vectorhashers make ranges or ids of distinct values.
   int32_t keySpacing_ = 1;
+  // Executor for a parallel join build. Serial build if nullptr.
+  std::unique_ptr<folly::CPUThreadPoolExecutor> executor_;
+  // True if the join probes group the rows by region of the table even
+  // if the table is small.
+  bool partitionedProbe_ = false;
 };
 
 TEST_F(HashTableTest, int2DenseArray) {
@@ -478,6 +489,14 @@ TEST_F(HashTableTest, int2SparseNormalizedMostMiss) {
   testCycle(BaseHashTable::HashMode::kNormalizedKey, 100000, 2, type, 2);
 }
 
+TEST_F(HashTableTest, int3SparseNormalized128) {
+  // The ranges of the three keys multiply to more than 64 bits and there
+  // are too many distinct values for value ids.
+  auto type = ROW({"k1", "k2", "k3"}, {BIGINT(), BIGINT(), BIGINT()});
+  keySpacing_ = 1000;
+  testCycle(BaseHashTable::HashMode::kNormalizedKey128, 100000, 2, type, 3);
+}
+
 TEST_F(HashTableTest, structKey) {
   auto type =
       ROW({"key"}, {ROW({"k1", "k2", "k3"}, {BIGINT(), VARCHAR(), BIGINT()})});
@@ -493,6 +512,44 @@ TEST_F(HashTableTest, mixed6Sparse) {
   testCycle(BaseHashTable::HashMode::kHash, 1000000, 2, type, 6);
 }
 
+TEST_F(HashTableTest, parallelBuildHash) {
+  auto type =
+      ROW({"key"}, {ROW({"k1", "k2", "k3"}, {BIGINT(), VARCHAR(), BIGINT()})});
+  keySpacing_ = 1000;
+  executor_ = std::make_unique<folly::CPUThreadPoolExecutor>(4);
+  testCycle(BaseHashTable::HashMode::kHash, 100000, 4, type, 1);
+}
+
+TEST_F(HashTableTest, parallelBuildNormalized) {
+  auto type = ROW({"k1", "k2"}, {BIGINT(), BIGINT()});
+  keySpacing_ = 1000;
+  executor_ = std::make_unique<folly::CPUThreadPoolExecutor>(4);
+  testCycle(BaseHashTable::HashMode::kNormalizedKey, 50000, 4, type, 2);
+}
+
+TEST_F(HashTableTest, parallelBuildNormalized128) {
+  auto type = ROW({"k1", "k2", "k3"}, {BIGINT(), BIGINT(), BIGINT()});
+  keySpacing_ = 1000;
+  executor_ = std::make_unique<folly::CPUThreadPoolExecutor>(4);
+  testCycle(BaseHashTable::HashMode::kNormalizedKey128, 50000, 4, type, 3);
+}
+
+TEST_F(HashTableTest, partitionedProbeNormalized) {
+  auto type = ROW({"k1", "k2"}, {BIGINT(), BIGINT()});
+  keySpacing_ = 1000;
+  insertPct_ = 50;
+  partitionedProbe_ = true;
+  testCycle(BaseHashTable::HashMode::kNormalizedKey, 100000, 2, type, 2);
+}
+
+TEST_F(HashTableTest, partitionedProbeHash) {
+  auto type =
+      ROW({"key"}, {ROW({"k1", "k2", "k3"}, {BIGINT(), VARCHAR(), BIGINT()})});
+  keySpacing_ = 1000;
+  partitionedProbe_ = true;
+  testCycle(BaseHashTable::HashMode::kHash, 100000, 2, type, 1);
+}
+
 // It should be safe to call clear() before we insert any data into HashTable
 TEST_F(HashTableTest, clear) {
   std::vector<std::unique_ptr<VectorHasher>> keyHashers;
@@ -508,6 +565,38 @@ TEST_F(HashTableTest, clear) {
   table->clear();
 }
 
+TEST_F(HashTableTest, compact) {
+  constexpr int32_t kNumGroups = 10'000;
+  auto rowType = ROW({"k"}, {BIGINT()});
+  auto table = createHashTableForAggregation(rowType, 1);
+  auto lookup = std::make_unique<HashLookup>(table->hashers());
+  auto input = vectorMaker_->rowVector({vectorMaker_->flatVector<int64_t>(
+      kNumGroups, [](auto row) { return row * 17; })});
+  insertGroups(*input, *lookup, *table);
+  ASSERT_EQ(kNumGroups, table->numDistinct());
+  std::vector<char*> groups(lookup->hits.begin(), lookup->hits.end());
+
+  // Erase 9 of each 10 groups.
+  std::vector<char*> erased;
+  for (auto i = 0; i < kNumGroups; ++i) {
+    if (i % 10 != 0) {
+      erased.push_back(groups[i]);
+    }
+  }
+  table->erase(folly::Range<char**>(erased.data(), erased.size()));
+  const auto bytesBefore = table->rows()->allocatedBytes();
+  table->compact();
+  table->rows()->checkConsistency();
+  EXPECT_EQ(0, table->rows()->numFreeRows());
+  EXPECT_GT(bytesBefore, table->rows()->allocatedBytes());
+
+  // The remaining groups are found at their new place. The erased ones are
+  // added again.
+  insertGroups(*input, *lookup, *table);
+  EXPECT_EQ(kNumGroups, table->numDistinct());
+  EXPECT_EQ(kNumGroups, table->rows()->numRows());
+}
+
 /// Test edge case that used to trigger a rounding error in
 /// HashTable::enableRangeWhereCan.
 TEST_F(HashTableTest, enableRangeWhereCan) {
@@ -572,3 +661,63 @@ TEST_F(HashTableTest, arrayProbeNormalizedKey) {
 
   ASSERT_TRUE(table->hashMode() == BaseHashTable::HashMode::kNormalizedKey);
 }
+
+TEST_F(HashTableTest, groupByWithoutNormalizedKey128) {
+  constexpr int32_t kBatchSize = 10'000;
+  constexpr int32_t kNumBatches = 20;
+  auto table = createHashTableForAggregation(
+      ROW({"k1", "k2", "k3"}, {BIGINT(), BIGINT(), BIGINT()}), 3);
+  auto lookup = std::make_unique<HashLookup>(table->hashers());
+  // A group by does not reserve the second word of a 128 bit key.
+  ASSERT_EQ(1, table->rows()->normalizedKeyWords());
+
+  // The keys are spread so that two of them fit in 64 bits and three do
+  // not, once there are too many distinct values for value ids.
+  std::vector<RowVectorPtr> batches;
+  std::vector<char*> groups;
+  for (auto i = 0; i < kNumBatches; ++i) {
+    const int64_t first = i * kBatchSize;
+    std::vector<VectorPtr> keys;
+    for (auto key = 0; key < 3; ++key) {
+      keys.push_back(vectorMaker_->flatVector<int64_t>(
+          kBatchSize, [&](auto row) { return (first + row) * 1000 + key; }));
+    }
+    batches.push_back(vectorMaker_->rowVector(keys));
+    insertGroups(*batches.back(), *lookup, *table);
+    groups.insert(groups.end(), lookup->hits.begin(), lookup->hits.end());
+  }
+  ASSERT_EQ(table->hashMode(), BaseHashTable::HashMode::kHash);
+  EXPECT_EQ(kBatchSize * kNumBatches, table->numDistinct());
+
+  // The groups are found again after the changes of hash mode.
+  for (auto i = 0; i < kNumBatches; ++i) {
+    insertGroups(*batches[i], *lookup, *table);
+    for (auto row = 0; row < kBatchSize; ++row) {
+      ASSERT_EQ(groups[i * kBatchSize + row], lookup->hits[row]);
+    }
+  }
+  EXPECT_EQ(kBatchSize * kNumBatches, table->numDistinct());
+}
+
+TEST_F(HashTableTest, normalizedKeyWords) {
+  auto makeTable = [&](const std::vector<TypePtr>& keyTypes) {
+    std::vector<std::unique_ptr<VectorHasher>> keyHashers;
+    for (auto channel = 0; channel < keyTypes.size(); ++channel) {
+      keyHashers.emplace_back(
+          std::make_unique<VectorHasher>(keyTypes[channel], channel));
+    }
+    return HashTable<true>::createForJoin(
+        std::move(keyHashers), {}, true, false, mappedMemory_);
+  };
+  // Keys whose value ids may not fit in 64 bits reserve a second word.
+  EXPECT_EQ(2, makeTable({BIGINT(), BIGINT()})->rows()->normalizedKeyWords());
+  EXPECT_EQ(
+      2, makeTable({INTEGER(), VARCHAR()})->rows()->normalizedKeyWords());
+  // Keys that always fit in 64 bits, a single key and keys without value
+  // ids use one word.
+  EXPECT_EQ(
+      1, makeTable({SMALLINT(), INTEGER()})->rows()->normalizedKeyWords());
+  EXPECT_EQ(1, makeTable({BIGINT()})->rows()->normalizedKeyWords());
+  EXPECT_EQ(
+      1, makeTable({BIGINT(), DOUBLE()})->rows()->normalizedKeyWords());
+}
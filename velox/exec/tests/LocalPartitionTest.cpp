@@ -279,6 +279,33 @@ TEST_F(LocalPartitionTest, maxBufferSizePartition) {
   verifyExchangeSourceOperatorStats(task, 2100);
 }
 
+TEST_F(LocalPartitionTest, manyProducersAndConsumers) {
+  std::vector<RowVectorPtr> vectors;
+  for (auto i = 0; i < 200; i++) {
+    vectors.emplace_back(makeRowVector({makeFlatVector<int32_t>(
+        50, [i](auto row) { return i * 50 + row; })}));
+  }
+  createDuckDbTable(vectors);
+
+  auto op = PlanBuilder()
+                .values(vectors, true)
+                .localPartition({"c0"})
+                .partialAggregation({}, {"count(1)", "max(c0)"})
+                .localPartition({})
+                .finalAggregation()
+                .planNode();
+
+  // Many consumers and producers racing on a queue that keeps blocking the
+  // producers. Any lost wakeup hangs the query. Each of the 8 Values drivers
+  // produces all of 'vectors'.
+  for (const auto& maxBufferSize : {"100", "10240"}) {
+    AssertQueryBuilder(op, duckDbQueryRunner_)
+        .maxDrivers(8)
+        .config(core::QueryConfig::kMaxLocalExchangeBufferSize, maxBufferSize)
+        .assertResults("SELECT count(1) * 8, max(c0) FROM tmp");
+  }
+}
+
 TEST_F(LocalPartitionTest, outputLayoutGather) {
   std::vector<RowVectorPtr> vectors = {
       makeRowVector({
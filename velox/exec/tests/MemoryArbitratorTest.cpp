@@ -0,0 +1,146 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "velox/exec/MemoryArbitrator.h"
+#include "velox/connectors/hive/HiveConnectorSplit.h"
+#include "velox/exec/tests/utils/Cursor.h"
+#include "velox/exec/tests/utils/HiveConnectorTestBase.h"
+#include "velox/exec/tests/utils/PlanBuilder.h"
+#include "velox/exec/tests/utils/TempDirectoryPath.h"
+
+using namespace facebook::velox;
+using namespace facebook::velox::exec;
+using namespace facebook::velox::exec::test;
+
+class MemoryArbitratorTest : public HiveConnectorTestBase {
+ protected:
+  static std::shared_ptr<core::QueryCtx> newQueryCtx() {
+    auto queryCtx = core::QueryCtx::createForTest();
+    queryCtx->pool()->setMemoryUsageTracker(
+        memory::MemoryUsageTracker::create());
+    return queryCtx;
+  }
+
+  // Returns a Task that only serves to register its query with an arbitrator.
+  std::shared_ptr<Task> makeTask(
+      const std::string& taskId,
+      const std::shared_ptr<core::QueryCtx>& queryCtx) {
+    auto plan = PlanBuilder()
+                    .values({makeRowVector({makeFlatVector<int64_t>({1})})})
+                    .planNode();
+    return std::make_shared<Task>(
+        taskId, core::PlanFragment(plan), 0, queryCtx);
+  }
+};
+
+TEST_F(MemoryArbitratorTest, growFromFreeCapacity) {
+  MemoryArbitrator arbitrator(64 << 20);
+  auto queryCtx = newQueryCtx();
+  auto task = makeTask("growFromFreeCapacity", queryCtx);
+  arbitrator.addTask(task);
+  auto tracker = queryCtx->pool()->getMemoryUsageTracker();
+
+  // The cap starts at the usage and grows by at least kMinGrowthBytes.
+  tracker->update(1 << 20);
+  EXPECT_EQ(MemoryArbitrator::kMinGrowthBytes, tracker->maxTotalBytes());
+  EXPECT_EQ(
+      arbitrator.capacity() - MemoryArbitrator::kMinGrowthBytes,
+      arbitrator.stats().freeCapacity);
+
+  // Nothing to reclaim from, so asking for more than the capacity fails.
+  EXPECT_THROW(tracker->update(128 << 20), VeloxRuntimeError);
+  EXPECT_EQ(1, arbitrator.stats().numFailures);
+  tracker->update(-(1 << 20));
+}
+
+TEST_F(MemoryArbitratorTest, spillOtherQuery) {
+  constexpr int32_t kNumFiles = 10;
+  constexpr int32_t kRowsPerFile = 100'000;
+  std::vector<RowVectorPtr> vectors;
+  auto filePaths = makeFilePaths(kNumFiles);
+  for (auto i = 0; i < kNumFiles; ++i) {
+    vectors.push_back(makeRowVector({
+        makeFlatVector<int64_t>(
+            kRowsPerFile, [i](auto row) { return i * kRowsPerFile + row; }),
+        makeFlatVector<int64_t>(kRowsPerFile, [](auto row) { return row % 7; }),
+    }));
+    writeToFile(filePaths[i]->path, vectors.back());
+  }
+  createDuckDbTable(vectors);
+  auto rowType = asRowType(vectors[0]->type());
+
+  MemoryArbitrator arbitrator(256 << 20);
+
+  // Run a spillable aggregation and keep it in its input phase by not
+  // signaling the end of splits.
+  auto spillDirectory = TempDirectoryPath::create();
+  auto aggQueryCtx = newQueryCtx();
+  aggQueryCtx->setConfigOverridesUnsafe(
+      {{core::QueryConfig::kSpillPath, spillDirectory->path}});
+  core::PlanNodeId scanId;
+  CursorParameters params;
+  params.planNode = PlanBuilder()
+                        .tableScan(rowType)
+                        .capturePlanNodeId(scanId)
+                        .singleAggregation({"c0"}, {"sum(c1)"})
+                        .planNode();
+  params.queryCtx = aggQueryCtx;
+  auto cursor = std::make_unique<TaskCursor>(params);
+  auto aggTask = cursor->task();
+  arbitrator.addTask(aggTask);
+  cursor->start();
+  for (const auto& filePath : filePaths) {
+    aggTask->addSplit(
+        scanId, exec::Split(makeHiveConnectorSplit(filePath->path)));
+  }
+  while (aggTask->taskStats().numFinishedSplits < kNumFiles) {
+    std::this_thread::sleep_for(std::chrono::milliseconds(10));
+  }
+
+  // A second query asks for more than is left after taking back the unused
+  // capacity of the aggregation. The aggregation gets paused and spills.
+  auto aggTracker = aggQueryCtx->pool()->getMemoryUsageTracker();
+  const auto aggUsage = aggTracker->totalReservedBytes();
+  ASSERT_GT(aggUsage, 2 * MemoryArbitrator::kMinGrowthBytes);
+  auto queryCtx = newQueryCtx();
+  auto task = makeTask("spillOtherQuery", queryCtx);
+  arbitrator.addTask(task);
+  auto tracker = queryCtx->pool()->getMemoryUsageTracker();
+  const auto size =
+      arbitrator.capacity() - aggUsage + MemoryArbitrator::kMinGrowthBytes;
+  tracker->update(size);
+
+  auto stats = arbitrator.stats();
+  EXPECT_EQ(0, stats.numFailures);
+  EXPECT_EQ(1, stats.numReclaims);
+  EXPECT_LT(MemoryArbitrator::kMinGrowthBytes, stats.reclaimedBytes);
+  EXPECT_LT(aggTracker->totalReservedBytes(), aggUsage);
+  tracker->update(-size);
+
+  // The aggregation resumes and produces the right result from the spilled
+  // data.
+  aggTask->noMoreSplits(scanId);
+  std::vector<RowVectorPtr> results;
+  while (cursor->moveNext()) {
+    results.push_back(cursor->current());
+  }
+  assertResults(
+      results,
+      asRowType(results[0]->type()),
+      "SELECT c0, sum(c1) FROM tmp GROUP BY 1",
+      duckDbQueryRunner_);
+  auto taskStats = aggTask->taskStats().pipelineStats;
+  EXPECT_LT(0, taskStats[0].operatorStats[1].spilledBytes);
+}
@@ -180,6 +180,31 @@ class MergeJoinTest : public HiveConnectorTestBase {
     assertQuery(
         makeCursorParameters(plan, 10'000),
         "SELECT t.c0, t.c1, u.c1 FROM t LEFT JOIN u ON t.c0 = u.c0");
+
+    // Test RIGHT and FULL joins.
+    for (auto joinType : {core::JoinType::kRight, core::JoinType::kFull}) {
+      planNodeIdGenerator = std::make_shared<PlanNodeIdGenerator>();
+      plan = PlanBuilder(planNodeIdGenerator)
+                 .values(left)
+                 .mergeJoin(
+                     {"c0"},
+                     {"u_c0"},
+                     PlanBuilder(planNodeIdGenerator)
+                         .values(right)
+                         .project({"c1 as u_c1", "c0 as u_c0"})
+                         .planNode(),
+                     "",
+                     {"c0", "c1", "u_c0", "u_c1"},
+                     joinType)
+                 .planNode();
+
+      const auto sql = fmt::format(
+          "SELECT t.c0, t.c1, u.c0, u.c1 FROM t {} JOIN u ON t.c0 = u.c0",
+          joinType == core::JoinType::kRight ? "RIGHT" : "FULL OUTER");
+      for (auto batchSize : {16, 1024, 10'000}) {
+        assertQuery(makeCursorParameters(plan, batchSize), sql);
+      }
+    }
   }
 };
 
@@ -417,6 +442,50 @@ TEST_F(MergeJoinTest, leftJoinFilter) {
   }
 }
 
+TEST_F(MergeJoinTest, dictionaryOutput) {
+  auto left = makeRowVector(
+      {"t_c0", "t_c1"},
+      {
+          makeFlatVector<int32_t>(100, [](auto row) { return row / 2; }),
+          makeFlatVector<StringView>(
+              100,
+              [](auto /*row*/) { return StringView("not an inlined string"); }),
+      });
+  auto right = makeRowVector(
+      {"u_c0", "u_c1"},
+      {
+          makeFlatVector<int32_t>(100, [](auto row) { return row / 3; }),
+          makeFlatVector<int64_t>(100, [](auto row) { return row; }),
+      });
+
+  auto planNodeIdGenerator = std::make_shared<PlanNodeIdGenerator>();
+  auto makePlan = [&](const std::string& filter, core::JoinType joinType) {
+    return PlanBuilder(planNodeIdGenerator)
+        .values({left})
+        .mergeJoin(
+            {"t_c0"},
+            {"u_c0"},
+            PlanBuilder(planNodeIdGenerator).values({right}).planNode(),
+            filter,
+            {"t_c0", "t_c1", "u_c1"},
+            joinType)
+        .planNode();
+  };
+  auto plan = makePlan("", core::JoinType::kFull);
+
+  // Output rows refer to the input rows instead of copying them.
+  auto cursor = std::make_unique<TaskCursor>(makeCursorParameters(plan, 1024));
+  while (cursor->moveNext()) {
+    for (const auto& child : cursor->current()->children()) {
+      EXPECT_EQ(VectorEncoding::Simple::DICTIONARY, child->encoding());
+    }
+  }
+
+  // Filters are not supported for RIGHT and FULL joins.
+  plan = makePlan("u_c1 > 10", core::JoinType::kRight);
+  EXPECT_THROW(AssertQueryBuilder(plan).copyResults(pool()), VeloxUserError);
+}
+
 // Verify that both left-side and right-side pipelines feeding the merge join
 // always run single-threaded.
 TEST_F(MergeJoinTest, numDrivers) {
@@ -83,7 +83,7 @@ class MultiFragmentTest : public HiveConnectorTestBase {
     task->noMoreSplits("0");
   }
 
-  void assertQuery(
+  std::shared_ptr<Task> assertQuery(
       const std::shared_ptr<const core::PlanNode>& plan,
       const std::vector<std::string>& remoteTaskIds,
       const std::string& duckDbSql,
@@ -92,7 +92,7 @@ class MultiFragmentTest : public HiveConnectorTestBase {
     for (auto& taskId : remoteTaskIds) {
       splits.push_back(std::make_shared<RemoteConnectorSplit>(taskId));
     }
-    OperatorTestBase::assertQuery(plan, splits, duckDbSql, sortingKeys);
+    return OperatorTestBase::assertQuery(plan, splits, duckDbSql, sortingKeys);
   }
 
   void assertQueryOrdered(
@@ -161,6 +161,37 @@ TEST_F(MultiFragmentTest, aggregationSingleKey) {
       op, finalAggTaskIds, "SELECT c0 % 10, sum(c1) FROM tmp GROUP BY 1");
 }
 
+TEST_F(MultiFragmentTest, elasticDrivers) {
+  setupSources(20, 1'000);
+  // Adds a Driver whenever the scan spends any time off CPU.
+  configSettings_[core::QueryConfig::kMaxElasticDriversPerPipeline] = "3";
+  configSettings_[core::QueryConfig::kElasticDriverMaxCpuPct] = "100";
+  auto leafTaskId = makeTaskId("leaf", 0);
+  auto leafPlan = PlanBuilder()
+                      .tableScan(rowType_)
+                      .project({"c0 % 10 AS c0", "c1"})
+                      .partialAggregation({"c0"}, {"sum(c1)"})
+                      .partitionedOutput({}, 1)
+                      .planNode();
+  auto leafTask = makeTask(leafTaskId, leafPlan, 0);
+  // Queues all splits before starting so that the single Driver sees more
+  // splits than Drivers.
+  addHiveSplits(leafTask, filePaths_);
+  Task::start(leafTask, 1);
+
+  auto finalPlan = PlanBuilder()
+                       .exchange(leafPlan->outputType())
+                       .finalAggregation({"c0"}, {"sum(a0)"}, {BIGINT()})
+                       .planNode();
+  assertQuery(
+      finalPlan, {leafTaskId}, "SELECT c0 % 10, sum(c1) FROM tmp GROUP BY 1");
+  ASSERT_TRUE(waitForTaskCompletion(leafTask.get()));
+
+  EXPECT_GT(leafTask->numTotalDrivers(), 1);
+  EXPECT_LE(leafTask->numTotalDrivers(), 4);
+  EXPECT_EQ(leafTask->numTotalDrivers(), leafTask->numFinishedDrivers());
+}
+
 TEST_F(MultiFragmentTest, aggregationMultiKey) {
   setupSources(10, 1'000);
   std::vector<std::shared_ptr<Task>> tasks;
@@ -204,6 +235,128 @@ TEST_F(MultiFragmentTest, aggregationMultiKey) {
       "SELECT c0 % 10, c1 % 2, sum(c2) FROM tmp GROUP BY 1, 2");
 }
 
+// Pages between local tasks hold vectors instead of serialized data.
+TEST_F(MultiFragmentTest, localVectors) {
+  configSettings_[core::QueryConfig::kExchangeLocalVectors] = "true";
+  setupSources(10, 1'000);
+  std::vector<std::shared_ptr<Task>> tasks;
+  auto leafTaskId = makeTaskId("leaf", 0);
+  core::PlanNodePtr partialAggPlan;
+  {
+    partialAggPlan = PlanBuilder()
+                         .tableScan(rowType_)
+                         .project({"c0 % 10 AS c0", "c5", "c1"})
+                         .partialAggregation({"c0", "c5"}, {"sum(c1)"})
+                         .partitionedOutput({"c0"}, 3)
+                         .planNode();
+
+    auto leafTask = makeTask(leafTaskId, partialAggPlan, 0);
+    tasks.push_back(leafTask);
+    Task::start(leafTask, 4);
+    addHiveSplits(leafTask, filePaths_);
+  }
+
+  core::PlanNodePtr finalAggPlan;
+  std::vector<std::string> finalAggTaskIds;
+  for (int i = 0; i < 3; i++) {
+    finalAggPlan = PlanBuilder()
+                       .exchange(partialAggPlan->outputType())
+                       .finalAggregation({"c0", "c5"}, {"sum(a0)"}, {BIGINT()})
+                       .partitionedOutput({}, 1)
+                       .planNode();
+
+    finalAggTaskIds.push_back(makeTaskId("final-agg", i));
+    auto task = makeTask(finalAggTaskIds.back(), finalAggPlan, i);
+    tasks.push_back(task);
+    Task::start(task, 1);
+    addRemoteSplits(task, {leafTaskId});
+  }
+
+  auto op = PlanBuilder().exchange(finalAggPlan->outputType()).planNode();
+
+  assertQuery(
+      op,
+      finalAggTaskIds,
+      "SELECT c0 % 10, c5, sum(c1) FROM tmp GROUP BY 1, 2");
+}
+
+// Pages are deserialized on the executor as they arrive, optionally merging
+// the batches of a page.
+TEST_F(MultiFragmentTest, parallelDeserialize) {
+  setupSources(10, 1'000);
+  for (auto mergeBatches : {"false", "true"}) {
+    SCOPED_TRACE(mergeBatches);
+    configSettings_[core::QueryConfig::kExchangeParallelDeserialize] = "true";
+    configSettings_[core::QueryConfig::kExchangeMergeBatches] = mergeBatches;
+    configSettings_[core::QueryConfig::kPreferredOutputBatchSize] = "100";
+    std::vector<std::shared_ptr<Task>> tasks;
+    auto leafTaskId = makeTaskId(fmt::format("leaf-{}", mergeBatches), 0);
+    auto leafPlan = PlanBuilder()
+                        .tableScan(rowType_)
+                        .project({"c0 % 10 AS c0", "c5", "c1"})
+                        .partitionedOutput({"c0"}, 3)
+                        .planNode();
+    auto leafTask = makeTask(leafTaskId, leafPlan, 0);
+    tasks.push_back(leafTask);
+    Task::start(leafTask, 4);
+    addHiveSplits(leafTask, filePaths_);
+
+    core::PlanNodePtr aggPlan;
+    std::vector<std::string> aggTaskIds;
+    for (int i = 0; i < 3; i++) {
+      aggPlan = PlanBuilder()
+                    .exchange(leafPlan->outputType())
+                    .singleAggregation({"c0", "c5"}, {"sum(c1)", "count(1)"})
+                    .partitionedOutput({}, 1)
+                    .planNode();
+
+      aggTaskIds.push_back(makeTaskId(fmt::format("agg-{}", mergeBatches), i));
+      auto task = makeTask(aggTaskIds.back(), aggPlan, i);
+      tasks.push_back(task);
+      Task::start(task, 2);
+      addRemoteSplits(task, {leafTaskId});
+    }
+
+    auto op = PlanBuilder().exchange(aggPlan->outputType()).planNode();
+    assertQuery(
+        op,
+        aggTaskIds,
+        "SELECT c0 % 10, c5, sum(c1), count(1) FROM tmp GROUP BY 1, 2");
+  }
+}
+
+TEST_F(MultiFragmentTest, exchangeRequestLatency) {
+  setupSources(2, 1'000);
+  auto leafTaskId = makeTaskId("leaf", 0);
+  auto leafPlan =
+      PlanBuilder().tableScan(rowType_).partitionedOutput({}, 1).planNode();
+  auto leafTask = makeTask(leafTaskId, leafPlan, 0);
+  Task::start(leafTask, 1);
+  addHiveSplits(leafTask, filePaths_);
+
+  auto op = PlanBuilder().exchange(leafPlan->outputType()).planNode();
+  auto task = assertQuery(op, {leafTaskId}, "SELECT * FROM tmp");
+  ASSERT_TRUE(waitForTaskCompletion(task.get()));
+
+  auto& runtimeStats =
+      task->taskStats().pipelineStats[0].operatorStats[0].runtimeStats;
+  for (auto name :
+       {"exchangeRequestLatencyP50",
+        "exchangeRequestLatencyP90",
+        "exchangeRequestLatencyP99"}) {
+    ASSERT_EQ(runtimeStats.count(name), 1) << name;
+    EXPECT_EQ(runtimeStats.at(name).count, 1);
+    EXPECT_GT(runtimeStats.at(name).sum, 0);
+  }
+  ASSERT_EQ(runtimeStats.count("exchangeRequestLatency"), 1);
+  const auto& latency = runtimeStats.at("exchangeRequestLatency");
+  ASSERT_NE(latency.histogram, nullptr);
+  EXPECT_EQ(latency.histogram->count(), latency.count);
+  EXPECT_EQ(
+      latency.histogram->percentile(99),
+      runtimeStats.at("exchangeRequestLatencyP99").sum);
+}
+
 TEST_F(MultiFragmentTest, distributedTableScan) {
   setupSources(10, 1000);
   // Run the table scan several times to test the caching.
@@ -15,6 +15,7 @@
  */
 #include "velox/exec/tests/utils/OperatorTestBase.h"
 #include "velox/exec/tests/utils/PlanBuilder.h"
+#include "velox/exec/tests/utils/TempDirectoryPath.h"
 #include "velox/vector/tests/VectorMaker.h"
 
 using namespace facebook::velox;
@@ -264,3 +265,105 @@ TEST_F(OrderByTest, unknown) {
   assertQueryOrdered(
       plan, "SELECT *, null FROM tmp ORDER BY c0 DESC NULLS LAST", {0});
 }
+
+TEST_F(OrderByTest, spill) {
+  vector_size_t batchSize = 1'000;
+  std::vector<RowVectorPtr> vectors;
+  for (int32_t i = 0; i < 20; ++i) {
+    vectors.push_back(makeRowVector({
+        makeFlatVector<int64_t>(
+            batchSize,
+            [i](auto row) { return (i * 7 + row) % 97; },
+            nullEvery(11)),
+        makeFlatVector<StringView>(
+            batchSize,
+            [i](auto row) {
+              return StringView(fmt::format("{}-{}", row % 13, i).c_str());
+            }),
+        makeFlatVector<int32_t>(batchSize, [i](auto row) { return i + row; }),
+    }));
+  }
+  createDuckDbTable(vectors);
+
+  auto tempDirectory = TempDirectoryPath::create();
+  auto plan = PlanBuilder()
+                  .values(vectors)
+                  .orderBy({"c0 DESC NULLS FIRST", "c1 ASC NULLS LAST"}, false)
+                  .planNode();
+
+  CursorParameters params;
+  params.planNode = plan;
+  params.queryCtx = core::QueryCtx::createForTest();
+  params.queryCtx->setConfigOverridesUnsafe({
+      {core::QueryConfig::kSpillPath, tempDirectory->path},
+      {core::QueryConfig::kTestingSpillPct, "100"},
+  });
+  auto task = assertQueryOrdered(
+      params,
+      "SELECT * FROM tmp ORDER BY c0 DESC NULLS FIRST, c1 NULLS LAST",
+      {0, 1});
+
+  auto stats = task->taskStats().pipelineStats;
+  EXPECT_LT(0, stats[0].operatorStats[1].spilledBytes);
+
+  // Same with compressed spill files.
+  params.queryCtx = core::QueryCtx::createForTest();
+  params.queryCtx->setConfigOverridesUnsafe({
+      {core::QueryConfig::kSpillPath, tempDirectory->path},
+      {core::QueryConfig::kTestingSpillPct, "100"},
+      {core::QueryConfig::kSpillCompressionKind, "zstd"},
+  });
+  task = assertQueryOrdered(
+      params,
+      "SELECT * FROM tmp ORDER BY c0 DESC NULLS FIRST, c1 NULLS LAST",
+      {0, 1});
+
+  stats = task->taskStats().pipelineStats;
+  const auto& orderByStats = stats[0].operatorStats[1];
+  EXPECT_LT(0, orderByStats.spilledBytes);
+  EXPECT_LT(orderByStats.spilledBytes, orderByStats.spilledUncompressedBytes);
+}
+
+TEST_F(OrderByTest, multiDriver) {
+  vector_size_t batchSize = 1'000;
+  std::vector<RowVectorPtr> vectors;
+  for (int32_t i = 0; i < 20; ++i) {
+    vectors.push_back(makeRowVector({
+        makeFlatVector<int64_t>(
+            batchSize,
+            [i](auto row) { return (i * 7 + row) % 97; },
+            nullEvery(11)),
+        makeFlatVector<StringView>(
+            batchSize,
+            [i](auto row) {
+              return StringView(fmt::format("{}-{}", row % 13, i).c_str());
+            }),
+        makeFlatVector<int32_t>(batchSize, [i](auto row) { return i + row; }),
+    }));
+  }
+  createDuckDbTable(vectors);
+
+  // Each Driver gets all of 'vectors'.
+  auto plan = PlanBuilder()
+                  .values(vectors, true)
+                  .orderBy({"c0 DESC NULLS FIRST", "c1 ASC NULLS LAST"}, false)
+                  .planNode();
+
+  CursorParameters params;
+  params.planNode = plan;
+  params.maxDrivers = 4;
+  params.queryCtx = core::QueryCtx::createForTest();
+  params.queryCtx->setConfigOverridesUnsafe({
+      {core::QueryConfig::kOrderByMultiDriverEnabled, "true"},
+      {core::QueryConfig::kOrderBySortThreads, "2"},
+  });
+  // Each Driver sorts 20'000 rows on 2 threads.
+  auto task = assertQueryOrdered(
+      params,
+      "SELECT * FROM (SELECT * FROM tmp UNION ALL SELECT * FROM tmp "
+      "UNION ALL SELECT * FROM tmp UNION ALL SELECT * FROM tmp) "
+      "ORDER BY c0 DESC NULLS FIRST, c1 NULLS LAST",
+      {0, 1});
+  EXPECT_EQ(
+      4, task->taskStats().pipelineStats[0].operatorStats[1].numDrivers);
+}
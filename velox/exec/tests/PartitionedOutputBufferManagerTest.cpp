@@ -324,6 +324,23 @@ TEST_F(PartitionedOutputBufferManagerTest, maxBytes) {
   }
 }
 
+TEST_F(PartitionedOutputBufferManagerTest, unflushedBytes) {
+  auto rowType = ROW({"c0"}, {BIGINT()});
+  std::string taskId = "t0";
+  initializeTask(taskId, rowType, 5, 2);
+
+  // The producers of a task share one total.
+  EXPECT_EQ(bufferManager_->updateUnflushedBytes(taskId, 1'000), 1'000);
+  EXPECT_EQ(bufferManager_->updateUnflushedBytes(taskId, 500), 1'500);
+  EXPECT_EQ(bufferManager_->updateUnflushedBytes(taskId, -1'000), 500);
+  EXPECT_EQ(bufferManager_->updateUnflushedBytes(taskId, 0), 500);
+
+  initializeTask("t1", rowType, 5, 1);
+  EXPECT_EQ(bufferManager_->updateUnflushedBytes("t1", 10), 10);
+  EXPECT_EQ(bufferManager_->updateUnflushedBytes(taskId, -500), 0);
+  bufferManager_->removeTask("t1");
+}
+
 TEST_F(PartitionedOutputBufferManagerTest, outOfOrderAcks) {
   std::vector<std::string> names = {"c0", "c1"};
   std::vector<TypePtr> types = {BIGINT(), VARCHAR()};
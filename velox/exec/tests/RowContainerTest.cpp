@@ -221,6 +221,78 @@ TEST_F(RowContainerTest, storeExtractArrayOfVarchar) {
   roundTrip(input);
 }
 
+// Checks the hashes and comparisons of arrays of fixed width elements, which
+// take the fast paths in ContainerRowSerde.
+TEST_F(RowContainerTest, arrayOfFixedWidthKeys) {
+  auto input = makeRowVector({
+      makeNullableArrayVector<int64_t>({
+          {1, 2, 3},
+          {1, 2},
+          {1, 2, std::nullopt},
+          {1, 2, 3},
+          {},
+          {std::nullopt},
+          {1, 3},
+      }),
+      makeNullableArrayVector<double>({
+          {1.5, 2.5},
+          {1.5, std::nullopt},
+          {},
+          {1.5, 2.5},
+          {-1.0},
+          {std::nullopt, std::nullopt},
+          {1.5, 2.5, 0.0},
+      }),
+  });
+  auto numRows = input->size();
+  auto data = makeRowContainer({ARRAY(BIGINT()), ARRAY(DOUBLE())}, {});
+  std::vector<char*> rows(numRows);
+  SelectivityVector allRows(numRows);
+  for (auto i = 0; i < numRows; ++i) {
+    rows[i] = data->newRow();
+  }
+  for (auto column = 0; column < input->childrenSize(); ++column) {
+    DecodedVector decoded(*input->childAt(column), allRows);
+    for (auto i = 0; i < numRows; ++i) {
+      data->store(decoded, i, rows[i], column);
+    }
+  }
+
+  for (auto column = 0; column < input->childrenSize(); ++column) {
+    auto source = input->childAt(column);
+    testExtractColumnForAllRows(*data, rows, column, source);
+
+    std::vector<uint64_t> rowHashes(numRows);
+    data->hash(
+        column,
+        folly::Range<char**>(rows.data(), rows.size()),
+        false,
+        rowHashes.data());
+    DecodedVector decoded(*source, allRows);
+    auto rowColumn = data->columnAt(column);
+    for (auto i = 0; i < numRows; ++i) {
+      EXPECT_EQ(source->hashValueAt(i), rowHashes[i]);
+      for (auto j = 0; j < numRows; ++j) {
+        for (auto nullsFirst : {true, false}) {
+          CompareFlags flags{nullsFirst, true};
+          auto expected =
+              sign(source->compare(source.get(), i, j, flags).value());
+          EXPECT_EQ(
+              expected,
+              sign(data->compare(rows[i], rowColumn, decoded, j, flags)))
+              << "column " << column << " rows " << i << ", " << j;
+          EXPECT_EQ(
+              expected, sign(data->compare(rows[i], rows[j], column, flags)))
+              << "column " << column << " rows " << i << ", " << j;
+        }
+        EXPECT_EQ(
+            source->equalValueAt(source.get(), i, j),
+            data->equals<false>(rows[i], rowColumn, decoded, j));
+      }
+    }
+  }
+}
+
 TEST_F(RowContainerTest, types) {
   constexpr int32_t kNumRows = 100;
   auto batch = makeDataset(
@@ -419,6 +491,81 @@ TEST_F(RowContainerTest, erase) {
   data->checkConsistency();
 }
 
+TEST_F(RowContainerTest, compact) {
+  constexpr int32_t kNumRows = 100'000;
+  auto data = makeRowContainer({BIGINT()}, {VARCHAR()}, false);
+  facebook::velox::test::VectorMaker vectorMaker{pool_.get()};
+  std::vector<std::string> strings(kNumRows);
+  for (auto i = 0; i < kNumRows; ++i) {
+    strings[i] = fmt::format("string {} that is not inlined", i);
+  }
+  std::vector<VectorPtr> input = {
+      vectorMaker.flatVector<int64_t>(kNumRows, [](auto row) { return row; }),
+      vectorMaker.flatVector<StringView>(
+          kNumRows, [&](auto row) { return StringView(strings[row]); }),
+  };
+  SelectivityVector allRows(kNumRows);
+  std::vector<DecodedVector> decoded;
+  for (auto& vector : input) {
+    decoded.emplace_back(*vector, allRows);
+  }
+  std::vector<char*> rows(kNumRows);
+  for (auto i = 0; i < kNumRows; ++i) {
+    rows[i] = data->newRow();
+    if (i == kNumRows / 2) {
+      // The rows after this have no normalized key.
+      data->disableNormalizedKeys();
+    }
+    for (auto column = 0; column < decoded.size(); ++column) {
+      data->store(decoded[column], i, rows[i], column);
+    }
+  }
+
+  // Erase all but every 10th row.
+  std::vector<char*> erased;
+  std::vector<int64_t> expectedKeys;
+  for (auto i = 0; i < kNumRows; ++i) {
+    if (i % 10 == 0) {
+      expectedKeys.push_back(i);
+    } else {
+      erased.push_back(rows[i]);
+    }
+  }
+  data->eraseRows(folly::Range<char**>(erased.data(), erased.size()));
+  const auto bytesBefore = data->allocatedBytes();
+  const auto stringBytesBefore = data->stringAllocator().retainedSize();
+
+  data->compact();
+  data->checkConsistency();
+  EXPECT_EQ(0, data->numFreeRows());
+  EXPECT_EQ(expectedKeys.size(), data->numRows());
+  EXPECT_GT(bytesBefore, data->allocatedBytes());
+  // The strings of the erased rows are released as well.
+  EXPECT_GT(stringBytesBefore / 2, data->stringAllocator().retainedSize());
+
+  // The rows keep their order and values.
+  std::vector<char*> compacted(data->numRows());
+  RowContainerIterator iter;
+  ASSERT_EQ(
+      compacted.size(),
+      data->listRows(&iter, compacted.size(), compacted.data()));
+  auto keys = BaseVector::create(BIGINT(), compacted.size(), pool_.get());
+  data->extractColumn(compacted.data(), compacted.size(), 0, keys);
+  auto values = BaseVector::create(VARCHAR(), compacted.size(), pool_.get());
+  data->extractColumn(compacted.data(), compacted.size(), 1, values);
+  for (auto i = 0; i < compacted.size(); ++i) {
+    ASSERT_EQ(expectedKeys[i], keys->as<FlatVector<int64_t>>()->valueAt(i));
+    ASSERT_EQ(
+        StringView(strings[expectedKeys[i]]),
+        values->as<FlatVector<StringView>>()->valueAt(i));
+  }
+
+  // New rows are added after the compacted ones.
+  data->newRow();
+  EXPECT_EQ(expectedKeys.size() + 1, data->numRows());
+  data->checkConsistency();
+}
+
 TEST_F(RowContainerTest, initialNulls) {
   std::vector<TypePtr> keys{INTEGER()};
   std::vector<TypePtr> dependent{INTEGER()};
@@ -0,0 +1,191 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#include "velox/exec/SortKeyEncoder.h"
+#include <gtest/gtest.h>
+#include "velox/exec/tests/utils/RowContainerTestBase.h"
+
+using namespace facebook::velox;
+using namespace facebook::velox::exec;
+
+namespace {
+int32_t sign(int32_t value) {
+  return value < 0 ? -1 : value > 0 ? 1 : 0;
+}
+} // namespace
+
+class SortKeyEncoderTest : public exec::test::RowContainerTestBase {
+ protected:
+  // Returns all combinations of null placement and direction for 'numKeys'
+  // keys that have the same flags.
+  static std::vector<std::vector<CompareFlags>> allFlags(int32_t numKeys) {
+    std::vector<std::vector<CompareFlags>> result;
+    for (auto nullsFirst : {true, false}) {
+      for (auto ascending : {true, false}) {
+        result.push_back(std::vector<CompareFlags>(
+            numKeys, CompareFlags{nullsFirst, ascending, false}));
+      }
+    }
+    return result;
+  }
+
+  // Checks that the encoded keys of all pairs of rows of 'data' order the
+  // rows as the full comparison does.
+  void testOrder(
+      const RowVectorPtr& data,
+      const std::vector<CompareFlags>& flags,
+      bool expectComplete) {
+    auto& types = data->type()->asRow().children();
+    SortKeyEncoder encoder(types, flags);
+    EXPECT_EQ(expectComplete, encoder.isComplete());
+    ASSERT_GT(encoder.keySize(), 0);
+
+    const auto size = data->size();
+    SelectivityVector allRows(size);
+    std::vector<DecodedVector> decoded(types.size());
+    for (auto i = 0; i < types.size(); ++i) {
+      decoded[i].decode(*data->childAt(i), allRows);
+    }
+    std::vector<std::vector<char>> keys(size);
+    for (auto row = 0; row < size; ++row) {
+      keys[row].resize(encoder.keySize());
+      encoder.encode(decoded, row, keys[row].data());
+    }
+
+    for (auto left = 0; left < size; ++left) {
+      for (auto right = 0; right < size; ++right) {
+        int32_t expected = 0;
+        for (auto i = 0; i < types.size() && expected == 0; ++i) {
+          expected = data->childAt(i)
+                         ->compare(
+                             data->childAt(i).get(), left, right, flags[i])
+                         .value();
+        }
+        auto result =
+            sign(encoder.compare(keys[left].data(), keys[right].data()));
+        if (result != 0 || encoder.isComplete()) {
+          EXPECT_EQ(sign(expected), result)
+              << data->toString(left) << " vs " << data->toString(right);
+        }
+      }
+    }
+  }
+
+  // Sorts the rows of 'data' in a RowContainer and checks that they are in
+  // order.
+  void testSortRows(
+      const RowVectorPtr& data,
+      const std::vector<CompareFlags>& flags) {
+    auto& types = data->type()->asRow().children();
+    auto container = makeRowContainer(types, {}, false);
+    const auto size = data->size();
+    SelectivityVector allRows(size);
+    std::vector<char*> rows(size);
+    for (auto row = 0; row < size; ++row) {
+      rows[row] = container->newRow();
+    }
+    for (auto i = 0; i < types.size(); ++i) {
+      DecodedVector decoded(*data->childAt(i), allRows);
+      for (auto row = 0; row < size; ++row) {
+        container->store(decoded, row, rows[row], i);
+      }
+    }
+    // The scratch memory of the sort is from the pool and freed after.
+    const auto poolBytes = pool_->getCurrentBytes();
+    SortKeyEncoder(types, flags)
+        .sortRows(
+            *container,
+            folly::Range<char**>(rows.data(), rows.size()),
+            *pool_);
+    EXPECT_EQ(poolBytes, pool_->getCurrentBytes());
+    for (auto i = 1; i < size; ++i) {
+      EXPECT_LE(container->compareRows(rows[i - 1], rows[i], flags), 0);
+    }
+  }
+};
+
+TEST_F(SortKeyEncoderTest, integers) {
+  velox::test::VectorMaker vectorMaker{pool_.get()};
+  auto data = vectorMaker.rowVector(
+      {vectorMaker.flatVectorNullable<int64_t>(
+           {0,
+            std::nullopt,
+            -1,
+            1,
+            std::numeric_limits<int64_t>::min(),
+            std::numeric_limits<int64_t>::max(),
+            1,
+            std::nullopt}),
+       vectorMaker.flatVectorNullable<int32_t>(
+           {5, 1, std::nullopt, -7, 3, 0, -7, 2}),
+       vectorMaker.flatVectorNullable<int8_t>(
+           {-128, 127, 0, std::nullopt, -1, 1, 1, 0})});
+  for (const auto& flags : allFlags(3)) {
+    testOrder(data, flags, true);
+    testSortRows(data, flags);
+  }
+}
+
+TEST_F(SortKeyEncoderTest, floatingPoint) {
+  velox::test::VectorMaker vectorMaker{pool_.get()};
+  const auto nan = std::numeric_limits<double>::quiet_NaN();
+  const auto inf = std::numeric_limits<double>::infinity();
+  auto data = vectorMaker.rowVector({vectorMaker.flatVectorNullable<double>(
+      {0.0, -0.0, nan, -nan, inf, -inf, 1.5, -1.5, std::nullopt, 1e-300})});
+  for (const auto& flags : allFlags(1)) {
+    testOrder(data, flags, true);
+    testSortRows(data, flags);
+  }
+}
+
+TEST_F(SortKeyEncoderTest, strings) {
+  velox::test::VectorMaker vectorMaker{pool_.get()};
+  auto data = vectorMaker.rowVector(
+      {vectorMaker.flatVectorNullable<StringView>(
+           {"",
+            "a",
+            "ab",
+            std::nullopt,
+            "a string longer than 12 bytes",
+            "a string longer than 12 bytes too",
+            "b",
+            "a"}),
+       vectorMaker.flatVector<int64_t>({1, 2, 3, 4, 5, 6, 7, 8})});
+  for (const auto& flags : allFlags(2)) {
+    // The key after the string is not encoded.
+    testOrder(data, flags, false);
+    testSortRows(data, flags);
+  }
+}
+
+TEST_F(SortKeyEncoderTest, keySize) {
+  // A null byte and 8 bytes per bigint. The fourth key does not fit.
+  SortKeyEncoder bigints(
+      {BIGINT(), BIGINT(), BIGINT(), BIGINT()},
+      std::vector<CompareFlags>(4));
+  EXPECT_EQ(27, bigints.keySize());
+  EXPECT_FALSE(bigints.isComplete());
+
+  // Encoding stops at a type that is not encoded.
+  SortKeyEncoder array(
+      {INTEGER(), ARRAY(INTEGER()), INTEGER()}, std::vector<CompareFlags>(3));
+  EXPECT_EQ(5, array.keySize());
+  EXPECT_FALSE(array.isComplete());
+
+  SortKeyEncoder none({MAP(INTEGER(), INTEGER())}, {CompareFlags{}});
+  EXPECT_EQ(0, none.keySize());
+}
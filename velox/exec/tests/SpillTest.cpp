@@ -14,9 +14,12 @@
  * limitations under the License.
  */
 #include "velox/exec/Spill.h"
+#include <folly/executors/IOThreadPoolExecutor.h>
 #include <gtest/gtest.h>
 #include <algorithm>
 #include <array>
+#include <filesystem>
+#include "velox/common/base/tests/GTestUtils.h"
 #include "velox/common/file/FileSystems.h"
 #include "velox/exec/tests/utils/TempDirectoryPath.h"
 #include "velox/serializers/PrestoSerializer.h"
@@ -97,3 +100,184 @@ TEST_F(SpillTest, spillState) {
     ASSERT_EQ(nullptr, merge->next());
   }
 }
+
+TEST_F(SpillTest, compressedSpillState) {
+  for (const auto& kind : {"lz4", "zstd"}) {
+    const auto codec = spillCompressionCodec(kind);
+    auto tempDirectory = exec::test::TempDirectoryPath::create();
+    SpillState state(
+        tempDirectory->path + "/test",
+        1,
+        1,
+        10000,
+        *pool(),
+        *mappedMemory_,
+        {},
+        codec);
+    state.setNumPartitions(1);
+    for (auto batch = 0; batch < 10; ++batch) {
+      state.appendToPartition(
+          0,
+          makeRowVector({makeFlatVector<int64_t>(
+              10000, [&](auto row) { return row * 10 + batch; })}));
+      state.finishWrite(0);
+    }
+    // Small integers in a sequence compress well.
+    EXPECT_LT(state.spilledBytes(), state.spilledUncompressedBytes());
+    EXPECT_LT(100'000 * sizeof(int64_t), state.spilledUncompressedBytes());
+
+    auto merge = state.startMerge(0, nullptr);
+    for (auto i = 0; i < 100000; ++i) {
+      auto stream = merge->next();
+      ASSERT_NE(nullptr, stream);
+      EXPECT_EQ(i, stream->decoded(0).valueAt<int64_t>(stream->currentIndex()));
+      stream->pop();
+    }
+    ASSERT_EQ(nullptr, merge->next());
+  }
+  EXPECT_THROW(spillCompressionCodec("brotli"), VeloxUserError);
+  // An unknown kind is not resolved if spilling is disabled.
+  EXPECT_EQ(
+      folly::io::CodecType::NO_COMPRESSION,
+      spillCompressionCodec(std::nullopt, "brotli"));
+  EXPECT_THROW(
+      spillCompressionCodec(std::string("/tmp/spill"), "brotli"),
+      VeloxUserError);
+}
+
+TEST_F(SpillTest, asyncSpillState) {
+  // Writes and reads through an executor, with and without compression. Each
+  // batch is larger than the 1MB read buffer, so that reads ahead cross batch
+  // boundaries.
+  folly::IOThreadPoolExecutor executor(4);
+  for (const auto& kind : {"none", "lz4"}) {
+    auto tempDirectory = exec::test::TempDirectoryPath::create();
+    SpillState state(
+        tempDirectory->path + "/test",
+        1,
+        1,
+        1 << 20,
+        *pool(),
+        *mappedMemory_,
+        {},
+        spillCompressionCodec(kind),
+        &executor);
+    state.setNumPartitions(1);
+    constexpr int32_t kBatchSize = 200'000;
+    for (auto batch = 0; batch < 5; ++batch) {
+      state.appendToPartition(
+          0,
+          makeRowVector({makeFlatVector<int64_t>(
+              kBatchSize, [&](auto row) { return row * 5 + batch; })}));
+      state.finishWrite(0);
+    }
+    EXPECT_LT(0, state.spilledBytes());
+
+    auto merge = state.startMerge(0, nullptr);
+    for (auto i = 0; i < 5 * kBatchSize; ++i) {
+      auto stream = merge->next();
+      ASSERT_NE(nullptr, stream);
+      ASSERT_EQ(i, stream->decoded(0).valueAt<int64_t>(stream->currentIndex()));
+      stream->pop();
+    }
+    ASSERT_EQ(nullptr, merge->next());
+  }
+}
+
+TEST_F(SpillTest, stripedSpillState) {
+  // Spills to two directories. The files of each partition alternate between
+  // them.
+  auto firstDirectory = exec::test::TempDirectoryPath::create();
+  auto secondDirectory = exec::test::TempDirectoryPath::create();
+  const auto path = appendToSpillPath(
+      firstDirectory->path + "," + secondDirectory->path, "/test");
+  EXPECT_EQ(
+      std::vector<std::string>(
+          {firstDirectory->path + "/test", secondDirectory->path + "/test"}),
+      splitSpillPath(path));
+  SpillState state(path, 2, 1, 10000, *pool(), *mappedMemory_);
+  state.setNumPartitions(2);
+  for (auto partition = 0; partition < 2; ++partition) {
+    for (auto batch = 0; batch < 4; ++batch) {
+      state.appendToPartition(
+          partition,
+          makeRowVector({makeFlatVector<int64_t>(
+              10000, [&](auto row) { return row * 4 + batch; })}));
+      state.finishWrite(partition);
+    }
+  }
+  auto pathStats = state.pathStats();
+  ASSERT_EQ(2, pathStats.size());
+  EXPECT_EQ(state.spilledBytes(), pathStats[0].bytes + pathStats[1].bytes);
+  EXPECT_EQ(pathStats[0].bytes, pathStats[1].bytes);
+  auto numFiles = [](const std::string& directory) {
+    return std::distance(
+        std::filesystem::directory_iterator(directory),
+        std::filesystem::directory_iterator());
+  };
+  EXPECT_EQ(4, numFiles(firstDirectory->path));
+  EXPECT_EQ(4, numFiles(secondDirectory->path));
+
+  for (auto partition = 0; partition < 2; ++partition) {
+    auto merge = state.startMerge(partition, nullptr);
+    for (auto i = 0; i < 40000; ++i) {
+      auto stream = merge->next();
+      ASSERT_NE(nullptr, stream);
+      ASSERT_EQ(i, stream->decoded(0).valueAt<int64_t>(stream->currentIndex()));
+      stream->pop();
+    }
+    ASSERT_EQ(nullptr, merge->next());
+  }
+
+  VELOX_ASSERT_THROW(splitSpillPath("/a,,/b"), "Empty prefix in spill path");
+}
+
+TEST_F(SpillTest, overflowSpillState) {
+  // The local tier holds the first file. The local spill bytes are then over
+  // the quota and the other files go to the overflow tier.
+  auto localDirectory = exec::test::TempDirectoryPath::create();
+  auto overflowDirectory = exec::test::TempDirectoryPath::create();
+  const auto initialLocalBytes = SpillFile::localSpillBytes();
+  {
+    SpillState state(
+        localDirectory->path + "/test|" + overflowDirectory->path + "/test",
+        1,
+        1,
+        10000,
+        *pool(),
+        *mappedMemory_,
+        {},
+        folly::io::CodecType::NO_COMPRESSION,
+        nullptr,
+        initialLocalBytes + 1);
+    state.setNumPartitions(1);
+    for (auto batch = 0; batch < 4; ++batch) {
+      state.appendToPartition(
+          0,
+          makeRowVector({makeFlatVector<int64_t>(
+              10000, [&](auto row) { return row * 4 + batch; })}));
+      state.finishWrite(0);
+    }
+    auto pathStats = state.pathStats();
+    ASSERT_EQ(2, pathStats.size());
+    EXPECT_FALSE(pathStats[0].overflow);
+    EXPECT_TRUE(pathStats[1].overflow);
+    EXPECT_EQ(3 * pathStats[0].bytes, pathStats[1].bytes);
+    EXPECT_EQ(
+        initialLocalBytes + pathStats[0].bytes, SpillFile::localSpillBytes());
+
+    auto merge = state.startMerge(0, nullptr);
+    for (auto i = 0; i < 40000; ++i) {
+      auto stream = merge->next();
+      ASSERT_NE(nullptr, stream);
+      ASSERT_EQ(i, stream->decoded(0).valueAt<int64_t>(stream->currentIndex()));
+      stream->pop();
+    }
+    ASSERT_EQ(nullptr, merge->next());
+  }
+  EXPECT_EQ(initialLocalBytes, SpillFile::localSpillBytes());
+
+  EXPECT_EQ("/a/x,/b/x|/c/x", appendToSpillPath("/a,/b|/c", "/x"));
+  VELOX_ASSERT_THROW(
+      splitSpillTiers("/a|/b|/c"), "Too many tiers in spill path");
+}
@@ -13,6 +13,8 @@
  * See the License for the specific language governing permissions and
  * limitations under the License.
  */
+#include "velox/exec/PlanNodeStats.h"
+#include "velox/exec/tests/utils/AssertQueryBuilder.h"
 #include "velox/exec/tests/utils/OperatorTestBase.h"
 #include "velox/exec/tests/utils/PlanBuilder.h"
 
@@ -274,3 +276,35 @@ TEST_F(StreamingAggregationTest, partialStreaming) {
 
   testMultiKeyAggregation(keys, {"c0"});
 }
+
+TEST_F(StreamingAggregationTest, preGroupedKeysChangeBetweenBatches) {
+  // The pre-grouped key c0 changes only between batches. The groups of each
+  // batch are produced before the next batch is added.
+  std::vector<RowVectorPtr> data;
+  for (auto i = 0; i < 4; ++i) {
+    data.push_back(makeRowVector({
+        makeFlatVector<int32_t>(100, [i](auto /*row*/) { return i; }),
+        makeFlatVector<int32_t>(100, [](auto row) { return row % 5; }),
+        makeFlatVector<int64_t>(100, [i](auto row) { return i * 100 + row; }),
+    }));
+  }
+  createDuckDbTable(data);
+
+  core::PlanNodeId aggId;
+  auto plan = PlanBuilder()
+                  .values(data)
+                  .aggregation(
+                      {"c0", "c1"},
+                      {"c0"},
+                      {"count(1)", "sum(c2)"},
+                      {},
+                      core::AggregationNode::Step::kSingle,
+                      false)
+                  .capturePlanNodeId(aggId)
+                  .planNode();
+  auto task =
+      AssertQueryBuilder(plan, duckDbQueryRunner_)
+          .assertResults(
+              "SELECT c0, c1, count(1), sum(c2) FROM tmp GROUP BY 1, 2");
+  EXPECT_EQ(toPlanStats(task->taskStats()).at(aggId).outputVectors, 4);
+}
@@ -395,6 +395,72 @@ TEST_F(TableScanTest, count) {
   EXPECT_EQ(numRead, 10'000);
 }
 
+TEST_F(TableScanTest, splitPreload) {
+  auto vectors = makeVectors(10, 1'000);
+  std::vector<std::shared_ptr<TempFilePath>> filePaths;
+  for (auto i = 0; i < 6; ++i) {
+    filePaths.push_back(TempFilePath::create());
+    writeToFile(filePaths.back()->path, vectors);
+  }
+  createDuckDbTable(vectors);
+
+  CursorParameters params;
+  params.planNode = tableScanNode(ROW({"c0", "c1"}, {BIGINT(), INTEGER()}));
+  params.queryCtx = core::QueryCtx::createForTest();
+  params.queryCtx->setConfigOverridesUnsafe(
+      {{core::QueryConfig::kMaxSplitPreloadPerDriver, "2"}});
+
+  bool splitsAdded = false;
+  auto task = test::assertQuery(
+      params,
+      [&](Task* task) {
+        if (splitsAdded) {
+          return;
+        }
+        splitsAdded = true;
+        for (auto& filePath : filePaths) {
+          task->addSplit("0", makeHiveSplit(filePath->path));
+        }
+        task->noMoreSplits("0");
+      },
+      "SELECT c0, c1 FROM tmp, range(6)",
+      duckDbQueryRunner_);
+  // All splits after the first one are preloaded. The first one is opened
+  // on the connector's executor.
+  auto stats = getTableScanRuntimeStats(task);
+  EXPECT_EQ(5, stats["preloadedSplits"].sum);
+  EXPECT_EQ(1, stats["asyncOpenedSplits"].sum);
+}
+
+TEST_F(TableScanTest, limitPushdown) {
+  auto vectors = makeVectors(10, 1'000);
+  auto filePath = TempFilePath::create();
+  writeToFile(filePath->path, vectors);
+  createDuckDbTable(vectors);
+
+  auto rowType = ROW({"c0", "c1"}, {BIGINT(), INTEGER()});
+  auto plan = PlanBuilder()
+                  .tableScan(rowType)
+                  .project({"c0 + 1", "c1"})
+                  .limit(0, 10, false)
+                  .planNode();
+  auto task =
+      assertQuery(plan, {filePath}, "SELECT c0 + 1, c1 FROM tmp LIMIT 10");
+  EXPECT_EQ(10, getTableScanRuntimeStats(task)["pushdownRowLimit"].sum);
+  // The scan reads only the rows the Limit needs.
+  EXPECT_EQ(10, getTableScanStats(task).rawInputRows);
+
+  // A filter between the scan and the Limit stops the pushdown.
+  plan = PlanBuilder()
+             .tableScan(rowType)
+             .filter("c1 % 2 = 0")
+             .limit(0, 10, false)
+             .planNode();
+  task = assertQuery(
+      plan, {filePath}, "SELECT c0, c1 FROM tmp WHERE c1 % 2 = 0 LIMIT 10");
+  EXPECT_EQ(0, getTableScanRuntimeStats(task).count("pushdownRowLimit"));
+}
+
 // Test that adding the same split with the same sequence id does not cause
 // double read and the 2nd split is ignored.
 TEST_F(TableScanTest, sequentialSplitNoDoubleRead) {
@@ -1766,6 +1832,120 @@ TEST_F(TableScanTest, aggregationPushdown) {
   EXPECT_EQ(0, loadedToValueHook(task));
 }
 
+TEST_F(TableScanTest, countAndStringAggregationPushdown) {
+  auto rowType = ROW(
+      {"c0", "c1", "c2", "c3"}, {TINYINT(), BIGINT(), BOOLEAN(), VARCHAR()});
+  auto vectors = makeVectors(10, 1'000, rowType);
+  auto filePath = TempFilePath::create();
+  writeToFile(filePath->path, vectors);
+  createDuckDbTable(vectors);
+
+  auto loadedToValueHook = [](const std::shared_ptr<Task>& task) {
+    auto stats =
+        task->taskStats().pipelineStats[0].operatorStats[0].runtimeStats;
+    auto it = stats.find("loadedToValueHook");
+    return it != stats.end() ? it->second.sum : 0;
+  };
+
+  auto op = PlanBuilder()
+                .tableScan(rowType)
+                .singleAggregation(
+                    {"c0"}, {"count(c1)", "count_if(c2)", "max(c3)"})
+                .planNode();
+  auto task = assertQuery(
+      op,
+      {filePath},
+      "SELECT c0, count(c1), count_if(c2), max(c3) FROM tmp GROUP BY c0");
+  EXPECT_EQ(3 * 10'000, loadedToValueHook(task));
+
+  op = PlanBuilder()
+           .tableScan(rowType)
+           .singleAggregation({"c0"}, {"min(c3)", "bool_or(c2)"})
+           .planNode();
+  task = assertQuery(
+      op, {filePath}, "SELECT c0, min(c3), bool_or(c2) FROM tmp GROUP BY c0");
+  EXPECT_EQ(2 * 10'000, loadedToValueHook(task));
+
+  // Group by a string column.
+  op = PlanBuilder()
+           .tableScan(rowType)
+           .singleAggregation({"c3"}, {"count(c1)", "bool_and(c2)"})
+           .planNode();
+  task = assertQuery(
+      op,
+      {filePath},
+      "SELECT c3, count(c1), bool_and(c2) FROM tmp GROUP BY c3");
+  EXPECT_EQ(2 * 10'000, loadedToValueHook(task));
+}
+
+TEST_F(TableScanTest, aggregatesFromStats) {
+  auto vectors = makeVectors(10, 1'000);
+  std::vector<std::shared_ptr<TempFilePath>> filePaths;
+  for (auto i = 0; i < 2; ++i) {
+    filePaths.push_back(TempFilePath::create());
+    writeToFile(filePaths.back()->path, vectors);
+  }
+  createDuckDbTable(vectors);
+
+  auto outputType =
+      ROW({"a0", "a1", "a2", "a3"}, {BIGINT(), BIGINT(), INTEGER(), VARCHAR()});
+  ColumnHandleMap assignments = {
+      {"a1", regularColumn("c0", BIGINT())},
+      {"a2", regularColumn("c1", INTEGER())},
+      {"a3", regularColumn("c5", VARCHAR())}};
+  std::vector<PushdownAggregate> aggregates = {
+      PushdownAggregate::kCount,
+      PushdownAggregate::kCount,
+      PushdownAggregate::kMin,
+      PushdownAggregate::kMax};
+  auto makePlan = [&](SubfieldFilters filters) {
+    auto tableHandle = std::make_shared<HiveTableHandle>(
+        kHiveConnectorId,
+        "hive_table",
+        true,
+        std::move(filters),
+        nullptr,
+        aggregates);
+    return PlanBuilder()
+        .tableScan(outputType, tableHandle, assignments)
+        .singleAggregation({}, {"sum(a0)", "sum(a1)", "min(a2)", "max(a3)"})
+        .planNode();
+  };
+  auto splitsFromStats = [&](const std::shared_ptr<Task>& task) {
+    return getTableScanRuntimeStats(task)["splitsAggregatedFromStats"].sum;
+  };
+
+  // No filter. The file statistics answer each split.
+  auto task = assertQuery(
+      makePlan({}),
+      filePaths,
+      "SELECT count(*) * 2, count(c0) * 2, min(c1), max(c5) FROM tmp");
+  EXPECT_EQ(2, splitsFromStats(task));
+
+  // A filter that all values pass.
+  task = assertQuery(
+      makePlan(SubfieldFiltersBuilder()
+                   .add(
+                       "c0",
+                       between(
+                           std::numeric_limits<int64_t>::min(),
+                           std::numeric_limits<int64_t>::max(),
+                           true))
+                   .build()),
+      filePaths,
+      "SELECT count(*) * 2, count(c0) * 2, min(c1), max(c5) FROM tmp");
+  EXPECT_EQ(2, splitsFromStats(task));
+
+  // A filter that drops some rows. The rows are read and aggregated.
+  task = assertQuery(
+      makePlan(
+          SubfieldFiltersBuilder().add("c0", greaterThanOrEqual(0)).build()),
+      filePaths,
+      "SELECT count(*) * 2, count(c0) * 2, min(c1), max(c5) FROM tmp "
+      "WHERE c0 >= 0");
+  EXPECT_EQ(0, splitsFromStats(task));
+}
+
 TEST_F(TableScanTest, bitwiseAggregationPushdown) {
   auto vectors = makeVectors(10, 1'000);
   auto filePath = TempFilePath::create();
@@ -13,9 +13,12 @@
  * See the License for the specific language governing permissions and
  * limitations under the License.
  */
+#include "velox/common/base/tests/GTestUtils.h"
 #include "velox/dwio/common/DataSink.h"
+#include "velox/exec/tests/utils/AssertQueryBuilder.h"
 #include "velox/exec/tests/utils/HiveConnectorTestBase.h"
 #include "velox/exec/tests/utils/PlanBuilder.h"
+#include "velox/exec/tests/utils/TempDirectoryPath.h"
 
 #include "velox/common/base/tests/Fs.h"
 
@@ -34,6 +37,42 @@ class TableWriteTest : public HiveConnectorTestBase {
     return BaseVector::createConstant(value, size, pool_.get());
   }
 
+  // Writes 'vectors' to a table under 'directory' partitioned by 'p' and
+  // bucketed by 'c0' into 4 buckets.
+  core::PlanNodePtr partitionedWritePlan(
+      const std::vector<RowVectorPtr>& vectors,
+      const std::string& directory) {
+    return PlanBuilder()
+        .values(vectors)
+        .tableWrite(
+            asRowType(vectors[0]->type())->names(),
+            std::make_shared<core::InsertTableHandle>(
+                kHiveConnectorId,
+                std::make_shared<HiveInsertTableHandle>(
+                    directory,
+                    std::vector<std::string>{"p"},
+                    std::vector<std::string>{"c0"},
+                    4)),
+            "rows")
+        .project({"rows"})
+        .planNode();
+  }
+
+  std::vector<RowVectorPtr> makePartitionedVectors() {
+    std::vector<RowVectorPtr> vectors;
+    for (auto i = 0; i < 3; ++i) {
+      vectors.push_back(makeRowVector(
+          {"p", "c0", "c1"},
+          {makeFlatVector<int32_t>(1'000, [](auto row) { return row % 3; }),
+           makeFlatVector<int64_t>(
+               1'000, [i](auto row) { return i * 1'000 + row; }),
+           makeFlatVector<StringView>(1'000, [](auto row) {
+             return StringView(fmt::format("s{}", row % 17));
+           })}));
+    }
+    return vectors;
+  }
+
   RowTypePtr rowType_{
       ROW({"c0", "c1", "c2", "c3", "c4", "c5"},
           {BIGINT(), INTEGER(), SMALLINT(), REAL(), DOUBLE(), VARCHAR()})};
@@ -237,3 +276,71 @@ TEST_F(TableWriteTest, writeEmptyFile) {
   execute(plan, queryCtx);
   ASSERT_TRUE(fs::exists(outputFile->path));
 }
+
+TEST_F(TableWriteTest, partitionedAndBucketed) {
+  auto vectors = makePartitionedVectors();
+  createDuckDbTable(vectors);
+  auto outputDirectory = TempDirectoryPath::create();
+  assertQuery(
+      partitionedWritePlan(vectors, outputDirectory->path), "SELECT 3000");
+
+  // Each file holds one partition and one bucket.
+  auto dataType = ROW({"c0", "c1"}, {BIGINT(), VARCHAR()});
+  std::vector<std::shared_ptr<connector::ConnectorSplit>> splits;
+  for (auto& entry : fs::recursive_directory_iterator(outputDirectory->path)) {
+    if (!fs::is_regular_file(entry.path())) {
+      continue;
+    }
+    auto partition = entry.path().parent_path().filename().string();
+    ASSERT_EQ("p=", partition.substr(0, 2));
+    auto bucket = std::stoi(entry.path().filename().string().substr(7));
+    auto split = HiveConnectorSplitBuilder(entry.path().string())
+                     .partitionKey("p", partition.substr(2))
+                     .tableBucketNumber(bucket)
+                     .build();
+    splits.push_back(split);
+
+    auto data = AssertQueryBuilder(
+                    PlanBuilder().tableScan(dataType).planNode())
+                    .split(split)
+                    .copyResults(pool_.get());
+    HivePartitionFunction bucketFunction(4, {0, 1, 2, 3}, {0});
+    std::vector<uint32_t> buckets;
+    bucketFunction.partition(*data, buckets);
+    for (auto row = 0; row < data->size(); ++row) {
+      ASSERT_EQ(bucket, buckets[row]);
+    }
+  }
+  ASSERT_EQ(12, splits.size());
+
+  ColumnHandleMap assignments = {
+      {"p", partitionKey("p", INTEGER())},
+      {"c0", regularColumn("c0", BIGINT())},
+      {"c1", regularColumn("c1", VARCHAR())}};
+  assertQuery(
+      PlanBuilder()
+          .tableScan(
+              asRowType(vectors[0]->type()), makeTableHandle(), assignments)
+          .planNode(),
+      splits,
+      "SELECT * FROM tmp");
+}
+
+TEST_F(TableWriteTest, maxOpenWriters) {
+  auto vectors = makePartitionedVectors();
+  auto outputDirectory = TempDirectoryPath::create();
+  auto queryCtx = std::make_shared<core::QueryCtx>(
+      std::make_shared<folly::CPUThreadPoolExecutor>(4),
+      std::make_shared<core::MemConfig>(),
+      std::unordered_map<std::string, std::shared_ptr<Config>>{
+          {kHiveConnectorId,
+           std::make_shared<core::MemConfig>(
+               std::unordered_map<std::string, std::string>{
+                   {HiveDataSink::kMaxOpenWriters, "5"}})}});
+  VELOX_ASSERT_THROW(
+      AssertQueryBuilder(
+          partitionedWritePlan(vectors, outputDirectory->path))
+          .queryCtx(queryCtx)
+          .copyResults(pool_.get()),
+      "Exceeded the limit of 5 open writers for partitions and buckets");
+}
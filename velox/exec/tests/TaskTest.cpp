@@ -133,6 +133,93 @@ TEST_F(TaskTest, wrongPlanNodeForSplit) {
       errorMessage)
 }
 
+TEST_F(TaskTest, cachedSplitsFirst) {
+  auto plan = PlanBuilder()
+                  .tableScan(ROW({"a", "b"}, {INTEGER(), DOUBLE()}))
+                  .planFragment();
+  exec::Task task(
+      "task-1", std::move(plan), 0, core::QueryCtx::createForTest());
+  auto makeSplit = [](const std::string& path, bool cached) {
+    return exec::Split(
+        std::make_shared<connector::hive::HiveConnectorSplit>(
+            "test",
+            path,
+            facebook::velox::dwio::common::FileFormat::DWRF),
+        -1,
+        cached);
+  };
+  task.addSplit("0", makeSplit("file:/tmp/cold1", false));
+  task.addSplit("0", makeSplit("file:/tmp/warm1", true));
+  task.addSplit("0", makeSplit("file:/tmp/cold2", false));
+  task.addSplit("0", makeSplit("file:/tmp/warm2", true));
+
+  std::vector<std::string> paths;
+  for (auto i = 0; i < 4; ++i) {
+    exec::Split split;
+    ContinueFuture future;
+    ASSERT_EQ(
+        BlockingReason::kNotBlocked,
+        task.getSplitOrFuture(0, "0", split, future));
+    paths.push_back(
+        std::dynamic_pointer_cast<connector::hive::HiveConnectorSplit>(
+            split.connectorSplit)
+            ->filePath);
+  }
+  EXPECT_EQ(
+      (std::vector<std::string>{
+          "file:/tmp/warm1",
+          "file:/tmp/warm2",
+          "file:/tmp/cold1",
+          "file:/tmp/cold2"}),
+      paths);
+}
+
+TEST_F(TaskTest, preloadArrivingSplits) {
+  auto plan = PlanBuilder()
+                  .tableScan(ROW({"a", "b"}, {INTEGER(), DOUBLE()}))
+                  .planFragment();
+  exec::Task task(
+      "task-1", std::move(plan), 0, core::QueryCtx::createForTest());
+  auto makeSplit = [](const std::string& path) {
+    return exec::Split(std::make_shared<connector::hive::HiveConnectorSplit>(
+        "test", path, facebook::velox::dwio::common::FileFormat::DWRF));
+  };
+  std::vector<std::string> preloaded;
+  auto preload = [&](std::shared_ptr<connector::ConnectorSplit> split) {
+    preloaded.push_back(
+        std::dynamic_pointer_cast<connector::hive::HiveConnectorSplit>(split)
+            ->filePath);
+    split->dataSource = std::make_shared<
+        AsyncSource<std::shared_ptr<connector::DataSource>>>(
+        []() { return nullptr; });
+  };
+  auto nextSplit = [&]() {
+    exec::Split split;
+    ContinueFuture future;
+    ASSERT_EQ(
+        BlockingReason::kNotBlocked,
+        task.getSplitOrFuture(0, "0", split, future, 2, preload));
+  };
+
+  task.addSplit("0", makeSplit("file:/tmp/1"));
+  nextSplit();
+  EXPECT_TRUE(preloaded.empty());
+
+  // The scan is busy with the first split. The next two splits are
+  // preloaded on arrival.
+  task.addSplit("0", makeSplit("file:/tmp/2"));
+  task.addSplit("0", makeSplit("file:/tmp/3"));
+  task.addSplit("0", makeSplit("file:/tmp/4"));
+  EXPECT_EQ(
+      (std::vector<std::string>{"file:/tmp/2", "file:/tmp/3"}), preloaded);
+
+  // Taking a split tops up the preloaded splits.
+  nextSplit();
+  EXPECT_EQ(
+      (std::vector<std::string>{"file:/tmp/2", "file:/tmp/3", "file:/tmp/4"}),
+      preloaded);
+}
+
 TEST_F(TaskTest, duplicatePlanNodeIds) {
   auto plan = PlanBuilder()
                   .tableScan(ROW({"a", "b"}, {INTEGER(), DOUBLE()}))
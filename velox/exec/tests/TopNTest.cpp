@@ -13,13 +13,14 @@
  * See the License for the specific language governing permissions and
  * limitations under the License.
  */
-#include "velox/exec/tests/utils/OperatorTestBase.h"
+#include "velox/exec/tests/utils/AssertQueryBuilder.h"
+#include "velox/exec/tests/utils/HiveConnectorTestBase.h"
 #include "velox/exec/tests/utils/PlanBuilder.h"
 
 using namespace facebook::velox;
 using namespace facebook::velox::exec::test;
 
-class TopNTest : public OperatorTestBase {
+class TopNTest : public HiveConnectorTestBase {
  protected:
   static std::vector<std::string> getSortOrderSqls() {
     return {"NULLS LAST", "NULLS FIRST", "DESC NULLS FIRST", "DESC NULLS LAST"};
@@ -245,3 +246,105 @@ TEST_F(TopNTest, empty) {
 
   testSingleKey(vectors, "c0", "c0 < 0");
 }
+
+TEST_F(TopNTest, thresholdPushdown) {
+  const int32_t numSplits = 10;
+  const int32_t numRows = 1'000;
+  auto files = makeFilePaths(numSplits);
+  std::vector<RowVectorPtr> vectors;
+  for (auto i = 0; i < numSplits; ++i) {
+    // Each split has smaller values of c0 than the earlier splits.
+    vectors.push_back(makeRowVector({
+        makeFlatVector<int64_t>(
+            numRows,
+            [&](auto row) { return (numSplits - i) * numRows + row; },
+            nullEvery(17)),
+        makeFlatVector<double>(
+            numRows,
+            [&](auto row) { return i * numRows + row; },
+            nullEvery(19)),
+    }));
+    writeToFile(files[i]->path, vectors.back());
+  }
+  createDuckDbTable(vectors);
+
+  auto rowType = ROW({"c0", "c1"}, {BIGINT(), DOUBLE()});
+  auto testThreshold = [&](const std::string& orderBy, bool filtersRows) {
+    SCOPED_TRACE(orderBy);
+    auto plan = PlanBuilder()
+                    .tableScan(rowType)
+                    .topN({orderBy}, 10, false)
+                    .planNode();
+    auto task =
+        AssertQueryBuilder(plan, duckDbQueryRunner_)
+            .splits(makeHiveConnectorSplits(files))
+            .assertResults(fmt::format(
+                "SELECT * FROM tmp ORDER BY {} LIMIT 10", orderBy));
+    auto& stats = task->taskStats().pipelineStats.front().operatorStats;
+    if (filtersRows) {
+      EXPECT_LT(stats[1].inputPositions, numSplits * numRows);
+      EXPECT_GT(stats[0].runtimeStats["dynamicFiltersAccepted"].sum, 0);
+    } else {
+      EXPECT_EQ(stats[1].inputPositions, numSplits * numRows);
+    }
+  };
+
+  testThreshold("c0 DESC NULLS LAST", true);
+  testThreshold("c1 NULLS LAST", true);
+  // The top rows are all nulls, which leaves nothing to filter on.
+  testThreshold("c0 DESC NULLS FIRST", false);
+  // No filter for a descending floating point key.
+  testThreshold("c1 DESC NULLS LAST", false);
+}
+
+TEST_F(TopNTest, sharedThreshold) {
+  const int32_t numBatches = 10;
+  const int32_t numRows = 1'000;
+  std::vector<RowVectorPtr> vectors;
+  for (auto i = 0; i < numBatches; ++i) {
+    // Each batch has smaller values of c0 than the earlier batches. The
+    // string key is not pushed down, so the rows reach the TopN.
+    vectors.push_back(makeRowVector({
+        makeFlatVector<StringView>(
+            numRows,
+            [&](auto row) {
+              return StringView(fmt::format(
+                  "{:06d}", (numBatches - i) * numRows + row));
+            }),
+        makeFlatVector<int64_t>(numRows, [&](auto row) { return row; }),
+    }));
+  }
+  createDuckDbTable(vectors);
+
+  // Each of the Drivers reads all the batches. The TopN operators share
+  // the worst key of the best of them and drop the rows after it.
+  const int32_t numDrivers = 4;
+  auto planNodeIdGenerator = std::make_shared<PlanNodeIdGenerator>();
+  auto plan = PlanBuilder(planNodeIdGenerator)
+                  .localMerge(
+                      {"c0 DESC"},
+                      {PlanBuilder(planNodeIdGenerator)
+                           .values(vectors, true)
+                           .topN({"c0 DESC"}, 10, true)
+                           .planNode()})
+                  .limit(0, 10, false)
+                  .planNode();
+  auto task = AssertQueryBuilder(plan, duckDbQueryRunner_)
+                  .maxDrivers(numDrivers)
+                  .assertResults(
+                      "SELECT * FROM (SELECT * FROM tmp UNION ALL "
+                      "SELECT * FROM tmp UNION ALL SELECT * FROM tmp UNION ALL "
+                      "SELECT * FROM tmp) ORDER BY c0 DESC LIMIT 10");
+
+  auto taskStats = task->taskStats();
+  int64_t numDropped = 0;
+  for (auto& pipeline : taskStats.pipelineStats) {
+    for (auto& op : pipeline.operatorStats) {
+      if (op.operatorType == "TopN") {
+        numDropped += op.runtimeStats["sharedThresholdDroppedRows"].sum;
+      }
+    }
+  }
+  // Each Driver drops at least the batches after the first one.
+  EXPECT_GE(numDropped, numDrivers * (numBatches - 1) * numRows);
+}
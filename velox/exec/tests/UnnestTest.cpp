@@ -403,3 +403,69 @@ TEST_F(UnnestTest, allEmptyOrNullMaps) {
            .planNode();
   assertQueryReturnsEmptyResult(op);
 }
+
+TEST_F(UnnestTest, zeroCopyOutput) {
+  // Arrays and maps whose elements follow each other, with some empty ones.
+  auto vector = makeRowVector({
+      makeFlatVector<int64_t>(100, [](auto row) { return row; }),
+      makeArrayVector<int32_t>(
+          100,
+          [](auto row) { return row % 4; },
+          [](auto row, auto index) { return row + index; }),
+      makeMapVector<int64_t, double>(
+          100,
+          [](auto row) { return row % 4; },
+          [](auto row) { return row; },
+          [](auto row) { return row * 0.1; }),
+  });
+
+  auto assertEncodings = [&](const core::PlanNodePtr& plan,
+                             const std::vector<VectorEncoding::Simple>&
+                                 expectedEncodings) {
+    CursorParameters params;
+    params.planNode = plan;
+    auto result = readCursor(params, [](auto /*task*/) {});
+    ASSERT_EQ(1, result.second.size());
+    const auto& output = result.second[0];
+    ASSERT_EQ(expectedEncodings.size(), output->childrenSize());
+    for (auto i = 0; i < expectedEncodings.size(); ++i) {
+      EXPECT_EQ(expectedEncodings[i], output->childAt(i)->encoding());
+    }
+  };
+
+  // The elements, keys and values vectors are returned as is. Only the
+  // replicated column is wrapped in a dictionary.
+  auto plan = PlanBuilder().values({vector}).unnest({"c0"}, {"c1"}).planNode();
+  assertEncodings(
+      plan,
+      {VectorEncoding::Simple::DICTIONARY, VectorEncoding::Simple::FLAT});
+  plan = PlanBuilder().values({vector}).unnest({"c0"}, {"c2"}).planNode();
+  assertEncodings(
+      plan,
+      {VectorEncoding::Simple::DICTIONARY,
+       VectorEncoding::Simple::FLAT,
+       VectorEncoding::Simple::FLAT});
+
+  plan = PlanBuilder().values({vector}).unnest({"c0"}, {"c1", "c2"}).planNode();
+  assertEncodings(
+      plan,
+      {VectorEncoding::Simple::DICTIONARY,
+       VectorEncoding::Simple::FLAT,
+       VectorEncoding::Simple::FLAT,
+       VectorEncoding::Simple::FLAT});
+
+  std::vector<int64_t> expectedC0;
+  std::vector<int32_t> expectedC1;
+  for (auto row = 0; row < 100; ++row) {
+    for (auto index = 0; index < row % 4; ++index) {
+      expectedC0.push_back(row);
+      expectedC1.push_back(row + index);
+    }
+  }
+  plan = PlanBuilder().values({vector}).unnest({"c0"}, {"c1"}).planNode();
+  assertQuery(
+      plan,
+      makeRowVector(
+          {makeFlatVector<int64_t>(expectedC0),
+           makeFlatVector<int32_t>(expectedC1)}));
+}
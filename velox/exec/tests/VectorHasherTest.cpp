@@ -478,6 +478,42 @@ TEST_F(VectorHasherTest, dateIds) {
   EXPECT_EQ(numDistinct, VectorHasher::kRangeTooLarge);
 }
 
+TEST_F(VectorHasherTest, timestampIds) {
+  auto vector = BaseVector::create(TIMESTAMP(), 100, pool_.get());
+  auto* timestamps = vector->as<FlatVector<Timestamp>>();
+  timestamps->setNull(0, true);
+  for (auto i = 0; i < 99; ++i) {
+    // Values one second and one microsecond apart.
+    timestamps->set(i + 1, Timestamp(1'600'000'000 + i, i * 1'000));
+  }
+  auto hasher = exec::VectorHasher::create(TIMESTAMP(), 1);
+  raw_vector<uint64_t> hashes(timestamps->size());
+  SelectivityVector rows(timestamps->size());
+  EXPECT_FALSE(hasher->computeValueIds(*vector, rows, hashes));
+  hasher->enableValueIds(1, 0);
+  EXPECT_TRUE(hasher->computeValueIds(*vector, rows, hashes));
+  // Hash of null is always 0.
+  EXPECT_EQ(hashes[0], 0);
+  std::unordered_set<uint64_t> ids;
+  for (auto i = 1; i < 100; ++i) {
+    EXPECT_NE(hashes[i], 0);
+    ids.insert(hashes[i]);
+  }
+  EXPECT_EQ(ids.size(), 99);
+
+  uint64_t numRange;
+  uint64_t numDistinct;
+  hasher->cardinality(0, numRange, numDistinct);
+  EXPECT_EQ(numDistinct, 100);
+
+  // A timestamp with sub-microsecond nanos has no value ID.
+  timestamps->set(10, Timestamp(1'600'000'000, 1));
+  EXPECT_FALSE(hasher->computeValueIds(*vector, rows, hashes));
+  hasher->cardinality(0, numRange, numDistinct);
+  EXPECT_EQ(numRange, VectorHasher::kRangeTooLarge);
+  EXPECT_EQ(numDistinct, VectorHasher::kRangeTooLarge);
+}
+
 TEST_F(VectorHasherTest, boolNoNulls) {
   auto vector = BaseVector::create(BOOLEAN(), 100, pool_.get());
   auto bools = vector->as<FlatVector<bool>>();
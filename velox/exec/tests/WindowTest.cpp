@@ -0,0 +1,355 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "velox/exec/tests/utils/AssertQueryBuilder.h"
+#include "velox/exec/tests/utils/OperatorTestBase.h"
+#include "velox/exec/tests/utils/PlanBuilder.h"
+
+using namespace facebook::velox;
+using namespace facebook::velox::exec::test;
+
+namespace {
+using BoundType = core::WindowNode::BoundType;
+using WindowType = core::WindowNode::WindowType;
+} // namespace
+
+class WindowTest : public OperatorTestBase {
+ protected:
+  std::vector<RowVectorPtr> makeData(
+      vector_size_t numBatches,
+      vector_size_t batchSize) {
+    std::vector<RowVectorPtr> data;
+    for (auto i = 0; i < numBatches; ++i) {
+      auto offset = i * batchSize;
+      data.push_back(makeRowVector({
+          makeFlatVector<int32_t>(
+              batchSize,
+              [](auto row) { return row % 17; },
+              nullEvery(31)),
+          makeFlatVector<int32_t>(batchSize, [](auto row) { return row % 7; }),
+          makeFlatVector<int64_t>(
+              batchSize, [offset](auto row) { return offset + row; }),
+      }));
+    }
+    return data;
+  }
+
+  static core::WindowNode::Frame frame(
+      WindowType type,
+      BoundType startType,
+      BoundType endType,
+      std::optional<int64_t> startValue = std::nullopt,
+      std::optional<int64_t> endValue = std::nullopt) {
+    return {
+        type,
+        startType,
+        startValue.has_value()
+            ? std::make_shared<core::ConstantTypedExpr>(startValue.value())
+            : nullptr,
+        endType,
+        endValue.has_value()
+            ? std::make_shared<core::ConstantTypedExpr>(endValue.value())
+            : nullptr};
+  }
+
+  static core::WindowNode::Frame defaultFrame() {
+    return frame(
+        WindowType::kRange,
+        BoundType::kUnboundedPreceding,
+        BoundType::kCurrentRow);
+  }
+
+  core::WindowNode::Function function(
+      const std::string& name,
+      const std::vector<std::string>& args,
+      const TypePtr& resultType,
+      const core::WindowNode::Frame& frame) {
+    std::vector<core::TypedExprPtr> inputs;
+    for (const auto& arg : args) {
+      inputs.push_back(std::make_shared<core::FieldAccessTypedExpr>(
+          rowType_->findChild(arg), arg));
+    }
+    return {
+        std::make_shared<core::CallTypedExpr>(resultType, inputs, name),
+        frame,
+        false};
+  }
+
+  std::vector<core::FieldAccessTypedExprPtr> fields(
+      const std::vector<std::string>& names) {
+    std::vector<core::FieldAccessTypedExprPtr> result;
+    for (const auto& name : names) {
+      result.push_back(std::make_shared<core::FieldAccessTypedExpr>(
+          rowType_->findChild(name), name));
+    }
+    return result;
+  }
+
+  core::PlanNodePtr makePlan(
+      const std::vector<RowVectorPtr>& input,
+      const std::vector<std::string>& partitionKeys,
+      const std::vector<std::string>& sortingKeys,
+      std::vector<core::WindowNode::Function> functions) {
+    std::vector<core::SortOrder> sortingOrders(
+        sortingKeys.size(), core::kAscNullsLast);
+    std::vector<std::string> names;
+    for (auto i = 0; i < functions.size(); ++i) {
+      names.push_back(fmt::format("w{}", i));
+    }
+    return PlanBuilder()
+        .values(input)
+        .addNode([&](std::string id, core::PlanNodePtr source) {
+          return std::make_shared<core::WindowNode>(
+              id,
+              fields(partitionKeys),
+              fields(sortingKeys),
+              sortingOrders,
+              names,
+              std::move(functions),
+              source);
+        })
+        .planNode();
+  }
+
+  void assertWindow(
+      const core::PlanNodePtr& plan,
+      const std::string& duckDbSql,
+      int32_t outputBatchSize = 1'024) {
+    AssertQueryBuilder(plan, duckDbQueryRunner_)
+        .config(
+            core::QueryConfig::kPreferredOutputBatchSize,
+            std::to_string(outputBatchSize))
+        .assertResults(duckDbSql);
+  }
+
+  const RowTypePtr rowType_{
+      ROW({"c0", "c1", "c2"}, {INTEGER(), INTEGER(), BIGINT()})};
+};
+
+TEST_F(WindowTest, ranking) {
+  auto data = makeData(3, 500);
+  createDuckDbTable(data);
+
+  auto plan = makePlan(
+      data,
+      {"c0"},
+      {"c1"},
+      {function("rank", {}, BIGINT(), defaultFrame()),
+       function("dense_rank", {}, BIGINT(), defaultFrame())});
+
+  assertWindow(
+      plan,
+      "SELECT *, rank() over (partition by c0 order by c1), "
+      "dense_rank() over (partition by c0 order by c1) FROM tmp");
+
+  plan = makePlan(
+      data,
+      {"c0"},
+      {"c2"},
+      {function("row_number", {}, BIGINT(), defaultFrame())});
+  assertWindow(
+      plan,
+      "SELECT *, row_number() over (partition by c0 order by c2) FROM tmp",
+      7);
+}
+
+TEST_F(WindowTest, runningAggregates) {
+  auto data = makeData(3, 500);
+  createDuckDbTable(data);
+
+  auto rowsFrame = frame(
+      WindowType::kRows,
+      BoundType::kUnboundedPreceding,
+      BoundType::kCurrentRow);
+  auto plan = makePlan(
+      data,
+      {"c0"},
+      {"c2"},
+      {function("sum", {"c2"}, BIGINT(), rowsFrame),
+       function("count", {"c1"}, BIGINT(), rowsFrame),
+       function("max", {"c1"}, INTEGER(), rowsFrame)});
+
+  auto sql =
+      "SELECT *, "
+      "sum(c2) over (partition by c0 order by c2 rows between unbounded preceding and current row), "
+      "count(c1) over (partition by c0 order by c2 rows between unbounded preceding and current row), "
+      "max(c1) over (partition by c0 order by c2 rows between unbounded preceding and current row) "
+      "FROM tmp";
+  assertWindow(plan, sql);
+  // Partitions span multiple output batches.
+  assertWindow(plan, sql, 10);
+
+  // RANGE frame ending at the current row includes all peers.
+  plan = makePlan(
+      data,
+      {"c0"},
+      {"c1"},
+      {function("sum", {"c2"}, BIGINT(), defaultFrame())});
+  assertWindow(
+      plan,
+      "SELECT *, sum(c2) over (partition by c0 order by c1) FROM tmp",
+      10);
+
+  // Whole partition.
+  plan = makePlan(
+      data,
+      {"c0"},
+      {},
+      {function(
+          "sum",
+          {"c2"},
+          BIGINT(),
+          frame(
+              WindowType::kRows,
+              BoundType::kUnboundedPreceding,
+              BoundType::kUnboundedFollowing))});
+  assertWindow(plan, "SELECT *, sum(c2) over (partition by c0) FROM tmp", 10);
+}
+
+TEST_F(WindowTest, slidingFrames) {
+  auto data = makeData(2, 300);
+  createDuckDbTable(data);
+
+  auto plan = makePlan(
+      data,
+      {"c0"},
+      {"c2"},
+      {function(
+           "sum",
+           {"c2"},
+           BIGINT(),
+           frame(
+               WindowType::kRows,
+               BoundType::kPreceding,
+               BoundType::kFollowing,
+               2,
+               1)),
+       function(
+           "min",
+           {"c2"},
+           BIGINT(),
+           frame(
+               WindowType::kRows,
+               BoundType::kCurrentRow,
+               BoundType::kUnboundedFollowing)),
+       function(
+           "count",
+           {"c2"},
+           BIGINT(),
+           frame(
+               WindowType::kRows,
+               BoundType::kFollowing,
+               BoundType::kFollowing,
+               3,
+               5))});
+
+  assertWindow(
+      plan,
+      "SELECT *, "
+      "sum(c2) over (partition by c0 order by c2 rows between 2 preceding and 1 following), "
+      "min(c2) over (partition by c0 order by c2 rows between current row and unbounded following), "
+      "count(c2) over (partition by c0 order by c2 rows between 3 following and 5 following) "
+      "FROM tmp",
+      13);
+}
+
+TEST_F(WindowTest, wideSlidingFrames) {
+  // The frames span many rows, so that they are computed from the segment
+  // tree of accumulators.
+  auto data = makeData(3, 1'000);
+  createDuckDbTable(data);
+
+  auto plan = makePlan(
+      data,
+      {"c1"},
+      {"c2"},
+      {function(
+           "sum",
+           {"c0"},
+           BIGINT(),
+           frame(
+               WindowType::kRows,
+               BoundType::kPreceding,
+               BoundType::kFollowing,
+               100,
+               50)),
+       function(
+           "avg",
+           {"c2"},
+           DOUBLE(),
+           frame(
+               WindowType::kRows,
+               BoundType::kFollowing,
+               BoundType::kUnboundedFollowing,
+               10)),
+       function(
+           "max",
+           {"c0"},
+           INTEGER(),
+           frame(
+               WindowType::kRows,
+               BoundType::kPreceding,
+               BoundType::kPreceding,
+               70,
+               3))});
+
+  assertWindow(
+      plan,
+      "SELECT *, "
+      "sum(c0) over (partition by c1 order by c2 rows between 100 preceding and 50 following), "
+      "avg(c2) over (partition by c1 order by c2 rows between 10 following and unbounded following), "
+      "max(c0) over (partition by c1 order by c2 rows between 70 preceding and 3 preceding) "
+      "FROM tmp",
+      97);
+}
+
+TEST_F(WindowTest, noPartitionKeys) {
+  auto data = makeData(2, 200);
+  createDuckDbTable(data);
+
+  auto plan = makePlan(
+      data,
+      {},
+      {"c2"},
+      {function("row_number", {}, BIGINT(), defaultFrame()),
+       function("sum", {"c1"}, BIGINT(), defaultFrame())});
+
+  assertWindow(
+      plan,
+      "SELECT *, row_number() over (order by c2), sum(c1) over (order by c2) FROM tmp");
+}
+
+TEST_F(WindowTest, emptyInput) {
+  auto data = makeData(1, 100);
+  createDuckDbTable(data);
+
+  auto plan = PlanBuilder()
+                  .values(data)
+                  .filter("c2 < 0")
+                  .addNode([&](std::string id, core::PlanNodePtr source) {
+                    return std::make_shared<core::WindowNode>(
+                        id,
+                        fields({"c0"}),
+                        fields({}),
+                        std::vector<core::SortOrder>{},
+                        std::vector<std::string>{"w0"},
+                        std::vector<core::WindowNode::Function>{function(
+                            "rank", {}, BIGINT(), defaultFrame())},
+                        source);
+                  })
+                  .planNode();
+
+  assertQuery(plan, "SELECT *, 1::BIGINT FROM tmp WHERE 1 = 0");
+}
@@ -166,6 +166,15 @@ PlanBuilder& PlanBuilder::values(
   return *this;
 }
 
+PlanBuilder& PlanBuilder::arrowStream(
+    const RowTypePtr& outputType,
+    std::shared_ptr<ArrowArrayStream> arrowStream) {
+  VELOX_CHECK_NULL(planNode_, "arrowStream() must be the first call");
+  planNode_ = std::make_shared<core::ArrowStreamNode>(
+      nextPlanNodeId(), outputType, std::move(arrowStream));
+  return *this;
+}
+
 PlanBuilder& PlanBuilder::exchange(const RowTypePtr& outputType) {
   VELOX_CHECK_NULL(planNode_, "exchange() must be the first call");
   planNode_ =
@@ -451,6 +460,7 @@ core::PlanNodePtr PlanBuilder::createIntermediateOrFinalAggregation(
       partialAggNode->aggregateNames(),
       aggregates,
       masks,
+      std::vector<bool>{},
       partialAggNode->ignoreNullKeys(),
       planNode_);
 }
@@ -566,7 +576,8 @@ PlanBuilder& PlanBuilder::aggregation(
     const std::vector<std::string>& masks,
     core::AggregationNode::Step step,
     bool ignoreNullKeys,
-    const std::vector<TypePtr>& resultTypes) {
+    const std::vector<TypePtr>& resultTypes,
+    const std::vector<bool>& distincts) {
   auto numAggregates = aggregates.size();
   auto aggregatesAndNames =
       createAggregateExpressionsAndNames(aggregates, step, resultTypes);
@@ -578,6 +589,7 @@ PlanBuilder& PlanBuilder::aggregation(
       aggregatesAndNames.names,
       aggregatesAndNames.aggregates,
       createAggregateMasks(numAggregates, masks),
+      distincts,
       ignoreNullKeys,
       planNode_);
   return *this;
@@ -601,6 +613,7 @@ PlanBuilder& PlanBuilder::streamingAggregation(
       aggregatesAndNames.names,
       aggregatesAndNames.aggregates,
       createAggregateMasks(numAggregates, masks),
+      std::vector<bool>{},
       ignoreNullKeys,
       planNode_);
   return *this;
@@ -903,7 +916,8 @@ PlanBuilder& PlanBuilder::hashJoin(
     const core::PlanNodePtr& build,
     const std::string& filter,
     const std::vector<std::string>& outputLayout,
-    core::JoinType joinType) {
+    core::JoinType joinType,
+    std::optional<std::string> buildCacheId) {
   VELOX_CHECK_EQ(leftKeys.size(), rightKeys.size());
 
   auto leftType = planNode_->outputType();
@@ -925,7 +939,8 @@ PlanBuilder& PlanBuilder::hashJoin(
       std::move(filterExpr),
       std::move(planNode_),
       build,
-      outputType);
+      outputType,
+      std::move(buildCacheId));
   return *this;
 }
 
@@ -963,12 +978,22 @@ PlanBuilder& PlanBuilder::mergeJoin(
 
 PlanBuilder& PlanBuilder::crossJoin(
     const core::PlanNodePtr& right,
-    const std::vector<std::string>& outputLayout) {
+    const std::vector<std::string>& outputLayout,
+    const std::string& filter) {
   auto resultType = concat(planNode_->outputType(), right->outputType());
   auto outputType = extract(resultType, outputLayout);
 
+  core::TypedExprPtr filterExpr;
+  if (!filter.empty()) {
+    filterExpr = parseExpr(filter, resultType, pool_);
+  }
+
   planNode_ = std::make_shared<core::CrossJoinNode>(
-      nextPlanNodeId(), std::move(planNode_), right, outputType);
+      nextPlanNodeId(),
+      std::move(planNode_),
+      right,
+      outputType,
+      std::move(filterExpr));
   return *this;
 }
 
@@ -182,6 +182,15 @@ class PlanBuilder {
       const std::vector<RowVectorPtr>& values,
       bool parallelizable = false);
 
+  /// Add an ArrowStreamNode that reads the batches of 'arrowStream'.
+  ///
+  /// @param outputType The type of the batches of the stream.
+  /// @param arrowStream The stream to read. It is released by the first
+  /// execution of the plan.
+  PlanBuilder& arrowStream(
+      const RowTypePtr& outputType,
+      std::shared_ptr<ArrowArrayStream> arrowStream);
+
   /// Add an ExchangeNode.
   ///
   /// Use capturePlanNodeId method to capture the node ID needed for adding
@@ -341,17 +350,24 @@ class PlanBuilder {
   /// Add a single aggregation plan node using specified grouping keys and
   /// aggregate expressions. See 'partialAggregation' method for the supported
   /// types of aggregate expressions.
+  ///
+  /// @param distincts An optional list of flags, one per aggregate. An
+  /// aggregate with the flag set only accumulates the distinct values of its
+  /// arguments in each group, e.g. count(c) becomes count(DISTINCT c).
   PlanBuilder& singleAggregation(
       const std::vector<std::string>& groupingKeys,
       const std::vector<std::string>& aggregates,
-      const std::vector<std::string>& masks = {}) {
+      const std::vector<std::string>& masks = {},
+      const std::vector<bool>& distincts = {}) {
     return aggregation(
         groupingKeys,
         {},
         aggregates,
         masks,
         core::AggregationNode::Step::kSingle,
-        false);
+        false,
+        {},
+        distincts);
   }
 
   /// Add an AggregationNode using specified grouping keys,
@@ -391,6 +407,10 @@ class PlanBuilder {
   /// memory and CPU then hash aggregation. The caller is responsible
   /// that input data is indeed clustered on the specified keys. If that's not
   /// the case, the query may return incorrect results.
+  ///
+  /// 'distincts' is an optional list of flags, one per aggregate, that marks
+  /// the aggregates that only see the distinct values of their arguments in
+  /// each group. Only supported for single aggregations.
   PlanBuilder& aggregation(
       const std::vector<std::string>& groupingKeys,
       const std::vector<std::string>& preGroupedKeys,
@@ -398,7 +418,8 @@ class PlanBuilder {
       const std::vector<std::string>& masks,
       core::AggregationNode::Step step,
       bool ignoreNullKeys,
-      const std::vector<TypePtr>& resultTypes = {});
+      const std::vector<TypePtr>& resultTypes = {},
+      const std::vector<bool>& distincts = {});
 
   /// A convenience method to create partial aggregation plan node for the case
   /// where input is clustered on all grouping keys.
@@ -592,13 +613,17 @@ class PlanBuilder {
   /// @param outputLayout Output layout consisting of columns from probe and
   /// build sides.
   /// @param joinType Type of the join: inner, left, right, full, semi, or anti.
+  /// @param buildCacheId Optional identity of the build side input. Tasks with
+  /// the same build side and id share one hash table. See
+  /// core::HashJoinNode.
   PlanBuilder& hashJoin(
       const std::vector<std::string>& leftKeys,
       const std::vector<std::string>& rightKeys,
       const core::PlanNodePtr& build,
       const std::string& filter,
       const std::vector<std::string>& outputLayout,
-      core::JoinType joinType = core::JoinType::kInner);
+      core::JoinType joinType = core::JoinType::kInner,
+      std::optional<std::string> buildCacheId = std::nullopt);
 
   /// Add a MergeJoinNode to join two inputs using one or more join keys and an
   /// optional filter. The caller is responsible to ensure that inputs are
@@ -622,9 +647,12 @@ class PlanBuilder {
   /// smaller input is placed on the right-side.
   /// @param outputLayout Output layout consisting of columns from left and
   /// right sides.
+  /// @param filter SQL expression over the columns of both sides. Only the
+  /// pairs of rows that pass it are produced. Empty for no filter.
   PlanBuilder& crossJoin(
       const core::PlanNodePtr& right,
-      const std::vector<std::string>& outputLayout);
+      const std::vector<std::string>& outputLayout,
+      const std::string& filter = "");
 
   /// Add an UnnestNode to unnest one or more columns of type array or map.
   ///
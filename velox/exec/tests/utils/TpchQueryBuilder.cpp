@@ -54,6 +54,16 @@ std::string formatDateFilter(
   VELOX_FAIL(
       "Date range check expression must have either a lower or an upper bound");
 }
+
+/// Return the expression for the year of a date column as per data format.
+std::string formatYear(
+    const std::string& stringDate,
+    const RowTypePtr& rowType) {
+  if (rowType->findChild(stringDate)->isVarchar()) {
+    return fmt::format("cast(substr({}, 1, 4) AS BIGINT)", stringDate);
+  }
+  return fmt::format("year({})", stringDate);
+}
 } // namespace
 
 void TpchQueryBuilder::initialize(const std::string& dataPath) {
@@ -109,24 +119,48 @@ TpchPlan TpchQueryBuilder::getQueryPlan(int queryId) const {
   switch (queryId) {
     case 1:
       return getQ1Plan();
+    case 2:
+      return getQ2Plan();
     case 3:
       return getQ3Plan();
+    case 4:
+      return getQ4Plan();
     case 5:
       return getQ5Plan();
     case 6:
       return getQ6Plan();
+    case 7:
+      return getQ7Plan();
+    case 8:
+      return getQ8Plan();
+    case 9:
+      return getQ9Plan();
     case 10:
       return getQ10Plan();
+    case 11:
+      return getQ11Plan();
     case 12:
       return getQ12Plan();
     case 13:
       return getQ13Plan();
     case 14:
       return getQ14Plan();
+    case 15:
+      return getQ15Plan();
+    case 16:
+      return getQ16Plan();
+    case 17:
+      return getQ17Plan();
     case 18:
       return getQ18Plan();
     case 19:
       return getQ19Plan();
+    case 20:
+      return getQ20Plan();
+    case 21:
+      return getQ21Plan();
+    case 22:
+      return getQ22Plan();
     default:
       VELOX_NYI("TPC-H query {} is not supported yet", queryId);
   }
@@ -185,6 +219,201 @@ TpchPlan TpchQueryBuilder::getQ1Plan() const {
   return context;
 }
 
+TpchPlan TpchQueryBuilder::getQ2Plan() const {
+  std::vector<std::string> partColumns = {
+      "p_partkey", "p_mfgr", "p_size", "p_type"};
+  std::vector<std::string> supplierColumns = {
+      "s_suppkey",
+      "s_name",
+      "s_address",
+      "s_nationkey",
+      "s_phone",
+      "s_acctbal",
+      "s_comment"};
+  std::vector<std::string> minSupplierColumns = {"s_suppkey", "s_nationkey"};
+  std::vector<std::string> partsuppColumns = {
+      "ps_partkey", "ps_suppkey", "ps_supplycost"};
+  std::vector<std::string> nationColumns = {
+      "n_nationkey", "n_name", "n_regionkey"};
+  std::vector<std::string> regionColumns = {"r_regionkey", "r_name"};
+
+  auto partSelectedRowType = getRowType(kPart, partColumns);
+  const auto& partFileColumns = getFileColumnNames(kPart);
+  auto supplierSelectedRowType = getRowType(kSupplier, supplierColumns);
+  auto minSupplierSelectedRowType = getRowType(kSupplier, minSupplierColumns);
+  const auto& supplierFileColumns = getFileColumnNames(kSupplier);
+  auto partsuppSelectedRowType = getRowType(kPartsupp, partsuppColumns);
+  const auto& partsuppFileColumns = getFileColumnNames(kPartsupp);
+  auto nationSelectedRowType = getRowType(kNation, nationColumns);
+  const auto& nationFileColumns = getFileColumnNames(kNation);
+  auto regionSelectedRowType = getRowType(kRegion, regionColumns);
+  const auto& regionFileColumns = getFileColumnNames(kRegion);
+
+  const std::string regionNameFilter = "r_name = 'EUROPE'";
+
+  auto planNodeIdGenerator = std::make_shared<PlanNodeIdGenerator>();
+  core::PlanNodeId partScanNodeId;
+  core::PlanNodeId supplierScanNodeId;
+  core::PlanNodeId partsuppScanNodeId;
+  core::PlanNodeId nationScanNodeId;
+  core::PlanNodeId regionScanNodeId;
+  core::PlanNodeId minSupplierScanNodeId;
+  core::PlanNodeId minPartsuppScanNodeId;
+  core::PlanNodeId minNationScanNodeId;
+  core::PlanNodeId minRegionScanNodeId;
+
+  // The correlated subquery becomes the minimum supply cost per part over
+  // the European suppliers, joined on the part key.
+  auto minRegion = PlanBuilder(planNodeIdGenerator)
+                       .tableScan(
+                           kRegion,
+                           regionSelectedRowType,
+                           regionFileColumns,
+                           {regionNameFilter})
+                       .capturePlanNodeId(minRegionScanNodeId)
+                       .planNode();
+
+  auto minNation =
+      PlanBuilder(planNodeIdGenerator)
+          .tableScan(kNation, nationSelectedRowType, nationFileColumns)
+          .capturePlanNodeId(minNationScanNodeId)
+          .hashJoin(
+              {"n_regionkey"}, {"r_regionkey"}, minRegion, "", {"n_nationkey"})
+          .planNode();
+
+  auto minSupplier =
+      PlanBuilder(planNodeIdGenerator)
+          .tableScan(
+              kSupplier, minSupplierSelectedRowType, supplierFileColumns)
+          .capturePlanNodeId(minSupplierScanNodeId)
+          .hashJoin(
+              {"s_nationkey"}, {"n_nationkey"}, minNation, "", {"s_suppkey"})
+          .planNode();
+
+  auto minCost =
+      PlanBuilder(planNodeIdGenerator)
+          .tableScan(kPartsupp, partsuppSelectedRowType, partsuppFileColumns)
+          .capturePlanNodeId(minPartsuppScanNodeId)
+          .hashJoin(
+              {"ps_suppkey"},
+              {"s_suppkey"},
+              minSupplier,
+              "",
+              {"ps_partkey", "ps_supplycost"})
+          .partialAggregation(
+              {"ps_partkey"}, {"min(ps_supplycost) AS min_supplycost"})
+          .localPartition({"ps_partkey"})
+          .finalAggregation()
+          .project({"ps_partkey AS min_partkey", "min_supplycost"})
+          .planNode();
+
+  auto region = PlanBuilder(planNodeIdGenerator)
+                    .tableScan(
+                        kRegion,
+                        regionSelectedRowType,
+                        regionFileColumns,
+                        {regionNameFilter})
+                    .capturePlanNodeId(regionScanNodeId)
+                    .planNode();
+
+  auto nationJoinRegion =
+      PlanBuilder(planNodeIdGenerator)
+          .tableScan(kNation, nationSelectedRowType, nationFileColumns)
+          .capturePlanNodeId(nationScanNodeId)
+          .hashJoin(
+              {"n_regionkey"},
+              {"r_regionkey"},
+              region,
+              "",
+              {"n_nationkey", "n_name"})
+          .planNode();
+
+  auto supplierJoinNation =
+      PlanBuilder(planNodeIdGenerator)
+          .tableScan(kSupplier, supplierSelectedRowType, supplierFileColumns)
+          .capturePlanNodeId(supplierScanNodeId)
+          .hashJoin(
+              {"s_nationkey"},
+              {"n_nationkey"},
+              nationJoinRegion,
+              "",
+              {"s_suppkey",
+               "s_name",
+               "s_address",
+               "s_phone",
+               "s_acctbal",
+               "s_comment",
+               "n_name"})
+          .planNode();
+
+  auto part = PlanBuilder(planNodeIdGenerator, pool_.get())
+                  .tableScan(
+                      kPart,
+                      partSelectedRowType,
+                      partFileColumns,
+                      {"p_size = 15"},
+                      "p_type like '%BRASS'")
+                  .capturePlanNodeId(partScanNodeId)
+                  .planNode();
+
+  auto plan =
+      PlanBuilder(planNodeIdGenerator)
+          .tableScan(kPartsupp, partsuppSelectedRowType, partsuppFileColumns)
+          .capturePlanNodeId(partsuppScanNodeId)
+          .hashJoin(
+              {"ps_partkey"},
+              {"p_partkey"},
+              part,
+              "",
+              {"ps_partkey", "ps_suppkey", "ps_supplycost", "p_mfgr"})
+          .hashJoin(
+              {"ps_partkey"},
+              {"min_partkey"},
+              minCost,
+              "ps_supplycost = min_supplycost",
+              {"ps_partkey", "ps_suppkey", "p_mfgr"})
+          .hashJoin(
+              {"ps_suppkey"},
+              {"s_suppkey"},
+              supplierJoinNation,
+              "",
+              {"s_acctbal",
+               "s_name",
+               "n_name",
+               "ps_partkey",
+               "p_mfgr",
+               "s_address",
+               "s_phone",
+               "s_comment"})
+          .project(
+              {"s_acctbal",
+               "s_name",
+               "n_name",
+               "ps_partkey AS p_partkey",
+               "p_mfgr",
+               "s_address",
+               "s_phone",
+               "s_comment"})
+          .localPartition({})
+          .orderBy({"s_acctbal DESC", "n_name", "s_name", "p_partkey"}, false)
+          .limit(0, 100, false)
+          .planNode();
+
+  TpchPlan context;
+  context.plan = std::move(plan);
+  context.dataFiles[partScanNodeId] = getTableFilePaths(kPart);
+  context.dataFiles[supplierScanNodeId] = getTableFilePaths(kSupplier);
+  context.dataFiles[partsuppScanNodeId] = getTableFilePaths(kPartsupp);
+  context.dataFiles[nationScanNodeId] = getTableFilePaths(kNation);
+  context.dataFiles[regionScanNodeId] = getTableFilePaths(kRegion);
+  context.dataFiles[minSupplierScanNodeId] = getTableFilePaths(kSupplier);
+  context.dataFiles[minPartsuppScanNodeId] = getTableFilePaths(kPartsupp);
+  context.dataFiles[minNationScanNodeId] = getTableFilePaths(kNation);
+  context.dataFiles[minRegionScanNodeId] = getTableFilePaths(kRegion);
+  context.dataFileFormat = format_;
+  return context;
+}
+
 TpchPlan TpchQueryBuilder::getQ3Plan() const {
   std::vector<std::string> lineitemColumns = {
       "l_shipdate", "l_orderkey", "l_extendedprice", "l_discount"};
@@ -273,6 +502,63 @@ TpchPlan TpchQueryBuilder::getQ3Plan() const {
   return context;
 }
 
+TpchPlan TpchQueryBuilder::getQ4Plan() const {
+  std::vector<std::string> ordersColumns = {
+      "o_orderkey", "o_orderdate", "o_orderpriority"};
+  std::vector<std::string> lineitemColumns = {
+      "l_orderkey", "l_commitdate", "l_receiptdate"};
+
+  auto ordersSelectedRowType = getRowType(kOrders, ordersColumns);
+  const auto& ordersFileColumns = getFileColumnNames(kOrders);
+  auto lineitemSelectedRowType = getRowType(kLineitem, lineitemColumns);
+  const auto& lineitemFileColumns = getFileColumnNames(kLineitem);
+
+  const std::string orderDateFilter = formatDateFilter(
+      "o_orderdate", ordersSelectedRowType, "'1993-07-01'", "'1993-09-30'");
+
+  auto planNodeIdGenerator = std::make_shared<PlanNodeIdGenerator>();
+  core::PlanNodeId ordersScanNodeId;
+  core::PlanNodeId lineitemScanNodeId;
+
+  auto lineitem = PlanBuilder(planNodeIdGenerator)
+                      .tableScan(
+                          kLineitem,
+                          lineitemSelectedRowType,
+                          lineitemFileColumns,
+                          {},
+                          "l_commitdate < l_receiptdate")
+                      .capturePlanNodeId(lineitemScanNodeId)
+                      .planNode();
+
+  auto plan = PlanBuilder(planNodeIdGenerator)
+                  .tableScan(
+                      kOrders,
+                      ordersSelectedRowType,
+                      ordersFileColumns,
+                      {orderDateFilter})
+                  .capturePlanNodeId(ordersScanNodeId)
+                  .hashJoin(
+                      {"o_orderkey"},
+                      {"l_orderkey"},
+                      lineitem,
+                      "",
+                      {"o_orderpriority"},
+                      core::JoinType::kLeftSemi)
+                  .partialAggregation(
+                      {"o_orderpriority"}, {"count(0) AS order_count"})
+                  .localPartition({})
+                  .finalAggregation()
+                  .orderBy({"o_orderpriority"}, false)
+                  .planNode();
+
+  TpchPlan context;
+  context.plan = std::move(plan);
+  context.dataFiles[ordersScanNodeId] = getTableFilePaths(kOrders);
+  context.dataFiles[lineitemScanNodeId] = getTableFilePaths(kLineitem);
+  context.dataFileFormat = format_;
+  return context;
+}
+
 TpchPlan TpchQueryBuilder::getQ5Plan() const {
   std::vector<std::string> customerColumns = {"c_custkey", "c_nationkey"};
   std::vector<std::string> ordersColumns = {
@@ -436,109 +722,561 @@ TpchPlan TpchQueryBuilder::getQ6Plan() const {
   return context;
 }
 
-TpchPlan TpchQueryBuilder::getQ10Plan() const {
-  std::vector<std::string> customerColumns = {
-      "c_nationkey",
-      "c_custkey",
-      "c_acctbal",
-      "c_name",
-      "c_address",
-      "c_phone",
-      "c_comment"};
-  std::vector<std::string> nationColumns = {"n_nationkey", "n_name"};
+TpchPlan TpchQueryBuilder::getQ7Plan() const {
+  std::vector<std::string> supplierColumns = {"s_suppkey", "s_nationkey"};
   std::vector<std::string> lineitemColumns = {
-      "l_orderkey", "l_returnflag", "l_extendedprice", "l_discount"};
-  std::vector<std::string> ordersColumns = {
-      "o_orderdate", "o_orderkey", "o_custkey"};
+      "l_orderkey",
+      "l_suppkey",
+      "l_extendedprice",
+      "l_discount",
+      "l_shipdate"};
+  std::vector<std::string> ordersColumns = {"o_orderkey", "o_custkey"};
+  std::vector<std::string> customerColumns = {"c_custkey", "c_nationkey"};
+  std::vector<std::string> nationColumns = {"n_nationkey", "n_name"};
 
-  const auto customerSelectedRowType = getRowType(kCustomer, customerColumns);
-  const auto& customerFileColumns = getFileColumnNames(kCustomer);
-  const auto nationSelectedRowType = getRowType(kNation, nationColumns);
-  const auto& nationFileColumns = getFileColumnNames(kNation);
-  const auto lineitemSelectedRowType = getRowType(kLineitem, lineitemColumns);
+  auto supplierSelectedRowType = getRowType(kSupplier, supplierColumns);
+  const auto& supplierFileColumns = getFileColumnNames(kSupplier);
+  auto lineitemSelectedRowType = getRowType(kLineitem, lineitemColumns);
   const auto& lineitemFileColumns = getFileColumnNames(kLineitem);
-  const auto ordersSelectedRowType = getRowType(kOrders, ordersColumns);
+  auto ordersSelectedRowType = getRowType(kOrders, ordersColumns);
   const auto& ordersFileColumns = getFileColumnNames(kOrders);
+  auto customerSelectedRowType = getRowType(kCustomer, customerColumns);
+  const auto& customerFileColumns = getFileColumnNames(kCustomer);
+  auto nationSelectedRowType = getRowType(kNation, nationColumns);
+  const auto& nationFileColumns = getFileColumnNames(kNation);
 
-  const auto lineitemReturnFlagFilter = "l_returnflag = 'R'";
-  const auto orderDate = "o_orderdate";
-  auto orderDateFilter = formatDateFilter(
-      orderDate, ordersSelectedRowType, "'1993-10-01'", "'1993-12-31'");
-
-  std::vector<std::string> customerOutputColumns = {
-      "c_name", "c_acctbal", "c_phone", "c_address", "c_custkey", "c_comment"};
-
-  auto mergeColumnNames = [](std::vector<std::string>& v1,
-                             const std::vector<std::string>& v2) {
-    v1.insert(v1.end(), v2.begin(), v2.end());
-    return v1;
-  };
+  const std::string nationFilter = "n_name IN ('FRANCE', 'GERMANY')";
+  const std::string shipDate = "l_shipdate";
+  const std::string shipDateFilter = formatDateFilter(
+      shipDate, lineitemSelectedRowType, "'1995-01-01'", "'1996-12-31'");
+  const std::string nationPairFilter =
+      "(supp_nation = 'FRANCE' AND cust_nation = 'GERMANY') OR "
+      "(supp_nation = 'GERMANY' AND cust_nation = 'FRANCE')";
 
   auto planNodeIdGenerator = std::make_shared<PlanNodeIdGenerator>();
-  core::PlanNodeId customerScanNodeId;
-  core::PlanNodeId nationScanNodeId;
+  core::PlanNodeId supplierScanNodeId;
   core::PlanNodeId lineitemScanNodeId;
   core::PlanNodeId ordersScanNodeId;
+  core::PlanNodeId customerScanNodeId;
+  core::PlanNodeId supplierNationScanNodeId;
+  core::PlanNodeId customerNationScanNodeId;
 
-  auto nation =
-      PlanBuilder(planNodeIdGenerator)
-          .tableScan(kNation, nationSelectedRowType, nationFileColumns)
-          .capturePlanNodeId(nationScanNodeId)
+  auto supplierNation =
+      PlanBuilder(planNodeIdGenerator, pool_.get())
+          .tableScan(
+              kNation, nationSelectedRowType, nationFileColumns, {nationFilter})
+          .capturePlanNodeId(supplierNationScanNodeId)
+          .project({"n_nationkey", "n_name AS supp_nation"})
           .planNode();
 
-  auto orders = PlanBuilder(planNodeIdGenerator)
-                    .tableScan(
-                        kOrders,
-                        ordersSelectedRowType,
-                        ordersFileColumns,
-                        {orderDateFilter})
-                    .capturePlanNodeId(ordersScanNodeId)
-                    .planNode();
+  auto customerNation =
+      PlanBuilder(planNodeIdGenerator, pool_.get())
+          .tableScan(
+              kNation, nationSelectedRowType, nationFileColumns, {nationFilter})
+          .capturePlanNodeId(customerNationScanNodeId)
+          .project({"n_nationkey", "n_name AS cust_nation"})
+          .planNode();
 
-  auto partialPlan =
+  auto supplierJoinNation =
       PlanBuilder(planNodeIdGenerator)
-          .tableScan(kCustomer, customerSelectedRowType, customerFileColumns)
-          .capturePlanNodeId(customerScanNodeId)
+          .tableScan(kSupplier, supplierSelectedRowType, supplierFileColumns)
+          .capturePlanNodeId(supplierScanNodeId)
           .hashJoin(
-              {"c_custkey"},
-              {"o_custkey"},
-              orders,
+              {"s_nationkey"},
+              {"n_nationkey"},
+              supplierNation,
               "",
-              mergeColumnNames(
-                  customerOutputColumns, {"c_nationkey", "o_orderkey"}))
+              {"s_suppkey", "supp_nation"})
+          .planNode();
+
+  auto customerJoinNation =
+      PlanBuilder(planNodeIdGenerator)
+          .tableScan(kCustomer, customerSelectedRowType, customerFileColumns)
+          .capturePlanNodeId(customerScanNodeId)
           .hashJoin(
               {"c_nationkey"},
               {"n_nationkey"},
-              nation,
+              customerNation,
               "",
-              mergeColumnNames(customerOutputColumns, {"n_name", "o_orderkey"}))
+              {"c_custkey", "cust_nation"})
           .planNode();
 
-  auto plan = PlanBuilder(planNodeIdGenerator)
-                  .tableScan(
-                      kLineitem,
-                      lineitemSelectedRowType,
-                      lineitemFileColumns,
-                      {lineitemReturnFlagFilter})
-                  .capturePlanNodeId(lineitemScanNodeId)
-                  .project(
-                      {"l_extendedprice * (1.0 - l_discount) AS part_revenue",
-                       "l_orderkey"})
-                  .hashJoin(
-                      {"l_orderkey"},
-                      {"o_orderkey"},
-                      partialPlan,
-                      "",
-                      mergeColumnNames(
-                          customerOutputColumns, {"part_revenue", "n_name"}))
-                  .partialAggregation(
-                      {"c_custkey",
-                       "c_name",
-                       "c_acctbal",
-                       "n_name",
-                       "c_address",
-                       "c_phone",
-                       "c_comment"},
+  auto ordersJoinCustomer =
+      PlanBuilder(planNodeIdGenerator)
+          .tableScan(kOrders, ordersSelectedRowType, ordersFileColumns)
+          .capturePlanNodeId(ordersScanNodeId)
+          .hashJoin(
+              {"o_custkey"},
+              {"c_custkey"},
+              customerJoinNation,
+              "",
+              {"o_orderkey", "cust_nation"})
+          .planNode();
+
+  auto plan =
+      PlanBuilder(planNodeIdGenerator)
+          .tableScan(
+              kLineitem,
+              lineitemSelectedRowType,
+              lineitemFileColumns,
+              {shipDateFilter})
+          .capturePlanNodeId(lineitemScanNodeId)
+          .project(
+              {"l_orderkey",
+               "l_suppkey",
+               "l_extendedprice * (1.0 - l_discount) AS volume",
+               formatYear(shipDate, lineitemSelectedRowType) + " AS l_year"})
+          .hashJoin(
+              {"l_suppkey"},
+              {"s_suppkey"},
+              supplierJoinNation,
+              "",
+              {"l_orderkey", "supp_nation", "volume", "l_year"})
+          .hashJoin(
+              {"l_orderkey"},
+              {"o_orderkey"},
+              ordersJoinCustomer,
+              nationPairFilter,
+              {"supp_nation", "cust_nation", "l_year", "volume"})
+          .partialAggregation(
+              {"supp_nation", "cust_nation", "l_year"},
+              {"sum(volume) AS revenue"})
+          .localPartition({})
+          .finalAggregation()
+          .orderBy({"supp_nation", "cust_nation", "l_year"}, false)
+          .planNode();
+
+  TpchPlan context;
+  context.plan = std::move(plan);
+  context.dataFiles[supplierScanNodeId] = getTableFilePaths(kSupplier);
+  context.dataFiles[lineitemScanNodeId] = getTableFilePaths(kLineitem);
+  context.dataFiles[ordersScanNodeId] = getTableFilePaths(kOrders);
+  context.dataFiles[customerScanNodeId] = getTableFilePaths(kCustomer);
+  context.dataFiles[supplierNationScanNodeId] = getTableFilePaths(kNation);
+  context.dataFiles[customerNationScanNodeId] = getTableFilePaths(kNation);
+  context.dataFileFormat = format_;
+  return context;
+}
+
+TpchPlan TpchQueryBuilder::getQ8Plan() const {
+  std::vector<std::string> partColumns = {"p_partkey", "p_type"};
+  std::vector<std::string> supplierColumns = {"s_suppkey", "s_nationkey"};
+  std::vector<std::string> lineitemColumns = {
+      "l_orderkey",
+      "l_partkey",
+      "l_suppkey",
+      "l_extendedprice",
+      "l_discount"};
+  std::vector<std::string> ordersColumns = {
+      "o_orderkey", "o_custkey", "o_orderdate"};
+  std::vector<std::string> customerColumns = {"c_custkey", "c_nationkey"};
+  std::vector<std::string> customerNationColumns = {
+      "n_nationkey", "n_regionkey"};
+  std::vector<std::string> supplierNationColumns = {"n_nationkey", "n_name"};
+  std::vector<std::string> regionColumns = {"r_regionkey", "r_name"};
+
+  auto partSelectedRowType = getRowType(kPart, partColumns);
+  const auto& partFileColumns = getFileColumnNames(kPart);
+  auto supplierSelectedRowType = getRowType(kSupplier, supplierColumns);
+  const auto& supplierFileColumns = getFileColumnNames(kSupplier);
+  auto lineitemSelectedRowType = getRowType(kLineitem, lineitemColumns);
+  const auto& lineitemFileColumns = getFileColumnNames(kLineitem);
+  auto ordersSelectedRowType = getRowType(kOrders, ordersColumns);
+  const auto& ordersFileColumns = getFileColumnNames(kOrders);
+  auto customerSelectedRowType = getRowType(kCustomer, customerColumns);
+  const auto& customerFileColumns = getFileColumnNames(kCustomer);
+  auto customerNationSelectedRowType =
+      getRowType(kNation, customerNationColumns);
+  auto supplierNationSelectedRowType =
+      getRowType(kNation, supplierNationColumns);
+  const auto& nationFileColumns = getFileColumnNames(kNation);
+  auto regionSelectedRowType = getRowType(kRegion, regionColumns);
+  const auto& regionFileColumns = getFileColumnNames(kRegion);
+
+  const std::string orderDate = "o_orderdate";
+  const std::string orderDateFilter = formatDateFilter(
+      orderDate, ordersSelectedRowType, "'1995-01-01'", "'1996-12-31'");
+
+  auto planNodeIdGenerator = std::make_shared<PlanNodeIdGenerator>();
+  core::PlanNodeId partScanNodeId;
+  core::PlanNodeId supplierScanNodeId;
+  core::PlanNodeId lineitemScanNodeId;
+  core::PlanNodeId ordersScanNodeId;
+  core::PlanNodeId customerScanNodeId;
+  core::PlanNodeId customerNationScanNodeId;
+  core::PlanNodeId supplierNationScanNodeId;
+  core::PlanNodeId regionScanNodeId;
+
+  auto region = PlanBuilder(planNodeIdGenerator)
+                    .tableScan(
+                        kRegion,
+                        regionSelectedRowType,
+                        regionFileColumns,
+                        {"r_name = 'AMERICA'"})
+                    .capturePlanNodeId(regionScanNodeId)
+                    .planNode();
+
+  auto customerNationJoinRegion =
+      PlanBuilder(planNodeIdGenerator)
+          .tableScan(kNation, customerNationSelectedRowType, nationFileColumns)
+          .capturePlanNodeId(customerNationScanNodeId)
+          .hashJoin(
+              {"n_regionkey"}, {"r_regionkey"}, region, "", {"n_nationkey"})
+          .planNode();
+
+  auto customerJoinNation =
+      PlanBuilder(planNodeIdGenerator)
+          .tableScan(kCustomer, customerSelectedRowType, customerFileColumns)
+          .capturePlanNodeId(customerScanNodeId)
+          .hashJoin(
+              {"c_nationkey"},
+              {"n_nationkey"},
+              customerNationJoinRegion,
+              "",
+              {"c_custkey"})
+          .planNode();
+
+  auto ordersJoinCustomer =
+      PlanBuilder(planNodeIdGenerator)
+          .tableScan(
+              kOrders,
+              ordersSelectedRowType,
+              ordersFileColumns,
+              {orderDateFilter})
+          .capturePlanNodeId(ordersScanNodeId)
+          .hashJoin(
+              {"o_custkey"},
+              {"c_custkey"},
+              customerJoinNation,
+              "",
+              {"o_orderkey", "o_orderdate"})
+          .planNode();
+
+  auto supplierNation =
+      PlanBuilder(planNodeIdGenerator)
+          .tableScan(kNation, supplierNationSelectedRowType, nationFileColumns)
+          .capturePlanNodeId(supplierNationScanNodeId)
+          .planNode();
+
+  auto supplierJoinNation =
+      PlanBuilder(planNodeIdGenerator)
+          .tableScan(kSupplier, supplierSelectedRowType, supplierFileColumns)
+          .capturePlanNodeId(supplierScanNodeId)
+          .hashJoin(
+              {"s_nationkey"},
+              {"n_nationkey"},
+              supplierNation,
+              "",
+              {"s_suppkey", "n_name"})
+          .planNode();
+
+  auto part = PlanBuilder(planNodeIdGenerator)
+                  .tableScan(
+                      kPart,
+                      partSelectedRowType,
+                      partFileColumns,
+                      {"p_type = 'ECONOMY ANODIZED STEEL'"})
+                  .capturePlanNodeId(partScanNodeId)
+                  .planNode();
+
+  auto plan =
+      PlanBuilder(planNodeIdGenerator)
+          .tableScan(kLineitem, lineitemSelectedRowType, lineitemFileColumns)
+          .capturePlanNodeId(lineitemScanNodeId)
+          .project(
+              {"l_orderkey",
+               "l_partkey",
+               "l_suppkey",
+               "l_extendedprice * (1.0 - l_discount) AS volume"})
+          .hashJoin(
+              {"l_partkey"},
+              {"p_partkey"},
+              part,
+              "",
+              {"l_orderkey", "l_suppkey", "volume"})
+          .hashJoin(
+              {"l_orderkey"},
+              {"o_orderkey"},
+              ordersJoinCustomer,
+              "",
+              {"l_suppkey", "volume", "o_orderdate"})
+          .hashJoin(
+              {"l_suppkey"},
+              {"s_suppkey"},
+              supplierJoinNation,
+              "",
+              {"volume", "o_orderdate", "n_name"})
+          .project(
+              {formatYear(orderDate, ordersSelectedRowType) + " AS o_year",
+               "volume",
+               "(CASE WHEN n_name = 'BRAZIL' THEN volume ELSE 0.0 END) AS brazil_volume"})
+          .partialAggregation(
+              {"o_year"},
+              {"sum(brazil_volume) AS brazil_total",
+               "sum(volume) AS total"})
+          .localPartition({})
+          .finalAggregation()
+          .project({"o_year", "brazil_total / total AS mkt_share"})
+          .orderBy({"o_year"}, false)
+          .planNode();
+
+  TpchPlan context;
+  context.plan = std::move(plan);
+  context.dataFiles[partScanNodeId] = getTableFilePaths(kPart);
+  context.dataFiles[supplierScanNodeId] = getTableFilePaths(kSupplier);
+  context.dataFiles[lineitemScanNodeId] = getTableFilePaths(kLineitem);
+  context.dataFiles[ordersScanNodeId] = getTableFilePaths(kOrders);
+  context.dataFiles[customerScanNodeId] = getTableFilePaths(kCustomer);
+  context.dataFiles[customerNationScanNodeId] = getTableFilePaths(kNation);
+  context.dataFiles[supplierNationScanNodeId] = getTableFilePaths(kNation);
+  context.dataFiles[regionScanNodeId] = getTableFilePaths(kRegion);
+  context.dataFileFormat = format_;
+  return context;
+}
+
+TpchPlan TpchQueryBuilder::getQ9Plan() const {
+  std::vector<std::string> partColumns = {"p_partkey", "p_name"};
+  std::vector<std::string> supplierColumns = {"s_suppkey", "s_nationkey"};
+  std::vector<std::string> lineitemColumns = {
+      "l_orderkey",
+      "l_partkey",
+      "l_suppkey",
+      "l_quantity",
+      "l_extendedprice",
+      "l_discount"};
+  std::vector<std::string> partsuppColumns = {
+      "ps_partkey", "ps_suppkey", "ps_supplycost"};
+  std::vector<std::string> ordersColumns = {"o_orderkey", "o_orderdate"};
+  std::vector<std::string> nationColumns = {"n_nationkey", "n_name"};
+
+  auto partSelectedRowType = getRowType(kPart, partColumns);
+  const auto& partFileColumns = getFileColumnNames(kPart);
+  auto supplierSelectedRowType = getRowType(kSupplier, supplierColumns);
+  const auto& supplierFileColumns = getFileColumnNames(kSupplier);
+  auto lineitemSelectedRowType = getRowType(kLineitem, lineitemColumns);
+  const auto& lineitemFileColumns = getFileColumnNames(kLineitem);
+  auto partsuppSelectedRowType = getRowType(kPartsupp, partsuppColumns);
+  const auto& partsuppFileColumns = getFileColumnNames(kPartsupp);
+  auto ordersSelectedRowType = getRowType(kOrders, ordersColumns);
+  const auto& ordersFileColumns = getFileColumnNames(kOrders);
+  auto nationSelectedRowType = getRowType(kNation, nationColumns);
+  const auto& nationFileColumns = getFileColumnNames(kNation);
+
+  const std::string orderDate = "o_orderdate";
+
+  auto planNodeIdGenerator = std::make_shared<PlanNodeIdGenerator>();
+  core::PlanNodeId partScanNodeId;
+  core::PlanNodeId supplierScanNodeId;
+  core::PlanNodeId lineitemScanNodeId;
+  core::PlanNodeId partsuppScanNodeId;
+  core::PlanNodeId ordersScanNodeId;
+  core::PlanNodeId nationScanNodeId;
+
+  auto part = PlanBuilder(planNodeIdGenerator)
+                  .tableScan(
+                      kPart,
+                      partSelectedRowType,
+                      partFileColumns,
+                      {},
+                      "p_name like '%green%'")
+                  .capturePlanNodeId(partScanNodeId)
+                  .planNode();
+
+  auto partsuppJoinPart =
+      PlanBuilder(planNodeIdGenerator)
+          .tableScan(kPartsupp, partsuppSelectedRowType, partsuppFileColumns)
+          .capturePlanNodeId(partsuppScanNodeId)
+          .hashJoin(
+              {"ps_partkey"},
+              {"p_partkey"},
+              part,
+              "",
+              {"ps_partkey", "ps_suppkey", "ps_supplycost"})
+          .planNode();
+
+  auto nation =
+      PlanBuilder(planNodeIdGenerator)
+          .tableScan(kNation, nationSelectedRowType, nationFileColumns)
+          .capturePlanNodeId(nationScanNodeId)
+          .planNode();
+
+  auto supplierJoinNation =
+      PlanBuilder(planNodeIdGenerator)
+          .tableScan(kSupplier, supplierSelectedRowType, supplierFileColumns)
+          .capturePlanNodeId(supplierScanNodeId)
+          .hashJoin(
+              {"s_nationkey"},
+              {"n_nationkey"},
+              nation,
+              "",
+              {"s_suppkey", "n_name"})
+          .planNode();
+
+  // Only the lineitems of green parts are kept, so they are the build side
+  // of the join with orders.
+  auto greenLineitems =
+      PlanBuilder(planNodeIdGenerator)
+          .tableScan(kLineitem, lineitemSelectedRowType, lineitemFileColumns)
+          .capturePlanNodeId(lineitemScanNodeId)
+          .hashJoin(
+              {"l_partkey", "l_suppkey"},
+              {"ps_partkey", "ps_suppkey"},
+              partsuppJoinPart,
+              "",
+              {"l_orderkey",
+               "l_suppkey",
+               "l_quantity",
+               "l_extendedprice",
+               "l_discount",
+               "ps_supplycost"})
+          .project(
+              {"l_orderkey",
+               "l_suppkey",
+               "l_extendedprice * (1.0 - l_discount) - ps_supplycost * l_quantity AS amount"})
+          .hashJoin(
+              {"l_suppkey"},
+              {"s_suppkey"},
+              supplierJoinNation,
+              "",
+              {"l_orderkey", "amount", "n_name"})
+          .planNode();
+
+  auto plan =
+      PlanBuilder(planNodeIdGenerator)
+          .tableScan(kOrders, ordersSelectedRowType, ordersFileColumns)
+          .capturePlanNodeId(ordersScanNodeId)
+          .hashJoin(
+              {"o_orderkey"},
+              {"l_orderkey"},
+              greenLineitems,
+              "",
+              {"n_name", "o_orderdate", "amount"})
+          .project(
+              {"n_name AS nation",
+               formatYear(orderDate, ordersSelectedRowType) + " AS o_year",
+               "amount"})
+          .partialAggregation(
+              {"nation", "o_year"}, {"sum(amount) AS sum_profit"})
+          .localPartition({})
+          .finalAggregation()
+          .orderBy({"nation", "o_year DESC"}, false)
+          .planNode();
+
+  TpchPlan context;
+  context.plan = std::move(plan);
+  context.dataFiles[partScanNodeId] = getTableFilePaths(kPart);
+  context.dataFiles[supplierScanNodeId] = getTableFilePaths(kSupplier);
+  context.dataFiles[lineitemScanNodeId] = getTableFilePaths(kLineitem);
+  context.dataFiles[partsuppScanNodeId] = getTableFilePaths(kPartsupp);
+  context.dataFiles[ordersScanNodeId] = getTableFilePaths(kOrders);
+  context.dataFiles[nationScanNodeId] = getTableFilePaths(kNation);
+  context.dataFileFormat = format_;
+  return context;
+}
+
+TpchPlan TpchQueryBuilder::getQ10Plan() const {
+  std::vector<std::string> customerColumns = {
+      "c_nationkey",
+      "c_custkey",
+      "c_acctbal",
+      "c_name",
+      "c_address",
+      "c_phone",
+      "c_comment"};
+  std::vector<std::string> nationColumns = {"n_nationkey", "n_name"};
+  std::vector<std::string> lineitemColumns = {
+      "l_orderkey", "l_returnflag", "l_extendedprice", "l_discount"};
+  std::vector<std::string> ordersColumns = {
+      "o_orderdate", "o_orderkey", "o_custkey"};
+
+  const auto customerSelectedRowType = getRowType(kCustomer, customerColumns);
+  const auto& customerFileColumns = getFileColumnNames(kCustomer);
+  const auto nationSelectedRowType = getRowType(kNation, nationColumns);
+  const auto& nationFileColumns = getFileColumnNames(kNation);
+  const auto lineitemSelectedRowType = getRowType(kLineitem, lineitemColumns);
+  const auto& lineitemFileColumns = getFileColumnNames(kLineitem);
+  const auto ordersSelectedRowType = getRowType(kOrders, ordersColumns);
+  const auto& ordersFileColumns = getFileColumnNames(kOrders);
+
+  const auto lineitemReturnFlagFilter = "l_returnflag = 'R'";
+  const auto orderDate = "o_orderdate";
+  auto orderDateFilter = formatDateFilter(
+      orderDate, ordersSelectedRowType, "'1993-10-01'", "'1993-12-31'");
+
+  std::vector<std::string> customerOutputColumns = {
+      "c_name", "c_acctbal", "c_phone", "c_address", "c_custkey", "c_comment"};
+
+  auto mergeColumnNames = [](std::vector<std::string>& v1,
+                             const std::vector<std::string>& v2) {
+    v1.insert(v1.end(), v2.begin(), v2.end());
+    return v1;
+  };
+
+  auto planNodeIdGenerator = std::make_shared<PlanNodeIdGenerator>();
+  core::PlanNodeId customerScanNodeId;
+  core::PlanNodeId nationScanNodeId;
+  core::PlanNodeId lineitemScanNodeId;
+  core::PlanNodeId ordersScanNodeId;
+
+  auto nation =
+      PlanBuilder(planNodeIdGenerator)
+          .tableScan(kNation, nationSelectedRowType, nationFileColumns)
+          .capturePlanNodeId(nationScanNodeId)
+          .planNode();
+
+  auto orders = PlanBuilder(planNodeIdGenerator)
+                    .tableScan(
+                        kOrders,
+                        ordersSelectedRowType,
+                        ordersFileColumns,
+                        {orderDateFilter})
+                    .capturePlanNodeId(ordersScanNodeId)
+                    .planNode();
+
+  auto partialPlan =
+      PlanBuilder(planNodeIdGenerator)
+          .tableScan(kCustomer, customerSelectedRowType, customerFileColumns)
+          .capturePlanNodeId(customerScanNodeId)
+          .hashJoin(
+              {"c_custkey"},
+              {"o_custkey"},
+              orders,
+              "",
+              mergeColumnNames(
+                  customerOutputColumns, {"c_nationkey", "o_orderkey"}))
+          .hashJoin(
+              {"c_nationkey"},
+              {"n_nationkey"},
+              nation,
+              "",
+              mergeColumnNames(customerOutputColumns, {"n_name", "o_orderkey"}))
+          .planNode();
+
+  auto plan = PlanBuilder(planNodeIdGenerator)
+                  .tableScan(
+                      kLineitem,
+                      lineitemSelectedRowType,
+                      lineitemFileColumns,
+                      {lineitemReturnFlagFilter})
+                  .capturePlanNodeId(lineitemScanNodeId)
+                  .project(
+                      {"l_extendedprice * (1.0 - l_discount) AS part_revenue",
+                       "l_orderkey"})
+                  .hashJoin(
+                      {"l_orderkey"},
+                      {"o_orderkey"},
+                      partialPlan,
+                      "",
+                      mergeColumnNames(
+                          customerOutputColumns, {"part_revenue", "n_name"}))
+                  .partialAggregation(
+                      {"c_custkey",
+                       "c_name",
+                       "c_acctbal",
+                       "n_name",
+                       "c_address",
+                       "c_phone",
+                       "c_comment"},
                       {"sum(part_revenue) as revenue"})
                   .localPartition({})
                   .finalAggregation()
@@ -565,6 +1303,116 @@ TpchPlan TpchQueryBuilder::getQ10Plan() const {
   return context;
 }
 
+TpchPlan TpchQueryBuilder::getQ11Plan() const {
+  std::vector<std::string> partsuppColumns = {
+      "ps_partkey", "ps_suppkey", "ps_availqty", "ps_supplycost"};
+  std::vector<std::string> supplierColumns = {"s_suppkey", "s_nationkey"};
+  std::vector<std::string> nationColumns = {"n_nationkey", "n_name"};
+
+  auto partsuppSelectedRowType = getRowType(kPartsupp, partsuppColumns);
+  const auto& partsuppFileColumns = getFileColumnNames(kPartsupp);
+  auto supplierSelectedRowType = getRowType(kSupplier, supplierColumns);
+  const auto& supplierFileColumns = getFileColumnNames(kSupplier);
+  auto nationSelectedRowType = getRowType(kNation, nationColumns);
+  const auto& nationFileColumns = getFileColumnNames(kNation);
+
+  const std::string nationNameFilter = "n_name = 'GERMANY'";
+  const std::string partValue =
+      "ps_supplycost * cast(ps_availqty AS DOUBLE) AS part_value";
+
+  auto planNodeIdGenerator = std::make_shared<PlanNodeIdGenerator>();
+  core::PlanNodeId partsuppScanNodeId;
+  core::PlanNodeId supplierScanNodeId;
+  core::PlanNodeId nationScanNodeId;
+  core::PlanNodeId totalPartsuppScanNodeId;
+  core::PlanNodeId totalSupplierScanNodeId;
+  core::PlanNodeId totalNationScanNodeId;
+
+  auto totalNation = PlanBuilder(planNodeIdGenerator)
+                         .tableScan(
+                             kNation,
+                             nationSelectedRowType,
+                             nationFileColumns,
+                             {nationNameFilter})
+                         .capturePlanNodeId(totalNationScanNodeId)
+                         .planNode();
+
+  auto totalSupplier =
+      PlanBuilder(planNodeIdGenerator)
+          .tableScan(kSupplier, supplierSelectedRowType, supplierFileColumns)
+          .capturePlanNodeId(totalSupplierScanNodeId)
+          .hashJoin(
+              {"s_nationkey"}, {"n_nationkey"}, totalNation, "", {"s_suppkey"})
+          .planNode();
+
+  // The threshold of the HAVING clause is a single row. The fraction is the
+  // one of the reference query text, 0.0001.
+  auto threshold =
+      PlanBuilder(planNodeIdGenerator)
+          .tableScan(kPartsupp, partsuppSelectedRowType, partsuppFileColumns)
+          .capturePlanNodeId(totalPartsuppScanNodeId)
+          .hashJoin(
+              {"ps_suppkey"},
+              {"s_suppkey"},
+              totalSupplier,
+              "",
+              {"ps_availqty", "ps_supplycost"})
+          .project({partValue})
+          .partialAggregation({}, {"sum(part_value) AS total_value"})
+          .localPartition({})
+          .finalAggregation()
+          .project({"total_value * 0.0001 AS threshold"})
+          .planNode();
+
+  auto nation = PlanBuilder(planNodeIdGenerator)
+                    .tableScan(
+                        kNation,
+                        nationSelectedRowType,
+                        nationFileColumns,
+                        {nationNameFilter})
+                    .capturePlanNodeId(nationScanNodeId)
+                    .planNode();
+
+  auto supplier =
+      PlanBuilder(planNodeIdGenerator)
+          .tableScan(kSupplier, supplierSelectedRowType, supplierFileColumns)
+          .capturePlanNodeId(supplierScanNodeId)
+          .hashJoin({"s_nationkey"}, {"n_nationkey"}, nation, "", {"s_suppkey"})
+          .planNode();
+
+  auto plan =
+      PlanBuilder(planNodeIdGenerator)
+          .tableScan(kPartsupp, partsuppSelectedRowType, partsuppFileColumns)
+          .capturePlanNodeId(partsuppScanNodeId)
+          .hashJoin(
+              {"ps_suppkey"},
+              {"s_suppkey"},
+              supplier,
+              "",
+              {"ps_partkey", "ps_availqty", "ps_supplycost"})
+          .project({"ps_partkey", partValue})
+          .partialAggregation({"ps_partkey"}, {"sum(part_value) AS value"})
+          .localPartition({"ps_partkey"})
+          .finalAggregation()
+          .crossJoin(threshold, {"ps_partkey", "value", "threshold"})
+          .filter("value > threshold")
+          .localPartition({})
+          .orderBy({"value DESC"}, false)
+          .project({"ps_partkey", "value"})
+          .planNode();
+
+  TpchPlan context;
+  context.plan = std::move(plan);
+  context.dataFiles[partsuppScanNodeId] = getTableFilePaths(kPartsupp);
+  context.dataFiles[supplierScanNodeId] = getTableFilePaths(kSupplier);
+  context.dataFiles[nationScanNodeId] = getTableFilePaths(kNation);
+  context.dataFiles[totalPartsuppScanNodeId] = getTableFilePaths(kPartsupp);
+  context.dataFiles[totalSupplierScanNodeId] = getTableFilePaths(kSupplier);
+  context.dataFiles[totalNationScanNodeId] = getTableFilePaths(kNation);
+  context.dataFileFormat = format_;
+  return context;
+}
+
 TpchPlan TpchQueryBuilder::getQ12Plan() const {
   std::vector<std::string> ordersColumns = {"o_orderkey", "o_orderpriority"};
   std::vector<std::string> lineitemColumns = {
@@ -674,78 +1522,316 @@ TpchPlan TpchQueryBuilder::getQ13Plan() const {
               core::JoinType::kRight)
           .partialAggregation({"c_custkey"}, {"count(o_orderkey) as pc_count"})
           .localPartition({})
-          .finalAggregation(
-              {"c_custkey"}, {"count(pc_count) as c_count"}, {BIGINT()})
-          .singleAggregation({"c_count"}, {"count(0) as custdist"})
-          .orderBy({"custdist DESC", "c_count DESC"}, false)
+          .finalAggregation(
+              {"c_custkey"}, {"count(pc_count) as c_count"}, {BIGINT()})
+          .singleAggregation({"c_count"}, {"count(0) as custdist"})
+          .orderBy({"custdist DESC", "c_count DESC"}, false)
+          .planNode();
+
+  TpchPlan context;
+  context.plan = std::move(plan);
+  context.dataFiles[ordersScanNodeId] = getTableFilePaths(kOrders);
+  context.dataFiles[customerScanNodeId] = getTableFilePaths(kCustomer);
+  context.dataFileFormat = format_;
+  return context;
+}
+
+TpchPlan TpchQueryBuilder::getQ14Plan() const {
+  std::vector<std::string> lineitemColumns = {
+      "l_partkey", "l_extendedprice", "l_discount", "l_shipdate"};
+  std::vector<std::string> partColumns = {"p_partkey", "p_type"};
+
+  auto lineitemSelectedRowType = getRowType(kLineitem, lineitemColumns);
+  const auto& lineitemFileColumns = getFileColumnNames(kLineitem);
+  auto partSelectedRowType = getRowType(kPart, partColumns);
+  const auto& partFileColumns = getFileColumnNames(kPart);
+
+  const std::string shipDate = "l_shipdate";
+  const std::string shipDateFilter = formatDateFilter(
+      shipDate, lineitemSelectedRowType, "'1995-09-01'", "'1995-09-30'");
+
+  auto planNodeIdGenerator = std::make_shared<PlanNodeIdGenerator>();
+  core::PlanNodeId lineitemScanNodeId;
+  core::PlanNodeId partScanNodeId;
+
+  auto part = PlanBuilder(planNodeIdGenerator)
+                  .tableScan(kPart, partSelectedRowType, partFileColumns)
+                  .capturePlanNodeId(partScanNodeId)
+                  .planNode();
+
+  auto plan =
+      PlanBuilder(planNodeIdGenerator)
+          .tableScan(
+              kLineitem,
+              lineitemSelectedRowType,
+              lineitemFileColumns,
+              {},
+              shipDateFilter)
+          .capturePlanNodeId(lineitemScanNodeId)
+          .project(
+              {"l_extendedprice * (1.0 - l_discount) as part_revenue",
+               "l_shipdate",
+               "l_partkey"})
+          .hashJoin(
+              {"l_partkey"},
+              {"p_partkey"},
+              part,
+              "",
+              {"part_revenue", "p_type"})
+          .project(
+              {"(CASE WHEN (p_type LIKE 'PROMO%') THEN part_revenue ELSE 0.0 END) as filter_revenue",
+               "part_revenue"})
+          .partialAggregation(
+              {},
+              {"sum(part_revenue) as total_revenue",
+               "sum(filter_revenue) as total_promo_revenue"})
+          .localPartition({})
+          .finalAggregation()
+          .project(
+              {"100.00 * total_promo_revenue/total_revenue as promo_revenue"})
+          .planNode();
+
+  TpchPlan context;
+  context.plan = std::move(plan);
+  context.dataFiles[lineitemScanNodeId] = getTableFilePaths(kLineitem);
+  context.dataFiles[partScanNodeId] = getTableFilePaths(kPart);
+  context.dataFileFormat = format_;
+  return context;
+}
+
+TpchPlan TpchQueryBuilder::getQ15Plan() const {
+  std::vector<std::string> lineitemColumns = {
+      "l_suppkey", "l_extendedprice", "l_discount", "l_shipdate"};
+  std::vector<std::string> supplierColumns = {
+      "s_suppkey", "s_name", "s_address", "s_phone"};
+
+  auto lineitemSelectedRowType = getRowType(kLineitem, lineitemColumns);
+  const auto& lineitemFileColumns = getFileColumnNames(kLineitem);
+  auto supplierSelectedRowType = getRowType(kSupplier, supplierColumns);
+  const auto& supplierFileColumns = getFileColumnNames(kSupplier);
+
+  const std::string shipDateFilter = formatDateFilter(
+      "l_shipdate", lineitemSelectedRowType, "'1996-01-01'", "'1996-03-31'");
+  // The revenue view is computed twice, once per supplier and once for the
+  // maximum. The revenue is summed in units of 1/10000, which is exact for
+  // prices and discounts with two decimals, so that both sums compare equal
+  // regardless of the order of addition.
+  const std::string revenueUnits =
+      "cast(round(l_extendedprice * (1.0 - l_discount) * 10000.0) AS BIGINT) "
+      "AS revenue_units";
+
+  auto planNodeIdGenerator = std::make_shared<PlanNodeIdGenerator>();
+  core::PlanNodeId lineitemScanNodeId;
+  core::PlanNodeId maxLineitemScanNodeId;
+  core::PlanNodeId supplierScanNodeId;
+
+  auto maxRevenue =
+      PlanBuilder(planNodeIdGenerator)
+          .tableScan(
+              kLineitem,
+              lineitemSelectedRowType,
+              lineitemFileColumns,
+              {shipDateFilter})
+          .capturePlanNodeId(maxLineitemScanNodeId)
+          .project({"l_suppkey", revenueUnits})
+          .partialAggregation(
+              {"l_suppkey"}, {"sum(revenue_units) AS total_units"})
+          .localPartition({"l_suppkey"})
+          .finalAggregation()
+          .partialAggregation({}, {"max(total_units) AS max_units"})
+          .localPartition({})
+          .finalAggregation()
+          .planNode();
+
+  auto supplier =
+      PlanBuilder(planNodeIdGenerator)
+          .tableScan(kSupplier, supplierSelectedRowType, supplierFileColumns)
+          .capturePlanNodeId(supplierScanNodeId)
+          .planNode();
+
+  auto plan =
+      PlanBuilder(planNodeIdGenerator)
+          .tableScan(
+              kLineitem,
+              lineitemSelectedRowType,
+              lineitemFileColumns,
+              {shipDateFilter})
+          .capturePlanNodeId(lineitemScanNodeId)
+          .project({"l_suppkey", revenueUnits})
+          .partialAggregation(
+              {"l_suppkey"}, {"sum(revenue_units) AS total_units"})
+          .localPartition({"l_suppkey"})
+          .finalAggregation()
+          .crossJoin(maxRevenue, {"l_suppkey", "total_units", "max_units"})
+          .filter("total_units = max_units")
+          .hashJoin(
+              {"l_suppkey"},
+              {"s_suppkey"},
+              supplier,
+              "",
+              {"s_suppkey", "s_name", "s_address", "s_phone", "total_units"})
+          .project(
+              {"s_suppkey",
+               "s_name",
+               "s_address",
+               "s_phone",
+               "cast(total_units AS DOUBLE) / 10000.0 AS total_revenue"})
+          .localPartition({})
+          .orderBy({"s_suppkey"}, false)
+          .planNode();
+
+  TpchPlan context;
+  context.plan = std::move(plan);
+  context.dataFiles[lineitemScanNodeId] = getTableFilePaths(kLineitem);
+  context.dataFiles[maxLineitemScanNodeId] = getTableFilePaths(kLineitem);
+  context.dataFiles[supplierScanNodeId] = getTableFilePaths(kSupplier);
+  context.dataFileFormat = format_;
+  return context;
+}
+
+TpchPlan TpchQueryBuilder::getQ16Plan() const {
+  std::vector<std::string> partColumns = {
+      "p_partkey", "p_brand", "p_type", "p_size"};
+  std::vector<std::string> supplierColumns = {"s_suppkey", "s_comment"};
+  std::vector<std::string> partsuppColumns = {"ps_partkey", "ps_suppkey"};
+
+  auto partSelectedRowType = getRowType(kPart, partColumns);
+  const auto& partFileColumns = getFileColumnNames(kPart);
+  auto supplierSelectedRowType = getRowType(kSupplier, supplierColumns);
+  const auto& supplierFileColumns = getFileColumnNames(kSupplier);
+  auto partsuppSelectedRowType = getRowType(kPartsupp, partsuppColumns);
+  const auto& partsuppFileColumns = getFileColumnNames(kPartsupp);
+
+  auto planNodeIdGenerator = std::make_shared<PlanNodeIdGenerator>();
+  core::PlanNodeId partScanNodeId;
+  core::PlanNodeId supplierScanNodeId;
+  core::PlanNodeId partsuppScanNodeId;
+
+  auto part = PlanBuilder(planNodeIdGenerator, pool_.get())
+                  .tableScan(
+                      kPart,
+                      partSelectedRowType,
+                      partFileColumns,
+                      {"p_size IN (49, 14, 23, 45, 19, 3, 36, 9)",
+                       "p_brand <> 'Brand#45'"},
+                      "p_type not like 'MEDIUM POLISHED%'")
+                  .capturePlanNodeId(partScanNodeId)
+                  .planNode();
+
+  auto complainedSuppliers = PlanBuilder(planNodeIdGenerator)
+                                 .tableScan(
+                                     kSupplier,
+                                     supplierSelectedRowType,
+                                     supplierFileColumns,
+                                     {},
+                                     "s_comment like '%Customer%Complaints%'")
+                                 .capturePlanNodeId(supplierScanNodeId)
+                                 .planNode();
+
+  // count(distinct ps_suppkey) is a distinct aggregation on all the keys
+  // followed by a count over the partitions of the group.
+  auto plan =
+      PlanBuilder(planNodeIdGenerator)
+          .tableScan(kPartsupp, partsuppSelectedRowType, partsuppFileColumns)
+          .capturePlanNodeId(partsuppScanNodeId)
+          .hashJoin(
+              {"ps_suppkey"},
+              {"s_suppkey"},
+              complainedSuppliers,
+              "",
+              {"ps_partkey", "ps_suppkey"},
+              core::JoinType::kAnti)
+          .hashJoin(
+              {"ps_partkey"},
+              {"p_partkey"},
+              part,
+              "",
+              {"p_brand", "p_type", "p_size", "ps_suppkey"})
+          .partialAggregation({"p_brand", "p_type", "p_size", "ps_suppkey"}, {})
+          .localPartition({"p_brand", "p_type", "p_size"})
+          .finalAggregation()
+          .singleAggregation(
+              {"p_brand", "p_type", "p_size"}, {"count(0) AS supplier_cnt"})
+          .localPartition({})
+          .orderBy({"supplier_cnt DESC", "p_brand", "p_type", "p_size"}, false)
           .planNode();
 
   TpchPlan context;
   context.plan = std::move(plan);
-  context.dataFiles[ordersScanNodeId] = getTableFilePaths(kOrders);
-  context.dataFiles[customerScanNodeId] = getTableFilePaths(kCustomer);
+  context.dataFiles[partScanNodeId] = getTableFilePaths(kPart);
+  context.dataFiles[supplierScanNodeId] = getTableFilePaths(kSupplier);
+  context.dataFiles[partsuppScanNodeId] = getTableFilePaths(kPartsupp);
   context.dataFileFormat = format_;
   return context;
 }
 
-TpchPlan TpchQueryBuilder::getQ14Plan() const {
+TpchPlan TpchQueryBuilder::getQ17Plan() const {
   std::vector<std::string> lineitemColumns = {
-      "l_partkey", "l_extendedprice", "l_discount", "l_shipdate"};
-  std::vector<std::string> partColumns = {"p_partkey", "p_type"};
+      "l_partkey", "l_quantity", "l_extendedprice"};
+  std::vector<std::string> partColumns = {
+      "p_partkey", "p_brand", "p_container"};
 
   auto lineitemSelectedRowType = getRowType(kLineitem, lineitemColumns);
   const auto& lineitemFileColumns = getFileColumnNames(kLineitem);
   auto partSelectedRowType = getRowType(kPart, partColumns);
   const auto& partFileColumns = getFileColumnNames(kPart);
 
-  const std::string shipDate = "l_shipdate";
-  const std::string shipDateFilter = formatDateFilter(
-      shipDate, lineitemSelectedRowType, "'1995-09-01'", "'1995-09-30'");
-
   auto planNodeIdGenerator = std::make_shared<PlanNodeIdGenerator>();
   core::PlanNodeId lineitemScanNodeId;
+  core::PlanNodeId avgLineitemScanNodeId;
   core::PlanNodeId partScanNodeId;
 
   auto part = PlanBuilder(planNodeIdGenerator)
-                  .tableScan(kPart, partSelectedRowType, partFileColumns)
+                  .tableScan(
+                      kPart,
+                      partSelectedRowType,
+                      partFileColumns,
+                      {"p_brand = 'Brand#23'", "p_container = 'MED BOX'"})
                   .capturePlanNodeId(partScanNodeId)
                   .planNode();
 
-  auto plan =
+  // The average quantity is computed only for the selected parts. Joining
+  // on it then also applies the part filter to the outer lineitems.
+  auto avgQuantity =
       PlanBuilder(planNodeIdGenerator)
-          .tableScan(
-              kLineitem,
-              lineitemSelectedRowType,
-              lineitemFileColumns,
-              {},
-              shipDateFilter)
-          .capturePlanNodeId(lineitemScanNodeId)
-          .project(
-              {"l_extendedprice * (1.0 - l_discount) as part_revenue",
-               "l_shipdate",
-               "l_partkey"})
+          .tableScan(kLineitem, lineitemSelectedRowType, lineitemFileColumns)
+          .capturePlanNodeId(avgLineitemScanNodeId)
           .hashJoin(
               {"l_partkey"},
               {"p_partkey"},
               part,
               "",
-              {"part_revenue", "p_type"})
-          .project(
-              {"(CASE WHEN (p_type LIKE 'PROMO%') THEN part_revenue ELSE 0.0 END) as filter_revenue",
-               "part_revenue"})
+              {"l_partkey", "l_quantity"},
+              core::JoinType::kLeftSemi)
           .partialAggregation(
-              {},
-              {"sum(part_revenue) as total_revenue",
-               "sum(filter_revenue) as total_promo_revenue"})
-          .localPartition({})
+              {"l_partkey"}, {"avg(l_quantity) AS avg_quantity"})
+          .localPartition({"l_partkey"})
           .finalAggregation()
           .project(
-              {"100.00 * total_promo_revenue/total_revenue as promo_revenue"})
+              {"l_partkey AS agg_partkey",
+               "0.2 * avg_quantity AS quantity_threshold"})
+          .planNode();
+
+  auto plan =
+      PlanBuilder(planNodeIdGenerator)
+          .tableScan(kLineitem, lineitemSelectedRowType, lineitemFileColumns)
+          .capturePlanNodeId(lineitemScanNodeId)
+          .hashJoin(
+              {"l_partkey"},
+              {"agg_partkey"},
+              avgQuantity,
+              "l_quantity < quantity_threshold",
+              {"l_extendedprice"})
+          .partialAggregation({}, {"sum(l_extendedprice) AS total"})
+          .localPartition({})
+          .finalAggregation()
+          .project({"total / 7.0 AS avg_yearly"})
           .planNode();
 
   TpchPlan context;
   context.plan = std::move(plan);
   context.dataFiles[lineitemScanNodeId] = getTableFilePaths(kLineitem);
+  context.dataFiles[avgLineitemScanNodeId] = getTableFilePaths(kLineitem);
   context.dataFiles[partScanNodeId] = getTableFilePaths(kPart);
   context.dataFileFormat = format_;
   return context;
@@ -901,8 +1987,359 @@ TpchPlan TpchQueryBuilder::getQ19Plan() const {
   return context;
 }
 
-const std::vector<std::string> TpchQueryBuilder::kTableNames_ =
-    {kLineitem, kOrders, kCustomer, kNation, kRegion, kPart, kSupplier};
+TpchPlan TpchQueryBuilder::getQ20Plan() const {
+  std::vector<std::string> supplierColumns = {
+      "s_suppkey", "s_name", "s_address", "s_nationkey"};
+  std::vector<std::string> nationColumns = {"n_nationkey", "n_name"};
+  std::vector<std::string> partsuppColumns = {
+      "ps_partkey", "ps_suppkey", "ps_availqty"};
+  std::vector<std::string> partColumns = {"p_partkey", "p_name"};
+  std::vector<std::string> lineitemColumns = {
+      "l_partkey", "l_suppkey", "l_quantity", "l_shipdate"};
+
+  auto supplierSelectedRowType = getRowType(kSupplier, supplierColumns);
+  const auto& supplierFileColumns = getFileColumnNames(kSupplier);
+  auto nationSelectedRowType = getRowType(kNation, nationColumns);
+  const auto& nationFileColumns = getFileColumnNames(kNation);
+  auto partsuppSelectedRowType = getRowType(kPartsupp, partsuppColumns);
+  const auto& partsuppFileColumns = getFileColumnNames(kPartsupp);
+  auto partSelectedRowType = getRowType(kPart, partColumns);
+  const auto& partFileColumns = getFileColumnNames(kPart);
+  auto lineitemSelectedRowType = getRowType(kLineitem, lineitemColumns);
+  const auto& lineitemFileColumns = getFileColumnNames(kLineitem);
+
+  const std::string shipDateFilter = formatDateFilter(
+      "l_shipdate", lineitemSelectedRowType, "'1994-01-01'", "'1994-12-31'");
+
+  auto planNodeIdGenerator = std::make_shared<PlanNodeIdGenerator>();
+  core::PlanNodeId supplierScanNodeId;
+  core::PlanNodeId nationScanNodeId;
+  core::PlanNodeId partsuppScanNodeId;
+  core::PlanNodeId partScanNodeId;
+  core::PlanNodeId lineitemScanNodeId;
+
+  auto part = PlanBuilder(planNodeIdGenerator, pool_.get())
+                  .tableScan(
+                      kPart,
+                      partSelectedRowType,
+                      partFileColumns,
+                      {"p_name like 'forest%'"})
+                  .capturePlanNodeId(partScanNodeId)
+                  .planNode();
+
+  auto partsuppJoinPart =
+      PlanBuilder(planNodeIdGenerator)
+          .tableScan(kPartsupp, partsuppSelectedRowType, partsuppFileColumns)
+          .capturePlanNodeId(partsuppScanNodeId)
+          .hashJoin(
+              {"ps_partkey"},
+              {"p_partkey"},
+              part,
+              "",
+              {"ps_partkey", "ps_suppkey", "ps_availqty"})
+          .planNode();
+
+  // The correlated subquery becomes the quantity shipped per part and
+  // supplier, joined on both keys. Pairs that shipped nothing in the year
+  // have a null threshold and do not qualify.
+  auto availableSuppliers =
+      PlanBuilder(planNodeIdGenerator)
+          .tableScan(
+              kLineitem,
+              lineitemSelectedRowType,
+              lineitemFileColumns,
+              {shipDateFilter})
+          .capturePlanNodeId(lineitemScanNodeId)
+          .partialAggregation(
+              {"l_partkey", "l_suppkey"}, {"sum(l_quantity) AS sum_quantity"})
+          .localPartition({"l_partkey", "l_suppkey"})
+          .finalAggregation()
+          .project(
+              {"l_partkey",
+               "l_suppkey",
+               "0.5 * sum_quantity AS quantity_threshold"})
+          .hashJoin(
+              {"l_partkey", "l_suppkey"},
+              {"ps_partkey", "ps_suppkey"},
+              partsuppJoinPart,
+              "cast(ps_availqty AS DOUBLE) > quantity_threshold",
+              {"ps_suppkey"})
+          .planNode();
+
+  auto nation = PlanBuilder(planNodeIdGenerator)
+                    .tableScan(
+                        kNation,
+                        nationSelectedRowType,
+                        nationFileColumns,
+                        {"n_name = 'CANADA'"})
+                    .capturePlanNodeId(nationScanNodeId)
+                    .planNode();
+
+  auto plan =
+      PlanBuilder(planNodeIdGenerator)
+          .tableScan(kSupplier, supplierSelectedRowType, supplierFileColumns)
+          .capturePlanNodeId(supplierScanNodeId)
+          .hashJoin(
+              {"s_nationkey"},
+              {"n_nationkey"},
+              nation,
+              "",
+              {"s_suppkey", "s_name", "s_address"})
+          .hashJoin(
+              {"s_suppkey"},
+              {"ps_suppkey"},
+              availableSuppliers,
+              "",
+              {"s_name", "s_address"},
+              core::JoinType::kLeftSemi)
+          .localPartition({})
+          .orderBy({"s_name"}, false)
+          .planNode();
+
+  TpchPlan context;
+  context.plan = std::move(plan);
+  context.dataFiles[supplierScanNodeId] = getTableFilePaths(kSupplier);
+  context.dataFiles[nationScanNodeId] = getTableFilePaths(kNation);
+  context.dataFiles[partsuppScanNodeId] = getTableFilePaths(kPartsupp);
+  context.dataFiles[partScanNodeId] = getTableFilePaths(kPart);
+  context.dataFiles[lineitemScanNodeId] = getTableFilePaths(kLineitem);
+  context.dataFileFormat = format_;
+  return context;
+}
+
+TpchPlan TpchQueryBuilder::getQ21Plan() const {
+  std::vector<std::string> supplierColumns = {
+      "s_suppkey", "s_name", "s_nationkey"};
+  std::vector<std::string> lineitemColumns = {
+      "l_orderkey", "l_suppkey", "l_receiptdate", "l_commitdate"};
+  std::vector<std::string> allLineitemColumns = {"l_orderkey", "l_suppkey"};
+  std::vector<std::string> ordersColumns = {"o_orderkey", "o_orderstatus"};
+  std::vector<std::string> nationColumns = {"n_nationkey", "n_name"};
+
+  auto supplierSelectedRowType = getRowType(kSupplier, supplierColumns);
+  const auto& supplierFileColumns = getFileColumnNames(kSupplier);
+  auto lineitemSelectedRowType = getRowType(kLineitem, lineitemColumns);
+  auto allLineitemSelectedRowType = getRowType(kLineitem, allLineitemColumns);
+  const auto& lineitemFileColumns = getFileColumnNames(kLineitem);
+  auto ordersSelectedRowType = getRowType(kOrders, ordersColumns);
+  const auto& ordersFileColumns = getFileColumnNames(kOrders);
+  auto nationSelectedRowType = getRowType(kNation, nationColumns);
+  const auto& nationFileColumns = getFileColumnNames(kNation);
+
+  const std::string lateFilter = "l_receiptdate > l_commitdate";
+
+  auto planNodeIdGenerator = std::make_shared<PlanNodeIdGenerator>();
+  core::PlanNodeId supplierScanNodeId;
+  core::PlanNodeId lineitemScanNodeId;
+  core::PlanNodeId multiSupplierLineitemScanNodeId;
+  core::PlanNodeId lateLineitemScanNodeId;
+  core::PlanNodeId ordersScanNodeId;
+  core::PlanNodeId nationScanNodeId;
+
+  // EXISTS a line of another supplier holds for the orders with more than
+  // one supplier. NOT EXISTS a late line of another supplier holds, for a
+  // late line, for the orders whose late lines all have one supplier.
+  auto multiSupplierOrders =
+      PlanBuilder(planNodeIdGenerator)
+          .tableScan(
+              kLineitem, allLineitemSelectedRowType, lineitemFileColumns)
+          .capturePlanNodeId(multiSupplierLineitemScanNodeId)
+          .partialAggregation({"l_orderkey", "l_suppkey"}, {})
+          .localPartition({"l_orderkey"})
+          .finalAggregation()
+          .singleAggregation({"l_orderkey"}, {"count(0) AS num_suppliers"})
+          .filter("num_suppliers > 1")
+          .project({"l_orderkey AS multi_orderkey"})
+          .planNode();
+
+  auto singleLateSupplierOrders =
+      PlanBuilder(planNodeIdGenerator)
+          .tableScan(
+              kLineitem,
+              lineitemSelectedRowType,
+              lineitemFileColumns,
+              {},
+              lateFilter)
+          .capturePlanNodeId(lateLineitemScanNodeId)
+          .partialAggregation({"l_orderkey", "l_suppkey"}, {})
+          .localPartition({"l_orderkey"})
+          .finalAggregation()
+          .singleAggregation({"l_orderkey"}, {"count(0) AS num_suppliers"})
+          .filter("num_suppliers = 1")
+          .project({"l_orderkey AS late_orderkey"})
+          .planNode();
+
+  auto nation = PlanBuilder(planNodeIdGenerator)
+                    .tableScan(
+                        kNation,
+                        nationSelectedRowType,
+                        nationFileColumns,
+                        {"n_name = 'SAUDI ARABIA'"})
+                    .capturePlanNodeId(nationScanNodeId)
+                    .planNode();
+
+  auto supplierJoinNation =
+      PlanBuilder(planNodeIdGenerator)
+          .tableScan(kSupplier, supplierSelectedRowType, supplierFileColumns)
+          .capturePlanNodeId(supplierScanNodeId)
+          .hashJoin(
+              {"s_nationkey"},
+              {"n_nationkey"},
+              nation,
+              "",
+              {"s_suppkey", "s_name"})
+          .planNode();
+
+  auto orders = PlanBuilder(planNodeIdGenerator)
+                    .tableScan(
+                        kOrders,
+                        ordersSelectedRowType,
+                        ordersFileColumns,
+                        {"o_orderstatus = 'F'"})
+                    .capturePlanNodeId(ordersScanNodeId)
+                    .planNode();
+
+  auto plan =
+      PlanBuilder(planNodeIdGenerator)
+          .tableScan(
+              kLineitem,
+              lineitemSelectedRowType,
+              lineitemFileColumns,
+              {},
+              lateFilter)
+          .capturePlanNodeId(lineitemScanNodeId)
+          .hashJoin(
+              {"l_suppkey"},
+              {"s_suppkey"},
+              supplierJoinNation,
+              "",
+              {"l_orderkey", "s_name"})
+          .hashJoin(
+              {"l_orderkey"},
+              {"o_orderkey"},
+              orders,
+              "",
+              {"l_orderkey", "s_name"})
+          .hashJoin(
+              {"l_orderkey"},
+              {"multi_orderkey"},
+              multiSupplierOrders,
+              "",
+              {"l_orderkey", "s_name"},
+              core::JoinType::kLeftSemi)
+          .hashJoin(
+              {"l_orderkey"},
+              {"late_orderkey"},
+              singleLateSupplierOrders,
+              "",
+              {"s_name"},
+              core::JoinType::kLeftSemi)
+          .partialAggregation({"s_name"}, {"count(0) AS numwait"})
+          .localPartition({})
+          .finalAggregation()
+          .orderBy({"numwait DESC", "s_name"}, false)
+          .limit(0, 100, false)
+          .planNode();
+
+  TpchPlan context;
+  context.plan = std::move(plan);
+  context.dataFiles[supplierScanNodeId] = getTableFilePaths(kSupplier);
+  context.dataFiles[lineitemScanNodeId] = getTableFilePaths(kLineitem);
+  context.dataFiles[multiSupplierLineitemScanNodeId] =
+      getTableFilePaths(kLineitem);
+  context.dataFiles[lateLineitemScanNodeId] = getTableFilePaths(kLineitem);
+  context.dataFiles[ordersScanNodeId] = getTableFilePaths(kOrders);
+  context.dataFiles[nationScanNodeId] = getTableFilePaths(kNation);
+  context.dataFileFormat = format_;
+  return context;
+}
+
+TpchPlan TpchQueryBuilder::getQ22Plan() const {
+  std::vector<std::string> customerColumns = {
+      "c_custkey", "c_phone", "c_acctbal"};
+  std::vector<std::string> avgCustomerColumns = {"c_phone", "c_acctbal"};
+  std::vector<std::string> ordersColumns = {"o_custkey"};
+
+  auto customerSelectedRowType = getRowType(kCustomer, customerColumns);
+  auto avgCustomerSelectedRowType = getRowType(kCustomer, avgCustomerColumns);
+  const auto& customerFileColumns = getFileColumnNames(kCustomer);
+  auto ordersSelectedRowType = getRowType(kOrders, ordersColumns);
+  const auto& ordersFileColumns = getFileColumnNames(kOrders);
+
+  const std::string countryCodeFilter =
+      "substr(c_phone, 1, 2) IN ('13', '31', '23', '29', '30', '18', '17')";
+
+  auto planNodeIdGenerator = std::make_shared<PlanNodeIdGenerator>();
+  core::PlanNodeId customerScanNodeId;
+  core::PlanNodeId avgCustomerScanNodeId;
+  core::PlanNodeId ordersScanNodeId;
+
+  auto avgBalance = PlanBuilder(planNodeIdGenerator, pool_.get())
+                        .tableScan(
+                            kCustomer,
+                            avgCustomerSelectedRowType,
+                            customerFileColumns,
+                            {"c_acctbal > 0.0"},
+                            countryCodeFilter)
+                        .capturePlanNodeId(avgCustomerScanNodeId)
+                        .partialAggregation(
+                            {}, {"avg(c_acctbal) AS avg_acctbal"})
+                        .localPartition({})
+                        .finalAggregation()
+                        .planNode();
+
+  auto orders =
+      PlanBuilder(planNodeIdGenerator)
+          .tableScan(kOrders, ordersSelectedRowType, ordersFileColumns)
+          .capturePlanNodeId(ordersScanNodeId)
+          .planNode();
+
+  auto plan =
+      PlanBuilder(planNodeIdGenerator, pool_.get())
+          .tableScan(
+              kCustomer,
+              customerSelectedRowType,
+              customerFileColumns,
+              {},
+              countryCodeFilter)
+          .capturePlanNodeId(customerScanNodeId)
+          .crossJoin(
+              avgBalance, {"c_custkey", "c_phone", "c_acctbal", "avg_acctbal"})
+          .filter("c_acctbal > avg_acctbal")
+          .hashJoin(
+              {"c_custkey"},
+              {"o_custkey"},
+              orders,
+              "",
+              {"c_phone", "c_acctbal"},
+              core::JoinType::kAnti)
+          .project({"substr(c_phone, 1, 2) AS cntrycode", "c_acctbal"})
+          .partialAggregation(
+              {"cntrycode"},
+              {"count(0) AS numcust", "sum(c_acctbal) AS totacctbal"})
+          .localPartition({})
+          .finalAggregation()
+          .orderBy({"cntrycode"}, false)
+          .planNode();
+
+  TpchPlan context;
+  context.plan = std::move(plan);
+  context.dataFiles[customerScanNodeId] = getTableFilePaths(kCustomer);
+  context.dataFiles[avgCustomerScanNodeId] = getTableFilePaths(kCustomer);
+  context.dataFiles[ordersScanNodeId] = getTableFilePaths(kOrders);
+  context.dataFileFormat = format_;
+  return context;
+}
+
+const std::vector<std::string> TpchQueryBuilder::kTableNames_ = {
+    kLineitem,
+    kOrders,
+    kCustomer,
+    kNation,
+    kRegion,
+    kPart,
+    kSupplier,
+    kPartsupp};
 
 const std::unordered_map<std::string, std::vector<std::string>>
     TpchQueryBuilder::kTables_ = {
@@ -926,6 +2363,9 @@ const std::unordered_map<std::string, std::vector<std::string>>
             tpch::getTableSchema(tpch::Table::TBL_PART)->names()),
         std::make_pair(
             "supplier",
-            tpch::getTableSchema(tpch::Table::TBL_SUPPLIER)->names())};
+            tpch::getTableSchema(tpch::Table::TBL_SUPPLIER)->names()),
+        std::make_pair(
+            "partsupp",
+            tpch::getTableSchema(tpch::Table::TBL_PARTSUPP)->names())};
 
 } // namespace facebook::velox::exec::test
@@ -45,7 +45,7 @@ struct TpchTableMetadata {
 /// is, the top-level directory is expected to contain a sub-directory per table
 /// name and the name of the sub-directory must match the table name. Example:
 /// ls -R data/
-///  customer   lineitem
+///  customer   lineitem   nation   orders   part   partsupp   region   supplier
 ///
 ///  data/customer:
 ///  customer1.parquet  customer2.parquet
@@ -68,7 +68,9 @@ class TpchQueryBuilder {
   /// @param dataPath path to the data files
   void initialize(const std::string& dataPath);
 
-  /// Get the query plan for a given TPC-H query number.
+  /// Get the query plan for a given TPC-H query number. All 22 queries are
+  /// supported. Correlated subqueries are decorrelated into joins and
+  /// aggregations.
   /// @param queryId TPC-H query number
   TpchPlan getQueryPlan(int queryId) const;
 
@@ -77,15 +79,27 @@ class TpchQueryBuilder {
 
  private:
   TpchPlan getQ1Plan() const;
+  TpchPlan getQ2Plan() const;
   TpchPlan getQ3Plan() const;
+  TpchPlan getQ4Plan() const;
   TpchPlan getQ5Plan() const;
   TpchPlan getQ6Plan() const;
+  TpchPlan getQ7Plan() const;
+  TpchPlan getQ8Plan() const;
+  TpchPlan getQ9Plan() const;
   TpchPlan getQ10Plan() const;
+  TpchPlan getQ11Plan() const;
   TpchPlan getQ12Plan() const;
   TpchPlan getQ13Plan() const;
   TpchPlan getQ14Plan() const;
+  TpchPlan getQ15Plan() const;
+  TpchPlan getQ16Plan() const;
+  TpchPlan getQ17Plan() const;
   TpchPlan getQ18Plan() const;
   TpchPlan getQ19Plan() const;
+  TpchPlan getQ20Plan() const;
+  TpchPlan getQ21Plan() const;
+  TpchPlan getQ22Plan() const;
 
   const std::vector<std::string>& getTableFilePaths(
       const std::string& tableName) const {
@@ -118,6 +132,7 @@ class TpchQueryBuilder {
   static constexpr const char* kRegion = "region";
   static constexpr const char* kPart = "part";
   static constexpr const char* kSupplier = "supplier";
+  static constexpr const char* kPartsupp = "partsupp";
   std::unique_ptr<memory::ScopedMemoryPool> pool_ =
       memory::getDefaultScopedMemoryPool();
 };
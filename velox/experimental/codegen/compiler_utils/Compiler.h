@@ -14,6 +14,7 @@
  * limitations under the License.
  */
 #pragma once
+#include <folly/hash/SpookyHashV2.h>
 #include "glog/logging.h"
 #include "velox/common/base/Exceptions.h"
 #include "velox/experimental/codegen/compiler_utils/CompilerOptions.h"
@@ -189,6 +190,62 @@ class Compiler {
     return dynamicLibPath;
   }
 
+  /// Compiles a given c++ string and links it into a dynamic library. When
+  /// CompilerOptions::cacheDirectory is set, the library is stored there under
+  /// a key computed from the source and the compile and link commands, and
+  /// later calls with the same key return the cached library without running
+  /// the compiler. The cache survives process restarts.
+  /// \param additionalLibraries
+  /// \param cppContent c++ file content
+  /// \return path to the generated .so
+  std::filesystem::path compileAndLinkString(
+      const std::vector<LibraryDescriptor>& additionalLibraries,
+      const std::string& cppContent) {
+    if (!compilerOptions_.cacheDirectory.has_value()) {
+      auto objectPath = compileString(additionalLibraries, cppContent);
+      return link(additionalLibraries, {objectPath});
+    }
+
+    const auto& cacheDirectory = compilerOptions_.cacheDirectory.value();
+    auto cachedPath = cacheDirectory /
+        fmt::format("{}.so", cacheKey(additionalLibraries, cppContent));
+    if (std::filesystem::exists(cachedPath)) {
+      DefaultScopedTimer timer("CompileCacheHit", eventSequence_);
+      return cachedPath;
+    }
+
+    auto objectPath = compileString(additionalLibraries, cppContent);
+    std::filesystem::create_directories(cacheDirectory);
+    // Link into a temporary file of the cache directory and rename it, so that
+    // concurrent compilations of the same code never expose a partial file.
+    auto tempPath = pathGenerator_.tempPath(cacheDirectory, "dyn", ".so");
+    link(additionalLibraries, {objectPath}, tempPath);
+    std::filesystem::rename(tempPath, cachedPath);
+    return cachedPath;
+  }
+
+  /// Returns the key of the compiled library of 'cppContent' in the compile
+  /// cache. The key covers the compiler, the flags and the libraries, so
+  /// changing any of them recompiles. It does not cover the content of the
+  /// included headers: the cache directory must be cleared when they change.
+  std::string cacheKey(
+      const std::vector<LibraryDescriptor>& additionalLibraries,
+      const std::string& cppContent) {
+    auto compile = compileCommand(additionalLibraries, "source.cpp", "source.o")
+                       .toString(" ");
+    auto link = linkCommand(additionalLibraries, {"source.o"}, "dyn.so")
+                    .toString(" ");
+    uint64_t hash1 = 0;
+    uint64_t hash2 = 0;
+    folly::hash::SpookyHashV2 hasher;
+    hasher.Init(hash1, hash2);
+    hasher.Update(cppContent.data(), cppContent.size());
+    hasher.Update(compile.data(), compile.size());
+    hasher.Update(link.data(), link.size());
+    hasher.Final(&hash1, &hash2);
+    return fmt::format("{:016x}{:016x}", hash1, hash2);
+  }
+
   /// Construct a command object which execution would compile the give files.
   /// \param additionalLibraries
   /// \param cppFile
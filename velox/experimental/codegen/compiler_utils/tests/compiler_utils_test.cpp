@@ -15,6 +15,7 @@
  */
 
 #include <dlfcn.h>
+#include <unistd.h>
 #include <gtest/gtest.h>
 #include <fstream>
 #include <iostream>
@@ -290,4 +291,46 @@ TEST(Compiler, CompileAndLink) {
   ASSERT_EQ(dlerror(), nullptr);
   ASSERT_EQ(f(), 24);
 };
+
+TEST(Compiler, CompileCache) {
+  auto sourceCode = R"a(
+  extern "C" {
+  int f() {
+    return 24;
+  };
+  }
+  )a";
+
+  auto cacheDirectory = std::filesystem::temp_directory_path() /
+      fmt::format("codegen_cache_{}", getpid());
+  std::filesystem::remove_all(cacheDirectory);
+  auto options = testCompilerOptions().withCacheDirectory(cacheDirectory);
+
+  DefaultScopedTimer::EventSequence eventSequence;
+  Compiler compiler(options, eventSequence);
+
+  auto sharedObject = compiler.compileAndLinkString({}, sourceCode);
+  ASSERT_EQ(cacheDirectory, sharedObject.parent_path());
+  ASSERT_GT(std::filesystem::file_size(sharedObject), 0);
+  auto libraryPtr =
+      native_loader::NativeLibraryLoader::loadLibraryInternal(sharedObject);
+  auto f = (int (*)())dlsym(libraryPtr, "f");
+  ASSERT_EQ(f(), 24);
+
+  // A new compiler with the same options finds the library in the cache.
+  Compiler newCompiler(options, eventSequence);
+  auto modificationTime = std::filesystem::last_write_time(sharedObject);
+  ASSERT_EQ(sharedObject, newCompiler.compileAndLinkString({}, sourceCode));
+  ASSERT_EQ(modificationTime, std::filesystem::last_write_time(sharedObject));
+
+  // Different flags give a different key.
+  auto otherOptions = options;
+  otherOptions.withOptimizationLevel("-O0");
+  Compiler otherCompiler(otherOptions, eventSequence);
+  ASSERT_NE(
+      compiler.cacheKey({}, sourceCode),
+      otherCompiler.cacheKey({}, sourceCode));
+
+  std::filesystem::remove_all(cacheDirectory);
+}
 } // namespace facebook::velox::codegen::compiler_utils::test
@@ -16,15 +16,18 @@
 
 #include "velox/expression/CastExpr.h"
 
+#include <limits>
 #include <stdexcept>
 
 #include <fmt/format.h>
+#include <folly/Conv.h>
 
 #include <velox/common/base/VeloxException.h>
 #include "velox/common/base/Exceptions.h"
 #include "velox/core/CoreTypeSystem.h"
 #include "velox/expression/StringWriter.h"
 #include "velox/external/date/tz.h"
+#include "velox/type/TimeZoneOffsets.h"
 #include "velox/vector/ComplexVector.h"
 #include "velox/vector/FunctionVector.h"
 #include "velox/vector/SelectivityVector.h"
@@ -98,6 +101,191 @@ std::string makeErrorMessage(
       input.base()->toString(input.index(row)));
 }
 
+// True for the casts that commonly fail on dirty data and can detect
+// failures without exceptions: VARCHAR to integer and floating point types.
+template <typename To, typename From>
+constexpr bool kHasNoThrowCast = std::is_same_v<From, StringView> &&
+    std::is_arithmetic_v<To> && !std::is_same_v<To, bool>;
+
+// True if the 8 bytes of 'chunk' are all ASCII digits.
+inline bool isEightDigits(uint64_t chunk) {
+  return (chunk & 0xF0F0F0F0F0F0F0F0) == 0x3030303030303030 &&
+      ((chunk + 0x0606060606060606) & 0xF0F0F0F0F0F0F0F0) ==
+      0x3030303030303030;
+}
+
+// Returns the value of the 8 ASCII digits in 'chunk', first digit in the
+// lowest byte. Combines pairs of digits, then pairs of pairs, with
+// multiplications on the whole word.
+inline uint64_t parseEightDigits(uint64_t chunk) {
+  chunk -= 0x3030303030303030;
+  chunk = (chunk * 10) + (chunk >> 8);
+  return (((chunk & 0x000000FF000000FF) * (100 + (1000000ULL << 32))) +
+          (((chunk >> 16) & 0x000000FF000000FF) * (1 + (10000ULL << 32)))) >>
+      32;
+}
+
+// Parses an optional '-' followed by up to 18 ASCII digits, which covers
+// almost all integers in practice and can not overflow int64_t. Returns
+// false for anything else, e.g. whitespace, a '+' sign, a value out of the
+// range of 'T' or an invalid value, which are left to folly.
+template <typename T>
+bool parseSimpleInteger(const StringView& input, T& result) {
+  static_assert(folly::kIsLittleEndian);
+  const char* data = input.data();
+  int32_t size = input.size();
+  const bool negative = size > 0 && data[0] == '-';
+  data += negative;
+  size -= negative;
+  if (size == 0 || size > 18) {
+    return false;
+  }
+  uint64_t value = 0;
+  for (; size >= 8; size -= 8, data += 8) {
+    uint64_t chunk;
+    std::memcpy(&chunk, data, sizeof(chunk));
+    if (!isEightDigits(chunk)) {
+      return false;
+    }
+    value = value * 100'000'000 + parseEightDigits(chunk);
+  }
+  for (; size > 0; --size, ++data) {
+    const uint8_t digit = *data - '0';
+    if (digit > 9) {
+      return false;
+    }
+    value = value * 10 + digit;
+  }
+  const int64_t signedValue =
+      negative ? -static_cast<int64_t>(value) : static_cast<int64_t>(value);
+  if (signedValue < std::numeric_limits<T>::min() ||
+      signedValue > std::numeric_limits<T>::max()) {
+    return false;
+  }
+  result = signedValue;
+  return true;
+}
+
+// Parses an optional '-', digits and optionally '.' and more digits. Returns
+// false unless the digits, read as an integer, and the power of ten to
+// divide them by are exact in 'T'. The quotient is then the correctly
+// rounded value. Leaves exponents, special values, long mantissas and
+// invalid values to folly.
+template <typename T>
+bool parseSimpleFloatingPoint(const StringView& input, T& result) {
+  // Largest integer and power of ten that are exact in 'T'.
+  constexpr uint64_t kMaxMantissa = 1ULL << std::numeric_limits<T>::digits;
+  constexpr int32_t kMaxPower = std::is_same_v<T, float> ? 10 : 22;
+  static constexpr T kPowersOfTen[] = {
+      1e0,  1e1,  1e2,  1e3,  1e4,  1e5,  1e6,  1e7,  1e8,  1e9,  1e10, 1e11,
+      1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22};
+
+  const char* data = input.data();
+  const char* end = data + input.size();
+  const bool negative = data < end && *data == '-';
+  data += negative;
+  uint64_t mantissa = 0;
+  int32_t numDigits = 0;
+  int32_t numFractionDigits = 0;
+  bool hasDot = false;
+  for (; data < end; ++data) {
+    const uint8_t digit = *data - '0';
+    if (digit <= 9) {
+      // 19 digits can not overflow uint64_t.
+      if (++numDigits > 19) {
+        return false;
+      }
+      mantissa = mantissa * 10 + digit;
+      numFractionDigits += hasDot;
+    } else if (*data == '.' && !hasDot && numDigits > 0) {
+      hasDot = true;
+    } else {
+      return false;
+    }
+  }
+  if (numDigits == 0 || (hasDot && numFractionDigits == 0) ||
+      mantissa > kMaxMantissa || numFractionDigits > kMaxPower) {
+    return false;
+  }
+  const T value = static_cast<T>(mantissa) / kPowersOfTen[numFractionDigits];
+  result = negative ? -value : value;
+  return true;
+}
+
+// Writes the decimal digits of 'value' so that they end at 'end'. Returns
+// the first character. 'end' must have 20 characters before it.
+template <typename T>
+char* writeDecimal(T value, char* end) {
+  static constexpr char kDigitPairs[] =
+      "0001020304050607080910111213141516171819"
+      "2021222324252627282930313233343536373839"
+      "4041424344454647484950515253545556575859"
+      "6061626364656667686970717273747576777879"
+      "8081828384858687888990919293949596979899";
+  using U = std::make_unsigned_t<T>;
+  U magnitude = value < 0 ? U(0) - static_cast<U>(value) : value;
+  while (magnitude >= 100) {
+    const auto pair = (magnitude % 100) * 2;
+    magnitude /= 100;
+    *--end = kDigitPairs[pair + 1];
+    *--end = kDigitPairs[pair];
+  }
+  if (magnitude >= 10) {
+    *--end = kDigitPairs[magnitude * 2 + 1];
+    *--end = kDigitPairs[magnitude * 2];
+  } else {
+    *--end = '0' + magnitude;
+  }
+  if (value < 0) {
+    *--end = '-';
+  }
+  return end;
+}
+
+// Converts 'input' like util::Converter<To, void, Truncate>::cast() but
+// without throwing. Returns false if 'input' is not a valid 'To'. Sets
+// 'error' to the message of the exception the conversion would throw.
+template <typename To, bool Truncate>
+bool tryCastFromString(
+    const StringView& input,
+    To& result,
+    std::string& error) {
+  if constexpr (Truncate && std::is_integral_v<To>) {
+    bool nullOutput = false;
+    result = util::Converter<CppToType<To>::typeKind, void, true>::
+        convertStringToInt(folly::StringPiece(input), nullOutput);
+    return !nullOutput;
+  } else {
+    if constexpr (std::is_integral_v<To>) {
+      if (parseSimpleInteger(input, result)) {
+        return true;
+      }
+    } else {
+      if (parseSimpleFloatingPoint(input, result)) {
+        return true;
+      }
+    }
+    auto parsed = folly::parseTo(folly::StringPiece(input), result);
+    if (parsed.hasError()) {
+      error = folly::makeConversionError(
+                  parsed.error(), folly::StringPiece(input))
+                  .what();
+      return false;
+    }
+    // Like folly::to(), allows only whitespace after the value.
+    const auto remaining = parsed.value();
+    for (auto c : remaining) {
+      if (!std::isspace(c)) {
+        error = folly::makeConversionError(
+                    folly::ConversionCode::NON_WHITESPACE_AFTER_END, remaining)
+                    .what();
+        return false;
+      }
+    }
+    return true;
+  }
+}
+
 } // namespace
 
 template <typename To, typename From>
@@ -109,6 +297,57 @@ void CastExpr::applyCastWithTry(
   const auto& queryConfig = context.execCtx()->queryCtx()->config();
   auto isCastIntByTruncate = queryConfig.isCastIntByTruncate();
 
+  if constexpr (kHasNoThrowCast<To, From>) {
+    // Invalid values are reported without exceptions, so that TRY(CAST(...))
+    // and TRY_CAST over dirty data cost about as much as over clean data.
+    auto castRows = [&](auto truncate) {
+      constexpr bool kTruncate = decltype(truncate)::value;
+      rows.applyToSelected([&](int row) {
+        const auto value = input.valueAt<StringView>(row);
+        To result;
+        std::string error;
+        if (tryCastFromString<To, kTruncate>(value, result, error)) {
+          resultFlatVector->set(row, result);
+        } else if (nullOnFailure_) {
+          resultFlatVector->setNull(row, true);
+        } else {
+          context.setUserError(row, [&]() {
+            return makeErrorMessage(input, row, resultFlatVector->type()) +
+                " " + error;
+          });
+        }
+      });
+    };
+    if (isCastIntByTruncate) {
+      castRows(std::true_type{});
+    } else {
+      castRows(std::false_type{});
+    }
+    return;
+  }
+
+  if constexpr (
+      std::is_same_v<To, StringView> && std::is_integral_v<From> &&
+      !std::is_same_v<From, bool>) {
+    // Integers can not fail to cast to VARCHAR. Most are short enough to be
+    // inlined in the StringView and need no string buffer.
+    char buffer[20];
+    char* const end = buffer + sizeof(buffer);
+    rows.applyToSelected([&](int row) {
+      const char* begin = writeDecimal(input.valueAt<From>(row), end);
+      const size_t size = end - begin;
+      if (size <= StringView::kInlineSize) {
+        resultFlatVector->setNoCopy(row, StringView(begin, size));
+      } else {
+        auto writer = exec::StringWriter<>(resultFlatVector, row);
+        writer.resize(size);
+        std::memcpy(writer.data(), begin, size);
+        writer.finalize();
+      }
+    });
+    return;
+  }
+
   if (!nullOnFailure_) {
     if (!isCastIntByTruncate) {
       context.applyToSelectedNoThrow(rows, [&](int row) {
@@ -200,11 +439,16 @@ void CastExpr::applyCastWithTry(
       if (!sessionTzName.empty()) {
         // locate_zone throws runtime_error if the timezone couldn't be found
         // (so we're safe to dereference the pointer).
-        auto* timeZone = date::locate_zone(sessionTzName);
+        const auto& offsets =
+            TimeZoneOffsets::get(*date::locate_zone(sessionTzName));
         auto rawTimestamps = resultFlatVector->mutableRawValues();
 
-        rows.applyToSelected(
-            [&](int row) { rawTimestamps[row].toGMT(*timeZone); });
+        if (rows.isAllSelected()) {
+          offsets.toGMT(rawTimestamps, rows.size());
+        } else {
+          rows.applyToSelected(
+              [&](int row) { offsets.toGMT(rawTimestamps[row]); });
+        }
       }
     }
   }
@@ -16,6 +16,8 @@
 
 #pragma once
 #include <folly/Likely.h>
+#include <cstring>
+#include <iterator>
 #include <optional>
 #include <tuple>
 #include <utility>
@@ -76,6 +78,23 @@ template <typename V>
 bool constexpr requires_commit =
     !provide_std_interface<V> || std::is_same<bool, V>::value;
 
+// True if values of V can be appended to their FlatVector with memcpy.
+template <typename V>
+bool constexpr provide_bulk_append =
+    provide_std_interface<V> && !std::is_same<bool, V>::value;
+
+// True if T stores its values of type E contiguously, e.g. std::vector<E>.
+template <typename T, typename E, typename = void>
+struct is_contiguous_of : std::false_type {};
+
+template <typename T, typename E>
+struct is_contiguous_of<
+    T,
+    E,
+    std::enable_if_t<std::is_same_v<
+        std::decay_t<decltype(*std::data(std::declval<const T&>()))>,
+        E>>> : std::true_type {};
+
 // The object passed to the simple function interface that represent a single
 // array entry.
 template <typename V>
@@ -189,11 +208,28 @@ class ArrayWriter {
     add_items(data);
   }
 
+  // Appends 'count' not null values from 'data' with one memcpy.
+  void add_items(const element_t* data, vector_size_t count) {
+    static_assert(
+        provide_bulk_append<V>, "add_items not allowed for this array");
+    auto start = valuesOffset_ + length_;
+    resize(length_ + count);
+    if (count > 0) {
+      std::memcpy(
+          elementsVector_->mutableRawValues() + start,
+          data,
+          count * sizeof(element_t));
+      elementsVector_->clearNulls(start, start + count);
+    }
+  }
+
   // Any vector type with std-like optional-free interface.
   template <typename VectorType>
   void add_items(const VectorType& data) {
-    if constexpr (provide_std_interface<V>) {
-      // TODO: accelerate this with memcpy.
+    if constexpr (
+        provide_bulk_append<V> && is_contiguous_of<VectorType, element_t>{}) {
+      add_items(std::data(data), std::size(data));
+    } else if constexpr (provide_std_interface<V>) {
       auto start = length_;
       resize(length_ + data.size());
       for (auto i = 0; i < data.size(); i++) {
@@ -335,6 +371,31 @@ class MapWriter {
     return length_;
   }
 
+  // Appends 'count' entries with not null values from 'keys' and 'values',
+  // each with one memcpy.
+  void add_items(
+      const key_element_t* keys,
+      const value_element_t* values,
+      vector_size_t count) {
+    static_assert(
+        provide_bulk_append<K> && provide_bulk_append<V>,
+        "add_items not allowed for this map");
+    auto start = innerOffset_ + length_;
+    resize(length_ + count);
+    if (count > 0) {
+      std::memcpy(
+          keysVector_->mutableRawValues() + start,
+          keys,
+          count * sizeof(key_element_t));
+      keysVector_->clearNulls(start, start + count);
+      std::memcpy(
+          valuesVector_->mutableRawValues() + start,
+          values,
+          count * sizeof(value_element_t));
+      valuesVector_->clearNulls(start, start + count);
+    }
+  }
+
   // Any map type iteratable in tuple like manner.
   template <typename MapType>
   void copy_from(const MapType& data) {
@@ -121,6 +121,14 @@ void ConjunctExpr::evalSpecialForm(
   VarSetter isFinalSelectionOr(
       context.mutableIsFinalSelection(), false, !isAnd_);
 
+  if (!reorderEnabledChecked_) {
+    reorderEnabled_ = context.execCtx()
+                          ->queryCtx()
+                          ->config()
+                          .adaptiveFilterReorderingEnabled();
+    reorderEnabledChecked_ = true;
+  }
+
   bool handleErrors = false;
   LocalSelectivityVector errorRows(context);
   LocalSelectivityVector activeRowsHolder(context, rows);
@@ -141,7 +149,10 @@ void ConjunctExpr::evalSpecialForm(
         static_cast<const SelectivityVector*>(activeRows),
         isAnd_ && context.isFinalSelection());
 
-    SelectivityTimer timer(selectivity_[inputOrder_[i]], numActive);
+    std::optional<SelectivityTimer> timer;
+    if (reorderEnabled_) {
+      timer.emplace(selectivity_[inputOrder_[i]], numActive);
+    }
     inputs_[inputOrder_[i]]->eval(*activeRows, context, inputResult);
     if (context.errors()) {
       handleErrors = true;
@@ -160,7 +171,9 @@ void ConjunctExpr::evalSpecialForm(
       activeRows->updateBounds();
     }
     numActive = activeRows->countSelected();
-    selectivity_[inputOrder_[i]].addOutput(numActive);
+    if (reorderEnabled_) {
+      selectivity_[inputOrder_[i]].addOutput(numActive);
+    }
 
     if (!numActive) {
       break;
@@ -168,19 +181,24 @@ void ConjunctExpr::evalSpecialForm(
   }
   // Clear errors for 'rows' that are not in 'activeRows'.
   finalizeErrors(rows, *activeRows, throwOnError, context);
-  if (!reorderEnabledChecked_) {
-    reorderEnabled_ = context.execCtx()
-                          ->queryCtx()
-                          ->config()
-                          .adaptiveFilterReorderingEnabled();
-    reorderEnabledChecked_ = true;
-  }
-  if (reorderEnabled_) {
+  if (reorderEnabled_ && numEvals_++ % kReorderInterval == 0) {
     maybeReorderInputs();
   }
 }
 
 void ConjunctExpr::maybeReorderInputs() {
+  bool decay = false;
+  for (auto& selectivity : selectivity_) {
+    if (selectivity.numIn() > kMaxHistoryRows) {
+      decay = true;
+      break;
+    }
+  }
+  if (decay) {
+    for (auto& selectivity : selectivity_) {
+      selectivity.decay();
+    }
+  }
   bool reorder = false;
   for (auto i = 1; i < inputs_.size(); ++i) {
     if (selectivity_[inputOrder_[i - 1]].timeToDropValue() >
@@ -15,6 +15,8 @@
  */
 #pragma once
 
+#include <optional>
+
 #include "velox/common/base/SelectivityInfo.h"
 #include "velox/expression/SpecialForm.h"
 
@@ -51,7 +53,18 @@ class ConjunctExpr : public SpecialForm {
     return selectivity_[inputOrder_[index]];
   }
 
+  /// Number of evaluations between checks of the input order. The first
+  /// check is after the first evaluation.
+  static constexpr int32_t kReorderInterval = 8;
+
+  /// Once an input has seen this many rows, the history of all inputs is
+  /// halved so that the order follows changes in the data.
+  static constexpr uint64_t kMaxHistoryRows = 1 << 20;
+
  private:
+  // Sorts the inputs on increasing time to decide a row, measured from the
+  // rows each input saw and the rows it left undecided. Called every
+  // kReorderInterval evaluations.
   void maybeReorderInputs();
   void updateResult(
       BaseVector* inputResult,
@@ -69,6 +82,10 @@ class ConjunctExpr : public SpecialForm {
   BufferPtr tempNulls_;
   bool reorderEnabledChecked_ = false;
   bool reorderEnabled_;
+  // Number of evaluations with reordering enabled.
+  int64_t numEvals_{0};
+  // Timing and pass rate of each input. Only collected if reordering is
+  // enabled.
   std::vector<SelectivityInfo> selectivity_;
   std::vector<int32_t> inputOrder_;
 };
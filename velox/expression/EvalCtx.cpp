@@ -20,6 +20,26 @@
 
 namespace facebook::velox::exec {
 
+namespace {
+// Returns the dictionary indices equivalent to the run 'lengths' of a
+// SequenceVector of 'size' rows.
+BufferPtr sequenceIndices(
+    const BufferPtr& lengths,
+    vector_size_t size,
+    memory::MemoryPool* pool) {
+  auto indices = AlignedBuffer::allocate<vector_size_t>(size, pool);
+  auto* rawIndices = indices->asMutable<vector_size_t>();
+  auto* rawLengths = lengths->as<vector_size_t>();
+  vector_size_t row = 0;
+  for (vector_size_t run = 0; row < size; ++run) {
+    auto end = std::min(size, row + rawLengths[run]);
+    std::fill(rawIndices + row, rawIndices + end, run);
+    row = end;
+  }
+  return indices;
+}
+} // namespace
+
 ContextSaver::~ContextSaver() {
   if (context) {
     context->restore(*this);
@@ -43,6 +63,26 @@ EvalCtx::EvalCtx(core::ExecCtx* execCtx)
   VELOX_CHECK_NOT_NULL(execCtx);
 }
 
+EvalCtx::~EvalCtx() {
+  for (auto& buffer : scratchBuffers_) {
+    execCtx_->releaseScratchBuffer(std::move(buffer));
+  }
+}
+
+char* EvalCtx::scratchBytes(size_t bytes) {
+  // Keeps every allocation aligned for any value type.
+  bytes = bits::roundUp(bytes, alignof(std::max_align_t));
+  if (scratchBuffers_.empty() ||
+      scratchOffset_ + bytes > scratchBuffers_.back()->capacity()) {
+    scratchBuffers_.push_back(
+        execCtx_->getScratchBuffer(std::max(bytes, kMinScratchBytes)));
+    scratchOffset_ = 0;
+  }
+  auto* result = scratchBuffers_.back()->asMutable<char>() + scratchOffset_;
+  scratchOffset_ += bytes;
+  return result;
+}
+
 void EvalCtx::setWrapped(
     Expr* FOLLY_NONNULL expr,
     VectorPtr source,
@@ -84,6 +124,23 @@ void EvalCtx::setWrapped(
       localResult = BaseVector::wrapInDictionary(
           std::move(nulls), wrap_, rows.end(), std::move(source));
     }
+  } else if (wrapEncoding_ == VectorEncoding::Simple::SEQUENCE) {
+    const auto numRuns = wrap_->size() / sizeof(vector_size_t);
+    if (!source) {
+      localResult =
+          BaseVector::createNullConstant(expr->type(), rows.size(), pool());
+    } else if (source->size() == numRuns) {
+      localResult =
+          BaseVector::wrapInSequence(wrap_, rows.end(), std::move(source));
+    } else {
+      // The peeled result does not have exactly one value per run, e.g. it
+      // was reused from a larger vector. Wrap it in a dictionary instead.
+      localResult = BaseVector::wrapInDictionary(
+          nullptr,
+          sequenceIndices(wrap_, rows.end(), pool()),
+          rows.end(),
+          std::move(source));
+    }
   } else if (wrapEncoding_ == VectorEncoding::Simple::CONSTANT) {
     localResult = BaseVector::wrapInConstant(
         rows.size(), constantWrapIndex_, std::move(source));
@@ -113,10 +170,8 @@ void EvalCtx::saveAndReset(ContextSaver& saver, const SelectivityVector& rows) {
   }
 }
 
-void EvalCtx::addError(
-    vector_size_t index,
-    const std::exception_ptr& exceptionPtr,
-    ErrorVectorPtr& errorsPtr) const {
+bool EvalCtx::prepareErrorAt(vector_size_t index, ErrorVectorPtr& errorsPtr)
+    const {
   auto errors = errorsPtr.get();
   auto oldSize = errors ? errors->size() : 0;
   if (!errors) {
@@ -141,9 +196,50 @@ void EvalCtx::addError(
   for (int32_t i = oldSize; i <= index; ++i) {
     errors->setNull(i, true);
   }
-  if (errors->isNullAt(index)) {
-    errors->setNull(index, false);
-    errors->set(index, std::make_shared<std::exception_ptr>(exceptionPtr));
+  return errors->isNullAt(index);
+}
+
+void EvalCtx::addError(
+    vector_size_t index,
+    const std::exception_ptr& exceptionPtr,
+    ErrorVectorPtr& errorsPtr) const {
+  if (prepareErrorAt(index, errorsPtr)) {
+    errorsPtr->setNull(index, false);
+    errorsPtr->set(index, std::make_shared<std::exception_ptr>(exceptionPtr));
+  }
+}
+
+namespace {
+const std::shared_ptr<void>& errorWithoutDetails() {
+  static const std::shared_ptr<void> kError =
+      std::make_shared<std::exception_ptr>(
+          std::make_exception_ptr(VeloxUserError(
+              __FILE__,
+              __LINE__,
+              __FUNCTION__,
+              "",
+              "Error details are not captured under TRY",
+              error_source::kErrorSourceUser,
+              error_code::kInvalidArgument,
+              false)));
+  return kError;
+}
+} // namespace
+
+void EvalCtx::addErrorWithoutDetails(vector_size_t index) {
+  if (prepareErrorAt(index, errors_)) {
+    errors_->setNull(index, false);
+    errors_->set(index, errorWithoutDetails());
+  }
+}
+
+void EvalCtx::setUserErrorWithMessage(
+    vector_size_t index,
+    const std::string& message) {
+  try {
+    VELOX_USER_FAIL("{}", message);
+  } catch (const VeloxUserError&) {
+    setError(index, std::current_exception());
   }
 }
 
@@ -152,8 +248,15 @@ void EvalCtx::restore(ContextSaver& saver) {
   nullsPruned_ = saver.nullsPruned;
   if (errors_) {
     int32_t errorSize = errors_->size();
-    // A constant wrap has no indices.
-    auto indices = wrap_ ? wrap_->as<vector_size_t>() : nullptr;
+    // A constant wrap has no indices. A sequence wrap has run lengths.
+    BufferPtr sequenceWrapIndices;
+    const vector_size_t* indices = nullptr;
+    if (wrapEncoding_ == VectorEncoding::Simple::SEQUENCE) {
+      sequenceWrapIndices = sequenceIndices(wrap_, saver.rows->end(), pool());
+      indices = sequenceWrapIndices->as<vector_size_t>();
+    } else if (wrap_) {
+      indices = wrap_->as<vector_size_t>();
+    }
     auto wrapNulls = wrapNulls_ ? wrapNulls_->as<uint64_t>() : nullptr;
     SelectivityIterator iter(*saver.rows);
     vector_size_t row;
@@ -185,6 +288,10 @@ void EvalCtx::setError(
   if (throwOnError_) {
     std::rethrow_exception(exceptionPtr);
   }
+  if (!captureErrorDetails_) {
+    addErrorWithoutDetails(index);
+    return;
+  }
   addError(index, exceptionPtr, errors_);
 }
 
@@ -16,6 +16,9 @@
 
 #pragma once
 
+#include <memory>
+#include <typeindex>
+
 #include "velox/common/base/Portability.h"
 #include "velox/core/QueryCtx.h"
 #include "velox/vector/ComplexVector.h"
@@ -39,6 +42,11 @@ class EvalCtx {
   /// For testing only.
   explicit EvalCtx(core::ExecCtx* FOLLY_NONNULL execCtx);
 
+  ~EvalCtx();
+
+  EvalCtx(const EvalCtx&) = delete;
+  EvalCtx& operator=(const EvalCtx&) = delete;
+
   const RowVector* FOLLY_NONNULL row() const {
     return row_;
   }
@@ -83,6 +91,21 @@ class EvalCtx {
       const SelectivityVector& rows,
       const std::exception_ptr& exceptionPtr);
 
+  /// Records a user error for 'index' without the caller throwing. Throws a
+  /// VeloxUserError with the message returned by 'makeMessage' if errors are
+  /// thrown. If the error only nulls out the row, i.e. under TRY with no
+  /// ExprSetListener, marks the row without making an exception or a
+  /// message. Lets functions report errors on dirty data at about the cost
+  /// of a null.
+  template <typename MakeMessage>
+  void setUserError(vector_size_t index, MakeMessage makeMessage) {
+    if (!throwOnError_ && !captureErrorDetails_) {
+      addErrorWithoutDetails(index);
+      return;
+    }
+    setUserErrorWithMessage(index, makeMessage());
+  }
+
   /// Invokes a function on each selected row. Records per-row exceptions by
   /// calling 'setError'. The function must take a single "row" argument of type
   /// vector_size_t and return void.
@@ -127,10 +150,24 @@ class EvalCtx {
     std::swap(errors_, other);
   }
 
+  bool throwOnError() const {
+    return throwOnError_;
+  }
+
   bool* FOLLY_NONNULL mutableThrowOnError() {
     return &throwOnError_;
   }
 
+  /// False if errors of rows are only used to null out the rows, so that the
+  /// exceptions need not be kept. See setUserError().
+  bool captureErrorDetails() const {
+    return captureErrorDetails_;
+  }
+
+  bool* FOLLY_NONNULL mutableCaptureErrorDetails() {
+    return &captureErrorDetails_;
+  }
+
   bool nullsPruned() const {
     return nullsPruned_;
   }
@@ -187,6 +224,14 @@ class EvalCtx {
     wrapNulls_ = std::move(wrapNulls);
   }
 
+  // Sets the run lengths of a SequenceVector as the wrap. Results of the
+  // peeled evaluation are then rewrapped as run-length encoded vectors.
+  void setSequenceWrap(BufferPtr lengths) {
+    wrapEncoding_ = VectorEncoding::Simple::SEQUENCE;
+    wrap_ = std::move(lengths);
+    wrapNulls_ = nullptr;
+  }
+
   // Copy "rows" of localResult into results if "result" is partially populated
   // and must be preserved. Copy localResult pointer into result otherwise.
   void moveOrCopyResult(
@@ -201,6 +246,25 @@ class EvalCtx {
     }
   }
 
+  // Makes 'result' writable for 'rows'. If 'result' is null, takes a recycled
+  // vector from the pool of the ExecCtx instead of allocating.
+  void ensureWritable(
+      const SelectivityVector& rows,
+      const TypePtr& type,
+      VectorPtr& result) {
+    if (!result) {
+      result = execCtx_->getVector(type, rows.size());
+      return;
+    }
+    BaseVector::ensureWritable(rows, type, pool(), &result);
+  }
+
+  // Gives intermediate results no longer needed back for reuse. Vectors
+  // referenced elsewhere are just released.
+  void releaseVectors(std::vector<VectorPtr>& vectors) {
+    execCtx_->releaseVectors(vectors);
+  }
+
   void moveOrCopyResult(
       const VectorPtr& localResult,
       const SelectivityVector& rows,
@@ -208,6 +272,45 @@ class EvalCtx {
     moveOrCopyResult(localResult, rows, *result);
   }
 
+  /// Returns uninitialized space for 'count' values of T that stays valid
+  /// until 'this' is destroyed. Use for temporaries of functions and special
+  /// forms that do not outlive the batch. The space comes from buffers the
+  /// ExecCtx recycles between batches, so it does not allocate once the
+  /// buffers are warm.
+  template <typename T>
+  T* FOLLY_NONNULL scratch(vector_size_t count) {
+    return reinterpret_cast<T*>(scratchBytes(count * sizeof(T)));
+  }
+
+  /// Returns the state of type T that a function evaluated with this context
+  /// derived from the input identified by 'key', or nullptr. Functions use
+  /// this to share work over an input, e.g. the subscript functions build one
+  /// index over the keys of a map vector for all lookups in the map. The
+  /// state must make sure that 'key' keeps identifying the same input for
+  /// the life of the context, e.g. by holding a reference to it.
+  template <typename T>
+  std::shared_ptr<T> sharedState(const void* FOLLY_NONNULL key) const {
+    for (const auto& state : sharedStates_) {
+      if (state.key == key && state.type == std::type_index(typeid(T))) {
+        return std::static_pointer_cast<T>(state.state);
+      }
+    }
+    return nullptr;
+  }
+
+  /// Sets the value returned by sharedState<T>(key).
+  template <typename T>
+  void setSharedState(const void* FOLLY_NONNULL key, std::shared_ptr<T> value) {
+    for (auto& state : sharedStates_) {
+      if (state.key == key && state.type == std::type_index(typeid(T))) {
+        state.state = std::move(value);
+        return;
+      }
+    }
+    sharedStates_.push_back(
+        {key, std::type_index(typeid(T)), std::move(value)});
+  }
+
  private:
   core::ExecCtx* const FOLLY_NONNULL execCtx_;
   ExprSet* FOLLY_NULLABLE const exprSet_;
@@ -226,6 +329,7 @@ class EvalCtx {
   // behavior.
   bool nullsPruned_{false};
   bool throwOnError_{true};
+  bool captureErrorDetails_{true};
 
   // True if the current set of rows will not grow, e.g. not under and IF or OR.
   bool isFinalSelection_{true};
@@ -238,6 +342,38 @@ class EvalCtx {
   // in a opaque flat vector, which will translate to a
   // std::shared_ptr<std::exception_ptr>.
   ErrorVectorPtr errors_;
+
+  struct SharedState {
+    const void* FOLLY_NONNULL key;
+    std::type_index type;
+    std::shared_ptr<void> state;
+  };
+
+  // See sharedState(). There are few, so a vector is enough.
+  std::vector<SharedState> sharedStates_;
+
+  // Minimum size of a buffer taken for scratch().
+  static constexpr size_t kMinScratchBytes = 16 << 10;
+
+  char* FOLLY_NONNULL scratchBytes(size_t bytes);
+
+  // Buffers from ExecCtx::getScratchBuffer(), given back on destruction.
+  // scratch() allocates from the end of the last one.
+  std::vector<BufferPtr> scratchBuffers_;
+  size_t scratchOffset_{0};
+
+  // Makes room for 'index' in '*errorsPtr'. Returns true if 'index' has no
+  // error yet.
+  bool prepareErrorAt(vector_size_t index, ErrorVectorPtr& errorsPtr) const;
+
+  // Sets the error at 'index' to an error shared by all rows whose errors
+  // have no details.
+  void addErrorWithoutDetails(vector_size_t index);
+
+  // Throws or records a VeloxUserError with 'message' for 'index'.
+  void setUserErrorWithMessage(
+      vector_size_t index,
+      const std::string& message);
 };
 
 struct ContextSaver {
@@ -240,7 +240,7 @@ void Expr::evalSimplifiedImpl(
 
     // All rows are null, return a null constant.
     if (!remainingRows.hasSelections()) {
-      inputValues_.clear();
+      context.releaseVectors(inputValues_);
       result =
           BaseVector::createNullConstant(type(), rows.size(), context.pool());
       return;
@@ -253,7 +253,7 @@ void Expr::evalSimplifiedImpl(
 
   // Make sure the returned vector has its null bitmap properly set.
   addNulls(rows, remainingRows.asRange().bits(), context, result);
-  inputValues_.clear();
+  context.releaseVectors(inputValues_);
 }
 
 void Expr::eval(
@@ -406,11 +406,21 @@ SelectivityVector* singleRow(
   return rows;
 }
 
-void setDictionaryWrapping(
+// Sets the wrap for the results of evaluating on peeled vectors. If a single
+// level of run-length encoding was peeled off all rows, the results keep the
+// run lengths of 'firstWrapper'. Otherwise they are wrapped in a dictionary.
+void setPeeledWrapping(
     DecodedVector& decoded,
     const SelectivityVector& rows,
     BaseVector& firstWrapper,
+    int numLevels,
     EvalCtx& context) {
+  if (numLevels == 1 &&
+      firstWrapper.encoding() == VectorEncoding::Simple::SEQUENCE &&
+      rows.isAllSelected() && rows.size() == firstWrapper.size()) {
+    context.setSequenceWrap(firstWrapper.wrapInfo());
+    return;
+  }
   auto wrapping = decoded.dictionaryWrapping(firstWrapper, rows);
   context.setDictionaryWrap(
       std::move(wrapping.indices), std::move(wrapping.nulls));
@@ -543,7 +553,8 @@ Expr::PeelEncodingsResult Expr::peelEncodings(
       *context.mutableFinalSelection() = newFinalSelection;
     }
 
-    setDictionaryWrapping(*decoded, rowsToDecode, *firstWrapper, context);
+    setPeeledWrapping(
+        *decoded, rowsToDecode, *firstWrapper, numLevels, context);
   }
   int numPeeled = 0;
   for (int i = 0; i < peeledVectors.size(); ++i) {
@@ -712,6 +723,31 @@ void deselectErrors(EvalCtx& context, SelectivityVector& rows) {
 }
 } // namespace
 
+Expr::DictionaryCacheEntry* FOLLY_NULLABLE
+Expr::findDictionaryCache(const VectorPtr& base) {
+  for (auto& entry : dictionaryCache_) {
+    if (entry.base == base) {
+      return &entry;
+    }
+  }
+  return nullptr;
+}
+
+Expr::DictionaryCacheEntry& Expr::newDictionaryCache() {
+  if (dictionaryCache_.size() < kMaxDictionaryCacheEntries) {
+    return dictionaryCache_.emplace_back();
+  }
+  auto& entry = *std::min_element(
+      dictionaryCache_.begin(),
+      dictionaryCache_.end(),
+      [](const auto& left, const auto& right) {
+        return left.lastUse < right.lastUse;
+      });
+  entry.base = nullptr;
+  entry.values = nullptr;
+  return entry;
+}
+
 void Expr::evalWithMemo(
     const SelectivityVector& rows,
     EvalCtx& context,
@@ -719,24 +755,22 @@ void Expr::evalWithMemo(
   VectorPtr base;
   distinctFields_[0]->evalSpecialForm(rows, context, base);
   ++numCachableInput_;
-  if (baseDictionary_ == base) {
+  if (auto* entry = findDictionaryCache(base)) {
     ++numCacheableRepeats_;
-    if (cachedDictionaryIndices_) {
-      LocalSelectivityVector cachedHolder(context, rows);
-      auto cached = cachedHolder.get();
-      assert(cached); // lint
-      cached->intersect(*cachedDictionaryIndices_);
-      if (cached->hasSelections()) {
-        BaseVector::ensureWritable(rows, type(), context.pool(), &result);
-        result->copy(dictionaryCache_.get(), *cached, nullptr);
-      }
+    entry->lastUse = numCachableInput_;
+    auto& cachedIndices = entry->indices;
+    LocalSelectivityVector cachedHolder(context, rows);
+    auto cached = cachedHolder.get();
+    assert(cached); // lint
+    cached->intersect(*cachedIndices);
+    if (cached->hasSelections()) {
+      BaseVector::ensureWritable(rows, type(), context.pool(), &result);
+      result->copy(entry->values.get(), *cached, nullptr);
     }
     LocalSelectivityVector uncachedHolder(context, rows);
     auto uncached = uncachedHolder.get();
     assert(uncached); // lint
-    if (cachedDictionaryIndices_) {
-      uncached->deselect(*cachedDictionaryIndices_);
-    }
+    uncached->deselect(*cachedIndices);
     if (uncached->hasSelections()) {
       // Fix finalSelection at "rows" if uncached rows is a strict subset to
       // avoid losing values not in uncached rows.
@@ -749,44 +783,44 @@ void Expr::evalWithMemo(
 
       evalWithNulls(*uncached, context, result);
       deselectErrors(context, *uncached);
-      context.exprSet()->addToMemo(this);
       auto newCacheSize = uncached->end();
 
-      // dictionaryCache_ is valid only for cachedDictionaryIndices_. Hence, a
+      // The cached values are valid only for 'cachedIndices'. Hence, a
       // safe call to BaseVector::ensureWritable must include all the rows not
-      // covered by cachedDictionaryIndices_. If BaseVector::ensureWritable is
-      // called only for a subset of rows not covered by
-      // cachedDictionaryIndices_, it will attempt to copy rows that are not
-      // valid leading to a crash.
-      LocalSelectivityVector allUncached(context, dictionaryCache_->size());
+      // covered by 'cachedIndices'. If BaseVector::ensureWritable is
+      // called only for a subset of rows not covered by 'cachedIndices', it
+      // will attempt to copy rows that are not valid leading to a crash.
+      LocalSelectivityVector allUncached(context, entry->values->size());
       allUncached.get()->setAll();
-      allUncached.get()->deselect(*cachedDictionaryIndices_);
+      allUncached.get()->deselect(*cachedIndices);
       BaseVector::ensureWritable(
-          *allUncached.get(), type(), context.pool(), &dictionaryCache_);
+          *allUncached.get(), type(), context.pool(), &entry->values);
 
-      if (cachedDictionaryIndices_->size() < newCacheSize) {
-        cachedDictionaryIndices_->resize(newCacheSize, false);
+      if (cachedIndices->size() < newCacheSize) {
+        cachedIndices->resize(newCacheSize, false);
       }
 
-      cachedDictionaryIndices_->select(*uncached);
+      cachedIndices->select(*uncached);
 
-      // Resize the dictionaryCache_ to accommodate all the necessary rows.
-      if (dictionaryCache_->size() < uncached->end()) {
-        dictionaryCache_->resize(uncached->end());
+      // Resize the cached values to accommodate all the necessary rows.
+      if (entry->values->size() < uncached->end()) {
+        entry->values->resize(uncached->end());
       }
-      dictionaryCache_->copy(result.get(), *uncached, nullptr);
+      entry->values->copy(result.get(), *uncached, nullptr);
     }
     return;
   }
-  baseDictionary_ = base;
+  auto& entry = newDictionaryCache();
+  entry.base = base;
+  entry.lastUse = numCachableInput_;
   evalWithNulls(rows, context, result);
-  dictionaryCache_ = result;
-  if (!cachedDictionaryIndices_) {
-    cachedDictionaryIndices_ =
-        context.execCtx()->getSelectivityVector(rows.end());
+  entry.values = result;
+  if (!entry.indices) {
+    entry.indices = context.execCtx()->getSelectivityVector(rows.end());
   }
-  *cachedDictionaryIndices_ = rows;
-  deselectErrors(context, *cachedDictionaryIndices_);
+  *entry.indices = rows;
+  deselectErrors(context, *entry.indices);
+  context.exprSet()->addToMemo(this);
 }
 
 void Expr::setAllNulls(
@@ -917,7 +951,7 @@ void Expr::evalAll(
           remainingRows->begin(),
           remainingRows->end());
       if (!remainingRows->hasSelections()) {
-        inputValues_.clear();
+        context.releaseVectors(inputValues_);
         setAllNulls(rows, context, result);
         return;
       }
@@ -937,7 +971,7 @@ void Expr::evalAll(
     }
     deselectErrors(context, *nonNulls.get());
     if (!remainingRows->hasSelections()) {
-      inputValues_.clear();
+      context.releaseVectors(inputValues_);
       setAllNulls(rows, context, result);
       return;
     }
@@ -950,7 +984,7 @@ void Expr::evalAll(
   if (remainingRows != &rows) {
     addNulls(rows, remainingRows->asRange().bits(), context, result);
   }
-  inputValues_.clear();
+  context.releaseVectors(inputValues_);
 }
 
 namespace {
@@ -1082,7 +1116,7 @@ bool Expr::applyFunctionWithPeeling(
     decoded->makeIndices(*firstWrapper, rows, numLevels);
     newRows = translateToInnerRows(applyRows, *decoded, newRowsHolder);
     context.saveAndReset(saver, rows);
-    setDictionaryWrapping(*decoded, rows, *firstWrapper, context);
+    setPeeledWrapping(*decoded, rows, *firstWrapper, numLevels, context);
   }
 
   VectorPtr peeledResult;
@@ -1095,8 +1129,18 @@ void Expr::applyFunction(
     const SelectivityVector& rows,
     EvalCtx& context,
     VectorPtr& result) {
+  const auto numRows = rows.countSelected();
   stats_.numProcessedVectors += 1;
-  stats_.numProcessedRows += rows.countSelected();
+  stats_.numProcessedRows += numRows;
+  if (context.wrapEncoding() != VectorEncoding::Simple::FLAT) {
+    stats_.numPeeledRows += numRows;
+  }
+  if (std::all_of(
+          inputValues_.begin(), inputValues_.end(), [](const auto& input) {
+            return input->isFlatEncoding() || input->isConstantEncoding();
+          })) {
+    stats_.numFlatRows += numRows;
+  }
   auto timer = cpuWallTimer();
 
   computeIsAsciiForInputs(vectorFunction_.get(), inputValues_, rows);
@@ -1265,20 +1309,24 @@ std::string makeUuid() {
 ExprSet::~ExprSet() {
   exprSetListeners().withRLock([&](auto& listeners) {
     if (!listeners.empty()) {
-      std::unordered_map<std::string, exec::ExprStats> stats;
-      std::unordered_set<const exec::Expr*> uniqueExprs;
-      for (const auto& expr : exprs()) {
-        addStats(*expr, stats, uniqueExprs);
-      }
-
+      auto exprStats = stats();
       auto uuid = makeUuid();
       for (auto& listener : listeners) {
-        listener->onCompletion(uuid, {stats});
+        listener->onCompletion(uuid, {exprStats});
       }
     }
   });
 }
 
+std::unordered_map<std::string, exec::ExprStats> ExprSet::stats() const {
+  std::unordered_map<std::string, exec::ExprStats> stats;
+  std::unordered_set<const exec::Expr*> uniqueExprs;
+  for (const auto& expr : exprs()) {
+    addStats(*expr, stats, uniqueExprs);
+  }
+  return stats;
+}
+
 std::string ExprSet::toString(bool compact) const {
   std::unordered_map<const exec::Expr*, uint32_t> uniqueExprs;
   std::stringstream out;
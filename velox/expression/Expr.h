@@ -43,10 +43,21 @@ struct ExprStats {
   /// size.
   uint64_t numProcessedVectors{0};
 
+  /// Number of processed rows evaluated on peeled inputs, i.e. under a
+  /// dictionary or constant wrapping that is applied to the result afterwards.
+  uint64_t numPeeledRows{0};
+
+  /// Number of processed rows for which all inputs were flat or constant
+  /// vectors. These are the rows eligible for the fast paths of simple
+  /// functions.
+  uint64_t numFlatRows{0};
+
   void add(const ExprStats& other) {
     timing.add(other.timing);
     numProcessedRows += other.numProcessedRows;
     numProcessedVectors += other.numProcessedVectors;
+    numPeeledRows += other.numPeeledRows;
+    numFlatRows += other.numFlatRows;
   }
 };
 
@@ -122,9 +133,7 @@ class Expr {
   }
 
   void clearMemo() {
-    baseDictionary_ = nullptr;
-    dictionaryCache_ = nullptr;
-    cachedDictionaryIndices_ = nullptr;
+    dictionaryCache_.clear();
   }
 
   const TypePtr& type() const {
@@ -343,14 +352,37 @@ class Expr {
   // The rows for which 'sharedSubexprValues_' has a value.
   std::unique_ptr<SelectivityVector> sharedSubexprRows_;
 
-  VectorPtr baseDictionary_;
+  // Results of 'this' over the base of a dictionary-encoded input. Readers
+  // return the same base for consecutive batches, e.g. for all the batches
+  // of a stripe, so that a repeat only evaluates the indices not seen
+  // before.
+  struct DictionaryCacheEntry {
+    VectorPtr base;
+
+    // Values computed for 'base', 1:1 to the positions in 'base'.
+    VectorPtr values;
 
-  // Values computed for the base dictionary, 1:1 to the positions in
-  // 'baseDictionary_'.
-  VectorPtr dictionaryCache_;
+    // The indices that are valid in 'values'.
+    std::unique_ptr<SelectivityVector> indices;
+
+    // Value of 'numCachableInput_' at the last use of 'this'.
+    int32_t lastUse{0};
+  };
 
-  // The indices that are valid in 'dictionaryCache_'.
-  std::unique_ptr<SelectivityVector> cachedDictionaryIndices_;
+  // Returns the entry for 'base' or nullptr if 'base' is not cached.
+  DictionaryCacheEntry* FOLLY_NULLABLE
+  findDictionaryCache(const VectorPtr& base);
+
+  // Returns an empty entry, replacing the least recently used one if the
+  // cache is full.
+  DictionaryCacheEntry& newDictionaryCache();
+
+  // Maximum number of bases with cached results. More than one keeps inputs
+  // that interleave batches from a few sources, e.g. a local exchange
+  // behind several scans, from evicting each other.
+  static constexpr int32_t kMaxDictionaryCacheEntries = 4;
+
+  std::vector<DictionaryCacheEntry> dictionaryCache_;
 
   // Count of executions where this is wrapped in a dictionary so that
   // results could be cached.
@@ -425,6 +457,11 @@ class ExprSet {
   /// Otherwise, prints a tree of expressions one node per line.
   std::string toString(bool compact = true) const;
 
+  /// Returns runtime stats aggregated by expression name (e.g. built-in
+  /// expression like and, or, switch or a function name). Common
+  /// subexpressions are counted once.
+  std::unordered_map<std::string, ExprStats> stats() const;
+
  protected:
   void clearSharedSubexprs();
 
@@ -440,7 +440,13 @@ ExprPtr compileExpression(
 
   auto folded =
       enableConstantFolding ? tryFoldIfConstant(result, scope) : result;
-  scope->visited[expr.get()] = folded;
+  // Structurally equal deterministic subtrees anywhere in the ExprSet share
+  // one Expr, which evaluates once per batch and is reused by all
+  // references. Each occurrence of a non-deterministic call, e.g. rand(),
+  // must produce its own values, so these are not shared.
+  if (folded->isDeterministic()) {
+    scope->visited[expr.get()] = folded;
+  }
   return folded;
 }
 
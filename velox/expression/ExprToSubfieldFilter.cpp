@@ -58,51 +58,87 @@ const core::CallTypedExpr* asCall(const core::ITypedExpr* expr) {
   return dynamic_cast<const core::CallTypedExpr*>(expr);
 }
 
-common::BigintRange* asBigintRange(std::unique_ptr<common::Filter>& filter) {
-  return dynamic_cast<common::BigintRange*>(filter.get());
-}
-
-common::BigintMultiRange* asBigintMultiRange(
-    std::unique_ptr<common::Filter>& filter) {
-  return dynamic_cast<common::BigintMultiRange*>(filter.get());
+// Appends copies of the ranges of 'filter' to 'ranges' if 'filter' is a
+// BigintRange or BigintMultiRange. Returns false otherwise.
+bool appendBigintRanges(
+    const common::Filter& filter,
+    std::vector<std::unique_ptr<common::BigintRange>>& ranges) {
+  if (auto range = dynamic_cast<const common::BigintRange*>(&filter)) {
+    ranges.push_back(std::make_unique<common::BigintRange>(
+        range->lower(), range->upper(), false));
+    return true;
+  }
+  if (auto multiRange =
+          dynamic_cast<const common::BigintMultiRange*>(&filter)) {
+    for (const auto& range : multiRange->ranges()) {
+      ranges.push_back(std::make_unique<common::BigintRange>(
+          range->lower(), range->upper(), false));
+    }
+    return true;
+  }
+  return false;
 }
 
-template <typename T, typename U>
-std::unique_ptr<T> asUniquePtr(std::unique_ptr<U> ptr) {
-  return std::unique_ptr<T>(static_cast<T*>(ptr.release()));
+// Returns the union of 'ranges' as a BigintRange if the ranges overlap or
+// touch, otherwise as a BigintMultiRange of sorted disjoint ranges.
+std::unique_ptr<common::Filter> mergeBigintRanges(
+    std::vector<std::unique_ptr<common::BigintRange>> ranges,
+    bool nullAllowed) {
+  std::sort(ranges.begin(), ranges.end(), [](const auto& a, const auto& b) {
+    return a->lower() < b->lower();
+  });
+  std::vector<std::unique_ptr<common::BigintRange>> merged;
+  for (auto& range : ranges) {
+    if (!merged.empty()) {
+      auto& last = merged.back();
+      if (last->upper() == std::numeric_limits<int64_t>::max() ||
+          range->lower() <= last->upper() + 1) {
+        if (range->upper() > last->upper()) {
+          last = std::make_unique<common::BigintRange>(
+              last->lower(), range->upper(), false);
+        }
+        continue;
+      }
+    }
+    merged.push_back(std::move(range));
+  }
+  if (merged.size() == 1) {
+    return std::make_unique<common::BigintRange>(
+        merged[0]->lower(), merged[0]->upper(), nullAllowed);
+  }
+  return std::make_unique<common::BigintMultiRange>(
+      std::move(merged), nullAllowed);
 }
 
 std::unique_ptr<common::Filter> makeOrFilter(
     std::unique_ptr<common::Filter> a,
     std::unique_ptr<common::Filter> b) {
-  if (asBigintRange(a) && asBigintRange(b)) {
-    return bigintOr(
-        asUniquePtr<common::BigintRange>(std::move(a)),
-        asUniquePtr<common::BigintRange>(std::move(b)));
-  }
-
-  if (asBigintRange(a) && asBigintMultiRange(b)) {
-    const auto& ranges = asBigintMultiRange(b)->ranges();
-    std::vector<std::unique_ptr<common::BigintRange>> newRanges;
-    newRanges.emplace_back(asUniquePtr<common::BigintRange>(std::move(a)));
-    for (const auto& range : ranges) {
-      newRanges.emplace_back(asUniquePtr<common::BigintRange>(range->clone()));
-    }
+  const bool nullAllowed = a->testNull() || b->testNull();
 
-    std::sort(
-        newRanges.begin(), newRanges.end(), [](const auto& a, const auto& b) {
-          return a->lower() < b->lower();
-        });
+  // 'x IS NULL OR <filter>' is <filter> with nulls allowed.
+  if (a->kind() == common::FilterKind::kIsNull) {
+    return b->clone(true);
+  }
+  if (b->kind() == common::FilterKind::kIsNull) {
+    return a->clone(true);
+  }
 
-    return std::make_unique<common::BigintMultiRange>(
-        std::move(newRanges), false);
+  std::vector<std::unique_ptr<common::BigintRange>> ranges;
+  if (appendBigintRanges(*a, ranges) && appendBigintRanges(*b, ranges)) {
+    return mergeBigintRanges(std::move(ranges), nullAllowed);
   }
 
-  if (asBigintMultiRange(a) && asBigintRange(b)) {
-    return makeOrFilter(std::move(b), std::move(a));
+  auto aValues = dynamic_cast<const common::BytesValues*>(a.get());
+  auto bValues = dynamic_cast<const common::BytesValues*>(b.get());
+  if (aValues && bValues) {
+    std::vector<std::string> values(
+        aValues->values().begin(), aValues->values().end());
+    values.insert(
+        values.end(), bValues->values().begin(), bValues->values().end());
+    return in(values, nullAllowed);
   }
 
-  return orFilter(std::move(a), std::move(b));
+  return orFilter(std::move(a), std::move(b), nullAllowed);
 }
 
 std::unique_ptr<common::Filter> makeLessThanOrEqualFilter(
@@ -248,41 +284,73 @@ std::unique_ptr<common::Filter> makeEqualFilter(
   }
 }
 
+// Returns a filter for 'x <> value'. With 'nullAllowed' this is 'x IS
+// DISTINCT FROM value'.
 std::unique_ptr<common::Filter> makeNotEqualFilter(
-    const core::TypedExprPtr& valueExpr) {
+    const core::TypedExprPtr& valueExpr,
+    bool nullAllowed = false) {
   auto queryCtx = core::QueryCtx::createForTest();
   auto value = toConstant(valueExpr, queryCtx);
+  switch (value->typeKind()) {
+    case TypeKind::TINYINT:
+      return notEqual(singleValue<int8_t>(value), nullAllowed);
+    case TypeKind::SMALLINT:
+      return notEqual(singleValue<int16_t>(value), nullAllowed);
+    case TypeKind::INTEGER:
+      return notEqual(singleValue<int32_t>(value), nullAllowed);
+    case TypeKind::BIGINT:
+      return notEqual(singleValue<int64_t>(value), nullAllowed);
+    case TypeKind::DATE:
+      return notEqual(singleValue<Date>(value).days(), nullAllowed);
+    case TypeKind::VARCHAR:
+      return notIn({singleValue<StringView>(value).str()}, nullAllowed);
+    case TypeKind::DOUBLE:
+    case TypeKind::REAL:
+      return orFilter(
+          makeLessThanFilter(valueExpr),
+          makeGreaterThanFilter(valueExpr),
+          nullAllowed);
+    default:
+      VELOX_NYI(
+          "Unsupported value for not equals filter: {} <> {}",
+          value->type()->toString(),
+          value->toString(0));
+  }
+}
+
+// Returns a filter for 'x LIKE pattern' if 'pattern' is a constant string
+// that matches a fixed string or the strings starting with a fixed prefix.
+// The prefix matches the range [prefix, prefix with its last byte
+// incremented), ignoring trailing 0xFF bytes.
+std::unique_ptr<common::Filter> makeLikeFilter(
+    const core::TypedExprPtr& patternExpr) {
+  auto queryCtx = core::QueryCtx::createForTest();
+  auto patternVector = toConstant(patternExpr, queryCtx);
+  VELOX_CHECK_EQ(patternVector->typeKind(), TypeKind::VARCHAR);
+  auto pattern = singleValue<StringView>(patternVector).str();
 
-  std::unique_ptr<common::Filter> lessThanFilter =
-      makeLessThanFilter(valueExpr);
-  std::unique_ptr<common::Filter> greaterThanFilter =
-      makeGreaterThanFilter(valueExpr);
-
-  if (value->typeKind() == TypeKind::TINYINT ||
-      value->typeKind() == TypeKind::SMALLINT ||
-      value->typeKind() == TypeKind::INTEGER ||
-      value->typeKind() == TypeKind::BIGINT) {
-    // Cast lessThanFilter and greaterThanFilter to
-    // std::unique_ptr<common::BigintRange>.
-    std::vector<std::unique_ptr<common::BigintRange>> ranges;
-    auto lessRange =
-        dynamic_cast<common::BigintRange*>(lessThanFilter.release());
-    VELOX_CHECK_NOT_NULL(lessRange, "Less-than range is null");
-    ranges.emplace_back(std::unique_ptr<common::BigintRange>(lessRange));
-
-    auto greaterRange =
-        dynamic_cast<common::BigintRange*>(greaterThanFilter.release());
-    VELOX_CHECK_NOT_NULL(greaterRange, "Greater-than range is null");
-    ranges.emplace_back(std::unique_ptr<common::BigintRange>(greaterRange));
-
-    return std::make_unique<common::BigintMultiRange>(std::move(ranges), false);
-  } else {
-    std::vector<std::unique_ptr<common::Filter>> filters;
-    filters.emplace_back(std::move(lessThanFilter));
-    filters.emplace_back(std::move(greaterThanFilter));
-    return std::make_unique<common::MultiRange>(
-        std::move(filters), false, false);
+  auto wildcard = pattern.find_first_of("%_");
+  if (wildcard == std::string::npos) {
+    return equal(pattern);
   }
+  if (wildcard != pattern.size() - 1 || pattern.back() != '%') {
+    VELOX_NYI("Unsupported pattern for 'like' filter: {}", pattern);
+  }
+
+  auto prefix = pattern.substr(0, wildcard);
+  if (prefix.empty()) {
+    return isNotNull();
+  }
+  auto upper = prefix;
+  while (!upper.empty() && static_cast<uint8_t>(upper.back()) == 0xFF) {
+    upper.pop_back();
+  }
+  if (upper.empty()) {
+    return greaterThanOrEqual(prefix);
+  }
+  upper.back() = static_cast<char>(static_cast<uint8_t>(upper.back()) + 1);
+  return std::make_unique<common::BytesRange>(
+      prefix, false, false, upper, false, true, false);
 }
 
 template <typename T>
@@ -296,7 +364,9 @@ toInt64List(const VectorPtr& vector, vector_size_t start, vector_size_t size) {
   return values;
 }
 
-std::unique_ptr<common::Filter> makeInFilter(const core::TypedExprPtr& expr) {
+std::unique_ptr<common::Filter> makeInFilter(
+    const core::TypedExprPtr& expr,
+    bool negated = false) {
   auto queryCtx = core::QueryCtx::createForTest();
   auto vector = toConstant(expr, queryCtx);
   VELOX_CHECK_EQ(vector->typeKind(), TypeKind::ARRAY);
@@ -308,28 +378,34 @@ std::unique_ptr<common::Filter> makeInFilter(const core::TypedExprPtr& expr) {
   auto elements = arrayVector->elements();
 
   auto elementType = arrayVector->type()->asArray().elementType();
+  std::vector<int64_t> values;
   switch (elementType->kind()) {
     case TypeKind::TINYINT:
-      return in(toInt64List<int16_t>(elements, offset, size));
+      values = toInt64List<int8_t>(elements, offset, size);
+      break;
     case TypeKind::SMALLINT:
-      return in(toInt64List<int16_t>(elements, offset, size));
+      values = toInt64List<int16_t>(elements, offset, size);
+      break;
     case TypeKind::INTEGER:
-      return in(toInt64List<int32_t>(elements, offset, size));
+      values = toInt64List<int32_t>(elements, offset, size);
+      break;
     case TypeKind::BIGINT:
-      return in(toInt64List<int64_t>(elements, offset, size));
+      values = toInt64List<int64_t>(elements, offset, size);
+      break;
     case TypeKind::VARCHAR: {
       auto stringElements = elements->as<SimpleVector<StringView>>();
-      std::vector<std::string> values;
+      std::vector<std::string> strings;
       for (auto i = 0; i < size; i++) {
-        values.push_back(stringElements->valueAt(offset + i).str());
+        strings.push_back(stringElements->valueAt(offset + i).str());
       }
-      return in(values);
+      return negated ? notIn(strings) : in(strings);
     }
     default:
       VELOX_NYI(
           "Unsupported value type for 'in' filter: {}",
           elementType->toString());
   }
+  return negated ? notIn(values) : in(values);
 }
 
 std::unique_ptr<common::Filter> makeBetweenFilter(
@@ -339,6 +415,12 @@ std::unique_ptr<common::Filter> makeBetweenFilter(
   auto lower = toConstant(lowerExpr, queryCtx);
   auto upper = toConstant(upperExpr, queryCtx);
   switch (lower->typeKind()) {
+    case TypeKind::TINYINT:
+      return between(singleValue<int8_t>(lower), singleValue<int8_t>(upper));
+    case TypeKind::SMALLINT:
+      return between(singleValue<int16_t>(lower), singleValue<int16_t>(upper));
+    case TypeKind::INTEGER:
+      return between(singleValue<int32_t>(lower), singleValue<int32_t>(upper));
     case TypeKind::BIGINT:
       return between(singleValue<int64_t>(lower), singleValue<int64_t>(upper));
     case TypeKind::DOUBLE:
@@ -381,6 +463,18 @@ std::pair<common::Subfield, std::unique_ptr<common::Filter>> toSubfieldFilter(
       if (auto field = asField(call, 0)) {
         return {Subfield(field->name()), makeNotEqualFilter(call->inputs()[1])};
       }
+    } else if (call->name() == "distinct_from") {
+      if (auto field = asField(call, 0)) {
+        return {
+            Subfield(field->name()),
+            makeNotEqualFilter(call->inputs()[1], true)};
+      }
+    } else if (call->name() == "like") {
+      if (auto field = asField(call, 0)) {
+        if (call->inputs().size() == 2) {
+          return {Subfield(field->name()), makeLikeFilter(call->inputs()[1])};
+        }
+      }
     } else if (call->name() == "lte") {
       if (auto field = asField(call, 0)) {
         return {
@@ -422,6 +516,12 @@ std::pair<common::Subfield, std::unique_ptr<common::Filter>> toSubfieldFilter(
           if (auto field = asField(nestedCall, 0)) {
             return {Subfield(field->name()), isNotNull()};
           }
+        } else if (nestedCall->name() == "in") {
+          if (auto field = asField(nestedCall, 0)) {
+            return {
+                Subfield(field->name()),
+                makeInFilter(nestedCall->inputs()[1], true)};
+          }
         }
       }
     }
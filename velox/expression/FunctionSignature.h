@@ -175,6 +175,21 @@ class AggregateFunctionSignature : public FunctionSignature {
             variableArity),
         intermediateType_{std::move(intermediateType)} {}
 
+  AggregateFunctionSignature(
+      std::vector<TypeVariableConstraint> typeVariableConstants,
+      std::vector<TypeVariableConstraint> variables,
+      TypeSignature returnType,
+      TypeSignature intermediateType,
+      std::vector<TypeSignature> argumentTypes,
+      bool variableArity)
+      : FunctionSignature(
+            std::move(typeVariableConstants),
+            std::move(variables),
+            std::move(returnType),
+            std::move(argumentTypes),
+            variableArity),
+        intermediateType_{std::move(intermediateType)} {}
+
   const TypeSignature& intermediateType() const {
     return intermediateType_;
   }
@@ -269,6 +284,13 @@ class AggregateFunctionSignatureBuilder {
     return *this;
   }
 
+  AggregateFunctionSignatureBuilder& variableConstraint(
+      std::string name,
+      std::string constraint) {
+    variables_.emplace_back(name, constraint);
+    return *this;
+  }
+
   AggregateFunctionSignatureBuilder& returnType(const std::string& type) {
     returnType_.emplace(parseTypeSignature(type));
     return *this;
@@ -293,6 +315,7 @@ class AggregateFunctionSignatureBuilder {
 
  private:
   std::vector<TypeVariableConstraint> typeVariableConstants_;
+  std::vector<TypeVariableConstraint> variables_;
   std::optional<TypeSignature> returnType_;
   std::optional<TypeSignature> intermediateType_;
   std::vector<TypeSignature> argumentTypes_;
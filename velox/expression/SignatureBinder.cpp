@@ -137,7 +137,7 @@ TypePtr SignatureBinder::tryResolveType(
   std::vector<TypePtr> children;
   children.reserve(params.size());
   for (auto& param : params) {
-    auto type = tryResolveType(param, bindings);
+    auto type = tryResolveType(param, bindings, variables, constraints);
     if (!type) {
       return nullptr;
     }
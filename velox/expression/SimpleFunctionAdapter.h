@@ -16,6 +16,7 @@
 
 #pragma once
 
+#include <atomic>
 #include <memory>
 
 #include <velox/expression/DecodedArgs.h>
@@ -49,6 +50,26 @@ struct IsMapWriter<MapWriter<K, V>> {
   static constexpr bool value = true;
 };
 
+namespace detail {
+template <typename T>
+struct IsFlatNoNullsFastPathArg
+    : std::bool_constant<
+          CppToType<T>::isPrimitiveType && CppToType<T>::isFixedWidth &&
+          CppToType<T>::typeKind != TypeKind::BOOLEAN &&
+          CppToType<T>::typeKind != TypeKind::UNKNOWN> {};
+
+template <typename Tuple>
+struct AllFlatNoNullsFastPathArgs;
+
+// True if all 'Args' are fixed-width primitives that are stored as arrays of
+// values in FlatVectors. Variadic arguments are not supported.
+template <typename... Args>
+struct AllFlatNoNullsFastPathArgs<std::tuple<Args...>>
+    : std::conjunction<std::conjunction<
+          std::negation<isVariadicType<Args>>,
+          IsFlatNoNullsFastPathArg<Args>>...> {};
+} // namespace detail
+
 template <typename FUNC>
 class SimpleFunctionAdapter : public VectorFunction {
   using T = typename FUNC::exec_return_type;
@@ -63,6 +84,14 @@ class SimpleFunctionAdapter : public VectorFunction {
       typename TypeToFlatVector<typename FUNC::return_type>::type;
   std::unique_ptr<FUNC> fn_;
 
+  static constexpr bool isStringResult =
+      std::is_same_v<typename FUNC::return_type, Varchar> ||
+      std::is_same_v<typename FUNC::return_type, Varbinary>;
+
+  // Output elements or string bytes per row of the last batch. See
+  // reserveOutput().
+  mutable std::atomic<int64_t> outputSizePerRow_{0};
+
   // Whether the return type for this UDF allows for fast path iteration.
   static constexpr bool fastPathIteration =
       return_type_traits::isPrimitiveType && return_type_traits::isFixedWidth;
@@ -73,6 +102,16 @@ class SimpleFunctionAdapter : public VectorFunction {
       TypeKind::UNKNOWN&& CppToType<arg_at<POSITION>>::typeKind !=
       TypeKind::BOOLEAN&& CppToType<arg_at<POSITION>>::isPrimitiveType;
 
+  // Whether the function can use a plain loop over the raw values of flat
+  // arguments without nulls: all arguments and the result are fixed-width
+  // primitives other than BOOLEAN and the function never returns null. The
+  // loop has no per-row indirection, so the compiler can vectorize simple
+  // function bodies.
+  static constexpr bool flatNoNullsFastPath = fastPathIteration &&
+      return_type_traits::typeKind != TypeKind::BOOLEAN &&
+      !FUNC::can_produce_null_output && !FUNC::udf_has_callNullFree &&
+      detail::AllFlatNoNullsFastPathArgs<typename FUNC::arg_types>::value;
+
   /// If the initialize() method provided by functions throw, we don't (can't)
   /// throw immediately; rather, we capture the exception using this member
   /// variable and set that as error for every single active row. This is needed
@@ -96,7 +135,7 @@ class SimpleFunctionAdapter : public VectorFunction {
       // is unique, as is nulls.  We also know the size of the vector is
       // at least as large as the size of rows.
       if (!isResultReused) {
-        BaseVector::ensureWritable(*rows, outputType, context->pool(), _result);
+        context->ensureWritable(*rows, outputType, *_result);
       }
       result = reinterpret_cast<result_vector_t*>((*_result).get());
       resultWriter.init(*result);
@@ -338,7 +377,16 @@ class SimpleFunctionAdapter : public VectorFunction {
     decoded.reserve(args.size());
     decodeArgs<0>(decoded, args, rows, context, !primitiveFlatConstantFastPath);
 
-    if (primitiveFlatConstantFastPath) {
+    bool flatNoNulls = false;
+    if constexpr (flatNoNullsFastPath) {
+      flatNoNulls = rows.isAllSelected() &&
+          allArgsFlatNoNulls(args, std::make_index_sequence<FUNC::num_args>{});
+    }
+
+    if (flatNoNulls) {
+      iterateFlatNoNulls(
+          applyContext, args, std::make_index_sequence<FUNC::num_args>{});
+    } else if (primitiveFlatConstantFastPath) {
       unpack<0, true>(applyContext, true, decoded, args);
     } else {
       unpack<0, false>(applyContext, true, decoded, args);
@@ -662,9 +710,80 @@ class SimpleFunctionAdapter : public VectorFunction {
     }
   }
 
+  template <size_t... POSITIONS>
+  static bool allArgsFlatNoNulls(
+      const std::vector<VectorPtr>& args,
+      std::index_sequence<POSITIONS...>) {
+    return (
+        (args[POSITIONS]->isFlatEncoding() &&
+         !args[POSITIONS]->mayHaveNulls()) &&
+        ...);
+  }
+
+  // Applies the function to all rows of flat arguments with no nulls. See
+  // flatNoNullsFastPath. An error skips just the row that raised it, like
+  // applyToSelectedNoThrow().
+  template <size_t... POSITIONS>
+  void iterateFlatNoNulls(
+      ApplyContext& applyContext,
+      const std::vector<VectorPtr>& args,
+      std::index_sequence<POSITIONS...>) const {
+    auto* data = applyContext.result->mutableRawValues();
+    const auto rawArgs = std::make_tuple(
+        args[POSITIONS]
+            ->template asUnchecked<FlatVector<typename ConstantFlatVectorReader<
+                arg_at<POSITIONS>>::exec_in_t>>()
+            ->rawValues()...);
+    const vector_size_t end = applyContext.rows->end();
+    vector_size_t row = applyContext.rows->begin();
+    while (row < end) {
+      try {
+        for (; row < end; ++row) {
+          T out{};
+          (*fn_).call(out, std::get<POSITIONS>(rawArgs)[row]...);
+          data[row] = out;
+        }
+      } catch (const std::exception& e) {
+        applyContext.context->setError(row, std::current_exception());
+        ++row;
+      }
+    }
+  }
+
+  // Pre-sizes the elements of array and map results and the string buffer
+  // of string results for the output size per row seen in the last batch,
+  // so that the writers do not grow them row by row.
+  void reserveOutput(ApplyContext& applyContext) const {
+    const auto sizePerRow = outputSizePerRow_.load(std::memory_order_relaxed);
+    if (sizePerRow == 0) {
+      return;
+    }
+    const auto size = std::min<int64_t>(
+        applyContext.rows->countSelected() * sizePerRow,
+        std::numeric_limits<vector_size_t>::max());
+    if constexpr (IsArrayWriter<T>::value || IsMapWriter<T>::value) {
+      applyContext.resultWriter.reserveElements(size);
+    } else if constexpr (isStringResult) {
+      if (fn_->reuseStringsFromArg() < 0) {
+        applyContext.result->getBufferWithSpace(size);
+      }
+    }
+  }
+
+  // Records the output size per row of a batch for reserveOutput().
+  void recordOutputSize(ApplyContext& applyContext, int64_t outputSize) const {
+    const auto numRows = applyContext.rows->countSelected();
+    if (numRows > 0) {
+      outputSizePerRow_.store(
+          bits::roundUp(outputSize, numRows) / numRows,
+          std::memory_order_relaxed);
+    }
+  }
+
   template <typename Func>
   void applyUdf(ApplyContext& applyContext, Func func) const {
     if constexpr (IsArrayWriter<T>::value || IsMapWriter<T>::value) {
+      reserveOutput(applyContext);
       // An optimization for arrayProxy and mapWriter that force the
       // localization of the writer.
       auto& currentWriter = applyContext.resultWriter.writer_;
@@ -677,7 +796,25 @@ class SimpleFunctionAdapter : public VectorFunction {
         currentWriter = localWriter;
         applyContext.resultWriter.commit(notNull);
       });
+      recordOutputSize(
+          applyContext, applyContext.resultWriter.numElements());
       applyContext.resultWriter.finish();
+    } else if constexpr (isStringResult) {
+      reserveOutput(applyContext);
+      int64_t bytesBefore = 0;
+      for (const auto& buffer : applyContext.result->stringBuffers()) {
+        bytesBefore += buffer->size();
+      }
+      applyContext.applyToSelectedNoThrow([&](auto row) INLINE_LAMBDA {
+        applyContext.resultWriter.setOffset(row);
+        applyContext.resultWriter.commit(
+            func(applyContext.resultWriter.current(), row));
+      });
+      int64_t bytesAfter = 0;
+      for (const auto& buffer : applyContext.result->stringBuffers()) {
+        bytesAfter += buffer->size();
+      }
+      recordOutputSize(applyContext, bytesAfter - bytesBefore);
     } else {
       applyContext.applyToSelectedNoThrow([&](auto row) INLINE_LAMBDA {
         applyContext.resultWriter.setOffset(row);
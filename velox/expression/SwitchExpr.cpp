@@ -15,6 +15,7 @@
  */
 #include "velox/expression/SwitchExpr.h"
 #include "velox/expression/BooleanMix.h"
+#include "velox/expression/FieldReference.h"
 #include "velox/expression/VarSetter.h"
 
 namespace facebook::velox::exec {
@@ -35,6 +36,9 @@ void SwitchExpr::evalSpecialForm(
       context.mutableFinalSelection(), &rows, context.isFinalSelection());
   VarSetter isFinalSelection(context.mutableIsFinalSelection(), false);
 
+  const auto compactionPct =
+      context.execCtx()->queryCtx()->config().exprSwitchCompactionPct();
+
   for (auto i = 0; i < numCases_; i++) {
     if (!remainingRows.get()->hasSelections()) {
       break;
@@ -74,7 +78,12 @@ void SwitchExpr::evalSpecialForm(
                 *thenRows.get(), result->type(), context.pool(), &result);
           }
 
-          inputs_[2 * i + 1]->eval(*thenRows.get(), context, result);
+          evalClause(
+              *inputs_[2 * i + 1],
+              *thenRows.get(),
+              compactionPct,
+              context,
+              result);
           remainingRows.get()->deselect(*thenRows.get());
         }
       }
@@ -89,7 +98,12 @@ void SwitchExpr::evalSpecialForm(
     }
 
     if (hasElseClause_) {
-      inputs_.back()->eval(*remainingRows.get(), context, result);
+      evalClause(
+          *inputs_.back(),
+          *remainingRows.get(),
+          compactionPct,
+          context,
+          result);
 
     } else {
       // fill in nulls for remainingRows
@@ -99,6 +113,95 @@ void SwitchExpr::evalSpecialForm(
   }
 }
 
+void SwitchExpr::evalClause(
+    Expr& clause,
+    const SelectivityVector& rows,
+    int32_t compactionPct,
+    EvalCtx& context,
+    VectorPtr& result) {
+  if (compactionPct > 0 &&
+      rows.countSelected() * 100 < compactionPct * rows.end() &&
+      evalCompacted(clause, rows, context, result)) {
+    return;
+  }
+  clause.eval(rows, context, result);
+}
+
+bool SwitchExpr::evalCompacted(
+    Expr& clause,
+    const SelectivityVector& rows,
+    EvalCtx& context,
+    VectorPtr& result) {
+  // Fields and constants cost less than the copies.
+  const auto& fields = clause.distinctFields();
+  if (clause.inputs().empty() || fields.empty() || !context.row()) {
+    return false;
+  }
+  for (auto* field : fields) {
+    if (!field->inputs().empty()) {
+      return false;
+    }
+  }
+
+  auto* pool = context.pool();
+  const auto numRows = rows.countSelected();
+  auto compactToRows = allocateIndices(numRows, pool);
+  auto rawCompactToRows = compactToRows->asMutable<vector_size_t>();
+  // Only used within this batch.
+  auto* rawRowsToCompact = context.scratch<vector_size_t>(rows.end());
+  vector_size_t numCompacted = 0;
+  rows.applyToSelected([&](auto row) {
+    rawRowsToCompact[row] = numCompacted;
+    rawCompactToRows[numCompacted++] = row;
+  });
+
+  // The fields the clause does not use are null constants.
+  const auto& rowType = context.row()->type();
+  std::vector<VectorPtr> children(rowType->size());
+  for (auto* field : fields) {
+    const auto index = field->index(context);
+    context.ensureFieldLoaded(index, rows);
+    const auto& source = context.getField(index);
+    SelectivityVector compactRows(numRows);
+    children[index] = BaseVector::create(source->type(), numRows, pool);
+    children[index]->copy(source.get(), compactRows, rawCompactToRows);
+  }
+  for (auto i = 0; i < children.size(); ++i) {
+    if (!children[i]) {
+      children[i] =
+          BaseVector::createNullConstant(rowType->childAt(i), numRows, pool);
+    }
+  }
+  auto compactRow = std::make_shared<RowVector>(
+      pool, rowType, nullptr, numRows, std::move(children));
+
+  EvalCtx compactContext(
+      context.execCtx(), context.exprSet(), compactRow.get());
+  *compactContext.mutableThrowOnError() = context.throwOnError();
+  *compactContext.mutableCaptureErrorDetails() = context.captureErrorDetails();
+  // Marks the rows as not being the rows of the ExprSet, so that shared
+  // subexpressions do not reuse or keep values across the two sets of rows.
+  compactContext.setDictionaryWrap(compactToRows, nullptr);
+
+  VectorPtr compactResult;
+  clause.eval(SelectivityVector(numRows), compactContext, compactResult);
+
+  if (auto* errors = compactContext.errors()) {
+    for (auto i = 0; i < errors->size(); ++i) {
+      if (!errors->isNullAt(i)) {
+        context.setError(
+            rawCompactToRows[i],
+            *std::static_pointer_cast<std::exception_ptr>(
+                errors->valueAt(i)));
+      }
+    }
+  }
+
+  BaseVector::ensureWritable(rows, type(), pool, &result);
+  result->copy(compactResult.get(), rows, rawRowsToCompact);
+  return true;
+}
+
 bool SwitchExpr::propagatesNulls() const {
   // The "switch" expression propagates nulls when all of the following
   // conditions are met:
@@ -65,6 +65,24 @@ class SwitchExpr : public SpecialForm {
   }
 
  private:
+  // Evaluates 'clause' on 'rows' and stores the result in 'result'. If
+  // 'rows' are sparse enough, evaluates 'clause' on copies of its fields
+  // compacted to 'rows'. See QueryConfig::kExprSwitchCompactionPct.
+  void evalClause(
+      Expr& clause,
+      const SelectivityVector& rows,
+      int32_t compactionPct,
+      EvalCtx& context,
+      VectorPtr& result);
+
+  // Returns true and sets 'result' at 'rows' if 'clause' could be evaluated
+  // on compacted fields.
+  bool evalCompacted(
+      Expr& clause,
+      const SelectivityVector& rows,
+      EvalCtx& context,
+      VectorPtr& result);
+
   const size_t numCases_;
   const bool hasElseClause_;
   BufferPtr tempValues_;
@@ -18,6 +18,13 @@
 
 namespace facebook::velox::exec {
 
+namespace {
+bool hasErrorListeners() {
+  return exprSetListeners().withRLock(
+      [](auto& listeners) { return !listeners.empty(); });
+}
+} // namespace
+
 void TryExpr::evalSpecialForm(
     const SelectivityVector& rows,
     EvalCtx& context,
@@ -32,6 +39,9 @@ void TryExpr::evalSpecialForm(
   // parent TRY expression, so the parent won't incorrectly null out rows that
   // threw exceptions which this expression already handled.
   VarSetter<EvalCtx::ErrorVectorPtr> errorsSetter(context.errorsPtr(), nullptr);
+  // Errors only null out their rows unless listeners want to see them.
+  VarSetter<bool> captureErrorDetails(
+      context.mutableCaptureErrorDetails(), hasErrorListeners());
   inputs_[0]->eval(rows, context, result);
 
   nullOutErrors(rows, context, result);
@@ -51,6 +61,8 @@ void TryExpr::evalSpecialFormSimplified(
   // parent TRY expression, so the parent won't incorrectly null out rows that
   // threw exceptions which this expression already handled.
   VarSetter<EvalCtx::ErrorVectorPtr> errorsSetter(context.errorsPtr(), nullptr);
+  VarSetter<bool> captureErrorDetails(
+      context.mutableCaptureErrorDetails(), hasErrorListeners());
   inputs_[0]->evalSimplified(rows, context, result);
 
   nullOutErrors(rows, context, result);
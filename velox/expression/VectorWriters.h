@@ -111,6 +111,17 @@ struct VectorWriter<Array<V>> {
     childWriter_.finish();
   }
 
+  // Sizes the elements vector for 'numElements' more elements in total, so
+  // that writing a batch of arrays does not grow it repeatedly.
+  void reserveElements(vector_size_t numElements) {
+    writer_.reserve(numElements + writer_.length_);
+  }
+
+  // Returns the number of elements written so far.
+  vector_size_t numElements() const {
+    return writer_.valuesOffset_ + writer_.length_;
+  }
+
   VectorWriter() = default;
 
   exec_out_t& current() {
@@ -195,6 +206,17 @@ struct VectorWriter<Map<K, V>> {
     valWriter_.finish();
   }
 
+  // Sizes the keys and values vectors for 'numEntries' more entries in
+  // total, so that writing a batch of maps does not grow them repeatedly.
+  void reserveElements(vector_size_t numEntries) {
+    writer_.reserve(numEntries + writer_.length_);
+  }
+
+  // Returns the number of entries written so far.
+  vector_size_t numElements() const {
+    return writer_.innerOffset_ + writer_.length_;
+  }
+
   VectorWriter() = default;
 
   exec_out_t& current() {
@@ -0,0 +1,126 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include <folly/Benchmark.h>
+#include <folly/init/Init.h>
+
+#include "velox/functions/lib/benchmarks/FunctionBenchmarkBase.h"
+
+// Benchmarks casts between VARCHAR and numeric types. The 'simple' cases use
+// plain decimal strings, which take the fast parsing paths. The 'exotic'
+// cases use exponents and surrounding whitespace, which go through folly.
+
+using namespace facebook::velox;
+
+namespace {
+class CastBenchmark : public functions::test::FunctionBenchmarkBase {
+ public:
+  size_t runFromVarchar(
+      const std::string& type,
+      std::function<std::string(vector_size_t)> makeString) {
+    folly::BenchmarkSuspender suspender;
+    std::vector<std::string> strings(kSize);
+    for (auto i = 0; i < kSize; ++i) {
+      strings[i] = makeString(i);
+    }
+    auto rowVector = vectorMaker_.rowVector({vectorMaker_.flatVector(strings)});
+    auto exprSet = compileExpression(
+        fmt::format("cast(c0 as {})", type), rowVector->type());
+    suspender.dismiss();
+
+    return doRun(exprSet, rowVector);
+  }
+
+  template <typename T>
+  size_t runToVarchar(std::function<T(vector_size_t)> makeValue) {
+    folly::BenchmarkSuspender suspender;
+    auto rowVector =
+        vectorMaker_.rowVector({vectorMaker_.flatVector<T>(kSize, makeValue)});
+    auto exprSet = compileExpression("cast(c0 as varchar)", rowVector->type());
+    suspender.dismiss();
+
+    return doRun(exprSet, rowVector);
+  }
+
+ private:
+  static constexpr vector_size_t kSize = 10'000;
+
+  size_t doRun(exec::ExprSet& exprSet, const RowVectorPtr& rowVector) {
+    size_t cnt = 0;
+    for (auto i = 0; i < 100; i++) {
+      cnt += evaluate(exprSet, rowVector)->size();
+    }
+    return cnt;
+  }
+};
+
+BENCHMARK_MULTI(varcharToBigintSimple) {
+  CastBenchmark benchmark;
+  return benchmark.runFromVarchar(
+      "bigint", [](auto row) { return fmt::format("{}", row * 7919 - 5000); });
+}
+
+BENCHMARK_MULTI(varcharToBigintLong) {
+  CastBenchmark benchmark;
+  return benchmark.runFromVarchar("bigint", [](auto row) {
+    return fmt::format("{}", row * 1'000'000'007LL);
+  });
+}
+
+BENCHMARK_MULTI(varcharToBigintExotic) {
+  CastBenchmark benchmark;
+  return benchmark.runFromVarchar(
+      "bigint", [](auto row) { return fmt::format(" {} ", row * 7919); });
+}
+
+BENCHMARK_DRAW_LINE();
+
+BENCHMARK_MULTI(varcharToDoubleSimple) {
+  CastBenchmark benchmark;
+  return benchmark.runFromVarchar(
+      "double", [](auto row) { return fmt::format("{}.{}", row, row % 100); });
+}
+
+BENCHMARK_MULTI(varcharToDoubleExotic) {
+  CastBenchmark benchmark;
+  return benchmark.runFromVarchar(
+      "double", [](auto row) { return fmt::format("{}e-3", row); });
+}
+
+BENCHMARK_DRAW_LINE();
+
+BENCHMARK_MULTI(bigintToVarcharShort) {
+  CastBenchmark benchmark;
+  return benchmark.runToVarchar<int64_t>(
+      [](auto row) { return row * 7919 - 5000; });
+}
+
+BENCHMARK_MULTI(bigintToVarcharLong) {
+  CastBenchmark benchmark;
+  return benchmark.runToVarchar<int64_t>(
+      [](auto row) { return row * 1'000'000'007LL; });
+}
+
+BENCHMARK_MULTI(doubleToVarchar) {
+  CastBenchmark benchmark;
+  return benchmark.runToVarchar<double>([](auto row) { return row * 0.1; });
+}
+} // namespace
+
+int main(int argc, char** argv) {
+  folly::init(&argc, &argv);
+  folly::runBenchmarks();
+  return 0;
+}
@@ -34,6 +34,9 @@
 // These benchmarks show that meerly adding a Try expression does not
 // significantly impact performance, and the performance cost of handling
 // exceptions scales linearly with the number of rows that saw exceptions.
+// 3) Benchmark casting strings to integers under Try with and without invalid
+// strings. Casts report invalid strings without exceptions, so the two cost
+// about the same.
 
 using namespace facebook::velox;
 
@@ -144,6 +147,25 @@ class TryBenchmark : public functions::test::FunctionBenchmarkBase {
     return doRun(exprSet, rowVector);
   }
 
+  // Casts strings to integers. 'invalidEvery' of the strings are not valid
+  // integers. Uses 0 for no invalid strings.
+  size_t runCastFromVarchar(vector_size_t invalidEvery) {
+    folly::BenchmarkSuspender suspender;
+    auto strings = vectorMaker_.flatVector<std::string>(
+        1'000, [&](vector_size_t row) {
+          return invalidEvery && row % invalidEvery == 0
+              ? fmt::format("{}x", row)
+              : fmt::format("{}", row);
+        });
+    auto rowVector = vectorMaker_.rowVector({strings});
+
+    auto exprSet =
+        compileExpression("TRY(CAST(c0 AS BIGINT))", rowVector->type());
+    suspender.dismiss();
+
+    return doRun(exprSet, rowVector);
+  }
+
   size_t doRun(exec::ExprSet& exprSet, const RowVectorPtr& rowVector) {
     int cnt = 0;
     for (auto i = 0; i < 100; i++) {
@@ -182,6 +204,15 @@ BENCHMARK_MULTI(divideAllExceptions) {
   TryBenchmark benchmark;
   return benchmark.runDivisionWithAllExceptions();
 }
+BENCHMARK_MULTI(castNoInvalid) {
+  TryBenchmark benchmark;
+  return benchmark.runCastFromVarchar(0);
+}
+
+BENCHMARK_MULTI(castAllInvalid) {
+  TryBenchmark benchmark;
+  return benchmark.runCastFromVarchar(1);
+}
 } // namespace
 
 int main(int /*argc*/, char** /*argv*/) {
@@ -17,6 +17,7 @@
 #include <fmt/core.h>
 #include <glog/logging.h>
 #include <gtest/gtest.h>
+#include <numeric>
 
 #include "velox/expression/VectorWriters.h"
 #include "velox/functions/Udf.h"
@@ -764,6 +765,36 @@ TEST_F(ArrayWriterTest, addItems) {
   }
 }
 
+TEST_F(ArrayWriterTest, bulkAppend) {
+  auto result = prepareResult(ARRAY(BIGINT()), 2);
+  exec::VectorWriter<Array<int64_t>> vectorWriter;
+  vectorWriter.init(*result->as<ArrayVector>());
+  vectorWriter.reserveElements(100);
+
+  std::vector<int64_t> values(50);
+  std::iota(values.begin(), values.end(), 0);
+
+  vectorWriter.setOffset(0);
+  auto& arrayWriter = vectorWriter.current();
+  arrayWriter.add_null();
+  arrayWriter.add_items(values.data(), 3);
+  EXPECT_EQ(4, vectorWriter.numElements());
+  vectorWriter.commit();
+
+  vectorWriter.setOffset(1);
+  arrayWriter.add_items(values);
+  EXPECT_EQ(54, vectorWriter.numElements());
+  vectorWriter.commit();
+  vectorWriter.finish();
+
+  std::vector<std::vector<std::optional<int64_t>>> expected{
+      {std::nullopt, 0, 1, 2}, {}};
+  for (auto value : values) {
+    expected[1].push_back(value);
+  }
+  assertEqualVectors(result, makeNullableArrayVector(expected));
+}
+
 // Make sure nested vectors are resized to actual size after writing.
 TEST_F(ArrayWriterTest, finishPostSize) {
   using out_t = Array<Array<int32_t>>;
@@ -17,6 +17,7 @@
 #include <limits>
 #include "velox/buffer/Buffer.h"
 #include "velox/common/base/VeloxException.h"
+#include "velox/common/base/tests/GTestUtils.h"
 #include "velox/common/memory/Memory.h"
 #include "velox/expression/VectorFunction.h"
 #include "velox/functions/prestosql/tests/FunctionBaseTest.h"
@@ -489,6 +490,84 @@ TEST_F(CastExprTest, errorHandling) {
       "tinyint", {"1", "2", "3", "100", "-100.5"}, {1, 2, 3, 100, -100}, true);
 }
 
+TEST_F(CastExprTest, tryCastFromVarchar) {
+  // Invalid values under TRY become nulls. This covers the cast path which
+  // reports errors without throwing.
+  auto input = makeRowVector({makeNullableFlatVector<std::string>(
+      {"1", "1a", "", " 2 ", "9223372036854775808", "-3", std::nullopt})});
+  auto result =
+      evaluate<SimpleVector<int64_t>>("try(cast(c0 as bigint))", input);
+  assertEqualVectors(
+      makeNullableFlatVector<int64_t>(
+          {1, std::nullopt, std::nullopt, 2, std::nullopt, -3, std::nullopt}),
+      result);
+
+  auto doubles = evaluate<SimpleVector<double>>(
+      "try(cast(c0 as double))",
+      makeRowVector({makeFlatVector<std::string>({"1.5", "x", "2e3 ", "-"})}));
+  assertEqualVectors(
+      makeNullableFlatVector<double>({1.5, std::nullopt, 2000, std::nullopt}),
+      doubles);
+
+  // Without TRY, the first invalid value is reported with its details.
+  VELOX_ASSERT_THROW(
+      (evaluate<SimpleVector<int64_t>>("cast(c0 as bigint)", input)),
+      "Failed to cast from VARCHAR to BIGINT: 1a. "
+      "Non-whitespace character found after end of conversion: \"a\"");
+}
+
+TEST_F(CastExprTest, decimalStrings) {
+  // Values around the limits of the fast parsing paths, which must behave
+  // like the general path.
+  testCast<std::string, int64_t>(
+      "bigint",
+      {"123456789012345678",
+       "-123456789012345678",
+       "1234567890123456789",
+       "9223372036854775807",
+       "-9223372036854775808",
+       "00000000000000000042",
+       " 12",
+       "+12"},
+      {123456789012345678,
+       -123456789012345678,
+       1234567890123456789,
+       std::numeric_limits<int64_t>::max(),
+       std::numeric_limits<int64_t>::min(),
+       42,
+       12,
+       12});
+  testCast<std::string, int8_t>("tinyint", {"127", "-128"}, {127, -128});
+  testCast<std::string, int8_t>("tinyint", {"128"}, {std::nullopt}, true);
+  testCast<std::string, int16_t>(
+      "smallint", {"-32768", "32767"}, {-32768, 32767});
+  testCast<std::string, int32_t>("integer", {"12345678a"}, {0}, true);
+
+  testCast<std::string, double>(
+      "double",
+      {"0.1", "-2.5", "3", "9007199254740993", "1.2345678901234567890", "1e10"},
+      {0.1, -2.5, 3, 9007199254740993.0, 1.2345678901234567890, 1e10});
+  testCast<std::string, float>(
+      "real", {"0.1", "-2.5", "16777217"}, {0.1f, -2.5f, 16777217.0f});
+  testCast<std::string, double>("double", {"1.2.3"}, {0}, true);
+
+  testCast<int64_t, std::string>(
+      "varchar",
+      {0,
+       -7,
+       999'999'999'999,
+       1'000'000'000'000,
+       std::numeric_limits<int64_t>::min(),
+       std::numeric_limits<int64_t>::max()},
+      {"0",
+       "-7",
+       "999999999999",
+       "1000000000000",
+       "-9223372036854775808",
+       "9223372036854775807"});
+  testCast<int8_t, std::string>("varchar", {-128, 127}, {"-128", "127"});
+}
+
 constexpr vector_size_t kVectorSize = 1'000;
 
 TEST_F(CastExprTest, mapCast) {
@@ -52,3 +52,37 @@ TEST_F(EvalCtxTest, selectivityVectors) {
   LocalSelectivityVector local2(context, all100);
   EXPECT_EQ(all100, *local2.get());
 }
+
+TEST_F(EvalCtxTest, scratch) {
+  {
+    EvalCtx context(execCtx_.get());
+    auto* ints = context.scratch<int32_t>(100);
+    auto* doubles = context.scratch<double>(100);
+    EXPECT_EQ(0, reinterpret_cast<uintptr_t>(doubles) % alignof(double));
+    EXPECT_GE(
+        reinterpret_cast<const char*>(doubles),
+        reinterpret_cast<const char*>(ints + 100));
+    std::fill(ints, ints + 100, 1);
+    std::fill(doubles, doubles + 100, 2);
+
+    // A nested context takes its own buffer.
+    {
+      EvalCtx nested(execCtx_.get());
+      auto* nestedInts = nested.scratch<int32_t>(100);
+      std::fill(nestedInts, nestedInts + 100, 3);
+    }
+    EXPECT_EQ(1, ints[99]);
+    EXPECT_EQ(2, doubles[99]);
+
+    // Larger than the default buffer size.
+    auto* large = context.scratch<int64_t>(1 << 20);
+    large[(1 << 20) - 1] = 4;
+  }
+
+  // The next batch reuses the buffers of the previous one.
+  EvalCtx context(execCtx_.get());
+  auto usedBytes = pool_->getCurrentBytes();
+  context.scratch<int32_t>(10);
+  context.scratch<int64_t>(1 << 20);
+  EXPECT_EQ(usedBytes, pool_->getCurrentBytes());
+}
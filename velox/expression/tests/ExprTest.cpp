@@ -19,6 +19,7 @@
 #include "gtest/gtest.h"
 
 #include "velox/common/base/Exceptions.h"
+#include "velox/common/base/tests/GTestUtils.h"
 #include "velox/dwio/common/DataSink.h"
 #include "velox/expression/ConjunctExpr.h"
 #include "velox/expression/ConstantExpr.h"
@@ -958,6 +959,39 @@ TEST_F(ExprTest, reorder) {
   }
 }
 
+TEST_F(ExprTest, reorderAfterDataChange) {
+  constexpr int32_t kSize = 1'000;
+  auto rowType = ROW({"c0", "c1"}, {BIGINT(), BIGINT()});
+  auto exprSet = compileExpression("c0 % 7 = 0 and c1 % 7 = 0", rowType);
+  auto condition =
+      std::dynamic_pointer_cast<exec::ConjunctExpr>(exprSet->expr(0));
+  ASSERT_TRUE(condition != nullptr);
+
+  // Returns a batch where the conjunct on 'selective' drops all rows and the
+  // other one drops none.
+  auto makeBatch = [&](int32_t selective) {
+    std::vector<VectorPtr> columns(2);
+    columns[selective] =
+        makeFlatVector<int64_t>(kSize, [](auto row) { return row * 7 + 1; });
+    columns[1 - selective] =
+        makeFlatVector<int64_t>(kSize, [](auto row) { return row * 7; });
+    return makeRowVector(columns);
+  };
+  for (auto i = 0; i < 2 * exec::ConjunctExpr::kReorderInterval; ++i) {
+    evaluate(exprSet.get(), makeBatch(0));
+  }
+  const auto* first = &condition->selectivityAt(0);
+  const auto* second = &condition->selectivityAt(1);
+  EXPECT_LT(0, first->numIn());
+  EXPECT_EQ(0, first->numOut());
+
+  // Once the second input becomes the selective one, it moves first.
+  for (auto i = 0; i < 50 * exec::ConjunctExpr::kReorderInterval; ++i) {
+    evaluate(exprSet.get(), makeBatch(1));
+  }
+  EXPECT_EQ(second, &condition->selectivityAt(0));
+}
+
 TEST_F(ExprTest, constant) {
   auto expr = compileExpression("1 + 2 + 3 + 4");
   auto constExpr = dynamic_cast<exec::ConstantExpr*>(expr);
@@ -1478,6 +1512,36 @@ TEST_F(ExprTest, csePartialEvaluation) {
   assertEqualVectors(expected, results[1]);
 }
 
+// Structurally equal subtrees of the expressions of one ExprSet share an
+// Expr, except for non-deterministic ones.
+TEST_F(ExprTest, cseAcrossExpressions) {
+  exec::registerVectorFunction(
+      "plus_random",
+      PlusRandomIntegerFunction::signatures(),
+      std::make_unique<PlusRandomIntegerFunction>());
+
+  auto rowType = ROW({"c0", "c1"}, {INTEGER(), VARCHAR()});
+  auto compile = [&](const std::vector<std::string>& texts) {
+    std::vector<std::shared_ptr<const core::ITypedExpr>> expressions;
+    for (const auto& text : texts) {
+      expressions.push_back(parseExpression(text, rowType));
+    }
+    return std::make_unique<exec::ExprSet>(
+        std::move(expressions), execCtx_.get());
+  };
+
+  auto exprSet = compile({"strpos(c1, 'a') > 1", "strpos(c1, 'a') < 10"});
+  auto& exprs = exprSet->exprs();
+  EXPECT_EQ(exprs[0]->inputs()[0].get(), exprs[1]->inputs()[0].get());
+  EXPECT_TRUE(exprs[0]->inputs()[0]->isMultiplyReferenced());
+
+  exprSet = compile({"plus_random(c0) > c0", "plus_random(c0) < c0"});
+  EXPECT_NE(
+      exprSet->exprs()[0]->inputs()[0].get(),
+      exprSet->exprs()[1]->inputs()[0].get());
+  EXPECT_FALSE(exprSet->exprs()[0]->inputs()[0]->isMultiplyReferenced());
+}
+
 // Checks that vector function registry overwrites if multiple registry
 // attempts are made for the same functions.
 TEST_F(ExprTest, overwriteInRegistry) {
@@ -1993,6 +2057,42 @@ TEST_F(ExprTest, switchExpr) {
   assertEqualVectors(expected, result);
 }
 
+TEST_F(ExprTest, switchCompaction) {
+  vector_size_t size = 1'000;
+  auto data = makeRowVector({
+      makeFlatVector<int64_t>(size, [](auto row) { return row; }),
+      makeFlatVector<int64_t>(
+          size, [](auto row) { return row * 3; }, nullEvery(7)),
+  });
+
+  std::vector<std::string> expressions = {
+      "case when c0 % 10 = 0 then c1 + c0 when c0 % 10 = 1 then c1 * 2 "
+      "when c0 % 10 = 2 then c0 - c1 else c1 end",
+      "case when c0 % 10 = 3 then c0 * 7 end",
+      "case when c0 % 2 = 0 then c0 else c1 + 1 end",
+      // Shared subexpression in the condition and the clauses.
+      "case when c1 + 1 > 500 then (c1 + 1) * 2 else c1 + 1 end",
+      "try(case when c0 % 10 = 0 then c0 / (c0 % 20) else c0 end)",
+  };
+  std::vector<VectorPtr> expected;
+  for (const auto& expression : expressions) {
+    expected.push_back(evaluate(expression, data));
+  }
+
+  queryCtx_->setConfigOverridesUnsafe(
+      {{core::QueryConfig::kExprSwitchCompactionPct, "50"}});
+  for (auto i = 0; i < expressions.size(); ++i) {
+    SCOPED_TRACE(expressions[i]);
+    assertEqualVectors(expected[i], evaluate(expressions[i], data));
+  }
+
+  // Errors of compacted rows are reported at their original rows.
+  VELOX_ASSERT_THROW(
+      evaluate("case when c0 % 10 = 0 then c0 / (c0 % 20) else c0 end", data),
+      "division by zero");
+  queryCtx_->setConfigOverridesUnsafe({});
+}
+
 TEST_F(ExprTest, ifWithConstant) {
   vector_size_t size = 4;
 
@@ -2208,6 +2308,30 @@ TEST_F(ExprTest, peelArgs) {
   assertEqualVectors(expected32, result);
 }
 
+TEST_F(ExprTest, peelSequence) {
+  // Runs of 5 values: 0, 1, null, 3, ..., 19.
+  constexpr vector_size_t kNumRuns = 20;
+  constexpr vector_size_t kRunLength = 5;
+  auto runValues = makeFlatVector<int64_t>(
+      kNumRuns, [](auto row) { return row; }, nullEvery(kNumRuns, 2));
+  auto lengths = allocateIndices(kNumRuns, pool());
+  auto* rawLengths = lengths->asMutable<vector_size_t>();
+  std::fill(rawLengths, rawLengths + kNumRuns, kRunLength);
+  auto input = BaseVector::wrapInSequence(
+      lengths, kNumRuns * kRunLength, runValues);
+
+  // The expression is evaluated once per run and the result keeps the runs.
+  auto result = evaluate("c0 * 2 + c0", makeRowVector({input}));
+  ASSERT_EQ(result->encoding(), VectorEncoding::Simple::SEQUENCE);
+  ASSERT_EQ(result->wrapInfo(), lengths);
+  ASSERT_EQ(result->valueVector()->size(), kNumRuns);
+  auto expected = makeFlatVector<int64_t>(
+      kNumRuns * kRunLength,
+      [](auto row) { return 3 * (row / kRunLength); },
+      [](auto row) { return row / kRunLength == 2; });
+  assertEqualVectors(expected, result);
+}
+
 class NullArrayFunction : public exec::VectorFunction {
  public:
   void apply(
@@ -2308,6 +2432,68 @@ TEST_F(ExprTest, memo) {
   assertEqualVectors(expectedResult, result);
 }
 
+namespace {
+// Returns the length of a string and counts the rows it is evaluated on.
+class CountingLengthFunction : public exec::VectorFunction {
+ public:
+  void apply(
+      const SelectivityVector& rows,
+      std::vector<VectorPtr>& args,
+      const TypePtr& /* outputType */,
+      exec::EvalCtx* context,
+      VectorPtr* result) const override {
+    numRows += rows.countSelected();
+    auto input = args[0]->asFlatVector<StringView>();
+    BaseVector::ensureWritable(rows, BIGINT(), context->pool(), result);
+    auto flatResult = (*result)->asFlatVector<int64_t>();
+    rows.applyToSelected(
+        [&](auto row) { flatResult->set(row, input->valueAt(row).size()); });
+  }
+
+  static std::vector<std::shared_ptr<exec::FunctionSignature>> signatures() {
+    // varchar -> bigint
+    return {exec::FunctionSignatureBuilder()
+                .returnType("bigint")
+                .argumentType("varchar")
+                .build()};
+  }
+
+  static inline int64_t numRows{0};
+};
+} // namespace
+
+// Batches that alternate between dictionaries over two bases reuse the
+// results cached for both bases.
+TEST_F(ExprTest, memoInterleavedBases) {
+  exec::registerVectorFunction(
+      "counting_length",
+      CountingLengthFunction::signatures(),
+      std::make_unique<CountingLengthFunction>());
+
+  std::vector<VectorPtr> bases = {
+      makeFlatVector<StringView>(
+          10, [](auto row) { return StringView("abcdefghij", row); }),
+      makeFlatVector<StringView>(
+          10, [](auto row) { return StringView("klmnopqrst", row + 1); }),
+  };
+  auto indices = makeIndices(100, [](auto row) { return row % 10; });
+
+  auto rowType = ROW({"c0"}, {VARCHAR()});
+  auto exprSet = compileExpression("counting_length(c0)", rowType);
+  CountingLengthFunction::numRows = 0;
+  for (auto i = 0; i < 6; ++i) {
+    const auto offset = i % 2;
+    auto result = evaluate(
+        exprSet.get(),
+        makeRowVector({wrapInDictionary(indices, 100, bases[offset])}));
+    auto expected = makeFlatVector<int64_t>(
+        100, [&](auto row) { return row % 10 + offset; });
+    assertEqualVectors(expected, result);
+  }
+  // Each distinct value of each base is evaluated once.
+  EXPECT_EQ(20, CountingLengthFunction::numRows);
+}
+
 // This test triggers the situation when peelEncodings() produces an empty
 // selectivity vector, which if passed to evalWithMemo() causes the latter to
 // produce null Expr::dictionaryCache_, which leads to a crash in evaluation
@@ -0,0 +1,133 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#include <gtest/gtest.h>
+
+#include "velox/expression/ExprToSubfieldFilter.h"
+#include "velox/functions/prestosql/tests/FunctionBaseTest.h"
+
+namespace facebook::velox::exec {
+namespace {
+
+class ExprToSubfieldFilterTest : public functions::test::FunctionBaseTest {
+ protected:
+  std::unique_ptr<common::Filter> toFilter(const std::string& text) {
+    auto rowType = ROW({"a", "s", "d"}, {BIGINT(), VARCHAR(), DOUBLE()});
+    auto [subfield, filter] = toSubfieldFilter(makeTypedExpr(text, rowType));
+    return std::move(filter);
+  }
+};
+
+TEST_F(ExprToSubfieldFilterTest, likePrefix) {
+  auto filter = toFilter("s LIKE 'abc%'");
+  ASSERT_EQ(filter->kind(), common::FilterKind::kBytesRange);
+  EXPECT_TRUE(filter->testBytes("abc", 3));
+  EXPECT_TRUE(filter->testBytes("abcz", 4));
+  EXPECT_FALSE(filter->testBytes("abd", 3));
+  EXPECT_FALSE(filter->testBytes("ab", 2));
+  EXPECT_FALSE(filter->testNull());
+
+  filter = toFilter("s LIKE 'abc'");
+  ASSERT_EQ(filter->kind(), common::FilterKind::kBytesValues);
+  EXPECT_TRUE(filter->testBytes("abc", 3));
+  EXPECT_FALSE(filter->testBytes("abcd", 4));
+
+  filter = toFilter("s LIKE '%'");
+  ASSERT_EQ(filter->kind(), common::FilterKind::kIsNotNull);
+
+  EXPECT_THROW(toFilter("s LIKE 'a%c'"), VeloxRuntimeError);
+  EXPECT_THROW(toFilter("s LIKE 'a_%'"), VeloxRuntimeError);
+}
+
+TEST_F(ExprToSubfieldFilterTest, notEqual) {
+  auto filter = toFilter("s <> 'x'");
+  ASSERT_EQ(filter->kind(), common::FilterKind::kNegatedBytesValues);
+  EXPECT_FALSE(filter->testBytes("x", 1));
+  EXPECT_TRUE(filter->testBytes("y", 1));
+  EXPECT_FALSE(filter->testNull());
+
+  filter = toFilter("a <> 10");
+  ASSERT_EQ(filter->kind(), common::FilterKind::kNegatedBigintRange);
+  EXPECT_FALSE(filter->testInt64(10));
+  EXPECT_TRUE(filter->testInt64(11));
+
+  filter = toFilter("d <> 1.5");
+  ASSERT_EQ(filter->kind(), common::FilterKind::kMultiRange);
+  EXPECT_FALSE(filter->testDouble(1.5));
+  EXPECT_TRUE(filter->testDouble(2.5));
+}
+
+TEST_F(ExprToSubfieldFilterTest, distinctFrom) {
+  auto filter = toFilter("s IS DISTINCT FROM 'x'");
+  ASSERT_EQ(filter->kind(), common::FilterKind::kNegatedBytesValues);
+  EXPECT_FALSE(filter->testBytes("x", 1));
+  EXPECT_TRUE(filter->testNull());
+
+  filter = toFilter("a IS DISTINCT FROM 10");
+  EXPECT_FALSE(filter->testInt64(10));
+  EXPECT_TRUE(filter->testInt64(9));
+  EXPECT_TRUE(filter->testNull());
+}
+
+TEST_F(ExprToSubfieldFilterTest, notIn) {
+  auto filter = toFilter("a NOT IN (1, 5, 7)");
+  EXPECT_FALSE(filter->testInt64(5));
+  EXPECT_TRUE(filter->testInt64(6));
+
+  filter = toFilter("s NOT IN ('x', 'y')");
+  ASSERT_EQ(filter->kind(), common::FilterKind::kNegatedBytesValues);
+  EXPECT_FALSE(filter->testBytes("y", 1));
+  EXPECT_TRUE(filter->testBytes("z", 1));
+}
+
+TEST_F(ExprToSubfieldFilterTest, orOfRanges) {
+  auto filter = toFilter("a = 5 OR a = 1 OR a BETWEEN 10 AND 20");
+  ASSERT_EQ(filter->kind(), common::FilterKind::kBigintMultiRange);
+  const auto& ranges =
+      dynamic_cast<common::BigintMultiRange*>(filter.get())->ranges();
+  ASSERT_EQ(ranges.size(), 3);
+  EXPECT_EQ(ranges[0]->lower(), 1);
+  EXPECT_EQ(ranges[1]->lower(), 5);
+  EXPECT_EQ(ranges[2]->lower(), 10);
+  EXPECT_EQ(ranges[2]->upper(), 20);
+
+  // Overlapping and adjacent ranges are coalesced.
+  filter = toFilter("a BETWEEN 1 AND 5 OR a = 6 OR a BETWEEN 3 AND 9");
+  ASSERT_EQ(filter->kind(), common::FilterKind::kBigintRange);
+  EXPECT_TRUE(filter->testInt64(1));
+  EXPECT_TRUE(filter->testInt64(9));
+  EXPECT_FALSE(filter->testInt64(10));
+
+  filter = toFilter("(a < 0 OR a > 100) OR (a = 50 OR a > 10)");
+  ASSERT_EQ(filter->kind(), common::FilterKind::kBigintMultiRange);
+  EXPECT_TRUE(filter->testInt64(-1));
+  EXPECT_FALSE(filter->testInt64(5));
+  EXPECT_TRUE(filter->testInt64(11));
+
+  filter = toFilter("a IS NULL OR a = 3");
+  ASSERT_EQ(filter->kind(), common::FilterKind::kBigintRange);
+  EXPECT_TRUE(filter->testNull());
+  EXPECT_TRUE(filter->testInt64(3));
+
+  filter = toFilter("s = 'x' OR s IN ('y', 'z')");
+  ASSERT_EQ(filter->kind(), common::FilterKind::kBytesValues);
+  EXPECT_TRUE(filter->testBytes("x", 1));
+  EXPECT_TRUE(filter->testBytes("z", 1));
+}
+
+} // namespace
+} // namespace facebook::velox::exec
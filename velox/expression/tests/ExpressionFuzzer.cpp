@@ -175,28 +175,7 @@ VectorFuzzer::Options getFuzzerOptions() {
   return opts;
 }
 
-// Represents one available function signature.
-struct CallableSignature {
-  // Function name.
-  std::string name;
-
-  // Input arguments and return type.
-  std::vector<TypePtr> args;
-  TypePtr returnType;
-
-  // Convenience print function.
-  std::string toString() const {
-    std::string buf = name;
-    buf.append("( ");
-    for (const auto& arg : args) {
-      buf.append(arg->toString());
-      buf.append(" ");
-    }
-    buf.append(") -> ");
-    buf.append(returnType->toString());
-    return buf;
-  }
-};
+} // namespace
 
 std::optional<CallableSignature> processSignature(
     const std::string& functionName,
@@ -250,6 +229,8 @@ std::optional<CallableSignature> processSignature(
   return std::nullopt;
 }
 
+namespace {
+
 class ExpressionFuzzer {
  public:
   ExpressionFuzzer(FunctionSignatureMap signatureMap, size_t initialSeed)
@@ -20,6 +20,36 @@
 
 namespace facebook::velox::test {
 
+// Represents one available function signature.
+struct CallableSignature {
+  // Function name.
+  std::string name;
+
+  // Input arguments and return type.
+  std::vector<TypePtr> args;
+  TypePtr returnType;
+
+  // Convenience print function.
+  std::string toString() const {
+    std::string buf = name;
+    buf.append("( ");
+    for (const auto& arg : args) {
+      buf.append(arg->toString());
+      buf.append(" ");
+    }
+    buf.append(") -> ");
+    buf.append(returnType->toString());
+    return buf;
+  }
+};
+
+// Returns the callable form of 'signature' of 'functionName' if the
+// fuzzers support it, i.e. it is deterministic and takes and returns only
+// primitive types.
+std::optional<CallableSignature> processSignature(
+    const std::string& functionName,
+    const exec::FunctionSignature& signature);
+
 // Generates random expressions based on `signatures` and random input data (via
 // VectorFuzzer). Generates `steps` distinct expressions.
 void expressionFuzzer(
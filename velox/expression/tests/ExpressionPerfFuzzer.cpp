@@ -0,0 +1,369 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "velox/expression/tests/ExpressionPerfFuzzer.h"
+
+#include <folly/Random.h>
+#include <glog/logging.h>
+#include <fstream>
+
+#include "velox/common/time/Timer.h"
+#include "velox/expression/Expr.h"
+#include "velox/expression/tests/ExpressionFuzzer.h"
+#include "velox/vector/fuzzer/VectorFuzzer.h"
+
+DEFINE_int32(
+    perf_batch_size,
+    1000,
+    "The number of rows in each input batch of the perf fuzzer.");
+
+DEFINE_int32(
+    perf_iterations,
+    100,
+    "The number of times each expression is evaluated per encoding.");
+
+DEFINE_int32(
+    perf_max_depth,
+    2,
+    "Maximum depth of the expression trees generated by the perf fuzzer. 1 "
+    "means the function under test applied to columns.");
+
+DEFINE_double(
+    perf_slow_encoding_ratio,
+    2.0,
+    "A non-flat encoding more than this many times slower than flat is "
+    "reported as a missing fast path.");
+
+DEFINE_double(
+    perf_regression_threshold,
+    0.2,
+    "A result slower than the baseline by more than this fraction is "
+    "reported as a regression.");
+
+DEFINE_string(
+    perf_baseline_path,
+    "",
+    "File with the results of a previous run to compare against.");
+
+DEFINE_string(
+    perf_save_baseline_path,
+    "",
+    "File to write the results of this run to, for use as a baseline.");
+
+DEFINE_int32(
+    perf_report_size,
+    50,
+    "Number of results listed in the report, worst first.");
+
+namespace facebook::velox::test {
+
+namespace {
+
+// Functions that need constant arguments after the first one.
+const std::unordered_set<std::string> kConstantArgsAfterFirst = {
+    "like",
+    "regexp_extract",
+    "regexp_extract_all",
+    "regexp_like",
+    "regexp_replace",
+};
+
+// Reads a baseline file of tab separated key and nanos per row lines.
+std::unordered_map<std::string, double> readBaseline(const std::string& path) {
+  std::unordered_map<std::string, double> baseline;
+  std::ifstream in(path);
+  VELOX_CHECK(in.good(), "Cannot open perf baseline file {}", path);
+  std::string line;
+  while (std::getline(in, line)) {
+    auto tab = line.rfind('\t');
+    if (tab == std::string::npos) {
+      continue;
+    }
+    baseline[line.substr(0, tab)] = std::stod(line.substr(tab + 1));
+  }
+  return baseline;
+}
+
+void writeBaseline(
+    const std::string& path,
+    const std::vector<ExpressionPerfResult>& results) {
+  std::ofstream out(path);
+  VELOX_CHECK(out.good(), "Cannot write perf baseline file {}", path);
+  for (const auto& result : results) {
+    out << result.key() << "\t" << result.nanosPerRow << "\n";
+  }
+}
+
+// How much worse 'result' is than flat or the baseline. Results are
+// reported in descending order of this.
+double score(const ExpressionPerfResult& result) {
+  return std::max(
+      result.encoding == "flat" ? 1.0 : result.flatRatio,
+      result.baselineRatio.value_or(1.0));
+}
+
+class ExpressionPerfFuzzer {
+ public:
+  ExpressionPerfFuzzer(FunctionSignatureMap signatureMap, size_t seed)
+      : vectorFuzzer_(VectorFuzzer::Options{}, execCtx_.pool(), seed),
+        rng_(seed) {
+    for (const auto& function : signatureMap) {
+      for (const auto& signature : function.second) {
+        if (auto callable = processSignature(function.first, *signature)) {
+          signatures_.push_back(std::move(*callable));
+        }
+      }
+    }
+    // Sorted so that the same seed generates the same expressions.
+    std::sort(
+        signatures_.begin(),
+        signatures_.end(),
+        [](const auto& left, const auto& right) {
+          return left.toString() < right.toString();
+        });
+    for (const auto& signature : signatures_) {
+      signaturesByType_[signature.returnType->kind()].push_back(&signature);
+    }
+  }
+
+  std::vector<ExpressionPerfResult> run() {
+    std::unordered_map<std::string, double> baseline;
+    if (!FLAGS_perf_baseline_path.empty()) {
+      baseline = readBaseline(FLAGS_perf_baseline_path);
+    }
+
+    std::vector<ExpressionPerfResult> results;
+    for (const auto& signature : signatures_) {
+      measure(signature, results);
+    }
+    for (auto& result : results) {
+      auto it = baseline.find(result.key());
+      if (it != baseline.end() && it->second > 0) {
+        result.baselineRatio = result.nanosPerRow / it->second;
+      }
+    }
+    if (!FLAGS_perf_save_baseline_path.empty()) {
+      writeBaseline(FLAGS_perf_save_baseline_path, results);
+    }
+
+    std::stable_sort(
+        results.begin(),
+        results.end(),
+        [](const auto& left, const auto& right) {
+          return score(left) > score(right);
+        });
+    report(results);
+    return results;
+  }
+
+ private:
+  // Times an expression rooted at 'signature' over each encoding and
+  // appends the results to 'results'. Skips the signature if the
+  // expression does not evaluate over flat inputs.
+  void measure(
+      const CallableSignature& signature,
+      std::vector<ExpressionPerfResult>& results) {
+    inputTypes_.clear();
+    inputNames_.clear();
+    auto expression = generateCall(signature, 1);
+    auto inputType = ROW(std::move(inputNames_), std::move(inputTypes_));
+
+    std::optional<double> flatNanos;
+    for (const auto& encoding :
+         {"flat", "dictionary", "constant", "null_heavy"}) {
+      auto input = makeInput(inputType, encoding);
+      std::optional<double> nanos;
+      try {
+        nanos = time(expression, input);
+      } catch (const std::exception& e) {
+        VLOG(1) << "Skipping " << encoding << " " << expression->toString()
+                << ": " << e.what();
+      }
+      if (!nanos.has_value()) {
+        if (!flatNanos.has_value()) {
+          // Expressions that fail over flat inputs are not measured.
+          return;
+        }
+        continue;
+      }
+      if (!flatNanos.has_value()) {
+        flatNanos = nanos;
+      }
+      ExpressionPerfResult result;
+      result.signature = signature.toString();
+      result.expression = expression->toString();
+      result.encoding = encoding;
+      result.nanosPerRow = *nanos;
+      result.flatRatio = *flatNanos > 0 ? *nanos / *flatNanos : 1;
+      results.push_back(std::move(result));
+    }
+  }
+
+  // Returns the mean time in nanoseconds per row of evaluating
+  // 'expression' over 'input'.
+  double time(const core::TypedExprPtr& expression, const RowVectorPtr& input) {
+    exec::ExprSet exprSet({expression}, &execCtx_);
+    SelectivityVector rows(input->size());
+    std::vector<VectorPtr> result(1);
+    // Warms up caches and fails fast on errors.
+    {
+      exec::EvalCtx evalCtx(&execCtx_, &exprSet, input.get());
+      exprSet.eval(rows, &evalCtx, &result);
+    }
+    uint64_t micros = 0;
+    {
+      MicrosecondTimer timer(&micros);
+      for (auto i = 0; i < FLAGS_perf_iterations; ++i) {
+        result[0] = nullptr;
+        exec::EvalCtx evalCtx(&execCtx_, &exprSet, input.get());
+        exprSet.eval(rows, &evalCtx, &result);
+      }
+    }
+    return micros * 1000.0 / (FLAGS_perf_iterations * input->size());
+  }
+
+  RowVectorPtr makeInput(const RowTypePtr& type, const std::string& encoding) {
+    VectorFuzzer::Options options;
+    options.vectorSize = FLAGS_perf_batch_size;
+    options.stringVariableLength = true;
+    options.nullRatio = encoding == "null_heavy" ? 0.9 : 0;
+    options.dictionaryHasNulls = false;
+    vectorFuzzer_.setOptions(options);
+
+    std::vector<VectorPtr> children;
+    for (const auto& childType : type->children()) {
+      auto flat = vectorFuzzer_.fuzzFlat(childType);
+      if (encoding == "dictionary") {
+        children.push_back(vectorFuzzer_.fuzzDictionary(flat));
+      } else if (encoding == "constant") {
+        children.push_back(
+            BaseVector::wrapInConstant(options.vectorSize, 0, flat));
+      } else {
+        children.push_back(flat);
+      }
+    }
+    return std::make_shared<RowVector>(
+        execCtx_.pool(),
+        type,
+        nullptr,
+        options.vectorSize,
+        std::move(children));
+  }
+
+  core::TypedExprPtr generateCall(
+      const CallableSignature& signature,
+      int32_t depth) {
+    std::vector<core::TypedExprPtr> args;
+    for (auto i = 0; i < signature.args.size(); ++i) {
+      const auto& type = signature.args[i];
+      if (i > 0 && kConstantArgsAfterFirst.count(signature.name)) {
+        args.push_back(std::make_shared<core::ConstantTypedExpr>(
+            vectorFuzzer_.randVariant(type)));
+      } else {
+        args.push_back(generateArg(type, depth));
+      }
+    }
+    return std::make_shared<core::CallTypedExpr>(
+        signature.returnType, std::move(args), signature.name);
+  }
+
+  // Returns a column or, one time in three if the depth allows, a call of
+  // a random function that returns 'type'.
+  core::TypedExprPtr generateArg(const TypePtr& type, int32_t depth) {
+    if (depth < FLAGS_perf_max_depth && folly::Random::oneIn(3, rng_)) {
+      auto it = signaturesByType_.find(type->kind());
+      if (it != signaturesByType_.end()) {
+        const auto& eligible = it->second;
+        const auto* chosen =
+            eligible[folly::Random::rand32(eligible.size(), rng_)];
+        if (!kConstantArgsAfterFirst.count(chosen->name)) {
+          return generateCall(*chosen, depth + 1);
+        }
+      }
+    }
+    inputTypes_.push_back(type);
+    inputNames_.push_back(fmt::format("c{}", inputTypes_.size() - 1));
+    return std::make_shared<core::FieldAccessTypedExpr>(
+        type, inputNames_.back());
+  }
+
+  void report(const std::vector<ExpressionPerfResult>& results) {
+    int32_t numSlow = 0;
+    int32_t numRegressed = 0;
+    for (const auto& result : results) {
+      numSlow += isSlowEncoding(result);
+      numRegressed += isPerfRegression(result);
+    }
+    LOG(INFO) << "Measured " << results.size() << " expressions and encodings: "
+              << numSlow << " non-flat encodings slower than flat by more than "
+              << FLAGS_perf_slow_encoding_ratio << "x, " << numRegressed
+              << " regressions against the baseline.";
+    auto size =
+        std::min<size_t>(results.size(), std::max(0, FLAGS_perf_report_size));
+    for (auto i = 0; i < size; ++i) {
+      const auto& result = results[i];
+      LOG(INFO) << fmt::format(
+          "{:>3} {:<10} {:>10.2f} ns/row {:>6.2f}x flat {:>8} baseline "
+          "{}{} {}",
+          i + 1,
+          result.encoding,
+          result.nanosPerRow,
+          result.flatRatio,
+          result.baselineRatio.has_value()
+              ? fmt::format("{:.2f}x", *result.baselineRatio)
+              : "-",
+          isSlowEncoding(result) ? "[slow encoding]" : "",
+          isPerfRegression(result) ? "[regression]" : "",
+          result.signature);
+      VLOG(1) << "    " << result.expression;
+    }
+  }
+
+  std::shared_ptr<core::QueryCtx> queryCtx_{core::QueryCtx::createForTest()};
+  std::unique_ptr<memory::MemoryPool> pool_{
+      memory::getDefaultScopedMemoryPool()};
+  core::ExecCtx execCtx_{pool_.get(), queryCtx_.get()};
+  VectorFuzzer vectorFuzzer_;
+  FuzzerGenerator rng_;
+
+  std::vector<CallableSignature> signatures_;
+  std::unordered_map<TypeKind, std::vector<const CallableSignature*>>
+      signaturesByType_;
+
+  // The columns referenced by the expression being generated.
+  std::vector<TypePtr> inputTypes_;
+  std::vector<std::string> inputNames_;
+};
+
+} // namespace
+
+bool isPerfRegression(const ExpressionPerfResult& result) {
+  return result.baselineRatio.has_value() &&
+      *result.baselineRatio > 1 + FLAGS_perf_regression_threshold;
+}
+
+bool isSlowEncoding(const ExpressionPerfResult& result) {
+  return result.encoding != "flat" &&
+      result.flatRatio > FLAGS_perf_slow_encoding_ratio;
+}
+
+std::vector<ExpressionPerfResult> expressionPerfFuzzer(
+    FunctionSignatureMap signatureMap,
+    size_t seed) {
+  return ExpressionPerfFuzzer(std::move(signatureMap), seed).run();
+}
+
+} // namespace facebook::velox::test
@@ -0,0 +1,71 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#pragma once
+
+#include "velox/functions/FunctionRegistry.h"
+
+namespace facebook::velox::test {
+
+// One measurement of the perf fuzzer: the cost per row of evaluating an
+// expression rooted at a function signature with inputs of one encoding.
+struct ExpressionPerfResult {
+  // The signature at the root of the expression, e.g. "plus( BIGINT
+  // BIGINT ) -> BIGINT".
+  std::string signature;
+
+  // The expression that was timed.
+  std::string expression;
+
+  // One of "flat", "dictionary", "constant" or "null_heavy".
+  std::string encoding;
+
+  double nanosPerRow{0};
+
+  // 'nanosPerRow' divided by that of the same expression over flat
+  // inputs.
+  double flatRatio{1};
+
+  // 'nanosPerRow' divided by that of the baseline, if the baseline has
+  // the same signature and encoding.
+  std::optional<double> baselineRatio;
+
+  // The key of the result in a baseline file.
+  std::string key() const {
+    return signature + "|" + encoding;
+  }
+};
+
+// Generates a random expression tree for each signature in 'signatureMap'
+// and times its evaluation over flat, dictionary, constant and null heavy
+// inputs. Compares the times with the baseline given by
+// --perf_baseline_path, if any, and logs a report of the slowest
+// encodings relative to flat and of the regressions against the baseline,
+// worst first. Writes the times to --perf_save_baseline_path if set.
+// Returns the results, worst first.
+std::vector<ExpressionPerfResult> expressionPerfFuzzer(
+    FunctionSignatureMap signatureMap,
+    size_t seed);
+
+// Returns true if 'result' is a regression against the baseline by more
+// than --perf_regression_threshold.
+bool isPerfRegression(const ExpressionPerfResult& result);
+
+// Returns true if 'result' is for a non-flat encoding that is more than
+// --perf_slow_encoding_ratio times slower than flat, which points to a
+// missing fast path for that encoding.
+bool isSlowEncoding(const ExpressionPerfResult& result);
+
+} // namespace facebook::velox::test
@@ -0,0 +1,75 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <folly/init/Init.h>
+#include <gflags/gflags.h>
+#include <ctime>
+#include <string>
+#include <unordered_set>
+
+#include "velox/expression/tests/ExpressionPerfFuzzer.h"
+#include "velox/expression/tests/FuzzerRunner.h"
+#include "velox/functions/prestosql/registration/RegistrationFunctions.h"
+
+/// Times random expressions over flat, dictionary, constant and null heavy
+/// inputs to find functions without fast paths for an encoding and
+/// regressions against a previous run. Typical use:
+///
+///  $ ./velox_expression_perf_fuzzer_test \
+///         --seed 123 \
+///         --perf_save_baseline_path /tmp/baseline.tsv
+///
+///  ... change the code and rebuild ...
+///
+///  $ ./velox_expression_perf_fuzzer_test \
+///         --seed 123 \
+///         --perf_baseline_path /tmp/baseline.tsv
+///
+/// The same seed generates the same expressions, so that the results of
+/// the two runs are comparable. Exits with 1 if there are regressions.
+
+DEFINE_int64(
+    seed,
+    0,
+    "Initial seed for random number generator used to reproduce previous "
+    "results (0 means start with random seed).");
+
+DEFINE_string(
+    only,
+    "",
+    "If specified, only time expressions rooted at functions from this "
+    "comma separated list of function names (e.g: --only \"substr,ltrim\").");
+
+int main(int argc, char** argv) {
+  facebook::velox::functions::prestosql::registerAllScalarFunctions();
+  folly::init(&argc, &argv);
+
+  // cardinality(HLL) is skipped for the same reason as in
+  // ExpressionFuzzerTest.
+  std::unordered_set<std::string> skipFunctions = {"cardinality"};
+  size_t seed = FLAGS_seed == 0 ? std::time(nullptr) : FLAGS_seed;
+  LOG(INFO) << "Perf fuzzer seed: " << seed;
+  auto results = facebook::velox::test::expressionPerfFuzzer(
+      FuzzerRunner::filterSignatures(
+          facebook::velox::getFunctionSignatures(), FLAGS_only, skipFunctions),
+      seed);
+  for (const auto& result : results) {
+    if (facebook::velox::test::isPerfRegression(result)) {
+      return 1;
+    }
+  }
+  return 0;
+}
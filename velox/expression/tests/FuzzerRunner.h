@@ -59,6 +59,7 @@
 ///         --only "substr,trim"
 
 class FuzzerRunner {
+ public:
   // Parse the comma separated list of funciton names, and use it to filter the
   // input signatures.
   static facebook::velox::FunctionSignatureMap filterSignatures(
@@ -99,7 +100,6 @@ class FuzzerRunner {
     return output;
   }
 
- public:
   static int run(
       const std::string& onlyFunctions,
       size_t steps,
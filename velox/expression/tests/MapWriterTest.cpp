@@ -235,6 +235,25 @@ TEST_F(MapWriterTest, addItem) {
   assertEqualVectors(result, makeMapVector<int64_t, int64_t>({expected}));
 }
 
+TEST_F(MapWriterTest, bulkAppend) {
+  auto [result, vectorWriter] = makeTestWriter();
+  vectorWriter->reserveElements(10);
+
+  auto& mapWriter = vectorWriter->current();
+  mapWriter.emplace(1, std::nullopt);
+  std::vector<int64_t> keys{2, 3, 4};
+  std::vector<int64_t> values{20, 30, 40};
+  mapWriter.add_items(keys.data(), values.data(), keys.size());
+  EXPECT_EQ(4, vectorWriter->numElements());
+
+  vectorWriter->commit();
+  vectorWriter->finish();
+
+  map_pairs_t<int64_t, int64_t> expected = {
+      {1, std::nullopt}, {2, 20}, {3, 30}, {4, 40}};
+  assertEqualVectors(result, makeMapVector<int64_t, int64_t>({expected}));
+}
+
 TEST_F(MapWriterTest, emplace) {
   auto [result, vectorWriter] = makeTestWriter();
 
@@ -20,6 +20,7 @@
 
 #include "glog/logging.h"
 #include "gtest/gtest.h"
+#include "velox/common/base/tests/GTestUtils.h"
 #include "velox/expression/Expr.h"
 #include "velox/functions/Udf.h"
 #include "velox/functions/prestosql/tests/FunctionBaseTest.h"
@@ -1036,4 +1037,56 @@ TEST_F(SimpleFunctionTest, variadicReuseNoArgsDifferentType) {
   ASSERT_NE(resultPtr.get(), capturedArg1);
 }
 
+// Divides by its second argument and fails on division by zero. Its flat
+// inputs with no nulls take the plain loop over raw values.
+template <typename T>
+struct CheckedDivideFunction {
+  FOLLY_ALWAYS_INLINE void
+  call(int64_t& out, const int64_t& a, const int64_t& b) {
+    VELOX_USER_CHECK_NE(b, 0, "division by zero");
+    out = a / b;
+  }
+};
+
+TEST_F(SimpleFunctionTest, flatNoNulls) {
+  registerFunction<CheckedDivideFunction, int64_t, int64_t, int64_t>(
+      {"checked_divide"});
+
+  const vector_size_t size = 1'000;
+  auto data = makeRowVector({
+      makeFlatVector<int64_t>(size, [](auto row) { return row * 10; }),
+      makeFlatVector<int64_t>(size, [](auto row) { return row % 100 + 1; }),
+      makeFlatVector<int64_t>(size, [](auto row) { return row % 100; }),
+      makeFlatVector<int64_t>(
+          size, [](auto row) { return row % 7 + 1; }, nullEvery(5)),
+  });
+
+  auto result = evaluate<FlatVector<int64_t>>("checked_divide(c0, c1)", data);
+  assertEqualVectors(
+      makeFlatVector<int64_t>(
+          size, [](auto row) { return row * 10 / (row % 100 + 1); }),
+      result);
+
+  // Errors null out only the rows they occur in.
+  result = evaluate<FlatVector<int64_t>>("try(checked_divide(c0, c2))", data);
+  assertEqualVectors(
+      makeFlatVector<int64_t>(
+          size,
+          [](auto row) { return row % 100 == 0 ? 0 : row * 10 / (row % 100); },
+          [](auto row) { return row % 100 == 0; }),
+      result);
+  VELOX_ASSERT_THROW(
+      evaluate<FlatVector<int64_t>>("checked_divide(c0, c2)", data),
+      "division by zero");
+
+  // Arguments with nulls take the general path.
+  result = evaluate<FlatVector<int64_t>>("checked_divide(c0, c3)", data);
+  assertEqualVectors(
+      makeFlatVector<int64_t>(
+          size,
+          [](auto row) { return row * 10 / (row % 7 + 1); },
+          nullEvery(5)),
+      result);
+}
+
 } // namespace
@@ -96,3 +96,5 @@ DEFINE_int32(
 DEFINE_bool(avx2, true, "Enables use of AVX2 when available");
 
 DEFINE_bool(bmi2, true, "Enables use of BMI2 when available");
+
+DEFINE_bool(avx512, true, "Enables use of AVX-512 when available");
@@ -0,0 +1,166 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <type_traits>
+#include <vector>
+
+namespace facebook::velox::functions {
+
+namespace detail {
+
+// Comparators of Batcher's odd-even merge sort for 16 values. Each puts the
+// smaller value at the lower position. Leaving out the comparators that
+// touch positions past the end sorts fewer values, as if the missing values
+// were larger than any other.
+struct SortingNetwork {
+  static constexpr int32_t kMaxSize = 16;
+  static constexpr int32_t kNumComparators = 63;
+
+  constexpr SortingNetwork() : lower(), upper() {
+    int32_t n = 0;
+    for (int32_t p = 1; p < kMaxSize; p *= 2) {
+      for (int32_t k = p; k >= 1; k /= 2) {
+        for (int32_t j = k % p; j + k < kMaxSize; j += 2 * k) {
+          for (int32_t i = 0; i < k; ++i) {
+            if ((i + j) / (2 * p) == (i + j + k) / (2 * p)) {
+              lower[n] = i + j;
+              upper[n] = i + j + k;
+              ++n;
+            }
+          }
+        }
+      }
+    }
+  }
+
+  uint8_t lower[kNumComparators];
+  uint8_t upper[kNumComparators];
+};
+
+inline constexpr SortingNetwork kSortingNetwork;
+
+} // namespace detail
+
+/// Sorts up to 16 values with a sorting network. The compare and exchange
+/// steps use selects instead of branches.
+template <typename T, typename Compare>
+void sortingNetworkSort(T* values, int32_t size, Compare compare) {
+  const auto& network = detail::kSortingNetwork;
+  for (auto i = 0; i < detail::SortingNetwork::kNumComparators; ++i) {
+    const auto upper = network.upper[i];
+    if (upper >= size) {
+      continue;
+    }
+    const auto lower = network.lower[i];
+    const T a = values[lower];
+    const T b = values[upper];
+    const bool swap = compare(b, a);
+    values[lower] = swap ? b : a;
+    values[upper] = swap ? a : b;
+  }
+}
+
+/// Sorts integers with a least significant digit first radix sort on bytes.
+/// Skips the bytes that are the same in all values. 'scratch' is resized to
+/// 'size' and is reusable across calls.
+template <typename T>
+void radixSort(
+    T* values,
+    int32_t size,
+    bool ascending,
+    std::vector<T>& scratch) {
+  static_assert(std::is_integral_v<T> && !std::is_same_v<T, bool>);
+  using U = std::make_unsigned_t<T>;
+  constexpr int32_t kNumBytes = sizeof(T);
+  if (size < 2) {
+    return;
+  }
+
+  // Maps the values to unsigned keys in the order of the sort.
+  const U signBit = std::is_signed_v<T> ? U(1) << (8 * kNumBytes - 1) : 0;
+  const U mask = ascending ? signBit : static_cast<U>(~signBit);
+  auto key = [mask](T value) { return static_cast<U>(value) ^ mask; };
+
+  uint32_t counts[kNumBytes][256] = {};
+  for (auto i = 0; i < size; ++i) {
+    const U k = key(values[i]);
+    for (auto byte = 0; byte < kNumBytes; ++byte) {
+      ++counts[byte][(k >> (8 * byte)) & 0xff];
+    }
+  }
+
+  scratch.resize(size);
+  T* from = values;
+  T* to = scratch.data();
+  for (auto byte = 0; byte < kNumBytes; ++byte) {
+    auto* count = counts[byte];
+    const auto shift = 8 * byte;
+    const auto firstDigit = (key(from[0]) >> shift) & 0xff;
+    if (count[firstDigit] == static_cast<uint32_t>(size)) {
+      continue;
+    }
+    uint32_t offset = 0;
+    for (auto digit = 0; digit < 256; ++digit) {
+      const auto digitCount = count[digit];
+      count[digit] = offset;
+      offset += digitCount;
+    }
+    for (auto i = 0; i < size; ++i) {
+      to[count[(key(from[i]) >> shift) & 0xff]++] = from[i];
+    }
+    std::swap(from, to);
+  }
+  if (from != values) {
+    std::memcpy(values, from, size * sizeof(T));
+  }
+}
+
+/// Minimum number of values for radixSort() to be faster than std::sort.
+inline constexpr int32_t kMinRadixSortSize = 256;
+
+/// Sorts the non-null values of an array of primitive type. 'compare' gives
+/// the order and must agree with 'ascending'. Uses a sorting network for up
+/// to 16 numbers, a radix sort for large arrays of integers and std::sort
+/// otherwise. 'scratch' is memory for the radix sort, reusable across
+/// arrays.
+template <typename T, typename Compare>
+void sortPrimitiveValues(
+    T* values,
+    int32_t size,
+    bool ascending,
+    Compare compare,
+    std::vector<T>& scratch) {
+  if constexpr (std::is_arithmetic_v<T>) {
+    if (size <= detail::SortingNetwork::kMaxSize) {
+      sortingNetworkSort(values, size, compare);
+      return;
+    }
+  }
+  if constexpr (std::is_integral_v<T> && !std::is_same_v<T, bool>) {
+    if (size >= kMinRadixSortSize) {
+      radixSort(values, size, ascending, scratch);
+      return;
+    }
+  }
+  std::sort(values, values + size, compare);
+}
+
+} // namespace facebook::velox::functions
@@ -153,11 +153,147 @@ int64_t numLiteralChars(
   return count;
 }
 
+// Writes 'value' as 'width' decimal digits, padded with 0s.
+inline void writeDigits(char* out, int64_t value, size_t width) {
+  for (auto i = width; i > 0; --i) {
+    out[i - 1] = '0' + value % 10;
+    value /= 10;
+  }
+}
+
 } // namespace
 
+// static
+size_t DateTimeFormatter::computeFixedWidth(
+    const std::vector<DateTimeToken>& tokens) {
+  size_t width = 0;
+  for (const auto& token : tokens) {
+    if (token.type == DateTimeToken::Type::kLiteral) {
+      width += token.literal.size();
+      continue;
+    }
+    const auto digits = token.pattern.minRepresentDigits;
+    switch (token.pattern.specifier) {
+      case DateTimeFormatSpecifier::YEAR:
+      case DateTimeFormatSpecifier::YEAR_OF_ERA:
+        // Two digit years are modulo 100. Otherwise years in [0, 9999] take
+        // 4 digits.
+        if (digits != 2 && digits < 4) {
+          return 0;
+        }
+        break;
+      case DateTimeFormatSpecifier::MONTH_OF_YEAR:
+      case DateTimeFormatSpecifier::DAY_OF_MONTH:
+      case DateTimeFormatSpecifier::HOUR_OF_DAY:
+      case DateTimeFormatSpecifier::MINUTE_OF_HOUR:
+      case DateTimeFormatSpecifier::SECOND_OF_MINUTE:
+        if (digits < 2) {
+          return 0;
+        }
+        break;
+      case DateTimeFormatSpecifier::FRACTION_OF_SECOND:
+        break;
+      default:
+        return 0;
+    }
+    width += digits;
+  }
+  return width;
+}
+
+bool DateTimeFormatter::formatFixedWidth(
+    const Timestamp& timestamp,
+    char* result) const {
+  static constexpr int64_t kMillisInDay = 86'400'000;
+  // Days from 1970-01-01 to 0000-01-01 and to 10000-01-01.
+  static constexpr int64_t kMinDays = -719'528;
+  static constexpr int64_t kMaxDays = 2'932'897;
+
+  const auto millis = timestamp.toMillis();
+  auto days = millis / kMillisInDay;
+  auto millisInDay = millis % kMillisInDay;
+  if (millisInDay < 0) {
+    --days;
+    millisInDay += kMillisInDay;
+  }
+  if (days < kMinDays || days >= kMaxDays) {
+    return false;
+  }
+
+  // Civil date from days since the epoch, see
+  // http://howardhinnant.github.io/date_algorithms.html#civil_from_days. The
+  // days are shifted by one 400 years era so that all values are positive.
+  const int64_t z = days + 719'468 + 146'097;
+  const int64_t era = z / 146'097;
+  const int64_t dayOfEra = z - era * 146'097;
+  const int64_t yearOfEra =
+      (dayOfEra - dayOfEra / 1'460 + dayOfEra / 36'524 -
+       dayOfEra / 146'096) /
+      365;
+  const int64_t dayOfYear =
+      dayOfEra - (365 * yearOfEra + yearOfEra / 4 - yearOfEra / 100);
+  const int64_t shiftedMonth = (5 * dayOfYear + 2) / 153;
+  const int64_t day = dayOfYear - (153 * shiftedMonth + 2) / 5 + 1;
+  const int64_t month = shiftedMonth < 10 ? shiftedMonth + 3 : shiftedMonth - 9;
+  const int64_t year = yearOfEra + (era - 1) * 400 + (month <= 2);
+
+  char* out = result;
+  for (const auto& token : tokens_) {
+    if (token.type == DateTimeToken::Type::kLiteral) {
+      memcpy(out, token.literal.data(), token.literal.size());
+      out += token.literal.size();
+      continue;
+    }
+    const auto digits = token.pattern.minRepresentDigits;
+    switch (token.pattern.specifier) {
+      case DateTimeFormatSpecifier::YEAR:
+        writeDigits(out, digits == 2 ? year % 100 : year, digits);
+        break;
+      case DateTimeFormatSpecifier::YEAR_OF_ERA:
+        // Year 0 is year 1 before the common era.
+        writeDigits(
+            out, digits == 2 ? year % 100 : std::max<int64_t>(year, 1), digits);
+        break;
+      case DateTimeFormatSpecifier::MONTH_OF_YEAR:
+        writeDigits(out, month, digits);
+        break;
+      case DateTimeFormatSpecifier::DAY_OF_MONTH:
+        writeDigits(out, day, digits);
+        break;
+      case DateTimeFormatSpecifier::HOUR_OF_DAY:
+        writeDigits(out, millisInDay / 3'600'000, digits);
+        break;
+      case DateTimeFormatSpecifier::MINUTE_OF_HOUR:
+        writeDigits(out, millisInDay / 60'000 % 60, digits);
+        break;
+      case DateTimeFormatSpecifier::SECOND_OF_MINUTE:
+        writeDigits(out, millisInDay / 1'000 % 60, digits);
+        break;
+      case DateTimeFormatSpecifier::FRACTION_OF_SECOND: {
+        char fraction[3];
+        writeDigits(fraction, millisInDay % 1'000, 3);
+        const auto numFractionDigits = std::min<size_t>(digits, 3);
+        memcpy(out, fraction, numFractionDigits);
+        memset(out + numFractionDigits, '0', digits - numFractionDigits);
+      } break;
+      default:
+        VELOX_UNREACHABLE();
+    }
+    out += digits;
+  }
+  return true;
+}
+
 std::string DateTimeFormatter::format(
     const Timestamp& timestamp,
     const date::time_zone* timezone) const {
+  if (fixedWidth_ > 0) {
+    std::string result(fixedWidth_, '\0');
+    if (formatFixedWidth(timestamp, result.data())) {
+      return result;
+    }
+  }
+
   const std::chrono::
       time_point<std::chrono::system_clock, std::chrono::milliseconds>
           timePoint(std::chrono::milliseconds(timestamp.toMillis()));
@@ -301,14 +437,14 @@ std::string DateTimeFormatter::format(
               token.pattern.minRepresentDigits);
           break;
 
-        case DateTimeFormatSpecifier::FRACTION_OF_SECOND:
-          result += padContent(
-                        durationInTheDay.subseconds().count(),
-                        '0',
-                        token.pattern.minRepresentDigits,
-                        false)
-                        .substr(0, token.pattern.minRepresentDigits);
-          break;
+        case DateTimeFormatSpecifier::FRACTION_OF_SECOND: {
+          // The milliseconds as 3 digits, padded with 0s or truncated to the
+          // number of digits of the pattern.
+          auto fraction =
+              padContent(durationInTheDay.subseconds().count(), '0', 3);
+          fraction.resize(token.pattern.minRepresentDigits, '0');
+          result += fraction;
+        } break;
         case DateTimeFormatSpecifier::TIMEZONE:
           // TODO: implement short name time zone, need a map from full name to
           // short name
@@ -155,7 +155,8 @@ class DateTimeFormatter {
       std::vector<DateTimeToken>&& tokens)
       : literalBuf_(std::move(literalBuf)),
         bufSize_(bufSize),
-        tokens_(std::move(tokens)) {}
+        tokens_(std::move(tokens)),
+        fixedWidth_(computeFixedWidth(tokens_)) {}
 
   const std::unique_ptr<char[]>& literalBuf() const {
     return literalBuf_;
@@ -177,10 +178,27 @@ class DateTimeFormatter {
       const Timestamp& timestamp,
       const date::time_zone* timezone) const;
 
+  /// Returns the size of all results of format() if the layout only has
+  /// literals and numeric fields of constant width, e.g. '%Y-%m-%d %H:%i:%s'
+  /// or "yyyy-MM-dd'T'HH:mm:ss.SSS". Returns 0 otherwise.
+  size_t fixedWidth() const {
+    return fixedWidth_;
+  }
+
+  /// Fast path of format() for layouts with a fixed width. Writes fixedWidth()
+  /// bytes to 'result' and returns true. Returns false, leaving 'result' in
+  /// an undefined state, if the year of 'timestamp' is outside [0, 9999] and
+  /// does not fit the layout. Computes the fields with integer arithmetic
+  /// and does not allocate.
+  bool formatFixedWidth(const Timestamp& timestamp, char* result) const;
+
  private:
+  static size_t computeFixedWidth(const std::vector<DateTimeToken>& tokens);
+
   std::unique_ptr<char[]> literalBuf_;
   size_t bufSize_;
   std::vector<DateTimeToken> tokens_;
+  const size_t fixedWidth_;
 };
 
 std::shared_ptr<DateTimeFormatter> buildMysqlDateTimeFormatter(
@@ -16,6 +16,7 @@
 
 #pragma once
 
+#include <algorithm>
 #include <cmath>
 #include <queue>
 #include <type_traits>
@@ -287,6 +288,55 @@ void KllSketch<T, A, C>::insert(T value) {
   doInsert(value);
 }
 
+template <typename T, typename A, typename C>
+void KllSketch<T, A, C>::insert(const T* values, size_t size) {
+  if (size == 0) {
+    return;
+  }
+  if (n_ == 0) {
+    minValue_ = maxValue_ = values[0];
+  }
+  for (size_t i = 0; i < size; ++i) {
+    minValue_ = std::min(minValue_, values[i], C());
+    maxValue_ = std::max(maxValue_, values[i], C());
+  }
+  VELOX_DCHECK_GT(k_, 0);
+  VELOX_DCHECK_GE(levels_.size(), 2);
+  size_t i = 0;
+  if (items_.size() < k_) {
+    const auto count = std::min<size_t>(k_ - items_.size(), size);
+    reserveItems(items_.size() + count);
+    items_.insert(items_.end(), values, values + count);
+    levels_[1] += count;
+    i = count;
+  }
+  while (i < size) {
+    if (levels_[0] == 0) {
+      items_[insertPosition()] = values[i++];
+      continue;
+    }
+    // Fills the free space below level zero from the top down, in the order
+    // insert() would, so that the sketch ends up the same.
+    const auto count = std::min<size_t>(levels_[0], size - i);
+    levels_[0] -= count;
+    std::reverse_copy(
+        values + i, values + i + count, items_.data() + levels_[0]);
+    i += count;
+  }
+  n_ += size;
+  isLevelZeroSorted_ = false;
+}
+
+template <typename T, typename A, typename C>
+void KllSketch<T, A, C>::reserveItems(size_t size) {
+  // Grows geometrically up to k, then to exactly the capacity of the levels,
+  // so that the memory used is at most the capacity of the sketch.
+  if (size > items_.capacity()) {
+    const auto capacity = std::max<size_t>({size, 2 * items_.capacity(), 8});
+    items_.reserve(size > k_ ? size : std::min<size_t>(capacity, k_));
+  }
+}
+
 template <typename T, typename A, typename C>
 void KllSketch<T, A, C>::doInsert(T value) {
   VELOX_DCHECK_GT(k_, 0);
@@ -294,6 +344,7 @@ void KllSketch<T, A, C>::doInsert(T value) {
   if (items_.size() < k_) {
     // Do not allocate all k elements in the beginning because in some group-by
     // aggregation most of the group size is small and won't use all k spaces.
+    reserveItems(items_.size() + 1);
     items_.push_back(value);
     ++levels_[1];
   } else {
@@ -397,6 +448,7 @@ void KllSketch<T, A, C>::addEmptyTopLevelToCompletelyFullSketch() {
 
   const uint32_t deltaCap = detail::levelCapacity(k_, numLevels() + 1, 0);
   const uint32_t newTotalCap = curTotalCap + deltaCap;
+  reserveItems(newTotalCap);
   items_.resize(newTotalCap);
   std::move_backward(
       items_.begin(), items_.begin() + curTotalCap, items_.end());
@@ -584,6 +636,7 @@ void KllSketch<T, A, C>::mergeViews(const folly::Range<const View*>& others) {
         randomBit_);
     VELOX_DCHECK_LE(result.finalNumLevels, ub);
     // Now we need to transfer the results back into "this" sketch.
+    reserveItems(result.finalCapacity);
     items_.resize(result.finalCapacity);
     const auto freeSpaceAtBottom = result.finalCapacity - result.finalNumItems;
     std::move(
@@ -60,6 +60,11 @@ struct KllSketch {
   /// Add one new value to the sketch.
   void insert(T value);
 
+  /// Add 'size' new values to the sketch.  Equivalent to calling
+  /// insert(value) for each value, but copies the values to the bottom
+  /// level in blocks.
+  void insert(const T* values, size_t size);
+
   /// Merge this sketch with values from multiple other sketches.
   /// @tparam Iter Iterator type dereferenceable to the same type as this sketch
   ///  (KllSketch<T, Allocator, Compare>)
@@ -126,6 +131,7 @@ struct KllSketch {
  private:
   KllSketch(const Allocator&, uint32_t seed);
   void doInsert(T);
+  void reserveItems(size_t size);
   uint32_t insertPosition();
   int findLevelToCompact() const;
   void addEmptyTopLevelToCompletelyFullSketch();
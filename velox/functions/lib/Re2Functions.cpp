@@ -16,6 +16,7 @@
 #include "velox/functions/lib/Re2Functions.h"
 
 #include <re2/re2.h>
+#include <cstring>
 #include <optional>
 #include <string>
 
@@ -67,6 +68,24 @@ void checkForBadPattern(const RE2& re) {
   }
 }
 
+// Looks up the per-row patterns of a batch in Re2Cache::instance(). Rows with
+// the same pattern as the previous row, e.g. from a dictionary over a small
+// lookup table, skip the lookup.
+class Re2BatchPatterns {
+ public:
+  const RE2& get(StringView pattern) {
+    if (!re_.get() || pattern != pattern_) {
+      re_ = Re2Cache::instance().get(pattern);
+      pattern_ = pattern;
+    }
+    return *re_;
+  }
+
+ private:
+  StringView pattern_;
+  Re2Cache::Ptr re_;
+};
+
 FlatVector<bool>& ensureWritableBool(
     const SelectivityVector& rows,
     velox::memory::MemoryPool* pool,
@@ -185,7 +204,7 @@ template <bool (*Fn)(StringView, const RE2&)>
 class Re2MatchConstantPattern final : public VectorFunction {
  public:
   explicit Re2MatchConstantPattern(StringView pattern)
-      : re_(toStringPiece(pattern), RE2::Quiet) {}
+      : re_(Re2Cache::instance().get(pattern)) {}
 
   void apply(
       const SelectivityVector& rows,
@@ -197,14 +216,14 @@ class Re2MatchConstantPattern final : public VectorFunction {
     FlatVector<bool>& result =
         ensureWritableBool(rows, context->pool(), resultRef);
     exec::LocalDecodedVector toSearch(context, *args[0], rows);
-    checkForBadPattern(re_);
+    checkForBadPattern(*re_);
     rows.applyToSelected([&](vector_size_t i) {
-      result.set(i, Fn(toSearch->valueAt<StringView>(i), re_));
+      result.set(i, Fn(toSearch->valueAt<StringView>(i), *re_));
     });
   }
 
  private:
-  RE2 re_;
+  const Re2Cache::Ptr re_;
 };
 
 template <bool (*Fn)(StringView, const RE2&)>
@@ -227,8 +246,9 @@ class Re2Match final : public VectorFunction {
         ensureWritableBool(rows, context->pool(), resultRef);
     exec::LocalDecodedVector toSearch(context, *args[0], rows);
     exec::LocalDecodedVector pattern(context, *args[1], rows);
+    Re2BatchPatterns patterns;
     rows.applyToSelected([&](vector_size_t row) {
-      RE2 re(toStringPiece(pattern->valueAt<StringView>(row)), RE2::Quiet);
+      const auto& re = patterns.get(pattern->valueAt<StringView>(row));
       checkForBadPattern(re);
       result.set(row, Fn(toSearch->valueAt<StringView>(row), re));
     });
@@ -247,7 +267,7 @@ class Re2SearchAndExtractConstantPattern final : public VectorFunction {
   explicit Re2SearchAndExtractConstantPattern(
       StringView pattern,
       bool emptyNoMatch)
-      : re_(toStringPiece(pattern), RE2::Quiet), emptyNoMatch_(emptyNoMatch) {}
+      : re_(Re2Cache::instance().get(pattern)), emptyNoMatch_(emptyNoMatch) {}
 
   void apply(
       const SelectivityVector& rows,
@@ -261,7 +281,7 @@ class Re2SearchAndExtractConstantPattern final : public VectorFunction {
         ensureWritableStringView(rows, context->pool(), resultRef);
 
     // apply() will not be invoked if the selection is empty.
-    checkForBadPattern(re_);
+    checkForBadPattern(*re_);
 
     exec::LocalDecodedVector toSearch(context, *args[0], rows);
     bool mustRefSourceStrings = false;
@@ -271,7 +291,7 @@ class Re2SearchAndExtractConstantPattern final : public VectorFunction {
       groups.resize(1);
       rows.applyToSelected([&](vector_size_t i) {
         mustRefSourceStrings |=
-            re2Extract(result, i, re_, toSearch, groups, 0, emptyNoMatch_);
+            re2Extract(result, i, *re_, toSearch, groups, 0, emptyNoMatch_);
       });
       if (mustRefSourceStrings) {
         result.acquireSharedStringBuffers(toSearch->base());
@@ -280,11 +300,11 @@ class Re2SearchAndExtractConstantPattern final : public VectorFunction {
     }
 
     if (const auto groupId = getIfConstant<T>(*args[2])) {
-      checkForBadGroupId(*groupId, re_);
+      checkForBadGroupId(*groupId, *re_);
       groups.resize(*groupId + 1);
       rows.applyToSelected([&](vector_size_t i) {
         mustRefSourceStrings |= re2Extract(
-            result, i, re_, toSearch, groups, *groupId, emptyNoMatch_);
+            result, i, *re_, toSearch, groups, *groupId, emptyNoMatch_);
       });
       if (mustRefSourceStrings) {
         result.acquireSharedStringBuffers(toSearch->base());
@@ -300,13 +320,13 @@ class Re2SearchAndExtractConstantPattern final : public VectorFunction {
       maxGroupId = std::max(groupIds->valueAt<T>(i), maxGroupId);
       minGroupId = std::min(groupIds->valueAt<T>(i), minGroupId);
     });
-    checkForBadGroupId(maxGroupId, re_);
-    checkForBadGroupId(minGroupId, re_);
+    checkForBadGroupId(maxGroupId, *re_);
+    checkForBadGroupId(minGroupId, *re_);
     groups.resize(maxGroupId + 1);
     rows.applyToSelected([&](vector_size_t i) {
       T group = groupIds->valueAt<T>(i);
       mustRefSourceStrings |=
-          re2Extract(result, i, re_, toSearch, groups, group, emptyNoMatch_);
+          re2Extract(result, i, *re_, toSearch, groups, group, emptyNoMatch_);
     });
     if (mustRefSourceStrings) {
       result.acquireSharedStringBuffers(toSearch->base());
@@ -314,7 +334,7 @@ class Re2SearchAndExtractConstantPattern final : public VectorFunction {
   }
 
  private:
-  RE2 re_;
+  const Re2Cache::Ptr re_;
   const bool emptyNoMatch_;
 }; // namespace
 
@@ -339,18 +359,19 @@ class Re2SearchAndExtract final : public VectorFunction {
       return;
     }
 
-    // The general case. Further optimizations are possible to avoid regex
-    // recompilation, but a constant pattern is by far the most common case.
+    // The general case. Patterns are compiled once per process through
+    // Re2Cache.
     FlatVector<StringView>& result =
         ensureWritableStringView(rows, context->pool(), resultRef);
     exec::LocalDecodedVector toSearch(context, *args[0], rows);
     exec::LocalDecodedVector pattern(context, *args[1], rows);
+    Re2BatchPatterns patterns;
     bool mustRefSourceStrings = false;
     FOLLY_DECLARE_REUSED(groups, std::vector<re2::StringPiece>);
     if (args.size() == 2) {
       groups.resize(1);
       rows.applyToSelected([&](vector_size_t i) {
-        RE2 re(toStringPiece(pattern->valueAt<StringView>(i)), RE2::Quiet);
+        const auto& re = patterns.get(pattern->valueAt<StringView>(i));
         checkForBadPattern(re);
         mustRefSourceStrings |=
             re2Extract(result, i, re, toSearch, groups, 0, emptyNoMatch_);
@@ -359,7 +380,7 @@ class Re2SearchAndExtract final : public VectorFunction {
       exec::LocalDecodedVector groupIds(context, *args[2], rows);
       rows.applyToSelected([&](vector_size_t i) {
         const auto groupId = groupIds->valueAt<T>(i);
-        RE2 re(toStringPiece(pattern->valueAt<StringView>(i)), RE2::Quiet);
+        const auto& re = patterns.get(pattern->valueAt<StringView>(i));
         checkForBadPattern(re);
         checkForBadGroupId(groupId, re);
         groups.resize(groupId + 1);
@@ -376,11 +397,200 @@ class Re2SearchAndExtract final : public VectorFunction {
   const bool emptyNoMatch_;
 };
 
+// Shapes of LIKE patterns that are matched without RE2. 'L' stands for a
+// literal without wildcards.
+enum class LikePatternKind {
+  // L
+  kExact,
+  // L%
+  kPrefix,
+  // %L
+  kSuffix,
+  // %L%
+  kSubstring,
+  // L%L
+  kPrefixSuffix,
+  // Anything else, e.g. with '_' or more than two literals.
+  kGeneric,
+};
+
+// Result of splitting a valid LIKE pattern into unescaped literals and
+// wildcards.
+struct LikePattern {
+  LikePatternKind kind{LikePatternKind::kGeneric};
+
+  // The literals. For kPrefixSuffix the prefix is 'first' and the suffix
+  // 'second'. For the other kinds except kGeneric, 'first' is the literal.
+  std::string first;
+  std::string second;
+
+  // For kGeneric, the longest literal. Every match contains it.
+  std::string requiredLiteral;
+};
+
+LikePattern analyzeLikePattern(
+    StringView pattern,
+    std::optional<char> escapeChar) {
+  // Sequence of literals and wildcards. Wildcards are stored as '%' and '_'
+  // with 'isWildcard' set and consecutive '%' are collapsed.
+  struct Token {
+    bool isWildcard;
+    std::string text;
+  };
+  std::vector<Token> tokens;
+  bool escaped = false;
+  for (const char c : pattern) {
+    if (!escaped && c == escapeChar) {
+      escaped = true;
+      continue;
+    }
+    if (!escaped && (c == '%' || c == '_')) {
+      if (!(c == '%' && !tokens.empty() && tokens.back().isWildcard &&
+            tokens.back().text == "%")) {
+        tokens.push_back({true, std::string(1, c)});
+      }
+    } else {
+      if (tokens.empty() || tokens.back().isWildcard) {
+        tokens.push_back({false, ""});
+      }
+      tokens.back().text.append(1, c);
+    }
+    escaped = false;
+  }
+
+  LikePattern result;
+  bool hasAnyChar = false;
+  for (const auto& token : tokens) {
+    if (!token.isWildcard) {
+      if (token.text.size() > result.requiredLiteral.size()) {
+        result.requiredLiteral = token.text;
+      }
+    } else if (token.text == "_") {
+      hasAnyChar = true;
+    }
+  }
+  if (hasAnyChar) {
+    return result;
+  }
+
+  // Describes 'tokens' as a string of 'L' and '%'.
+  std::string shape;
+  for (const auto& token : tokens) {
+    shape.append(token.isWildcard ? "%" : "L");
+  }
+  if (shape.empty() || shape == "L") {
+    result.kind = LikePatternKind::kExact;
+  } else if (shape == "%" || shape == "L%") {
+    result.kind = LikePatternKind::kPrefix;
+  } else if (shape == "%L") {
+    result.kind = LikePatternKind::kSuffix;
+  } else if (shape == "%L%") {
+    result.kind = LikePatternKind::kSubstring;
+  } else if (shape == "L%L") {
+    result.kind = LikePatternKind::kPrefixSuffix;
+    result.second = tokens[2].text;
+  } else {
+    return result;
+  }
+  for (const auto& token : tokens) {
+    if (!token.isWildcard) {
+      result.first = token.text;
+      break;
+    }
+  }
+  return result;
+}
+
+bool containsLiteral(StringView input, const std::string& literal) {
+  return literal.empty() ||
+      memmem(input.data(), input.size(), literal.data(), literal.size()) !=
+      nullptr;
+}
+
+// Evaluates 'match' on a flat or constant first argument.
+template <typename Match>
+void applyLike(
+    const SelectivityVector& rows,
+    std::vector<VectorPtr>& args,
+    EvalCtx* context,
+    VectorPtr* resultRef,
+    Match match) {
+  FlatVector<bool>& result =
+      ensureWritableBool(rows, context->pool(), resultRef);
+
+  exec::DecodedArgs decodedArgs(rows, args, context);
+  auto toSearch = decodedArgs.at(0);
+  if (toSearch->isIdentityMapping()) {
+    auto rawStrings = toSearch->data<StringView>();
+    rows.applyToSelected(
+        [&](vector_size_t i) { result.set(i, match(rawStrings[i])); });
+    return;
+  }
+
+  if (toSearch->isConstantMapping()) {
+    bool matched = match(toSearch->valueAt<StringView>(0));
+    rows.applyToSelected([&](vector_size_t i) { result.set(i, matched); });
+    return;
+  }
+
+  // Since the likePattern and escapeChar (2nd and 3rd args) are both
+  // constants, so the first arg is expected to be either of flat or constant
+  // vector only. This code path is unreachable.
+  VELOX_UNREACHABLE();
+}
+
+// LIKE with a pattern of one of the shapes matched without RE2.
+template <LikePatternKind kind>
+class OptimizedLikeConstantPattern final : public VectorFunction {
+ public:
+  explicit OptimizedLikeConstantPattern(LikePattern pattern)
+      : first_(std::move(pattern.first)), second_(std::move(pattern.second)) {}
+
+  void apply(
+      const SelectivityVector& rows,
+      std::vector<VectorPtr>& args,
+      const TypePtr& /* outputType */,
+      EvalCtx* context,
+      VectorPtr* resultRef) const final {
+    VELOX_CHECK(args.size() == 2 || args.size() == 3);
+    applyLike(rows, args, context, resultRef, [&](StringView input) {
+      return match(input);
+    });
+  }
+
+ private:
+  bool match(StringView input) const {
+    switch (kind) {
+      case LikePatternKind::kExact:
+        return input == StringView(first_);
+      case LikePatternKind::kPrefix:
+        return input.startsWith(first_);
+      case LikePatternKind::kSuffix:
+        return input.endsWith(first_);
+      case LikePatternKind::kSubstring:
+        return containsLiteral(input, first_);
+      case LikePatternKind::kPrefixSuffix:
+        return input.size() >= first_.size() + second_.size() &&
+            input.startsWith(first_) && input.endsWith(second_);
+      case LikePatternKind::kGeneric:
+        VELOX_UNREACHABLE();
+    }
+  }
+
+  const std::string first_;
+  const std::string second_;
+};
+
 class LikeConstantPattern final : public VectorFunction {
  public:
   LikeConstantPattern(StringView pattern, std::optional<char> escapeChar)
       : re_(toStringPiece(likePatternToRe2(pattern, escapeChar, validPattern_)),
-            RE2::Quiet) {}
+            likeRe2Options()) {
+    if (validPattern_) {
+      requiredLiteral_ =
+          analyzeLikePattern(pattern, escapeChar).requiredLiteral;
+    }
+  }
 
   void apply(
       const SelectivityVector& rows,
@@ -399,34 +609,25 @@ class LikeConstantPattern final : public VectorFunction {
 
     // apply() will not be invoked if the selection is empty.
     checkForBadPattern(re_);
-    FlatVector<bool>& result =
-        ensureWritableBool(rows, context->pool(), resultRef);
-
-    exec::DecodedArgs decodedArgs(rows, args, context);
-    auto toSearch = decodedArgs.at(0);
-    if (toSearch->isIdentityMapping()) {
-      auto rawStrings = toSearch->data<StringView>();
-      rows.applyToSelected([&](vector_size_t i) {
-        result.set(i, re2FullMatch(rawStrings[i], re_));
-      });
-      return;
-    }
-
-    if (toSearch->isConstantMapping()) {
-      bool match = re2FullMatch(toSearch->valueAt<StringView>(0), re_);
-      rows.applyToSelected([&](vector_size_t i) { result.set(i, match); });
-      return;
-    }
-
-    // Since the likePattern and escapeChar (2nd and 3rd args) are both
-    // constants, so the first arg is expected to be either of flat or constant
-    // vector only. This code path is unreachable.
-    VELOX_UNREACHABLE();
+    // Strings without the longest literal of the pattern cannot match. Checking
+    // for it is much cheaper than running RE2.
+    applyLike(rows, args, context, resultRef, [&](StringView input) {
+      return containsLiteral(input, requiredLiteral_) &&
+          re2FullMatch(input, re_);
+    });
   }
 
  private:
+  // '%' and '_' match any character, including new lines.
+  static RE2::Options likeRe2Options() {
+    RE2::Options options(RE2::Quiet);
+    options.set_dot_nl(true);
+    return options;
+  }
+
   RE2 re_;
   bool validPattern_;
+  std::string requiredLiteral_;
 };
 
 void re2ExtractAll(
@@ -460,7 +661,7 @@ template <typename T>
 class Re2ExtractAllConstantPattern final : public VectorFunction {
  public:
   explicit Re2ExtractAllConstantPattern(StringView pattern)
-      : re_(toStringPiece(pattern), RE2::Quiet) {}
+      : re_(Re2Cache::instance().get(pattern)) {}
 
   void apply(
       const SelectivityVector& rows,
@@ -469,7 +670,7 @@ class Re2ExtractAllConstantPattern final : public VectorFunction {
       EvalCtx* context,
       VectorPtr* resultRef) const final {
     VELOX_CHECK(args.size() == 2 || args.size() == 3);
-    checkForBadPattern(re_);
+    checkForBadPattern(*re_);
 
     ArrayBuilder<Varchar> builder(
         rows.size(), rows.countSelected() * 3, context->pool());
@@ -481,15 +682,15 @@ class Re2ExtractAllConstantPattern final : public VectorFunction {
       //
       groups.resize(1);
       context->applyToSelectedNoThrow(rows, [&](vector_size_t row) {
-        re2ExtractAll(builder, re_, inputStrs, row, groups, 0);
+        re2ExtractAll(builder, *re_, inputStrs, row, groups, 0);
       });
     } else if (const auto _groupId = getIfConstant<T>(*args[2])) {
       // Case 2: Constant groupId
       //
-      checkForBadGroupId(*_groupId, re_);
+      checkForBadGroupId(*_groupId, *re_);
       groups.resize(*_groupId + 1);
       context->applyToSelectedNoThrow(rows, [&](vector_size_t row) {
-        re2ExtractAll(builder, re_, inputStrs, row, groups, *_groupId);
+        re2ExtractAll(builder, *re_, inputStrs, row, groups, *_groupId);
       });
     } else {
       // Case 3: Variable groupId, so resize the groups vector to accommodate
@@ -501,13 +702,13 @@ class Re2ExtractAllConstantPattern final : public VectorFunction {
         maxGroupId = std::max(groupIds->valueAt<T>(row), maxGroupId);
         minGroupId = std::min(groupIds->valueAt<T>(row), minGroupId);
       });
-      checkForBadGroupId(maxGroupId, re_);
-      checkForBadGroupId(minGroupId, re_);
+      checkForBadGroupId(maxGroupId, *re_);
+      checkForBadGroupId(minGroupId, *re_);
       groups.resize(maxGroupId + 1);
       context->applyToSelectedNoThrow(rows, [&](vector_size_t row) {
         const T groupId = groupIds->valueAt<T>(row);
-        checkForBadGroupId(groupId, re_);
-        re2ExtractAll(builder, re_, inputStrs, row, groups, groupId);
+        checkForBadGroupId(groupId, *re_);
+        re2ExtractAll(builder, *re_, inputStrs, row, groups, groupId);
       });
     }
 
@@ -520,7 +721,7 @@ class Re2ExtractAllConstantPattern final : public VectorFunction {
   }
 
  private:
-  RE2 re_;
+  const Re2Cache::Ptr re_;
 };
 
 template <typename T>
@@ -545,6 +746,7 @@ class Re2ExtractAll final : public VectorFunction {
         rows.size(), rows.countSelected() * 3, context->pool());
     exec::LocalDecodedVector inputStrs(context, *args[0], rows);
     exec::LocalDecodedVector pattern(context, *args[1], rows);
+    Re2BatchPatterns patterns;
     FOLLY_DECLARE_REUSED(groups, std::vector<re2::StringPiece>);
 
     if (args.size() == 2) {
@@ -552,7 +754,7 @@ class Re2ExtractAll final : public VectorFunction {
       //
       groups.resize(1);
       context->applyToSelectedNoThrow(rows, [&](vector_size_t row) {
-        RE2 re(toStringPiece(pattern->valueAt<StringView>(row)), RE2::Quiet);
+        const auto& re = patterns.get(pattern->valueAt<StringView>(row));
         checkForBadPattern(re);
         re2ExtractAll(builder, re, inputStrs, row, groups, 0);
       });
@@ -562,7 +764,7 @@ class Re2ExtractAll final : public VectorFunction {
       exec::LocalDecodedVector groupIds(context, *args[2], rows);
       context->applyToSelectedNoThrow(rows, [&](vector_size_t row) {
         const T groupId = groupIds->valueAt<T>(row);
-        RE2 re(toStringPiece(pattern->valueAt<StringView>(row)), RE2::Quiet);
+        const auto& re = patterns.get(pattern->valueAt<StringView>(row));
         checkForBadPattern(re);
         checkForBadGroupId(groupId, re);
         groups.resize(groupId + 1);
@@ -604,6 +806,41 @@ std::shared_ptr<VectorFunction> makeRe2MatchImpl(
 
 } // namespace
 
+std::unique_ptr<RE2> Re2Cache::Generator::operator()(
+    const std::string& pattern) const {
+  return std::make_unique<RE2>(pattern, RE2::Quiet);
+}
+
+Re2Cache::Re2Cache(int64_t maxEntries)
+    : factory_(
+          std::make_unique<SimpleLRUCache<std::string, RE2>>(maxEntries),
+          std::make_unique<Generator>()) {}
+
+// static
+Re2Cache& Re2Cache::instance() {
+  // Leaked so that functions destroyed at exit can still release their
+  // patterns.
+  static auto* instance = new Re2Cache(kDefaultMaxEntries);
+  return *instance;
+}
+
+Re2Cache::Ptr Re2Cache::get(StringView pattern) {
+  auto re = factory_.generate(std::string(pattern));
+  if (re.wasCached()) {
+    numHits_.fetch_add(1, std::memory_order_relaxed);
+  } else {
+    numMisses_.fetch_add(1, std::memory_order_relaxed);
+  }
+  return re;
+}
+
+Re2Cache::Stats Re2Cache::stats() const {
+  return {
+      numHits_.load(std::memory_order_relaxed),
+      numMisses_.load(std::memory_order_relaxed),
+      factory_.currentSize()};
+}
+
 std::shared_ptr<VectorFunction> makeRe2Match(
     const std::string& name,
     const std::vector<VectorFunctionArg>& inputArgs) {
@@ -770,7 +1007,38 @@ std::shared_ptr<exec::VectorFunction> makeLike(
       name,
       inputArgs[1].type->toString());
   auto pattern = constantPattern->as<ConstantVector<StringView>>()->valueAt(0);
-  return std::make_shared<LikeConstantPattern>(pattern, escapeChar);
+  bool validPattern;
+  likePatternToRe2(pattern, escapeChar, validPattern);
+  if (!validPattern) {
+    // Reports the error on evaluation.
+    return std::make_shared<LikeConstantPattern>(pattern, escapeChar);
+  }
+  auto analyzed = analyzeLikePattern(pattern, escapeChar);
+  switch (analyzed.kind) {
+    case LikePatternKind::kExact:
+      return std::make_shared<
+          OptimizedLikeConstantPattern<LikePatternKind::kExact>>(
+          std::move(analyzed));
+    case LikePatternKind::kPrefix:
+      return std::make_shared<
+          OptimizedLikeConstantPattern<LikePatternKind::kPrefix>>(
+          std::move(analyzed));
+    case LikePatternKind::kSuffix:
+      return std::make_shared<
+          OptimizedLikeConstantPattern<LikePatternKind::kSuffix>>(
+          std::move(analyzed));
+    case LikePatternKind::kSubstring:
+      return std::make_shared<
+          OptimizedLikeConstantPattern<LikePatternKind::kSubstring>>(
+          std::move(analyzed));
+    case LikePatternKind::kPrefixSuffix:
+      return std::make_shared<
+          OptimizedLikeConstantPattern<LikePatternKind::kPrefixSuffix>>(
+          std::move(analyzed));
+    case LikePatternKind::kGeneric:
+      return std::make_shared<LikeConstantPattern>(pattern, escapeChar);
+  }
+  VELOX_UNREACHABLE();
 }
 
 std::vector<std::shared_ptr<exec::FunctionSignature>> likeSignatures() {
@@ -15,11 +15,13 @@
  */
 #pragma once
 
+#include <atomic>
 #include <memory>
 #include <vector>
 
 #include <re2/re2.h>
 
+#include "velox/common/caching/CachedFactory.h"
 #include "velox/expression/VectorFunction.h"
 #include "velox/functions/Udf.h"
 #include "velox/vector/BaseVector.h"
@@ -31,6 +33,44 @@ namespace facebook::velox::functions {
 /// backtracking and associated features (e.g. backreferences).
 /// See https://github.com/google/re2/wiki/Syntax for more information.
 
+/// Process-wide cache of compiled regular expressions, keyed on the pattern.
+/// Lets functions compile a pattern once per process instead of once per
+/// function instance, or once per row for patterns that are not constant.
+/// Thread-safe. Keeps at most 'maxEntries' patterns that are not in use,
+/// evicting the oldest first.
+class Re2Cache {
+ public:
+  /// Keeps the RE2 in the cache while alive.
+  using Ptr = CachedPtr<std::string, RE2>;
+
+  struct Stats {
+    int64_t numHits{0};
+    int64_t numMisses{0};
+    int64_t numEntries{0};
+  };
+
+  explicit Re2Cache(int64_t maxEntries);
+
+  static Re2Cache& instance();
+
+  /// Returns 'pattern' compiled with RE2::Quiet. The caller must check
+  /// RE2::ok().
+  Ptr get(StringView pattern);
+
+  Stats stats() const;
+
+  static constexpr int64_t kDefaultMaxEntries = 1'000;
+
+ private:
+  struct Generator {
+    std::unique_ptr<RE2> operator()(const std::string& pattern) const;
+  };
+
+  CachedFactory<std::string, RE2, Generator> factory_;
+  std::atomic<int64_t> numHits_{0};
+  std::atomic<int64_t> numMisses_{0};
+};
+
 /// re2Match(string, pattern) → bool
 ///
 /// Returns whether str matches the regex pattern.  pattern will be parsed using
@@ -126,7 +166,7 @@ struct Re2RegexpReplace {
 
   std::string processedReplacement_;
   std::string result_;
-  std::optional<RE2> re_;
+  Re2Cache::Ptr re_;
 
   FOLLY_ALWAYS_INLINE void initialize(
       const core::QueryConfig& /*config*/,
@@ -141,7 +181,7 @@ struct Re2RegexpReplace {
 
     auto processedPattern = prepareRegexpPattern(*pattern);
 
-    re_.emplace(processedPattern, RE2::Quiet);
+    re_ = Re2Cache::instance().get(StringView(processedPattern));
     if (UNLIKELY(!re_->ok())) {
       VELOX_USER_FAIL(
           "Invalid regular expression {}: {}.", processedPattern, re_->error());
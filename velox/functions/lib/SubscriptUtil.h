@@ -16,12 +16,134 @@
 
 #pragma once
 
+#include <folly/hash/Hash.h>
+
+#include "velox/common/base/BitUtil.h"
 #include "velox/expression/VectorFunction.h"
 #include "velox/type/Type.h"
 #include "velox/vector/NullsBuilder.h"
 
 namespace facebook::velox::functions {
 
+/// Hash table from the keys of each map of a MapVector to their positions in
+/// the keys vector. The subscripts of the same map vector in an evaluation
+/// share one through EvalCtx::sharedState(), e.g. in 'm[1] + m[2] + m[3]',
+/// so that each lookup probes the table instead of scanning the keys of the
+/// map. The table is only built once a map vector is looked up a second time
+/// and its maps are large enough for a scan to be slower than a probe.
+template <typename TKey>
+class MapKeyIndex {
+ public:
+  explicit MapKeyIndex(const MapVector& map)
+      : numMaps_(map.size()),
+        mapKeys_(map.mapKeys()),
+        offsets_(map.offsets()),
+        sizes_(map.sizes()) {}
+
+  /// Returns true if this was made for 'map'. Holding on to the keys, offsets
+  /// and sizes makes sure that a different map vector at the same address
+  /// does not match.
+  bool isFor(const MapVector& map) const {
+    return mapKeys_ == map.mapKeys() && offsets_ == map.offsets() &&
+        sizes_ == map.sizes() && numMaps_ == map.size();
+  }
+
+  /// Counts a lookup of all the rows of a subscript. Returns true if find()
+  /// can be used, false if the caller should scan the keys.
+  bool addLookup(const MapVector& map) {
+    if (!built_ && ++numLookups_ > 1 &&
+        mapKeys_->size() >= kMinAverageMapSize * std::max(numMaps_, 1)) {
+      build(map);
+    }
+    return built_;
+  }
+
+  /// Returns the position of the first 'key' in map 'mapIndex', -1 if the map
+  /// does not have 'key'.
+  vector_size_t find(vector_size_t mapIndex, TKey key) const {
+    const auto offset = rawOffsets_[mapIndex];
+    const auto size = rawSizes_[mapIndex];
+    for (auto slot = hash(mapIndex, key) & mask_;; slot = (slot + 1) & mask_) {
+      const auto position = table_[slot];
+      if (position == kEmpty) {
+        return -1;
+      }
+      if (position >= offset && position < offset + size &&
+          decodedKeys_.valueAt<TKey>(position) == key) {
+        return position;
+      }
+    }
+  }
+
+  const DecodedVector& decodedKeys() const {
+    return decodedKeys_;
+  }
+
+  static constexpr vector_size_t kMinAverageMapSize = 16;
+
+ private:
+  static constexpr vector_size_t kEmpty = -1;
+
+  static uint64_t hash(vector_size_t mapIndex, TKey key) {
+    return bits::hashMix(mapIndex, folly::hasher<TKey>()(key));
+  }
+
+  void build(const MapVector& map) {
+    const auto numKeys = mapKeys_->size();
+    decodedKeys_.decode(*mapKeys_, SelectivityVector(numKeys));
+    rawOffsets_ = map.rawOffsets();
+    rawSizes_ = map.rawSizes();
+    uint64_t numEntries = 0;
+    for (auto i = 0; i < numMaps_; ++i) {
+      if (isValid(map, i)) {
+        numEntries += rawSizes_[i];
+      }
+    }
+    table_.assign(
+        bits::nextPowerOfTwo(std::max<uint64_t>(16, 2 * numEntries)), kEmpty);
+    mask_ = table_.size() - 1;
+    for (auto i = 0; i < numMaps_; ++i) {
+      if (!isValid(map, i)) {
+        continue;
+      }
+      const auto end = rawOffsets_[i] + rawSizes_[i];
+      for (auto position = rawOffsets_[i]; position < end; ++position) {
+        const auto key = decodedKeys_.valueAt<TKey>(position);
+        // Keeps the first of duplicate keys, like the scan.
+        if (find(i, key) != -1) {
+          continue;
+        }
+        auto slot = hash(i, key) & mask_;
+        while (table_[slot] != kEmpty) {
+          slot = (slot + 1) & mask_;
+        }
+        table_[slot] = position;
+      }
+    }
+    built_ = true;
+  }
+
+  // Returns true if map 'index' is not null and its keys are in 'mapKeys_'.
+  // The others are never looked up.
+  bool isValid(const MapVector& map, vector_size_t index) const {
+    return !map.isNullAt(index) && rawSizes_[index] > 0 &&
+        rawOffsets_[index] >= 0 &&
+        rawOffsets_[index] + rawSizes_[index] <= mapKeys_->size();
+  }
+
+  const vector_size_t numMaps_;
+  const VectorPtr mapKeys_;
+  const BufferPtr offsets_;
+  const BufferPtr sizes_;
+  int32_t numLookups_{0};
+  bool built_{false};
+  const vector_size_t* rawOffsets_{nullptr};
+  const vector_size_t* rawSizes_{nullptr};
+  DecodedVector decodedKeys_;
+  std::vector<vector_size_t> table_;
+  uint64_t mask_{0};
+};
+
 /// Generic subscript/element_at implementation for both array and map data
 /// types.
 ///
@@ -309,18 +431,36 @@ class SubscriptImpl : public exec::VectorFunction {
     auto rawSizes = baseMap->rawSizes();
     auto rawOffsets = baseMap->rawOffsets();
 
+    // Uses the index if another subscript of 'baseMap' in this evaluation
+    // made it worth building.
+    auto keyIndex = context->sharedState<MapKeyIndex<TKey>>(baseMap);
+    if (!keyIndex || !keyIndex->isFor(*baseMap)) {
+      keyIndex = std::make_shared<MapKeyIndex<TKey>>(*baseMap);
+      context->setSharedState(baseMap, keyIndex);
+    }
+    const auto* index =
+        keyIndex->addLookup(*baseMap) ? keyIndex.get() : nullptr;
+
     // Lambda that does the search for a key, for each row.
     auto processRow = [&](vector_size_t row, TKey searchKey) {
       size_t mapIndex = mapIndices[row];
+      if (index) {
+        const auto position = index->find(mapIndex, searchKey);
+        if (position == -1) {
+          nullsBuilder.setNull(row);
+        } else {
+          rawIndices[row] = position;
+        }
+        return;
+      }
       size_t offsetStart = rawOffsets[mapIndex];
       size_t offsetEnd = offsetStart + rawSizes[mapIndex];
       bool found = false;
 
       // Sequentially check each key on this map for a match. We use a
       // sequential scan over the keys because it's easier to express (and
-      // likely has good memory locality), but if we find that this is slow
-      // for large maps we could try to canonicalize the whole vector and binary
-      // search `searchKey`.
+      // likely has good memory locality). Large maps that are looked up more
+      // than once use 'index' instead.
       for (size_t offset = offsetStart; offset < offsetEnd; ++offset) {
         if (decodedMapKeys->valueAt<TKey>(offset) == searchKey) {
           rawIndices[row] = offset;
@@ -731,4 +731,38 @@ TEST_F(MysqlDateTimeTest, formatCompositeTime) {
       "23:59:59");
 }
 
+TEST_F(DateTimeFormatterTest, fixedWidthFormat) {
+  EXPECT_EQ(19, buildMysqlDateTimeFormatter("%Y-%m-%d %H:%i:%s")->fixedWidth());
+  EXPECT_EQ(
+      23,
+      buildJodaDateTimeFormatter("yyyy-MM-dd'T'HH:mm:ss.SSS")->fixedWidth());
+  EXPECT_EQ(26, buildMysqlDateTimeFormatter("%Y-%m-%d %T.%f")->fixedWidth());
+  EXPECT_EQ(8, buildMysqlDateTimeFormatter("%y%m%d%H")->fixedWidth());
+  // Variable width.
+  EXPECT_EQ(0, buildMysqlDateTimeFormatter("%Y-%c-%e")->fixedWidth());
+  EXPECT_EQ(0, buildMysqlDateTimeFormatter("%Y-%b-%d")->fixedWidth());
+  EXPECT_EQ(0, buildJodaDateTimeFormatter("y-MM-dd")->fixedWidth());
+  EXPECT_EQ(0, buildJodaDateTimeFormatter("yyyy-MM-dd a")->fixedWidth());
+
+  auto format = [](const std::string& pattern, const std::string& timestamp) {
+    return buildJodaDateTimeFormatter(pattern)->format(
+        util::fromTimestampString(timestamp), nullptr);
+  };
+  const std::string iso = "yyyy-MM-dd'T'HH:mm:ss.SSS";
+  EXPECT_EQ("1970-01-01T00:00:00.000", format(iso, "1970-01-01 00:00:00"));
+  EXPECT_EQ("1969-12-31T23:59:59.999", format(iso, "1969-12-31 23:59:59.999"));
+  EXPECT_EQ("2000-02-29T12:34:56.005", format(iso, "2000-02-29 12:34:56.005"));
+  EXPECT_EQ("1900-03-01T01:02:03.040", format(iso, "1900-03-01 01:02:03.04"));
+  EXPECT_EQ("0000-01-01T00:00:00.000", format(iso, "0000-01-01 00:00:00"));
+  EXPECT_EQ("9999-12-31T23:59:59.999", format(iso, "9999-12-31 23:59:59.999"));
+  EXPECT_EQ("0001", format("YYYY", "0000-06-01"));
+  EXPECT_EQ("22", format("yy", "2022-06-01"));
+  EXPECT_EQ("000", format("SSS", "2022-06-01 00:00:00.0"));
+  EXPECT_EQ("00500", format("SSSSS", "2022-06-01 00:00:00.005"));
+
+  // Years that do not fit 4 digits take the general path.
+  EXPECT_EQ("10000-01-01", format("yyyy-MM-dd", "10000-01-01"));
+  EXPECT_EQ("-0001-12-31", format("yyyy-MM-dd", "-0001-12-31"));
+}
+
 } // namespace facebook::velox::functions
@@ -15,6 +15,7 @@
  */
 
 #include <gtest/gtest.h>
+#include <numeric>
 
 #include "velox/common/memory/HashStringAllocator.h"
 #include "velox/functions/lib/KllSketch.h"
@@ -200,6 +201,40 @@ TEST(KllSketchTest, mergeEmpty) {
   EXPECT_EQ(kll2.estimateQuantile(0.5), 1.0);
 }
 
+TEST(KllSketchTest, insertBatch) {
+  constexpr int N = 1e5;
+  std::vector<int64_t> values(N);
+  std::default_random_engine gen(0);
+  std::uniform_int_distribution<int64_t> dist(-1'000'000, 1'000'000);
+  for (auto& value : values) {
+    value = dist(gen);
+  }
+
+  // Sketches with the same seed end up the same regardless of how the values
+  // are split into batches.
+  for (auto batchSize : {1, 7, 200, 1'000, N}) {
+    KllSketch<int64_t> expected(kDefaultK, {}, 0);
+    KllSketch<int64_t> kll(kDefaultK, {}, 0);
+    for (int i = 0; i < N; i += batchSize) {
+      const auto size = std::min(batchSize, N - i);
+      for (int j = i; j < i + size; ++j) {
+        expected.insert(values[j]);
+      }
+      kll.insert(values.data() + i, size);
+      EXPECT_EQ(kll.totalCount(), expected.totalCount());
+    }
+    expected.finish();
+    kll.finish();
+    std::string expectedData(expected.serializedByteSize(), '\0');
+    expected.serialize(expectedData.data());
+    std::string data(kll.serializedByteSize(), '\0');
+    kll.serialize(data.data());
+    EXPECT_EQ(data, expectedData) << batchSize;
+    EXPECT_EQ(kll.estimateQuantile(0.0), expected.estimateQuantile(0.0));
+    EXPECT_EQ(kll.estimateQuantile(1.0), expected.estimateQuantile(1.0));
+  }
+}
+
 TEST(KllSketchTest, kFromEpsilon) {
   EXPECT_EQ(kFromEpsilon(kEpsilon), kDefaultK);
 }
@@ -280,17 +315,38 @@ TEST(KllSketchTest, memoryUsage) {
   HashStringAllocator alloc(memory::MappedMemory::getInstance());
   KllSketch<int64_t, StlAllocator<int64_t>> kll(
       1024, StlAllocator<int64_t>(&alloc));
-  EXPECT_LE(alloc.retainedSize() - alloc.freeSpace(), 64);
+  EXPECT_LE(
+      alloc.retainedSize() - alloc.freeSpace() - alloc.cachedBytes(), 64);
   kll.insert(0);
-  EXPECT_LE(alloc.retainedSize() - alloc.freeSpace(), 64);
+  EXPECT_LE(
+      alloc.retainedSize() - alloc.freeSpace() - alloc.cachedBytes(), 64);
   for (int i = 1; i < 1024; ++i) {
     kll.insert(i);
   }
-  EXPECT_LE(alloc.retainedSize() - alloc.freeSpace(), 8500);
+  EXPECT_LE(
+      alloc.retainedSize() - alloc.freeSpace() - alloc.cachedBytes(), 8500);
   for (int i = 1024; i < 8192; ++i) {
     kll.insert(i);
   }
-  EXPECT_LE(alloc.retainedSize() - alloc.freeSpace(), 28000);
+  EXPECT_LE(
+      alloc.retainedSize() - alloc.freeSpace() - alloc.cachedBytes(), 28000);
+}
+
+TEST(KllSketchTest, memoryUsageInsertBatch) {
+  HashStringAllocator alloc(memory::MappedMemory::getInstance());
+  KllSketch<int64_t, StlAllocator<int64_t>> kll(
+      1024, StlAllocator<int64_t>(&alloc));
+  std::vector<int64_t> values(8192);
+  std::iota(values.begin(), values.end(), 0);
+  kll.insert(values.data(), 10);
+  EXPECT_LE(
+      alloc.retainedSize() - alloc.freeSpace() - alloc.cachedBytes(), 200);
+  kll.insert(values.data() + 10, 1014);
+  EXPECT_LE(
+      alloc.retainedSize() - alloc.freeSpace() - alloc.cachedBytes(), 8500);
+  kll.insert(values.data() + 1024, 8192 - 1024);
+  EXPECT_LE(
+      alloc.retainedSize() - alloc.freeSpace() - alloc.cachedBytes(), 28000);
 }
 
 } // namespace
@@ -207,6 +207,50 @@ TEST_F(Re2FunctionsTest, regexMatchBatch) {
   re2Match.testBatchAll();
 }
 
+TEST_F(Re2FunctionsTest, regexMatchCachedPatterns) {
+  // Patterns from a small lookup table, repeated on many rows. Each distinct
+  // pattern is compiled once.
+  const std::vector<std::string> lookup = {
+      "cachedPattern[0-9]", "cachedPattern[a-z]", "cachedPattern_"};
+  const vector_size_t size = 1'000;
+  auto data = makeRowVector({
+      makeFlatVector<StringView>(
+          size,
+          [](auto row) {
+            return StringView(row % 2 ? "cachedPattern7" : "cachedPatternx");
+          }),
+      makeFlatVector<StringView>(
+          size, [&](auto row) { return StringView(lookup[row % 3]); }),
+  });
+
+  const auto before = Re2Cache::instance().stats();
+  auto result = evaluate<SimpleVector<bool>>("re2_match(c0, c1)", data);
+  for (auto row = 0; row < size; ++row) {
+    EXPECT_EQ(
+        row % 3 == 0 ? row % 2 == 1 : row % 3 == 1 && row % 2 == 0,
+        result->valueAt(row))
+        << row;
+  }
+  const auto after = Re2Cache::instance().stats();
+  EXPECT_EQ(3, after.numMisses - before.numMisses);
+  EXPECT_EQ(size - 3, after.numHits - before.numHits);
+
+  // A second evaluation hits the cache for all rows.
+  evaluate<SimpleVector<bool>>("re2_match(c0, c1)", data);
+  EXPECT_EQ(3, Re2Cache::instance().stats().numMisses - before.numMisses);
+
+  // Unused patterns beyond the capacity are evicted.
+  Re2Cache cache(2);
+  for (const auto& pattern : lookup) {
+    EXPECT_TRUE(cache.get(StringView(pattern))->ok());
+  }
+  EXPECT_EQ(2, cache.stats().numEntries);
+  EXPECT_EQ(3, cache.stats().numMisses);
+  auto pinned = cache.get(StringView(lookup[2]));
+  EXPECT_EQ(1, cache.stats().numHits);
+  EXPECT_FALSE(cache.get(StringView("*"))->ok());
+}
+
 template <typename F>
 void testRe2Search(F&& regexSearch) {
   // Empty string cases.
@@ -403,6 +447,66 @@ TEST_F(Re2FunctionsTest, likePatternAndEscape) {
   EXPECT_THROW(like("abcd", "a#}#+", '#'), std::exception);
 }
 
+TEST_F(Re2FunctionsTest, likePatternShapes) {
+  auto like = [&](std::optional<std::string> str, const std::string& pattern) {
+    return evaluateOnce<bool>("like(c0, '" + pattern + "')", str);
+  };
+  auto likeEscape = [&](std::optional<std::string> str,
+                        const std::string& pattern) {
+    return evaluateOnce<bool>("like(c0, '" + pattern + "', '#')", str);
+  };
+
+  // Exact.
+  EXPECT_EQ(like("", ""), true);
+  EXPECT_EQ(like("a", ""), false);
+  EXPECT_EQ(like("abc", "abc"), true);
+  EXPECT_EQ(like("abcd", "abc"), false);
+
+  // Prefix.
+  EXPECT_EQ(like("", "%"), true);
+  EXPECT_EQ(like("abc", "%%"), true);
+  EXPECT_EQ(like("abcdefghijklmnop", "abcdefghijklmn%"), true);
+  EXPECT_EQ(like("abcdefghijklmnop", "abcdefghijklmm%"), false);
+  EXPECT_EQ(like("ab", "abc%"), false);
+
+  // Suffix.
+  EXPECT_EQ(like("abcdefghijklmnop", "%mnop"), true);
+  EXPECT_EQ(like("abcdefghijklmnop", "%%mnop"), true);
+  EXPECT_EQ(like("abcdefghijklmnop", "%mno"), false);
+  EXPECT_EQ(like("op", "%mnop"), false);
+
+  // Substring.
+  EXPECT_EQ(like("abcdefghijklmnop", "%ghij%"), true);
+  EXPECT_EQ(like("abcdefghijklmnop", "%ghik%"), false);
+  EXPECT_EQ(like("ghij", "%ghij%"), true);
+
+  // Prefix and suffix overlapping in the input do not match.
+  EXPECT_EQ(like("abcdef", "abc%def"), true);
+  EXPECT_EQ(like("abcxyzdef", "abc%def"), true);
+  EXPECT_EQ(like("abcdef", "abcd%cdef"), false);
+  EXPECT_EQ(like("aba", "ab%ba"), false);
+
+  // Wildcards match new lines.
+  EXPECT_EQ(like("abc\ndef", "abc%"), true);
+  EXPECT_EQ(like("abc\ndef", "a_c_d%"), true);
+  EXPECT_EQ(like("\n", "_"), true);
+
+  // Escaped wildcards are literals.
+  EXPECT_EQ(likeEscape("50%", "%#%"), true);
+  EXPECT_EQ(likeEscape("50", "%#%"), false);
+  EXPECT_EQ(likeEscape("a_b", "a#_b"), true);
+  EXPECT_EQ(likeEscape("axb", "a#_b"), false);
+  EXPECT_EQ(likeEscape("a#b", "a##b"), true);
+
+  // Patterns with '_' or more than two literals go to RE2, after checking for
+  // the longest literal.
+  EXPECT_EQ(like("abcdefghijklmnop", "a%fghij%n_p"), true);
+  EXPECT_EQ(like("abcdefghijklmnop", "a%fghik%n_p"), false);
+  EXPECT_EQ(like("abcdefghijklmnop", "a%c%p"), true);
+  EXPECT_EQ(like("abcdefghijklmnop", "a%x%p"), false);
+  EXPECT_EQ(like(std::nullopt, "a%b"), std::nullopt);
+}
+
 template <typename T>
 void Re2FunctionsTest::testRe2ExtractAll(
     const std::vector<std::optional<std::string>>& inputs,
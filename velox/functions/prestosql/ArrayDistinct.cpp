@@ -14,6 +14,8 @@
  * limitations under the License.
  */
 
+#include <array>
+
 #include <folly/container/F14Set.h>
 
 #include "velox/expression/EvalCtx.h"
@@ -74,8 +76,10 @@ class ArrayDistinctFunction : public exec::VectorFunction {
     auto* rawSizes = newLengths->asMutable<vector_size_t>();
     auto* rawOffsets = newOffsets->asMutable<vector_size_t>();
 
-    // Process the rows: store unique values in the hash table.
+    // Process the rows: store unique values in the hash table. Short arrays
+    // compare each value with the unique values found so far instead.
     folly::F14FastSet<T> uniqueSet;
+    std::array<T, kMaxLinearSize> uniqueValues;
 
     rows.applyToSelected([&](vector_size_t row) {
       auto size = arrayVector->sizeAt(row);
@@ -83,6 +87,26 @@ class ArrayDistinctFunction : public exec::VectorFunction {
 
       rawOffsets[row] = indicesCursor;
       bool hasNulls = false;
+      if (size <= kMaxLinearSize) {
+        vector_size_t numUnique = 0;
+        for (vector_size_t i = offset; i < offset + size; ++i) {
+          if (elements->isNullAt(i)) {
+            if (!hasNulls) {
+              hasNulls = true;
+              rawNewIndices[indicesCursor++] = i;
+            }
+          } else {
+            auto value = elements->valueAt<T>(i);
+            if (!contains(uniqueValues.data(), numUnique, value)) {
+              uniqueValues[numUnique++] = value;
+              rawNewIndices[indicesCursor++] = i;
+            }
+          }
+        }
+        rawSizes[row] = indicesCursor - rawOffsets[row];
+        return;
+      }
+
       for (vector_size_t i = offset; i < offset + size; ++i) {
         if (elements->isNullAt(i)) {
           if (!hasNulls) {
@@ -118,6 +142,23 @@ class ArrayDistinctFunction : public exec::VectorFunction {
         0);
     context->moveOrCopyResult(resultArray, rows, result);
   }
+
+ private:
+  // Arrays of up to this many elements are deduplicated without hashing.
+  static constexpr vector_size_t kMaxLinearSize = 16;
+
+  static bool contains(const T* values, vector_size_t size, const T& value) {
+    if constexpr (std::is_arithmetic_v<T>) {
+      // No early exit, so that the loop vectorizes.
+      bool found = false;
+      for (auto i = 0; i < size; ++i) {
+        found |= values[i] == value;
+      }
+      return found;
+    } else {
+      return std::find(values, values + size, value) != values + size;
+    }
+  }
 };
 
 // Validate number of parameters and types.
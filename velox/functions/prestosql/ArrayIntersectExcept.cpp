@@ -18,22 +18,66 @@
 
 namespace facebook::velox::functions {
 namespace {
+// Distinct values, and whether null is among them. Up to kMaxLinearSize
+// values are kept in a vector and looked up with a linear scan, which for the
+// short arrays common in practice is faster than hashing. Larger sets switch
+// to a hash set.
 template <typename T>
-
 struct SetWithNull {
   SetWithNull(vector_size_t initialSetSize = kInitialSetSize) {
     set.reserve(initialSetSize);
   }
 
   void reset() {
+    values.clear();
     set.clear();
     hasNull = false;
   }
 
+  // Adds 'value'. Returns false if 'value' was already in the set.
+  bool insert(const T& value) {
+    if (set.empty()) {
+      if (containsLinear(value)) {
+        return false;
+      }
+      if (values.size() < kMaxLinearSize) {
+        values.push_back(value);
+        return true;
+      }
+      set.insert(values.begin(), values.end());
+    }
+    return set.insert(value).second;
+  }
+
+  bool contains(const T& value) const {
+    if (set.empty()) {
+      return containsLinear(value);
+    }
+    return set.count(value) > 0;
+  }
+
+  // Used while 'set' is empty.
+  std::vector<T> values;
   std::unordered_set<T> set;
   bool hasNull{false};
   static constexpr vector_size_t kInitialSetSize{128};
+  static constexpr vector_size_t kMaxLinearSize{16};
+
+ private:
+  bool containsLinear(const T& value) const {
+    if constexpr (std::is_arithmetic_v<T>) {
+      // No early exit, so that the loop vectorizes.
+      bool found = false;
+      for (const auto& other : values) {
+        found |= other == value;
+      }
+      return found;
+    } else {
+      return std::find(values.begin(), values.end(), value) != values.end();
+    }
+  }
 };
+
 // Generates a set based on the elements of an ArrayVector. Note that we take
 // rightSet as a parameter (instead of returning a new one) to reuse the
 // allocated memory.
@@ -54,9 +98,9 @@ void generateSet(
       // Function can be called with either FlatVector or DecodedVector, but
       // their APIs are slightly different.
       if constexpr (std::is_same_v<TVector, DecodedVector>) {
-        rightSet.set.insert(arrayElements->template valueAt<T>(i));
+        rightSet.insert(arrayElements->template valueAt<T>(i));
       } else {
-        rightSet.set.insert(arrayElements->valueAt(i));
+        rightSet.insert(arrayElements->valueAt(i));
       }
     }
   }
@@ -204,15 +248,12 @@ class ArrayIntersectExceptFunction : public exec::VectorFunction {
           // (check outputSet).
           bool addValue = false;
           if constexpr (isIntersect) {
-            addValue = rightSet.set.count(val) > 0;
+            addValue = rightSet.contains(val);
           } else {
-            addValue = rightSet.set.count(val) == 0;
+            addValue = !rightSet.contains(val);
           }
-          if (addValue) {
-            auto it = outputSet.set.insert(val);
-            if (it.second) {
-              rawNewIndices[indicesCursor++] = i;
-            }
+          if (addValue && outputSet.insert(val)) {
+            rawNewIndices[indicesCursor++] = i;
           }
         }
       }
@@ -239,11 +280,24 @@ class ArrayIntersectExceptFunction : public exec::VectorFunction {
           decodeArrayElements(rightHolder, rightElementsHolder, rows);
       SetWithNull<T> rightSet;
       auto rightArrayVector = rightHolder.get()->base()->as<ArrayVector>();
-      rows.applyToSelected([&](vector_size_t row) {
-        auto idx = rightHolder.get()->index(row);
-        generateSet<T>(rightArrayVector, decodedRightElements, idx, rightSet);
-        processRow(row, rightSet, outputSet);
-      });
+      if (rightHolder.get()->isConstantMapping() && rows.hasSelections()) {
+        // The right-hand side is the same array for all rows.
+        generateSet<T>(
+            rightArrayVector,
+            decodedRightElements,
+            rightHolder.get()->index(rows.begin()),
+            rightSet);
+        rows.applyToSelected([&](vector_size_t row) {
+          processRow(row, rightSet, outputSet);
+        });
+      } else {
+        rows.applyToSelected([&](vector_size_t row) {
+          auto idx = rightHolder.get()->index(row);
+          generateSet<T>(
+              rightArrayVector, decodedRightElements, idx, rightSet);
+          processRow(row, rightSet, outputSet);
+        });
+      }
     }
 
     auto newElements = BaseVector::wrapInDictionary(
@@ -308,7 +362,7 @@ class ArraysOverlapFunction : public exec::VectorFunction {
           hasNull = true;
           continue;
         }
-        if (rightSet.set.count(decodedLeftElements->valueAt<T>(i)) > 0) {
+        if (rightSet.contains(decodedLeftElements->valueAt<T>(i))) {
           // Found an overlapping element. Add to result set.
           resultBoolVector->set(row, true);
           return;
@@ -336,11 +390,22 @@ class ArraysOverlapFunction : public exec::VectorFunction {
           decodeArrayElements(rightDecoder, rightElementsDecoder, rows);
       SetWithNull<T> rightSet;
       auto baseRightArray = rightDecoder.get()->base()->as<ArrayVector>();
-      rows.applyToSelected([&](vector_size_t row) {
-        auto idx = rightDecoder.get()->index(row);
-        generateSet<T>(baseRightArray, decodedRightElements, idx, rightSet);
-        processRow(row, rightSet);
-      });
+      if (rightDecoder.get()->isConstantMapping() && rows.hasSelections()) {
+        // The right-hand side is the same array for all rows.
+        generateSet<T>(
+            baseRightArray,
+            decodedRightElements,
+            rightDecoder.get()->index(rows.begin()),
+            rightSet);
+        rows.applyToSelected(
+            [&](vector_size_t row) { processRow(row, rightSet); });
+      } else {
+        rows.applyToSelected([&](vector_size_t row) {
+          auto idx = rightDecoder.get()->index(row);
+          generateSet<T>(baseRightArray, decodedRightElements, idx, rightSet);
+          processRow(row, rightSet);
+        });
+      }
     }
   }
 
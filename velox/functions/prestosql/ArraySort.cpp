@@ -19,6 +19,7 @@
 #include "velox/expression/EvalCtx.h"
 #include "velox/expression/Expr.h"
 #include "velox/expression/VectorFunction.h"
+#include "velox/functions/lib/ArraySortUtil.h"
 #include "velox/functions/lib/LambdaFunctionUtil.h"
 
 namespace facebook::velox::functions {
@@ -101,6 +102,7 @@ void applyScalarType(
           decodedElements->base(), inputElementRows, /*toSourceRow=*/nullptr);
 
   auto flatResults = (*resultElements)->asFlatVector<T>();
+  std::vector<T> scratch;
 
   auto processRow = [&](vector_size_t row) {
     const auto size = inputArray->sizeAt(row);
@@ -128,7 +130,12 @@ void applyScalarType(
       bits::fillBits(rawBits, endZeroRow, endRow, bits::kNotNull);
     } else {
       T* resultRawValues = flatResults->mutableRawValues();
-      std::sort(resultRawValues + startRow, resultRawValues + endRow);
+      sortPrimitiveValues(
+          resultRawValues + startRow,
+          endRow - startRow,
+          /*ascending=*/true,
+          std::less<T>(),
+          scratch);
     }
   };
   rows.applyToSelected(processRow);
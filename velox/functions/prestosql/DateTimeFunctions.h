@@ -21,6 +21,7 @@
 #include "velox/functions/lib/JodaDateTime.h"
 #include "velox/functions/prestosql/DateTimeImpl.h"
 #include "velox/functions/prestosql/types/TimestampWithTimeZoneType.h"
+#include "velox/type/TimeZoneOffsets.h"
 #include "velox/type/Type.h"
 #include "velox/type/tz/TimeZoneMap.h"
 
@@ -65,21 +66,23 @@ struct FromUnixtimeFunction {
 namespace {
 inline constexpr int64_t kSecondsInDay = 86'400;
 
-FOLLY_ALWAYS_INLINE const date::time_zone* getTimeZoneFromConfig(
+// Returns the offsets of the session time zone if timestamps are to be
+// adjusted to it.
+FOLLY_ALWAYS_INLINE const TimeZoneOffsets* getTimeZoneFromConfig(
     const core::QueryConfig& config) {
   if (config.adjustTimestampToTimezone()) {
     auto sessionTzName = config.sessionTimezone();
     if (!sessionTzName.empty()) {
-      return date::locate_zone(sessionTzName);
+      return &TimeZoneOffsets::get(*date::locate_zone(sessionTzName));
     }
   }
   return nullptr;
 }
 
 FOLLY_ALWAYS_INLINE int64_t
-getSeconds(Timestamp timestamp, const date::time_zone* timeZone) {
+getSeconds(Timestamp timestamp, const TimeZoneOffsets* timeZone) {
   if (timeZone != nullptr) {
-    timestamp.toTimezone(*timeZone);
+    timeZone->toTimezone(timestamp);
     return timestamp.getSeconds();
   } else {
     return timestamp.getSeconds();
@@ -87,25 +90,19 @@ getSeconds(Timestamp timestamp, const date::time_zone* timeZone) {
 }
 
 FOLLY_ALWAYS_INLINE
-std::tm getDateTime(Timestamp timestamp, const date::time_zone* timeZone) {
-  int64_t seconds = getSeconds(timestamp, timeZone);
-  std::tm dateTime;
-  gmtime_r((const time_t*)&seconds, &dateTime);
-  return dateTime;
+std::tm getDateTime(Timestamp timestamp, const TimeZoneOffsets* timeZone) {
+  return toDateTime(getSeconds(timestamp, timeZone));
 }
 
 FOLLY_ALWAYS_INLINE
 std::tm getDateTime(Date date) {
-  int64_t seconds = date.days() * kSecondsInDay;
-  std::tm dateTime;
-  gmtime_r((const time_t*)&seconds, &dateTime);
-  return dateTime;
+  return toDateTime(date.days() * kSecondsInDay);
 }
 
 template <typename T>
 struct InitSessionTimezone {
   VELOX_DEFINE_FUNCTION_TYPES(T);
-  const date::time_zone* timeZone_{nullptr};
+  const TimeZoneOffsets* timeZone_{nullptr};
 
   FOLLY_ALWAYS_INLINE void initialize(
       const core::QueryConfig& config,
@@ -532,7 +529,7 @@ template <typename T>
 struct DateTruncFunction {
   VELOX_DEFINE_FUNCTION_TYPES(T);
 
-  const date::time_zone* timeZone_ = nullptr;
+  const TimeZoneOffsets* timeZone_ = nullptr;
   std::optional<DateTimeUnit> unit_;
 
   FOLLY_ALWAYS_INLINE void initialize(
@@ -611,9 +608,9 @@ struct DateTruncFunction {
     auto dateTime = getDateTime(timestamp, timeZone_);
     adjustDateTime(dateTime, unit);
 
-    result = Timestamp(timegm(&dateTime), 0);
+    result = Timestamp(fromDateTime(dateTime), 0);
     if (timeZone_ != nullptr) {
-      result.toGMT(*timeZone_);
+      timeZone_->toGMT(result);
     }
     return true;
   }
@@ -634,7 +631,7 @@ struct DateTruncFunction {
     auto dateTime = getDateTime(date);
     adjustDateTime(dateTime, unit);
 
-    result = Date(timegm(&dateTime) / kSecondsInDay);
+    result = Date(fromDateTime(dateTime) / kSecondsInDay);
     return true;
   }
 };
@@ -643,7 +640,7 @@ template <typename T>
 struct DateAddFunction {
   VELOX_DEFINE_FUNCTION_TYPES(T);
 
-  const date::time_zone* sessionTimeZone_ = nullptr;
+  const TimeZoneOffsets* sessionTimeZone_ = nullptr;
   std::optional<DateTimeUnit> unit_ = std::nullopt;
 
   FOLLY_ALWAYS_INLINE void initialize(
@@ -684,7 +681,7 @@ struct DateAddFunction {
       // sessionTimeZone not null means that the config
       // adjust_timestamp_to_timezone is on.
       Timestamp zonedTimestamp = timestamp;
-      zonedTimestamp.toTimezone(*sessionTimeZone_);
+      sessionTimeZone_->toTimezone(zonedTimestamp);
 
       Timestamp resultTimestamp =
           addToTimestamp(zonedTimestamp, unit, (int32_t)value);
@@ -695,7 +692,7 @@ struct DateAddFunction {
         result = Timestamp(
             resultTimestamp.getSeconds() + offset, resultTimestamp.getNanos());
       } else {
-        resultTimestamp.toGMT(*sessionTimeZone_);
+        sessionTimeZone_->toGMT(resultTimestamp);
         result = resultTimestamp;
       }
     } else {
@@ -727,7 +724,7 @@ template <typename T>
 struct DateDiffFunction {
   VELOX_DEFINE_FUNCTION_TYPES(T);
 
-  const date::time_zone* sessionTimeZone_ = nullptr;
+  const TimeZoneOffsets* sessionTimeZone_ = nullptr;
   std::optional<DateTimeUnit> unit_ = std::nullopt;
 
   FOLLY_ALWAYS_INLINE void initialize(
@@ -765,7 +762,7 @@ struct DateDiffFunction {
       // sessionTimeZone not null means that the config
       // adjust_timestamp_to_timezone is on.
       Timestamp fromZonedTimestamp = timestamp1;
-      fromZonedTimestamp.toTimezone(*sessionTimeZone_);
+      sessionTimeZone_->toTimezone(fromZonedTimestamp);
 
       Timestamp toZonedTimestamp = timestamp2;
       if (isTimeUnit(unit)) {
@@ -775,7 +772,7 @@ struct DateDiffFunction {
             toZonedTimestamp.getSeconds() - offset,
             toZonedTimestamp.getNanos());
       } else {
-        toZonedTimestamp.toTimezone(*sessionTimeZone_);
+        sessionTimeZone_->toTimezone(toZonedTimestamp);
       }
       result = diffTimestamp(unit, fromZonedTimestamp, toZonedTimestamp);
     } else {
@@ -798,13 +795,41 @@ struct DateDiffFunction {
   }
 };
 
+namespace {
+/// Formats 'timestamp' into 'result'. Layouts of fixed width are written in
+/// place.
+template <typename TOutString>
+FOLLY_ALWAYS_INLINE void formatDateTime(
+    const DateTimeFormatter& formatter,
+    const Timestamp& timestamp,
+    const TimeZoneOffsets* timeZone,
+    TOutString& result) {
+  if (const auto width = formatter.fixedWidth()) {
+    result.resize(width);
+    if (formatter.formatFixedWidth(timestamp, result.data())) {
+      return;
+    }
+  }
+  auto formattedResult = formatter.format(
+      timestamp, timeZone != nullptr ? &timeZone->zone() : nullptr);
+  auto resultSize = formattedResult.size();
+  result.resize(resultSize);
+  if (resultSize != 0) {
+    std::memcpy(result.data(), formattedResult.data(), resultSize);
+  }
+}
+} // namespace
+
 template <typename T>
 struct DateFormatFunction {
   VELOX_DEFINE_FUNCTION_TYPES(T);
 
-  const date::time_zone* sessionTimeZone_ = nullptr;
+  const TimeZoneOffsets* sessionTimeZone_ = nullptr;
   std::shared_ptr<DateTimeFormatter> mysqlDateTime_;
   bool isConstFormat_ = false;
+  // Format of 'mysqlDateTime_' if the format is not constant. Consecutive rows
+  // with the same format reuse the formatter.
+  std::string lastFormat_;
 
   FOLLY_ALWAYS_INLINE void initialize(
       const core::QueryConfig& config,
@@ -823,16 +848,14 @@ struct DateFormatFunction {
       const arg_type<Timestamp>& timestamp,
       const arg_type<Varchar>& formatString) {
     if (!isConstFormat_) {
-      mysqlDateTime_ = buildMysqlDateTimeFormatter(
-          std::string_view(formatString.data(), formatString.size()));
+      const std::string_view format(formatString.data(), formatString.size());
+      if (!mysqlDateTime_ || format != lastFormat_) {
+        mysqlDateTime_ = buildMysqlDateTimeFormatter(format);
+        lastFormat_ = format;
+      }
     }
 
-    auto formattedResult = mysqlDateTime_->format(timestamp, sessionTimeZone_);
-    auto resultSize = formattedResult.size();
-    result.resize(resultSize);
-    if (resultSize != 0) {
-      std::memcpy(result.data(), formattedResult.data(), resultSize);
-    }
+    formatDateTime(*mysqlDateTime_, timestamp, sessionTimeZone_, result);
     return true;
   }
 };
@@ -891,9 +914,12 @@ template <typename T>
 struct FormatDateTimeFunction {
   VELOX_DEFINE_FUNCTION_TYPES(T);
 
-  const date::time_zone* sessionTimeZone_ = nullptr;
+  const TimeZoneOffsets* sessionTimeZone_ = nullptr;
   std::shared_ptr<DateTimeFormatter> jodaDateTime_;
   bool isConstFormat_ = false;
+  // Format of 'jodaDateTime_' if the format is not constant. Consecutive rows
+  // with the same format reuse the formatter.
+  std::string lastFormat_;
 
   FOLLY_ALWAYS_INLINE void initialize(
       const core::QueryConfig& config,
@@ -912,16 +938,14 @@ struct FormatDateTimeFunction {
       const arg_type<Timestamp>& timestamp,
       const arg_type<Varchar>& formatString) {
     if (!isConstFormat_) {
-      jodaDateTime_ = buildJodaDateTimeFormatter(
-          std::string_view(formatString.data(), formatString.size()));
+      const std::string_view format(formatString.data(), formatString.size());
+      if (!jodaDateTime_ || format != lastFormat_) {
+        jodaDateTime_ = buildJodaDateTimeFormatter(format);
+        lastFormat_ = format;
+      }
     }
 
-    auto formattedResult = jodaDateTime_->format(timestamp, sessionTimeZone_);
-    auto resultSize = formattedResult.size();
-    result.resize(resultSize);
-    if (resultSize != 0) {
-      std::memcpy(result.data(), formattedResult.data(), resultSize);
-    }
+    formatDateTime(*jodaDateTime_, timestamp, sessionTimeZone_, result);
     return true;
   }
 };
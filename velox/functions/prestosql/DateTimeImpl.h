@@ -16,6 +16,7 @@
 #pragma once
 
 #include <chrono>
+#include <ctime>
 #include <optional>
 #include "velox/external/date/date.h"
 #include "velox/type/Date.h"
@@ -69,6 +70,79 @@ FOLLY_ALWAYS_INLINE std::optional<Timestamp> fromUnixtime(double unixtime) {
   return Timestamp(seconds, nanos * kNanosecondsInSecond);
 }
 
+// Converts days since epoch to a proleptic Gregorian (year, month, day) with
+// month and day 1-based. Integer arithmetic only, after H. Hinnant's
+// civil_from_days, so that loops over flat vectors vectorize.
+FOLLY_ALWAYS_INLINE void
+civilFromDays(int64_t days, int64_t& year, int32_t& month, int32_t& day) {
+  // Shift the epoch to 0000-03-01 so that leap days end the year.
+  const int64_t z = days + 719'468;
+  const int64_t era = (z >= 0 ? z : z - 146'096) / 146'097;
+  const int64_t dayOfEra = z - era * 146'097;
+  const int64_t yearOfEra = (dayOfEra - dayOfEra / 1'460 +
+                             dayOfEra / 36'524 - dayOfEra / 146'096) /
+      365;
+  const int64_t dayOfYear =
+      dayOfEra - (365 * yearOfEra + yearOfEra / 4 - yearOfEra / 100);
+  // Month counted from March.
+  const int64_t shiftedMonth = (5 * dayOfYear + 2) / 153;
+  day = dayOfYear - (153 * shiftedMonth + 2) / 5 + 1;
+  month = shiftedMonth < 10 ? shiftedMonth + 3 : shiftedMonth - 9;
+  year = yearOfEra + era * 400 + (month <= 2);
+}
+
+// Inverse of civilFromDays. 'month' and 'day' must be in range.
+FOLLY_ALWAYS_INLINE int64_t
+daysFromCivil(int64_t year, int32_t month, int32_t day) {
+  year -= month <= 2;
+  const int64_t era = (year >= 0 ? year : year - 399) / 400;
+  const int64_t yearOfEra = year - era * 400;
+  const int64_t shiftedMonth = month > 2 ? month - 3 : month + 9;
+  const int64_t dayOfYear = (153 * shiftedMonth + 2) / 5 + day - 1;
+  const int64_t dayOfEra =
+      yearOfEra * 365 + yearOfEra / 4 - yearOfEra / 100 + dayOfYear;
+  return era * 146'097 + dayOfEra - 719'468;
+}
+
+// Breaks 'seconds' since epoch into UTC calendar fields. Produces the same
+// fields as gmtime_r, except tm_gmtoff and tm_zone, without a library call.
+FOLLY_ALWAYS_INLINE std::tm toDateTime(int64_t seconds) {
+  constexpr int64_t kSecondsInDay = 86'400;
+  int64_t days = seconds / kSecondsInDay;
+  int64_t secondOfDay = seconds % kSecondsInDay;
+  // Floor instead of truncating toward 0 for times before the epoch.
+  const bool negative = secondOfDay < 0;
+  days -= negative;
+  secondOfDay += negative * kSecondsInDay;
+
+  int64_t year;
+  int32_t month;
+  int32_t day;
+  civilFromDays(days, year, month, day);
+
+  std::tm dateTime{};
+  dateTime.tm_year = year - 1900;
+  dateTime.tm_mon = month - 1;
+  dateTime.tm_mday = day;
+  dateTime.tm_hour = secondOfDay / 3'600;
+  dateTime.tm_min = secondOfDay % 3'600 / 60;
+  dateTime.tm_sec = secondOfDay % 60;
+  // 1970-01-01 was a Thursday.
+  const int64_t weekDay = (days + 4) % 7;
+  dateTime.tm_wday = weekDay < 0 ? weekDay + 7 : weekDay;
+  dateTime.tm_yday = days - daysFromCivil(year, 1, 1);
+  return dateTime;
+}
+
+// Inverse of toDateTime for normalized fields. Replaces timegm, which also
+// normalizes out of range fields and is much slower.
+FOLLY_ALWAYS_INLINE int64_t fromDateTime(const std::tm& dateTime) {
+  const int64_t days = daysFromCivil(
+      dateTime.tm_year + 1900, dateTime.tm_mon + 1, dateTime.tm_mday);
+  return days * 86'400 + dateTime.tm_hour * 3'600 + dateTime.tm_min * 60 +
+      dateTime.tm_sec;
+}
+
 namespace {
 enum class DateTimeUnit {
   kMillisecond,
@@ -0,0 +1,293 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "velox/expression/DecodedArgs.h"
+#include "velox/expression/VectorFunction.h"
+#include "velox/type/DecimalUtil.h"
+
+namespace facebook::velox::functions {
+namespace {
+
+// Returns the decimal type with unscaled values of type T.
+template <typename T>
+using DecimalNativeType =
+    std::conditional_t<std::is_same_v<T, int64_t>, ShortDecimal, LongDecimal>;
+
+// Applies a binary operation to decimals with unscaled values of types A and B
+// and stores the unscaled results of type R. R is int64_t when the result type
+// is a SHORT_DECIMAL and int128_t otherwise. Overflow is tracked in a flag for
+// the whole batch. Only if the flag is set after the batch are the rows
+// recomputed one at a time to report the errors.
+template <typename R, typename A, typename B, typename Operation>
+class DecimalBaseFunction : public exec::VectorFunction {
+ public:
+  DecimalBaseFunction(uint8_t aRescale, uint8_t bRescale)
+      : aRescale_(aRescale), bRescale_(bRescale) {}
+
+  void apply(
+      const SelectivityVector& rows,
+      std::vector<VectorPtr>& args,
+      const TypePtr& outputType,
+      exec::EvalCtx* context,
+      VectorPtr* result) const override {
+    BaseVector::ensureWritable(rows, outputType, context->pool(), result);
+    auto* rawResults = reinterpret_cast<R*>(
+        (*result)->asFlatVector<DecimalNativeType<R>>()->mutableRawValues());
+
+    exec::DecodedArgs decodedArgs(rows, args, context);
+    auto* a = decodedArgs.at(0);
+    auto* b = decodedArgs.at(1);
+
+    bool overflow = false;
+    if (a->isIdentityMapping() && b->isIdentityMapping()) {
+      auto* rawA = a->data<A>();
+      auto* rawB = b->data<B>();
+      rows.applyToSelected([&](vector_size_t row) {
+        rawResults[row] = Operation::template apply<R>(
+            rawA[row], rawB[row], aRescale_, bRescale_, overflow);
+      });
+    } else if (a->isIdentityMapping() && b->isConstantMapping()) {
+      auto* rawA = a->data<A>();
+      auto constantB = b->valueAt<B>(0);
+      rows.applyToSelected([&](vector_size_t row) {
+        rawResults[row] = Operation::template apply<R>(
+            rawA[row], constantB, aRescale_, bRescale_, overflow);
+      });
+    } else {
+      rows.applyToSelected([&](vector_size_t row) {
+        rawResults[row] = Operation::template apply<R>(
+            a->valueAt<A>(row),
+            b->valueAt<B>(row),
+            aRescale_,
+            bRescale_,
+            overflow);
+      });
+    }
+
+    if (UNLIKELY(overflow)) {
+      context->applyToSelectedNoThrow(rows, [&](vector_size_t row) {
+        bool rowOverflow = false;
+        Operation::template apply<R>(
+            a->valueAt<A>(row),
+            b->valueAt<B>(row),
+            aRescale_,
+            bRescale_,
+            rowOverflow);
+        VELOX_USER_CHECK(
+            !rowOverflow,
+            "Decimal overflow: result does not fit in {}",
+            outputType->toString());
+      });
+    }
+  }
+
+ private:
+  // Powers of ten by which to multiply the values of the arguments to bring
+  // them to the scale of the operation.
+  const uint8_t aRescale_;
+  const uint8_t bRescale_;
+};
+
+// Returns true if 'value' fits in a LONG_DECIMAL. A SHORT_DECIMAL result
+// always fits, since its precision is not capped.
+template <typename R>
+bool resultInRange(R value) {
+  if constexpr (std::is_same_v<R, int128_t>) {
+    return DecimalUtil::valueInRange(value);
+  }
+  return true;
+}
+
+class Addition {
+ public:
+  template <typename R, typename A, typename B>
+  static R
+  apply(A a, B b, uint8_t aRescale, uint8_t bRescale, bool& overflow) {
+    R result;
+    overflow |= __builtin_add_overflow(
+        DecimalUtil::rescale<R>(a, aRescale, overflow),
+        DecimalUtil::rescale<R>(b, bRescale, overflow),
+        &result);
+    overflow |= !resultInRange(result);
+    return result;
+  }
+
+  // Both arguments are rescaled to the larger of the two scales.
+  static uint8_t computeRescaleFactor(int32_t fromScale, int32_t toScale) {
+    return std::max(0, toScale - fromScale);
+  }
+
+  static int32_t computeResultPrecision(
+      int32_t aPrecision,
+      int32_t aScale,
+      int32_t bPrecision,
+      int32_t bScale) {
+    return std::min(
+        DecimalUtil::kMaxLongDecimalPrecision,
+        std::max(aPrecision - aScale, bPrecision - bScale) +
+            std::max(aScale, bScale) + 1);
+  }
+};
+
+class Subtraction {
+ public:
+  template <typename R, typename A, typename B>
+  static R
+  apply(A a, B b, uint8_t aRescale, uint8_t bRescale, bool& overflow) {
+    R result;
+    overflow |= __builtin_sub_overflow(
+        DecimalUtil::rescale<R>(a, aRescale, overflow),
+        DecimalUtil::rescale<R>(b, bRescale, overflow),
+        &result);
+    overflow |= !resultInRange(result);
+    return result;
+  }
+
+  static uint8_t computeRescaleFactor(int32_t fromScale, int32_t toScale) {
+    return Addition::computeRescaleFactor(fromScale, toScale);
+  }
+
+  static int32_t computeResultPrecision(
+      int32_t aPrecision,
+      int32_t aScale,
+      int32_t bPrecision,
+      int32_t bScale) {
+    return Addition::computeResultPrecision(
+        aPrecision, aScale, bPrecision, bScale);
+  }
+};
+
+class Multiplication {
+ public:
+  template <typename R, typename A, typename B>
+  static R apply(
+      A a,
+      B b,
+      uint8_t /*aRescale*/,
+      uint8_t /*bRescale*/,
+      bool& overflow) {
+    R result;
+    overflow |= __builtin_mul_overflow(
+        static_cast<R>(a), static_cast<R>(b), &result);
+    overflow |= !resultInRange(result);
+    return result;
+  }
+
+  // The scale of the result is the sum of the scales. No rescaling needed.
+  static uint8_t computeRescaleFactor(
+      int32_t /*fromScale*/,
+      int32_t /*toScale*/) {
+    return 0;
+  }
+
+  static int32_t computeResultPrecision(
+      int32_t aPrecision,
+      int32_t /*aScale*/,
+      int32_t bPrecision,
+      int32_t /*bScale*/) {
+    return std::min(
+        DecimalUtil::kMaxLongDecimalPrecision, aPrecision + bPrecision);
+  }
+};
+
+template <typename Operation>
+std::shared_ptr<exec::VectorFunction> createDecimalFunction(
+    const std::string& name,
+    const std::vector<exec::VectorFunctionArg>& inputArgs) {
+  VELOX_CHECK_EQ(inputArgs.size(), 2, "{} takes two arguments", name);
+  const auto& aType = inputArgs[0].type;
+  const auto& bType = inputArgs[1].type;
+  int aPrecision, aScale, bPrecision, bScale;
+  getDecimalPrecisionScale(*aType, aPrecision, aScale);
+  getDecimalPrecisionScale(*bType, bPrecision, bScale);
+  const auto aRescale = Operation::computeRescaleFactor(aScale, bScale);
+  const auto bRescale = Operation::computeRescaleFactor(bScale, aScale);
+  // Values are computed in 64 bits whenever the result is a SHORT_DECIMAL.
+  const auto resultPrecision =
+      Operation::computeResultPrecision(aPrecision, aScale, bPrecision, bScale);
+  const bool shortResult =
+      resultPrecision <= DecimalUtil::kMaxShortDecimalPrecision;
+  const bool shortA = aType->kind() == TypeKind::SHORT_DECIMAL;
+  const bool shortB = bType->kind() == TypeKind::SHORT_DECIMAL;
+
+  if (shortResult) {
+    VELOX_CHECK(shortA && shortB);
+    return std::make_shared<
+        DecimalBaseFunction<int64_t, int64_t, int64_t, Operation>>(
+        aRescale, bRescale);
+  }
+  if (shortA && shortB) {
+    return std::make_shared<
+        DecimalBaseFunction<int128_t, int64_t, int64_t, Operation>>(
+        aRescale, bRescale);
+  }
+  if (shortA) {
+    return std::make_shared<
+        DecimalBaseFunction<int128_t, int64_t, int128_t, Operation>>(
+        aRescale, bRescale);
+  }
+  if (shortB) {
+    return std::make_shared<
+        DecimalBaseFunction<int128_t, int128_t, int64_t, Operation>>(
+        aRescale, bRescale);
+  }
+  return std::make_shared<
+      DecimalBaseFunction<int128_t, int128_t, int128_t, Operation>>(
+      aRescale, bRescale);
+}
+
+std::vector<std::shared_ptr<exec::FunctionSignature>>
+decimalAddSubtractSignature() {
+  return {exec::FunctionSignatureBuilder()
+              .returnType("DECIMAL(r_precision, r_scale)")
+              .argumentType("DECIMAL(a_precision, a_scale)")
+              .argumentType("DECIMAL(b_precision, b_scale)")
+              .variableConstraint(
+                  "r_precision",
+                  "min(38, max(a_precision - a_scale, b_precision - b_scale) + max(a_scale, b_scale) + 1)")
+              .variableConstraint("r_scale", "max(a_scale, b_scale)")
+              .build()};
+}
+
+std::vector<std::shared_ptr<exec::FunctionSignature>>
+decimalMultiplySignature() {
+  return {exec::FunctionSignatureBuilder()
+              .returnType("DECIMAL(r_precision, r_scale)")
+              .argumentType("DECIMAL(a_precision, a_scale)")
+              .argumentType("DECIMAL(b_precision, b_scale)")
+              .variableConstraint(
+                  "r_precision", "min(38, a_precision + b_precision)")
+              .variableConstraint("r_scale", "a_scale + b_scale")
+              .build()};
+}
+
+} // namespace
+
+VELOX_DECLARE_STATEFUL_VECTOR_FUNCTION(
+    udf_decimal_add,
+    decimalAddSubtractSignature(),
+    createDecimalFunction<Addition>);
+
+VELOX_DECLARE_STATEFUL_VECTOR_FUNCTION(
+    udf_decimal_sub,
+    decimalAddSubtractSignature(),
+    createDecimalFunction<Subtraction>);
+
+VELOX_DECLARE_STATEFUL_VECTOR_FUNCTION(
+    udf_decimal_mul,
+    decimalMultiplySignature(),
+    createDecimalFunction<Multiplication>);
+
+} // namespace facebook::velox::functions
@@ -13,12 +13,18 @@
  * See the License for the specific language governing permissions and
  * limitations under the License.
  */
+#include "velox/common/base/SimdUtil.h"
 #include "velox/expression/VectorFunction.h"
 #include "velox/type/Filter.h"
+#include "velox/type/StringViewSimd.h"
 
 namespace facebook::velox::functions {
 namespace {
 
+// Maximum size of an IN list of integers or strings that is tested by
+// comparing with each value instead of a lookup in a hash table or bitmask.
+constexpr int32_t kMaxSmallValues = 16;
+
 template <typename T, typename U = T>
 std::optional<std::pair<std::vector<T>, bool>> toValues(
     const std::vector<exec::VectorFunctionArg>& inputArgs) {
@@ -52,9 +58,12 @@ std::optional<std::pair<std::vector<T>, bool>> toValues(
       {std::move(values), nullAllowed});
 }
 
+// Sets 'smallValues' to the values of a list of at most kMaxSmallValues
+// values that are not a contiguous range.
 template <typename T>
 std::unique_ptr<common::Filter> createBigintValuesFilter(
-    const std::vector<exec::VectorFunctionArg>& inputArgs) {
+    const std::vector<exec::VectorFunctionArg>& inputArgs,
+    std::vector<int64_t>& smallValues) {
   auto valuesPair = toValues<int64_t, T>(inputArgs);
   if (!valuesPair.has_value()) {
     return nullptr;
@@ -71,11 +80,19 @@ std::unique_ptr<common::Filter> createBigintValuesFilter(
         values[0], values[0], nullAllowed);
   }
 
-  return common::createBigintValues(values, nullAllowed);
+  auto filter = common::createBigintValues(values, nullAllowed);
+  if (values.size() <= kMaxSmallValues &&
+      filter->kind() != common::FilterKind::kBigintRange) {
+    smallValues = values;
+  }
+  return filter;
 }
 
+// Sets 'smallStrings' to the values of a list of at most kMaxSmallValues
+// values.
 std::unique_ptr<common::Filter> createBytesValuesFilter(
-    const std::vector<exec::VectorFunctionArg>& inputArgs) {
+    const std::vector<exec::VectorFunctionArg>& inputArgs,
+    std::vector<std::string>& smallStrings) {
   auto valuesPair = toValues<std::string, StringView>(inputArgs);
   if (!valuesPair.has_value()) {
     return nullptr;
@@ -87,6 +104,9 @@ std::unique_ptr<common::Filter> createBytesValuesFilter(
   VELOX_USER_CHECK(
       !values.empty(),
       "IN predicate expects at least one non-null value in the in-list");
+  if (values.size() <= kMaxSmallValues) {
+    smallStrings = values;
+  }
   if (values.size() == 1) {
     return std::make_unique<common::BytesRange>(
         values[0], false, false, values[0], false, false, nullAllowed);
@@ -97,8 +117,13 @@ std::unique_ptr<common::Filter> createBytesValuesFilter(
 
 class InPredicate : public exec::VectorFunction {
  public:
-  explicit InPredicate(std::unique_ptr<common::Filter> filter)
-      : filter_{std::move(filter)} {}
+  InPredicate(
+      std::unique_ptr<common::Filter> filter,
+      std::vector<int64_t> smallValues,
+      std::vector<std::string> smallStrings)
+      : filter_{std::move(filter)},
+        smallValues_{std::move(smallValues)},
+        smallStrings_{std::move(smallStrings)} {}
 
   static std::shared_ptr<InPredicate> create(
       const std::string& /*name*/,
@@ -107,30 +132,33 @@ class InPredicate : public exec::VectorFunction {
     auto inListType = inputArgs[1].type;
     VELOX_CHECK_EQ(inListType->kind(), TypeKind::ARRAY);
     std::unique_ptr<common::Filter> filter;
+    std::vector<int64_t> smallValues;
+    std::vector<std::string> smallStrings;
 
     switch (inListType->childAt(0)->kind()) {
       case TypeKind::BIGINT:
-        filter = createBigintValuesFilter<int64_t>(inputArgs);
+        filter = createBigintValuesFilter<int64_t>(inputArgs, smallValues);
         break;
       case TypeKind::INTEGER:
-        filter = createBigintValuesFilter<int32_t>(inputArgs);
+        filter = createBigintValuesFilter<int32_t>(inputArgs, smallValues);
         break;
       case TypeKind::SMALLINT:
-        filter = createBigintValuesFilter<int16_t>(inputArgs);
+        filter = createBigintValuesFilter<int16_t>(inputArgs, smallValues);
         break;
       case TypeKind::TINYINT:
-        filter = createBigintValuesFilter<int8_t>(inputArgs);
+        filter = createBigintValuesFilter<int8_t>(inputArgs, smallValues);
         break;
       case TypeKind::VARCHAR:
       case TypeKind::VARBINARY:
-        filter = createBytesValuesFilter(inputArgs);
+        filter = createBytesValuesFilter(inputArgs, smallStrings);
         break;
       default:
         VELOX_UNSUPPORTED(
             "Unsupported in-list type for IN predicate: {}",
             inListType->toString());
     }
-    return std::make_shared<InPredicate>(std::move(filter));
+    return std::make_shared<InPredicate>(
+        std::move(filter), std::move(smallValues), std::move(smallStrings));
   }
 
   // x IN (2, null) returns null when x != 2 and true when x == 2.
@@ -208,6 +236,84 @@ class InPredicate : public exec::VectorFunction {
     return BaseVector::createConstant(value, size, context->pool());
   }
 
+  // Returns true if there is a SIMD test for a batch of T.
+  template <typename T>
+  bool canTestBatches() const {
+    if constexpr (std::is_same_v<T, StringView>) {
+      return !smallStrings_.empty();
+    }
+    if constexpr (std::is_integral_v<T>) {
+      if (!smallValues_.empty()) {
+        return true;
+      }
+      if constexpr (!std::is_same_v<T, int8_t>) {
+        // The other filters have no SIMD test of a batch.
+        return filter_->kind() == common::FilterKind::kBigintRange ||
+            filter_->kind() == common::FilterKind::kBigintValuesUsingHashTable;
+      }
+    }
+    return false;
+  }
+
+  // Returns a mask of the lanes of 'values' that are in the IN list.
+  template <typename T>
+  xsimd::batch_bool<T> testBatch(xsimd::batch<T> values) const {
+    if constexpr (!std::is_same_v<T, int8_t>) {
+      if (smallValues_.empty()) {
+        return filter_->testValues(values);
+      }
+    }
+    auto result = values == xsimd::broadcast<T>(smallValues_[0]);
+    for (auto i = 1; i < smallValues_.size(); ++i) {
+      result = result | (values == xsimd::broadcast<T>(smallValues_[i]));
+    }
+    return result;
+  }
+
+  // Sets the result bits of the first 'size' values a batch at a time.
+  template <typename T, typename F>
+  void applyBatches(
+      vector_size_t size,
+      const T* rawValues,
+      uint64_t* rawResults,
+      F testFunction) const {
+    constexpr int32_t kBatchSize = xsimd::batch<T>::size;
+    static_assert(64 % kBatchSize == 0);
+    constexpr uint64_t kBatchMask =
+        kBatchSize == 64 ? ~0ULL : bits::lowMask(kBatchSize);
+    vector_size_t row = 0;
+    for (; row + kBatchSize <= size; row += kBatchSize) {
+      const uint64_t passed =
+          simd::toBitMask(testBatch(xsimd::load_unaligned(rawValues + row))) &
+          kBatchMask;
+      auto& word = rawResults[row / 64];
+      const auto shift = row % 64;
+      word = (word & ~(kBatchMask << shift)) | (passed << shift);
+    }
+    for (; row < size; ++row) {
+      bits::setBit(rawResults, row, testFunction(rawValues[row]));
+    }
+  }
+
+  // Sets the result bits of the first 'size' strings. Each value of the IN
+  // list is compared with a SIMD batch of StringViews at a time.
+  void applyStringBatches(
+      vector_size_t size,
+      const StringView* rawValues,
+      uint64_t* rawResults) const {
+    simd::stringViewsEqual(
+        rawValues, size, StringView(smallStrings_[0]), rawResults);
+    if (smallStrings_.size() == 1) {
+      return;
+    }
+    std::vector<uint64_t> equal(bits::nwords(size));
+    for (auto i = 1; i < smallStrings_.size(); ++i) {
+      simd::stringViewsEqual(
+          rawValues, size, StringView(smallStrings_[i]), equal.data());
+      bits::orBits(rawResults, equal.data(), 0, size);
+    }
+  }
+
   template <typename T, typename F>
   void applyTyped(
       const SelectivityVector& rows,
@@ -260,6 +366,12 @@ class InPredicate : public exec::VectorFunction {
           }
         }
       });
+    } else if (rows.isAllSelected() && canTestBatches<T>()) {
+      if constexpr (std::is_integral_v<T>) {
+        applyBatches(rows.size(), rawValues, rawResults, testFunction);
+      } else if constexpr (std::is_same_v<T, StringView>) {
+        applyStringBatches(rows.size(), rawValues, rawResults);
+      }
     } else {
       rows.applyToSelected([&](auto row) {
         bool pass = testFunction(rawValues[row]);
@@ -269,6 +381,13 @@ class InPredicate : public exec::VectorFunction {
   }
 
   const std::unique_ptr<common::Filter> filter_;
+
+  // Values of a short IN list of integers, compared with each input value.
+  // Empty if batches are tested with 'filter_'.
+  const std::vector<int64_t> smallValues_;
+
+  // Values of a short IN list of strings, compared with each input value.
+  const std::vector<std::string> smallStrings_;
 };
 } // namespace
 
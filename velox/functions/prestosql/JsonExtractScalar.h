@@ -35,15 +35,62 @@ struct JsonExtractScalarFunction {
     const folly::StringPiece& jsonStringPiece = json;
     const folly::StringPiece& jsonPathStringPiece = jsonPath;
     auto extractResult =
-        jsonExtractScalar(jsonStringPiece, jsonPathStringPiece);
+        jsonExtractScalar(jsonStringPiece, jsonPathStringPiece, buffer_);
     if (extractResult.hasValue()) {
-      UDFOutputString::assign(result, *extractResult);
+      UDFOutputString::assign(
+          result,
+          std::string_view(extractResult->data(), extractResult->size()));
       return true;
 
     } else {
       return false;
     }
   }
+
+ private:
+  // Holds results that are not in the input, e.g. unescaped strings.
+  std::string buffer_;
+};
+
+// json_extract_scalars(json, json_path...) -> array(varchar)
+// Returns the results of json_extract_scalar(json, json_path) for each of the
+// paths. Reads or parses each document once instead of once per path, for
+// queries that extract several fields of the same JSON column.
+template <typename T>
+struct JsonExtractScalarsFunction {
+  VELOX_DEFINE_FUNCTION_TYPES(T);
+
+  FOLLY_ALWAYS_INLINE bool call(
+      out_type<Array<Varchar>>& result,
+      const arg_type<Varchar>& json,
+      const arg_type<Variadic<Varchar>>& jsonPaths) {
+    paths_.clear();
+    for (const auto& jsonPath : jsonPaths) {
+      const StringView& path = jsonPath.value();
+      paths_.emplace_back(path.data(), path.size());
+    }
+    jsonExtractScalars(
+        folly::StringPiece(json.data(), json.size()),
+        paths_,
+        results_,
+        buffers_);
+    result.reserve(results_.size());
+    for (const auto& extractResult : results_) {
+      if (extractResult.hasValue()) {
+        result.add_item().copy_from(
+            std::string_view(extractResult->data(), extractResult->size()));
+      } else {
+        result.add_null();
+      }
+    }
+    return true;
+  }
+
+ private:
+  // Reused across rows to avoid allocations.
+  std::vector<folly::StringPiece> paths_;
+  std::vector<folly::Optional<folly::StringPiece>> results_;
+  std::vector<std::string> buffers_;
 };
 
 } // namespace facebook::velox::functions
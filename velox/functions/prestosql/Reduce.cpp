@@ -24,7 +24,7 @@ namespace {
 /// Populates indices of the n-th elements of the arrays.
 /// Selects 'row' in 'arrayRows' if corresponding array has an n-th element.
 /// Sets elementIndices[row] to the index of the n-th element in the 'elements'
-/// vector.
+/// vector. Leaves the indices of other rows unchanged.
 /// Returns true if at least one array has n-th element.
 bool toNthElementRows(
     const ArrayVectorPtr& arrayVector,
@@ -39,7 +39,6 @@ bool toNthElementRows(
   auto* rawElementIndices = elementIndices->asMutable<vector_size_t>();
 
   arrayRows.clearAll();
-  memset(rawElementIndices, 0, elementIndices->size());
 
   rows.applyToSelected([&](auto row) {
     if (!rawNulls || !bits::isBitNull(rawNulls, row)) {
@@ -85,6 +84,7 @@ class ReduceFunction : public exec::VectorFunction {
     auto inputFuncIt = args[2]->asUnchecked<FunctionVector>()->iterator(&rows);
 
     SelectivityVector arrayRows(flatArray->size(), false);
+    SelectivityVector previousArrayRows(flatArray->size(), false);
     BufferPtr elementIndices =
         allocateIndices(flatArray->size(), context->pool());
 
@@ -113,14 +113,22 @@ class ReduceFunction : public exec::VectorFunction {
     // Then, apply input function to second elements of all arrays.
     // And so on until all elements of all arrays have been processed.
     // At each step the number of arrays being processed will get smaller as
-    // some arrays will run out of elements.
+    // some arrays will run out of elements. Each step produces a new state
+    // vector, so that the previous state is not copied. The state of an array
+    // is copied to 'partialResult' once the array runs out of elements.
     while (auto entry = inputFuncIt.next()) {
       VectorPtr state = initialState;
-
-      int n = 0;
-      while (true) {
-        if (!toNthElementRows(
-                flatArray, *entry.rows, n, arrayRows, elementIndices)) {
+      const SelectivityVector* candidateRows = entry.rows;
+
+      for (auto n = 0;; ++n) {
+        const bool hasNthElement = toNthElementRows(
+            flatArray, *candidateRows, n, arrayRows, elementIndices);
+        if (n > 0) {
+          // Arrays without an n-th element have their final state.
+          previousArrayRows.deselect(arrayRows);
+          partialResult->copy(state.get(), previousArrayRows, nullptr);
+        }
+        if (!hasNthElement) {
           break; // Ran out of elements in all arrays.
         }
 
@@ -131,10 +139,14 @@ class ReduceFunction : public exec::VectorFunction {
             flatArray->elements());
 
         std::vector<VectorPtr> lambdaArgs = {state, nthElement};
+        VectorPtr newState;
         entry.callable->apply(
-            arrayRows, nullptr, context, lambdaArgs, &partialResult);
-        state = partialResult;
-        n++;
+            arrayRows, nullptr, context, lambdaArgs, &newState);
+        state = std::move(newState);
+
+        // Only arrays with an n-th element can have an (n + 1)-th element.
+        std::swap(arrayRows, previousArrayRows);
+        candidateRows = &previousArrayRows;
       }
     }
 
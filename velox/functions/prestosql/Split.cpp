@@ -109,6 +109,11 @@ class SplitFunction : public exec::VectorFunction {
     ArrayBuilder<Varchar> builder(
         rows.end(), 3 * rows.countSelected(), context->pool());
 
+    // The elements point into the strings of the input. Tokens of at most
+    // StringView::kInlineSize bytes are copied into the StringView, so the
+    // input buffers are only kept if some token is longer.
+    bool mustRefSourceStrings = false;
+
     // Optimization for the (flat, const, const) case.
     if (strings->isIdentityMapping() and delims->isConstantMapping() and
         (noLimit or limits->isConstantMapping())) {
@@ -118,14 +123,16 @@ class SplitFunction : public exec::VectorFunction {
       if (noLimit) {
         const I limit = std::numeric_limits<I>::max();
         rows.applyToSelected([&](vector_size_t row) {
-          applyInner<false, I>(rawStrings[row], delim, limit, row, builder);
+          mustRefSourceStrings |=
+              applyInner<false, I>(rawStrings[row], delim, limit, row, builder);
         });
       } else {
         const I limit = limits->valueAt<I>(0);
         // Limit must be positive.
         if (limit > 0) {
           rows.applyToSelected([&](vector_size_t row) {
-            applyInner<true, I>(rawStrings[row], delim, limit, row, builder);
+            mustRefSourceStrings |= applyInner<true, I>(
+                rawStrings[row], delim, limit, row, builder);
           });
         } else {
           auto pex = std::make_exception_ptr(
@@ -134,18 +141,16 @@ class SplitFunction : public exec::VectorFunction {
               [&](vector_size_t row) { context->setError(row, pex); });
         }
       }
-
-      // Ensure that our result elements vector uses the same string buffer as
-      // the input vector of strings.
-      builder.setStringBuffers(
-          strings->base()->as<FlatVector<StringView>>()->stringBuffers());
     } else {
       // The rest of the cases are handled through this general path and no
       // direct access.
-      applyDecoded<I>(rows, context, strings, delims, limits, builder);
+      mustRefSourceStrings =
+          applyDecoded<I>(rows, context, strings, delims, limits, builder);
+    }
 
-      // Ensure that our result elements vector uses the same string buffer as
-      // the input vector of strings.
+    // Ensure that our result elements vector uses the same string buffer as
+    // the input vector of strings.
+    if (mustRefSourceStrings) {
       builder.setStringBuffers(strings->base());
     }
 
@@ -154,18 +159,20 @@ class SplitFunction : public exec::VectorFunction {
     context->moveOrCopyResult(arrayVector, rows, result);
   }
 
+  // Returns true if some element references the strings of the input.
   template <typename I>
-  void applyDecoded(
+  bool applyDecoded(
       const SelectivityVector& rows,
       exec::EvalCtx* context,
       DecodedVector* strings,
       DecodedVector* delims,
       DecodedVector* limits,
       ArrayBuilder<Varchar>& builder) const {
+    bool mustRefSourceStrings = false;
     if (limits == nullptr) {
       auto limit = std::numeric_limits<I>::max();
       rows.applyToSelected([&](vector_size_t row) {
-        applyInner<false, I>(
+        mustRefSourceStrings |= applyInner<false, I>(
             strings->valueAt<StringView>(row),
             delims->valueAt<StringView>(row),
             limit,
@@ -176,7 +183,7 @@ class SplitFunction : public exec::VectorFunction {
       rows.applyToSelected([&](vector_size_t row) {
         const I limit = limits->valueAt<I>(row);
         if (limit > 0) {
-          applyInner<true, I>(
+          mustRefSourceStrings |= applyInner<true, I>(
               strings->valueAt<StringView>(row),
               delims->valueAt<StringView>(row),
               limit,
@@ -189,13 +196,15 @@ class SplitFunction : public exec::VectorFunction {
         }
       });
     }
+    return mustRefSourceStrings;
   }
 
   /**
-   * The inner most kernel of the vector operations for 'split'.
+   * The inner most kernel of the vector operations for 'split'. Returns true
+   * if some of the added elements are not inlined and reference 'input'.
    */
   template <bool hasLimit = false, typename I>
-  inline void applyInner(
+  inline bool applyInner(
       StringView input,
       const StringView delim,
       I limit,
@@ -207,13 +216,14 @@ class SplitFunction : public exec::VectorFunction {
     // Trivial case of converting string to array with 1 element.
     if (hasLimit and limit == 1) {
       arrayRef.emplace_back(input);
-      return;
+      return !input.isInline();
     }
 
     // We walk through our input cutting off the pieces using the delimiter and
     // adding them to the elements vector, until we reached the end of the
     // string or the limit.
     int32_t addedElements{0};
+    bool mustRefSourceStrings = false;
     std::string_view sinput(input.data(), input.size());
     const std::string_view sdelim(delim.data(), delim.size());
     while (true) {
@@ -227,6 +237,7 @@ class SplitFunction : public exec::VectorFunction {
 
       // Add the new element, we've split
       arrayRef.emplace_back(StringView(sinput.data(), byteIndex));
+      mustRefSourceStrings |= !StringView::isInline(byteIndex);
 
       // Advance input by the size of the element + delimiter.
       // Note: should we add 'advance' method?
@@ -246,6 +257,7 @@ class SplitFunction : public exec::VectorFunction {
     // Add the rest of the string and we are done.
     // Note, that the rest of the string can be empty - we still add it.
     arrayRef.emplace_back(StringView(sinput.data(), sinput.size()));
+    return mustRefSourceStrings || !StringView::isInline(sinput.size());
   }
 };
 
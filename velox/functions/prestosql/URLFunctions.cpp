@@ -15,36 +15,76 @@
  */
 
 #include "URLFunctions.h"
+#include <algorithm>
 #include "velox/type/Type.h"
 
 namespace facebook::velox::functions {
 
-bool matchAuthorityAndPath(
-    const boost::cmatch& urlMatch,
-    boost::cmatch& authAndPathMatch,
-    boost::cmatch& authorityMatch,
-    bool& hasAuthority) {
-  static const boost::regex kAuthorityAndPathRegex("//([^/]*)(/.*)?");
-  auto authorityAndPath = submatch(urlMatch, 2);
-  if (!boost::regex_match(
-          authorityAndPath.begin(),
-          authorityAndPath.end(),
-          authAndPathMatch,
-          kAuthorityAndPathRegex)) {
+namespace {
+// Parses 'hostAndPort' as host, optionally followed by ':' and a decimal port.
+// The host is either an IP literal in brackets, e.g. [::1], or a run of
+// characters other than '[' and ':'.
+bool parseHostAndPort(const char* data, size_t size, AuthorityParts& parts) {
+  const char* end = data + size;
+  const char* pos = data;
+  if (pos < end && *pos == '[') {
+    while (pos < end && *pos != ']') {
+      ++pos;
+    }
+    if (pos == end) {
+      return false;
+    }
+    ++pos;
+  } else {
+    while (pos < end && *pos != '[' && *pos != ':') {
+      ++pos;
+    }
+  }
+  parts.host = StringView(data, pos - data);
+  parts.port = StringView();
+  if (pos == end) {
+    return true;
+  }
+  if (*pos != ':') {
+    return false;
+  }
+  const char* port = ++pos;
+  while (pos < end && std::isdigit(static_cast<unsigned char>(*pos))) {
+    ++pos;
+  }
+  parts.port = StringView(port, pos - port);
+  return pos == end;
+}
+} // namespace
+
+bool parseAuthorityAndPath(
+    StringView authorityAndPath,
+    bool& hasAuthority,
+    AuthorityParts& authority,
+    StringView& path) {
+  const char* data = authorityAndPath.data();
+  const size_t size = authorityAndPath.size();
+  if (size < 2 || data[0] != '/' || data[1] != '/') {
     // Does not start with //, doesn't have authority.
     hasAuthority = false;
     return true;
   }
 
-  static const boost::regex kAuthorityRegex(
-      "(?:([^@:]*)(?::([^@]*))?@)?" // username, password.
-      "(\\[[^\\]]*\\]|[^\\[:]*)" // host (IP-literal (e.g. '['+IPv6+']',
-      // dotted-IPv4, or named host).
-      "(?::(\\d*))?"); // port.
+  // The authority ends at the first '/', which starts the path.
+  const char* start = data + 2;
+  const char* end = data + size;
+  const char* pathStart = std::find(start, end, '/');
+  path = StringView(pathStart, end - pathStart);
 
-  const auto authority = authAndPathMatch[1];
-  if (!boost::regex_match(
-          authority.first, authority.second, authorityMatch, kAuthorityRegex)) {
+  // Optional user info ends at the first '@'. If the rest is not a valid
+  // host and port, the whole authority is tried as host and port.
+  const char* at = std::find(start, pathStart, '@');
+  if (at != pathStart &&
+      parseHostAndPort(at + 1, pathStart - at - 1, authority)) {
+    hasAuthority = true;
+    return true;
+  }
+  if (!parseHostAndPort(start, pathStart - start, authority)) {
     return false; // Invalid URI Authority.
   }
 
@@ -15,37 +15,91 @@
  */
 #pragma once
 
-#include <boost/regex.hpp>
 #include <cctype>
 #include "velox/functions/Macros.h"
 
 namespace facebook::velox::functions {
 
+// Components of a URL of the form scheme:authority-and-path?query#fragment.
+// All refer to the characters of the URL, so results can be returned without
+// copying. Missing components are empty.
+struct UrlParts {
+  StringView scheme;
+  StringView authorityAndPath;
+  StringView query;
+  StringView fragment;
+};
+
+// Host and port of the authority part of a URL. Both refer to the characters
+// of the URL.
+struct AuthorityParts {
+  StringView host;
+  StringView port;
+};
+
 namespace {
-FOLLY_ALWAYS_INLINE StringView submatch(const boost::cmatch& match, int idx) {
-  const auto& sub = match[idx];
-  return StringView(sub.first, sub.length());
+FOLLY_ALWAYS_INLINE bool isSchemeChar(char c) {
+  return std::isalnum(static_cast<unsigned char>(c)) || c == '+' ||
+      c == '-' || c == '.';
 }
 
+// Splits 'rawUrl' into 'parts' in a single pass. Returns false if 'rawUrl' does
+// not start with a scheme followed by ':'.
 template <typename TInString>
-bool parse(const TInString& rawUrl, boost::cmatch& match) {
-  static const boost::regex kUriRegex(
-      "([a-zA-Z][a-zA-Z0-9+.-]*):" // scheme:
-      "([^?#]*)" // authority and path
-      "(?:\\?([^#]*))?" // ?query
-      "(?:#(.*))?"); // #fragment
-
-  return boost::regex_match(
-      rawUrl.data(), rawUrl.data() + rawUrl.size(), match, kUriRegex);
+bool parse(const TInString& rawUrl, UrlParts& parts) {
+  const char* data = rawUrl.data();
+  const char* end = data + rawUrl.size();
+
+  // scheme: [a-zA-Z][a-zA-Z0-9+.-]*
+  if (data == end || !std::isalpha(static_cast<unsigned char>(*data))) {
+    return false;
+  }
+  const char* pos = data + 1;
+  while (pos < end && isSchemeChar(*pos)) {
+    ++pos;
+  }
+  if (pos == end || *pos != ':') {
+    return false;
+  }
+  parts.scheme = StringView(data, pos - data);
+  ++pos;
+
+  // Authority and path end at the first '?' or '#'.
+  const char* start = pos;
+  while (pos < end && *pos != '?' && *pos != '#') {
+    ++pos;
+  }
+  parts.authorityAndPath = StringView(start, pos - start);
+
+  parts.query = StringView();
+  if (pos < end && *pos == '?') {
+    start = ++pos;
+    while (pos < end && *pos != '#') {
+      ++pos;
+    }
+    parts.query = StringView(start, pos - start);
+  }
+
+  parts.fragment = StringView();
+  if (pos < end) {
+    // *pos is '#'.
+    ++pos;
+    parts.fragment = StringView(pos, end - pos);
+  }
+  return true;
 }
 
 } // namespace
 
-bool matchAuthorityAndPath(
-    const boost::cmatch& urlMatch,
-    boost::cmatch& authAndPathMatch,
-    boost::cmatch& authorityMatch,
-    bool& hasAuthority);
+// Splits 'authorityAndPath' of a URL into authority and path. Sets
+// 'hasAuthority' to false and returns true if there is no authority, i.e.
+// 'authorityAndPath' does not start with "//". Returns false if the authority
+// is malformed.
+bool parseAuthorityAndPath(
+    StringView authorityAndPath,
+    bool& hasAuthority,
+    AuthorityParts& authority,
+    StringView& path);
 
 template <typename T>
 struct UrlExtractProtocolFunction {
@@ -60,11 +114,11 @@ struct UrlExtractProtocolFunction {
   FOLLY_ALWAYS_INLINE bool call(
       out_type<Varchar>& result,
       const arg_type<Varchar>& url) {
-    boost::cmatch match;
-    if (!parse(url, match)) {
+    UrlParts parts;
+    if (!parse(url, parts)) {
       result.setEmpty();
     } else {
-      result.setNoCopy(submatch(match, 1));
+      result.setNoCopy(parts.scheme);
     }
     return true;
   }
@@ -83,11 +137,11 @@ struct UrlExtractFragmentFunction {
   FOLLY_ALWAYS_INLINE bool call(
       out_type<Varchar>& result,
       const arg_type<Varchar>& url) {
-    boost::cmatch match;
-    if (!parse(url, match)) {
+    UrlParts parts;
+    if (!parse(url, parts)) {
       result.setEmpty();
     } else {
-      result.setNoCopy(submatch(match, 4));
+      result.setNoCopy(parts.fragment);
     }
     return true;
   }
@@ -106,19 +160,19 @@ struct UrlExtractHostFunction {
   FOLLY_ALWAYS_INLINE bool call(
       out_type<Varchar>& result,
       const arg_type<Varchar>& url) {
-    boost::cmatch match;
-    if (!parse(url, match)) {
+    UrlParts parts;
+    if (!parse(url, parts)) {
       result.setEmpty();
       return true;
     }
-    boost::cmatch authAndPathMatch;
-    boost::cmatch authorityMatch;
     bool hasAuthority;
+    AuthorityParts authority;
+    StringView path;
 
-    if (matchAuthorityAndPath(
-            match, authAndPathMatch, authorityMatch, hasAuthority) &&
+    if (parseAuthorityAndPath(
+            parts.authorityAndPath, hasAuthority, authority, path) &&
         hasAuthority) {
-      result.setNoCopy(submatch(authorityMatch, 3));
+      result.setNoCopy(authority.host);
     } else {
       result.setEmpty();
     }
@@ -131,18 +185,18 @@ struct UrlExtractPortFunction {
   VELOX_DEFINE_FUNCTION_TYPES(T);
 
   FOLLY_ALWAYS_INLINE bool call(int64_t& result, const arg_type<Varchar>& url) {
-    boost::cmatch match;
-    if (!parse(url, match)) {
+    UrlParts parts;
+    if (!parse(url, parts)) {
       return false;
     }
 
-    boost::cmatch authAndPathMatch;
-    boost::cmatch authorityMatch;
     bool hasAuthority;
-    if (matchAuthorityAndPath(
-            match, authAndPathMatch, authorityMatch, hasAuthority) &&
+    AuthorityParts authority;
+    StringView path;
+    if (parseAuthorityAndPath(
+            parts.authorityAndPath, hasAuthority, authority, path) &&
         hasAuthority) {
-      auto port = submatch(authorityMatch, 4);
+      auto port = authority.port;
       if (!port.empty()) {
         try {
           result = to<int64_t>(port);
@@ -168,22 +222,22 @@ struct UrlExtractPathFunction {
   FOLLY_ALWAYS_INLINE bool call(
       out_type<Varchar>& result,
       const arg_type<Varchar>& url) {
-    boost::cmatch match;
-    if (!parse(url, match)) {
+    UrlParts parts;
+    if (!parse(url, parts)) {
       result.setEmpty();
       return true;
     }
 
-    boost::cmatch authAndPathMatch;
-    boost::cmatch authorityMatch;
     bool hasAuthority;
+    AuthorityParts authority;
+    StringView path;
 
-    if (matchAuthorityAndPath(
-            match, authAndPathMatch, authorityMatch, hasAuthority)) {
+    if (parseAuthorityAndPath(
+            parts.authorityAndPath, hasAuthority, authority, path)) {
       if (hasAuthority) {
-        result.setNoCopy(submatch(authAndPathMatch, 2));
+        result.setNoCopy(path);
       } else {
-        result.setNoCopy(submatch(match, 2));
+        result.setNoCopy(parts.authorityAndPath);
       }
     }
 
@@ -204,14 +258,13 @@ struct UrlExtractQueryFunction {
   FOLLY_ALWAYS_INLINE bool call(
       out_type<Varchar>& result,
       const arg_type<Varchar>& url) {
-    boost::cmatch match;
-    if (!parse(url, match)) {
+    UrlParts parts;
+    if (!parse(url, parts)) {
       result.setEmpty();
       return true;
     }
 
-    auto query = submatch(match, 3);
-    result.setNoCopy(query);
+    result.setNoCopy(parts.query);
     return true;
   }
 };
@@ -230,37 +283,36 @@ struct UrlExtractParameterFunction {
       out_type<Varchar>& result,
       const arg_type<Varchar>& url,
       const arg_type<Varchar>& param) {
-    boost::cmatch match;
-    if (!parse(url, match)) {
+    UrlParts parts;
+    if (!parse(url, parts)) {
       result.setEmpty();
       return false;
     }
 
-    auto query = submatch(match, 3);
-    if (!query.empty()) {
-      // Parse query string.
-      static const boost::regex kQueryParamRegex(
-          "(^|&)" // start of query or start of parameter "&"
-          "([^=&]*)=?" // parameter name and "=" if value is expected
-          "([^=&]*)" // parameter value
-          "(?=(&|$))" // forward reference, next should be end of query or
-                      // start of next parameter
-      );
-
-      const boost::cregex_iterator begin(
-          query.data(), query.data() + query.size(), kQueryParamRegex);
-      boost::cregex_iterator end;
-
-      for (auto it = begin; it != end; ++it) {
-        if (it->length(2) != 0) { // key shouldnt be empty.
-          auto key = submatch((*it), 2);
-          if (param.compare(key) == 0) {
-            auto value = submatch((*it), 3);
-            result.setNoCopy(value);
-            return true;
-          }
+    // Parameters are separated by '&'. Each is a non-empty name, optionally
+    // followed by '=' and a value. Parameters with more than one '=' are
+    // skipped.
+    const char* pos = parts.query.data();
+    const char* end = pos + parts.query.size();
+    while (pos < end) {
+      const char* start = pos;
+      const char* equals = nullptr;
+      bool valid = true;
+      for (; pos < end && *pos != '&'; ++pos) {
+        if (*pos == '=') {
+          valid = equals == nullptr;
+          equals = pos;
         }
       }
+      const char* nameEnd = equals ? equals : pos;
+      if (valid && nameEnd != start &&
+          param.compare(StringView(start, nameEnd - start)) == 0) {
+        const char* value = equals ? equals + 1 : pos;
+        result.setNoCopy(StringView(value, pos - value));
+        return true;
+      }
+      // Skip the '&'.
+      ++pos;
     }
 
     return false;
@@ -177,9 +177,11 @@ struct ApproxMostFrequentAggregate : exec::Aggregate {
       const SelectivityVector& rows,
       const std::vector<VectorPtr>& args) {
     VELOX_CHECK_EQ(args.size(), 3);
-    DecodedVector decodedBuckets(*args[0], rows);
+    decodedBuckets_.decode(*args[0], rows);
+    auto& decodedBuckets = decodedBuckets_;
     decodedValues_.decode(*args[1], rows);
-    DecodedVector decodedCapacity(*args[2], rows);
+    decodedCapacity_.decode(*args[2], rows);
+    auto& decodedCapacity = decodedCapacity_;
     setConstantArgument("Buckets", buckets_, decodedBuckets);
     setConstantArgument("Capacity", capacity_, decodedCapacity);
   }
@@ -218,7 +220,8 @@ struct ApproxMostFrequentAggregate : exec::Aggregate {
       const SelectivityVector& rows,
       const std::vector<VectorPtr>& args) {
     VELOX_CHECK_EQ(args.size(), 1);
-    DecodedVector decoded(*args[0], rows);
+    decodedIntermediates_.decode(*args[0], rows);
+    auto& decoded = decodedIntermediates_;
     auto rowVec = static_cast<const RowVector*>(decoded.base());
     auto buckets = rowVec->childAt(0)->as<SimpleVector<int64_t>>();
     auto capacity = rowVec->childAt(1)->as<SimpleVector<int64_t>>();
@@ -279,6 +282,9 @@ struct ApproxMostFrequentAggregate : exec::Aggregate {
 
   static constexpr int64_t kMissingArgument = -1;
   DecodedVector decodedValues_;
+  DecodedVector decodedBuckets_;
+  DecodedVector decodedCapacity_;
+  DecodedVector decodedIntermediates_;
   int64_t buckets_ = kMissingArgument;
   int64_t capacity_ = kMissingArgument;
 };
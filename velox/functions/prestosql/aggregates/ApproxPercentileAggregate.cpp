@@ -51,6 +51,10 @@ struct KllSketchAccumulator {
     sketch_.insert(value);
   }
 
+  void append(const T* values, size_t size) {
+    sketch_.insert(values, size);
+  }
+
   void append(T value, int64_t count) {
     constexpr size_t kMaxBufferSize = 4096;
     constexpr int64_t kMinCountToBuffer = 512;
@@ -280,6 +284,8 @@ class ApproxPercentileAggregate : public exec::Aggregate {
 
           accumulator->append(decodedValue_.valueAt<T>(row));
         });
+      } else if (decodedValue_.isIdentityMapping() && rows.isAllSelected()) {
+        accumulator->append(decodedValue_.data<T>(), rows.size());
       } else {
         rows.applyToSelected([&](auto row) {
           accumulator->append(decodedValue_.valueAt<T>(row));
@@ -56,7 +56,8 @@ class ArbitraryAggregate : public SimpleNumericAggregate<T, T, T> {
       const SelectivityVector& rows,
       const std::vector<VectorPtr>& args,
       bool /*unused*/) override {
-    DecodedVector decoded(*args[0], rows);
+    this->decodedRaw_.decode(*args[0], rows);
+    auto& decoded = this->decodedRaw_;
 
     if (decoded.isConstantMapping()) {
       if (decoded.isNullAt(0)) {
@@ -96,7 +97,8 @@ class ArbitraryAggregate : public SimpleNumericAggregate<T, T, T> {
       const SelectivityVector& rows,
       const std::vector<VectorPtr>& args,
       bool /*unused*/) override {
-    DecodedVector decoded(*args[0], rows);
+    this->decodedRaw_.decode(*args[0], rows);
+    auto& decoded = this->decodedRaw_;
 
     if (decoded.isConstantMapping()) {
       if (decoded.isNullAt(0)) {
@@ -192,7 +194,8 @@ class NonNumericArbitrary : public exec::Aggregate {
       const SelectivityVector& rows,
       const std::vector<VectorPtr>& args,
       bool /*unused*/) override {
-    DecodedVector decoded(*args[0], rows, true);
+    decodedRaw_.decode(*args[0], rows, true);
+    auto& decoded = decodedRaw_;
     if (decoded.isConstantMapping() && decoded.isNullAt(0)) {
       // nothing to do; all values are nulls
       return;
@@ -224,7 +227,8 @@ class NonNumericArbitrary : public exec::Aggregate {
       const SelectivityVector& rows,
       const std::vector<VectorPtr>& args,
       bool /*unused*/) override {
-    DecodedVector decoded(*args[0], rows, true);
+    decodedRaw_.decode(*args[0], rows, true);
+    auto& decoded = decodedRaw_;
     if (decoded.isConstantMapping() && decoded.isNullAt(0)) {
       // nothing to do; all values are nulls
       return;
@@ -250,6 +254,11 @@ class NonNumericArbitrary : public exec::Aggregate {
       bool mayPushdown) override {
     addSingleGroupRawInput(group, rows, args, mayPushdown);
   }
+
+ private:
+  // Decodes the raw and intermediate input, which are the same. Kept to
+  // reuse memory between batches.
+  DecodedVector decodedRaw_;
 };
 
 bool registerArbitraryAggregate(const std::string& name) {
@@ -0,0 +1,216 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#pragma once
+
+#include <folly/hash/Hash.h>
+
+#include "velox/common/base/BitUtil.h"
+#include "velox/common/memory/HashStringAllocator.h"
+
+namespace facebook::velox::aggregate {
+
+// Open addressing hash map from fixed width keys to fixed width values for
+// use as an aggregate accumulator. Up to kInlineCapacity entries are stored
+// inside the map itself, so that small groups do not allocate. Larger maps
+// keep their entries and a byte of hash tag per slot in a single block of the
+// HashStringAllocator. The map has no destructor. free() must be called to
+// return the block to the allocator.
+template <typename K, typename V>
+class ArenaHashMap {
+ public:
+  ArenaHashMap() = default;
+
+  // Returns the value for 'key'. Inserts 'key' with a value-initialized value
+  // if 'key' is not in the map. The reference is valid until the next insert.
+  V& findOrInsert(const K& key, HashStringAllocator* allocator) {
+    if (capacity_ == 0) {
+      auto* entries = inlineEntries();
+      for (auto i = 0; i < size_; ++i) {
+        if (entries[i].key == key) {
+          return entries[i].value;
+        }
+      }
+      if (size_ < kInlineCapacity) {
+        new (&entries[size_]) Entry{key, V()};
+        return entries[size_++].value;
+      }
+      rehash(kInitialCapacity, allocator);
+      return insertNew(key, hash(key));
+    }
+
+    const auto keyHash = hash(key);
+    const auto keyTag = tag(keyHash);
+    auto* tags = tagsOf(header_, capacity_);
+    auto* entries = entriesOf(header_);
+    const auto mask = capacity_ - 1;
+    for (auto i = keyHash & mask; tags[i] != kEmpty; i = (i + 1) & mask) {
+      if (tags[i] == keyTag && entries[i].key == key) {
+        return entries[i].value;
+      }
+    }
+    // Keeps the load factor at most 3/4.
+    if ((size_ + 1) * 4 > capacity_ * 3) {
+      rehash(capacity_ * 2, allocator);
+    }
+    return insertNew(key, keyHash);
+  }
+
+  int32_t size() const {
+    return size_;
+  }
+
+  // Calls 'func(key, value)' for each entry in no particular order.
+  template <typename Func>
+  void forEach(Func func) const {
+    if (capacity_ == 0) {
+      auto* entries = inlineEntries();
+      for (auto i = 0; i < size_; ++i) {
+        func(entries[i].key, entries[i].value);
+      }
+      return;
+    }
+    const auto* tags = tagsOf(header_, capacity_);
+    const auto* entries = entriesOf(header_);
+    for (auto i = 0; i < capacity_; ++i) {
+      if (tags[i] != kEmpty) {
+        func(entries[i].key, entries[i].value);
+      }
+    }
+  }
+
+  // Returns the allocation of a map with more than kInlineCapacity entries to
+  // 'allocator' and leaves the map empty.
+  void free(HashStringAllocator* allocator) {
+    if (capacity_ != 0) {
+      allocator->free(header_);
+      capacity_ = 0;
+    }
+    size_ = 0;
+  }
+
+ private:
+  struct Entry {
+    K key;
+    V value;
+  };
+
+  static_assert(std::is_trivially_copyable_v<Entry>);
+
+  // Size of the inline storage. Gives 2 entries of 8 byte keys and values.
+  static constexpr int32_t kInlineBytes = 32;
+  static constexpr int32_t kInlineCapacity =
+      std::max<int32_t>(1, kInlineBytes / sizeof(Entry));
+  static constexpr int32_t kInitialCapacity = 16;
+
+  // Tag of an empty slot. The tags of keys have the high bit set.
+  static constexpr uint8_t kEmpty = 0;
+
+  static uint64_t hash(const K& key) {
+    // std::hash is the identity for integers. Mix the bits so that the low
+    // bits used for the slot and the high bits used for the tag both vary.
+    return folly::hash::twang_mix64(std::hash<K>{}(key));
+  }
+
+  static uint8_t tag(uint64_t hash) {
+    return 0x80 | (hash >> 57);
+  }
+
+  // The entries start at the first address aligned for Entry in the
+  // allocation. The tags follow the entries.
+  static Entry* entriesOf(HashStringAllocator::Header* header) {
+    return reinterpret_cast<Entry*>(bits::roundUp(
+        reinterpret_cast<uintptr_t>(header->begin()), alignof(Entry)));
+  }
+
+  static uint8_t* tagsOf(
+      HashStringAllocator::Header* header,
+      int32_t capacity) {
+    return reinterpret_cast<uint8_t*>(entriesOf(header) + capacity);
+  }
+
+  Entry* inlineEntries() {
+    return reinterpret_cast<Entry*>(inline_);
+  }
+
+  const Entry* inlineEntries() const {
+    return reinterpret_cast<const Entry*>(inline_);
+  }
+
+  // Inserts 'key', which is known not to be in the table, into a free slot.
+  V& insertNew(const K& key, uint64_t keyHash) {
+    auto* tags = tagsOf(header_, capacity_);
+    const auto mask = capacity_ - 1;
+    auto i = keyHash & mask;
+    while (tags[i] != kEmpty) {
+      i = (i + 1) & mask;
+    }
+    tags[i] = tag(keyHash);
+    auto* entry = new (entriesOf(header_) + i) Entry{key, V()};
+    ++size_;
+    return entry->value;
+  }
+
+  // Moves the entries into a new table of 'newCapacity' slots.
+  void rehash(int32_t newCapacity, HashStringAllocator* allocator) {
+    const auto oldCapacity = capacity_;
+    const auto numEntries = size_;
+    alignas(Entry) char oldInline[sizeof(inline_)];
+    HashStringAllocator::Header* oldHeader = nullptr;
+    const Entry* oldEntries;
+    const uint8_t* oldTags = nullptr;
+    if (oldCapacity == 0) {
+      memcpy(oldInline, inline_, sizeof(Entry) * numEntries);
+      oldEntries = reinterpret_cast<const Entry*>(oldInline);
+    } else {
+      oldHeader = header_;
+      oldEntries = entriesOf(oldHeader);
+      oldTags = tagsOf(oldHeader, oldCapacity);
+    }
+
+    header_ = allocator->allocate(
+        newCapacity * (sizeof(Entry) + 1) + alignof(Entry) - 1);
+    capacity_ = newCapacity;
+    size_ = 0;
+    memset(tagsOf(header_, capacity_), kEmpty, capacity_);
+
+    if (oldCapacity == 0) {
+      for (auto i = 0; i < numEntries; ++i) {
+        insertNew(oldEntries[i].key, hash(oldEntries[i].key)) =
+            oldEntries[i].value;
+      }
+    } else {
+      for (auto i = 0; i < oldCapacity; ++i) {
+        if (oldTags[i] != kEmpty) {
+          insertNew(oldEntries[i].key, hash(oldEntries[i].key)) =
+              oldEntries[i].value;
+        }
+      }
+      allocator->free(oldHeader);
+    }
+  }
+
+  int32_t size_{0};
+
+  // Number of slots in the table. 0 while the entries are stored inline.
+  int32_t capacity_{0};
+
+  union {
+    alignas(Entry) char inline_[kInlineCapacity * sizeof(Entry)];
+    HashStringAllocator::Header* header_;
+  };
+};
+
+} // namespace facebook::velox::aggregate
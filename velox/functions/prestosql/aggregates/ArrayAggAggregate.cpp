@@ -60,6 +60,7 @@ class ArrayAggAggregate : public exec::Aggregate {
 
     auto elements = vector->elements();
     elements->resize(countElements(groups, numGroups));
+    reserveStringBuffer(groups, numGroups, *elements);
 
     uint64_t* rawNulls = getRawNulls(vector);
     vector_size_t offset = 0;
@@ -69,10 +70,7 @@ class ArrayAggAggregate : public exec::Aggregate {
       auto& values = value<ArrayAccumulator>(groups[i])->elements;
       auto arraySize = values.size();
       if (arraySize) {
-        ValueListReader reader(values);
-        for (auto index = 0; index < arraySize; ++index) {
-          reader.next(*elements, offset + index);
-        }
+        readValues(values, *elements, offset);
         vector->setOffsetAndSize(i, offset, arraySize);
         offset += arraySize;
       } else {
@@ -170,6 +168,68 @@ class ArrayAggAggregate : public exec::Aggregate {
     return size;
   }
 
+  // Makes space for the strings of all groups in one buffer of a flat
+  // VARCHAR or VARBINARY 'elements' vector, so that reading the values does
+  // not allocate a new buffer each time the last one fills up.
+  void reserveStringBuffer(
+      char** groups,
+      int32_t numGroups,
+      BaseVector& elements) const {
+    if (elements.encoding() != VectorEncoding::Simple::FLAT ||
+        (elements.typeKind() != TypeKind::VARCHAR &&
+         elements.typeKind() != TypeKind::VARBINARY)) {
+      return;
+    }
+    uint64_t totalBytes = 0;
+    for (int32_t i = 0; i < numGroups; ++i) {
+      totalBytes += value<ArrayAccumulator>(groups[i])->elements.totalBytes();
+    }
+    if (totalBytes > 0 && totalBytes <= std::numeric_limits<int32_t>::max()) {
+      elements.asUnchecked<FlatVector<StringView>>()->getBufferWithSpace(
+          totalBytes);
+    }
+  }
+
+  // Reads 'values' into 'elements' starting at 'offset'. Values of fixed
+  // width types are copied in bulk.
+  static void
+  readValues(ValueList& values, BaseVector& elements, vector_size_t offset) {
+    ValueListReader reader(values);
+    if (elements.encoding() == VectorEncoding::Simple::FLAT) {
+      switch (elements.typeKind()) {
+        case TypeKind::TINYINT:
+          return readFixedWidth<int8_t>(reader, elements, offset);
+        case TypeKind::SMALLINT:
+          return readFixedWidth<int16_t>(reader, elements, offset);
+        case TypeKind::INTEGER:
+          return readFixedWidth<int32_t>(reader, elements, offset);
+        case TypeKind::BIGINT:
+          return readFixedWidth<int64_t>(reader, elements, offset);
+        case TypeKind::REAL:
+          return readFixedWidth<float>(reader, elements, offset);
+        case TypeKind::DOUBLE:
+          return readFixedWidth<double>(reader, elements, offset);
+        case TypeKind::TIMESTAMP:
+          return readFixedWidth<Timestamp>(reader, elements, offset);
+        case TypeKind::DATE:
+          return readFixedWidth<Date>(reader, elements, offset);
+        default:
+          break;
+      }
+    }
+    for (auto index = 0; index < values.size(); ++index) {
+      reader.next(elements, offset + index);
+    }
+  }
+
+  template <typename T>
+  static void readFixedWidth(
+      ValueListReader& reader,
+      BaseVector& elements,
+      vector_size_t offset) {
+    reader.readAll(*elements.asUnchecked<FlatVector<T>>(), offset);
+  }
+
   // Reusable instance of DecodedVector for decoding input vectors.
   DecodedVector decodedElements_;
   DecodedVector decodedIntermediate_;
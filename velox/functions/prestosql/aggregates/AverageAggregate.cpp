@@ -16,6 +16,7 @@
 #include "velox/exec/Aggregate.h"
 #include "velox/expression/FunctionSignature.h"
 #include "velox/functions/prestosql/aggregates/AggregateNames.h"
+#include "velox/functions/prestosql/aggregates/DecimalAggregate.h"
 #include "velox/vector/ComplexVector.h"
 #include "velox/vector/DecodedVector.h"
 #include "velox/vector/FlatVector.h"
@@ -42,6 +43,10 @@ class AverageAggregate : public exec::Aggregate {
     return sizeof(SumCount);
   }
 
+  bool accumulatorUsesAllocator() const override {
+    return false;
+  }
+
   void initializeNewGroups(
       char** groups,
       folly::Range<const vector_size_t*> indices) override {
@@ -307,6 +312,16 @@ bool registerAverageAggregate(const std::string& name) {
                            .intermediateType("row(double,bigint)")
                            .argumentType("real")
                            .build());
+  signatures.push_back(
+      exec::AggregateFunctionSignatureBuilder()
+          .returnType("DECIMAL(r_precision, r_scale)")
+          .intermediateType("ROW(DECIMAL(i_precision, i_scale), BIGINT)")
+          .argumentType("DECIMAL(a_precision, a_scale)")
+          .variableConstraint("r_precision", "a_precision")
+          .variableConstraint("r_scale", "a_scale")
+          .variableConstraint("i_precision", "38")
+          .variableConstraint("i_scale", "a_scale")
+          .build());
 
   exec::registerAggregateFunction(
       name,
@@ -330,12 +345,23 @@ bool registerAverageAggregate(const std::string& name) {
               return std::make_unique<AverageAggregate<float>>(resultType);
             case TypeKind::DOUBLE:
               return std::make_unique<AverageAggregate<double>>(resultType);
+            case TypeKind::SHORT_DECIMAL:
+              return std::make_unique<DecimalAverageAggregate<int64_t>>(
+                  resultType);
+            case TypeKind::LONG_DECIMAL:
+              return std::make_unique<DecimalAverageAggregate<int128_t>>(
+                  resultType);
             default:
               VELOX_FAIL(
                   "Unknown input type for {} aggregation {}",
                   name,
                   inputType->kindName());
           }
+        } else if (
+            inputType->kind() == TypeKind::ROW &&
+            inputType->childAt(0)->kind() == TypeKind::LONG_DECIMAL) {
+          return std::make_unique<DecimalAverageAggregate<int128_t>>(
+              resultType);
         } else {
           checkSumCountRowType(
               inputType,
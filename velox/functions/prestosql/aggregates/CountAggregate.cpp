@@ -52,13 +52,20 @@ class CountAggregate : public SimpleNumericAggregate<bool, int64_t, int64_t> {
       char** groups,
       const SelectivityVector& rows,
       const std::vector<VectorPtr>& args,
-      bool /*mayPushdown*/) override {
+      bool mayPushdown) override {
     if (args.empty()) {
       rows.applyToSelected([&](vector_size_t i) { addToGroup(groups[i], 1); });
       return;
     }
 
-    DecodedVector decoded(*args[0], rows);
+    if (mayPushdown && args[0]->isLazy() &&
+        AggregationHook::supportsKind(args[0]->typeKind())) {
+      BaseAggregate::template pushdown<CountHook>(groups, rows, args[0]);
+      return;
+    }
+
+    decodedRaw_.decode(*args[0], rows);
+    auto& decoded = decodedRaw_;
     if (decoded.isConstantMapping()) {
       if (!decoded.isNullAt(0)) {
         rows.applyToSelected(
@@ -97,12 +104,19 @@ class CountAggregate : public SimpleNumericAggregate<bool, int64_t, int64_t> {
       return;
     }
 
-    DecodedVector decoded(*args[0], rows);
+    decodedRaw_.decode(*args[0], rows);
+    auto& decoded = decodedRaw_;
     if (decoded.isConstantMapping()) {
       if (!decoded.isNullAt(0)) {
         addToGroup(group, rows.size());
       }
     } else if (decoded.mayHaveNulls()) {
+      if (decoded.isIdentityMapping() && rows.isAllSelected()) {
+        // Count the non-null bits a word at a time.
+        addToGroup(
+            group, bits::countBits(decoded.nulls(), rows.begin(), rows.end()));
+        return;
+      }
       int64_t nonNullCount = 0;
       rows.applyToSelected([&](vector_size_t i) {
         if (!decoded.isNullAt(i)) {
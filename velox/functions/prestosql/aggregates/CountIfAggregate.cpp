@@ -15,6 +15,7 @@
  */
 
 #include "velox/exec/Aggregate.h"
+#include "velox/exec/AggregationHook.h"
 #include "velox/expression/FunctionSignature.h"
 #include "velox/functions/prestosql/aggregates/AggregateNames.h"
 #include "velox/vector/DecodedVector.h"
@@ -31,6 +32,10 @@ class CountIfAggregate : public exec::Aggregate {
     return sizeof(int64_t);
   }
 
+  bool accumulatorUsesAllocator() const override {
+    return false;
+  }
+
   void initializeNewGroups(
       char** groups,
       folly::Range<const vector_size_t*> indices) override {
@@ -62,8 +67,14 @@ class CountIfAggregate : public exec::Aggregate {
       char** groups,
       const SelectivityVector& rows,
       const std::vector<VectorPtr>& args,
-      bool /*mayPushdown*/) override {
-    DecodedVector decoded(*args[0], rows);
+      bool mayPushdown) override {
+    if (mayPushdown && args[0]->isLazy()) {
+      pushdown<CountIfHook>(groups, rows, args[0]);
+      return;
+    }
+
+    decodedRaw_.decode(*args[0], rows);
+    auto& decoded = decodedRaw_;
 
     if (decoded.isConstantMapping()) {
       if (decoded.isNullAt(0)) {
@@ -96,7 +107,8 @@ class CountIfAggregate : public exec::Aggregate {
       const SelectivityVector& rows,
       const std::vector<VectorPtr>& args,
       bool /*mayPushdown*/) override {
-    DecodedVector decoded(*args[0], rows);
+    decodedIntermediate_.decode(*args[0], rows);
+    auto& decoded = decodedIntermediate_;
 
     if (decoded.isConstantMapping()) {
       auto numTrue = decoded.valueAt<int64_t>(0);
@@ -116,7 +128,8 @@ class CountIfAggregate : public exec::Aggregate {
       const SelectivityVector& rows,
       const std::vector<VectorPtr>& args,
       bool /*mayPushdown*/) override {
-    DecodedVector decoded(*args[0], rows);
+    decodedRaw_.decode(*args[0], rows);
+    auto& decoded = decodedRaw_;
 
     // Constant mapping - check once and add number of selected rows if true.
     if (decoded.isConstantMapping()) {
@@ -163,6 +176,10 @@ class CountIfAggregate : public exec::Aggregate {
   inline void addToGroup(char* group, int64_t numTrue) {
     *value<int64_t>(group) += numTrue;
   }
+
+  // Kept to reuse memory between batches.
+  DecodedVector decodedRaw_;
+  DecodedVector decodedIntermediate_;
 };
 
 bool registerCountIfAggregate(const std::string& name) {
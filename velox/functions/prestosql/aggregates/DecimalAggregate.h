@@ -0,0 +1,336 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#pragma once
+
+#include "velox/exec/Aggregate.h"
+#include "velox/type/DecimalUtil.h"
+#include "velox/vector/ComplexVector.h"
+#include "velox/vector/DecodedVector.h"
+#include "velox/vector/FlatVector.h"
+
+namespace facebook::velox::aggregate {
+
+// Accumulator of the sum and count of decimal values. The sum is kept as an
+// int128_t regardless of the input type. Rows of a RowContainer do not align
+// the accumulators, so the sum is read and written with memcpy.
+struct DecimalSumCount {
+  char sum[sizeof(int128_t)];
+  int64_t count;
+};
+
+// Base class of sum and avg over decimals. TInput is the type of the unscaled
+// input values: int64_t for SHORT_DECIMAL and int128_t for LONG_DECIMAL.
+// Overflow of the int128_t sums is checked once for each input batch.
+// Subclasses define the intermediate and final results.
+template <typename TInput>
+class DecimalAggregate : public exec::Aggregate {
+ public:
+  explicit DecimalAggregate(TypePtr resultType)
+      : exec::Aggregate(std::move(resultType)) {}
+
+  int32_t accumulatorFixedWidthSize() const override {
+    return sizeof(DecimalSumCount);
+  }
+
+  void initializeNewGroups(
+      char** groups,
+      folly::Range<const vector_size_t*> indices) override {
+    setAllNulls(groups, indices);
+    for (auto i : indices) {
+      auto* accumulator = value<DecimalSumCount>(groups[i]);
+      DecimalUtil::writeUnaligned(accumulator->sum, 0);
+      accumulator->count = 0;
+    }
+  }
+
+  void finalize(char** /*groups*/, int32_t /*numGroups*/) override {}
+
+  void addRawInput(
+      char** groups,
+      const SelectivityVector& rows,
+      const std::vector<VectorPtr>& args,
+      bool /*mayPushdown*/) override {
+    decodedRaw_.decode(*args[0], rows);
+    bool overflow = false;
+    if (decodedRaw_.isIdentityMapping() && !decodedRaw_.mayHaveNulls()) {
+      auto* values = decodedRaw_.data<TInput>();
+      rows.applyToSelected([&](vector_size_t row) {
+        update(groups[row], values[row], 1, overflow);
+      });
+    } else {
+      rows.applyToSelected([&](vector_size_t row) {
+        if (!decodedRaw_.isNullAt(row)) {
+          update(groups[row], decodedRaw_.valueAt<TInput>(row), 1, overflow);
+        }
+      });
+    }
+    checkOverflow(overflow);
+  }
+
+  void addSingleGroupRawInput(
+      char* group,
+      const SelectivityVector& rows,
+      const std::vector<VectorPtr>& args,
+      bool /*mayPushdown*/) override {
+    decodedRaw_.decode(*args[0], rows);
+    int128_t sum = 0;
+    int64_t count = 0;
+    bool overflow = false;
+    if (decodedRaw_.isIdentityMapping() && !decodedRaw_.mayHaveNulls()) {
+      auto* values = decodedRaw_.data<TInput>();
+      if constexpr (std::is_same_v<TInput, int64_t>) {
+        // Adds short decimals in 64 bits. Only if the 64 bit sum of the
+        // batch overflows are the values added again in 128 bits.
+        int64_t shortSum = 0;
+        bool shortOverflow = false;
+        rows.applyToSelected([&](vector_size_t row) {
+          shortOverflow |=
+              __builtin_add_overflow(shortSum, values[row], &shortSum);
+        });
+        if (!shortOverflow) {
+          sum = shortSum;
+        } else {
+          rows.applyToSelected([&](vector_size_t row) { sum += values[row]; });
+        }
+      } else {
+        rows.applyToSelected([&](vector_size_t row) {
+          overflow |= __builtin_add_overflow(sum, values[row], &sum);
+        });
+      }
+      count = rows.countSelected();
+    } else {
+      rows.applyToSelected([&](vector_size_t row) {
+        if (!decodedRaw_.isNullAt(row)) {
+          overflow |= __builtin_add_overflow(
+              sum, decodedRaw_.valueAt<TInput>(row), &sum);
+          ++count;
+        }
+      });
+    }
+    if (count > 0) {
+      update(group, sum, count, overflow);
+    }
+    checkOverflow(overflow);
+  }
+
+ protected:
+  // Adds 'sum' and 'count' to the accumulator of 'group'. Sets 'overflow' if
+  // the sum no longer fits in an int128_t.
+  template <typename T>
+  void update(char* group, T sum, int64_t count, bool& overflow) {
+    clearNull(group);
+    auto* accumulator = value<DecimalSumCount>(group);
+    int128_t newSum;
+    overflow |= __builtin_add_overflow(
+        DecimalUtil::readUnaligned(accumulator->sum),
+        static_cast<int128_t>(sum),
+        &newSum);
+    DecimalUtil::writeUnaligned(accumulator->sum, newSum);
+    accumulator->count += count;
+  }
+
+  // Adds the sums in 'sums' and, if given, the counts in 'counts' to the
+  // groups. Counts default to 1 per row.
+  void addIntermediate(
+      char** groups,
+      const SelectivityVector& rows,
+      const DecodedVector& decoded,
+      const SimpleVector<LongDecimal>& sums,
+      const SimpleVector<int64_t>* counts) {
+    bool overflow = false;
+    rows.applyToSelected([&](vector_size_t row) {
+      if (decoded.isNullAt(row)) {
+        return;
+      }
+      auto index = decoded.index(row);
+      update(
+          groups[row],
+          sums.valueAt(index).unscaledValue(),
+          counts ? counts->valueAt(index) : 1,
+          overflow);
+    });
+    checkOverflow(overflow);
+  }
+
+  // Returns the sum of 'group'. Throws if it has more than 38 digits.
+  int128_t sumOf(char* group) const {
+    auto sum = DecimalUtil::readUnaligned(value<DecimalSumCount>(group)->sum);
+    VELOX_USER_CHECK(DecimalUtil::valueInRange(sum), "Decimal overflow in sum");
+    return sum;
+  }
+
+  int64_t countOf(char* group) const {
+    return value<DecimalSumCount>(group)->count;
+  }
+
+  // Writes the sums of 'groups' to the flat LONG_DECIMAL 'vector'.
+  void extractSums(char** groups, int32_t numGroups, BaseVector* vector) {
+    auto* flatVector = vector->asFlatVector<LongDecimal>();
+    VELOX_CHECK(flatVector);
+    flatVector->resize(numGroups);
+    uint64_t* rawNulls = getRawNulls(flatVector);
+    auto* rawValues = flatVector->mutableRawValues();
+    for (auto i = 0; i < numGroups; ++i) {
+      if (isNull(groups[i])) {
+        flatVector->setNull(i, true);
+      } else {
+        clearNull(rawNulls, i);
+        rawValues[i] = LongDecimal(sumOf(groups[i]));
+      }
+    }
+  }
+
+  static void checkOverflow(bool overflow) {
+    VELOX_USER_CHECK(!overflow, "Decimal overflow in sum");
+  }
+
+  DecodedVector decodedRaw_;
+  DecodedVector decodedIntermediate_;
+};
+
+// sum(decimal(p, s)) returns decimal(38, s). The intermediate result is the
+// same as the final result.
+template <typename TInput>
+class DecimalSumAggregate : public DecimalAggregate<TInput> {
+  using Base = DecimalAggregate<TInput>;
+
+ public:
+  explicit DecimalSumAggregate(TypePtr resultType)
+      : Base(std::move(resultType)) {}
+
+  void extractValues(char** groups, int32_t numGroups, VectorPtr* result)
+      override {
+    Base::extractSums(groups, numGroups, result->get());
+  }
+
+  void extractAccumulators(char** groups, int32_t numGroups, VectorPtr* result)
+      override {
+    Base::extractSums(groups, numGroups, result->get());
+  }
+
+  void addIntermediateResults(
+      char** groups,
+      const SelectivityVector& rows,
+      const std::vector<VectorPtr>& args,
+      bool /*mayPushdown*/) override {
+    auto& decoded = Base::decodedIntermediate_;
+    decoded.decode(*args[0], rows);
+    Base::addIntermediate(
+        groups,
+        rows,
+        decoded,
+        *decoded.base()->template as<SimpleVector<LongDecimal>>(),
+        nullptr);
+  }
+
+  void addSingleGroupIntermediateResults(
+      char* group,
+      const SelectivityVector& rows,
+      const std::vector<VectorPtr>& args,
+      bool mayPushdown) override {
+    std::vector<char*> groups(rows.end(), group);
+    addIntermediateResults(groups.data(), rows, args, mayPushdown);
+  }
+};
+
+// avg(decimal(p, s)) returns decimal(p, s), rounding half away from zero.
+// The intermediate result is row(decimal(38, s), bigint) with the sum and
+// count.
+template <typename TInput>
+class DecimalAverageAggregate : public DecimalAggregate<TInput> {
+  using Base = DecimalAggregate<TInput>;
+
+ public:
+  explicit DecimalAverageAggregate(TypePtr resultType)
+      : Base(std::move(resultType)) {}
+
+  void extractValues(char** groups, int32_t numGroups, VectorPtr* result)
+      override {
+    if ((*result)->typeKind() == TypeKind::SHORT_DECIMAL) {
+      extractAverages<ShortDecimal>(groups, numGroups, result->get());
+    } else {
+      extractAverages<LongDecimal>(groups, numGroups, result->get());
+    }
+  }
+
+  void extractAccumulators(char** groups, int32_t numGroups, VectorPtr* result)
+      override {
+    auto rowVector = (*result)->as<RowVector>();
+    VELOX_CHECK(rowVector);
+    rowVector->resize(numGroups);
+    Base::extractSums(groups, numGroups, rowVector->childAt(0).get());
+
+    auto countVector = rowVector->childAt(1)->asFlatVector<int64_t>();
+    countVector->resize(numGroups);
+    auto* rawCounts = countVector->mutableRawValues();
+    uint64_t* rawNulls = Base::getRawNulls(rowVector);
+    for (auto i = 0; i < numGroups; ++i) {
+      if (Base::isNull(groups[i])) {
+        rowVector->setNull(i, true);
+      } else {
+        Base::clearNull(rawNulls, i);
+        rawCounts[i] = Base::countOf(groups[i]);
+      }
+    }
+  }
+
+  void addIntermediateResults(
+      char** groups,
+      const SelectivityVector& rows,
+      const std::vector<VectorPtr>& args,
+      bool /*mayPushdown*/) override {
+    auto& decoded = Base::decodedIntermediate_;
+    decoded.decode(*args[0], rows);
+    auto* rowVector = decoded.base()->template as<RowVector>();
+    Base::addIntermediate(
+        groups,
+        rows,
+        decoded,
+        *rowVector->childAt(0)->template as<SimpleVector<LongDecimal>>(),
+        rowVector->childAt(1)->template as<SimpleVector<int64_t>>());
+  }
+
+  void addSingleGroupIntermediateResults(
+      char* group,
+      const SelectivityVector& rows,
+      const std::vector<VectorPtr>& args,
+      bool mayPushdown) override {
+    std::vector<char*> groups(rows.end(), group);
+    addIntermediateResults(groups.data(), rows, args, mayPushdown);
+  }
+
+ private:
+  template <typename TResult>
+  void extractAverages(char** groups, int32_t numGroups, BaseVector* vector) {
+    auto* flatVector = vector->asFlatVector<TResult>();
+    VELOX_CHECK(flatVector);
+    flatVector->resize(numGroups);
+    uint64_t* rawNulls = Base::getRawNulls(flatVector);
+    auto* rawValues = flatVector->mutableRawValues();
+    for (auto i = 0; i < numGroups; ++i) {
+      if (Base::isNull(groups[i])) {
+        flatVector->setNull(i, true);
+      } else {
+        Base::clearNull(rawNulls, i);
+        // The average of values of precision p has at most p digits.
+        rawValues[i] = TResult(DecimalUtil::divideRoundHalfUp(
+            Base::sumOf(groups[i]), Base::countOf(groups[i])));
+      }
+    }
+  }
+};
+
+} // namespace facebook::velox::aggregate
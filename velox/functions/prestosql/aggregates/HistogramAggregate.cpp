@@ -13,25 +13,19 @@
  * See the License for the specific language governing permissions and
  * limitations under the License.
  */
-#include "folly/container/F14Map.h"
-
 #include "velox/common/base/Exceptions.h"
 #include "velox/common/memory/HashStringAllocator.h"
 #include "velox/exec/Aggregate.h"
 #include "velox/expression/FunctionSignature.h"
 #include "velox/functions/prestosql/aggregates/AggregateNames.h"
+#include "velox/functions/prestosql/aggregates/ArenaHashMap.h"
 #include "velox/vector/FlatVector.h"
 
 namespace facebook::velox::aggregate {
 namespace {
 
 template <typename T>
-using ValueMap = folly::F14FastMap<
-    T,
-    int64_t,
-    std::hash<T>,
-    std::equal_to<T>,
-    AlignedStlAllocator<std::pair<const T, int64_t>, 16>>;
+using ValueMap = ArenaHashMap<T, int64_t>;
 
 // Combines a partial aggregation represented by the key-value pair at row in
 // mapKeys and mapValues into groupMap.
@@ -43,11 +37,13 @@ FOLLY_ALWAYS_INLINE void addToFinalAggregation(
     const vector_size_t* rawSizes,
     const vector_size_t* rawOffsets,
     vector_size_t row,
-    ValueMap<T>* groupMap) {
+    ValueMap<T>* groupMap,
+    HashStringAllocator* allocator) {
   auto size = rawSizes[indices[row]];
   auto offset = rawOffsets[indices[row]];
   for (int i = 0; i < size; ++i) {
-    (*groupMap)[mapKeys->valueAt(offset + i)] += mapValues->valueAt(offset + i);
+    groupMap->findOrInsert(mapKeys->valueAt(offset + i), allocator) +=
+        mapValues->valueAt(offset + i);
   }
 }
 
@@ -65,8 +61,7 @@ class HistogramAggregate : public exec::Aggregate {
       char** groups,
       folly::Range<const vector_size_t*> indices) override {
     for (auto index : indices) {
-      new (groups[index] + offset_) ValueMap<T>{
-          AlignedStlAllocator<std::pair<const T, int64_t>, 16>(allocator_)};
+      new (groups[index] + offset_) ValueMap<T>();
     }
   }
 
@@ -97,12 +92,11 @@ class HistogramAggregate : public exec::Aggregate {
       if (mapSize == 0) {
         bits::setNull(rawNulls, i, true);
       } else {
-        for (auto it = groupMap->begin(); it != groupMap->end(); ++it) {
-          mapKeys->set(index, it->first);
-          mapValues->set(index, it->second);
-
+        groupMap->forEach([&](const T& key, int64_t count) {
+          mapKeys->set(index, key);
+          mapValues->set(index, count);
           ++index;
-        }
+        });
       }
       mapVector->setOffsetAndSize(i, index - mapSize, mapSize);
     }
@@ -126,7 +120,7 @@ class HistogramAggregate : public exec::Aggregate {
         auto group = groups[row];
         auto groupMap = value<ValueMap<T>>(group);
 
-        (*groupMap)[decodedKeys_.valueAt<T>(row)]++;
+        ++groupMap->findOrInsert(decodedKeys_.valueAt<T>(row), allocator_);
       }
     });
   }
@@ -141,7 +135,7 @@ class HistogramAggregate : public exec::Aggregate {
     rows.applyToSelected([&](auto row) {
       // Nulls among the values being aggregated are ignored.
       if (!decodedKeys_.isNullAt(row)) {
-        (*groupMap)[decodedKeys_.valueAt<T>(row)]++;
+        ++groupMap->findOrInsert(decodedKeys_.valueAt<T>(row), allocator_);
       }
     });
   }
@@ -169,7 +163,14 @@ class HistogramAggregate : public exec::Aggregate {
         auto groupMap = value<ValueMap<T>>(group);
 
         addToFinalAggregation<T>(
-            mapKeys, mapValues, indices, rawSizes, rawOffsets, row, groupMap);
+            mapKeys,
+            mapValues,
+            indices,
+            rawSizes,
+            rawOffsets,
+            row,
+            groupMap,
+            allocator_);
       }
     });
   }
@@ -196,15 +197,21 @@ class HistogramAggregate : public exec::Aggregate {
     rows.applyToSelected([&](vector_size_t row) {
       if (!decodedIntermediate_.isNullAt(row)) {
         addToFinalAggregation<T>(
-            mapKeys, mapValues, indices, rawSizes, rawOffsets, row, groupMap);
+            mapKeys,
+            mapValues,
+            indices,
+            rawSizes,
+            rawOffsets,
+            row,
+            groupMap,
+            allocator_);
       }
     });
   }
 
   void destroy(folly::Range<char**> groups) override {
     for (auto group : groups) {
-      auto groupMap = value<ValueMap<T>>(group);
-      std::destroy_at(groupMap);
+      value<ValueMap<T>>(group)->free(allocator_);
     }
   }
 
@@ -57,6 +57,24 @@ class MinMaxAggregate : public SimpleNumericAggregate<T, T, ResultType> {
       return *BaseAggregate::Aggregate::template value<T>(group);
     });
   }
+
+ protected:
+  // Returns the 'updateRange' for updateOneGroup(). Integers are compared a
+  // SIMD batch at a time. Other types are compared row by row, so that the
+  // result for NaNs does not depend on the order of comparisons.
+  template <bool isMin>
+  static auto updateRange() {
+    if constexpr (std::is_integral_v<T>) {
+      return [](T& result,
+                const T* values,
+                vector_size_t begin,
+                vector_size_t end) {
+        result = detail::minMaxOfValues<isMin>(values, begin, end, result);
+      };
+    } else {
+      return nullptr;
+    }
+  }
 };
 
 template <>
@@ -115,11 +133,7 @@ class MaxAggregate : public MinMaxAggregate<T, ResultType> {
         groups,
         rows,
         args[0],
-        [](T& result, T value) {
-          if (result < value) {
-            result = value;
-          }
-        },
+        [](T& result, T value) { result = result < value ? value : result; },
         mayPushdown);
   }
 
@@ -143,7 +157,8 @@ class MaxAggregate : public MinMaxAggregate<T, ResultType> {
         [](T& result, T value) { result = result > value ? result : value; },
         [](T& result, T value, int /* unused */) { result = value; },
         mayPushdown,
-        kInitialValue_);
+        kInitialValue_,
+        MinMaxAggregate<T, ResultType>::template updateRange<false>());
   }
 
   void addSingleGroupIntermediateResults(
@@ -190,11 +205,7 @@ class MinAggregate : public MinMaxAggregate<T, ResultType> {
         groups,
         rows,
         args[0],
-        [](T& result, T value) {
-          if (result > value) {
-            result = value;
-          }
-        },
+        [](T& result, T value) { result = result > value ? value : result; },
         mayPushdown);
   }
 
@@ -218,7 +229,8 @@ class MinAggregate : public MinMaxAggregate<T, ResultType> {
         [](T& result, T value) { result = result < value ? result : value; },
         [](T& result, T value, int /* unused */) { result = value; },
         mayPushdown,
-        kInitialValue_);
+        kInitialValue_,
+        MinMaxAggregate<T, ResultType>::template updateRange<true>());
   }
 
   void addSingleGroupIntermediateResults(
@@ -233,6 +245,42 @@ class MinAggregate : public MinMaxAggregate<T, ResultType> {
   static constexpr T kInitialValue_{MinMaxTrait<T>::max()};
 };
 
+// Updates the SingleValueAccumulators of groups with the smallest or largest
+// of the strings a column reader produces. The reader passes each string as a
+// folly::StringPiece into its buffers. The string is compared with the stored
+// value in place and copied only if it replaces it.
+template <bool isMin>
+class StringMinMaxHook final : public AggregationHook {
+ public:
+  StringMinMaxHook(
+      int32_t offset,
+      int32_t nullByte,
+      uint8_t nullMask,
+      char** groups,
+      uint64_t* numNulls,
+      HashStringAllocator* allocator)
+      : AggregationHook(offset, nullByte, nullMask, groups, numNulls),
+        allocator_(allocator) {}
+
+  void addValue(vector_size_t row, const void* value) override {
+    auto group = findGroup(row);
+    auto accumulator =
+        reinterpret_cast<SingleValueAccumulator*>(group + offset_);
+    const auto& string = *reinterpret_cast<const folly::StringPiece*>(value);
+    clearNull(group);
+    if (accumulator->hasValue()) {
+      auto result = accumulator->compare(string);
+      if (isMin ? result <= 0 : result >= 0) {
+        return;
+      }
+    }
+    accumulator->write(string, allocator_);
+  }
+
+ private:
+  HashStringAllocator* const allocator_;
+};
+
 class NonNumericMinMaxAggregateBase : public exec::Aggregate {
  public:
   explicit NonNumericMinMaxAggregateBase(const TypePtr& resultType)
@@ -293,13 +341,34 @@ class NonNumericMinMaxAggregateBase : public exec::Aggregate {
   }
 
  protected:
+  // Decodes the raw or intermediate input. Kept to reuse memory between
+  // batches.
+  DecodedVector decoded_;
+
+  // Pushes the aggregation of strings into the reader of a LazyVector 'arg'.
+  // Returns false if 'arg' does not qualify.
+  template <bool isMin>
+  bool pushdownStrings(
+      char** groups,
+      const SelectivityVector& rows,
+      const VectorPtr& arg,
+      bool mayPushdown) {
+    if (!mayPushdown || !arg->isLazy() ||
+        arg->typeKind() != TypeKind::VARCHAR) {
+      return false;
+    }
+    pushdown<StringMinMaxHook<isMin>>(groups, rows, arg, allocator_);
+    return true;
+  }
+
   template <typename TCompareTest>
   void doUpdate(
       char** groups,
       const SelectivityVector& rows,
       const VectorPtr& arg,
       TCompareTest compareTest) {
-    DecodedVector decoded(*arg, rows, true);
+    decoded_.decode(*arg, rows, true);
+    auto& decoded = decoded_;
     auto indices = decoded.indices();
     auto baseVector = decoded.base();
 
@@ -326,7 +395,8 @@ class NonNumericMinMaxAggregateBase : public exec::Aggregate {
       const SelectivityVector& rows,
       const VectorPtr& arg,
       TCompareTest compareTest) {
-    DecodedVector decoded(*arg, rows, true);
+    decoded_.decode(*arg, rows, true);
+    auto& decoded = decoded_;
     auto indices = decoded.indices();
     auto baseVector = decoded.base();
 
@@ -366,7 +436,10 @@ class NonNumericMaxAggregate : public NonNumericMinMaxAggregateBase {
       char** groups,
       const SelectivityVector& rows,
       const std::vector<VectorPtr>& args,
-      bool /*mayPushdown*/) override {
+      bool mayPushdown) override {
+    if (pushdownStrings<false>(groups, rows, args[0], mayPushdown)) {
+      return;
+    }
     doUpdate(groups, rows, args[0], [](int32_t compareResult) {
       return compareResult < 0;
     });
@@ -408,7 +481,10 @@ class NonNumericMinAggregate : public NonNumericMinMaxAggregateBase {
       char** groups,
       const SelectivityVector& rows,
       const std::vector<VectorPtr>& args,
-      bool /*mayPushdown*/) override {
+      bool mayPushdown) override {
+    if (pushdownStrings<true>(groups, rows, args[0], mayPushdown)) {
+      return;
+    }
     doUpdate(groups, rows, args[0], [](int32_t compareResult) {
       return compareResult > 0;
     });
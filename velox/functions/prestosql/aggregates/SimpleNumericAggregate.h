@@ -15,6 +15,8 @@
  */
 #pragma once
 
+#include <xsimd/xsimd.hpp>
+
 #include "velox/exec/Aggregate.h"
 #include "velox/exec/AggregationHook.h"
 #include "velox/vector/DecodedVector.h"
@@ -23,6 +25,78 @@
 
 namespace facebook::velox::aggregate {
 
+namespace detail {
+
+// Returns 'sum' plus the sum of 'values' in [begin, end). Integers of the
+// width of the sum are added a SIMD batch at a time. Integer addition wraps
+// the same way in any order, so the result matches adding one value at a time.
+// Other values are added in row order.
+template <typename TData, typename TInput>
+TData sumOfValues(
+    const TInput* values,
+    vector_size_t begin,
+    vector_size_t end,
+    TData sum) {
+  if constexpr (std::is_same_v<TData, TInput> && std::is_integral_v<TData>) {
+    using Batch = xsimd::batch<TData>;
+    constexpr vector_size_t kBatchSize = Batch::size;
+    auto sums = xsimd::broadcast<TData>(0);
+    for (; begin + kBatchSize <= end; begin += kBatchSize) {
+      sums += Batch::load_unaligned(values + begin);
+    }
+    alignas(Batch::arch_type::alignment()) TData lanes[Batch::size];
+    sums.store_aligned(lanes);
+    for (auto lane : lanes) {
+      sum += lane;
+    }
+  }
+  for (; begin < end; ++begin) {
+    sum += values[begin];
+  }
+  return sum;
+}
+
+// Returns the smallest (isMin) or largest of 'result' and 'values' in [begin,
+// end). Integers are compared a SIMD batch at a time, other values in row
+// order.
+template <bool isMin, typename T>
+T minMaxOfValues(
+    const T* values,
+    vector_size_t begin,
+    vector_size_t end,
+    T result) {
+  if constexpr (std::is_integral_v<T> && !std::is_same_v<T, bool>) {
+    using Batch = xsimd::batch<T>;
+    constexpr vector_size_t kBatchSize = Batch::size;
+    if (begin + kBatchSize <= end) {
+      auto extremes = xsimd::broadcast<T>(result);
+      for (; begin + kBatchSize <= end; begin += kBatchSize) {
+        auto batch = Batch::load_unaligned(values + begin);
+        if constexpr (isMin) {
+          extremes = xsimd::min(extremes, batch);
+        } else {
+          extremes = xsimd::max(extremes, batch);
+        }
+      }
+      alignas(Batch::arch_type::alignment()) T lanes[Batch::size];
+      extremes.store_aligned(lanes);
+      for (auto lane : lanes) {
+        result = isMin ? std::min(result, lane) : std::max(result, lane);
+      }
+    }
+  }
+  for (; begin < end; ++begin) {
+    if constexpr (isMin) {
+      result = result < values[begin] ? result : values[begin];
+    } else {
+      result = result > values[begin] ? result : values[begin];
+    }
+  }
+  return result;
+}
+
+} // namespace detail
+
 template <typename TInput, typename TAccumulator, typename TResult>
 class SimpleNumericAggregate : public exec::Aggregate {
  protected:
@@ -31,6 +105,10 @@ class SimpleNumericAggregate : public exec::Aggregate {
  public:
   void finalize(char** /* unused */, int32_t /* unused */) override {}
 
+  bool accumulatorUsesAllocator() const override {
+    return false;
+  }
+
   void extractAccumulators(char** groups, int32_t numGroups, VectorPtr* result)
       override {
     extractValues(groups, numGroups, result);
@@ -78,7 +156,8 @@ class SimpleNumericAggregate : public exec::Aggregate {
       const VectorPtr& arg,
       UpdateSingleValue updateSingleValue,
       bool mayPushdown) {
-    DecodedVector decoded(*arg, rows, !mayPushdown);
+    decodedRaw_.decode(*arg, rows, !mayPushdown);
+    auto& decoded = decodedRaw_;
     auto encoding = decoded.base()->encoding();
     if (encoding == VectorEncoding::Simple::LAZY) {
       SimpleCallableHook<TInput, TData, UpdateSingleValue> hook(
@@ -113,6 +192,11 @@ class SimpleNumericAggregate : public exec::Aggregate {
       });
     } else if (decoded.isIdentityMapping() && !std::is_same_v<TInput, bool>) {
       auto data = decoded.data<TInput>();
+      if (rows.isAllSelected()) {
+        updateGroupsInRange<tableHasNulls, TData>(
+            groups, data, rows.begin(), rows.end(), updateSingleValue);
+        return;
+      }
       rows.applyToSelected([&](vector_size_t i) {
         updateNonNullValue<tableHasNulls, TData>(
             groups[i], data[i], updateSingleValue);
@@ -127,10 +211,16 @@ class SimpleNumericAggregate : public exec::Aggregate {
 
   // TData is either TAccumulator or TResult, which in most cases are the same,
   // but for sum(real) can differ.
+  //
+  // If given, 'updateRange' is called as updateRange(TData& result, const
+  // TInput* values, begin, end) to fold all values of a flat 'arg' without
+  // nulls into 'initialValue' when all 'rows' are selected, e.g. with a SIMD
+  // reduction. The result is then applied to 'group' with 'updateSingleValue'.
   template <
       typename TData = TResult,
       typename UpdateSingle,
-      typename UpdateDuplicate>
+      typename UpdateDuplicate,
+      typename UpdateRange = std::nullptr_t>
   void updateOneGroup(
       char* group,
       const SelectivityVector& rows,
@@ -138,8 +228,19 @@ class SimpleNumericAggregate : public exec::Aggregate {
       UpdateSingle updateSingleValue,
       UpdateDuplicate updateDuplicateValues,
       bool /*mayPushdown*/,
-      TData initialValue) {
-    DecodedVector decoded(*arg, rows);
+      TData initialValue,
+      UpdateRange updateRange = nullptr) {
+    if (updateOneGroupFromRuns<TData>(
+            group,
+            rows,
+            *arg,
+            updateSingleValue,
+            updateDuplicateValues,
+            initialValue)) {
+      return;
+    }
+    decodedRaw_.decode(*arg, rows);
+    auto& decoded = decodedRaw_;
 
     // Do row by row if not all rows are selected.
     if (decoded.isConstantMapping()) {
@@ -158,6 +259,14 @@ class SimpleNumericAggregate : public exec::Aggregate {
       });
     } else if (decoded.isIdentityMapping() && !std::is_same_v<TInput, bool>) {
       auto data = decoded.data<TInput>();
+      if constexpr (!std::is_same_v<UpdateRange, std::nullptr_t>) {
+        if (rows.isAllSelected() && rows.end() > rows.begin()) {
+          updateRange(initialValue, data, rows.begin(), rows.end());
+          updateNonNullValue<true, TData>(
+              group, initialValue, updateSingleValue);
+          return;
+        }
+      }
       rows.applyToSelected([&](vector_size_t i) {
         updateNonNullValue<true, TData>(group, data[i], updateSingleValue);
       });
@@ -169,40 +278,79 @@ class SimpleNumericAggregate : public exec::Aggregate {
     }
   }
 
-  template <typename THook>
-  void
-  pushdown(char** groups, const SelectivityVector& rows, const VectorPtr& arg) {
-    DecodedVector decoded(*arg, rows, false);
-    const vector_size_t* indices = decoded.indices();
-    THook hook(
-        exec::Aggregate::offset_,
-        exec::Aggregate::nullByte_,
-        exec::Aggregate::nullMask_,
-        groups,
-        &this->exec::Aggregate::numNulls_);
-    // The decoded vector does not really keep the info from the 'rows', except
-    // for the 'upper bound' of it. In case not all rows are selected we need to
-    // generate proper indices, which we 'indirect' through the ones we got from
-    // the decoded vector.
-    vector_size_t numIndices{arg->size()};
-    if (not rows.isAllSelected()) {
-      const auto numSelected = rows.countSelected();
-      if (numSelected != arg->size()) {
-        pushdownCustomIndices_.resize(numSelected);
-        vector_size_t tgtIndex{0};
-        rows.template applyToSelected([&](vector_size_t i) {
-          pushdownCustomIndices_[tgtIndex++] = indices[i];
-        });
-        indices = pushdownCustomIndices_.data();
-        numIndices = numSelected;
+  // Updates 'group' once per run if 'arg' is a run-length encoded vector of
+  // flat values and all of its rows are selected. Each run is folded into a
+  // copy of 'initialValue' with 'updateDuplicateValues' and the result is
+  // applied with 'updateSingleValue'. Returns false if 'arg' does not qualify.
+  template <typename TData, typename UpdateSingle, typename UpdateDuplicate>
+  bool updateOneGroupFromRuns(
+      char* group,
+      const SelectivityVector& rows,
+      const BaseVector& arg,
+      UpdateSingle updateSingleValue,
+      UpdateDuplicate updateDuplicateValues,
+      TData initialValue) {
+    if (arg.encoding() != VectorEncoding::Simple::SEQUENCE ||
+        !rows.isAllSelected() || rows.end() != arg.size()) {
+      return false;
+    }
+    auto runValues = arg.valueVector();
+    if (!runValues->isFlatEncoding()) {
+      return false;
+    }
+    auto* values = runValues->template asUnchecked<SimpleVector<TInput>>();
+    auto* lengths = arg.wrapInfo()->template as<vector_size_t>();
+    for (vector_size_t run = 0; run < values->size(); ++run) {
+      if (lengths[run] == 0 || values->isNullAt(run)) {
+        continue;
       }
+      TData runValue = initialValue;
+      updateDuplicateValues(runValue, values->valueAt(run), lengths[run]);
+      updateNonNullValue<true, TData>(group, runValue, updateSingleValue);
     }
-
-    decoded.base()->as<const LazyVector>()->load(
-        RowSet(indices, numIndices), &hook);
+    return true;
   }
 
+ protected:
+  // Decodes the raw input. Kept to reuse memory between batches.
+  DecodedVector decodedRaw_;
+
  private:
+  // Number of rows ahead of the current row whose groups are prefetched.
+  static constexpr vector_size_t kPrefetchDistance = 16;
+
+  // Updates groups[i] with values[i] for all rows in [begin, end). The groups
+  // of the next block of rows are prefetched while updating the current block
+  // and the null flags are cleared without branching, so that the loop is
+  // bound by memory bandwidth rather than by cache misses on random groups.
+  template <bool tableHasNulls, typename TData, typename Update>
+  void updateGroupsInRange(
+      char** groups,
+      const TInput* values,
+      vector_size_t begin,
+      vector_size_t end,
+      Update updateValue) {
+    const auto offset = exec::Aggregate::offset_;
+    const auto nullByte = exec::Aggregate::nullByte_;
+    const uint8_t nullMask = exec::Aggregate::nullMask_;
+    for (auto i = begin; i < end; i += kPrefetchDistance) {
+      const auto blockEnd = std::min(i + kPrefetchDistance, end);
+      const auto prefetchEnd = std::min(blockEnd + kPrefetchDistance, end);
+      for (auto j = blockEnd; j < prefetchEnd; ++j) {
+        __builtin_prefetch(groups[j] + offset);
+      }
+      for (auto j = i; j < blockEnd; ++j) {
+        char* group = groups[j];
+        if constexpr (tableHasNulls) {
+          const uint8_t flags = group[nullByte];
+          exec::Aggregate::numNulls_ -= (flags & nullMask) != 0;
+          group[nullByte] = flags & ~nullMask;
+        }
+        updateValue(*exec::Aggregate::value<TData>(group), values[j]);
+      }
+    }
+  }
+
   // TData is either TAccumulator or TResult, which in most cases are the same,
   // but for sum(real) can differ.
   template <
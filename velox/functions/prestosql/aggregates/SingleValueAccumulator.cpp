@@ -34,6 +34,20 @@ void SingleValueAccumulator::write(
   allocator->finishWrite(stream, stream.size());
 }
 
+void SingleValueAccumulator::write(
+    folly::StringPiece value,
+    HashStringAllocator* allocator) {
+  if (!begin_) {
+    begin_ = allocator->allocate(kInitialBytes);
+  }
+
+  ByteStream stream(allocator);
+  allocator->extendWrite({begin_, begin_->begin()}, stream);
+  stream.appendOne<int32_t>(value.size());
+  stream.appendStringPiece(value);
+  allocator->finishWrite(stream, stream.size());
+}
+
 void SingleValueAccumulator::read(const VectorPtr& vector, vector_size_t index)
     const {
   VELOX_CHECK(begin_);
@@ -61,6 +75,27 @@ int32_t SingleValueAccumulator::compare(
       inStream, decoded, index, {true, true, false});
 }
 
+int32_t SingleValueAccumulator::compare(folly::StringPiece value) const {
+  VELOX_CHECK(begin_);
+
+  ByteStream inStream;
+  HashStringAllocator::prepareRead(begin_, inStream);
+  int32_t storedSize = inStream.read<int32_t>();
+  auto compareSize = std::min<int32_t>(storedSize, value.size());
+  int32_t offset = 0;
+  while (compareSize > 0) {
+    auto storedView = inStream.nextView(compareSize);
+    auto result =
+        memcmp(storedView.data(), value.data() + offset, storedView.size());
+    if (result != 0) {
+      return result;
+    }
+    offset += storedView.size();
+    compareSize -= storedView.size();
+  }
+  return storedSize - static_cast<int32_t>(value.size());
+}
+
 void SingleValueAccumulator::destroy(HashStringAllocator* allocator) {
   if (begin_) {
     allocator->free(begin_);
@@ -28,6 +28,9 @@ struct SingleValueAccumulator {
       vector_size_t index,
       HashStringAllocator* allocator);
 
+  // Writes a VARCHAR or VARBINARY 'value' in the layout of write() above.
+  void write(folly::StringPiece value, HashStringAllocator* allocator);
+
   void read(const VectorPtr& vector, vector_size_t index) const;
 
   bool hasValue() const;
@@ -36,6 +39,10 @@ struct SingleValueAccumulator {
   // then new value; >0 if stored value is greated than new value
   int32_t compare(const DecodedVector& decoded, vector_size_t index) const;
 
+  // Same as compare() above for a stored VARCHAR or VARBINARY value and a
+  // string that is not in a vector.
+  int32_t compare(folly::StringPiece value) const;
+
   void destroy(HashStringAllocator* allocator);
 
  private:
@@ -16,6 +16,7 @@
 #pragma once
 
 #include "velox/expression/FunctionSignature.h"
+#include "velox/functions/prestosql/aggregates/DecimalAggregate.h"
 #include "velox/functions/prestosql/aggregates/SimpleNumericAggregate.h"
 
 namespace facebook::velox::aggregate {
@@ -86,7 +87,8 @@ class SumAggregate
         [](TAccumulator& result, TInput value) { result += value; },
         [](TAccumulator& result, TInput value, int n) { result += n * value; },
         mayPushdown,
-        0);
+        0,
+        updateRange<TAccumulator>());
   }
 
   void addSingleGroupIntermediateResults(
@@ -101,10 +103,28 @@ class SumAggregate
         [](ResultType& result, TInput value) { result += value; },
         [](ResultType& result, TInput value, int n) { result += n * value; },
         mayPushdown,
-        0);
+        0,
+        updateRange<ResultType>());
   }
 
  protected:
+  // Returns the 'updateRange' for updateOneGroup(). Integers are added a SIMD
+  // batch at a time. Floating point values are added row by row, since adding
+  // them in a different order may give a different result.
+  template <typename TData>
+  static auto updateRange() {
+    if constexpr (std::is_integral_v<TData>) {
+      return [](TData& result,
+                const TInput* values,
+                vector_size_t begin,
+                vector_size_t end) {
+        result = detail::sumOfValues(values, begin, end, result);
+      };
+    } else {
+      return nullptr;
+    }
+  }
+
   // TData is either TAccumulator or TResult, which in most cases are the same,
   // but for sum(real) can differ.
   template <typename TData>
@@ -161,6 +181,13 @@ bool registerSumAggregate(const std::string& name) {
                              .argumentType(inputType)
                              .build());
   }
+  signatures.push_back(exec::AggregateFunctionSignatureBuilder()
+                           .returnType("DECIMAL(r_precision, r_scale)")
+                           .intermediateType("DECIMAL(r_precision, r_scale)")
+                           .argumentType("DECIMAL(a_precision, a_scale)")
+                           .variableConstraint("r_precision", "38")
+                           .variableConstraint("r_scale", "a_scale")
+                           .build());
 
   return exec::registerAggregateFunction(
       name,
@@ -190,6 +217,10 @@ bool registerSumAggregate(const std::string& name) {
               return std::make_unique<T<double, double, float>>(resultType);
             }
             return std::make_unique<T<double, double, double>>(DOUBLE());
+          case TypeKind::SHORT_DECIMAL:
+            return std::make_unique<DecimalSumAggregate<int64_t>>(resultType);
+          case TypeKind::LONG_DECIMAL:
+            return std::make_unique<DecimalSumAggregate<int128_t>>(resultType);
           default:
             VELOX_CHECK(
                 false,
@@ -43,6 +43,12 @@ class ValueList {
     return size_;
   }
 
+  // Returns the number of bytes written for the values and null flags. This
+  // is an upper bound for the size of the string data of a list of strings.
+  uint64_t totalBytes() const {
+    return totalBytes_;
+  }
+
   // Called after all data has been appended.
   void finalize(HashStringAllocator* allocator) {
     if (size_ % 64 != 0) {
@@ -112,6 +118,42 @@ class ValueListReader {
 
   bool next(BaseVector& output, vector_size_t outputIndex);
 
+  // Reads all values into consecutive positions of 'output' starting at
+  // 'outputIndex'. T must be a fixed width type other than bool, i.e. the
+  // serialized form of the values is the same as in a FlatVector<T>. Copies
+  // the non-null values of each word of null flags with one memcpy when the
+  // word has no nulls. Must be called instead of next().
+  template <typename T>
+  void readAll(FlatVector<T>& output, vector_size_t outputIndex) {
+    static_assert(!std::is_same_v<T, bool>);
+    VELOX_CHECK_EQ(pos_, 0);
+    auto* rawValues = output.mutableRawValues() + outputIndex;
+    const auto size = values_.size();
+    for (vector_size_t i = 0; i < size; i += 64) {
+      const auto numValues = std::min<vector_size_t>(64, size - i);
+      nulls_ = nullsStream_.read<uint64_t>();
+      if (nulls_ == 0) {
+        dataStream_.readBytes(rawValues + i, numValues * sizeof(T));
+        if (output.rawNulls()) {
+          bits::fillBits(
+              output.mutableRawNulls(),
+              outputIndex + i,
+              outputIndex + i + numValues,
+              bits::kNotNull);
+        }
+        continue;
+      }
+      for (auto j = 0; j < numValues; ++j) {
+        const bool isNull = nulls_ & (1UL << j);
+        output.setNull(outputIndex + i + j, isNull);
+        if (!isNull) {
+          dataStream_.readBytes(rawValues + i + j, sizeof(T));
+        }
+      }
+    }
+    pos_ = size;
+  }
+
  private:
   ValueList& values_;
   ByteStream dataStream_;
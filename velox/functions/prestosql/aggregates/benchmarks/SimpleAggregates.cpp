@@ -116,9 +116,15 @@ class SimpleAggregatesBenchmark : public HiveConnectorTestBase {
   void run(const std::string& key, const std::string& aggregate) {
     folly::BenchmarkSuspender suspender;
 
+    // The 'global' key runs an aggregation without grouping keys.
+    std::vector<std::string> keys;
+    if (key != "global") {
+      keys.push_back(key);
+    }
+
     auto plan = PlanBuilder()
                     .tableScan(inputType_)
-                    .partialAggregation({key}, {aggregate})
+                    .partialAggregation(keys, {aggregate})
                     .finalAggregation()
                     .planFragment();
 
@@ -211,18 +217,21 @@ void doRun(uint32_t, const std::string& key, const std::string& aggregate) {
   BENCHMARK_DRAW_LINE();
 
 // Count(1) aggregate.
+BENCHMARK_NAMED_PARAM(doRun, count_global, "global", "count(1)");
 BENCHMARK_NAMED_PARAM(doRun, count_k_array, "k_array", "count(1)");
 BENCHMARK_NAMED_PARAM(doRun, count_k_norm, "k_norm", "count(1)");
 BENCHMARK_NAMED_PARAM(doRun, count_k_hash, "k_hash", "count(1)");
 BENCHMARK_DRAW_LINE();
 
 // Count aggregate.
+AGG_BENCHMARKS(count, global)
 AGG_BENCHMARKS(count, k_array)
 AGG_BENCHMARKS(count, k_norm)
 AGG_BENCHMARKS(count, k_hash)
 BENCHMARK_DRAW_LINE();
 
 // Sum aggregate.
+AGG_BENCHMARKS(sum, global)
 AGG_BENCHMARKS(sum, k_array)
 AGG_BENCHMARKS(sum, k_norm)
 AGG_BENCHMARKS(sum, k_hash)
@@ -235,12 +244,14 @@ AGG_BENCHMARKS(avg, k_hash)
 BENCHMARK_DRAW_LINE();
 
 // Min aggregate.
+AGG_BENCHMARKS(min, global)
 AGG_BENCHMARKS(min, k_array)
 AGG_BENCHMARKS(min, k_norm)
 AGG_BENCHMARKS(min, k_hash)
 BENCHMARK_DRAW_LINE();
 
 // Max aggregate.
+AGG_BENCHMARKS(max, global)
 AGG_BENCHMARKS(max, k_array)
 AGG_BENCHMARKS(max, k_norm)
 AGG_BENCHMARKS(max, k_hash)
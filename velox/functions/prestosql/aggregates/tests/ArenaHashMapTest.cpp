@@ -0,0 +1,88 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "velox/functions/prestosql/aggregates/ArenaHashMap.h"
+#include <gtest/gtest.h>
+#include <unordered_map>
+#include "velox/type/Timestamp.h"
+
+using namespace facebook::velox;
+
+class ArenaHashMapTest : public testing::Test {
+ protected:
+  // Counts 'keys' in an ArenaHashMap and checks the counts against
+  // std::unordered_map after each batch of 'checkEvery' keys.
+  template <typename T>
+  void testCounts(const std::vector<T>& keys, int32_t checkEvery) {
+    aggregate::ArenaHashMap<T, int64_t> map;
+    std::unordered_map<T, int64_t> expected;
+    for (auto i = 0; i < keys.size(); ++i) {
+      ++map.findOrInsert(keys[i], allocator_.get());
+      ++expected[keys[i]];
+      if ((i + 1) % checkEvery == 0 || i + 1 == keys.size()) {
+        ASSERT_EQ(expected.size(), map.size());
+        int32_t numEntries = 0;
+        map.forEach([&](const T& key, int64_t count) {
+          ASSERT_EQ(expected[key], count);
+          ++numEntries;
+        });
+        ASSERT_EQ(expected.size(), numEntries);
+      }
+    }
+    map.free(allocator_.get());
+    EXPECT_EQ(0, map.size());
+    allocator_->checkConsistency();
+  }
+
+  std::unique_ptr<HashStringAllocator> allocator_{
+      std::make_unique<HashStringAllocator>(
+          memory::MappedMemory::getInstance())};
+};
+
+TEST_F(ArenaHashMapTest, smallMaps) {
+  // Stays within the inline entries.
+  testCounts<int64_t>({5, 5, -1, 5, -1}, 1);
+  testCounts<int8_t>({1, 2, 3, 1, 2, 3}, 1);
+}
+
+TEST_F(ArenaHashMapTest, integers) {
+  for (auto numDistinct : {3, 17, 1'000, 100'000}) {
+    std::vector<int64_t> keys;
+    for (auto i = 0; i < 200'000; ++i) {
+      keys.push_back((i * 7'919L) % numDistinct - numDistinct / 2);
+    }
+    testCounts(keys, 9'973);
+  }
+}
+
+TEST_F(ArenaHashMapTest, timestamps) {
+  std::vector<Timestamp> keys;
+  for (auto i = 0; i < 10'000; ++i) {
+    keys.emplace_back(i % 101, i % 7);
+  }
+  testCounts(keys, 997);
+}
+
+TEST_F(ArenaHashMapTest, reuseAfterFree) {
+  aggregate::ArenaHashMap<int32_t, int64_t> map;
+  for (auto round = 0; round < 3; ++round) {
+    for (auto i = 0; i < 1'000; ++i) {
+      map.findOrInsert(i, allocator_.get()) += i;
+    }
+    EXPECT_EQ(1'000, map.size());
+    map.free(allocator_.get());
+  }
+  allocator_->checkConsistency();
+}
@@ -320,4 +320,50 @@ TEST_F(MinMaxTest, initialValue) {
   assertQuery(agg, "SELECT -1");
 }
 
+TEST_F(MinMaxTest, flatNoNulls) {
+  // Flat inputs without nulls take the SIMD path for the global aggregation
+  // and the prefetching path for the grouped one. Use sizes that are not a
+  // multiple of the SIMD width.
+  std::vector<RowVectorPtr> vectors;
+  for (auto i = 0; i < 3; ++i) {
+    vectors.push_back(makeRowVector({
+        makeFlatVector<int32_t>(1'001, [](auto row) { return row % 7; }),
+        makeFlatVector<int8_t>(1'001, [i](auto row) { return row * 3 + i; }),
+        makeFlatVector<int16_t>(
+            1'001, [i](auto row) { return row * 7919 - i; }),
+        makeFlatVector<int32_t>(
+            1'001, [i](auto row) { return row * 104'729 + i; }),
+        makeFlatVector<int64_t>(
+            1'001, [i](auto row) { return (row - 500) * 1'000'003 * i; }),
+    }));
+  }
+  createDuckDbTable(vectors);
+
+  auto agg = PlanBuilder()
+                 .values(vectors)
+                 .partialAggregation(
+                     {},
+                     {"min(c1)",
+                      "max(c1)",
+                      "min(c2)",
+                      "max(c2)",
+                      "min(c3)",
+                      "max(c3)",
+                      "min(c4)",
+                      "max(c4)"})
+                 .finalAggregation()
+                 .planNode();
+  assertQuery(
+      agg,
+      "SELECT min(c1), max(c1), min(c2), max(c2), min(c3), max(c3), "
+      "min(c4), max(c4) FROM tmp");
+
+  agg = PlanBuilder()
+            .values(vectors)
+            .partialAggregation({"c0"}, {"min(c4)", "max(c4)"})
+            .finalAggregation()
+            .planNode();
+  assertQuery(agg, "SELECT c0, min(c4), max(c4) FROM tmp GROUP BY 1");
+}
+
 } // namespace
@@ -13,10 +13,14 @@
  * See the License for the specific language governing permissions and
  * limitations under the License.
  */
+#include "velox/common/base/tests/GTestUtils.h"
 #include "velox/exec/AggregationHook.h"
+#include "velox/exec/tests/utils/AssertQueryBuilder.h"
 #include "velox/exec/tests/utils/PlanBuilder.h"
 #include "velox/functions/prestosql/aggregates/tests/AggregationTestBase.h"
+#include "velox/type/DecimalUtil.h"
 
+using facebook::velox::exec::test::AssertQueryBuilder;
 using facebook::velox::exec::test::PlanBuilder;
 
 namespace facebook::velox::aggregate::test {
@@ -95,6 +99,37 @@ TEST_F(SumTest, sumDouble) {
   assertQuery(agg, "SELECT sum(c0), sum(c1) FROM tmp");
 }
 
+TEST_F(SumTest, flatNoNulls) {
+  // Flat inputs without nulls take the SIMD path for the global aggregation
+  // and the prefetching path for the grouped one. Use sizes that are not a
+  // multiple of the SIMD width.
+  std::vector<RowVectorPtr> vectors;
+  for (auto i = 0; i < 3; ++i) {
+    vectors.push_back(makeRowVector({
+        makeFlatVector<int32_t>(1'001, [](auto row) { return row % 7; }),
+        makeFlatVector<int32_t>(
+            1'001, [i](auto row) { return row * 104'729 + i; }),
+        makeFlatVector<int64_t>(
+            1'001, [i](auto row) { return (row - 500) * 1'000'003 * i; }),
+    }));
+  }
+  createDuckDbTable(vectors);
+
+  auto agg = PlanBuilder()
+                 .values(vectors)
+                 .partialAggregation({}, {"sum(c1)", "sum(c2)"})
+                 .finalAggregation()
+                 .planNode();
+  assertQuery(agg, "SELECT sum(c1), sum(c2) FROM tmp");
+
+  agg = PlanBuilder()
+            .values(vectors)
+            .partialAggregation({"c0"}, {"sum(c1)", "sum(c2)"})
+            .finalAggregation()
+            .planNode();
+  assertQuery(agg, "SELECT c0, sum(c1), sum(c2) FROM tmp GROUP BY 1");
+}
+
 TEST_F(SumTest, sumWithMask) {
   auto rowType =
       ROW({"c0", "c1", "c2", "c3", "c4"},
@@ -247,6 +282,114 @@ TEST_F(SumTest, nulls) {
   assertQuery(plan, "SELECT a, sum(b) as sum_b FROM tmp GROUP BY 1");
 }
 
+TEST_F(SumTest, runLengthEncoded) {
+  // Runs of 1, 2, ..., 10 values, the third run null.
+  constexpr vector_size_t kNumRuns = 10;
+  auto runValues = makeFlatVector<int64_t>(
+      kNumRuns, [](auto row) { return row * 100; }, nullEvery(kNumRuns, 2));
+  auto lengths = allocateIndices(kNumRuns, pool());
+  auto* rawLengths = lengths->asMutable<vector_size_t>();
+  int64_t expectedSum = 0;
+  vector_size_t size = 0;
+  for (auto run = 0; run < kNumRuns; ++run) {
+    rawLengths[run] = run + 1;
+    size += run + 1;
+    if (run != 2) {
+      expectedSum += run * 100 * (run + 1);
+    }
+  }
+  auto data =
+      makeRowVector({BaseVector::wrapInSequence(lengths, size, runValues)});
+
+  auto plan = PlanBuilder()
+                  .values({data, data})
+                  .partialAggregation({}, {"sum(c0)", "max(c0)", "min(c0)"})
+                  .finalAggregation()
+                  .planNode();
+  auto expected = makeRowVector(
+      {makeFlatVector<int64_t>(std::vector<int64_t>{2 * expectedSum}),
+       makeFlatVector<int64_t>(std::vector<int64_t>{900}),
+       makeFlatVector<int64_t>(std::vector<int64_t>{0})});
+  assertEqualVectors(expected, AssertQueryBuilder(plan).copyResults(pool()));
+}
+
+TEST_F(SumTest, decimal) {
+  // Unscaled values of a short decimal with a sum that overflows 64 bits.
+  const std::vector<int64_t> values = {
+      999'999'999'999'999'999,
+      999'999'999'999'999'999,
+      -1,
+      999'999'999'999'999'999,
+      123};
+  auto input = BaseVector::create(DECIMAL(18, 2), values.size(), pool());
+  int128_t expectedSum = 0;
+  for (auto i = 0; i < values.size(); ++i) {
+    input->asFlatVector<ShortDecimal>()->set(i, ShortDecimal(values[i]));
+    expectedSum += values[i];
+  }
+  input->setNull(2, true);
+  expectedSum += 1;
+  auto data = makeRowVector({input});
+
+  auto expectedResult = [&](const TypePtr& type, int128_t value) {
+    auto vector = BaseVector::create(type, 1, pool());
+    if (type->kind() == TypeKind::SHORT_DECIMAL) {
+      vector->asFlatVector<ShortDecimal>()->set(0, ShortDecimal(value));
+    } else {
+      vector->asFlatVector<LongDecimal>()->set(0, LongDecimal(value));
+    }
+    return makeRowVector({vector});
+  };
+
+  auto plan = PlanBuilder()
+                  .values({data})
+                  .partialAggregation({}, {"sum(c0)"})
+                  .finalAggregation()
+                  .planNode();
+  assertEqualVectors(
+      expectedResult(DECIMAL(38, 2), expectedSum),
+      AssertQueryBuilder(plan).copyResults(pool()));
+
+  // avg rounds half away from zero and keeps the input type.
+  plan = PlanBuilder()
+             .values({data})
+             .partialAggregation({}, {"avg(c0)"})
+             .finalAggregation()
+             .planNode();
+  assertEqualVectors(
+      expectedResult(
+          DECIMAL(18, 2), DecimalUtil::divideRoundHalfUp(expectedSum, 4)),
+      AssertQueryBuilder(plan).copyResults(pool()));
+
+  // The same over long decimals.
+  auto longInput = BaseVector::create(DECIMAL(38, 0), 3, pool());
+  const int128_t large = DecimalUtil::kPowersOfTen[37];
+  longInput->asFlatVector<LongDecimal>()->set(0, LongDecimal(large));
+  longInput->asFlatVector<LongDecimal>()->set(1, LongDecimal(large));
+  longInput->asFlatVector<LongDecimal>()->set(2, LongDecimal(-1));
+  plan = PlanBuilder()
+             .values({makeRowVector({longInput})})
+             .singleAggregation({}, {"avg(c0)"})
+             .planNode();
+  assertEqualVectors(
+      expectedResult(
+          DECIMAL(38, 0), DecimalUtil::divideRoundHalfUp(2 * large - 1, 3)),
+      AssertQueryBuilder(plan).copyResults(pool()));
+
+  // A sum with more than 38 digits fails.
+  auto overflowInput = BaseVector::create(DECIMAL(38, 0), 10, pool());
+  for (auto i = 0; i < 10; ++i) {
+    overflowInput->asFlatVector<LongDecimal>()->set(
+        i, LongDecimal(DecimalUtil::kLongDecimalMax));
+  }
+  plan = PlanBuilder()
+             .values({makeRowVector({overflowInput})})
+             .singleAggregation({}, {"sum(c0)"})
+             .planNode();
+  VELOX_ASSERT_THROW(
+      AssertQueryBuilder(plan).copyResults(pool()), "Decimal overflow in sum");
+}
+
 struct SumRow {
   char nulls;
   int64_t sum;
@@ -101,3 +101,48 @@ TEST_F(ValueListTest, arrays) {
     }
   }
 }
+
+TEST_F(ValueListTest, readAll) {
+  auto testReadAll = [&](const VectorPtr& data) {
+    using T = int64_t;
+    auto size = data->size();
+    SelectivityVector allRows(size);
+    DecodedVector decoded(*data, allRows);
+
+    aggregate::ValueList values;
+    for (auto i = 0; i < size; i++) {
+      values.appendValue(decoded, i, allocator());
+    }
+    values.finalize(allocator());
+
+    // Read at an offset into a vector that has nulls to check that the
+    // null flags of non-null values are cleared.
+    auto result = BaseVector::create(data->type(), size + 3, pool());
+    for (auto i = 0; i < size + 3; i++) {
+      result->setNull(i, true);
+    }
+    aggregate::ValueListReader reader(values);
+    reader.readAll(*result->asFlatVector<T>(), 3);
+
+    auto* flatData = data->asFlatVector<T>();
+    auto* flatResult = result->asFlatVector<T>();
+    for (auto i = 0; i < size; i++) {
+      ASSERT_EQ(flatData->isNullAt(i), flatResult->isNullAt(i + 3)) << i;
+      if (!flatData->isNullAt(i)) {
+        ASSERT_EQ(flatData->valueAt(i), flatResult->valueAt(i + 3)) << i;
+      }
+    }
+    values.free(allocator());
+  };
+
+  for (auto size : {1, 64, 100, 10'000}) {
+    testReadAll(makeFlatVector<int64_t>(size, [](auto row) { return row; }));
+
+    for (auto nullEvery : {2, 7, 97}) {
+      testReadAll(makeFlatVector<int64_t>(
+          size,
+          [](auto row) { return row; },
+          test::VectorMaker::nullEvery(nullEvery)));
+    }
+  }
+}
@@ -0,0 +1,116 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <folly/Benchmark.h>
+#include <folly/Random.h>
+#include <folly/init/Init.h>
+
+#include "velox/functions/lib/benchmarks/FunctionBenchmarkBase.h"
+#include "velox/functions/prestosql/registration/RegistrationFunctions.h"
+
+namespace facebook::velox::functions {
+namespace {
+
+// Compares array_sort with sorting each array with std::sort. Each batch has
+// 10'000 elements in arrays of the same size.
+class ArraySortBenchmark : public functions::test::FunctionBenchmarkBase {
+ public:
+  ArraySortBenchmark() : FunctionBenchmarkBase() {
+    functions::prestosql::registerArrayFunctions();
+  }
+
+  template <typename T>
+  VectorPtr makeData(vector_size_t arraySize) {
+    constexpr vector_size_t kNumElements = 10'000;
+    folly::Random::DefaultGenerator rng(1);
+    return vectorMaker_.arrayVector<T>(
+        kNumElements / arraySize,
+        [arraySize](auto /*row*/) { return arraySize; },
+        [&](auto /*row*/) { return static_cast<T>(rng()); });
+  }
+
+  template <typename T>
+  size_t runArraySort(vector_size_t arraySize) {
+    folly::BenchmarkSuspender suspender;
+    auto rowVector = vectorMaker_.rowVector({makeData<T>(arraySize)});
+    auto exprSet = compileExpression("array_sort(c0)", rowVector->type());
+    suspender.dismiss();
+
+    size_t count = 0;
+    for (auto i = 0; i < 100; i++) {
+      count += evaluate(exprSet, rowVector)->size();
+    }
+    return count;
+  }
+
+  // Copies the elements and sorts each array with std::sort, the way
+  // array_sort used to.
+  template <typename T>
+  size_t runStdSort(vector_size_t arraySize) {
+    folly::BenchmarkSuspender suspender;
+    auto data = makeData<T>(arraySize);
+    auto* arrayVector = data->as<ArrayVector>();
+    auto* elements = arrayVector->elements()->asFlatVector<T>();
+    suspender.dismiss();
+
+    size_t count = 0;
+    for (auto i = 0; i < 100; i++) {
+      std::vector<T> values(
+          elements->rawValues(), elements->rawValues() + elements->size());
+      for (auto row = 0; row < arrayVector->size(); ++row) {
+        auto* begin = values.data() + arrayVector->offsetAt(row);
+        std::sort(begin, begin + arrayVector->sizeAt(row));
+      }
+      folly::doNotOptimizeAway(values);
+      count += arrayVector->size();
+    }
+    return count;
+  }
+};
+
+#define ARRAY_SORT_BENCHMARKS(type, name, size)           \
+  BENCHMARK_MULTI(stdSort_##name##_##size) {              \
+    ArraySortBenchmark benchmark;                         \
+    return benchmark.runStdSort<type>(size);              \
+  }                                                       \
+  BENCHMARK_RELATIVE_MULTI(arraySort_##name##_##size) {   \
+    ArraySortBenchmark benchmark;                         \
+    return benchmark.runArraySort<type>(size);            \
+  }                                                       \
+  BENCHMARK_DRAW_LINE();
+
+// Sorting network.
+ARRAY_SORT_BENCHMARKS(int32_t, integer, 8)
+ARRAY_SORT_BENCHMARKS(int64_t, bigint, 8)
+ARRAY_SORT_BENCHMARKS(double, double, 8)
+ARRAY_SORT_BENCHMARKS(int32_t, integer, 16)
+
+// std::sort.
+ARRAY_SORT_BENCHMARKS(int32_t, integer, 100)
+
+// Radix sort.
+ARRAY_SORT_BENCHMARKS(int32_t, integer, 1000)
+ARRAY_SORT_BENCHMARKS(int64_t, bigint, 1000)
+ARRAY_SORT_BENCHMARKS(int16_t, smallint, 1000)
+
+} // namespace
+} // namespace facebook::velox::functions
+
+int main(int argc, char** argv) {
+  folly::init(&argc, &argv);
+  folly::runBenchmarks();
+  return 0;
+}
@@ -124,6 +124,19 @@ class DateTimeBenchmark : public functions::test::FunctionBenchmarkBase {
     doRun(exprSet, data);
   }
 
+  // Evaluates 'expression' over a flat column 'c0' of 'type'.
+  void runExpression(const std::string& expression, const TypePtr& type) {
+    folly::BenchmarkSuspender suspender;
+    VectorFuzzer::Options opts;
+    opts.vectorSize = 10'000;
+    auto data =
+        vectorMaker_.rowVector({VectorFuzzer(opts, pool()).fuzzFlat(type)});
+    auto exprSet = compileExpression(expression, data->type());
+    suspender.dismiss();
+
+    doRun(exprSet, data);
+  }
+
   void doRun(exec::ExprSet& exprSet, const RowVectorPtr& rowVector) {
     int cnt = 0;
     for (auto i = 0; i < 100; i++) {
@@ -188,6 +201,26 @@ BENCHMARK_RELATIVE(hour_vector) {
   benchmark.run("hour_vector");
 }
 
+BENCHMARK(yearMonthDay) {
+  DateTimeBenchmark benchmark;
+  benchmark.runExpression("year(c0) + month(c0) + day(c0)", TIMESTAMP());
+}
+
+BENCHMARK(yearDate) {
+  DateTimeBenchmark benchmark;
+  benchmark.runExpression("year(c0)", DATE());
+}
+
+BENCHMARK(dayOfYearDate) {
+  DateTimeBenchmark benchmark;
+  benchmark.runExpression("day_of_year(c0)", DATE());
+}
+
+BENCHMARK(truncMonthDate) {
+  DateTimeBenchmark benchmark;
+  benchmark.runExpression("date_trunc('month', c0)", DATE());
+}
+
 BENCHMARK(minute) {
   DateTimeBenchmark benchmark;
   benchmark.run("minute");
@@ -56,14 +56,17 @@ class InBenchmark : public functions::test::FunctionBenchmarkBase {
         {VectorFuzzer(opts, pool()).fuzzFlat(INTEGER())});
   }
 
-  void run(size_t numValues) {
+  /// Runs 'c0 IN (0, step, 2 * step, ...)'. A step of 1 makes a range, a
+  /// small step a bitmask and a large step a hash table, unless there are at
+  /// most 16 values.
+  void run(size_t numValues, int64_t step = 2) {
     folly::BenchmarkSuspender suspender;
     auto data = makeData();
 
     std::ostringstream inList;
     inList << "0";
     for (auto i = 1; i < numValues; ++i) {
-      inList << ", " << i * 2;
+      inList << ", " << i * step;
     }
 
     auto sql = fmt::format("c0 IN ({})", inList.str());
@@ -116,6 +119,16 @@ BENCHMARK_RELATIVE(in) {
   benchmark.run(10);
 }
 
+BENCHMARK_RELATIVE(inRange) {
+  InBenchmark benchmark;
+  benchmark.run(10, 1);
+}
+
+BENCHMARK_RELATIVE(inSparse) {
+  InBenchmark benchmark;
+  benchmark.run(10, 1'000'000);
+}
+
 BENCHMARK(fastIn1K) {
   InBenchmark benchmark;
   benchmark.runFast(1'000);
@@ -126,6 +139,11 @@ BENCHMARK_RELATIVE(in1K) {
   benchmark.run(1'000);
 }
 
+BENCHMARK_RELATIVE(inSparse1K) {
+  InBenchmark benchmark;
+  benchmark.run(1'000, 1'000'000);
+}
+
 } // namespace
 
 int main(int /*argc*/, char** /*argv*/) {
@@ -190,17 +190,7 @@ class UrlBenchmark : public functions::test::FunctionBenchmarkBase {
     folly::BenchmarkSuspender suspender;
 
     size_t size = 1000;
-    auto vectorUrls = vectorMaker_.flatVector<StringView>(
-        size,
-        [](auto row) {
-          // construct some pseudo random url
-          return StringView(fmt::format(
-              "http://somehost{}.com:8080/somepath{}/p.php?k1={}#Refi",
-              row,
-              row % 2,
-              row % 3));
-        },
-        nullptr);
+    auto vectorUrls = makeUrls(size);
     auto constVector = BaseVector::createConstant("k1", size, pool());
     auto rowVector = isParameter
         ? vectorMaker_.rowVector({vectorUrls, constVector})
@@ -215,6 +205,32 @@ class UrlBenchmark : public functions::test::FunctionBenchmarkBase {
     doRun(exprSet, rowVector);
   }
 
+  // Evaluates 'expression' over a column 'c0' of URLs.
+  void runExpression(const std::string& expression) {
+    folly::BenchmarkSuspender suspender;
+
+    auto rowVector = vectorMaker_.rowVector({makeUrls(1000)});
+    auto exprSet = compileExpression(expression, rowVector->type());
+
+    suspender.dismiss();
+
+    doRun(exprSet, rowVector);
+  }
+
+  VectorPtr makeUrls(vector_size_t size) {
+    return vectorMaker_.flatVector<StringView>(
+        size,
+        [](auto row) {
+          // construct some pseudo random url
+          return StringView(fmt::format(
+              "http://somehost{}.com:8080/somepath{}/p.php?k1={}#Refi",
+              row,
+              row % 2,
+              row % 3));
+        },
+        nullptr);
+  }
+
   void doRun(ExprSet& exprSet, const RowVectorPtr& rowVector) {
     uint32_t cnt = 0;
     for (auto i = 0; i < 100; i++) {
@@ -284,6 +300,13 @@ BENCHMARK_RELATIVE(velox_protocol) {
   benchmark.runUrlExtract("url_extract_protocol");
 }
 
+BENCHMARK(velox_host_path_query) {
+  UrlBenchmark benchmark;
+  benchmark.runExpression(
+      "concat(url_extract_host(c0), url_extract_path(c0), "
+      "url_extract_query(c0))");
+}
+
 BENCHMARK(folly_param) {
   UrlBenchmark benchmark;
   benchmark.runUrlExtract("folly_url_extract_parameter", true);
@@ -14,8 +14,10 @@
  * limitations under the License.
  */
 #include "velox/functions/prestosql/hyperloglog/DenseHll.h"
+#include <cmath>
 #include <exception>
 #include <sstream>
+#include "velox/common/base/SimdUtil.h"
 #include "velox/functions/prestosql/aggregates/IOUtils.h"
 #include "velox/functions/prestosql/hyperloglog/BiasCorrection.h"
 #include "velox/functions/prestosql/hyperloglog/HllUtils.h"
@@ -116,6 +118,80 @@ double correctBias(double rawEstimate, int8_t indexBitLength) {
 
   return rawEstimate - bias;
 }
+
+/// Adds the number of buckets with each delta in the 'size' bytes of 'deltas'
+/// to 'counts', which has an entry for each delta from 0 to kMaxDelta.
+void countDeltas(const int8_t* deltas, int32_t size, int32_t* counts) {
+  using Batch = xsimd::batch<uint8_t>;
+  const auto* bytes = reinterpret_cast<const uint8_t*>(deltas);
+  const auto mask = xsimd::broadcast<uint8_t>(kBucketMask);
+  int32_t i = 0;
+  for (; i + Batch::size <= size; i += Batch::size) {
+    const auto batch = Batch::load_unaligned(bytes + i);
+    const auto low = batch & mask;
+    const auto high = (batch >> kBitsPerBucket) & mask;
+    for (uint8_t delta = 0; delta <= kMaxDelta; ++delta) {
+      const auto expected = xsimd::broadcast<uint8_t>(delta);
+      counts[delta] += __builtin_popcount(simd::toBitMask(low == expected)) +
+          __builtin_popcount(simd::toBitMask(high == expected));
+    }
+  }
+  for (; i < size; ++i) {
+    ++counts[bytes[i] & kBucketMask];
+    ++counts[bytes[i] >> kBitsPerBucket];
+  }
+}
+
+/// Sets each bucket in the 'size' bytes of 'deltas' to the larger of its
+/// value and the value in 'otherDeltas', as a delta from 'newBaseline', which
+/// is the larger of the baselines. Does not look at overflows, so a delta of
+/// kMaxDelta stands for a value of baseline + kMaxDelta. Returns the number
+/// of zero deltas in the result.
+int32_t mergeDeltas(
+    int8_t* deltas,
+    int8_t baseline,
+    const int8_t* otherDeltas,
+    int8_t otherBaseline,
+    int8_t newBaseline,
+    int32_t size) {
+  using Batch = xsimd::batch<uint8_t>;
+  auto* bytes = reinterpret_cast<uint8_t*>(deltas);
+  const auto* otherBytes = reinterpret_cast<const uint8_t*>(otherDeltas);
+  const auto mask = xsimd::broadcast<uint8_t>(kBucketMask);
+  const auto base = xsimd::broadcast<uint8_t>(baseline);
+  const auto otherBase = xsimd::broadcast<uint8_t>(otherBaseline);
+  const auto newBase = xsimd::broadcast<uint8_t>(newBaseline);
+  const auto zero = xsimd::broadcast<uint8_t>(0);
+  int32_t zeros = 0;
+  int32_t i = 0;
+  for (; i + Batch::size <= size; i += Batch::size) {
+    const auto batch = Batch::load_unaligned(bytes + i);
+    const auto otherBatch = Batch::load_unaligned(otherBytes + i);
+    const auto low =
+        xsimd::max((batch & mask) + base, (otherBatch & mask) + otherBase) -
+        newBase;
+    const auto high = xsimd::max(
+                          ((batch >> kBitsPerBucket) & mask) + base,
+                          ((otherBatch >> kBitsPerBucket) & mask) + otherBase) -
+        newBase;
+    ((high << kBitsPerBucket) | low).store_unaligned(bytes + i);
+    zeros += __builtin_popcount(simd::toBitMask(low == zero)) +
+        __builtin_popcount(simd::toBitMask(high == zero));
+  }
+  auto mergeDelta = [&](int delta, int otherDelta) -> uint8_t {
+    return std::max(delta + baseline, otherDelta + otherBaseline) -
+        newBaseline;
+  };
+  for (; i < size; ++i) {
+    const auto low =
+        mergeDelta(bytes[i] & kBucketMask, otherBytes[i] & kBucketMask);
+    const auto high = mergeDelta(
+        bytes[i] >> kBitsPerBucket, otherBytes[i] >> kBitsPerBucket);
+    bytes[i] = (high << kBitsPerBucket) | low;
+    zeros += (low == 0) + (high == 0);
+  }
+  return zeros;
+}
 } // namespace
 
 DenseHll::DenseHll(int8_t indexBitLength, HashStringAllocator* allocator)
@@ -143,6 +219,22 @@ void DenseHll::insertHash(uint64_t hash) {
 }
 
 void DenseHll::insert(int32_t index, int8_t value) {
+  if (updateBucket(index, value)) {
+    adjustBaselineIfNeeded();
+  }
+}
+
+void DenseHll::insert(
+    const int32_t* indices,
+    const int8_t* values,
+    int32_t size) {
+  for (auto i = 0; i < size; ++i) {
+    updateBucket(indices[i], values[i]);
+  }
+  adjustBaselineIfNeeded();
+}
+
+bool DenseHll::updateBucket(int32_t index, int8_t value) {
   auto delta = value - baseline_;
   auto oldDelta = getDelta(index);
 
@@ -150,7 +242,7 @@ void DenseHll::insert(int32_t index, int8_t value) {
       (oldDelta == kMaxDelta && (delta <= oldDelta + getOverflow(index)))) {
     // The old bucket value is (baseline + oldDelta) + possibly an overflow, so
     // it's guaranteed to be >= the new value.
-    return;
+    return false;
   }
 
   if (delta > kMaxDelta) {
@@ -170,8 +262,9 @@ void DenseHll::insert(int32_t index, int8_t value) {
 
   if (oldDelta == 0) {
     --baselineCount_;
-    adjustBaselineIfNeeded();
+    return true;
   }
+  return false;
 }
 
 namespace {
@@ -204,12 +297,9 @@ struct DenseHllView {
 int64_t cardinalityImpl(const DenseHllView& hll) {
   auto numBuckets = 1 << hll.indexBitLength;
 
-  int32_t baselineCount = 0;
-  for (int i = 0; i < numBuckets; i++) {
-    if (hll.getDelta(i) == 0) {
-      baselineCount++;
-    }
-  }
+  int32_t deltaCounts[kMaxDelta + 1] = {};
+  countDeltas(hll.deltas, numBuckets / 2, deltaCounts);
+  int32_t baselineCount = deltaCounts[0];
 
   // If baseline is zero, then baselineCount is the number of buckets with value
   // 0.
@@ -218,10 +308,18 @@ int64_t cardinalityImpl(const DenseHllView& hll) {
     return std::round(linearCounting(baselineCount, numBuckets));
   }
 
+  // Sums 1 / 2 ^ value over the buckets with the same delta at once, then
+  // corrects the sum for the buckets with an overflow.
   double sum = 0;
-  for (int i = 0; i < numBuckets; i++) {
-    int value = hll.getValue(i);
-    sum += 1.0 / (1L << value);
+  for (int delta = 0; delta <= kMaxDelta; ++delta) {
+    sum += deltaCounts[delta] * std::ldexp(1.0, -(hll.baseline + delta));
+  }
+  for (int i = 0; i < hll.overflows; ++i) {
+    if (hll.getDelta(hll.overflowBuckets[i]) == kMaxDelta) {
+      const int value = hll.baseline + kMaxDelta + hll.overflowValues[i];
+      sum += std::ldexp(1.0, -value) -
+          std::ldexp(1.0, -(hll.baseline + kMaxDelta));
+    }
   }
 
   double estimate = (alpha(hll.indexBitLength) * numBuckets * numBuckets) / sum;
@@ -517,12 +615,9 @@ DenseHll::DenseHll(const char* serialized, HashStringAllocator* allocator)
         overflowValues_.data());
   }
 
-  baselineCount_ = 0;
-  for (int i = 0; i < numBuckets; i++) {
-    if (getDelta(i) == 0) {
-      baselineCount_++;
-    }
-  }
+  int32_t deltaCounts[kMaxDelta + 1] = {};
+  countDeltas(deltas_.data(), deltas_.size(), deltaCounts);
+  baselineCount_ = deltaCounts[0];
 }
 
 void DenseHll::mergeWith(const DenseHll& other) {
@@ -568,54 +663,48 @@ void DenseHll::mergeWith(
     const uint16_t* otherOverflowBuckets,
     const int8_t* otherOverflowValues) {
   int8_t newBaseline = std::max(baseline_, otherBaseline);
-  int32_t baselineCount = 0;
-
-  int bucket = 0;
-  for (int i = 0; i < deltas_.size(); i++) {
-    int newSlot = 0;
-
-    int8_t slot1 = deltas_[i];
-    int8_t slot2 = otherDeltas[i];
-
-    for (int shift = 4; shift >= 0; shift -= 4) {
-      int8_t delta1 = (slot1 >> shift) & kBucketMask;
-      int8_t delta2 = (slot2 >> shift) & kBucketMask;
-
-      int8_t value1 = baseline_ + delta1;
-      int8_t value2 = otherBaseline + delta2;
-
-      int16_t overflowEntry = -1;
-      if (delta1 == kMaxDelta) {
-        overflowEntry = findOverflowEntry(bucket);
-        if (overflowEntry != -1) {
-          value1 += overflowValues_[overflowEntry];
-        }
-      }
-
-      if (delta2 == kMaxDelta) {
-        value2 += getOverflowImpl(
-            bucket, otherOverflows, otherOverflowBuckets, otherOverflowValues);
-      }
-
-      int8_t newValue = std::max(value1, value2);
-      int8_t newDelta = newValue - newBaseline;
 
-      if (newDelta == 0) {
-        baselineCount++;
-      }
-
-      newDelta = updateOverflow(bucket, overflowEntry, newDelta);
-
-      newSlot <<= 4;
-      newSlot |= newDelta;
-      bucket++;
+  // Merges the deltas as if there were no overflows, then raises the buckets
+  // with an overflow on either side to their values.
+  std::vector<std::pair<uint16_t, int8_t>> bucketValues;
+  for (int i = 0; i < overflows_; i++) {
+    bucketValues.emplace_back(
+        overflowBuckets_[i], baseline_ + kMaxDelta + overflowValues_[i]);
+  }
+  for (int i = 0; i < otherOverflows; i++) {
+    const auto bucket = otherOverflowBuckets[i];
+    const auto otherDelta =
+        (otherDeltas[bucket >> 1] >> shiftForBucket(bucket)) & kBucketMask;
+    if (otherDelta == kMaxDelta) {
+      bucketValues.emplace_back(
+          bucket, otherBaseline + kMaxDelta + otherOverflowValues[i]);
     }
-
-    deltas_[i] = newSlot;
   }
 
+  baselineCount_ = mergeDeltas(
+      deltas_.data(),
+      baseline_,
+      otherDeltas,
+      otherBaseline,
+      newBaseline,
+      deltas_.size());
   baseline_ = newBaseline;
-  baselineCount_ = baselineCount;
+  overflows_ = 0;
+
+  for (const auto& [bucket, value] : bucketValues) {
+    auto delta = getDelta(bucket);
+    auto overflowEntry = findOverflowEntry(bucket);
+    if (overflowEntry != -1) {
+      delta += overflowValues_[overflowEntry];
+    }
+    if (value <= baseline_ + delta) {
+      continue;
+    }
+    if (delta == 0) {
+      --baselineCount_;
+    }
+    setDelta(bucket, updateOverflow(bucket, overflowEntry, value - baseline_));
+  }
 
   // All baseline values in one of the HLLs lost to the values
   // in the other HLL, so we need to adjust the final baseline.
@@ -53,6 +53,10 @@ class DenseHll {
   /// value of this HLL. Used by SparseHll.toDense().
   void insert(int32_t index, int8_t value);
 
+  /// Inserts 'size' pre-computed {bucket, value} pairs. Adjusts the baseline
+  /// once at the end instead of after each pair.
+  void insert(const int32_t* indices, const int8_t* values, int32_t size);
+
   int64_t cardinality() const;
 
   static int64_t cardinality(const char* serialized);
@@ -91,6 +95,11 @@ class DenseHll {
   static int32_t estimateInMemorySize(int8_t indexBitLength);
 
  private:
+  /// Sets bucket 'index' to 'value' if 'value' is larger. Returns true if the
+  /// bucket was at the baseline, in which case the baseline may need
+  /// adjusting.
+  bool updateBucket(int32_t index, int8_t value);
+
   int8_t getDelta(int32_t index) const;
 
   void setDelta(int32_t index, int8_t value);
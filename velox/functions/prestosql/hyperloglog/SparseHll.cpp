@@ -228,21 +228,32 @@ void SparseHll::verify() const {
 void SparseHll::toDense(DenseHll& denseHll) const {
   auto indexBitLength = denseHll.indexBitLength();
 
-  for (auto i = 0; i < entries_.size(); i++) {
-    auto entry = entries_[i];
-    auto index = entry >> (32 - indexBitLength);
-
-    auto zeros = __builtin_clz(entry << indexBitLength);
-
-    // If zeros > kIndexBitLength - indexBitLength, it means all those bits were
-    // zeros, so look at the entry value, which contains the number of leading 0
-    // *after* kIndexBitLength.
-    auto bits = kIndexBitLength - indexBitLength;
-    if (zeros > bits) {
-      zeros = bits + decodeValue(entry) - 1;
+  // Decodes the entries a batch at a time and inserts each batch with one
+  // call.
+  constexpr int32_t kBatchSize = 256;
+  int32_t indices[kBatchSize];
+  int8_t values[kBatchSize];
+  for (auto start = 0; start < entries_.size(); start += kBatchSize) {
+    const int32_t numEntries =
+        std::min<size_t>(kBatchSize, entries_.size() - start);
+    for (auto i = 0; i < numEntries; i++) {
+      auto entry = entries_[start + i];
+      auto index = entry >> (32 - indexBitLength);
+
+      auto zeros = __builtin_clz(entry << indexBitLength);
+
+      // If zeros > kIndexBitLength - indexBitLength, it means all those bits
+      // were zeros, so look at the entry value, which contains the number of
+      // leading 0 *after* kIndexBitLength.
+      auto bits = kIndexBitLength - indexBitLength;
+      if (zeros > bits) {
+        zeros = bits + decodeValue(entry) - 1;
+      }
+
+      indices[i] = index;
+      values[i] = zeros + 1;
     }
-
-    denseHll.insert(index, zeros + 1);
+    denseHll.insert(indices, values, numEntries);
   }
 }
 
@@ -219,6 +219,54 @@ TEST_P(DenseHllTest, mergeWith) {
   testMergeWith(indexBitLength, sequence(0, 2'000'000), sequence(0, 2'000'000));
 }
 
+TEST_P(DenseHllTest, mergeWithOverflows) {
+  int8_t indexBitLength = GetParam();
+  const auto numBuckets = 1 << indexBitLength;
+
+  // Values far apart make overflows on both sides and baselines that differ.
+  for (auto serialized : {false, true}) {
+    DenseHll hllLeft{indexBitLength, &allocator_};
+    DenseHll hllRight{indexBitLength, &allocator_};
+    DenseHll expected{indexBitLength, &allocator_};
+    for (auto i = 0; i < numBuckets; ++i) {
+      const int8_t leftValue = i % 5 == 0 ? 20 + i % 17 : 3 + i % 4;
+      const int8_t rightValue = i % 7 == 0 ? 30 - i % 11 : 6 + i % 3;
+      hllLeft.insert(i, leftValue);
+      hllRight.insert(i, rightValue);
+      expected.insert(i, std::max(leftValue, rightValue));
+    }
+
+    if (serialized) {
+      auto serializedRight = serialize(hllRight);
+      hllLeft.mergeWith(serializedRight.data());
+    } else {
+      hllLeft.mergeWith(hllRight);
+    }
+
+    ASSERT_EQ(hllLeft.cardinality(), expected.cardinality());
+    ASSERT_EQ(serialize(hllLeft), serialize(expected));
+  }
+}
+
+TEST_P(DenseHllTest, insertBatch) {
+  int8_t indexBitLength = GetParam();
+  const auto numBuckets = 1 << indexBitLength;
+
+  std::vector<int32_t> indices;
+  std::vector<int8_t> values;
+  DenseHll expected{indexBitLength, &allocator_};
+  for (auto i = 0; i < 3 * numBuckets; ++i) {
+    indices.push_back(i * 7 % numBuckets);
+    values.push_back(1 + i % 23);
+    expected.insert(indices.back(), values.back());
+  }
+
+  DenseHll hll{indexBitLength, &allocator_};
+  hll.insert(indices.data(), values.data(), indices.size());
+  ASSERT_EQ(hll.cardinality(), expected.cardinality());
+  ASSERT_EQ(serialize(hll), serialize(expected));
+}
+
 INSTANTIATE_TEST_SUITE_P(
     DenseHllTest,
     DenseHllTest,
@@ -16,12 +16,16 @@
 
 #include "velox/functions/prestosql/json/JsonExtractor.h"
 
+#include <algorithm>
 #include <cctype>
+#include <cstring>
 #include <unordered_map>
 #include <vector>
 
 #include "boost/algorithm/string/trim.hpp"
+#include "folly/Conv.h"
 #include "folly/String.h"
+#include "folly/container/F14Map.h"
 #include "folly/json.h"
 #include "velox/common/base/Exceptions.h"
 #include "velox/functions/prestosql/json/JsonPathTokenizer.h"
@@ -32,29 +36,41 @@ namespace {
 
 using JsonVector = std::vector<const folly::dynamic*>;
 
+class JsonScanner;
+
 class JsonExtractor {
  public:
   // Use this method to get an instance of JsonExtractor given a json path.
   static JsonExtractor& getInstance(folly::StringPiece path) {
     // Pre-process
-    auto trimedPath = folly::trimWhitespace(path).str();
+    auto trimedPath = folly::trimWhitespace(path);
 
-    std::shared_ptr<JsonExtractor> op;
-    if (kExtractorCache.count(trimedPath)) {
-      op = kExtractorCache.at(trimedPath);
-    } else {
-      if (kExtractorCache.size() == kMaxCacheNum) {
-        // TODO: Blindly evict the first one, use better policy
-        kExtractorCache.erase(kExtractorCache.begin());
-      }
-      op = std::make_shared<JsonExtractor>(trimedPath);
-      kExtractorCache[trimedPath] = op;
+    // Looks up the path without copying it.
+    auto it = kExtractorCache.find(trimedPath);
+    if (it != kExtractorCache.end()) {
+      return *it->second;
     }
+    if (kExtractorCache.size() == kMaxCacheNum) {
+      // TODO: Blindly evict the first one, use better policy
+      kExtractorCache.erase(kExtractorCache.begin());
+    }
+    auto op = std::make_shared<JsonExtractor>(trimedPath.str());
+    kExtractorCache.emplace(trimedPath.str(), op);
     return *op;
   }
 
   folly::Optional<folly::dynamic> extract(const folly::dynamic& json);
 
+  // Extracts the scalar at the path from the document of 'scanner' without
+  // parsing it into a folly::dynamic. The document must have been validated.
+  // Returns false if the document or the path use constructs that only
+  // extract() handles, e.g. wildcards, escaped strings or non-integer
+  // numbers. Otherwise sets 'result' to a view into the document or into a
+  // literal, or to folly::none if there is no scalar at the path.
+  bool tryExtractScalar(
+      JsonScanner& scanner,
+      folly::Optional<folly::StringPiece>& result);
+
   // Shouldn't instantiate directly - use getInstance().
   explicit JsonExtractor(const std::string& path) {
     if (!tokenize(path)) {
@@ -84,8 +100,8 @@ class JsonExtractor {
 
   // Cache tokenize operations in JsonExtractor across invocations in the same
   // thread for the same JsonPath.
-  thread_local static std::
-      unordered_map<std::string, std::shared_ptr<JsonExtractor>>
+  thread_local static folly::
+      F14FastMap<std::string, std::shared_ptr<JsonExtractor>>
           kExtractorCache;
   thread_local static JsonPathTokenizer kTokenizer;
 
@@ -95,10 +111,366 @@ class JsonExtractor {
   std::vector<std::string> tokens_;
 };
 
-thread_local std::unordered_map<std::string, std::shared_ptr<JsonExtractor>>
+thread_local folly::F14FastMap<std::string, std::shared_ptr<JsonExtractor>>
     JsonExtractor::kExtractorCache;
 thread_local JsonPathTokenizer JsonExtractor::kTokenizer;
 
+// Outcome of looking up a path with JsonScanner.
+enum class ScanResult { kFound, kNotFound, kUnsupported };
+
+// Reads a JSON document in place, without allocating. Used to extract
+// scalars without building a folly::dynamic for the whole document.
+// Accepts a subset of what folly::parseJson accepts, so that documents
+// it validates are parsed by folly::parseJson into the same values.
+class JsonScanner {
+ public:
+  explicit JsonScanner(folly::StringPiece json)
+      : begin_(json.begin()), pos_(json.begin()), end_(json.end()) {}
+
+  // Returns true if the document is a single valid JSON value with optional
+  // surrounding whitespace.
+  bool validate() {
+    pos_ = begin_;
+    if (!skipValue(0)) {
+      return false;
+    }
+    skipWhitespace();
+    return pos_ == end_;
+  }
+
+  // Sets 'value' to the text of the value at 'tokens'. Requires a document
+  // for which validate() returned true.
+  ScanResult find(
+      const std::vector<std::string>& tokens,
+      folly::StringPiece& value) {
+    pos_ = begin_;
+    for (const auto& token : tokens) {
+      skipWhitespace();
+      ScanResult result;
+      if (*pos_ == '{') {
+        result = findMember(token);
+      } else if (*pos_ == '[') {
+        result = findElement(token);
+      } else {
+        return ScanResult::kNotFound;
+      }
+      if (result != ScanResult::kFound) {
+        return result;
+      }
+    }
+    skipWhitespace();
+    auto start = pos_;
+    skipValue(0);
+    value = folly::StringPiece(start, pos_);
+    return ScanResult::kFound;
+  }
+
+ private:
+  // Nesting limit. Below the recursion limit of folly::parseJson.
+  static constexpr int32_t kMaxDepth = 64;
+
+  // Longest integer accepted. Longer ones may overflow int64_t, which
+  // folly::parseJson reports as an error.
+  static constexpr int32_t kMaxIntegerDigits = 18;
+
+  static bool isDigit(char c) {
+    return c >= '0' && c <= '9';
+  }
+
+  void skipWhitespace() {
+    while (pos_ < end_ &&
+           (*pos_ == ' ' || *pos_ == '\n' || *pos_ == '\r' ||
+            *pos_ == '\t')) {
+      ++pos_;
+    }
+  }
+
+  bool skipValue(int32_t depth) {
+    skipWhitespace();
+    if (pos_ == end_) {
+      return false;
+    }
+    bool hasEscape;
+    switch (*pos_) {
+      case '{':
+        return skipObject(depth + 1);
+      case '[':
+        return skipArray(depth + 1);
+      case '"':
+        return skipString(hasEscape);
+      case 't':
+        return skipLiteral("true");
+      case 'f':
+        return skipLiteral("false");
+      case 'n':
+        return skipLiteral("null");
+      default:
+        return skipNumber();
+    }
+  }
+
+  bool skipObject(int32_t depth) {
+    if (depth > kMaxDepth) {
+      return false;
+    }
+    ++pos_;
+    skipWhitespace();
+    if (pos_ < end_ && *pos_ == '}') {
+      ++pos_;
+      return true;
+    }
+    for (;;) {
+      skipWhitespace();
+      bool hasEscape;
+      if (pos_ == end_ || *pos_ != '"' || !skipString(hasEscape)) {
+        return false;
+      }
+      skipWhitespace();
+      if (pos_ == end_ || *pos_++ != ':') {
+        return false;
+      }
+      if (!skipValue(depth)) {
+        return false;
+      }
+      skipWhitespace();
+      if (pos_ == end_) {
+        return false;
+      }
+      if (*pos_ == ',') {
+        ++pos_;
+      } else if (*pos_++ == '}') {
+        return true;
+      } else {
+        return false;
+      }
+    }
+  }
+
+  bool skipArray(int32_t depth) {
+    if (depth > kMaxDepth) {
+      return false;
+    }
+    ++pos_;
+    skipWhitespace();
+    if (pos_ < end_ && *pos_ == ']') {
+      ++pos_;
+      return true;
+    }
+    for (;;) {
+      if (!skipValue(depth)) {
+        return false;
+      }
+      skipWhitespace();
+      if (pos_ == end_) {
+        return false;
+      }
+      if (*pos_ == ',') {
+        ++pos_;
+      } else if (*pos_++ == ']') {
+        return true;
+      } else {
+        return false;
+      }
+    }
+  }
+
+  // Skips the string starting at 'pos_'. Sets 'hasEscape' if the string
+  // contains escape sequences.
+  bool skipString(bool& hasEscape) {
+    hasEscape = false;
+    ++pos_;
+    while (pos_ < end_) {
+      const auto c = static_cast<unsigned char>(*pos_);
+      if (c == '"') {
+        ++pos_;
+        return true;
+      }
+      if (c < 0x20) {
+        return false;
+      }
+      ++pos_;
+      if (c != '\\') {
+        continue;
+      }
+      hasEscape = true;
+      if (pos_ == end_) {
+        return false;
+      }
+      switch (*pos_) {
+        case '"':
+        case '\\':
+        case '/':
+        case 'b':
+        case 'f':
+        case 'n':
+        case 'r':
+        case 't':
+          ++pos_;
+          break;
+        case 'u':
+          if (!skipUnicodeEscape()) {
+            return false;
+          }
+          break;
+        default:
+          return false;
+      }
+    }
+    return false;
+  }
+
+  // Skips the 'uXXXX' of a \uXXXX escape.
+  bool skipUnicodeEscape() {
+    if (end_ - pos_ < 5) {
+      return false;
+    }
+    uint32_t codePoint = 0;
+    for (auto i = 1; i < 5; ++i) {
+      const auto c = pos_[i];
+      codePoint <<= 4;
+      if (isDigit(c)) {
+        codePoint |= c - '0';
+      } else if (c >= 'a' && c <= 'f') {
+        codePoint |= c - 'a' + 10;
+      } else if (c >= 'A' && c <= 'F') {
+        codePoint |= c - 'A' + 10;
+      } else {
+        return false;
+      }
+    }
+    // Surrogate pairs are left to folly::parseJson, which checks them.
+    if (codePoint >= 0xD800 && codePoint <= 0xDFFF) {
+      return false;
+    }
+    pos_ += 5;
+    return true;
+  }
+
+  bool skipLiteral(folly::StringPiece literal) {
+    if (end_ - pos_ < static_cast<int64_t>(literal.size()) ||
+        memcmp(pos_, literal.data(), literal.size()) != 0) {
+      return false;
+    }
+    pos_ += literal.size();
+    return true;
+  }
+
+  bool skipNumber() {
+    if (*pos_ == '-') {
+      ++pos_;
+    }
+    const auto digits = pos_;
+    if (pos_ == end_ || !isDigit(*pos_)) {
+      return false;
+    }
+    if (*pos_ == '0') {
+      ++pos_;
+    } else {
+      while (pos_ < end_ && isDigit(*pos_)) {
+        ++pos_;
+      }
+    }
+    bool isInteger = true;
+    if (pos_ < end_ && *pos_ == '.') {
+      isInteger = false;
+      ++pos_;
+      if (pos_ == end_ || !isDigit(*pos_)) {
+        return false;
+      }
+      while (pos_ < end_ && isDigit(*pos_)) {
+        ++pos_;
+      }
+    }
+    if (pos_ < end_ && (*pos_ == 'e' || *pos_ == 'E')) {
+      isInteger = false;
+      ++pos_;
+      if (pos_ < end_ && (*pos_ == '+' || *pos_ == '-')) {
+        ++pos_;
+      }
+      const auto exponent = pos_;
+      while (pos_ < end_ && isDigit(*pos_)) {
+        ++pos_;
+      }
+      // Exponents of 3 digits or more may overflow.
+      if (pos_ == exponent || pos_ - exponent > 2) {
+        return false;
+      }
+    }
+    return !isInteger || pos_ - digits <= kMaxIntegerDigits;
+  }
+
+  // Moves to the value of the member 'key' of the object at 'pos_'.
+  ScanResult findMember(const std::string& key) {
+    ++pos_;
+    skipWhitespace();
+    if (*pos_ == '}') {
+      return ScanResult::kNotFound;
+    }
+    const char* match = nullptr;
+    for (;;) {
+      skipWhitespace();
+      const auto keyStart = pos_ + 1;
+      bool hasEscape;
+      skipString(hasEscape);
+      if (hasEscape) {
+        // The key may match once unescaped.
+        return ScanResult::kUnsupported;
+      }
+      const folly::StringPiece memberKey(keyStart, pos_ - 1);
+      skipWhitespace();
+      ++pos_;
+      skipWhitespace();
+      if (memberKey == key) {
+        if (match) {
+          // Duplicate keys are resolved by folly::dynamic.
+          return ScanResult::kUnsupported;
+        }
+        match = pos_;
+      }
+      skipValue(0);
+      skipWhitespace();
+      if (*pos_++ != ',') {
+        break;
+      }
+    }
+    if (!match) {
+      return ScanResult::kNotFound;
+    }
+    pos_ = match;
+    return ScanResult::kFound;
+  }
+
+  // Moves to the element at index 'token' of the array at 'pos_'.
+  ScanResult findElement(const std::string& token) {
+    if (token.empty() || token.size() > 9 ||
+        !std::all_of(token.begin(), token.end(), isDigit)) {
+      // Wildcards and other subscripts are left to extract().
+      return ScanResult::kUnsupported;
+    }
+    const auto index = folly::to<int32_t>(token);
+    ++pos_;
+    skipWhitespace();
+    if (*pos_ == ']') {
+      return ScanResult::kNotFound;
+    }
+    for (auto i = 0;; ++i) {
+      skipWhitespace();
+      if (i == index) {
+        return ScanResult::kFound;
+      }
+      skipValue(0);
+      skipWhitespace();
+      if (*pos_++ != ',') {
+        return ScanResult::kNotFound;
+      }
+    }
+  }
+
+  const char* const begin_;
+  const char* pos_;
+  const char* const end_;
+};
+
 void extractObject(
     const folly::dynamic* jsonObj,
     const std::string& key,
@@ -166,11 +538,66 @@ folly::Optional<folly::dynamic> JsonExtractor::extract(
   }
 }
 
+bool JsonExtractor::tryExtractScalar(
+    JsonScanner& scanner,
+    folly::Optional<folly::StringPiece>& result) {
+  folly::StringPiece value;
+  switch (scanner.find(tokens_, value)) {
+    case ScanResult::kUnsupported:
+      return false;
+    case ScanResult::kNotFound:
+      result = folly::none;
+      return true;
+    case ScanResult::kFound:
+      break;
+  }
+  switch (value.front()) {
+    case '"':
+      value = value.subpiece(1, value.size() - 2);
+      if (value.find('\\') != folly::StringPiece::npos) {
+        return false;
+      }
+      result = value;
+      return true;
+    case 't':
+    case 'f':
+      result = value;
+      return true;
+    case 'n':
+    case '{':
+    case '[':
+      result = folly::none;
+      return true;
+    default:
+      // Integers are returned as written. folly::dynamic formats doubles and
+      // -0 differently.
+      if (value == "-0" ||
+          value.find_first_of(".eE") != folly::StringPiece::npos) {
+        return false;
+      }
+      result = value;
+      return true;
+  }
+}
+
 bool isScalarType(const folly::Optional<folly::dynamic>& json) {
   return json.has_value() && !json->isObject() && !json->isArray() &&
       !json->isNull();
 }
 
+folly::Optional<folly::StringPiece> toScalar(
+    const folly::Optional<folly::dynamic>& json,
+    std::string& buffer) {
+  if (!isScalarType(json)) {
+    return folly::none;
+  }
+  if (json->isBool()) {
+    return folly::StringPiece(json->asBool() ? "true" : "false");
+  }
+  buffer = json->asString();
+  return folly::StringPiece(buffer);
+}
+
 } // namespace
 
 folly::Optional<folly::dynamic> jsonExtract(
@@ -207,17 +634,60 @@ folly::Optional<folly::dynamic> jsonExtract(
   return folly::none;
 }
 
+folly::Optional<folly::StringPiece> jsonExtractScalar(
+    folly::StringPiece json,
+    folly::StringPiece path,
+    std::string& buffer) {
+  auto& extractor = JsonExtractor::getInstance(path);
+  // If 'json' is not validated, let folly::parseJson decide whether it is
+  // valid.
+  JsonScanner scanner(json);
+  folly::Optional<folly::StringPiece> result;
+  if (scanner.validate() && extractor.tryExtractScalar(scanner, result)) {
+    return result;
+  }
+  return toScalar(jsonExtract(json, path), buffer);
+}
+
+void jsonExtractScalars(
+    folly::StringPiece json,
+    const std::vector<folly::StringPiece>& paths,
+    std::vector<folly::Optional<folly::StringPiece>>& results,
+    std::vector<std::string>& buffers) {
+  results.resize(paths.size());
+  buffers.resize(paths.size());
+  JsonScanner scanner(json);
+  const bool valid = scanner.validate();
+  // Parsed on the first path that needs it.
+  folly::Optional<folly::dynamic> parsed;
+  bool parseFailed = false;
+  for (auto i = 0; i < paths.size(); ++i) {
+    auto& extractor = JsonExtractor::getInstance(paths[i]);
+    if (valid && extractor.tryExtractScalar(scanner, results[i])) {
+      continue;
+    }
+    if (!parsed.has_value() && !parseFailed) {
+      try {
+        parsed = folly::parseJson(json);
+      } catch (const folly::json::parse_error&) {
+        parseFailed = true;
+      } catch (const folly::ConversionError&) {
+        parseFailed = true;
+      }
+    }
+    results[i] = parseFailed
+        ? folly::none
+        : toScalar(extractor.extract(parsed.value()), buffers[i]);
+  }
+}
+
 folly::Optional<std::string> jsonExtractScalar(
     folly::StringPiece json,
     folly::StringPiece path) {
-  auto res = jsonExtract(json, path);
-  // Not a scalar value
-  if (isScalarType(res)) {
-    if (res->isBool()) {
-      return res->asBool() ? std::string{"true"} : std::string{"false"};
-    } else {
-      return res->asString();
-    }
+  std::string buffer;
+  auto result = jsonExtractScalar(json, path, buffer);
+  if (result.has_value()) {
+    return result->str();
   }
   return folly::none;
 }
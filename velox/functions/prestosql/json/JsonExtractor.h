@@ -17,6 +17,7 @@
 #pragma once
 
 #include <string>
+#include <vector>
 
 #include "folly/Range.h"
 #include "folly/dynamic.h"
@@ -63,6 +64,24 @@ folly::Optional<std::string> jsonExtractScalar(
     folly::StringPiece json,
     folly::StringPiece path);
 
+/// Like jsonExtractScalar() above, but avoids copies. The result points into
+/// 'json', into a string literal or into 'buffer'. Scalars reached without
+/// wildcards, outside of escaped strings, are found by reading 'json' in
+/// place instead of parsing it into a folly::dynamic.
+folly::Optional<folly::StringPiece> jsonExtractScalar(
+    folly::StringPiece json,
+    folly::StringPiece path,
+    std::string& buffer);
+
+/// Extracts the scalars at several paths from the same document, reading or
+/// parsing 'json' once for all of them. Sets 'results[i]' to the scalar at
+/// 'paths[i]', as jsonExtractScalar() above would with 'buffers[i]'.
+void jsonExtractScalars(
+    folly::StringPiece json,
+    const std::vector<folly::StringPiece>& paths,
+    std::vector<folly::Optional<folly::StringPiece>>& results,
+    std::vector<std::string>& buffers);
+
 folly::Optional<folly::dynamic> jsonExtract(
     const std::string& json,
     const std::string& path);
@@ -501,3 +501,42 @@ TEST(JsonExtractorTest, jsonMultipleExtractsTest) {
   ASSERT_TRUE(extract2.hasValue());
   EXPECT_EQ(jsonExtract(json, "$.store.fruit").value(), extract2.value());
 }
+
+// Covers the documents and paths that jsonExtractScalar reads in place and
+// those it leaves to folly::parseJson.
+TEST(JsonExtractorTest, scalarInPlaceTest) {
+  EXPECT_SCALAR_VALUE_EQ(
+      " { \"a\" : [ 1 , { \"b\" : 22 } ] } "s, "$.a[1].b"s, "22"s);
+  EXPECT_SCALAR_VALUE_EQ("{\"a\": true, \"b\": false}"s, "$.b"s, "false"s);
+  EXPECT_SCALAR_VALUE_EQ("{\"a\": -15}"s, "$.a"s, "-15"s);
+  EXPECT_SCALAR_VALUE_EQ("{\"a\": -0}"s, "$.a"s, "0"s);
+  EXPECT_SCALAR_VALUE_EQ("{\"a\": 1.50}"s, "$.a"s, "1.5"s);
+  EXPECT_SCALAR_VALUE_EQ("{\"a\": \"x\\ny\"}"s, "$.a"s, "x\ny"s);
+  EXPECT_SCALAR_VALUE_EQ("{\"a\\u0062\": 1}"s, "$.ab"s, "1"s);
+  EXPECT_SCALAR_VALUE_EQ("[[1, 2], [3]]"s, "$[1][0]"s, "3"s);
+  EXPECT_SCALAR_VALUE_EQ("[\"a\"]"s, "$[*]"s, "a"s);
+  EXPECT_SCALAR_VALUE_NULL("{\"a\": [1]}"s, "$.b[0]"s);
+  EXPECT_SCALAR_VALUE_NULL("[1, 2]"s, "$.a"s);
+  EXPECT_SCALAR_VALUE_NULL("5"s, "$.a"s);
+
+  // Invalid documents return null even when the value precedes the error.
+  EXPECT_SCALAR_VALUE_NULL("{\"a\": 1,"s, "$.a"s);
+  EXPECT_SCALAR_VALUE_NULL("{\"a\": 1} x"s, "$.a"s);
+  EXPECT_SCALAR_VALUE_NULL("{\"a\": 1, \"b\": 01}"s, "$.a"s);
+  EXPECT_SCALAR_VALUE_NULL("{\"a\": 1, \"b\": tru}"s, "$.a"s);
+  EXPECT_SCALAR_VALUE_NULL("{\"a\": 1, \"b\": \"\\x\"}"s, "$.a"s);
+
+  // The overload with a buffer points into the document when it can.
+  std::string json = "{\"a\": \"abc\", \"b\": \"\\u0001\"}";
+  std::string buffer;
+  auto result = jsonExtractScalar(
+      folly::StringPiece(json), folly::StringPiece("$.a"), buffer);
+  ASSERT_TRUE(result.hasValue());
+  EXPECT_EQ("abc", result.value());
+  EXPECT_GE(result->data(), json.data());
+  EXPECT_LT(result->data(), json.data() + json.size());
+  result = jsonExtractScalar(
+      folly::StringPiece(json), folly::StringPiece("$.b"), buffer);
+  ASSERT_TRUE(result.hasValue());
+  EXPECT_EQ("\001", result.value());
+}
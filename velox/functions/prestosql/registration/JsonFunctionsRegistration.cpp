@@ -21,6 +21,11 @@ namespace facebook::velox::functions {
 void registerJsonFunctions() {
   registerFunction<JsonExtractScalarFunction, Varchar, Varchar, Varchar>(
       {"json_extract_scalar"});
+  registerFunction<
+      JsonExtractScalarsFunction,
+      Array<Varchar>,
+      Varchar,
+      Variadic<Varchar>>({"json_extract_scalars"});
 }
 
 } // namespace facebook::velox::functions
@@ -305,3 +305,30 @@ TEST_F(ArrayDistinctTest, nonContiguousRows) {
       makeRowVector({c0, c1, c2}));
   assertEqualVectors(expected, result);
 }
+
+// Arrays on both sides of the size limit for deduplicating without hashing.
+TEST_F(ArrayDistinctTest, sizes) {
+  std::vector<std::vector<std::optional<int64_t>>> input;
+  std::vector<std::vector<std::optional<int64_t>>> expected;
+  for (auto size : {3, 10, 16, 17, 40}) {
+    std::vector<std::optional<int64_t>> values;
+    std::vector<std::optional<int64_t>> distinctValues;
+    for (auto i = 0; i < size; ++i) {
+      std::optional<int64_t> value;
+      if (i % 7 != 5) {
+        value = i * 11 % 13;
+      }
+      values.push_back(value);
+      if (std::find(distinctValues.begin(), distinctValues.end(), value) ==
+          distinctValues.end()) {
+        distinctValues.push_back(value);
+      }
+    }
+    input.push_back(values);
+    expected.push_back(distinctValues);
+  }
+  testExpr(
+      makeNullableArrayVector(expected),
+      "array_distinct(C0)",
+      {makeNullableArrayVector(input)});
+}
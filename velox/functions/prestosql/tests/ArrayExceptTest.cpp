@@ -291,3 +291,24 @@ TEST_F(ArrayExceptTest, constant) {
   });
   testExpr(expected, "array_except(ARRAY[1,NULL,4], C0)", {array1});
 }
+
+// When the right-hand side is constant-encoded but not a literal.
+TEST_F(ArrayExceptTest, constantEncoding) {
+  auto array1 = makeNullableArrayVector<int32_t>({
+      {1, -2, 3, std::nullopt, 4, 5, 6, std::nullopt},
+      {1, 2, -2, 1},
+      {3, 8, std::nullopt},
+      {1, 1, -2, -2, -2, 4, 8},
+  });
+  auto array2 = BaseVector::wrapInConstant(
+      4, 1, makeArrayVector<int32_t>({{5}, {1, -2, 4, 1}}));
+  auto expected = makeNullableArrayVector<int32_t>({
+      {3, std::nullopt, 5, 6},
+      {2},
+      {3, 8, std::nullopt},
+      {8},
+  });
+  auto result = evaluate<ArrayVector>(
+      "array_except(c0, c1)", makeRowVector({array1, array2}));
+  assertEqualVectors(expected, result);
+}
@@ -256,3 +256,55 @@ TEST_F(ArrayIntersectTest, constant) {
   testExpr(expected, "array_intersect(C0, ARRAY[1,NULL,4])", {array1});
   testExpr(expected, "array_intersect(ARRAY[1,NULL,4], C0)", {array1});
 }
+
+// Arrays longer than the sets that are searched without hashing.
+TEST_F(ArrayIntersectTest, longArrays) {
+  std::vector<std::vector<int64_t>> left;
+  std::vector<std::vector<int64_t>> right;
+  std::vector<std::vector<int64_t>> expected;
+  for (auto size : {5, 16, 17, 40}) {
+    std::vector<int64_t> leftValues;
+    std::vector<int64_t> rightValues;
+    for (auto i = 0; i < size; ++i) {
+      leftValues.push_back(i * 7 % 25);
+      rightValues.push_back(i % 20);
+    }
+    std::vector<int64_t> expectedValues;
+    for (auto value : leftValues) {
+      auto contains = [&](const auto& values) {
+        return std::find(values.begin(), values.end(), value) != values.end();
+      };
+      if (contains(rightValues) && !contains(expectedValues)) {
+        expectedValues.push_back(value);
+      }
+    }
+    left.push_back(leftValues);
+    right.push_back(rightValues);
+    expected.push_back(expectedValues);
+  }
+  testExpr(
+      makeArrayVector(expected),
+      "array_intersect(C0, C1)",
+      {makeArrayVector(left), makeArrayVector(right)});
+}
+
+// When the right-hand side is constant-encoded but not a literal.
+TEST_F(ArrayIntersectTest, constantEncoding) {
+  auto array1 = makeNullableArrayVector<int32_t>({
+      {1, -2, 3, std::nullopt, 4, 5, 6, std::nullopt},
+      {1, 2, -2, 1},
+      {3, 8, std::nullopt},
+      {1, 1, -2, -2, -2, 4, 8},
+  });
+  auto array2 = BaseVector::wrapInConstant(
+      4, 1, makeArrayVector<int32_t>({{5}, {1, -2, 4, 1}}));
+  auto expected = makeNullableArrayVector<int32_t>({
+      {1, -2, 4},
+      {1, -2},
+      {},
+      {1, -2, 4},
+  });
+  auto result = evaluate<ArrayVector>(
+      "array_intersect(c0, c1)", makeRowVector({array1, array2}));
+  assertEqualVectors(expected, result);
+}
@@ -376,6 +376,45 @@ TEST_P(ArraySortTest, basic) {
   runTest(GetParam());
 }
 
+class ArraySortSizesTest : public FunctionBaseTest {
+ protected:
+  // Arrays of sizes around the limits of the sorting network and the radix
+  // sort, with nulls, duplicates and values that differ in several bytes.
+  template <typename T>
+  void test() {
+    std::vector<std::vector<std::optional<T>>> input;
+    std::vector<std::vector<std::optional<T>>> expected;
+    for (auto size : {0, 1, 2, 5, 16, 17, 100, 255, 256, 1'000}) {
+      std::vector<std::optional<T>> values;
+      for (auto i = 0; i < size; ++i) {
+        if (i % 11 == 3) {
+          values.push_back(std::nullopt);
+        } else {
+          values.push_back(static_cast<T>(
+              (i * 7'919 % 1'001 - 500) * (i % 3 == 0 ? 1 : 1'000'003)));
+        }
+      }
+      input.push_back(values);
+      std::sort(values.begin(), values.end(), [](auto& a, auto& b) {
+        return a.has_value() && (!b.has_value() || a.value() < b.value());
+      });
+      expected.push_back(values);
+    }
+    auto result = evaluate<ArrayVector>(
+        "array_sort(c0)", makeRowVector({makeNullableArrayVector(input)}));
+    assertEqualVectors(makeNullableArrayVector(expected), result);
+  }
+};
+
+TEST_F(ArraySortSizesTest, sizes) {
+  test<int8_t>();
+  test<int16_t>();
+  test<int32_t>();
+  test<int64_t>();
+  test<float>();
+  test<double>();
+}
+
 VELOX_INSTANTIATE_TEST_SUITE_P(
     ArraySortTest,
     ArraySortTest,
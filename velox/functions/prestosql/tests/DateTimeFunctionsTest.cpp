@@ -15,6 +15,7 @@
  */
 
 #include <optional>
+#include "velox/functions/prestosql/DateTimeImpl.h"
 #include "velox/functions/prestosql/tests/FunctionBaseTest.h"
 #include "velox/functions/prestosql/types/TimestampWithTimeZoneType.h"
 #include "velox/type/Date.h"
@@ -314,6 +315,26 @@ TEST_F(DateTimeFunctionsTest, fromUnixtime) {
   EXPECT_EQ(Timestamp(0, 0), fromUnixtime(kNan));
 }
 
+TEST_F(DateTimeFunctionsTest, toDateTime) {
+  // Years -7500 to 11000, stepping by neither whole days nor whole hours.
+  for (int64_t seconds = -300'000'000'000; seconds < 285'000'000'000;
+       seconds += 86'399 * 7 + 3'601) {
+    std::tm expected;
+    auto time = static_cast<time_t>(seconds);
+    gmtime_r(&time, &expected);
+    auto actual = functions::toDateTime(seconds);
+    ASSERT_EQ(expected.tm_year, actual.tm_year) << seconds;
+    ASSERT_EQ(expected.tm_mon, actual.tm_mon) << seconds;
+    ASSERT_EQ(expected.tm_mday, actual.tm_mday) << seconds;
+    ASSERT_EQ(expected.tm_hour, actual.tm_hour) << seconds;
+    ASSERT_EQ(expected.tm_min, actual.tm_min) << seconds;
+    ASSERT_EQ(expected.tm_sec, actual.tm_sec) << seconds;
+    ASSERT_EQ(expected.tm_wday, actual.tm_wday) << seconds;
+    ASSERT_EQ(expected.tm_yday, actual.tm_yday) << seconds;
+    ASSERT_EQ(seconds, functions::fromDateTime(actual));
+  }
+}
+
 TEST_F(DateTimeFunctionsTest, year) {
   const auto year = [&](std::optional<Timestamp> date) {
     return evaluateOnce<int64_t>("year(c0)", date);
@@ -0,0 +1,125 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "velox/common/base/tests/GTestUtils.h"
+#include "velox/functions/prestosql/tests/FunctionBaseTest.h"
+#include "velox/type/DecimalUtil.h"
+
+namespace facebook::velox {
+namespace {
+
+class DecimalArithmeticTest : public functions::test::FunctionBaseTest {
+ protected:
+  // Returns a flat vector of 'type' with the given unscaled values.
+  VectorPtr makeDecimalVector(
+      const TypePtr& type,
+      const std::vector<int128_t>& unscaledValues) {
+    auto size = unscaledValues.size();
+    auto vector = BaseVector::create(type, size, pool());
+    for (auto i = 0; i < size; ++i) {
+      if (type->kind() == TypeKind::SHORT_DECIMAL) {
+        vector->asFlatVector<ShortDecimal>()->set(
+            i, ShortDecimal(unscaledValues[i]));
+      } else {
+        vector->asFlatVector<LongDecimal>()->set(
+            i, LongDecimal(unscaledValues[i]));
+      }
+    }
+    return vector;
+  }
+
+  void testDecimalExpression(
+      const std::string& expression,
+      const std::vector<VectorPtr>& inputs,
+      const TypePtr& expectedType,
+      const std::vector<int128_t>& expected) {
+    auto result = evaluate(expression, makeRowVector(inputs));
+    ASSERT_TRUE(result->type()->equivalent(*expectedType))
+        << result->type()->toString();
+    assertEqualVectors(makeDecimalVector(expectedType, expected), result);
+  }
+};
+
+TEST_F(DecimalArithmeticTest, add) {
+  // Short decimal result. The argument with the smaller scale is rescaled.
+  testDecimalExpression(
+      "c0 + c1",
+      {makeDecimalVector(DECIMAL(10, 2), {100, -250, 0, 999}),
+       makeDecimalVector(DECIMAL(10, 3), {5, 1000, -1, 999})},
+      DECIMAL(12, 3),
+      {1'005, -1'500, -1, 999'999});
+
+  // Long decimal result from short decimal arguments.
+  const int64_t kMaxShort = DecimalUtil::kPowersOfTen[18] - 1;
+  testDecimalExpression(
+      "c0 + c1",
+      {makeDecimalVector(DECIMAL(18, 0), {kMaxShort, -kMaxShort}),
+       makeDecimalVector(DECIMAL(18, 0), {kMaxShort, -1})},
+      DECIMAL(19, 0),
+      {static_cast<int128_t>(kMaxShort) * 2, -kMaxShort - 1});
+
+  // Long decimal arguments and constants.
+  testDecimalExpression(
+      "c0 + c0",
+      {makeDecimalVector(DECIMAL(30, 5), {DecimalUtil::kPowersOfTen[29], 7})},
+      DECIMAL(31, 5),
+      {DecimalUtil::kPowersOfTen[29] * 2, 14});
+}
+
+TEST_F(DecimalArithmeticTest, subtract) {
+  testDecimalExpression(
+      "c0 - c1",
+      {makeDecimalVector(DECIMAL(10, 2), {100, -250, 0}),
+       makeDecimalVector(DECIMAL(20, 3), {5, 1000, -1})},
+      DECIMAL(21, 3),
+      {995, -3'500, 1});
+}
+
+TEST_F(DecimalArithmeticTest, multiply) {
+  testDecimalExpression(
+      "c0 * c1",
+      {makeDecimalVector(DECIMAL(5, 2), {150, -200, 0}),
+       makeDecimalVector(DECIMAL(5, 1), {15, 31, 99})},
+      DECIMAL(10, 3),
+      {2'250, -6'200, 0});
+
+  testDecimalExpression(
+      "c0 * c1",
+      {makeDecimalVector(DECIMAL(18, 0), {DecimalUtil::kPowersOfTen[17]}),
+       makeDecimalVector(DECIMAL(18, 0), {DecimalUtil::kPowersOfTen[17]})},
+      DECIMAL(36, 0),
+      {DecimalUtil::kPowersOfTen[34]});
+}
+
+TEST_F(DecimalArithmeticTest, overflow) {
+  // The result precision is capped at 38 digits.
+  auto data = makeRowVector({
+      makeDecimalVector(DECIMAL(38, 0), {1, DecimalUtil::kLongDecimalMax, 2}),
+      makeDecimalVector(DECIMAL(38, 0), {1, 1, 2}),
+  });
+  VELOX_ASSERT_THROW(evaluate("c0 + c1", data), "Decimal overflow");
+  VELOX_ASSERT_THROW(evaluate("c0 * c0", data), "Decimal overflow");
+
+  // Rows without overflow are computed under TRY.
+  auto result = evaluate("try(c0 + c1)", data);
+  ASSERT_FALSE(result->isNullAt(0));
+  ASSERT_TRUE(result->isNullAt(1));
+  ASSERT_FALSE(result->isNullAt(2));
+  ASSERT_EQ(
+      result->as<SimpleVector<LongDecimal>>()->valueAt(2), LongDecimal(4));
+}
+
+} // namespace
+} // namespace facebook::velox
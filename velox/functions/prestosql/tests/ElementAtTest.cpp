@@ -362,6 +362,53 @@ TEST_F(ElementAtTest, constantInputMap) {
   }
 }
 
+TEST_F(ElementAtTest, repeatedLookupsInLargeMaps) {
+  // Maps of 32 keys: 0, 2, 4, ..., 62. Key 2 * i maps to row * 100 + i. The
+  // subscripts after the first probe an index of the keys of all maps.
+  auto sizeAt = [](vector_size_t /* row */) { return 32; };
+  auto keyAt = [](vector_size_t idx) { return (idx % 32) * 2; };
+  auto valueAt = [](vector_size_t idx) { return (idx / 32) * 100 + idx % 32; };
+  auto mapVector =
+      makeMapVector<int64_t, int64_t>(kVectorSize, sizeAt, keyAt, valueAt);
+  testElementAt<int64_t>(
+      "C0[0] + C0[10] + C0[62] + element_at(C0, 30)",
+      {mapVector},
+      [](vector_size_t row) { return row * 400 + 5 + 31 + 15; });
+
+  auto expectedNullAt = [](vector_size_t /* row */) { return true; };
+  testElementAt<int64_t>(
+      "C0[2] + C0[3] + element_at(C0, 64)",
+      {mapVector},
+      [](vector_size_t /* row */) { return 0; },
+      expectedNullAt);
+
+  auto keys =
+      makeFlatVector<int64_t>(kVectorSize, [](auto row) { return row % 70; });
+  testElementAt<int64_t>(
+      "C0[0] + C0[C1]",
+      {mapVector, keys},
+      [](vector_size_t row) { return row * 200 + (row % 70) / 2; },
+      [](vector_size_t row) { return row % 70 % 2 == 1 || row % 70 > 62; });
+
+  // The same over varchar keys 'k0' to 'k19'.
+  auto stringMapVector = makeMapVector<StringView, int64_t>(
+      kVectorSize,
+      [](vector_size_t /* row */) { return 20; },
+      [](vector_size_t idx) {
+        return StringView(folly::sformat("k{}", idx % 20));
+      },
+      [](vector_size_t idx) { return idx; });
+  testElementAt<int64_t>(
+      "C0['k3'] + C0['k19'] + element_at(C0, 'k7')",
+      {stringMapVector},
+      [](vector_size_t row) { return row * 60 + 3 + 19 + 7; });
+  testElementAt<int64_t>(
+      "C0['k3'] + C0['k20']",
+      {stringMapVector},
+      [](vector_size_t /* row */) { return 0; },
+      expectedNullAt);
+}
+
 TEST_F(ElementAtTest, variableInputMap) {
   testVariableInputMap<int64_t>(); // BIGINT
   testVariableInputMap<int32_t>(); // INTEGER
@@ -13,6 +13,8 @@
  * See the License for the specific language governing permissions and
  * limitations under the License.
  */
+#include <folly/String.h>
+
 #include "velox/functions/prestosql/tests/FunctionBaseTest.h"
 
 using namespace facebook::velox;
@@ -134,6 +136,53 @@ class InPredicateTest : public FunctionBaseTest {
     assertEqualVectors(expected, result);
   }
 
+  // Tests IN lists of the shapes that are evaluated differently: ranges,
+  // short lists, bitmasks and hash tables. The size is not a multiple of the
+  // SIMD batch size.
+  template <typename T>
+  void testIntegerListShapes() {
+    const vector_size_t size = 1'003;
+    auto vector = makeFlatVector<T>(
+        size, [](auto row) { return row * 37 % 251 - 125; });
+    auto rowVector = makeRowVector({vector});
+
+    auto testInList = [&](const std::vector<int64_t>& values) {
+      auto result = evaluate<SimpleVector<bool>>(
+          fmt::format("c0 IN ({})", folly::join(", ", values)), rowVector);
+      auto expected = makeFlatVector<bool>(size, [&](auto row) {
+        return std::find(values.begin(), values.end(), vector->valueAt(row)) !=
+            values.end();
+      });
+      assertEqualVectors(expected, result);
+    };
+
+    std::vector<int64_t> values;
+    for (auto i = -3; i <= 3; ++i) {
+      values.push_back(i);
+    }
+    testInList(values);
+
+    values = {-125, -60, 7, 125};
+    testInList(values);
+
+    values.clear();
+    for (auto i = 0; i < 16; ++i) {
+      values.push_back(i * 15 - 120);
+    }
+    testInList(values);
+
+    values.push_back(124);
+    testInList(values);
+
+    if constexpr (sizeof(T) > 1) {
+      for (auto i = 0; i < 17; ++i) {
+        values[i] = i * 3'000 - 25'000;
+      }
+      values.push_back(-125);
+      testInList(values);
+    }
+  }
+
   template <typename T>
   void testsIntegerConstant() {
     const vector_size_t size = 1'000;
@@ -165,21 +214,25 @@ class InPredicateTest : public FunctionBaseTest {
 
 TEST_F(InPredicateTest, bigint) {
   testIntegers<int64_t>();
+  testIntegerListShapes<int64_t>();
   testsIntegerConstant<int64_t>();
 }
 
 TEST_F(InPredicateTest, integer) {
   testIntegers<int32_t>();
+  testIntegerListShapes<int32_t>();
   testsIntegerConstant<int32_t>();
 }
 
 TEST_F(InPredicateTest, smallint) {
   testIntegers<int16_t>();
+  testIntegerListShapes<int16_t>();
   testsIntegerConstant<int16_t>();
 }
 
 TEST_F(InPredicateTest, tinyint) {
   testIntegers<int8_t>();
+  testIntegerListShapes<int8_t>();
   testsIntegerConstant<int8_t>();
 }
 
@@ -271,6 +324,51 @@ TEST_F(InPredicateTest, varchar) {
   assertEqualVectors(expected, result);
 }
 
+TEST_F(InPredicateTest, varcharEmptyString) {
+  const vector_size_t size = 1'000;
+
+  std::vector<std::string> strings = {
+      "", "a", "ab", "abcd", "apple", "", "pear", "abcdefghijklmnop"};
+
+  auto vector = makeFlatVector<StringView>(size, [&strings](auto row) {
+    return StringView(strings[row % strings.size()]);
+  });
+  // The second word of a StringView of up to 4 bytes is not part of the
+  // value. Make it differ between rows.
+  auto rawValues = vector->mutableRawValues();
+  for (auto row = 0; row < size; ++row) {
+    if (rawValues[row].size() <= StringView::kPrefixSize) {
+      const uint64_t tail = 0x0123456789abcdefULL * (row + 1);
+      memcpy(
+          reinterpret_cast<char*>(&rawValues[row]) + sizeof(uint64_t),
+          &tail,
+          sizeof(tail));
+    }
+  }
+  auto rowVector = makeRowVector({vector});
+
+  auto result =
+      evaluate<SimpleVector<bool>>("c0 IN ('', 'ab', 'pear')", rowVector);
+  auto expected = makeFlatVector<bool>(size, [&strings](auto row) {
+    const auto& string = strings[row % strings.size()];
+    return string.empty() || string == "ab" || string == "pear";
+  });
+  assertEqualVectors(expected, result);
+
+  result = evaluate<SimpleVector<bool>>("c0 IN ('')", rowVector);
+  expected = makeFlatVector<bool>(size, [&strings](auto row) {
+    return strings[row % strings.size()].empty();
+  });
+  assertEqualVectors(expected, result);
+
+  result = evaluate<SimpleVector<bool>>("c0 IN ('a', 'abcd')", rowVector);
+  expected = makeFlatVector<bool>(size, [&strings](auto row) {
+    const auto& string = strings[row % strings.size()];
+    return string == "a" || string == "abcd";
+  });
+  assertEqualVectors(expected, result);
+}
+
 TEST_F(InPredicateTest, varcharConstant) {
   const vector_size_t size = 1'000;
   auto rowVector = makeRowVector(
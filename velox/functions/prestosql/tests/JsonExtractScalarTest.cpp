@@ -160,6 +160,33 @@ TEST_F(JsonExtractScalarTest, overflow) {
       std::nullopt);
 }
 
+TEST_F(JsonExtractScalarTest, multiplePaths) {
+  auto data = makeRowVector({makeFlatVector<std::string>({
+      R"({"a": 1, "b": {"c": "x"}, "d": [true, 2.5]})",
+      R"({"a": "\u0041", "b": [1]})",
+      R"({"a": 1,)",
+  })});
+
+  auto result = evaluate<ArrayVector>(
+      "json_extract_scalars(c0, '$.a', '$.b.c', '$.d[0]', '$.d[1]', '$.b')",
+      data);
+  auto expected = makeNullableArrayVector<StringView>({
+      {"1"_sv, "x"_sv, "true"_sv, "2.5"_sv, std::nullopt},
+      {"A"_sv, std::nullopt, std::nullopt, std::nullopt, std::nullopt},
+      {std::nullopt, std::nullopt, std::nullopt, std::nullopt, std::nullopt},
+  });
+  ::facebook::velox::test::assertEqualVectors(expected, result);
+
+  // Same results as separate json_extract_scalar calls.
+  for (const auto& path : {"$.a", "$.b.c", "$.d[0]", "$.d[1]", "$.b"}) {
+    auto single = evaluate<SimpleVector<StringView>>(
+        fmt::format("json_extract_scalar(c0, '{}')", path), data);
+    auto fromMultiple = evaluate<SimpleVector<StringView>>(
+        fmt::format("json_extract_scalars(c0, '{}')[1]", path), data);
+    ::facebook::velox::test::assertEqualVectors(single, fromMultiple);
+  }
+}
+
 } // namespace
 
 } // namespace facebook::velox::functions::prestosql
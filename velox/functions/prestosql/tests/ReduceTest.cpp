@@ -123,3 +123,51 @@ TEST_F(ReduceTest, conditional) {
       nullEvery(11));
   assertEqualVectors(expectedResult, result);
 }
+
+// Arrays of very different lengths finish at different steps. Each keeps the
+// state it had after its last element. Also covers lambdas that return one of
+// their arguments as is.
+TEST_F(ReduceTest, differentLengths) {
+  vector_size_t size = 1'000;
+  auto inputArray = makeArrayVector<int64_t>(
+      size,
+      [](auto row) { return row % 101; },
+      [](auto row, auto index) { return row + index; },
+      nullEvery(13));
+  auto input = makeRowVector({inputArray});
+  auto signature = rowType("s", BIGINT(), "x", BIGINT());
+  registerLambda("sum_input", signature, input->type(), "s + x");
+  registerLambda("last_input", signature, input->type(), "x");
+  registerLambda("keep_state", signature, input->type(), "s");
+  registerLambda("output", rowType("s", BIGINT()), input->type(), "s");
+
+  auto result = evaluate<SimpleVector<int64_t>>(
+      "reduce(c0, 0, function('sum_input'), function('output'))", input);
+  assertEqualVectors(
+      makeFlatVector<int64_t>(
+          size,
+          [](auto row) {
+            int64_t sum = 0;
+            for (auto i = 0; i < row % 101; i++) {
+              sum += row + i;
+            }
+            return sum;
+          },
+          nullEvery(13)),
+      result);
+
+  result = evaluate<SimpleVector<int64_t>>(
+      "reduce(c0, -1, function('last_input'), function('output'))", input);
+  assertEqualVectors(
+      makeFlatVector<int64_t>(
+          size,
+          [](auto row) { return row % 101 == 0 ? -1 : row + row % 101 - 1; },
+          nullEvery(13)),
+      result);
+
+  result = evaluate<SimpleVector<int64_t>>(
+      "reduce(c0, 7, function('keep_state'), function('output'))", input);
+  assertEqualVectors(
+      makeFlatVector<int64_t>(size, [](auto) { return 7; }, nullEvery(13)),
+      result);
+}
@@ -302,3 +302,23 @@ TEST_F(SplitTest, splitError) {
   // Limit should be positive.
   EXPECT_THROW(RUN("split(C0, C1, C2)", 0), std::invalid_argument);
 }
+
+/// Elements reference the string buffers of the input, which are only kept
+/// if some element does not fit inline.
+TEST_F(SplitTest, stringBuffers) {
+  auto elementBuffers = [&](const std::vector<std::string>& input) {
+    auto strings = makeFlatVector<StringView>(
+        input.size(), [&](auto row) { return StringView(input[row]); });
+    auto result =
+        evaluate<ArrayVector>("split(c0, ',')", makeRowVector({strings}));
+    auto elements = result->elements()->asFlatVector<StringView>();
+    EXPECT_TRUE(
+        elements->stringBuffers().empty() ||
+        elements->stringBuffers() == strings->stringBuffers());
+    return elements->stringBuffers().size();
+  };
+
+  EXPECT_EQ(0, elementBuffers({"short,tokens,only,in,a,long,string"}));
+  EXPECT_EQ(1, elementBuffers({"a,token longer than inline,b"}));
+  EXPECT_EQ(1, elementBuffers({"a,b", "last token is long enough"}));
+}
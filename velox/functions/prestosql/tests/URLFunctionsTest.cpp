@@ -98,6 +98,15 @@ TEST_F(URLFunctionsTest, validateURL) {
       "",
       "",
       std::nullopt);
+  validate(
+      "http://user:pass@[::1]:8080/p?q#f",
+      "http",
+      "[::1]",
+      "/p",
+      "f",
+      "q",
+      8080);
+  validate("1http://example.com", "", "", "", "", "", std::nullopt);
   validate("foo", "", "", "", "", "", std::nullopt);
 }
 
@@ -122,6 +131,12 @@ TEST_F(URLFunctionsTest, extractParameter) {
       extractParam(
           "http://example.com/path1/p.php?k1=v1&k2=v2&k3&k4#Ref1", "k6"),
       std::nullopt);
+  EXPECT_EQ(
+      extractParam("http://example.com/path1/p.php?k1=v1=v2&k1=v3", "k1"),
+      "v3");
+  EXPECT_EQ(
+      extractParam("http://example.com/path1/p.php?&k1=v1#k2=v2", "k2"),
+      std::nullopt);
   EXPECT_EQ(extractParam("foo", ""), std::nullopt);
 }
 
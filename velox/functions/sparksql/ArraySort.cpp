@@ -20,6 +20,7 @@
 #include "velox/expression/EvalCtx.h"
 #include "velox/expression/Expr.h"
 #include "velox/expression/VectorFunction.h"
+#include "velox/functions/lib/ArraySortUtil.h"
 #include "velox/functions/lib/LambdaFunctionUtil.h"
 #include "velox/functions/sparksql/Comparisons.h"
 #include "velox/type/Type.h"
@@ -103,6 +104,7 @@ void applyTyped(
 
   auto flatResults = (*resultElements)->asFlatVector<T>();
   T* resultRawValues = flatResults->mutableRawValues();
+  std::vector<T> scratch;
 
   auto processRow = [&](vector_size_t row) {
     auto size = inputArray->sizeAt(row);
@@ -144,11 +146,19 @@ void applyTyped(
       bits::fillBits(rawBits, mid, rowEnd, !smallerValue);
     } else {
       if (ascending) {
-        std::sort(
-            resultRawValues + rowBegin, resultRawValues + rowEnd, Less<T>());
+        sortPrimitiveValues(
+            resultRawValues + rowBegin,
+            rowEnd - rowBegin,
+            ascending,
+            Less<T>(),
+            scratch);
       } else {
-        std::sort(
-            resultRawValues + rowBegin, resultRawValues + rowEnd, Greater<T>());
+        sortPrimitiveValues(
+            resultRawValues + rowBegin,
+            rowEnd - rowBegin,
+            ascending,
+            Greater<T>(),
+            scratch);
       }
     }
   };
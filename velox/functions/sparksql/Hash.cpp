@@ -18,6 +18,7 @@
 #include <stdint.h>
 
 #include <folly/CPortability.h>
+#include <xsimd/xsimd.hpp>
 
 #include "velox/common/base/BitUtil.h"
 #include "velox/vector/FlatVector.h"
@@ -106,6 +107,113 @@ uint32_t hashDouble(double input, uint32_t seed) {
       input == -0. ? 0 : *reinterpret_cast<uint64_t*>(&input), seed);
 }
 
+// Versions of the above that hash Batch::size values at a time.
+using Batch = xsimd::batch<uint32_t>;
+
+constexpr vector_size_t kBatchSize = Batch::size;
+
+Batch rotateLeft(Batch x, int32_t n) {
+  return (x << n) | (x >> (32 - n));
+}
+
+Batch mixK1(Batch k1) {
+  k1 *= Batch(0xcc9e2d51);
+  k1 = rotateLeft(k1, 15);
+  k1 *= Batch(0x1b873593);
+  return k1;
+}
+
+Batch mixH1(Batch h1, Batch k1) {
+  h1 ^= k1;
+  h1 = rotateLeft(h1, 13);
+  h1 = h1 * Batch(5u) + Batch(0xe6546b64);
+  return h1;
+}
+
+Batch fmix(Batch h1, uint32_t length) {
+  h1 ^= Batch(length);
+  h1 ^= h1 >> 16;
+  h1 *= Batch(0x85ebca6b);
+  h1 ^= h1 >> 13;
+  h1 *= Batch(0xc2b2ae35);
+  h1 ^= h1 >> 16;
+  return h1;
+}
+
+// Hashes the 4 byte 'values' of the rows in [begin, end) into 'hashes',
+// using the previous hashes as seeds.
+template <typename T>
+void hashFourByteValues(
+    const T* values,
+    int32_t* hashes,
+    vector_size_t begin,
+    vector_size_t end) {
+  static_assert(sizeof(T) == sizeof(uint32_t));
+  auto row = begin;
+  for (; row + kBatchSize <= end; row += kBatchSize) {
+    auto input =
+        Batch::load_unaligned(reinterpret_cast<const uint32_t*>(values + row));
+    if constexpr (std::is_floating_point_v<T>) {
+      // -0f is hashed as +0f.
+      input = xsimd::select(input == Batch(0x80000000), Batch(0u), input);
+    }
+    auto* seeds = reinterpret_cast<uint32_t*>(hashes + row);
+    fmix(mixH1(Batch::load_unaligned(seeds), mixK1(input)), 4)
+        .store_unaligned(seeds);
+  }
+  for (; row < end; ++row) {
+    if constexpr (std::is_floating_point_v<T>) {
+      hashes[row] = hashFloat(values[row], hashes[row]);
+    } else {
+      hashes[row] = hashInt32(values[row], hashes[row]);
+    }
+  }
+}
+
+template <typename T, typename Hash>
+void hashValues(
+    const T* values,
+    int32_t* hashes,
+    vector_size_t begin,
+    vector_size_t end,
+    Hash hash) {
+  for (auto row = begin; row < end; ++row) {
+    hashes[row] = hash(values[row], hashes[row]);
+  }
+}
+
+// Hashes a column of flat fixed width values without nulls into 'hashes' for
+// the rows in [begin, end). Returns false if the type has no such kernel.
+bool hashFlatColumn(
+    TypeKind kind,
+    const DecodedVector& decoded,
+    int32_t* hashes,
+    vector_size_t begin,
+    vector_size_t end) {
+  switch (kind) {
+    case TypeKind::TINYINT:
+      hashValues(decoded.data<int8_t>(), hashes, begin, end, hashInt32);
+      return true;
+    case TypeKind::SMALLINT:
+      hashValues(decoded.data<int16_t>(), hashes, begin, end, hashInt32);
+      return true;
+    case TypeKind::INTEGER:
+      hashFourByteValues(decoded.data<int32_t>(), hashes, begin, end);
+      return true;
+    case TypeKind::REAL:
+      hashFourByteValues(decoded.data<float>(), hashes, begin, end);
+      return true;
+    case TypeKind::BIGINT:
+      hashValues(decoded.data<int64_t>(), hashes, begin, end, hashInt64);
+      return true;
+    case TypeKind::DOUBLE:
+      hashValues(decoded.data<double>(), hashes, begin, end, hashDouble);
+      return true;
+    default:
+      return false;
+  }
+}
+
 class HashFunction final : public exec::VectorFunction {
   bool isDefaultNullBehavior() const final {
     return false;
@@ -128,6 +236,18 @@ class HashFunction final : public exec::VectorFunction {
 
     for (auto& arg : args) {
       exec::LocalDecodedVector decoded(context, *arg, rows);
+      // Flat columns without nulls are hashed a column at a time. The hash
+      // of each column is the seed for the next.
+      if (rows.isAllSelected() && decoded->isIdentityMapping() &&
+          !decoded->mayHaveNulls() &&
+          hashFlatColumn(
+              arg->typeKind(),
+              *decoded,
+              result.mutableRawValues(),
+              rows.begin(),
+              rows.end())) {
+        continue;
+      }
       const SelectivityVector* selected = &rows;
       if (arg->mayHaveNulls()) {
         *selectedMinusNulls.get(rows.end()) = rows;
@@ -13,6 +13,8 @@
  * See the License for the specific language governing permissions and
  * limitations under the License.
  */
+#include <array>
+
 #include "folly/container/F14Set.h"
 #include "folly/hash/Hash.h"
 
@@ -62,6 +64,10 @@ class Set<StringView> {
   folly::F14FastSet<std::string_view> set_;
 };
 
+// Maximum size of an IN list of numbers that is tested by comparing with each
+// value instead of a lookup in a hash table.
+constexpr int32_t kMaxSmallValues = 16;
+
 template <typename TInput>
 struct InFunctionOuter {
   template <typename TExecCtx>
@@ -85,6 +91,14 @@ struct InFunctionOuter {
         }
         elements_.emplace(entry.value());
       }
+
+      if constexpr (kHasSmallValues) {
+        if (elements_.size() <= kMaxSmallValues) {
+          for (const auto& element : elements_) {
+            smallValues_[numSmallValues_++] = element;
+          }
+        }
+      }
     }
 
     FOLLY_ALWAYS_INLINE bool callNullable(
@@ -95,7 +109,8 @@ struct InFunctionOuter {
         return false;
       }
 
-      result = elements_.contains(*searchTerm);
+      result = numSmallValues_ > 0 ? smallValuesContain(*searchTerm)
+                                   : elements_.contains(*searchTerm);
       if (hasNull_ && !result) {
         return false;
       }
@@ -103,8 +118,26 @@ struct InFunctionOuter {
     }
 
    private:
+    static constexpr bool kHasSmallValues =
+        std::is_arithmetic_v<TInput> && !std::is_same_v<TInput, bool>;
+
+    // Compares with all the values, without branches for integers.
+    bool smallValuesContain(const TInput& value) const {
+      bool found = false;
+      if constexpr (kHasSmallValues) {
+        for (auto i = 0; i < numSmallValues_; ++i) {
+          found |= Equal<TInput>()(value, smallValues_[i]);
+        }
+      }
+      return found;
+    }
+
     Set<TInput> elements_;
     bool hasNull_{false};
+
+    // Copy of 'elements_' if there are at most kMaxSmallValues numbers.
+    std::array<TInput, kHasSmallValues ? kMaxSmallValues : 0> smallValues_;
+    int32_t numSmallValues_{0};
   };
 
   template <typename T>
@@ -0,0 +1,128 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "velox/functions/sparksql/MightContain.h"
+
+#include "velox/common/base/BloomFilter.h"
+#include "velox/expression/DecodedArgs.h"
+#include "velox/vector/FlatVector.h"
+
+namespace facebook::velox::functions::sparksql {
+namespace {
+
+// Hashes values the same way as bloom_filter_agg.
+FOLLY_ALWAYS_INLINE uint64_t hashValue(int64_t value) {
+  return folly::hasher<uint64_t>()(value);
+}
+
+class MightContainFunction final : public exec::VectorFunction {
+ public:
+  // 'bloom' is set if the filter is a constant argument.
+  explicit MightContainFunction(std::optional<BloomFilter<false>> bloom)
+      : bloom_(std::move(bloom)) {}
+
+  void apply(
+      const SelectivityVector& rows,
+      std::vector<VectorPtr>& args,
+      const TypePtr& /* outputType */,
+      exec::EvalCtx* context,
+      VectorPtr* result) const final {
+    BaseVector::ensureWritable(rows, BOOLEAN(), context->pool(), result);
+    auto* flatResult = (*result)->asFlatVector<bool>();
+
+    if (!bloom_.has_value()) {
+      exec::DecodedArgs decodedArgs(rows, args, context);
+      auto* blooms = decodedArgs.at(0);
+      auto* values = decodedArgs.at(1);
+      BloomFilter<false> bloom;
+      rows.applyToSelected([&](vector_size_t row) {
+        auto serialized = blooms->valueAt<StringView>(row);
+        bloom.deserialize(serialized.data(), serialized.size());
+        flatResult->set(
+            row, bloom.mayContain(hashValue(values->valueAt<int64_t>(row))));
+      });
+      return;
+    }
+
+    if (args[1]->isFlatEncoding() && rows.isAllSelected()) {
+      mayContainBatch(
+          args[1]->asUnchecked<FlatVector<int64_t>>()->rawValues(),
+          rows.end(),
+          flatResult->mutableRawValues<uint64_t>());
+      return;
+    }
+
+    exec::LocalDecodedVector values(context, *args[1], rows);
+    rows.applyToSelected([&](vector_size_t row) {
+      flatResult->set(
+          row, bloom_->mayContain(hashValue(values->valueAt<int64_t>(row))));
+    });
+  }
+
+ private:
+  // Tests rows [0, numRows) of 'values' a SIMD batch at a time and sets the
+  // corresponding bits of 'rawResults'.
+  void mayContainBatch(
+      const int64_t* values,
+      vector_size_t numRows,
+      uint64_t* rawResults) const {
+    constexpr int32_t kBatchSize = xsimd::batch<int64_t>::size;
+    int64_t hashes[kBatchSize];
+    vector_size_t row = 0;
+    for (; row + kBatchSize <= numRows; row += kBatchSize) {
+      for (auto i = 0; i < kBatchSize; ++i) {
+        hashes[i] = hashValue(values[row + i]);
+      }
+      auto mask = simd::toBitMask(
+          bloom_->mayContain(xsimd::load_unaligned(hashes)));
+      for (auto i = 0; i < kBatchSize; ++i) {
+        bits::setBit(rawResults, row + i, mask & (1 << i));
+      }
+    }
+    for (; row < numRows; ++row) {
+      bits::setBit(
+          rawResults, row, bloom_->mayContain(hashValue(values[row])));
+    }
+  }
+
+  const std::optional<BloomFilter<false>> bloom_;
+};
+
+} // namespace
+
+std::vector<std::shared_ptr<exec::FunctionSignature>> mightContainSignatures() {
+  return {exec::FunctionSignatureBuilder()
+              .returnType("boolean")
+              .argumentType("varbinary")
+              .argumentType("bigint")
+              .build()};
+}
+
+std::shared_ptr<exec::VectorFunction> makeMightContain(
+    const std::string& /*name*/,
+    const std::vector<exec::VectorFunctionArg>& inputArgs) {
+  VELOX_CHECK_EQ(inputArgs.size(), 2);
+  std::optional<BloomFilter<false>> bloom;
+  const auto& constant = inputArgs[0].constantValue;
+  if (constant != nullptr && !constant->isNullAt(0)) {
+    auto serialized =
+        constant->as<ConstantVector<StringView>>()->valueAt(0);
+    bloom.emplace();
+    bloom->deserialize(serialized.data(), serialized.size());
+  }
+  return std::make_shared<MightContainFunction>(std::move(bloom));
+}
+
+} // namespace facebook::velox::functions::sparksql
@@ -26,6 +26,7 @@
 #include "velox/functions/sparksql/Hash.h"
 #include "velox/functions/sparksql/In.h"
 #include "velox/functions/sparksql/LeastGreatest.h"
+#include "velox/functions/sparksql/MightContain.h"
 #include "velox/functions/sparksql/RegexFunctions.h"
 #include "velox/functions/sparksql/RegisterArithmetic.h"
 #include "velox/functions/sparksql/RegisterCompare.h"
@@ -112,6 +113,10 @@ void registerFunctions(const std::string& prefix) {
   // Register 'in' functions.
   registerIn(prefix);
 
+  // Probe of the runtime join filters made by bloom_filter_agg.
+  exec::registerStatefulVectorFunction(
+      prefix + "might_contain", mightContainSignatures(), makeMightContain);
+
   // Compare nullsafe functions
   exec::registerStatefulVectorFunction(
       prefix + "equalnullsafe", equalNullSafeSignatures(), makeEqualNullSafe);
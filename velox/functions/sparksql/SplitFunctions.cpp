@@ -46,6 +46,9 @@ class SplitCharacter final : public exec::VectorFunction {
         /*estimatedNumElements=*/rows.countSelected() * 3,
         context->pool());
 
+    // Tokens of at most StringView::kInlineSize bytes are copied into the
+    // StringView and do not reference the input.
+    bool mustRefSourceStrings = false;
     rows.applyToSelected([&](vector_size_t row) {
       ArrayBuilder<Varchar>::Ref array = builder.startArray(row);
       const StringView& current = input->valueAt<StringView>(row);
@@ -55,12 +58,15 @@ class SplitCharacter final : public exec::VectorFunction {
       do {
         delim = std::find(pos, end, pattern_);
         array.emplace_back(pos, delim - pos);
+        mustRefSourceStrings |= !StringView::isInline(delim - pos);
         pos = delim + 1; // Skip past delim.
       } while (delim != end);
     });
     // Reference the input StringBuffers since we did not deep copy above.
-    builder.setStringBuffers(
-        args[0]->asFlatVector<StringView>()->stringBuffers());
+    // The input may be dictionary or constant encoded.
+    if (mustRefSourceStrings) {
+      builder.setStringBuffers(input->base());
+    }
     std::shared_ptr<ArrayVector> arrayVector =
         std::move(builder).finish(context->pool());
     context->moveOrCopyResult(arrayVector, rows, result);
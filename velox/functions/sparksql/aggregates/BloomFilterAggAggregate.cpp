@@ -0,0 +1,237 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "velox/functions/sparksql/aggregates/BloomFilterAggAggregate.h"
+
+#include "velox/common/base/BloomFilter.h"
+#include "velox/exec/Aggregate.h"
+#include "velox/expression/FunctionSignature.h"
+#include "velox/vector/DecodedVector.h"
+#include "velox/vector/FlatVector.h"
+
+namespace facebook::velox::functions::sparksql::aggregates {
+
+namespace {
+
+/// BloomFilterAggAggregate builds a BloomFilter over the non-null values of a
+/// bigint column for a group of rows. Spark uses it to build runtime filters
+/// for joins, which are probed with might_contain.
+/// Usage: bloom_filter_agg(expr [, estimatedNumItems [, numBits]])
+///
+/// 'estimatedNumItems' and 'numBits' must be constant. 'numBits' defaults to
+/// 8 bits per estimated item and is capped at kMaxNumBits. Values are hashed
+/// with folly::hasher<uint64_t>. The result and the intermediate result are
+/// the BloomFilter serialized as by BloomFilter::serialize(). Returns null for
+/// a group with no non-null values.
+class BloomFilterAggAggregate : public exec::Aggregate {
+ public:
+  explicit BloomFilterAggAggregate(const TypePtr& resultType)
+      : exec::Aggregate(resultType) {}
+
+  int32_t accumulatorFixedWidthSize() const override {
+    return sizeof(BloomFilter<false>);
+  }
+
+  bool accumulatorUsesExternalMemory() const override {
+    return true;
+  }
+
+  void initializeNewGroups(
+      char** groups,
+      folly::Range<const vector_size_t*> indices) override {
+    setAllNulls(groups, indices);
+    for (auto i : indices) {
+      new (groups[i] + offset_) BloomFilter<false>();
+    }
+  }
+
+  void addRawInput(
+      char** groups,
+      const SelectivityVector& rows,
+      const std::vector<VectorPtr>& args,
+      bool /*mayPushdown*/) override {
+    decodeArguments(rows, args);
+    rows.applyToSelected([&](vector_size_t row) {
+      if (decodedValue_.isNullAt(row)) {
+        return;
+      }
+      insert(groups[row], decodedValue_.valueAt<int64_t>(row));
+    });
+  }
+
+  void addIntermediateResults(
+      char** groups,
+      const SelectivityVector& rows,
+      const std::vector<VectorPtr>& args,
+      bool /*mayPushdown*/) override {
+    decodedIntermediate_.decode(*args[0], rows);
+    rows.applyToSelected([&](vector_size_t row) {
+      if (decodedIntermediate_.isNullAt(row)) {
+        return;
+      }
+      merge(groups[row], decodedIntermediate_.valueAt<StringView>(row));
+    });
+  }
+
+  void addSingleGroupRawInput(
+      char* group,
+      const SelectivityVector& rows,
+      const std::vector<VectorPtr>& args,
+      bool /*mayPushdown*/) override {
+    decodeArguments(rows, args);
+    rows.applyToSelected([&](vector_size_t row) {
+      if (decodedValue_.isNullAt(row)) {
+        return;
+      }
+      insert(group, decodedValue_.valueAt<int64_t>(row));
+    });
+  }
+
+  void addSingleGroupIntermediateResults(
+      char* group,
+      const SelectivityVector& rows,
+      const std::vector<VectorPtr>& args,
+      bool /*mayPushdown*/) override {
+    decodedIntermediate_.decode(*args[0], rows);
+    rows.applyToSelected([&](vector_size_t row) {
+      if (decodedIntermediate_.isNullAt(row)) {
+        return;
+      }
+      merge(group, decodedIntermediate_.valueAt<StringView>(row));
+    });
+  }
+
+  void extractValues(char** groups, int32_t numGroups, VectorPtr* result)
+      override {
+    extractAccumulators(groups, numGroups, result);
+  }
+
+  void extractAccumulators(char** groups, int32_t numGroups, VectorPtr* result)
+      override {
+    auto* flatResult = (*result)->asFlatVector<StringView>();
+    VELOX_CHECK_NOT_NULL(flatResult);
+    flatResult->resize(numGroups);
+
+    uint64_t* rawNulls = getRawNulls(flatResult);
+    for (auto i = 0; i < numGroups; ++i) {
+      char* group = groups[i];
+      if (isNull(group)) {
+        flatResult->setNull(i, true);
+        continue;
+      }
+      clearNull(rawNulls, i);
+      auto* bloom = value<BloomFilter<false>>(group);
+      auto size = bloom->serializedSize();
+      Buffer* buffer = flatResult->getBufferWithSpace(size);
+      char* serialized = buffer->asMutable<char>() + buffer->size();
+      bloom->serialize(serialized);
+      buffer->setSize(buffer->size() + size);
+      flatResult->setNoCopy(i, StringView(serialized, size));
+    }
+  }
+
+  void destroy(folly::Range<char**> groups) override {
+    for (auto group : groups) {
+      value<BloomFilter<false>>(group)->~BloomFilter<false>();
+    }
+  }
+
+  void finalize(char** /*groups*/, int32_t /*numGroups*/) override {}
+
+ private:
+  // Same as Spark's defaults for spark.sql.optimizer.runtime.bloomFilter.*.
+  static constexpr int64_t kDefaultExpectedNumItems = 1'000'000;
+  static constexpr int64_t kMaxNumBits = 67'108'864;
+
+  void decodeArguments(
+      const SelectivityVector& rows,
+      const std::vector<VectorPtr>& args) {
+    decodedValue_.decode(*args[0], rows);
+    int64_t expectedNumItems = kDefaultExpectedNumItems;
+    int64_t numBits = 0;
+    if (args.size() > 1) {
+      expectedNumItems = constantArgument(*args[1], rows, "estimatedNumItems");
+    }
+    if (args.size() > 2) {
+      numBits = constantArgument(*args[2], rows, "numBits");
+    } else {
+      numBits = expectedNumItems * 8;
+    }
+    VELOX_USER_CHECK_GT(numBits, 0, "numBits must be positive");
+    numBits = std::min(numBits, kMaxNumBits);
+    // BloomFilter::reset() allocates 16 bits per unit of capacity.
+    capacity_ = std::max<int64_t>(1, numBits / 16);
+  }
+
+  static int64_t constantArgument(
+      const BaseVector& arg,
+      const SelectivityVector& rows,
+      const char* name) {
+    DecodedVector decoded(arg, rows);
+    VELOX_USER_CHECK(
+        decoded.isConstantMapping() && !decoded.isNullAt(rows.begin()),
+        "{} argument of bloom_filter_agg must be a non-null constant",
+        name);
+    return decoded.valueAt<int64_t>(rows.begin());
+  }
+
+  void insert(char* group, int64_t value) {
+    clearNull(group);
+    auto* bloom = Aggregate::value<BloomFilter<false>>(group);
+    if (!bloom->isSet()) {
+      bloom->reset(capacity_);
+    }
+    bloom->insert(folly::hasher<uint64_t>()(value));
+  }
+
+  void merge(char* group, StringView serialized) {
+    clearNull(group);
+    value<BloomFilter<false>>(group)->merge(
+        serialized.data(), serialized.size());
+  }
+
+  DecodedVector decodedValue_;
+  DecodedVector decodedIntermediate_;
+  int64_t capacity_{0};
+};
+
+} // namespace
+
+bool registerBloomFilterAggAggregate(const std::string& name) {
+  std::vector<std::shared_ptr<exec::AggregateFunctionSignature>> signatures;
+  for (auto numArgs = 1; numArgs <= 3; ++numArgs) {
+    auto builder = exec::AggregateFunctionSignatureBuilder();
+    for (auto i = 0; i < numArgs; ++i) {
+      builder.argumentType("bigint");
+    }
+    signatures.push_back(builder.intermediateType("varbinary")
+                             .returnType("varbinary")
+                             .build());
+  }
+
+  return exec::registerAggregateFunction(
+      name,
+      std::move(signatures),
+      [name](
+          core::AggregationNode::Step /*step*/,
+          const std::vector<TypePtr>& argTypes,
+          const TypePtr& resultType) -> std::unique_ptr<exec::Aggregate> {
+        VELOX_CHECK_LE(
+            argTypes.size(), 3, "{} takes at most 3 arguments", name);
+        return std::make_unique<BloomFilterAggAggregate>(resultType);
+      });
+}
+
+} // namespace facebook::velox::functions::sparksql::aggregates
@@ -16,11 +16,13 @@
 
 #include "velox/functions/sparksql/aggregates/Register.h"
 
+#include "velox/functions/sparksql/aggregates/BloomFilterAggAggregate.h"
 #include "velox/functions/sparksql/aggregates/LastAggregate.h"
 
 namespace facebook::velox::functions::sparksql::aggregates {
 
 void registerAggregateFunctions(const std::string& prefix) {
   aggregates::registerLastAggregate(prefix + "last");
+  aggregates::registerBloomFilterAggAggregate(prefix + "bloom_filter_agg");
 }
 } // namespace facebook::velox::functions::sparksql::aggregates
@@ -0,0 +1,104 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <numeric>
+
+#include "velox/common/base/BloomFilter.h"
+#include "velox/functions/prestosql/aggregates/tests/AggregationTestBase.h"
+#include "velox/functions/sparksql/aggregates/Register.h"
+
+namespace facebook::velox::functions::sparksql::aggregates::test {
+
+namespace {
+
+class BloomFilterAggAggregateTest
+    : public aggregate::test::AggregationTestBase {
+ public:
+  BloomFilterAggAggregateTest() {
+    aggregates::registerAggregateFunctions("");
+    disableSpill();
+  }
+
+ protected:
+  // Returns the serialized BloomFilter that bloom_filter_agg makes for
+  // 'values' with 'numBits'.
+  static std::string makeSerialized(
+      const std::vector<int64_t>& values,
+      int64_t numBits) {
+    BloomFilter<false> bloom;
+    bloom.reset(std::max<int64_t>(1, numBits / 16));
+    for (auto value : values) {
+      bloom.insert(folly::hasher<uint64_t>()(value));
+    }
+    std::string serialized(bloom.serializedSize(), '\0');
+    bloom.serialize(serialized.data());
+    return serialized;
+  }
+};
+
+TEST_F(BloomFilterAggAggregateTest, groupBy) {
+  constexpr int32_t kSize = 1'000;
+  auto vectors = {makeRowVector({
+      makeFlatVector<int32_t>(kSize, [](auto row) { return row % 5; }),
+      // Group 0 has only nulls.
+      makeFlatVector<int64_t>(
+          kSize,
+          [](auto row) { return row * 7; },
+          [](auto row) { return row % 5 == 0; }),
+      makeConstant<int64_t>(100, kSize),
+      makeConstant<int64_t>(1'600, kSize),
+  })};
+
+  std::vector<std::vector<int64_t>> groupValues(5);
+  for (auto row = 0; row < kSize; ++row) {
+    if (row % 5 != 0) {
+      groupValues[row % 5].push_back(row * 7);
+    }
+  }
+
+  // 'numBits' defaults to 8 per estimated item.
+  for (auto [aggregate, numBits] :
+       std::vector<std::pair<std::string, int64_t>>{
+           {"bloom_filter_agg(c1, c2)", 800},
+           {"bloom_filter_agg(c1, c2, c3)", 1'600}}) {
+    std::vector<std::optional<std::string>> expectedFilters{std::nullopt};
+    for (auto group = 1; group < 5; ++group) {
+      expectedFilters.push_back(makeSerialized(groupValues[group], numBits));
+    }
+    auto expected = {makeRowVector({
+        makeFlatVector<int32_t>({0, 1, 2, 3, 4}),
+        makeNullableFlatVector<std::string>(expectedFilters, VARBINARY()),
+    })};
+    testAggregations(vectors, {"c0"}, {aggregate}, expected);
+  }
+}
+
+TEST_F(BloomFilterAggAggregateTest, global) {
+  constexpr int32_t kSize = 1'000;
+  auto vectors = {makeRowVector({
+      makeFlatVector<int64_t>(kSize, [](auto row) { return row; }),
+      makeConstant<int64_t>(kSize, kSize),
+  })};
+
+  std::vector<int64_t> values(kSize);
+  std::iota(values.begin(), values.end(), 0);
+  auto expected = {makeRowVector({makeNullableFlatVector<std::string>(
+      {makeSerialized(values, kSize * 8)}, VARBINARY())})};
+  testAggregations(vectors, {}, {"bloom_filter_agg(c0, c1)"}, expected);
+}
+
+} // namespace
+} // namespace facebook::velox::functions::sparksql::aggregates::test
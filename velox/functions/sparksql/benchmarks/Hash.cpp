@@ -0,0 +1,104 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include <fmt/format.h>
+#include <folly/Benchmark.h>
+#include <folly/init/Init.h>
+
+#include "velox/functions/lib/benchmarks/FunctionBenchmarkBase.h"
+#include "velox/functions/sparksql/Register.h"
+#include "velox/vector/fuzzer/VectorFuzzer.h"
+
+namespace facebook::velox::functions::sparksql {
+namespace {
+
+// Returns the number of bytes of input hashed, so that the reported iters/s
+// is the throughput in bytes per second.
+unsigned hashColumns(
+    unsigned iters,
+    const std::vector<TypePtr>& types,
+    bool wrapInDictionary) {
+  folly::BenchmarkSuspender suspender;
+  test::FunctionBenchmarkBase benchmarkBase;
+
+  VectorFuzzer::Options opts;
+  opts.vectorSize = 10'000;
+  opts.nullRatio = 0;
+  VectorFuzzer fuzzer(opts, benchmarkBase.pool());
+
+  std::vector<VectorPtr> columns;
+  std::string exprStr = "hash(";
+  int64_t bytesPerRow = 0;
+  for (auto i = 0; i < types.size(); ++i) {
+    auto column = fuzzer.fuzzFlat(types[i]);
+    if (wrapInDictionary) {
+      column = fuzzer.fuzzDictionary(column);
+    }
+    columns.push_back(column);
+    exprStr += fmt::format("{}c{}", i > 0 ? ", " : "", i);
+    bytesPerRow += types[i]->cppSizeInBytes();
+  }
+  exprStr += ")";
+  auto data = benchmarkBase.maker().rowVector(columns);
+  auto exprSet = benchmarkBase.compileExpression(exprStr, data->type());
+  suspender.dismiss();
+
+  for (auto i = 0; i < iters; ++i) {
+    benchmarkBase.evaluate(exprSet, data);
+  }
+  return iters * opts.vectorSize * bytesPerRow;
+}
+
+BENCHMARK_MULTI(intFlat, n) {
+  return hashColumns(n, {INTEGER()}, false);
+}
+
+BENCHMARK_RELATIVE_MULTI(intDictionary, n) {
+  return hashColumns(n, {INTEGER()}, true);
+}
+
+BENCHMARK_MULTI(bigintFlat, n) {
+  return hashColumns(n, {BIGINT()}, false);
+}
+
+BENCHMARK_RELATIVE_MULTI(bigintDictionary, n) {
+  return hashColumns(n, {BIGINT()}, true);
+}
+
+BENCHMARK_MULTI(realFlat, n) {
+  return hashColumns(n, {REAL()}, false);
+}
+
+BENCHMARK_RELATIVE_MULTI(realDictionary, n) {
+  return hashColumns(n, {REAL()}, true);
+}
+
+BENCHMARK_MULTI(fourColumnsFlat, n) {
+  return hashColumns(n, {INTEGER(), BIGINT(), INTEGER(), DOUBLE()}, false);
+}
+
+BENCHMARK_RELATIVE_MULTI(fourColumnsDictionary, n) {
+  return hashColumns(n, {INTEGER(), BIGINT(), INTEGER(), DOUBLE()}, true);
+}
+
+} // namespace
+} // namespace facebook::velox::functions::sparksql
+
+int main(int argc, char** argv) {
+  folly::init(&argc, &argv);
+  facebook::velox::functions::sparksql::registerFunctions("");
+  folly::runBenchmarks();
+  return 0;
+}
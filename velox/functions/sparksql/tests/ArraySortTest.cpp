@@ -52,6 +52,42 @@ class ArraySortTest : public SparkFunctionBaseTest {
     auto expected = makeNullableArrayVector(floatingPointAscNullLargest<T>());
     testArraySort(input, expected);
   }
+
+  // Arrays of sizes around the limits of the sorting network and the radix
+  // sort, with nulls, duplicates and values that differ in several bytes.
+  template <typename T>
+  void testSizes() {
+    std::vector<std::vector<std::optional<T>>> input;
+    std::vector<std::vector<std::optional<T>>> ascending;
+    std::vector<std::vector<std::optional<T>>> descending;
+    for (auto size : {0, 1, 2, 5, 16, 17, 100, 255, 256, 1'000}) {
+      std::vector<std::optional<T>> values;
+      for (auto i = 0; i < size; ++i) {
+        if (i % 11 == 3) {
+          values.push_back(std::nullopt);
+        } else {
+          values.push_back(static_cast<T>(
+              (i * 7'919 % 1'001 - 500) * (i % 3 == 0 ? 1 : 1'000'003)));
+        }
+      }
+      input.push_back(values);
+      std::sort(values.begin(), values.end(), [](auto& a, auto& b) {
+        return a.has_value() && (!b.has_value() || a.value() < b.value());
+      });
+      ascending.push_back(values);
+      // Nulls stay last in sort_array() with descending order.
+      std::sort(values.begin(), values.end(), [](auto& a, auto& b) {
+        return a.has_value() && (!b.has_value() || a.value() > b.value());
+      });
+      descending.push_back(values);
+    }
+    auto inputVector = makeNullableArrayVector(input);
+    testArraySort(inputVector, makeNullableArrayVector(ascending));
+    assertEqualVectors(
+        makeNullableArrayVector(descending),
+        evaluate<ArrayVector>(
+            "sort_array(c0, false)", makeRowVector({inputVector})));
+  }
 };
 
 TEST_F(ArraySortTest, int8) {
@@ -70,6 +106,14 @@ TEST_F(ArraySortTest, int64) {
   testInt<int64_t>();
 }
 
+TEST_F(ArraySortTest, sizes) {
+  testSizes<int8_t>();
+  testSizes<int16_t>();
+  testSizes<int32_t>();
+  testSizes<int64_t>();
+  testSizes<double>();
+}
+
 TEST_F(ArraySortTest, float) {
   testFloatingPoint<float>();
 }
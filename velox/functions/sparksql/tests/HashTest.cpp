@@ -113,5 +113,36 @@ TEST_F(HashTest, Float) {
   EXPECT_EQ(hash<float>(-limits::infinity()), 427440766);
 }
 
+TEST_F(HashTest, flatColumns) {
+  // Flat columns without nulls are hashed a column at a time. Compare with
+  // the row by row results for the same columns wrapped in dictionaries.
+  const vector_size_t size = 1'000;
+  auto data = makeRowVector({
+      makeFlatVector<int8_t>(size, [](auto row) { return row; }),
+      makeFlatVector<int16_t>(size, [](auto row) { return row * 7; }),
+      makeFlatVector<int32_t>(size, [](auto row) { return row * 1'001; }),
+      makeFlatVector<int64_t>(
+          size, [](auto row) { return static_cast<int64_t>(row) << 35; }),
+      makeFlatVector<float>(
+          size, [](auto row) { return row % 3 == 0 ? -0.0f : row * 0.1f; }),
+      makeFlatVector<double>(
+          size, [](auto row) { return row % 5 == 0 ? -0.0 : row * 0.1; }),
+  });
+
+  std::vector<VectorPtr> wrappedChildren;
+  auto indices = makeIndices(size, [](auto row) { return row; });
+  for (auto& child : data->children()) {
+    wrappedChildren.push_back(wrapInDictionary(indices, size, child));
+  }
+  auto wrapped = makeRowVector(wrappedChildren);
+
+  for (auto& expr :
+       {"hash(c2)", "hash(c4)", "hash(c0, c1, c2, c3, c4, c5)"}) {
+    auto expected = evaluate<SimpleVector<int32_t>>(expr, wrapped);
+    auto result = evaluate<SimpleVector<int32_t>>(expr, data);
+    assertEqualVectors(expected, result);
+  }
+}
+
 } // namespace
 } // namespace facebook::velox::functions::sparksql::test
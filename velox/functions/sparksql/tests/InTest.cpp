@@ -136,6 +136,28 @@ TEST_F(InTest, Int64) {
   EXPECT_EQ(in<int64_t>(std::nullopt, {1, std::nullopt, 2}), std::nullopt);
 }
 
+TEST_F(InTest, LongList) {
+  // Lists of up to 16 numbers are scanned, longer ones use a hash table.
+  std::vector<std::optional<int64_t>> values;
+  for (auto i = 0; i < 20; ++i) {
+    values.push_back(i * 7);
+  }
+  EXPECT_EQ(in<int64_t>(0, values), true);
+  EXPECT_EQ(in<int64_t>(133, values), true);
+  EXPECT_EQ(in<int64_t>(134, values), false);
+  values.push_back(std::nullopt);
+  EXPECT_EQ(in<int64_t>(70, values), true);
+  EXPECT_EQ(in<int64_t>(71, values), std::nullopt);
+
+  std::vector<std::optional<double>> doubles{kNan};
+  for (auto i = 0; i < 20; ++i) {
+    doubles.push_back(i * 0.5);
+  }
+  EXPECT_EQ(in<double>(kNan, doubles), true);
+  EXPECT_EQ(in<double>(9.5, doubles), true);
+  EXPECT_EQ(in<double>(kInf, doubles), false);
+}
+
 TEST_F(InTest, Float) {
   EXPECT_EQ(in<float>(1.0, {-1.0, 1.0, 2.0}), true);
   EXPECT_EQ(in<float>(0, {-1.0, 1.0}), false);
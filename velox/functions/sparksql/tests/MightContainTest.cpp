@@ -0,0 +1,110 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "velox/common/base/BloomFilter.h"
+#include "velox/core/Expressions.h"
+#include "velox/functions/sparksql/tests/SparkFunctionBaseTest.h"
+
+namespace facebook::velox::functions::sparksql::test {
+namespace {
+
+class MightContainTest : public SparkFunctionBaseTest {
+ protected:
+  // Returns a serialized BloomFilter with 'values', hashed the same way as
+  // bloom_filter_agg.
+  static std::string makeSerialized(const std::vector<int64_t>& values) {
+    BloomFilter<false> bloom;
+    bloom.reset(values.size());
+    for (auto value : values) {
+      bloom.insert(folly::hasher<uint64_t>()(value));
+    }
+    std::string serialized(bloom.serializedSize(), '\0');
+    bloom.serialize(serialized.data());
+    return serialized;
+  }
+
+  // Evaluates might_contain with 'serialized' as a constant first argument
+  // and 'c0' of 'data' as the second.
+  VectorPtr mightContainConstant(
+      const std::string& serialized,
+      const RowVectorPtr& data) {
+    auto expr = std::make_shared<core::CallTypedExpr>(
+        BOOLEAN(),
+        std::vector<core::TypedExprPtr>{
+            std::make_shared<core::ConstantTypedExpr>(
+                VARBINARY(), variant::binary(serialized)),
+            std::make_shared<core::FieldAccessTypedExpr>(BIGINT(), "c0")},
+        "might_contain");
+    return evaluate(expr, data);
+  }
+};
+
+TEST_F(MightContainTest, basic) {
+  constexpr int32_t kSize = 1'000;
+  std::vector<int64_t> values(kSize);
+  for (auto i = 0; i < kSize; ++i) {
+    values[i] = i * 2;
+  }
+  auto serialized = makeSerialized(values);
+
+  // Flat input without nulls takes the SIMD path. Odd numbers are not in the
+  // filter.
+  auto probe =
+      makeFlatVector<int64_t>(2 * kSize, [](auto row) { return row; });
+  auto flatResult = mightContainConstant(serialized, makeRowVector({probe}))
+                        ->asFlatVector<bool>();
+  int32_t numFalsePositives = 0;
+  for (auto row = 0; row < 2 * kSize; ++row) {
+    if (row % 2 == 0) {
+      ASSERT_TRUE(flatResult->valueAt(row)) << row;
+    } else {
+      numFalsePositives += flatResult->valueAt(row);
+    }
+  }
+  EXPECT_GT(5, 100 * numFalsePositives / kSize);
+
+  // Dictionary encoded input with nulls is probed a row at a time and must
+  // give the same answers.
+  auto indices = makeIndices(2 * kSize, [](auto row) { return row; });
+  auto dictionary = BaseVector::wrapInDictionary(
+      makeNulls(2 * kSize, nullEvery(7)), indices, 2 * kSize, probe);
+  auto result = mightContainConstant(serialized, makeRowVector({dictionary}));
+  for (auto row = 0; row < 2 * kSize; ++row) {
+    if (row % 7 == 0) {
+      ASSERT_TRUE(result->isNullAt(row)) << row;
+    } else {
+      ASSERT_EQ(
+          flatResult->valueAt(row),
+          result->as<SimpleVector<bool>>()->valueAt(row))
+          << row;
+    }
+  }
+
+  // A non-constant filter is deserialized per row.
+  auto filters = makeNullableFlatVector<std::string>(
+      std::vector<std::optional<std::string>>(2 * kSize, serialized),
+      VARBINARY());
+  result = evaluate("might_contain(c1, c0)", makeRowVector({probe, filters}));
+  for (auto row = 0; row < 2 * kSize; ++row) {
+    ASSERT_EQ(
+        flatResult->valueAt(row),
+        result->as<SimpleVector<bool>>()->valueAt(row))
+        << row;
+  }
+}
+
+} // namespace
+} // namespace facebook::velox::functions::sparksql::test
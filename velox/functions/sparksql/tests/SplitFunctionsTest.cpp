@@ -105,5 +105,20 @@ TEST_F(SplitTest, LongStrings) {
       {{{"abcdefghijklkmnopqrstuvwxyz"}}});
 }
 
+TEST_F(SplitTest, dictionaryInput) {
+  auto strings = makeFlatVector<std::string>(
+      {"a:b", "this is a long token:c", "d:and another long token"});
+  auto indices = makeIndices(4, [](auto row) { return 2 - row % 3; });
+  auto input = wrapInDictionary(indices, 4, strings);
+  auto result = evaluate<ArrayVector>("split(c0, ':')", makeRowVector({input}));
+  auto expected = makeArrayVector<StringView>({
+      {"d", "and another long token"},
+      {"this is a long token", "c"},
+      {"a", "b"},
+      {"d", "and another long token"},
+  });
+  assertEqualVectors(expected, result);
+}
+
 } // namespace
 } // namespace facebook::velox::functions::sparksql::test
@@ -0,0 +1,385 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "velox/row/UnsafeRowColumnarSerializer.h"
+#include "velox/row/UnsafeRow.h"
+#include "velox/row/UnsafeRowDynamicSerializer.h"
+
+namespace facebook::velox::row {
+namespace {
+
+constexpr size_t kWordSize = UnsafeRow::kFieldWidthBytes;
+
+size_t align(size_t size) {
+  return UnsafeRow::alignToFieldWidth(size);
+}
+
+bool isStringKind(TypeKind kind) {
+  return kind == TypeKind::VARCHAR || kind == TypeKind::VARBINARY;
+}
+
+void checkSupported(const TypePtr& type) {
+  switch (type->kind()) {
+    case TypeKind::BOOLEAN:
+    case TypeKind::TINYINT:
+    case TypeKind::SMALLINT:
+    case TypeKind::INTEGER:
+    case TypeKind::BIGINT:
+    case TypeKind::REAL:
+    case TypeKind::DOUBLE:
+    case TypeKind::TIMESTAMP:
+    case TypeKind::DATE:
+    case TypeKind::VARCHAR:
+    case TypeKind::VARBINARY:
+      return;
+    case TypeKind::ARRAY:
+    case TypeKind::MAP:
+    case TypeKind::ROW:
+      for (auto i = 0; i < type->size(); ++i) {
+        checkSupported(type->childAt(i));
+      }
+      return;
+    default:
+      VELOX_UNSUPPORTED(
+          "UnsafeRow serialization of {} is not supported", type->toString());
+  }
+}
+
+// The functions below return the sizes UnsafeRowDynamicSerializer returns for
+// nested values. These are not always the number of bytes written. E.g. the
+// size of an array of fixed width elements includes a word more than is
+// written. They must match, since they determine the offsets of the values
+// that follow.
+
+// Returns true if UnsafeRowDynamicSerializer writes the value at 'index' of
+// 'vector' as a null.
+bool isNullValue(const BaseVector& vector, vector_size_t index) {
+  if (vector.type()->isPrimitiveType()) {
+    return vector.loadedVector()->isNullAt(index);
+  }
+  return vector.wrappedVector()->isNullAt(vector.wrappedIndex(index));
+}
+
+size_t variableSize(
+    const TypePtr& type,
+    const BaseVector& vector,
+    vector_size_t index);
+
+size_t arraySize(
+    const TypePtr& elementType,
+    vector_size_t offset,
+    vector_size_t size,
+    const BaseVector& elements) {
+  // The array starts with the number of elements, followed by the null bits.
+  const size_t nullLength = UnsafeRow::getNullLength(size);
+  size_t dataSize;
+  if (elementType->isFixedWidth()) {
+    dataSize =
+        kWordSize + align(size * elementType->cppSizeInBytes() + nullLength);
+  } else {
+    size_t end = kWordSize + nullLength + size * kWordSize;
+    for (auto i = 0; i < size; ++i) {
+      end = align(end);
+      if (!isNullValue(elements, offset + i)) {
+        end += variableSize(elementType, elements, offset + i);
+      }
+    }
+    dataSize = align(end) - kWordSize;
+  }
+  return align(kWordSize + dataSize);
+}
+
+size_t rowSize(const RowType& type, const RowVector& row, vector_size_t index) {
+  const auto numFields = type.size();
+  size_t end = UnsafeRow::getNullLength(numFields) + numFields * kWordSize;
+  for (auto i = 0; i < numFields; ++i) {
+    end = align(end);
+    const auto& fieldType = type.childAt(i);
+    const auto& field = *row.childAt(i);
+    if (!fieldType->isFixedWidth() && !isNullValue(field, index)) {
+      end += variableSize(fieldType, field, index);
+    }
+  }
+  return end;
+}
+
+// Returns the size of the non-null value at 'index' of 'vector' of 'type'.
+size_t variableSize(
+    const TypePtr& type,
+    const BaseVector& vector,
+    vector_size_t index) {
+  switch (type->kind()) {
+    case TypeKind::VARCHAR:
+    case TypeKind::VARBINARY:
+      return vector.loadedVector()
+          ->asUnchecked<SimpleVector<StringView>>()
+          ->valueAt(index)
+          .size();
+    case TypeKind::ARRAY: {
+      auto* array = vector.wrappedVector()->asUnchecked<ArrayVector>();
+      auto wrappedIndex = vector.wrappedIndex(index);
+      return arraySize(
+          type->childAt(0),
+          array->offsetAt(wrappedIndex),
+          array->sizeAt(wrappedIndex),
+          *array->elements());
+    }
+    case TypeKind::MAP: {
+      auto* map = vector.wrappedVector()->asUnchecked<MapVector>();
+      auto wrappedIndex = vector.wrappedIndex(index);
+      auto offset = map->offsetAt(wrappedIndex);
+      auto size = map->sizeAt(wrappedIndex);
+      // The size of the keys, then the keys and the values as arrays.
+      return kWordSize +
+          arraySize(type->childAt(0), offset, size, *map->mapKeys()) +
+          arraySize(type->childAt(1), offset, size, *map->mapValues());
+    }
+    case TypeKind::ROW:
+      return rowSize(
+          type->asRow(),
+          *vector.wrappedVector()->asUnchecked<RowVector>(),
+          vector.wrappedIndex(index));
+    default:
+      return 0;
+  }
+}
+
+template <TypeKind Kind>
+void writeFixedWidthValues(
+    const DecodedVector& decoded,
+    column_index_t column,
+    size_t slotOffset,
+    char* const* rows,
+    vector_size_t numRows) {
+  using T = typename TypeTraits<Kind>::NativeType;
+  for (vector_size_t row = 0; row < numRows; ++row) {
+    auto* data = rows[row];
+    if (!data) {
+      continue;
+    }
+    // Null values and the unused high bytes of the slot are zero.
+    uint64_t word = 0;
+    if (decoded.isNullAt(row)) {
+      bits::setBit(reinterpret_cast<uint64_t*>(data), column);
+    } else if constexpr (Kind == TypeKind::TIMESTAMP) {
+      word = decoded.valueAt<Timestamp>(row).toMicros();
+    } else {
+      static_assert(sizeof(T) <= sizeof(word));
+      auto value = decoded.valueAt<T>(row);
+      memcpy(&word, &value, sizeof(T));
+    }
+    *reinterpret_cast<uint64_t*>(data + slotOffset) = word;
+  }
+}
+
+} // namespace
+
+UnsafeRowColumnarSerializer::UnsafeRowColumnarSerializer(
+    const RowVectorPtr& input)
+    : input_(input),
+      numColumns_(input->childrenSize()),
+      fixedSize_(
+          UnsafeRow::getNullLength(numColumns_) + numColumns_ * kWordSize) {
+  const auto numRows = input_->size();
+  SelectivityVector allRows(numRows);
+  decoded_.resize(numColumns_);
+  for (auto i = 0; i < numColumns_; ++i) {
+    checkSupported(input_->type()->childAt(i));
+    decoded_[i].decode(*input_->childAt(i), allRows);
+  }
+
+  offsets_.resize(numRows);
+  for (auto row = 0; row < numRows; ++row) {
+    offsets_[row] = input_->isNullAt(row) ? 0 : fixedSize_;
+  }
+  for (auto i = 0; i < numColumns_; ++i) {
+    if (!input_->type()->childAt(i)->isFixedWidth()) {
+      addColumnSizes(i);
+    }
+  }
+
+  rowSizes_ = offsets_;
+  for (auto size : rowSizes_) {
+    totalSize_ += align(size);
+  }
+}
+
+void UnsafeRowColumnarSerializer::addColumnSizes(column_index_t column) {
+  const auto& type = input_->type()->childAt(column);
+  const auto& decoded = decoded_[column];
+  const auto numRows = input_->size();
+  if (isStringKind(type->kind())) {
+    for (auto row = 0; row < numRows; ++row) {
+      if (offsets_[row] == 0) {
+        continue;
+      }
+      offsets_[row] = align(offsets_[row]);
+      if (!decoded.isNullAt(row)) {
+        offsets_[row] += decoded.valueAt<StringView>(row).size();
+      }
+    }
+    return;
+  }
+  // Nulls of complex values are those of the wrapped vector, as in
+  // UnsafeRowDynamicSerializer.
+  const auto& vector = *input_->childAt(column);
+  for (auto row = 0; row < numRows; ++row) {
+    if (offsets_[row] == 0) {
+      continue;
+    }
+    offsets_[row] = align(offsets_[row]);
+    if (!isNullValue(vector, row)) {
+      offsets_[row] += variableSize(type, vector, row);
+    }
+  }
+}
+
+std::vector<std::optional<std::string_view>>
+UnsafeRowColumnarSerializer::serialize(char* buffer) {
+  VELOX_CHECK_EQ(reinterpret_cast<uintptr_t>(buffer) % kWordSize, 0);
+  const auto numRows = input_->size();
+  bool hasComplexColumn = false;
+  for (auto i = 0; i < numColumns_; ++i) {
+    auto kind = input_->type()->childAt(i)->kind();
+    hasComplexColumn |= !isStringKind(kind) &&
+        !input_->type()->childAt(i)->isFixedWidth();
+  }
+  if (hasComplexColumn) {
+    // UnsafeRowDynamicSerializer does not write padding.
+    memset(buffer, 0, totalSize_);
+  }
+
+  std::vector<std::optional<std::string_view>> result(numRows);
+  std::vector<char*> rows(numRows, nullptr);
+  const size_t nullLength = UnsafeRow::getNullLength(numColumns_);
+  size_t offset = 0;
+  for (auto row = 0; row < numRows; ++row) {
+    if (rowSizes_[row] == 0) {
+      continue;
+    }
+    rows[row] = buffer + offset;
+    result[row] = std::string_view(rows[row], rowSizes_[row]);
+    memset(rows[row], 0, nullLength);
+    offsets_[row] = fixedSize_;
+    offset += align(rowSizes_[row]);
+  }
+
+  for (auto i = 0; i < numColumns_; ++i) {
+    const auto& type = input_->type()->childAt(i);
+    if (type->isFixedWidth()) {
+      writeFixedWidthColumn(i, rows.data());
+    } else if (isStringKind(type->kind())) {
+      writeStringColumn(i, rows.data());
+    } else {
+      writeComplexColumn(i, rows.data());
+    }
+  }
+
+  for (auto row = 0; row < numRows; ++row) {
+    VELOX_DCHECK_EQ(offsets_[row], rowSizes_[row]);
+  }
+  return result;
+}
+
+void UnsafeRowColumnarSerializer::writeFixedWidthColumn(
+    column_index_t column,
+    char* const* rows) {
+  const auto& decoded = decoded_[column];
+  const auto slotOffset =
+      UnsafeRow::getNullLength(numColumns_) + column * kWordSize;
+  const auto numRows = input_->size();
+  switch (input_->type()->childAt(column)->kind()) {
+#define WRITE_FIXED_WIDTH(kind)                           \
+  case TypeKind::kind:                                    \
+    writeFixedWidthValues<TypeKind::kind>(                \
+        decoded, column, slotOffset, rows, numRows);      \
+    break;
+    WRITE_FIXED_WIDTH(BOOLEAN);
+    WRITE_FIXED_WIDTH(TINYINT);
+    WRITE_FIXED_WIDTH(SMALLINT);
+    WRITE_FIXED_WIDTH(INTEGER);
+    WRITE_FIXED_WIDTH(BIGINT);
+    WRITE_FIXED_WIDTH(REAL);
+    WRITE_FIXED_WIDTH(DOUBLE);
+    WRITE_FIXED_WIDTH(TIMESTAMP);
+    WRITE_FIXED_WIDTH(DATE);
+#undef WRITE_FIXED_WIDTH
+    default:
+      VELOX_UNREACHABLE();
+  }
+}
+
+void UnsafeRowColumnarSerializer::writeStringColumn(
+    column_index_t column,
+    char* const* rows) {
+  const auto& decoded = decoded_[column];
+  const auto slotOffset =
+      UnsafeRow::getNullLength(numColumns_) + column * kWordSize;
+  const auto numRows = input_->size();
+  for (auto row = 0; row < numRows; ++row) {
+    auto* data = rows[row];
+    if (!data) {
+      continue;
+    }
+    uint64_t word = 0;
+    auto offset = align(offsets_[row]);
+    if (decoded.isNullAt(row)) {
+      bits::setBit(reinterpret_cast<uint64_t*>(data), column);
+    } else {
+      auto value = decoded.valueAt<StringView>(row);
+      word = offset << 32 | value.size();
+      if (value.size() % kWordSize != 0) {
+        // Zeroes the padding after the string.
+        *reinterpret_cast<uint64_t*>(
+            data + offset + align(value.size()) - kWordSize) = 0;
+      }
+      memcpy(data + offset, value.data(), value.size());
+      offset += value.size();
+    }
+    *reinterpret_cast<uint64_t*>(data + slotOffset) = word;
+    offsets_[row] = offset;
+  }
+}
+
+void UnsafeRowColumnarSerializer::writeComplexColumn(
+    column_index_t column,
+    char* const* rows) {
+  const auto& type = input_->type()->childAt(column);
+  const auto& vector = input_->childAt(column);
+  const auto slotOffset =
+      UnsafeRow::getNullLength(numColumns_) + column * kWordSize;
+  const auto numRows = input_->size();
+  for (auto row = 0; row < numRows; ++row) {
+    auto* data = rows[row];
+    if (!data) {
+      continue;
+    }
+    uint64_t word = 0;
+    auto offset = align(offsets_[row]);
+    auto size =
+        UnsafeRowDynamicSerializer::serialize(type, vector, data + offset, row);
+    if (!size.has_value()) {
+      bits::setBit(reinterpret_cast<uint64_t*>(data), column);
+    } else {
+      word = offset << 32 | size.value();
+      offset += size.value();
+    }
+    *reinterpret_cast<uint64_t*>(data + slotOffset) = word;
+    offsets_[row] = offset;
+  }
+}
+
+} // namespace facebook::velox::row
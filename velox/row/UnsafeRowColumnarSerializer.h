@@ -0,0 +1,78 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include "velox/vector/ComplexVector.h"
+#include "velox/vector/DecodedVector.h"
+
+namespace facebook::velox::row {
+
+/// Serializes the rows of a RowVector to UnsafeRows a column at a time. The
+/// sizes of all rows are computed first. Then each column is written to all
+/// rows in one loop. The bytes of each row are the same as those written by
+/// UnsafeRowDynamicSerializer::serialize() for the row, except that bytes
+/// the latter leaves unwritten, e.g. the padding after strings, are zero.
+///
+/// Columns of primitive types are written without per row type dispatch.
+/// Values of ARRAY, MAP and ROW columns are written with
+/// UnsafeRowDynamicSerializer.
+class UnsafeRowColumnarSerializer {
+ public:
+  explicit UnsafeRowColumnarSerializer(const RowVectorPtr& input);
+
+  /// Returns the serialized size of 'row'. 0 if 'row' is null.
+  size_t rowSize(vector_size_t row) const {
+    return rowSizes_[row];
+  }
+
+  /// Returns the size of the buffer for serialize().
+  size_t totalSize() const {
+    return totalSize_;
+  }
+
+  /// Writes the rows back to back to 'buffer', each at an 8 byte aligned
+  /// offset. 'buffer' must be 8 byte aligned and have totalSize() bytes.
+  /// Returns the serialized rows, std::nullopt for a null row.
+  std::vector<std::optional<std::string_view>> serialize(char* buffer);
+
+ private:
+  // Advances 'offsets_' past the values of 'column' in each row, as
+  // serialize() does when writing them.
+  void addColumnSizes(column_index_t column);
+
+  void writeFixedWidthColumn(column_index_t column, char* const* rows);
+
+  void writeStringColumn(column_index_t column, char* const* rows);
+
+  void writeComplexColumn(column_index_t column, char* const* rows);
+
+  const RowVectorPtr input_;
+  const size_t numColumns_;
+
+  // Size of the null bits and fixed width slots of each row.
+  const size_t fixedSize_;
+
+  std::vector<DecodedVector> decoded_;
+  std::vector<size_t> rowSizes_;
+  size_t totalSize_{0};
+
+  // Offset of the end of the variable width data in each row, relative to
+  // the start of the row.
+  std::vector<size_t> offsets_;
+};
+
+} // namespace facebook::velox::row
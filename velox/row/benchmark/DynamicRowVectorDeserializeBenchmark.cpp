@@ -18,7 +18,9 @@
 #include <folly/init/Init.h>
 #include <random>
 
+#include "velox/row/UnsafeRow24Deserializer.h"
 #include "velox/row/UnsafeRowBatchDeserializer.h"
+#include "velox/row/UnsafeRowColumnarSerializer.h"
 #include "velox/row/UnsafeRowDeserializer.h"
 #include "velox/row/UnsafeRowDynamicSerializer.h"
 #include "velox/type/Type.h"
@@ -72,11 +74,61 @@ class UnsaferowBatchDeserializer : public Deserializer {
       memory::getDefaultScopedMemoryPool();
 };
 
+// Deserializes a column at a time into flat vectors.
+class UnsaferowColumnarDeserializer : public Deserializer {
+ public:
+  UnsaferowColumnarDeserializer() {}
+
+  void deserialize(
+      const std::vector<std::optional<std::string_view>>& data,
+      const TypePtr& type) override {
+    std::vector<const char*> rows(data.size());
+    for (auto i = 0; i < data.size(); ++i) {
+      rows[i] = data[i].has_value() ? data[i]->data() : nullptr;
+    }
+    UnsafeRow24Deserializer::Create(asRowType(type))
+        ->DeserializeRows(pool_.get(), rows);
+  }
+
+ private:
+  std::unique_ptr<memory::ScopedMemoryPool> pool_ =
+      memory::getDefaultScopedMemoryPool();
+};
+
 class BenchmarkHelper {
  public:
   std::tuple<std::vector<std::optional<std::string_view>>, TypePtr>
   randomUnsaferows(int nFields, int nRows, bool stringOnly) {
-    RowTypePtr rowType;
+    auto rowType = randomRowType(nFields, stringOnly);
+    VectorFuzzer fuzzer(fuzzerOptions(1), pool_.get(), folly::Random::rand32());
+    const auto& inputVector = fuzzer.fuzzRow(rowType);
+    std::vector<std::optional<std::string_view>> results;
+    results.reserve(nRows);
+    // Serialize rowVector into bytes.
+    for (int32_t i = 0; i < nRows; ++i) {
+      BufferPtr bufferPtr =
+          AlignedBuffer::allocate<char>(1024, pool_.get(), true);
+      char* buffer = bufferPtr->asMutable<char>();
+      auto rowSize = UnsafeRowDynamicSerializer::serialize(
+          rowType, inputVector, buffer, /*idx=*/0);
+      results.push_back(std::string_view(buffer, rowSize.value()));
+      buffers_.push_back(std::move(bufferPtr));
+    }
+    return {results, rowType};
+  }
+
+  RowVectorPtr randomRowVector(int nFields, int nRows, bool stringOnly) {
+    VectorFuzzer fuzzer(
+        fuzzerOptions(nRows), pool_.get(), folly::Random::rand32());
+    return fuzzer.fuzzRow(randomRowType(nFields, stringOnly));
+  }
+
+  memory::MemoryPool* pool() {
+    return pool_.get();
+  }
+
+ private:
+  RowTypePtr randomRowType(int nFields, bool stringOnly) {
     std::vector<std::string> names;
     std::vector<TypePtr> types;
     names.reserve(nFields);
@@ -90,35 +142,21 @@ class BenchmarkHelper {
         types.push_back(allTypes_[idx]);
       }
     }
-    rowType =
-        TypeFactory<TypeKind::ROW>::create(std::move(names), std::move(types));
+    return TypeFactory<TypeKind::ROW>::create(
+        std::move(names), std::move(types));
+  }
 
+  static VectorFuzzer::Options fuzzerOptions(size_t vectorSize) {
     VectorFuzzer::Options opts;
-    opts.vectorSize = 1;
+    opts.vectorSize = vectorSize;
     opts.nullRatio = 0.1;
     opts.stringVariableLength = true;
     opts.stringLength = 20;
     // Spark uses microseconds to store timestamp
     opts.useMicrosecondPrecisionTimestamp = true;
-
-    auto seed = folly::Random::rand32();
-    VectorFuzzer fuzzer(opts, pool_.get(), seed);
-    const auto& inputVector = fuzzer.fuzzRow(rowType);
-    std::vector<std::optional<std::string_view>> results;
-    results.reserve(nRows);
-    // Serialize rowVector into bytes.
-    for (int32_t i = 0; i < nRows; ++i) {
-      BufferPtr bufferPtr =
-          AlignedBuffer::allocate<char>(1024, pool_.get(), true);
-      char* buffer = bufferPtr->asMutable<char>();
-      auto rowSize = UnsafeRowDynamicSerializer::serialize(
-          rowType, inputVector, buffer, /*idx=*/0);
-      results.push_back(std::string_view(buffer, rowSize.value()));
-    }
-    return {results, rowType};
+    return opts;
   }
 
- private:
   std::vector<TypePtr> allTypes_{
       BOOLEAN(),
       TINYINT(),
@@ -135,6 +173,9 @@ class BenchmarkHelper {
 
   std::unique_ptr<memory::ScopedMemoryPool> pool_ =
       memory::getDefaultScopedMemoryPool();
+
+  // Keeps the serialized rows alive.
+  std::vector<BufferPtr> buffers_;
 };
 
 int deserialize(
@@ -155,6 +196,31 @@ int deserialize(
   return nIters * nFields * nRows;
 }
 
+int serialize(int nIters, int nFields, int nRows, bool columnar) {
+  folly::BenchmarkSuspender suspender;
+  BenchmarkHelper helper;
+  auto input = helper.randomRowVector(nFields, nRows, false);
+  auto buffer = AlignedBuffer::allocate<char>(
+      UnsafeRowColumnarSerializer(input).totalSize(), helper.pool());
+  suspender.dismiss();
+
+  for (int i = 0; i < nIters; i++) {
+    if (columnar) {
+      UnsafeRowColumnarSerializer serializer(input);
+      serializer.serialize(buffer->asMutable<char>());
+    } else {
+      char* data = buffer->asMutable<char>();
+      for (auto row = 0; row < nRows; ++row) {
+        auto rowSize = UnsafeRowDynamicSerializer::serialize(
+            input->type(), input, data, row);
+        data += UnsafeRow::alignToFieldWidth(rowSize.value_or(0));
+      }
+    }
+  }
+
+  return nIters * nFields * nRows;
+}
+
 BENCHMARK_NAMED_PARAM_MULTI(
     deserialize,
     row_10_100k_string_only,
@@ -169,6 +235,13 @@ BENCHMARK_RELATIVE_NAMED_PARAM_MULTI(
     100000,
     true,
     std::make_unique<UnsaferowBatchDeserializer>());
+BENCHMARK_RELATIVE_NAMED_PARAM_MULTI(
+    deserialize,
+    columnar_10_100k_string_only,
+    10,
+    100000,
+    true,
+    std::make_unique<UnsaferowColumnarDeserializer>());
 
 BENCHMARK_NAMED_PARAM_MULTI(
     deserialize,
@@ -184,6 +257,13 @@ BENCHMARK_RELATIVE_NAMED_PARAM_MULTI(
     100000,
     true,
     std::make_unique<UnsaferowBatchDeserializer>());
+BENCHMARK_RELATIVE_NAMED_PARAM_MULTI(
+    deserialize,
+    columnar_100_100k_string_only,
+    100,
+    100000,
+    true,
+    std::make_unique<UnsaferowColumnarDeserializer>());
 
 BENCHMARK_NAMED_PARAM_MULTI(
     deserialize,
@@ -199,6 +279,13 @@ BENCHMARK_RELATIVE_NAMED_PARAM_MULTI(
     100000,
     false,
     std::make_unique<UnsaferowBatchDeserializer>());
+BENCHMARK_RELATIVE_NAMED_PARAM_MULTI(
+    deserialize,
+    columnar_10_100k_all_types,
+    10,
+    100000,
+    false,
+    std::make_unique<UnsaferowColumnarDeserializer>());
 
 BENCHMARK_NAMED_PARAM_MULTI(
     deserialize,
@@ -214,6 +301,39 @@ BENCHMARK_RELATIVE_NAMED_PARAM_MULTI(
     100000,
     false,
     std::make_unique<UnsaferowBatchDeserializer>());
+BENCHMARK_RELATIVE_NAMED_PARAM_MULTI(
+    deserialize,
+    columnar_100_100k_all_types,
+    100,
+    100000,
+    false,
+    std::make_unique<UnsaferowColumnarDeserializer>());
+
+BENCHMARK_NAMED_PARAM_MULTI(
+    serialize,
+    row_10_100k_all_types,
+    10,
+    100000,
+    false);
+BENCHMARK_RELATIVE_NAMED_PARAM_MULTI(
+    serialize,
+    columnar_10_100k_all_types,
+    10,
+    100000,
+    true);
+
+BENCHMARK_NAMED_PARAM_MULTI(
+    serialize,
+    row_100_10k_all_types,
+    100,
+    10000,
+    false);
+BENCHMARK_RELATIVE_NAMED_PARAM_MULTI(
+    serialize,
+    columnar_100_10k_all_types,
+    100,
+    10000,
+    true);
 
 } // namespace
 } // namespace facebook::spark::benchmarks
@@ -20,6 +20,7 @@
 #include <folly/init/Init.h>
 
 #include "velox/row/UnsafeRowBatchDeserializer.h"
+#include "velox/row/UnsafeRowColumnarSerializer.h"
 #include "velox/row/UnsafeRowDynamicSerializer.h"
 #include "velox/type/Type.h"
 #include "velox/vector/BaseVector.h"
@@ -99,5 +100,66 @@ TEST_F(UnsafeRowFuzzTests, simpleTypeRoundTripTest) {
   }
 }
 
+TEST_F(UnsafeRowFuzzTests, columnarSerialize) {
+  auto rowType = ROW(
+      {BOOLEAN(),
+       TINYINT(),
+       SMALLINT(),
+       INTEGER(),
+       BIGINT(),
+       REAL(),
+       DOUBLE(),
+       VARCHAR(),
+       TIMESTAMP(),
+       ROW({VARCHAR(), INTEGER()}),
+       ARRAY(INTEGER()),
+       ARRAY(VARCHAR()),
+       MAP(VARCHAR(), ARRAY(INTEGER()))});
+
+  VectorFuzzer::Options opts;
+  opts.vectorSize = 100;
+  opts.nullRatio = 0.1;
+  opts.containerHasNulls = false;
+  opts.dictionaryHasNulls = false;
+  opts.stringVariableLength = true;
+  opts.stringLength = 20;
+  opts.useMicrosecondPrecisionTimestamp = true;
+  opts.containerLength = 10;
+
+  auto seed = folly::Random::rand32();
+  LOG(INFO) << "seed: " << seed;
+  VectorFuzzer fuzzer(opts, pool_.get(), seed);
+
+  for (size_t i = 0; i < 20; ++i) {
+    auto inputVector = fuzzer.fuzzRow(rowType);
+    UnsafeRowColumnarSerializer serializer(inputVector);
+    auto data = AlignedBuffer::allocate<char>(
+        std::max<size_t>(serializer.totalSize(), 1), pool_.get());
+    auto rows = serializer.serialize(data->asMutable<char>());
+    ASSERT_EQ(rows.size(), inputVector->size());
+
+    // Each row has the bytes written by the row at a time serializer.
+    for (auto row = 0; row < inputVector->size(); ++row) {
+      clearBuffer();
+      auto rowSize = UnsafeRowDynamicSerializer::serialize(
+          rowType, inputVector, buffer_, row);
+      ASSERT_EQ(rowSize.has_value(), rows[row].has_value())
+          << "seed " << seed;
+      if (!rowSize.has_value()) {
+        continue;
+      }
+      ASSERT_EQ(rowSize.value(), serializer.rowSize(row)) << "seed " << seed;
+      ASSERT_EQ(std::string_view(buffer_, rowSize.value()), rows[row].value())
+          << "seed " << seed;
+    }
+
+    VectorPtr outputVector =
+        UnsafeRowDynamicVectorBatchDeserializer::deserializeComplex(
+            rows, rowType, pool_.get());
+    assertEqualVectors(
+        inputVector, outputVector, fmt::format(" (seed {}).", seed));
+  }
+}
+
 } // namespace
 } // namespace facebook::velox::row
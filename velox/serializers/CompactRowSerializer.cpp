@@ -0,0 +1,667 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "velox/serializers/CompactRowSerializer.h"
+#include "velox/vector/ComplexVector.h"
+#include "velox/vector/FlatVector.h"
+
+namespace facebook::velox::serializer {
+namespace {
+
+// Serialized value. 'data()' is nullptr for a null.
+using Value = std::string_view;
+
+int32_t readInt32(const char* data) {
+  int32_t value;
+  memcpy(&value, data, sizeof(value));
+  return value;
+}
+
+void writeInt32(char* data, int32_t value) {
+  memcpy(data, &value, sizeof(value));
+}
+
+int32_t nullBytes(int32_t numValues) {
+  return bits::nbytes(numValues);
+}
+
+void checkSupported(const TypePtr& type) {
+  switch (type->kind()) {
+    case TypeKind::BOOLEAN:
+    case TypeKind::TINYINT:
+    case TypeKind::SMALLINT:
+    case TypeKind::INTEGER:
+    case TypeKind::BIGINT:
+    case TypeKind::REAL:
+    case TypeKind::DOUBLE:
+    case TypeKind::TIMESTAMP:
+    case TypeKind::DATE:
+    case TypeKind::INTERVAL_DAY_TIME:
+    case TypeKind::VARCHAR:
+    case TypeKind::VARBINARY:
+      return;
+    case TypeKind::ARRAY:
+    case TypeKind::MAP:
+    case TypeKind::ROW:
+      for (auto i = 0; i < type->size(); ++i) {
+        checkSupported(type->childAt(i));
+      }
+      return;
+    default:
+      VELOX_UNSUPPORTED(
+          "Compact row serialization of {} is not supported",
+          type->toString());
+  }
+}
+
+// Returns the size of the data of the non-null variable width value at
+// 'index' of 'vector'.
+int32_t variableSize(
+    const TypePtr& type,
+    const BaseVector& vector,
+    vector_size_t index);
+
+// Returns the size of 'numFields' fields laid out as a ROW value. 'type(i)',
+// 'vector(i)' and 'index(i)' return the type, vector and index of field 'i'.
+template <typename TypeAt, typename VectorAt, typename IndexAt>
+int32_t fieldsSize(
+    int32_t numFields,
+    TypeAt type,
+    VectorAt vector,
+    IndexAt index) {
+  int32_t size = nullBytes(numFields);
+  for (auto i = 0; i < numFields; ++i) {
+    const auto& fieldType = type(i);
+    if (fieldType->isFixedWidth()) {
+      size += fieldType->cppSizeInBytes();
+      continue;
+    }
+    size += sizeof(int32_t);
+    const auto& fieldVector = vector(i);
+    if (!fieldVector.isNullAt(index(i))) {
+      size += variableSize(fieldType, fieldVector, index(i));
+    }
+  }
+  return size;
+}
+
+int32_t listSize(
+    const TypePtr& type,
+    const BaseVector& vector,
+    vector_size_t offset,
+    vector_size_t size) {
+  return fieldsSize(
+      size,
+      [&](auto) -> const TypePtr& { return type; },
+      [&](auto) -> const BaseVector& { return vector; },
+      [&](auto i) { return offset + i; });
+}
+
+int32_t rowSize(
+    const RowType& type,
+    const RowVector& vector,
+    vector_size_t index) {
+  return fieldsSize(
+      type.size(),
+      [&](auto i) -> const TypePtr& { return type.childAt(i); },
+      [&](auto i) -> const BaseVector& { return *vector.childAt(i); },
+      [&](auto) { return index; });
+}
+
+int32_t variableSize(
+    const TypePtr& type,
+    const BaseVector& vector,
+    vector_size_t index) {
+  switch (type->kind()) {
+    case TypeKind::VARCHAR:
+    case TypeKind::VARBINARY:
+      return vector.loadedVector()
+          ->asUnchecked<SimpleVector<StringView>>()
+          ->valueAt(index)
+          .size();
+    case TypeKind::ARRAY: {
+      auto* array = vector.wrappedVector()->asUnchecked<ArrayVector>();
+      auto wrappedIndex = vector.wrappedIndex(index);
+      return sizeof(int32_t) +
+          listSize(
+                 type->childAt(0),
+                 *array->elements(),
+                 array->offsetAt(wrappedIndex),
+                 array->sizeAt(wrappedIndex));
+    }
+    case TypeKind::MAP: {
+      auto* map = vector.wrappedVector()->asUnchecked<MapVector>();
+      auto wrappedIndex = vector.wrappedIndex(index);
+      auto offset = map->offsetAt(wrappedIndex);
+      auto size = map->sizeAt(wrappedIndex);
+      return sizeof(int32_t) +
+          listSize(type->childAt(0), *map->mapKeys(), offset, size) +
+          listSize(type->childAt(1), *map->mapValues(), offset, size);
+    }
+    case TypeKind::ROW:
+      return rowSize(
+          type->asRow(),
+          *vector.wrappedVector()->asUnchecked<RowVector>(),
+          vector.wrappedIndex(index));
+    default:
+      VELOX_UNREACHABLE();
+  }
+}
+
+template <TypeKind Kind>
+void writeFixedWidthValue(
+    const BaseVector& vector,
+    vector_size_t index,
+    char* data) {
+  using T = typename TypeTraits<Kind>::NativeType;
+  auto value =
+      vector.loadedVector()->asUnchecked<SimpleVector<T>>()->valueAt(index);
+  memcpy(data, &value, sizeof(T));
+}
+
+// Writes the data of the non-null variable width value at 'index' of
+// 'vector' to 'data'. Returns the end of the data.
+char* writeVariable(
+    const TypePtr& type,
+    const BaseVector& vector,
+    vector_size_t index,
+    char* data);
+
+// Writes the fields laid out as a ROW value. See fieldsSize().
+template <typename TypeAt, typename VectorAt, typename IndexAt>
+char* writeFields(
+    int32_t numFields,
+    TypeAt type,
+    VectorAt vector,
+    IndexAt index,
+    char* data) {
+  auto* nulls = reinterpret_cast<uint8_t*>(data);
+  memset(nulls, 0, nullBytes(numFields));
+  char* slot = data + nullBytes(numFields);
+  // The variable width data starts after the slots.
+  char* end = slot;
+  for (auto i = 0; i < numFields; ++i) {
+    const auto& fieldType = type(i);
+    end += fieldType->isFixedWidth() ? fieldType->cppSizeInBytes()
+                                     : sizeof(int32_t);
+  }
+  for (auto i = 0; i < numFields; ++i) {
+    const auto& fieldType = type(i);
+    const auto& fieldVector = vector(i);
+    const auto fieldIndex = index(i);
+    const bool isNull = fieldVector.isNullAt(fieldIndex);
+    if (isNull) {
+      bits::setBit(nulls, i);
+    }
+    if (fieldType->isFixedWidth()) {
+      const auto width = fieldType->cppSizeInBytes();
+      if (isNull) {
+        memset(slot, 0, width);
+      } else {
+        VELOX_DYNAMIC_SCALAR_TYPE_DISPATCH(
+            writeFixedWidthValue,
+            fieldType->kind(),
+            fieldVector,
+            fieldIndex,
+            slot);
+      }
+      slot += width;
+      continue;
+    }
+    int32_t size = 0;
+    if (!isNull) {
+      auto* valueEnd = writeVariable(fieldType, fieldVector, fieldIndex, end);
+      size = valueEnd - end;
+      end = valueEnd;
+    }
+    writeInt32(slot, size);
+    slot += sizeof(int32_t);
+  }
+  return end;
+}
+
+char* writeList(
+    const TypePtr& type,
+    const BaseVector& vector,
+    vector_size_t offset,
+    vector_size_t size,
+    char* data) {
+  return writeFields(
+      size,
+      [&](auto) -> const TypePtr& { return type; },
+      [&](auto) -> const BaseVector& { return vector; },
+      [&](auto i) { return offset + i; },
+      data);
+}
+
+char* writeRow(
+    const RowType& type,
+    const RowVector& vector,
+    vector_size_t index,
+    char* data) {
+  return writeFields(
+      type.size(),
+      [&](auto i) -> const TypePtr& { return type.childAt(i); },
+      [&](auto i) -> const BaseVector& { return *vector.childAt(i); },
+      [&](auto) { return index; },
+      data);
+}
+
+char* writeVariable(
+    const TypePtr& type,
+    const BaseVector& vector,
+    vector_size_t index,
+    char* data) {
+  switch (type->kind()) {
+    case TypeKind::VARCHAR:
+    case TypeKind::VARBINARY: {
+      auto value = vector.loadedVector()
+                       ->asUnchecked<SimpleVector<StringView>>()
+                       ->valueAt(index);
+      memcpy(data, value.data(), value.size());
+      return data + value.size();
+    }
+    case TypeKind::ARRAY: {
+      auto* array = vector.wrappedVector()->asUnchecked<ArrayVector>();
+      auto wrappedIndex = vector.wrappedIndex(index);
+      auto size = array->sizeAt(wrappedIndex);
+      writeInt32(data, size);
+      return writeList(
+          type->childAt(0),
+          *array->elements(),
+          array->offsetAt(wrappedIndex),
+          size,
+          data + sizeof(int32_t));
+    }
+    case TypeKind::MAP: {
+      auto* map = vector.wrappedVector()->asUnchecked<MapVector>();
+      auto wrappedIndex = vector.wrappedIndex(index);
+      auto offset = map->offsetAt(wrappedIndex);
+      auto size = map->sizeAt(wrappedIndex);
+      writeInt32(data, size);
+      data = writeList(
+          type->childAt(0),
+          *map->mapKeys(),
+          offset,
+          size,
+          data + sizeof(int32_t));
+      return writeList(type->childAt(1), *map->mapValues(), offset, size, data);
+    }
+    case TypeKind::ROW:
+      return writeRow(
+          type->asRow(),
+          *vector.wrappedVector()->asUnchecked<RowVector>(),
+          vector.wrappedIndex(index),
+          data);
+    default:
+      VELOX_UNREACHABLE();
+  }
+}
+
+// Calls 'onValue(i, value)' for each field 'i' of the fields laid out as a
+// ROW value at 'data'. 'type(i)' returns the type of field 'i'. Returns the
+// end of the value.
+template <typename TypeAt, typename OnValue>
+const char*
+readFields(const char* data, int32_t numFields, TypeAt type, OnValue onValue) {
+  auto* nulls = reinterpret_cast<const uint8_t*>(data);
+  const char* slot = data + nullBytes(numFields);
+  const char* end = slot;
+  for (auto i = 0; i < numFields; ++i) {
+    const auto& fieldType = type(i);
+    end += fieldType->isFixedWidth() ? fieldType->cppSizeInBytes()
+                                     : sizeof(int32_t);
+  }
+  for (auto i = 0; i < numFields; ++i) {
+    const auto& fieldType = type(i);
+    const bool isNull = bits::isBitSet(nulls, i);
+    if (fieldType->isFixedWidth()) {
+      const auto width = fieldType->cppSizeInBytes();
+      onValue(i, isNull ? Value() : Value(slot, width));
+      slot += width;
+      continue;
+    }
+    auto size = readInt32(slot);
+    onValue(i, isNull ? Value() : Value(end, size));
+    end += size;
+    slot += sizeof(int32_t);
+  }
+  return end;
+}
+
+// Appends the 'size' values of the list at 'data' to 'values'. Returns the
+// end of the list.
+const char* readList(
+    const char* data,
+    int32_t size,
+    const TypePtr& type,
+    std::vector<Value>& values) {
+  return readFields(
+      data,
+      size,
+      [&](auto) -> const TypePtr& { return type; },
+      [&](auto, Value value) { values.push_back(value); });
+}
+
+// Returns the nulls of 'values', nullptr if none is null.
+BufferPtr readNulls(
+    const std::vector<Value>& values,
+    memory::MemoryPool* pool) {
+  BufferPtr nulls;
+  for (auto i = 0; i < values.size(); ++i) {
+    if (values[i].data() == nullptr) {
+      if (!nulls) {
+        nulls =
+            AlignedBuffer::allocate<bool>(values.size(), pool, bits::kNotNull);
+      }
+      bits::setNull(nulls->asMutable<uint64_t>(), i);
+    }
+  }
+  return nulls;
+}
+
+VectorPtr readValues(
+    const TypePtr& type,
+    const std::vector<Value>& values,
+    memory::MemoryPool* pool);
+
+template <TypeKind Kind>
+VectorPtr readFixedWidthValues(
+    const TypePtr& type,
+    const std::vector<Value>& values,
+    memory::MemoryPool* pool) {
+  using T = typename TypeTraits<Kind>::NativeType;
+  const auto size = values.size();
+  auto vector = BaseVector::create<FlatVector<T>>(type, size, pool);
+  for (auto i = 0; i < size; ++i) {
+    if (values[i].data() == nullptr) {
+      vector->setNull(i, true);
+    } else {
+      T value;
+      memcpy(&value, values[i].data(), sizeof(T));
+      vector->set(i, value);
+    }
+  }
+  return vector;
+}
+
+VectorPtr readStrings(
+    const TypePtr& type,
+    const std::vector<Value>& values,
+    memory::MemoryPool* pool) {
+  const auto size = values.size();
+  auto vector = BaseVector::create<FlatVector<StringView>>(type, size, pool);
+  size_t totalSize = 0;
+  for (auto& value : values) {
+    if (value.size() > StringView::kInlineSize) {
+      totalSize += value.size();
+    }
+  }
+  // All strings that are not inlined are copied to one buffer.
+  BufferPtr buffer;
+  char* rawBuffer = nullptr;
+  if (totalSize > 0) {
+    buffer = AlignedBuffer::allocate<char>(totalSize, pool);
+    rawBuffer = buffer->asMutable<char>();
+  }
+  auto* rawValues = vector->mutableRawValues();
+  for (auto i = 0; i < size; ++i) {
+    const auto& value = values[i];
+    if (value.data() == nullptr) {
+      vector->setNull(i, true);
+      continue;
+    }
+    if (value.size() <= StringView::kInlineSize) {
+      rawValues[i] = StringView(value.data(), value.size());
+    } else {
+      memcpy(rawBuffer, value.data(), value.size());
+      rawValues[i] = StringView(rawBuffer, value.size());
+      rawBuffer += value.size();
+    }
+  }
+  if (buffer) {
+    vector->setStringBuffers({std::move(buffer)});
+  }
+  return vector;
+}
+
+// Reads ARRAY or MAP values. A MAP has two lists per value.
+VectorPtr readLists(
+    const TypePtr& type,
+    const std::vector<Value>& values,
+    memory::MemoryPool* pool) {
+  const auto size = values.size();
+  const bool isMap = type->kind() == TypeKind::MAP;
+  auto offsets = allocateOffsets(size, pool);
+  auto sizes = allocateSizes(size, pool);
+  auto* rawOffsets = offsets->asMutable<vector_size_t>();
+  auto* rawSizes = sizes->asMutable<vector_size_t>();
+  std::vector<Value> elements;
+  std::vector<Value> mapValues;
+  for (auto i = 0; i < size; ++i) {
+    rawOffsets[i] = elements.size();
+    rawSizes[i] = 0;
+    if (values[i].data() == nullptr) {
+      continue;
+    }
+    rawSizes[i] = readInt32(values[i].data());
+    auto* data = readList(
+        values[i].data() + sizeof(int32_t),
+        rawSizes[i],
+        type->childAt(0),
+        elements);
+    if (isMap) {
+      readList(data, rawSizes[i], type->childAt(1), mapValues);
+    }
+  }
+
+  auto nulls = readNulls(values, pool);
+  if (isMap) {
+    return std::make_shared<MapVector>(
+        pool,
+        type,
+        std::move(nulls),
+        size,
+        std::move(offsets),
+        std::move(sizes),
+        readValues(type->childAt(0), elements, pool),
+        readValues(type->childAt(1), mapValues, pool));
+  }
+  return std::make_shared<ArrayVector>(
+      pool,
+      type,
+      std::move(nulls),
+      size,
+      std::move(offsets),
+      std::move(sizes),
+      readValues(type->childAt(0), elements, pool));
+}
+
+RowVectorPtr readRows(
+    const TypePtr& type,
+    const std::vector<Value>& values,
+    memory::MemoryPool* pool) {
+  const auto& rowType = type->asRow();
+  const auto numFields = rowType.size();
+  const auto size = values.size();
+  std::vector<std::vector<Value>> fieldValues(numFields);
+  for (auto& field : fieldValues) {
+    field.reserve(size);
+  }
+  for (auto& value : values) {
+    if (value.data() == nullptr) {
+      // Fields of null rows are null.
+      for (auto& field : fieldValues) {
+        field.push_back(Value());
+      }
+      continue;
+    }
+    readFields(
+        value.data(),
+        numFields,
+        [&](auto i) -> const TypePtr& { return rowType.childAt(i); },
+        [&](auto i, Value field) { fieldValues[i].push_back(field); });
+  }
+
+  // Each field is read for all rows in one loop.
+  std::vector<VectorPtr> children(numFields);
+  for (auto i = 0; i < numFields; ++i) {
+    children[i] = readValues(rowType.childAt(i), fieldValues[i], pool);
+  }
+  return std::make_shared<RowVector>(
+      pool, type, readNulls(values, pool), size, std::move(children));
+}
+
+VectorPtr readValues(
+    const TypePtr& type,
+    const std::vector<Value>& values,
+    memory::MemoryPool* pool) {
+  switch (type->kind()) {
+    case TypeKind::VARCHAR:
+    case TypeKind::VARBINARY:
+      return readStrings(type, values, pool);
+    case TypeKind::ARRAY:
+    case TypeKind::MAP:
+      return readLists(type, values, pool);
+    case TypeKind::ROW:
+      return readRows(type, values, pool);
+    default:
+      return VELOX_DYNAMIC_SCALAR_TYPE_DISPATCH(
+          readFixedWidthValues, type->kind(), type, values, pool);
+  }
+}
+
+class CompactRowVectorSerializer : public VectorSerializer {
+ public:
+  CompactRowVectorSerializer(
+      std::shared_ptr<const RowType> rowType,
+      int32_t numRows,
+      StreamArena* streamArena)
+      : rowType_(std::move(rowType)), rows_(streamArena) {
+    checkSupported(rowType_);
+    // A guess of 16 bytes per field.
+    rows_.startWrite(
+        std::max<int32_t>(1, numRows) * (1 + rowType_->size()) * 16);
+  }
+
+  void append(
+      RowVectorPtr vector,
+      const folly::Range<const IndexRange*>& ranges) override {
+    for (const auto& range : ranges) {
+      for (auto row = range.begin; row < range.begin + range.size; ++row) {
+        const auto size = rowSize(*rowType_, *vector, row);
+        row_.resize(sizeof(int32_t) + size);
+        writeInt32(row_.data(), size);
+        auto* end = writeRow(
+            *rowType_, *vector, row, row_.data() + sizeof(int32_t));
+        VELOX_DCHECK_EQ(end - row_.data(), row_.size());
+        rows_.appendStringPiece(folly::StringPiece(row_));
+        totalSize_ += row_.size();
+        ++numRows_;
+      }
+    }
+  }
+
+  void flush(OutputStream* out) override {
+    char header[2 * sizeof(int32_t)];
+    writeInt32(header, numRows_);
+    writeInt32(header + sizeof(int32_t), totalSize_);
+    out->write(header, sizeof(header));
+    rows_.flush(out);
+  }
+
+ private:
+  const std::shared_ptr<const RowType> rowType_;
+  ByteStream rows_;
+  int32_t numRows_{0};
+  int32_t totalSize_{0};
+
+  // Scratch space for serializing one row.
+  std::string row_;
+};
+
+} // namespace
+
+void CompactRowVectorSerde::estimateSerializedSize(
+    std::shared_ptr<BaseVector> vector,
+    const folly::Range<const IndexRange*>& ranges,
+    vector_size_t** sizes) {
+  // 'vector' is a column. Its values are sized as a ROW value with one field,
+  // whose null byte stands for the null bits and the size of the row.
+  const auto& type = vector->type();
+  for (auto i = 0; i < ranges.size(); ++i) {
+    for (auto row = ranges[i].begin; row < ranges[i].begin + ranges[i].size;
+         ++row) {
+      *sizes[i] += fieldsSize(
+          1,
+          [&](auto) -> const TypePtr& { return type; },
+          [&](auto) -> const BaseVector& { return *vector; },
+          [&](auto) { return row; });
+    }
+  }
+}
+
+std::unique_ptr<VectorSerializer> CompactRowVectorSerde::createSerializer(
+    std::shared_ptr<const RowType> type,
+    int32_t numRows,
+    StreamArena* streamArena,
+    const Options* options) {
+  VELOX_USER_CHECK(
+      !options ||
+          options->compressionKind == folly::io::CodecType::NO_COMPRESSION,
+      "Compression is not supported with the {} serde",
+      kName);
+  return std::make_unique<CompactRowVectorSerializer>(
+      std::move(type), numRows, streamArena);
+}
+
+void CompactRowVectorSerde::deserialize(
+    ByteStream* source,
+    velox::memory::MemoryPool* pool,
+    std::shared_ptr<const RowType> type,
+    std::shared_ptr<RowVector>* result,
+    const Options* /*options*/) {
+  const auto numRows = source->read<int32_t>();
+  const auto totalSize = source->read<int32_t>();
+
+  // The rows are read in place if they are in one range of 'source'.
+  BufferPtr copy;
+  const char* data = nullptr;
+  auto view = source->nextView(totalSize);
+  if (view.size() == totalSize) {
+    data = view.data();
+  } else {
+    copy = AlignedBuffer::allocate<char>(totalSize, pool);
+    auto* rawCopy = copy->asMutable<char>();
+    memcpy(rawCopy, view.data(), view.size());
+    source->readBytes(rawCopy + view.size(), totalSize - view.size());
+    data = rawCopy;
+  }
+
+  std::vector<Value> rows(numRows);
+  for (auto i = 0; i < numRows; ++i) {
+    const auto size = readInt32(data);
+    rows[i] = Value(data + sizeof(int32_t), size);
+    data += sizeof(int32_t) + size;
+  }
+  *result = readRows(type, rows, pool);
+}
+
+void CompactRowVectorSerde::registerNamedVectorSerde() {
+  velox::registerNamedVectorSerde(
+      kName, std::make_unique<CompactRowVectorSerde>());
+}
+
+} // namespace facebook::velox::serializer
@@ -0,0 +1,69 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#pragma once
+
+#include "velox/vector/VectorStream.h"
+
+namespace facebook::velox::serializer {
+
+/// Serializes RowVectors as a sequence of compact rows. Rows are appended
+/// one at a time, so that small batches for many destinations cost no more
+/// than one row each, unlike columnar pages whose streams are created for
+/// every batch. The reader converts the rows back to flat vectors a column
+/// at a time.
+///
+/// A page is the number of rows and the size of the rows as int32, followed
+/// by each row as its int32 size and its bytes. A row and a ROW value are a
+/// bit per field for nulls, padded to a byte, then a slot per field and then
+/// the variable width data. The slot of a fixed width field has its value,
+/// as many bytes as its C++ type. The slot of a VARCHAR, VARBINARY, ARRAY,
+/// MAP or ROW field has the int32 size of its data. The data of the non-null
+/// variable width fields follows the slots, in field order. Slots of null
+/// fields are zero. Nothing is padded.
+///
+/// An ARRAY value is its int32 number of elements followed by the elements
+/// as a list. A MAP value is its int32 number of entries followed by the
+/// keys and then the values, each as a list. A list of n values is laid out
+/// as a ROW value with n fields of the same type.
+///
+/// Compression is not supported.
+class CompactRowVectorSerde : public VectorSerde {
+ public:
+  /// Name under which registerNamedVectorSerde() registers the serde.
+  static constexpr const char* kName = "compact_row";
+
+  void estimateSerializedSize(
+      std::shared_ptr<BaseVector> vector,
+      const folly::Range<const IndexRange*>& ranges,
+      vector_size_t** sizes) override;
+
+  std::unique_ptr<VectorSerializer> createSerializer(
+      std::shared_ptr<const RowType> type,
+      int32_t numRows,
+      StreamArena* streamArena,
+      const Options* options = nullptr) override;
+
+  void deserialize(
+      ByteStream* source,
+      velox::memory::MemoryPool* pool,
+      std::shared_ptr<const RowType> type,
+      std::shared_ptr<RowVector>* result,
+      const Options* options = nullptr) override;
+
+  static void registerNamedVectorSerde();
+};
+
+} // namespace facebook::velox::serializer
@@ -15,6 +15,7 @@
  */
 #include "velox/serializers/PrestoSerializer.h"
 #include "velox/common/memory/ByteStream.h"
+#include "velox/common/time/Timer.h"
 #include "velox/functions/prestosql/types/TimestampWithTimeZoneType.h"
 #include "velox/type/Date.h"
 #include "velox/type/IntervalDayTime.h"
@@ -29,6 +30,16 @@ int8_t kCompressedBitMask = 1;
 int8_t kEncryptedBitMask = 2;
 int8_t kCheckSumBitMask = 4;
 
+// Names of the encodings of run length and dictionary encoded blocks. These
+// wrap a nested block of the value or the dictionary, which has the encoding
+// given by typeToEncodingName().
+constexpr std::string_view kRLE{"RLE"};
+constexpr std::string_view kDictionary{"DICTIONARY"};
+
+// Size of the id of the dictionary that follows the indices of a dictionary
+// block. The id is not used.
+constexpr int32_t kDictionaryIdSize = 24;
+
 int64_t computeChecksum(
     PrestoOutputStreamListener* listener,
     int codecMarker,
@@ -41,15 +52,18 @@ int64_t computeChecksum(
   return result.checksum();
 }
 
+// Returns the checksum of a page whose 'sizeInBytes' bytes of data, which may
+// be compressed, start at the position of 'source'. Does not move 'source'.
 int64_t computeChecksum(
     ByteStream* source,
     int codecMarker,
     int numRows,
-    int uncompressedSize) {
+    int uncompressedSize,
+    int sizeInBytes) {
   auto offset = source->tellp();
   boost::crc_32_type crc32;
 
-  auto remainingBytes = uncompressedSize;
+  auto remainingBytes = sizeInBytes;
   while (remainingBytes > 0) {
     auto data = source->nextView(remainingBytes);
     crc32.process_bytes(data.data(), data.size());
@@ -291,7 +305,8 @@ void read(
     velox::memory::MemoryPool* pool,
     VectorPtr* result) {
   int32_t size = source->read<int32_t>();
-  if (*result && result->unique()) {
+  if (*result && result->unique() &&
+      (*result)->encoding() == VectorEncoding::Simple::FLAT) {
     (*result)->resize(size);
   } else {
     *result = BaseVector::create(type, size, pool);
@@ -331,7 +346,8 @@ void read<StringView>(
     VectorPtr* result) {
   int32_t size = source->read<int32_t>();
 
-  if (*result && result->unique()) {
+  if (*result && result->unique() &&
+      (*result)->encoding() == VectorEncoding::Simple::FLAT) {
     (*result)->resize(size);
   } else {
     *result = BaseVector::create(type, size, pool);
@@ -609,9 +625,8 @@ std::string readLengthPrefixedString(ByteStream* source) {
   return value;
 }
 
-void readAndCheckType(ByteStream* source, TypePtr type) {
+void checkTypeEncoding(const std::string& encoding, const TypePtr& type) {
   auto kindEncoding = typeToEncodingName(type);
-  std::string encoding = readLengthPrefixedString(source);
   VELOX_CHECK(
       encoding == kindEncoding,
       "Encoding to Type mismatch {} expected {} got {}",
@@ -620,6 +635,37 @@ void readAndCheckType(ByteStream* source, TypePtr type) {
       encoding);
 }
 
+// Reads the single value of a run length encoded block into a ConstantVector.
+void readRleVector(
+    ByteStream* source,
+    velox::memory::MemoryPool* pool,
+    const TypePtr& type,
+    VectorPtr* result) {
+  const auto size = source->read<int32_t>();
+  std::vector<VectorPtr> values(1);
+  readColumns(source, pool, {type}, &values);
+  VELOX_CHECK_EQ(1, values[0]->size(), "RLE block must have one value");
+  *result = BaseVector::wrapInConstant(size, 0, values[0]);
+}
+
+// Reads the dictionary and the indices of a dictionary block into a
+// DictionaryVector.
+void readDictionaryVector(
+    ByteStream* source,
+    velox::memory::MemoryPool* pool,
+    const TypePtr& type,
+    VectorPtr* result) {
+  const auto size = source->read<int32_t>();
+  std::vector<VectorPtr> dictionary(1);
+  readColumns(source, pool, {type}, &dictionary);
+  auto indices = allocateIndices(size, pool);
+  source->readBytes(
+      indices->asMutable<uint8_t>(), size * sizeof(vector_size_t));
+  source->skip(kDictionaryIdSize);
+  *result = BaseVector::wrapInDictionary(
+      nullptr, std::move(indices), size, dictionary[0]);
+}
+
 void readColumns(
     ByteStream* source,
     velox::memory::MemoryPool* pool,
@@ -659,8 +705,15 @@ void readColumns(
         "Column reader for type {} is missing",
         types[i]->kindName());
 
-    readAndCheckType(source, types[i]);
-    it->second(source, types[i], pool, &(*result)[i]);
+    const auto encoding = readLengthPrefixedString(source);
+    if (encoding == kRLE) {
+      readRleVector(source, pool, types[i], &(*result)[i]);
+    } else if (encoding == kDictionary) {
+      readDictionaryVector(source, pool, types[i], &(*result)[i]);
+    } else {
+      checkTypeEncoding(encoding, types[i]);
+      it->second(source, types[i], pool, &(*result)[i]);
+    }
   }
 }
 
@@ -906,7 +959,7 @@ void serializeFlatVector(
     const folly::Range<const IndexRange*>& ranges,
     VectorStream* stream) {
   using T = typename TypeTraits<kind>::NativeType;
-  auto flatVector = dynamic_cast<const FlatVector<T>*>(vector);
+  auto flatVector = vector->asUnchecked<FlatVector<T>>();
   auto rawValues = flatVector->rawValues();
   if (!flatVector->mayHaveNulls()) {
     for (auto& range : ranges) {
@@ -954,7 +1007,7 @@ void serializeFlatVector<TypeKind::BOOLEAN>(
     const BaseVector* vector,
     const folly::Range<const IndexRange*>& ranges,
     VectorStream* stream) {
-  auto flatVector = dynamic_cast<const FlatVector<bool>*>(vector);
+  auto flatVector = vector->asUnchecked<FlatVector<bool>>();
   if (!vector->mayHaveNulls()) {
     for (int32_t i = 0; i < ranges.size(); ++i) {
       stream->appendNonNull(ranges[i].size);
@@ -978,6 +1031,17 @@ void serializeFlatVector<TypeKind::BOOLEAN>(
   }
 }
 
+// Appends 'ranges[i]' of the flat 'vector' to 'streams[i]' for each i.
+template <TypeKind kind>
+void scatterFlatVector(
+    const BaseVector* vector,
+    const std::vector<folly::Range<const IndexRange*>>& ranges,
+    const std::vector<VectorStream*>& streams) {
+  for (auto i = 0; i < streams.size(); ++i) {
+    serializeFlatVector<kind>(vector, ranges[i], streams[i]);
+  }
+}
+
 void serializeColumn(
     const BaseVector* vector,
     const folly::Range<const IndexRange*>& ranges,
@@ -1487,18 +1551,187 @@ void estimateSerializedSizeInt(
   }
 }
 
+// A top level column of a page. Keeps the column in RLE encoding while all
+// batches appended to the page have the same constant value, or in
+// DICTIONARY encoding while all batches are dictionaries over the same base
+// vector with fewer rows than the page. Otherwise the rows are serialized in
+// the flat encoding of the type into 'stream_'.
+class EncodedColumn {
+ public:
+  EncodedColumn(const TypePtr& type, StreamArena* streamArena, int32_t numRows)
+      : type_(type),
+        streamArena_(streamArena),
+        stream_(std::make_unique<VectorStream>(type, streamArena, numRows)) {}
+
+  void append(
+      const VectorPtr& vector,
+      const folly::Range<const IndexRange*>& ranges,
+      int32_t numRows) {
+    const bool firstBatch = !hasRows_;
+    hasRows_ = true;
+    switch (encoding_) {
+      case VectorEncoding::Simple::CONSTANT:
+        if (vector->isConstantEncoding() &&
+            vector->equalValueAt(vector_.get(), 0, 0)) {
+          numRows_ += numRows;
+          return;
+        }
+        flatten();
+        break;
+      case VectorEncoding::Simple::DICTIONARY:
+        if (isDictionaryOver(*vector, vector_)) {
+          appendIndices(*vector, ranges);
+          return;
+        }
+        flatten();
+        break;
+      default:
+        if (firstBatch && numRows > 1 && vector->isConstantEncoding()) {
+          startEncoding(VectorEncoding::Simple::CONSTANT, vector, 1);
+          numRows_ = numRows;
+          return;
+        }
+        if (firstBatch &&
+            vector->encoding() == VectorEncoding::Simple::DICTIONARY &&
+            !vector->rawNulls() &&
+            vector->valueVector()->size() * 2 <= numRows) {
+          auto base = vector->valueVector();
+          startEncoding(
+              VectorEncoding::Simple::DICTIONARY, base, base->size());
+          appendIndices(*vector, ranges);
+          return;
+        }
+    }
+    serializeColumn(vector.get(), ranges, stream_.get());
+  }
+
+  // Returns the stream to which the caller appends rows of a flat vector.
+  // Rows held in RLE or DICTIONARY encoding are first moved to the stream.
+  VectorStream* flatStream() {
+    if (encoding_ != VectorEncoding::Simple::FLAT) {
+      flatten();
+    }
+    hasRows_ = true;
+    return stream_.get();
+  }
+
+  // Writes out the accumulated contents. Does not change the state.
+  void flush(OutputStream* out) {
+    if (encoding_ == VectorEncoding::Simple::FLAT) {
+      stream_->flush(out);
+      return;
+    }
+    const auto name =
+        encoding_ == VectorEncoding::Simple::CONSTANT ? kRLE : kDictionary;
+    writeInt32(out, name.size());
+    out->write(name.data(), name.size());
+    writeInt32(out, numRows_);
+    valueStream_->flush(out);
+    if (encoding_ == VectorEncoding::Simple::DICTIONARY) {
+      out->write(
+          reinterpret_cast<const char*>(indices_.data()),
+          indices_.size() * sizeof(vector_size_t));
+      const char zeros[kDictionaryIdSize] = {};
+      out->write(zeros, kDictionaryIdSize);
+    }
+  }
+
+ private:
+  // Returns true if 'vector' is a dictionary that adds no nulls to 'base'.
+  static bool isDictionaryOver(
+      const BaseVector& vector,
+      const VectorPtr& base) {
+    return vector.encoding() == VectorEncoding::Simple::DICTIONARY &&
+        !vector.rawNulls() && vector.valueVector() == base;
+  }
+
+  // Serializes the first 'numValues' rows of 'vector' into 'valueStream_'.
+  void startEncoding(
+      VectorEncoding::Simple encoding,
+      VectorPtr vector,
+      vector_size_t numValues) {
+    encoding_ = encoding;
+    vector_ = std::move(vector);
+    valueStream_ =
+        std::make_unique<VectorStream>(type_, streamArena_, numValues);
+    IndexRange range{0, numValues};
+    serializeColumn(vector_.get(), folly::Range(&range, 1), valueStream_.get());
+  }
+
+  void appendIndices(
+      const BaseVector& dictionary,
+      const folly::Range<const IndexRange*>& ranges) {
+    auto rawIndices = dictionary.wrapInfo()->as<vector_size_t>();
+    for (auto& range : ranges) {
+      indices_.insert(
+          indices_.end(),
+          rawIndices + range.begin,
+          rawIndices + range.begin + range.size);
+    }
+    numRows_ = indices_.size();
+  }
+
+  // Serializes the rows held in RLE or DICTIONARY encoding into 'stream_'
+  // and continues in the flat encoding.
+  void flatten() {
+    if (encoding_ == VectorEncoding::Simple::CONSTANT) {
+      IndexRange range{0, numRows_};
+      serializeColumn(vector_.get(), folly::Range(&range, 1), stream_.get());
+    } else {
+      std::vector<IndexRange> ranges;
+      ranges.reserve(indices_.size());
+      for (auto index : indices_) {
+        ranges.push_back(IndexRange{index, 1});
+      }
+      serializeColumn(vector_.get(), ranges, stream_.get());
+    }
+    encoding_ = VectorEncoding::Simple::FLAT;
+    vector_.reset();
+    valueStream_.reset();
+    indices_.clear();
+    numRows_ = 0;
+  }
+
+  const TypePtr type_;
+  StreamArena* const streamArena_;
+  std::unique_ptr<VectorStream> stream_;
+  bool hasRows_{false};
+
+  // FLAT if the rows are in 'stream_'. Otherwise CONSTANT for RLE or
+  // DICTIONARY.
+  VectorEncoding::Simple encoding_{VectorEncoding::Simple::FLAT};
+  // The constant vector or the base of the dictionaries.
+  VectorPtr vector_;
+  // The serialized value of the constant or the serialized dictionary.
+  std::unique_ptr<VectorStream> valueStream_;
+  // Indices into 'vector_' for DICTIONARY.
+  std::vector<vector_size_t> indices_;
+  // Number of rows held in RLE or DICTIONARY encoding.
+  int32_t numRows_{0};
+};
+
 class PrestoVectorSerializer : public VectorSerializer {
  public:
   PrestoVectorSerializer(
       std::shared_ptr<const RowType> rowType,
       int32_t numRows,
-      StreamArena* streamArena) {
+      StreamArena* streamArena,
+      const VectorSerde::Options* options)
+      : streamArena_(streamArena) {
     auto types = rowType->children();
     auto numTypes = types.size();
-    streams_.resize(numTypes);
+    columns_.resize(numTypes);
     for (int i = 0; i < numTypes; i++) {
-      streams_[i] =
-          std::make_unique<VectorStream>(types[i], streamArena, numRows);
+      columns_[i] =
+          std::make_unique<EncodedColumn>(types[i], streamArena, numRows);
+    }
+    if (options &&
+        options->compressionKind != folly::io::CodecType::NO_COMPRESSION) {
+      codec_ = folly::io::getCodec(options->compressionKind);
+      minCompressionRatio_ = options->minCompressionRatio;
+      if (options->compressionStats) {
+        compressionStats_ = options->compressionStats;
+      }
     }
   }
 
@@ -1509,13 +1742,77 @@ class PrestoVectorSerializer : public VectorSerializer {
     if (newRows > 0) {
       numRows_ += newRows;
       for (int32_t i = 0; i < vector->childrenSize(); ++i) {
-        serializeColumn(vector->childAt(i).get(), ranges, streams_[i].get());
+        columns_[i]->append(vector->childAt(i), ranges, newRows);
       }
     }
   }
 
+  // Adds 'numRows' to the rows of the page. The caller appends their values
+  // to each of the columns.
+  void addRows(int32_t numRows) {
+    numRows_ += numRows;
+  }
+
+  EncodedColumn& column(column_index_t index) {
+    return *columns_[index];
+  }
+
   // Writes the contents to 'stream' in wire format
   void flush(OutputStream* out) override {
+    if (!codec_) {
+      flushUncompressed(out);
+      return;
+    }
+    auto& stats = *compressionStats_;
+    if (stats.pagesToSkip > 0) {
+      --stats.pagesToSkip;
+      ++stats.numSkippedPages;
+      flushUncompressed(out);
+      return;
+    }
+
+    // The columns are written to a buffer that is then compressed as a
+    // whole. The page is sent uncompressed if that does not save enough.
+    IOBufOutputStream columns(*streamArena_->mappedMemory());
+    writeColumns(&columns);
+    auto uncompressed = columns.getIOBuf();
+    const int32_t uncompressedSize = uncompressed->computeChainDataLength();
+    std::unique_ptr<folly::IOBuf> compressed;
+    {
+      MicrosecondTimer timer(&stats.compressionTimeUs);
+      compressed = codec_->compress(uncompressed.get());
+    }
+    const int32_t compressedSize = compressed->computeChainDataLength();
+    stats.compressionInputBytes += uncompressedSize;
+    stats.compressedBytes += compressedSize;
+    if (compressedSize > uncompressedSize * minCompressionRatio_) {
+      ++stats.numIncompressiblePages;
+      stats.pagesToSkip = stats.skipInterval;
+      stats.skipInterval = std::min(2 * stats.skipInterval, kMaxSkipInterval);
+      writePage(out, *uncompressed, uncompressedSize, false);
+    } else {
+      ++stats.numCompressedPages;
+      stats.skipInterval = 1;
+      writePage(out, *compressed, uncompressedSize, true);
+    }
+  }
+
+ private:
+  static const int32_t kSizeInBytesOffset{4 + 1};
+  static const int32_t kHeaderSize{kSizeInBytesOffset + 4 + 4 + 8};
+
+  // Upper limit for the number of pages sent without trying compression
+  // after a page that does not compress well.
+  static const int32_t kMaxSkipInterval{64};
+
+  void writeColumns(OutputStream* out) {
+    writeInt32(out, columns_.size());
+    for (auto& column : columns_) {
+      column->flush(out);
+    }
+  }
+
+  void flushUncompressed(OutputStream* out) {
     auto listener = dynamic_cast<PrestoOutputStreamListener*>(out->listener());
     // Reset CRC computation
     if (listener) {
@@ -1546,10 +1843,7 @@ class PrestoVectorSerializer : public VectorSerializer {
     if (listener) {
       listener->resume();
     }
-    writeInt32(out, streams_.size());
-    for (auto& stream : streams_) {
-      stream->flush(out);
-    }
+    writeColumns(out);
 
     // Pause CRC computation
     if (listener) {
@@ -1571,12 +1865,63 @@ class PrestoVectorSerializer : public VectorSerializer {
     out->seekp(offset + size);
   }
 
- private:
-  static const int32_t kSizeInBytesOffset{4 + 1};
-  static const int32_t kHeaderSize{kSizeInBytesOffset + 4 + 4 + 8};
+  // Writes a page with the columns in 'body'. 'body' is compressed if
+  // 'compressed' is true. The checksum covers the bytes as sent.
+  void writePage(
+      OutputStream* out,
+      const folly::IOBuf& body,
+      int32_t uncompressedSize,
+      bool compressed) {
+    auto listener = dynamic_cast<PrestoOutputStreamListener*>(out->listener());
+    if (listener) {
+      listener->reset();
+    }
+
+    char codec = 0;
+    if (listener) {
+      codec = getCodecMarker();
+    }
+    if (compressed) {
+      codec |= kCompressedBitMask;
+    }
+
+    int32_t offset = out->tellp();
+    if (listener) {
+      listener->pause();
+    }
+    writeInt32(out, numRows_);
+    out->write(&codec, 1);
+    writeInt32(out, uncompressedSize);
+    writeInt32(out, body.computeChainDataLength());
+    writeInt64(out, 0);
 
+    if (listener) {
+      listener->resume();
+    }
+    for (auto range : body) {
+      out->write(reinterpret_cast<const char*>(range.data()), range.size());
+    }
+    if (listener) {
+      listener->pause();
+      int32_t size = (int32_t)out->tellp() - offset;
+      auto crc = computeChecksum(listener, codec, numRows_, uncompressedSize);
+      out->seekp(offset + kHeaderSize - sizeof(int64_t));
+      writeInt64(out, crc);
+      out->seekp(offset + size);
+    }
+  }
+
+  StreamArena* const streamArena_;
   int32_t numRows_{0};
-  std::vector<std::unique_ptr<VectorStream>> streams_;
+  std::vector<std::unique_ptr<EncodedColumn>> columns_;
+
+  // Compresses the pages. nullptr if compression is off.
+  std::unique_ptr<folly::io::Codec> codec_;
+  double minCompressionRatio_{1};
+
+  // Used if the options give no counters.
+  VectorSerde::CompressionStats pageStats_;
+  VectorSerde::CompressionStats* compressionStats_{&pageStats_};
 };
 } // namespace
 
@@ -1590,15 +1935,66 @@ void PrestoVectorSerde::estimateSerializedSize(
 std::unique_ptr<VectorSerializer> PrestoVectorSerde::createSerializer(
     std::shared_ptr<const RowType> type,
     int32_t numRows,
-    StreamArena* streamArena) {
-  return std::make_unique<PrestoVectorSerializer>(type, numRows, streamArena);
+    StreamArena* streamArena,
+    const Options* options) {
+  return std::make_unique<PrestoVectorSerializer>(
+      type, numRows, streamArena, options);
+}
+
+void PrestoVectorSerde::appendPartitioned(
+    const RowVectorPtr& vector,
+    const std::vector<folly::Range<const IndexRange*>>& ranges,
+    const std::vector<VectorSerializer*>& serializers) {
+  VELOX_CHECK_EQ(ranges.size(), serializers.size());
+  std::vector<PrestoVectorSerializer*> targets;
+  std::vector<folly::Range<const IndexRange*>> targetRanges;
+  std::vector<int32_t> targetRows;
+  for (auto i = 0; i < serializers.size(); ++i) {
+    auto numRows = rangesTotalSize(ranges[i]);
+    if (numRows == 0) {
+      continue;
+    }
+    auto target = dynamic_cast<PrestoVectorSerializer*>(serializers[i]);
+    VELOX_CHECK_NOT_NULL(target);
+    target->addRows(numRows);
+    targets.push_back(target);
+    targetRanges.push_back(ranges[i]);
+    targetRows.push_back(numRows);
+  }
+  if (targets.empty()) {
+    return;
+  }
+
+  // Each column is written to all the targets before the next column, so
+  // that its values stay in cache. Flat columns are written to the streams
+  // of the targets with one type dispatch.
+  std::vector<VectorStream*> streams(targets.size());
+  for (auto column = 0; column < vector->childrenSize(); ++column) {
+    const auto& child = vector->childAt(column);
+    if (child->encoding() == VectorEncoding::Simple::FLAT) {
+      for (auto i = 0; i < targets.size(); ++i) {
+        streams[i] = targets[i]->column(column).flatStream();
+      }
+      VELOX_DYNAMIC_SCALAR_TYPE_DISPATCH_ALL(
+          scatterFlatVector,
+          child->typeKind(),
+          child.get(),
+          targetRanges,
+          streams);
+      continue;
+    }
+    for (auto i = 0; i < targets.size(); ++i) {
+      targets[i]->column(column).append(child, targetRanges[i], targetRows[i]);
+    }
+  }
 }
 
 void PrestoVectorSerde::deserialize(
     ByteStream* source,
     velox::memory::MemoryPool* pool,
     std::shared_ptr<const RowType> type,
-    std::shared_ptr<RowVector>* result) {
+    std::shared_ptr<RowVector>* result,
+    const Options* options) {
   auto numRows = source->read<int32_t>();
   if (!(*result) || !result->unique() || (*result)->type() != type) {
     *result = std::dynamic_pointer_cast<RowVector>(
@@ -1609,19 +2005,40 @@ void PrestoVectorSerde::deserialize(
 
   auto pageCodecMarker = source->read<int8_t>();
   auto uncompressedSize = source->read<int32_t>();
-  // skip size in bytes
-  source->skip(4);
+  auto sizeInBytes = source->read<int32_t>();
   auto checksum = source->read<int64_t>();
 
   int64_t actualCheckSum = 0;
   if (isChecksumBitSet(pageCodecMarker)) {
-    actualCheckSum =
-        computeChecksum(source, pageCodecMarker, numRows, uncompressedSize);
+    actualCheckSum = computeChecksum(
+        source, pageCodecMarker, numRows, uncompressedSize, sizeInBytes);
   }
 
   VELOX_CHECK_EQ(
       checksum, actualCheckSum, "Received corrupted serialized page.");
 
+  // The columns of a compressed page are read from the uncompressed copy.
+  ByteStream uncompressedSource;
+  std::unique_ptr<folly::IOBuf> uncompressed;
+  if (isCompressedBitSet(pageCodecMarker)) {
+    VELOX_CHECK(
+        options &&
+            options->compressionKind != folly::io::CodecType::NO_COMPRESSION,
+        "Received a compressed page but no compression codec is set");
+    auto compressed = folly::IOBuf::create(sizeInBytes);
+    source->readBytes(compressed->writableData(), sizeInBytes);
+    compressed->append(sizeInBytes);
+    uncompressed = folly::io::getCodec(options->compressionKind)
+                       ->uncompress(compressed.get(), uncompressedSize);
+    std::vector<ByteRange> ranges;
+    for (auto range : *uncompressed) {
+      ranges.push_back(ByteRange{
+          const_cast<uint8_t*>(range.data()), (int32_t)range.size(), 0});
+    }
+    uncompressedSource.resetInput(std::move(ranges));
+    source = &uncompressedSource;
+  }
+
   // skip number of columns
   source->skip(4);
 
@@ -28,13 +28,21 @@ class PrestoVectorSerde : public VectorSerde {
   std::unique_ptr<VectorSerializer> createSerializer(
       std::shared_ptr<const RowType> type,
       int32_t numRows,
-      StreamArena* streamArena) override;
+      StreamArena* streamArena,
+      const Options* options = nullptr) override;
+
+  /// Writes each column to all the serializers before the next column.
+  void appendPartitioned(
+      const std::shared_ptr<RowVector>& vector,
+      const std::vector<folly::Range<const IndexRange*>>& ranges,
+      const std::vector<VectorSerializer*>& serializers) override;
 
   void deserialize(
       ByteStream* source,
       velox::memory::MemoryPool* pool,
       std::shared_ptr<const RowType> type,
-      std::shared_ptr<RowVector>* result) override;
+      std::shared_ptr<RowVector>* result,
+      const Options* options = nullptr) override;
 
   static void registerVectorSerde();
 };
@@ -0,0 +1,209 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "velox/serializers/CompactRowSerializer.h"
+#include <folly/Random.h>
+#include <gtest/gtest.h>
+#include "velox/common/base/tests/GTestUtils.h"
+#include "velox/common/memory/ByteStream.h"
+#include "velox/vector/fuzzer/VectorFuzzer.h"
+#include "velox/vector/tests/VectorTestBase.h"
+
+using namespace facebook::velox;
+using namespace facebook::velox::test;
+
+class CompactRowSerializerTest : public ::testing::Test,
+                                 public VectorTestBase {
+ protected:
+  void SetUp() override {
+    serde_ = std::make_unique<serializer::CompactRowVectorSerde>();
+  }
+
+  // Serializes 'ranges' of each of 'vectors' to one page.
+  std::string serialize(
+      const std::vector<RowVectorPtr>& vectors,
+      const std::vector<std::vector<IndexRange>>& ranges) {
+    auto arena =
+        std::make_unique<StreamArena>(memory::MappedMemory::getInstance());
+    auto rowType = asRowType(vectors[0]->type());
+    auto serializer = serde_->createSerializer(rowType, 0, arena.get());
+    for (auto i = 0; i < vectors.size(); ++i) {
+      serializer->append(
+          vectors[i], folly::Range(ranges[i].data(), ranges[i].size()));
+    }
+    std::ostringstream output;
+    OStreamOutputStream out(&output);
+    serializer->flush(&out);
+    return output.str();
+  }
+
+  std::string serialize(const RowVectorPtr& vector) {
+    return serialize({vector}, {{IndexRange{0, vector->size()}}});
+  }
+
+  // Deserializes 'input' split into ranges of 'rangeSize' bytes, so that
+  // rows span ranges.
+  RowVectorPtr deserialize(
+      const RowTypePtr& rowType,
+      const std::string& input,
+      int32_t rangeSize = std::numeric_limits<int32_t>::max()) {
+    std::vector<ByteRange> ranges;
+    for (int32_t offset = 0; offset < input.size(); offset += rangeSize) {
+      ranges.push_back(ByteRange{
+          reinterpret_cast<uint8_t*>(const_cast<char*>(input.data())) +
+              offset,
+          std::min<int32_t>(rangeSize, input.size() - offset),
+          0});
+    }
+    ByteStream byteStream;
+    byteStream.resetInput(std::move(ranges));
+    RowVectorPtr result;
+    serde_->deserialize(&byteStream, pool_.get(), rowType, &result);
+    EXPECT_TRUE(byteStream.atEnd());
+    return result;
+  }
+
+  void testRoundTrip(const RowVectorPtr& vector) {
+    auto serialized = serialize(vector);
+    auto rowType = asRowType(vector->type());
+    assertEqualVectors(vector, deserialize(rowType, serialized));
+    assertEqualVectors(vector, deserialize(rowType, serialized, 7));
+  }
+
+  std::unique_ptr<VectorSerde> serde_;
+};
+
+TEST_F(CompactRowSerializerTest, primitives) {
+  auto vector = makeRowVector({
+      makeNullableFlatVector<bool>({true, std::nullopt, false, true}),
+      makeNullableFlatVector<int8_t>({1, 2, std::nullopt, 4}),
+      makeNullableFlatVector<int16_t>({1, 2, 3, std::nullopt}),
+      makeNullableFlatVector<int32_t>({std::nullopt, 2, 3, 4}),
+      makeFlatVector<int64_t>({1, -2, 3, 1LL << 40}),
+      makeFlatVector<float>({1.5, 2.5, 3.5, 4.5}),
+      makeNullableFlatVector<double>({1.25, std::nullopt, 3.25, 4.25}),
+      makeNullableFlatVector<Timestamp>(
+          {Timestamp(1, 2), std::nullopt, Timestamp(3, 4), Timestamp(0, 0)}),
+      makeNullableFlatVector<StringView>(
+          {"a", std::nullopt, "", "a string longer than 12 bytes"}),
+  });
+  testRoundTrip(vector);
+}
+
+TEST_F(CompactRowSerializerTest, complexTypes) {
+  auto vector = makeRowVector({
+      makeVectorWithNullArrays<int64_t>(
+          {{{1, 2, std::nullopt}}, std::nullopt, {{}}, {{4}}}),
+      makeVectorWithNullArrays<StringView>(
+          {{{"a", std::nullopt}},
+           {{"a string longer than 12 bytes"}},
+           std::nullopt,
+           {{}}}),
+      makeMapVector<int32_t, StringView>(
+          {{{1, "a"}, {2, "b"}}, {}, {{3, "a string longer than 12 bytes"}},
+           {{4, "d"}}}),
+      makeRowVector(
+          {makeFlatVector<int32_t>({1, 2, 3, 4}),
+           makeNullableFlatVector<StringView>({"x", "y", std::nullopt, "z"})},
+          [](vector_size_t row) { return row == 1; }),
+  });
+  testRoundTrip(vector);
+}
+
+TEST_F(CompactRowSerializerTest, fuzz) {
+  auto rowType = ROW(
+      {BOOLEAN(),
+       TINYINT(),
+       BIGINT(),
+       DOUBLE(),
+       VARCHAR(),
+       TIMESTAMP(),
+       DATE(),
+       ARRAY(VARCHAR()),
+       MAP(VARCHAR(), ARRAY(INTEGER())),
+       ROW({VARCHAR(), INTEGER(), ARRAY(BIGINT())})});
+
+  VectorFuzzer::Options opts;
+  opts.vectorSize = 100;
+  opts.nullRatio = 0.1;
+  opts.stringVariableLength = true;
+  opts.stringLength = 20;
+  opts.containerLength = 5;
+
+  auto seed = folly::Random::rand32();
+  LOG(INFO) << "seed: " << seed;
+  VectorFuzzer fuzzer(opts, pool_.get(), seed);
+  for (auto i = 0; i < 10; ++i) {
+    testRoundTrip(fuzzer.fuzzRow(rowType));
+  }
+}
+
+TEST_F(CompactRowSerializerTest, appendRanges) {
+  auto first = makeRowVector({
+      makeFlatVector<int64_t>({0, 1, 2, 3, 4}),
+      makeFlatVector<StringView>({"a", "b", "c", "d", "e"}),
+  });
+  auto second = makeRowVector({
+      makeFlatVector<int64_t>({10, 11, 12}),
+      makeFlatVector<StringView>({"x", "y", "z"}),
+  });
+  auto serialized = serialize(
+      {first, second},
+      {{IndexRange{1, 2}, IndexRange{4, 1}}, {IndexRange{0, 1}}});
+  auto expected = makeRowVector({
+      makeFlatVector<int64_t>({1, 2, 4, 10}),
+      makeFlatVector<StringView>({"b", "c", "e", "x"}),
+  });
+  assertEqualVectors(
+      expected, deserialize(asRowType(expected->type()), serialized));
+}
+
+TEST_F(CompactRowSerializerTest, estimateSerializedSize) {
+  auto vector = makeRowVector({
+      makeFlatVector<int64_t>({1, 2}),
+      makeFlatVector<StringView>({"a", "a string longer than 12 bytes"}),
+  });
+  std::vector<vector_size_t> sizes(2, 0);
+  std::vector<vector_size_t*> rawSizes{&sizes[0], &sizes[1]};
+  std::vector<IndexRange> ranges{{0, 1}, {1, 1}};
+  for (auto& child : vector->children()) {
+    serde_->estimateSerializedSize(
+        child, folly::Range(ranges.data(), ranges.size()), rawSizes.data());
+  }
+  // A null byte and a slot per column, plus the string.
+  EXPECT_EQ(sizes[0], 1 + 8 + 1 + 4 + 1);
+  EXPECT_EQ(sizes[1], 1 + 8 + 1 + 4 + 29);
+}
+
+TEST_F(CompactRowSerializerTest, compressionNotSupported) {
+  VectorSerde::Options options;
+  options.compressionKind = folly::io::CodecType::LZ4;
+  auto arena =
+      std::make_unique<StreamArena>(memory::MappedMemory::getInstance());
+  VELOX_ASSERT_THROW(
+      serde_->createSerializer(ROW({BIGINT()}), 1, arena.get(), &options),
+      "Compression is not supported with the compact_row serde");
+}
+
+TEST_F(CompactRowSerializerTest, namedSerde) {
+  if (!isRegisteredNamedVectorSerde(serializer::CompactRowVectorSerde::kName)) {
+    serializer::CompactRowVectorSerde::registerNamedVectorSerde();
+  }
+  auto* serde = getNamedVectorSerde(serializer::CompactRowVectorSerde::kName);
+  EXPECT_NE(dynamic_cast<serializer::CompactRowVectorSerde*>(serde), nullptr);
+  VELOX_ASSERT_THROW(
+      getNamedVectorSerde("no_such_serde"),
+      "Vector serde 'no_such_serde' is not registered");
+}
@@ -45,7 +45,10 @@ class PrestoSerializerTest : public ::testing::Test {
     serde_->estimateSerializedSize(rowVector, ranges, rawRowSizes.data());
   }
 
-  void serialize(RowVectorPtr rowVector, std::ostream* output) {
+  void serialize(
+      RowVectorPtr rowVector,
+      std::ostream* output,
+      const VectorSerde::Options* options = nullptr) {
     auto numRows = rowVector->size();
 
     std::vector<IndexRange> rows(numRows);
@@ -59,7 +62,8 @@ class PrestoSerializerTest : public ::testing::Test {
     auto arena =
         std::make_unique<StreamArena>(memory::MappedMemory::getInstance());
     auto rowType = std::dynamic_pointer_cast<const RowType>(rowVector->type());
-    auto serializer = serde_->createSerializer(rowType, numRows, arena.get());
+    auto serializer =
+        serde_->createSerializer(rowType, numRows, arena.get(), options);
 
     serializer->append(rowVector, folly::Range(rows.data(), numRows));
     facebook::velox::serializer::presto::PrestoOutputStreamListener listener;
@@ -79,14 +83,22 @@ class PrestoSerializerTest : public ::testing::Test {
 
   RowVectorPtr deserialize(
       std::shared_ptr<const RowType> rowType,
-      const std::string& input) {
+      const std::string& input,
+      const VectorSerde::Options* options = nullptr) {
     auto byteStream = toByteStream(input);
 
     RowVectorPtr result;
-    serde_->deserialize(byteStream.get(), pool_.get(), rowType, &result);
+    serde_->deserialize(
+        byteStream.get(), pool_.get(), rowType, &result, options);
     return result;
   }
 
+  // Returns true if the page at the start of 'bytes' is compressed.
+  static bool isCompressed(const std::string& bytes) {
+    // The codec marker follows the number of rows.
+    return bytes[sizeof(int32_t)] & 1;
+  }
+
   RowVectorPtr makeTestVector(vector_size_t size) {
     auto a = vectorMaker_->flatVector<int64_t>(
         size, [](vector_size_t row) { return row; });
@@ -263,3 +275,232 @@ TEST_F(PrestoSerializerTest, multiPage) {
   assertEqualVectors(deserialized, c);
   ASSERT_TRUE(byteStream->atEnd());
 }
+
+TEST_F(PrestoSerializerTest, constant) {
+  const vector_size_t size = 1'000;
+  auto rowVector = vectorMaker_->rowVector({
+      BaseVector::createConstant(
+          variant::create<TypeKind::BIGINT>(7), size, pool_.get()),
+      BaseVector::createConstant(
+          variant("some string that is not inlined"), size, pool_.get()),
+      BaseVector::createNullConstant(DOUBLE(), size, pool_.get()),
+  });
+
+  std::ostringstream out;
+  serialize(rowVector, &out);
+
+  auto rowType = std::dynamic_pointer_cast<const RowType>(rowVector->type());
+  auto deserialized = deserialize(rowType, out.str());
+  assertEqualVectors(deserialized, rowVector);
+  for (auto i = 0; i < deserialized->childrenSize(); ++i) {
+    EXPECT_EQ(
+        deserialized->childAt(i)->encoding(), VectorEncoding::Simple::CONSTANT);
+  }
+
+  // A constant column is sent as a single value.
+  std::ostringstream flatOut;
+  serialize(makeTestVector(size), &flatOut);
+  EXPECT_LT(out.str().size() * 10, flatOut.str().size());
+}
+
+TEST_F(PrestoSerializerTest, dictionary) {
+  const vector_size_t size = 1'000;
+  auto base = vectorMaker_->flatVector<StringView>(
+      10, [](auto row) { return StringView(std::string(20, 'a' + row)); });
+  BufferPtr indices = AlignedBuffer::allocate<vector_size_t>(size, pool_.get());
+  auto rawIndices = indices->asMutable<vector_size_t>();
+  for (auto i = 0; i < size; i++) {
+    rawIndices[i] = (i * 7) % 10;
+  }
+  auto rowVector = vectorMaker_->rowVector(
+      {BaseVector::wrapInDictionary(nullptr, indices, size, base)});
+
+  std::ostringstream out;
+  serialize(rowVector, &out);
+
+  auto rowType = std::dynamic_pointer_cast<const RowType>(rowVector->type());
+  auto deserialized = deserialize(rowType, out.str());
+  assertEqualVectors(deserialized, rowVector);
+  EXPECT_EQ(
+      deserialized->childAt(0)->encoding(), VectorEncoding::Simple::DICTIONARY);
+  EXPECT_EQ(deserialized->childAt(0)->valueVector()->size(), 10);
+}
+
+/// Appends batches whose constant values and dictionaries differ to one
+/// page. The columns fall back to flat encoding.
+TEST_F(PrestoSerializerTest, mixedEncodingsInPage) {
+  const vector_size_t size = 100;
+  auto base = vectorMaker_->flatVector<int64_t>(
+      10, [](auto row) { return row * 3; });
+  BufferPtr indices = AlignedBuffer::allocate<vector_size_t>(size, pool_.get());
+  auto rawIndices = indices->asMutable<vector_size_t>();
+  for (auto i = 0; i < size; i++) {
+    rawIndices[i] = i % 10;
+  }
+  auto makeBatch = [&](int64_t constant, const VectorPtr& dictionaryBase) {
+    return vectorMaker_->rowVector({
+        BaseVector::createConstant(
+            variant::create<TypeKind::BIGINT>(constant), size, pool_.get()),
+        BaseVector::wrapInDictionary(nullptr, indices, size, dictionaryBase),
+    });
+  };
+  std::vector<RowVectorPtr> batches = {
+      makeBatch(1, base),
+      makeBatch(1, base),
+      makeBatch(2, vectorMaker_->flatVector<int64_t>(
+                       10, [](auto row) { return row * 5; })),
+  };
+
+  auto rowType = std::dynamic_pointer_cast<const RowType>(batches[0]->type());
+  auto arena =
+      std::make_unique<StreamArena>(memory::MappedMemory::getInstance());
+  auto serializer =
+      serde_->createSerializer(rowType, size * batches.size(), arena.get());
+  IndexRange range{0, size};
+  auto expected = vectorMaker_->rowVector(
+      rowType, static_cast<vector_size_t>(size * batches.size()));
+  for (auto i = 0; i < batches.size(); ++i) {
+    serializer->append(batches[i], folly::Range(&range, 1));
+    expected->copy(batches[i].get(), i * size, 0, size);
+  }
+  std::ostringstream output;
+  facebook::velox::serializer::presto::PrestoOutputStreamListener listener;
+  OStreamOutputStream out(&output, &listener);
+  serializer->flush(&out);
+
+  auto deserialized = deserialize(rowType, output.str());
+  assertEqualVectors(deserialized, expected);
+}
+
+// Writing a batch to several pages a column at a time gives the same pages as
+// appending to each page in turn.
+TEST_F(PrestoSerializerTest, appendPartitioned) {
+  const vector_size_t size = 100;
+  BufferPtr indices = AlignedBuffer::allocate<vector_size_t>(size, pool_.get());
+  auto rawIndices = indices->asMutable<vector_size_t>();
+  for (auto i = 0; i < size; i++) {
+    rawIndices[i] = i % 10;
+  }
+  auto rowVector = vectorMaker_->rowVector({
+      vectorMaker_->flatVector<int64_t>(
+          size, [](auto row) { return row; }, VectorMaker::nullEvery(7)),
+      vectorMaker_->flatVector<bool>(size, [](auto row) { return row % 3; }),
+      vectorMaker_->flatVector<StringView>(
+          size,
+          [](auto row) {
+            return StringView(row % 2 ? "a string longer than 12" : "short");
+          },
+          VectorMaker::nullEvery(5)),
+      BaseVector::createConstant(
+          variant::create<TypeKind::BIGINT>(11), size, pool_.get()),
+      BaseVector::wrapInDictionary(
+          nullptr,
+          indices,
+          size,
+          vectorMaker_->flatVector<int32_t>(10, [](auto row) { return row; })),
+      vectorMaker_->arrayVector<int32_t>(
+          size,
+          [](auto row) { return row % 4; },
+          [](auto row) { return row; }),
+  });
+  auto rowType = asRowType(rowVector->type());
+
+  // Rows go round robin to 3 pages, the 3rd page gets no rows.
+  std::vector<std::vector<IndexRange>> rows(3);
+  for (auto i = 0; i < size; ++i) {
+    rows[i % 2].push_back(IndexRange{i, 1});
+  }
+  std::vector<folly::Range<const IndexRange*>> ranges;
+  for (auto& pageRows : rows) {
+    ranges.push_back(folly::Range(pageRows.data(), pageRows.size()));
+  }
+
+  auto arena =
+      std::make_unique<StreamArena>(memory::MappedMemory::getInstance());
+  std::vector<std::unique_ptr<VectorSerializer>> partitioned;
+  std::vector<std::unique_ptr<VectorSerializer>> expected;
+  std::vector<VectorSerializer*> serializers;
+  for (auto i = 0; i < rows.size(); ++i) {
+    partitioned.push_back(serde_->createSerializer(rowType, size, arena.get()));
+    serializers.push_back(partitioned.back().get());
+    expected.push_back(serde_->createSerializer(rowType, size, arena.get()));
+  }
+  // Two batches so that the second appends to pages with rows.
+  for (auto batch = 0; batch < 2; ++batch) {
+    serde_->appendPartitioned(rowVector, ranges, serializers);
+    for (auto i = 0; i < rows.size(); ++i) {
+      expected[i]->append(rowVector, ranges[i]);
+    }
+  }
+
+  auto toString = [](VectorSerializer& serializer) {
+    std::ostringstream output;
+    facebook::velox::serializer::presto::PrestoOutputStreamListener listener;
+    OStreamOutputStream out(&output, &listener);
+    serializer.flush(&out);
+    return output.str();
+  };
+  for (auto i = 0; i < rows.size(); ++i) {
+    EXPECT_EQ(toString(*partitioned[i]), toString(*expected[i]));
+  }
+}
+
+TEST_F(PrestoSerializerTest, compression) {
+  for (auto kind : {folly::io::CodecType::LZ4, folly::io::CodecType::ZSTD}) {
+    if (!folly::io::hasCodec(kind)) {
+      continue;
+    }
+    SCOPED_TRACE(folly::io::getCodec(kind)->getCodecName());
+    VectorSerde::CompressionStats stats;
+    VectorSerde::Options options;
+    options.compressionKind = kind;
+    options.compressionStats = &stats;
+
+    auto rowVector = vectorMaker_->rowVector(
+        {vectorMaker_->flatVector<int64_t>(
+             10'000, [](auto row) { return row % 7; }),
+         vectorMaker_->flatVector<StringView>(10'000, [](auto row) {
+           return StringView(row % 2 ? "some repeated string" : "another");
+         })});
+    std::ostringstream out;
+    serialize(rowVector, &out, &options);
+    std::ostringstream uncompressedOut;
+    serialize(rowVector, &uncompressedOut);
+
+    EXPECT_TRUE(isCompressed(out.str()));
+    EXPECT_EQ(stats.numCompressedPages, 1);
+    EXPECT_EQ(stats.compressedBytes + 21, out.str().size());
+    EXPECT_LT(out.str().size() * 5, uncompressedOut.str().size());
+
+    auto rowType = std::dynamic_pointer_cast<const RowType>(rowVector->type());
+    assertEqualVectors(deserialize(rowType, out.str(), &options), rowVector);
+    EXPECT_THROW(deserialize(rowType, out.str()), VeloxRuntimeError);
+  }
+}
+
+/// Pages that do not compress well are sent uncompressed. After each such
+/// page, compression is not tried for a number of pages that doubles for
+/// each incompressible page in a row.
+TEST_F(PrestoSerializerTest, incompressiblePages) {
+  if (!folly::io::hasCodec(folly::io::CodecType::LZ4)) {
+    return;
+  }
+  VectorSerde::CompressionStats stats;
+  VectorSerde::Options options;
+  options.compressionKind = folly::io::CodecType::LZ4;
+  options.compressionStats = &stats;
+
+  auto rowVector = vectorMaker_->rowVector({vectorMaker_->flatVector<int64_t>(
+      1'000, [](auto /*row*/) { return folly::Random::rand64(); })});
+  auto rowType = std::dynamic_pointer_cast<const RowType>(rowVector->type());
+  for (auto i = 0; i < 4; ++i) {
+    std::ostringstream out;
+    serialize(rowVector, &out, &options);
+    EXPECT_FALSE(isCompressed(out.str()));
+    assertEqualVectors(deserialize(rowType, out.str(), &options), rowVector);
+  }
+  EXPECT_EQ(stats.numCompressedPages, 0);
+  EXPECT_EQ(stats.numIncompressiblePages, 2);
+  EXPECT_EQ(stats.numSkippedPages, 2);
+  EXPECT_EQ(stats.pagesToSkip, 1);
+}
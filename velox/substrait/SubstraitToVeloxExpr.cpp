@@ -64,6 +64,17 @@ SubstraitVeloxExprConverter::toVeloxExpr(
   const auto& veloxType = toVeloxType(
       substraitParser_.parseType(substraitFunc.output_type())->type);
 
+  // Velox has no is_not_null. Express it as not(is_null) so that it can be
+  // evaluated and recognized as a null check by filter pushdown.
+  if (veloxFunction == "is_not_null") {
+    VELOX_CHECK_EQ(params.size(), 1);
+    std::vector<core::TypedExprPtr> isNull{
+        std::make_shared<const core::CallTypedExpr>(
+            BOOLEAN(), std::move(params), "is_null")};
+    return std::make_shared<const core::CallTypedExpr>(
+        veloxType, std::move(isNull), "not");
+  }
+
   return std::make_shared<const core::CallTypedExpr>(
       veloxType, std::move(params), veloxFunction);
 }
@@ -76,15 +87,33 @@ SubstraitVeloxExprConverter::toVeloxExpr(
     case ::substrait::Expression_Literal::LiteralTypeCase::kBoolean:
       return std::make_shared<core::ConstantTypedExpr>(
           variant(substraitLit.boolean()));
+    case ::substrait::Expression_Literal::LiteralTypeCase::kI8:
+      return std::make_shared<core::ConstantTypedExpr>(
+          variant(static_cast<int8_t>(substraitLit.i8())));
+    case ::substrait::Expression_Literal::LiteralTypeCase::kI16:
+      return std::make_shared<core::ConstantTypedExpr>(
+          variant(static_cast<int16_t>(substraitLit.i16())));
     case ::substrait::Expression_Literal::LiteralTypeCase::kI32:
       return std::make_shared<core::ConstantTypedExpr>(
           variant(substraitLit.i32()));
     case ::substrait::Expression_Literal::LiteralTypeCase::kI64:
       return std::make_shared<core::ConstantTypedExpr>(
           variant(substraitLit.i64()));
+    case ::substrait::Expression_Literal::LiteralTypeCase::kFp32:
+      return std::make_shared<core::ConstantTypedExpr>(
+          variant(substraitLit.fp32()));
     case ::substrait::Expression_Literal::LiteralTypeCase::kFp64:
       return std::make_shared<core::ConstantTypedExpr>(
           variant(substraitLit.fp64()));
+    case ::substrait::Expression_Literal::LiteralTypeCase::kString:
+      return std::make_shared<core::ConstantTypedExpr>(
+          variant(substraitLit.string()));
+    case ::substrait::Expression_Literal::LiteralTypeCase::kVarChar:
+      return std::make_shared<core::ConstantTypedExpr>(
+          variant(substraitLit.var_char().value()));
+    case ::substrait::Expression_Literal::LiteralTypeCase::kDate:
+      return std::make_shared<core::ConstantTypedExpr>(
+          variant(Date(substraitLit.date())));
     case ::substrait::Expression_Literal::LiteralTypeCase::kNull: {
       auto veloxType =
           toVeloxType(substraitParser_.parseType(substraitLit.null())->type);
@@ -112,6 +141,28 @@ SubstraitVeloxExprConverter::toVeloxExpr(
   return std::make_shared<core::CastTypedExpr>(type, inputs, nullOnFailure);
 }
 
+std::shared_ptr<const core::ITypedExpr>
+SubstraitVeloxExprConverter::toVeloxExpr(
+    const ::substrait::Expression::SingularOrList& singularOrList,
+    const RowTypePtr& inputType) {
+  auto value = toVeloxExpr(singularOrList.value(), inputType);
+  std::vector<variant> options;
+  options.reserve(singularOrList.options().size());
+  for (const auto& option : singularOrList.options()) {
+    VELOX_CHECK(
+        option.has_literal(),
+        "Only literal options are supported in SingularOrList.");
+    options.emplace_back(toVeloxExpr(option.literal())->value());
+  }
+
+  std::vector<core::TypedExprPtr> params{
+      value,
+      std::make_shared<const core::ConstantTypedExpr>(
+          ARRAY(value->type()), variant::array(std::move(options)))};
+  return std::make_shared<const core::CallTypedExpr>(
+      BOOLEAN(), std::move(params), "in");
+}
+
 std::shared_ptr<const core::ITypedExpr>
 SubstraitVeloxExprConverter::toVeloxExpr(
     const ::substrait::Expression& substraitExpr,
@@ -127,6 +178,8 @@ SubstraitVeloxExprConverter::toVeloxExpr(
       return toVeloxExpr(substraitExpr.selection(), inputType);
     case ::substrait::Expression::RexTypeCase::kCast:
       return toVeloxExpr(substraitExpr.cast(), inputType);
+    case ::substrait::Expression::RexTypeCase::kSingularOrList:
+      return toVeloxExpr(substraitExpr.singular_or_list(), inputType);
     default:
       VELOX_NYI(
           "Substrait conversion not supported for Expression '{}'", typeCase);
@@ -15,6 +15,7 @@
  */
 
 #include "velox/substrait/SubstraitToVeloxPlan.h"
+#include "velox/expression/ExprToSubfieldFilter.h"
 #include "velox/substrait/TypeUtils.h"
 #include "velox/type/Type.h"
 #include "velox/vector/ComplexVector.h"
@@ -228,6 +229,7 @@ core::PlanNodePtr SubstraitVeloxPlanConverter::toVeloxPlan(
         aggOutNames,
         aggExprs,
         aggregateMasks,
+        {},
         ignoreNullKeys,
         childNode);
   } else {
@@ -251,6 +253,7 @@ core::PlanNodePtr SubstraitVeloxPlanConverter::toVeloxPlan(
         aggOutNames,
         aggExprs,
         aggregateMasks,
+        {},
         ignoreNullKeys,
         projectNode);
   }
@@ -358,39 +361,56 @@ core::PlanNodePtr SubstraitVeloxPlanConverter::toVeloxPlan(
 
   // Velox requires Filter Pushdown must being enabled.
   bool filterPushdownEnabled = true;
-  std::shared_ptr<connector::hive::HiveTableHandle> tableHandle;
-  if (!readRel.has_filter()) {
-    tableHandle = std::make_shared<connector::hive::HiveTableHandle>(
-        kHiveConnectorId,
-        "hive_table",
-        filterPushdownEnabled,
-        connector::hive::SubfieldFilters{},
-        nullptr);
+  connector::hive::SubfieldFilters subfieldFilters;
+  core::TypedExprPtr remainingFilter;
+  if (readRel.has_filter()) {
+    remainingFilter = toVeloxFilter(
+        ROW(std::vector<std::string>(colNameList),
+            std::vector<TypePtr>(veloxTypeList)),
+        readRel.filter(),
+        subfieldFilters);
+  }
+  auto tableHandle = std::make_shared<connector::hive::HiveTableHandle>(
+      kHiveConnectorId,
+      "hive_table",
+      filterPushdownEnabled,
+      std::move(subfieldFilters),
+      remainingFilter);
+
+  // The columns to project out. Columns that are only referenced by the
+  // filters are read by the data source without being assigned.
+  std::vector<int32_t> projectedColumns;
+  if (readRel.has_projection() && !readRel.has_virtual_table()) {
+    for (const auto& item : readRel.projection().select().struct_items()) {
+      VELOX_CHECK_LT(
+          item.field(),
+          colNameList.size(),
+          "Projected field is out of the base schema.");
+      projectedColumns.emplace_back(item.field());
+    }
   } else {
-    connector::hive::SubfieldFilters filters =
-        toVeloxFilter(colNameList, veloxTypeList, readRel.filter());
-    tableHandle = std::make_shared<connector::hive::HiveTableHandle>(
-        kHiveConnectorId,
-        "hive_table",
-        filterPushdownEnabled,
-        std::move(filters),
-        nullptr);
+    projectedColumns.resize(colNameList.size());
+    std::iota(projectedColumns.begin(), projectedColumns.end(), 0);
   }
 
   // Get assignments and out names.
   std::vector<std::string> outNames;
-  outNames.reserve(colNameList.size());
+  std::vector<TypePtr> outTypes;
+  outNames.reserve(projectedColumns.size());
+  outTypes.reserve(projectedColumns.size());
   std::unordered_map<std::string, std::shared_ptr<connector::ColumnHandle>>
       assignments;
-  for (int idx = 0; idx < colNameList.size(); idx++) {
+  for (int idx = 0; idx < projectedColumns.size(); idx++) {
+    auto column = projectedColumns[idx];
     auto outName = substraitParser_->makeNodeName(planNodeId_, idx);
     assignments[outName] = std::make_shared<connector::hive::HiveColumnHandle>(
-        colNameList[idx],
+        colNameList[column],
         connector::hive::HiveColumnHandle::ColumnType::kRegular,
-        veloxTypeList[idx]);
+        veloxTypeList[column]);
     outNames.emplace_back(outName);
+    outTypes.emplace_back(veloxTypeList[column]);
   }
-  auto outputType = ROW(std::move(outNames), std::move(veloxTypeList));
+  auto outputType = ROW(std::move(outNames), std::move(outTypes));
 
   if (readRel.has_virtual_table()) {
     return toVeloxPlan(readRel, pool, outputType);
@@ -518,171 +538,59 @@ std::string SubstraitVeloxPlanConverter::nextPlanNodeId() {
   return id;
 }
 
-// This class contains the needed infos for Filter Pushdown.
-// TODO: Support different types here.
-class FilterInfo {
- public:
-  // Used to set the left bound.
-  void setLeft(double left, bool isExclusive) {
-    left_ = left;
-    leftExclusive_ = isExclusive;
-    if (!isInitialized_) {
-      isInitialized_ = true;
+core::TypedExprPtr SubstraitVeloxPlanConverter::toVeloxFilter(
+    const RowTypePtr& inputType,
+    const ::substrait::Expression& substraitFilter,
+    connector::hive::SubfieldFilters& subfieldFilters) {
+  std::vector<core::TypedExprPtr> conjuncts;
+  flattenConjuncts(
+      exprConverter_->toVeloxExpr(substraitFilter, inputType), conjuncts);
+
+  std::vector<core::TypedExprPtr> remaining;
+  for (const auto& conjunct : conjuncts) {
+    std::pair<common::Subfield, std::unique_ptr<common::Filter>> filter;
+    try {
+      filter = exec::toSubfieldFilter(conjunct);
+    } catch (const VeloxException&) {
+      // Not a range, IN-list or null check on a column.
+      remaining.emplace_back(conjunct);
+      continue;
     }
-  }
 
-  // Used to set the right bound.
-  void setRight(double right, bool isExclusive) {
-    right_ = right;
-    rightExclusive_ = isExclusive;
-    if (!isInitialized_) {
-      isInitialized_ = true;
+    auto it = subfieldFilters.find(filter.first);
+    if (it == subfieldFilters.end()) {
+      subfieldFilters[std::move(filter.first)] = std::move(filter.second);
+      continue;
     }
-  }
-
-  // Will fordis Null value if called once.
-  void forbidsNull() {
-    nullAllowed_ = false;
-    if (!isInitialized_) {
-      isInitialized_ = true;
+    // Several conjuncts on one column, e.g. both bounds of a range, are
+    // merged if the filter kinds allow it.
+    try {
+      it->second = it->second->mergeWith(filter.second.get());
+    } catch (const VeloxException&) {
+      remaining.emplace_back(conjunct);
     }
   }
 
-  // Return the initialization status.
-  bool isInitialized() {
-    return isInitialized_ ? true : false;
+  if (remaining.empty()) {
+    return nullptr;
   }
-
-  // The left bound.
-  std::optional<double> left_ = std::nullopt;
-  // The right bound.
-  std::optional<double> right_ = std::nullopt;
-  // The Null allowing.
-  bool nullAllowed_ = true;
-  // If true, left bound will be exclusive.
-  bool leftExclusive_ = false;
-  // If true, right bound will be exclusive.
-  bool rightExclusive_ = false;
-
- private:
-  bool isInitialized_ = false;
-};
-
-connector::hive::SubfieldFilters SubstraitVeloxPlanConverter::toVeloxFilter(
-    const std::vector<std::string>& inputNameList,
-    const std::vector<TypePtr>& inputTypeList,
-    const ::substrait::Expression& substraitFilter) {
-  connector::hive::SubfieldFilters filters;
-  // A map between the column index and the FilterInfo for that column.
-  std::unordered_map<int, std::shared_ptr<FilterInfo>> colInfoMap;
-  for (int idx = 0; idx < inputNameList.size(); idx++) {
-    colInfoMap[idx] = std::make_shared<FilterInfo>();
+  if (remaining.size() == 1) {
+    return remaining[0];
   }
-
-  std::vector<::substrait::Expression_ScalarFunction> scalarFunctions;
-  flattenConditions(substraitFilter, scalarFunctions);
-  // Construct the FilterInfo for the related column.
-  for (const auto& scalarFunction : scalarFunctions) {
-    auto filterNameSpec = substraitParser_->findFunctionSpec(
-        functionMap_, scalarFunction.function_reference());
-    auto filterName = substraitParser_->getFunctionName(filterNameSpec);
-    int32_t colIdx;
-    // TODO: Add different types' support here.
-    double val;
-    for (auto& param : scalarFunction.args()) {
-      auto typeCase = param.rex_type_case();
-      switch (typeCase) {
-        case ::substrait::Expression::RexTypeCase::kSelection: {
-          auto sel = param.selection();
-          // TODO: Only direct reference is considered here.
-          auto dRef = sel.direct_reference();
-          colIdx = substraitParser_->parseReferenceSegment(dRef);
-          break;
-        }
-        case ::substrait::Expression::RexTypeCase::kLiteral: {
-          auto sLit = param.literal();
-          // TODO: Only double is considered here.
-          val = sLit.fp64();
-          break;
-        }
-        default:
-          VELOX_NYI(
-              "Substrait conversion not supported for arg type '{}'", typeCase);
-      }
-    }
-    if (filterName == "is_not_null") {
-      colInfoMap[colIdx]->forbidsNull();
-    } else if (filterName == "gte") {
-      colInfoMap[colIdx]->setLeft(val, false);
-    } else if (filterName == "gt") {
-      colInfoMap[colIdx]->setLeft(val, true);
-    } else if (filterName == "lte") {
-      colInfoMap[colIdx]->setRight(val, false);
-    } else if (filterName == "lt") {
-      colInfoMap[colIdx]->setRight(val, true);
-    } else {
-      VELOX_NYI(
-          "Substrait conversion not supported for filter name '{}'",
-          filterName);
-    }
-  }
-
-  // Construct the Filters.
-  for (int idx = 0; idx < inputNameList.size(); idx++) {
-    auto filterInfo = colInfoMap[idx];
-    double leftBound;
-    double rightBound;
-    bool leftUnbounded = true;
-    bool rightUnbounded = true;
-    bool leftExclusive = false;
-    bool rightExclusive = false;
-    if (filterInfo->isInitialized()) {
-      if (filterInfo->left_) {
-        leftUnbounded = false;
-        leftBound = filterInfo->left_.value();
-        leftExclusive = filterInfo->leftExclusive_;
-      }
-      if (filterInfo->right_) {
-        rightUnbounded = false;
-        rightBound = filterInfo->right_.value();
-        rightExclusive = filterInfo->rightExclusive_;
-      }
-      bool nullAllowed = filterInfo->nullAllowed_;
-      filters[common::Subfield(inputNameList[idx])] =
-          std::make_unique<common::DoubleRange>(
-              leftBound,
-              leftUnbounded,
-              leftExclusive,
-              rightBound,
-              rightUnbounded,
-              rightExclusive,
-              nullAllowed);
-    }
-  }
-  return filters;
+  return std::make_shared<const core::CallTypedExpr>(
+      BOOLEAN(), std::move(remaining), "and");
 }
 
-void SubstraitVeloxPlanConverter::flattenConditions(
-    const ::substrait::Expression& substraitFilter,
-    std::vector<::substrait::Expression_ScalarFunction>& scalarFunctions) {
-  auto typeCase = substraitFilter.rex_type_case();
-  switch (typeCase) {
-    case ::substrait::Expression::RexTypeCase::kScalarFunction: {
-      auto sFunc = substraitFilter.scalar_function();
-      auto filterNameSpec = substraitParser_->findFunctionSpec(
-          functionMap_, sFunc.function_reference());
-      // TODO: Only and relation is supported here.
-      if (substraitParser_->getFunctionName(filterNameSpec) == "and") {
-        for (const auto& sCondition : sFunc.args()) {
-          flattenConditions(sCondition, scalarFunctions);
-        }
-      } else {
-        scalarFunctions.emplace_back(sFunc);
-      }
-      break;
+void SubstraitVeloxPlanConverter::flattenConjuncts(
+    const core::TypedExprPtr& expr,
+    std::vector<core::TypedExprPtr>& conjuncts) {
+  auto call = std::dynamic_pointer_cast<const core::CallTypedExpr>(expr);
+  if (call && call->name() == "and") {
+    for (const auto& input : call->inputs()) {
+      flattenConjuncts(input, conjuncts);
     }
-    default:
-      VELOX_NYI("GetFlatConditions not supported for type '{}'", typeCase);
+  } else {
+    conjuncts.emplace_back(expr);
   }
 }
 
@@ -114,20 +114,22 @@ class SubstraitVeloxPlanConverter {
   /// starting from zero.
   std::string nextPlanNodeId();
 
-  /// Used to convert Substrait Filter into Velox SubfieldFilters which will
-  /// be used in TableScan.
-  connector::hive::SubfieldFilters toVeloxFilter(
-      const std::vector<std::string>& inputNameList,
-      const std::vector<TypePtr>& inputTypeList,
-      const ::substrait::Expression& substraitFilter);
+  /// Converts the filter of a ReadRel over the columns in 'inputType'.
+  /// Conjuncts that are range, IN-list or null checks on a column are added
+  /// to 'subfieldFilters'. Returns the conjunction of the other conjuncts,
+  /// to be evaluated as the remaining filter of the scan, or nullptr if
+  /// there are none.
+  core::TypedExprPtr toVeloxFilter(
+      const RowTypePtr& inputType,
+      const ::substrait::Expression& substraitFilter,
+      connector::hive::SubfieldFilters& subfieldFilters);
 
   /// Multiple conditions are connected to a binary tree structure with
-  /// the relation key words, including AND, OR, and etc. Currently, only
-  /// AND is supported. This function is used to extract all the Substrait
-  /// conditions in the binary tree structure into a vector.
-  void flattenConditions(
-      const ::substrait::Expression& substraitFilter,
-      std::vector<::substrait::Expression_ScalarFunction>& scalarFunctions);
+  /// AND. This function is used to extract the conditions in the tree into
+  /// a vector.
+  static void flattenConjuncts(
+      const core::TypedExprPtr& expr,
+      std::vector<core::TypedExprPtr>& conjuncts);
 
   /// The Substrait parser used to convert Substrait representations into
   /// recognizable representations.
@@ -234,6 +234,10 @@ void VeloxToSubstraitPlanConvertor::toSubstrait(
   // AggregatesSize should be equal to or greater than the aggregateMasks Size.
   // Two cases: 1. aggregateMasksSize = 0, aggregatesSize > aggregateMasksSize.
   // 2. aggregateMasksSize != 0, aggregatesSize = aggregateMasksSize.
+  if (aggregateNode->hasDistinctAggregates()) {
+    VELOX_NYI("Substrait conversion of distinct aggregates is not supported");
+  }
+
   auto aggregates = aggregateNode->aggregates();
   auto aggregateMasks = aggregateNode->aggregateMasks();
   int64_t aggregatesSize = aggregates.size();
@@ -30,6 +30,37 @@ using namespace facebook::velox::test;
 using namespace facebook::velox::connector::hive;
 using namespace facebook::velox::exec;
 
+namespace {
+::substrait::Expression makeField(int32_t index) {
+  ::substrait::Expression expr;
+  expr.mutable_selection()
+      ->mutable_direct_reference()
+      ->mutable_struct_field()
+      ->set_field(index);
+  return expr;
+}
+
+// Makes a call of the function with anchor 'function' returning a boolean
+// or, if 'isBoolean' is false, a double.
+::substrait::Expression makeCall(
+    uint32_t function,
+    const std::vector<::substrait::Expression>& args,
+    bool isBoolean = true) {
+  ::substrait::Expression expr;
+  auto* call = expr.mutable_scalar_function();
+  call->set_function_reference(function);
+  for (const auto& arg : args) {
+    *call->add_args() = arg;
+  }
+  if (isBoolean) {
+    call->mutable_output_type()->mutable_bool_();
+  } else {
+    call->mutable_output_type()->mutable_fp64();
+  }
+  return expr;
+}
+} // namespace
+
 class Substrait2VeloxPlanConversionTest
     : public exec::test::HiveConnectorTestBase {
  protected:
@@ -286,3 +317,99 @@ TEST_F(Substrait2VeloxPlanConversionTest, q6) {
       .splits(makeSplits(planConverter, planNode))
       .assertResults(expectedResult);
 }
+
+// Scans c0 BIGINT, c1 DOUBLE and c2 VARCHAR with the filter
+//
+//  c0 >= 10 AND c0 < 20 AND c1 IS NOT NULL AND c2 IN ('a', 'b') AND
+//  c1 * c1 > 4.0
+//
+// and projects out only c1. The conjuncts on a single column become subfield
+// filters and the comparison of the product becomes the remaining filter.
+TEST_F(Substrait2VeloxPlanConversionTest, readRelFilterPushdown) {
+  writeToFile(
+      tmpDir_->path + "/filter_pushdown.orc",
+      {makeRowVector(
+          {"c0", "c1", "c2"},
+          {makeFlatVector<int64_t>({5, 10, 15, 19, 20}),
+           makeNullableFlatVector<double>({1.0, 3.0, std::nullopt, 2.5, 5.0}),
+           makeFlatVector<std::string>({"a", "a", "b", "b", "c"})})});
+
+  ::substrait::Plan plan;
+  const std::vector<std::string> functions = {
+      "and:bool_bool",
+      "gte:i64_i64",
+      "lt:i64_i64",
+      "is_not_null:fp64",
+      "gt:fp64_fp64",
+      "multiply:fp64_fp64"};
+  for (auto i = 0; i < functions.size(); ++i) {
+    auto* function = plan.add_extensions()->mutable_extension_function();
+    function->set_function_anchor(i);
+    function->set_name(functions[i]);
+  }
+
+  auto* readRel = plan.add_relations()->mutable_rel()->mutable_read();
+  auto* schema = readRel->mutable_base_schema();
+  for (const auto& name : {"c0", "c1", "c2"}) {
+    schema->add_names(name);
+  }
+  schema->mutable_struct_()->add_types()->mutable_i64();
+  schema->mutable_struct_()->add_types()->mutable_fp64();
+  schema->mutable_struct_()->add_types()->mutable_string();
+  auto* file = readRel->mutable_local_files()->add_items();
+  file->set_uri_file("/filter_pushdown.orc");
+  file->set_length(std::numeric_limits<uint64_t>::max());
+
+  ::substrait::Expression ten;
+  ten.mutable_literal()->set_i64(10);
+  ::substrait::Expression twenty;
+  twenty.mutable_literal()->set_i64(20);
+  ::substrait::Expression four;
+  four.mutable_literal()->set_fp64(4.0);
+  ::substrait::Expression inList;
+  auto* orList = inList.mutable_singular_or_list();
+  *orList->mutable_value() = makeField(2);
+  orList->add_options()->mutable_literal()->set_string("a");
+  orList->add_options()->mutable_literal()->set_string("b");
+
+  *readRel->mutable_filter() = makeCall(
+      0,
+      {makeCall(1, {makeField(0), ten}),
+       makeCall(2, {makeField(0), twenty}),
+       makeCall(3, {makeField(1)}),
+       inList,
+       makeCall(4, {makeCall(5, {makeField(1), makeField(1)}, false), four})});
+  readRel->mutable_projection()
+      ->mutable_select()
+      ->add_struct_items()
+      ->set_field(1);
+
+  facebook::velox::substrait::SubstraitVeloxPlanConverter planConverter;
+  auto planNode = planConverter.toVeloxPlan(plan, pool_.get());
+
+  auto scan = std::dynamic_pointer_cast<const core::TableScanNode>(planNode);
+  ASSERT_TRUE(scan != nullptr);
+  ASSERT_EQ(1, scan->outputType()->size());
+  EXPECT_EQ(*DOUBLE(), *scan->outputType()->childAt(0));
+  auto tableHandle =
+      std::dynamic_pointer_cast<HiveTableHandle>(scan->tableHandle());
+  const auto& filters = tableHandle->subfieldFilters();
+  ASSERT_EQ(3, filters.size());
+  EXPECT_EQ(
+      common::FilterKind::kBigintRange,
+      filters.at(common::Subfield("c0"))->kind());
+  EXPECT_EQ(
+      common::FilterKind::kIsNotNull,
+      filters.at(common::Subfield("c1"))->kind());
+  EXPECT_EQ(
+      common::FilterKind::kBytesValues,
+      filters.at(common::Subfield("c2"))->kind());
+  auto remainingFilter = std::dynamic_pointer_cast<const core::CallTypedExpr>(
+      tableHandle->remainingFilter());
+  ASSERT_TRUE(remainingFilter != nullptr);
+  EXPECT_EQ("gt", remainingFilter->name());
+
+  exec::test::AssertQueryBuilder(planNode)
+      .splits(makeSplits(planConverter, planNode))
+      .assertResults(makeRowVector({makeFlatVector<double>({3.0, 2.5})}));
+}
@@ -147,6 +147,13 @@ size_t getRowCount(Table table, size_t scaleFactor) {
   return 0; // make gcc happy.
 }
 
+size_t getGeneratorRowCount(Table table, size_t scaleFactor) {
+  if (table == Table::TBL_LINEITEM) {
+    return getRowCount(Table::TBL_ORDERS, scaleFactor);
+  }
+  return getRowCount(table, scaleFactor);
+}
+
 RowTypePtr getTableSchema(Table table) {
   switch (table) {
     case Table::TBL_PART: {
@@ -360,14 +367,15 @@ RowVectorPtr genTpchOrders(
       getRowCount(Table::TBL_ORDERS, scaleFactor), maxRows, offset);
   auto children = allocateVectors(ordersRowType, vectorSize, pool);
 
-  auto orderKeyVector = children[0]->asFlatVector<int64_t>();
-  auto custKeyVector = children[1]->asFlatVector<int64_t>();
+  auto rawOrderKey = children[0]->asFlatVector<int64_t>()->mutableRawValues();
+  auto rawCustKey = children[1]->asFlatVector<int64_t>()->mutableRawValues();
   auto orderStatusVector = children[2]->asFlatVector<StringView>();
-  auto totalPriceVector = children[3]->asFlatVector<double>();
+  auto rawTotalPrice = children[3]->asFlatVector<double>()->mutableRawValues();
   auto orderDateVector = children[4]->asFlatVector<StringView>();
   auto orderPriorityVector = children[5]->asFlatVector<StringView>();
   auto clerkVector = children[6]->asFlatVector<StringView>();
-  auto shipPriorityVector = children[7]->asFlatVector<int32_t>();
+  auto rawShipPriority =
+      children[7]->asFlatVector<int32_t>()->mutableRawValues();
   auto commentVector = children[8]->asFlatVector<StringView>();
 
   DBGenIterator dbgenIt(scaleFactor);
@@ -379,15 +387,15 @@ RowVectorPtr genTpchOrders(
   for (size_t i = 0; i < vectorSize; ++i) {
     dbgenIt.genOrder(i + offset + 1, order);
 
-    orderKeyVector->set(i, order.okey);
-    custKeyVector->set(i, order.custkey);
+    rawOrderKey[i] = order.okey;
+    rawCustKey[i] = order.custkey;
     orderStatusVector->set(i, StringView(&order.orderstatus, 1));
-    totalPriceVector->set(i, decimalToDouble(order.totalprice));
+    rawTotalPrice[i] = decimalToDouble(order.totalprice);
     orderDateVector->set(i, StringView(order.odate, strlen(order.odate)));
     orderPriorityVector->set(
         i, StringView(order.opriority, strlen(order.opriority)));
     clerkVector->set(i, StringView(order.clerk, strlen(order.clerk)));
-    shipPriorityVector->set(i, order.spriority);
+    rawShipPriority[i] = order.spriority;
     commentVector->set(i, StringView(order.comment, order.clen));
   }
   return std::make_shared<RowVector>(
@@ -409,15 +417,16 @@ RowVectorPtr genTpchLineItem(
   auto lineItemRowType = getTableSchema(Table::TBL_LINEITEM);
   auto children = allocateVectors(lineItemRowType, lineItemUpperBound, pool);
 
-  auto orderKeyVector = children[0]->asFlatVector<int64_t>();
-  auto partKeyVector = children[1]->asFlatVector<int64_t>();
-  auto suppKeyVector = children[2]->asFlatVector<int64_t>();
-  auto lineNumberVector = children[3]->asFlatVector<int32_t>();
+  auto rawOrderKey = children[0]->asFlatVector<int64_t>()->mutableRawValues();
+  auto rawPartKey = children[1]->asFlatVector<int64_t>()->mutableRawValues();
+  auto rawSuppKey = children[2]->asFlatVector<int64_t>()->mutableRawValues();
+  auto rawLineNumber = children[3]->asFlatVector<int32_t>()->mutableRawValues();
 
-  auto quantityVector = children[4]->asFlatVector<double>();
-  auto extendedPriceVector = children[5]->asFlatVector<double>();
-  auto discountVector = children[6]->asFlatVector<double>();
-  auto taxVector = children[7]->asFlatVector<double>();
+  auto rawQuantity = children[4]->asFlatVector<double>()->mutableRawValues();
+  auto rawExtendedPrice =
+      children[5]->asFlatVector<double>()->mutableRawValues();
+  auto rawDiscount = children[6]->asFlatVector<double>()->mutableRawValues();
+  auto rawTax = children[7]->asFlatVector<double>()->mutableRawValues();
 
   auto returnFlagVector = children[8]->asFlatVector<StringView>();
   auto lineStatusVector = children[9]->asFlatVector<StringView>();
@@ -443,34 +452,30 @@ RowVectorPtr genTpchLineItem(
 
     for (size_t l = 0; l < order.lines; ++l) {
       const auto& line = order.l[l];
-      orderKeyVector->set(lineItemCount + l, line.okey);
-      partKeyVector->set(lineItemCount + l, line.partkey);
-      suppKeyVector->set(lineItemCount + l, line.suppkey);
+      const auto row = lineItemCount + l;
+      rawOrderKey[row] = line.okey;
+      rawPartKey[row] = line.partkey;
+      rawSuppKey[row] = line.suppkey;
 
-      lineNumberVector->set(lineItemCount + l, line.lcnt);
+      rawLineNumber[row] = line.lcnt;
 
-      quantityVector->set(lineItemCount + l, decimalToDouble(line.quantity));
-      extendedPriceVector->set(lineItemCount + l, decimalToDouble(line.eprice));
-      discountVector->set(lineItemCount + l, decimalToDouble(line.discount));
-      taxVector->set(lineItemCount + l, decimalToDouble(line.tax));
+      rawQuantity[row] = decimalToDouble(line.quantity);
+      rawExtendedPrice[row] = decimalToDouble(line.eprice);
+      rawDiscount[row] = decimalToDouble(line.discount);
+      rawTax[row] = decimalToDouble(line.tax);
 
-      returnFlagVector->set(lineItemCount + l, StringView(line.rflag, 1));
-      lineStatusVector->set(lineItemCount + l, StringView(line.lstatus, 1));
+      returnFlagVector->set(row, StringView(line.rflag, 1));
+      lineStatusVector->set(row, StringView(line.lstatus, 1));
 
-      shipDateVector->set(
-          lineItemCount + l, StringView(line.sdate, strlen(line.sdate)));
-      commitDateVector->set(
-          lineItemCount + l, StringView(line.cdate, strlen(line.cdate)));
-      receiptDateVector->set(
-          lineItemCount + l, StringView(line.rdate, strlen(line.rdate)));
+      shipDateVector->set(row, StringView(line.sdate, strlen(line.sdate)));
+      commitDateVector->set(row, StringView(line.cdate, strlen(line.cdate)));
+      receiptDateVector->set(row, StringView(line.rdate, strlen(line.rdate)));
 
       shipInstructVector->set(
-          lineItemCount + l,
-          StringView(line.shipinstruct, strlen(line.shipinstruct)));
+          row, StringView(line.shipinstruct, strlen(line.shipinstruct)));
       shipModeVector->set(
-          lineItemCount + l, StringView(line.shipmode, strlen(line.shipmode)));
-      commentVector->set(
-          lineItemCount + l, StringView(line.comment, strlen(line.comment)));
+          row, StringView(line.shipmode, strlen(line.shipmode)));
+      commentVector->set(row, StringView(line.comment, strlen(line.comment)));
     }
     lineItemCount += order.lines;
   }
@@ -498,14 +503,14 @@ RowVectorPtr genTpchPart(
       getVectorSize(getRowCount(Table::TBL_PART, scaleFactor), maxRows, offset);
   auto children = allocateVectors(partRowType, vectorSize, pool);
 
-  auto partKeyVector = children[0]->asFlatVector<int64_t>();
+  auto rawPartKey = children[0]->asFlatVector<int64_t>()->mutableRawValues();
   auto nameVector = children[1]->asFlatVector<StringView>();
   auto mfgrVector = children[2]->asFlatVector<StringView>();
   auto brandVector = children[3]->asFlatVector<StringView>();
   auto typeVector = children[4]->asFlatVector<StringView>();
-  auto sizeVector = children[5]->asFlatVector<int32_t>();
+  auto rawSize = children[5]->asFlatVector<int32_t>()->mutableRawValues();
   auto containerVector = children[6]->asFlatVector<StringView>();
-  auto retailPriceVector = children[7]->asFlatVector<double>();
+  auto rawRetailPrice = children[7]->asFlatVector<double>()->mutableRawValues();
   auto commentVector = children[8]->asFlatVector<StringView>();
 
   DBGenIterator dbgenIt(scaleFactor);
@@ -517,14 +522,14 @@ RowVectorPtr genTpchPart(
   for (size_t i = 0; i < vectorSize; ++i) {
     dbgenIt.genPart(i + offset + 1, part);
 
-    partKeyVector->set(i, part.partkey);
+    rawPartKey[i] = part.partkey;
     nameVector->set(i, StringView(part.name, strlen(part.name)));
     mfgrVector->set(i, StringView(part.mfgr, strlen(part.mfgr)));
     brandVector->set(i, StringView(part.brand, strlen(part.brand)));
     typeVector->set(i, StringView(part.type, part.tlen));
-    sizeVector->set(i, part.size);
+    rawSize[i] = part.size;
     containerVector->set(i, StringView(part.container, strlen(part.container)));
-    retailPriceVector->set(i, decimalToDouble(part.retailprice));
+    rawRetailPrice[i] = decimalToDouble(part.retailprice);
     commentVector->set(i, StringView(part.comment, part.clen));
   }
   return std::make_shared<RowVector>(
@@ -542,12 +547,12 @@ RowVectorPtr genTpchSupplier(
       getRowCount(Table::TBL_SUPPLIER, scaleFactor), maxRows, offset);
   auto children = allocateVectors(supplierRowType, vectorSize, pool);
 
-  auto suppKeyVector = children[0]->asFlatVector<int64_t>();
+  auto rawSuppKey = children[0]->asFlatVector<int64_t>()->mutableRawValues();
   auto nameVector = children[1]->asFlatVector<StringView>();
   auto addressVector = children[2]->asFlatVector<StringView>();
-  auto nationKeyVector = children[3]->asFlatVector<int64_t>();
+  auto rawNationKey = children[3]->asFlatVector<int64_t>()->mutableRawValues();
   auto phoneVector = children[4]->asFlatVector<StringView>();
-  auto acctbalVector = children[5]->asFlatVector<double>();
+  auto rawAcctbal = children[5]->asFlatVector<double>()->mutableRawValues();
   auto commentVector = children[6]->asFlatVector<StringView>();
 
   DBGenIterator dbgenIt(scaleFactor);
@@ -559,12 +564,12 @@ RowVectorPtr genTpchSupplier(
   for (size_t i = 0; i < vectorSize; ++i) {
     dbgenIt.genSupplier(i + offset + 1, supp);
 
-    suppKeyVector->set(i, supp.suppkey);
+    rawSuppKey[i] = supp.suppkey;
     nameVector->set(i, StringView(supp.name, strlen(supp.name)));
     addressVector->set(i, StringView(supp.address, supp.alen));
-    nationKeyVector->set(i, supp.nation_code);
+    rawNationKey[i] = supp.nation_code;
     phoneVector->set(i, StringView(supp.phone, strlen(supp.phone)));
-    acctbalVector->set(i, decimalToDouble(supp.acctbal));
+    rawAcctbal[i] = decimalToDouble(supp.acctbal);
     commentVector->set(i, StringView(supp.comment, supp.clen));
   }
   return std::make_shared<RowVector>(
@@ -586,10 +591,10 @@ RowVectorPtr genTpchPartSupp(
       getRowCount(Table::TBL_PARTSUPP, scaleFactor), maxRows, offset);
   auto children = allocateVectors(partSuppRowType, vectorSize, pool);
 
-  auto partKeyVector = children[0]->asFlatVector<int64_t>();
-  auto suppKeyVector = children[1]->asFlatVector<int64_t>();
-  auto availQtyVector = children[2]->asFlatVector<int32_t>();
-  auto supplyCostVector = children[3]->asFlatVector<double>();
+  auto rawPartKey = children[0]->asFlatVector<int64_t>()->mutableRawValues();
+  auto rawSuppKey = children[1]->asFlatVector<int64_t>()->mutableRawValues();
+  auto rawAvailQty = children[2]->asFlatVector<int32_t>()->mutableRawValues();
+  auto rawSupplyCost = children[3]->asFlatVector<double>()->mutableRawValues();
   auto commentVector = children[4]->asFlatVector<StringView>();
 
   DBGenIterator dbgenIt(scaleFactor);
@@ -611,10 +616,10 @@ RowVectorPtr genTpchPartSupp(
     while ((partSuppIdx < SUPP_PER_PART) && (partSuppCount < vectorSize)) {
       const auto& partSupp = part.s[partSuppIdx];
 
-      partKeyVector->set(partSuppCount, partSupp.partkey);
-      suppKeyVector->set(partSuppCount, partSupp.suppkey);
-      availQtyVector->set(partSuppCount, partSupp.qty);
-      supplyCostVector->set(partSuppCount, decimalToDouble(partSupp.scost));
+      rawPartKey[partSuppCount] = partSupp.partkey;
+      rawSuppKey[partSuppCount] = partSupp.suppkey;
+      rawAvailQty[partSuppCount] = partSupp.qty;
+      rawSupplyCost[partSuppCount] = decimalToDouble(partSupp.scost);
       commentVector->set(
           partSuppCount, StringView(partSupp.comment, partSupp.clen));
 
@@ -646,12 +651,12 @@ RowVectorPtr genTpchCustomer(
       getRowCount(Table::TBL_CUSTOMER, scaleFactor), maxRows, offset);
   auto children = allocateVectors(customerRowType, vectorSize, pool);
 
-  auto custKeyVector = children[0]->asFlatVector<int64_t>();
+  auto rawCustKey = children[0]->asFlatVector<int64_t>()->mutableRawValues();
   auto nameVector = children[1]->asFlatVector<StringView>();
   auto addressVector = children[2]->asFlatVector<StringView>();
-  auto nationKeyVector = children[3]->asFlatVector<int64_t>();
+  auto rawNationKey = children[3]->asFlatVector<int64_t>()->mutableRawValues();
   auto phoneVector = children[4]->asFlatVector<StringView>();
-  auto acctBalVector = children[5]->asFlatVector<double>();
+  auto rawAcctBal = children[5]->asFlatVector<double>()->mutableRawValues();
   auto mktSegmentVector = children[6]->asFlatVector<StringView>();
   auto commentVector = children[7]->asFlatVector<StringView>();
 
@@ -664,12 +669,12 @@ RowVectorPtr genTpchCustomer(
   for (size_t i = 0; i < vectorSize; ++i) {
     dbgenIt.genCustomer(i + offset + 1, cust);
 
-    custKeyVector->set(i, cust.custkey);
+    rawCustKey[i] = cust.custkey;
     nameVector->set(i, StringView(cust.name, strlen(cust.name)));
     addressVector->set(i, StringView(cust.address, cust.alen));
-    nationKeyVector->set(i, cust.nation_code);
+    rawNationKey[i] = cust.nation_code;
     phoneVector->set(i, StringView(cust.phone, strlen(cust.phone)));
-    acctBalVector->set(i, decimalToDouble(cust.acctbal));
+    rawAcctBal[i] = decimalToDouble(cust.acctbal);
     mktSegmentVector->set(
         i, StringView(cust.mktsegment, strlen(cust.mktsegment)));
     commentVector->set(i, StringView(cust.comment, cust.clen));
@@ -693,9 +698,9 @@ RowVectorPtr genTpchNation(
       getRowCount(Table::TBL_NATION, scaleFactor), maxRows, offset);
   auto children = allocateVectors(nationRowType, vectorSize, pool);
 
-  auto nationKeyVector = children[0]->asFlatVector<int64_t>();
+  auto rawNationKey = children[0]->asFlatVector<int64_t>()->mutableRawValues();
   auto nameVector = children[1]->asFlatVector<StringView>();
-  auto regionKeyVector = children[2]->asFlatVector<int64_t>();
+  auto rawRegionKey = children[2]->asFlatVector<int64_t>()->mutableRawValues();
   auto commentVector = children[3]->asFlatVector<StringView>();
 
   DBGenIterator dbgenIt(scaleFactor);
@@ -707,9 +712,9 @@ RowVectorPtr genTpchNation(
   for (size_t i = 0; i < vectorSize; ++i) {
     dbgenIt.genNation(i + offset + 1, code);
 
-    nationKeyVector->set(i, code.code);
+    rawNationKey[i] = code.code;
     nameVector->set(i, StringView(code.text, strlen(code.text)));
-    regionKeyVector->set(i, code.join);
+    rawRegionKey[i] = code.join;
     commentVector->set(i, StringView(code.comment, code.clen));
   }
   return std::make_shared<RowVector>(
@@ -727,7 +732,7 @@ RowVectorPtr genTpchRegion(
       getRowCount(Table::TBL_REGION, scaleFactor), maxRows, offset);
   auto children = allocateVectors(regionRowType, vectorSize, pool);
 
-  auto regionKeyVector = children[0]->asFlatVector<int64_t>();
+  auto rawRegionKey = children[0]->asFlatVector<int64_t>()->mutableRawValues();
   auto nameVector = children[1]->asFlatVector<StringView>();
   auto commentVector = children[2]->asFlatVector<StringView>();
 
@@ -740,7 +745,7 @@ RowVectorPtr genTpchRegion(
   for (size_t i = 0; i < vectorSize; ++i) {
     dbgenIt.genRegion(i + offset + 1, code);
 
-    regionKeyVector->set(i, code.code);
+    rawRegionKey[i] = code.code;
     nameVector->set(i, StringView(code.text, strlen(code.text)));
     commentVector->set(i, StringView(code.comment, code.clen));
   }
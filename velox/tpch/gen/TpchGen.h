@@ -27,8 +27,8 @@ namespace facebook::velox::tpch {
 /// TPC-H scale factor, the maximum batch size, and the offset. The common usage
 /// is to make successive calls to this API advancing the offset parameter,
 /// until all records were read. Clients might also assign different slices of
-/// the range "[0, getRowCount(Table, scaleFactor)[" to different threads in
-/// order to generate datasets in parallel.
+/// the range "[0, getGeneratorRowCount(Table, scaleFactor)[" to different
+/// threads in order to generate datasets in parallel.
 ///
 /// If not enough records are available given a particular scale factor and
 /// offset, less than maxRows records might be returned.
@@ -58,6 +58,12 @@ Table fromTableName(std::string_view tableName);
 ///  https://www.tpc.org/tpch/
 size_t getRowCount(Table table, size_t scaleFactor);
 
+/// Returns the number of rows that the `offset` and `maxRows` parameters of
+/// the generator for `table` refer to. This is the row count of the table,
+/// except for "lineitem", which is generated by order and so is divided
+/// into parallel parts by its orders.
+size_t getGeneratorRowCount(Table table, size_t scaleFactor);
+
 /// Returns the schema (RowType) for a particular TPC-H table.
 RowTypePtr getTableSchema(Table table);
 
@@ -0,0 +1,99 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#pragma once
+
+#include <array>
+#include <cstring>
+
+#include "velox/type/LongDecimal.h"
+#include "velox/type/ShortDecimal.h"
+
+namespace facebook::velox {
+
+/// Helpers for arithmetic on the unscaled values of decimals. The unscaled
+/// value of a SHORT_DECIMAL is an int64_t and the unscaled value of a
+/// LONG_DECIMAL is an int128_t. Functions that may overflow set an overflow
+/// flag instead of throwing, so that callers can check the flag once for a
+/// batch of values.
+class DecimalUtil {
+ public:
+  static constexpr int32_t kMaxShortDecimalPrecision = 18;
+  static constexpr int32_t kMaxLongDecimalPrecision = 38;
+
+  /// 10^i for i in [0, 38].
+  static constexpr std::array<int128_t, kMaxLongDecimalPrecision + 1>
+      kPowersOfTen = [] {
+        std::array<int128_t, kMaxLongDecimalPrecision + 1> powers{};
+        int128_t power = 1;
+        for (size_t i = 0; i < powers.size(); ++i) {
+          powers[i] = power;
+          if (i + 1 < powers.size()) {
+            power *= 10;
+          }
+        }
+        return powers;
+      }();
+
+  /// Largest unscaled value of a decimal of precision 38.
+  static constexpr int128_t kLongDecimalMax =
+      kPowersOfTen[kMaxLongDecimalPrecision] - 1;
+  static constexpr int128_t kLongDecimalMin = -kLongDecimalMax;
+
+  /// Returns true if 'value' has at most 38 digits.
+  static bool valueInRange(int128_t value) {
+    return value >= kLongDecimalMin && value <= kLongDecimalMax;
+  }
+
+  /// Returns 'value' * 10^'delta' as a TOutput. Sets 'overflow' if the result
+  /// does not fit.
+  template <typename TOutput, typename TInput>
+  static TOutput rescale(TInput value, int32_t delta, bool& overflow) {
+    TOutput result;
+    overflow |= __builtin_mul_overflow(
+        static_cast<TOutput>(value),
+        static_cast<TOutput>(kPowersOfTen[delta]),
+        &result);
+    return result;
+  }
+
+  /// Returns 'sum' / 'count' rounded half away from zero. 'count' must be
+  /// positive.
+  static int128_t divideRoundHalfUp(int128_t sum, int64_t count) {
+    auto quotient = sum / count;
+    auto remainder = sum % count;
+    if (remainder < 0) {
+      remainder = -remainder;
+    }
+    if (remainder * 2 >= count) {
+      quotient += sum < 0 ? -1 : 1;
+    }
+    return quotient;
+  }
+
+  /// Reads an int128_t from a possibly unaligned address, e.g. an accumulator
+  /// in a row of a RowContainer.
+  static int128_t readUnaligned(const void* address) {
+    int128_t value;
+    memcpy(&value, address, sizeof(value));
+    return value;
+  }
+
+  static void writeUnaligned(void* address, int128_t value) {
+    memcpy(address, &value, sizeof(value));
+  }
+};
+
+} // namespace facebook::velox
@@ -297,6 +297,41 @@ bool BigintValuesUsingHashTable::testInt64Range(
   return max >= *it;
 }
 
+xsimd::batch_bool<int64_t> BigintValuesUsingBloomFilter::testValues(
+    xsimd::batch<int64_t> x) const {
+  auto outOfRange = (x < xsimd::broadcast<int64_t>(min_)) |
+      (x > xsimd::broadcast<int64_t>(max_));
+  if (simd::toBitMask(outOfRange) == simd::allSetBitMask<int64_t>()) {
+    return xsimd::batch_bool<int64_t>(false);
+  }
+  xsimd::batch<uint64_t> hashes = xsimd::batch<uint64_t>(x) * M;
+  hashes = hashes ^ (hashes >> 32);
+  return bloom_->mayContain(xsimd::batch<int64_t>(hashes)) & ~outOfRange;
+}
+
+xsimd::batch_bool<int32_t> BigintValuesUsingBloomFilter::testValues(
+    xsimd::batch<int32_t> x) const {
+  auto first = simd::toBitMask(testValues(simd::getHalf<int64_t, 0>(x)));
+  auto second = simd::toBitMask(testValues(simd::getHalf<int64_t, 1>(x)));
+  return simd::fromBitMask<int32_t>(
+      first | (second << xsimd::batch<int64_t>::size));
+}
+
+bool BigintValuesUsingBloomFilter::testInt64Range(
+    int64_t min,
+    int64_t max,
+    bool hasNull) const {
+  if (hasNull && nullAllowed_) {
+    return true;
+  }
+
+  if (min == max) {
+    return testInt64(min);
+  }
+
+  return !(min > max_ || max < min_);
+}
+
 NegatedBigintValuesUsingBitmask::NegatedBigintValuesUsingBitmask(
     int64_t min,
     int64_t max,
@@ -1053,6 +1088,7 @@ std::unique_ptr<Filter> BigintRange::mergeWith(const Filter* other) const {
     case FilterKind::kNegatedBigintRange:
     case FilterKind::kBigintValuesUsingBitmask:
     case FilterKind::kBigintValuesUsingHashTable:
+    case FilterKind::kBigintValuesUsingBloomFilter:
       return other->mergeWith(this);
     case FilterKind::kBigintMultiRange: {
       auto otherMultiRange = dynamic_cast<const BigintMultiRange*>(other);
@@ -1157,6 +1193,7 @@ std::unique_ptr<Filter> NegatedBigintRange::mergeWith(
     }
     case FilterKind::kBigintValuesUsingHashTable:
     case FilterKind::kBigintValuesUsingBitmask:
+    case FilterKind::kBigintValuesUsingBloomFilter:
       return other->mergeWith(this);
     case FilterKind::kNegatedBigintValuesUsingHashTable:
     case FilterKind::kNegatedBigintValuesUsingBitmask: {
@@ -1212,6 +1249,7 @@ std::unique_ptr<Filter> BigintValuesUsingHashTable::mergeWith(
       return mergeWith(min, max, other);
     }
     case FilterKind::kBigintValuesUsingBitmask:
+    case FilterKind::kBigintValuesUsingBloomFilter:
       return other->mergeWith(this);
     case FilterKind::kBigintMultiRange: {
       auto otherMultiRange = dynamic_cast<const BigintMultiRange*>(other);
@@ -1288,6 +1326,8 @@ std::unique_ptr<Filter> BigintValuesUsingBitmask::mergeWith(
       return other->mergeWith(this);
     case FilterKind::kIsNotNull:
       return std::make_unique<BigintValuesUsingBitmask>(*this, false);
+    case FilterKind::kBigintValuesUsingBloomFilter:
+      return other->mergeWith(this);
     case FilterKind::kBigintRange: {
       auto otherRange = dynamic_cast<const BigintRange*>(other);
 
@@ -1354,6 +1394,82 @@ std::unique_ptr<Filter> BigintValuesUsingBitmask::mergeWith(
   return createBigintValues(valuesToKeep, bothNullAllowed);
 }
 
+std::unique_ptr<Filter> BigintValuesUsingBloomFilter::mergeWith(
+    const Filter* other) const {
+  switch (other->kind()) {
+    case FilterKind::kAlwaysTrue:
+    case FilterKind::kAlwaysFalse:
+    case FilterKind::kIsNull:
+      return other->mergeWith(this);
+    case FilterKind::kIsNotNull:
+      return std::make_unique<BigintValuesUsingBloomFilter>(*this, false);
+    case FilterKind::kBigintRange: {
+      auto otherRange = static_cast<const BigintRange*>(other);
+      auto min = std::max(min_, otherRange->lower());
+      auto max = std::min(max_, otherRange->upper());
+
+      return mergeWith(min, max, other);
+    }
+    case FilterKind::kBigintValuesUsingBloomFilter: {
+      // Keeps the Bloom filter of 'this'. Both are approximate, so dropping
+      // one does not change the result beyond more false positives.
+      auto otherBloom = static_cast<const BigintValuesUsingBloomFilter*>(other);
+      auto min = std::max(min_, otherBloom->min_);
+      auto max = std::min(max_, otherBloom->max_);
+
+      return mergeWith(min, max, other);
+    }
+    case FilterKind::kBigintValuesUsingHashTable:
+    case FilterKind::kBigintValuesUsingBitmask: {
+      // The exact list is reduced to the values that pass 'this'.
+      auto values = other->kind() == FilterKind::kBigintValuesUsingHashTable
+          ? static_cast<const BigintValuesUsingHashTable*>(other)->values()
+          : static_cast<const BigintValuesUsingBitmask*>(other)->values();
+      std::vector<int64_t> valuesToKeep;
+      for (auto value : values) {
+        if (testInt64(value)) {
+          valuesToKeep.push_back(value);
+        }
+      }
+      bool bothNullAllowed = nullAllowed_ && other->testNull();
+      return createBigintValues(valuesToKeep, bothNullAllowed);
+    }
+    case FilterKind::kNegatedBigintRange:
+    case FilterKind::kNegatedBigintValuesUsingHashTable:
+    case FilterKind::kNegatedBigintValuesUsingBitmask:
+    case FilterKind::kBigintMultiRange: {
+      // These cannot be combined with a Bloom filter. 'this' only drops rows
+      // early, so the merge keeps the exact filter.
+      bool bothNullAllowed = nullAllowed_ && other->testNull();
+      return other->clone(bothNullAllowed);
+    }
+    default:
+      VELOX_UNREACHABLE();
+  }
+}
+
+std::unique_ptr<Filter> BigintValuesUsingBloomFilter::mergeWith(
+    int64_t min,
+    int64_t max,
+    const Filter* other) const {
+  bool bothNullAllowed = nullAllowed_ && other->testNull();
+
+  if (max < min) {
+    return nullOrFalse(bothNullAllowed);
+  }
+
+  if (max == min) {
+    if (testInt64(min) && other->testInt64(min)) {
+      return std::make_unique<BigintRange>(min, min, bothNullAllowed);
+    }
+
+    return nullOrFalse(bothNullAllowed);
+  }
+
+  return std::make_unique<BigintValuesUsingBloomFilter>(
+      min, max, bloom_, bothNullAllowed);
+}
+
 std::unique_ptr<Filter> NegatedBigintValuesUsingHashTable::mergeWith(
     const Filter* other) const {
   // Rules of NegatedBigintValuesUsingHashTable with IsNull/IsNotNull
@@ -1373,6 +1489,7 @@ std::unique_ptr<Filter> NegatedBigintValuesUsingHashTable::mergeWith(
       return std::make_unique<NegatedBigintValuesUsingHashTable>(*this, false);
     case FilterKind::kBigintValuesUsingHashTable:
     case FilterKind::kBigintValuesUsingBitmask:
+    case FilterKind::kBigintValuesUsingBloomFilter:
     case FilterKind::kBigintRange:
     case FilterKind::kBigintMultiRange: {
       return other->mergeWith(this);
@@ -1412,6 +1529,7 @@ std::unique_ptr<Filter> NegatedBigintValuesUsingBitmask::mergeWith(
       return std::make_unique<NegatedBigintValuesUsingBitmask>(*this, false);
     case FilterKind::kBigintValuesUsingHashTable:
     case FilterKind::kBigintValuesUsingBitmask:
+    case FilterKind::kBigintValuesUsingBloomFilter:
     case FilterKind::kBigintRange:
     case FilterKind::kNegatedBigintRange:
     case FilterKind::kBigintMultiRange: {
@@ -1454,7 +1572,8 @@ std::unique_ptr<Filter> BigintMultiRange::mergeWith(const Filter* other) const {
     case FilterKind::kBigintRange:
     case FilterKind::kNegatedBigintRange:
     case FilterKind::kBigintValuesUsingBitmask:
-    case FilterKind::kBigintValuesUsingHashTable: {
+    case FilterKind::kBigintValuesUsingHashTable:
+    case FilterKind::kBigintValuesUsingBloomFilter: {
       return other->mergeWith(this);
     }
     case FilterKind::kBigintMultiRange: {
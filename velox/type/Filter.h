@@ -24,6 +24,7 @@
 #include <folly/Range.h>
 #include <folly/container/F14Set.h>
 
+#include "velox/common/base/BloomFilter.h"
 #include "velox/common/base/Exceptions.h"
 #include "velox/common/base/SimdUtil.h"
 #include "velox/type/StringView.h"
@@ -39,6 +40,7 @@ enum class FilterKind {
   kBigintRange,
   kBigintValuesUsingHashTable,
   kBigintValuesUsingBitmask,
+  kBigintValuesUsingBloomFilter,
   kNegatedBigintRange,
   kNegatedBigintValuesUsingHashTable,
   kNegatedBigintValuesUsingBitmask,
@@ -825,6 +827,97 @@ class BigintValuesUsingBitmask final : public Filter {
   const int64_t max_;
 };
 
+/// Approximate IN-list filter for integral data types. Passes the values in
+/// [min, max] that hit a Bloom filter, so a small fraction of the values that
+/// are not in the list pass too. Used for dynamic filters pushed down from a
+/// hash join build side that has too many distinct keys for an exact IN-list.
+/// Must only be used where false positives are acceptable.
+class BigintValuesUsingBloomFilter final : public Filter {
+ public:
+  using Bloom = BloomFilter<false>;
+
+  /// @param min Minimum value.
+  /// @param max Maximum value.
+  /// @param bloom Bloom filter of hashValue() of each value in the list.
+  /// @param nullAllowed Null values are passing the filter if true.
+  BigintValuesUsingBloomFilter(
+      int64_t min,
+      int64_t max,
+      std::shared_ptr<const Bloom> bloom,
+      bool nullAllowed)
+      : Filter(true, nullAllowed, FilterKind::kBigintValuesUsingBloomFilter),
+        min_(min),
+        max_(max),
+        bloom_(std::move(bloom)) {}
+
+  BigintValuesUsingBloomFilter(
+      const BigintValuesUsingBloomFilter& other,
+      bool nullAllowed)
+      : Filter(true, nullAllowed, FilterKind::kBigintValuesUsingBloomFilter),
+        min_(other.min_),
+        max_(other.max_),
+        bloom_(other.bloom_) {}
+
+  /// Returns the hash number to insert into the Bloom filter for 'value'.
+  static uint64_t hashValue(int64_t value) {
+    uint64_t hash = static_cast<uint64_t>(value) * M;
+    return hash ^ (hash >> 32);
+  }
+
+  std::unique_ptr<Filter> clone(
+      std::optional<bool> nullAllowed = std::nullopt) const final {
+    if (nullAllowed) {
+      return std::make_unique<BigintValuesUsingBloomFilter>(
+          *this, nullAllowed.value());
+    } else {
+      return std::make_unique<BigintValuesUsingBloomFilter>(*this);
+    }
+  }
+
+  bool testInt64(int64_t value) const final {
+    return value >= min_ && value <= max_ &&
+        bloom_->mayContain(hashValue(value));
+  }
+
+  xsimd::batch_bool<int64_t> testValues(xsimd::batch<int64_t>) const final;
+  xsimd::batch_bool<int32_t> testValues(xsimd::batch<int32_t>) const final;
+  xsimd::batch_bool<int16_t> testValues(xsimd::batch<int16_t> x) const final {
+    return Filter::testValues(x);
+  }
+
+  bool testInt64Range(int64_t min, int64_t max, bool hasNull) const final;
+
+  std::unique_ptr<Filter> mergeWith(const Filter* other) const final;
+
+  int64_t min() const {
+    return min_;
+  }
+
+  int64_t max() const {
+    return max_;
+  }
+
+  std::string toString() const final {
+    return fmt::format(
+        "BigintValuesUsingBloomFilter: [{}, {}] {}",
+        min_,
+        max_,
+        nullAllowed_ ? "with nulls" : "no nulls");
+  }
+
+ private:
+  std::unique_ptr<Filter>
+  mergeWith(int64_t min, int64_t max, const Filter* other) const;
+
+  // from Murmur hash
+  static constexpr uint64_t M = 0xc6a4a7935bd1e995L;
+
+  const int64_t min_;
+  const int64_t max_;
+  // Shared between the copies made by clone() and mergeWith().
+  const std::shared_ptr<const Bloom> bloom_;
+};
+
 // NOT IN-list filter for integral data types. Implemented as a hash table. Good
 // for large number of rejected values that do not fit within a small range.
 class NegatedBigintValuesUsingHashTable final : public Filter {
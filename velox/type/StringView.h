@@ -16,6 +16,8 @@
 
 #pragma once
 
+#include <algorithm>
+#include <cstring>
 #include <functional>
 #include <string>
 
@@ -179,6 +181,29 @@ struct StringView {
     return compare(other) >= 0;
   }
 
+  /// Returns true if 'this' starts with 'prefix'. Compares the inlined
+  /// prefix before reading out of line data.
+  bool startsWith(std::string_view prefix) const {
+    if (prefix.size() > size_) {
+      return false;
+    }
+    if (memcmp(prefix_, prefix.data(), std::min(prefix.size(), kPrefixSize)) !=
+        0) {
+      return false;
+    }
+    return prefix.size() <= kPrefixSize ||
+        memcmp(data() + kPrefixSize,
+               prefix.data() + kPrefixSize,
+               prefix.size() - kPrefixSize) == 0;
+  }
+
+  /// Returns true if 'this' ends with 'suffix'.
+  bool endsWith(std::string_view suffix) const {
+    return suffix.size() <= size_ &&
+        memcmp(data() + size_ - suffix.size(), suffix.data(), suffix.size()) ==
+        0;
+  }
+
   operator folly::StringPiece() const {
     return folly::StringPiece(data(), size());
   }
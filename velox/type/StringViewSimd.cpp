@@ -0,0 +1,126 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "velox/type/StringViewSimd.h"
+
+#include "velox/common/base/BitUtil.h"
+#include "velox/common/base/SimdUtil.h"
+
+namespace facebook::velox::simd {
+
+namespace {
+using Batch = xsimd::batch<int64_t>;
+
+// Each StringView takes 2 lanes of a batch.
+constexpr int32_t kStringsPerBatch = Batch::size / 2;
+static_assert(64 % kStringsPerBatch == 0);
+
+const int64_t* words(const StringView* values) {
+  return reinterpret_cast<const int64_t*>(values);
+}
+
+// Returns a bit per StringView in [left, left + kStringsPerBatch), set if it
+// equals the corresponding 'right(i)'. 'wordsEqual' has a bit per 8 byte
+// word of the StringViews, set if the word is equal in 'left' and 'right'.
+template <typename Right>
+uint64_t
+resolveBatch(uint64_t wordsEqual, const StringView* left, Right right) {
+  uint64_t equal = 0;
+  for (auto i = 0; i < kStringsPerBatch; ++i) {
+    switch ((wordsEqual >> (2 * i)) & 3) {
+      case 3:
+        // Same size, prefix and inline part or data pointer.
+        equal |= 1ULL << i;
+        break;
+      case 1:
+        // Same size and prefix. Out of line strings have different data
+        // pointers. Inline strings of up to kPrefixSize bytes are equal:
+        // their second word is not part of the value and is not
+        // necessarily zeroed, e.g. for an empty string.
+        if (left[i] == right(i)) {
+          equal |= 1ULL << i;
+        }
+        break;
+      default:
+        break;
+    }
+  }
+  return equal;
+}
+
+// Sets the bits of 'result' for [0, size) a batch at a time. 'loadRight(i)'
+// returns the batch to compare to the StringViews of 'left' starting at 'i'.
+// 'right(i)' returns the StringView to compare with 'left[i]'.
+template <typename LoadRight, typename Right>
+void equalBatches(
+    const StringView* left,
+    int32_t size,
+    uint64_t* result,
+    LoadRight loadRight,
+    Right right) {
+  bits::fillBits(result, 0, size, false);
+  int32_t row = 0;
+  for (; row + kStringsPerBatch <= size; row += kStringsPerBatch) {
+    const uint64_t wordsEqual = toBitMask(
+        Batch::load_unaligned(words(left + row)) == loadRight(row));
+    if (wordsEqual == 0) {
+      continue;
+    }
+    const auto equal = resolveBatch(
+        wordsEqual, left + row, [&](auto i) { return right(row + i); });
+    result[row / 64] |= equal << (row % 64);
+  }
+  for (; row < size; ++row) {
+    if (left[row] == right(row)) {
+      bits::setBit(result, row);
+    }
+  }
+}
+} // namespace
+
+void stringViewsEqual(
+    const StringView* values,
+    int32_t size,
+    const StringView& value,
+    uint64_t* result) {
+  // The 16 bytes of 'value' repeated for each StringView of a batch.
+  alignas(Batch::arch_type::alignment()) int64_t valueWords[Batch::size];
+  for (auto i = 0; i < Batch::size; ++i) {
+    valueWords[i] = words(&value)[i % 2];
+  }
+  const auto valueBatch = Batch::load_aligned(valueWords);
+  equalBatches(
+      values,
+      size,
+      result,
+      [&](auto /*row*/) { return valueBatch; },
+      [&](auto /*row*/) { return value; });
+}
+
+void stringViewsEqual(
+    const StringView* left,
+    const StringView* right,
+    int32_t size,
+    uint64_t* result) {
+  equalBatches(
+      left,
+      size,
+      result,
+      [&](auto row) { return Batch::load_unaligned(words(right + row)); },
+      [&](auto row) { return right[row]; });
+}
+
+} // namespace facebook::velox::simd
@@ -0,0 +1,54 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#pragma once
+
+#include "velox/type/StringView.h"
+
+/// Batch equality of StringViews. A StringView is 16 bytes: the size and the
+/// 4 byte prefix, followed by either the rest of an inline string or a
+/// pointer to the data. These 16 byte headers are compared a SIMD batch of
+/// StringViews at a time. Only strings that are not inline and whose size
+/// and prefix match read their out of line data.
+namespace facebook::velox::simd {
+
+static_assert(sizeof(StringView) == 2 * sizeof(int64_t));
+
+/// Returns true if 'left' and 'right' have the same size and prefix. If so,
+/// either both or neither are inline.
+inline bool stringViewHeadsEqual(
+    const StringView& left,
+    const StringView& right) {
+  return reinterpret_cast<const int64_t*>(&left)[0] ==
+      reinterpret_cast<const int64_t*>(&right)[0];
+}
+
+/// Sets bit 'i' of 'result' if 'values[i]' equals 'value' and clears it
+/// otherwise, for 'i' in [0, size).
+void stringViewsEqual(
+    const StringView* values,
+    int32_t size,
+    const StringView& value,
+    uint64_t* result);
+
+/// Sets bit 'i' of 'result' if 'left[i]' equals 'right[i]' and clears it
+/// otherwise, for 'i' in [0, size).
+void stringViewsEqual(
+    const StringView* left,
+    const StringView* right,
+    int32_t size,
+    uint64_t* result);
+
+} // namespace facebook::velox::simd
@@ -0,0 +1,133 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "velox/type/TimeZoneOffsets.h"
+
+#include <cstdlib>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+
+#include "velox/external/date/tz.h"
+
+namespace facebook::velox {
+namespace {
+
+date::sys_seconds toSysSeconds(int64_t seconds) {
+  return date::sys_seconds(std::chrono::seconds(seconds));
+}
+
+int64_t toSeconds(date::sys_seconds time) {
+  return time.time_since_epoch().count();
+}
+
+} // namespace
+
+TimeZoneOffsets::TimeZoneOffsets(const date::time_zone& zone)
+    : zone_(zone), days_(kMaxDay - kMinDay) {
+  // 'info' covers the second before the start of the day being filled in.
+  auto info = zone.get_info(toSysSeconds(dayStart(0) - 1));
+  int32_t offset = info.offset.count();
+  bool largeOffset = std::abs(offset) >= kSecondsPerDay;
+  for (int32_t i = 0; i < days_.size(); ++i) {
+    const auto end = dayStart(i + 1);
+    auto& day = days_[i];
+    day.offset = offset;
+    day.change = kNoChange;
+    day.offsetAfter = offset;
+    while (toSeconds(info.end) < end) {
+      info = zone.get_info(info.end);
+      if (info.offset.count() == offset) {
+        // Only the abbreviation or the daylight saving part changes.
+        continue;
+      }
+      day.change = day.change == kNoChange
+          ? toSeconds(info.begin) - dayStart(i)
+          : kManyChanges;
+      offset = info.offset.count();
+      day.offsetAfter = offset;
+      largeOffset |= std::abs(offset) >= kSecondsPerDay;
+    }
+  }
+
+  // A local time of a day is the GMT time of the day before, the day or the
+  // day after plus an offset of less than a day.
+  for (int32_t i = 0; i < days_.size(); ++i) {
+    auto& day = days_[i];
+    if (largeOffset || i == 0 || i == days_.size() - 1) {
+      day.localChange = kManyChanges;
+      continue;
+    }
+    day.localChange = kNoChange;
+    for (auto j = i - 1; j <= i + 1; ++j) {
+      const auto change = days_[j].change;
+      if (change == kNoChange) {
+        continue;
+      }
+      if (change == kManyChanges || day.localChange != kNoChange) {
+        day.localChange = kManyChanges;
+        break;
+      }
+      day.localChange = (j - i) * kSecondsPerDay + change;
+    }
+  }
+}
+
+// static
+const TimeZoneOffsets& TimeZoneOffsets::get(const date::time_zone& zone) {
+  static std::mutex mutex;
+  static auto* offsets = new std::unordered_map<
+      const date::time_zone*,
+      std::unique_ptr<TimeZoneOffsets>>();
+  std::lock_guard<std::mutex> l(mutex);
+  auto& zoneOffsets = (*offsets)[&zone];
+  if (!zoneOffsets) {
+    zoneOffsets = std::make_unique<TimeZoneOffsets>(zone);
+  }
+  return *zoneOffsets;
+}
+
+void TimeZoneOffsets::toTimezone(Timestamp* timestamps, int32_t size) const {
+  for (auto i = 0; i < size; ++i) {
+    toTimezone(timestamps[i]);
+  }
+}
+
+void TimeZoneOffsets::toGMT(Timestamp* timestamps, int32_t size) const {
+  for (auto i = 0; i < size; ++i) {
+    toGMT(timestamps[i]);
+  }
+}
+
+int64_t TimeZoneOffsets::toGMTAroundChange(int32_t index, int64_t seconds)
+    const {
+  const auto localChange = days_[index].localChange;
+  const auto& changeDay =
+      days_[index + (localChange + kSecondsPerDay) / kSecondsPerDay - 1];
+  const auto change = dayStart(index) + localChange;
+  const auto later = seconds - changeDay.offsetAfter;
+  if (later >= change) {
+    return later;
+  }
+  const auto earlier = seconds - changeDay.offset;
+  if (earlier < change) {
+    return earlier;
+  }
+  // 'seconds' is in the gap of a change to a larger offset.
+  return change;
+}
+
+} // namespace facebook::velox
@@ -0,0 +1,138 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#pragma once
+
+#include <limits>
+#include <vector>
+
+#include "velox/type/Timestamp.h"
+
+namespace facebook::velox {
+
+/// Offsets from GMT of a time zone, precomputed for each day of a range of
+/// days. Converts timestamps between GMT and the time zone with a lookup in
+/// a flat array instead of a search of the time zone database for each
+/// value. Gives the same results as Timestamp::toTimezone() and
+/// Timestamp::toGMT(). Times outside of the range, and the rare days next to
+/// more than one change of offset, go through the time zone database.
+class TimeZoneOffsets {
+ public:
+  explicit TimeZoneOffsets(const date::time_zone& zone);
+
+  /// Returns the offsets of 'zone'. The offsets are computed on first use
+  /// and are kept for the life of the process.
+  static const TimeZoneOffsets& get(const date::time_zone& zone);
+
+  const date::time_zone& zone() const {
+    return zone_;
+  }
+
+  /// Same as timestamp.toTimezone(zone()).
+  void toTimezone(Timestamp& timestamp) const {
+    const auto seconds = timestamp.getSeconds();
+    const auto index = dayIndex(seconds);
+    if (index >= 0) {
+      const auto& day = days_[index];
+      if (day.change != kManyChanges) {
+        const int32_t second = seconds - dayStart(index);
+        timestamp = Timestamp(
+            seconds + (second < day.change ? day.offset : day.offsetAfter),
+            timestamp.getNanos());
+        return;
+      }
+    }
+    timestamp.toTimezone(zone_);
+  }
+
+  /// Same as timestamp.toGMT(zone()). A local time that occurs twice
+  /// converts to the later GMT time. A local time skipped by a change of
+  /// offset converts to the time of the change.
+  void toGMT(Timestamp& timestamp) const {
+    const auto seconds = timestamp.getSeconds();
+    const auto index = dayIndex(seconds);
+    if (index >= 0) {
+      const auto& day = days_[index];
+      if (day.localChange == kNoChange) {
+        timestamp = Timestamp(seconds - day.offset, timestamp.getNanos());
+        return;
+      }
+      if (day.localChange != kManyChanges) {
+        timestamp =
+            Timestamp(toGMTAroundChange(index, seconds), timestamp.getNanos());
+        return;
+      }
+    }
+    timestamp.toGMT(zone_);
+  }
+
+  /// Converts 'size' consecutive timestamps with toTimezone(Timestamp&).
+  void toTimezone(Timestamp* timestamps, int32_t size) const;
+
+  /// Converts 'size' consecutive timestamps with toGMT(Timestamp&).
+  void toGMT(Timestamp* timestamps, int32_t size) const;
+
+  /// Range of days covered, [1900-01-01, 2100-01-01).
+  static constexpr int32_t kMinDay = -25'567;
+  static constexpr int32_t kMaxDay = 47'482;
+
+ private:
+  static constexpr int64_t kSecondsPerDay = 86'400;
+
+  // Values of Day::change and Day::localChange.
+  static constexpr int32_t kNoChange = std::numeric_limits<int32_t>::max();
+  static constexpr int32_t kManyChanges = std::numeric_limits<int32_t>::min();
+
+  struct Day {
+    // Offset in seconds at the start of the day.
+    int32_t offset;
+
+    // Second of the day at which the offset becomes 'offsetAfter'. kNoChange
+    // if the offset does not change during the day, kManyChanges if it
+    // changes more than once.
+    int32_t change;
+
+    int32_t offsetAfter;
+
+    // For converting local times of this day to GMT: second from the start
+    // of this day of the change of offset in the day before, this day or the
+    // day after. kNoChange if the offset is 'offset' for all 3 days,
+    // kManyChanges if there is more than one change.
+    int32_t localChange;
+  };
+
+  // Returns the index in 'days_' of the day of 'seconds', -1 if the day is
+  // not covered.
+  static int32_t dayIndex(int64_t seconds) {
+    if (seconds < kMinDay * kSecondsPerDay ||
+        seconds >= kMaxDay * kSecondsPerDay) {
+      return -1;
+    }
+    return (seconds - kMinDay * kSecondsPerDay) / kSecondsPerDay;
+  }
+
+  static int64_t dayStart(int32_t index) {
+    return (kMinDay + index) * kSecondsPerDay;
+  }
+
+  // Returns the GMT time of local time 'seconds' of day 'index', where the
+  // offset changes once near 'seconds'.
+  int64_t toGMTAroundChange(int32_t index, int64_t seconds) const;
+
+  const date::time_zone& zone_;
+  std::vector<Day> days_;
+};
+
+} // namespace facebook::velox
@@ -441,6 +441,61 @@ TEST(FilterTest, bigintValuesUsingBitmask) {
   EXPECT_FALSE(filter->testInt64Range(1234, 2000, false));
 }
 
+TEST(FilterTest, bigintValuesUsingBloomFilter) {
+  std::vector<int64_t> numbers;
+  auto bloom = std::make_shared<BigintValuesUsingBloomFilter::Bloom>();
+  bloom->reset(10'000);
+  for (auto i = 0; i < 10'000; ++i) {
+    numbers.push_back(i * 1209);
+    bloom->insert(BigintValuesUsingBloomFilter::hashValue(numbers.back()));
+  }
+  auto filter = std::make_unique<BigintValuesUsingBloomFilter>(
+      0, numbers.back(), bloom, false);
+
+  int32_t numFalsePositives = 0;
+  for (auto n : numbers) {
+    EXPECT_TRUE(filter->testInt64(n));
+    numFalsePositives += filter->testInt64(n + 1);
+  }
+  EXPECT_GT(5, 100 * numFalsePositives / numbers.size());
+  EXPECT_FALSE(filter->testNull());
+  EXPECT_FALSE(filter->testInt64(-1209));
+  EXPECT_FALSE(filter->testInt64(numbers.back() + 1209));
+  EXPECT_TRUE(filter->testInt64Range(0, 100, false));
+  EXPECT_FALSE(filter->testInt64Range(-100, -1, false));
+
+  int64_t outOfRange[] = {-100, -20000, 0x10000000, 0x20000000};
+  auto verify = [&](int64_t x) { return filter->testInt64(x); };
+  checkSimd(filter.get(), outOfRange, verify);
+  applySimdTestToVector(numbers, *filter, verify);
+  std::vector<int32_t> numbers32;
+  for (auto n : numbers) {
+    numbers32.push_back(n + n % 2);
+  }
+  applySimdTestToVector(numbers32, *filter, verify);
+
+  // Merging with a range narrows the range and keeps the Bloom filter.
+  auto merged = filter->mergeWith(between(1209 * 10, 1209 * 20).get());
+  ASSERT_EQ(FilterKind::kBigintValuesUsingBloomFilter, merged->kind());
+  EXPECT_TRUE(merged->testInt64(1209 * 10));
+  EXPECT_FALSE(merged->testInt64(1209 * 9));
+  EXPECT_FALSE(merged->testInt64(1209 * 21));
+
+  // Merging with an IN-list gives an exact IN-list.
+  merged = filter->mergeWith(in({1209, 1209 * 3, -5, 1209 * 20'000}).get());
+  EXPECT_TRUE(merged->testInt64(1209));
+  EXPECT_TRUE(merged->testInt64(1209 * 3));
+  EXPECT_FALSE(merged->testInt64(-5));
+  EXPECT_FALSE(merged->testInt64(1209 * 20'000));
+  EXPECT_FALSE(merged->testInt64(1209 * 2));
+
+  // Merging with a NOT IN-list keeps the exact filter only.
+  merged = filter->mergeWith(notIn({1209, 1209 * 3}).get());
+  EXPECT_NE(FilterKind::kBigintValuesUsingBloomFilter, merged->kind());
+  EXPECT_FALSE(merged->testInt64(1209));
+  EXPECT_TRUE(merged->testInt64(5));
+}
+
 TEST(FilterTest, negatedBigintValuesUsingBitmask) {
   auto filter = createNegatedBigintValues({1, 6, 1000, 8, 9, 100, 10}, false);
   auto castedFilter =
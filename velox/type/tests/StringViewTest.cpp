@@ -16,6 +16,7 @@
 #include <gmock/gmock.h>
 #include <gtest/gtest.h>
 #include <sstream>
+#include "velox/type/StringViewSimd.h"
 #include "velox/type/Type.h"
 
 using namespace facebook::velox;
@@ -151,3 +152,108 @@ TEST(StringView, implicitConstructionAndConversion) {
   };
   testOptionalConversion("literal");
 }
+
+TEST(StringView, startsWithEndsWith) {
+  StringView inlined("abcdef");
+  StringView notInlined("abcdefghijklmnopqrstuvwxyz");
+  for (const auto& sv : {inlined, notInlined}) {
+    EXPECT_TRUE(sv.startsWith(""));
+    EXPECT_TRUE(sv.startsWith("ab"));
+    EXPECT_TRUE(sv.startsWith("abcdef"));
+    EXPECT_FALSE(sv.startsWith("abd"));
+    EXPECT_FALSE(sv.startsWith("abcdeg"));
+    EXPECT_TRUE(sv.endsWith(""));
+    EXPECT_FALSE(sv.endsWith("abc"));
+    EXPECT_EQ(sv.startsWith(std::string_view(sv)), true);
+    EXPECT_EQ(sv.endsWith(std::string_view(sv)), true);
+  }
+  EXPECT_TRUE(inlined.endsWith("def"));
+  EXPECT_TRUE(notInlined.endsWith("xyz"));
+  EXPECT_TRUE(notInlined.startsWith("abcdefghijklmnop"));
+  EXPECT_FALSE(notInlined.startsWith("abcdefghijklmnoq"));
+  EXPECT_FALSE(inlined.startsWith("abcdefg"));
+  EXPECT_FALSE(inlined.endsWith("xabcdef"));
+}
+
+TEST(StringView, batchEquality) {
+  // Inline and out of line strings that differ in size, prefix, the inline
+  // part or only after the prefix. The copies have the same contents at
+  // different addresses.
+  std::vector<std::string> strings = {
+      "",
+      "abc",
+      "abcd",
+      "abcdefghijkl",
+      "abcdefghijkx",
+      "abcdefghijklm",
+      "abcdefghijklx",
+      "xbcdefghijklm",
+      "abcdefghijklmnopqrstuvwxyz"};
+  std::vector<std::string> copies = strings;
+  std::vector<StringView> left;
+  std::vector<StringView> right;
+  // 67 rows, so that the last batches and the tail are partial.
+  for (auto i = 0; i < 67; ++i) {
+    const auto& leftString = strings[i % strings.size()];
+    const auto& rightString = (i % 3 == 0)
+        ? leftString
+        : copies[(i * 7 / 3) % copies.size()];
+    left.emplace_back(leftString.data(), leftString.size());
+    right.emplace_back(rightString.data(), rightString.size());
+  }
+
+  std::vector<uint64_t> result(2, ~0ULL);
+  simd::stringViewsEqual(left.data(), right.data(), left.size(), result.data());
+  for (auto i = 0; i < left.size(); ++i) {
+    EXPECT_EQ(bits::isBitSet(result.data(), i), left[i] == right[i]) << i;
+  }
+
+  for (const auto& string : copies) {
+    StringView value(string.data(), string.size());
+    simd::stringViewsEqual(left.data(), left.size(), value, result.data());
+    for (auto i = 0; i < left.size(); ++i) {
+      EXPECT_EQ(bits::isBitSet(result.data(), i), left[i] == value) << i;
+    }
+  }
+}
+
+TEST(StringView, batchEqualityDirtyTail) {
+  // The second word of a StringView of up to 4 bytes is not part of the
+  // value. The constructor leaves it as is for an empty string, so equal
+  // short strings can differ there.
+  std::vector<std::string> strings = {"", "a", "ab", "abc", "abcd", ""};
+  auto makeDirty = [](const std::string& string, uint64_t tail) {
+    StringView view(string.data(), string.size());
+    memcpy(reinterpret_cast<char*>(&view) + sizeof(uint64_t), &tail, 8);
+    EXPECT_EQ(view, StringView(string));
+    return view;
+  };
+
+  std::vector<StringView> left;
+  std::vector<StringView> right;
+  // 67 rows, so that the last batches and the tail are partial.
+  for (auto i = 0; i < 67; ++i) {
+    const auto& leftString = strings[i % strings.size()];
+    const auto& rightString =
+        (i % 2 == 0) ? leftString : strings[(i / 2) % strings.size()];
+    left.push_back(makeDirty(leftString, 0x0123456789abcdefULL * i));
+    right.push_back(makeDirty(rightString, ~0ULL - i));
+  }
+
+  std::vector<uint64_t> result(2, ~0ULL);
+  simd::stringViewsEqual(left.data(), right.data(), left.size(), result.data());
+  for (auto i = 0; i < left.size(); ++i) {
+    EXPECT_EQ(bits::isBitSet(result.data(), i), left[i] == right[i]) << i;
+  }
+
+  for (auto i = 0; i < strings.size(); ++i) {
+    auto value = makeDirty(strings[i], 0xdeadbeefULL + i);
+    simd::stringViewsEqual(left.data(), left.size(), value, result.data());
+    for (auto row = 0; row < left.size(); ++row) {
+      EXPECT_EQ(
+          bits::isBitSet(result.data(), row),
+          strings[row % strings.size()] == strings[i])
+          << row;
+    }
+  }
+}
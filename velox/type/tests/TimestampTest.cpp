@@ -16,6 +16,8 @@
 
 #include <gtest/gtest.h>
 
+#include "velox/external/date/tz.h"
+#include "velox/type/TimeZoneOffsets.h"
 #include "velox/type/Timestamp.h"
 
 namespace facebook::velox {
@@ -49,5 +51,74 @@ TEST(TimestampTest, fromMillisAndMicros) {
   EXPECT_EQ(ts3, Timestamp::fromMicros(ts3.toMicros()));
 }
 
+TEST(TimestampTest, timeZoneOffsets) {
+  // Zones with offsets of half and quarter hours, changes of half an hour,
+  // a skipped day (Pacific/Apia at the end of 2011) and changes of 2 hours
+  // (Antarctica/Troll).
+  for (const auto* name :
+       {"America/Los_Angeles",
+        "Europe/London",
+        "Asia/Kolkata",
+        "Asia/Kathmandu",
+        "Australia/Lord_Howe",
+        "Pacific/Apia",
+        "Antarctica/Troll"}) {
+    SCOPED_TRACE(name);
+    const auto* zone = date::locate_zone(name);
+    const auto& offsets = TimeZoneOffsets::get(*zone);
+    EXPECT_EQ(&offsets, &TimeZoneOffsets::get(*zone));
+
+    auto expectSame = [&](int64_t seconds) {
+      Timestamp expected(seconds, 123);
+      Timestamp actual = expected;
+      expected.toTimezone(*zone);
+      offsets.toTimezone(actual);
+      ASSERT_EQ(expected, actual) << seconds;
+
+      expected = Timestamp(seconds, 123);
+      actual = expected;
+      expected.toGMT(*zone);
+      offsets.toGMT(actual);
+      ASSERT_EQ(expected, actual) << seconds;
+    };
+
+    // From before to after the range of the table.
+    for (int64_t seconds = -2'500'000'000; seconds < 4'500'000'000;
+         seconds += 10'007) {
+      expectSame(seconds);
+    }
+    // Densely over 2021, around its changes of offset.
+    for (int64_t seconds = 1'609'459'200; seconds < 1'640'995'200;
+         seconds += 97) {
+      expectSame(seconds);
+    }
+  }
+}
+
+TEST(TimestampTest, timeZoneOffsetsBatch) {
+  const auto* zone = date::locate_zone("America/Los_Angeles");
+  const auto& offsets = TimeZoneOffsets::get(*zone);
+  // 2021-03-14 and 2021-11-07 around 02:00, in GMT.
+  std::vector<Timestamp> timestamps;
+  for (int64_t seconds : {1'615'712'400, 1'615'716'000, 1'636'275'600}) {
+    for (auto i = -3; i < 3; ++i) {
+      timestamps.emplace_back(seconds + i * 1'800, i);
+    }
+  }
+  auto expected = timestamps;
+  auto actual = timestamps;
+  for (auto& timestamp : expected) {
+    timestamp.toTimezone(*zone);
+  }
+  offsets.toTimezone(actual.data(), actual.size());
+  EXPECT_EQ(expected, actual);
+
+  for (auto& timestamp : expected) {
+    timestamp.toGMT(*zone);
+  }
+  offsets.toGMT(actual.data(), actual.size());
+  EXPECT_EQ(expected, actual);
+}
+
 } // namespace
 } // namespace facebook::velox
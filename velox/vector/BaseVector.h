@@ -25,6 +25,7 @@
 #include <folly/Format.h>
 #include <folly/Range.h>
 #include <folly/container/F14Map.h>
+#include <folly/container/F14Set.h>
 
 #include "velox/buffer/Buffer.h"
 #include "velox/common/base/BitUtil.h"
@@ -49,6 +50,44 @@ class SimpleVector;
 template <typename T>
 class FlatVector;
 
+class BaseVector;
+
+/// Adds up the memory kept live by one or more vectors, counting each Buffer
+/// and each vector once. Vectors often share Buffers and children, e.g.
+/// dictionaries wrapping the same base vector or string buffers that a reader
+/// hands to several vectors. BaseVector::retainedSize() counts these once per
+/// reference.
+class RetainedSizeAccumulator {
+ public:
+  /// Adds the capacity of 'buffer' unless it was added before. 'buffer' may
+  /// be null.
+  void addBuffer(const Buffer* buffer) {
+    if (buffer && buffers_.insert(buffer).second) {
+      bytes_ += buffer->capacity();
+    }
+  }
+
+  /// Adds memory that is not held in a Buffer.
+  void addBytes(uint64_t bytes) {
+    bytes_ += bytes;
+  }
+
+  /// Returns true if 'vector' was not added before. The Buffers of a vector
+  /// are added only the first time the vector is seen.
+  bool addVector(const BaseVector* vector) {
+    return vectors_.insert(vector).second;
+  }
+
+  uint64_t bytes() const {
+    return bytes_;
+  }
+
+ private:
+  folly::F14FastSet<const Buffer*> buffers_;
+  folly::F14FastSet<const BaseVector*> vectors_;
+  uint64_t bytes_{0};
+};
+
 /**
  * Base class for all columnar-based vectors of any type.
  */
@@ -602,6 +641,23 @@ class BaseVector {
     return nulls_ ? nulls_->capacity() : 0;
   }
 
+  /// Adds the memory kept live through 'this' to 'accumulator'. Buffers and
+  /// child vectors shared with vectors added before are not added again.
+  void addRetainedSize(RetainedSizeAccumulator& accumulator) const {
+    if (accumulator.addVector(this)) {
+      addRetainedBuffers(accumulator);
+    }
+  }
+
+  /// Returns the byte size of memory that is kept live through 'this', with
+  /// Buffers and vectors that are referenced more than once counted once.
+  /// Slower than retainedSize() since it keeps a set of the Buffers seen.
+  uint64_t deduplicatedRetainedSize() const {
+    RetainedSizeAccumulator accumulator;
+    addRetainedSize(accumulator);
+    return accumulator.bytes();
+  }
+
   /// Returns an estimate of the 'retainedSize' of a flat representation of the
   /// data stored in this vector. Returns zero if this is a lazy vector that
   /// hasn't been loaded yet.
@@ -661,6 +717,13 @@ class BaseVector {
   }
 
  protected:
+  // Adds the Buffers of 'this' and calls addRetainedSize() on the children.
+  // Subclasses add their Buffers to those of the base class.
+  virtual void addRetainedBuffers(
+      RetainedSizeAccumulator& accumulator) const {
+    accumulator.addBuffer(nulls_.get());
+  }
+
   /*
    * Allocates or reallocates nulls_ with the given size if nulls_ hasn't
    * been allocated yet or has been allocated with a smaller capacity.
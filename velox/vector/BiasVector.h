@@ -159,6 +159,12 @@ class BiasVector : public SimpleVector<T> {
     return true;
   }
 
+ protected:
+  void addRetainedBuffers(RetainedSizeAccumulator& accumulator) const override {
+    BaseVector::addRetainedBuffers(accumulator);
+    accumulator.addBuffer(values_.get());
+  }
+
  private:
   template <typename U>
   inline xsimd::batch<T> loadSIMDInternal(size_t byteOffset) const {
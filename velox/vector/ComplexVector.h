@@ -166,6 +166,16 @@ class RowVector : public BaseVector {
     return false;
   }
 
+ protected:
+  void addRetainedBuffers(RetainedSizeAccumulator& accumulator) const override {
+    BaseVector::addRetainedBuffers(accumulator);
+    for (auto& child : children_) {
+      if (child) {
+        child->addRetainedSize(accumulator);
+      }
+    }
+  }
+
  private:
   vector_size_t childSize() const {
     bool allConstant = false;
@@ -385,6 +395,14 @@ class ArrayVector : public BaseVector {
         elements_->mayHaveNullsRecursive();
   }
 
+ protected:
+  void addRetainedBuffers(RetainedSizeAccumulator& accumulator) const override {
+    BaseVector::addRetainedBuffers(accumulator);
+    accumulator.addBuffer(offsets_.get());
+    accumulator.addBuffer(sizes_.get());
+    elements_->addRetainedSize(accumulator);
+  }
+
  private:
   BufferPtr offsets_;
   const vector_size_t* rawOffsets_;
@@ -576,6 +594,15 @@ class MapVector : public BaseVector {
         keys_->mayHaveNullsRecursive() || values_->mayHaveNullsRecursive();
   }
 
+ protected:
+  void addRetainedBuffers(RetainedSizeAccumulator& accumulator) const override {
+    BaseVector::addRetainedBuffers(accumulator);
+    accumulator.addBuffer(offsets_.get());
+    accumulator.addBuffer(sizes_.get());
+    keys_->addRetainedSize(accumulator);
+    values_->addRetainedSize(accumulator);
+  }
+
  private:
   // Returns true if the keys for map at 'index' are sorted from first
   // to last in the type's collation order.
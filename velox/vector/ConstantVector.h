@@ -334,6 +334,18 @@ class ConstantVector final : public SimpleVector<T> {
     return valueVector_->toString(index_);
   }
 
+ protected:
+  void addRetainedBuffers(RetainedSizeAccumulator& accumulator) const override {
+    VELOX_DCHECK(initialized_);
+    if (valueVector_) {
+      valueVector_->addRetainedSize(accumulator);
+    } else if (stringBuffer_) {
+      accumulator.addBuffer(stringBuffer_.get());
+    } else {
+      accumulator.addBytes(sizeof(T));
+    }
+  }
+
  private:
   void setInternalState() {
     if (isLazyNotLoaded(*valueVector_)) {
@@ -225,6 +225,14 @@ class DictionaryVector : public SimpleVector<T> {
     BaseVector::resize(size, setNotNull);
   }
 
+ protected:
+  void addRetainedBuffers(RetainedSizeAccumulator& accumulator) const override {
+    BaseVector::addRetainedBuffers(accumulator);
+    dictionaryValues_->addRetainedSize(accumulator);
+    accumulator.addBuffer(indices_.get());
+    accumulator.addBuffer(flatNullsBuffer_.get());
+  }
+
  private:
   // return the dictionary index for the specified vector index.
   inline vector_size_t getDictionaryIndex(vector_size_t idx) const {
@@ -328,6 +328,15 @@ class FlatVector final : public SimpleVector<T> {
   /// mutable. Resizes the buffer to zero to allow for reuse instead of append.
   void prepareForReuse() override;
 
+ protected:
+  void addRetainedBuffers(RetainedSizeAccumulator& accumulator) const override {
+    BaseVector::addRetainedBuffers(accumulator);
+    accumulator.addBuffer(values_.get());
+    for (auto& buffer : stringBuffers_) {
+      accumulator.addBuffer(buffer.get());
+    }
+  }
+
  private:
   void copyValuesAndNulls(
       const BaseVector* source,
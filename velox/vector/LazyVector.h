@@ -281,6 +281,15 @@ class LazyVector : public BaseVector {
       DecodedVector& decoded,
       SelectivityVector& baseRows);
 
+ protected:
+  void addRetainedBuffers(RetainedSizeAccumulator& accumulator) const override {
+    if (isLoaded()) {
+      loadedVector()->addRetainedSize(accumulator);
+    } else {
+      BaseVector::addRetainedBuffers(accumulator);
+    }
+  }
+
  private:
   std::unique_ptr<VectorLoader> loader_;
 
@@ -15,7 +15,71 @@
  */
 #include "velox/vector/SelectivityVector.h"
 
+#include <xsimd/xsimd.hpp>
+
 namespace facebook::velox {
+namespace {
+
+// Below this many rows between begin and end, applyToSelected scans the bits.
+constexpr int32_t kMinRowsForCompactIteration = 512;
+
+// Ranges are used if the selected rows form ranges of at least this many rows
+// on average.
+constexpr int32_t kMinAverageRangeLength = 32;
+
+// Row numbers are used if at most one in this many rows is selected, i.e. if
+// most words of the bitmap are zero.
+constexpr int32_t kMinRowsPerIndex = 64;
+
+// Calls 'func(index, word)' for each word of 'bits' covering [begin, end),
+// with the bits outside of the range cleared.
+template <typename Func>
+void forEachMaskedWord(
+    const uint64_t* bits,
+    int32_t begin,
+    int32_t end,
+    Func func) {
+  bits::forEachWord(
+      begin,
+      end,
+      [&](int32_t index, uint64_t mask) { func(index, bits[index] & mask); },
+      [&](int32_t index) { func(index, bits[index]); });
+}
+
+// target = target AND right, or target AND NOT right if 'negate', for the bits
+// in [begin, end). The full words are processed a SIMD register at a time.
+template <bool negate>
+void andBitsBatch(
+    uint64_t* target,
+    const uint64_t* right,
+    int32_t begin,
+    int32_t end) {
+  using Batch = xsimd::batch<uint64_t>;
+  constexpr int32_t kWordsPerBatch = Batch::size;
+  const int32_t firstWord = bits::roundUp(begin, 64) / 64;
+  const int32_t lastWord = end / 64;
+  if (lastWord - firstWord < kWordsPerBatch) {
+    bits::andRange<negate>(target, target, right, begin, end);
+    return;
+  }
+  bits::andRange<negate>(target, target, right, begin, firstWord * 64);
+  bits::andRange<negate>(target, target, right, lastWord * 64, end);
+  auto i = firstWord;
+  for (; i + kWordsPerBatch <= lastWord; i += kWordsPerBatch) {
+    auto left = Batch::load_unaligned(target + i);
+    auto other = Batch::load_unaligned(right + i);
+    if constexpr (negate) {
+      xsimd::bitwise_andnot(left, other).store_unaligned(target + i);
+    } else {
+      (left & other).store_unaligned(target + i);
+    }
+  }
+  for (; i < lastWord; ++i) {
+    target[i] &= negate ? ~right[i] : right[i];
+  }
+}
+
+} // namespace
 
 // static
 const SelectivityVector& SelectivityVector::empty() {
@@ -52,4 +116,65 @@ std::string SelectivityVector::toString(
   return out.str();
 }
 
+void SelectivityVector::intersect(const SelectivityVector& other) {
+  andBitsBatch<false>(
+      bits_.data(), other.bits_.data(), begin_, std::min(end_, other.size()));
+  updateBounds();
+}
+
+void SelectivityVector::deselect(const SelectivityVector& other) {
+  andBitsBatch<true>(
+      bits_.data(), other.bits_.data(), begin_, std::min(end_, other.size()));
+  updateBounds();
+}
+
+void SelectivityVector::prepareIteration() {
+  iteration_ = Iteration::kBits;
+  const auto numRows = end_ - begin_;
+  if (numRows < kMinRowsForCompactIteration) {
+    return;
+  }
+  // A range starts at each set bit whose lower neighbor is not set. 'carry'
+  // is the highest bit of the previous word.
+  int64_t numSelected = 0;
+  int64_t numRanges = 0;
+  uint64_t carry = 0;
+  forEachMaskedWord(
+      bits_.data(), begin_, end_, [&](int32_t /*index*/, uint64_t word) {
+        numSelected += __builtin_popcountll(word);
+        numRanges += __builtin_popcountll(word & ~((word << 1) | carry));
+        carry = word >> 63;
+      });
+
+  if (numRanges * kMinAverageRangeLength <= numSelected) {
+    iteration_ = Iteration::kRanges;
+    compactRows_.clear();
+    compactRows_.reserve(numRanges * 2);
+    // The starts and ends of ranges alternate, so the positions of both in
+    // ascending order give the [begin, end) pairs.
+    carry = 0;
+    forEachMaskedWord(
+        bits_.data(), begin_, end_, [&](int32_t index, uint64_t word) {
+          const auto shifted = (word << 1) | carry;
+          auto edges = word ^ shifted;
+          while (edges) {
+            compactRows_.push_back(index * 64 + __builtin_ctzll(edges));
+            edges &= edges - 1;
+          }
+          carry = word >> 63;
+        });
+    if (compactRows_.size() % 2) {
+      // The last range ends at a word boundary.
+      compactRows_.push_back(end_);
+    }
+  } else if (numSelected * kMinRowsPerIndex <= numRows) {
+    iteration_ = Iteration::kIndices;
+    compactRows_.clear();
+    compactRows_.reserve(numSelected);
+    bits::forEachSetBit(bits_.data(), begin_, end_, [&](vector_size_t row) {
+      compactRows_.push_back(row);
+    });
+  }
+}
+
 } // namespace facebook::velox
@@ -87,6 +87,7 @@ class SelectivityVector {
     size_ = size;
     begin_ = 0;
     end_ = value ? size_ : 0;
+    resetCachedState();
     allSelected_ = value;
   }
 
@@ -98,7 +99,7 @@ class SelectivityVector {
   void setValid(vector_size_t idx, bool valid) {
     VELOX_DCHECK_LT(idx, bits_.size() * sizeof(bits_[0]) * 8);
     bits::setBit(bits_.data(), idx, valid);
-    allSelected_.reset();
+    resetCachedState();
   }
 
   /**
@@ -109,7 +110,7 @@ class SelectivityVector {
   void setValidRange(vector_size_t begin, vector_size_t end, bool valid) {
     VELOX_DCHECK_LE(end, bits_.size() * sizeof(bits_[0]) * 8);
     bits::fillBits(bits_.data(), begin, end, valid);
-    allSelected_.reset();
+    resetCachedState();
   }
 
   /**
@@ -127,6 +128,7 @@ class SelectivityVector {
    * updateBounds() need to be called explicitly if data is modified.
    */
   MutableRange<bool> asMutableRange() {
+    resetCachedState();
     return MutableRange<bool>(bits_.data(), begin_, end_);
   }
 
@@ -135,7 +137,7 @@ class SelectivityVector {
     VELOX_DCHECK_LE(end, size_, "Range end out of range");
     begin_ = begin;
     end_ = end;
-    allSelected_.reset();
+    resetCachedState();
   }
 
   vector_size_t begin() const {
@@ -160,6 +162,7 @@ class SelectivityVector {
     bits::fillBits(bits_.data(), 0, size_, false);
     begin_ = 0;
     end_ = 0;
+    resetCachedState();
     allSelected_ = false;
   }
 
@@ -170,6 +173,7 @@ class SelectivityVector {
     bits::fillBits(bits_.data(), 0, size_, true);
     begin_ = 0;
     end_ = size_;
+    resetCachedState();
     allSelected_ = true;
   }
 
@@ -188,22 +192,14 @@ class SelectivityVector {
   /**
    * Removes rows that are not present in the 'other' vector.
    */
-  void intersect(const SelectivityVector& other) {
-    bits::andBits(
-        bits_.data(), other.bits_.data(), begin_, std::min(end_, other.size()));
-    updateBounds();
-  }
+  void intersect(const SelectivityVector& other);
 
   /**
    * Merges the valid vector of another SelectivityVector by !AND'ing them
    * together. This is used to support logical deletes where
    * any keys passing should actually be inverted
    */
-  void deselect(const SelectivityVector& other) {
-    bits::andWithNegatedBits(
-        bits_.data(), other.bits_.data(), begin_, std::min(end_, other.size()));
-    updateBounds();
-  }
+  void deselect(const SelectivityVector& other);
 
   void deselect(const uint64_t* bits, int32_t begin, int32_t end) {
     bits::andWithNegatedBits(
@@ -278,6 +274,7 @@ class SelectivityVector {
    */
   void updateBounds() {
     begin_ = bits::findFirstBit(bits_.data(), 0, size_);
+    resetCachedState();
     if (begin_ == -1) {
       begin_ = 0;
       end_ = 0;
@@ -285,7 +282,6 @@ class SelectivityVector {
       return;
     }
     end_ = bits::findLastBit(bits_.data(), begin_, size_) + 1;
-    allSelected_.reset();
   }
 
   bool isAllSelected() const {
@@ -324,10 +320,19 @@ class SelectivityVector {
   }
 
   /// Invokes a function on each selected row. The function must take a single
-  /// "row" argument of type vector_size_t and return void.
+  /// "row" argument of type vector_size_t and return void. Uses the list of
+  /// ranges or row numbers made by prepareIteration() if the selection has
+  /// not changed since.
   template <typename Callable>
   void applyToSelected(Callable func) const;
 
+  /// Makes a list of ranges or row numbers of the selected rows if the
+  /// selection is a few long ranges or is so sparse that most words are zero.
+  /// Worthwhile before iterating over the same selection many times. The
+  /// list is dropped by any change to the selection. Must not be called from
+  /// inside applyToSelected() over 'this'.
+  void prepareIteration();
+
   /// Invokes a function on each selected row sequentially in order starting
   /// from the lowest row number until a function returns 'false' or all
   /// selected rows have been processed. The function must take a single "row"
@@ -360,6 +365,27 @@ class SelectivityVector {
   }
 
  private:
+  // How applyToSelected visits the selected rows when not all rows are
+  // selected. Chosen by prepareIteration() and kept until the selection
+  // changes.
+  enum class Iteration : int8_t {
+    // Not prepared. Same as kBits.
+    kUnknown,
+    // Scans the words of 'bits_'.
+    kBits,
+    // Loops over the [begin, end) pairs in 'compactRows_'.
+    kRanges,
+    // Loops over the row numbers in 'compactRows_'.
+    kIndices,
+  };
+
+  // 'compactRows_' is left as is, so that a function called from
+  // applyToSelected may change the selection it is iterating over.
+  void resetCachedState() {
+    allSelected_.reset();
+    iteration_ = Iteration::kUnknown;
+  }
+
   // the vector of bits for what is selected vs not (1 is selected)
   std::vector<uint64_t> bits_;
   // The number of leading bits used in 'bits_'.
@@ -369,6 +395,9 @@ class SelectivityVector {
   // one past the last selected value, if there are any selected
   vector_size_t end_ = 0;
   mutable std::optional<bool> allSelected_;
+  Iteration iteration_ = Iteration::kUnknown;
+  // Ranges or row numbers of the selected rows, depending on 'iteration_'.
+  std::vector<vector_size_t> compactRows_;
 
   friend class SelectivityIterator;
 };
@@ -421,8 +450,24 @@ inline void SelectivityVector::applyToSelected(Callable func) const {
     for (vector_size_t row = begin_; row < end_; ++row) {
       func(row);
     }
-  } else {
-    bits::forEachSetBit(bits_.data(), begin_, end_, func);
+    return;
+  }
+  switch (iteration_) {
+    case Iteration::kRanges:
+      for (size_t i = 0; i < compactRows_.size(); i += 2) {
+        const auto end = compactRows_[i + 1];
+        for (auto row = compactRows_[i]; row < end; ++row) {
+          func(row);
+        }
+      }
+      break;
+    case Iteration::kIndices:
+      for (auto row : compactRows_) {
+        func(row);
+      }
+      break;
+    default:
+      bits::forEachSetBit(bits_.data(), begin_, end_, func);
   }
 }
 
@@ -169,10 +169,23 @@ class SequenceVector : public SimpleVector<T> {
     return sequenceValues_->wrappedIndex(offsetOfIndex(index));
   }
 
+  // Nulls are only present at the level of the runs. Callers that need to add
+  // nulls must make the vector writable first.
+  bool isNullsWritable() const override {
+    return false;
+  }
+
   void addNulls(const uint64_t* bits, const SelectivityVector& rows) override {
     throw std::runtime_error("addNulls not supported");
   }
 
+ protected:
+  void addRetainedBuffers(RetainedSizeAccumulator& accumulator) const override {
+    sequenceValues_->addRetainedSize(accumulator);
+    accumulator.addBuffer(sequenceLengths_.get());
+    accumulator.addBuffer(flatNullsBuffer_.get());
+  }
+
  private:
   // Prepares for use after construction.
   void setInternalState();
@@ -0,0 +1,70 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "velox/vector/VectorPool.h"
+
+namespace facebook::velox {
+
+VectorPool::TypePool* VectorPool::typePool(const Type& type) {
+  const auto kind = static_cast<int32_t>(type.kind());
+  if (kind >= kNumCachedKinds || type.kind() == TypeKind::VARCHAR ||
+      type.kind() == TypeKind::VARBINARY) {
+    return nullptr;
+  }
+  return &typePools_[kind];
+}
+
+VectorPtr VectorPool::get(const TypePtr& type, vector_size_t size) {
+  auto* pool = typePool(*type);
+  if (pool != nullptr && pool->size > 0 && size <= kMaxCachedSize) {
+    auto& cached = pool->vectors[pool->size - 1];
+    // Custom types may share a kind with a builtin type.
+    if (*cached->type() == *type) {
+      auto vector = std::move(cached);
+      --pool->size;
+      vector->resetNulls();
+      vector->resize(size);
+      return vector;
+    }
+  }
+  return BaseVector::create(type, size, pool_);
+}
+
+bool VectorPool::release(VectorPtr& vector) {
+  if (vector == nullptr || vector->size() > kMaxCachedSize ||
+      vector->pool() != pool_) {
+    return false;
+  }
+  auto* pool = typePool(*vector->type());
+  if (pool == nullptr || pool->size == kNumPerKind ||
+      !BaseVector::isReusableFlatVector(vector)) {
+    return false;
+  }
+  pool->vectors[pool->size++] = std::move(vector);
+  return true;
+}
+
+size_t VectorPool::release(std::vector<VectorPtr>& vectors) {
+  size_t numReleased = 0;
+  for (auto& vector : vectors) {
+    if (release(vector)) {
+      ++numReleased;
+    }
+  }
+  vectors.clear();
+  return numReleased;
+}
+
+} // namespace facebook::velox
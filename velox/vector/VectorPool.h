@@ -0,0 +1,75 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#pragma once
+
+#include <array>
+
+#include "velox/vector/BaseVector.h"
+
+namespace facebook::velox {
+
+/// A cache of flat vectors of fixed width primitive types for reuse between
+/// batches. A VectorPool is not thread-safe. It is meant to be owned by a
+/// single driver thread, e.g. through core::ExecCtx.
+///
+/// Vectors enter the pool through release() once their user is done with
+/// them, e.g. intermediate results of expressions, and leave it through get().
+/// Only singly-referenced flat vectors with singly-referenced, mutable buffers
+/// are kept, so that reusing them cannot be observed by anyone else.
+class VectorPool {
+ public:
+  explicit VectorPool(memory::MemoryPool* pool) : pool_(pool) {}
+
+  /// Returns a flat vector of 'type' with 'size' rows and no nulls. Reuses a
+  /// vector from the pool if there is one of the same type. The values are
+  /// undefined.
+  VectorPtr get(const TypePtr& type, vector_size_t size);
+
+  /// Moves 'vector' into the pool and returns true if it can be reused.
+  /// Otherwise leaves 'vector' unchanged and returns false.
+  bool release(VectorPtr& vector);
+
+  /// Calls release() on each of 'vectors', then clears 'vectors'. Returns
+  /// the number of vectors moved into the pool.
+  size_t release(std::vector<VectorPtr>& vectors);
+
+ private:
+  // Vectors of up to this many rows are kept.
+  static constexpr vector_size_t kMaxCachedSize = 10'000;
+
+  // Maximum number of vectors of each type kind.
+  static constexpr int32_t kNumPerKind = 10;
+
+  // TypeKinds up to and including DATE may be cached. Only the fixed width
+  // ones are.
+  static constexpr int32_t kNumCachedKinds =
+      static_cast<int32_t>(TypeKind::DATE) + 1;
+
+  struct TypePool {
+    int32_t size{0};
+    std::array<VectorPtr, kNumPerKind> vectors;
+  };
+
+  // Returns the pool for vectors of 'type' or nullptr if 'type' is not
+  // cached.
+  TypePool* typePool(const Type& type);
+
+  memory::MemoryPool* const pool_;
+
+  std::array<TypePool, kNumCachedKinds> typePools_;
+};
+
+} // namespace facebook::velox
@@ -15,6 +15,7 @@
  */
 #include "velox/vector/VectorStream.h"
 #include <memory>
+#include <unordered_map>
 
 namespace facebook::velox {
 
@@ -23,8 +24,33 @@ std::unique_ptr<VectorSerde>& getVectorSerde() {
   static std::unique_ptr<VectorSerde> serde;
   return serde;
 }
+
+std::unordered_map<std::string, std::unique_ptr<VectorSerde>>&
+namedVectorSerdes() {
+  static std::unordered_map<std::string, std::unique_ptr<VectorSerde>> serdes;
+  return serdes;
+}
+
+// Returns 'serde' or, if nullptr, the default serde.
+VectorSerde* serdeOrDefault(VectorSerde* serde) {
+  if (serde) {
+    return serde;
+  }
+  VELOX_CHECK(getVectorSerde().get(), "Vector serde is not registered");
+  return getVectorSerde().get();
+}
 } // namespace
 
+void VectorSerde::appendPartitioned(
+    const std::shared_ptr<RowVector>& vector,
+    const std::vector<folly::Range<const IndexRange*>>& ranges,
+    const std::vector<VectorSerializer*>& serializers) {
+  VELOX_CHECK_EQ(ranges.size(), serializers.size());
+  for (auto i = 0; i < serializers.size(); ++i) {
+    serializers[i]->append(vector, ranges[i]);
+  }
+}
+
 bool registerVectorSerde(std::unique_ptr<VectorSerde> serde) {
   VELOX_CHECK(!getVectorSerde().get(), "Vector serde is already registered");
   getVectorSerde() = std::move(serde);
@@ -35,11 +61,37 @@ bool isRegisteredVectorSerde() {
   return (getVectorSerde().get() != nullptr);
 }
 
+bool registerNamedVectorSerde(
+    const std::string& name,
+    std::unique_ptr<VectorSerde> serde) {
+  auto& serdes = namedVectorSerdes();
+  VELOX_CHECK(
+      serdes.find(name) == serdes.end(),
+      "Vector serde '{}' is already registered",
+      name);
+  serdes[name] = std::move(serde);
+  return true;
+}
+
+bool isRegisteredNamedVectorSerde(const std::string& name) {
+  auto& serdes = namedVectorSerdes();
+  return serdes.find(name) != serdes.end();
+}
+
+VectorSerde* getNamedVectorSerde(const std::string& name) {
+  auto& serdes = namedVectorSerdes();
+  auto it = serdes.find(name);
+  VELOX_USER_CHECK(
+      it != serdes.end(), "Vector serde '{}' is not registered", name);
+  return it->second.get();
+}
+
 void VectorStreamGroup::createStreamTree(
     std::shared_ptr<const RowType> type,
-    int32_t numRows) {
-  VELOX_CHECK(getVectorSerde().get(), "Vector serde is not registered");
-  serializer_ = getVectorSerde()->createSerializer(type, numRows, this);
+    int32_t numRows,
+    const VectorSerde::Options* options) {
+  serializer_ =
+      serdeOrDefault(serde_)->createSerializer(type, numRows, this, options);
 }
 
 void VectorStreamGroup::append(
@@ -48,6 +100,24 @@ void VectorStreamGroup::append(
   serializer_->append(vector, ranges);
 }
 
+// static
+void VectorStreamGroup::appendPartitioned(
+    const std::shared_ptr<RowVector>& vector,
+    const std::vector<folly::Range<const IndexRange*>>& ranges,
+    const std::vector<VectorStreamGroup*>& groups) {
+  if (groups.empty()) {
+    return;
+  }
+  std::vector<VectorSerializer*> serializers;
+  serializers.reserve(groups.size());
+  for (auto* group : groups) {
+    VELOX_CHECK(group->serde_ == groups[0]->serde_);
+    serializers.push_back(group->serializer_.get());
+  }
+  serdeOrDefault(groups[0]->serde_)
+      ->appendPartitioned(vector, ranges, serializers);
+}
+
 void VectorStreamGroup::flush(OutputStream* out) {
   serializer_->flush(out);
 }
@@ -56,9 +126,9 @@ void VectorStreamGroup::flush(OutputStream* out) {
 void VectorStreamGroup::estimateSerializedSize(
     std::shared_ptr<BaseVector> vector,
     const folly::Range<const IndexRange*>& ranges,
-    vector_size_t** sizes) {
-  VELOX_CHECK(getVectorSerde().get(), "Vector serde is not registered");
-  getVectorSerde()->estimateSerializedSize(vector, ranges, sizes);
+    vector_size_t** sizes,
+    VectorSerde* serde) {
+  serdeOrDefault(serde)->estimateSerializedSize(vector, ranges, sizes);
 }
 
 // static
@@ -66,9 +136,10 @@ void VectorStreamGroup::read(
     ByteStream* source,
     velox::memory::MemoryPool* pool,
     std::shared_ptr<const RowType> type,
-    std::shared_ptr<RowVector>* result) {
-  VELOX_CHECK(getVectorSerde().get(), "Vector serde is not registered");
-  getVectorSerde()->deserialize(source, pool, type, result);
+    std::shared_ptr<RowVector>* result,
+    const VectorSerde::Options* options,
+    VectorSerde* serde) {
+  serdeOrDefault(serde)->deserialize(source, pool, type, result, options);
 }
 
 } // namespace facebook::velox
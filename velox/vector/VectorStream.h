@@ -15,6 +15,8 @@
  */
 #pragma once
 
+#include <folly/compression/Compression.h>
+
 #include "velox/buffer/Buffer.h"
 #include "velox/common/memory/ByteStream.h"
 #include "velox/common/memory/MappedMemory.h"
@@ -48,6 +50,54 @@ class VectorSerializer {
 
 class VectorSerde {
  public:
+  /// Counters of the compression of the pages of one stream, e.g. the pages
+  /// of a PartitionedOutput. The serializers of consecutive pages share these
+  /// and use them to decide whether compression is worth trying.
+  struct CompressionStats {
+    /// Number of pages sent compressed.
+    int64_t numCompressedPages{0};
+
+    /// Number of pages that were sent uncompressed because compressing them
+    /// did not save enough.
+    int64_t numIncompressiblePages{0};
+
+    /// Number of pages that were not compressed because recent pages did not
+    /// compress well.
+    int64_t numSkippedPages{0};
+
+    /// Bytes given to the codec and bytes it returned.
+    int64_t compressionInputBytes{0};
+    int64_t compressedBytes{0};
+
+    /// Time spent in the codec.
+    uint64_t compressionTimeUs{0};
+
+    /// Number of upcoming pages to send without trying compression.
+    int32_t pagesToSkip{0};
+
+    /// Number of pages to skip after the next page that does not compress
+    /// well. Doubles for each such page in a row.
+    int32_t skipInterval{1};
+  };
+
+  /// Options given to the serializer and deserializer of a stream. The
+  /// writer and the reader of a stream must agree on 'compressionKind'.
+  struct Options {
+    virtual ~Options() = default;
+
+    /// Codec for compressing the pages. NO_COMPRESSION for none.
+    folly::io::CodecType compressionKind{
+        folly::io::CodecType::NO_COMPRESSION};
+
+    /// A page is sent compressed only if its compressed size is at most
+    /// this fraction of its uncompressed size.
+    double minCompressionRatio{0.8};
+
+    /// Counters updated by the serializer. nullptr if not needed. Without
+    /// counters, compression is tried for every page.
+    CompressionStats* compressionStats{nullptr};
+  };
+
   virtual ~VectorSerde() = default;
 
   virtual void estimateSerializedSize(
@@ -58,19 +108,43 @@ class VectorSerde {
   virtual std::unique_ptr<VectorSerializer> createSerializer(
       std::shared_ptr<const RowType> type,
       int32_t numRows,
-      StreamArena* streamArena) = 0;
+      StreamArena* streamArena,
+      const Options* options = nullptr) = 0;
+
+  /// Appends 'ranges[i]' of 'vector' to 'serializers[i]' for each i. The
+  /// serializers are created by 'this' for the type of 'vector'. Serdes with
+  /// columnar serializers override this to write each column to all the
+  /// serializers in one pass, e.g. to scatter a batch to the pages of many
+  /// destinations. The default appends to one serializer at a time.
+  virtual void appendPartitioned(
+      const std::shared_ptr<RowVector>& vector,
+      const std::vector<folly::Range<const IndexRange*>>& ranges,
+      const std::vector<VectorSerializer*>& serializers);
 
   virtual void deserialize(
       ByteStream* source,
       velox::memory::MemoryPool* pool,
       std::shared_ptr<const RowType> type,
-      std::shared_ptr<RowVector>* result) = 0;
+      std::shared_ptr<RowVector>* result,
+      const Options* options = nullptr) = 0;
 };
 
 bool registerVectorSerde(std::unique_ptr<VectorSerde> serde);
 
 bool isRegisteredVectorSerde();
 
+/// Registers 'serde' under 'name', next to the default serde registered with
+/// registerVectorSerde(). Named serdes are selected per stream, e.g. by the
+/// "exchange-serde" query config.
+bool registerNamedVectorSerde(
+    const std::string& name,
+    std::unique_ptr<VectorSerde> serde);
+
+bool isRegisteredNamedVectorSerde(const std::string& name);
+
+/// Returns the serde registered under 'name'. Throws if there is none.
+VectorSerde* getNamedVectorSerde(const std::string& name);
+
 #define _VELOX_REGISTER_VECTOR_SERDE_NAME(serde) registerVectorSerde_##serde
 
 #define VELOX_DECLARE_VECTOR_SERDE(serde)             \
@@ -84,22 +158,38 @@ bool isRegisteredVectorSerde();
     _VELOX_REGISTER_VECTOR_SERDE_NAME(serde)();             \
   }
 
+/// Serializes and deserializes with the default serde unless given another
+/// one.
 class VectorStreamGroup : public StreamArena {
  public:
-  explicit VectorStreamGroup(memory::MappedMemory* mappedMemory)
-      : StreamArena(mappedMemory) {}
+  explicit VectorStreamGroup(
+      memory::MappedMemory* mappedMemory,
+      VectorSerde* serde = nullptr)
+      : StreamArena(mappedMemory), serde_(serde) {}
 
-  void createStreamTree(std::shared_ptr<const RowType> type, int32_t numRows);
+  void createStreamTree(
+      std::shared_ptr<const RowType> type,
+      int32_t numRows,
+      const VectorSerde::Options* options = nullptr);
 
   static void estimateSerializedSize(
       std::shared_ptr<BaseVector> vector,
       const folly::Range<const IndexRange*>& ranges,
-      vector_size_t** sizes);
+      vector_size_t** sizes,
+      VectorSerde* serde = nullptr);
 
   void append(
       std::shared_ptr<RowVector> vector,
       const folly::Range<const IndexRange*>& ranges);
 
+  /// Appends 'ranges[i]' of 'vector' to 'groups[i]' for each i with
+  /// VectorSerde::appendPartitioned(). The groups must have the same serde
+  /// and their stream trees must be created.
+  static void appendPartitioned(
+      const std::shared_ptr<RowVector>& vector,
+      const std::vector<folly::Range<const IndexRange*>>& ranges,
+      const std::vector<VectorStreamGroup*>& groups);
+
   // Writes the contents to 'stream' in wire format.
   void flush(OutputStream* stream);
 
@@ -108,9 +198,12 @@ class VectorStreamGroup : public StreamArena {
       ByteStream* source,
       velox::memory::MemoryPool* pool,
       std::shared_ptr<const RowType> type,
-      std::shared_ptr<RowVector>* result);
+      std::shared_ptr<RowVector>* result,
+      const VectorSerde::Options* options = nullptr,
+      VectorSerde* serde = nullptr);
 
  private:
+  VectorSerde* const serde_;
   std::unique_ptr<VectorSerializer> serializer_;
 };
 
@@ -16,6 +16,8 @@
 
 #include "velox/vector/arrow/Bridge.h"
 
+#include <cerrno>
+
 #include "velox/buffer/Buffer.h"
 #include "velox/common/base/BitUtil.h"
 #include "velox/common/base/Exceptions.h"
@@ -464,6 +466,12 @@ void exportToArrow(const TypePtr& type, ArrowSchema& arrowSchema) {
 }
 
 TypePtr importFromArrow(const ArrowSchema& arrowSchema) {
+  // The format of a dictionary encoded array is the type of its indices. The
+  // type of the values is the type of the dictionary.
+  if (arrowSchema.dictionary != nullptr) {
+    return importFromArrow(*arrowSchema.dictionary);
+  }
+
   const char* format = arrowSchema.format;
   VELOX_CHECK_NOT_NULL(format);
 
@@ -647,10 +655,11 @@ VectorPtr createStringFlatVector(
     shouldAcquireStringBuffer |= !rawStringViews[i].isInline();
   }
 
+  // The StringViews point into the Arrow values buffer, which is kept alive
+  // by the vector.
   std::vector<BufferPtr> stringViewBuffers;
   if (shouldAcquireStringBuffer) {
-    stringViewBuffers.emplace_back(
-        wrapInBufferView(values, offsets[length + 1]));
+    stringViewBuffers.emplace_back(wrapInBufferView(values, offsets[length]));
   }
 
   return std::make_shared<FlatVector<StringView>>(
@@ -672,6 +681,121 @@ VectorPtr importFromArrowImpl(
     bool isViewer,
     WrapInBufferViewFunc wrapInBufferView);
 
+// Returns the indices of a dictionary encoded ArrowArray as vector_size_t.
+// 32 bit indices are wrapped without a copy, unless a null row has an index
+// out of the range of the dictionary. Velox expects valid indices also for
+// null rows, whereas Arrow leaves them undefined.
+template <typename TIndex>
+BufferPtr importDictionaryIndices(
+    memory::MemoryPool* pool,
+    const uint64_t* rawNulls,
+    size_t length,
+    const TIndex* indices,
+    vector_size_t dictionarySize,
+    const WrapInBufferViewFunc& wrapInBufferView) {
+  auto isValid = [&](size_t row) {
+    return indices[row] >= 0 && indices[row] < dictionarySize;
+  };
+  if constexpr (sizeof(TIndex) == sizeof(vector_size_t)) {
+    bool nullIndicesValid = true;
+    if (rawNulls != nullptr) {
+      for (size_t row = 0; row < length; ++row) {
+        if (bits::isBitNull(rawNulls, row) && !isValid(row)) {
+          nullIndicesValid = false;
+          break;
+        }
+      }
+    }
+    if (nullIndicesValid) {
+      return wrapInBufferView(indices, length * sizeof(vector_size_t));
+    }
+  }
+
+  auto buffer = AlignedBuffer::allocate<vector_size_t>(length, pool);
+  auto* rawIndices = buffer->asMutable<vector_size_t>();
+  for (size_t row = 0; row < length; ++row) {
+    rawIndices[row] = (rawNulls != nullptr && bits::isBitNull(rawNulls, row) &&
+                       !isValid(row))
+        ? 0
+        : indices[row];
+  }
+  return buffer;
+}
+
+// Imports a dictionary encoded ArrowArray as a DictionaryVector. The
+// dictionary is imported recursively. Its buffers are kept alive the same way
+// as the ones of 'arrowArray', which owns it.
+VectorPtr createDictionaryVector(
+    memory::MemoryPool* pool,
+    BufferPtr nulls,
+    const ArrowSchema& arrowSchema,
+    const ArrowArray& arrowArray,
+    bool isViewer,
+    const WrapInBufferViewFunc& wrapInBufferView) {
+  VELOX_USER_CHECK_NOT_NULL(
+      arrowSchema.dictionary,
+      "Dictionary encoded arrowArray needs a dictionary in arrowSchema.");
+  VELOX_USER_CHECK_EQ(
+      arrowArray.n_buffers,
+      2,
+      "Expecting two buffers as input for dictionary indices.");
+  auto dictionary = importFromArrowImpl(
+      *arrowSchema.dictionary,
+      *arrowArray.dictionary,
+      pool,
+      isViewer,
+      wrapInBufferView);
+
+  const auto* rawNulls = nulls ? nulls->as<uint64_t>() : nullptr;
+  const auto length = arrowArray.length;
+  const auto* indices = arrowArray.buffers[1];
+  const auto dictionarySize = dictionary->size();
+  BufferPtr indicesBuffer;
+  switch (arrowSchema.format[0]) {
+    case 'c':
+      indicesBuffer = importDictionaryIndices(
+          pool,
+          rawNulls,
+          length,
+          static_cast<const int8_t*>(indices),
+          dictionarySize,
+          wrapInBufferView);
+      break;
+    case 's':
+      indicesBuffer = importDictionaryIndices(
+          pool,
+          rawNulls,
+          length,
+          static_cast<const int16_t*>(indices),
+          dictionarySize,
+          wrapInBufferView);
+      break;
+    case 'i':
+      indicesBuffer = importDictionaryIndices(
+          pool,
+          rawNulls,
+          length,
+          static_cast<const int32_t*>(indices),
+          dictionarySize,
+          wrapInBufferView);
+      break;
+    case 'l':
+      indicesBuffer = importDictionaryIndices(
+          pool,
+          rawNulls,
+          length,
+          static_cast<const int64_t*>(indices),
+          dictionarySize,
+          wrapInBufferView);
+      break;
+    default:
+      VELOX_USER_FAIL(
+          "Unsupported dictionary index type: '{}'", arrowSchema.format);
+  }
+  return BaseVector::wrapInDictionary(
+      nulls, indicesBuffer, length, std::move(dictionary));
+}
+
 RowVectorPtr createRowVector(
     memory::MemoryPool* pool,
     const RowTypePtr& rowType,
@@ -712,9 +836,6 @@ VectorPtr importFromArrowImpl(
     WrapInBufferViewFunc wrapInBufferView) {
   VELOX_USER_CHECK_NOT_NULL(arrowSchema.release, "arrowSchema was released.");
   VELOX_USER_CHECK_NOT_NULL(arrowArray.release, "arrowArray was released.");
-  VELOX_USER_CHECK_NULL(
-      arrowArray.dictionary,
-      "Dictionary encoded arrowArrays not supported yet.");
   VELOX_USER_CHECK_EQ(
       arrowArray.offset,
       0,
@@ -747,12 +868,32 @@ VectorPtr importFromArrowImpl(
         arrowArray.buffers[0], bits::nbytes(arrowArray.length));
   }
 
+  // Dictionary encoded arrays.
+  if (arrowArray.dictionary != nullptr) {
+    return createDictionaryVector(
+        pool, nulls, arrowSchema, arrowArray, isViewer, wrapInBufferView);
+  }
+
   // String data types (VARCHAR and VARBINARY).
   if (type->isVarchar() || type->isVarbinary()) {
     VELOX_USER_CHECK_EQ(
         arrowArray.n_buffers,
         3,
         "Expecting three buffers as input for string types.");
+    // Large strings and binaries ('U' and 'Z') have 64 bit offsets.
+    const bool isLarge =
+        arrowSchema.format[0] == 'U' || arrowSchema.format[0] == 'Z';
+    if (isLarge) {
+      return createStringFlatVector(
+          pool,
+          type,
+          nulls,
+          arrowArray.length,
+          static_cast<const int64_t*>(arrowArray.buffers[1]), // offsets
+          static_cast<const char*>(arrowArray.buffers[2]), // values
+          arrowArray.null_count,
+          wrapInBufferView);
+    }
     return createStringFlatVector(
         pool,
         type,
@@ -795,38 +936,23 @@ VectorPtr importFromArrowImpl(
   }
 }
 
-} // namespace
-
-VectorPtr importFromArrowAsViewer(
-    const ArrowSchema& arrowSchema,
-    const ArrowArray& arrowArray,
-    memory::MemoryPool* pool) {
-  return importFromArrowImpl(
-      arrowSchema,
-      arrowArray,
-      pool,
-      /*isViewer=*/true,
-      wrapInBufferViewAsViewer);
+void releaseAndDeleteSchema(ArrowSchema* toDelete) {
+  if (toDelete != nullptr) {
+    if (toDelete->release != nullptr) {
+      toDelete->release(toDelete);
+    }
+    delete toDelete;
+  }
 }
 
-VectorPtr importFromArrowAsOwner(
-    ArrowSchema& arrowSchema,
+// Imports 'arrowArray', described by 'arrowSchema', and takes over the
+// ownership of 'arrowArray'. The imported buffers keep 'schemaReleaser'
+// alive.
+VectorPtr importFromArrowAsOwnerImpl(
+    const ArrowSchema& arrowSchema,
+    const std::shared_ptr<ArrowSchema>& schemaReleaser,
     ArrowArray& arrowArray,
     memory::MemoryPool* pool) {
-  // This Vector will take over the ownership of `arrowSchema` and `arrowArray`
-  // by marking them as released and becoming responsible for calling the
-  // release callbacks when use count reaches zero. These ArrowSchema object and
-  // ArrowArray object will be co-owned by both the BufferVieweReleaser of the
-  // nulls buffer and values buffer.
-  std::shared_ptr<ArrowSchema> schemaReleaser(
-      new ArrowSchema(arrowSchema), [](ArrowSchema* toDelete) {
-        if (toDelete != nullptr) {
-          if (toDelete->release != nullptr) {
-            toDelete->release(toDelete);
-          }
-          delete toDelete;
-        }
-      });
   std::shared_ptr<ArrowArray> arrayReleaser(
       new ArrowArray(arrowArray), [](ArrowArray* toDelete) {
         if (toDelete != nullptr) {
@@ -846,10 +972,205 @@ VectorPtr importFromArrowAsOwner(
             buffer, length, schemaReleaser, arrayReleaser);
       });
 
-  arrowSchema.release = nullptr;
   arrowArray.release = nullptr;
+  return imported;
+}
 
+} // namespace
+
+VectorPtr importFromArrowAsViewer(
+    const ArrowSchema& arrowSchema,
+    const ArrowArray& arrowArray,
+    memory::MemoryPool* pool) {
+  return importFromArrowImpl(
+      arrowSchema,
+      arrowArray,
+      pool,
+      /*isViewer=*/true,
+      wrapInBufferViewAsViewer);
+}
+
+VectorPtr importFromArrowAsOwner(
+    ArrowSchema& arrowSchema,
+    ArrowArray& arrowArray,
+    memory::MemoryPool* pool) {
+  // This Vector will take over the ownership of `arrowSchema` and `arrowArray`
+  // by marking them as released and becoming responsible for calling the
+  // release callbacks when use count reaches zero. These ArrowSchema object and
+  // ArrowArray object will be co-owned by both the BufferVieweReleaser of the
+  // nulls buffer and values buffer.
+  std::shared_ptr<ArrowSchema> schemaReleaser(
+      new ArrowSchema(arrowSchema), releaseAndDeleteSchema);
+  auto imported =
+      importFromArrowAsOwnerImpl(arrowSchema, schemaReleaser, arrowArray, pool);
+  arrowSchema.release = nullptr;
   return imported;
 }
 
+namespace {
+
+// Holds the producer of an exported ArrowArrayStream. This is opaquely
+// carried by ArrowArrayStream.private_data.
+struct VeloxToArrowStreamHolder {
+  RowTypePtr type;
+  std::function<RowVectorPtr()> next;
+  memory::MemoryPool* pool;
+  std::string lastError;
+};
+
+VeloxToArrowStreamHolder* streamHolder(ArrowArrayStream* arrowStream) {
+  VELOX_CHECK_NOT_NULL(arrowStream);
+  auto* holder =
+      static_cast<VeloxToArrowStreamHolder*>(arrowStream->private_data);
+  VELOX_CHECK_NOT_NULL(holder);
+  return holder;
+}
+
+// Returns 'vector' with the children that exportToArrow() cannot convert, e.g.
+// dictionaries produced by a filter, flattened.
+RowVectorPtr flattenChildren(const RowVectorPtr& vector) {
+  auto children = vector->children();
+  bool flattened = false;
+  for (auto& child : children) {
+    child = BaseVector::loadedVectorShared(child);
+    const auto encoding = child->encoding();
+    if (encoding != VectorEncoding::Simple::FLAT &&
+        encoding != VectorEncoding::Simple::ROW) {
+      BaseVector::flattenVector(&child, vector->size());
+      flattened = true;
+    }
+  }
+  if (!flattened) {
+    return vector;
+  }
+  return std::make_shared<RowVector>(
+      vector->pool(),
+      vector->type(),
+      vector->nulls(),
+      vector->size(),
+      std::move(children));
+}
+
+int streamGetSchema(ArrowArrayStream* arrowStream, ArrowSchema* out) {
+  auto* holder = streamHolder(arrowStream);
+  try {
+    exportToArrow(holder->type, *out);
+  } catch (const std::exception& e) {
+    holder->lastError = e.what();
+    return EIO;
+  }
+  return 0;
+}
+
+int streamGetNext(ArrowArrayStream* arrowStream, ArrowArray* out) {
+  auto* holder = streamHolder(arrowStream);
+  try {
+    auto vector = holder->next();
+    if (vector == nullptr) {
+      // A released array marks the end of the stream.
+      out->release = nullptr;
+      return 0;
+    }
+    exportToArrow(flattenChildren(vector), *out, holder->pool);
+  } catch (const std::exception& e) {
+    holder->lastError = e.what();
+    return EIO;
+  }
+  return 0;
+}
+
+const char* streamGetLastError(ArrowArrayStream* arrowStream) {
+  auto* holder = streamHolder(arrowStream);
+  return holder->lastError.empty() ? nullptr : holder->lastError.c_str();
+}
+
+void streamRelease(ArrowArrayStream* arrowStream) {
+  if (arrowStream == nullptr || arrowStream->release == nullptr) {
+    return;
+  }
+  delete static_cast<VeloxToArrowStreamHolder*>(arrowStream->private_data);
+  arrowStream->release = nullptr;
+  arrowStream->private_data = nullptr;
+}
+
+} // namespace
+
+void exportToArrowStream(
+    const RowTypePtr& type,
+    std::function<RowVectorPtr()> next,
+    ArrowArrayStream& arrowStream,
+    memory::MemoryPool* pool) {
+  VELOX_CHECK_NOT_NULL(type);
+  VELOX_CHECK(next != nullptr);
+  arrowStream.get_schema = streamGetSchema;
+  arrowStream.get_next = streamGetNext;
+  arrowStream.get_last_error = streamGetLastError;
+  arrowStream.release = streamRelease;
+  arrowStream.private_data =
+      new VeloxToArrowStreamHolder{type, std::move(next), pool, {}};
+}
+
+ArrowStreamImporter::ArrowStreamImporter(
+    ArrowArrayStream& arrowStream,
+    memory::MemoryPool* pool)
+    : pool_(pool) {
+  VELOX_CHECK_NOT_NULL(
+      arrowStream.release, "Cannot import a released ArrowArrayStream");
+  arrowStream_ = std::make_unique<ArrowArrayStream>(arrowStream);
+  arrowStream.release = nullptr;
+
+  // The destructor does not run if the constructor throws.
+  try {
+    ArrowSchema arrowSchema;
+    checkStreamError(
+        arrowStream_->get_schema(arrowStream_.get(), &arrowSchema),
+        "get_schema");
+    arrowSchema_ = std::shared_ptr<ArrowSchema>(
+        new ArrowSchema(arrowSchema), releaseAndDeleteSchema);
+    type_ = asRowType(importFromArrow(*arrowSchema_));
+    VELOX_CHECK_NOT_NULL(
+        type_,
+        "ArrowArrayStream must produce structs: {}",
+        arrowSchema_->format);
+  } catch (...) {
+    arrowStream_->release(arrowStream_.get());
+    throw;
+  }
+}
+
+ArrowStreamImporter::~ArrowStreamImporter() {
+  if (arrowStream_->release != nullptr) {
+    arrowStream_->release(arrowStream_.get());
+  }
+}
+
+RowVectorPtr ArrowStreamImporter::next() {
+  if (atEnd_) {
+    return nullptr;
+  }
+  ArrowArray arrowArray;
+  checkStreamError(
+      arrowStream_->get_next(arrowStream_.get(), &arrowArray), "get_next");
+  if (arrowArray.release == nullptr) {
+    atEnd_ = true;
+    return nullptr;
+  }
+  return std::dynamic_pointer_cast<RowVector>(importFromArrowAsOwnerImpl(
+      *arrowSchema_, arrowSchema_, arrowArray, pool_));
+}
+
+void ArrowStreamImporter::checkStreamError(
+    int errorCode,
+    const char* operation) {
+  if (errorCode == 0) {
+    return;
+  }
+  const char* message = arrowStream_->get_last_error(arrowStream_.get());
+  VELOX_FAIL(
+      "ArrowArrayStream {} failed with error code {}: {}",
+      operation,
+      errorCode,
+      message ? message : "no error message");
+}
+
 } // namespace facebook::velox
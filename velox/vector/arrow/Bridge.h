@@ -16,14 +16,18 @@
 
 #pragma once
 
+#include <functional>
+
 #include "velox/common/memory/Memory.h"
 #include "velox/vector/BaseVector.h"
+#include "velox/vector/ComplexVector.h"
 
-/// These 2 definitions should be included by user from either
+/// These 3 definitions should be included by user from either
 ///   1. <arrow/c/abi.h> or
 ///   2. "velox/vector/arrow/Abi.h"
 struct ArrowArray;
 struct ArrowSchema;
+struct ArrowArrayStream;
 
 namespace facebook::velox {
 
@@ -146,4 +150,85 @@ VectorPtr importFromArrowAsOwner(
     memory::MemoryPool* pool =
         &velox::memory::getProcessDefaultMemoryManager().getRoot());
 
+/// Export a stream of RowVectors of type 'type' to an ArrowArrayStream, as
+/// defined by Arrow's C stream interface:
+///
+///   https://arrow.apache.org/docs/format/CStreamInterface.html
+///
+/// Batches are produced lazily: each call to the stream's get_next() calls
+/// 'next' once and exports the RowVector it returns, so the producer only runs
+/// as fast as the consumer pulls. 'next' returns nullptr at the end of the
+/// stream. An exception thrown by 'next' or by the conversion is returned to
+/// the consumer as EIO, with the message available from get_last_error().
+///
+/// The stream holds on to 'next' until the consumer calls release().
+///
+/// Example usage, streaming the results of a query:
+///
+///   auto cursor = std::make_unique<TaskCursor>(params);
+///   ArrowArrayStream arrowStream;
+///   exportToArrowStream(
+///       plan->outputType(),
+///       [cursor = std::move(cursor)]() -> RowVectorPtr {
+///         return cursor->moveNext() ? cursor->current() : nullptr;
+///       },
+///       arrowStream,
+///       pool);
+///
+///   (pass arrowStream to the consumer, which calls its release())
+///
+void exportToArrowStream(
+    const RowTypePtr& type,
+    std::function<RowVectorPtr()> next,
+    ArrowArrayStream& arrowStream,
+    memory::MemoryPool* pool =
+        &velox::memory::getProcessDefaultMemoryManager().getRoot());
+
+/// Imports the arrays of an ArrowArrayStream one at a time as RowVectors.
+///
+/// The importer takes over the ownership of 'arrowStream', marks it as
+/// released and calls its release callback when destructed. Like
+/// importFromArrowAsOwner, each returned RowVector owns its ArrowArray and may
+/// outlive the importer.
+///
+/// Example usage:
+///
+///   ArrowArrayStream arrowStream;
+///   ... // fills arrowStream
+///   ArrowStreamImporter importer(arrowStream, pool);
+///   while (auto vector = importer.next()) {
+///     ... // use vector
+///   }
+///
+class ArrowStreamImporter {
+ public:
+  /// Reads the schema of the stream. Throws if the stream does not produce
+  /// structs.
+  explicit ArrowStreamImporter(
+      ArrowArrayStream& arrowStream,
+      memory::MemoryPool* pool =
+          &velox::memory::getProcessDefaultMemoryManager().getRoot());
+
+  ~ArrowStreamImporter();
+
+  const RowTypePtr& type() const {
+    return type_;
+  }
+
+  /// Returns the next batch of the stream, or nullptr at the end of the
+  /// stream. Throws if the producer fails.
+  RowVectorPtr next();
+
+ private:
+  // Throws with the producer's error message if 'errorCode' is not 0.
+  void checkStreamError(int errorCode, const char* operation);
+
+  std::unique_ptr<ArrowArrayStream> arrowStream_;
+  // Released once the importer and all the vectors it returned are gone.
+  std::shared_ptr<ArrowSchema> arrowSchema_;
+  RowTypePtr type_;
+  memory::MemoryPool* const pool_;
+  bool atEnd_{false};
+};
+
 } // namespace facebook::velox
@@ -664,6 +664,107 @@ class ArrowBridgeArrayImportTest : public ArrowBridgeArrayExportTest {
         });
   }
 
+  void testImportStringZeroCopy() {
+    ArrowContextHolder holder;
+    auto arrowArray = fillArrowArray(
+        std::vector<std::optional<std::string>>{
+            "a string which is not inlined", std::nullopt, "short"},
+        holder);
+    auto arrowSchema = makeArrowSchema("u");
+    auto output = importFromArrow(arrowSchema, arrowArray, pool_.get());
+
+    // The StringViews point into the Arrow values buffer.
+    auto* flat = output->asFlatVector<StringView>();
+    ASSERT_EQ(1, flat->stringBuffers().size());
+    EXPECT_EQ(
+        holder.values->as<char>(), flat->stringBuffers()[0]->as<char>());
+    EXPECT_EQ(holder.values->as<char>(), flat->valueAt(0).data());
+  }
+
+  void testImportLargeString() {
+    std::vector<std::optional<std::string>> inputValues = {
+        "hello", std::nullopt, "a string which is not inlined", ""};
+    ArrowContextHolder holder;
+    auto arrowArray = fillArrowArray(inputValues, holder);
+
+    // Same values with 64 bit offsets.
+    auto* offsets = holder.offsets->as<int32_t>();
+    auto largeOffsets = AlignedBuffer::allocate<int64_t>(
+        inputValues.size() + 1, pool_.get());
+    for (auto i = 0; i <= inputValues.size(); ++i) {
+      largeOffsets->asMutable<int64_t>()[i] = offsets[i];
+    }
+    arrowArray.buffers[1] = largeOffsets->as<int64_t>();
+
+    auto arrowSchema = makeArrowSchema("U");
+    auto output = importFromArrow(arrowSchema, arrowArray, pool_.get());
+    assertVectorContent(inputValues, output, arrowArray.null_count);
+  }
+
+  void testImportDictionary() {
+    ArrowContextHolder dictionaryHolder;
+    auto dictionaryArray = fillArrowArray(
+        std::vector<std::optional<std::string>>{
+            "apple", "a banana with a long name", "cherry"},
+        dictionaryHolder);
+    auto dictionarySchema = makeArrowSchema("u");
+
+    const std::vector<std::optional<std::string>> expected = {
+        "cherry",
+        "apple",
+        std::nullopt,
+        "a banana with a long name",
+        "a banana with a long name",
+        "apple"};
+
+    auto testIndices = [&](const char* format, auto indices) {
+      using TIndex = typename decltype(indices)::value_type;
+      auto nulls =
+          AlignedBuffer::allocate<uint64_t>(indices.size(), pool_.get());
+      auto* rawNulls = nulls->asMutable<uint64_t>();
+      for (auto i = 0; i < indices.size(); ++i) {
+        bits::setNull(rawNulls, i, !expected[i].has_value());
+      }
+      const void* buffers[] = {rawNulls, indices.data()};
+      auto arrowArray = makeArrowArray(buffers, 2, indices.size(), 1);
+      arrowArray.dictionary = &dictionaryArray;
+      auto arrowSchema = makeArrowSchema(format);
+      arrowSchema.dictionary = &dictionarySchema;
+
+      auto output = importFromArrow(arrowSchema, arrowArray, pool_.get());
+      EXPECT_EQ(VectorEncoding::Simple::DICTIONARY, output->encoding());
+      EXPECT_EQ(*VARCHAR(), *output->type());
+      EXPECT_EQ(
+          dictionaryHolder.values->as<char>(),
+          output->valueVector()
+              ->asFlatVector<StringView>()
+              ->stringBuffers()[0]
+              ->as<char>());
+
+      auto* simple = output->as<SimpleVector<StringView>>();
+      EXPECT_EQ(expected.size(), simple->size());
+      for (auto i = 0; i < expected.size(); ++i) {
+        if (!expected[i].has_value()) {
+          EXPECT_TRUE(simple->isNullAt(i));
+          // Undefined indices of null rows are replaced.
+          EXPECT_LT(simple->wrappedIndex(i), 3);
+        } else {
+          EXPECT_EQ(StringView(*expected[i]), simple->valueAt(i));
+        }
+      }
+      // Returns true if the indices were not copied.
+      return std::is_same_v<TIndex, int32_t> &&
+          output->wrapInfo()->as<void>() == (const void*)indices.data();
+    };
+
+    // 32 bit indices are not copied, unless a null row has an invalid index.
+    EXPECT_TRUE(testIndices("i", std::vector<int32_t>{2, 0, 1, 1, 1, 0}));
+    EXPECT_FALSE(testIndices("i", std::vector<int32_t>{2, 0, -1, 1, 1, 0}));
+    testIndices("c", std::vector<int8_t>{2, 0, 100, 1, 1, 0});
+    testIndices("s", std::vector<int16_t>{2, 0, 0, 1, 1, 0});
+    testIndices("l", std::vector<int64_t>{2, 0, 0, 1, 1, 0});
+  }
+
  private:
   void testImportRowFull() {
     // Manually create a ROW type.
@@ -839,6 +940,18 @@ TEST_F(ArrowBridgeArrayImportAsViewerTest, string) {
   testImportString();
 }
 
+TEST_F(ArrowBridgeArrayImportAsViewerTest, stringZeroCopy) {
+  testImportStringZeroCopy();
+}
+
+TEST_F(ArrowBridgeArrayImportAsViewerTest, largeString) {
+  testImportLargeString();
+}
+
+TEST_F(ArrowBridgeArrayImportAsViewerTest, dictionary) {
+  testImportDictionary();
+}
+
 TEST_F(ArrowBridgeArrayImportAsViewerTest, row) {
   testImportRow();
 }
@@ -874,6 +987,18 @@ TEST_F(ArrowBridgeArrayImportAsOwnerTest, string) {
   testImportString();
 }
 
+TEST_F(ArrowBridgeArrayImportAsOwnerTest, stringZeroCopy) {
+  testImportStringZeroCopy();
+}
+
+TEST_F(ArrowBridgeArrayImportAsOwnerTest, largeString) {
+  testImportLargeString();
+}
+
+TEST_F(ArrowBridgeArrayImportAsOwnerTest, dictionary) {
+  testImportDictionary();
+}
+
 TEST_F(ArrowBridgeArrayImportAsOwnerTest, row) {
   testImportRow();
 }
@@ -0,0 +1,144 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <arrow/c/abi.h>
+#include <gtest/gtest.h>
+
+#include "velox/common/base/tests/GTestUtils.h"
+#include "velox/vector/arrow/Bridge.h"
+#include "velox/vector/tests/VectorTestBase.h"
+
+namespace facebook::velox::test {
+namespace {
+
+class ArrowBridgeStreamTest : public testing::Test, public VectorTestBase {
+ protected:
+  std::vector<RowVectorPtr> makeBatches() {
+    std::vector<RowVectorPtr> batches;
+    for (auto i = 0; i < 3; ++i) {
+      batches.push_back(makeRowVector(
+          {"a", "b"},
+          {makeFlatVector<int64_t>(100, [&](auto row) { return row + i; }),
+           makeFlatVector<StringView>(
+               100,
+               [](auto row) { return StringView(std::string(row % 20, 'x')); },
+               nullEvery(7))}));
+    }
+    return batches;
+  }
+
+  // Exports 'batches' one at a time. Counts the batches pulled in
+  // 'numPulled'.
+  void exportBatches(
+      const std::vector<RowVectorPtr>& batches,
+      ArrowArrayStream& arrowStream,
+      int32_t& numPulled) {
+    exportToArrowStream(
+        asRowType(batches[0]->type()),
+        [&batches, &numPulled]() -> RowVectorPtr {
+          if (numPulled == batches.size()) {
+            return nullptr;
+          }
+          return batches[numPulled++];
+        },
+        arrowStream,
+        pool());
+  }
+};
+
+TEST_F(ArrowBridgeStreamTest, roundTrip) {
+  auto batches = makeBatches();
+  int32_t numPulled = 0;
+  ArrowArrayStream arrowStream;
+  exportBatches(batches, arrowStream, numPulled);
+  // Nothing is produced before the consumer asks for it.
+  EXPECT_EQ(0, numPulled);
+
+  ArrowStreamImporter importer(arrowStream, pool());
+  EXPECT_EQ(nullptr, arrowStream.release);
+  EXPECT_TRUE(importer.type()->equivalent(*batches[0]->type()));
+
+  for (auto i = 0; i < batches.size(); ++i) {
+    auto vector = importer.next();
+    ASSERT_NE(nullptr, vector);
+    EXPECT_EQ(i + 1, numPulled);
+    assertEqualVectors(batches[i], vector);
+  }
+  EXPECT_EQ(nullptr, importer.next());
+  EXPECT_EQ(nullptr, importer.next());
+}
+
+TEST_F(ArrowBridgeStreamTest, dictionaryChildren) {
+  auto batch = makeRowVector({wrapInDictionary(
+      makeIndicesInReverse(100),
+      100,
+      makeFlatVector<int32_t>(100, [](auto row) { return row; }))});
+  bool done = false;
+  ArrowArrayStream arrowStream;
+  exportToArrowStream(
+      asRowType(batch->type()),
+      [&]() -> RowVectorPtr {
+        if (done) {
+          return nullptr;
+        }
+        done = true;
+        return batch;
+      },
+      arrowStream,
+      pool());
+
+  ArrowStreamImporter importer(arrowStream, pool());
+  assertEqualVectors(batch, importer.next());
+  EXPECT_EQ(nullptr, importer.next());
+}
+
+TEST_F(ArrowBridgeStreamTest, producerError) {
+  ArrowArrayStream arrowStream;
+  exportToArrowStream(
+      ROW({"a"}, {BIGINT()}),
+      []() -> RowVectorPtr { VELOX_FAIL("Producer failed"); },
+      arrowStream,
+      pool());
+
+  ArrowArray arrowArray;
+  EXPECT_NE(0, arrowStream.get_next(&arrowStream, &arrowArray));
+  EXPECT_NE(
+      std::string(arrowStream.get_last_error(&arrowStream))
+          .find("Producer failed"),
+      std::string::npos);
+
+  ArrowStreamImporter importer(arrowStream, pool());
+  VELOX_ASSERT_THROW(importer.next(), "Producer failed");
+}
+
+TEST_F(ArrowBridgeStreamTest, release) {
+  ArrowArrayStream arrowStream;
+  exportToArrowStream(
+      ROW({"a"}, {BIGINT()}),
+      []() -> RowVectorPtr { return nullptr; },
+      arrowStream,
+      pool());
+  arrowStream.release(&arrowStream);
+  EXPECT_EQ(nullptr, arrowStream.release);
+  EXPECT_EQ(nullptr, arrowStream.private_data);
+
+  VELOX_ASSERT_THROW(
+      ArrowStreamImporter(arrowStream, pool()),
+      "Cannot import a released ArrowArrayStream");
+}
+
+} // namespace
+} // namespace facebook::velox::test
@@ -300,6 +300,73 @@ BENCHMARK_PARAM(BM_operatorEquals, 1000000);
 BENCHMARK_PARAM(BM_operatorEquals, 10000000);
 BENCHMARK_DRAW_LINE();
 
+// applyToSelected Tests
+
+// Selects 'numRanges' ranges of 'rangeLength' rows spread evenly over the
+// vector. A 'rangeLength' of 1 gives sparse single rows.
+void applyToSelectedTest(
+    uint32_t iterations,
+    size_t numEntries,
+    size_t numRanges,
+    size_t rangeLength) {
+  folly::BenchmarkSuspender suspender;
+  SelectivityVector vector(numEntries, false);
+  const auto step = numEntries / numRanges;
+  for (size_t i = 0; i + rangeLength <= numEntries; i += step) {
+    vector.setValidRange(i, i + rangeLength, true);
+  }
+  vector.updateBounds();
+  vector.prepareIteration();
+  suspender.dismiss();
+
+  int64_t sum = 0;
+  for (uint32_t i = 0; i < iterations; ++i) {
+    vector.applyToSelected([&](auto row) { sum += row; });
+  }
+  folly::doNotOptimizeAway(sum);
+
+  suspender.rehire();
+}
+
+void BM_applyToSelectedRanges(uint32_t iterations, size_t numEntries) {
+  applyToSelectedTest(iterations, numEntries, 4, numEntries / 8);
+}
+
+void BM_applyToSelectedSparse(uint32_t iterations, size_t numEntries) {
+  applyToSelectedTest(iterations, numEntries, numEntries / 100, 1);
+}
+
+void BM_applyToSelectedRandom(uint32_t iterations, size_t numEntries) {
+  folly::BenchmarkSuspender suspender;
+  SelectivityVector vector(numEntries);
+  for (size_t i = 0; i < vector.size(); ++i) {
+    vector.setValid(i, folly::Random::oneIn(2));
+  }
+  vector.updateBounds();
+  vector.prepareIteration();
+  suspender.dismiss();
+
+  int64_t sum = 0;
+  for (uint32_t i = 0; i < iterations; ++i) {
+    vector.applyToSelected([&](auto row) { sum += row; });
+  }
+  folly::doNotOptimizeAway(sum);
+
+  suspender.rehire();
+}
+
+BENCHMARK_PARAM(BM_applyToSelectedRanges, 1000);
+BENCHMARK_PARAM(BM_applyToSelectedRanges, 1000000);
+BENCHMARK_DRAW_LINE();
+
+BENCHMARK_PARAM(BM_applyToSelectedSparse, 1000);
+BENCHMARK_PARAM(BM_applyToSelectedSparse, 1000000);
+BENCHMARK_DRAW_LINE();
+
+BENCHMARK_PARAM(BM_applyToSelectedRandom, 1000);
+BENCHMARK_PARAM(BM_applyToSelectedRandom, 1000000);
+BENCHMARK_DRAW_LINE();
+
 } // namespace test
 } // namespace velox
 } // namespace facebook
@@ -18,6 +18,8 @@
 
 #include <gtest/gtest.h>
 
+#include <random>
+
 namespace facebook {
 namespace velox {
 namespace test {
@@ -514,6 +516,134 @@ TEST(SelectivityVectorTest, toString) {
       "147 out of 1024 rows selected between 0 and 1023: 0, 7, 14, 21, 28, 35, 42, 49, 56, 63, 70, 77, 84, 91, 98, 105, 112, 119, 126, 133, 140, 147, 154, 161, 168, 175, 182, 189, 196, 203, 210, 217, 224, 231, 238, 245, 252, 259, 266, 273, 280, 287, 294, 301, 308, 315, 322, 329, 336, 343, 350, 357, 364, 371, 378, 385, 392, 399, 406, 413, 420, 427, 434, 441, 448, 455, 462, 469, 476, 483, 490, 497, 504, 511, 518, 525, 532, 539, 546, 553, 560, 567, 574, 581, 588, 595, 602, 609, 616, 623, 630, 637, 644, 651, 658, 665, 672, 679, 686, 693, 700, 707, 714, 721, 728, 735, 742, 749, 756, 763, 770, 777, 784, 791, 798, 805, 812, 819, 826, 833, 840, 847, 854, 861, 868, 875, 882, 889, 896, 903, 910, 917, 924, 931, 938, 945, 952, 959, 966, 973, 980, 987, 994, 1001, 1008, 1015, 1022");
 }
 
+namespace {
+
+std::vector<vector_size_t> selectedRows(const SelectivityVector& rows) {
+  std::vector<vector_size_t> result;
+  rows.applyToSelected([&](auto row) { result.push_back(row); });
+  return result;
+}
+
+std::vector<vector_size_t> validRows(const SelectivityVector& rows) {
+  std::vector<vector_size_t> result;
+  for (auto i = 0; i < rows.size(); ++i) {
+    if (rows.isValid(i)) {
+      result.push_back(i);
+    }
+  }
+  return result;
+}
+
+} // namespace
+
+TEST(SelectivityVectorTest, applyToSelectedCompact) {
+  constexpr int32_t kSize = 10'000;
+  SelectivityVector rows(kSize, false);
+
+  // A few long ranges, the last one ending at a word boundary.
+  rows.setValidRange(100, 1'000, true);
+  rows.setValidRange(1'001, 3'000, true);
+  rows.setValidRange(9'000, 9'984, true);
+  rows.updateBounds();
+  ASSERT_EQ(validRows(rows), selectedRows(rows));
+  // Iterates over the ranges.
+  rows.prepareIteration();
+  ASSERT_EQ(validRows(rows), selectedRows(rows));
+
+  // Changing the selection discards the ranges.
+  rows.setValid(2'000, false);
+  rows.setValid(5'000, true);
+  rows.updateBounds();
+  ASSERT_EQ(validRows(rows), selectedRows(rows));
+  rows.prepareIteration();
+  ASSERT_EQ(validRows(rows), selectedRows(rows));
+
+  // Sparse rows.
+  rows.clearAll();
+  for (auto i = 3; i < kSize; i += 97) {
+    rows.setValid(i, true);
+  }
+  rows.updateBounds();
+  ASSERT_EQ(validRows(rows), selectedRows(rows));
+  rows.prepareIteration();
+  ASSERT_EQ(validRows(rows), selectedRows(rows));
+
+  // A copy iterates over the same rows.
+  SelectivityVector copy = rows;
+  ASSERT_EQ(validRows(rows), selectedRows(copy));
+  copy.setValidRange(0, kSize, true);
+  copy.setActiveRange(10, 20);
+  ASSERT_EQ(10, selectedRows(copy).size());
+  ASSERT_EQ(validRows(rows), selectedRows(rows));
+
+  // Random rows of different densities.
+  std::mt19937 rng(1);
+  for (auto density : {2, 5, 50, 200}) {
+    rows.clearAll();
+    for (auto i = 0; i < kSize; ++i) {
+      if (rng() % density == 0) {
+        rows.setValid(i, true);
+      }
+    }
+    rows.updateBounds();
+    ASSERT_EQ(validRows(rows), selectedRows(rows));
+    rows.prepareIteration();
+    ASSERT_EQ(validRows(rows), selectedRows(rows));
+  }
+}
+
+TEST(SelectivityVectorTest, changeSelectionWhileIterating) {
+  constexpr int32_t kSize = 10'000;
+  SelectivityVector rows(kSize, false);
+  rows.setValidRange(100, 5'000, true);
+  rows.updateBounds();
+  rows.prepareIteration();
+  const auto expected = validRows(rows);
+
+  // The rows selected at the start of the iteration are visited.
+  std::vector<vector_size_t> visited;
+  rows.applyToSelected([&](auto row) {
+    visited.push_back(row);
+    rows.setValid(row, false);
+    rows.updateBounds();
+  });
+  ASSERT_EQ(expected, visited);
+  ASSERT_FALSE(rows.hasSelections());
+}
+
+TEST(SelectivityVectorTest, intersectAndDeselectBatches) {
+  constexpr int32_t kSize = 5'000;
+  std::mt19937 rng(1);
+  for (auto i = 0; i < 20; ++i) {
+    SelectivityVector left(kSize);
+    SelectivityVector right(kSize);
+    for (auto row = 0; row < kSize; ++row) {
+      left.setValid(row, rng() % 3 != 0);
+      right.setValid(row, rng() % 2 == 0);
+    }
+    // Leaves 'left' with bounds that are not on word boundaries.
+    left.setValidRange(0, rng() % 200, false);
+    left.setValidRange(kSize - rng() % 200, kSize, false);
+    left.updateBounds();
+    right.updateBounds();
+
+    std::vector<bool> expectIntersect(kSize);
+    std::vector<bool> expectDeselect(kSize);
+    for (auto row = 0; row < kSize; ++row) {
+      expectIntersect[row] = left.isValid(row) && right.isValid(row);
+      expectDeselect[row] = left.isValid(row) && !right.isValid(row);
+    }
+
+    auto intersected = left;
+    intersected.intersect(right);
+    assertState(expectIntersect, intersected);
+
+    auto deselected = left;
+    deselected.deselect(right);
+    assertState(expectDeselect, deselected);
+  }
+}
+
 } // namespace test
 } // namespace velox
 } // namespace facebook
@@ -505,3 +505,24 @@ TEST_F(VectorEstimateFlatSizeTest, structs) {
   EXPECT_EQ(2837, row->estimateFlatSize());
   EXPECT_EQ(3295, flatten(row)->estimateFlatSize());
 }
+
+TEST_F(VectorEstimateFlatSizeTest, deduplicatedRetainedSize) {
+  auto base = makeFlatVector<int32_t>(1'000, int32At);
+  auto indices = makeIndices(100, [](auto row) { return row * 2; });
+  EXPECT_EQ(4000, base->retainedSize());
+  EXPECT_EQ(4000, base->deduplicatedRetainedSize());
+
+  // Two dictionaries over the same base vector and indices.
+  auto row = makeRowVector(
+      {wrapInDictionary(indices, 100, base),
+       wrapInDictionary(indices, 100, base)});
+  EXPECT_EQ(8832, row->retainedSize());
+  EXPECT_EQ(4416, row->deduplicatedRetainedSize());
+
+  // Vectors added to the same accumulator share the count.
+  RetainedSizeAccumulator accumulator;
+  base->addRetainedSize(accumulator);
+  EXPECT_EQ(4000, accumulator.bytes());
+  row->addRetainedSize(accumulator);
+  EXPECT_EQ(4416, accumulator.bytes());
+}
@@ -0,0 +1,89 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include <gtest/gtest.h>
+
+#include "velox/vector/VectorPool.h"
+#include "velox/vector/tests/VectorTestBase.h"
+
+using namespace facebook::velox;
+
+class VectorPoolTest : public testing::Test, public test::VectorTestBase {};
+
+TEST_F(VectorPoolTest, reuse) {
+  VectorPool vectorPool(pool());
+  auto vector = vectorPool.get(BIGINT(), 100);
+  ASSERT_EQ(100, vector->size());
+  vector->setNull(3, true);
+  auto* rawValues = vector->values().get();
+
+  ASSERT_TRUE(vectorPool.release(vector));
+  EXPECT_EQ(nullptr, vector);
+
+  // The same vector comes back, without nulls.
+  auto reused = vectorPool.get(BIGINT(), 50);
+  EXPECT_EQ(rawValues, reused->values().get());
+  EXPECT_EQ(50, reused->size());
+  EXPECT_FALSE(reused->mayHaveNulls());
+
+  // An empty pool allocates.
+  auto other = vectorPool.get(BIGINT(), 50);
+  EXPECT_NE(reused->values().get(), other->values().get());
+
+  // Vectors of other types do not mix.
+  ASSERT_TRUE(vectorPool.release(reused));
+  auto doubles = vectorPool.get(DOUBLE(), 50);
+  EXPECT_EQ(TypeKind::DOUBLE, doubles->typeKind());
+}
+
+TEST_F(VectorPoolTest, notReusable) {
+  VectorPool vectorPool(pool());
+
+  // Referenced elsewhere.
+  VectorPtr vector =
+      makeFlatVector<int32_t>(10, [](auto row) { return row; });
+  auto copy = vector;
+  EXPECT_FALSE(vectorPool.release(vector));
+  EXPECT_NE(nullptr, vector);
+
+  // Not flat.
+  VectorPtr constant = makeConstant<int32_t>(1, 10);
+  EXPECT_FALSE(vectorPool.release(constant));
+
+  // Strings and complex types are not cached.
+  VectorPtr strings = makeFlatVector<StringView>(
+      10, [](auto /*row*/) { return StringView("a"); });
+  EXPECT_FALSE(vectorPool.release(strings));
+  VectorPtr arrays = makeArrayVector<int32_t>({{1, 2}, {3}});
+  EXPECT_FALSE(vectorPool.release(arrays));
+
+  // Too large.
+  VectorPtr large =
+      makeFlatVector<int64_t>(20'000, [](auto row) { return row; });
+  EXPECT_FALSE(vectorPool.release(large));
+}
+
+TEST_F(VectorPoolTest, releaseMany) {
+  VectorPool vectorPool(pool());
+  std::vector<VectorPtr> vectors;
+  for (auto i = 0; i < 15; ++i) {
+    vectors.push_back(vectorPool.get(INTEGER(), 10));
+  }
+  vectors.push_back(makeConstant<int32_t>(1, 10));
+
+  // At most 10 vectors of a kind are kept.
+  EXPECT_EQ(10, vectorPool.release(vectors));
+  EXPECT_TRUE(vectors.empty());
+}